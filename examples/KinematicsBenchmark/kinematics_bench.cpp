@@ -0,0 +1,182 @@
+/**
+ * @file kinematics_bench.cpp
+ * @brief Host-side accuracy/speed comparison of the arm solver math
+ *
+ * Sweeps a grid of planar targets over TheGill's arm and solves each one
+ * three ways:
+ *
+ * - libm:  the law-of-cosines solve the arm solvers used before
+ *          Kinematics.h (sqrtf/atan2f/acosf), reproduced here as reference
+ * - float: Kinematics::solveTwoLink<float>
+ * - q16:   Kinematics::solveTwoLink<Kinematics::Q16>
+ *
+ * and prints ns/solve plus the worst and mean shoulder/elbow error against
+ * a double-precision solve. It then times Kinematics::CollisionScene::check()
+ * on the solved poses with a scene like TheGill's (three capsules, three
+ * boxes) and prints its share of a 1 kHz control tick. Kinematics.h and
+ * Collision.h have no Arduino dependency:
+ *
+ *     g++ -O2 -std=gnu++11 -Ilib/ILITE/include \
+ *         examples/KinematicsBenchmark/kinematics_bench.cpp -o kinematics_bench
+ *     ./kinematics_bench
+ *
+ * Host timings only rank the variants; on the ESP32 float has an FPU and
+ * Q16 is meant for FPU-less robot MCUs.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#include "Kinematics.h"
+#include "Collision.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr float kShoulderMm = 155.0f;   // IKEngine::ArmDimensions defaults
+constexpr float kForearmMm = 300.0f;    // elbow length + full extension
+constexpr int kRepeats = 200;
+constexpr double kTickNs = 1e6;         // 1 kHz control budget
+
+struct Target {
+    float horizontal;
+    float vertical;
+};
+
+struct Angles {
+    double shoulder;
+    double elbow;
+};
+
+Angles solveDouble(double l1, double l2, double h, double v) {
+    double d = std::sqrt(h * h + v * v);
+    d = std::fmin(std::fmax(d, std::fabs(l1 - l2)), l1 + l2);
+    d = std::fmax(d, 1e-3);
+    const double shoulder = std::atan2(v, h) +
+        std::acos(std::fmin(1.0, std::fmax(-1.0, (l1 * l1 + d * d - l2 * l2) / (2 * l1 * d))));
+    const double elbow =
+        std::acos(std::fmin(1.0, std::fmax(-1.0, (l1 * l1 + l2 * l2 - d * d) / (2 * l1 * l2))));
+    return Angles{shoulder, elbow};
+}
+
+Angles solveLibm(float l1, float l2, float h, float v) {
+    float d = sqrtf(h * h + v * v);
+    d = fminf(fmaxf(d, fabsf(l1 - l2)), l1 + l2);
+    d = fmaxf(d, 1e-3f);
+    const float shoulder = atan2f(v, h) +
+        acosf(fminf(1.0f, fmaxf(-1.0f, (l1 * l1 + d * d - l2 * l2) / (2.0f * l1 * d))));
+    const float elbow =
+        acosf(fminf(1.0f, fmaxf(-1.0f, (l1 * l1 + l2 * l2 - d * d) / (2.0f * l1 * l2))));
+    return Angles{shoulder, elbow};
+}
+
+template <typename T>
+Angles solveKinematics(float l1, float l2, float h, float v) {
+    const Kinematics::TwoLinkResult<T> result =
+        Kinematics::solveTwoLink<T>(T(l1), T(l2), T(h), T(v), T(1e-3f));
+    return Angles{Kinematics::toFloat(result.angleToTarget + result.shoulderOffset),
+                  Kinematics::toFloat(result.elbowInterior)};
+}
+
+template <typename Solver>
+void run(const char* name, const std::vector<Target>& targets, Solver solver) {
+    double maxError = 0.0;
+    double sumError = 0.0;
+    double checksum = 0.0;
+
+    for (const Target& t : targets) {
+        const Angles ref = solveDouble(kShoulderMm, kForearmMm, t.horizontal, t.vertical);
+        const Angles got = solver(kShoulderMm, kForearmMm, t.horizontal, t.vertical);
+        const double error = std::fmax(std::fabs(got.shoulder - ref.shoulder),
+                                       std::fabs(got.elbow - ref.elbow)) * 180.0 / M_PI;
+        maxError = std::fmax(maxError, error);
+        sumError += error;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (const Target& t : targets) {
+            const Angles got = solver(kShoulderMm, kForearmMm, t.horizontal, t.vertical);
+            checksum += got.shoulder + got.elbow;
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+                      (static_cast<double>(kRepeats) * targets.size());
+
+    std::printf("%-6s %8.1f ns/solve  max %.4f deg  mean %.5f deg  (checksum %.1f)\n",
+                name, ns, maxError, sumError / targets.size(), checksum);
+}
+
+// Shoulder pivot, elbow, wrist and jaw tips for each target, swept over base yaw
+std::vector<Kinematics::Vec3f> armChains(const std::vector<Target>& targets) {
+    std::vector<Kinematics::Vec3f> chains;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const Target& t = targets[i];
+        const Angles a = solveKinematics<float>(kShoulderMm, kForearmMm, t.horizontal, t.vertical);
+        const float yaw = static_cast<float>(i % 36) * 0.1745f - 3.14159f;
+        const float forearm = static_cast<float>(a.shoulder + a.elbow - M_PI);
+        const float elbowH = kShoulderMm * cosf(a.shoulder);
+        const float elbowV = kShoulderMm * sinf(a.shoulder);
+        const float wristH = elbowH + kForearmMm * cosf(forearm);
+        const float wristV = elbowV + kForearmMm * sinf(forearm);
+        const float planar[4][2] = {
+            {0.0f, 0.0f}, {elbowH, elbowV}, {wristH, wristV},
+            {wristH + 60.0f * cosf(forearm), wristV + 60.0f * sinf(forearm)}
+        };
+        for (const auto& p : planar) {
+            chains.push_back(Kinematics::Vec3f(p[0] * cosf(yaw), p[0] * sinf(yaw), p[1]));
+        }
+    }
+    return chains;
+}
+
+void runCollision(const std::vector<Target>& targets) {
+    Kinematics::CollisionScene scene;
+    scene.setLinkRadius(0, 20.0f);
+    scene.setLinkRadius(1, 16.0f);
+    scene.setLinkRadius(2, 25.0f);
+    scene.addBox({{-50.0f, -50.0f, -90.0f}, {50.0f, 50.0f, 0.0f}, "turret", 0x01});
+    scene.addBox({{-220.0f, -160.0f, -260.0f}, {220.0f, 160.0f, -90.0f}, "chassis", 0});
+    scene.addBox({{-170.0f, -25.0f, -90.0f}, {-130.0f, 25.0f, 200.0f}, "camera mast", 0});
+
+    const std::vector<Kinematics::Vec3f> chains = armChains(targets);
+    const size_t poses = chains.size() / 4;
+    size_t hits = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (size_t i = 0; i < poses; ++i) {
+            if (scene.check(&chains[i * 4], 4)) {
+                hits++;
+            }
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+                      (static_cast<double>(kRepeats) * poses);
+
+    std::printf("collide %7.1f ns/check  %.3f%% of a 1 kHz tick  (%zu of %zu poses blocked)\n",
+                ns, 100.0 * ns / kTickNs, hits / kRepeats, poses);
+}
+
+}  // namespace
+
+int main() {
+    std::vector<Target> targets;
+    for (float h = 0.0f; h <= 480.0f; h += 4.0f) {
+        for (float v = -300.0f; v <= 480.0f; v += 4.0f) {
+            targets.push_back(Target{h, v});
+        }
+    }
+    std::printf("%zu targets, L1=%.0f mm, L2=%.0f mm\n", targets.size(), kShoulderMm, kForearmMm);
+
+    run("libm", targets, solveLibm);
+    run("float", targets, solveKinematics<float>);
+    run("q16", targets, solveKinematics<Kinematics::Q16>);
+    runCollision(targets);
+    return 0;
+}
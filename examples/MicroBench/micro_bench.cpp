@@ -0,0 +1,354 @@
+/**
+ * @file micro_bench.cpp
+ * @brief Hot-path benchmark suite for comparing firmware builds
+ *
+ * Runs each kernel through MicroBench and prints one CSV row per kernel.
+ * Diff the output of two builds before a competition:
+ *
+ *     pio run -e ILITE_bench -t upload && pio device monitor -e ILITE_bench > before.csv
+ *     pio run -e native_bench && .pio/build/native_bench/program > before-host.csv
+ *
+ * On the device the suite runs once at boot, before any framework task
+ * exists, so nothing else competes for the core or the display. Send any
+ * line on the console to run it again. The native build runs only the
+ * kernels without hardware dependencies (arm solvers, control shaping,
+ * drive mixing).
+ * Everything touching U8g2, the module registry or FreeRTOS primitives is
+ * device-only.
+ *
+ * Kernels:
+ * - router.route        PacketRouter::routePacket of a DroneGaze telemetry frame
+ * - telemetry.pidSample appendPidSample (12 history pushes)
+ * - menu.visible        MenuRegistry::getVisibleEntries(root), cached
+ * - menu.visibleCold    the same after invalidateVisibility()
+ * - ik.solvePlanar      InverseKinematics::solvePlanar over a target sweep
+ * - mecharm.solve       mech::MechArmIK::solve over a target sweep
+ * - shaping.eval        ControlShaping::evaluateCurve (Sine), the per-tick float math
+ * - shaping.table       the same curve through a CurveTable lookup
+ * - drive.mecanum       DriveMixer::mix, four mecanum wheels with desaturation
+ * - spectrum.slice      one Spectrum (256 points) slice: a frame load, a stage or the split
+ * - canvas.text         clear + six lines of DisplayCanvas::drawText
+ * - canvas.shapes       dotted grid, frames, bars and lines (framebuffer kernels)
+ * - canvas.sendBuffer   full-frame DisplayCanvas::sendBuffer (invalidated; not in page mode)
+ * - canvas.frame        one invalidated firstPage()/nextPage() pass drawing canvas.shapes:
+ *                       render plus transfer, comparable across ILITE_DISPLAY_PAGE_BUFFER builds
+ *
+ * In page-buffer builds canvas.text and canvas.shapes only fill the first
+ * band. After the kernels, DisplayBus::benchmark prints the buffer mode and
+ * its RAM, then the sustained full-frame rate of the default panel at each
+ * standard bus clock ("[Display]" lines). For the RAM/FPS trade-off, run
+ * the suite once per buffer mode and compare:
+ *
+ *     PLATFORMIO_BUILD_FLAGS=-DILITE_DISPLAY_PAGE_BUFFER=2 pio run -e ILITE_bench -t upload
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include "MicroBench.h"
+#include "InverseKinematics.h"
+#include "mech_arm_ik.h"
+#include "ControlShaping.h"
+#include "DriveMixer.h"
+#include "Spectrum.h"
+
+#ifndef ILITE_NATIVE
+#include <U8g2lib.h>
+#include "ILITE.h"
+#include "DisplayBus.h"
+#include "DisplayCanvas.h"
+#include "MenuRegistry.h"
+#include "ModuleRegistry.h"
+#include "PacketRouter.h"
+#include "telemetry.h"
+#endif
+
+namespace {
+
+constexpr uint32_t kIterations = 5000;
+constexpr uint32_t kWarmup = 50;
+constexpr uint32_t kDisplayIterations = 200;    // sendBuffer is ~ms over I2C
+
+struct Sweep {
+    uint32_t step = 0;
+    volatile uint32_t sink = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Arm solvers (device and native)
+// ----------------------------------------------------------------------------
+
+struct IkContext : Sweep {
+    IKEngine::InverseKinematics solver;
+};
+
+void solvePlanarKernel(void* context) {
+    IkContext& ik = *static_cast<IkContext*>(context);
+    const uint32_t i = ik.step++;
+    IKEngine::IKSolution solution;
+    ik.solver.solvePlanar(150.0f + static_cast<float>(i % 200), static_cast<float>(i % 150) - 50.0f,
+                          0.0f, solution);
+    ik.sink += solution.reachable ? 1 : 0;
+}
+
+struct MechArmContext : Sweep {
+    mech::MechArmIK arm;
+};
+
+void mechArmKernel(void* context) {
+    MechArmContext& mech = *static_cast<MechArmContext*>(context);
+    const uint32_t i = mech.step++;
+    const mech::Vec3 target(120.0f + static_cast<float>(i % 160),
+                            static_cast<float>(i % 90) - 45.0f,
+                            60.0f + static_cast<float>(i % 120));
+    mech.sink += mech.arm.solve(target, (i & 1) != 0) ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------
+// Control shaping (device and native)
+// ----------------------------------------------------------------------------
+
+struct ShapingContext : Sweep {
+    ControlShaping::CurveTable table{ControlShaping::Curve::Sine, 0.6f};
+    volatile float out = 0.0f;
+};
+
+inline float sweepInput(uint32_t i) {
+    return static_cast<float>(static_cast<int32_t>(i % 201) - 100) * 0.01f;
+}
+
+void shapingEvalKernel(void* context) {
+    ShapingContext& shaping = *static_cast<ShapingContext*>(context);
+    const float v = sweepInput(shaping.step++);
+    const float shaped = ControlShaping::evaluateCurve(ControlShaping::Curve::Sine, 0.6f, fabsf(v));
+    shaping.out = v < 0.0f ? -shaped : shaped;
+}
+
+void shapingTableKernel(void* context) {
+    ShapingContext& shaping = *static_cast<ShapingContext*>(context);
+    shaping.out = shaping.table.apply(sweepInput(shaping.step++));
+}
+
+// ----------------------------------------------------------------------------
+// Drive mixing (device and native)
+// ----------------------------------------------------------------------------
+
+struct DriveContext : Sweep {
+    DriveMixer mixer{DriveMixer::Layout::Mecanum};
+    volatile float out = 0.0f;
+};
+
+void driveMixKernel(void* context) {
+    DriveContext& drive = *static_cast<DriveContext*>(context);
+    const uint32_t i = drive.step++;
+    float wheels[DriveMixer::kMaxWheels];
+    drive.mixer.mix({sweepInput(i), sweepInput(i * 7), sweepInput(i * 13)}, wheels);
+    drive.out = wheels[0] + wheels[3];
+}
+
+// ----------------------------------------------------------------------------
+// Spectrum slices (device and native)
+// ----------------------------------------------------------------------------
+
+struct SpectrumContext : Sweep {
+    Spectrum spectrum{256};
+    int16_t frame[256];
+    volatile float out = 0.0f;
+
+    SpectrumContext() {
+        for (size_t n = 0; n < 256; ++n) {
+            frame[n] = static_cast<int16_t>(sweepInput(static_cast<uint32_t>(n * 37)) * 1000.0f);
+        }
+    }
+};
+
+void spectrumSliceKernel(void* context) {
+    SpectrumContext& fft = *static_cast<SpectrumContext*>(context);
+    if (!fft.spectrum.isBusy()) {
+        fft.spectrum.begin(fft.frame, 100.0f);
+    } else if (fft.spectrum.step()) {
+        fft.out = fft.spectrum.getDominantHz();
+    }
+}
+
+#ifndef ILITE_NATIVE
+
+// ----------------------------------------------------------------------------
+// Device-only kernels
+// ----------------------------------------------------------------------------
+
+struct RouterContext {
+    uint8_t mac[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+    uint8_t frame[64] = {};
+    size_t length = 0;
+};
+
+void routeKernel(void* context) {
+    RouterContext& router = *static_cast<RouterContext*>(context);
+    PacketRouter::getInstance().routePacket(router.mac, router.frame, router.length);
+}
+
+void pidSampleKernel(void*) {
+    telemetry.pitch += 0.25f;
+    appendPidSample();
+}
+
+void menuKernel(void* context) {
+    Sweep& sweep = *static_cast<Sweep*>(context);
+    sweep.sink += MenuRegistry::getVisibleEntries(MENU_ROOT).count;
+}
+
+void menuColdKernel(void* context) {
+    MenuRegistry::invalidateVisibility();
+    menuKernel(context);
+}
+
+void canvasTextKernel(void* context) {
+    DisplayCanvas& canvas = *static_cast<DisplayCanvas*>(context);
+    canvas.clear();
+    canvas.drawText(0, 10, "Battery:");
+    canvas.drawText(0, 20, "RSSI -61 dBm");
+    canvas.drawText(0, 30, "Pitch  +12.4");
+    canvas.drawText(0, 40, "Roll    -3.1");
+    canvas.drawText(0, 50, "Yaw   +178.0");
+    canvas.drawText(0, 60, "Link OK");
+}
+
+void canvasShapesKernel(void* context) {
+    DisplayCanvas& canvas = *static_cast<DisplayCanvas*>(context);
+    canvas.clear();
+    for (int16_t i = 0; i < 8; i++) {
+        canvas.drawPatternLine(0, i * 8, 127, 63 - i * 8, 0x01, 4);
+    }
+    canvas.drawRect(2, 20, 72, 10, false);
+    canvas.drawRect(38, 21, 30, 8, true);
+    canvas.drawVLine(50, 20, 10);
+    canvas.drawLine(80, 10, 120, 50);
+    canvas.drawLine(80, 50, 120, 10);
+    canvas.invertRect(0, 0, 128, 12);
+}
+
+void sendBufferKernel(void* context) {
+    DisplayCanvas& canvas = *static_cast<DisplayCanvas*>(context);
+    canvas.invalidate();
+    canvas.sendBuffer();
+}
+
+void frameKernel(void* context) {
+    DisplayCanvas& canvas = *static_cast<DisplayCanvas*>(context);
+    canvas.invalidate();
+    canvas.firstPage();
+    do {
+        canvasShapesKernel(context);
+    } while (canvas.nextPage());
+}
+
+U8G2* u8g2 = nullptr;
+DisplayCanvas* canvas = nullptr;
+RouterContext routerContext;
+
+void setupDeviceKernels() {
+    u8g2 = DisplayBus::create(DisplayBusConfig());
+    if (u8g2->begin()) {
+        canvas = new DisplayCanvas(*u8g2);
+        canvas->setFont(DisplayCanvas::SMALL);
+    } else {
+        Serial.println("#note,display init failed; canvas kernels skipped");
+    }
+
+    registerBuiltInModules();
+    MenuRegistry::initBuiltInMenus();
+
+    PacketRouter& router = PacketRouter::getInstance();
+    router.begin();
+    ILITEModule* module = ModuleRegistry::findModuleById("com.ilite.drongaze");
+    router.setActiveModule(module);
+    if (module != nullptr && module->getTelemetryPacketTypeCount() > 0) {
+        const PacketDescriptor descriptor = module->getTelemetryPacketDescriptor(0);
+        routerContext.length = descriptor.minSize <= sizeof(routerContext.frame)
+                                   ? descriptor.minSize : sizeof(routerContext.frame);
+        memcpy(routerContext.frame, &descriptor.magicNumber, sizeof(descriptor.magicNumber));
+    }
+}
+
+#endif // ILITE_NATIVE
+
+void runSuite() {
+    static IkContext ik;
+    static MechArmContext mechArm;
+    static ShapingContext shaping;
+    static DriveContext drive;
+    static SpectrumContext spectrum;
+
+    MicroBench::printHeader(Serial);
+#ifndef ILITE_NATIVE
+    static Sweep menu;
+    MicroBench::print(Serial, MicroBench::run("router.route", routeKernel, &routerContext,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("telemetry.pidSample", pidSampleKernel, nullptr,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("menu.visible", menuKernel, &menu,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("menu.visibleCold", menuColdKernel, &menu,
+                                              kIterations, kWarmup));
+#endif
+    MicroBench::print(Serial, MicroBench::run("ik.solvePlanar", solvePlanarKernel, &ik,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("mecharm.solve", mechArmKernel, &mechArm,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("shaping.eval", shapingEvalKernel, &shaping,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("shaping.table", shapingTableKernel, &shaping,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("drive.mecanum", driveMixKernel, &drive,
+                                              kIterations, kWarmup));
+    MicroBench::print(Serial, MicroBench::run("spectrum.slice", spectrumSliceKernel, &spectrum,
+                                              kIterations, kWarmup));
+#ifndef ILITE_NATIVE
+    if (canvas != nullptr) {
+        MicroBench::print(Serial, MicroBench::run("canvas.text", canvasTextKernel, canvas,
+                                                  kIterations, kWarmup));
+        MicroBench::print(Serial, MicroBench::run("canvas.shapes", canvasShapesKernel, canvas,
+                                                  kIterations, kWarmup));
+        if (!canvas->isPageMode()) {
+            MicroBench::print(Serial, MicroBench::run("canvas.sendBuffer", sendBufferKernel, canvas,
+                                                      kDisplayIterations, 2));
+        }
+        MicroBench::print(Serial, MicroBench::run("canvas.frame", frameKernel, canvas,
+                                                  kDisplayIterations, 2));
+        DisplayBus::benchmark(*canvas, Serial);
+    }
+#endif
+    Serial.println("#done");
+}
+
+}  // namespace
+
+#ifdef ILITE_NATIVE
+
+int main() {
+    runSuite();
+    return 0;
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    delay(500);
+    setupDeviceKernels();
+    runSuite();
+}
+
+void loop() {
+    if (Serial.available() > 0) {
+        while (Serial.available() > 0) {
+            Serial.read();
+        }
+        runSuite();
+    }
+    delay(50);
+}
+
+#endif // ILITE_NATIVE
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <ILITEModule.h>
+#include <PacketLayout.h>
 
 /**
  * @brief Minimal robot control module
@@ -60,41 +61,30 @@ public:
     size_t getCommandPacketTypeCount() const override { return 1; }
 
     PacketDescriptor getCommandPacketDescriptor(size_t index) const override {
-        static const PacketDescriptor::Field fields[] = {
-            {"magic", 0, 4, PacketDescriptor::Field::UINT32},
-            {"leftSpeed", 4, 2, PacketDescriptor::Field::INT16},
-            {"rightSpeed", 6, 2, PacketDescriptor::Field::INT16},
-            {"flags", 8, 1, PacketDescriptor::Field::UINT8}
+        // Sizes and offsets come from CommandPacket itself (see PacketLayout.h)
+        static constexpr PacketDescriptor::Field fields[] = {
+            ILITE_PACKET_FIELD(CommandPacket, magic),
+            ILITE_PACKET_FIELD(CommandPacket, leftSpeed),
+            ILITE_PACKET_FIELD(CommandPacket, rightSpeed),
+            ILITE_PACKET_FIELD(CommandPacket, flags)
         };
-
-        return {
-            "Command",                  // name
-            0x12345678,                // magic number
-            sizeof(CommandPacket),     // minSize
-            sizeof(CommandPacket),     // maxSize
-            true,                      // usesMagic
-            fields,                    // field definitions
-            4                          // fieldCount
+        static constexpr PacketDescriptor descriptor = {
+            ILITE_PACKET_WITH_FIELDS(CommandPacket, "Command", 0x12345678, fields)
         };
+        return descriptor;
     }
 
     size_t getTelemetryPacketTypeCount() const override { return 1; }
 
     PacketDescriptor getTelemetryPacketDescriptor(size_t index) const override {
-        static const PacketDescriptor::Field fields[] = {
-            {"magic", 0, 4, PacketDescriptor::Field::UINT32},
-            {"batteryVolts", 4, 4, PacketDescriptor::Field::FLOAT}
+        static constexpr PacketDescriptor::Field fields[] = {
+            ILITE_PACKET_FIELD(TelemetryPacket, magic),
+            ILITE_PACKET_FIELD(TelemetryPacket, batteryVolts)
         };
-
-        return {
-            "Telemetry",
-            0x87654321,
-            sizeof(TelemetryPacket),
-            sizeof(TelemetryPacket),
-            true,
-            fields,
-            2
+        static constexpr PacketDescriptor descriptor = {
+            ILITE_PACKET_WITH_FIELDS(TelemetryPacket, "Telemetry", 0x87654321, fields)
         };
+        return descriptor;
     }
 
     // ========================================================================
@@ -181,6 +171,19 @@ public:
         }
     }
 
+    // ========================================================================
+    // Callback Budgets (OPTIONAL - framework defaults otherwise)
+    // ========================================================================
+
+    // The framework times every callback; a dashboard that keeps running
+    // over its budget is skipped on most frames (see ModuleBudget.h)
+    uint32_t getCallbackBudgetUs(ModuleCallback callback) const override {
+        if (callback == ModuleCallback::Draw) {
+            return 10000;  // This dashboard is simple; 10 ms is plenty
+        }
+        return ILITEModule::getCallbackBudgetUs(callback);
+    }
+
     // ========================================================================
     // Function Buttons (OPTIONAL)
     // ========================================================================
@@ -0,0 +1,788 @@
+/**
+ * @file native_core.cpp
+ * @brief Headless run of the framework core on the PC, over the simulated radio
+ *
+ * Two parts:
+ *
+ * - Link simulation (virtual clock, seeded loss, so every run prints the
+ *   same numbers): a 50 Hz control loop sends drive and arm command frames
+ *   through TxWindow to a scripted robot over SimRadio. The robot answers
+ *   each frame with telemetry, which comes back through the ESP-NOW receive
+ *   callback into RxRing and TelemetryStore as on the controller. A burst
+ *   of encoder edits then goes through ParamSync with the robot
+ *   acknowledging parameter frames. The scripted robot parses commands
+ *   with the ILITERobot Dispatcher.
+ * - Robot library conformance: frames from the controller's writers
+ *   (bundle, redundancy, stamp, rate request) go through the ILITERobot
+ *   Dispatcher and TelemetryScheduler, and the robot's bundled, echoed,
+ *   delta-encoded telemetry is read back with the controller's readers.
+ *   TheGill's arm state then goes through DeltaPacketWriter and
+ *   DeltaPacketReader on its own, to compare its size with plain packets.
+ * - Benchmarks (host clock): ns/op of the hot paths that do not need
+ *   hardware, on both ends of the link.
+ *
+ * The simulation and conformance runs check their results; any failed
+ * check is printed and makes the program exit with status 1.
+ *
+ * Build and run with the `native` PlatformIO environment:
+ *
+ *     pio run -e native && .pio/build/native/program
+ *
+ * or directly:
+ *
+ *     g++ -O2 -std=gnu++17 -DILITE_NATIVE -Inative/shim -Inative/sim -Ilib/ILITE/include \
+ *         -Ilib/ILITERobot/include examples/NativeCore/native_core.cpp \
+ *         native/shim/NativeShim.cpp native/sim/SimRadio.cpp \
+ *         lib/ILITE/src/{RxRing,TelemetryStore,PacketBundle,RedundantPacket,TxWindow,\
+ *         ParamSync,Transport,InverseKinematics,SeriesBuffer,DeltaPacket,RateRequest,\
+ *         CommandStamp}.cpp -o native_core
+ *
+ * Host timings only rank variants against each other; they are not ESP32
+ * numbers.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include "SimRadio.h"
+#include "RxRing.h"
+#include "TelemetryStore.h"
+#include "PacketBundle.h"
+#include "RedundantPacket.h"
+#include "TxWindow.h"
+#include "ParamSync.h"
+#include "Transport.h"
+#include "InverseKinematics.h"
+#include "SeriesBuffer.h"
+#include "DeltaPacket.h"
+#include "RateRequest.h"
+#include "CommandStamp.h"
+#include "ILITERobot.h"
+#include "thegill.h"
+
+#include <chrono>
+
+// The robot library carries its own copy of the wire format
+static_assert(ILITERobot::kBundleMagic == BUNDLE_PACKET_MAGIC, "Bundle magic differs");
+static_assert(ILITERobot::kStampMagic == STAMP_PACKET_MAGIC, "Stamp magic differs");
+static_assert(ILITERobot::kEchoMagic == ECHO_PACKET_MAGIC, "Echo magic differs");
+static_assert(ILITERobot::kRateRequestMagic == RATE_REQUEST_MAGIC, "Rate request magic differs");
+static_assert(ILITERobot::kDeltaMagic == DELTA_PACKET_MAGIC, "Delta magic differs");
+static_assert(ILITERobot::kRedundantMagic == REDUNDANT_PACKET_MAGIC, "Redundant magic differs");
+static_assert(ILITERobot::kBundleHeaderSize == PacketBundleWriter::kHeaderSize, "Bundle header differs");
+static_assert(ILITERobot::kRedundantHeaderSize == RedundantPacketWriter::kHeaderSize &&
+              ILITERobot::kRedundantMaxDepth == RedundantPacketWriter::kMaxDepth, "Redundant framing differs");
+static_assert(ILITERobot::kRateHeaderSize == RateRequestWriter::kHeaderSize &&
+              ILITERobot::kRateEntrySize == RateRequestWriter::kEntrySize &&
+              ILITERobot::kRateMaxEntries == RateRequestWriter::kMaxEntries &&
+              ILITERobot::kRateTimeoutMs == RateRequestFollower::kTimeoutMs, "Rate request framing differs");
+static_assert(ILITERobot::kDeltaHeaderSize == DeltaPacketWriter::kHeaderSize &&
+              ILITERobot::kDeltaMaxPacketSize == DeltaLayout::kMaxPacketSize &&
+              ILITERobot::kDeltaMaxSegments == DeltaLayout::kMaxSegments, "Delta framing differs");
+static_assert(ILITERobot::kStampSize == kCommandStampSize, "Stamp header differs");
+
+namespace {
+
+const uint8_t kRobotMac[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+constexpr uint32_t kTickUs = 20000;         // 50 Hz control loop
+constexpr uint32_t kDriveMagic = 0x44525645;
+constexpr uint32_t kArmMagic = 0x41524D31;
+constexpr uint32_t kTelemetryMagic = 0x54454C45;
+constexpr uint32_t kParamMagic = 0x50415241;
+constexpr uint32_t kParamAckMagic = 0x50414B31;
+
+struct DriveCommand {
+    uint32_t magic;
+    int16_t left;
+    int16_t right;
+} __attribute__((packed));
+
+struct ArmCommand {
+    uint32_t magic;
+    int16_t joints[4];
+} __attribute__((packed));
+
+struct Telemetry {
+    uint32_t magic;
+    uint32_t framesSeen;
+    int16_t lastLeft;
+} __attribute__((packed));
+
+RxRing rxRing;
+uint32_t sendCallbacks = 0;
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        Serial.printf("  FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+void onSent(const uint8_t* mac, esp_now_send_status_t status) {
+    (void)status;
+    sendCallbacks++;
+    TxWindow::onSendComplete(mac);
+}
+
+void onReceive(const uint8_t* mac, const uint8_t* data, int len) {
+    rxRing.push(mac, data, len);
+}
+
+// --------------------------------------------------------------------------
+// Scripted robot
+// --------------------------------------------------------------------------
+
+struct Robot {
+    uint32_t framesSeen = 0;
+    int16_t lastLeft = 0;
+    uint16_t paramAcks = 0;
+    bool paramFrame = false;
+};
+
+Robot robot;
+ILITERobot::Dispatcher robotDispatcher;
+
+void robotOnDrive(const DriveCommand& drive, void* context) {
+    static_cast<Robot*>(context)->lastLeft = drive.left;
+}
+
+void robotOnArm(const ArmCommand& arm, void* context) {
+    (void)arm;
+    (void)context;
+}
+
+void robotOnParams(const uint8_t* packet, size_t length, void* context) {
+    (void)length;
+    // [magic][sequence:2][values...]: acknowledge the sequence
+    Robot& state = *static_cast<Robot*>(context);
+    uint8_t ack[6];
+    memcpy(ack, &kParamAckMagic, 4);
+    memcpy(ack + 4, packet + 4, 2);
+    state.paramAcks++;
+    state.paramFrame = true;
+    SimRadio::reply(kRobotMac, ack, sizeof(ack));
+}
+
+void resetRobot() {
+    robot = Robot{};
+    robotDispatcher = ILITERobot::Dispatcher();
+    robotDispatcher.addPacket<DriveCommand>(kDriveMagic, robotOnDrive, &robot);
+    robotDispatcher.addPacket<ArmCommand>(kArmMagic, robotOnArm, &robot);
+    robotDispatcher.addRoute(kParamMagic, 6, ILITERobot::kMaxFrameSize, robotOnParams, &robot);
+}
+
+void robotHandler(const uint8_t* from, const uint8_t* data, size_t length) {
+    (void)from;
+    if (length < sizeof(uint32_t)) {
+        return;
+    }
+    robot.paramFrame = false;
+    robotDispatcher.handle(data, length);
+    if (robot.paramFrame) {
+        return;
+    }
+
+    robot.framesSeen++;
+    const Telemetry telemetry{kTelemetryMagic, robot.framesSeen, robot.lastLeft};
+    SimRadio::reply(kRobotMac, reinterpret_cast<const uint8_t*>(&telemetry), sizeof(telemetry));
+}
+
+// --------------------------------------------------------------------------
+// Parameter channel
+// --------------------------------------------------------------------------
+
+ParamSync* paramSync = nullptr;
+
+bool sendParams(uint16_t sequence, const ParamValue* values, size_t count) {
+    uint8_t frame[6 + ParamSync::kMaxParams * 5];
+    memcpy(frame, &kParamMagic, 4);
+    memcpy(frame + 4, &sequence, 2);
+    size_t length = 6;
+    for (size_t i = 0; i < count; ++i) {
+        frame[length] = values[i].id;
+        memcpy(frame + length + 1, &values[i].value, 4);
+        length += 5;
+    }
+    return Transport::getActive().send(kRobotMac, frame, length) == ESP_OK;
+}
+
+size_t drainReplies(TelemetryStore& store) {
+    size_t frames = 0;
+    while (const RxFrame* frame = rxRing.front()) {
+        uint32_t magic = 0;
+        memcpy(&magic, frame->data, sizeof(magic));
+        if (magic == kParamAckMagic && frame->length >= 6) {
+            uint16_t sequence;
+            memcpy(&sequence, frame->data + 4, sizeof(sequence));
+            paramSync->acknowledge(sequence);
+        } else {
+            store.publish(0, frame->data, frame->length);
+        }
+        rxRing.pop();
+        frames++;
+    }
+    return frames;
+}
+
+void runLinkSimulation(float lossRate) {
+    NativeClock::useVirtualTime(1000000);
+    SimRadio::reset();
+    SimLinkConfig link;
+    link.lossRate = lossRate;
+    link.queueDepth = 4;
+    link.seed = 42;
+    SimRadio::configure(link);
+    SimRadio::addPeer(kRobotMac, robotHandler);
+    esp_now_init();
+    esp_now_register_send_cb(onSent);
+    esp_now_register_recv_cb(onReceive);
+    Transport::setSentCallback(nullptr);    // The driver callback above covers ESP-NOW
+    TxWindow::begin(2);
+    resetRobot();
+    sendCallbacks = 0;
+
+    TelemetryStore& store = TelemetryStore::getInstance();
+    store.reset();
+
+    ParamSync params(sendParams);
+    paramSync = &params;
+
+    constexpr int kTicks = 500;             // 10 s
+    size_t repliesDrained = 0;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        // Scripted inputs: a slow sweep on the drive, arm moving every 5th tick
+        const DriveCommand drive{kDriveMagic, static_cast<int16_t>((tick % 200) - 100),
+                                 static_cast<int16_t>(100 - (tick % 200))};
+        TxWindow::submit(kRobotMac, 0, reinterpret_cast<const uint8_t*>(&drive), sizeof(drive));
+        if (tick % 5 == 0) {
+            const ArmCommand arm{kArmMagic, {static_cast<int16_t>(tick), 0, 0, 0}};
+            TxWindow::submit(kRobotMac, 1, reinterpret_cast<const uint8_t*>(&arm), sizeof(arm));
+        }
+
+        // A fast encoder spin on one gain between 2 s and 2.5 s
+        if (tick >= 100 && tick < 125) {
+            params.set(0, 1.0f + 0.01f * static_cast<float>(tick - 100));
+        }
+        params.service(millis());
+        TxWindow::pump(2 * kTickUs);
+
+        SimRadio::advanceUs(kTickUs);
+        repliesDrained += drainReplies(store);
+    }
+    // Let the last frames settle
+    for (int i = 0; i < 100 && params.getPendingCount() > 0; ++i) {
+        params.service(millis());
+        SimRadio::advanceUs(kTickUs);
+        repliesDrained += drainReplies(store);
+    }
+
+    const SimRadioStats& radio = SimRadio::getStats();
+    const TxWindowStats window = TxWindow::getStats();
+    const ParamSyncStats sync = params.getStats();
+    Telemetry last{};
+    store.getSlot(0)->read(&last, sizeof(last));
+
+    Serial.printf("\n[Sim] loss=%.0f%% ticks=%d (virtual %.1f s)\n", lossRate * 100.0f, kTicks,
+                  kTicks * kTickUs / 1e6);
+    Serial.printf("  radio: sent=%u delivered=%u lost=%u queue full=%u replies=%u received=%u\n",
+                  radio.sent, radio.delivered, radio.lost, radio.queueFull, radio.replies,
+                  radio.received);
+    Serial.printf("  window: sent=%u held=%u coalesced=%u dropped=%u timeouts=%u callbacks=%u\n",
+                  window.sent, window.held, window.coalesced, window.dropped, window.timeouts,
+                  sendCallbacks);
+    Serial.printf("  robot: frames=%u telemetry drained=%zu last frames seen=%u\n",
+                  robot.framesSeen, repliesDrained, last.framesSeen);
+    Serial.printf("  params: edits=%u coalesced=%u frames=%u resends=%u acks=%u pending=%zu\n",
+                  sync.edits, sync.coalesced, sync.frames, sync.resends, sync.acks,
+                  params.getPendingCount());
+
+    check(params.getPendingCount() == 0, "parameter edits left unacknowledged");
+    check(sync.acks > 0 && sync.frames >= sync.acks, "parameter frames and acks disagree");
+    check(window.dropped == 0 && window.timeouts == 0, "command window dropped frames");
+    check(sendCallbacks == radio.sent, "a send without a completion callback");
+    check(last.framesSeen != 0 && last.framesSeen <= robot.framesSeen, "telemetry store behind the robot");
+    if (lossRate == 0.0f) {
+        // A clean link delivers every command and every reply
+        check(radio.lost == 0 && radio.delivered == radio.sent, "frames lost on a clean link");
+        check(robot.framesSeen == window.sent, "robot missed command frames");
+        check(repliesDrained == radio.replies, "replies missing from the receive ring");
+        check(last.framesSeen == robot.framesSeen, "latest telemetry is not the last reply");
+    }
+    paramSync = nullptr;
+}
+
+// --------------------------------------------------------------------------
+// Robot library conformance
+// --------------------------------------------------------------------------
+
+constexpr uint32_t kStateMagic = 0x53544154;
+constexpr uint32_t kStatusMagic = 0x53545331;
+
+struct RobotState {
+    uint32_t magic;
+    uint32_t sampleUs;
+    int16_t wheels[2];
+    float heading;
+    int16_t currents[4];
+    uint16_t temperatures[2];
+    uint8_t flags[3];
+} __attribute__((packed));
+
+struct RobotStatus {
+    uint32_t magic;
+    uint16_t batteryMv;
+    uint8_t mode;
+} __attribute__((packed));
+
+// The controller's descriptor fields and the robot's copy of them
+const PacketDescriptor::Field kStateFields[] = {
+    {"magic", 0, 4, PacketDescriptor::Field::UINT32},
+    {"sampleUs", 4, 4, PacketDescriptor::Field::UINT32},
+    {"left", 8, 2, PacketDescriptor::Field::INT16},
+    {"right", 10, 2, PacketDescriptor::Field::INT16},
+    {"heading", 12, 4, PacketDescriptor::Field::FLOAT},
+    {"current0", 16, 2, PacketDescriptor::Field::INT16},
+    {"current1", 18, 2, PacketDescriptor::Field::INT16},
+    {"current2", 20, 2, PacketDescriptor::Field::INT16},
+    {"current3", 22, 2, PacketDescriptor::Field::INT16},
+    {"temp0", 24, 2, PacketDescriptor::Field::UINT16},
+    {"temp1", 26, 2, PacketDescriptor::Field::UINT16},
+    {"flags", 28, 3, PacketDescriptor::Field::BYTE_ARRAY},
+};
+
+const ILITERobot::DeltaField kRobotStateFields[] = {
+    {0, 4, ILITERobot::DeltaField::Integer},
+    {4, 4, ILITERobot::DeltaField::Integer},
+    {8, 2, ILITERobot::DeltaField::Integer},
+    {10, 2, ILITERobot::DeltaField::Integer},
+    {12, 4, ILITERobot::DeltaField::Float},
+    {16, 2, ILITERobot::DeltaField::Integer},
+    {18, 2, ILITERobot::DeltaField::Integer},
+    {20, 2, ILITERobot::DeltaField::Integer},
+    {22, 2, ILITERobot::DeltaField::Integer},
+    {24, 2, ILITERobot::DeltaField::Integer},
+    {26, 2, ILITERobot::DeltaField::Integer},
+    {28, 3, ILITERobot::DeltaField::Bytes},
+};
+
+struct Conformance {
+    // Commands
+    uint32_t drives = 0;
+    uint32_t arms = 0;
+    int16_t lastArm = -1;
+    bool armsInOrder = true;
+    // Telemetry
+    RobotState state{};
+    RobotStatus status{};
+    RobotState sentState{};
+    RobotStatus sentStatus{};
+    DeltaPacketReader stateReader;
+    uint32_t echoSeq = 0;
+    uint32_t bytesSent = 0;
+    uint32_t bytesPlain = 0;
+    uint32_t decoded = 0;
+    uint32_t mismatches = 0;
+};
+
+void conformanceOnDrive(const DriveCommand& drive, void* context) {
+    (void)drive;
+    static_cast<Conformance*>(context)->drives++;
+}
+
+void conformanceOnArm(const ArmCommand& arm, void* context) {
+    Conformance& c = *static_cast<Conformance*>(context);
+    c.armsInOrder = c.armsInOrder && arm.joints[0] == c.lastArm + 1;
+    c.lastArm = arm.joints[0];
+    c.arms++;
+}
+
+size_t buildState(uint8_t* out, size_t capacity, void* context) {
+    Conformance& c = *static_cast<Conformance*>(context);
+    if (capacity < sizeof(c.state)) {
+        return 0;
+    }
+    c.sentState = c.state;
+    memcpy(out, &c.state, sizeof(c.state));
+    c.bytesPlain += sizeof(c.state);
+    return sizeof(c.state);
+}
+
+size_t buildStatus(uint8_t* out, size_t capacity, void* context) {
+    Conformance& c = *static_cast<Conformance*>(context);
+    if (capacity < sizeof(c.status)) {
+        return 0;
+    }
+    c.sentStatus = c.status;
+    memcpy(out, &c.status, sizeof(c.status));
+    c.bytesPlain += sizeof(c.status);
+    return sizeof(c.status);
+}
+
+// Controller side of the telemetry: the framework's own readers
+void checkTelemetryPacket(const uint8_t* packet, size_t length, void* context) {
+    Conformance& c = *static_cast<Conformance*>(context);
+    uint8_t rebuilt[DeltaLayout::kMaxPacketSize];
+    if (isDeltaPacket(packet, length)) {
+        length = c.stateReader.decode(packet, length, rebuilt, sizeof(rebuilt));
+        packet = rebuilt;
+    }
+    uint32_t magic = 0;
+    if (length >= sizeof(magic)) {
+        memcpy(&magic, packet, sizeof(magic));
+    }
+    const bool match = (magic == kStateMagic && length == sizeof(c.sentState) &&
+                        memcmp(packet, &c.sentState, length) == 0) ||
+                       (magic == kStatusMagic && length == sizeof(c.sentStatus) &&
+                        memcmp(packet, &c.sentStatus, length) == 0);
+    if (match) {
+        c.decoded++;
+    } else {
+        c.mismatches++;
+    }
+}
+
+bool conformanceSend(const uint8_t* mac, const uint8_t* data, size_t length, void* context) {
+    (void)mac;
+    Conformance& c = *static_cast<Conformance*>(context);
+    c.bytesSent += length;
+    CommandStampHeader echo;
+    size_t innerLength = 0;
+    const uint8_t* inner = unwrapStampedFrame(data, length, ECHO_PACKET_MAGIC, echo, innerLength);
+    if (inner != nullptr) {
+        c.echoSeq = echo.sequence;
+        data = inner;
+        length = innerLength;
+    }
+    if (isPacketBundle(data, length)) {
+        if (forEachBundledPacket(data, length, checkTelemetryPacket, &c) < 0) {
+            c.mismatches++;
+        }
+    } else {
+        checkTelemetryPacket(data, length, &c);
+    }
+    return true;
+}
+
+void runRobotConformance() {
+    Conformance c;
+    c.stateReader.configure(kStateFields, sizeof(kStateFields) / sizeof(kStateFields[0]), sizeof(RobotState));
+
+    ILITERobot::Dispatcher dispatcher;
+    ILITERobot::TelemetryScheduler telemetry(conformanceSend, &c);
+    dispatcher.addPacket<DriveCommand>(kDriveMagic, conformanceOnDrive, &c);
+    dispatcher.addPacket<ArmCommand>(kArmMagic, conformanceOnArm, &c);
+    dispatcher.addRoute(ILITERobot::kRateRequestMagic, ILITERobot::kRateHeaderSize,
+                        ILITERobot::kMaxFrameSize, ILITERobot::TelemetryScheduler::rateRoute, &telemetry);
+    telemetry.addType(kStateMagic, 100, buildState, &c);
+    telemetry.addType(kStatusMagic, 100, buildStatus, &c);
+    telemetry.enableDelta(kStateMagic, kRobotStateFields,
+                          sizeof(kRobotStateFields) / sizeof(kRobotStateFields[0]), sizeof(RobotState));
+    telemetry.setEcho(true);
+
+    // Commands as CommTask frames them: stamped bundle of drive + redundant arm,
+    // every fourth frame lost
+    constexpr int kFrames = 200;
+    RedundantPacketWriter armHistory;
+    uint32_t lastDelivered = 0;
+    int lost = 0;
+    for (int i = 0; i < kFrames; ++i) {
+        const DriveCommand drive{kDriveMagic, static_cast<int16_t>(i), static_cast<int16_t>(-i)};
+        const ArmCommand arm{kArmMagic, {static_cast<int16_t>(i), 0, 0, 0}};
+        uint8_t armFrame[64];
+        const size_t armLength = armHistory.wrap(reinterpret_cast<const uint8_t*>(&arm), sizeof(arm), 2,
+                                                 armFrame, sizeof(armFrame));
+        PacketBundleWriter bundle;
+        bundle.setHeadroom(kCommandStampSize);
+        bundle.append(reinterpret_cast<const uint8_t*>(&drive), sizeof(drive));
+        bundle.append(armFrame, armLength);
+        const CommandStampHeader stamp{STAMP_PACKET_MAGIC, static_cast<uint32_t>(i + 1),
+                                       static_cast<uint32_t>(i) * kTickUs};
+        uint8_t frame[PacketBundleWriter::kMaxFrameSize];
+        const size_t length = writeStampedFrame(frame, sizeof(frame), stamp, bundle.data(), bundle.size());
+        if (i % 4 == 3) {
+            lost++;
+            continue;
+        }
+        dispatcher.handle(frame, length);
+        lastDelivered = stamp.sequence;
+    }
+    const ILITERobot::DispatchStats& dispatch = dispatcher.getStats();
+    const ILITERobot::StampHeader* applied = dispatcher.getStamp();
+    Serial.printf("\n[Robot] companion library against the controller's framing\n");
+    Serial.printf("  commands: frames=%d lost=%d drives=%u arms=%u recovered=%u in order=%s stamp=%u/%u\n",
+                  kFrames, lost, c.drives, c.arms, dispatch.recovered, c.armsInOrder ? "yes" : "NO",
+                  applied != nullptr ? applied->sequence : 0, lastDelivered);
+
+    // Rate request for the state only; the status keeps its default
+    RateRequestWriter rates;
+    rates.setCount(2);
+    rates.set(0, kStateMagic, 50.0f);
+    rates.set(1, kStatusMagic, 0.0f);
+    uint8_t request[RateRequestWriter::kMaxFrameSize];
+    const size_t requestLength = rates.poll(0, request, sizeof(request));
+    dispatcher.handle(request, requestLength);
+    Serial.printf("  rates: state %u ms (asked 50 Hz), status %u ms (default)\n",
+                  telemetry.getIntervalMs(kStateMagic, 0), telemetry.getIntervalMs(kStatusMagic, 0));
+
+    // Telemetry for 5 s of robot loop at 200 Hz
+    c.state = RobotState{kStateMagic, 0, {0, 0}, 0.0f, {1200, 1150, 300, 0}, {410, 395}, {1, 0, 0}};
+    c.status = RobotStatus{kStatusMagic, 12000, 1};
+    for (uint32_t ms = 0; ms < 5000; ms += 5) {
+        c.state.sampleUs = ms * 1000;
+        c.state.wheels[0] = static_cast<int16_t>((ms / 5) % 400 - 200);
+        c.state.wheels[1] = static_cast<int16_t>(200 - (ms / 5) % 400);
+        c.state.heading = 0.001f * static_cast<float>(ms);
+        c.state.currents[2] = static_cast<int16_t>(300 + (ms / 250) % 8);
+        c.state.temperatures[0] = static_cast<uint16_t>(410 + ms / 1000);
+        c.state.flags[1] = static_cast<uint8_t>(ms / 1000);
+        c.status.batteryMv = static_cast<uint16_t>(12000 - ms / 100);
+        telemetry.poll(kRobotMac, ms, dispatcher.getStamp());
+    }
+    const ILITERobot::TelemetryStats& sent = telemetry.getStats();
+    Serial.printf("  telemetry: frames=%u packets=%u bundles=%u keyframes=%u deltas=%u echo seq=%u\n",
+                  sent.frames, sent.packets, sent.bundles, sent.keyframes, sent.deltas, c.echoSeq);
+    Serial.printf("  decoded by the controller: %u, mismatches %u, bytes %u + %u echo (%u as plain packets)\n",
+                  c.decoded, c.mismatches, static_cast<uint32_t>(c.bytesSent - sent.echoes * kCommandStampSize),
+                  static_cast<uint32_t>(sent.echoes * kCommandStampSize), c.bytesPlain);
+
+    check(c.drives == static_cast<uint32_t>(kFrames - lost), "drive commands lost or repeated");
+    // Redundancy recovers each arm command whose frame was lost, once
+    check(c.armsInOrder && c.arms == lastDelivered, "arm commands not recovered in order");
+    check(applied != nullptr && applied->sequence == lastDelivered, "stamp is not the last frame's");
+    check(telemetry.getIntervalMs(kStateMagic, 0) == 20 && telemetry.getIntervalMs(kStatusMagic, 0) == 100,
+          "rate request not applied");
+    check(c.mismatches == 0 && c.decoded == sent.packets, "telemetry not read back intact");
+    check(sent.keyframes > 0 && sent.deltas > 0, "delta encoding not exercised");
+    check(c.echoSeq == lastDelivered, "echo does not carry the last command");
+}
+
+// --------------------------------------------------------------------------
+// Arm state deltas
+// --------------------------------------------------------------------------
+
+// Copy of the field table TheGill's arm state descriptor carries
+// (ModuleRegistration.cpp)
+const PacketDescriptor::Field kArmStateFields[] = {
+    {"magic", offsetof(ArmStatePacket, magic), 4, PacketDescriptor::Field::UINT32},
+    {"base", offsetof(ArmStatePacket, baseDegrees), 4, PacketDescriptor::Field::FLOAT},
+    {"extensionCm", offsetof(ArmStatePacket, extensionCentimeters), 4, PacketDescriptor::Field::FLOAT},
+    {"shoulder", offsetof(ArmStatePacket, servoDegrees) + 0, 4, PacketDescriptor::Field::FLOAT},
+    {"elbow", offsetof(ArmStatePacket, servoDegrees) + 4, 4, PacketDescriptor::Field::FLOAT},
+    {"pitch", offsetof(ArmStatePacket, servoDegrees) + 8, 4, PacketDescriptor::Field::FLOAT},
+    {"roll", offsetof(ArmStatePacket, servoDegrees) + 12, 4, PacketDescriptor::Field::FLOAT},
+    {"yaw", offsetof(ArmStatePacket, servoDegrees) + 16, 4, PacketDescriptor::Field::FLOAT},
+    {"enabledMask", offsetof(ArmStatePacket, servoEnabledMask), 1, PacketDescriptor::Field::UINT8},
+    {"attachedMask", offsetof(ArmStatePacket, servoAttachedMask), 1, PacketDescriptor::Field::UINT8},
+    {"flags", offsetof(ArmStatePacket, flags), 1, PacketDescriptor::Field::UINT8}
+};
+
+void runArmStateDeltas() {
+    constexpr size_t kFieldCount = sizeof(kArmStateFields) / sizeof(kArmStateFields[0]);
+    DeltaPacketWriter writer(kArmStateFields, kFieldCount, sizeof(ArmStatePacket));
+    DeltaPacketReader reader;
+    reader.configure(kArmStateFields, kFieldCount, sizeof(ArmStatePacket));
+
+    // 20 s at 50 Hz: the operator jogs one joint at a time, the rest hold
+    constexpr int kFrames = 1000;
+    ArmStatePacket state{THEGILL_ARM_STATE_MAGIC, 90.0f, 0.0f, {45.0f, 90.0f, 0.0f, 0.0f, 90.0f},
+                         0x1F, 0x1F, 0x3};
+    size_t bytes = 0;
+    int mismatches = 0;
+    for (int i = 0; i < kFrames; ++i) {
+        const int phase = (i / 100) % 4;
+        if (phase == 0) {
+            state.servoDegrees[0] += 0.25f;
+        } else if (phase == 1) {
+            state.servoDegrees[1] -= 0.4f;
+        } else if (phase == 2) {
+            state.baseDegrees += 0.5f;
+        }
+
+        uint8_t frame[DeltaPacketWriter::kMaxFrameSize];
+        const size_t length = writer.encode(reinterpret_cast<const uint8_t*>(&state), sizeof(state),
+                                            frame, sizeof(frame));
+        bytes += length;
+        uint8_t rebuilt[DeltaLayout::kMaxPacketSize];
+        const size_t rebuiltLength = reader.decode(frame, length, rebuilt, sizeof(rebuilt));
+        if (rebuiltLength != sizeof(state) || memcmp(rebuilt, &state, sizeof(state)) != 0) {
+            mismatches++;
+        }
+    }
+
+    const float average = static_cast<float>(bytes) / kFrames;
+    Serial.printf("\n[Arm state] %d frames delta-encoded\n", kFrames);
+    Serial.printf("  average %.1f bytes against %u plain, keyframes=%u deltas=%u mismatches=%d\n",
+                  average, static_cast<unsigned>(sizeof(ArmStatePacket)), writer.getKeyframes(),
+                  writer.getDeltas(), mismatches);
+
+    check(mismatches == 0 && reader.getDropped() == 0, "arm state not rebuilt intact");
+    check(average < sizeof(ArmStatePacket), "arm state deltas not smaller than plain packets");
+}
+
+// --------------------------------------------------------------------------
+// Benchmarks
+// --------------------------------------------------------------------------
+
+volatile uint32_t sink = 0;
+
+template <typename Fn>
+void bench(const char* name, int iterations, Fn fn) {
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const double ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    Serial.printf("  %-32s %8.1f ns/op\n", name, ns / iterations);
+}
+
+void countPacket(const uint8_t* packet, size_t length, void* context) {
+    (void)packet;
+    *static_cast<size_t*>(context) += length;
+}
+
+void runBenchmarks() {
+    Serial.println("\n[Bench] host clock");
+    constexpr int kIterations = 200000;
+
+    uint8_t packetA[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    uint8_t packetB[20] = {};
+    bench("PacketBundle append x2 + walk", kIterations, [&](int i) {
+        PacketBundleWriter writer;
+        packetA[0] = static_cast<uint8_t>(i);
+        writer.append(packetA, sizeof(packetA));
+        writer.append(packetB, sizeof(packetB));
+        size_t bytes = 0;
+        forEachBundledPacket(writer.data(), writer.size(), countPacket, &bytes);
+        sink += bytes;
+    });
+
+    RedundantPacketWriter redundantWriter;
+    RedundantPacketReader redundantReader;
+    bench("RedundantPacket wrap + deliver", kIterations, [&](int i) {
+        uint8_t frame[128];
+        packetA[0] = static_cast<uint8_t>(i);
+        const size_t length = redundantWriter.wrap(packetA, sizeof(packetA), 2, frame, sizeof(frame));
+        size_t bytes = 0;
+        redundantReader.deliver(frame, length, countPacket, &bytes);
+        sink += bytes;
+    });
+
+    bench("RxRing push + pop", kIterations, [&](int i) {
+        packetA[0] = static_cast<uint8_t>(i);
+        rxRing.push(kRobotMac, packetA, sizeof(packetA));
+        if (const RxFrame* frame = rxRing.front()) {
+            sink += frame->length;
+            rxRing.pop();
+        }
+    });
+
+    ILITERobot::RxRing<8> robotRing;
+    bench("Robot RxRing push + pop", kIterations, [&](int i) {
+        packetA[0] = static_cast<uint8_t>(i);
+        robotRing.push(kRobotMac, packetA, sizeof(packetA), static_cast<uint32_t>(i));
+        if (const ILITERobot::RxFrame* frame = robotRing.front()) {
+            sink += frame->length;
+            robotRing.pop();
+        }
+    });
+
+    ILITERobot::RedundantReader robotRedundant;
+    RedundantPacketWriter robotRedundantWriter;
+    bench("Robot RedundantReader deliver", kIterations, [&](int i) {
+        uint8_t frame[128];
+        packetA[0] = static_cast<uint8_t>(i);
+        const size_t length = robotRedundantWriter.wrap(packetA, sizeof(packetA), 2, frame, sizeof(frame));
+        size_t bytes = 0;
+        robotRedundant.deliver(frame, length, countPacket, &bytes);
+        sink += bytes;
+    });
+
+    // A stamped drive + arm bundle, built once
+    uint8_t commandFrame[PacketBundleWriter::kMaxFrameSize];
+    size_t commandLength = 0;
+    {
+        const DriveCommand drive{kDriveMagic, 10, -10};
+        const ArmCommand arm{kArmMagic, {1, 2, 3, 4}};
+        PacketBundleWriter bundle;
+        bundle.append(reinterpret_cast<const uint8_t*>(&drive), sizeof(drive));
+        bundle.append(reinterpret_cast<const uint8_t*>(&arm), sizeof(arm));
+        const CommandStampHeader stamp{STAMP_PACKET_MAGIC, 1, 0};
+        commandLength = writeStampedFrame(commandFrame, sizeof(commandFrame), stamp, bundle.data(), bundle.size());
+    }
+    Robot benchRobot;
+    ILITERobot::Dispatcher benchDispatcher;
+    benchDispatcher.addPacket<DriveCommand>(kDriveMagic, robotOnDrive, &benchRobot);
+    benchDispatcher.addPacket<ArmCommand>(kArmMagic, robotOnArm, &benchRobot);
+    bench("Robot Dispatcher stamp+bundle x2", kIterations, [&](int i) {
+        (void)i;
+        sink += static_cast<uint32_t>(benchDispatcher.handle(commandFrame, commandLength));
+    });
+
+    Conformance benchConformance;
+    benchConformance.state = RobotState{kStateMagic, 0, {0, 0}, 0.0f, {0, 0, 0, 0}, {0, 0}, {0, 0, 0}};
+    benchConformance.status = RobotStatus{kStatusMagic, 12000, 1};
+    ILITERobot::TelemetryScheduler benchTelemetry(
+        [](const uint8_t*, const uint8_t*, size_t length, void*) {
+            sink += static_cast<uint32_t>(length);
+            return true;
+        },
+        nullptr);
+    benchTelemetry.addType(kStateMagic, 0, buildState, &benchConformance);
+    benchTelemetry.addType(kStatusMagic, 0, buildStatus, &benchConformance);
+    benchTelemetry.enableDelta(kStateMagic, kRobotStateFields,
+                               sizeof(kRobotStateFields) / sizeof(kRobotStateFields[0]), sizeof(RobotState));
+    benchTelemetry.setEcho(true);
+    const ILITERobot::StampHeader benchStamp{ILITERobot::kStampMagic, 1, 0};
+    bench("Robot telemetry x2 delta+echo", kIterations, [&](int i) {
+        benchConformance.state.sampleUs = static_cast<uint32_t>(i) * 5000;
+        benchConformance.state.wheels[0] = static_cast<int16_t>(i % 400 - 200);
+        benchTelemetry.poll(kRobotMac, static_cast<uint32_t>(i) * 5, &benchStamp);
+    });
+
+    TelemetryStore& store = TelemetryStore::getInstance();
+    bench("TelemetryStore publish + read", kIterations, [&](int i) {
+        Telemetry telemetry{kTelemetryMagic, static_cast<uint32_t>(i), 0};
+        store.publish(0, reinterpret_cast<const uint8_t*>(&telemetry), sizeof(telemetry));
+        Telemetry out{};
+        store.getSlot(0)->read(&out, sizeof(out));
+        sink += out.framesSeen;
+    });
+
+    SeriesBuffer series(10);
+    bench("SeriesBuffer push + range", kIterations, [&](int i) {
+        series.push(static_cast<int16_t>((i * 37) % 2000 - 1000));
+        int16_t lo = 0;
+        int16_t hi = 0;
+        series.getRange(lo, hi);
+        sink += static_cast<uint32_t>(hi - lo);
+    });
+
+    IKEngine::InverseKinematics solver;
+    bench("InverseKinematics solvePlanar", kIterations, [&](int i) {
+        IKEngine::IKSolution solution;
+        solver.solvePlanar(150.0f + static_cast<float>(i % 200), static_cast<float>(i % 150) - 50.0f,
+                           0.0f, solution);
+        sink += solution.reachable ? 1 : 0;
+    });
+}
+
+}  // namespace
+
+int main() {
+    Serial.println("ILITE native core");
+    runLinkSimulation(0.0f);
+    runLinkSimulation(0.10f);
+    runRobotConformance();
+    runArmStateDeltas();
+    runBenchmarks();
+    if (failures != 0) {
+        Serial.printf("\n%d check(s) failed\n", failures);
+        return 1;
+    }
+    Serial.println("\nAll checks passed");
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <stdint.h>
 #include <math.h>
+#include "Collision.h"
 
 namespace mech {
 
@@ -78,6 +79,7 @@ struct IKStatus {
   bool reachable = true;
   float lateralError = 0.0f;
   float distanceError = 0.0f;
+  Kinematics::CollisionHit collision;  // Links: 0 base column, 1 upper arm, 2 forearm, 3 extension
 
   void reset();
 };
@@ -178,6 +180,9 @@ public:
   void adjustElbowLength(float delta);
   void adjustExtensionMax(float delta);
 
+  // Scene checked after each solve (nullptr: none); must outlive the solver
+  void setCollisionScene(const Kinematics::CollisionScene* scene);
+
   const ArmSolution& solution() const;
   ArmServoPose servoPose() const;
   ArmServoSetpoints servoSetpoints(const ArmServoMap& map) const;
@@ -188,6 +193,7 @@ private:
 
   ArmDimensions dims_;
   ArmLimits limits_;
+  const Kinematics::CollisionScene* collisionScene_ = nullptr;
   Vec3 basePos_;
   Vec3 target_;
   Vec3 reached_;
@@ -0,0 +1,102 @@
+/**
+ * @file AdcSampler.h
+ * @brief Background ADC1 DMA sampling of all analog inputs
+ *
+ * All six analog inputs (both joysticks, potentiometer, battery) sit on
+ * ADC1. AdcSampler runs ADC1 in continuous (DMA) mode and a small reader
+ * task accumulates every conversion per channel. InputManager::update()
+ * calls latch() once per tick to take the oversampled average of everything
+ * converted since the previous latch - no blocking analogRead() in the
+ * control loop, and the averaging removes most of the ESP32 ADC noise.
+ *
+ * If continuous mode cannot be started, isRunning() stays false and
+ * InputManager falls back to one analogRead() per channel per update.
+ *
+ * @note While DMA sampling is running, analogRead() must not be used on
+ *       ADC1 pins. Read analog values through InputManager instead.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ADC_SAMPLER_H
+#define ILITE_ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @class AdcSampler
+ * @brief Continuous-mode ADC1 sampler with per-channel oversampling
+ */
+class AdcSampler {
+public:
+    /// Logical analog channels, in InputManager order
+    enum Channel : uint8_t {
+        JOY_A_X = 0,
+        JOY_A_Y,
+        JOY_B_X,
+        JOY_B_Y,
+        POT,
+        BATTERY,
+        CHANNEL_COUNT
+    };
+
+    /// Total conversion rate across all channels (~3.3 kHz per channel)
+    static constexpr uint32_t kSampleRateHz = 20000;
+
+    static AdcSampler& getInstance();
+
+    /**
+     * @brief Configure ADC1 DMA for all analog pins and start the reader task
+     * @return true if continuous sampling is running
+     */
+    bool begin();
+
+    /**
+     * @brief Stop sampling and release the ADC
+     */
+    void end();
+
+    /// True while continuous sampling is active
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief Take averaged values since the last latch
+     *
+     * Channels that received no new conversions keep their previous value.
+     *
+     * @param out Array of CHANNEL_COUNT raw 12-bit values
+     */
+    void latch(uint16_t out[CHANNEL_COUNT]);
+
+    /// Total conversions accumulated since begin()
+    uint32_t getSampleCount() const { return sampleCount_; }
+
+    /// GPIO pin for a logical channel
+    static uint8_t pinFor(Channel channel);
+
+private:
+    AdcSampler();
+    AdcSampler(const AdcSampler&) = delete;
+    AdcSampler& operator=(const AdcSampler&) = delete;
+
+    static void readerTask(void* parameter);
+    void accumulate(const uint8_t* buffer, uint32_t length);
+
+    struct Accumulator {
+        uint32_t sum;
+        uint16_t count;
+    };
+
+    Accumulator acc_[CHANNEL_COUNT];
+    uint16_t last_[CHANNEL_COUNT];
+    int8_t channelMap_[16];             ///< ADC1 hardware channel -> logical channel
+    portMUX_TYPE lock_;
+    TaskHandle_t taskHandle_;
+    volatile bool running_;
+    volatile uint32_t sampleCount_;
+};
+
+#endif // ILITE_ADC_SAMPLER_H
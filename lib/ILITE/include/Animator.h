@@ -0,0 +1,139 @@
+/**
+ * @file Animator.h
+ * @brief Fixed-timestep animation clock and fixed-point tweens for the UI
+ *
+ * Menu selections and browser cards used to jump, and the little animation
+ * there was counted calls instead of time. Animator gives DisplayTask one
+ * clock and Tween a way to move a value over it:
+ *
+ * - **Clock**: beginFrame() adds the real time since the previous frame to
+ *   an accumulator and advances it in whole kStepMs steps; the remainder is
+ *   kept as alpha, the fraction of the next step. Every tween drawn in a
+ *   frame reads the same (step, alpha) sample, progress does not depend on
+ *   the frame rate, and a stalled frame (bus benchmark, idle) is clamped
+ *   to kMaxFrameMs so nothing jumps on wake.
+ * - **Tween**: eases an int32 value from where it is to a target over a
+ *   fixed duration. Progress is Q16 (65536 = done) interpolated inside the
+ *   current step with alpha, and the easing curves are integer polynomials,
+ *   so drawing costs a few multiplies and no float.
+ * - **Frames on demand**: reading a tween that is still running marks the
+ *   frame as animated; endFrame() reports it and DisplayTask posts
+ *   RenderReason::Animation for the next frame. Nothing posts once the
+ *   last tween settles or stops being drawn, and the display drops back
+ *   to its floor rate.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * Tween scroll(120, Ease::OutCubic);
+ *
+ * // Draw function (DisplayTask)
+ * scroll.retarget(selection * kRowHeight);
+ * const int16_t offset = scroll.value();
+ * ```
+ *
+ * ## Thread Safety:
+ * DisplayTask only: tweens are retargeted and read from draw functions,
+ * which keeps them on the one task that advances the clock.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ANIMATOR_H
+#define ILITE_ANIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Easing curves (progress in, eased progress out, both Q16)
+enum class Ease : uint8_t {
+    Linear,
+    OutCubic,       ///< Fast start, soft landing (selection, scrolling)
+    InOutCubic      ///< Soft start and landing (page slides)
+};
+
+/**
+ * @class Animator
+ * @brief Static frame clock shared by all tweens
+ */
+class Animator {
+public:
+    static constexpr uint32_t kStepMs = 8;          ///< Fixed step (125 Hz)
+    static constexpr uint32_t kMaxFrameMs = 100;    ///< Longer gaps advance only this much
+    static constexpr int32_t kOne = 65536;          ///< Q16 1.0
+
+    /// DisplayTask, before drawing: advance the clock to nowMs
+    static void beginFrame(uint32_t nowMs);
+
+    /**
+     * @brief DisplayTask, after drawing
+     * @return true if a tween drawn this frame is still running
+     */
+    static bool endFrame();
+
+    /// Whole steps since boot
+    static uint32_t getSteps() { return steps_; }
+
+    /// Fraction of the next step that has elapsed (Q16)
+    static int32_t getAlpha() { return alpha_; }
+
+    /// Animation time of the current frame (steps, in milliseconds)
+    static uint32_t getFrameMs() { return steps_ * kStepMs; }
+
+    /// Frames drawn with a running tween since boot
+    static uint32_t getAnimatedFrames() { return animatedFrames_; }
+
+    /// Ask for the next frame (called by Tween::value() while running)
+    static void keepAlive() { alive_ = true; }
+
+    /// Apply a curve to Q16 progress (clamped to 0..kOne)
+    static int32_t ease(Ease curve, int32_t t);
+
+private:
+    static uint32_t lastMs_;
+    static uint32_t accumulatorMs_;
+    static uint32_t steps_;
+    static int32_t alpha_;
+    static bool started_;
+    static bool alive_;
+    static uint32_t animatedFrames_;
+};
+
+/**
+ * @class Tween
+ * @brief Value eased towards a target on the Animator clock
+ */
+class Tween {
+public:
+    explicit Tween(uint16_t durationMs = 120, Ease curve = Ease::OutCubic);
+
+    /// Jump to value with no animation (first show, page change)
+    void snap(int32_t value);
+
+    /**
+     * @brief Animate from the current value to target
+     *
+     * No-op if target is already the destination, so draw functions can
+     * call it every frame with whatever the state says.
+     */
+    void retarget(int32_t target);
+
+    /// Value for this frame; keeps frames coming while running
+    int32_t value();
+
+    bool isRunning() const { return running_; }
+    int32_t getTarget() const { return to_; }
+
+private:
+    int32_t progress() const;
+
+    int32_t from_ = 0;
+    int32_t to_ = 0;
+    uint32_t startStep_ = 0;
+    int32_t startAlpha_ = 0;
+    uint16_t durationSteps_;
+    Ease curve_;
+    bool running_ = false;
+};
+
+#endif // ILITE_ANIMATOR_H
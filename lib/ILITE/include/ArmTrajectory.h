@@ -0,0 +1,131 @@
+/**
+ * @file ArmTrajectory.h
+ * @brief Jerk-limited joint planner that streams spline segments to TheGill
+ *
+ * Sending one ArmControlCommand setpoint per control tick ties arm
+ * smoothness to link timing: every late or lost packet is a visible step.
+ * ArmTrajectoryPlanner instead follows the IK joint goals with per-axis
+ * velocity, acceleration and jerk limits, and every kSegmentMs sends an
+ * ArmTrajectoryPacket: the planned position and velocity of each axis now
+ * and at kArmTrajectoryKnots - 1 future knots, extrapolated with the goal
+ * held. The robot interpolates the knots as a cubic Hermite spline, so
+ *
+ * - motion between packets is smooth whatever the link rate,
+ * - a lost packet is bridged by the tail of the previous one, and
+ * - the arm stream drops from one 44-byte packet per tick to one 96-byte
+ *   packet per segment, and to one per kIdleResendMs while settled.
+ *
+ * Position limits come from IKConfiguration; the motion limits have
+ * defaults per axis and can be tuned with setAxisLimits().
+ *
+ * ## Usage Example:
+ * ```cpp
+ * planner.configure(ikSolver.getConfiguration());
+ * planner.reset(currentJoints);
+ * // every control tick
+ * planner.setGoal(goalJoints);
+ * planner.update(dt);
+ * // when sending
+ * ArmTrajectoryPacket pkt;
+ * if (planner.buildPacket(millis(), ArmCommandFlag::EnableOutputs, pkt)) { send(pkt); }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ARM_TRAJECTORY_H
+#define ILITE_ARM_TRAJECTORY_H
+
+#include <Arduino.h>
+#include "InverseKinematics.h"
+#include "thegill.h"
+
+class ArmTrajectoryPlanner {
+public:
+    /// Axis order of ArmTrajectoryKnot
+    enum Axis : uint8_t {
+        EXTENSION = 0,
+        BASE,
+        SHOULDER,
+        ELBOW,
+        PITCH,
+        ROLL,
+        YAW,
+        AXIS_COUNT
+    };
+
+    struct AxisLimits {
+        float minPosition;      ///< deg (extension: mm)
+        float maxPosition;
+        float maxVelocity;      ///< per second
+        float maxAcceleration;  ///< per second^2
+        float maxJerk;          ///< per second^3
+    };
+
+    static constexpr uint16_t kSegmentMs = 60;      ///< Knot spacing and send period while moving
+    static constexpr uint32_t kIdleResendMs = 250;  ///< Send period while settled
+    static constexpr float kStepSeconds = 0.005f;   ///< Integration step of the limiter
+
+    /// ArmCommandMask bits of the axes a packet carries
+    static constexpr uint16_t kValidMask =
+        ArmCommandMask::Extension | ArmCommandMask::Base | ArmCommandMask::AllServos;
+
+    ArmTrajectoryPlanner();
+
+    /// Take position limits from the IK configuration (motion limits unchanged)
+    void configure(const IKEngine::IKConfiguration& config);
+
+    void setAxisLimits(Axis axis, const AxisLimits& limits);
+    const AxisLimits& getAxisLimits(Axis axis) const { return limits_[axis]; }
+
+    /// Jump to a known pose (e.g. from an ArmStatePacket) and stop there
+    void reset(const float positions[AXIS_COUNT]);
+    bool isInitialized() const { return initialized_; }
+
+    /// New goal pose; clamped to the position limits
+    void setGoal(const float positions[AXIS_COUNT]);
+
+    /// Advance the planned motion by dtSeconds
+    void update(float dtSeconds);
+
+    /// True when every axis rests on its goal
+    bool isSettled() const;
+
+    float getPosition(Axis axis) const { return state_[axis].position; }
+    float getVelocity(Axis axis) const { return state_[axis].velocity; }
+
+    /**
+     * @brief Fill the next packet if one is due
+     * @param nowMs millis()
+     * @param flags ArmCommandFlag bits to carry
+     * @return true if `out` should be sent now
+     */
+    bool buildPacket(uint32_t nowMs, uint8_t flags, ArmTrajectoryPacket& out);
+
+    /// Joint values of an ArmControlCommand in Axis order
+    static void fromCommand(const ArmControlCommand& command, float out[AXIS_COUNT]);
+
+private:
+    struct AxisState {
+        float position;
+        float velocity;
+        float acceleration;
+    };
+
+    static void step(const AxisLimits& limits, float goal, AxisState& state, float dt);
+    static int16_t toCounts(float value, float scale);
+    void advance(AxisState* state, float seconds) const;
+    void writeKnot(const AxisState* state, ArmTrajectoryKnot& knot) const;
+
+    AxisLimits limits_[AXIS_COUNT];
+    AxisState state_[AXIS_COUNT];
+    float goal_[AXIS_COUNT];
+    float pendingSeconds_;
+    uint32_t lastSendMs_;
+    uint16_t sequence_;
+    bool initialized_;
+    bool lastSentSettled_;
+};
+
+#endif // ILITE_ARM_TRAJECTORY_H
@@ -24,6 +24,7 @@
 #include <Arduino.h>
 #include <vector>
 #include <functional>
+#include "audio_feedback.h"
 
 /**
  * @brief Audio cue definition (renamed to avoid conflict with existing AudioCue enum)
@@ -38,6 +39,10 @@ struct AudioCueDefinition {
 
     /// Optional: Play only if condition is true
     std::function<bool()> condition;
+
+    /// Optional: Note table played by the audio sequencer (overrides frequency/duration)
+    const AudioNote* notes;
+    uint8_t noteCount;
 };
 
 /**
@@ -111,7 +116,9 @@ private:
                     freq, \
                     duration, \
                     nullptr, \
-                    nullptr \
+                    nullptr, \
+                    nullptr, \
+                    0 \
                 }); \
             } \
         }; \
@@ -142,7 +149,9 @@ private:
                     freq, \
                     duration, \
                     nullptr, \
-                    cond \
+                    cond, \
+                    nullptr, \
+                    0 \
                 }); \
             } \
         }; \
@@ -157,12 +166,8 @@ private:
  *
  * @example
  * ```cpp
- * REGISTER_AUDIO_CUSTOM("startup", []() {
- *     AudioRegistry::play("beep");
- *     delay(100);
- *     AudioRegistry::play("beep");
- *     delay(100);
- *     AudioRegistry::play("long_beep");
+ * REGISTER_AUDIO_CUSTOM("random_beep", []() {
+ *     audioPlayTone(random(400, 1600), 60);
  * });
  * ```
  */
@@ -175,7 +180,42 @@ private:
                     0, \
                     0, \
                     func, \
-                    nullptr \
+                    nullptr, \
+                    nullptr, \
+                    0 \
+                }); \
+            } \
+        }; \
+        static AudioCueRegistrar_##name g_audioCueRegistrar_##name; \
+    }
+
+/**
+ * @brief Macro for registering a multi-note cue as a note table
+ *
+ * The table is constant data; playback is timed by the audio sequencer and
+ * AudioRegistry::play() returns immediately. Use frequency 0 for rests.
+ *
+ * @param name Cue name
+ * @param ... AudioNote initializers ({frequencyHz, durationMs})
+ *
+ * @example
+ * ```cpp
+ * REGISTER_AUDIO_NOTES(double_beep, {1000, 40}, {0, 40}, {1000, 40});
+ * ```
+ */
+#define REGISTER_AUDIO_NOTES(name, ...) \
+    namespace { \
+        constexpr AudioNote kAudioNotes_##name[] = {__VA_ARGS__}; \
+        struct AudioCueRegistrar_##name { \
+            AudioCueRegistrar_##name() { \
+                AudioRegistry::registerCue({ \
+                    #name, \
+                    0, \
+                    0, \
+                    nullptr, \
+                    nullptr, \
+                    kAudioNotes_##name, \
+                    static_cast<uint8_t>(sizeof(kAudioNotes_##name) / sizeof(AudioNote)) \
                 }); \
             } \
         }; \
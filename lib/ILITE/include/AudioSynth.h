@@ -0,0 +1,141 @@
+/**
+ * @file AudioSynth.h
+ * @brief Wavetable synthesizer with mixable voices for the DAC buzzer
+ *
+ * AudioSynth replaces the single-frequency cosine generator with sampled
+ * audio: up to kVoiceCount voices read a sine wavetable, each shaped by an
+ * ADSR envelope, and are mixed into 8-bit DAC samples. Overlapping cues
+ * now mix instead of cutting each other off, and notes fade in and out
+ * instead of clicking.
+ *
+ * The built-in DAC DMA path (I2S0) is already taken by AdcSampler's
+ * continuous ADC, so the DAC is fed from two ping-pong sample buffers by a
+ * hardware timer interrupt that only copies one byte per sample. Whenever
+ * the interrupt finishes a buffer it notifies the synth task, which renders
+ * exactly one buffer. The work per buffer is fixed (kBufferFrames samples
+ * times kVoiceCount voices), so CPU cost stays bounded and nothing polls
+ * from Audio::update().
+ *
+ * play() is lock-free and may be called from any task; the note table is
+ * read in place and must outlive playback (normally static const data).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_AUDIO_SYNTH_H
+#define ILITE_AUDIO_SYNTH_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "audio_feedback.h"
+#include "MpscQueue.h"
+#include <atomic>
+
+/**
+ * @class AudioSynth
+ * @brief Timer-fed wavetable synth, single consumer of the cue queue
+ */
+class AudioSynth {
+public:
+    static constexpr uint32_t kSampleRate = 16000;      ///< DAC samples per second
+    static constexpr uint8_t kVoiceCount = 4;           ///< Simultaneous notes
+    static constexpr size_t kBufferFrames = 128;        ///< 8 ms per buffer
+    static constexpr size_t kWavetableBits = 8;         ///< 256-entry sine table
+    static constexpr uint32_t kQueueSize = 8;           ///< Pending play() requests
+
+    /// Envelope applied to every note (times in ms, sustain in percent)
+    struct Envelope {
+        uint16_t attackMs;
+        uint16_t decayMs;
+        uint8_t sustainPercent;
+        uint16_t releaseMs;
+    };
+
+    static AudioSynth& getInstance();
+
+    /**
+     * @brief Enable the DAC, start the sample timer and the synth task
+     * @return true if the synth is running
+     */
+    bool begin();
+
+    /// True once begin() succeeded
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief Queue a note table on a free voice (steals the oldest if none)
+     * @return false if the synth is not running or the queue is full
+     */
+    bool play(const AudioNote* notes, size_t count);
+
+    /// Queue a single tone
+    bool playTone(uint16_t frequencyHz, uint16_t durationMs);
+
+    /// Envelope for notes started after this call
+    void setEnvelope(const Envelope& envelope) { envelope_ = envelope; }
+    const Envelope& getEnvelope() const { return envelope_; }
+
+    /// Master volume 0-100 %
+    void setVolume(uint8_t percent) { volume_ = percent > 100 ? 100 : percent; }
+    uint8_t getVolume() const { return volume_; }
+
+    /// Voices currently sounding (including release tails)
+    uint8_t getActiveVoices() const { return activeVoices_; }
+
+    /// True while any voice sounds or a request is waiting
+    bool isPlaying() const { return activeVoices_ != 0 || !requests_.empty(); }
+
+private:
+    AudioSynth();
+    AudioSynth(const AudioSynth&) = delete;
+    AudioSynth& operator=(const AudioSynth&) = delete;
+
+    struct Request {
+        const AudioNote* notes;
+        uint16_t count;
+        AudioNote tone;     ///< Used when notes is null
+    };
+
+    enum Stage : uint8_t { IDLE, ATTACK, DECAY, SUSTAIN, RELEASE };
+
+    struct Voice {
+        Request request;
+        uint16_t index;             ///< Current note
+        uint32_t samplesLeft;       ///< Samples until the next note
+        uint32_t phase;             ///< Wavetable phase, 32-bit fraction of a cycle
+        uint32_t phaseStep;
+        int32_t level;              ///< Envelope level, Q23
+        int32_t attackStep;
+        int32_t decayStep;
+        int32_t sustainLevel;
+        int32_t releaseStep;
+        uint32_t startOrder;        ///< For stealing the oldest voice
+        Stage stage;
+    };
+
+    static void IRAM_ATTR onSampleTimer();
+    static void synthTask(void* parameter);
+    bool submit(const Request& request);
+    void startRequest(const Request& request);
+    void beginNote(Voice& voice);
+    void render(uint8_t* out, size_t frames);
+
+    Voice voices_[kVoiceCount];
+    MpscQueue<Request, kQueueSize> requests_;
+    int16_t wavetable_[1 << kWavetableBits];
+    uint8_t buffers_[2][kBufferFrames];
+    volatile uint8_t playBuffer_;       ///< Buffer the timer is reading
+    volatile uint16_t playIndex_;
+    Envelope envelope_;
+    uint8_t volume_;
+    uint8_t activeVoices_;
+    uint32_t voiceOrder_;
+    hw_timer_t* timer_;
+    TaskHandle_t taskHandle_;
+    std::atomic<bool> sleeping_;        ///< Timer stopped, task waits for submit()
+    volatile bool running_;
+};
+
+#endif // ILITE_AUDIO_SYNTH_H
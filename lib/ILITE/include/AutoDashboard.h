@@ -0,0 +1,92 @@
+/**
+ * @file AutoDashboard.h
+ * @brief Retained-mode dashboards generated from PacketDescriptor field tables
+ *
+ * A module that does not override drawDashboard() gets a dashboard laid out
+ * from the Field tables of its telemetry descriptors, so a new robot is
+ * usable with no display code at all:
+ *
+ * | Field                                   | Cell                             |
+ * |-----------------------------------------|----------------------------------|
+ * | BOOL                                    | Label + box, filled when true    |
+ * | Name with "batt", "pct", "percent" or   | Label + 0-100 bar                |
+ * | "level"                                 |                                  |
+ * | First kMaxSparklines FLOAT/INT16/INT32  | Full width: label, value and a   |
+ * |                                         | sparkline of the recent samples  |
+ * | Other numbers, BYTE_ARRAY               | Label + value (hex for arrays)   |
+ * | Type without a field table              | Full width: first bytes in hex   |
+ *
+ * Half-width cells are packed two per row, in field order, below the
+ * full-width ones. Fields that do not fit one screen go to further pages
+ * (at most kMaxPages), which cycle every kPageMs; the packet inspector
+ * ("framework.packets") still shows everything.
+ *
+ * - **Cached layout**: the cells are placed once per module and descriptor
+ *   set. Each frame only compares the descriptors' field table pointers
+ *   and counts against the cached ones.
+ * - **Retained widgets**: every cell is a Widget of one WidgetScreen per
+ *   page. A cell skips its field unless the TelemetryStore slot sequence
+ *   moved, decodes it in place (TelemetrySlot::inspect()) when it did, and
+ *   only redraws when the text, bar length or flag it shows changed, or a
+ *   sparkline took a sample.
+ *
+ * Storage (about 4 KB) is allocated on the first generated frame, so modules
+ * with their own dashboard do not pay for it.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * class ProbeRobot : public ILITEModule {
+ *     // ... descriptors with Field tables, updateControl(), prepareCommandPacket()
+ *     // No drawDashboard(): the framework generates one
+ * };
+ * ```
+ *
+ * ## Thread Safety:
+ * DisplayTask only. Telemetry is read through the TelemetryStore seqlock.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_AUTO_DASHBOARD_H
+#define ILITE_AUTO_DASHBOARD_H
+
+#include <Arduino.h>
+
+class DisplayCanvas;
+class ILITEModule;
+class WidgetScreen;
+
+/**
+ * @class AutoDashboard
+ * @brief Static dashboard generator for the active module
+ */
+class AutoDashboard {
+public:
+    static constexpr size_t kMaxPages = 3;
+    static constexpr size_t kMaxSparklines = 2;
+    static constexpr size_t kSparkSamples = 64;     ///< Samples across a sparkline
+    static constexpr uint32_t kPageMs = 4000;
+
+    /**
+     * @brief Widget screen of the page on display
+     *
+     * Rebuilds the layout when the module or its telemetry descriptors
+     * changed. The pointer changes with the page, which makes the framework
+     * redraw the whole dashboard.
+     *
+     * @return Screen, or nullptr if the storage could not be allocated
+     */
+    static WidgetScreen* getScreen(const ILITEModule& module);
+
+    /// Draw the current page in full (immediate-mode callers)
+    static void draw(const ILITEModule& module, DisplayCanvas& canvas);
+
+    /// Fields placed on pages by the last layout
+    static size_t getPlacedFields();
+
+    /// Fields left out of the last layout (pages full)
+    static size_t getHiddenFields();
+};
+
+#endif // ILITE_AUTO_DASHBOARD_H
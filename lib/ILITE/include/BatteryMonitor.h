@@ -0,0 +1,105 @@
+/**
+ * @file BatteryMonitor.h
+ * @brief Filtered battery voltage, charge and time-to-empty, published at 1 Hz
+ *
+ * The battery channel is already oversampled by AdcSampler (every control
+ * tick latches the DMA average of ~60 conversions). What the status bar
+ * showed was still that single tick converted with a fixed 3.3 V / 4095
+ * scale, so it jittered whenever the radio transmitted and was off by the
+ * ESP32 ADC's gain and offset error.
+ *
+ * BatteryMonitor instead:
+ * - converts with the ESP32 ADC calibration from eFuse (Vref or two-point
+ *   values when the chip has them, the nominal 1100 mV otherwise) once the
+ *   divider has been trimmed ("battery trim <volts>" with a multimeter
+ *   reading; stored in SettingsStore). Untrimmed, the legacy 3.3 V / 4095
+ *   scale and kLegacyDividerRatio it was tuned with are kept;
+ * - averages every control tick of a one-second window;
+ * - adds back the sag of the estimated load (kInternalMilliohm times the
+ *   idle or radio-streaming current) to approximate the resting voltage;
+ * - low-pass filters that across windows (kFilterAlpha);
+ * - maps it through a 1S LiPo resting-voltage table;
+ * - tracks the discharge rate over kRateWindowMs to estimate time to empty.
+ *
+ * Readers (status bar, menus) take the published values, which change at
+ * most once per second and cost nothing to read.
+ *
+ * ## Thread Safety:
+ * sample() runs on CommTask (FrameworkEngine::update) and is the only
+ * writer of the published values, which are single words; readers on
+ * other tasks may see one window older values. trim() comes from the
+ * console and restarts the filter; at worst one window uses the old scale.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_BATTERY_MONITOR_H
+#define ILITE_BATTERY_MONITOR_H
+
+#include <Arduino.h>
+
+/**
+ * @class BatteryMonitor
+ * @brief Static battery estimator
+ */
+class BatteryMonitor {
+public:
+    static constexpr uint32_t kPublishMs = 1000;         ///< Output rate
+    static constexpr uint32_t kRateWindowMs = 60000;     ///< Discharge slope window
+    static constexpr float kFilterAlpha = 0.25f;         ///< Per published window
+    static constexpr float kLegacyDividerRatio = 3.64f;  ///< Tuned against the uncalibrated scale
+    static constexpr uint16_t kInternalMilliohm = 150;   ///< Cell + wiring resistance
+    static constexpr uint16_t kIdleMilliamps = 90;       ///< ESP32 + OLED, radio listening
+    static constexpr uint16_t kStreamingMilliamps = 150; ///< Same while sending commands
+
+    /// Read the ADC calibration and the stored trim (call once, after the ADC is configured)
+    static void begin();
+
+    /**
+     * @brief Derive the divider ratio from a measured battery voltage
+     *
+     * Uses the last tick's reading; hold the load steady while measuring.
+     *
+     * @return false if the reading or the measurement is implausible
+     */
+    static bool trim(float measuredVolts);
+
+    /**
+     * @brief One control tick's battery reading
+     *
+     * @param raw Oversampled 12-bit battery channel (InputManager::getBatteryRaw)
+     * @param streaming Commands are being sent (higher load)
+     * @param nowMs millis()
+     * @return true when new values were published
+     */
+    static bool sample(uint16_t raw, bool streaming, uint32_t nowMs);
+
+    /// Calibrated battery voltage of one raw reading (no filtering)
+    static float rawToVolts(uint16_t raw);
+
+    /// Charge (0-100) for a resting cell voltage
+    static uint8_t percentForVoltage(float volts);
+
+    // Published values (0 until the first window completes)
+    static float getVoltage() { return publishedMillivolts_ * 0.001f; }
+    static uint8_t getPercent() { return publishedPercent_; }
+
+    /// Minutes to empty at the current drain (0 = not known yet or charging)
+    static uint16_t getMinutesToEmpty() { return minutesToEmpty_; }
+
+    /// True once a window has been published
+    static bool isValid() { return publishedMillivolts_ != 0; }
+
+    /// Calibration source, as reported by the ADC driver
+    static const char* getCalibrationName();
+
+    static void dump(Print& out);
+
+private:
+    static volatile uint32_t publishedMillivolts_;
+    static volatile uint8_t publishedPercent_;
+    static volatile uint16_t minutesToEmpty_;
+};
+
+#endif // ILITE_BATTERY_MONITOR_H
@@ -0,0 +1,180 @@
+/**
+ * @file BlackBox.h
+ * @brief Flight recorder: the last seconds of inputs, packets and link state, kept on a fault
+ *
+ * TelemetryTap and the event log only help if someone was watching or the
+ * fault left a log line. When a robot drops its link or goes quiet mid
+ * match, what the sticks, the command packets and the radio did in the
+ * seconds before is gone. BlackBox keeps that window all the time:
+ *
+ * - **RAM ring**: kRingBytes of compact variable-length records, always
+ *   on, oldest overwritten first: CommTask's input snapshot of every tick
+ *   and each command packet it sends, every telemetry packet RxTask
+ *   accepts and a link sample (RSSI, loss, RTT) every 100 ms. At 50 Hz
+ *   that is about four seconds.
+ * - **Bounded cost**: recording one record is a short spinlock, one copy
+ *   of at most 8 + kMaxPayload bytes and the eviction of the records it
+ *   overwrites (every record is at least 8 bytes, so a bounded number).
+ *   Longer packets are truncated; the record keeps their full length.
+ * - **Triggers**: link loss, telemetry going stale (the robot has fallen
+ *   silent, typically into its failsafe), a CommTask tick watchdog, the
+ *   button chord B1 + B3 held kChordMs, or "blackbox trigger" on the
+ *   console. The ring keeps recording for kTailMs so the capture shows the
+ *   aftermath, then freezes; later triggers are counted until it is saved.
+ * - **Flash**: ServiceTask writes the frozen ring to the next slot of the
+ *   "blackbox" partition (see partitions_ilite.csv) in kFlushChunk pieces,
+ *   header last, so a capture torn by a reset is never listed. The next
+ *   slot is erased a sector at a time ahead of use while unpaired. The
+ *   oldest capture is overwritten.
+ * - **Decoding**: "blackbox dump [n]" prints capture n (0 = newest) with
+ *   times relative to the trigger. Packets are decoded field by field with
+ *   the PacketDescriptor tables of the module the capture names.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * // CommTask, once per tick
+ * BlackBox::onInput(InputReplay::kFormatVersion, encoded, sizeof(encoded), inputUs);
+ * BlackBox::checkChord(snapshot.debounced, nowMs);
+ *
+ * // Anywhere a fault is detected
+ * BlackBox::trigger(BlackBoxTrigger::Watchdog);
+ * ```
+ *
+ * ## Thread Safety:
+ * The on*() hooks and trigger() may run on any task (a portMUX guards the
+ * ring). begin(), service() and the dump functions run on ServiceTask.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_BLACK_BOX_H
+#define ILITE_BLACK_BOX_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class ILITEModule;
+struct LinkPeerStats;
+
+enum class BlackBoxTrigger : uint8_t {
+    Manual,             ///< "blackbox trigger" on the console
+    LinkLost,           ///< Discovery dropped the paired peer
+    TelemetryStale,     ///< A telemetry type stopped arriving
+    Watchdog,           ///< CommTask saw no tick for 100 ms
+    Chord,              ///< B1 + B3 held
+    Count
+};
+
+/**
+ * @brief Recorder counters (see BlackBox::dump)
+ */
+struct BlackBoxStats {
+    uint32_t records;           ///< Records written to the ring
+    uint32_t evicted;           ///< Overwritten by newer records
+    uint32_t truncated;         ///< Packets longer than kMaxPayload
+    uint32_t captures;          ///< Captures saved this boot
+    uint32_t ignoredTriggers;   ///< Triggers while a capture was pending
+    uint32_t pairedErases;      ///< Sector erases that could not wait for unpaired
+    uint32_t maxFlushUs;        ///< Longest single flash write or erase
+};
+
+/**
+ * @class BlackBox
+ * @brief Static fault recorder with a RAM ring and a flash partition
+ */
+class BlackBox {
+public:
+    static constexpr const char* kPartitionLabel = "blackbox";
+    static constexpr size_t kRingBytes = 32768;
+    static constexpr size_t kMaxPayload = 96;           ///< Packet bytes kept per record
+    static constexpr uint32_t kSlotBytes = 65536;       ///< One capture in flash
+    static constexpr uint32_t kSectorSize = 4096;
+    static constexpr size_t kFlushChunk = 4096;         ///< Bytes written per service() call
+    static constexpr uint32_t kTailMs = 500;            ///< Recording kept up after a trigger
+    static constexpr uint32_t kChordMs = 1500;
+    static constexpr uint32_t kLinkSampleMs = 100;
+
+    enum RecordKind : uint8_t {
+        RECORD_INPUT = 0x01,        ///< type = InputReplay::kFormatVersion, encoded snapshot
+        RECORD_COMMAND = 0x02,      ///< type = command descriptor index, packet bytes
+        RECORD_TELEMETRY = 0x03,    ///< type = telemetry descriptor index, packet bytes
+        RECORD_LINK = 0x04,         ///< LinkSample
+        RECORD_TRIGGER = 0x05       ///< type = BlackBoxTrigger
+    };
+
+    /**
+     * @brief Allocate the ring and mount the partition
+     *
+     * Call after EventLog::begin() (captures carry its boot number).
+     * Without the partition the ring still records and "blackbox trigger"
+     * still freezes it, but nothing is saved.
+     *
+     * @return true if the ring was allocated; recording starts at once
+     */
+    static bool begin();
+
+    /// True unless a capture is frozen for saving (or begin() failed)
+    static inline bool isRecording() {
+        return recording_.load(std::memory_order_relaxed);
+    }
+
+    /// An encoded InputSnapshot was captured (CommTask)
+    static inline void onInput(uint8_t version, const uint8_t* data, size_t length,
+                               uint32_t timestampUs) {
+        if (isRecording()) {
+            record(RECORD_INPUT, version, data, length, timestampUs);
+        }
+    }
+
+    /// A command packet of the active module is about to be sent (CommTask)
+    static inline void onCommand(uint8_t typeIndex, const uint8_t* data, size_t length,
+                                 uint32_t timestampUs) {
+        if (isRecording()) {
+            record(RECORD_COMMAND, typeIndex, data, length, timestampUs);
+        }
+    }
+
+    /// A telemetry packet was accepted by PacketRouter (RxTask)
+    static inline void onTelemetry(uint8_t typeIndex, const uint8_t* data, size_t length,
+                                   uint32_t timestampUs) {
+        if (isRecording()) {
+            record(RECORD_TELEMETRY, typeIndex, data, length, timestampUs);
+        }
+    }
+
+    /// Sample the paired peer's link (ServiceTask; kept every kLinkSampleMs)
+    static void onLink(const LinkPeerStats* stats, uint32_t nowMs);
+
+    /// Trigger on the button chord once it has been held kChordMs (CommTask)
+    static void checkChord(uint8_t debouncedButtons, uint32_t nowMs);
+
+    /// Freeze the ring after kTailMs and save it (any task)
+    static void trigger(BlackBoxTrigger reason);
+
+    /**
+     * @brief Freeze after the tail, save a frozen capture, erase ahead
+     * @param paired Link active: erase only what the pending capture needs
+     * @param module Active module, named in the capture for decoding
+     */
+    static void service(bool paired, uint32_t nowMs, ILITEModule* module);
+
+    /// Stored captures, newest first
+    static void list(Print& out);
+
+    /// Decode capture `index` (0 = newest)
+    static void download(Print& out, uint32_t index = 0);
+
+    static const char* name(BlackBoxTrigger reason);
+    static const BlackBoxStats& getStats() { return stats_; }
+    static void dump(Print& out);
+
+private:
+    static void record(uint8_t kind, uint8_t type, const uint8_t* data, size_t length,
+                       uint32_t timestampUs);
+
+    static std::atomic<bool> recording_;
+    static BlackBoxStats stats_;
+};
+
+#endif // ILITE_BLACK_BOX_H
@@ -7,6 +7,9 @@
  * - Configurable timing thresholds
  * - Module function mapping
  *
+ * Buttons are not read here: levels and edges come from ButtonSampler, so
+ * debouncing matches InputManager and ControlBindingSystem.
+ *
  * @author ILITE Team
  * @date 2025
  * @version 2.0.0
@@ -15,6 +18,7 @@
 #pragma once
 #include <Arduino.h>
 #include <functional>
+#include "ButtonSampler.h"
 
 /**
  * @brief Button event types
@@ -60,9 +64,14 @@ public:
     /**
      * @brief Update button state machine (call frequently, e.g., 50Hz)
      *
+     * A press edge in `changes` counts even if the button was already
+     * released again, so taps shorter than the update period still report
+     * PRESSED (and RELEASED on the next update).
+     *
+     * @param changes Debounced levels and edges from ButtonSampler
      * @return Current event detected this frame
      */
-    ButtonEvent update();
+    ButtonEvent update(const ButtonChanges& changes);
 
     /**
      * @brief Check if button is currently pressed
@@ -106,6 +115,7 @@ public:
 
 private:
     uint8_t pin_;                       ///< GPIO pin
+    uint8_t bit_;                       ///< ButtonSampler bit for pin_
     uint32_t longPressThreshold_;       ///< Long press time in ms
     ButtonState state_;                 ///< Current state
     ButtonState previousState_;         ///< Previous state for edge detection
@@ -113,11 +123,6 @@ private:
     bool lastReading_;                  ///< Last debounced reading
     bool longPressFired_;               ///< Whether long press event has fired
     ButtonCallback callback_;           ///< User callback function
-
-    // Debouncing
-    static constexpr uint32_t DEBOUNCE_MS = 50;
-    uint32_t lastDebounceTime_;
-    bool lastRawReading_;
 };
 
 /**
@@ -178,4 +183,5 @@ private:
     ButtonEventTracker buttons_[BUTTON_COUNT];
     ButtonEvent lastEvents_[BUTTON_COUNT];
     uint32_t longPressThreshold_;
+    ButtonSampler::Cursor cursor_;
 };
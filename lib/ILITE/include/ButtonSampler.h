@@ -0,0 +1,140 @@
+/**
+ * @file ButtonSampler.h
+ * @brief Single 1 kHz debounced source for every push button
+ *
+ * InputManager, ButtonEventEngine and ControlBindingSystem used to read the
+ * button pins themselves, each with its own debounce rules, from different
+ * tasks. ButtonSampler replaces those reads: a periodic esp_timer reads the
+ * GPIO input register once per millisecond, debounces all buttons with one
+ * rule (a level must be stable for kDebounceMs), and publishes
+ *
+ * - the debounced levels as a bitmask (getLevels()), and
+ * - every debounced transition into an edge queue (ButtonEdge).
+ *
+ * The queue has one writer (the timer) and any number of readers. Each
+ * reader keeps its own Cursor, so consumers running at different rates all
+ * see every edge, including presses shorter than their own update period.
+ * A reader that falls more than kQueueSize edges behind skips the oldest
+ * ones; the levels stay correct.
+ *
+ * @note Bits use the InputSnapshot::Button layout.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_BUTTON_SAMPLER_H
+#define ILITE_BUTTON_SAMPLER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+
+/**
+ * @brief One debounced button transition
+ */
+struct ButtonEdge {
+    uint32_t timeMs;        ///< millis() when the new level became stable
+    uint8_t button;         ///< Single button bit
+    bool pressed;           ///< true = press, false = release
+};
+
+/**
+ * @brief Edges collected by one reader since its previous collect()
+ */
+struct ButtonChanges {
+    uint8_t levels = 0;     ///< Debounced levels now, bit set = pressed
+    uint8_t pressed = 0;    ///< Buttons with a press edge since the last collect
+    uint8_t released = 0;   ///< Buttons with a release edge since the last collect
+};
+
+/**
+ * @class ButtonSampler
+ * @brief Timer-driven button debouncer with a multi-reader edge queue
+ */
+class ButtonSampler {
+public:
+    /// Button bits (same values as InputSnapshot::Button)
+    enum Button : uint8_t {
+        BUTTON_1       = 1 << 0,
+        BUTTON_2       = 1 << 1,
+        BUTTON_3       = 1 << 2,
+        JOY_BUTTON_A   = 1 << 3,
+        JOY_BUTTON_B   = 1 << 4,
+        ENCODER_BUTTON = 1 << 5
+    };
+
+    static constexpr uint8_t kButtonCount = 6;
+    static constexpr uint32_t kSamplePeriodUs = 1000;   ///< 1 kHz
+    static constexpr uint32_t kDebounceMs = 20;         ///< Time a new level must hold
+    static constexpr size_t kQueueSize = 32;            ///< Edge queue depth (power of 2)
+
+    /// Read position of one consumer in the edge queue
+    struct Cursor {
+        uint32_t tail = 0;
+    };
+
+    static ButtonSampler& getInstance();
+
+    /**
+     * @brief Start the 1 kHz sampling timer
+     * @return true if the timer is running
+     */
+    bool begin();
+
+    /// True while the timer is sampling
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief Sample once from the caller (only when the timer is not running)
+     *
+     * Keeps consumers working if begin() failed or was never called.
+     * InputManager::update() calls this, so the fallback still has a single
+     * writer; debouncing then runs at the control loop rate.
+     */
+    void poll();
+
+    /// Debounced levels, bit set = pressed
+    uint8_t getLevels() const { return levels_.load(std::memory_order_acquire); }
+
+    /// Undebounced levels of the latest sample
+    uint8_t getRawLevels() const { return raw_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Copy the edges a reader has not seen yet
+     * @param cursor Reader position (advanced past the returned edges)
+     * @param out Destination
+     * @param maxEdges Capacity of `out`
+     * @return Number of edges copied
+     */
+    size_t readEdges(Cursor& cursor, ButtonEdge* out, size_t maxEdges);
+
+    /**
+     * @brief Fold all unseen edges into press/release masks
+     * @param cursor Reader position (advanced to the newest edge)
+     */
+    ButtonChanges collect(Cursor& cursor);
+
+    /// Button bit for a GPIO pin (0 if the pin is not a button)
+    static uint8_t bitForPin(uint8_t pin);
+
+private:
+    ButtonSampler();
+    ButtonSampler(const ButtonSampler&) = delete;
+    ButtonSampler& operator=(const ButtonSampler&) = delete;
+
+    static void timerCallback(void* arg);
+    static uint8_t readButtonLevels();
+    void sample();
+
+    ButtonEdge queue_[kQueueSize];
+    std::atomic<uint32_t> head_;        ///< Edges written since begin
+    std::atomic<uint8_t> levels_;
+    std::atomic<uint8_t> raw_;
+    uint8_t pending_;                   ///< Buttons whose raw level differs from levels_
+    uint32_t pendingSinceMs_[kButtonCount];
+    esp_timer_handle_t timer_;
+    volatile bool running_;
+};
+
+#endif // ILITE_BUTTON_SAMPLER_H
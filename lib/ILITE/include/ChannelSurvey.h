@@ -0,0 +1,93 @@
+/**
+ * @file ChannelSurvey.h
+ * @brief Boot-time channel survey and loss-driven channel hops
+ *
+ * ESP-NOW used to stay on whatever channel the radio came up on, which in
+ * a crowded venue is often the busiest one. With ILITEConfig::autoChannel:
+ *
+ * - **Survey**: before ESP-NOW starts, the radio listens promiscuously on
+ *   channels 1-13 for a short dwell each and estimates how much of the
+ *   time each one is busy. Every candidate in kChannelCandidates is scored
+ *   by the airtime on it and on the channels it overlaps (a channel 2
+ *   apart weighs 3/5, 4 apart 1/5), and the lowest score wins.
+ * - **Hop**: ServiceTask compares the paired peer's LinkMetrics counters
+ *   over kEvalWindowMs windows. After kDegradedWindows windows in a row
+ *   with too many unacknowledged sends (once LinkRate has no lower rate
+ *   left to try) or a high round-trip average, the controller moves the
+ *   link to the next-best candidate with
+ *   EspNowDiscovery::requestChannelSwitch(), at most once per
+ *   kHopCooldownMs.
+ *
+ * Rates are not decoded from the RX control header, so the airtime is an
+ * estimate at a fixed rate. It ranks channels; it does not measure them.
+ *
+ * Robots must run firmware that follows MSG_CHANNEL (see
+ * espnow_protocol.md), which is why the feature is off by default.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_CHANNEL_SURVEY_H
+#define ILITE_CHANNEL_SURVEY_H
+
+#include <Arduino.h>
+
+class EspNowDiscovery;
+
+/**
+ * @brief What one channel's dwell heard
+ */
+struct ChannelActivity {
+    uint32_t frames = 0;
+    uint32_t busyUs = 0;            ///< Estimated airtime during the dwell
+    int8_t peakRssi = -128;         ///< Strongest frame (dBm)
+};
+
+/**
+ * @class ChannelSurvey
+ * @brief Static channel survey plus the hop policy
+ */
+class ChannelSurvey {
+public:
+    static constexpr uint32_t kDefaultDwellMs = 40;
+    static constexpr uint32_t kEvalWindowMs = 2000;
+    static constexpr uint8_t kDegradedFailPercent = 25;     ///< Unacknowledged sends in a window
+    static constexpr uint32_t kDegradedRttUs = 20000;       ///< Round-trip moving average
+    static constexpr uint32_t kMinWindowSends = 20;         ///< Fewer sends are not judged
+    static constexpr uint8_t kDegradedWindows = 2;
+    static constexpr uint32_t kHopCooldownMs = 30000;
+
+    /**
+     * @brief Listen on every channel for `dwellMs`
+     *
+     * Blocks for about 13 x dwellMs and leaves the radio on whichever
+     * channel it was on. Borrows promiscuous receive; call
+     * LinkMetrics::restorePromiscuous() afterwards if LinkMetrics runs.
+     * Refused while the softAP is up.
+     *
+     * @return The best candidate, or 0 if the survey could not run
+     */
+    static uint8_t run(uint32_t dwellMs);
+
+    static bool hasResult();
+    static const ChannelActivity& getActivity(uint8_t channel);
+
+    /// Airtime score of a channel including its overlapping neighbours
+    static uint32_t score(uint8_t channel);
+
+    /**
+     * @brief Best candidate other than `excluding`
+     *
+     * Without a survey, the candidate after `excluding` in kChannelCandidates.
+     */
+    static uint8_t bestChannel(uint8_t excluding = 0);
+
+    /// Judge the link and hop when it stays degraded (ServiceTask)
+    static void setAutoHop(bool enabled);
+    static void service(EspNowDiscovery& discovery, uint32_t now);
+
+    static void dump(Print& out, const EspNowDiscovery& discovery);
+};
+
+#endif // ILITE_CHANNEL_SURVEY_H
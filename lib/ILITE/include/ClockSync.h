@@ -0,0 +1,123 @@
+/**
+ * @file ClockSync.h
+ * @brief Robot-to-controller clock offset and skew estimation
+ *
+ * Telemetry is stamped with its arrival time on the controller, which adds
+ * radio jitter and queueing to every sample. ClockSync estimates the robot's
+ * esp_timer clock in controller time, so a packet that carries the robot's
+ * sampling time can be placed on the controller's timeline instead.
+ *
+ * The estimate runs over the link pings EspNowDiscovery already sends to
+ * the paired peer (MSG_PING / MSG_PONG). Robots with clock sync append two
+ * stamps to each pong (PongPacket): when the ping arrived and when the pong
+ * left. With the controller's send and receive times this gives the four
+ * NTP timestamps t1..t4:
+ *
+ *     offset = ((t2 - t1) + (t3 - t4)) / 2        delay = (t4 - t1) - (t3 - t2)
+ *
+ * - **Filter**: of each kWindow consecutive samples only the one with the
+ *   lowest delay is kept (an anchor); queueing only ever adds delay, so it
+ *   carries the least error. Samples slower than kMaxDelayUs are dropped.
+ * - **Skew**: a least-squares line through the last kAnchors anchors gives
+ *   the drift between the two crystals (ppm) and the offset at any time.
+ *
+ * Robots that only echo the ping leave the estimate unsynced, and callers
+ * fall back to arrival times. All times are the low 32 bits of
+ * esp_timer_get_time() (micros()), so the offset is taken modulo 2^32.
+ *
+ * "clock" on the console prints the estimate.
+ *
+ * ## Thread Safety:
+ * onPong() runs on RxTask and reset() on ServiceTask; both change the
+ * filter and the estimate under one spinlock, and the estimate can be read
+ * from any task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_CLOCK_SYNC_H
+#define ILITE_CLOCK_SYNC_H
+
+#include <Arduino.h>
+
+/**
+ * @class ClockSync
+ * @brief Static NTP-style clock estimator for the paired peer
+ */
+class ClockSync {
+public:
+    static constexpr size_t kWindow = 8;                ///< Samples per anchor
+    static constexpr size_t kAnchors = 16;              ///< Anchors in the skew fit
+    static constexpr size_t kMinSkewAnchors = 3;        ///< Fewer: offset only
+    static constexpr uint32_t kMaxDelayUs = 20000;      ///< Slower round trips are dropped
+    static constexpr float kMaxSkewPpm = 200.0f;        ///< Fits beyond this are rejected
+
+    /**
+     * @brief Add one exchange (RxTask)
+     * @param mac Peer that answered; a different peer restarts the estimate
+     * @param sentUs t1: controller time the ping was sent
+     * @param robotRxUs t2: robot time the ping arrived
+     * @param robotTxUs t3: robot time the pong was sent
+     * @param receivedUs t4: controller time the pong arrived
+     */
+    static void onPong(const uint8_t* mac, uint32_t sentUs, uint32_t robotRxUs,
+                       uint32_t robotTxUs, uint32_t receivedUs);
+
+    /// Forget the estimate (link lost or new peer)
+    static void reset();
+
+    /// Whether at least one anchor is in
+    static bool isSynced();
+
+    /**
+     * @brief Map a robot timestamp onto the controller's micros()
+     * @return The controller time, or robotUs unchanged while unsynced
+     */
+    static uint32_t toLocalUs(uint32_t robotUs);
+
+    /// Robot clock minus controller clock now (us, modulo 2^32)
+    static uint32_t getOffsetUs();
+
+    /// Robot clock rate relative to the controller's (ppm, + = robot fast)
+    static float getSkewPpm();
+
+    /// Lowest round-trip delay of the newest anchor (us)
+    static uint32_t getDelayUs();
+
+    static void dump(Print& out);
+
+private:
+    struct Sample {
+        uint32_t localUs;       ///< Controller time at the midpoint of the exchange
+        uint32_t offsetUs;      ///< Robot minus controller at that time
+        uint32_t delayUs;
+    };
+
+    struct Estimate {
+        bool synced;
+        uint32_t baseLocalUs;   ///< Controller time the base offset applies at
+        uint32_t baseOffsetUs;
+        float skew;             ///< Offset change per controller microsecond
+        uint32_t delayUs;
+        uint32_t samples;
+        uint32_t anchors;
+    };
+
+    static bool addAnchor(const Sample& anchor, float& rejectedPpm);
+    static void clear();
+    static Estimate snapshot();
+
+    static uint8_t mac_[6];
+    static Sample window_[kWindow];
+    static size_t windowCount_;
+    static Sample anchors_[kAnchors];
+    static size_t anchorHead_;
+    static size_t anchorCount_;
+    static uint32_t samples_;
+    static uint32_t rejected_;
+    static Estimate estimate_;
+    static portMUX_TYPE lock_;
+};
+
+#endif // ILITE_CLOCK_SYNC_H
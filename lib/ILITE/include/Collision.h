@@ -0,0 +1,243 @@
+/**
+ * @file Collision.h
+ * @brief Capsule and box collision checks for solved arm poses
+ *
+ * Neither arm solver knows about the robot around the arm, so a target
+ * behind the camera mast or inside the chassis solves as reachable. A
+ * CollisionScene describes the arm as a chain of joints whose links are
+ * capsules (segment plus radius), and the fixed parts of the robot as a
+ * handful of axis-aligned boxes in the same frame. check() runs once on a
+ * solved pose:
+ *
+ * - Self: every pair of links that share no joint (zero-length links
+ *   between them do not count), segment-segment distance against the sum
+ *   of their radii.
+ * - Obstacles: every link against every box grown by the link's radius
+ *   (slab test), except links a box lists in ignoreLinks (the turret the
+ *   first link is mounted on).
+ *
+ * Growing a box by the radius instead of rounding it leaves its edges and
+ * corners up to radius * (sqrt(3) - 1) too fat: a near miss may be
+ * rejected, a hit is never missed.
+ *
+ * Header-only float code like Kinematics.h, so it builds on the host;
+ * examples/KinematicsBenchmark times check() against the control tick.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * Kinematics::CollisionScene scene;
+ * scene.setLinkRadius(0, 20.0f);
+ * scene.addBox({{-200, -150, -400}, {200, 150, -120}, "chassis", 0});
+ *
+ * const Kinematics::CollisionHit hit = scene.check(joints, jointCount);
+ * if (hit) {
+ *     // Keep the last pose that was clear
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_COLLISION_H
+#define ILITE_COLLISION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Kinematics.h"
+
+namespace Kinematics {
+
+typedef Vec3T<float> Vec3f;
+
+/**
+ * @brief Fixed obstacle, axis-aligned in the arm's frame (mm)
+ */
+struct CollisionBox {
+    Vec3f min;
+    Vec3f max;
+    const char* name;
+    uint8_t ignoreLinks;    ///< Bit n set: link n may touch this box
+};
+
+enum class CollisionKind : uint8_t {
+    None,
+    Self,           ///< Two links of the arm
+    Obstacle        ///< A link and a box
+};
+
+struct CollisionHit {
+    CollisionKind kind = CollisionKind::None;
+    uint8_t link = 0;       ///< Link involved (the lower index for Self)
+    uint8_t other = 0;      ///< Second link (Self) or box index (Obstacle)
+
+    explicit operator bool() const { return kind != CollisionKind::None; }
+};
+
+/**
+ * @brief Squared distance between segments p1-q1 and p2-q2
+ *
+ * Closest points by clamped parameters (Ericson, Real-Time Collision
+ * Detection 5.1.9); zero-length segments are points.
+ */
+inline float segmentDistanceSq(const Vec3f& p1, const Vec3f& q1, const Vec3f& p2, const Vec3f& q2) {
+    const float kEpsilon = 1e-6f;
+    const Vec3f d1 = q1 - p1;
+    const Vec3f d2 = q2 - p2;
+    const Vec3f r = p1 - p2;
+    const float a = d1.dot(d1);
+    const float e = d2.dot(d2);
+    const float f = d2.dot(r);
+
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= kEpsilon && e <= kEpsilon) {
+        return r.dot(r);
+    }
+    if (a <= kEpsilon) {
+        t = clampScalar(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = d1.dot(r);
+        if (e <= kEpsilon) {
+            s = clampScalar(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = d1.dot(d2);
+            const float denom = a * e - b * b;
+            // Parallel segments: any s works, start from p1
+            s = denom > kEpsilon ? clampScalar((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = clampScalar(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = clampScalar((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    const Vec3f gap = (p1 + d1 * s) - (p2 + d2 * t);
+    return gap.dot(gap);
+}
+
+/**
+ * @brief Whether segment a-b passes through a box grown by `grow` on every side
+ */
+inline bool segmentHitsBox(const Vec3f& a, const Vec3f& b, const CollisionBox& box, float grow) {
+    const float start[3] = {a.x, a.y, a.z};
+    const float delta[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+    const float lo[3] = {box.min.x - grow, box.min.y - grow, box.min.z - grow};
+    const float hi[3] = {box.max.x + grow, box.max.y + grow, box.max.z + grow};
+
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (absScalar(delta[axis]) < 1e-6f) {
+            if (start[axis] < lo[axis] || start[axis] > hi[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const float inv = 1.0f / delta[axis];
+        float t0 = (lo[axis] - start[axis]) * inv;
+        float t1 = (hi[axis] - start[axis]) * inv;
+        if (t0 > t1) {
+            const float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        tEnter = maxScalar(tEnter, t0);
+        tExit = minScalar(tExit, t1);
+        if (tEnter > tExit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @class CollisionScene
+ * @brief Link radii and obstacle boxes of one robot
+ */
+class CollisionScene {
+public:
+    static constexpr size_t kMaxLinks = 8;
+    static constexpr size_t kMaxBoxes = 8;
+
+    /// Link n joins joint n and joint n + 1; links without a radius are lines
+    void setLinkRadius(size_t link, float radiusMm) {
+        if (link < kMaxLinks) {
+            radius_[link] = radiusMm;
+        }
+    }
+
+    float getLinkRadius(size_t link) const {
+        return link < kMaxLinks ? radius_[link] : 0.0f;
+    }
+
+    /// @return false if kMaxBoxes are defined already
+    bool addBox(const CollisionBox& box) {
+        if (boxCount_ >= kMaxBoxes) {
+            return false;
+        }
+        boxes_[boxCount_++] = box;
+        return true;
+    }
+
+    void clearBoxes() { boxCount_ = 0; }
+    size_t getBoxCount() const { return boxCount_; }
+    const CollisionBox& getBox(size_t index) const { return boxes_[index]; }
+
+    /**
+     * @brief First collision of a pose, self collisions first
+     * @param joints Joint positions along the arm, base first
+     */
+    CollisionHit check(const Vec3f* joints, size_t jointCount) const {
+        CollisionHit hit;
+        size_t links = jointCount > 0 ? jointCount - 1 : 0;
+        if (links > kMaxLinks) {
+            links = kMaxLinks;
+        }
+
+        for (size_t i = 0; i + 2 < links; ++i) {
+            for (size_t j = i + 2; j < links; ++j) {
+                // Zero-length links in between (a retracted extension) make
+                // the pair adjacent after all
+                if ((joints[j] - joints[i + 1]).magSq() < 1e-6f) {
+                    continue;
+                }
+                const float reach = radius_[i] + radius_[j];
+                if (segmentDistanceSq(joints[i], joints[i + 1], joints[j], joints[j + 1]) < reach * reach) {
+                    hit.kind = CollisionKind::Self;
+                    hit.link = static_cast<uint8_t>(i);
+                    hit.other = static_cast<uint8_t>(j);
+                    return hit;
+                }
+            }
+        }
+
+        for (size_t b = 0; b < boxCount_; ++b) {
+            const CollisionBox& box = boxes_[b];
+            for (size_t i = 0; i < links; ++i) {
+                if ((box.ignoreLinks & (1U << i)) != 0) {
+                    continue;
+                }
+                if (segmentHitsBox(joints[i], joints[i + 1], box, radius_[i])) {
+                    hit.kind = CollisionKind::Obstacle;
+                    hit.link = static_cast<uint8_t>(i);
+                    hit.other = static_cast<uint8_t>(b);
+                    return hit;
+                }
+            }
+        }
+        return hit;
+    }
+
+private:
+    float radius_[kMaxLinks] = {};
+    CollisionBox boxes_[kMaxBoxes];
+    size_t boxCount_ = 0;
+};
+
+}  // namespace Kinematics
+
+#endif // ILITE_COLLISION_H
@@ -0,0 +1,103 @@
+/**
+ * @file CommandSchedule.h
+ * @brief Per-type send periods for command packets
+ *
+ * CommTask used to build and send every command type on every control
+ * tick. A drive command wants the full rate, while configuration or
+ * settings packets only matter on change or about once a second. With
+ * PacketDescriptor::periodMs set, a type is only built
+ * (prepareCommandPacket()) and sent on the ticks where it is due:
+ *
+ * - periodMs 0, or not longer than the tick, is due on every tick.
+ * - Slower types get a phase when the module is loaded, so types with
+ *   the same period leave on different ticks instead of in one burst.
+ * - Due types go out highest PacketDescriptor::priority first, so they
+ *   claim the TX window before the bulk types; equal priorities keep
+ *   their index order.
+ *
+ * The tick itself stays at ILITEConfig::controlLoopHz: updateControl()
+ * runs every tick, and the fastest type sets the useful control rate.
+ * A changed packet of a slow type waits for its next due tick; under
+ * change-only sending an unchanged one is still skipped when due.
+ *
+ * Each schedule also measures the achieved rate per type (built and
+ * sent per second); "sched" on the console prints it for the paired
+ * robot.
+ *
+ * One schedule per driven peer, CommTask only.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_COMMAND_SCHEDULE_H
+#define ILITE_COMMAND_SCHEDULE_H
+
+#include <Arduino.h>
+
+class ILITEModule;
+struct PacketDescriptor;
+
+/**
+ * @brief Measured rate of one command type
+ */
+struct CommandTypeRate {
+    uint16_t periodMs = 0;          ///< From the descriptor (0 = every tick)
+    uint8_t priority = 0;
+    float builtHz = 0.0f;           ///< prepareCommandPacket() calls per second
+    float sentHz = 0.0f;            ///< Packets handed to the link per second
+};
+
+/**
+ * @class CommandSchedule
+ * @brief Due types of one peer's module, per control tick
+ */
+class CommandSchedule {
+public:
+    static constexpr size_t kMaxTypes = 8;              ///< Scheduled types; later ones run every tick
+    static constexpr uint32_t kRateWindowUs = 1000000;
+
+    CommandSchedule();
+
+    /// Forget the periods (new module or new link); the next plan() reloads them
+    void reset();
+
+    /**
+     * @brief Types due on this tick, highest priority first
+     *
+     * @param descriptors The module's command descriptors (cached by the caller)
+     * @param count Number of descriptors (at most kMaxTypes are scheduled)
+     * @param due Receives up to kMaxTypes type indices
+     * @return Number of due types written
+     */
+    size_t plan(const PacketDescriptor* descriptors, size_t count, uint32_t nowUs,
+                uint32_t tickUs, uint8_t* due);
+
+    /// The type's packet was built / handed to the link this tick
+    void onBuilt(size_t typeIndex);
+    void onSent(size_t typeIndex);
+
+    size_t getCount() const { return count_; }
+    const CommandTypeRate& getRate(size_t typeIndex) const { return rates_[typeIndex]; }
+
+    /// One line per type; names come from `module` when given
+    void dump(Print& out, const ILITEModule* module) const;
+
+private:
+    struct Type {
+        uint32_t periodUs;          ///< 0 = every tick
+        uint32_t nextDueUs;
+        uint32_t built;             ///< In the current rate window
+        uint32_t sent;
+    };
+
+    void load(const PacketDescriptor* descriptors, size_t count, uint32_t nowUs, uint32_t tickUs);
+
+    Type types_[kMaxTypes];
+    CommandTypeRate rates_[kMaxTypes];
+    size_t count_;
+    uint32_t windowStartUs_;
+    bool loaded_;
+};
+
+#endif // ILITE_COMMAND_SCHEDULE_H
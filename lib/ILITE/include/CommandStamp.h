@@ -0,0 +1,116 @@
+/**
+ * @file CommandStamp.h
+ * @brief Optional sequence/timestamp header on command frames, and its echo
+ *
+ * Module command packets have no sequence number or timestamp, so the
+ * controller cannot tell how old the command a robot is acting on is. With
+ * ILITEConfig::commandStamps enabled, CommTask wraps every command frame
+ * (single packet or bundle) in a stamp header:
+ *
+ *     [STAMP_MAGIC:4][sequence:4][inputUs:4][frame bytes...]
+ *
+ * `inputUs` is the low 32 bits of esp_timer_get_time() when the tick's
+ * input snapshot was taken. A robot that understands stamps strips the
+ * header (unwrapCommandStamp), applies the command, and wraps its telemetry
+ * in an echo of the last applied stamp:
+ *
+ *     [ECHO_MAGIC:4][sequence:4][inputUs:4][telemetry bytes...]
+ *
+ * PacketRouter unwraps echoes before normal routing and feeds
+ * CommandLatency, so `now - inputUs` measures input snapshot -> command
+ * applied on the robot -> telemetry back, on the controller's clock alone.
+ * Robots that do not echo are unaffected; robots that do not understand
+ * stamps must not be sent them.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_COMMAND_STAMP_H
+#define ILITE_COMMAND_STAMP_H
+
+#include <Arduino.h>
+
+/// Magic of a stamped command frame ('STMP')
+constexpr uint32_t STAMP_PACKET_MAGIC = 0x53544D50;
+
+/// Magic of a telemetry frame carrying a stamp echo ('ECHO')
+constexpr uint32_t ECHO_PACKET_MAGIC = 0x4543484F;
+
+#pragma pack(push, 1)
+/// Header shared by stamp and echo frames
+struct CommandStampHeader {
+    uint32_t magic;
+    uint32_t sequence;      ///< Incremented once per stamped frame
+    uint32_t inputUs;       ///< esp_timer (low 32 bits) of the input snapshot
+};
+#pragma pack(pop)
+
+constexpr size_t kCommandStampSize = sizeof(CommandStampHeader);
+
+/**
+ * @brief Write `header` + `frame` into `out`
+ * @return Bytes written, or 0 if it does not fit
+ */
+size_t writeStampedFrame(uint8_t* out, size_t capacity, const CommandStampHeader& header,
+                         const uint8_t* frame, size_t length);
+
+/**
+ * @brief Split a stamp or echo frame into header and inner frame
+ * @param magic STAMP_PACKET_MAGIC or ECHO_PACKET_MAGIC
+ * @return Inner frame, or nullptr if `data` is not a frame of that kind
+ */
+const uint8_t* unwrapStampedFrame(const uint8_t* data, size_t length, uint32_t magic,
+                                  CommandStampHeader& header, size_t& innerLength);
+
+/// Robot side: strip a command stamp (nullptr if the frame is not stamped)
+inline const uint8_t* unwrapCommandStamp(const uint8_t* data, size_t length,
+                                         CommandStampHeader& header, size_t& innerLength) {
+    return unwrapStampedFrame(data, length, STAMP_PACKET_MAGIC, header, innerLength);
+}
+
+static constexpr size_t kCommandLatencyBuckets = 8;
+
+/**
+ * @brief End-to-end command latency from stamp echoes
+ */
+struct CommandLatencyStats {
+    uint32_t lastSentSeq = 0;       ///< Sequence of the newest stamped frame
+    uint32_t lastEchoSeq = 0;       ///< Newest sequence the robot reported applied
+    uint32_t echoes = 0;
+    uint32_t skippedSeq = 0;        ///< Sequences never echoed (superseded or lost)
+    uint32_t lastUs = 0;
+    uint32_t minUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t avgUs = 0;             ///< Moving average (1/8 weight)
+    uint32_t histogram[kCommandLatencyBuckets] = {};
+};
+
+/**
+ * @class CommandLatency
+ * @brief Stamp sequencing (CommTask) and echo statistics (RxTask)
+ */
+class CommandLatency {
+public:
+    /// Upper bound (us) of each histogram bucket; the last is open-ended
+    static const uint32_t kBucketUs[kCommandLatencyBuckets];
+
+    /// Next stamp header for a frame whose inputs were sampled at `inputUs`
+    static CommandStampHeader nextStamp(uint32_t inputUs);
+
+    /// An echo arrived (PacketRouter)
+    static void onEcho(const CommandStampHeader& echo);
+
+    static const CommandLatencyStats& getStats() { return stats_; }
+
+    /// Frames sent but not yet echoed
+    static uint32_t getOutstanding() { return stats_.lastSentSeq - stats_.lastEchoSeq; }
+
+    static void reset();
+    static void dump(Print& out);
+
+private:
+    static CommandLatencyStats stats_;
+};
+
+#endif // ILITE_COMMAND_STAMP_H
@@ -0,0 +1,148 @@
+/**
+ * @file CommandTable.h
+ * @brief Console and module commands looked up by perfect hash
+ *
+ * The serial console compared each line against every command with
+ * strcmp()/strncmp() in one long else-if chain, and modules parsed their
+ * terminal commands the same way, so the cost of a line grew with the
+ * number of commands and each argument was parsed by hand. A CommandTable
+ * indexes an array of CommandSpec once:
+ *
+ * - **Names** are one or two words ("prof", "prof reset"), matched without
+ *   regard to case. A line is tokenized once; its first two words are
+ *   looked up as a pair, then the first word alone, so "log clear" and
+ *   "log router debug" reach different commands.
+ * - **Lookup** hashes the words once (FNV-1a) and finds the only slot the
+ *   name can be in: buckets get a displacement chosen at build time so
+ *   that no two names share a slot (hash and displace). One string
+ *   compare confirms the hit, however many commands there are.
+ * - **Arguments** are checked against the spec's schema and converted
+ *   before the handler runs; a bad line prints the usage instead.
+ * - **Completion**: complete() lists the names starting with a prefix, for
+ *   StringBuilder suggestions and the console's tab key.
+ *
+ * Schema characters, one per argument: `u` decimal unsigned, `i` signed,
+ * `x` hex, `f` float, `s` word. Arguments after a `?` are optional.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * static const CommandSpec kCommands[] = {
+ *     {"status", "", nullptr, [](const CommandArgs&, Print& out) { dumpStatus(out); }},
+ *     {"gain set", "sf", "<axis> <gain>", [](const CommandArgs& args, Print& out) {
+ *         setGain(args.word(0), args.asFloat(1));
+ *     }},
+ * };
+ * static const CommandTable commands(kCommands, sizeof(kCommands) / sizeof(kCommands[0]));
+ *
+ * commands.dispatch("gain set roll 0.8", Serial);
+ * ```
+ *
+ * The table keeps a pointer to the specs; they must outlive it.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_COMMAND_TABLE_H
+#define ILITE_COMMAND_TABLE_H
+
+#include <Arduino.h>
+#include "Delegate.h"
+
+/**
+ * @brief Converted arguments of one command line
+ */
+struct CommandArgs {
+    static constexpr size_t kMaxArgs = 4;
+
+    size_t count = 0;
+    const char* text[kMaxArgs] = {};
+
+    /// Word i as typed, or nullptr if not given
+    const char* word(size_t index) const { return index < count ? text[index] : nullptr; }
+    bool has(size_t index) const { return index < count; }
+
+    uint32_t asUnsigned(size_t index) const { return index < count ? value_[index].u : 0; }
+    int32_t asInt(size_t index) const { return index < count ? value_[index].i : 0; }
+    float asFloat(size_t index) const { return index < count ? value_[index].f : 0.0f; }
+
+private:
+    friend class CommandTable;
+
+    union Value {
+        uint32_t u;
+        int32_t i;
+        float f;
+    };
+    Value value_[kMaxArgs] = {};
+};
+
+typedef Delegate<void(const CommandArgs&, Print&)> CommandHandler;
+
+struct CommandSpec {
+    const char* name;       ///< One or two words, e.g. "prof reset"
+    const char* args;       ///< Schema, e.g. "ux" or "?u"
+    const char* usage;      ///< Argument help, e.g. "<bytes> <crc32 hex>" (nullptr = none)
+    CommandHandler handler;
+};
+
+enum class CommandResult : uint8_t {
+    Ran,
+    Unknown,
+    BadArgs         ///< Name known; the usage was printed
+};
+
+/**
+ * @class CommandTable
+ * @brief Perfect-hash index over an array of CommandSpec
+ */
+class CommandTable {
+public:
+    static constexpr size_t kMaxCommands = 96;
+    static constexpr size_t kMaxLine = 64;
+    static constexpr size_t kSlots = 128;
+    static constexpr size_t kBuckets = 32;
+
+    CommandTable() = default;
+    CommandTable(const CommandSpec* specs, size_t count) { assign(specs, count); }
+
+    /**
+     * @brief Index `specs` (replacing the previous array)
+     * @return false if a name is duplicated or no displacement was found;
+     *         lookups then scan the array
+     */
+    bool assign(const CommandSpec* specs, size_t count);
+
+    /// Tokenize `line`, find its command, convert the arguments and run it
+    CommandResult dispatch(const char* line, Print& out) const;
+
+    /// Spec named `name` (one or two words), or nullptr
+    const CommandSpec* find(const char* name) const;
+
+    /**
+     * @brief Names starting with `prefix` (case ignored), in table order
+     * @param matches Receives up to `maxMatches` names (may be nullptr)
+     * @return Number of names that match, even if more than maxMatches
+     */
+    size_t complete(const char* prefix, const char** matches, size_t maxMatches) const;
+
+    /// Names and usages starting with `prefix` ("help")
+    void dump(Print& out, const char* prefix = "") const;
+
+    size_t size() const { return count_; }
+    bool isPerfect() const { return perfect_; }
+
+private:
+    static constexpr uint8_t kEmpty = 0xFF;
+
+    const CommandSpec* lookup(const char* const* words, size_t wordCount) const;
+    bool buildIndex();
+
+    const CommandSpec* specs_ = nullptr;
+    size_t count_ = 0;
+    bool perfect_ = false;
+    uint8_t displacement_[kBuckets] = {};
+    uint8_t slots_[kSlots] = {};
+};
+
+#endif // ILITE_COMMAND_TABLE_H
@@ -5,6 +5,13 @@
  * Allows users to bind input events (press, hold, double-click) to actions
  * with conditions and screen-specific contexts.
  *
+ * Bindings live in a fixed pool of kMaxBindings slots. Each (input, event)
+ * pair has its own list of slots, kept sorted by priority at registration,
+ * so dispatching an event only visits the bindings for that event. Callbacks
+ * are Delegate, which stores the lambda in the binding itself (one pointer
+ * of capture); with the fixed pool, registering and clearing bindings
+ * (including the module capture on every module switch) never allocates.
+ *
  * @example
  * ```cpp
  * REGISTER_CONTROL_BINDING(
@@ -22,8 +29,8 @@
 #define ILITE_CONTROL_BINDING_SYSTEM_H
 
 #include <Arduino.h>
-#include <vector>
-#include <functional>
+#include "ButtonSampler.h"
+#include "Delegate.h"
 
 /**
  * @brief Input event types
@@ -34,7 +41,8 @@ enum ControlEvent {
     EVENT_CLICK,         ///< Quick press + release (< 300ms)
     EVENT_HOLD,          ///< Held for specified duration
     EVENT_DOUBLE_CLICK,  ///< Two clicks within 300ms
-    EVENT_LONG_PRESS     ///< Held for 2+ seconds
+    EVENT_LONG_PRESS,    ///< Held for 2+ seconds
+    EVENT_COUNT          ///< Number of events (not an event)
 };
 
 /**
@@ -47,7 +55,8 @@ enum ControlInput {
     INPUT_JOYSTICK_A_BUTTON,
     INPUT_JOYSTICK_B_BUTTON,
     INPUT_ENCODER_BUTTON,
-    INPUT_ENCODER_ROTATE
+    INPUT_ENCODER_ROTATE,
+    INPUT_COUNT             ///< Number of inputs (not an input)
 };
 
 /**
@@ -56,13 +65,14 @@ enum ControlInput {
 struct ControlBinding {
     ControlInput input;                     ///< Input to bind
     ControlEvent event;                     ///< Event type
-    std::function<void()> action;           ///< Action callback
-    std::function<void(int)> actionWithValue; ///< Action with value (for encoder)
-    std::function<bool()> condition;        ///< Condition (optional)
+    Delegate<void()> action;                ///< Action callback
+    Delegate<void(int)> actionWithValue;    ///< Action with value (for encoder)
+    Delegate<bool()> condition;             ///< Condition (optional)
     const char* screenId;                   ///< Screen-specific binding (optional)
     uint32_t duration;                      ///< Duration for HOLD event (ms)
     int priority;                           ///< Priority (higher = executed first)
     bool moduleOwned = false;               ///< true if binding belongs to currently active module
+    bool standby = false;                   ///< Module-owned, but its module is in standby (not dispatched)
 };
 
 /**
@@ -75,11 +85,15 @@ public:
      */
     static void begin();
 
+    /// Binding pool size
+    static constexpr size_t kMaxBindings = 64;
+
     /**
      * @brief Register a control binding
      * @param binding Binding definition
+     * @return false if the pool is full or input/event is out of range
      */
-    static void registerBinding(const ControlBinding& binding);
+    static bool registerBinding(const ControlBinding& binding);
 
     /**
      * @brief Update control bindings (call in loop)
@@ -89,10 +103,9 @@ public:
     static void update();
 
     /**
-     * @brief Get all registered bindings
-     * @return Vector of bindings
+     * @brief Number of registered bindings
      */
-    static std::vector<ControlBinding>& getAllBindings();
+    static size_t getBindingCount();
 
     /**
      * @brief Clear all bindings
@@ -100,10 +113,17 @@ public:
     static void clear();
 
     /**
-     * @brief Clear only module-owned bindings
+     * @brief Clear only module-owned bindings (of the active module)
      */
     static void clearModuleBindings();
 
+    /**
+     * @brief Trade the active module's bindings for the standby module's
+     *
+     * Bindings in standby stay in the pool but are never dispatched.
+     */
+    static void swapModuleBindings();
+
     /**
      * @brief Enter module binding capture mode
      *
@@ -149,19 +169,51 @@ private:
         int lastCount;
     };
 
-    static std::vector<ControlBinding> bindings_;
+    /**
+     * @brief Pool slot; `next` links the slots of one (input, event) list
+     */
+    struct Slot {
+        ControlBinding binding;
+        uint8_t next;
+        uint8_t generation;     ///< Bumped on release, so dispatch can skip reused slots
+        bool used;
+    };
+
+    /**
+     * @brief Binding pool and per-(input, event) list heads
+     */
+    struct Table {
+        Slot slots[kMaxBindings];
+        uint8_t heads[INPUT_COUNT][EVENT_COUNT];
+        uint8_t freeHead;
+        size_t count;
+
+        Table();
+    };
+
+    static constexpr uint8_t kNoSlot = 0xFF;
+    static_assert(kMaxBindings < kNoSlot, "Slot indices must fit in uint8_t");
+
+    /// Pool (constructed on first use, so static-init registrations are safe)
+    static Table& table();
+
+    /// Return a slot to the free list
+    static void releaseSlot(Table& table, uint8_t index);
+
     static bool enabled_;
     static bool capturingModuleBindings_;
 
     static ButtonState buttonStates_[7];  // 6 buttons + encoder button
     static EncoderState encoderState_;
+    static ButtonSampler::Cursor buttonCursor_;
 
     /**
      * @brief Update button state and detect events
      * @param input Input identifier
-     * @param currentValue Current button value (true = pressed)
+     * @param changes Debounced levels and edges from ButtonSampler
+     * @param bit ButtonSampler bit of this input
      */
-    static void updateButton(ControlInput input, bool currentValue);
+    static void updateButton(ControlInput input, const ButtonChanges& changes, uint8_t bit);
 
     /**
      * @brief Update encoder and detect rotation
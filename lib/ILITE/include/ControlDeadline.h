@@ -0,0 +1,115 @@
+/**
+ * @file ControlDeadline.h
+ * @brief Per-stage deadline tracking and the degraded control tick
+ *
+ * ControlLoopStats only says that a tick ran long, not which part of it.
+ * A module whose updateControl() overruns, or a stage blocked on a slow
+ * call, makes the control timer queue ticks that then run back to back.
+ * ControlDeadline times every CommTask stage against its own budget, a
+ * share of the tick set in ILITEConfig:
+ *
+ *     input    sampling, replay, idle tracking, the input tap
+ *     ui       FrameworkEngine::update() (button and encoder hooks)
+ *     control  the module's updateControl()
+ *     transmit building and sending the command packets
+ *
+ * A tick overruns when it runs past its period or starts a tick late.
+ * With kEnterOverruns overrunning ticks among the last kHistoryTicks,
+ * CommTask drops to the degraded tick:
+ *
+ * - The UI hooks run only every kDegradedUiDivider ticks.
+ * - If updateControl() itself keeps blowing its budget, it runs every
+ *   other tick; dt covers both ticks.
+ * - Each peer gets only its safety command: the module's highest
+ *   PacketDescriptor::priority type (the first on a tie). It is built and
+ *   sent every tick, past the schedule and change-only sending. The
+ *   other types, rate requests and the telemetry tap are skipped.
+ *
+ * After kRecoverMs without an overrun the full tick returns. The top
+ * strip flashes the warning icon while degraded; "deadline" on the
+ * console prints the stages.
+ *
+ * CommTask only; other tasks read the stats for display.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_CONTROL_DEADLINE_H
+#define ILITE_CONTROL_DEADLINE_H
+
+#include <Arduino.h>
+
+/// CommTask stages, in tick order
+enum class ControlStage : uint8_t {
+    Input,
+    Ui,
+    Control,
+    Transmit,
+    Count
+};
+
+/**
+ * @brief Timing of one stage
+ */
+struct ControlStageStats {
+    uint32_t budgetUs = 0;          ///< Share of the current tick
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t overruns = 0;          ///< Runs past budgetUs
+    uint32_t skipped = 0;           ///< Ticks the degraded tick left it out
+};
+
+/**
+ * @brief Degraded-mode state and counters
+ */
+struct ControlDeadlineStats {
+    bool degraded = false;
+    uint32_t overrunTicks = 0;      ///< Ticks past their period or late
+    uint32_t missedTicks = 0;       ///< Timer releases that queued up behind a late tick
+    uint32_t entries = 0;           ///< Times the degraded tick started
+    uint32_t degradedTicks = 0;
+    uint32_t lastEntryMs = 0;
+};
+
+/**
+ * @class ControlDeadline
+ * @brief Static stage timer and degraded-mode switch
+ */
+class ControlDeadline {
+public:
+    static constexpr uint8_t kHistoryTicks = 16;
+    static constexpr uint8_t kEnterOverruns = 4;    ///< Of the last kHistoryTicks
+    static constexpr uint32_t kRecoverMs = 1000;
+    static constexpr uint8_t kDegradedUiDivider = 4;
+    static constexpr size_t kStageCount = static_cast<size_t>(ControlStage::Count);
+
+    /// Budgets in percent of the tick; degradation off only tracks
+    static void configure(const uint8_t budgetPercent[kStageCount], bool degradation);
+
+    /**
+     * @brief A tick starts
+     * @param missedTicks Timer releases beyond this one since the last tick
+     */
+    static void beginTick(uint32_t periodUs, int64_t startUs, uint32_t missedTicks);
+
+    /// `stage` ended now (or was skipped)
+    static void endStage(ControlStage stage);
+    static void skipStage(ControlStage stage);
+
+    /// Judge the tick and switch modes
+    static void endTick(uint32_t nowMs);
+
+    static bool isDegraded();
+    /// Whether this tick runs the stage (always true outside degraded mode)
+    static bool runsUi();
+    static bool runsControl();
+
+    static const char* name(ControlStage stage);
+    static const ControlStageStats& getStageStats(ControlStage stage);
+    static ControlDeadlineStats getStats();
+    static void reset();
+    static void dump(Print& out);
+};
+
+#endif // ILITE_CONTROL_DEADLINE_H
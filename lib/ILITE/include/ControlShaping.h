@@ -0,0 +1,285 @@
+/**
+ * @file ControlShaping.h
+ * @brief Float stick shaping shared by every module's updateControl()
+ *
+ * InputManager hands out calibrated, filtered axes in -1..+1 with its own
+ * small deadzone. What a module does with them next (a wider deadzone for a
+ * jittery axis, a softer center, a cap on how fast a value may move) used
+ * to be hand-rolled per module on raw ADC counts with integer map(). The
+ * pieces here do it once, in floats:
+ *
+ * - deadzone(): zero inside the band, rescaled outside it so the output
+ *   still reaches +-1 and has no step at the edge.
+ * - expo(): blends linear and cubic response; 0 is linear, 1 is fully
+ *   cubic (fine control near center, full throw at the ends).
+ * - slew(): moves a value toward a target by at most `ratePerSec * dt`.
+ * - Axis: the three in order plus a final scale, with the slew state kept
+ *   between ticks.
+ * - CurveTable: a response curve (expo, power, sine, ease-out, smoothstep)
+ *   sampled once into a 256-segment table and looked up with fixed-point
+ *   interpolation. An Axis bound to a table uses it in place of expo(), so
+ *   modules that pick the same curve and strength get the same response
+ *   and no powf()/sinf() per tick.
+ * - Setpoint: hysteresis plus quantization to actuator resolution for an
+ *   output that is sent only when it changes. Jitter inside the band
+ *   leaves the value bit-identical from tick to tick.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * ControlShaping::Axis roll(ControlShaping::AxisShape(0.08f, 0.3f, 90.0f));   // deadzone, expo, scale
+ *
+ * void updateControl(const InputManager& inputs, float dt) override {
+ *     command.roll = static_cast<int8_t>(roll.update(inputs.getJoystickB_X(), dt));
+ * }
+ * ```
+ *
+ * Shared curves:
+ * ```cpp
+ * static ControlShaping::CurveTable driveCurve;
+ * driveCurve.build(ControlShaping::Curve::Sine, 0.6f);    // menu change, not per tick
+ * throttleAxis.setCurve(&driveCurve);
+ * ```
+ *
+ * Free of Arduino dependencies, so it builds natively too.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_CONTROL_SHAPING_H
+#define ILITE_CONTROL_SHAPING_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace ControlShaping {
+
+/// Zero inside +-width, rescaled so the rest of the travel still spans 0..+-1
+inline float deadzone(float value, float width) {
+    if (width <= 0.0f) {
+        return value;
+    }
+    if (width >= 1.0f) {
+        return 0.0f;
+    }
+    const float magnitude = fabsf(value);
+    if (magnitude <= width) {
+        return 0.0f;
+    }
+    const float shaped = (magnitude - width) / (1.0f - width);
+    return value < 0.0f ? -shaped : shaped;
+}
+
+/// (1 - amount) * v + amount * v^3; keeps the sign and the +-1 end points
+inline float expo(float value, float amount) {
+    if (amount <= 0.0f) {
+        return value;
+    }
+    if (amount > 1.0f) {
+        amount = 1.0f;
+    }
+    return (1.0f - amount) * value + amount * value * value * value;
+}
+
+/// Step `current` toward `target` by at most ratePerSec * dt (rate 0 = jump)
+inline float slew(float current, float target, float ratePerSec, float dt) {
+    if (ratePerSec <= 0.0f || dt <= 0.0f) {
+        return target;
+    }
+    const float maxStep = ratePerSec * dt;
+    const float delta = target - current;
+    if (delta > maxStep) {
+        return current + maxStep;
+    }
+    if (delta < -maxStep) {
+        return current - maxStep;
+    }
+    return target;
+}
+
+inline float clamp(float value, float minValue, float maxValue) {
+    return value < minValue ? minValue : (value > maxValue ? maxValue : value);
+}
+
+/// Nearest multiple of `step` (step <= 0 = unchanged)
+inline float quantize(float value, float step) {
+    if (step <= 0.0f) {
+        return value;
+    }
+    return roundf(value / step) * step;
+}
+
+/**
+ * @brief Response curves a CurveTable can hold
+ *
+ * `strength` (0..1) blends from linear (0) to the full curve (1):
+ * - Expo: (1 - s) * v + s * v^3, the same as expo()
+ * - Power: v^(1 + 3s), soft start
+ * - Sine: blend with sin(v * pi/2), quick start
+ * - EaseOut: 1 - (1 - v)^(1 + 3s)
+ * - Smoothstep: blend with v^2 * (3 - 2v)
+ */
+enum class Curve : uint8_t {
+    Linear = 0,
+    Expo,
+    Power,
+    Sine,
+    EaseOut,
+    Smoothstep,
+};
+
+/// Curve magnitude at `magnitude` (0..1); what a CurveTable samples
+float evaluateCurve(Curve curve, float strength, float magnitude);
+
+/**
+ * @class CurveTable
+ * @brief One curve sampled over 0..1, applied symmetrically to -1..+1
+ *
+ * 257 points (256 segments) of unsigned Q16. A lookup is a multiply, a
+ * shift and one interpolation in integer math. build() costs 257 curve
+ * evaluations, so call it when a setting changes, from the task that does
+ * the lookups. The table is 514 bytes; share one between axes.
+ */
+class CurveTable {
+public:
+    static constexpr uint16_t kSegments = 256;
+
+    CurveTable() { build(Curve::Linear, 0.0f); }
+    CurveTable(Curve curve, float strength) { build(curve, strength); }
+
+    void build(Curve curve, float strength);
+
+    /// Rebuild only when the curve or strength differs from the current one
+    bool rebuildIfChanged(Curve curve, float strength) {
+        if (curve == curve_ && strength == strength_) {
+            return false;
+        }
+        build(curve, strength);
+        return true;
+    }
+
+    /// Shape `value` (-1..+1); the sign is kept
+    float apply(float value) const {
+        const float magnitude = value < 0.0f ? -value : value;
+        const uint32_t q = magnitude >= 1.0f ? (static_cast<uint32_t>(kSegments) << 8)
+                                             : static_cast<uint32_t>(magnitude * (kSegments << 8));
+        const float shaped = static_cast<float>(lookupQ16(q)) * (1.0f / 65535.0f);
+        return value < 0.0f ? -shaped : shaped;
+    }
+
+    /// Integer form: `q` is the magnitude in Q8 segments (0 .. kSegments << 8)
+    uint16_t lookupQ16(uint32_t q) const {
+        const uint32_t index = q >> 8;
+        if (index >= kSegments) {
+            return table_[kSegments];
+        }
+        const int32_t a = table_[index];
+        const int32_t b = table_[index + 1];
+        return static_cast<uint16_t>(a + (((b - a) * static_cast<int32_t>(q & 0xFF)) >> 8));
+    }
+
+    Curve curve() const { return curve_; }
+    float strength() const { return strength_; }
+
+private:
+    uint16_t table_[kSegments + 1];
+    Curve curve_ = Curve::Linear;
+    float strength_ = 0.0f;
+};
+
+/**
+ * @brief Shaping of one axis
+ *
+ * Applied in order: clamp to -1..+1, deadzone, expo (or the bound
+ * CurveTable), multiply by scale, then slew at ratePerSec (in output units
+ * per second; 0 = unlimited).
+ */
+struct AxisShape {
+    float deadzone;
+    float expo;
+    float scale;
+    float ratePerSec;
+
+    constexpr AxisShape(float deadzone = 0.0f, float expo = 0.0f, float scale = 1.0f,
+                        float ratePerSec = 0.0f)
+        : deadzone(deadzone), expo(expo), scale(scale), ratePerSec(ratePerSec) {}
+};
+
+/**
+ * @class Axis
+ * @brief AxisShape plus the slew state of one control output
+ */
+class Axis {
+public:
+    Axis() = default;
+    explicit Axis(const AxisShape& shape, float initial = 0.0f)
+        : shape_(shape), output_(initial) {}
+
+    /// Shape `input` (-1..+1) and return the new output
+    float update(float input, float dt) {
+        return updateScaled(input, shape_.scale, dt);
+    }
+
+    /// Same, with a scale chosen per tick (e.g. a precision mode)
+    float updateScaled(float input, float scale, float dt) {
+        const float centered = deadzone(clamp(input, -1.0f, 1.0f), shape_.deadzone);
+        const float shaped = curve_ != nullptr ? curve_->apply(centered) : expo(centered, shape_.expo);
+        output_ = slew(output_, shaped * scale, shape_.ratePerSec, dt);
+        return output_;
+    }
+
+    /// Jump to `value` (mode changes, disarm)
+    void reset(float value = 0.0f) { output_ = value; }
+
+    float value() const { return output_; }
+    const AxisShape& shape() const { return shape_; }
+    void setShape(const AxisShape& shape) { shape_ = shape; }
+
+    /// Use a shared table instead of shape().expo (nullptr = back to expo)
+    void setCurve(const CurveTable* curve) { curve_ = curve; }
+    const CurveTable* curve() const { return curve_; }
+
+private:
+    AxisShape shape_;
+    const CurveTable* curve_ = nullptr;
+    float output_ = 0.0f;
+};
+
+/**
+ * @class Setpoint
+ * @brief Hysteresis and quantization of one actuator command
+ *
+ * The output holds until the input moves more than `band` away from it,
+ * then jumps to the input rounded to a multiple of `step`. Keep band above
+ * step / 2: an input resting on a rounding boundary then cannot toggle,
+ * and update() with an unchanged input returns an unchanged output.
+ */
+class Setpoint {
+public:
+    Setpoint(float step = 0.0f, float band = 0.0f) : step_(step), band_(band) {}
+
+    float update(float input) {
+        if (!primed_ || fabsf(input - output_) > band_) {
+            output_ = quantize(input, step_);
+            primed_ = true;
+        }
+        return output_;
+    }
+
+    /// Take the next input as is (mode changes, resync to the robot)
+    void reset() { primed_ = false; }
+
+    float value() const { return output_; }
+    float step() const { return step_; }
+    float band() const { return band_; }
+
+private:
+    float step_;
+    float band_;
+    float output_ = 0.0f;
+    bool primed_ = false;
+};
+
+}  // namespace ControlShaping
+
+#endif // ILITE_CONTROL_SHAPING_H
@@ -0,0 +1,177 @@
+/**
+ * @file Delegate.h
+ * @brief Two-word callback: an invoke thunk plus one pointer of state
+ *
+ * MenuEntry, Screen and ControlBinding each carry a dozen callbacks, and
+ * nearly all of them are captureless lambdas, plain functions or lambdas
+ * capturing a single pointer (`this`, a module, a menu item). std::function
+ * spends 16 bytes per slot on ESP32 whether it is set or not. A Delegate
+ * is the function pointer and `void*` context pair C APIs use, built from
+ * a lambda:
+ *
+ * - The callable is stored in one pointer-sized word. Captureless lambdas,
+ *   function pointers and lambdas capturing one pointer or int fit.
+ * - There is no manager: the callable must be trivially copyable and
+ *   destructible, so a Delegate is too. Copying an entry is a memcpy and
+ *   nothing ever allocates.
+ * - Larger captures fail to compile instead of allocating. Capture a
+ *   pointer to a struct that holds the state.
+ *
+ * 8 bytes per slot on ESP32 (16 on 64-bit hosts).
+ *
+ * Delegates made from a function pointer (or, from C++17, a captureless
+ * lambda) are constant expressions, so tables of entries that hold them can
+ * be `constexpr` and stay in flash (see MenuRegistry::registerTable()).
+ *
+ * ## Usage Example:
+ * ```cpp
+ * Delegate<void(int)> onTurn = [this](int delta) { scroll(delta); };
+ * if (onTurn) {
+ *     onTurn(1);
+ * }
+ *
+ * // C-style function and context, or a member function
+ * Delegate<void()> tick = Delegate<void()>::bind<&tickThunk>(module);
+ * Delegate<void()> draw = Delegate<void()>::bind<Module, &Module::draw>(module);
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_DELEGATE_H
+#define ILITE_DELEGATE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature>
+class Delegate;
+
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+    typedef R (*Plain)(Args...);
+
+    template <typename F>
+    struct IsPlain {
+        static constexpr bool value =
+            std::is_convertible<typename std::decay<F>::type, Plain>::value &&
+            !std::is_same<typename std::decay<F>::type, std::nullptr_t>::value;
+    };
+
+public:
+    constexpr Delegate() : invoke_(nullptr), storage_() {}
+    constexpr Delegate(std::nullptr_t) : invoke_(nullptr), storage_() {}
+
+    /// Null function pointers make an empty delegate, like std::function
+    constexpr Delegate(Plain function)
+        : invoke_(function != nullptr ? &plainThunk : nullptr), storage_(function) {}
+
+    /// Function references and captureless lambdas go through their pointer
+    template <typename F,
+              typename std::enable_if<IsPlain<F>::value, int>::type = 0>
+    constexpr Delegate(F&& f) : Delegate(static_cast<Plain>(f)) {}
+
+    template <typename F,
+              typename std::enable_if<
+                  !IsPlain<F>::value &&
+                  !std::is_same<typename std::decay<F>::type, Delegate>::value, int>::type = 0>
+    Delegate(F&& f) : invoke_(nullptr), storage_() {
+        assign(std::forward<F>(f));
+    }
+
+    /// Bind a C-style function that takes the context as its first argument
+    template <R (*Function)(void*, Args...)>
+    static Delegate bind(void* context) {
+        Delegate delegate;
+        new (delegate.storage_.bytes) void*(context);
+        delegate.invoke_ = &contextThunk<Function>;
+        return delegate;
+    }
+
+    /// Bind a member function to an object
+    template <typename T, R (T::*Method)(Args...)>
+    static Delegate bind(T* object) {
+        Delegate delegate;
+        new (delegate.storage_.bytes) T*(object);
+        delegate.invoke_ = &methodThunk<T, Method>;
+        return delegate;
+    }
+
+    Delegate& operator=(std::nullptr_t) {
+        invoke_ = nullptr;
+        return *this;
+    }
+
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+    Delegate& operator=(F&& f) {
+        return *this = Delegate(std::forward<F>(f));
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    R operator()(Args... args) const {
+        return invoke_(const_cast<Storage*>(&storage_), std::forward<Args>(args)...);
+    }
+
+    void reset() { invoke_ = nullptr; }
+
+    friend bool operator==(const Delegate& d, std::nullptr_t) { return !d; }
+    friend bool operator==(std::nullptr_t, const Delegate& d) { return !d; }
+    friend bool operator!=(const Delegate& d, std::nullptr_t) { return static_cast<bool>(d); }
+    friend bool operator!=(std::nullptr_t, const Delegate& d) { return static_cast<bool>(d); }
+
+private:
+    typedef R (*Invoke)(void* storage, Args...);
+
+    // The function pointer member is what makes plain delegates constexpr;
+    // anything else is placement-constructed into the bytes
+    union Storage {
+        constexpr Storage() : context(nullptr) {}
+        constexpr Storage(Plain function) : plain(function) {}
+
+        void* context;
+        Plain plain;
+        alignas(void*) unsigned char bytes[sizeof(void*)];
+    };
+
+    static R plainThunk(void* storage, Args... args) {
+        return static_cast<Storage*>(storage)->plain(std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static R invokeImpl(void* storage, Args... args) {
+        return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <R (*Function)(void*, Args...)>
+    static R contextThunk(void* storage, Args... args) {
+        return Function(*static_cast<void**>(storage), std::forward<Args>(args)...);
+    }
+
+    template <typename T, R (T::*Method)(Args...)>
+    static R methodThunk(void* storage, Args... args) {
+        return ((*static_cast<T**>(storage))->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    void assign(F&& f) {
+        typedef typename std::decay<F>::type Fn;
+        static_assert(sizeof(Fn) <= sizeof(void*),
+                      "Delegate holds one pointer of captured state; capture a pointer to a struct instead");
+        static_assert(alignof(Fn) <= alignof(void*), "Callable alignment not supported");
+        static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+                      "Delegate callables must be trivially copyable (capture pointers, not objects)");
+        new (storage_.bytes) Fn(std::forward<F>(f));
+        invoke_ = &invokeImpl<Fn>;
+    }
+
+    Invoke invoke_;
+    Storage storage_;
+};
+
+#endif // ILITE_DELEGATE_H
@@ -0,0 +1,164 @@
+/**
+ * @file DeltaPacket.h
+ * @brief Delta-encoded telemetry: keyframes plus per-field differences
+ *
+ * Telemetry structs such as ArmStatePacket are sent whole on every frame
+ * although most fields barely move between frames. A telemetry descriptor
+ * with `deltaEncoded` set lets the robot send the type as:
+ *
+ *     [DELTA_PACKET_MAGIC:4][magic:4][keySeq:1][kind:1][body...]
+ *
+ * - **Keyframe** (kind 0): the body is the whole packet. It becomes the
+ *   base of the following deltas and is numbered keySeq.
+ * - **Delta** (kind 1): a bit mask of the segments that differ from
+ *   keyframe keySeq, then one encoded value per set bit. Integer fields
+ *   carry the zigzag varint of the difference, float fields the varint of
+ *   the XOR of their bits, other fields their raw bytes.
+ *
+ * Segments are the PacketDescriptor::Field entries of the descriptor (or
+ * 4-byte words when it has none), so robot and controller must use the
+ * same field table. Deltas are taken against the keyframe rather than the
+ * previous frame, so a lost delta costs nothing; a lost keyframe drops the
+ * deltas until the next one. The writer sends a keyframe every
+ * `keyframeInterval` frames, when the length changes, when a byte outside
+ * every field changes, or when a delta would not be smaller.
+ *
+ * On the controller, PacketRouter rebuilds the packet before size checks
+ * and handleTelemetry(), so modules never see the encoding. On the robot,
+ * one DeltaPacketWriter per delta-encoded type wraps each packet.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_DELTA_PACKET_H
+#define ILITE_DELTA_PACKET_H
+
+#include <Arduino.h>
+#include "ILITEModule.h"
+
+/// Magic that marks a delta-encoded packet ('DLTA')
+constexpr uint32_t DELTA_PACKET_MAGIC = 0x444C5441;
+
+/**
+ * @brief Segment layout of one packet type, shared by writer and reader
+ */
+struct DeltaLayout {
+    static constexpr size_t kMaxPacketSize = 128;
+    static constexpr size_t kMaxSegments = 32;
+
+    enum Kind : uint8_t {
+        Zigzag,     ///< Integer: zigzag varint of the wrapped difference
+        Xor,        ///< Float or word: varint of the XOR of the bits
+        Raw         ///< Anything else: the bytes themselves
+    };
+
+    struct Segment {
+        uint8_t offset;
+        uint8_t size;
+        Kind kind;
+    };
+
+    Segment segments[kMaxSegments];
+    uint8_t count = 0;
+    uint8_t covered[kMaxPacketSize / 8];    ///< Bytes inside some segment
+
+    /**
+     * @brief Lay out the segments
+     * @param fields Field table (nullptr: 4-byte words up to packetSize)
+     */
+    void build(const PacketDescriptor::Field* fields, size_t fieldCount, size_t packetSize);
+
+    bool isCovered(size_t offset) const {
+        return (covered[offset / 8] >> (offset % 8)) & 1U;
+    }
+};
+
+/**
+ * @class DeltaPacketWriter
+ * @brief Robot side: encode packets of one type as keyframes and deltas
+ */
+class DeltaPacketWriter {
+public:
+    static constexpr size_t kHeaderSize = 2 * sizeof(uint32_t) + 2;
+    static constexpr size_t kMaxFrameSize = kHeaderSize + DeltaLayout::kMaxPacketSize;
+    static constexpr uint8_t kDefaultKeyframeInterval = 25;
+
+    /**
+     * @param fields The descriptor's field table (may be nullptr)
+     * @param packetSize The descriptor's maxSize
+     * @param keyframeInterval Frames between forced keyframes
+     */
+    DeltaPacketWriter(const PacketDescriptor::Field* fields, size_t fieldCount, size_t packetSize,
+                      uint8_t keyframeInterval = kDefaultKeyframeInterval);
+
+    /// Send a keyframe next (new link)
+    void reset();
+
+    /**
+     * @brief Encode the next packet
+     * @return Bytes written to `out` (0 if the packet is too large or `out` too small)
+     */
+    size_t encode(const uint8_t* packet, size_t length, uint8_t* out, size_t capacity);
+
+    uint32_t getKeyframes() const { return keyframes_; }
+    uint32_t getDeltas() const { return deltas_; }
+
+private:
+    size_t encodeDelta(const uint8_t* packet, size_t length, uint8_t* out, size_t capacity) const;
+
+    DeltaLayout layout_;
+    uint8_t key_[DeltaLayout::kMaxPacketSize];
+    uint8_t keyLength_;
+    uint8_t keySeq_;
+    uint8_t sinceKey_;
+    uint8_t interval_;
+    bool haveKey_;
+    uint32_t keyframes_;
+    uint32_t deltas_;
+};
+
+/**
+ * @class DeltaPacketReader
+ * @brief Controller side: rebuild packets of one type
+ */
+class DeltaPacketReader {
+public:
+    DeltaPacketReader();
+
+    /// Lay out the segments from the descriptor and forget the keyframe
+    void configure(const PacketDescriptor::Field* fields, size_t fieldCount, size_t packetSize);
+
+    /// Forget the keyframe (new link)
+    void reset();
+
+    /**
+     * @brief Rebuild the packet a delta frame carries
+     * @return Packet length written to `out`, 0 if it cannot be rebuilt
+     *         (no matching keyframe, malformed frame, `out` too small)
+     */
+    size_t decode(const uint8_t* frame, size_t length, uint8_t* out, size_t capacity);
+
+    uint32_t getDropped() const { return dropped_; }
+
+private:
+    DeltaLayout layout_;
+    uint8_t key_[DeltaLayout::kMaxPacketSize];
+    uint8_t keyLength_;
+    uint8_t keySeq_;
+    bool haveKey_;
+    uint32_t dropped_;
+};
+
+/**
+ * @brief Check whether a received packet is delta-encoded
+ */
+bool isDeltaPacket(const uint8_t* data, size_t length);
+
+/**
+ * @brief Magic of the packet a delta frame carries
+ * @pre isDeltaPacket(data, length)
+ */
+uint32_t deltaPacketInnerMagic(const uint8_t* data);
+
+#endif // ILITE_DELTA_PACKET_H
@@ -0,0 +1,159 @@
+/**
+ * @file DisplayBus.h
+ * @brief OLED controller and transport selection, plus a bus throughput benchmark
+ *
+ * The framebuffer transfer is the largest cost of a DisplayTask frame. At
+ * the U8g2 default of 400 kHz a full 1 KiB SH1106 frame takes ~25 ms on
+ * I2C; DisplayCanvas's tile diff only helps while most of the screen is
+ * static. DisplayBus builds the U8G2 instance for the configured panel:
+ *
+ * | Bus | Controllers     | Clock (0 = default) | Full frame           |
+ * |-----|-----------------|---------------------|----------------------|
+ * | I2C | SH1106, SSD1306 | 400 kHz, max 1 MHz  | ~25 ms / ~10 ms      |
+ * | SPI | SH1106, SSD1306 | 8 MHz, max 10 MHz   | ~1.2 ms at 8 MHz     |
+ *
+ * I2C above 400 kHz is fast-mode-plus: many SH1106 modules run at 1 MHz
+ * with their on-board pull-ups, some need stronger ones (2.2 kOhm). Run
+ * "display bench" to see which clocks a given panel sustains.
+ *
+ * The SPI variant uses the VSPI peripheral on remapped pins, since the
+ * default VSPI pins (18, 23) carry the encoder button and button 1. Clock
+ * and data take the I2C pins (22, 21), which an SPI panel leaves free, so
+ * the defaults stay clear of the UART transport (14, 4) and the buzzer
+ * DAC (26).
+ * Everything above the U8G2 instance (DisplayCanvas, async flush, the
+ * tile diff) is the same for both buses.
+ *
+ * ## Page buffer
+ * The full-frame U8g2 classes keep the whole 1 KiB frame in RAM, and
+ * DisplayCanvas keeps a second 1 KiB copy as its diff reference. Builds
+ * short of RAM set ILITE_DISPLAY_PAGE_BUFFER to 1 or 2: create() then
+ * picks the `_1`/`_2` page-mode classes, and DisplayTask draws each frame
+ * in 8 or 4 bands (DisplayCanvas::firstPage()/nextPage()). The tile diff
+ * stays, on per-tile hashes instead of the copy:
+ *
+ * | ILITE_DISPLAY_PAGE_BUFFER | U8g2 class | Buffer + diff state | Per frame              |
+ * |---------------------------|------------|---------------------|------------------------|
+ * | 0 (default)               | `_F_`      | 1024 + 1024 B       | 1 draw, async transfer |
+ * | 2                         | `_2_`      | 256 + 256 B         | 4 draws, inline        |
+ * | 1                         | `_1_`      | 128 + 256 B         | 8 draws, inline        |
+ *
+ * Every band runs the whole draw code again, and the transfer can no
+ * longer overlap drawing (no async flush), so frames take longer; run
+ * "display bench" on each build to see by how much. Retained dashboards
+ * and ScreenCapture need the full frame and are off in page mode.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_DISPLAY_BUS_H
+#define ILITE_DISPLAY_BUS_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+/// Framebuffer pages held in RAM: 0 = full frame, 1 or 2 = U8g2 page mode
+#ifndef ILITE_DISPLAY_PAGE_BUFFER
+#define ILITE_DISPLAY_PAGE_BUFFER 0
+#endif
+
+#if ILITE_DISPLAY_PAGE_BUFFER != 0 && ILITE_DISPLAY_PAGE_BUFFER != 1 && ILITE_DISPLAY_PAGE_BUFFER != 2
+#error "ILITE_DISPLAY_PAGE_BUFFER must be 0, 1 or 2"
+#endif
+
+class DisplayCanvas;
+
+/// Panel transport
+enum class DisplayBusType : uint8_t {
+    I2C,        ///< Hardware I2C on the Wire pins (21/22)
+    SPI         ///< 4-wire hardware SPI on DisplayBusConfig's pins
+};
+
+/// Panel controller
+enum class DisplayController : uint8_t {
+    SH1106,     ///< 132x64 RAM, 128 columns shown (stock ILITE panel)
+    SSD1306
+};
+
+/**
+ * @brief Display hardware description (ILITEConfig::displayBus)
+ */
+struct DisplayBusConfig {
+    DisplayBusType bus = DisplayBusType::I2C;
+    DisplayController controller = DisplayController::SH1106;
+
+    /// Bus clock in Hz (0 = 400 kHz I2C / 8 MHz SPI, clamped to 1 MHz / 10 MHz)
+    uint32_t clockHz = 0;
+
+    /// 7-bit I2C address
+    uint8_t i2cAddress = 0x3C;
+
+    // SPI wiring (GPIO numbers, U8X8_PIN_NONE for no reset line)
+    uint8_t spiClock = 22;
+    uint8_t spiData = 21;
+    uint8_t spiCs = 5;
+    uint8_t spiDc = 15;
+    uint8_t spiReset = U8X8_PIN_NONE;
+};
+
+/**
+ * @class DisplayBus
+ * @brief Static factory and benchmark for the display transport
+ */
+class DisplayBus {
+public:
+    static constexpr uint32_t kI2CDefaultHz = 400000;
+    static constexpr uint32_t kI2CMaxHz = 1000000;
+    static constexpr uint32_t kSpiDefaultHz = 8000000;
+    static constexpr uint32_t kSpiMaxHz = 10000000;
+
+    /**
+     * @brief Create the U8G2 instance for a panel (not yet begun)
+     *
+     * Starts the bus peripheral on the configured pins and sets the clock;
+     * call begin() on the result.
+     */
+    static U8G2* create(const DisplayBusConfig& config);
+
+    /// Clock create() applied (Hz)
+    static uint32_t getClockHz() { return clockHz_; }
+
+    /// "I2C SH1106" etc.
+    static const char* getName();
+
+    /**
+     * @brief Sustained full-frame rate at one bus clock
+     *
+     * Draws the test pattern and forces every tile to be sent
+     * (DisplayCanvas::invalidate) each frame, and waits for each transfer,
+     * so the tile diff and async flush do not hide the bus cost. A frame
+     * is one pass, so page mode pays for its repeated draws. Leaves the
+     * clock at clockHz.
+     *
+     * @return Frames per second
+     */
+    static float measureFps(DisplayCanvas& canvas, uint32_t clockHz, uint16_t frames);
+
+    /**
+     * @brief Measure every standard clock of the active bus and print the table
+     *
+     * Starts with the buffer mode and its RAM, then one row per clock.
+     * Draws a test pattern; the caller owns the canvas for the duration
+     * (DisplayTask, or a sketch without the framework). Restores the
+     * configured clock.
+     */
+    static void benchmark(DisplayCanvas& canvas, Print& out, uint16_t frames = 30);
+
+    /// "full frame", "2-page" or "1-page"
+    static const char* getBufferModeName();
+
+    static void dump(Print& out);
+
+private:
+    static U8G2* u8g2_;
+    static DisplayBusConfig config_;
+    static uint32_t clockHz_;
+};
+
+#endif // ILITE_DISPLAY_BUS_H
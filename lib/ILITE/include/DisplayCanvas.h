@@ -22,6 +22,14 @@
 #pragma once
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include "DisplayBus.h"
+#include "TextCache.h"
+#include "PageFont.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+struct Icon;
 
 /**
  * @brief High-level drawing canvas for OLED display
@@ -94,9 +102,113 @@ public:
      *
      * Call after all drawing complete for current frame.
      * Framework calls this automatically after drawDashboard().
+     *
+     * Only the 8-pixel pages that changed since the previous frame are sent,
+     * and within each page only the span of changed 8x8 tiles. A completely
+     * static frame costs no bus time.
+     *
+     * After startAsyncFlush(), changed tiles are copied into the front
+     * buffer and handed to the flush task; this call then returns at once
+     * and the caller can draw the next frame while I2C is busy. It only
+     * blocks if the previous frame is still being transferred.
+     *
+     * Does nothing in page-buffer builds: nextPage() transmits each window.
      */
     void sendBuffer();
 
+    /**
+     * @brief Start a frame pass (see ILITE_DISPLAY_PAGE_BUFFER)
+     *
+     * Draw the whole frame, then call nextPage() until it returns false:
+     *
+     * ```cpp
+     * canvas.firstPage();
+     * do {
+     *     drawScreen(canvas);
+     * } while (canvas.nextPage());
+     * ```
+     *
+     * With a full framebuffer the loop runs once and nextPage() is
+     * sendBuffer(). In page mode the buffer holds only a band of
+     * ILITE_DISPLAY_PAGE_BUFFER pages: each pass draws the frame clipped
+     * to the next band, so the draw code must give the same picture every
+     * time within one frame (animate from the frame clock, update state
+     * outside the loop). firstPage() clears the band; outside page mode it
+     * leaves the buffer alone, so retained frames keep their pixels.
+     */
+    void firstPage();
+
+    /**
+     * @brief Finish the current band of a frame pass
+     *
+     * Page mode: sends the tiles of the band that changed since the panel
+     * last showed them, then clears the buffer for the next band.
+     *
+     * @return true while there is another band to draw
+     */
+    bool nextPage();
+
+    /**
+     * @brief Do not send what was drawn since the last nextPage()
+     *
+     * The panel keeps the previous frame (page mode: the previous content
+     * of the current band). Used when a throttled module skipped its draw.
+     */
+    void keepLastFrame() { keepFrame_ = true; }
+
+    /**
+     * @brief Whether the buffer holds less than the whole screen
+     * @return true in page-buffer builds (retained frames are not possible)
+     */
+    bool isPageMode() const;
+
+    /**
+     * @brief RAM behind the framebuffer: U8G2 buffer plus the diff state
+     * @return Bytes (2048 full frame, 384 or 512 in page mode on 128x64)
+     */
+    size_t getBufferBytes() const;
+
+    /**
+     * @brief Move I2C transfers to a dedicated flush task
+     *
+     * Call once after the boot screen. From then on, all panel writes must
+     * go through sendBuffer(); do not call U8G2 transfer functions directly.
+     * Not available in page mode, where the band buffer is reused at once.
+     *
+     * @param core CPU core for the flush task
+     * @param priority Task priority (should be >= the rendering task)
+     * @return true if the flush task is running
+     */
+    bool startAsyncFlush(BaseType_t core = 1, UBaseType_t priority = 2);
+
+    /**
+     * @brief Fence: wait until the last submitted frame is on the panel
+     *
+     * @param timeout Maximum ticks to wait
+     * @return true if no transfer is pending
+     */
+    bool waitForFlush(TickType_t timeout = portMAX_DELAY);
+
+    /**
+     * @brief Check whether a frame is still being transferred
+     * @return true while the flush task is busy
+     */
+    bool isFlushPending() const;
+
+    /**
+     * @brief Force the next sendBuffer() to transfer the whole frame
+     *
+     * Use after anything that changes the panel contents behind the
+     * canvas' back (direct U8G2 writes to the display, power save, reset).
+     */
+    void invalidate();
+
+    /**
+     * @brief Number of 8x8 tiles transferred by the last sendBuffer()
+     * @return Tile count (128 for a full 128x64 frame)
+     */
+    uint16_t getLastFlushTiles() const;
+
     /**
      * @brief Set draw color
      * @param color 0=black (clear), 1=white (draw), 2=XOR
@@ -155,6 +267,34 @@ public:
      */
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool filled = false);
 
+    // ========================================================================
+    // Framebuffer Kernels
+    // ========================================================================
+    //
+    // drawPixel, drawLine, drawHLine, drawVLine and drawRect write the
+    // page-layout buffer directly (one byte = 8 vertical pixels, bit 0 on
+    // top) instead of going through U8G2's per-pixel clip and color
+    // dispatch. Bounds and the clip rect are checked once per primitive;
+    // the draw color (0 clear, 1 set, 2 XOR) applies as with U8G2.
+
+    /**
+     * @brief Draw a dashed or dotted line
+     *
+     * Pixel n along the major axis is drawn if bit (n % length) of
+     * pattern is set: 0x01 with length 4 plots every 4th pixel, 0x33 with
+     * length 8 gives 2-on/2-off dashes.
+     *
+     * @param pattern On/off bits, LSB first
+     * @param length Pattern period in pixels (1-8)
+     */
+    void drawPatternLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         uint8_t pattern, uint8_t length = 8);
+
+    /**
+     * @brief Invert a rectangle (XOR regardless of the draw color)
+     */
+    void invertRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
     /**
      * @brief Draw rounded rectangle
      * @param x Top-left X
@@ -232,11 +372,30 @@ public:
 
     /**
      * @brief Get text width in pixels
+     *
+     * Served from the text cache when it is enabled.
+     *
      * @param text String to measure
      * @return Width in pixels
      */
     int16_t getTextWidth(const char* text) const;
 
+    /**
+     * @brief Enable the pre-rasterized label cache (see TextCache)
+     *
+     * When enabled, drawText() replays cached bitmaps for labels that repeat
+     * across frames and getTextWidth() caches its results.
+     *
+     * @param enabled true to enable, false to disable and drop all entries
+     */
+    void setTextCacheEnabled(bool enabled);
+
+    /**
+     * @brief Access the text cache (statistics, manual clear)
+     * @return Reference to the cache
+     */
+    TextCache& getTextCache();
+
     /**
      * @brief Get current font height in pixels
      * @return Height in pixels
@@ -288,6 +447,44 @@ public:
      */
     bool drawIconByID(int16_t x, int16_t y, const char* iconId);
 
+    /**
+     * @brief Draw an IconLibrary icon from its page-major copy
+     *
+     * Copies whole framebuffer bytes when `y` is a multiple of 8 and the
+     * icon height fills its pages, otherwise shifts each page across two
+     * framebuffer pages. Falls back to U8G2's drawXBM() for XOR drawing,
+     * clipped icons and icons without page data. Like drawXBM(), the icon
+     * background is drawn in the opposite color.
+     *
+     * @param x X coordinate (top-left)
+     * @param y Y coordinate (top-left)
+     * @param icon Icon from IconLibrary::getIcon() or IconLibrary::getBitmap()
+     */
+    void drawIconBitmap(int16_t x, int16_t y, const Icon& icon);
+
+    /**
+     * @brief Draw a page-major bitmap opaquely, clipped to the screen
+     *
+     * `pages` holds ceil(h / 8) runs of `w` bytes (bit 0 = top row), the
+     * layout readPages() produces. Rows below `h` in the last page are left
+     * alone. Unlike drawIconBitmap() any position works: columns and rows
+     * outside the screen or the clip rectangle are skipped, so bitmaps can
+     * slide in from an edge.
+     */
+    void drawPages(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pages);
+
+    /**
+     * @brief Copy framebuffer pages into a page-major bitmap
+     *
+     * @param x Left column (0..width - w)
+     * @param firstPage Top page (row / 8)
+     * @param w Columns to copy
+     * @param pageCount Pages to copy
+     * @param out w * pageCount bytes
+     * @return false if the area is not inside the framebuffer
+     */
+    bool readPages(int16_t x, uint8_t firstPage, int16_t w, uint8_t pageCount, uint8_t* out) const;
+
     // ========================================================================
     // Widgets
     // ========================================================================
@@ -411,6 +608,12 @@ public:
      */
     void clearClipRect();
 
+    /**
+     * @brief Set panel contrast (waits for a pending flush; owner task only)
+     * @param value 0-255
+     */
+    void setContrast(uint8_t value);
+
     /**
      * @brief Get display width in pixels
      * @return Width (typically 128)
@@ -436,9 +639,68 @@ public:
 private:
     U8G2& u8g2_;           ///< Underlying U8G2 instance
     Font currentFont_;     ///< Current font setting
+    mutable TextCache textCache_;  ///< Label bitmaps and widths (mutable: width lookups fill it)
+
+    // Front buffer: copy of the last frame submitted to the panel. It is
+    // both the diff reference and the source the flush task transmits from.
+    static constexpr size_t kShadowSize = 1024;  ///< 128x64 monochrome
+    static constexpr uint8_t kMaxPages = 8;
+#if ILITE_DISPLAY_PAGE_BUFFER
+    // Page mode keeps no copy of the panel: a 16-bit hash per 8x8 tile of
+    // what it shows is the diff reference instead
+    static constexpr size_t kMaxTiles = kShadowSize / 8;
+    uint16_t tileHash_[kMaxTiles];
+#else
+    uint8_t shadow_[kShadowSize];
+#endif
+    bool shadowValid_;     ///< False until a full frame has been sent
+    uint16_t lastFlushTiles_;
+    bool keepFrame_;       ///< keepLastFrame(): nextPage() skips the send
+
+    // Changed tile span per page for the pending transfer (count 0 = clean)
+    struct PageSpan {
+        uint8_t first;
+        uint8_t count;
+    };
+    PageSpan spans_[kMaxPages];
+    uint8_t pageCount_;
+    uint8_t tileWidth_;
+
+    // Async flushing
+    TaskHandle_t flushTask_;
+    SemaphoreHandle_t flushIdle_;   ///< Given while no transfer is pending
+
+    uint16_t collectDirtySpans();
+    void transmitSpans();
+    uint16_t transmitBand();
+    static void flushTask(void* parameter);
+
+    // Screen rows the U8G2 buffer holds (all of them outside page mode);
+    // the framebuffer kernels clip to these and address pages through band()
+    int16_t bandTop() const;
+    int16_t bandBottom() const;
+    uint8_t* band(int16_t page) const;
+
+    // Clip rect mirrored from setClipRect() for the framebuffer kernels (end exclusive)
+    bool clipActive_;
+    int16_t clipX0_;
+    int16_t clipY0_;
+    int16_t clipX1_;
+    int16_t clipY1_;
+
+    struct Bounds {
+        int16_t x0, y0, x1, y1;     ///< End exclusive
+    };
+    Bounds drawBounds() const;
+    void fillSpans(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
 
     static DisplayCanvas* instance_;  ///< Singleton instance
 
     // Font mapping (U8G2 font pointers)
     const uint8_t* getFontPointer(Font font) const;
+
+    // Page fonts (see PageFont.h); false means "draw it through U8G2"
+    const PageFontData* getPageFont(Font font) const;
+    bool measurePageText(const PageFontData& font, const char* text, int16_t& width) const;
+    bool drawPageText(int16_t x, int16_t y, const char* text);
 };
@@ -0,0 +1,124 @@
+/**
+ * @file DriveMixer.h
+ * @brief Body-motion to wheel-command mixing for wheeled robot modules
+ *
+ * A module's updateControl() turns stick axes into a body motion - forward,
+ * strafe and turn, each -1..+1 - and needs one command per wheel. Each
+ * module used to do that with its own scattered arithmetic. DriveMixer holds
+ * the wheel layout as a small matrix and evaluates every wheel in one pass:
+ *
+ *     wheel[i] = gain[i] * (kForward[i] * forward + kStrafe[i] * strafe + kTurn[i] * turn)
+ *
+ * - **Layouts**: Differential (2 wheels), Skid (4 wheels, sides paired),
+ *   Mecanum and Omni4 (4 wheels, X configuration) and Omni3 (kiwi, 3
+ *   wheels at 120 deg). Four-wheel order is front-left, rear-left,
+ *   front-right, rear-right; Omni3 is front-left, rear, front-right.
+ * - **Gains**: per wheel; a negative gain inverts a mirrored motor, a gain
+ *   below 1 derates a wheel with less traction.
+ * - **Limits**: per wheel, in output units. When any wheel would exceed
+ *   its limit, all wheels are scaled down by the same factor, which keeps
+ *   the direction of travel and the turn radius instead of clipping one
+ *   side (Normalize::Scale). Normalize::Clamp clips each wheel on its own.
+ *
+ * Unused rows stay zero and the loop always runs kMaxWheels times, so it
+ * has no branches or variable trip count; the compiler unrolls it into
+ * straight-line multiply-adds. Neither the classic ESP32 nor the S3 has
+ * float vector instructions, so this is the whole fast path.
+ *
+ * Positive forward is ahead, positive strafe is to the right and positive
+ * turn is clockwise seen from above (right stick = turn right).
+ *
+ * ## Usage Example:
+ * ```cpp
+ * DriveMixer mixer(DriveMixer::Layout::Mecanum);
+ * mixer.setGain(2, -1.0f);                   // Front-right motor mounted mirrored
+ *
+ * void updateControl(const InputManager& inputs, float dt) override {
+ *     float wheels[DriveMixer::kMaxWheels];
+ *     mixer.mix({inputs.getJoystickA_Y(), inputs.getJoystickA_X(), inputs.getJoystickB_X()}, wheels);
+ *     for (size_t i = 0; i < 4; ++i) {
+ *         command.wheel[i] = DriveMixer::toCommand(wheels[i], 1000);
+ *     }
+ * }
+ * ```
+ *
+ * Free of Arduino dependencies, so it builds natively too.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_DRIVE_MIXER_H
+#define ILITE_DRIVE_MIXER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class DriveMixer
+ * @brief Wheel layout matrix with gains, limits and desaturation
+ */
+class DriveMixer {
+public:
+    static constexpr size_t kMaxWheels = 4;
+
+    enum class Layout : uint8_t {
+        Differential,   ///< left, right
+        Skid,           ///< Differential with two wheels per side
+        Mecanum,        ///< 45 deg rollers, X configuration
+        Omni4,          ///< Omni wheels at 45 deg to the chassis
+        Omni3           ///< Kiwi drive
+    };
+
+    enum class Normalize : uint8_t {
+        Scale,          ///< Scale every wheel by the same factor (keeps the path)
+        Clamp           ///< Clip each wheel to its limit
+    };
+
+    /// Body motion, each axis -1..+1
+    struct Motion {
+        float forward;
+        float strafe;   ///< Ignored by Differential and Skid
+        float turn;
+    };
+
+    explicit DriveMixer(Layout layout = Layout::Differential);
+
+    /// Load a layout's matrix; gains and limits reset to 1
+    void configure(Layout layout);
+
+    Layout getLayout() const { return layout_; }
+    size_t getWheelCount() const { return wheelCount_; }
+
+    /// Per-wheel multiplier (negative inverts, < 1 derates)
+    void setGain(size_t wheel, float gain);
+
+    /// Per-wheel output magnitude limit (> 0)
+    void setLimit(size_t wheel, float limit);
+
+    void setNormalize(Normalize mode) { normalize_ = mode; }
+
+    /**
+     * @brief Mix one body motion into wheel outputs
+     * @param motion Body motion
+     * @param out kMaxWheels outputs; entries past getWheelCount() are 0
+     * @return Factor applied by Normalize::Scale (1 = no wheel saturated)
+     */
+    float mix(const Motion& motion, float* out) const;
+
+    /// Scale a -1..+1 output to an integer command, clamped to +-fullScale
+    static int16_t toCommand(float value, int16_t fullScale);
+
+private:
+    float forward_[kMaxWheels];
+    float strafe_[kMaxWheels];
+    float turn_[kMaxWheels];
+    float gain_[kMaxWheels];
+    float inverseLimit_[kMaxWheels];
+    float limit_[kMaxWheels];
+    Layout layout_;
+    Normalize normalize_;
+    uint8_t wheelCount_;
+};
+
+#endif // ILITE_DRIVE_MIXER_H
@@ -0,0 +1,166 @@
+/**
+ * @file EncoderSampler.h
+ * @brief Quadrature decoder for the rotary encoder with a timestamped detent queue
+ *
+ * The encoder used to be counted by a RISING interrupt on the clock pin
+ * into the global encoderCount, which FrameworkEngine cleared after
+ * reading it. A detent between that read and the clear was lost, and the
+ * clear also broke ControlBindingSystem and ModuleShell, which read the
+ * same global as an absolute count. EncoderSampler replaces it:
+ *
+ * - **Quadrature state machine**: both pins interrupt on CHANGE and every
+ *   transition is decoded from a transition table, so contact bounce
+ *   cancels itself out. A detent is counted when the encoder returns to
+ *   its rest state having moved at least half a cycle in one direction.
+ * - **Absolute position**: a single atomic count that is never reset.
+ *   encoderCount mirrors it for older sketches.
+ * - **Detent queue**: every detent is queued with its esp_timer time and
+ *   the position after it. Readers keep their own Cursor (as with
+ *   ButtonSampler), so every consumer sees every detent.
+ * - **Velocity acceleration**: readAccelerated() weights each detent by
+ *   the smoothed interval to the previous one, from 1x at kSlowDetentUs
+ *   and above to kMaxAcceleration at kFastDetentUs and below. A change of
+ *   direction drops back to 1x.
+ *
+ * A reader that falls more than kQueueSize detents behind still gets the
+ * exact step count from the positions; only the skipped detents lose
+ * their acceleration.
+ *
+ * ## Backends
+ * - **Pcnt** (default): both channels of PCNT unit 0 count all four edges
+ *   in hardware behind a ~12.8 us glitch filter, with no interrupts at all.
+ *   poll() reads the counter once per input snapshot (InputManager::update)
+ *   and queues the detents, spreading their timestamps over the interval
+ *   since the previous poll. Counts are turned into detents with one count
+ *   of hysteresis, so bounce around the rest position does not flap.
+ * - **Interrupt**: the state machine above, run from CHANGE interrupts on
+ *   both pins. Timestamps are exact, at the cost of one interrupt per edge.
+ *   Used if the PCNT unit cannot be configured.
+ *
+ * PCNT does not count in light sleep; PowerManager adds the encoder pins
+ * to the GPIO wake sources next to the buttons.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ENCODER_SAMPLER_H
+#define ILITE_ENCODER_SAMPLER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/// How the encoder edges are counted
+enum class EncoderBackend : uint8_t {
+    Interrupt,      ///< CHANGE interrupts on both pins, decoded in software
+    Pcnt            ///< Pulse counter peripheral, polled per input snapshot
+};
+
+/**
+ * @brief One decoded detent
+ */
+struct EncoderDetent {
+    uint32_t timeUs;        ///< esp_timer time of the detent (low 32 bits)
+    int32_t position;       ///< Absolute position after the detent
+    int8_t direction;       ///< +1 clockwise, -1 counter-clockwise
+};
+
+/**
+ * @brief Rotation collected by one reader since its previous read
+ */
+struct EncoderDelta {
+    int steps = 0;          ///< Detents, signed
+    int accelerated = 0;    ///< Detents weighted by rotation speed, signed
+};
+
+/**
+ * @class EncoderSampler
+ * @brief Encoder decoder (PCNT or interrupts) with a multi-reader detent queue
+ */
+class EncoderSampler {
+public:
+    static constexpr size_t kQueueSize = 32;            ///< Detent queue depth (power of 2)
+    static constexpr uint32_t kSlowDetentUs = 60000;    ///< Interval at or above: 1x
+    static constexpr uint32_t kFastDetentUs = 8000;     ///< Interval at or below: kMaxAcceleration
+    static constexpr int kMaxAcceleration = 10;
+    static constexpr uint16_t kPcntFilter = 1023;       ///< Glitch filter, APB cycles (max, ~12.8 us)
+    static constexpr int16_t kPcntLimit = 32000;        ///< Counter wraps to 0 here (multiple of 4)
+
+    /// Read position of one consumer
+    struct Cursor {
+        uint32_t tail = 0;
+        int32_t position = 0;       ///< Position after the last detent read
+        uint32_t lastUs = 0;        ///< Time of the last detent read
+        uint32_t intervalUs = 0;    ///< Smoothed detent interval (0 = at rest)
+        int8_t direction = 0;
+    };
+
+    static EncoderSampler& getInstance();
+
+    /**
+     * @brief Start counting (safe to call more than once; the first call wins)
+     *
+     * The encoder should sit in a detent: the pin levels read here are taken
+     * as the rest state. Falls back to Interrupt if the PCNT unit cannot be
+     * configured.
+     */
+    void begin(EncoderBackend backend = EncoderBackend::Pcnt);
+
+    EncoderBackend getBackend() const { return backend_; }
+
+    /**
+     * @brief Move new hardware counts into the detent queue (Pcnt backend)
+     *
+     * Must be called from one task only (InputManager::update does); no-op
+     * for the Interrupt backend.
+     */
+    void poll();
+
+    /// Absolute detent count since boot
+    int32_t getPosition() const { return position_.load(std::memory_order_acquire); }
+
+    /// Start a reader at the current position (no rotation reported so far)
+    void sync(Cursor& cursor) const;
+
+    /**
+     * @brief Detents since the reader's previous read, with acceleration
+     * @param cursor Reader position (advanced to the newest detent)
+     */
+    EncoderDelta readAccelerated(Cursor& cursor);
+
+    /// Weight of one detent for a (smoothed) interval to the previous one
+    static int accelerationFor(uint32_t intervalUs);
+
+    /// Transitions that skipped a state (both pins changed at once)
+    uint32_t getInvalidTransitions() const { return invalid_; }
+
+    void dump(Print& out) const;
+
+private:
+    EncoderSampler();
+    EncoderSampler(const EncoderSampler&) = delete;
+    EncoderSampler& operator=(const EncoderSampler&) = delete;
+
+    static void onPinChange();
+    void decode(uint8_t state);
+    void pushDetent(int8_t direction, uint32_t timeUs);
+    bool beginPcnt();
+
+    EncoderDetent queue_[kQueueSize];
+    std::atomic<uint32_t> head_;        ///< Detents written since begin
+    std::atomic<int32_t> position_;
+    uint8_t state_;                     ///< Last pin state, A << 1 | B
+    uint8_t restState_;
+    int8_t travel_;                     ///< Transitions since the last rest state
+    volatile uint32_t invalid_;
+    volatile uint32_t maxAcceleration_; ///< Highest weight handed out
+    EncoderBackend backend_;
+    bool attached_;
+
+    // Pcnt backend (poll() only)
+    int16_t pcntLast_;                  ///< Counter value at the previous poll
+    int16_t pcntTravel_;                ///< Counts since the last detent
+    uint32_t pcntPollUs_;               ///< Time of the previous poll
+};
+
+#endif // ILITE_ENCODER_SAMPLER_H
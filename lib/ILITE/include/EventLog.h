@@ -0,0 +1,114 @@
+/**
+ * @file EventLog.h
+ * @brief Persistent event log: the connection log, appended to a flash partition
+ *
+ * The connection log is a RAM ring for the UI and is gone after a reboot,
+ * which left nothing to look at after a match that ended in a brown-out or
+ * a crash. EventLog is its second tier:
+ *
+ * - **Hot path unchanged**: connectionLogAdd() still only fills a RAM
+ *   record. The flusher reads the ring from ServiceTask
+ *   (connectionLogReadNext), formats each entry and appends it here.
+ * - **Page batches**: records collect in a 256-byte page buffer that is
+ *   written when full or kFlushMs after its first record, so a busy link
+ *   costs a few flash writes per minute.
+ * - **Circular partition**: the "eventlog" data partition (see
+ *   partitions_ilite.csv) is used as a ring of 4 KiB sectors. Each sector
+ *   starts with a header (sequence, boot, time of its first record); at
+ *   boot the newest sector is found from the headers and the write
+ *   position by walking its records. The oldest sector is erased to make
+ *   room.
+ * - **Boot/timestamp indexing**: every record carries the boot number
+ *   (counted in SettingsStore) and millis() of that boot, and sector
+ *   headers allow listing boots and seeking to one without reading the
+ *   whole partition.
+ *
+ * Flash writes and erases stall instruction cache on both cores. A page
+ * write is ~1 ms; a sector erase is ~40 ms, so the next sector is erased
+ * ahead of time while unpaired and only erased in a match when the
+ * current one fills up. Download ("log download [boot]" on the console)
+ * prints the records as CSV.
+ *
+ * ## Thread Safety:
+ * service() and the read/dump functions run on ServiceTask (the console
+ * is served there too).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_EVENT_LOG_H
+#define ILITE_EVENT_LOG_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Flusher counters (see EventLog::dump)
+ */
+struct EventLogStats {
+    uint32_t written;           ///< Records appended this boot
+    uint32_t lost;              ///< Overwritten in RAM before they were flushed
+    uint32_t pageWrites;
+    uint32_t erases;
+    uint32_t pairedErases;      ///< Erases that could not wait for unpaired
+    uint32_t maxWriteUs;
+    uint32_t maxEraseUs;
+};
+
+/**
+ * @class EventLog
+ * @brief Static flash tier of the connection log
+ */
+class EventLog {
+public:
+    static constexpr const char* kPartitionLabel = "eventlog";
+    static constexpr uint32_t kSectorSize = 4096;
+    static constexpr size_t kPageSize = 256;
+    static constexpr uint32_t kFlushMs = 5000;      ///< Max age of a batched record
+
+    /**
+     * @brief Mount the partition and count this boot
+     *
+     * Call after SettingsStore::begin(). Without the partition (stock
+     * partition table) the log stays RAM-only.
+     *
+     * @return true if the partition was found
+     */
+    static bool begin();
+
+    /**
+     * @brief Move new connection log entries to flash (ServiceTask, ~1 Hz)
+     * @param paired Link active: avoid erases that are not needed yet
+     */
+    static void service(bool paired, uint32_t nowMs);
+
+    /// Write the pending page now (before a reboot or an OTA update)
+    static void flush();
+
+    /// Boot number of this session (1 = first boot with the log)
+    static uint32_t getBoot() { return boot_; }
+
+    static bool isMounted() { return mounted_; }
+    static const EventLogStats& getStats() { return stats_; }
+
+    /// List the boots still stored: first/last time and record count
+    static void dumpBoots(Print& out);
+
+    /**
+     * @brief Print stored records as "boot,ms,text" lines, oldest first
+     * @param boot Only this boot (0 = all)
+     */
+    static void download(Print& out, uint32_t boot = 0);
+
+    /// Erase the partition
+    static void erase();
+
+    static void dump(Print& out);
+
+private:
+    static bool mounted_;
+    static uint32_t boot_;
+    static EventLogStats stats_;
+};
+
+#endif // ILITE_EVENT_LOG_H
@@ -0,0 +1,232 @@
+/**
+ * @file FirmwareRelay.h
+ * @brief Flash the paired robot over the link: staged image, windowed chunks, SACK
+ *
+ * Reflashing a robot used to mean a USB cable or joining the robot's own
+ * access point. The controller already has a link to it, so it can carry
+ * the image instead:
+ *
+ * 1. **Stage** - tools/relay_push.py streams the robot's firmware.bin over
+ *    the console ("relay stage <bytes> <crc32>") into the controller's
+ *    spare OTA slot, one 256-byte block per "[Relay] staged" reply. The
+ *    slot is not marked bootable, so the controller's own firmware is not
+ *    touched; its next OTA update overwrites the staged image.
+ * 2. **Relay** - "relay start" (or the tool's --start) sends the staged
+ *    image to the paired robot from a task of its own:
+ *
+ *        BEGIN  session, image bytes, chunk count, CRC-32   (until READY)
+ *        CHUNK  session, index, CRC-16, 240 bytes           (250-byte frames)
+ *        END    session, CRC-32                             (until DONE)
+ *
+ *    The robot answers with ACK frames: the first chunk it still needs
+ *    (cumulative) and a bitmap of the 32 chunks after it (selective), so
+ *    only chunks that were actually lost are sent again. Up to kWindow
+ *    chunks are outstanding past the cumulative point. A chunk is resent
+ *    when a later chunk is acknowledged before it (frames arrive in order,
+ *    so it was lost) or after kRetransmitUs without an acknowledgement.
+ *
+ * Pacing comes from the send callback: at most kMaxQueued frames wait in
+ * the driver, and the task is woken by each completion instead of polling,
+ * so the link runs at whatever rate the radio sustains without
+ * ESP_ERR_ESPNOW_NO_MEM. Command frames to the robot are suppressed while
+ * the relay runs; the robot is busy flashing and the airtime is needed.
+ *
+ * Progress shows on the "framework.relay" screen (Status menu) and as
+ * console lines every 10 %. "relay" prints the counters.
+ *
+ * ## Robot side
+ * The robot erases its OTA partition on BEGIN and replies READY, writes
+ * each chunk whose CRC-16 matches (CRC-16/CCITT-FALSE over the data,
+ * firmwareChunkCrc()), acknowledges every few chunks and on a gap, checks
+ * the CRC-32 (zlib/IEEE, `crc32_le(0, ...)` in the ESP32 ROM) on END,
+ * replies DONE or an error, and reboots into the new image. A BEGIN with a
+ * new session restarts the transfer.
+ *
+ * ## Thread Safety:
+ * Staging runs on ServiceTask (console). onFrame() runs on RxTask,
+ * onSendComplete() on the WiFi task, the transfer on its own task; they
+ * share state under a spinlock.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_FIRMWARE_RELAY_H
+#define ILITE_FIRMWARE_RELAY_H
+
+#include "Framing.h"
+#include <Arduino.h>
+
+/// Start of a transfer ('FWBG')
+constexpr uint32_t FIRMWARE_BEGIN_MAGIC = 0x46574247;
+
+/// One chunk of the image ('FWCH')
+constexpr uint32_t FIRMWARE_CHUNK_MAGIC = 0x46574348;
+
+/// All chunks delivered, check and boot ('FWEN')
+constexpr uint32_t FIRMWARE_END_MAGIC = 0x4657454E;
+
+/// Give up the transfer ('FWAB')
+constexpr uint32_t FIRMWARE_ABORT_MAGIC = 0x46574142;
+
+/// Robot's acknowledgement ('FWAK')
+constexpr uint32_t FIRMWARE_ACK_MAGIC = 0x4657414B;
+
+/// Image bytes per chunk (frame = 10-byte header + 240 = 250)
+constexpr size_t kFirmwareChunkBytes = 240;
+
+/// Robot status in a FirmwareAckFrame
+enum FirmwareStatus : uint8_t {
+    kFirmwareReceiving = 0,         ///< Chunks acknowledged, more wanted
+    kFirmwareReady = 1,             ///< BEGIN accepted, partition erased
+    kFirmwareDone = 2,              ///< CRC-32 matched, rebooting into the image
+    kFirmwareErrorSpace = 0x80,     ///< Image does not fit the robot's partition
+    kFirmwareErrorCrc = 0x81,       ///< CRC-32 of the written image differs
+    kFirmwareErrorFlash = 0x82,     ///< Erase or write failed
+    kFirmwareErrorSession = 0x83    ///< Frame for a session the robot does not know
+};
+
+#pragma pack(push, 1)
+/// Controller -> robot: start of a transfer
+struct FirmwareBeginFrame {
+    uint32_t magic;
+    uint16_t session;
+    uint8_t chunkBytes;             ///< kFirmwareChunkBytes
+    uint8_t reserved;
+    uint32_t imageBytes;
+    uint16_t chunkCount;
+    uint16_t reserved2;
+    uint32_t imageCrc;              ///< CRC-32 of the whole image
+};
+
+/// Controller -> robot: one chunk (data follows the header)
+struct FirmwareChunkHeader {
+    uint32_t magic;
+    uint16_t session;
+    uint16_t index;                 ///< Chunk number; offset = index * chunkBytes
+    uint16_t crc;                   ///< firmwareChunkCrc() of the data
+};
+
+/// Controller -> robot: end of the image, or abort (FIRMWARE_ABORT_MAGIC)
+struct FirmwareEndFrame {
+    uint32_t magic;
+    uint16_t session;
+    uint16_t reserved;
+    uint32_t imageCrc;
+};
+
+/// Robot -> controller
+struct FirmwareAckFrame {
+    uint32_t magic;
+    uint16_t session;
+    uint8_t status;                 ///< FirmwareStatus
+    uint8_t reserved;
+    uint16_t base;                  ///< First chunk not yet received
+    uint32_t received;              ///< Bit i: chunk base + 1 + i received
+};
+#pragma pack(pop)
+
+/// CRC-16/CCITT-FALSE of a chunk's data (both sides)
+inline uint16_t firmwareChunkCrc(const uint8_t* data, size_t length) {
+    return Framing::crc16(data, length);
+}
+
+/**
+ * @brief State of the staged image and the transfer
+ */
+enum class RelayState : uint8_t {
+    Idle,           ///< Nothing staged
+    Staging,        ///< Receiving the image over the console
+    Staged,         ///< Image in flash, ready to relay
+    Starting,       ///< BEGIN sent, waiting for READY (robot erasing)
+    Sending,        ///< Chunks
+    Finishing,      ///< END sent, waiting for DONE
+    Done,           ///< Robot reported DONE
+    Failed          ///< See FirmwareRelayStats::error
+};
+
+/**
+ * @brief Counters of the current or last transfer
+ */
+struct FirmwareRelayStats {
+    RelayState state = RelayState::Idle;
+    const char* error = nullptr;
+    uint32_t imageBytes = 0;
+    uint16_t chunkCount = 0;
+    uint16_t acknowledged = 0;      ///< Cumulative chunks the robot has
+    uint32_t chunksSent = 0;        ///< Retransmissions included
+    uint32_t retransmits = 0;
+    uint32_t acks = 0;
+    uint32_t sendFailures = 0;      ///< Send callbacks reporting failure
+    uint32_t driverFull = 0;        ///< ESP_ERR_ESPNOW_NO_MEM
+    uint32_t elapsedMs = 0;         ///< BEGIN to DONE (or now)
+    uint32_t bytesPerSecond = 0;    ///< Acknowledged image bytes over elapsedMs
+};
+
+/**
+ * @class FirmwareRelay
+ * @brief Static stager and sender of robot firmware
+ */
+class FirmwareRelay {
+public:
+    static constexpr size_t kWindow = 32;               ///< Chunks past the cumulative ACK
+    static constexpr size_t kMaxQueued = 4;             ///< Frames waiting in the driver
+    static constexpr size_t kStageBlockBytes = 256;     ///< Console bytes per "staged" reply
+    static constexpr uint32_t kRetransmitUs = 40000;
+    static constexpr uint32_t kCallbackTimeoutUs = 20000;
+    static constexpr uint32_t kReadyTimeoutMs = 30000;  ///< Robot erasing its partition
+    static constexpr uint32_t kStallTimeoutMs = 5000;   ///< No ACK progress for this long
+    static constexpr uint32_t kStageTimeoutMs = 3000;   ///< Console quiet while staging
+
+    /// Register the progress screen
+    static void begin();
+
+    // ------------------------------------------------------------------------
+    // Staging (ServiceTask, console)
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Start receiving an image over the console
+     * @param crc32 CRC-32 (zlib) of the whole image
+     * @return false if a transfer runs or the image does not fit the slot
+     */
+    static bool beginStaging(uint32_t imageBytes, uint32_t crc32);
+
+    static bool isStaging();
+
+    /// One console byte of the image being staged
+    static void feed(uint8_t byte);
+
+    /// Staging timeout (call with the console)
+    static void service(uint32_t nowMs);
+
+    // ------------------------------------------------------------------------
+    // Transfer
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Send the staged image to `mac`
+     * @return false if nothing is staged, a transfer runs or the task failed
+     */
+    static bool start(const uint8_t* mac);
+
+    /// Stop the transfer and tell the robot
+    static void abort();
+
+    /// A transfer runs (Starting, Sending or Finishing)
+    static bool isActive();
+
+    /// The transfer runs to `mac` (its command frames are suppressed)
+    static bool isTarget(const uint8_t* mac);
+
+    /// Consume a FirmwareAckFrame (RxTask); other frames return false
+    static bool onFrame(const uint8_t* mac, const uint8_t* data, size_t length);
+
+    /// Send callback hook (WiFi task)
+    static void onSendComplete(const uint8_t* mac, bool success);
+
+    static FirmwareRelayStats getStats();
+    static void dump(Print& out);
+};
+
+#endif // ILITE_FIRMWARE_RELAY_H
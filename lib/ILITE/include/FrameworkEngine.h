@@ -18,11 +18,14 @@
 #include <Arduino.h>
 #include <vector>
 #include "ButtonEventEngine.h"
+#include "EncoderSampler.h"
 #include "ILITEModule.h"
 #include "DisplayCanvas.h"
 #include "AudioRegistry.h"
 #include "MenuRegistry.h"
 #include "ModuleMenu.h"
+#include "WidgetTree.h"
+#include "Animator.h"
 
 // Forward declarations
 class InputManager;
@@ -88,19 +91,29 @@ public:
     void update();
 
     /**
-     * @brief Update status LED based on system state
+     * @brief Pick the status LED pattern for the system state
      *
-     * Call frequently to update LED blinking patterns
+     * StatusLed times the pattern itself; this only switches patterns.
      */
     void updateStatusLED();
 
     /**
      * @brief Render complete frame (top strip + dashboard)
      *
+     * Clears the canvas itself, except when a retained widget dashboard
+     * that was drawn last frame is still showing.
+     *
      * @param canvas Display canvas to render to
      */
     void render(DisplayCanvas& canvas);
 
+    /**
+     * @brief Force the next render() to redraw the dashboard from scratch
+     *
+     * Call after anything else has drawn over the framebuffer.
+     */
+    void invalidateDashboard();
+
     // ========================================================================
     // Module Management
     // ========================================================================
@@ -108,6 +121,9 @@ public:
     /**
      * @brief Load and activate a module
      *
+     * Called by ILITEFramework::setActiveModule() while no module is
+     * published; use ILITEFramework::requestModuleActivation() elsewhere.
+     *
      * @param module Pointer to module to load (nullptr to unload current)
      */
     void loadModule(ILITEModule* module);
@@ -119,6 +135,20 @@ public:
      */
     ILITEModule* getCurrentModule() const { return currentModule_; }
 
+    /**
+     * @brief Trade the loaded module for the one in standby
+     *
+     * The loaded module's menu entries leave MenuRegistry and its bindings
+     * stop dispatching, but both stay built, along with its encoder
+     * functions and ModuleArena bank. The standby module (or nothing) comes
+     * back the same way, without onActivate() or a menu rebuild. Same
+     * calling rules as loadModule().
+     */
+    void swapStandbyModule();
+
+    /// Module kept in standby by swapStandbyModule() (nullptr if none)
+    ILITEModule* getStandbyModule() const { return standby_.module; }
+
     /**
      * @brief Check if a module is currently loaded
      *
@@ -209,8 +239,11 @@ public:
      * @brief Handle encoder rotation (for strip navigation)
      *
      * @param delta Rotation delta (+1 = clockwise, -1 = counterclockwise)
+     * @param accelerated Delta weighted by spin speed (EncoderSampler), used
+     *                    for value edits
      */
-    void onEncoderRotate(int delta);
+    void onEncoderRotate(int delta, int accelerated);
+    void onEncoderRotate(int delta) { onEncoderRotate(delta, delta); }
 
     /**
      * @brief Handle encoder button press
@@ -324,6 +357,19 @@ private:
      */
     void renderGenericDashboard(DisplayCanvas& canvas);
 
+    /**
+     * @brief Widget screen for the current dashboard, if retained
+     *
+     * @return Module or generic widget screen; nullptr while a menu, screen
+     *         or immediate-mode module dashboard is showing
+     */
+    WidgetScreen* activeWidgetScreen();
+
+    /**
+     * @brief Generic dashboard status line
+     */
+    const char* genericStatusText();
+
     /**
      * @brief Route button event to appropriate handler
      *
@@ -347,17 +393,30 @@ private:
      */
     void clearModuleMenuEntries();
 
+    /// Leave any submenu whose ID lives in the active ModuleArena bank
+    void leaveModuleSubmenus();
+
     /**
      * @brief Recursively convert and register ModuleMenuItem tree
      */
     void convertModuleMenuItems(const ModuleMenuItem& parent, MenuID parentMenuId);
     bool beginStringEdit(const MenuEntry* entry);
+
+    /// Run the setter of the entry being edited with the edit value
+    void applyEditValue();
+
+    /// Coalesced setter call of a live edit (update())
+    void serviceLiveEdit(uint32_t nowMs);
     void drawBlinkUnderline(DisplayCanvas& canvas, int16_t x, int16_t y, int16_t width);
 
     // Core engines
     ButtonEventEngine buttonEngine_;
+    EncoderSampler::Cursor encoderCursor_;
+
+    /// Published module for the CommTask/DisplayTask paths (see ModuleHandoff)
+    static ILITEModule* liveModule();
 
-    // Module state
+    // Module state (loadModule() side; the tasks read liveModule())
     ILITEModule* currentModule_;
     bool isPaired_;
     FrameworkStatus status_;
@@ -365,7 +424,25 @@ private:
     // Module menu integration
     ModuleMenuItem moduleMenuRoot_;
     ModuleMenuBuilder moduleMenuBuilder_;
-    std::vector<std::string> moduleMenuIds_;
+    std::vector<MenuID> moduleMenuIds_;        ///< Arena-owned IDs of registered entries
+
+    /**
+     * @brief A module parked by swapStandbyModule()
+     *
+     * The entries are copies of the registered ones; their IDs and labels
+     * stay valid in the standby ModuleArena bank, and their callbacks point
+     * into menuItems, whose elements never move.
+     */
+    struct StandbyModule {
+        ILITEModule* module = nullptr;
+        std::vector<ModuleMenuItem> menuItems;
+        std::vector<MenuID> menuIds;
+        std::vector<MenuEntry> menuEntries;
+        EncoderFunction encoderFunctions[2];
+        bool hasEncoderFunction[2] = {false, false};
+    };
+    StandbyModule standby_;
+    std::vector<MenuEntry> parkedEntries_;     ///< Scratch for the swap (capacity kept)
 
     // Top strip state
     StripButton selectedStripButton_;
@@ -378,23 +455,34 @@ private:
     std::vector<MenuID> menuStack_;
     int menuSelection_;
     int menuScrollOffset_;
+    Tween menuScrollTween_;            ///< Drawn scroll position (pixels)
+    Tween menuCursorTween_;            ///< Drawn selection box position (pixels from the first entry)
+    MenuID menuAnimMenu_;              ///< Menu the tweens belong to; a new menu snaps them
 
     // Menu edit mode state
     bool menuEditMode_;
     const MenuEntry* editingEntry_;
     int editValueInt_;
     float editValueFloat_;
-    uint32_t lastEncoderRotateMs_;
+    int editStartInt_;                  ///< Value restored when a live edit is cancelled
+    float editStartFloat_;
+    bool editDirty_;                    ///< Live edit changed since the setter last ran
+    uint32_t editDirtyMs_;
     uint32_t cursorBlinkTimer_;
 
     // Status
     uint8_t batteryPercent_;
-    uint32_t statusAnimFrame_;
-
-    // LED status indication
-    uint32_t ledLastUpdateMs_;
-    uint8_t ledBlinkPhase_;
-    bool ledState_;
+    uint32_t statusAnimFrame_;         ///< Animator time / 20 ms of the frame being drawn
+
+    // Retained-mode dashboards
+    WidgetScreen* retainedScreen_;     ///< Screen whose pixels are in the framebuffer
+    bool dashboardSkipped_;            ///< Module draw throttled this frame; keep the last one
+    WidgetScreen genericScreen_;
+    TextWidget genericTitle_;
+    TextWidget genericCount_;
+    TextWidget genericStatus_;
+    TextWidget genericHelp_;
+    char genericCountText_[24];
 
     // Default button callbacks (when no module loaded)
     ButtonCallback defaultButtonCallbacks_[3];
@@ -404,4 +492,5 @@ private:
     static constexpr uint8_t DASHBOARD_Y = STRIP_HEIGHT;
     static constexpr uint8_t DASHBOARD_HEIGHT = 54;
     static constexpr uint8_t LED_PIN = 2;  // Built-in LED on most ESP32 boards (GPIO2)
+    static constexpr uint8_t LOW_BATTERY_PERCENT = 15;
 };
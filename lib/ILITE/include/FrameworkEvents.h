@@ -0,0 +1,86 @@
+/**
+ * @file FrameworkEvents.h
+ * @brief Typed events from the receive path to ServiceTask
+ *
+ * RxTask parses discovery frames and used to act on them inline: audio
+ * cues played from the discovery code (ignoring ILITEConfig::enableAudio,
+ * and twice on a pair ack, once there and once in handlePairing()), and a
+ * pair ack waited for the next pairing poll. Discovery now only posts an
+ * event and moves on:
+ *
+ * - PeerSeen    a peer entered the table (the device list redraws)
+ * - PairState   the pair handshake finished or the link was dropped;
+ *               ServiceTask runs handlePairing() at once
+ * - Cue         an audio cue, played if audio is enabled
+ * - ModuleSeen  telemetry from the paired peer named a module that pairing
+ *               did not select; ServiceTask activates it
+ *
+ * Posting is one lock-free MpscQueue push, from any task. ServiceTask
+ * drains the queue every tick. A full queue drops the event and counts it.
+ *
+ * Only the controller posts. On a robot (DEVICE_ROLE_CONTROLLED), nothing
+ * drains the queue, so its discovery branches keep their direct calls.
+ *
+ * Telemetry is not an event. onTelemetryReceived() is two stores, and a
+ * per-packet event would only cost queue slots.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_FRAMEWORK_EVENTS_H
+#define ILITE_FRAMEWORK_EVENTS_H
+
+#include <Arduino.h>
+#include "audio_feedback.h"
+
+enum class FrameworkEventType : uint8_t {
+    PeerSeen,
+    PairState,
+    Cue,
+    ModuleSeen
+};
+
+/**
+ * @brief One event; which fields apply depends on the type
+ */
+struct FrameworkEvent {
+    FrameworkEventType type;
+    uint8_t mac[6];             ///< PeerSeen, PairState, ModuleSeen
+    uint8_t value;              ///< PairState: 1 = paired; Cue: AudioCue; ModuleSeen: module index
+    uint32_t timeMs;            ///< When it was posted
+};
+
+/**
+ * @brief Queue counters
+ */
+struct FrameworkEventStats {
+    uint32_t posted = 0;
+    uint32_t dropped = 0;       ///< Queue full
+    uint32_t handled = 0;
+};
+
+/**
+ * @class FrameworkEvents
+ * @brief Static MPSC event queue, consumed by ServiceTask
+ */
+class FrameworkEvents {
+public:
+    static constexpr uint32_t kQueueSize = 32;
+
+    static bool postPeerSeen(const uint8_t* mac);
+    static bool postPairState(const uint8_t* mac, bool paired);
+    static bool postCue(AudioCue cue);
+    static bool postModuleSeen(const uint8_t* mac, uint8_t moduleIndex);
+
+    /// Oldest event (ServiceTask only); false if none
+    static bool pop(FrameworkEvent& event);
+
+    static FrameworkEventStats getStats();
+    static void dump(Print& out);
+
+private:
+    static bool post(FrameworkEventType type, const uint8_t* mac, uint8_t value);
+};
+
+#endif // ILITE_FRAMEWORK_EVENTS_H
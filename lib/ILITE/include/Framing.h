@@ -0,0 +1,74 @@
+/**
+ * @file Framing.h
+ * @brief CRC16, COBS encoding and little-endian byte packing for serial frames
+ *
+ * TelemetryTap, SerialBridge, UartTransport, InputReplay and ModuleConfig all
+ * frame or checksum byte streams the same way; this is the one copy they
+ * share. The CRC is CRC-16/CCITT-FALSE (init 0xFFFF, poly 0x1021, MSB first,
+ * no final XOR), so host tools can check frames with any stock CRC library.
+ * Multi-byte fields are little-endian regardless of host byte order.
+ *
+ * ## Thread Safety:
+ * Stateless; safe from any task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_FRAMING_H
+#define ILITE_FRAMING_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Framing {
+
+/// Initial value of a running CRC (crc16Update)
+constexpr uint16_t kCrcInit = 0xFFFF;
+
+/// Fold one byte into a running CRC that started at kCrcInit
+inline uint16_t crc16Update(uint16_t crc, uint8_t byte) {
+    crc ^= static_cast<uint16_t>(byte) << 8;
+    for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                             : static_cast<uint16_t>(crc << 1);
+    }
+    return crc;
+}
+
+/// CRC of a whole buffer
+uint16_t crc16(const uint8_t* data, size_t length);
+
+/// Worst-case cobsEncode() output for `length` input bytes, delimiter included
+constexpr size_t cobsMaxEncoded(size_t length) {
+    return length + length / 254 + 2;
+}
+
+/**
+ * @brief Consistent overhead byte stuffing: no 0x00 in the output, plus the delimiter
+ * @param out At least cobsMaxEncoded(length) bytes; must not overlap `in`
+ * @return Bytes written to `out`, including the trailing 0x00
+ */
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+
+inline void putU16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void putU32(uint8_t* out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value));
+    putU16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+inline uint16_t getU16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+inline uint32_t getU32(const uint8_t* in) {
+    return getU16(in) | (static_cast<uint32_t>(getU16(in + 2)) << 16);
+}
+
+} // namespace Framing
+
+#endif // ILITE_FRAMING_H
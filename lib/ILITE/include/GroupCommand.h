@@ -0,0 +1,140 @@
+/**
+ * @file GroupCommand.h
+ * @brief One broadcast frame addressed to a group of robots, with ACK sampling
+ *
+ * Sending the same command to N robots as unicasts costs N frames of
+ * airtime, one after the other, so the last robot acts up to N frames later
+ * than the first. A group command is a single ESP-NOW broadcast instead:
+ *
+ *     [GROUP_MAGIC:4][group:1][flags:1][sequence:2][command bytes...]
+ *
+ * Every robot receives the same frame at the same time. A robot keeps it
+ * only if it belongs to `group` (acceptGroupCommand), or if the group is
+ * kGroupAll. Broadcasts are never retried by the MAC layer, so a sender that
+ * cares can set kGroupFlagAck on some frames: each member that applied such
+ * a frame unicasts an ACK back
+ *
+ *     [GROUP_ACK_MAGIC:4][group:1][reserved:1][sequence:2]
+ *
+ * and GroupCommand keeps per-robot ACK counts and round trips. Sampling
+ * (ackEvery) keeps the ACK traffic small compared with the commands.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_GROUP_COMMAND_H
+#define ILITE_GROUP_COMMAND_H
+
+#include <Arduino.h>
+
+/// Magic of a group command frame ('GRUP')
+constexpr uint32_t GROUP_PACKET_MAGIC = 0x47525550;
+
+/// Magic of a robot's acknowledgement of a group command ('GACK')
+constexpr uint32_t GROUP_ACK_MAGIC = 0x4741434B;
+
+/// Group every robot belongs to
+constexpr uint8_t kGroupAll = 0xFF;
+
+/// Flag: members reply with a GroupAckFrame
+constexpr uint8_t kGroupFlagAck = 0x01;
+
+#pragma pack(push, 1)
+/// Header of a group command frame
+struct GroupCommandHeader {
+    uint32_t magic;
+    uint8_t group;          ///< Target group (kGroupAll = every robot)
+    uint8_t flags;          ///< kGroupFlagAck
+    uint16_t sequence;      ///< Incremented once per group frame
+};
+
+/// A robot's acknowledgement of a group command
+struct GroupAckFrame {
+    uint32_t magic;
+    uint8_t group;
+    uint8_t reserved;
+    uint16_t sequence;      ///< Sequence of the acknowledged frame
+};
+#pragma pack(pop)
+
+constexpr size_t kGroupHeaderSize = sizeof(GroupCommandHeader);
+
+/**
+ * @brief Write `header` + `command` into `out`
+ * @return Bytes written, or 0 if it does not fit
+ */
+size_t writeGroupFrame(uint8_t* out, size_t capacity, const GroupCommandHeader& header,
+                       const uint8_t* command, size_t length);
+
+/**
+ * @brief Robot side: filter a group frame by membership
+ *
+ * @param memberOf Bit i set = member of group i (groups 0-31)
+ * @return Inner command, or nullptr if `data` is not a group frame or the
+ *         robot is not in its group
+ */
+const uint8_t* acceptGroupCommand(const uint8_t* data, size_t length, uint32_t memberOf,
+                                  GroupCommandHeader& header, size_t& innerLength);
+
+/// Robot side: the ACK to unicast back when `header.flags` has kGroupFlagAck
+inline GroupAckFrame makeGroupAck(const GroupCommandHeader& header) {
+    GroupAckFrame ack;
+    ack.magic = GROUP_ACK_MAGIC;
+    ack.group = header.group;
+    ack.reserved = 0;
+    ack.sequence = header.sequence;
+    return ack;
+}
+
+/**
+ * @brief ACKs received from one robot
+ */
+struct GroupMemberStats {
+    uint8_t mac[6] = {};
+    uint32_t acks = 0;
+    uint16_t lastSequence = 0;
+    uint32_t lastRttUs = 0;
+    uint32_t avgRttUs = 0;          ///< Moving average (1/8 weight)
+};
+
+/**
+ * @class GroupCommand
+ * @brief Sends group frames (any task) and collects ACKs (RxTask)
+ */
+class GroupCommand {
+public:
+    static constexpr size_t kMaxMembers = 8;        ///< Robots tracked for ACKs
+
+    /**
+     * @brief Broadcast `command` to every robot in `group`
+     *
+     * @param ackEvery Request ACKs on every n-th frame (0 = never, 1 = always)
+     * @return false if the frame does not fit or the send failed
+     */
+    static bool send(uint8_t group, const uint8_t* command, size_t length, uint8_t ackEvery = 0);
+
+    /**
+     * @brief Consume a GroupAckFrame (any other frame returns false)
+     */
+    static bool onFrame(const uint8_t* mac, const uint8_t* data, size_t length);
+
+    static uint32_t getFramesSent() { return framesSent_; }
+    static uint32_t getAckRequests() { return ackRequests_; }
+    static size_t getMemberCount() { return memberCount_; }
+    static const GroupMemberStats& getMember(size_t index) { return members_[index]; }
+
+    static void reset();
+    static void dump(Print& out);
+
+private:
+    static uint16_t sequence_;
+    static uint32_t framesSent_;
+    static uint32_t ackRequests_;
+    static uint16_t lastAckSequence_;       ///< Sequence of the newest ACK request
+    static uint32_t lastAckSentUs_;         ///< esp_timer (low 32 bits) of that request
+    static GroupMemberStats members_[kMaxMembers];
+    static size_t memberCount_;
+};
+
+#endif // ILITE_GROUP_COMMAND_H
@@ -0,0 +1,145 @@
+/**
+ * @file HeapProfiler.h
+ * @brief Heap fragmentation history and, in profiling builds, allocation attribution
+ *
+ * Hot paths allocate without anyone noticing (menu entry vectors, capturing
+ * std::function objects, screen stack pushes), and a controller left on for
+ * an event day slowly fragments its heap. HeapProfiler covers both:
+ *
+ * - **History** (always built): ServiceTask samples free heap and the
+ *   largest free block every few seconds. When the kHistory samples are
+ *   full, neighbours are merged (keeping the worse values) and the interval
+ *   doubles, so the table spans the whole session in fixed memory. A
+ *   largest block below kLowBlockBytes is logged once per crossing.
+ * - **Attribution** (ILITE_HEAP_PROFILE=1): every malloc/free is counted
+ *   against the calling task and the Profiler zone it is in (ProfileScope
+ *   marks the zone, so ILITE_PROFILE sites need no extra annotation).
+ *   The allocations reach the profiler through the ESP-IDF heap hooks
+ *   (CONFIG_HEAP_USE_HOOKS) or, on SDKs without them, through the linker's
+ *   --wrap of malloc, calloc, realloc and free (env ILITE_heap in
+ *   platformio.ini). new and std::function allocate through malloc.
+ * - **No-alloc regions**: ILITE_NO_ALLOC() marks the rest of a scope as a
+ *   region that must not allocate. CommTask ticks and DisplayTask frames
+ *   are marked. An allocation inside one is recorded with task, zone, size
+ *   and caller and logged from ServiceTask (Mode::Log), or stops the
+ *   controller with a backtrace of the allocating call (Mode::Assert).
+ *
+ * Without ILITE_HEAP_PROFILE the zone and region markers compile to
+ * nothing and only the history is kept.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * void tick() {
+ *     ILITE_NO_ALLOC();
+ *     ILITE_PROFILE(ProfileZone::UpdateControl);
+ *     module->updateControl(inputs, dt);     // A push_back here is reported
+ * }
+ * ```
+ * "heap" on the console prints the history, "heap allocs" the table per
+ * task and zone and the last region violations.
+ *
+ * ## Thread Safety:
+ * The hooks run on whichever task allocates; each task's counters have
+ * that task as their only writer, and the violation ring is guarded by a
+ * portMUX. sample() and the dump functions run on ServiceTask.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_HEAP_PROFILER_H
+#define ILITE_HEAP_PROFILER_H
+
+#include <Arduino.h>
+
+#ifndef ILITE_HEAP_PROFILE
+#define ILITE_HEAP_PROFILE 0
+#endif
+
+/**
+ * @brief One point of the fragmentation history
+ */
+struct HeapSample {
+    uint32_t timeMs;
+    uint32_t freeBytes;         ///< Lowest free heap in the interval
+    uint32_t largestBlock;      ///< Smallest largest-free-block in the interval
+};
+
+/**
+ * @class HeapProfiler
+ * @brief Static heap sampler and allocation hook sink
+ */
+class HeapProfiler {
+public:
+    static constexpr uint32_t kSampleMs = 5000;         ///< First history interval
+    static constexpr size_t kHistory = 48;
+    static constexpr uint32_t kLowBlockBytes = 8192;
+    static constexpr size_t kMaxTasks = 8;              ///< Tasks counted separately
+    static constexpr size_t kMaxViolations = 8;         ///< Region violations kept
+    static constexpr uint8_t kNoZone = 0xFF;
+
+    enum class Mode : uint8_t {
+        Log,        ///< Record and log region violations
+        Assert      ///< Abort on the first one
+    };
+
+    /// Take a history sample when due and log new violations (ServiceTask)
+    static void sample(uint32_t nowMs);
+
+    /// Compiled with ILITE_HEAP_PROFILE (allocations are counted)
+    static constexpr bool isInstrumented() { return ILITE_HEAP_PROFILE != 0; }
+
+    static void setMode(Mode mode);
+    static Mode getMode();
+
+    /// Enter Profiler zone `zone` on the calling task; returns the zone to restore
+    static uint8_t enterZone(uint8_t zone);
+    static void leaveZone(uint8_t previous);
+
+    /// Nestable no-alloc region of the calling task
+    static void enterNoAlloc();
+    static void leaveNoAlloc();
+
+    /// Allocation hooks (called from the heap hooks or the malloc wraps)
+    static void onAlloc(void* ptr, size_t size, void* caller);
+    static void onFree(void* ptr);
+
+    /// Clear the allocation counters and violations (the history stays)
+    static void reset();
+
+    /// Current heap and the history
+    static void dump(Print& out);
+
+    /// Allocations per task and zone, and the recorded violations
+    static void dumpAllocations(Print& out);
+};
+
+#if ILITE_HEAP_PROFILE
+
+/**
+ * @class HeapNoAllocScope
+ * @brief Marks its lifetime as a no-alloc region of the calling task
+ */
+class HeapNoAllocScope {
+public:
+    HeapNoAllocScope() { HeapProfiler::enterNoAlloc(); }
+    ~HeapNoAllocScope() { HeapProfiler::leaveNoAlloc(); }
+
+    HeapNoAllocScope(const HeapNoAllocScope&) = delete;
+    HeapNoAllocScope& operator=(const HeapNoAllocScope&) = delete;
+};
+
+#define ILITE_HEAP_CONCAT_(a, b) a##b
+#define ILITE_HEAP_CONCAT(a, b) ILITE_HEAP_CONCAT_(a, b)
+
+/// The rest of the enclosing scope must not allocate
+#define ILITE_NO_ALLOC() \
+    HeapNoAllocScope ILITE_HEAP_CONCAT(heapNoAlloc_, __LINE__)
+
+#else
+
+#define ILITE_NO_ALLOC() do {} while (0)
+
+#endif // ILITE_HEAP_PROFILE
+
+#endif // ILITE_HEAP_PROFILER_H
@@ -94,7 +94,9 @@ private:
     static DisplayMode currentMode_;
     static DisplayMode previousMode_;
     static uint32_t lastUpdate_;
-    static int deviceListIndex_;
-    static int selectedDeviceIndex_;
+    static int deviceListIndex_;        ///< Rank of the highlighted device
+    static int listPeerIndex_;          ///< Peer under the highlight (followed when ranks move)
+    static uint32_t listRankVersion_;
+    static int selectedDeviceIndex_;    ///< Peer table index
     static int selectedButtonIndex_;
 };
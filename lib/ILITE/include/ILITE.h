@@ -38,14 +38,20 @@
 
 #include <Arduino.h>
 #include <U8G2lib.h>
+#include <esp_timer.h>
+#include <esp_now.h>
 #include "ILITEModule.h"
 #include "ModuleRegistry.h"
 #include "InputManager.h"
 #include "DisplayCanvas.h"
+#include "DisplayBus.h"
+#include "EncoderSampler.h"
 #include "PacketRouter.h"
 #include "ILITEHelpers.h"
 #include "InverseKinematics.h"
 #include "AudioRegistry.h"
+#include "LinkRate.h"
+#include "CommandTable.h"
 
 // Forward declarations for existing subsystems
 class EspNowDiscovery;
@@ -55,6 +61,116 @@ class FrameworkEngine;
 // Built-in module registration (called from ILITEFramework::begin)
 void registerBuiltInModules();
 
+/**
+ * @struct ControlLoopStats
+ * @brief Timing statistics of the control loop (CommTask)
+ *
+ * Written only by CommTask; readers on other tasks may see values from
+ * adjacent iterations, which is fine for display.
+ */
+struct ControlLoopStats {
+    uint32_t targetPeriodUs = 0;    ///< Configured period
+    uint32_t lastPeriodUs = 0;      ///< Measured time between the last two iterations
+    uint32_t lastJitterUs = 0;      ///< |lastPeriodUs - targetPeriodUs|
+    uint32_t maxJitterUs = 0;       ///< Worst jitter since reset
+    uint32_t lastExecUs = 0;        ///< Time spent in the last iteration
+    uint32_t maxExecUs = 0;         ///< Worst iteration time since reset
+    uint32_t overrunCount = 0;      ///< Missed deadlines: late iterations, plus releases lost otherwise
+    uint32_t iterations = 0;        ///< Iterations since reset
+    uint32_t telemetryTicks = 0;    ///< Extra control runs triggered by telemetry (ControlSchedule)
+};
+
+/**
+ * @struct RadioLatencyStats
+ * @brief Command-to-air latency of CommTask transmissions
+ *
+ * Measured from the control timer releasing CommTask to the ESP-NOW send
+ * callback of the first packet sent in that tick. Written only by the send
+ * callback (WiFi task).
+ */
+struct RadioLatencyStats {
+    uint32_t lastUs = 0;            ///< Latest measured latency
+    uint32_t minUs = 0;             ///< Best latency since reset
+    uint32_t maxUs = 0;             ///< Worst latency since reset
+    uint32_t avgUs = 0;             ///< Running average (1/16 weight per sample)
+    uint32_t samples = 0;           ///< Measured ticks since reset
+    uint32_t failures = 0;          ///< Send callbacks reporting failure
+};
+
+/**
+ * @struct PeerTxStats
+ * @brief Command traffic to one driven peer
+ *
+ * Slot 0 is the paired peer; slots 1..kMaxTeamPeers are team peers.
+ */
+struct PeerTxStats {
+    const uint8_t* mac = nullptr;           ///< Peer MAC (nullptr = slot unused)
+    const char* moduleName = nullptr;       ///< Module driving the peer
+    uint32_t frames = 0;                    ///< Command frames sent since boot
+    uint16_t achievedHz = 0;                ///< Command frames in the last second
+    bool acked = false;                     ///< Peer acknowledged the pairing
+};
+
+/**
+ * @brief Core/priority layouts for the framework tasks
+ *
+ * The WiFi/ESP-NOW stack runs on core 0 at priority 23. The Arduino loop()
+ * stays on core 1 at priority 1 but only sleeps once ServiceTask runs.
+ *
+ * | Profile      | CommTask | RxTask  | DisplayTask | DisplayFlush | ServiceTask | JobWorker |
+ * |--------------|----------|---------|-------------|--------------|-------------|-----------|
+ * | Balanced     | C0 / P2  | C0 / P3 | C1 / P1     | C1 / P2      | C1 / P1     | C1 / P0   |
+ * | RadioLatency | C1 / P4  | C0 / P3 | C1 / P1     | C1 / P2      | C1 / P1     | C0 / P0   |
+ * | UiSmooth     | C0 / P2  | C0 / P3 | C1 / P3     | C1 / P4      | C1 / P1     | C1 / P0   |
+ *
+ * - Balanced: the default. Control and receive share core 0 with the
+ *   radio, and the UI owns core 1.
+ * - RadioLatency: control moves off the radio core and preempts the UI, so
+ *   WiFi callbacks never delay the control computation, and vice versa.
+ *   Frames may stretch while the control loop runs.
+ * - UiSmooth: rendering and flushing preempt ServiceTask housekeeping (and
+ *   the ADC reader), for steadier frame pacing.
+ *
+ * JobWorker (JobQueue.h) runs at the idle priority on the core CommTask is
+ * not on, so background jobs only take time every other task leaves.
+ *
+ * Compare the profiles with the "radio" serial command or System Status >
+ * Air Latency (RadioLatencyStats).
+ */
+enum class TaskProfile : uint8_t {
+    Balanced = 0,
+    RadioLatency,
+    UiSmooth
+};
+
+/**
+ * @brief Link layer under the packet router (see Transport.h)
+ */
+enum class LinkTransport : uint8_t {
+    EspNow = 0,         ///< Over the air (default)
+    Uart                ///< Wired UART or RS485 bus (see UartTransport.h)
+};
+
+/**
+ * @brief Placement of one task
+ */
+struct TaskPlacement {
+    BaseType_t core;
+    UBaseType_t priority;
+};
+
+/**
+ * @brief Placement of every framework task for a TaskProfile
+ */
+struct TaskLayout {
+    TaskPlacement comm;
+    TaskPlacement rx;
+    TaskPlacement display;
+    TaskPlacement flush;
+    TaskPlacement service;
+    TaskPlacement worker;
+};
+
 /**
  * @struct ILITEConfig
  * @brief Configuration options for ILITE framework initialization
@@ -66,28 +182,153 @@ struct ILITEConfig {
     // Network Configuration
     // ========================================================================
 
-    /// WiFi SSID for access point mode (used for OTA updates)
+    /// WiFi SSID of the maintenance-mode access point (used for OTA updates)
     const char* wifiSSID = "ILITE-Controller";
 
     /// WiFi password for access point (minimum 8 characters)
     const char* wifiPassword = "ilite2024";
 
-    /// Enable over-the-air (OTA) updates via WiFi
+    /**
+     * Allow the OTA maintenance mode (see enterMaintenanceMode()). The radio
+     * runs STA-only ESP-NOW otherwise; the access point and ArduinoOTA only
+     * exist while the mode is active (the AP also while webDashboard runs).
+     */
     bool enableOTA = true;
 
+    /// Never broadcast pairing requests; learn robots only from their own broadcasts
+    bool passiveDiscovery = false;
+
+    /// Drop frames that are neither discovery packets nor from a known peer in
+    /// the ESP-NOW receive callback ("airtime" shows the foreign traffic)
+    bool foreignFilter = true;
+
+    /**
+     * Survey the channels at boot, run ESP-NOW on the quietest of 1/6/11 and
+     * move the link when it stays degraded (see ChannelSurvey). Robots must
+     * follow MSG_CHANNEL and search the candidates while unpaired.
+     */
+    bool autoChannel = false;
+
+    /// Listening time per channel in the boot survey (ms, 13 channels)
+    uint16_t channelSurveyDwellMs = 40;
+
+    /// ESP-NOW PHY rate; with linkRateAdaptive the start and unpaired rate (see LinkRate)
+    LinkPhyRate linkRate = LinkPhyRate::Mbps1;
+
+    /// Step the PHY rate up and down with the paired link's loss and RSSI
+    bool linkRateAdaptive = false;
+
+    /// Enable 802.11 LR so the lr250k/lr500k rates exist (the robot must enable it too)
+    bool linkLongRange = false;
+
+    /**
+     * Share the channel with other controllers at the same control rate in
+     * beacon-synchronized send slots (see TdmaSlots). Controllers only.
+     */
+    bool tdmaSlots = false;
+
+    /// Radio transmit power in 0.25 dBm steps (8-84; 78 = 19.5 dBm)
+    int8_t txPowerQuarterDbm = 78;
+
+    /// Capture per-peer RSSI through promiscuous receive (see LinkMetrics)
+    bool linkRssi = true;
+
+    /// Ping the paired peer this often for RTT/loss statistics (ms, 0 = off)
+    uint16_t linkPingMs = 500;
+
+    /// Wrap command frames in a sequence/timestamp stamp (robot must unwrap, see CommandStamp.h)
+    bool commandStamps = false;
+
+    /// Carry previous copies of command types that set PacketDescriptor::redundancy
+    /// (robot must unwrap REDN frames, see RedundantPacket.h). Off: those types go plain.
+    bool redundantCommands = false;
+
+    /// Command frames awaiting their send callback before newer ones are held (0 = no limit, see TxWindow)
+    uint8_t txWindow = 2;
+
+    /// Link that carries every frame; modules are unaware of it
+    LinkTransport transport = LinkTransport::EspNow;
+
+    /// Wired transport (UART2): baud and pins. The defaults avoid the input and I2C pins.
+    uint32_t uartTransportBaud = 2000000;
+    int8_t uartTransportTxPin = 14;
+    int8_t uartTransportRxPin = 4;
+
+    /// RS485 driver-enable pin (-1 = plain point-to-point UART)
+    int8_t uartTransportDePin = -1;
+
     // ========================================================================
     // Timing Configuration
     // ========================================================================
 
-    /// Display refresh rate in Hz (default 10Hz = 100ms per frame)
+    /// Redraw rate cap for changing data: paired dashboards, animated screens (Hz, see RenderScheduler)
     uint8_t displayRefreshHz = 10;
 
-    /// Control loop frequency in Hz (default 50Hz = 20ms per iteration)
-    uint8_t controlLoopHz = 50;
+    /// Redraw rate cap for input reactions (menu navigation)
+    uint8_t displayMaxFps = 30;
+
+    /// Redraw at least this often when nothing asks for a frame
+    uint8_t displayFloorHz = 4;
+
+    /// Control loop frequency in Hz (default 50Hz = 20ms per iteration, max 1000Hz)
+    uint16_t controlLoopHz = 50;
 
     /// Connection timeout in milliseconds (default 3000ms = 3 seconds)
     uint32_t connectionTimeoutMs = 3000;
 
+    /// Only transmit command packets whose bytes changed since the last send, for
+    /// every type. Off: only types that set PacketDescriptor::keepaliveMs opt in,
+    /// since the robot must tolerate gaps up to the keepalive.
+    bool changeOnlyCommands = false;
+
+    /// Resend unchanged command packets at least this often (ms, default 100)
+    /// when changeOnlyCommands covers a type without its own keepaliveMs
+    uint16_t commandKeepaliveMs = 100;
+
+    /// CommTask stage budgets in percent of the tick (see ControlDeadline)
+    uint8_t inputBudgetPercent = 10;
+    uint8_t uiBudgetPercent = 15;
+    uint8_t controlBudgetPercent = 40;
+    uint8_t transmitBudgetPercent = 25;
+
+    /// Sustained overruns switch to the degraded tick (safety commands only)
+    bool degradedMode = true;
+
+    /// Module callbacks over their budget: logged, and draw/service throttled
+    ModuleBudgetPolicy moduleBudgets = ModuleBudgetPolicy::Skip;
+
+    /// Keep the module switched away from in standby: its menus, bindings,
+    /// working state and telemetry stay, so switching back skips
+    /// onActivate() and the rebuild (see ILITEModule::onSuspend())
+    bool moduleStandby = true;
+
+    /// Core/priority layout of the framework tasks (see TaskProfile)
+    TaskProfile taskProfile = TaskProfile::Balanced;
+
+    // ========================================================================
+    // Power Configuration (see PowerManager)
+    // ========================================================================
+
+    /// Scale the CPU clock and slow the tasks while nothing needs full rate
+    bool powerManagement = true;
+
+    /// CPU clock range (MHz) for frequency scaling
+    uint16_t cpuMaxMhz = 240;
+    uint16_t cpuMinMhz = 80;
+
+    /// Automatic light sleep while idle and unpaired (ESP-NOW is deaf while asleep)
+    bool lightSleep = false;
+
+    /// Control loop rate while unpaired (Hz, 0 = controlLoopHz)
+    uint16_t unpairedControlHz = 20;
+
+    /// No input for this long dims the display (ms, 0 = never idle)
+    uint32_t idleTimeoutMs = 30000;
+
+    /// Display floor rate and contrast while idle
+    uint8_t idleDisplayHz = 2;
+    uint8_t idleContrast = 8;
+
     // ========================================================================
     // Input Configuration
     // ========================================================================
@@ -101,6 +342,9 @@ struct ILITEConfig {
     /// Enable joystick low-pass filtering
     bool joystickFiltering = true;
 
+    /// Encoder counting: PCNT peripheral (no interrupts) or pin interrupts
+    EncoderBackend encoderBackend = EncoderBackend::Pcnt;
+
     // ========================================================================
     // Feature Flags
     // ========================================================================
@@ -114,11 +358,31 @@ struct ILITEConfig {
     /// Enable automatic discovery broadcasting
     bool enableDiscovery = true;
 
+    /// Commit settings edits once the oldest is this old (ms, see SettingsStore)
+    uint32_t settingsCommitMs = 5000;
+
+    /// Persist the connection log to the "eventlog" flash partition (see EventLog)
+    bool eventLog = true;
+
+    /// Keep the last seconds of inputs and packets, saved to the "blackbox" partition on a fault (see BlackBox)
+    bool blackBox = true;
+
+    /**
+     * Fast boot: resume the last paired peer and its module without discovery,
+     * on the cached channel, with quiet boot logs. The power-on to first
+     * command time is logged once the first command frame is out (or after
+     * 3 s without one).
+     */
+    bool fastBoot = false;
+
     // ========================================================================
     // Display Configuration
     // ========================================================================
 
-    /// I2C address for OLED display (default 0x3C for SH1106)
+    /// Panel controller, bus, clock and SPI pins (see DisplayBus)
+    DisplayBusConfig displayBus;
+
+    /// I2C address for OLED display (default 0x3C for SH1106; overrides displayBus.i2cAddress)
     uint8_t displayI2CAddress = 0x3C;
 
     /// Display rotation (0, 90, 180, 270 degrees)
@@ -127,6 +391,9 @@ struct ILITEConfig {
     /// Display contrast (0-255, default 128)
     uint8_t displayContrast = 128;
 
+    /// Cache rasterized labels and text widths across frames (see TextCache)
+    bool displayTextCache = true;
+
     // ========================================================================
     // Debug Configuration
     // ========================================================================
@@ -136,6 +403,24 @@ struct ILITEConfig {
 
     /// Serial baud rate (if framework should initialize Serial)
     uint32_t serialBaudRate = 115200;
+
+    /// Mirror every telemetry and command packet to Serial as binary frames (see TelemetryTap)
+    bool telemetryTap = false;
+
+    /// Serial baud rate while the tap is enabled (0 keeps the current rate)
+    uint32_t telemetryTapBaud = 2000000;
+
+    /// Also stream the display on the tap, delta coded (see ScreenCapture)
+    bool screenTap = false;
+
+    /// Serial baud rate while the PC drives the robot through the controller (see SerialBridge)
+    uint32_t bridgeBaud = 2000000;
+
+    /// Keep the access point up and serve the telemetry dashboard (see WebDashboard)
+    bool webDashboard = false;
+
+    /// HTTP/WebSocket port of the dashboard
+    uint16_t webDashboardPort = 80;
 };
 
 /**
@@ -151,13 +436,13 @@ struct ILITEConfig {
  * - FreeRTOS task creation (control loop, display rendering)
  * - Discovery and pairing protocols
  * - Connection timeout detection
- * - OTA update handling
+ * - OTA maintenance mode
  *
  * ## Architecture:
  * ```
  * Main Loop (loop())
  *     └─> ILITE.update()
- *         ├─> OTA handling
+ *         ├─> OTA handling (maintenance mode only)
  *         ├─> Discovery updates
  *         └─> Timeout detection
  *
@@ -178,6 +463,7 @@ class ILITEFramework {
 public:
     static constexpr size_t WIFI_SSID_MAX_LEN = 31;
     static constexpr size_t WIFI_PASSWORD_MAX_LEN = 63;
+    static constexpr uint16_t MAX_CONTROL_LOOP_HZ = 1000;
     /**
      * @brief Get singleton instance
      * @return Reference to the ILITEFramework instance
@@ -200,26 +486,28 @@ public:
      * 3. Initialize all registered modules (call onInit())
      * 4. Create FreeRTOS tasks (control, display)
      * 5. Start discovery protocol
-     * 6. Initialize OTA if enabled
+     * 6. Initialize extension systems
      *
      * @note If initialization fails, check Serial output for error messages
      */
     bool begin(const ILITEConfig& config = ILITEConfig());
 
     /**
-     * @brief Update framework state (call in loop())
+     * @brief Yield the Arduino loop (call in loop())
      *
-     * Handles non-time-critical tasks that don't need precise timing:
-     * - OTA update processing
-     * - Discovery protocol maintenance
-     * - Connection timeout detection
-     * - Audio feedback updates
+     * Housekeeping (OTA, discovery, pairing, serial console, control
+     * bindings, audio) runs in ServiceTask at fixed periods, so this only
+     * sleeps for kLoopYieldMs to keep loop() from spinning. If ServiceTask
+     * could not be created, the housekeeping jobs run here instead.
      *
      * @note Time-critical control and display operations run in dedicated
      *       FreeRTOS tasks, not in this function.
      */
     void update();
 
+    /// Sleep of update() while ServiceTask owns the housekeeping (ms)
+    static constexpr uint32_t kLoopYieldMs = 10;
+
     // ========================================================================
     // Module Management
     // ========================================================================
@@ -228,7 +516,13 @@ public:
      * @brief Set the currently active module
      *
      * Activates a module by calling its onActivate() hook, deactivates the
-     * previous module, and updates the packet router.
+     * previous module, and updates the packet router. The previous module is
+     * unpublished and only deactivated after a ModuleHandoff grace period, so
+     * call this on ServiceTask (or before the tasks start), never while pinned.
+     *
+     * With ILITEConfig::moduleStandby the previous module is suspended
+     * instead, and the module suspended before it is deactivated unless it
+     * is `module`, which then resumes as it was left.
      *
      * @param module Pointer to module to activate (nullptr to deactivate all)
      */
@@ -237,8 +531,7 @@ public:
     /**
      * @brief Request a module switch from any task context.
      *
-     * The change is deferred to the main framework loop to avoid race
-     * conditions with the control task.
+     * The change is queued in ModuleHandoff and applied on ServiceTask.
      *
      * @param module Module to activate (nullptr to clear selection)
      */
@@ -246,7 +539,10 @@ public:
 
     /**
      * @brief Get the currently active module
-     * @return Pointer to active module, or nullptr if none active
+     *
+     * Only call into it on the ServiceTask or while holding a ModulePin.
+     *
+     * @return Pointer to active module, or nullptr if none active (or mid-switch)
      */
     ILITEModule* getActiveModule() const;
 
@@ -272,6 +568,69 @@ public:
      */
     bool registerModule(ILITEModule& module);
 
+    // ========================================================================
+    // Group Commands
+    // ========================================================================
+
+    /**
+     * @brief Send one command to every robot in a group as a single broadcast
+     *
+     * Airtime and start skew stay constant however many robots are in the
+     * group. Robots filter with acceptGroupCommand() (see GroupCommand.h).
+     * Safe from any task.
+     *
+     * @param group Group ID (kGroupAll = every robot)
+     * @param ackEvery Ask members to ACK every n-th frame (0 = never)
+     * @return false if the frame did not fit or could not be sent
+     */
+    bool sendGroupCommand(uint8_t group, const uint8_t* data, size_t length,
+                          uint8_t ackEvery = 0);
+
+    // ========================================================================
+    // Team Peers (multi-robot control)
+    // ========================================================================
+
+    /// Robots driven next to the paired peer
+    static constexpr size_t kMaxTeamPeers = 2;
+
+    /**
+     * @brief Drive a discovered robot next to the paired peer
+     *
+     * The robot is linked with a PAIR_CONFIRM and driven by the registered
+     * module matching its identity. That module must not already drive
+     * another peer (modules are single instances), so two robots need two
+     * different modules. Its telemetry is routed to it by MAC.
+     *
+     * CommTask splits each control tick into one slot per driven peer, so
+     * every peer still gets controlLoopHz while the sends are spread across
+     * the tick.
+     *
+     * Call from ServiceTask context (serial console, deferred requests).
+     *
+     * @param peerIndex EspNowDiscovery peer index
+     * @return false if no slot, module or link was available
+     */
+    bool addTeamPeer(int peerIndex);
+
+    /**
+     * @brief Stop driving a team peer (its module gets onUnpair())
+     */
+    void removeTeamPeer(const uint8_t* mac);
+
+    /**
+     * @brief Number of team peers being driven
+     */
+    size_t getTeamPeerCount() const;
+
+    /// Control loop rate right now (lower while unpaired, see ILITEConfig::unpairedControlHz)
+    uint16_t getControlLoopHz() const;
+
+    /**
+     * @brief Command traffic of a driven peer
+     * @param slot 0 = paired peer, 1..kMaxTeamPeers = team peers
+     */
+    PeerTxStats getPeerTxStats(size_t slot) const;
+
     // ========================================================================
     // Pairing Management
     // ========================================================================
@@ -333,6 +692,46 @@ public:
      */
     const char* getWiFiPassword() const;
 
+    // ========================================================================
+    // OTA Maintenance Mode
+    // ========================================================================
+
+    /**
+     * @brief Request the OTA maintenance mode from any task context
+     *
+     * Applied by ServiceTask. Entering saves pending config and settings,
+     * stops the control timer, parks CommTask and DisplayTask, and starts
+     * the access point (on the ESP-NOW channel), ArduinoOTA for espota and
+     * OtaReceiver for compressed images (tools/ota_push.py). Leaving
+     * reverses this and returns the radio to STA-only ESP-NOW. Pressing the
+     * encoder button also leaves the mode.
+     *
+     * @param enable true to enter, false to leave
+     * @return false if config.enableOTA is off
+     */
+    bool requestMaintenanceMode(bool enable);
+
+    /**
+     * @brief Check if the OTA maintenance mode is active
+     */
+    bool isInMaintenanceMode() const;
+
+    /**
+     * @brief Start or stop the web dashboard (ServiceTask)
+     *
+     * Starting brings up the access point on the ESP-NOW channel; stopping
+     * takes it down again unless the maintenance mode still needs it.
+     */
+    bool setWebDashboard(bool enable);
+
+    /**
+     * @brief Serial console commands ("help" lists them)
+     *
+     * The terminal prompt runs lines the active module does not know
+     * through the same table and offers its names as completions.
+     */
+    const CommandTable& getConsoleCommands() const;
+
     /**
      * @brief Update WiFi credentials (optionally persist + restart AP)
      * @param ssid New SSID (null-terminated)
@@ -351,17 +750,65 @@ public:
      */
     uint32_t getPacketTxCount() const;
 
+    /**
+     * @brief Time of the first command frame
+     * @return millis() since power-on when it was sent, 0 before that
+     */
+    uint32_t getFirstCommandMs() const;
+
     /**
      * @brief Get packet receive count
      * @return Number of packets received via ESP-NOW since boot
      */
     uint32_t getPacketRxCount() const;
 
+    /**
+     * @brief Get count of command packets skipped as unchanged
+     * @return Number of transmissions saved by change-only sending since boot
+     */
+    uint32_t getPacketSkippedCount() const;
+
+    /**
+     * @brief Get control loop timing statistics (jitter, overruns, exec time)
+     */
+    const ControlLoopStats& getControlLoopStats() const;
+
+    /**
+     * @brief Reset control loop statistics (applied on the next iteration)
+     */
+    void resetControlLoopStats();
+
+    /**
+     * @brief Get command-to-air latency statistics
+     */
+    const RadioLatencyStats& getRadioLatencyStats() const;
+
+    /**
+     * @brief Reset radio latency statistics (applied on the next send callback)
+     */
+    void resetRadioLatencyStats();
+
+    /**
+     * @brief Task layout used for a profile
+     */
+    static TaskLayout getTaskLayout(TaskProfile profile);
+
+    /**
+     * @brief Display name of a profile ("balanced", "radio-latency", "ui-smooth")
+     */
+    static const char* getTaskProfileName(TaskProfile profile);
+
     /**
      * @brief Internal hook used by PacketRouter when telemetry arrives.
      */
     void onTelemetryReceived(ILITEModule* module);
 
+    /**
+     * @brief Internal hook used by PacketRouter: telemetry for the paired
+     *        peer's module arrived (ControlSchedule::OnTelemetry trigger)
+     */
+    void onControlTelemetry(ILITEModule* module, size_t typeIndex);
+
 private:
     /**
      * @brief Private constructor (singleton pattern)
@@ -395,11 +842,22 @@ private:
     bool createTasks();
 
     /**
-     * @brief Initialize OTA update system
+     * @brief Start the OTA update system (ArduinoOTA and OtaReceiver)
+     *
+     * Runs on every maintenance mode entry; the ArduinoOTA handlers are
+     * registered on the first call only.
      * @return true if successful, false on error
      */
     bool initOTA();
 
+    /// ArduinoOTA progress, error and start handlers (once, from initOTA())
+    void registerOTAHandlers();
+
+    /**
+     * @brief Commit pending settings before an OTA image is written
+     */
+    static void prepareForFlashing();
+
     // ========================================================================
     // Task Functions (Static for FreeRTOS)
     // ========================================================================
@@ -407,13 +865,35 @@ private:
     /**
      * @brief Control loop task (Core 0, high priority)
      *
-     * Runs at configured Hz (default 50Hz). Reads inputs, calls module's
-     * updateControl(), prepares packets, and transmits via ESP-NOW.
+     * Runs at configured Hz (default 50Hz, up to 1000Hz), released by a
+     * periodic esp_timer. Reads inputs, calls module's updateControl() with
+     * a microsecond-resolution dt, prepares packets, and transmits via
+     * ESP-NOW. Records jitter and overruns in ControlLoopStats.
      *
      * @param parameter Pointer to ILITEFramework instance
      */
     static void commTask(void* parameter);
 
+    /**
+     * @brief ESP-NOW send callback; records RadioLatencyStats
+     */
+    static void onEspNowSent(const uint8_t* mac, esp_now_send_status_t status);
+
+    /**
+     * @brief esp_timer callback that releases CommTask each period
+     *
+     * @param arg CommTask handle
+     */
+    static void controlTimerCallback(void* arg);
+
+    /**
+     * @brief One-shot esp_timer callback that restarts the control timer at
+     *        a TDMA slot start and releases CommTask
+     *
+     * @param arg The framework
+     */
+    static void alignTimerCallback(void* arg);
+
     /**
      * @brief Display rendering task (Core 1, lower priority)
      *
@@ -424,6 +904,105 @@ private:
      */
     static void displayTask(void* parameter);
 
+    /**
+     * @brief Receive consumer task (Core 0, above CommTask)
+     *
+     * Sleeps until the ESP-NOW callback queues a frame, then drains the
+     * receive ring in batches: discovery packets go to EspNowDiscovery,
+     * telemetry from the paired peer goes to PacketRouter.
+     *
+     * @param parameter Pointer to ILITEFramework instance
+     */
+    static void rxTask(void* parameter);
+
+    /**
+     * @brief Housekeeping task (Core 1, low priority)
+     *
+     * Wakes every kServiceTickMs and runs each job whose period elapsed:
+     *
+     * | Job                              | Period |
+     * |----------------------------------|--------|
+     * | Pending module switch, audio     | 10 ms  |
+     * | Control bindings (buttons)       | 10 ms  |
+     * | Pairing and connection timeout   | 20 ms  |
+     * | Serial console                   | 20 ms  |
+     * | Maintenance mode switch          | 10 ms  |
+     * | OTA (maintenance mode only)      | 50 ms  |
+     * | Discovery                        | 100 ms |
+     * | Fast-boot deferred init (once)   | 50 ms  |
+     * | TaskMonitor (self-limits to 1 s) | 100 ms |
+     * | Team links and command rates     | 1 s    |
+     *
+     * Without a JobQueue worker it also runs a slice of the next background
+     * job (at most kServiceJobSliceUs) every tick.
+     *
+     * @param parameter Pointer to ILITEFramework instance
+     */
+    static void serviceTask(void* parameter);
+
+    /// Tick of ServiceTask (ms)
+    static constexpr uint32_t kServiceTickMs = 10;
+
+    /// Background job time per ServiceTask tick when there is no worker task
+    static constexpr uint32_t kServiceJobSliceUs = 1000;
+
+    /// ServiceTask stack; the maintenance mode runs the OTA and AP setup on it
+    static constexpr uint32_t kServiceTaskStackSize = 6144;
+
+    /// Fast boot reports its timing this long after begin() at the latest
+    static constexpr uint32_t kDeferredInitTimeoutMs = 3000;
+
+    /**
+     * @brief Create ServiceTask (after initialization completes)
+     */
+    bool startServiceTask();
+
+    /**
+     * @brief Run every housekeeping job that is due
+     */
+    void runServiceJobs(uint32_t now);
+
+    /**
+     * @brief Prepare and send one module's command packets to its peer
+     *
+     * @param txSlot 0 for the paired peer, 1 + team index otherwise
+     * @param peerMac Destination (nullptr = not linked, only resets state)
+     */
+    void runTelemetryTick(uint32_t inputUs);
+    void transmitCommands(size_t txSlot, ILITEModule* module, const uint8_t* peerMac,
+                          uint32_t now, uint32_t inputUs);
+
+    /**
+     * @brief Drop team peers whose link went stale; update achieved rates
+     */
+    void updateTeamPeers();
+
+    /**
+     * @brief Send queued bundleable command packets and clear the bundle
+     *
+     * A bundle that holds a single packet is sent without bundle framing.
+     */
+    void flushCommandBundle(class PacketBundleWriter& bundle, const uint8_t* peerMac,
+                            uint32_t inputUs);
+
+    /**
+     * @brief Send the module's telemetry rate request if it changed or is due
+     * @param primary Paired peer's slot: TelemetryHealth follows the new rates
+     * @see RateRequest.h
+     */
+    void sendRateRequest(class RateRequestWriter& rates, ILITEModule* module,
+                         const uint8_t* peerMac, uint32_t now, uint32_t inputUs, bool primary);
+
+    /**
+     * @brief Send one command frame to the peer through TxWindow, stamped if enabled
+     * @param key Command type for coalescing (kTxNoCoalesce for bundles)
+     * @param inputUs esp_timer time (low 32 bits) of this tick's input snapshot
+     * @param headroom Writable bytes the caller owns in front of `data`; with
+     *                 kCommandStampSize the stamp goes there instead of a copy
+     */
+    void sendCommandFrame(const uint8_t* peerMac, uint8_t key, const uint8_t* data,
+                          size_t length, uint32_t inputUs, size_t headroom = 0);
+
     // ========================================================================
     // Runtime Helpers
     // ========================================================================
@@ -448,6 +1027,54 @@ private:
      */
     void handleOTA();
 
+    /**
+     * @brief Pair with the cached peer and activate its module (fast boot)
+     * @return true if a cached peer and a matching module were found
+     */
+    bool resumeLastPeer();
+
+    /**
+     * @brief Cache the paired peer, its channel and the active module
+     */
+    void rememberLastPeer();
+
+    /**
+     * @brief Report the fast-boot timing once commands flow
+     */
+    void finishDeferredInit();
+
+    /**
+     * @brief Park the real-time tasks and start the AP, ArduinoOTA and
+     *        the compressed-image OtaReceiver
+     */
+    void enterMaintenanceMode();
+
+    /**
+     * @brief Stop OTA and the AP and resume the real-time tasks
+     */
+    void exitMaintenanceMode();
+
+    /**
+     * @brief Bring up the access point for the maintenance mode or the dashboard
+     */
+    void startAccessPoint();
+
+    /**
+     * @brief Draw the maintenance screen (DisplayTask must be parked)
+     * @param progress Update progress in percent, or -1 while waiting
+     */
+    void drawMaintenanceScreen(int progress);
+
+    /**
+     * @brief Read serial console lines ("prof", "prof reset")
+     */
+    void handleSerialCommands();
+
+    /**
+     * @brief Index the console commands (once, from begin())
+     */
+    void registerConsoleCommands();
+
     /**
      * @brief Handle input events for the home screen while unpaired
      */
@@ -469,27 +1096,72 @@ private:
     /// Boot timestamp
     uint32_t bootTime_;
 
-    /// Currently active module
+    /// Fast boot: timing still to report
+    volatile bool deferredInitPending_;
+
+    /// OTA maintenance mode: active, and the state ServiceTask should switch to
+    volatile bool maintenanceMode_;
+    volatile bool maintenanceRequested_;
+
+    /// ArduinoOTA handlers registered (ServiceTask)
+    bool otaHandlersSet_;
+
+    /// DisplayTask is parked, so other tasks may draw
+    volatile bool displayParked_;
+
+    /// Serial console and terminal commands
+    CommandTable consoleCommands_;
+
+    /// Console asked DisplayTask to run DisplayBus::benchmark()
+    volatile bool displayBenchRequested_;
+
+    /// millis() of the first command frame (0 until sent)
+    volatile uint32_t firstCommandMs_;
+
+    /// Currently active module (ServiceTask; other tasks pin ModuleHandoff)
     ILITEModule* activeModule_;
 
     /// Previous active module (for deactivation)
     ILITEModule* previousModule_;
 
-    /// Pending module request (processed on update loop)
-    ILITEModule* pendingModule_;
-    bool moduleChangePending_;
-
     /// Pairing state
     bool paired_;
+    uint32_t pairEpoch_;            ///< Bumped on every new pairing
+    uint32_t standbyPairEpoch_;     ///< pairEpoch_ when the standby module was suspended (0 = unpaired)
     uint32_t lastTelemetryTime_;
 
     /// Packet statistics
     uint32_t packetTxCount_;
     uint32_t packetRxCount_;
+    uint32_t packetSkippedCount_;
+
+    /// Team peers (module == nullptr marks a free slot)
+    struct TeamPeer {
+        ILITEModule* volatile module;
+        uint8_t mac[6];
+    };
+    TeamPeer teamPeers_[kMaxTeamPeers];
+
+    /// Per-peer transmit state and counters (slot 0 = paired peer)
+    struct PeerTxState;
+    static PeerTxState txStates_[1 + kMaxTeamPeers];
+    uint32_t txFrames_[1 + kMaxTeamPeers];
+    uint32_t txFramesLastSecond_[1 + kMaxTeamPeers];
+    uint16_t txHz_[1 + kMaxTeamPeers];
 
     /// Task handles
     TaskHandle_t commTaskHandle_;
     TaskHandle_t displayTaskHandle_;
+    TaskHandle_t rxTaskHandle_;
+    TaskHandle_t serviceTaskHandle_;
+
+    /// Control loop scheduling
+    esp_timer_handle_t controlTimer_;
+    esp_timer_handle_t alignTimer_;     ///< Re-times controlTimer_ onto the TDMA slot
+    ControlLoopStats controlStats_;
+    volatile bool controlStatsResetPending_;
+    RadioLatencyStats radioStats_;
+    volatile bool radioStatsResetPending_;
 
     /// Hardware subsystem pointers
     U8G2* u8g2_;
@@ -506,6 +1178,7 @@ private:
     void initializeWiFiCredentials();
     void loadWiFiCredentialsFromPrefs();
     void persistWiFiCredentials();
+    void saveModuleConfig(ILITEModule* module);
 };
 
 /**
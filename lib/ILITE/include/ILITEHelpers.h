@@ -14,6 +14,8 @@
 #pragma once
 #include <Arduino.h>
 #include <Preferences.h>
+#include "connection_log.h"
+#include "LogChannels.h"
 
 // ============================================================================
 // Logger - Connection Event Logging
@@ -23,7 +25,8 @@
  * @brief Connection event logger
  *
  * Wraps connection_log system with clean API. Logs ESP-NOW events,
- * pairing status, packet counts, errors, etc.
+ * pairing status, packet counts, errors, etc. Lines go to the SYSTEM
+ * log channel; use ILITE_LOG() for other channels.
  *
  * ## Usage
  * ```cpp
@@ -48,10 +51,17 @@ public:
 
     /**
      * @brief Log formatted message (printf-style)
-     * @param fmt Format string
-     * @param ... Arguments
+     *
+     * Arguments are captured as a binary record and formatted only when the
+     * log is displayed, so this is cheap enough for packet callbacks.
+     *
+     * @param fmt Format string (must be a string literal)
+     * @param args Arguments
      */
-    void logf(const char* fmt, ...);
+    template <typename... Args>
+    void logf(const char* fmt, Args... args) {
+        ILITE_LOG(SYSTEM, LOG_INFO, fmt, args...);
+    }
 
     /**
      * @brief Log info message (same as log, for semantic clarity)
@@ -230,6 +240,10 @@ private:
  * ```
  *
  * **Important**: Always call begin() before use and end() when done!
+ *
+ * Every put writes and commits flash immediately. For values edited
+ * interactively (menus, encoder tuning) use SettingsStore, which caches
+ * them and commits in batches.
  */
 class PreferencesManager {
 public:
@@ -13,22 +13,49 @@
 
 #pragma once
 #include <Arduino.h>
+#include <cstddef>
 #include <functional>
 #include <vector>
 
 #include "ModuleMenu.h"
+#include "ModuleBudget.h"
 
 // Forward declarations
 class DisplayCanvas;
+class WidgetScreen;
 class InputManager;
 class PreferencesManager;
+class SettingsStore;
 class Logger;
 class Audio;
+class CommandTable;
 
 /**
  * @brief Describes a packet structure for validation and routing
  */
 struct PacketDescriptor {
+    struct Field;
+
+    constexpr PacketDescriptor() : PacketDescriptor(nullptr, 0, 0, 0, false) {}
+
+    /**
+     * @brief Descriptor with the required members, the optional ones defaulted
+     *
+     * Not an aggregate, so the brace lists modules write (`return {"State",
+     * STATE_MAGIC, sizeof(State), sizeof(State), true, nullptr, 0};`) call
+     * this in every language mode; optional members follow in declaration
+     * order.
+     */
+    constexpr PacketDescriptor(const char* name, uint32_t magicNumber, size_t minSize, size_t maxSize,
+                               bool usesMagic, const Field* fields = nullptr, size_t fieldCount = 0,
+                               bool bundleable = false, uint16_t keepaliveMs = 0, uint8_t redundancy = 0,
+                               uint16_t periodMs = 0, uint8_t priority = 0, uint16_t staleAfterMs = 0,
+                               bool deltaEncoded = false, int16_t timestampOffset = -1)
+        : name(name), magicNumber(magicNumber), minSize(minSize), maxSize(maxSize),
+          usesMagic(usesMagic), fields(fields), fieldCount(fieldCount), bundleable(bundleable),
+          keepaliveMs(keepaliveMs), redundancy(redundancy), periodMs(periodMs), priority(priority),
+          staleAfterMs(staleAfterMs), deltaEncoded(deltaEncoded), timestampOffset(timestampOffset) {}
+
     const char* name;           ///< Human-readable name "Flight Command"
     uint32_t magicNumber;       ///< Packet identifier (e.g., 0xA1B2C3D4)
     size_t minSize;             ///< Minimum valid packet size in bytes
@@ -49,6 +76,83 @@ struct PacketDescriptor {
 
     const Field* fields;        ///< Array of field descriptors (can be nullptr)
     size_t fieldCount;          ///< Number of fields in array
+
+    /// Command packets only: may be packed with other bundleable packets into
+    /// one ESP-NOW frame (see PacketBundle.h). The receiver must unbundle.
+    bool bundleable;
+
+    /// Command packets only: opt this type into change-only sending and
+    /// resend an unchanged packet at least this often (ms). 0 sends every
+    /// tick unless ILITEConfig::changeOnlyCommands is set, which then uses
+    /// ILITEConfig::commandKeepaliveMs. Keep it short for safety-critical
+    /// packets the robot uses as a failsafe heartbeat.
+    uint16_t keepaliveMs;
+
+    /// Command packets only: also carry this many previous versions (1-3) in
+    /// every frame, so the robot rebuilds lost frames without a retry, and
+    /// repeat a change that many times under change-only sending. The
+    /// receiver must unwrap (see RedundantPacket.h), so it only applies
+    /// with ILITEConfig::redundantCommands set.
+    uint8_t redundancy;
+
+    /// Command packets only: build and send this type every periodMs instead
+    /// of every control tick (0). Slow types are spread across ticks; a
+    /// change waits for the next due tick. See CommandSchedule.h.
+    uint16_t periodMs;
+
+    /// Command packets only: types due on the same tick go out highest
+    /// priority first, ahead of bulk types in the TX window
+    uint8_t priority;
+
+    /// Telemetry packets only: the type counts as stale after this long
+    /// without a packet (ms). 0 uses TelemetryHealth::kStaleIntervals times
+    /// the measured interval; kNeverStale exempts packets that only come as
+    /// replies to a request. See onTelemetryStale().
+    uint16_t staleAfterMs;
+
+    static constexpr uint16_t kNeverStale = 0xFFFF;     ///< staleAfterMs: no staleness tracking
+
+    /// Telemetry packets only: the robot may send this type delta-encoded
+    /// against keyframes, segmented by `fields` (see DeltaPacket.h). The
+    /// router rebuilds the packet before handleTelemetry().
+    bool deltaEncoded;
+
+    /// Telemetry packets only: byte offset of a uint32_t robot timestamp
+    /// (esp_timer microseconds, low 32 bits) taken when the data was
+    /// sampled, or -1 if the packet has none. Once ClockSync is synced the
+    /// router maps it onto the controller's clock; see getTelemetrySampleUs().
+    /// No built-in robot stamps its telemetry yet (DrongazeTelemetry has no
+    /// sample time), so the built-in descriptors leave this at -1.
+    int16_t timestampOffset;
+};
+
+/**
+ * @brief One persistent field of a module config struct (see ModuleConfig.h)
+ *
+ * Like PacketDescriptor::Field, plus an ID that stays with the field when
+ * the struct layout changes. Never reuse the ID of a removed field.
+ */
+struct ConfigField {
+    uint8_t id;                         ///< Stable field ID (1-255)
+    const char* name;                   ///< Field name "easingRate"
+    size_t offset;                      ///< Byte offset in the config struct
+    size_t size;                        ///< Field size in bytes
+    PacketDescriptor::Field::Type type; ///< Data type
+};
+
+/// ConfigField for `Struct::member`, e.g. ILITE_CONFIG_FIELD(1, MyConfig, gain, FLOAT)
+#define ILITE_CONFIG_FIELD(fieldId, Struct, member, fieldType) \
+    ConfigField{fieldId, #member, offsetof(Struct, member), sizeof(Struct::member), \
+                PacketDescriptor::Field::fieldType}
+
+/**
+ * @brief Layout of a module's persistent config struct
+ */
+struct ConfigDescriptor {
+    uint16_t version;           ///< Module's own config version (informational)
+    size_t size;                ///< sizeof(config struct)
+    const ConfigField* fields;  ///< Persistent fields
+    size_t fieldCount;
 };
 
 /**
@@ -61,6 +165,14 @@ struct FunctionAction {
     bool isToggle;                      ///< Whether this is a toggle (shows on/off state)
 };
 
+/**
+ * @brief When the framework calls a module's updateControl()
+ */
+enum class ControlSchedule : uint8_t {
+    Timer,          ///< Every control tick (default)
+    OnTelemetry     ///< Also as soon as triggering telemetry arrives (closed loops)
+};
+
 /**
  * @brief Abstract base class for all ILITE control modules
  *
@@ -200,7 +312,9 @@ public:
     /**
      * @brief Get command packet descriptor by index
      *
-     * Describes packet structure for validation and debugging.
+     * Describes packet structure for validation and debugging. Keep the
+     * descriptors in a constexpr table derived from the packet structs
+     * (PacketLayout.h) and return PacketLayout::at(table, index).
      *
      * @param index Packet type index (0 to getCommandPacketTypeCount()-1)
      * @return Packet descriptor
@@ -227,14 +341,17 @@ public:
     // ========================================================================
 
     /**
-     * @brief Called once when module is first loaded
+     * @brief Called once, before the module is first activated or paired
+     *
+     * Modules that are never used are never initialized, so boot time does
+     * not grow with the modules compiled in.
      *
      * Use for:
      * - Initializing state variables
-     * - Allocating buffers
      * - Loading preferences from EEPROM
      * - Registering callbacks
      *
+     * Large buffers belong in the working state (see getStateSize()).
      * Do NOT access hardware directly (use onActivate instead).
      */
     virtual void onInit() {}
@@ -285,6 +402,42 @@ public:
      */
     virtual void onDeactivate() {}
 
+    /**
+     * @brief Called instead of onDeactivate() when the module goes to standby
+     *
+     * With ILITEConfig::moduleStandby the module switched away from stays
+     * loaded: its menus, bindings, encoder functions and working state are
+     * kept, it just gets no control ticks, frames or telemetry. If the user
+     * switches back next, onResume() is called instead of onActivate();
+     * otherwise onDeactivate() follows when the next switch evicts it.
+     *
+     * Use for:
+     * - Stopping outputs that must not run unattended
+     */
+    virtual void onSuspend() {}
+
+    /**
+     * @brief Called instead of onActivate() when the module returns from standby
+     *
+     * onPair() follows only if the link was re-established meanwhile, and
+     * onUnpair() if it dropped.
+     */
+    virtual void onResume() {}
+
+    /**
+     * @brief Bytes of working state the module needs while active
+     *
+     * The framework reserves a ModuleArena state block of this size before
+     * onActivate(); the module places its buffers in it with
+     * ModuleArena::createState() / allocateState(). The block is freed when
+     * the module is unloaded (the next switch, or the one after while it is
+     * in standby), so pointers into it must be dropped in onDeactivate().
+     * Sum ModuleArena::stateBytes() of every allocation.
+     *
+     * @return Bytes (0 = no working state)
+     */
+    virtual size_t getStateSize() const { return 0; }
+
     // ========================================================================
     // Control Loop (REQUIRED - called at 50Hz by framework)
     // ========================================================================
@@ -334,7 +487,7 @@ public:
                                 size_t length) = 0;
 
     // ========================================================================
-    // Display & UI (REQUIRED for main dashboard)
+    // Display & UI
     // ========================================================================
 
     /**
@@ -357,9 +510,26 @@ public:
      * canvas.drawGauge(64, 40, 20, speed, 0, 100, "Speed");
      * ```
      *
+     * Modules that do not override it get a dashboard generated from their
+     * telemetry Field tables (see AutoDashboard.h), drawn retained through
+     * getDashboardWidgets().
+     *
      * @param canvas High-level drawing API (fonts, shapes, widgets)
      */
-    virtual void drawDashboard(DisplayCanvas& canvas) = 0;
+    virtual void drawDashboard(DisplayCanvas& canvas);
+
+    /**
+     * @brief Optional retained-mode dashboard (see WidgetTree.h)
+     *
+     * Return a WidgetScreen to have the framework render the dashboard
+     * incrementally: the framebuffer is kept between frames and only widgets
+     * whose bound value changed are redrawn. drawDashboard() is not called
+     * while this returns non-null.
+     *
+     * @return Widget screen, or nullptr for immediate-mode drawDashboard()
+     *         (the generated dashboard once the default drawDashboard() ran)
+     */
+    virtual WidgetScreen* getDashboardWidgets();
 
     /**
      * @brief Build per-module menu structure.
@@ -500,30 +670,40 @@ public:
     // ========================================================================
 
     /**
-     * @brief Get configuration schema (optional, for future web UI)
+     * @brief Describe the persistent config struct (optional)
      *
-     * JSON schema describing configurable parameters.
-     * Future feature - not yet implemented.
+     * The framework loads the stored config into getConfigData() before the
+     * module is first activated, and saves it after markConfigDirty(). The
+     * blob is binary (see ModuleConfig.h): an unchanged layout loads with one
+     * memcpy, a changed one is migrated field by field through the IDs.
      *
-     * @return JSON schema string or nullptr
+     * Example:
+     * ```cpp
+     * static const ConfigField kFields[] = {
+     *     ILITE_CONFIG_FIELD(1, MyConfig, gain, FLOAT),
+     *     ILITE_CONFIG_FIELD(2, MyConfig, mode, UINT8),
+     * };
+     * static const ConfigDescriptor kConfig = {1, sizeof(MyConfig), kFields, 2};
+     * const ConfigDescriptor* getConfigDescriptor() const override { return &kConfig; }
+     * void* getConfigData() override { return &config_; }
+     * ```
+     *
+     * @return Descriptor, or nullptr if the module stores no config
      */
-    virtual const char* getConfigSchema() const { return nullptr; }
+    virtual const ConfigDescriptor* getConfigDescriptor() const { return nullptr; }
 
     /**
-     * @brief Load configuration from JSON
+     * @brief Config struct described by getConfigDescriptor()
      *
-     * @param json Configuration JSON string
+     * Must hold the defaults when the module is first activated; fields
+     * without a stored value keep them.
      */
-    virtual void loadConfig(const char* json) {}
+    virtual void* getConfigData() { return nullptr; }
 
     /**
-     * @brief Save configuration to JSON
-     *
-     * @param buffer Output buffer for JSON
-     * @param bufferSize Max buffer size
-     * @return Bytes written
+     * @brief Called after a stored config was loaded into getConfigData()
      */
-    virtual size_t saveConfig(char* buffer, size_t bufferSize) { return 0; }
+    virtual void onConfigLoaded() {}
 
     // ========================================================================
     // Advanced Features (OPTIONAL)
@@ -545,6 +725,87 @@ public:
      */
     virtual void onEncoderButton() {}
 
+    /**
+     * @brief A telemetry packet type went stale or recovered
+     *
+     * Called from ServiceTask for the active module, once per transition
+     * and only for types received at least once. Use it to show a failsafe
+     * state for the data that type carries (e.g. grey out the arm pose).
+     *
+     * @param typeIndex Telemetry packet type index
+     * @param stale true when it went stale, false when packets resumed
+     */
+    virtual void onTelemetryStale(size_t typeIndex, bool stale) {}
+
+    /**
+     * @brief Background work of the active module
+     *
+     * Called from ServiceTask (low priority) about every 10 ms, never on
+     * the control path. Keep each call short and split longer analysis into
+     * slices: ServiceTask also runs the console, config saves and module
+     * switches.
+     *
+     * @param nowMs millis()
+     */
+    virtual void onService(uint32_t nowMs) {}
+
+    /**
+     * @brief Time budget of one of this module's callbacks
+     *
+     * The framework times every call against it (see ModuleBudget.h). An
+     * overrunning drawDashboard() or onService() is throttled; the others
+     * are logged. Read once, the first time the module is called.
+     *
+     * @param callback Callback being budgeted
+     * @return Budget in microseconds per call, 0 for none. Defaults to
+     *         ModuleBudget::defaultBudgetUs().
+     */
+    virtual uint32_t getCallbackBudgetUs(ModuleCallback callback) const;
+
+    /**
+     * @brief Telemetry rate to ask the robot for (see RateRequest.h)
+     *
+     * Called every control tick (CommTask) for each telemetry type. Return
+     * a high rate only while a screen that shows the data is visible, so
+     * downlink airtime goes to what is displayed. The robot must follow
+     * requests with RateRequestFollower for this to have an effect.
+     *
+     * @param typeIndex Telemetry packet type index
+     * @return Wanted rate in Hz; 0 leaves the rate to the robot (default)
+     */
+    virtual float getTelemetryRequestHz(size_t typeIndex) const { return 0.0f; }
+
+    /**
+     * @brief When updateControl() runs
+     *
+     * With ControlSchedule::OnTelemetry a closed-loop module reacts to
+     * feedback at once: a packet of a type for which triggersControl() is
+     * true wakes CommTask, which runs updateControl() with the last tick's
+     * inputs and sends the commands right away, instead of up to one timer
+     * period later. The control timer stays on as a floor: a timer tick
+     * less than half a period after a triggered one is left out for this
+     * module, so the rate follows telemetry while it flows and never drops
+     * below the control loop rate.
+     *
+     * Triggers apply to the paired peer while no team peers are driven,
+     * TDMA slots are off, the loop is not degraded and neither a replay
+     * nor the serial bridge supplies the commands. Read on every packet
+     * (RxTask).
+     *
+     * @return ControlSchedule::Timer (default) or ControlSchedule::OnTelemetry
+     */
+    virtual ControlSchedule getControlSchedule() const { return ControlSchedule::Timer; }
+
+    /**
+     * @brief Whether telemetry type `typeIndex` triggers a control tick
+     *
+     * Only asked with ControlSchedule::OnTelemetry (RxTask).
+     *
+     * @param typeIndex Telemetry packet type index
+     * @return true for every type by default
+     */
+    virtual bool triggersControl(size_t typeIndex) const { return true; }
+
     /**
      * @brief Module has custom command processor
      *
@@ -564,6 +825,17 @@ public:
      */
     virtual void handleCommand(const char* command) {}
 
+    /**
+     * @brief Terminal commands of this module (see CommandTable.h)
+     *
+     * Terminal lines are looked up here first, then among the console
+     * commands; only lines neither knows reach handleCommand(). The
+     * names are offered as completions in the terminal prompt.
+     *
+     * @return Table that lives as long as the module, or nullptr
+     */
+    virtual const CommandTable* getCommandTable() const { return nullptr; }
+
     /**
      * @brief Send custom command to paired device
      *
@@ -591,6 +863,29 @@ protected:
      */
     PreferencesManager& getPreferences();
 
+    /**
+     * @brief Get reference to the cached settings store
+     *
+     * Prefer this over getPreferences() for values edited from menus or the
+     * encoder: edits stay in RAM and are committed in batches.
+     * @return SettingsStore instance
+     */
+    SettingsStore& getSettings();
+
+    /**
+     * @brief Mark the config struct as changed
+     *
+     * Saved by the framework within a few seconds, on module switch and
+     * before an OTA update, so repeated edits cost one flash write.
+     */
+    void markConfigDirty();
+
+    /**
+     * @brief Save the config struct now
+     * @return true if stored (or the stored copy was already identical)
+     */
+    bool saveConfig();
+
     /**
      * @brief Get reference to Logger (connection log)
      * @return Logger instance
@@ -615,6 +910,39 @@ protected:
      */
     uint32_t getTimeSinceLastTelemetry() const;
 
+    /**
+     * @brief Get time since the last packet of one telemetry type
+     *
+     * Tracked per type for the active module only; other modules (team
+     * peers) get getTimeSinceLastTelemetry().
+     *
+     * @return Milliseconds since the last packet (UINT32_MAX if never received)
+     */
+    uint32_t getTelemetryAgeMs(size_t typeIndex) const;
+
+    /**
+     * @brief Average arrival rate of one telemetry type
+     * @return Packets per second (0 while stale or not yet measured)
+     */
+    float getTelemetryRateHz(size_t typeIndex) const;
+
+    /**
+     * @brief Check whether one telemetry type has gone silent
+     *
+     * Uses the descriptor's staleAfterMs (see PacketDescriptor).
+     * @return true if stale or never received
+     */
+    bool isTelemetryStale(size_t typeIndex) const;
+
+    /**
+     * @brief When the packet being handled was sampled, in controller micros()
+     *
+     * Valid inside handleTelemetry() only. Packets with a timestampOffset are
+     * placed by their robot timestamp once ClockSync is synced; otherwise
+     * this is the arrival time, radio jitter included.
+     */
+    uint32_t getTelemetrySampleUs() const;
+
     /**
      * @brief Virtual destructor for proper cleanup
      */
@@ -630,5 +958,8 @@ private:
     bool initialized_ = false;
     bool paired_ = false;
     bool active_ = false;
+    bool configLoaded_ = false;
+    volatile bool configDirty_ = false;
     uint32_t lastTelemetryTime_ = 0;
+    bool generatedDashboard_ = false;   ///< Default drawDashboard() ran: use AutoDashboard
 };
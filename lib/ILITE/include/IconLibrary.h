@@ -18,6 +18,15 @@
  * canvas.drawIcon(0, 0, ICON_MY_DRONE);
  * ```
  *
+ * Icons are stored twice: the registered XBM bitmap (row-major, bit 0 =
+ * leftmost pixel) and a page-major copy in the SH1106 framebuffer layout
+ * (one byte per column per 8-row page, bit 0 = top pixel). The built-in set
+ * converts at compile time and, records included, lives in flash: it is
+ * registered by address with registerTable(). Icons registered at run time
+ * are copied to the heap and converted once on registration. DisplayCanvas::drawIconBitmap() copies
+ * the page bytes straight into the framebuffer instead of plotting every
+ * pixel through U8G2.
+ *
  * @author ILITE Framework
  * @version 1.0.0
  */
@@ -39,8 +48,33 @@ struct Icon {
     uint8_t width;           ///< Width in pixels (8, 16, or 32)
     uint8_t height;          ///< Height in pixels (8, 16, or 32)
     const uint8_t* data;     ///< Bitmap data (1 bit per pixel, row-major)
+    const uint8_t* pages;    ///< Page-major copy (width bytes per 8-row page), filled by registerIcon()
 };
 
+// ============================================================================
+// Page Conversion
+// ============================================================================
+
+/**
+ * @brief One page byte of an 8-row XBM bitmap (bit 0 = top row)
+ *
+ * `rows` points at 8 XBM rows of `stride` bytes each; `col` is the pixel
+ * column. Usable in constant expressions, so built-in icon tables can be
+ * converted at compile time.
+ */
+constexpr uint8_t iconPageByte(const uint8_t* rows, uint8_t stride, uint8_t col, uint8_t row = 0) {
+    return row >= 8 ? 0
+        : static_cast<uint8_t>((((rows[row * stride + (col >> 3)] >> (col & 7)) & 1) << row) |
+                               iconPageByte(rows, stride, col, row + 1));
+}
+
+/// Page-major initializer for an 8x8 XBM array
+#define ICON_PAGES_8X8(xbm) { \
+    iconPageByte(xbm, 1, 0), iconPageByte(xbm, 1, 1), \
+    iconPageByte(xbm, 1, 2), iconPageByte(xbm, 1, 3), \
+    iconPageByte(xbm, 1, 4), iconPageByte(xbm, 1, 5), \
+    iconPageByte(xbm, 1, 6), iconPageByte(xbm, 1, 7) }
+
 /**
  * @brief Icon Library - Manages bitmap icons
  */
@@ -52,6 +86,18 @@ public:
      */
     static void registerIcon(const Icon& icon);
 
+    /**
+     * @brief Register a static table of icons by address
+     *
+     * Records with pages set are not copied, so a `constexpr` table stays
+     * in flash and must outlive the library; records without pages are
+     * registered with registerIcon().
+     *
+     * @param icons First icon
+     * @param count Number of icons
+     */
+    static void registerTable(const Icon* icons, size_t count);
+
     /**
      * @brief Get icon by ID
      * @param id Icon ID (e.g., "icon_drone")
@@ -59,6 +105,30 @@ public:
      */
     static const Icon* getIcon(IconID id);
 
+    /**
+     * @brief Index of an icon, for repeated O(1) access through getIconAt()
+     * @param id Icon ID
+     * @return Index, or -1 if not found
+     */
+    static int16_t indexOf(IconID id);
+
+    /**
+     * @brief Get icon by index (see indexOf())
+     * @return Pointer to icon, or nullptr if out of range
+     */
+    static const Icon* getIconAt(int16_t index);
+
+    /**
+     * @brief Page-converted wrapper for an unregistered XBM bitmap
+     *
+     * Converts on first use and caches by data pointer, so `xbm` must stay
+     * valid (module logos in flash). Used for the 32x32 module logos. The
+     * returned pointer is valid until the next getBitmap() or clear() call.
+     *
+     * @return Icon with pages set, or nullptr if out of memory
+     */
+    static const Icon* getBitmap(const uint8_t* xbm, uint8_t width, uint8_t height);
+
     /**
      * @brief Check if icon exists
      * @param id Icon ID
@@ -68,9 +138,9 @@ public:
 
     /**
      * @brief Get all registered icons
-     * @return Vector of icons
+     * @return Icons in registration order (getIconAt() indices)
      */
-    static std::vector<Icon>& getIcons();
+    static const std::vector<const Icon*>& getIcons();
 
     /**
      * @brief Clear all icons
@@ -86,7 +156,17 @@ public:
     static void initBuiltInIcons();
 
 private:
-    static std::vector<Icon> icons_;
+    static constexpr size_t kIndexSlots = 128;  ///< Open-addressed ID table (power of 2)
+
+    static uint32_t hashId(IconID id);
+    static const uint8_t* convertPages(const uint8_t* xbm, uint8_t width, uint8_t height);
+    static void indexIcon(size_t i);
+
+    static std::vector<const Icon*> icons_;       ///< Flash table records and heap copies
+    static std::vector<Icon*> copies_;            ///< registerIcon() copies (RAM overlay)
+    static std::vector<Icon> bitmaps_;            ///< getBitmap() cache
+    static std::vector<const uint8_t*> owned_;    ///< Pages allocated by convertPages()
+    static uint16_t index_[kIndexSlots];          ///< icons_ index + 1 per hash slot, 0 = empty
 };
 
 // ============================================================================
@@ -167,7 +247,8 @@ private:
                     id, \
                     w, \
                     h, \
-                    g_iconData_##id \
+                    g_iconData_##id, \
+                    nullptr \
                 }); \
             } \
         }; \
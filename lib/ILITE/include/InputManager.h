@@ -10,9 +10,12 @@
  *
  * Features:
  * - Automatic center calibration
+ * - Stored per-axis calibration tables (min/center/max and a 16-point curve)
  * - Adjustable deadzone
  * - Low-pass filtering
+ * - Background ADC DMA sampling with oversampling (see AdcSampler)
  * - Edge detection (pressed/released)
+ * - Per-tick immutable InputSnapshot (getters never touch hardware)
  * - Thread-safe for FreeRTOS
  *
  * @author ILITE Team
@@ -21,6 +24,73 @@
 
 #pragma once
 #include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include "AdcSampler.h"
+#include "ButtonSampler.h"
+
+/**
+ * @brief Immutable view of every input, captured once per update()
+ *
+ * Buttons come from ButtonSampler (levels plus the edges since the previous
+ * capture) and all analog channels from one AdcSampler latch, so every field
+ * describes the same instant. `sequence` increments on every capture.
+ */
+struct InputSnapshot {
+    /// Bits in `buttons` / `pressed`
+    enum Button : uint8_t {
+        BUTTON_1       = ButtonSampler::BUTTON_1,
+        BUTTON_2       = ButtonSampler::BUTTON_2,
+        BUTTON_3       = ButtonSampler::BUTTON_3,
+        JOY_BUTTON_A   = ButtonSampler::JOY_BUTTON_A,
+        JOY_BUTTON_B   = ButtonSampler::JOY_BUTTON_B,
+        ENCODER_BUTTON = ButtonSampler::ENCODER_BUTTON
+    };
+
+    uint32_t sequence;                          ///< Capture counter (0 = never captured)
+    uint32_t timestampUs;                       ///< micros() at capture
+    uint16_t raw[AdcSampler::CHANNEL_COUNT];    ///< Latched ADC values (AdcSampler::Channel order)
+    float joystickA_X;                          ///< Calibrated -1.0 to +1.0
+    float joystickA_Y;
+    float joystickB_X;
+    float joystickB_Y;
+    float potentiometer;                        ///< 0.0 to 1.0
+    uint8_t buttons;                            ///< Raw levels, bit set = pressed
+    uint8_t debounced;                          ///< Debounced levels, bit set = pressed
+    uint8_t pressed;                            ///< Debounced rising edges since the previous capture
+    int encoderCount;                           ///< Absolute encoder count at capture
+};
+
+/**
+ * @brief Stored calibration of one joystick axis (one SettingsStore value)
+ *
+ * `curve` holds the output, in Q15 (32767 = full deflection), at eight raw
+ * positions evenly spaced from `center` towards `min` (curve[0..7]) and
+ * eight towards `max` (curve[8..15]); the last point of each side is full
+ * deflection. A straight stick has curve[i] = (i % 8 + 1) * 32767 / 8.
+ * JoystickCalibrator records these; a zeroed value (version 0) means the
+ * axis has no table and auto-centers.
+ */
+struct AxisCalibration {
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kSidePoints = 8;
+    static constexpr size_t kCurvePoints = 2 * kSidePoints;
+    static constexpr int16_t kMinHalfSpan = 256;    ///< Raw counts from center to either end
+    static constexpr uint16_t kFullScale = 32767;
+
+    uint8_t version;
+    uint8_t reserved;
+    int16_t min;
+    int16_t center;
+    int16_t max;
+    uint16_t curve[kCurvePoints];
+
+    /// Usable: current version, both sides wide enough, curves rising to full scale
+    bool isValid() const;
+
+    /// Fill `curve` with a straight line on both sides
+    void setLinear();
+};
 
 /**
  * @brief Manages all controller input devices
@@ -50,9 +120,21 @@
  * ```cpp
  * inputs.recalibrateJoysticks();  // Center sticks first!
  * ```
+ * An axis with a stored AxisCalibration (Settings > Controls > Calibrate
+ * Sticks, see JoystickCalibrator) instead maps through its table: a
+ * fixed-point piecewise-linear lookup of the raw value, with separate
+ * spans on either side of center and no center drift. Deadzone,
+ * sensitivity and filtering apply to both paths.
+ *
+ * ## Snapshots
+ * update() captures one InputSnapshot per control tick. Every const getter
+ * reads that snapshot, so querying the same input twice inside
+ * updateControl() always returns the same value and costs no hardware access.
+ * Use getSequence() to detect a new capture.
  *
  * ## Thread Safety
- * Reading methods are thread-safe (called from multiple FreeRTOS tasks).
+ * update() has a single writer (CommTask). Snapshots are double-buffered, so
+ * reading methods are safe from any FreeRTOS task.
  * Configuration methods should only be called from setup() or main loop.
  */
 class InputManager {
@@ -143,13 +225,16 @@ public:
     uint16_t getPotentiometer_Raw() const;
 
     /**
-     * @brief Get battery voltage (after voltage divider correction)
+     * @brief Get battery voltage of this tick (calibrated, divider corrected)
+     *
+     * Unfiltered; displays should use BatteryMonitor's published values.
+     *
      * @return Voltage in volts
      */
     float getBatteryVoltage() const;
 
     /**
-     * @brief Get battery percentage (Li-Po curve)
+     * @brief Get battery percentage of this tick (Li-Po curve, unfiltered)
      * @return Percentage 0-100
      */
     uint8_t getBatteryPercent() const;
@@ -244,6 +329,26 @@ public:
      */
     bool getEncoderButtonPressed() const;
 
+    // ========================================================================
+    // Snapshot
+    // ========================================================================
+
+    /**
+     * @brief Copy of the most recent input capture
+     * @return Snapshot taken by the last update()
+     */
+    InputSnapshot getSnapshot() const;
+
+    /**
+     * @brief Sequence number of the most recent capture
+     *
+     * Increments once per update(). Cheap change detection for callers that
+     * run at a different rate than the control loop.
+     *
+     * @return Capture counter (0 before the first update)
+     */
+    uint32_t getSequence() const;
+
     // ========================================================================
     // Encoder
     // ========================================================================
@@ -252,7 +357,8 @@ public:
      * @brief Get encoder rotation delta since last call
      *
      * Positive = clockwise, negative = counterclockwise.
-     * Resets to 0 after reading (non-accumulating).
+     * Measured against the current snapshot; resets to 0 after reading
+     * (non-accumulating).
      *
      * @return Rotation delta (+/- N detents)
      */
@@ -306,10 +412,39 @@ public:
      * @brief Recalibrate joystick center points
      *
      * Call when joysticks are centered. Updates center point for all axes.
-     * Useful if joysticks drift over time or controller is moved.
+     * Useful if joysticks drift over time or controller is moved. Axes with
+     * a calibration table keep their curve around the new center until the
+     * next boot (the stored table is not changed).
      */
     void recalibrateJoysticks();
 
+    /**
+     * @brief Load the stored calibration tables (framework, after SettingsStore)
+     */
+    void loadJoystickCalibration();
+
+    /**
+     * @brief Store and apply a calibration table for one axis
+     *
+     * Takes effect on the next update() and is written to flash by the
+     * SettingsStore commit task.
+     *
+     * @param axis AdcSampler::JOY_A_X to JOY_B_Y
+     * @return false if the axis or the table is invalid
+     */
+    bool setJoystickCalibration(AdcSampler::Channel axis, const AxisCalibration& calibration);
+
+    /**
+     * @brief Get the stored table of one axis
+     * @return false if the axis has none (it auto-centers)
+     */
+    bool getJoystickCalibration(AdcSampler::Channel axis, AxisCalibration& out) const;
+
+    /**
+     * @brief Remove the tables of all axes and return to auto-centering
+     */
+    void clearJoystickCalibration();
+
     /**
      * @brief Enable/disable low-pass filtering on joysticks
      *
@@ -338,13 +473,25 @@ public:
     void begin();
 
     /**
-     * @brief Update input state (called each loop)
+     * @brief Capture a new InputSnapshot (called each control tick)
      *
-     * Called by framework in main loop to update button edge detection
-     * and encoder delta calculation. Should not be called by user code.
+     * Called by the framework from CommTask before updateControl(). Latches
+     * the oversampled analog values from AdcSampler, takes the debounced
+     * button levels and press edges from ButtonSampler, runs joystick
+     * calibration, then publishes the result. Should not be called by user
+     * code.
      */
     void update();
 
+    /**
+     * @brief Publish a recorded snapshot instead of capturing one
+     *
+     * Called by CommTask in place of update() while InputReplay runs. The
+     * sequence continues from the live captures and timestampUs is the
+     * current time; every other field is taken as recorded.
+     */
+    void replay(const InputSnapshot& recorded);
+
 private:
     InputManager();  // Private constructor (singleton)
     InputManager(const InputManager&) = delete;
@@ -354,11 +501,21 @@ private:
     // Internal State
     // ========================================================================
 
+    // Fixed-point form of an AxisCalibration ([0] towards min, [1] towards max)
+    struct AxisLut {
+        bool valid;
+        int16_t center;
+        uint16_t halfSpan[2];                               // Raw counts to each end
+        uint32_t scale[2];                                  // Q16 segments per raw count
+        uint16_t knots[2][AxisCalibration::kSidePoints + 1];  // Q15 output, knots[s][0] = 0
+    };
+
     // Joystick calibration data
     struct JoystickCalibration {
         int16_t center;           // Center point (typically ~2048)
         bool initialized;         // Whether center has been calibrated
         float filtered;           // Filtered output value
+        AxisLut lut;              // Stored table (CommTask copy)
     };
 
     JoystickCalibration joyA_X_;
@@ -366,27 +523,29 @@ private:
     JoystickCalibration joyB_X_;
     JoystickCalibration joyB_Y_;
 
-    // Button edge detection
-    struct ButtonState {
-        bool current;             // Current state (true = pressed)
-        bool previous;            // Previous frame state
-        uint32_t lastChangeTime;  // For debouncing
-    };
+    // Button edges seen by update() (debouncing lives in ButtonSampler)
+    ButtonSampler::Cursor buttonCursor_;
+    volatile uint32_t encoderBtnIsrMs_;     // Legacy encoderBtnState ISR lockout
 
-    ButtonState button1_;
-    ButtonState button2_;
-    ButtonState button3_;
-    ButtonState joyBtnA_;
-    ButtonState joyBtnB_;
-    ButtonState encoderBtn_;
+    // Double-buffered snapshots; readers use snapshots_[published_]
+    InputSnapshot snapshots_[2];
+    std::atomic<uint8_t> published_;
 
     // Encoder state
-    int encoderCount_;            // Absolute count
     int lastEncoderCount_;        // Last read count (for delta)
 
+    // Calibration tables; setters queue a LUT, update() takes it
+    static constexpr uint8_t kJoystickAxes = 4;
+    AxisCalibration calibrations_[kJoystickAxes];   // Guarded by lutLock_
+    AxisLut pendingLuts_[kJoystickAxes];            // Guarded by lutLock_
+    std::atomic<uint8_t> pendingLutMask_;
+    mutable portMUX_TYPE lutLock_;
+
     // Configuration
     float deadzone_;              // Deadzone radius (0.0 to 1.0)
     float sensitivity_;           // Sensitivity multiplier
+    int32_t deadzoneQ15_;         // deadzone_ for the table path
+    int32_t sensitivityQ8_;       // sensitivity_ for the table path
     bool filteringEnabled_;       // Whether to apply low-pass filter
 
     // Constants
@@ -396,6 +555,11 @@ private:
     static constexpr float kFilterAlpha = 0.2f;  // IIR filter coefficient
 
     // Helper methods
-    float readJoystickAxis(uint8_t pin, JoystickCalibration& cal) const;
-    void updateButtonState(ButtonState& state, uint8_t pin);
+    const InputSnapshot& current() const;
+    float readJoystickAxis(uint16_t raw, JoystickCalibration& cal);
+    float readTableAxis(uint16_t raw, JoystickCalibration& cal);
+    JoystickCalibration* joystickAxis(uint8_t axis);
+    void queueLut(uint8_t axis, const AxisCalibration& calibration, int16_t center);
+    void takePendingLuts();
+    void latchAnalogInputs(uint16_t out[AdcSampler::CHANNEL_COUNT]);
 };
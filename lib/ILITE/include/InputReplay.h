@@ -0,0 +1,147 @@
+/**
+ * @file InputReplay.h
+ * @brief Replays a TelemetryTap recording through CommTask and checks the commands
+ *
+ * With the tap on, CommTask records every InputSnapshot next to the RX and
+ * TX packets it already mirrors. A capture of a real session then holds
+ * everything module updateControl() code saw and everything it produced,
+ * all timestamped.
+ *
+ * "replay" on the console switches the port to receive that capture back.
+ * The same COBS frames are sent by a host pacing them at the recorded rate
+ * (tools/tap_replay.py). While it runs:
+ *
+ * - Each CommTask tick takes the next recorded snapshot instead of reading
+ *   the hardware. dt is the recorded one. A tick with no snapshot queued
+ *   yet is held, so a slow host stalls the replay instead of skewing it.
+ * - Telemetry recorded before that snapshot is routed to the module first,
+ *   as it was during the session.
+ * - Each command packet the module produces is compared with the recorded
+ *   one (type, length and CRC). Without a paired robot the packets are
+ *   compared but not sent.
+ * - The time from snapshot to command packet is collected per tick, so a
+ *   slower updateControl() shows up as a latency regression.
+ *
+ * A summary prints when the host sends the end frame or goes quiet for
+ * kIdleTimeoutMs. "replay stats" prints it again.
+ *
+ * Only what modules read through InputManager is replayed. Menu navigation
+ * (ButtonEventEngine and the encoder ISR count) still follows the hardware,
+ * so leave the controller alone during a replay. Recordings should start
+ * right after pairing: the change-only command cache begins empty on both
+ * sides then. Modules that put clocks or random values into their packets
+ * will report mismatches.
+ *
+ * ## Thread Safety:
+ * start(), feed() and service() run on ServiceTask. nextTick() and
+ * onCommand() run on CommTask. Each statistic has a single writer, so a
+ * dump may show a tick in progress.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_INPUT_REPLAY_H
+#define ILITE_INPUT_REPLAY_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "InputManager.h"
+
+static constexpr size_t kReplayLatencyBuckets = 8;
+
+/**
+ * @brief Outcome of the current or last replay
+ */
+struct InputReplayStats {
+    uint32_t ticks = 0;             ///< Snapshots replayed
+    uint32_t stalls = 0;            ///< Ticks held waiting for the host
+    uint32_t telemetry = 0;         ///< Recorded telemetry packets routed
+    uint32_t matched = 0;           ///< Commands identical to the recording
+    uint32_t mismatched = 0;        ///< Same type, different bytes
+    uint32_t missing = 0;           ///< Recorded commands not produced
+    uint32_t extra = 0;             ///< Commands produced but not recorded
+    uint32_t firstMismatchTick = 0; ///< Tick of the first difference (0 = none)
+    uint32_t badFrames = 0;         ///< COBS/CRC/format errors on the console
+    uint32_t overflows = 0;         ///< Frames lost on a full queue (host too fast)
+    uint32_t recordingGaps = 0;     ///< Records the tap dropped while recording
+    uint32_t minUs = 0;             ///< Snapshot -> first command of the tick
+    uint32_t maxUs = 0;
+    uint32_t avgUs = 0;             ///< Mean over the replay
+    uint32_t histogram[kReplayLatencyBuckets] = {};
+};
+
+/**
+ * @class InputReplay
+ * @brief Static replay session
+ */
+class InputReplay {
+public:
+    static constexpr uint8_t kFormatVersion = 1;        ///< Body byte 0 of an input record
+    static constexpr size_t kSnapshotSize =
+        AdcSampler::CHANNEL_COUNT * 2 + 5 * 4 + 3 + 4;  ///< Encoded InputSnapshot
+    static constexpr size_t kQueueSize = 32;            ///< Frames buffered from the host
+    static constexpr uint32_t kIdleTimeoutMs = 2000;
+
+    /// Upper bound (us) of each latency bucket; the last is open-ended
+    static const uint32_t kBucketUs[kReplayLatencyBuckets];
+
+    /**
+     * @brief Serialize the fields modules read (little-endian, kSnapshotSize bytes)
+     *
+     * raw[] u16 each, joysticks A X/Y and B X/Y and the potentiometer as
+     * float bits, buttons, debounced, pressed, encoderCount i32.
+     */
+    static void encodeSnapshot(const InputSnapshot& snapshot, uint8_t* out);
+
+    /// Inverse of encodeSnapshot(); sequence and timestampUs are left 0
+    static bool decodeSnapshot(const uint8_t* data, size_t length, InputSnapshot& out);
+
+    // ========================================================================
+    // ServiceTask
+    // ========================================================================
+
+    /// Start receiving a recording on the console (allocates the queue once)
+    static bool start();
+
+    /// One console byte while isReceiving()
+    static void feed(uint8_t byte);
+
+    /// Idle timeout and the final report
+    static void service(uint32_t nowMs);
+
+    /// Console bytes belong to the replay stream
+    static bool isReceiving() { return receiving_.load(std::memory_order_relaxed); }
+
+    // ========================================================================
+    // CommTask
+    // ========================================================================
+
+    /// CommTask replays instead of sampling
+    static bool isActive() { return active_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Take this tick's snapshot
+     *
+     * Routes the telemetry and checks the commands recorded since the
+     * previous snapshot.
+     *
+     * @param out Recorded snapshot, encoder rebased onto the live count
+     * @param dtSeconds Recorded time since the previous snapshot (0 on the first)
+     * @return false to hold the tick (nothing queued, or the replay ended)
+     */
+    static bool nextTick(InputSnapshot& out, float& dtSeconds);
+
+    /// A command packet of the active module is ready (`inputUs` = snapshot time)
+    static void onCommand(uint8_t typeIndex, const uint8_t* data, size_t length, uint32_t inputUs);
+
+    static const InputReplayStats& getStats() { return stats_; }
+    static void dump(Print& out);
+
+private:
+    static std::atomic<bool> receiving_;
+    static std::atomic<bool> active_;
+    static InputReplayStats stats_;
+};
+
+#endif // ILITE_INPUT_REPLAY_H
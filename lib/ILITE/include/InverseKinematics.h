@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include "Kinematics.h"
+#include "Collision.h"
 
 /**
  * @file InverseKinematics.h
@@ -27,21 +29,17 @@
  *
  * These conventions map directly to the user requirements, and can be adapted
  * through configuration offsets if future hardware revisions require it.
+ *
+ * The trigonometry runs through Kinematics::solveTwoLink. Define
+ * ILITE_KINEMATICS_Q16 to solve in 16.16 fixed point instead of float.
  */
 
 namespace IKEngine {
 
 /**
- * Simple 3D vector expressed in millimetres.
+ * Simple 3D vector expressed in millimetres (shared with Kinematics.h).
  */
-struct Vec3 {
-    float x = 0.0f;
-    float y = 0.0f;
-    float z = 0.0f;
-
-    constexpr Vec3() = default;
-    constexpr Vec3(float xIn, float yIn, float zIn) : x(xIn), y(yIn), z(zIn) {}
-};
+typedef Kinematics::Vec3T<float> Vec3;
 
 /**
  * Range helper for rotational joints (degrees).
@@ -74,6 +72,7 @@ struct ArmDimensions {
     float yawToPitchOffsetMm = 0.0f;
     float pitchToRollOffsetMm = 0.0f;
     float rollToEffectorOffsetMm = 0.0f;
+    float gripperLengthMm = 60.0f;   ///< Wrist centre to jaw tips, for collision checks.
 
     /**
      * @return Total wrist chain length from the yaw joint to the tool tip.
@@ -126,6 +125,26 @@ struct IKSolution {
     bool constrained = false;     ///< True if any joint had to be clamped to limits.
 };
 
+/**
+ * Sine/cosine of the shoulder and elbow angles, when the caller has them.
+ */
+struct JointTrig {
+    float sinShoulder = 0.0f;
+    float cosShoulder = 1.0f;
+    float sinElbow = 0.0f;
+    float cosElbow = 1.0f;
+};
+
+/**
+ * Joint positions in the arm plane (x = horizontal from the shoulder pivot,
+ * y = vertical, z = 0), in millimetres.
+ */
+struct ArmPose {
+    Vec3 elbow{};           ///< End of the shoulder link.
+    Vec3 extensionBase{};   ///< End of the rigid forearm, where the extension starts.
+    Vec3 wrist{};           ///< Wrist centre at the tip of the extension.
+};
+
 /**
  * Inverse kinematics solver for the ILITE arm.
  */
@@ -138,6 +157,12 @@ public:
     void setExtensionEnabled(bool enabled);
     bool isExtensionEnabled() const;
 
+    /// Bumped whenever the configuration or extension mode changes
+    uint32_t getRevision() const { return revision_; }
+
+    /// Extension actually applied for a requested one (0 when disabled)
+    float clampExtension(float extensionMm) const;
+
     /**
      * Planar solve for a horizontal/vertical target using a caller supplied
      * forearm extension.
@@ -162,6 +187,42 @@ public:
         return solvePlanar(planarTarget.x, planarTarget.y, extensionOverrideMm, outSolution);
     }
 
+    /**
+     * Clamp shoulder/elbow to their limits and fill the rest of a solution
+     * (forward positions, wrist defaults). Shared by solvePlanar() and
+     * IncrementalSolver so both report identical solutions.
+     *
+     * @param trig Optional precomputed sin/cos of the unclamped angles; used
+     *             only when no clamping was needed.
+     * @return true if nothing had to be clamped and `constrained` was false.
+     */
+    bool completeSolution(float shoulderDeg,
+                          float elbowDeg,
+                          float extensionMm,
+                          float distanceMm,
+                          bool constrained,
+                          IKSolution& outSolution,
+                          const JointTrig* trig = nullptr) const;
+
+    /**
+     * Forward kinematics from the configured link lengths.
+     *
+     * @param extensionMm Extension as reported by the arm; not clamped, so a
+     *                    pose read back from hardware is drawn as it is.
+     */
+    ArmPose forwardPlanar(float shoulderDeg, float elbowDeg, float extensionMm) const;
+
+    /// Joints collisionChain() writes: shoulder pivot, elbow, wrist, jaw tips
+    static constexpr size_t kCollisionJoints = 4;
+
+    /**
+     * Joint chain of a pose for Kinematics::CollisionScene, in the solver
+     * frame with the shoulder pivot at the origin. Links: 0 upper arm,
+     * 1 forearm with its extension, 2 gripper (taken along the forearm,
+     * like the toolDirection solvePlanar() reports).
+     */
+    void collisionChain(const ArmPose& pose, float baseYawDeg, Vec3 out[kCollisionJoints]) const;
+
     /**
      * Normalises a vector. Returns {1,0,0} when magnitude falls below epsilon.
      */
@@ -170,7 +231,104 @@ public:
 private:
     IKConfiguration config_;
     bool extensionEnabled_ = true;
+    uint32_t revision_ = 0;
 
 };
 
+/**
+ * Memoizing, incremental front-end for InverseKinematics::solvePlanar.
+ *
+ * Joystick jogging moves the target by a few millimetres per tick, or not
+ * at all while the sticks rest in the deadzone. solvePlanar() returns the
+ * cached solution when target, extension and solver revision are
+ * unchanged. For small moves from a reachable solution it takes a Jacobian
+ * step plus one chord correction from the cached joint angles, updating
+ * their sin/cos by angle addition instead of calling trig, and checks the
+ * result with forward kinematics. It falls back to the closed-form solve
+ * for large jumps, near straight/folded singularities, at joint limits, or
+ * when the result misses by more than kToleranceMm.
+ */
+class IncrementalSolver {
+public:
+    static constexpr float kMaxStepMm = 8.0f;       ///< Larger moves take the full solve
+    static constexpr float kMaxStepRad = 0.1f;      ///< Larger joint steps take the full solve
+    static constexpr float kToleranceMm = 0.05f;    ///< Accepted forward-kinematics residual
+    static constexpr float kMinElbowSin = 0.1f;     ///< |sin(elbow)| below this is near-singular
+
+    struct Stats {
+        uint32_t cacheHits = 0;
+        uint32_t incremental = 0;
+        uint32_t fullSolves = 0;
+    };
+
+    explicit IncrementalSolver(const InverseKinematics& solver);
+
+    /// Same contract as InverseKinematics::solvePlanar(const Vec3&, ...)
+    bool solvePlanar(const Vec3& planarTarget,
+                     float extensionOverrideMm,
+                     IKSolution& outSolution);
+
+    /// Force the next call to run the closed-form solve
+    void invalidate() { valid_ = false; }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    bool tryIncremental(const Vec3& planarTarget, float extensionMm, IKSolution& outSolution);
+    void remember(const Vec3& planarTarget, float extensionMm, float shoulderRad, float elbowRad,
+                  const JointTrig& trig, const IKSolution& solution, bool result);
+
+    const InverseKinematics& solver_;
+    Stats stats_;
+    IKSolution cached_;
+    JointTrig trig_;
+    Vec3 target_;
+    float extensionMm_ = 0.0f;
+    float shoulderRad_ = 0.0f;
+    float elbowRad_ = 0.0f;
+    uint32_t revision_ = 0;
+    bool result_ = false;
+    bool valid_ = false;
+};
+
+/**
+ * Memoized forward kinematics for reported joint states.
+ *
+ * Arm-state telemetry repeats the same servo angles while the arm rests.
+ * update() quantizes the joints to kQuantumDeg / kQuantumMm and only runs
+ * forwardPlanar() when a quantized joint or the solver revision changed.
+ */
+class ForwardCache {
+public:
+    static constexpr float kQuantumDeg = 0.1f;
+    static constexpr float kQuantumMm = 0.1f;
+
+    struct Stats {
+        uint32_t hits = 0;
+        uint32_t updates = 0;
+    };
+
+    explicit ForwardCache(const InverseKinematics& solver);
+
+    /// @return true if pose() was recomputed
+    bool update(float shoulderDeg, float elbowDeg, float extensionMm);
+
+    /// Pose of the last update(); all zero before the first
+    const ArmPose& pose() const { return pose_; }
+
+    void invalidate() { valid_ = false; }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    const InverseKinematics& solver_;
+    Stats stats_;
+    ArmPose pose_;
+    int32_t shoulderKey_ = 0;
+    int32_t elbowKey_ = 0;
+    int32_t extensionKey_ = 0;
+    uint32_t revision_ = 0;
+    bool valid_ = false;
+};
+
 } // namespace IKEngine
@@ -0,0 +1,150 @@
+/**
+ * @file JobQueue.h
+ * @brief Prioritized background jobs on a low-priority worker task
+ *
+ * Spectrum frames, map generation, thumbnails and other non-real-time
+ * work used to be stepped from ServiceTask or a module callback, sharing
+ * their period and timing. JobQueue runs them on one worker task at the
+ * bottom priority, pinned by the TaskProfile to the core CommTask is not
+ * on. Every framework task preempts it, so a job can only use CPU those
+ * tasks leave over.
+ *
+ * - **Steps**: a job is a step function called until it returns true.
+ *   Each step should be a bounded piece of work (one FFT stage, a few
+ *   map rows); the worker cannot interrupt a step.
+ * - **Slices**: the worker calls a job's steps for up to its slice
+ *   (kDefaultSliceUs unless given), then sleeps for a tick and picks again.
+ * - **Priorities**: the highest priority job with work left runs next;
+ *   jobs of equal priority take turns slice by slice.
+ * - **Cancellation**: cancel() drops a queued job at once. For a job in
+ *   the middle of a step it waits for the step to end. Once cancel()
+ *   returns, neither the step nor the done callback is called again, so
+ *   the caller may free what the job works on.
+ * - **Stats**: steps, slices, run time, the longest step and queue times
+ *   per job; finished jobs stay listed until their slot is reused. Behind
+ *   "jobs" on the console.
+ *
+ * Without a worker (begin() not called or failed) ServiceTask runs one
+ * slice per tick through runPending().
+ *
+ * ## Usage Example:
+ * ```cpp
+ * spectrumJob_ = JobQueue::submit("fft", JobPriority::Normal,
+ *     [this]() { return spectrum_->step(); },
+ *     JobQueue::kDefaultSliceUs,
+ *     [this]() { publishSpectrum(); });
+ *
+ * // Before freeing spectrum_
+ * JobQueue::cancel(spectrumJob_);
+ * ```
+ *
+ * Safe to call from any task; steps and done callbacks run on the worker.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_JOB_QUEUE_H
+#define ILITE_JOB_QUEUE_H
+
+#include <Arduino.h>
+#include "Delegate.h"
+
+/// Submission handle; 0 is never a job
+typedef uint32_t JobId;
+
+/// Scheduling class, highest first
+enum class JobPriority : uint8_t {
+    High,
+    Normal,
+    Low,
+    Count
+};
+
+enum class JobState : uint8_t {
+    None,           ///< Unknown id, or its slot was reused
+    Queued,         ///< Not started yet
+    Running,        ///< Started; more steps to go
+    Done,
+    Cancelled
+};
+
+/**
+ * @brief Accounting of one job
+ */
+struct JobStats {
+    JobId id = 0;
+    const char* name = nullptr;
+    JobPriority priority = JobPriority::Normal;
+    JobState state = JobState::None;
+    uint32_t sliceUs = 0;
+    uint32_t steps = 0;
+    uint32_t slices = 0;
+    uint32_t runUs = 0;             ///< Time spent in steps
+    uint32_t maxStepUs = 0;
+    uint32_t waitMs = 0;            ///< Submission to first step
+    uint32_t elapsedMs = 0;         ///< Submission to the end (so far while active)
+};
+
+/**
+ * @brief Queue-wide counters
+ */
+struct JobQueueStats {
+    uint32_t submitted = 0;
+    uint32_t completed = 0;
+    uint32_t cancelled = 0;
+    uint32_t rejected = 0;          ///< No free slot
+    uint32_t longSteps = 0;         ///< Steps longer than their job's slice
+};
+
+/**
+ * @class JobQueue
+ * @brief Static job table and worker task
+ */
+class JobQueue {
+public:
+    static constexpr size_t kMaxJobs = 8;
+    static constexpr uint32_t kDefaultSliceUs = 2000;
+    static constexpr uint32_t kStackSize = 4096;
+
+    /// One bounded piece of work; true when the job is finished
+    typedef Delegate<bool()> Step;
+    /// Called on the worker after the last step of a job that was not cancelled
+    typedef Delegate<void()> Done;
+
+    /// Start the worker task
+    static bool begin(BaseType_t core, UBaseType_t priority);
+    static bool hasWorker();
+
+    /**
+     * @brief Queue a job
+     * @param name Static string, for the stats
+     * @return Id for cancel() and getState(), 0 if the table is full
+     */
+    static JobId submit(const char* name, JobPriority priority, Step step,
+                        uint32_t sliceUs = kDefaultSliceUs, Done done = Done());
+
+    /**
+     * @brief Stop a job; waits for a step in progress unless called from that step
+     * @return false if the job had already ended (or the id is unknown)
+     */
+    static bool cancel(JobId id);
+
+    static JobState getState(JobId id);
+    /// Queued or running
+    static bool isActive(JobId id);
+
+    /// One slice of the next job on the calling task, at most budgetUs (no worker)
+    static void runPending(uint32_t budgetUs);
+
+    /// Job table in slot order (state None for a free slot)
+    static JobStats getJob(size_t slot);
+    static JobQueueStats getStats();
+    static void dump(Print& out);
+
+private:
+    static void workerTask(void* parameter);
+    static bool runSlice(uint32_t budgetUs);
+};
+
+#endif // ILITE_JOB_QUEUE_H
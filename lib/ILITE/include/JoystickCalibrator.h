@@ -0,0 +1,120 @@
+/**
+ * @file JoystickCalibrator.h
+ * @brief Guided recording of the per-axis joystick calibration tables
+ *
+ * Auto-centering assumes a stick spans ±2048 counts evenly around its
+ * center. Real sticks stop short on one side and their potentiometers are
+ * not linear, so full deflection reads as 0.8 one way and half travel as
+ * 0.6. The "Calibrate Sticks" screen (Settings > Controls) records, for
+ * all four axes at once:
+ *
+ * - **Center**: the mean of the raw values while both sticks are let go.
+ * - **Ends**: the lowest and highest raw value while the sticks are
+ *   circled along their stops.
+ * - **Curve**: the sticks are swept end to end at an even pace. Each side
+ *   of center is cut into eight equal raw bins and every sample that moved
+ *   at least kMinStep counts since the previous tick is counted in its bin
+ *   (pauses at the stops or at center count for nothing). At an even pace
+ *   the time spent per bin follows the travel it covers, so the running
+ *   share of samples is the deflection at each bin edge: the 16 points of
+ *   the AxisCalibration curve. A side with a bin below kMinBinSamples
+ *   keeps a straight line.
+ *
+ * B2 moves to the next step and, after the sweep, stores the tables
+ * (InputManager::setJoystickCalibration, persisted by SettingsStore); B3
+ * during the sweep stores straight curves with the recorded ends. B1
+ * cancels and keeps the previous tables.
+ *
+ * The samples come from InputManager::update() on every control tick.
+ * While a recording runs the calibrated joystick values read 0, so a
+ * connected robot holds still while the sticks are swept.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * // InputManager::update()
+ * if (JoystickCalibrator::onSample(next.raw)) {
+ *     next.joystickA_X = 0.0f;    // Recording
+ * }
+ *
+ * // Console: print the stored tables
+ * JoystickCalibrator::dump(Serial);
+ * ```
+ *
+ * ## Thread Safety:
+ * onSample() runs on CommTask; the screen handlers on the display task. A
+ * portMUX guards the recording.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_JOYSTICK_CALIBRATOR_H
+#define ILITE_JOYSTICK_CALIBRATOR_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "AdcSampler.h"
+
+/**
+ * @class JoystickCalibrator
+ * @brief Static state machine behind the "framework.joycal" screen
+ */
+class JoystickCalibrator {
+public:
+    static constexpr uint8_t kAxisCount = 4;                ///< AdcSampler::JOY_A_X to JOY_B_Y
+    static constexpr uint16_t kMinCenterSamples = 25;       ///< Ticks averaged for the center
+    static constexpr uint16_t kMinStep = 8;                 ///< Raw counts per tick that count as moving
+    static constexpr uint16_t kMinBinSamples = 3;           ///< Per bin, or the side stays straight
+    static constexpr uint16_t kGoodBinSamples = 12;         ///< Per bin for a full progress bar
+
+    enum class Step : uint8_t {
+        Idle,
+        Center,     ///< Sticks let go
+        Ends,       ///< Sticks circled along the stops
+        Sweep,      ///< Sticks swept end to end
+        Done        ///< Tables stored
+    };
+
+    /// Register the calibration screen (after the built-in menus)
+    static void registerScreen();
+
+    /// Start a recording at the Center step
+    static void start();
+
+    /// Drop the recording; the stored tables stay
+    static void cancel();
+
+    /**
+     * @brief Finish the current step
+     * @return false if it has too little data (see getMessage())
+     */
+    static bool next();
+
+    /// Store straight curves with the recorded ends (Sweep step)
+    static bool storeLinear();
+
+    static Step getStep();
+
+    /// Why the last next() refused, or "" (display task)
+    static const char* getMessage();
+
+    /// One control tick of raw values (CommTask); true while recording
+    static inline bool onSample(const uint16_t raw[AdcSampler::CHANNEL_COUNT]) {
+        if (!recording_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        record(raw);
+        return true;
+    }
+
+    /// Print the stored table of every axis
+    static void dump(Print& out);
+
+private:
+    static void record(const uint16_t raw[AdcSampler::CHANNEL_COUNT]);
+    static bool store(bool linear);
+
+    static std::atomic<bool> recording_;
+};
+
+#endif // ILITE_JOYSTICK_CALIBRATOR_H
@@ -0,0 +1,343 @@
+/**
+ * @file Kinematics.h
+ * @brief Shared arm kinematics math, templated on the scalar type
+ *
+ * One code path for every arm solver: IKEngine::InverseKinematics (TheGill)
+ * and mech::MechArmIK both build on the pieces here instead of calling libm
+ * trig directly.
+ *
+ * - Scalar types: `float`, or `Q16` (signed 16.16 fixed point) for targets
+ *   without an FPU. Every function below is a template over the scalar.
+ * - Fast trig: polynomial sin/cos/atan2/acos using only + - * / and one
+ *   square root. Joint angles from solveTwoLink() stay within 0.005 deg of
+ *   a double-precision solve in float, and within 0.2 deg in Q16 (worst
+ *   near a straight or folded arm), both finer than a hobby servo resolves.
+ * - Vec3T: small vector type shared by the solvers.
+ * - solveTwoLink(): the law-of-cosines core both solvers share.
+ *
+ * Q16 only spans +-32768, so squaring millimetre lengths would overflow.
+ * solveTwoLink() therefore normalises every length by the maximum reach
+ * before squaring; callers pass and receive plain millimetres.
+ *
+ * The header depends only on <stdint.h>/<math.h>, so it also builds on the
+ * host (see examples/KinematicsBenchmark).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_KINEMATICS_H
+#define ILITE_KINEMATICS_H
+
+#include <stdint.h>
+#include <math.h>
+
+namespace Kinematics {
+
+// ============================================================================
+// Q16 fixed point
+// ============================================================================
+
+/**
+ * @brief Signed 16.16 fixed-point number
+ *
+ * Products and quotients go through 64-bit intermediates; division by zero
+ * saturates instead of trapping.
+ */
+struct Q16 {
+    static constexpr int kFracBits = 16;
+    static constexpr int32_t kOne = 1 << kFracBits;
+
+    int32_t raw;
+
+    constexpr Q16() : raw(0) {}
+    constexpr Q16(float value)
+        : raw(static_cast<int32_t>(value * kOne + (value >= 0.0f ? 0.5f : -0.5f))) {}
+    constexpr Q16(int value) : raw(value * kOne) {}
+
+    static constexpr Q16 fromRaw(int32_t raw) { return Q16(raw, 0); }
+    constexpr float toFloat() const { return static_cast<float>(raw) / kOne; }
+
+    constexpr Q16 operator-() const { return fromRaw(-raw); }
+    constexpr Q16 operator+(Q16 other) const { return fromRaw(raw + other.raw); }
+    constexpr Q16 operator-(Q16 other) const { return fromRaw(raw - other.raw); }
+    constexpr Q16 operator*(Q16 other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> kFracBits));
+    }
+    Q16 operator/(Q16 other) const {
+        if (other.raw == 0) {
+            return fromRaw(raw >= 0 ? INT32_MAX : -INT32_MAX);
+        }
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) << kFracBits) / other.raw));
+    }
+
+    Q16& operator+=(Q16 other) { raw += other.raw; return *this; }
+    Q16& operator-=(Q16 other) { raw -= other.raw; return *this; }
+    Q16& operator*=(Q16 other) { return *this = *this * other; }
+    Q16& operator/=(Q16 other) { return *this = *this / other; }
+
+    constexpr bool operator<(Q16 other) const { return raw < other.raw; }
+    constexpr bool operator>(Q16 other) const { return raw > other.raw; }
+    constexpr bool operator<=(Q16 other) const { return raw <= other.raw; }
+    constexpr bool operator>=(Q16 other) const { return raw >= other.raw; }
+    constexpr bool operator==(Q16 other) const { return raw == other.raw; }
+    constexpr bool operator!=(Q16 other) const { return raw != other.raw; }
+
+private:
+    constexpr Q16(int32_t rawValue, int) : raw(rawValue) {}
+};
+
+// ============================================================================
+// Scalar primitives (overloaded per type)
+// ============================================================================
+
+inline float toFloat(float value) { return value; }
+inline float toFloat(Q16 value) { return value.toFloat(); }
+
+inline float sqrtScalar(float value) { return value > 0.0f ? sqrtf(value) : 0.0f; }
+
+inline Q16 sqrtScalar(Q16 value) {
+    if (value.raw <= 0) {
+        return Q16();
+    }
+    // sqrt(raw / 2^16) * 2^16 == sqrt(raw << 16), bit by bit
+    uint64_t remainder = static_cast<uint64_t>(value.raw) << Q16::kFracBits;
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > remainder) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (remainder >= root + bit) {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return Q16::fromRaw(static_cast<int32_t>(root));
+}
+
+template <typename T>
+inline T absScalar(T value) { return value < T(0) ? -value : value; }
+
+template <typename T>
+inline T clampScalar(T value, T minValue, T maxValue) {
+    if (minValue > maxValue) {
+        T swap = minValue;
+        minValue = maxValue;
+        maxValue = swap;
+    }
+    return value < minValue ? minValue : (value > maxValue ? maxValue : value);
+}
+
+template <typename T>
+inline T minScalar(T a, T b) { return a < b ? a : b; }
+
+template <typename T>
+inline T maxScalar(T a, T b) { return a > b ? a : b; }
+
+template <typename T>
+struct Constants {
+    static T pi() { return T(3.14159265f); }
+    static T halfPi() { return T(1.57079633f); }
+    static T twoPi() { return T(6.28318531f); }
+};
+
+// ============================================================================
+// Fast trigonometry
+// ============================================================================
+
+/// sin(x) for any x; 9th-order Taylor on [-pi/2, pi/2], error < 4e-6
+template <typename T>
+T sinFast(T x) {
+    const T pi = Constants<T>::pi();
+    const T twoPi = Constants<T>::twoPi();
+    const T halfPi = Constants<T>::halfPi();
+    // Wrap to [-pi, pi] (float inputs far out of range lose precision anyway)
+    while (x > pi) x -= twoPi;
+    while (x < -pi) x += twoPi;
+    // Fold to [-pi/2, pi/2] using sin(pi - x) = sin(x)
+    if (x > halfPi) {
+        x = pi - x;
+    } else if (x < -halfPi) {
+        x = -pi - x;
+    }
+    const T x2 = x * x;
+    return x * (T(1.0f) + x2 * (T(-1.0f / 6.0f) + x2 * (T(1.0f / 120.0f) +
+           x2 * (T(-1.0f / 5040.0f) + x2 * T(1.0f / 362880.0f)))));
+}
+
+template <typename T>
+T cosFast(T x) {
+    return sinFast(x + Constants<T>::halfPi());
+}
+
+/// atan(z) for |z| <= 1; minimax polynomial, error < 1e-5 rad
+template <typename T>
+T atanUnit(T z) {
+    const T z2 = z * z;
+    return z * (T(0.9998660f) + z2 * (T(-0.3302995f) + z2 * (T(0.1801410f) +
+           z2 * (T(-0.0851330f) + z2 * T(0.0208351f)))));
+}
+
+/// atan2(y, x) in (-pi, pi]; 0 when both are 0
+template <typename T>
+T atan2Fast(T y, T x) {
+    const T ax = absScalar(x);
+    const T ay = absScalar(y);
+    if (ax == T(0) && ay == T(0)) {
+        return T(0);
+    }
+    T angle;
+    if (ax >= ay) {
+        angle = atanUnit(ay / ax);
+    } else {
+        angle = Constants<T>::halfPi() - atanUnit(ax / ay);
+    }
+    if (x < T(0)) {
+        angle = Constants<T>::pi() - angle;
+    }
+    return y < T(0) ? -angle : angle;
+}
+
+/// acos(x), x clamped to [-1, 1]; Abramowitz & Stegun 4.4.45, error < 7e-5 rad
+template <typename T>
+T acosFast(T x) {
+    x = clampScalar(x, T(-1.0f), T(1.0f));
+    const bool negative = x < T(0);
+    const T ax = absScalar(x);
+    T result = sqrtScalar(T(1.0f) - ax) *
+               (T(1.5707288f) + ax * (T(-0.2121144f) + ax * (T(0.0742610f) + ax * T(-0.0187293f))));
+    return negative ? Constants<T>::pi() - result : result;
+}
+
+// ============================================================================
+// Vectors
+// ============================================================================
+
+template <typename T>
+struct Vec3T {
+    T x;
+    T y;
+    T z;
+
+    constexpr Vec3T() : x(0), y(0), z(0) {}
+    constexpr Vec3T(T xIn, T yIn, T zIn) : x(xIn), y(yIn), z(zIn) {}
+
+    Vec3T operator+(const Vec3T& o) const { return Vec3T(x + o.x, y + o.y, z + o.z); }
+    Vec3T operator-(const Vec3T& o) const { return Vec3T(x - o.x, y - o.y, z - o.z); }
+    Vec3T operator*(T s) const { return Vec3T(x * s, y * s, z * s); }
+    Vec3T& operator+=(const Vec3T& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    Vec3T& operator-=(const Vec3T& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    Vec3T& operator*=(T s) { x *= s; y *= s; z *= s; return *this; }
+
+    T dot(const Vec3T& o) const { return x * o.x + y * o.y + z * o.z; }
+    Vec3T cross(const Vec3T& o) const {
+        return Vec3T(y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x);
+    }
+    T magSq() const { return dot(*this); }
+    T magnitude() const { return sqrtScalar(magSq()); }
+
+    /// Unit vector, or `fallback` when shorter than `epsilon`
+    Vec3T normalized(T epsilon, const Vec3T& fallback) const {
+        const T length = magnitude();
+        if (length <= epsilon) {
+            return fallback;
+        }
+        const T inv = T(1.0f) / length;
+        return Vec3T(x * inv, y * inv, z * inv);
+    }
+};
+
+/// Rodrigues rotation of `v` about `axis` (need not be unit length)
+template <typename T>
+Vec3T<T> rotateAroundAxis(const Vec3T<T>& v, const Vec3T<T>& axis, T angle) {
+    const T axisLength = axis.magnitude();
+    if (angle == T(0) || axisLength == T(0)) {
+        return v;
+    }
+    const Vec3T<T> k = axis * (T(1.0f) / axisLength);
+    const T cosA = cosFast(angle);
+    const T sinA = sinFast(angle);
+    return v * cosA + k.cross(v) * sinA + k * (v.dot(k) * (T(1.0f) - cosA));
+}
+
+// ============================================================================
+// Two-link planar solve
+// ============================================================================
+
+/**
+ * @brief Triangle formed by shoulder, elbow and a planar target
+ */
+template <typename T>
+struct TwoLinkResult {
+    T angleToTarget;    ///< atan2(vertical, horizontal) of the target (rad)
+    T shoulderOffset;   ///< Angle between link 1 and the target line (rad)
+    T elbowInterior;    ///< Interior angle between the links, pi = straight (rad)
+    T distance;         ///< Target distance actually solved for (mm)
+    bool distanceClamped;   ///< Target was outside [|L1 - L2|, L1 + L2]
+};
+
+/**
+ * @brief Law-of-cosines solve for two links reaching (horizontal, vertical)
+ *
+ * Lengths are in millimetres. The shoulder angle is
+ * `angleToTarget +- shoulderOffset` depending on the elbow branch.
+ *
+ * @param minDistance Lower bound on the solved distance (keeps the
+ *        triangle non-degenerate)
+ */
+template <typename T>
+TwoLinkResult<T> solveTwoLink(T link1, T link2, T horizontal, T vertical, T minDistance) {
+    TwoLinkResult<T> result;
+
+    // Work in units of total reach so every square stays <= 1 (Q16 range).
+    // Divide rather than multiply by 1/reach: 1/reach has few Q16 bits.
+    T reach = link1 + link2;
+    if (reach <= T(0)) {
+        reach = T(1);
+    }
+    const T l1 = link1 / reach;
+    const T l2 = link2 / reach;
+    const T h = horizontal / reach;
+    const T v = vertical / reach;
+
+    // Targets far outside reach are scaled down first so h*h cannot overflow
+    const T bigSide = maxScalar(absScalar(h), absScalar(v));
+    T distance;
+    if (bigSide > T(2)) {
+        const T hs = h / bigSide;
+        const T vs = v / bigSide;
+        distance = sqrtScalar(hs * hs + vs * vs) * bigSide;
+    } else {
+        distance = sqrtScalar(h * h + v * v);
+    }
+
+    const T reachMin = absScalar(l1 - l2);
+    const T reachMax = l1 + l2;
+    T solved = clampScalar(distance, reachMin, reachMax);
+    result.distanceClamped = absScalar(solved - distance) > T(1e-4f);
+    solved = maxScalar(solved, minDistance / reach);
+
+    result.angleToTarget = atan2Fast(v, h);
+    if (solved >= reachMax) {
+        // Straight arm: acos near -1 would amplify rounding of the normalisation
+        result.shoulderOffset = T(0);
+        result.elbowInterior = Constants<T>::pi();
+    } else if (solved <= reachMin) {
+        // Fully folded
+        result.shoulderOffset = l1 < l2 ? Constants<T>::pi() : T(0);
+        result.elbowInterior = T(0);
+    } else {
+        result.shoulderOffset = acosFast((l1 * l1 + solved * solved - l2 * l2) / (T(2) * l1 * solved));
+        result.elbowInterior = acosFast((l1 * l1 + l2 * l2 - solved * solved) / (T(2) * l1 * l2));
+    }
+    result.distance = solved * reach;
+    return result;
+}
+
+}  // namespace Kinematics
+
+#endif // ILITE_KINEMATICS_H
@@ -0,0 +1,212 @@
+/**
+ * @file LatencyPins.h
+ * @brief GPIO markers for measuring the input-to-air path with a logic analyzer
+ *
+ * Profiler times each stage on the controller's own clock, but cannot show
+ * how the stages line up, what the radio adds after esp_now_send() returns,
+ * or what a whole stick-to-air path costs. With ILITE_LATENCY_PINS=1 (env
+ * ILITE_latency in platformio.ini) spare GPIOs follow the path, written
+ * through the GPIO set/clear registers (a few tens of ns, from any task or
+ * ISR, no locking):
+ *
+ * | Marker     | GPIO | Signal                                              |
+ * |------------|------|-----------------------------------------------------|
+ * | AdcLatch   | 12   | Pulse: InputManager latched the ADC averages         |
+ * | Control    | 14   | High during the module's updateControl()             |
+ * | Prepare    | 15   | High during each prepareCommandPacket()              |
+ * | Air        | 4    | Rises at esp_now_send(), falls at the send callback  |
+ * |            |      | that leaves no frame in flight                      |
+ * | Rx         | 5    | Pulse: ESP-NOW receive callback (any frame)          |
+ * | SendBuffer | 2    | High during DisplayCanvas::sendBuffer()              |
+ *
+ * Each pin can be moved with -DILITE_LATENCY_PIN_<MARKER>=<gpio> or turned
+ * off with -1 (GPIOs 0-31 only). The defaults are free with the I2C
+ * display and without UartTransport; GPIO 2 is the status LED, which is
+ * not started in this build, and GPIOs 12 and 15 are strapping pins, so
+ * leave them unloaded at reset. Pulses are about 0.3 us wide: sample at
+ * 10 MHz or more.
+ *
+ * tools/latency_histogram.py turns an exported capture into histograms
+ * (ADC latch to control, control to air, air to send callback, RX to
+ * control, display flushes).
+ *
+ * ## Usage Example:
+ * ```cpp
+ * {
+ *     ILITE_LATENCY_SPAN(Control);        // Pin high until the scope ends
+ *     module->updateControl(inputs, dt);
+ * }
+ * ILITE_LATENCY_PULSE(AdcLatch);
+ * ```
+ *
+ * ## Thread Safety:
+ * Markers can be written from any task or ISR. Air counts frames in
+ * flight atomically between CommTask and the WiFi task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_LATENCY_PINS_H
+#define ILITE_LATENCY_PINS_H
+
+#include <Arduino.h>
+
+#ifndef ILITE_LATENCY_PINS
+#define ILITE_LATENCY_PINS 0
+#endif
+
+#ifndef ILITE_LATENCY_PIN_ADC_LATCH
+#define ILITE_LATENCY_PIN_ADC_LATCH 12
+#endif
+#ifndef ILITE_LATENCY_PIN_CONTROL
+#define ILITE_LATENCY_PIN_CONTROL 14
+#endif
+#ifndef ILITE_LATENCY_PIN_PREPARE
+#define ILITE_LATENCY_PIN_PREPARE 15
+#endif
+#ifndef ILITE_LATENCY_PIN_AIR
+#define ILITE_LATENCY_PIN_AIR 4
+#endif
+#ifndef ILITE_LATENCY_PIN_RX
+#define ILITE_LATENCY_PIN_RX 5
+#endif
+#ifndef ILITE_LATENCY_PIN_SEND_BUFFER
+#define ILITE_LATENCY_PIN_SEND_BUFFER 2
+#endif
+
+/**
+ * @brief Marked points of the input-to-air path
+ */
+enum class LatencyMarker : uint8_t {
+    AdcLatch,
+    Control,
+    Prepare,
+    Air,
+    Rx,
+    SendBuffer,
+    Count
+};
+
+#if ILITE_LATENCY_PINS
+
+#include <atomic>
+#include <soc/gpio_reg.h>
+
+/**
+ * @class LatencyPins
+ * @brief Static GPIO marker writer
+ */
+class LatencyPins {
+public:
+    static constexpr size_t kMarkerCount = static_cast<size_t>(LatencyMarker::Count);
+    static constexpr uint8_t kPulseWrites = 8;      ///< Repeated set writes (~0.3 us high)
+
+    /// GPIO of `marker`, or -1 when it is off
+    static constexpr int pinOf(LatencyMarker marker) {
+        return marker == LatencyMarker::AdcLatch ? ILITE_LATENCY_PIN_ADC_LATCH
+             : marker == LatencyMarker::Control ? ILITE_LATENCY_PIN_CONTROL
+             : marker == LatencyMarker::Prepare ? ILITE_LATENCY_PIN_PREPARE
+             : marker == LatencyMarker::Air ? ILITE_LATENCY_PIN_AIR
+             : marker == LatencyMarker::Rx ? ILITE_LATENCY_PIN_RX
+             : marker == LatencyMarker::SendBuffer ? ILITE_LATENCY_PIN_SEND_BUFFER
+             : -1;
+    }
+
+    static constexpr uint32_t maskOf(LatencyMarker marker) {
+        return pinOf(marker) >= 0 && pinOf(marker) < 32 ? 1UL << pinOf(marker) : 0;
+    }
+
+    /// Whether any marker drives GPIO `pin`
+    static constexpr bool usesPin(int pin) {
+        return (maskOf(LatencyMarker::AdcLatch) | maskOf(LatencyMarker::Control) |
+                maskOf(LatencyMarker::Prepare) | maskOf(LatencyMarker::Air) |
+                maskOf(LatencyMarker::Rx) | maskOf(LatencyMarker::SendBuffer)) & (1UL << pin);
+    }
+
+    /// Make the marker pins outputs, low, and log the map
+    static void begin();
+
+    template <LatencyMarker M>
+    static inline void set() {
+        if (maskOf(M) != 0) {
+            REG_WRITE(GPIO_OUT_W1TS_REG, maskOf(M));
+        }
+    }
+
+    template <LatencyMarker M>
+    static inline void clear() {
+        if (maskOf(M) != 0) {
+            REG_WRITE(GPIO_OUT_W1TC_REG, maskOf(M));
+        }
+    }
+
+    template <LatencyMarker M>
+    static inline void pulse() {
+        if (maskOf(M) != 0) {
+            for (uint8_t i = 0; i < kPulseWrites; ++i) {
+                REG_WRITE(GPIO_OUT_W1TS_REG, maskOf(M));
+            }
+            REG_WRITE(GPIO_OUT_W1TC_REG, maskOf(M));
+        }
+    }
+
+    /// esp_now_send() is about to run: Air rises with the first frame in flight
+    static inline void onSend() {
+        if (airInFlight_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            set<LatencyMarker::Air>();
+        }
+    }
+
+    /// Send callback (or a failed send): Air falls with the last frame in flight
+    static inline void onSendDone() {
+        uint8_t inFlight = airInFlight_.load(std::memory_order_relaxed);
+        while (inFlight > 0 &&
+               !airInFlight_.compare_exchange_weak(inFlight, inFlight - 1, std::memory_order_relaxed)) {
+        }
+        if (inFlight == 1) {
+            clear<LatencyMarker::Air>();
+        }
+    }
+
+private:
+    static std::atomic<uint8_t> airInFlight_;
+};
+
+/**
+ * @class LatencySpan
+ * @brief Holds a marker pin high for its lifetime
+ */
+template <LatencyMarker M>
+class LatencySpan {
+public:
+    LatencySpan() { LatencyPins::set<M>(); }
+    ~LatencySpan() { LatencyPins::clear<M>(); }
+
+    LatencySpan(const LatencySpan&) = delete;
+    LatencySpan& operator=(const LatencySpan&) = delete;
+};
+
+#define ILITE_LATENCY_CONCAT_(a, b) a##b
+#define ILITE_LATENCY_CONCAT(a, b) ILITE_LATENCY_CONCAT_(a, b)
+
+/// Marker pin high until the end of the enclosing scope
+#define ILITE_LATENCY_SPAN(marker) \
+    LatencySpan<LatencyMarker::marker> ILITE_LATENCY_CONCAT(latencySpan_, __LINE__)
+
+/// Short pulse on the marker pin
+#define ILITE_LATENCY_PULSE(marker) LatencyPins::pulse<LatencyMarker::marker>()
+
+#define ILITE_LATENCY_SEND() LatencyPins::onSend()
+#define ILITE_LATENCY_SEND_DONE() LatencyPins::onSendDone()
+
+#else
+
+#define ILITE_LATENCY_SPAN(marker) do {} while (0)
+#define ILITE_LATENCY_PULSE(marker) do {} while (0)
+#define ILITE_LATENCY_SEND() do {} while (0)
+#define ILITE_LATENCY_SEND_DONE() do {} while (0)
+
+#endif // ILITE_LATENCY_PINS
+
+#endif // ILITE_LATENCY_PINS_H
@@ -0,0 +1,132 @@
+/**
+ * @file LinkMetrics.h
+ * @brief Per-peer radio link quality: TX success, RSSI, loss and round-trip time
+ *
+ * Packet counters alone cannot tell a weak radio link from a robot that is
+ * slow to respond. LinkMetrics keeps one record per destination MAC:
+ *
+ * - **TX success**: every ESP-NOW send callback reports whether the peer
+ *   acknowledged the frame at the MAC layer.
+ * - **RSSI**: with promiscuous receive enabled, the RX control header of
+ *   each ESP-NOW action frame from a known peer updates a smoothed RSSI.
+ * - **Loss / RTT**: EspNowDiscovery pings the paired peer (MSG_PING) and
+ *   the peer echoes the esp_timer stamp and sequence number (MSG_PONG).
+ *   Gaps in the echoed sequence count as lost round trips, and each echo
+ *   adds a sample to a round-trip histogram.
+ *
+ * Pings are answered inside the discovery handler on the robot, so a high
+ * RTT with good RSSI and TX success points at a busy robot rather than at
+ * the radio.
+ *
+ * Records are claimed from any task with an atomic state flag and never
+ * released (except by reset()), so readers need no lock. Counters are plain
+ * 32-bit values written by one task each.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_LINK_METRICS_H
+#define ILITE_LINK_METRICS_H
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <atomic>
+
+static constexpr size_t kLinkRttBuckets = 8;
+
+/**
+ * @brief Link statistics of one destination
+ */
+struct LinkPeerStats {
+    std::atomic<uint8_t> state;     ///< 0 free, 1 claiming, 2 ready
+    uint8_t mac[6];
+
+    uint32_t txOk;                  ///< Send callbacks with ESP_NOW_SEND_SUCCESS
+    uint32_t txFail;                ///< Send callbacks with ESP_NOW_SEND_FAIL
+
+    int16_t rssiDbm;                ///< Smoothed RSSI (dBm)
+    int8_t rssiLastDbm;             ///< Latest RSSI (dBm)
+    uint32_t rssiSamples;
+
+    uint32_t rxFrames;              ///< Frames received from this peer
+    uint32_t lastHeardMs;           ///< millis() of the latest frame
+
+    uint32_t pingsSent;
+    uint32_t pongs;
+    uint32_t seqLost;               ///< Missing sequence numbers in the echoes
+    uint32_t nextSeq;               ///< Next sequence number expected back
+
+    uint32_t rttLastUs;
+    uint32_t rttMinUs;
+    uint32_t rttMaxUs;
+    uint32_t rttAvgUs;              ///< Moving average (1/8 weight)
+    uint32_t rttHistogram[kLinkRttBuckets];
+};
+
+/**
+ * @class LinkMetrics
+ * @brief Static table of per-peer link statistics plus the link screen
+ */
+class LinkMetrics {
+public:
+    static constexpr size_t kMaxPeers = 8;
+    static constexpr uint32_t kStaleMs = 2000;          ///< No frame for this long = no signal
+
+    /// Upper bound (us) of each RTT histogram bucket; the last is open-ended
+    static const uint32_t kRttBucketUs[kLinkRttBuckets];
+
+    /**
+     * @brief Register the link screen and optionally start RSSI capture
+     * @param promiscuousRssi Enable promiscuous receive for RSSI
+     */
+    static void begin(bool promiscuousRssi);
+
+    /// Take promiscuous receive back after someone borrowed it (ChannelSurvey)
+    static void restorePromiscuous();
+
+    /// ESP-NOW send callback result (WiFi task)
+    static void onSendStatus(const uint8_t* mac, bool success);
+
+    /// Any frame received from `mac`
+    static void onReceive(const uint8_t* mac);
+
+    /// A ping with `sequence` was sent to `mac`
+    static void onPingSent(const uint8_t* mac, uint32_t sequence);
+
+    /**
+     * @brief An echo arrived
+     * @param sentUs Low 32 bits of esp_timer_get_time() when the ping was sent
+     */
+    static void onPong(const uint8_t* mac, uint32_t sequence, uint32_t sentUs);
+
+    /// Statistics for `mac`, or nullptr if nothing was recorded yet
+    static const LinkPeerStats* find(const uint8_t* mac);
+
+    /// Share of sends acknowledged (0-100, 100 with no samples)
+    static uint8_t txSuccessPercent(const LinkPeerStats& stats);
+
+    /// Share of round trips lost (0-100)
+    static uint8_t lossPercent(const LinkPeerStats& stats);
+
+    /**
+     * @brief Signal bars for UIComponents::drawSignalIndicator
+     * @return 0 when there is no data, 1 (none) to 4 (full) otherwise
+     */
+    static uint8_t getSignalBars(const uint8_t* mac);
+
+    /// Drop all records
+    static void reset();
+
+    /// Print a table of all peers
+    static void dump(Print& out);
+
+private:
+    static void promiscuousCallback(void* buffer, wifi_promiscuous_pkt_type_t type);
+    static LinkPeerStats* lookup(const uint8_t* mac);
+    static LinkPeerStats* findOrAdd(const uint8_t* mac);
+
+    static LinkPeerStats peers_[kMaxPeers];
+};
+
+#endif // ILITE_LINK_METRICS_H
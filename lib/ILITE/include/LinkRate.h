@@ -0,0 +1,111 @@
+/**
+ * @file LinkRate.h
+ * @brief ESP-NOW PHY rate selection with adaptive fallback
+ *
+ * ESP-NOW sends at 1 Mbit/s unless told otherwise, so a robot a metre away
+ * pays the same airtime per frame as one across the arena. LinkRate sets
+ * the rate with esp_wifi_config_espnow_rate() from a ladder ordered by
+ * robustness:
+ *
+ *     lr250k lr500k 1M 2M 5.5M 11M 12M 24M 36M 54M
+ *
+ * The two 802.11 LR rates only exist with ILITEConfig::linkLongRange, which
+ * adds WIFI_PROTOCOL_LR to the station; the robot must enable it too.
+ *
+ * With adaptation on, ServiceTask judges the paired peer's LinkMetrics
+ * counters once per kWindowMs (the adaptive ARF scheme):
+ *
+ * - A window with kStepDownFailPercent or more unacknowledged sends, or as
+ *   many lost pings, steps one rate down.
+ * - After enough clean windows in a row, and with the smoothed RSSI above
+ *   the next rate's floor, it probes one rate up. A probe that fails its
+ *   first window steps back and doubles the clean windows needed for the
+ *   next probe (up to kMaxStepUpWindows).
+ * - Unpaired, the radio goes back to the configured rate so broadcasts
+ *   still reach far robots.
+ *
+ * The rate is per interface, so team peers and broadcasts share it.
+ *
+ * Every window is also booked to the rate it ran at: sends, failed sends,
+ * pings, lost pings and round-trip time per rate ("rate" on the console).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_LINK_RATE_H
+#define ILITE_LINK_RATE_H
+
+#include <Arduino.h>
+
+class EspNowDiscovery;
+
+/// ESP-NOW PHY rates, most robust first
+enum class LinkPhyRate : uint8_t {
+    Lr250k,
+    Lr500k,
+    Mbps1,
+    Mbps2,
+    Mbps5_5,
+    Mbps11,
+    Mbps12,
+    Mbps24,
+    Mbps36,
+    Mbps54,
+    Count
+};
+
+/**
+ * @brief What the link did while running at one rate
+ */
+struct LinkRateStats {
+    uint32_t activeMs = 0;          ///< Judged windows at this rate
+    uint32_t sends = 0;
+    uint32_t sendFails = 0;         ///< No MAC-layer acknowledgement
+    uint32_t pings = 0;             ///< Echoes received
+    uint32_t pingsLost = 0;
+    uint64_t rttSumUs = 0;          ///< Window RTT average times echoes
+};
+
+/**
+ * @class LinkRate
+ * @brief Static rate ladder, per-rate statistics and the adaptive controller
+ */
+class LinkRate {
+public:
+    static constexpr uint32_t kWindowMs = 1000;
+    static constexpr uint32_t kMinWindowSends = 10;         ///< Fewer sends are not judged
+    static constexpr uint8_t kStepDownFailPercent = 20;
+    static constexpr uint8_t kStepUpFailPercent = 3;        ///< A clean window stays below this
+    static constexpr uint8_t kStepUpWindows = 5;
+    static constexpr uint8_t kMaxStepUpWindows = 60;
+
+    /**
+     * @brief Configure the station and apply `rate` (after esp_now_init())
+     * @param longRange Enable 802.11 LR so the lr rates are available
+     */
+    static bool begin(LinkPhyRate rate, bool adaptive, bool longRange);
+
+    /// Apply `rate` now; also the rate used while unpaired
+    static bool setRate(LinkPhyRate rate);
+    static LinkPhyRate getRate();
+
+    static void setAdaptive(bool enabled);
+    static bool isAdaptive();
+
+    /// Adaptation may still step down, so loss is not yet a channel problem
+    static bool canStepDown();
+
+    /// Book the last window and adapt (ServiceTask)
+    static void service(const EspNowDiscovery& discovery, uint32_t now);
+
+    static const char* name(LinkPhyRate rate);
+    /// "1M", "lr250k", ...; false if unknown or not available
+    static bool parse(const char* text, LinkPhyRate& rate);
+
+    static const LinkRateStats& getStats(LinkPhyRate rate);
+    static void reset();
+    static void dump(Print& out);
+};
+
+#endif // ILITE_LINK_RATE_H
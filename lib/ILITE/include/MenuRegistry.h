@@ -5,6 +5,26 @@
  * Allows users to register custom menu entries with hierarchical structure,
  * conditional visibility, icons, and callbacks.
  *
+ * Navigation queries go through an index that is rebuilt only after entries
+ * change: each distinct parent ID gets a group holding its children in
+ * priority order, and IDs are resolved by pointer identity through a small
+ * cache (entry IDs pushed on the menu stack hit it directly), falling back
+ * to strcmp only on a miss. getVisibleEntries() caches the filtered list of
+ * the last queried menu until invalidateVisibility() bumps the generation,
+ * and returns it by value in a fixed-capacity MenuList, so menu rendering
+ * allocates nothing per frame.
+ *
+ * Entry callbacks are Delegate (see Delegate.h): 8 bytes per slot instead
+ * of std::function's 16, never allocating. They take captureless lambdas,
+ * functions, or lambdas capturing one pointer.
+ *
+ * Entries live in two places. Fixed ones (the built-in menus, the
+ * REGISTER_MENU_* macros) are `constexpr` tables in flash, registered by
+ * address with registerTable(): nothing is copied and they cost one table
+ * record of RAM. Entries built at run time (module menus, framework
+ * diagnostics) are copied into a RAM overlay by registerEntry() and are the
+ * only ones that can be edited or removed. The index covers both.
+ *
  * @example
  * ```cpp
  * REGISTER_MENU_ENTRY(
@@ -29,9 +49,9 @@
 
 #include <Arduino.h>
 #include <vector>
-#include <functional>
 #include <cstddef>
 #include "IconLibrary.h"
+#include "Delegate.h"
 
 /// Menu entry ID type
 using MenuID = const char*;
@@ -40,46 +60,67 @@ using MenuID = const char*;
  * @brief Menu entry definition
  */
 struct MenuEntry {
-    MenuID id;                         ///< Unique identifier "mydrone.arm"
-    MenuID parent;                     ///< Parent menu ID (nullptr = root level)
-    IconID icon;                       ///< Icon ID from IconLibrary
-    const char* label;                 ///< Display label "Arm Motors"
-    const char* shortLabel;            ///< Short label for compact display (optional)
+    MenuEntry() = default;
+
+    /**
+     * @brief Entry with the common fields, usable in constant expressions
+     *
+     * Callbacks given as functions (or nullptr) keep the whole entry a
+     * constant, so `constexpr MenuEntry` tables are placed in flash and
+     * registered with MenuRegistry::registerTable(). Editable value fields
+     * keep their defaults.
+     */
+    constexpr MenuEntry(MenuID id, MenuID parent, IconID icon, const char* label,
+                        const char* shortLabel, Delegate<void()> onSelect,
+                        Delegate<bool()> condition, Delegate<const char*()> getValue,
+                        int priority, bool isSubmenu, bool isToggle,
+                        Delegate<bool()> getToggleState, bool isReadOnly,
+                        Delegate<void(int16_t, int16_t, int16_t, bool)> customDraw)
+        : id(id), parent(parent), icon(icon), label(label), shortLabel(shortLabel),
+          onSelect(onSelect), condition(condition), getValue(getValue),
+          priority(priority), isSubmenu(isSubmenu), isToggle(isToggle),
+          getToggleState(getToggleState), isReadOnly(isReadOnly), customDraw(customDraw) {}
+
+    MenuID id = nullptr;               ///< Unique identifier "mydrone.arm"
+    MenuID parent = nullptr;           ///< Parent menu ID (nullptr = root level)
+    IconID icon = nullptr;             ///< Icon ID from IconLibrary
+    const char* label = nullptr;       ///< Display label "Arm Motors"
+    const char* shortLabel = nullptr;  ///< Short label for compact display (optional)
 
     /// Callback when entry is selected
-    std::function<void()> onSelect;
+    Delegate<void()> onSelect;
 
     /// Condition for visibility (return false to hide entry)
-    std::function<bool()> condition;
+    Delegate<bool()> condition;
 
     /// Display value (e.g., "Enabled", "50%")
-    std::function<const char*()> getValue;
+    Delegate<const char*()> getValue;
 
     /// Priority for sorting (lower = higher in list)
-    int priority;
+    int priority = 0;
 
     /// Whether this entry opens a submenu
-    bool isSubmenu;
+    bool isSubmenu = false;
 
     /// Whether this entry is a toggle (show checkmark when enabled)
-    bool isToggle;
+    bool isToggle = false;
 
     /// Get toggle state (only valid if isToggle == true)
-    std::function<bool()> getToggleState;
+    Delegate<bool()> getToggleState;
 
     /// Whether this entry is a read-only info display
-    bool isReadOnly;
+    bool isReadOnly = false;
 
     /// Custom draw function (advanced - overrides default rendering)
-    std::function<void(int16_t x, int16_t y, int16_t w, bool focused)> customDraw;
+    Delegate<void(int16_t x, int16_t y, int16_t w, bool focused)> customDraw;
 
     // Editable value support
     bool isEditableInt = false;        ///< Whether this is an editable integer
     bool isEditableFloat = false;      ///< Whether this is an editable float
-    std::function<int()> getIntValue;  ///< Get integer value
-    std::function<void(int)> setIntValue; ///< Set integer value
-    std::function<float()> getFloatValue; ///< Get float value
-    std::function<void(float)> setFloatValue; ///< Set float value
+    Delegate<int()> getIntValue;  ///< Get integer value
+    Delegate<void(int)> setIntValue; ///< Set integer value
+    Delegate<float()> getFloatValue; ///< Get float value
+    Delegate<void(float)> setFloatValue; ///< Set float value
     int minValue = 0;                  ///< Minimum value
     int maxValue = 100;                ///< Maximum value
     float minValueFloat = 0.0f;        ///< Minimum float value
@@ -87,11 +128,36 @@ struct MenuEntry {
     float step = 1.0f;                 ///< Fine step size
     float coarseStep = 10.0f;          ///< Coarse step size (for fast rotation)
 
+    /// Apply the value while the encoder turns, not only on press. Detents are
+    /// coalesced: the setter runs at most once per 30 ms with the latest
+    /// value, always once more on press, and cancelling restores the start value.
+    bool liveEdit = false;
+
+    /// True while the value is not yet confirmed by the robot (drawn as a '*'
+    /// before the value, see ParamSync)
+    Delegate<bool()> isPending;
+
     // Editable string support
     bool isEditableString = false;      ///< Whether this entry edits a string
     size_t maxStringLength = 32;        ///< Maximum characters (excluding null)
-    std::function<void(char*, size_t)> getStringValueForEdit; ///< Populate buffer with current value
-    std::function<void(const char*)> setStringValue;          ///< Apply edited value
+    Delegate<void(char*, size_t)> getStringValueForEdit; ///< Populate buffer with current value
+    Delegate<void(const char*)> setStringValue;          ///< Apply edited value
+};
+
+/**
+ * @brief Fixed-capacity list of menu entries (no heap)
+ */
+struct MenuList {
+    static constexpr size_t kCapacity = 32;     ///< Entries shown per menu level
+
+    const MenuEntry* items[kCapacity];
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const MenuEntry* operator[](size_t index) const { return index < count ? items[index] : nullptr; }
+    const MenuEntry* const* begin() const { return items; }
+    const MenuEntry* const* end() const { return items + count; }
 };
 
 /**
@@ -100,11 +166,30 @@ struct MenuEntry {
 class MenuRegistry {
 public:
     /**
-     * @brief Register a menu entry
+     * @brief Register a menu entry (copied into the RAM overlay)
      * @param entry Menu entry definition
      */
     static void registerEntry(const MenuEntry& entry);
 
+    /**
+     * @brief Register a static table of entries by address
+     *
+     * The table is not copied and must outlive the registry; make it
+     * `constexpr` so it stays in flash. Entries whose ID is already
+     * registered are skipped.
+     *
+     * @param entries First entry
+     * @param count Number of entries
+     */
+    static void registerTable(const MenuEntry* entries, size_t count);
+
+    /**
+     * @brief Register copies of several entries at once (one log line)
+     *
+     * For putting back entries taken with takeEntries().
+     */
+    static void registerEntries(const MenuEntry* entries, size_t count);
+
     /**
      * @brief Get all entries at a given level
      * @param parentId Parent ID (nullptr = root level)
@@ -128,53 +213,121 @@ public:
 
     /**
      * @brief Get visible entries in menu (applies conditions)
+     *
+     * Conditions are evaluated once per visibility generation; later calls
+     * for the same menu return the cached result.
+     *
      * @param parentId Parent ID
-     * @return Vector of visible entries only
+     * @return Visible entries, sorted by priority
      */
-    static std::vector<const MenuEntry*> getVisibleEntries(MenuID parentId);
+    static MenuList getVisibleEntries(MenuID parentId);
 
     /**
-     * @brief Get all registered entries
-     * @return Vector of all entries
+     * @brief Re-evaluate entry conditions on the next getVisibleEntries()
+     *
+     * The menu renderer calls this once per frame, so navigation in between
+     * frames works on exactly the list that is on screen.
+     */
+    static void invalidateVisibility();
+
+    /**
+     * @brief Get the entries in the RAM overlay
+     *
+     * The caller may modify the entries, so the navigation index is rebuilt
+     * on the next query. Entries from static tables are not included.
+     *
+     * @return Vector of registerEntry() entries
      */
     static std::vector<MenuEntry>& getAllEntries();
 
     /**
-     * @brief Clear all entries
+     * @brief Clear all entries (overlay and table registrations)
      */
     static void clear();
 
     /**
      * @brief Remove a specific entry by ID
      * @param id Entry ID to remove
-     * @return true if entry was found and removed
+     * @return true if entry was found in the RAM overlay and removed
      */
     static bool removeEntry(MenuID id);
 
     /**
-     * @brief Remove all entries with a specific parent
+     * @brief Remove all overlay entries with a specific parent
      * @param parentId Parent ID
      * @return Number of entries removed
      */
     static int removeEntriesByParent(MenuID parentId);
 
     /**
-     * @brief Find entry by ID (non-const version for internal use)
+     * @brief Remove overlay entries and append them to `out`, in `ids` order
+     * @return Number of entries taken
+     */
+    static size_t takeEntries(const MenuID* ids, size_t count, std::vector<MenuEntry>& out);
+
+    /**
+     * @brief Find an overlay entry by ID (non-const version for internal use)
      * @param id Entry ID
-     * @return Pointer to entry, or nullptr if not found
+     * @return Pointer to entry, or nullptr if not found (or in a static table)
      */
     static MenuEntry* findEntry(MenuID id);
 
     /**
      * @brief Initialize built-in menu structure
      *
-     * Creates default menus: Home, Settings, Quick Actions, etc.
-     * Called automatically by framework.
+     * Registers the default menus (Home, Settings, Quick Actions, etc.)
+     * from a flash table. Called automatically by framework.
      */
     static void initBuiltInMenus();
 
 private:
-    static std::vector<MenuEntry> entries_;
+    /// Static entries registered with registerTable()
+    struct Table {
+        const MenuEntry* entries;
+        size_t count;
+    };
+
+    /// Children of one parent ID: children_[first .. first + count)
+    struct Group {
+        MenuID id;
+        uint16_t first;
+        uint16_t count;
+    };
+
+    /// Pointer-identity cache: ID pointer -> group (-1 = no children)
+    struct IdSlot {
+        MenuID id;
+        int16_t group;
+    };
+
+    static constexpr size_t kIdCacheSize = 32;   ///< Power of 2
+    static constexpr int16_t kNoGroup = -1;
+    static constexpr int16_t kUnset = -2;
+
+    static std::vector<Table> tables_;
+    static std::vector<MenuEntry> entries_;         ///< RAM overlay
+    static std::vector<Group> groups_;
+    static std::vector<const MenuEntry*> children_;
+    static IdSlot idCache_[kIdCacheSize];
+    static int16_t rootGroup_;
+    static bool indexDirty_;
+
+    static MenuList visible_;
+    static int16_t visibleGroup_;
+    static uint32_t visibleGeneration_;
+    static uint32_t generation_;
+
+    /// Entry with this ID in a table or the overlay (linear, registration only)
+    static const MenuEntry* lookup(MenuID id);
+
+    /// Mark the index stale (entries added, removed or exposed for writing)
+    static void markDirty();
+
+    /// Rebuild groups_/children_ if stale
+    static void ensureIndex();
+
+    /// Group for a parent ID (kNoGroup if it has no children)
+    static int16_t findGroup(MenuID parentId);
 
     /// Helper: Compare entries by priority
     static bool compareByPriority(const MenuEntry* a, const MenuEntry* b);
@@ -200,6 +353,28 @@ private:
 // Registration Macros
 // ============================================================================
 
+// Unique names per use, so IDs can be string literals
+#define ILITE_MENU_CONCAT_INNER(a, b) a##b
+#define ILITE_MENU_CONCAT(a, b) ILITE_MENU_CONCAT_INNER(a, b)
+
+/**
+ * @brief Define a static entry and register it by address
+ *
+ * The entry is a constant (flash) when every callback is a function or a
+ * captureless lambda in a C++17 build; otherwise it is initialized at
+ * startup in place. Either way it is never copied into the registry.
+ */
+#define ILITE_REGISTER_STATIC_MENU_ENTRY(...) \
+    namespace { \
+        const MenuEntry ILITE_MENU_CONCAT(g_menuEntry_, __LINE__)[] = {{__VA_ARGS__}}; \
+        struct ILITE_MENU_CONCAT(MenuEntryRegistrar_, __LINE__) { \
+            ILITE_MENU_CONCAT(MenuEntryRegistrar_, __LINE__)() { \
+                MenuRegistry::registerTable(ILITE_MENU_CONCAT(g_menuEntry_, __LINE__), 1); \
+            } \
+        }; \
+        ILITE_MENU_CONCAT(MenuEntryRegistrar_, __LINE__) ILITE_MENU_CONCAT(g_menuEntryRegistrar_, __LINE__); \
+    }
+
 /**
  * @brief Macro for registering simple menu entries
  *
@@ -215,29 +390,8 @@ private:
  * ```
  */
 #define REGISTER_MENU_ENTRY_SIMPLE(id, parent, icon, label, callback) \
-    namespace { \
-        struct MenuEntryRegistrar_##id { \
-            MenuEntryRegistrar_##id() { \
-                MenuRegistry::registerEntry({ \
-                    #id, \
-                    parent, \
-                    icon, \
-                    label, \
-                    nullptr, \
-                    callback, \
-                    nullptr, \
-                    nullptr, \
-                    0, \
-                    false, \
-                    false, \
-                    nullptr, \
-                    false, \
-                    nullptr \
-                }); \
-            } \
-        }; \
-        static MenuEntryRegistrar_##id g_menuEntryRegistrar_##id; \
-    }
+    ILITE_REGISTER_STATIC_MENU_ENTRY(id, parent, icon, label, nullptr, callback, nullptr, nullptr, \
+                                     0, false, false, nullptr, false, nullptr)
 
 /**
  * @brief Macro for registering conditional menu entries
@@ -255,29 +409,8 @@ private:
  * ```
  */
 #define REGISTER_MENU_ENTRY_CONDITIONAL(id, parent, icon, label, cond, callback) \
-    namespace { \
-        struct MenuEntryRegistrar_##id { \
-            MenuEntryRegistrar_##id() { \
-                MenuRegistry::registerEntry({ \
-                    #id, \
-                    parent, \
-                    icon, \
-                    label, \
-                    nullptr, \
-                    callback, \
-                    cond, \
-                    nullptr, \
-                    0, \
-                    false, \
-                    false, \
-                    nullptr, \
-                    false, \
-                    nullptr \
-                }); \
-            } \
-        }; \
-        static MenuEntryRegistrar_##id g_menuEntryRegistrar_##id; \
-    }
+    ILITE_REGISTER_STATIC_MENU_ENTRY(id, parent, icon, label, nullptr, callback, cond, nullptr, \
+                                     0, false, false, nullptr, false, nullptr)
 
 /**
  * @brief Macro for registering submenu entries
@@ -293,29 +426,8 @@ private:
  * ```
  */
 #define REGISTER_MENU_SUBMENU(id, parent, icon, label) \
-    namespace { \
-        struct MenuEntryRegistrar_##id { \
-            MenuEntryRegistrar_##id() { \
-                MenuRegistry::registerEntry({ \
-                    #id, \
-                    parent, \
-                    icon, \
-                    label, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    0, \
-                    true, \
-                    false, \
-                    nullptr, \
-                    false, \
-                    nullptr \
-                }); \
-            } \
-        }; \
-        static MenuEntryRegistrar_##id g_menuEntryRegistrar_##id; \
-    }
+    ILITE_REGISTER_STATIC_MENU_ENTRY(id, parent, icon, label, nullptr, nullptr, nullptr, nullptr, \
+                                     0, true, false, nullptr, false, nullptr)
 
 /**
  * @brief Macro for registering toggle menu entries
@@ -333,28 +445,7 @@ private:
  * ```
  */
 #define REGISTER_MENU_TOGGLE(id, parent, icon, label, getState, callback) \
-    namespace { \
-        struct MenuEntryRegistrar_##id { \
-            MenuEntryRegistrar_##id() { \
-                MenuRegistry::registerEntry({ \
-                    #id, \
-                    parent, \
-                    icon, \
-                    label, \
-                    nullptr, \
-                    callback, \
-                    nullptr, \
-                    nullptr, \
-                    0, \
-                    false, \
-                    true, \
-                    getState, \
-                    false, \
-                    nullptr \
-                }); \
-            } \
-        }; \
-        static MenuEntryRegistrar_##id g_menuEntryRegistrar_##id; \
-    }
+    ILITE_REGISTER_STATIC_MENU_ENTRY(id, parent, icon, label, nullptr, callback, nullptr, nullptr, \
+                                     0, false, true, getState, false, nullptr)
 
 #endif // ILITE_MENU_REGISTRY_H
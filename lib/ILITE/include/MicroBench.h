@@ -0,0 +1,103 @@
+/**
+ * @file MicroBench.h
+ * @brief Repeatable per-kernel measurements for comparing firmware builds
+ *
+ * MicroBench::run() calls a kernel `warmup` times untimed and then
+ * `iterations` times timed. It reports, per call:
+ *
+ * - ns/op and cycles/op from the CPU cycle counter (CCOUNT). The native
+ *   build uses the host clock and reports 0 cycles. The cost of an empty
+ *   kernel call, calibrated once, is subtracted.
+ * - Stack bytes used by one call. The area below the caller is painted and
+ *   scanned afterwards, so the figure is approximate to within a few frame
+ *   headers. Kernels deeper than kStackProbeBytes report the probe size.
+ * - Heap allocations and bytes per call. These are only counted in builds
+ *   with ILITE_BENCH, which replace the global operator new. malloc() made
+ *   directly by C code (e.g. String) is not seen.
+ *
+ * Results print as CSV lines prefixed with "bench," and a "#" header, so a
+ * log from each build can be diffed or loaded into a spreadsheet. See
+ * examples/MicroBench for the suite and the `bench` PlatformIO envs.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * static void solve(void* context) {
+ *     static_cast<Solver*>(context)->solve();
+ * }
+ *
+ * MicroBench::printHeader(Serial);
+ * MicroBench::print(Serial, MicroBench::run("solve", solve, &solver, 10000, 100));
+ * ```
+ *
+ * Keep each run well under 17 s (2^32 cycles at 240 MHz).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MICRO_BENCH_H
+#define ILITE_MICRO_BENCH_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Per-call figures of one kernel
+ */
+struct BenchResult {
+    const char* name = "";
+    uint32_t iterations = 0;
+    float nsPerOp = 0.0f;
+    float cyclesPerOp = 0.0f;       ///< 0 in the native build
+    uint32_t stackBytes = 0;
+    float allocsPerOp = 0.0f;       ///< 0 without ILITE_BENCH
+    float allocBytesPerOp = 0.0f;
+};
+
+/**
+ * @class MicroBench
+ * @brief Static benchmark runner
+ */
+class MicroBench {
+public:
+    using Kernel = void (*)(void* context);
+
+    static constexpr size_t kStackProbeBytes = 3072;   ///< Caller needs this much free stack
+
+    /**
+     * @brief Measure one kernel
+     *
+     * @param name Row label (kept by pointer; use a literal)
+     * @param kernel Function under test
+     * @param context Passed to every call
+     * @param iterations Timed calls (at least 1)
+     * @param warmup Untimed calls first (caches, lazy init)
+     */
+    static BenchResult run(const char* name, Kernel kernel, void* context,
+                           uint32_t iterations, uint32_t warmup = 0);
+
+    /// "#build,..." and "#bench,..." column lines
+    static void printHeader(Print& out);
+
+    /// One "bench,..." row
+    static void print(Print& out, const BenchResult& result);
+
+    /// true when operator new is counted (ILITE_BENCH builds)
+    static bool isCountingAllocs();
+
+    /// operator new calls / bytes since boot (ILITE_BENCH builds)
+    static uint32_t getAllocCount();
+    static uint32_t getAllocBytes();
+
+private:
+    static uint64_t ticks();
+    static uint64_t elapsedTicks(uint64_t start, uint64_t end);
+    static float ticksToNs(float ticks);
+    static float ticksToCycles(float ticks);
+    static uint32_t stackUsed(Kernel kernel, void* context);
+
+    static float overheadTicks_;    ///< Per empty kernel call
+    static uint32_t overheadStack_;  ///< Stack an empty kernel call reports
+    static bool calibrated_;
+};
+
+#endif // ILITE_MICRO_BENCH_H
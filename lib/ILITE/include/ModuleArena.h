@@ -0,0 +1,150 @@
+/**
+ * @file ModuleArena.h
+ * @brief Bump allocator for state owned by the active module
+ *
+ * Every module switch used to allocate the module's menu IDs and labels on
+ * the heap (and never free them), alongside the menu entries and bindings
+ * it registers. Over a long session those small, short-lived blocks break
+ * the heap into pieces. ModuleArena hands out that memory from one static
+ * buffer instead: allocation is a pointer bump, and the whole arena is
+ * released in one step when the module is unloaded.
+ *
+ * Memory from the arena is only valid until the next reset(). Objects
+ * placed in it are never destroyed, so only store trivially destructible
+ * data (strings, PODs).
+ *
+ * The active module's working state (trace buffers, analysis scratch) goes
+ * in a second region: one heap block of ILITEModule::getStateSize() bytes,
+ * reserved when the module is activated, carved up by the module with
+ * createState() in onActivate() and freed by the same reset(). Resident RAM
+ * then follows the active module instead of every module compiled in, and
+ * a switch costs one allocation and one free instead of many.
+ *
+ * The arena has two banks. With ILITEConfig::moduleStandby the module
+ * switched away from keeps its bank (menu strings and state block) in
+ * standby while the next module fills the other; swapBanks() trades them
+ * back when it returns. Everything but swapBanks() and the standby
+ * accessors works on the active bank.
+ *
+ * dumpHeap() prints the free heap, the largest free block and the arena
+ * usage; FrameworkEngine logs it before and after each module switch so
+ * fragmentation can be compared across a session.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MODULE_ARENA_H
+#define ILITE_MODULE_ARENA_H
+
+#include <Arduino.h>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * @class ModuleArena
+ * @brief Static, module-scoped bump arena
+ */
+class ModuleArena {
+public:
+    static constexpr size_t kCapacity = 4096;   ///< Bytes per bank
+    static constexpr size_t kBanks = 2;         ///< Active and standby
+
+    /**
+     * @brief Allocate from the arena
+     * @param size Bytes
+     * @param align Alignment (power of 2)
+     * @return Pointer, or nullptr when the arena is full
+     */
+    static void* allocate(size_t size, size_t align = 4);
+
+    /**
+     * @brief Copy a string into the arena
+     * @return Arena copy, or nullptr when the arena is full
+     */
+    static const char* copyString(const char* text);
+
+    /// True if `ptr` points into the arena
+    static bool owns(const void* ptr);
+
+    /// Release the active bank (call once the module's registrations are removed)
+    static void reset();
+
+    /// Trade the active bank for the standby one; neither is released
+    static void swapBanks();
+
+    // ========================================================================
+    // Working State
+    // ========================================================================
+
+    static constexpr size_t kStateAlign = 8;    ///< State allocation granularity
+
+    /// Bytes a state allocation of `size` takes (sum these in getStateSize())
+    static constexpr size_t stateBytes(size_t size) {
+        return (size + kStateAlign - 1) & ~(kStateAlign - 1);
+    }
+
+    /**
+     * @brief Allocate the state block for the module being activated
+     * @param bytes Block size (0 = none)
+     * @return false if the heap could not provide it
+     */
+    static bool reserveState(size_t bytes);
+
+    /**
+     * @brief Allocate zeroed memory from the state block
+     * @return Pointer, or nullptr when the block is full
+     */
+    static void* allocateState(size_t size);
+
+    /**
+     * @brief Construct an object in the state block
+     *
+     * The destructor is never run; only place objects that own no other
+     * memory (see SeriesBuffer's storage constructor).
+     *
+     * @return Object, or nullptr when the block is full
+     */
+    template <typename T, typename... Args>
+    static T* createState(Args&&... args) {
+        void* memory = allocateState(sizeof(T));
+        return memory != nullptr ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    static size_t stateUsed() { return stateUsed_; }
+    static size_t stateCapacity() { return stateCapacity_; }
+
+    static size_t used() { return used_; }
+    static size_t peak() { return peak_; }
+    static uint32_t failures() { return failures_; }
+
+    /// Arena and state bytes held by the standby bank
+    static size_t standbyUsed() { return standby_.used + standby_.stateCapacity; }
+
+    /// Print heap free / largest block / fragmentation and arena usage
+    static void dumpHeap(Print& out, const char* stage);
+
+private:
+    /// A parked bank (the active one lives in the members below)
+    struct Bank {
+        uint8_t* base;
+        size_t used;
+        uint8_t* state;
+        size_t stateCapacity;
+        size_t stateUsed;
+    };
+
+    alignas(8) static uint8_t buffer_[kBanks][kCapacity];
+    static uint8_t* base_;
+    static Bank standby_;
+    static size_t used_;
+    static size_t peak_;
+    static uint32_t failures_;
+
+    static uint8_t* state_;
+    static size_t stateCapacity_;
+    static size_t stateUsed_;
+};
+
+#endif // ILITE_MODULE_ARENA_H
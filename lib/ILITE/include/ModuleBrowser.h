@@ -5,6 +5,12 @@
  * Displays registered modules as cards with logos/names.
  * Allows browsing and selecting modules to view their dashboards.
  *
+ * Cards are rasterized once per module on first use (border, logo and
+ * name) into a page-major thumbnail and blitted with DisplayCanvas::
+ * drawPages() from then on, at any scroll offset. Modules are never
+ * unregistered, so thumbnails live until clearThumbnails(); a card that
+ * cannot be cached (table full, out of memory) is drawn directly.
+ *
  * @author ILITE Framework
  * @date 2025
  */
@@ -61,10 +67,39 @@ public:
      */
     static int getCurrentIndex();
 
+    /**
+     * @brief Free all card thumbnails (rebuilt on next draw)
+     */
+    static void clearThumbnails();
+
+    /**
+     * @brief Heap bytes held by card thumbnails
+     */
+    static size_t getThumbnailBytes();
+
 private:
+    static constexpr size_t kMaxThumbnails = 16;
+
+    enum class CardStyle : uint8_t {
+        Small,      ///< 56x40, selection rings drawn around it
+        Large       ///< 66x50 including the double border
+    };
+
+    struct Thumbnail {
+        const ILITEModule* module;
+        CardStyle style;
+        uint8_t* pages;
+    };
+
     static void drawCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y, bool selected);
     static void drawLargeCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y);
+    static void renderCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y);
+    static void renderLargeCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y);
+    static void drawLogo(DisplayCanvas& canvas, int16_t x, int16_t y, const uint8_t* logo);
+    static const uint8_t* getThumbnail(DisplayCanvas& canvas, ILITEModule* module, CardStyle style);
 
     static int currentIndex_;
     static int scrollOffset_;
+    static Thumbnail thumbnails_[kMaxThumbnails];
+    static size_t thumbnailCount_;
 };
@@ -0,0 +1,136 @@
+/**
+ * @file ModuleBudget.h
+ * @brief Time budgets for module callbacks
+ *
+ * Module code runs on the framework's tasks: a drawDashboard() that takes
+ * 80 ms starves DisplayTask, an updateControl() past the tick delays the
+ * commands. The framework times each call of a module callback against a
+ * budget. ModuleBudget::defaultBudgetUs() gives the framework's defaults;
+ * a module declares its own with ILITEModule::getCallbackBudgetUs(),
+ * read once when the module is first called.
+ *
+ * A call over budget is counted and logged (rate limited). Under
+ * ModuleBudgetPolicy::Skip, kStrikes violations in a row throttle a
+ * skippable callback: it only runs on every kSkipDivider-th call, and the
+ * first of those back within budget lifts the throttle.
+ *
+ * - drawDashboard(): a skipped call skips the frame, so the display keeps
+ *   the last dashboard instead of going blank.
+ * - onService(): a skipped call just does not happen.
+ * - updateControl(), prepareCommandPacket() and handleTelemetry() are only
+ *   warned about. Skipping them would freeze or drop the robot's
+ *   commands; CommTask sheds load with ControlDeadline instead.
+ *
+ * Per-module averages are on the last page of the "framework.profiler"
+ * screen and behind "budget" on the console.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * ModuleCall call(module, ModuleCallback::Draw);
+ * if (call.allowed()) {
+ *     module->drawDashboard(canvas);
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MODULE_BUDGET_H
+#define ILITE_MODULE_BUDGET_H
+
+#include <Arduino.h>
+
+class ILITEModule;
+struct ModuleBudgetEntry;
+
+/// Module callbacks the framework times
+enum class ModuleCallback : uint8_t {
+    Draw,           ///< drawDashboard() (DisplayTask)
+    Control,        ///< updateControl() (CommTask)
+    Prepare,        ///< prepareCommandPacket(), per call (CommTask)
+    Telemetry,      ///< handleTelemetry(), per packet
+    Service,        ///< onService() (ServiceTask)
+    Count
+};
+
+/// What a call over budget leads to
+enum class ModuleBudgetPolicy : uint8_t {
+    Off,            ///< Not timed
+    Warn,           ///< Counted and logged
+    Skip            ///< Also throttle the skippable callbacks
+};
+
+/**
+ * @brief Timing of one callback of one module
+ */
+struct ModuleCallbackStats {
+    uint32_t budgetUs = 0;
+    uint32_t avgUs = 0;             ///< Running average (1/8 weight per call)
+    uint32_t maxUs = 0;
+    uint32_t calls = 0;
+    uint32_t violations = 0;
+    uint32_t skipped = 0;
+    bool throttled = false;
+};
+
+/**
+ * @class ModuleBudget
+ * @brief Static per-module callback table
+ */
+class ModuleBudget {
+public:
+    static constexpr size_t kMaxModules = 8;        ///< The least recently called is replaced
+    static constexpr size_t kCallbackCount = static_cast<size_t>(ModuleCallback::Count);
+    static constexpr uint8_t kStrikes = 3;
+    static constexpr uint8_t kSkipDivider = 4;
+
+    static void setPolicy(ModuleBudgetPolicy policy);
+    static ModuleBudgetPolicy getPolicy();
+
+    /// Framework default budget of a callback
+    static uint32_t defaultBudgetUs(ModuleCallback callback);
+
+    /// Only drawDashboard() and onService() can be skipped
+    static bool isSkippable(ModuleCallback callback);
+
+    static const char* name(ModuleCallback callback);
+
+    /// Modules timed so far, in table order (nullptr for a free slot)
+    static const ILITEModule* getModule(size_t slot);
+    static ModuleCallbackStats getStats(size_t slot, ModuleCallback callback);
+
+    static void reset();
+    static void dump(Print& out);
+
+private:
+    friend class ModuleCall;
+
+    static ModuleBudgetEntry* entryFor(ILITEModule* module);
+    static bool admit(ModuleBudgetEntry* entry, ModuleCallback callback);
+    static void finish(ModuleBudgetEntry* entry, ModuleCallback callback, uint32_t elapsedUs);
+};
+
+/**
+ * @class ModuleCall
+ * @brief Admits and times one module callback for the lifetime of the scope
+ */
+class ModuleCall {
+public:
+    ModuleCall(ILITEModule* module, ModuleCallback callback);
+    ~ModuleCall();
+
+    /// false: the callback is throttled and must not be called this time
+    bool allowed() const { return allowed_; }
+
+    ModuleCall(const ModuleCall&) = delete;
+    ModuleCall& operator=(const ModuleCall&) = delete;
+
+private:
+    ModuleBudgetEntry* entry_;
+    ModuleCallback callback_;
+    int64_t startUs_;
+    bool allowed_;
+};
+
+#endif // ILITE_MODULE_BUDGET_H
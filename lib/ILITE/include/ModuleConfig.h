@@ -0,0 +1,86 @@
+/**
+ * @file ModuleConfig.h
+ * @brief Versioned binary config blobs for ILITEModule config structs
+ *
+ * A module describes its config struct with a ConfigDescriptor (a field
+ * table in the style of PacketDescriptor::Field, plus stable field IDs).
+ * The framework stores the struct in NVS as one blob:
+ *
+ * ```
+ * magic:u16 'IC'  format:u8  fieldCount:u8  version:u16  size:u16  layout:u32
+ * {id:u8 type:u8 offset:u16 size:u16} * fieldCount
+ * image[size]                         raw bytes of the config struct
+ * crc:u16                             CRC-16/CCITT-FALSE over all of the above
+ * ```
+ *
+ * `layout` hashes the struct size and every (id, type, offset, size). When
+ * it matches the module's current descriptor the image is copied into the
+ * struct with a single memcpy. Otherwise the stored field table is used to
+ * migrate: each stored field whose ID still exists with the same type and
+ * size is copied from its old offset to its new one, and every other field
+ * keeps its default. Added, removed, reordered and resized fields therefore
+ * never corrupt each other. A blob with a bad CRC is ignored.
+ *
+ * Blobs live in the "modcfg" NVS namespace under a key derived from the
+ * module ID; save() skips the write when the stored blob is identical.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MODULE_CONFIG_H
+#define ILITE_MODULE_CONFIG_H
+
+#include <Arduino.h>
+#include "ILITEModule.h"
+
+/**
+ * @class ModuleConfigStore
+ * @brief Encode, decode, load and save module config blobs
+ */
+class ModuleConfigStore {
+public:
+    static constexpr size_t kHeaderSize = 12;
+    static constexpr size_t kFieldEntrySize = 6;
+    static constexpr size_t kMaxBlobSize = 256;     ///< Header, field table, image and CRC
+
+    /// Result of decode()
+    enum class LoadResult : uint8_t {
+        Missing,        ///< No stored blob
+        Invalid,        ///< Bad magic, size or CRC (defaults kept)
+        Exact,          ///< Same layout, copied with one memcpy
+        Migrated        ///< Layout changed, fields copied by ID
+    };
+
+    /**
+     * @brief Load the stored config into module.getConfigData()
+     *
+     * Calls onConfigLoaded() when anything was loaded.
+     */
+    static LoadResult load(ILITEModule& module);
+
+    /**
+     * @brief Store module.getConfigData()
+     * @return true if stored or already identical
+     */
+    static bool save(ILITEModule& module);
+
+    /**
+     * @brief Serialize a config struct
+     * @return Blob length, 0 if it does not fit `capacity`
+     */
+    static size_t encode(const ConfigDescriptor& desc, const void* data,
+                         uint8_t* out, size_t capacity);
+
+    /// Deserialize a blob into `data` (which holds the defaults)
+    static LoadResult decode(const ConfigDescriptor& desc, const uint8_t* blob, size_t length,
+                             void* data);
+
+    /// Layout hash of a descriptor
+    static uint32_t layoutHash(const ConfigDescriptor& desc);
+
+    /// Name of a LoadResult for logs
+    static const char* resultName(LoadResult result);
+};
+
+#endif // ILITE_MODULE_CONFIG_H
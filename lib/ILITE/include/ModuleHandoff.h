@@ -0,0 +1,127 @@
+/**
+ * @file ModuleHandoff.h
+ * @brief Epoch-based handoff of the active module between tasks
+ *
+ * CommTask, DisplayTask and RxTask all call into the active module, while
+ * module switches run on ServiceTask. Reading a bare pointer let a switch
+ * deactivate a module in the middle of its updateControl(), drawDashboard()
+ * or handleTelemetry(). ModuleHandoff is a small quiescent-state RCU:
+ *
+ * - **Readers** pin once per iteration (one control tick, one frame, one
+ *   receive batch) with a ModulePin. Any module pointer read while pinned -
+ *   current(), PacketRouter's tables, the team peers - stays valid until
+ *   the pin is released.
+ * - **The writer** publishes the new pointer, then synchronize() waits
+ *   until every reader has either released its pin or pinned again after
+ *   the publish. Only then is the old module deactivated.
+ *
+ * Readers never block and never take a lock; a pin is two atomic stores.
+ * A switch costs the writer at most one iteration of the slowest reader.
+ *
+ * Module change requests from any task (menus, console) are queued with
+ * request() and applied on ServiceTask by ILITEFramework.
+ *
+ * ## Rules:
+ * - Never call synchronize() while pinned: it would wait for itself until
+ *   kGraceTimeoutMs and then proceed.
+ * - Each Reader slot belongs to one task; pins do not nest.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MODULE_HANDOFF_H
+#define ILITE_MODULE_HANDOFF_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class ILITEModule;
+
+/**
+ * @class ModuleHandoff
+ * @brief Static active-module pointer with per-task pins and grace periods
+ */
+class ModuleHandoff {
+public:
+    /// Tasks that call into modules; one pin slot each
+    enum class Reader : uint8_t {
+        Comm,
+        Display,
+        Rx,
+        Web,            ///< WebDashboard task, per telemetry push
+        Count
+    };
+
+    static constexpr uint32_t kGraceTimeoutMs = 1000;
+
+    /**
+     * @brief Enter a read-side section and return the active module
+     * @return The active module (nullptr while none or mid-switch)
+     */
+    static ILITEModule* pin(Reader reader);
+
+    /// Leave the read-side section (quiescent state)
+    static void unpin(Reader reader);
+
+    /// The published module; only safe to call into while pinned or on the writer
+    static ILITEModule* current();
+
+    /// Publish a new active module (writer)
+    static void publish(ILITEModule* module);
+
+    /**
+     * @brief Wait until no reader can still use what was unpublished (writer)
+     * @return false if a reader stayed pinned past the timeout
+     */
+    static bool synchronize(uint32_t timeoutMs = kGraceTimeoutMs);
+
+    /// Ask for a module switch from any task (nullptr = no module)
+    static void request(ILITEModule* module);
+
+    /**
+     * @brief Take the newest pending request (ServiceTask)
+     * @return false if none is pending
+     */
+    static bool takeRequest(ILITEModule*& module);
+
+    static void dump(Print& out);
+
+private:
+    static std::atomic<ILITEModule*> current_;
+    static std::atomic<uint32_t> epoch_;
+    static std::atomic<uint32_t> pins_[static_cast<size_t>(Reader::Count)];   ///< 0 = quiescent
+    static std::atomic<ILITEModule*> requested_;
+    static std::atomic<bool> requestPending_;
+    static uint32_t syncs_;
+    static uint32_t timeouts_;
+    static uint32_t maxGraceUs_;
+};
+
+/**
+ * @class ModulePin
+ * @brief Scoped read-side section
+ *
+ *     ModulePin pin(ModuleHandoff::Reader::Display);
+ *     if (ILITEModule* module = pin.get()) {
+ *         module->drawDashboard(canvas);
+ *     }
+ */
+class ModulePin {
+public:
+    explicit ModulePin(ModuleHandoff::Reader reader)
+        : reader_(reader), module_(ModuleHandoff::pin(reader)) {}
+    ~ModulePin() { ModuleHandoff::unpin(reader_); }
+
+    ModulePin(const ModulePin&) = delete;
+    ModulePin& operator=(const ModulePin&) = delete;
+
+    /// Active module when the pin was taken
+    ILITEModule* get() const { return module_; }
+
+private:
+    ModuleHandoff::Reader reader_;
+    ILITEModule* module_;
+};
+
+#endif // ILITE_MODULE_HANDOFF_H
@@ -70,6 +70,8 @@ struct ModuleMenuItem {
     float maxValueFloat = 100.0f;         ///< Maximum float value for editing
     float step = 1.0f;                    ///< Step size for editing
     float coarseStep = 10.0f;             ///< Coarse step size for fast editing
+    bool liveEdit = false;                ///< Apply while turning, coalesced (see MenuEntry)
+    std::function<bool()> isPending;      ///< Value not yet confirmed by the robot (optional)
 
     // Editable string support
     std::function<void(char*, size_t)> getStringValue; ///< Populate buffer with current value
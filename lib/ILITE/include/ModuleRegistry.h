@@ -11,7 +11,24 @@
 
 #pragma once
 #include "ILITEModule.h"
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-size list of registered modules (static storage, no heap)
+ */
+struct ModuleList {
+    static constexpr size_t kCapacity = 16;     ///< Maximum registered modules
+
+    ILITEModule* items[kCapacity];
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    ILITEModule* operator[](size_t index) const { return index < count ? items[index] : nullptr; }
+    ILITEModule* const* begin() const { return items; }
+    ILITEModule* const* end() const { return items + count; }
+};
 
 /**
  * @brief Central registry for all ILITE modules
@@ -27,6 +44,22 @@
  * 4. Module instance registered in global registry
  * 5. Framework discovers all modules via `ModuleRegistry::getModules()`
  *
+ * ## Name Matching
+ * Detection keywords are indexed once, when modules are initialized: every
+ * keyword is hashed and the table is sorted by (length, hash). A lookup then
+ * slides a rolling hash of each indexed length over the device name and
+ * binary-searches the table, so the cost depends on the name length and the
+ * number of distinct keyword lengths, not on the number of modules or
+ * keywords. The last matched name is remembered, so a robot that reboots and
+ * re-pairs under the same name resolves with a single hash compare.
+ *
+ * ## Magic Matching
+ * The same pass indexes every module's telemetry magic numbers, sorted for
+ * binary search. A robot whose name matches no keyword is still recognised
+ * by the first telemetry packet it sends: findModuleByMagic() names the one
+ * module that declares that magic. A magic declared by two modules names
+ * neither, so shared packet types never pick a module by accident.
+ *
  * ## Thread Safety
  * Registration must complete before ILITE.begin() is called (single-threaded).
  * After begin(), the registry is read-only (thread-safe).
@@ -42,12 +75,15 @@ public:
      */
     static void registerModule(ILITEModule* module);
 
+    static constexpr size_t kMaxKeywords = 48;  ///< Indexed detection keywords (all modules)
+    static constexpr size_t kMaxMagics = 64;    ///< Indexed telemetry magics (all modules)
+
     /**
      * @brief Get all registered modules
      *
-     * @return Vector of module pointers
+     * @return List of module pointers in registration order
      */
-    static std::vector<ILITEModule*>& getModules();
+    static const ModuleList& getModules();
 
     /**
      * @brief Get number of registered modules
@@ -62,7 +98,8 @@ public:
      * Searches all modules' detection keywords for a match against the
      * device name. Used for automatic module selection when pairing.
      *
-     * Case-insensitive substring search.
+     * Case-insensitive substring search. When several keywords occur in the
+     * name, the earliest registered module (then its earliest keyword) wins.
      *
      * Example:
      * - Device name: "MyRobot-Alpha"
@@ -82,6 +119,18 @@ public:
      */
     static ILITEModule* findModuleById(const char* moduleId);
 
+    /**
+     * @brief Find the module that declares a telemetry magic number
+     *
+     * Used when pairing found no module by name: the first telemetry packet
+     * from the robot identifies it. Descriptors are read when the index is
+     * built, before any module's onInit(), so they must not depend on it.
+     *
+     * @param magic Magic number of a telemetry packet (first 4 bytes)
+     * @return Pointer to the only module declaring it, or nullptr if none or several do
+     */
+    static ILITEModule* findModuleByMagic(uint32_t magic);
+
     /**
      * @brief Get module by index
      *
@@ -91,15 +140,27 @@ public:
     static ILITEModule* getModuleByIndex(size_t index);
 
     /**
-     * @brief Initialize all registered modules
+     * @brief Prepare the registry at startup
      *
-     * Calls onInit() for each module. Called once by framework at startup.
-     * Users should not call this directly.
+     * Builds the keyword index. Modules are not initialized here: onInit()
+     * runs on first use through ensureInitialized(). Called once by
+     * framework at startup. Users should not call this directly.
      */
     static void initializeAll();
 
+    /**
+     * @brief Run a module's onInit() if it has not run yet
+     *
+     * Called by the framework before a module is activated or drives a
+     * team peer.
+     */
+    static void ensureInitialized(ILITEModule* module);
+
 private:
     ModuleRegistry() = delete;  // Static class, no instances
+
+    /// Rebuild the keyword and magic tables if modules changed
+    static void buildKeywordIndex();
 };
 
 /**
@@ -0,0 +1,53 @@
+/**
+ * @file ModuleSelection.h
+ * @brief Build-time selection of the built-in modules
+ *
+ * Every built-in module is compiled only when its ILITE_MODULE_* flag is 1.
+ * All of them are on by default. A platformio.ini env either turns off the
+ * ones its controller never pairs with, or starts from none and lists the
+ * ones it keeps:
+ *
+ * ```ini
+ * build_flags = -DILITE_MODULES_DEFAULT=0 -DILITE_MODULE_DRONGAZE=1
+ * ```
+ *
+ * A disabled module's class, screens, menus, logo and config descriptor
+ * are not compiled, so nothing references its protocol and helper files
+ * (drongaze.cpp, PidAutoTune.cpp, ...) and --gc-sections drops them from
+ * the image. registerBuiltInModules() registers whatever is left.
+ *
+ * tools/module_footprint.py (extra_scripts in platformio.ini) reports the
+ * flash and RAM each module costs from the linker map after every build.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MODULE_SELECTION_H
+#define ILITE_MODULE_SELECTION_H
+
+/// Value of every ILITE_MODULE_* flag the build does not set
+#ifndef ILITE_MODULES_DEFAULT
+#define ILITE_MODULES_DEFAULT 1
+#endif
+
+/// TheGill four-wheel drive with mechanical arm (arm IK, pose recorder)
+#ifndef ILITE_MODULE_THEGILL
+#define ILITE_MODULE_THEGILL ILITE_MODULES_DEFAULT
+#endif
+
+/// DroneGaze quadcopter (PID trace, spectrum, auto-tune)
+#ifndef ILITE_MODULE_DRONGAZE
+#define ILITE_MODULE_DRONGAZE ILITE_MODULES_DEFAULT
+#endif
+
+/// Bulky utility carrier
+#ifndef ILITE_MODULE_BULKY
+#define ILITE_MODULE_BULKY ILITE_MODULES_DEFAULT
+#endif
+
+/// Built-in modules compiled into this image
+#define ILITE_BUILTIN_MODULE_COUNT \
+    (ILITE_MODULE_THEGILL + ILITE_MODULE_DRONGAZE + ILITE_MODULE_BULKY)
+
+#endif // ILITE_MODULE_SELECTION_H
@@ -7,9 +7,16 @@
  * ModuleShell is responsible for rendering the module status strip, delegating
  * drawing to the active module, and hosting the module-specific menu overlay.
  * It also centralises encoder/button handling while a module is active.
+ *
+ * Menu traversal allocates nothing once the menu is open: rebuildMenu()
+ * lays out a span of child index slots per submenu, and the visible
+ * children of a node are evaluated into its span at most once per
+ * visibility generation. draw() bumps the generation every frame, so
+ * encoder steps between frames work on exactly the list that is on screen.
  */
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class ILITEModule;
@@ -49,13 +56,73 @@ public:
      */
     static void reset();
 
+    /**
+     * @brief Re-evaluate menu item conditions on the next traversal
+     *
+     * Called by draw() once per frame; modules may call it after a state
+     * change that should show or hide entries immediately.
+     */
+    static void invalidateVisibility();
+
+    /**
+     * @brief Visible children of a menu node, as a view over its cached span
+     *
+     * Valid until the menu is rebuilt. Iterating yields ModuleMenuItem&.
+     */
+    class VisibleChildren {
+    public:
+        class Iterator {
+        public:
+            Iterator(const VisibleChildren* range, uint16_t pos) : range_(range), pos_(pos) {}
+            ModuleMenuItem& operator*() const { return *range_->at(pos_); }
+            Iterator& operator++() { ++pos_; return *this; }
+            bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+        private:
+            const VisibleChildren* range_;
+            uint16_t pos_;
+        };
+
+        VisibleChildren() = default;
+        VisibleChildren(ModuleMenuItem* node, const uint16_t* index, uint16_t count)
+            : node_(node), index_(index), count_(count) {}
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+
+        /// Child at a visible position, nullptr if out of range
+        ModuleMenuItem* at(int pos) const {
+            if (pos < 0 || pos >= count_) {
+                return nullptr;
+            }
+            return &node_->children[index_[pos]];
+        }
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, count_); }
+
+    private:
+        ModuleMenuItem* node_ = nullptr;
+        const uint16_t* index_ = nullptr;
+        uint16_t count_ = 0;
+    };
+
 private:
     struct MenuLevel {
         ModuleMenuItem* node;
+        uint16_t span;          ///< Into spans_
         int focus = 0;
         int scroll = 0;
 
-        MenuLevel(ModuleMenuItem* n, int f, int s) : node(n), focus(f), scroll(s) {}
+        MenuLevel(ModuleMenuItem* n, uint16_t sp, int f, int s) : node(n), span(sp), focus(f), scroll(s) {}
+    };
+
+    /// Visible children of one submenu: visibleIndex_[first .. first + count)
+    struct MenuSpan {
+        const ModuleMenuItem* node;
+        uint16_t first;         ///< node->children.size() slots are reserved
+        uint16_t count;
+        uint32_t generation;    ///< generation_ the span was evaluated in (0 = never)
     };
 
     static void rebuildMenu();
@@ -68,14 +135,21 @@ private:
 
     static void drawMenuOverlay(DisplayCanvas& canvas);
     static ModuleMenuItem* currentMenuNode();
-    static std::vector<ModuleMenuItem*> collectVisibleChildren(ModuleMenuItem& node);
-    static ModuleMenuItem* visibleChildAt(ModuleMenuItem& node, int index);
+    static VisibleChildren visibleChildren(const MenuLevel& level);
+
+    /// Lay out spans_ for every submenu of the tree (allocates; rebuild only)
+    static void indexMenu(const ModuleMenuItem& node, size_t& maxChildren);
+    static uint16_t spanFor(const ModuleMenuItem* node);
 
     static ILITEModule* activeModule_;
     static bool menuOpen_;
     static ModuleMenuItem menuRoot_;
     static ModuleMenuBuilder menuBuilder_;
     static std::vector<MenuLevel> menuStack_;
+    static std::vector<MenuSpan> spans_;
+    static std::vector<uint16_t> visibleIndex_;
+    static std::vector<UIComponents::MenuItem> menuItems_;
+    static uint32_t generation_;
 
     // Input edge tracking
     static int lastEncoderCount_;
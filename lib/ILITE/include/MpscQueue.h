@@ -0,0 +1,90 @@
+/**
+ * @file MpscQueue.h
+ * @brief Bounded lock-free multi-producer / single-consumer queue
+ *
+ * Any task (or an ESP-NOW callback) may push; exactly one task pops.
+ * Producers claim a slot with a compare-and-swap on the head index, so a
+ * push never takes a lock and never blocks. When the queue is full push()
+ * returns false and the item is dropped.
+ *
+ * Each slot stores its sequence number relative to its index, which makes
+ * the all-zero state valid: a global MpscQueue works before any constructor
+ * or setup code has run.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * static MpscQueue<Request, 8> requests;
+ * requests.push(request);          // any task
+ * while (requests.pop(request)) {  // consumer task only
+ *     handle(request);
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_MPSC_QUEUE_H
+#define ILITE_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T, uint32_t Size>
+class MpscQueue {
+    static_assert((Size & (Size - 1)) == 0, "MpscQueue size must be a power of 2");
+
+public:
+    /// Add an item (any task); false if the queue is full
+    bool push(const T& item) {
+        uint32_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t index = pos & (Size - 1);
+            Slot& slot = slots_[index];
+            const uint32_t sequence = slot.sequence.load(std::memory_order_acquire) + index;
+            const int32_t diff = static_cast<int32_t>(sequence - pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(pos + 1 - index, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Remove the oldest item (consumer only); false if empty
+    bool pop(T& out) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t index = tail & (Size - 1);
+        Slot& slot = slots_[index];
+        if (slot.sequence.load(std::memory_order_acquire) + index != tail + 1) {
+            return false;
+        }
+        out = slot.item;
+        slot.sequence.store(tail + Size - index, std::memory_order_release);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// True if no items are waiting (approximate while producers are active)
+    bool empty() const {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};
+        T item{};
+    };
+
+    Slot slots_[Size];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+};
+
+#endif // ILITE_MPSC_QUEUE_H
@@ -0,0 +1,88 @@
+/**
+ * @file OtaReceiver.h
+ * @brief Compressed OTA: zlib image streamed through inflate into Update
+ *
+ * espota (the ILITE_OTA env) sends the raw image over the softAP and
+ * ArduinoOTA hands the bytes straight to Update, so the image cannot be
+ * compressed on the way. In maintenance mode OtaReceiver listens on a
+ * second TCP port next to ArduinoOTA for tools/ota_push.py, which sends
+ * the image zlib-compressed:
+ *
+ *     [header:32][payload...]        host -> controller
+ *     "GO\n" | "ERR <reason>\n"      after the header
+ *     "OK\n" | "ERR <reason>\n"      after the payload
+ *
+ * Header, little-endian: magic 'ILOZ', version, encoding (0 raw, 1 zlib),
+ * reserved u16, image bytes, payload bytes, MD5 of the image. Update
+ * verifies the MD5 at the end, and the controller reboots on "OK".
+ *
+ * The payload is inflated as it arrives with the tinfl decoder in the
+ * ESP32 ROM (no flash cost) into its 32 KB wrap-around dictionary, and
+ * every chunk of output is written to the OTA partition at once, so
+ * nothing the size of the image is ever held in RAM. The decoder and
+ * dictionary (~43 KB) are allocated for the transfer only; the real-time
+ * tasks are parked in maintenance mode, so the heap is there.
+ *
+ * Raw payloads (encoding 0, `ota_push.py --raw`) go through the same path
+ * uncompressed, which is how the two are compared (docs/ota.md).
+ *
+ * ## Thread Safety:
+ * ServiceTask only (handle() runs from ILITEFramework::handleOTA()). A
+ * transfer blocks the caller until it finishes, like ArduinoOTA.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_OTA_RECEIVER_H
+#define ILITE_OTA_RECEIVER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Result of the last transfer
+ */
+struct OtaReceiverStats {
+    uint32_t imageBytes = 0;        ///< Firmware written to the OTA partition
+    uint32_t payloadBytes = 0;      ///< Bytes received over TCP
+    uint32_t elapsedMs = 0;         ///< Header to last byte written
+    uint8_t encoding = 0;
+    bool ok = false;
+    const char* error = nullptr;    ///< Why the last transfer failed
+};
+
+/**
+ * @class OtaReceiver
+ * @brief TCP listener that flashes raw or zlib-compressed images
+ */
+class OtaReceiver {
+public:
+    static constexpr uint16_t kDefaultPort = 3233;      ///< ArduinoOTA uses 3232
+    static constexpr uint8_t kEncodingRaw = 0;
+    static constexpr uint8_t kEncodingZlib = 1;
+
+    typedef void (*StartCallback)();
+    typedef void (*ProgressCallback)(int percent);
+
+    /**
+     * @brief Start listening (maintenance mode)
+     * @param onStart Called once a valid header arrived, before flashing
+     * @param onProgress Called when the received percentage changes
+     */
+    static bool begin(uint16_t port, StartCallback onStart, ProgressCallback onProgress);
+
+    /// Stop listening
+    static void end();
+
+    /// Accept and run a pending transfer; reboots after a successful one
+    static void handle();
+
+    static const OtaReceiverStats& getStats() { return stats_; }
+
+    static void dump(Print& out);
+
+private:
+    static OtaReceiverStats stats_;
+};
+
+#endif // ILITE_OTA_RECEIVER_H
@@ -0,0 +1,103 @@
+/**
+ * @file PacketBundle.h
+ * @brief Pack several small packets into a single ESP-NOW frame
+ *
+ * Modules with many command types (drive, peripheral, arm, ...) would
+ * otherwise cost one radio transaction per type per control tick. Command
+ * descriptors marked `bundleable` are packed into one frame:
+ *
+ *     [BUNDLE_MAGIC:4][len:1][packet bytes...][len:1][packet bytes...]...
+ *
+ * The receiver recognises the bundle magic and hands each sub-packet to its
+ * normal handler. PacketRouter does this for telemetry bundles.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PACKET_BUNDLE_H
+#define ILITE_PACKET_BUNDLE_H
+
+#include <Arduino.h>
+
+/// Magic that marks a bundle frame ('BNDL')
+constexpr uint32_t BUNDLE_PACKET_MAGIC = 0x424E444C;
+
+/**
+ * @class PacketBundleWriter
+ * @brief Accumulates length-prefixed packets into one frame buffer
+ */
+class PacketBundleWriter {
+public:
+    static constexpr size_t kMaxFrameSize = 250;    ///< ESP-NOW maximum payload
+    static constexpr size_t kHeaderSize = sizeof(uint32_t);
+
+    PacketBundleWriter();
+
+    /**
+     * @brief Discard all queued packets
+     */
+    void reset();
+
+    /**
+     * @brief Keep `bytes` of the frame free for an outer header
+     *
+     * Used when CommTask wraps frames in a command stamp (CommandStamp.h).
+     */
+    void setHeadroom(size_t bytes) { headroom_ = bytes < kMaxFrameSize ? bytes : kMaxFrameSize; }
+
+    /**
+     * @brief Append one packet
+     * @return false if it does not fit (caller should flush and retry)
+     */
+    bool append(const uint8_t* packet, size_t length);
+
+    /**
+     * @brief Check whether a packet of this length would still fit
+     */
+    bool fits(size_t length) const;
+
+    /// Number of packets queued
+    size_t getCount() const { return count_; }
+
+    /// True if nothing queued
+    bool isEmpty() const { return count_ == 0; }
+
+    /// Frame bytes (valid while getCount() > 0)
+    const uint8_t* data() const { return buffer_; }
+
+    /// Frame length including magic
+    size_t size() const { return length_; }
+
+    /**
+     * @brief The single queued packet without bundle framing
+     *
+     * A one-packet bundle is sent as a plain packet so peers that do not
+     * understand bundles keep working when only one type is dirty.
+     */
+    const uint8_t* firstPacket(size_t& length) const;
+
+private:
+    uint8_t buffer_[kMaxFrameSize];
+    size_t length_;
+    size_t count_;
+    size_t headroom_;
+};
+
+/**
+ * @brief Check whether a received frame is a bundle
+ */
+bool isPacketBundle(const uint8_t* data, size_t length);
+
+/**
+ * @brief Invoke `handler` for each sub-packet of a bundle frame
+ *
+ * Stops at the first malformed length prefix.
+ *
+ * @return Number of sub-packets delivered, or -1 if the frame is malformed
+ */
+int forEachBundledPacket(const uint8_t* data, size_t length,
+                         void (*handler)(const uint8_t* packet, size_t length, void* context),
+                         void* context);
+
+#endif // ILITE_PACKET_BUNDLE_H
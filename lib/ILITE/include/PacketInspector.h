@@ -0,0 +1,104 @@
+/**
+ * @file PacketInspector.h
+ * @brief Live telemetry packet inspector driven by PacketDescriptor field tables
+ *
+ * PacketDescriptor::Field tables describe each telemetry packet, but nothing
+ * used them: the generic module dumped the first 8 bytes in hex. The
+ * inspector screen ("framework.packets") decodes the latest packet of the
+ * selected type field by field and shows per-type traffic statistics:
+ *
+ * - **Zero-copy decode**: fields are formatted straight out of the
+ *   TelemetryStore slot with TelemetrySlot::inspect(). The router's slot is
+ *   never copied or locked, so an open inspector does not change RxTask
+ *   timing; a pass torn by a new packet is simply redone.
+ * - **Per-type statistics**: PacketRouter calls record() for every
+ *   validated packet of the active module (a few adds on RxTask). The
+ *   screen shows the arrival rate, average interval and longest gap (from
+ *   TelemetryHealth), last/min/max size, a size histogram in 32-byte
+ *   buckets and a histogram of inter-arrival jitter (the deviation of each
+ *   interval from the running average interval).
+ *
+ * Screen controls: encoder scrolls the fields, encoder press selects the
+ * next packet type, B2 switches between fields and histograms, B3 resets
+ * the statistics, B1 goes back. "packets" on the console prints the same
+ * statistics.
+ *
+ * ## Thread Safety:
+ * record() runs on RxTask only. The statistics are read without locking by
+ * the screen and the console; a counter may be one packet stale.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PACKET_INSPECTOR_H
+#define ILITE_PACKET_INSPECTOR_H
+
+#include <Arduino.h>
+#include "ILITEModule.h"
+
+constexpr size_t kPacketHistogramBuckets = 8;
+
+/**
+ * @brief Traffic statistics of one telemetry packet type
+ */
+struct PacketTypeStats {
+    uint32_t packets;
+    uint32_t jitterAvgUs;           ///< Running average |interval - average|
+    uint32_t jitterMaxUs;
+    uint16_t lastSize;
+    uint16_t minSize;
+    uint16_t maxSize;
+    uint32_t sizeHistogram[kPacketHistogramBuckets];     ///< 32-byte buckets
+    uint32_t jitterHistogram[kPacketHistogramBuckets];   ///< kJitterBucketUs
+};
+
+/**
+ * @class PacketInspector
+ * @brief Static packet statistics and the inspector screen
+ */
+class PacketInspector {
+public:
+    static constexpr size_t kMaxTypes = 8;              ///< TelemetryStore::kMaxSlots
+    static constexpr size_t kSizeBucketBytes = 32;
+
+    /// Upper bounds of the jitter histogram buckets (us)
+    static const uint32_t kJitterBucketUs[kPacketHistogramBuckets];
+
+    /// Register the inspector screen
+    static void begin();
+
+    /**
+     * @brief Account one validated telemetry packet (RxTask)
+     *
+     * Call after TelemetryHealth::record(), which measures the interval.
+     *
+     * @param typeIndex Descriptor index in the active module
+     * @param intervalUs Interval to the previous packet of the type (0 for the first)
+     */
+    static void record(size_t typeIndex, size_t length, uint32_t intervalUs);
+
+    /// Clear all statistics (module change, B3 on the screen)
+    static void reset();
+
+    /// Statistics of one type (nullptr if out of range)
+    static const PacketTypeStats* getStats(size_t typeIndex);
+
+    /**
+     * @brief Format one field of a packet as text
+     *
+     * Reads the field bytes at their offset (unaligned access is fine).
+     * Fields that extend past `length` print "--".
+     *
+     * @return Characters written
+     */
+    static size_t formatField(const PacketDescriptor::Field& field, const uint8_t* data, size_t length,
+                              char* out, size_t outSize);
+
+    static void dump(Print& out);
+
+private:
+    static PacketTypeStats stats_[kMaxTypes];
+};
+
+#endif // ILITE_PACKET_INSPECTOR_H
@@ -0,0 +1,189 @@
+/**
+ * @file PacketLayout.h
+ * @brief Compile-time PacketDescriptor tables derived from the packet structs
+ *
+ * Descriptors written by hand inside getTelemetryPacketDescriptor() are
+ * built again on every call, and their sizes and field offsets are typed
+ * in separately from the structs they describe, so the two can drift
+ * apart. The macros here derive everything from the struct definitions
+ * with sizeof/offsetof, so a module keeps its descriptors as constexpr
+ * tables in flash and hands out entries of them:
+ *
+ * - **ILITE_PACKET_FIELD(Struct, member)**: Field named after the member.
+ *   The Field::Type follows the member's C++ type: integers by size and
+ *   sign, float, bool, enums by their underlying type. Arrays and other
+ *   types become BYTE_ARRAY.
+ * - **ILITE_PACKET_FIELD_NAMED(Struct, member, name)**: the same, with a
+ *   display name.
+ * - **ILITE_PACKET_ELEMENT(Struct, member, index, name)**: one element of
+ *   an array member.
+ * - **ILITE_PACKET(Struct, name, magic)** and
+ *   **ILITE_PACKET_WITH_FIELDS(Struct, name, magic, fields)**: the first
+ *   seven arguments of the PacketDescriptor constructor for a fixed-size
+ *   packet (minSize = maxSize = sizeof(Struct), magic checked). Put them in
+ *   braces, which calls the constexpr constructor, and continue with the
+ *   optional arguments (bundleable, keepaliveMs, redundancy, periodMs,
+ *   priority, staleAfterMs, deltaEncoded, timestampOffset) as far as needed.
+ * - **ILITE_PACKET_RANGE(name, magic, minSize, maxSize)**: the same for a
+ *   variable-length packet without a field table.
+ *
+ * The tables are constant expressions in gnu++11 too: PacketDescriptor is
+ * not an aggregate, and every brace list goes through its constructor.
+ *
+ * When the tables are declared constexpr, the compiler rejects:
+ * - a packet struct larger than an ESP-NOW frame or not trivially copyable;
+ * - fields that are empty, reach past the struct, overlap or are out of
+ *   offset order;
+ * - an array element past the end of its member;
+ * - minSize > maxSize.
+ * The messages name PacketLayout::fieldOutsideStruct() and the other
+ * check functions.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * constexpr PacketDescriptor::Field kStateFields[] = {
+ *     ILITE_PACKET_FIELD(RobotState, magic),
+ *     ILITE_PACKET_FIELD_NAMED(RobotState, batteryMillivolts, "batteryMv"),
+ *     ILITE_PACKET_ELEMENT(RobotState, wheelSpeed, 0, "left"),
+ *     ILITE_PACKET_ELEMENT(RobotState, wheelSpeed, 1, "right"),
+ * };
+ *
+ * constexpr PacketDescriptor kTelemetry[] = {
+ *     {ILITE_PACKET_WITH_FIELDS(RobotState, "State", STATE_MAGIC, kStateFields)},
+ *     // bundleable, keepaliveMs, redundancy, periodMs, priority, staleAfterMs
+ *     {ILITE_PACKET(RobotLog, "Log", LOG_MAGIC), false, 0, 0, 0, 0, 2000},
+ * };
+ *
+ * size_t getTelemetryPacketTypeCount() const override { return PacketLayout::countOf(kTelemetry); }
+ * PacketDescriptor getTelemetryPacketDescriptor(size_t index) const override {
+ *     return PacketLayout::at(kTelemetry, index);
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PACKET_LAYOUT_H
+#define ILITE_PACKET_LAYOUT_H
+
+#include <Arduino.h>
+#include <cstddef>
+#include <type_traits>
+#include "ILITEModule.h"
+
+/**
+ * @brief PacketDescriptor::Field::Type of a member type
+ */
+template<typename T, bool IsEnum = std::is_enum<T>::value>
+struct PacketFieldType {
+    static constexpr PacketDescriptor::Field::Type value =
+        std::is_same<T, bool>::value ? PacketDescriptor::Field::BOOL
+        : std::is_same<T, float>::value ? PacketDescriptor::Field::FLOAT
+        : !std::is_integral<T>::value ? PacketDescriptor::Field::BYTE_ARRAY
+        : sizeof(T) == 1 ? (std::is_signed<T>::value ? PacketDescriptor::Field::INT8
+                                                     : PacketDescriptor::Field::UINT8)
+        : sizeof(T) == 2 ? (std::is_signed<T>::value ? PacketDescriptor::Field::INT16
+                                                     : PacketDescriptor::Field::UINT16)
+        : sizeof(T) == 4 ? (std::is_signed<T>::value ? PacketDescriptor::Field::INT32
+                                                     : PacketDescriptor::Field::UINT32)
+        : PacketDescriptor::Field::BYTE_ARRAY;
+};
+
+template<typename T>
+struct PacketFieldType<T, true> : PacketFieldType<typename std::underlying_type<T>::type> {};
+
+/**
+ * @class PacketLayout
+ * @brief Checks and helpers behind the descriptor macros
+ */
+class PacketLayout {
+public:
+    static constexpr size_t kMaxPacketSize = 250;   ///< ESP-NOW payload (TelemetrySlot::kMaxSize)
+
+    /// sizeof(Struct), rejected at compile time if it cannot be a packet
+    template<typename Struct>
+    static constexpr size_t sizeOf() {
+        static_assert(std::is_trivially_copyable<Struct>::value, "Packet structs must be trivially copyable");
+        static_assert(sizeof(Struct) <= kMaxPacketSize, "Packet struct is larger than an ESP-NOW frame");
+        return sizeof(Struct);
+    }
+
+    /// `fields`, checked against sizeof(Struct)
+    template<typename Struct, size_t N>
+    static constexpr const PacketDescriptor::Field* checkFields(const PacketDescriptor::Field (&fields)[N]) {
+        return fieldsFit(fields, N, sizeOf<Struct>(), 0) ? fields : (fieldOutsideStruct(), fields);
+    }
+
+    /// maxSize, checked against minSize and the frame size
+    static constexpr size_t checkRange(size_t minSize, size_t maxSize) {
+        return minSize <= maxSize && maxSize <= kMaxPacketSize ? maxSize : (sizeRangeInvalid(), maxSize);
+    }
+
+    /// Byte offset of element `index` of an array member
+    static constexpr size_t elementOffset(size_t memberOffset, size_t index, size_t extent, size_t elementSize) {
+        return index < extent ? memberOffset + index * elementSize : (elementOutsideArray(), memberOffset);
+    }
+
+    template<typename T, size_t N>
+    static constexpr size_t countOf(const T (&)[N]) {
+        return N;
+    }
+
+    /// Entry `index` of a descriptor table, or an empty descriptor past the end
+    template<size_t N>
+    static const PacketDescriptor& at(const PacketDescriptor (&table)[N], size_t index) {
+        return index < N ? table[index] : empty();
+    }
+
+    static const PacketDescriptor& empty() {
+        static constexpr PacketDescriptor kEmpty{};
+        return kEmpty;
+    }
+
+    /// Fields non-empty, in offset order, without overlap, inside `size`
+    static constexpr bool fieldsFit(const PacketDescriptor::Field* fields, size_t count, size_t size, size_t end) {
+        return count == 0 ||
+               (fields->size > 0 && fields->offset >= end && fields->offset + fields->size <= size &&
+                fieldsFit(fields + 1, count - 1, size, fields->offset + fields->size));
+    }
+
+private:
+    // Not constexpr: reaching one while evaluating a constexpr table is the
+    // compile error. They do nothing when a table is built at run time.
+    static size_t fieldOutsideStruct() { return 0; }
+    static size_t sizeRangeInvalid() { return 0; }
+    static size_t elementOutsideArray() { return 0; }
+};
+
+/// Field named after `member` of `Struct`, type from the member's C++ type
+#define ILITE_PACKET_FIELD(Struct, member) ILITE_PACKET_FIELD_NAMED(Struct, member, #member)
+
+/// Field for `Struct::member` shown as `name`
+#define ILITE_PACKET_FIELD_NAMED(Struct, member, name) \
+    PacketDescriptor::Field{name, offsetof(Struct, member), sizeof(Struct::member), \
+        PacketFieldType<typename std::remove_cv<decltype(Struct::member)>::type>::value}
+
+/// Element `index` of the array member `Struct::member`, shown as `name`
+#define ILITE_PACKET_ELEMENT(Struct, member, index, name) \
+    PacketDescriptor::Field{name, \
+        PacketLayout::elementOffset(offsetof(Struct, member), index, \
+                                    std::extent<decltype(Struct::member)>::value, sizeof(Struct::member[0])), \
+        sizeof(Struct::member[0]), \
+        PacketFieldType<typename std::remove_cv< \
+            typename std::remove_extent<decltype(Struct::member)>::type>::type>::value}
+
+/// First seven PacketDescriptor constructor arguments: fixed-size packet without fields
+#define ILITE_PACKET(Struct, name, magic) \
+    name, magic, PacketLayout::sizeOf<Struct>(), PacketLayout::sizeOf<Struct>(), true, nullptr, 0
+
+/// First seven PacketDescriptor constructor arguments: fixed-size packet with a field table
+#define ILITE_PACKET_WITH_FIELDS(Struct, name, magic, fields) \
+    name, magic, PacketLayout::sizeOf<Struct>(), PacketLayout::sizeOf<Struct>(), true, \
+    PacketLayout::checkFields<Struct>(fields), PacketLayout::countOf(fields)
+
+/// First seven PacketDescriptor constructor arguments: variable-length packet without fields
+#define ILITE_PACKET_RANGE(name, magic, minSize, maxSize) \
+    name, magic, minSize, PacketLayout::checkRange(minSize, maxSize), true, nullptr, 0
+
+#endif // ILITE_PACKET_LAYOUT_H
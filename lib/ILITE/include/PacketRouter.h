@@ -8,23 +8,37 @@
  *
  * ## Usage Example:
  * ```cpp
- * // In ESP-NOW receive callback:
- * void onDataRecv(const uint8_t* mac, const uint8_t* data, int len) {
- *     PacketRouter::getInstance().routePacket(mac, data, len);
- * }
+ * // In the receive consumer task (frames drained from RxRing):
+ * PacketRouter::getInstance().routePacket(frame.mac, frame.data, frame.length, frame.timestampUs);
  * ```
  *
  * ## How It Works:
- * 1. Packet arrives via ESP-NOW
- * 2. Router reads magic number (first 4 bytes)
- * 3. Queries active module's telemetry descriptors
- * 4. Finds matching descriptor by magic number
+ * 1. setActiveModule() snapshots the module's telemetry descriptors into a
+ *    small open-addressed magic -> (type index, size range) table
+ * 2. Packet arrives via ESP-NOW
+ * 3. Router reads magic number (first 4 bytes)
+ * 4. Looks the magic up in the table (no virtual descriptor calls)
  * 5. Validates packet size
  * 6. Calls module's handleTelemetry() with type index
  *
+ * Bundle frames (see PacketBundle.h) are split and each sub-packet is routed
+ * through the same steps. Delta frames (see DeltaPacket.h) of descriptors
+ * with `deltaEncoded` are rebuilt into the full packet before step 5.
+ *
+ * ## Team Peers:
+ * setPeerModule() gives an extra robot its own module and dispatch table,
+ * keyed by MAC. Frames from that MAC go to its module; everything else goes
+ * to the active module. Only the active module's telemetry is published to
+ * TelemetryStore and TelemetryTap.
+ *
  * ## Thread Safety:
- * All methods are thread-safe. ESP-NOW callbacks run in WiFi task context,
- * so the router uses FreeRTOS mutexes to protect shared state.
+ * Module changes never block the packet path. Tables are published with a
+ * `live` flag: setActiveModule() and setPeerModule() take the table out of
+ * routing, wait for a ModuleHandoff grace period, rebuild it and publish it
+ * again. routePacket() must therefore run inside a ModulePin (RxTask, and
+ * CommTask during input replay); the route mutex only keeps those two
+ * routing tasks apart and is uncontended outside replay. Packets are never
+ * routed from the WiFi task.
  *
  * @author ILITE Framework
  * @version 1.0.0
@@ -36,7 +50,9 @@
 #include <Arduino.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <atomic>
 #include "ILITEModule.h"
+#include "DeltaPacket.h"
 
 /**
  * @class PacketRouter
@@ -67,30 +83,55 @@ public:
      * @brief Set the currently active module
      *
      * The router only routes packets to the active module. When modules are
-     * switched, call this to update routing.
+     * switched, call this to update routing. Waits for a ModuleHandoff grace
+     * period (never call it while pinned); on return no task is still
+     * routing to the previous module.
      *
      * @param module Pointer to the active module (nullptr to disable routing)
      */
     void setActiveModule(ILITEModule* module);
 
+    /**
+     * @brief Keep the last module's telemetry while it is in standby
+     *
+     * The TelemetryStore slots of the module switched away from move to the
+     * store's second bank instead of being cleared, and come back if that
+     * module is activated next (see ILITEConfig::moduleStandby).
+     */
+    void setModuleStandby(bool enable) { moduleStandby_ = enable; }
+
     /**
      * @brief Get the currently active module
      * @return Pointer to active module, or nullptr if none active
      */
     ILITEModule* getActiveModule() const;
 
+    /// Peers routed to their own module next to the active one
+    static constexpr size_t kMaxPeerRoutes = 2;
+
+    /**
+     * @brief Route a team peer's frames to its own module
+     *
+     * @param mac Peer MAC address (6 bytes)
+     * @param module Module driving that peer (nullptr removes the route)
+     * @return false if all kMaxPeerRoutes routes are taken
+     */
+    bool setPeerModule(const uint8_t* mac, ILITEModule* module);
+
     /**
      * @brief Route an incoming packet to the appropriate module
      *
-     * Called by ESP-NOW receive callback. Examines packet magic number,
+     * Called by the receive consumer task. Examines packet magic number,
      * finds matching telemetry descriptor in active module, validates size,
      * and calls module's handleTelemetry().
      *
-     * Thread-safe - can be called from ESP-NOW callback context.
+     * Call inside a ModulePin. Do not call from the ESP-NOW callback; queue
+     * into RxRing instead.
      *
      * @param macAddr Source MAC address (6 bytes)
      * @param data Packet data
      * @param length Packet length in bytes
+     * @param timestampUs micros() when the frame arrived (0 = now), for TelemetryTap
      * @return true if packet was successfully routed, false if dropped
      *
      * @note Packets are dropped if:
@@ -99,7 +140,19 @@ public:
      *       - Magic number doesn't match any telemetry descriptor
      *       - Packet size doesn't match descriptor size constraints
      */
-    bool routePacket(const uint8_t* macAddr, const uint8_t* data, size_t length);
+    bool routePacket(const uint8_t* macAddr, const uint8_t* data, size_t length,
+                     uint32_t timestampUs = 0);
+
+    /**
+     * @brief Sampling time of the packet being handled
+     *
+     * The robot timestamp mapped by ClockSync for descriptors with a
+     * timestampOffset, otherwise the arrival time. Valid during
+     * handleTelemetry() (RxTask).
+     *
+     * @return Controller micros()
+     */
+    uint32_t getSampleTimestampUs() const;
 
     // ========================================================================
     // Statistics
@@ -151,17 +204,83 @@ private:
     PacketRouter& operator=(const PacketRouter&) = delete;
 
     /**
-     * @brief Try to route packet to specific module
+     * @brief Precomputed routing data for one telemetry packet type
+     */
+    struct DispatchEntry {
+        uint32_t magic;         ///< Magic number (key)
+        uint16_t minSize;       ///< Minimum valid packet size
+        uint16_t maxSize;       ///< Maximum valid packet size
+        uint8_t typeIndex;      ///< Index passed to handleTelemetry()
+        uint8_t deltaSlot;      ///< RouteTable::deltas index (kNoDelta if not delta-encoded)
+        int16_t timestampOffset; ///< Robot timestamp offset (-1 if none)
+        bool used;              ///< Slot occupied
+        bool logged;            ///< First packet already logged
+        const char* name;       ///< Descriptor name (for logging)
+    };
+
+    /// Table slots (power of two, at least 2x the largest descriptor count)
+    static constexpr size_t kDispatchSlots = 16;
+
+    /// Delta-encoded telemetry types per table
+    static constexpr size_t kMaxDeltaTypes = 2;
+    static constexpr uint8_t kNoDelta = 0xFF;
+
+    /**
+     * @brief Module and magic-number dispatch table for one destination
+     */
+    struct RouteTable {
+        ILITEModule* module;                    ///< Module packets go to
+        uint8_t mac[6];                         ///< Source MAC (team peers only)
+        bool used;                              ///< Peer route occupied (writer side)
+        bool primary;                           ///< Active module (publishes to store/tap)
+        std::atomic<bool> live;                 ///< Visible to routePacket()
+        DispatchEntry dispatch[kDispatchSlots];
+        size_t count;
+        DeltaPacketReader deltas[kMaxDeltaTypes];   ///< Keyframes of delta-encoded types
+        size_t deltaCount;
+    };
+
+    /**
+     * @brief Rebuild a dispatch table from a module's telemetry descriptors
      *
-     * Checks all telemetry descriptors of the given module to find a matching
-     * magic number, validates size, and calls handleTelemetry().
+     * Called with the config mutex held on a table that is not live.
      *
-     * @param module Module to try routing to
+     * @param table Table to fill
+     * @param module Module to index (nullptr clears the table)
+     */
+    void rebuildDispatchTable(RouteTable& table, ILITEModule* module);
+
+    /**
+     * @brief Find the dispatch entry for a magic number
+     * @return Matching entry, or nullptr if the table's module has none
+     */
+    static DispatchEntry* lookup(RouteTable& table, uint32_t magic);
+
+    /**
+     * @brief Table for frames from a MAC (a team peer's, else the active module's)
+     * @return nullptr if neither is live
+     */
+    RouteTable* tableFor(const uint8_t* mac);
+
+    /**
+     * @brief Take a table out of routing and wait until no task uses it
+     */
+    static void retire(RouteTable& table);
+
+    /**
+     * @brief Route a packet to a table's module
+     *
+     * @param table Table to route through
      * @param data Packet data
      * @param length Packet length
      * @return true if module accepted the packet, false otherwise
      */
-    bool tryRouteToModule(ILITEModule* module, const uint8_t* data, size_t length);
+    bool tryRouteToModule(RouteTable& table, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Slot index for a magic number (Fibonacci hash)
+     */
+    static size_t hashMagic(uint32_t magic);
 
     /**
      * @brief Extract magic number from packet
@@ -180,11 +299,36 @@ private:
     /// Singleton instance pointer
     static PacketRouter* instance_;
 
-    /// Currently active module (packets routed here)
-    ILITEModule* activeModule_;
+    /// Keeps RxTask and replay (CommTask) from routing at the same time
+    SemaphoreHandle_t routeMutex_;
+
+    /// Serialises table changes
+    SemaphoreHandle_t configMutex_;
+
+    /// Dispatch table of the active module (frames from any other MAC)
+    RouteTable active_;
+
+    /// Modules whose packets the TelemetryStore banks hold (active, standby)
+    ILITEModule* storeModule_;
+    ILITEModule* standbyModule_;
+    bool moduleStandby_;
+
+    /**
+     * @brief Give the active store bank to `module` (config mutex held, nothing routing)
+     */
+    void selectTelemetryBank(ILITEModule* module);
+
+    /// Dispatch tables of team peers, keyed by MAC
+    RouteTable peerRoutes_[kMaxPeerRoutes];
+
+    /// Last unmatched magic that was logged (avoids per-packet log spam)
+    uint32_t lastMissMagic_;
+
+    /// Arrival time of the frame being routed (for TelemetryTap)
+    uint32_t rxTimestampUs_;
 
-    /// Mutex for thread-safe access
-    SemaphoreHandle_t mutex_;
+    /// Sampling time of the packet being handled (controller micros())
+    uint32_t sampleTimestampUs_;
 
     /// Statistics counters
     uint32_t routedCount_;   ///< Successfully routed packets
@@ -0,0 +1,69 @@
+/**
+ * @file PageFont.h
+ * @brief Pre-compiled, page-aligned glyph subsets of the DisplayCanvas fonts
+ *
+ * U8G2 stores its fonts run-length coded and decodes every glyph again on
+ * every draw, one run and one clipped pixel span at a time. The status bar
+ * and the menus draw dozens of TINY glyphs per frame that way.
+ *
+ * tools/font_subset.py (a pre-build script of the ESP32 environments)
+ * decodes the TINY, SMALL and NORMAL U8G2 fonts from the installed U8g2
+ * library and keeps the printable ASCII characters that appear in string
+ * literals of the firmware, plus digits, hex letters and printf
+ * punctuation. Each glyph is written uncompressed in the framebuffer's page
+ * layout: ceil(height / 8) pages of `width` column bytes, bit 0 on top.
+ * The script writes the tables to the build directory and defines
+ * ILITE_PAGE_FONTS=1.
+ *
+ * DisplayCanvas::drawText() then copies each glyph's columns into the
+ * framebuffer with a mask and a shift, as drawIconBitmap() does. Text that
+ * uses a character outside the subset, is drawn with the XOR color, or
+ * reaches past the clip rect or the screen edge goes through U8G2 as
+ * before, so the output is identical either way: glyphs are drawn in U8G2's
+ * solid font mode (the glyph box's background pixels take the other
+ * color), and widths follow U8G2's getUTF8Width().
+ *
+ * Builds without the script (native) keep ILITE_PAGE_FONTS=0 and draw all
+ * text through U8G2. Environments that run it fail the build rather than
+ * drop to that path when U8g2 cannot be installed or read.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PAGE_FONT_H
+#define ILITE_PAGE_FONT_H
+
+#include <Arduino.h>
+
+#ifndef ILITE_PAGE_FONTS
+#define ILITE_PAGE_FONTS 0
+#endif
+
+/**
+ * @brief One glyph of a page font (U8G2 metrics)
+ */
+struct PageGlyph {
+    uint16_t offset;        ///< First bitmap byte
+    uint8_t width;          ///< Bitmap columns (0 for blank glyphs such as space)
+    uint8_t height;         ///< Bitmap rows (at most PageFontData::kMaxHeight)
+    int8_t x;               ///< Left edge relative to the cursor
+    int8_t top;             ///< Rows from the top edge down to the baseline
+    int8_t advance;         ///< Cursor step
+    uint8_t present;        ///< In the subset; drawing anything else falls back to U8G2
+};
+
+/**
+ * @brief A page font: glyphs for encodings kFirst..kLast
+ */
+struct PageFontData {
+    static constexpr uint8_t kFirst = 0x20;
+    static constexpr uint8_t kLast = 0x7E;
+    static constexpr uint8_t kMaxHeight = 16;
+
+    const char* source;             ///< U8G2 font it was cut from
+    const PageGlyph* glyphs;        ///< kLast - kFirst + 1 entries
+    const uint8_t* bitmaps;
+};
+
+#endif // ILITE_PAGE_FONT_H
@@ -0,0 +1,124 @@
+/**
+ * @file ParamSync.h
+ * @brief Coalesced, acknowledged streaming of tunable parameters to a robot
+ *
+ * Tuning with the encoder produces a burst of edits, most of them stale by
+ * the time they could be sent. ParamSync sits between the edits and a
+ * module's parameter frames:
+ *
+ * - set() only records the newest value of a parameter and marks it dirty.
+ * - service() sends the dirty parameters as one frame once the oldest edit
+ *   is `windowMs` old, so a fast spin becomes one frame per window carrying
+ *   only the latest values.
+ * - One frame is in flight at a time. acknowledge() with its sequence
+ *   settles it; until then service() resends it every `retryMs` (doubling
+ *   up to 1 s) with the current values and a new sequence, so the final
+ *   value always arrives while the link is up and a late reply to an older
+ *   frame settles nothing.
+ * - isPending() is true from the edit until the frame carrying its latest
+ *   value is acknowledged, for an "unconfirmed" marker in the UI.
+ *
+ * The wire format is the module's: the send function gets the sequence and
+ * the parameter values and builds its own frame.
+ *
+ * ## Thread Safety:
+ * set(), acknowledge() and the queries may be called from any task;
+ * service() from one task only (the send function runs there).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PARAM_SYNC_H
+#define ILITE_PARAM_SYNC_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @brief One parameter in a frame
+ */
+struct ParamValue {
+    uint8_t id;
+    float value;
+};
+
+/**
+ * @brief Counters of one ParamSync channel
+ */
+struct ParamSyncStats {
+    uint32_t edits = 0;             ///< set() calls
+    uint32_t coalesced = 0;         ///< Edits replaced by a newer one before sending
+    uint32_t frames = 0;            ///< Frames sent, resends included
+    uint32_t resends = 0;
+    uint32_t acks = 0;
+};
+
+/**
+ * @class ParamSync
+ * @brief One module's parameter channel
+ */
+class ParamSync {
+public:
+    static constexpr size_t kMaxParams = 32;            ///< Parameter IDs 0-31
+    static constexpr uint32_t kMaxRetryMs = 1000;
+
+    /**
+     * @brief Build and send one frame
+     *
+     * @param count 0 for a refresh request (see requestRefresh())
+     * @return false if nothing was sent (the frame is retried later)
+     */
+    using SendFn = bool (*)(uint16_t sequence, const ParamValue* values, size_t count);
+
+    explicit ParamSync(SendFn send, uint32_t windowMs = 30, uint32_t retryMs = 150);
+
+    /// Record the newest value of `id`; it goes out with the next frame
+    void set(uint8_t id, float value);
+
+    /// Ask for an empty frame (the robot reports every value) when nothing is dirty
+    void requestRefresh();
+
+    /// Send due frames and resend an unacknowledged one (one task only)
+    void service(uint32_t nowMs);
+
+    /**
+     * @brief Settle the frame in flight if `sequence` is its sequence
+     * @return true if it was
+     */
+    bool acknowledge(uint16_t sequence);
+
+    /// Edited since the last frame was built (a reported value must not overwrite it)
+    bool isDirty(uint8_t id) const;
+
+    /// Edited and not yet confirmed by the robot
+    bool isPending(uint8_t id) const;
+
+    /// Parameters edited and not yet confirmed
+    size_t getPendingCount() const;
+
+    ParamSyncStats getStats() const;
+
+    /// Forget every edit and the frame in flight (sequences keep counting)
+    void reset();
+
+private:
+    SendFn send_;
+    uint32_t windowMs_;
+    uint32_t retryMs_;
+
+    mutable portMUX_TYPE lock_;
+    float values_[kMaxParams];
+    uint32_t dirtyMask_;            ///< Edited, not in any frame yet
+    uint32_t inFlightMask_;         ///< In the frame awaiting its ACK
+    uint32_t firstDirtyMs_;
+    bool refreshPending_;
+    bool awaiting_;
+    bool refreshInFlight_;
+    uint16_t sequence_;
+    uint32_t sentMs_;
+    uint32_t backoffMs_;
+    ParamSyncStats stats_;
+};
+
+#endif // ILITE_PARAM_SYNC_H
@@ -0,0 +1,209 @@
+/**
+ * @file PidAutoTune.h
+ * @brief Step-response PID auto-tuner fed by streamed attitude telemetry
+ *
+ * Tuning DroneGaze by hand means turning one gain a detent at a time and
+ * watching the PID trace. PidAutoTune runs that loop on the controller for
+ * one axis:
+ *
+ * 0. **Start**: propose the current gains with Ki = 0, so each step shows
+ *    the PD response without integrator windup.
+ * 1. **Settle**: hold the setpoint at the base angle and average the
+ *    measured angle as the step's zero.
+ * 2. **Step**: command base +- stepDeg (the sign alternates so the craft
+ *    does not wander) and analyze every telemetry sample as it arrives. The
+ *    response is normalized to the step (0 = start, 1 = target) and tracked
+ *    through its lobes around 1: rise time, first peak (overshoot), trough,
+ *    second peak and the time between the two upward crossings of the
+ *    target (oscillation period). Nothing is buffered; the history the PID
+ *    trace keeps is not needed.
+ * 3. **Adjust**: compare the step with the target band and propose new
+ *    gains. Too little overshoot raises Kp; too much raises Kd, or lowers
+ *    Kp when the response keeps ringing (second peak above ringDecay of
+ *    the first). Inside the band the tune has converged and Ki is set from
+ *    the measured period (Ti = 2 x period).
+ * 4. **Apply**: the caller sends the proposal over the parameter channel
+ *    and calls gainsApplied() once the drone has confirmed it; the next
+ *    step starts from Settle.
+ *
+ * A relay test would give the ultimate period directly, but it needs the
+ * relay inside the drone's loop; from the controller only the setpoint can
+ * be moved, so the closed-loop step is what can be observed. The radio
+ * adds its latency to every step, which makes the proposal conservative.
+ *
+ * The tune fails, and proposes the gains it started from, when the angle
+ * leaves limitDeg, the axis does not respond, or maxSteps pass without
+ * convergence. The caller aborts it on disarm, stick input or stale
+ * telemetry and restores the starting gains the same way.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * tuner.start(currentGains, baseDeg, millis());
+ *
+ * // Control tick
+ * if (newTelemetry) tuner.addSample(millis(), measuredDeg);
+ * PidAutoTune::Gains gains;
+ * if (tuner.takeProposal(gains)) sendGains(gains);
+ * if (tuner.getState() == PidAutoTune::State::Apply && !gainsPending()) tuner.gainsApplied(millis());
+ * command.angle = tuner.getSetpoint();
+ * ```
+ *
+ * The tuner reads no clock and sends nothing: every call takes the time in
+ * milliseconds, and proposals leave only through takeProposal().
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PID_AUTO_TUNE_H
+#define ILITE_PID_AUTO_TUNE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class PidAutoTune
+ * @brief Iterative step-response tuner for one PID axis
+ */
+class PidAutoTune {
+public:
+    struct Gains {
+        float kp;
+        float ki;
+        float kd;
+    };
+
+    struct Config {
+        float stepDeg = 10.0f;          ///< Step size around the base angle
+        float limitDeg = 35.0f;         ///< Fail when the angle leaves base +- this
+        uint32_t settleMs = 800;        ///< Hold at the base angle before each step
+        uint32_t stepMs = 1500;         ///< Observation window of one step
+        uint8_t maxSteps = 12;          ///< Give up after this many steps
+        float overshootLow = 0.05f;     ///< Below: response too soft, raise Kp
+        float overshootHigh = 0.20f;    ///< Above: too lively, add damping
+        float ringDecay = 0.35f;        ///< Second peak / first peak that counts as ringing
+        float minResponse = 0.3f;       ///< Fraction of the step the axis must reach
+        Gains maxGains = {20.0f, 5.0f, 5.0f};
+    };
+
+    enum class State : uint8_t {
+        Idle,
+        Settle,         ///< Holding the base angle
+        Step,           ///< Observing a step
+        Apply,          ///< Waiting for the drone to confirm proposed gains
+        Done,           ///< Converged; the proposal is the result
+        Failed          ///< Stopped; the proposal restores the starting gains
+    };
+
+    enum class Outcome : uint8_t {
+        None,
+        Converged,
+        Unstable,       ///< Angle left the limit
+        NoResponse,     ///< Axis did not follow the step at the highest Kp
+        StepLimit,      ///< maxSteps without convergence
+        Aborted         ///< Caller stopped it
+    };
+
+    /// What the tuner saw during the last step (normalized to the step)
+    struct StepMetrics {
+        float reach;            ///< Highest normalized response
+        float overshoot;        ///< First peak above target (0 = none)
+        float secondPeak;       ///< Second peak above target (0 = none)
+        float riseMs;           ///< Time to 90 % of the step (0 = never)
+        float peakMs;           ///< Time to the first peak
+        float periodMs;         ///< Between upward target crossings (0 = none)
+        uint16_t samples;
+    };
+
+    PidAutoTune() = default;
+
+    void setConfig(const Config& config) { config_ = config; }
+    const Config& getConfig() const { return config_; }
+
+    /**
+     * @brief Start tuning from the gains in effect
+     * @param initial Gains the drone runs now (restored on failure)
+     * @param baseDeg Setpoint the steps are taken around
+     * @param nowMs Monotonic milliseconds
+     */
+    void start(const Gains& initial, float baseDeg, uint32_t nowMs);
+
+    /// Stop and propose the starting gains (no-op when not running)
+    void abort();
+
+    /**
+     * @brief Feed one telemetry sample of the tuned axis
+     * @param nowMs Arrival time (monotonic milliseconds)
+     * @param actualDeg Measured angle
+     */
+    void addSample(uint32_t nowMs, float actualDeg);
+
+    /// Advance timers without a sample (keeps Settle/Step moving on a quiet link)
+    void update(uint32_t nowMs);
+
+    /// Call once the proposal from takeProposal() is in effect on the drone
+    void gainsApplied(uint32_t nowMs);
+
+    /**
+     * @brief Take gains to send, once per proposal
+     * @return false if nothing new is proposed
+     */
+    bool takeProposal(Gains& out);
+
+    /// Setpoint to command now
+    float getSetpoint() const { return setpointDeg_; }
+
+    State getState() const { return state_; }
+    Outcome getOutcome() const { return outcome_; }
+    bool isRunning() const {
+        return state_ == State::Settle || state_ == State::Step || state_ == State::Apply;
+    }
+    uint8_t getStepCount() const { return steps_; }
+    const Gains& getGains() const { return gains_; }
+    const StepMetrics& getLastStep() const { return last_; }
+
+    static const char* stateName(State state);
+    static const char* outcomeName(Outcome outcome);
+
+private:
+    enum class Lobe : uint8_t {
+        Rising,         ///< Below the target, not yet crossed
+        FirstPeak,      ///< Above the target the first time
+        Trough,         ///< Back below
+        SecondPeak,     ///< Above again
+        Past            ///< Beyond the second peak; nothing more to learn
+    };
+
+    void beginSettle(uint32_t nowMs);
+    void beginStep(uint32_t nowMs);
+    void finishStep();
+    void propose(const Gains& gains);
+    void fail(Outcome outcome);
+    float clampGain(float value, float max) const;
+
+    Config config_;
+    State state_ = State::Idle;
+    Outcome outcome_ = Outcome::None;
+    Gains initial_ = {0.0f, 0.0f, 0.0f};
+    Gains gains_ = {0.0f, 0.0f, 0.0f};
+    Gains proposal_ = {0.0f, 0.0f, 0.0f};
+    bool proposalReady_ = false;
+    float baseDeg_ = 0.0f;
+    float setpointDeg_ = 0.0f;
+    uint32_t phaseStartMs_ = 0;
+    uint8_t steps_ = 0;
+    float direction_ = 1.0f;
+
+    // Settle: running mean of the measured angle
+    float zeroSum_ = 0.0f;
+    uint16_t zeroCount_ = 0;
+    float zeroDeg_ = 0.0f;
+
+    // Step: incremental lobe tracking
+    Lobe lobe_ = Lobe::Rising;
+    uint32_t firstCrossMs_ = 0;
+    StepMetrics current_ = {};
+    StepMetrics last_ = {};
+};
+
+#endif // ILITE_PID_AUTO_TUNE_H
@@ -0,0 +1,197 @@
+/**
+ * @file PoseRecorder.h
+ * @brief Records TheGill arm poses to flash and replays them
+ *
+ * PoseRecorder captures one Frame per control tick: the joint setpoints of
+ * ArmControlCommand, both grippers and the planar IK target. Frames are
+ * delta encoded into a 4 KB RAM block:
+ *
+ * - a frame whose channels all match the previous one is not stored; its
+ *   time folds into the next frame's delta,
+ * - otherwise: varint dt (ms), varint mask of changed channels, then one
+ *   zigzag varint delta per changed channel,
+ * - the first frame of every block is a key frame (all channels, deltas
+ *   from zero), so any block decodes on its own.
+ *
+ * A full block is handed to a low-priority writer task, which writes it to
+ * the data partition with the "spiffs" subtype (nothing else uses it) and
+ * then erases the next sector ahead of time. The control loop only ever
+ * touches RAM and never issues an erase or a write itself, though it is
+ * paused while one runs (see the note below). Blocks fill a ring
+ * over the partition; a take longer than the partition keeps its newest
+ * blocks. Only the latest take is kept.
+ *
+ * Playback decodes through a memory-mapped view of the partition at the
+ * original or a scaled speed; the control code applies the frames to
+ * armCommand, so they go out through acquireArmCommand() as before.
+ *
+ * @note SPI flash operations briefly pause code running from flash on both
+ *       cores; the recorder still sees the correct time because every frame
+ *       stores its measured dt.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_POSE_RECORDER_H
+#define ILITE_POSE_RECORDER_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+
+class PoseRecorder {
+public:
+    enum Channel : uint8_t {
+        EXTENSION = 0,
+        BASE,
+        SHOULDER,
+        ELBOW,
+        PITCH,
+        ROLL,
+        YAW,
+        GRIPPER1,
+        GRIPPER2,
+        TARGET_X,
+        TARGET_Y,
+        CHANNEL_COUNT
+    };
+
+    /// One quantised sample
+    struct Frame {
+        int16_t value[CHANNEL_COUNT];
+    };
+
+    enum class State : uint8_t {
+        Idle,
+        Recording,
+        Playing
+    };
+
+    static constexpr float kAngleScale = 50.0f;     ///< Counts per degree (extension: per mm)
+    static constexpr float kTargetScale = 10.0f;    ///< Counts per mm of IK target
+    static constexpr size_t kBlockSize = 4096;      ///< One flash sector
+    static constexpr uint32_t kBlockMagic = 0x43455250; // 'PREC'
+    static constexpr float kMinSpeed = 0.25f;
+    static constexpr float kMaxSpeed = 4.0f;
+
+    static PoseRecorder& getInstance();
+
+    /**
+     * @brief Find the partition, load the latest take and start the writer
+     * @return true if recording and playback are available
+     */
+    bool begin();
+    bool isAvailable() const { return partition_ != nullptr && writerTask_ != nullptr; }
+
+    /// Start a new take (replaces the stored one)
+    bool startRecording();
+    /// Close the take; the last block is written in the background
+    void stopRecording();
+
+    /// Append a frame (control loop, while recording)
+    void record(const Frame& frame, uint32_t nowMs);
+
+    /**
+     * @brief Start replaying the stored take
+     * @param speed Playback rate (1 = as recorded), clamped to kMinSpeed..kMaxSpeed
+     * @return false if there is no take or it is still being written
+     */
+    bool startPlayback(float speed = 1.0f);
+    void stopPlayback();
+    void setPlaybackSpeed(float speed);
+    float getPlaybackSpeed() const { return speed_; }
+
+    /**
+     * @brief Advance playback (control loop)
+     * @param dtSeconds Control loop period
+     * @param frame Updated with every frame that became due
+     * @return false once the take has ended (state is Idle again)
+     */
+    bool advance(float dtSeconds, Frame& frame);
+
+    State getState() const { return state_; }
+    bool hasTake() const { return takeBlocks_ > 0; }
+    uint32_t getTakeDurationMs() const { return takeDurationMs_; }
+    uint32_t getTakeFrames() const { return takeFrames_; }
+    uint32_t getTakeBytes() const { return takeBytes_; }
+    uint32_t getDroppedFrames() const { return droppedFrames_; }
+
+    void dump(Print& out) const;
+
+private:
+    struct BlockHeader {
+        uint32_t magic;
+        uint32_t takeId;
+        uint32_t sequence;      ///< Block index within the take
+        uint16_t payloadBytes;
+        uint16_t frameCount;
+        uint32_t durationMs;    ///< Sum of frame dts in this block
+    } __attribute__((packed));
+
+    static constexpr size_t kPayloadSize = kBlockSize - sizeof(BlockHeader);
+    static constexpr size_t kMaxFrameBytes = 3 + 2 + CHANNEL_COUNT * 3;
+
+    struct Block {
+        BlockHeader header;
+        uint8_t payload[kPayloadSize];
+    };
+
+    PoseRecorder();
+    PoseRecorder(const PoseRecorder&) = delete;
+    PoseRecorder& operator=(const PoseRecorder&) = delete;
+
+    static void writerTask(void* param);
+    void writerLoop();
+    void scanTake();
+    bool sealActive();
+    void beginBlock(uint32_t sequence);
+    void store(const Frame& frame, uint32_t nowMs);
+    void encodeFrame(const Frame& frame, uint32_t dtMs, bool keyFrame);
+    uint32_t sectorFor(uint32_t sequence) const { return sequence % blockCount_; }
+    bool openPlaybackBlock();
+
+    const esp_partition_t* partition_;
+    uint32_t blockCount_;
+    TaskHandle_t writerTask_;
+
+    // Recording (control loop writes, writer task reads sealed blocks)
+    Block blocks_[2];
+    std::atomic<bool> sealed_[2];
+    std::atomic<int32_t> eraseAhead_;   ///< Sector the writer should pre-erase, -1 = none
+    uint8_t active_;
+    bool blockOpen_;
+    size_t offset_;
+    Frame last_;
+    uint32_t lastFrameMs_;      ///< Time of the last stored frame
+    uint32_t lastSeenMs_;       ///< Time of the last record() call
+    uint32_t sequence_;
+    uint32_t droppedFrames_;
+
+    // Stored take
+    uint32_t takeId_;
+    uint32_t takeFirstSequence_;
+    uint32_t takeBlocks_;
+    uint32_t takeFrames_;
+    uint32_t takeBytes_;
+    uint32_t takeDurationMs_;
+
+    // Playback
+    const void* mapped_;
+    spi_flash_mmap_handle_t mapHandle_;
+    uint32_t playSequence_;
+    const uint8_t* playCursor_;
+    const uint8_t* playEnd_;
+    Frame playFrame_;
+    float playClockMs_;         ///< Take time reached (scaled by speed_)
+    uint32_t playNextMs_;       ///< Take time of the next frame
+    bool playHavePending_;      ///< playNextMs_ is valid (its dt was read)
+    bool playKeyFrame_;         ///< Next frame starts a block
+    float speed_;
+
+    State state_;
+};
+
+#endif // ILITE_POSE_RECORDER_H
@@ -0,0 +1,109 @@
+/**
+ * @file PowerManager.h
+ * @brief CPU frequency scaling, light sleep and the idle state
+ *
+ * At an all-day event the controller spends most of its time unpaired on
+ * the home screen or lying on a table, yet both framework tasks ran at
+ * full rate on a 240 MHz CPU. PowerManager tracks input activity and
+ * holds ESP-IDF power management locks only while they are needed:
+ *
+ * - **CPU clock**: esp_pm_configure() lets the clock scale between
+ *   cpuMinMhz and cpuMaxMhz. An ESP_PM_CPU_FREQ_MAX lock is held while
+ *   paired or active, so control ticks never run slow. Builds without
+ *   CONFIG_PM_ENABLE (stock Arduino cores) fall back to
+ *   setCpuFrequencyMhz() on each transition.
+ * - **Light sleep** (opt-in): an ESP_PM_NO_LIGHT_SLEEP lock is held
+ *   except while idle and unpaired. ESP-NOW cannot receive while the chip
+ *   sleeps, so discovery only hears robots that broadcast while awake.
+ *   The buttons and the encoder are armed as GPIO wake sources only while
+ *   the lock is released. Armed pins interrupt on a level rather than an
+ *   edge, so the edge handlers call wakeFromPinIsr() first: the first
+ *   level interrupt restores every pin's edge type and wakes CommTask.
+ * - **Idle state**: no button, encoder, stick or pot movement for
+ *   idleTimeoutMs. The framework lowers the display rate and contrast
+ *   while idle (ILITEConfig::idleDisplayHz / idleContrast) and the
+ *   control loop rate while unpaired (ILITEConfig::unpairedControlHz).
+ *
+ * Wake is immediate: button edges (ButtonSampler) and the encoder ISRs
+ * call wake()/wakeFromIsr(), which notifies CommTask for an extra tick
+ * instead of waiting for the next slow one.
+ *
+ * ## Thread Safety:
+ * update() runs on CommTask only. wake() may be called from any task and
+ * wakeFromIsr() from interrupts; both only set a flag and notify.
+ * wakeFromPinIsr() also rewrites the wake pins' interrupt types, which
+ * applyLocks() only does after winning the armed flag from it.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_POWER_MANAGER_H
+#define ILITE_POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "InputManager.h"
+
+/**
+ * @class PowerManager
+ * @brief Static power state of the controller
+ */
+class PowerManager {
+public:
+    static constexpr float kStickActivity = 0.15f;  ///< Stick deflection that counts as input
+    static constexpr float kPotActivity = 0.03f;    ///< Pot change that counts as input
+
+    /**
+     * @brief Configure frequency scaling and create the locks
+     *
+     * @param cpuMaxMhz Clock while paired or active
+     * @param cpuMinMhz Clock the scaler may drop to
+     * @param lightSleep Allow automatic light sleep while idle and unpaired
+     * @param idleTimeoutMs No input for this long = idle (0 = never idle)
+     * @return false if power management is unavailable (fallback clock switching is used)
+     */
+    static bool begin(uint16_t cpuMaxMhz, uint16_t cpuMinMhz, bool lightSleep, uint32_t idleTimeoutMs);
+
+    /// Task woken by wake()/wakeFromIsr() (CommTask)
+    static void setWakeTask(TaskHandle_t task) { wakeTask_ = task; }
+
+    /**
+     * @brief Evaluate this tick's input and link state (CommTask)
+     * @return true if the idle state changed
+     */
+    static bool update(const InputSnapshot& snapshot, bool paired, uint32_t nowMs);
+
+    /// Input seen outside the snapshot (task context)
+    static void wake();
+
+    /// Input seen in an interrupt handler
+    static void IRAM_ATTR wakeFromIsr();
+
+    /**
+     * @brief Call first in the edge ISR of a wake pin (encoder, encoder button)
+     * @return true if this was the level wake interrupt, not an edge; the
+     *         edge types are restored and CommTask is woken
+     */
+    static bool IRAM_ATTR wakeFromPinIsr();
+
+    /// No input for idleTimeoutMs
+    static bool isIdle() { return idle_.load(std::memory_order_relaxed); }
+
+    /// True if esp_pm_configure() accepted the configuration
+    static bool isScaling() { return scaling_; }
+
+    static void dump(Print& out);
+
+private:
+    static void applyLocks(bool paired);
+
+    static std::atomic<bool> idle_;
+    static std::atomic<bool> wakePending_;
+    static TaskHandle_t wakeTask_;
+    static bool scaling_;
+};
+
+#endif // ILITE_POWER_MANAGER_H
@@ -0,0 +1,173 @@
+/**
+ * @file Profiler.h
+ * @brief Frame-time profiler for the display and comm tasks
+ *
+ * Scoped timers read the CPU cycle counter (CCOUNT) on entry and exit of a
+ * zone and record the elapsed microseconds into a per-zone window of recent
+ * samples. Each zone reports min/avg/max/p99 over that window, so the
+ * display "Profiler" screen and the serial `prof` command show which step of
+ * a frame or control tick is eating the budget.
+ *
+ * Each zone has a single writer task (the task the zone runs on). Readers on
+ * other tasks may see a sample from an adjacent frame, which is fine for
+ * display. Tasks are pinned to a core, so both cycle-counter reads of a
+ * scope come from the same core's CCOUNT.
+ *
+ * In ILITE_HEAP_PROFILE builds a scope also tells HeapProfiler which zone
+ * its task is in, so allocations are attributed to the zone.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * void render(DisplayCanvas& canvas) {
+ *     ILITE_PROFILE(ProfileZone::Render);
+ *     // ...
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_PROFILER_H
+#define ILITE_PROFILER_H
+
+#include <Arduino.h>
+#include "HeapProfiler.h"
+
+/**
+ * @brief Instrumented zones
+ */
+enum class ProfileZone : uint8_t {
+    DisplayFrame = 0,   ///< Whole DisplayTask iteration
+    Render,             ///< FrameworkEngine::render (strip + dashboard)
+    ModuleDraw,         ///< Module drawDashboard()
+    SendBuffer,         ///< DisplayCanvas::sendBuffer()
+    CommTick,           ///< Whole CommTask iteration
+    UpdateControl,      ///< Module updateControl()
+    PrepareCommand,     ///< Module prepareCommandPacket(), all types in one tick
+    ControlRead,        ///< Control stage: input sampling and shaping
+    ControlIntent,      ///< Control stage: modes, targets, drive commands
+    ControlKinematics,  ///< Control stage: workspace clamp, IK, trajectory
+    ControlPack,        ///< Control stage: command assembly
+    ModuleService,      ///< Module onService() on ServiceTask
+    Count
+};
+
+/**
+ * @brief Rolling statistics of one zone
+ */
+struct ProfileStats {
+    uint32_t minUs = 0;
+    uint32_t avgUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t p99Us = 0;
+    uint32_t lastUs = 0;
+    uint16_t samples = 0;       ///< Samples in the window
+    uint32_t total = 0;         ///< Samples since reset
+};
+
+/**
+ * @class Profiler
+ * @brief Static registry of zone timings
+ */
+class Profiler {
+public:
+    static constexpr size_t kZoneCount = static_cast<size_t>(ProfileZone::Count);
+    static constexpr size_t kWindow = 128;     ///< Samples kept per zone (power of 2)
+
+    /// Current cycle counter value
+    static inline uint32_t cycles() { return ESP.getCycleCount(); }
+
+    /// Enable or disable recording (scopes still read the counter)
+    static void setEnabled(bool enabled) { enabled_ = enabled; }
+    static bool isEnabled() { return enabled_; }
+
+    /**
+     * @brief Record one sample
+     * @param zone Zone
+     * @param elapsedCycles CPU cycles spent in the zone
+     */
+    static void record(ProfileZone zone, uint32_t elapsedCycles);
+
+    /// Add cycles to a zone's pending sample; commit() records the sum
+    static void accumulate(ProfileZone zone, uint32_t elapsedCycles);
+
+    /// Record the pending sum of accumulate() calls (if any)
+    static void commit(ProfileZone zone);
+
+    /// Compute statistics over the current window
+    static ProfileStats getStats(ProfileZone zone);
+
+    /// Short zone name ("render", "sendBuf", ...)
+    static const char* getZoneName(ProfileZone zone);
+
+    /// Drop every sample
+    static void reset();
+
+    /// Print a table of all zones
+    static void dump(Print& out);
+
+    /// Register the "framework.profiler" screen (idempotent)
+    static void registerScreen();
+
+private:
+    struct Zone {
+        uint32_t samples[kWindow];
+        uint32_t head;          ///< Total samples written (index of next slot)
+        uint32_t pending;       ///< accumulate() cycles not yet committed
+        bool hasPending;
+    };
+
+    static Zone zones_[kZoneCount];
+    static bool enabled_;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Records the lifetime of the scope into a zone
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone zone, bool accumulate = false)
+        : zone_(zone), accumulate_(accumulate), start_(Profiler::cycles()) {
+#if ILITE_HEAP_PROFILE
+        heapZone_ = HeapProfiler::enterZone(static_cast<uint8_t>(zone));
+#endif
+    }
+
+    ~ProfileScope() {
+#if ILITE_HEAP_PROFILE
+        HeapProfiler::leaveZone(heapZone_);
+#endif
+        const uint32_t elapsed = Profiler::cycles() - start_;
+        if (accumulate_) {
+            Profiler::accumulate(zone_, elapsed);
+        } else {
+            Profiler::record(zone_, elapsed);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone zone_;
+    bool accumulate_;
+    uint32_t start_;
+#if ILITE_HEAP_PROFILE
+    uint8_t heapZone_;
+#endif
+};
+
+#define ILITE_PROFILE_CONCAT_(a, b) a##b
+#define ILITE_PROFILE_CONCAT(a, b) ILITE_PROFILE_CONCAT_(a, b)
+
+/// Time the rest of the enclosing scope
+#define ILITE_PROFILE(zone) \
+    ProfileScope ILITE_PROFILE_CONCAT(profileScope_, __LINE__)(zone)
+
+/// Time the rest of the enclosing scope, summed until Profiler::commit(zone)
+#define ILITE_PROFILE_ACCUMULATE(zone) \
+    ProfileScope ILITE_PROFILE_CONCAT(profileScope_, __LINE__)(zone, true)
+
+#endif // ILITE_PROFILER_H
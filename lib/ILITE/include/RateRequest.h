@@ -0,0 +1,168 @@
+/**
+ * @file RateRequest.h
+ * @brief Ask the robot for per-packet telemetry rates
+ *
+ * Robots send telemetry at whatever rate their firmware picked, and
+ * WifiControlCommand::enableTelemetry only turns it on or off, so the arm
+ * state streams at full rate while the drive dashboard never shows it.
+ * The controller instead tells the robot how often it wants each
+ * telemetry type:
+ *
+ *     [RATE_REQUEST_MAGIC:4][count:1]([magic:4][intervalMs:2]) x count
+ *
+ * An interval of 0 leaves that type to the robot's own default, as does
+ * any type missing from the request.
+ *
+ * On the controller, the framework asks the active module for
+ * ILITEModule::getTelemetryRequestHz() of every telemetry type each
+ * control tick; a RateRequestWriter per peer sends the request when it
+ * changes and refreshes it every kRefreshMs. Modules that never ask for a
+ * rate send nothing.
+ *
+ * On the robot, one RateRequestFollower declares the telemetry types with
+ * their default intervals, consumes request frames in the receive handler
+ * and says when each type is due. Requests expire after kTimeoutMs, so a
+ * robot that loses the controller returns to its defaults.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_RATE_REQUEST_H
+#define ILITE_RATE_REQUEST_H
+
+#include <Arduino.h>
+
+/// Magic that marks a telemetry rate request ('RATE')
+constexpr uint32_t RATE_REQUEST_MAGIC = 0x52415445;
+
+/**
+ * @brief Requested interval of one telemetry type
+ */
+struct RateRequestEntry {
+    uint32_t magic;
+    uint16_t intervalMs;    ///< 0 = robot's default
+};
+
+/**
+ * @class RateRequestWriter
+ * @brief Controller side: track the wanted rates and build request frames
+ */
+class RateRequestWriter {
+public:
+    static constexpr size_t kMaxEntries = 8;            ///< TelemetryStore::kMaxSlots
+    static constexpr size_t kHeaderSize = sizeof(uint32_t) + 1;
+    static constexpr size_t kEntrySize = sizeof(uint32_t) + sizeof(uint16_t);
+    static constexpr size_t kMaxFrameSize = kHeaderSize + kMaxEntries * kEntrySize;
+    static constexpr uint32_t kRefreshMs = 2000;
+
+    RateRequestWriter();
+
+    /// Forget what was sent (new module or new link); the next poll() sends
+    void reset();
+
+    /// Number of telemetry types in the request (clamped to kMaxEntries)
+    void setCount(size_t count);
+
+    /// Wanted rate of one type; hz <= 0 leaves it to the robot
+    void set(size_t index, uint32_t magic, float hz);
+
+    /// Interval last set for a type (0 = robot's default or out of range)
+    uint16_t getIntervalMs(size_t index) const {
+        return index < count_ ? entries_[index].intervalMs : 0;
+    }
+
+    /**
+     * @brief Write the request if it changed or is due for a refresh
+     *
+     * A request that leaves every type to the robot is sent once after a
+     * change and not refreshed; before any rate was asked for, never.
+     *
+     * @return Bytes written to `out`, 0 if nothing is due
+     */
+    size_t poll(uint32_t nowMs, uint8_t* out, size_t capacity);
+
+    /// Interval for a rate (1 ms to 65535 ms; 0 for hz <= 0)
+    static uint16_t intervalForHz(float hz);
+
+private:
+    RateRequestEntry entries_[kMaxEntries];
+    RateRequestEntry sent_[kMaxEntries];
+    size_t count_;
+    size_t sentCount_;
+    uint32_t sentMs_;
+    bool sentOnce_;
+};
+
+/**
+ * @brief Check whether a received packet is a rate request
+ */
+bool isRateRequest(const uint8_t* data, size_t length);
+
+/**
+ * @class RateRequestFollower
+ * @brief Robot side: apply requests and pace each telemetry type
+ *
+ * Typical use in the robot's loop:
+ *
+ *     RateRequestFollower rates;
+ *     rates.addType(STATUS_MAGIC, 100);       // 10 Hz unless asked otherwise
+ *     rates.addType(ARM_STATE_MAGIC, 50);
+ *     ...
+ *     // In the ESP-NOW receive handler
+ *     if (rates.handle(data, len, millis())) return;
+ *     ...
+ *     if (rates.due(ARM_STATE_MAGIC, millis())) sendArmState();
+ */
+class RateRequestFollower {
+public:
+    static constexpr size_t kMaxTypes = RateRequestWriter::kMaxEntries;
+    static constexpr uint32_t kTimeoutMs = 3 * RateRequestWriter::kRefreshMs;
+
+    RateRequestFollower();
+
+    /**
+     * @brief Declare a telemetry type and the interval used without a request
+     * @return false if kMaxTypes types are declared already
+     */
+    bool addType(uint32_t magic, uint16_t defaultIntervalMs);
+
+    /**
+     * @brief Apply a received frame
+     * @return true if it was a rate request (consumed)
+     */
+    bool handle(const uint8_t* data, size_t length, uint32_t nowMs);
+
+    /**
+     * @brief Whether the type should be sent now; true also starts its next interval
+     *
+     * Undeclared types are always due.
+     */
+    bool due(uint32_t magic, uint32_t nowMs);
+
+    /// Interval in effect for the type (0 if undeclared)
+    uint16_t getIntervalMs(uint32_t magic, uint32_t nowMs) const;
+
+    /// Drop the current request (link lost); the defaults apply again
+    void reset();
+
+private:
+    struct Type {
+        uint32_t magic;
+        uint16_t defaultMs;
+        uint16_t requestedMs;       ///< 0 = not requested
+        uint32_t lastSentMs;
+        bool sent;
+    };
+
+    Type* find(uint32_t magic);
+    const Type* find(uint32_t magic) const;
+    uint16_t intervalOf(const Type& type, uint32_t nowMs) const;
+
+    Type types_[kMaxTypes];
+    size_t count_;
+    uint32_t requestMs_;
+    bool haveRequest_;
+};
+
+#endif // ILITE_RATE_REQUEST_H
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include "InverseKinematics.h"
+
+/**
+ * @file ReachabilityMap.h
+ * @brief Precomputed planar workspace of the arm for O(1) target clamping.
+ *
+ * The map samples InverseKinematics::solvePlanar once per cell over the
+ * planar workspace (x = horizontal >= 0, y = vertical) for one forearm
+ * extension, then stores a signed distance field: negative inside the
+ * reachable region, positive outside, in half-cell units (int8). Lookups
+ * interpolate bilinearly; clamp() moves a target along the field gradient
+ * to the nearest reachable point, so an out-of-reach jog target slides
+ * along the envelope instead of failing every tick.
+ *
+ * Building costs one closed-form solve per cell (~6.5k for TheGill), so it
+ * runs in slices: update() samples kRowsPerUpdate rows per call and swaps
+ * in the new field when the last row is done. The previous field stays in
+ * use until then. A rebuild starts when the solver revision changes or the
+ * extension moves by more than kRebuildExtensionMm.
+ */
+
+namespace IKEngine {
+
+class ReachabilityMap {
+public:
+    static constexpr size_t kMaxCols = 64;
+    static constexpr size_t kMaxRows = 128;
+    static constexpr float kMinCellMm = 4.0f;
+    static constexpr size_t kRowsPerUpdate = 4;
+    static constexpr float kRebuildExtensionMm = 5.0f;
+    static constexpr float kClampMarginMm = 2.0f;   ///< Minimum depth clamp() aims inside the envelope
+    static constexpr size_t kMaxEnvelopePoints = 2 * kMaxCols;
+
+    ReachabilityMap();
+
+    /**
+     * Keep the map in step with the solver; call once per control tick.
+     * @return true once a field for the current configuration is usable.
+     */
+    bool update(const InverseKinematics& solver, float extensionMm);
+
+    /// Build the whole map now (configuration time).
+    void build(const InverseKinematics& solver, float extensionMm);
+
+    bool isReady() const { return ready_; }
+
+    /// Incremented every time a rebuilt field is swapped in
+    uint32_t getGeneration() const { return generation_; }
+
+    /// Interpolated signed distance (mm): < 0 reachable, > 0 outside.
+    float signedDistance(float horizontalMm, float verticalMm) const;
+
+    bool isReachable(float horizontalMm, float verticalMm) const {
+        return ready_ && signedDistance(horizontalMm, verticalMm) < 0.0f;
+    }
+
+    /**
+     * Nearest reachable point to `target` (x = horizontal, y = vertical).
+     * Returns `target` unchanged when it is reachable or the map is not ready.
+     */
+    Vec3 clamp(const Vec3& target) const;
+
+    /**
+     * Outline of the reachable region: the top boundary left to right, then
+     * the bottom boundary right to left, one point per column.
+     * @return Number of points written to `out`.
+     */
+    size_t envelope(Vec3* out, size_t maxPoints) const;
+
+private:
+    void beginBuild(const InverseKinematics& solver, float extensionMm);
+    void sampleRows(const InverseKinematics& solver, size_t rowCount);
+    void finishBuild();
+    float sample(float col, float row) const;
+    bool marked(size_t col, size_t row) const;
+
+    int8_t field_[kMaxRows * kMaxCols];             ///< Signed half-cells, < 0 inside
+    uint8_t marks_[(kMaxRows * kMaxCols + 7) / 8];  ///< Reachable cells of the build in progress
+    uint8_t topRow_[kMaxCols];                      ///< Envelope per column (0xFF = empty)
+    uint8_t bottomRow_[kMaxCols];
+    // Geometry of the field in use
+    size_t cols_ = 0;
+    size_t rows_ = 0;
+    float cellMm_ = kMinCellMm;
+    float originY_ = 0.0f;
+    float extensionMm_ = 0.0f;
+    uint32_t revision_ = 0;
+    uint32_t generation_ = 0;
+    bool ready_ = false;
+    // Geometry of the build in progress
+    size_t buildCols_ = 0;
+    size_t buildRows_ = 0;
+    float buildCellMm_ = kMinCellMm;
+    float buildOriginY_ = 0.0f;
+    float buildExtensionMm_ = 0.0f;
+    uint32_t buildRevision_ = 0;
+    size_t buildRow_ = 0;
+    bool building_ = false;
+};
+
+} // namespace IKEngine
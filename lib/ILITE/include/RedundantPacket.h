@@ -0,0 +1,108 @@
+/**
+ * @file RedundantPacket.h
+ * @brief Carry previous copies of a command packet so the robot can recover losses
+ *
+ * ESP-NOW unicast retries recover most lost frames, but each retry costs a
+ * full retransmit timeout. For safety-critical commands (TheGill's system
+ * bits, Drongaze arming) a command descriptor can set `redundancy` to N:
+ * every frame of that type then also carries the N previous versions of the
+ * packet, newest first:
+ *
+ *     [REDUNDANT_MAGIC:4][seq:2][count:1]([len:1][packet bytes...]) x count
+ *
+ * Entry k has sequence `seq - k`. The wrapped packet is bundleable like any
+ * other packet (see PacketBundle.h).
+ *
+ * Robot firmware that does not know REDN frames would drop them, so the
+ * wrapping is opt-in: it only happens with ILITEConfig::redundantCommands
+ * set. Without it the same descriptors send the plain packet.
+ *
+ * On the robot, one RedundantPacketReader per packet type delivers, oldest
+ * first, every carried copy newer than the last one it delivered. Up to N
+ * consecutive lost frames are reconstructed from the next frame that
+ * arrives, without waiting for a retry; duplicates are dropped.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_REDUNDANT_PACKET_H
+#define ILITE_REDUNDANT_PACKET_H
+
+#include <Arduino.h>
+
+/// Magic that marks a redundant packet ('REDN')
+constexpr uint32_t REDUNDANT_PACKET_MAGIC = 0x5245444E;
+
+/**
+ * @class RedundantPacketWriter
+ * @brief Per-type history of sent packets and the redundant frame builder
+ */
+class RedundantPacketWriter {
+public:
+    static constexpr size_t kMaxDepth = 3;          ///< Previous copies carried at most
+    static constexpr size_t kMaxPacketSize = 48;    ///< Larger packets are sent plain
+    static constexpr size_t kHeaderSize = sizeof(uint32_t) + sizeof(uint16_t) + 1;
+
+    RedundantPacketWriter();
+
+    /// Forget the history (new module or new pairing)
+    void reset();
+
+    /**
+     * @brief Record `packet` as the next version and write the redundant frame
+     * @param depth Previous copies to carry (clamped to kMaxDepth)
+     * @return Bytes written to `out`, or 0 if the packet cannot be wrapped
+     */
+    size_t wrap(const uint8_t* packet, size_t length, uint8_t depth,
+                uint8_t* out, size_t capacity);
+
+    /// Sequence of the last wrapped packet
+    uint16_t getSequence() const { return sequence_; }
+
+private:
+    uint8_t history_[kMaxDepth][kMaxPacketSize];
+    uint8_t lengths_[kMaxDepth];
+    size_t historyCount_;
+    size_t historyHead_;        ///< Slot of the newest copy
+    uint16_t sequence_;
+};
+
+/**
+ * @brief Check whether a received packet is a redundant frame
+ */
+bool isRedundantPacket(const uint8_t* data, size_t length);
+
+/**
+ * @class RedundantPacketReader
+ * @brief Receive side: deliver each sequence exactly once, recovering gaps
+ */
+class RedundantPacketReader {
+public:
+    RedundantPacketReader();
+
+    /// Accept the next frame as a fresh start (robot boot, link reset)
+    void reset();
+
+    /**
+     * @brief Deliver the new packets of a redundant frame, oldest first
+     * @return Packets delivered, or -1 if the frame is malformed
+     */
+    int deliver(const uint8_t* data, size_t length,
+                void (*handler)(const uint8_t* packet, size_t length, void* context),
+                void* context);
+
+    /// Frames delivered from a carried copy instead of their own frame
+    uint32_t getRecovered() const { return recovered_; }
+
+    /// Sequences older than every carried copy when the next frame arrived
+    uint32_t getLost() const { return lost_; }
+
+private:
+    uint16_t lastSequence_;
+    bool synced_;
+    uint32_t recovered_;
+    uint32_t lost_;
+};
+
+#endif // ILITE_REDUNDANT_PACKET_H
@@ -0,0 +1,99 @@
+/**
+ * @file RenderScheduler.h
+ * @brief Event-driven frame scheduling for DisplayTask
+ *
+ * DisplayTask used to render at displayRefreshHz whether or not anything
+ * had changed: static menus cost a render and a diff every 100 ms, and an
+ * encoder step waited up to a full period to show. Now the display only
+ * draws when asked to, or when a floor period has passed:
+ *
+ * - **Input** (button events, encoder steps, pairing, power wake): drawn
+ *   as soon as the last frame is 1 / displayMaxFps old.
+ * - **Data** (paired control ticks, custom screens that animate): drawn
+ *   at most displayRefreshHz, the previous fixed rate.
+ * - **Animation** (a Tween was drawn still moving, see Animator.h): drawn
+ *   at displayMaxFps like Input, but only while something is in motion.
+ * - **Floor**: with nothing posted a frame still comes every
+ *   1 / displayFloorHz (1 / idleDisplayHz while PowerManager is idle),
+ *   for clocks, blinking status and anything that does not post.
+ *
+ * Requests are FreeRTOS notification bits on DisplayTask, so posting is
+ * one xTaskNotify() and requests arriving while a frame is drawn merge
+ * into the next one.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * selectedIndex_++;
+ * RenderScheduler::invalidate(RenderReason::Input);
+ * ```
+ *
+ * ## Thread Safety:
+ * invalidate() from any task, invalidateFromIsr() from interrupts.
+ * waitForFrame() only on DisplayTask.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_RENDER_SCHEDULER_H
+#define ILITE_RENDER_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/// Why a frame is wanted (notification bits)
+enum class RenderReason : uint32_t {
+    Input = 0x01,       ///< User-visible reaction; drawn at up to displayMaxFps
+    Data = 0x02,        ///< Changed values; drawn at up to displayRefreshHz
+    Animation = 0x04,   ///< Tween in motion; drawn at up to displayMaxFps
+};
+
+/**
+ * @brief Frame counters (see RenderScheduler::dump)
+ */
+struct RenderStats {
+    uint32_t frames;
+    uint32_t inputFrames;       ///< Frames with an Input request
+    uint32_t dataFrames;        ///< Frames with only Data requests
+    uint32_t floorFrames;       ///< Frames with no request
+    uint32_t animationFrames;   ///< Frames with only Animation (and Data) requests
+    uint32_t inputLatencyMaxUs; ///< First Input request -> frame start
+    uint32_t inputLatencyAvgUs; ///< Moving average (1/8 weight)
+};
+
+/**
+ * @class RenderScheduler
+ * @brief Static frame scheduler
+ */
+class RenderScheduler {
+public:
+    /**
+     * @brief Attach to DisplayTask and set the capped rates (Hz, 0 = 30 / 10)
+     */
+    static void begin(TaskHandle_t displayTask, uint8_t maxFps, uint8_t dataHz);
+
+    /// Ask for a frame (any task)
+    static void invalidate(RenderReason reason);
+
+    /// Ask for a frame from an interrupt handler
+    static void IRAM_ATTR invalidateFromIsr(RenderReason reason);
+
+    /**
+     * @brief Block DisplayTask until the next frame is due
+     *
+     * @param floorHz Current floor rate (lower while idle)
+     * @return Requested RenderReason bits of this frame (0 = floor frame)
+     */
+    static uint32_t waitForFrame(uint8_t floorHz);
+
+    static const RenderStats& getStats() { return stats_; }
+    static void resetStats();
+    static void dump(Print& out);
+
+private:
+    static TaskHandle_t task_;
+    static RenderStats stats_;
+};
+
+#endif // ILITE_RENDER_SCHEDULER_H
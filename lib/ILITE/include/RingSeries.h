@@ -0,0 +1,123 @@
+/**
+ * @file RingSeries.h
+ * @brief Fixed-capacity scrolling sample history with O(1) append
+ *
+ * Scrolling plots used to shift a whole array by one element per sample.
+ * RingSeries keeps a head index instead: push() overwrites the oldest sample
+ * and iteration walks from oldest to newest, so renderers draw exactly as if
+ * the data had been shifted.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * RingSeries<int16_t, 128> history;
+ * history.push(sample);                    // O(1), from the telemetry path
+ *
+ * int x = 128 - history.size();            // right-align a partial history
+ * for (int16_t value : history) {          // oldest -> newest
+ *     plot(x++, value);
+ * }
+ * ```
+ *
+ * ## Thread Safety:
+ * None. A reader racing a writer may see one sample from the next push;
+ * for scrolling plots that is harmless.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_RING_SERIES_H
+#define ILITE_RING_SERIES_H
+
+#include <Arduino.h>
+
+/**
+ * @class RingSeries
+ * @brief Circular buffer of the last N samples
+ *
+ * @tparam T Sample type
+ * @tparam N Capacity (powers of two make indexing a mask)
+ */
+template<typename T, size_t N>
+class RingSeries {
+public:
+    static_assert(N > 0, "RingSeries capacity must be non-zero");
+
+    /**
+     * @brief Forward iterator, oldest to newest
+     */
+    class const_iterator {
+    public:
+        const_iterator(const RingSeries* series, size_t index)
+            : series_(series), index_(index) {}
+
+        const T& operator*() const { return (*series_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const RingSeries* series_;
+        size_t index_;
+    };
+
+    /**
+     * @brief Append a sample, dropping the oldest once full
+     */
+    void push(const T& value) {
+        data_[head_] = value;
+        head_ = wrap(head_ + 1);
+        if (count_ < N) {
+            count_++;
+        }
+    }
+
+    /**
+     * @brief Remove all samples
+     */
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+    /**
+     * @brief Fill to capacity with one value (e.g. a zero baseline)
+     */
+    void fill(const T& value) {
+        for (size_t i = 0; i < N; ++i) {
+            data_[i] = value;
+        }
+        head_ = 0;
+        count_ = N;
+    }
+
+    /// Sample `index` counted from the oldest (0) to the newest (size() - 1)
+    const T& operator[](size_t index) const {
+        return data_[wrap(head_ + N - count_ + index)];
+    }
+
+    /// Most recent sample (undefined if empty)
+    const T& newest() const { return data_[wrap(head_ + N - 1)]; }
+
+    /// Oldest retained sample (undefined if empty)
+    const T& oldest() const { return (*this)[0]; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+    static constexpr size_t capacity() { return N; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count_); }
+
+private:
+    static size_t wrap(size_t index) {
+        return ((N & (N - 1)) == 0) ? (index & (N - 1)) : (index % N);
+    }
+
+    T data_[N] = {};
+    size_t head_ = 0;   ///< Next slot to write
+    size_t count_ = 0;  ///< Valid samples (<= N)
+};
+
+#endif // ILITE_RING_SERIES_H
@@ -0,0 +1,120 @@
+/**
+ * @file RxRing.h
+ * @brief Lock-free single-producer/single-consumer receive ring for ESP-NOW frames
+ *
+ * The ESP-NOW receive callback runs inside the WiFi task. Anything slow done
+ * there (mutexes, logging, module handlers) stalls the radio stack. RxRing
+ * lets the callback do nothing but copy the frame into a fixed slot, while a
+ * consumer task on the comm core drains the ring in batches.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * // Producer (ESP-NOW callback, WiFi task):
+ * ring.push(mac, data, len);
+ *
+ * // Consumer (comm core):
+ * while (const RxFrame* frame = ring.front()) {
+ *     process(frame->mac, frame->data, frame->length);
+ *     ring.pop();
+ * }
+ * ```
+ *
+ * ## Thread Safety:
+ * Exactly one producer and one consumer. No locks are taken; head and tail
+ * indices are published with acquire/release ordering so a slot is never
+ * read while it is being written.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_RX_RING_H
+#define ILITE_RX_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief One received ESP-NOW frame, stamped on arrival
+ */
+struct RxFrame {
+    static constexpr size_t kMaxPayload = 250;  ///< ESP-NOW maximum payload
+
+    uint8_t mac[6];                 ///< Sender MAC address
+    uint8_t length;                 ///< Payload length in bytes
+    uint32_t timestampUs;           ///< micros() when the callback fired
+    uint8_t data[kMaxPayload];      ///< Payload bytes
+};
+
+/**
+ * @class RxRing
+ * @brief Fixed-capacity SPSC ring of RxFrame slots
+ */
+class RxRing {
+public:
+    /// Number of slots (power of two). 16 x ~260 bytes = ~4 KB.
+    static constexpr size_t kCapacity = 16;
+
+    RxRing();
+
+    /**
+     * @brief Copy a frame into the next free slot (producer side)
+     * @return false if the ring was full or the frame oversized (frame dropped)
+     */
+    bool push(const uint8_t* mac, const uint8_t* data, int len);
+
+    /**
+     * @brief Next free slot for the producer to fill in place, or nullptr if full
+     *
+     * For producers that decode straight into the ring (see UartTransport).
+     * The slot is not visible to the consumer until commit(); reserving again
+     * without a commit returns the same slot. A full ring counts an overflow.
+     */
+    RxFrame* reserve();
+
+    /**
+     * @brief Publish the slot returned by reserve() (producer side)
+     *
+     * The caller has written mac and `length` bytes of data; the timestamp is
+     * taken here.
+     */
+    void commit(uint8_t length);
+
+    /**
+     * @brief Oldest unread frame, or nullptr if empty (consumer side)
+     *
+     * The pointer stays valid until pop() is called.
+     */
+    const RxFrame* front() const;
+
+    /**
+     * @brief Release the frame returned by front() (consumer side)
+     */
+    void pop();
+
+    /**
+     * @brief Number of frames waiting to be consumed
+     */
+    size_t size() const;
+
+    /**
+     * @brief Frames dropped because the ring was full or oversized
+     */
+    uint32_t getOverflowCount() const { return overflowCount_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Highest number of frames queued at once since boot
+     */
+    size_t getHighWaterMark() const { return highWaterMark_.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "RxRing capacity must be a power of two");
+
+    RxFrame slots_[kCapacity];
+    std::atomic<uint32_t> head_;    ///< Next slot to write (producer owned)
+    std::atomic<uint32_t> tail_;    ///< Next slot to read (consumer owned)
+    std::atomic<uint32_t> overflowCount_;
+    std::atomic<size_t> highWaterMark_;
+};
+
+#endif // ILITE_RX_RING_H
@@ -0,0 +1,123 @@
+/**
+ * @file ScreenCapture.h
+ * @brief Display frames as XOR-delta, run-length encoded streams for recording and remote view
+ *
+ * Demo videos of the controller are filmed off the OLED, and a remote
+ * helper cannot see what the driver's screen shows. ScreenCapture copies
+ * each frame DisplayCanvas::sendBuffer() puts on the panel and streams it:
+ *
+ * - **Delta**: each 128-byte page is XORed with the receiver's copy of it
+ *   (the sink keeps a reference frame), so unchanged bytes become zero.
+ *   Unchanged pages are left out, and a frame with no changed page is not
+ *   sent at all: a static screen costs nothing.
+ * - **Run length**: the XOR stream is PackBits coded (encodeDelta()), so a
+ *   changed digit in a page costs its few bytes plus two per zero run.
+ * - **Keyframes** are encoded against an empty screen, so they are mostly
+ *   runs too. One goes out when a sink starts, every kKeyframeMs, and
+ *   after a tap record was dropped, so a receiver joining late or losing a
+ *   record recovers.
+ * - **Sinks**: the TelemetryTap (FRAME_DISPLAY, "screen on") for recording
+ *   with tools/screen_view.py, and the WebDashboard page, which draws the
+ *   screen above the telemetry while a phone is connected.
+ *
+ * Only geometries of at most kFrameBytes with pages of at most
+ * kMaxPageBytes are captured (the 128x64 panels qualify).
+ *
+ * ## Encoding
+ * ```
+ * delta   = { ctrl:u8 ... }*
+ *   ctrl 0x00-0x7F   ctrl + 1 literal XOR bytes follow
+ *   ctrl 0x80-0xFF   one byte follows, repeated ctrl - 0x80 + 3 times
+ * ```
+ * A decoder XORs the expanded bytes into its copy of the page. Pixel
+ * (x, y) of a frame is bit y % 8 of byte (y / 8) * tileWidth * 8 + x.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * // DisplayCanvas::sendBuffer(), after the front buffer was updated
+ * ScreenCapture::onFrame(shadow_, tileWidth_, pageCount_, tiles > 0);
+ *
+ * // Console
+ * ScreenCapture::setTapStreaming(true);
+ * ```
+ *
+ * ## Thread Safety:
+ * onFrame() runs on the display task and does the tap encoding there.
+ * The web task takes frames with copyLatest(); a portMUX guards the
+ * latest-frame copy. The setters may be called from any task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SCREEN_CAPTURE_H
+#define ILITE_SCREEN_CAPTURE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief Capture counters (see ScreenCapture::dump)
+ */
+struct ScreenCaptureStats {
+    uint32_t frames;            ///< Frames seen while a sink was active
+    uint32_t tapFrames;         ///< Frames sent to the tap
+    uint32_t tapKeyframes;
+    uint32_t tapBytes;          ///< Encoded page bytes sent to the tap
+    uint32_t tapDrops;          ///< Records the tap queue refused
+    uint32_t unsupported;       ///< Frames of a geometry that is not captured
+};
+
+/**
+ * @class ScreenCapture
+ * @brief Static frame tap between DisplayCanvas and the streaming sinks
+ */
+class ScreenCapture {
+public:
+    static constexpr size_t kFrameBytes = 1024;         ///< 128x64 monochrome
+    static constexpr size_t kMaxPageBytes = 128;        ///< One page in one tap record
+    static constexpr size_t kMaxEncodedPage = kMaxPageBytes + kMaxPageBytes / 128 + 1;
+    static constexpr uint32_t kKeyframeMs = 2000;
+
+    /// A frame reached the panel (display task); `changed` is false when it matched the last one
+    static inline void onFrame(const uint8_t* frame, uint8_t tileWidth, uint8_t pageCount,
+                               bool changed) {
+        if (active_.load(std::memory_order_relaxed)) {
+            capture(frame, tileWidth, pageCount, changed);
+        }
+    }
+
+    /// Stream frames to the TelemetryTap (it must be running to see them)
+    static bool setTapStreaming(bool enabled);
+    static bool isTapStreaming();
+
+    /// A dashboard client started (true) or stopped (false) viewing
+    static bool setWebViewer(bool viewing);
+
+    /**
+     * @brief Copy the newest frame if it is not `sequence` (web task)
+     * @param out kFrameBytes buffer
+     * @param sequence In: the frame the caller holds; out: the one copied
+     * @return false if no newer frame was captured
+     */
+    static bool copyLatest(uint8_t* out, uint32_t& sequence, uint8_t& tileWidth, uint8_t& pageCount);
+
+    /**
+     * @brief PackBits-encode `current` XOR `reference`
+     * @param out At least length + length / 128 + 1 bytes
+     * @return Encoded bytes
+     */
+    static size_t encodeDelta(const uint8_t* current, const uint8_t* reference, size_t length,
+                              uint8_t* out);
+
+    static ScreenCaptureStats getStats();
+    static void dump(Print& out);
+
+private:
+    static void capture(const uint8_t* frame, uint8_t tileWidth, uint8_t pageCount, bool changed);
+    static bool updateActive();
+
+    static std::atomic<bool> active_;
+};
+
+#endif // ILITE_SCREEN_CAPTURE_H
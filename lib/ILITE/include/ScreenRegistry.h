@@ -4,6 +4,22 @@
  *
  * Allows users to register custom full-screen UIs with event handlers.
  * Screens can be accessed from menus or triggered programmatically.
+ * Handlers are Delegate (see Delegate.h): captureless lambdas, functions or
+ * lambdas capturing one pointer.
+ *
+ * Screen is an aggregate, so a definition whose handlers are all functions
+ * is a constant. The framework's screens are `constexpr` records in flash
+ * registered by address with registerTable(); registerScreen() copies a
+ * screen built at run time to the heap. Either way a Screen pointer stays
+ * valid until clear().
+ *
+ * Lookups go through a hash index of the IDs built at registration, so
+ * find() costs one hash of the ID whatever the number of screens. It
+ * returns a ScreenHandle (index plus registry generation) that callers may
+ * keep: after clear() it resolves to nothing instead of a freed record.
+ * The navigation stack holds handles in a fixed array, and show() and
+ * back() copy the top screen's handlers into a RAM dispatch table, so an
+ * input event is one indexed call that never reads the flash record.
  *
  * @example
  * ```cpp
@@ -25,10 +41,11 @@
 #define ILITE_SCREEN_REGISTRY_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <vector>
-#include <functional>
 #include "DisplayCanvas.h"
 #include "IconLibrary.h"
+#include "Delegate.h"
 
 /// Screen ID type
 using ScreenID = const char*;
@@ -42,29 +59,42 @@ struct Screen {
     IconID icon;                    ///< Icon (optional)
 
     /// Draw function (required) - called at 10Hz
-    std::function<void(DisplayCanvas&)> drawFunc;
+    Delegate<void(DisplayCanvas&)> drawFunc;
 
     /// Update function (optional) - called at 10Hz before draw
-    std::function<void()> updateFunc;
+    Delegate<void()> updateFunc;
 
     // Input event handlers (all optional)
-    std::function<void(int delta)> onEncoderRotate;
-    std::function<void()> onEncoderPress;
-    std::function<void()> onButton1;
-    std::function<void()> onButton2;
-    std::function<void()> onButton3;
+    Delegate<void(int delta)> onEncoderRotate;
+    Delegate<void()> onEncoderPress;
+    Delegate<void()> onButton1;
+    Delegate<void()> onButton2;
+    Delegate<void()> onButton3;
 
     /// Whether this is a modal overlay (true) or full-screen (false)
     bool isModal;
 
     /// Condition for availability (optional)
-    std::function<bool()> condition;
+    Delegate<bool()> condition;
 
     /// Called when screen is shown
-    std::function<void()> onShow;
+    Delegate<void()> onShow;
 
     /// Called when screen is hidden
-    std::function<void()> onHide;
+    Delegate<void()> onHide;
+};
+
+/**
+ * @brief Stable reference to a registered screen (see ScreenRegistry::find)
+ */
+struct ScreenHandle {
+    uint16_t index;         ///< Registration order
+    uint16_t generation;    ///< Registry generation it was resolved in
+
+    bool operator==(const ScreenHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const ScreenHandle& other) const { return !(*this == other); }
 };
 
 /**
@@ -72,12 +102,40 @@ struct Screen {
  */
 class ScreenRegistry {
 public:
+    static constexpr size_t kMaxDepth = 8;              ///< Navigation stack entries
+    static constexpr uint16_t kNoIndex = 0xFFFF;
+    static constexpr ScreenHandle kNoScreen = {kNoIndex, 0};
+
     /**
-     * @brief Register a screen
+     * @brief Register a screen (copied to the heap)
      * @param screen Screen definition
      */
     static void registerScreen(const Screen& screen);
 
+    /**
+     * @brief Register a static table of screens by address
+     *
+     * The table is not copied and must outlive the registry; make it
+     * `constexpr` so it stays in flash.
+     *
+     * @param screens First screen
+     * @param count Number of screens
+     */
+    static void registerTable(const Screen* screens, size_t count);
+
+    /**
+     * @brief Resolve a screen ID once
+     * @param id Screen ID
+     * @return Handle, or kNoScreen if not registered
+     */
+    static ScreenHandle find(ScreenID id);
+
+    /**
+     * @brief Get screen by handle
+     * @return Pointer to screen, or nullptr if the handle is stale or unknown
+     */
+    static const Screen* getScreen(ScreenHandle handle);
+
     /**
      * @brief Get screen by ID
      * @param id Screen ID
@@ -94,9 +152,9 @@ public:
 
     /**
      * @brief Get all registered screens
-     * @return Vector of screens
+     * @return Screens in registration order
      */
-    static std::vector<Screen>& getAllScreens();
+    static const std::vector<const Screen*>& getAllScreens();
 
     /**
      * @brief Clear all screens
@@ -114,12 +172,21 @@ public:
      */
     static bool show(ScreenID id);
 
+    /**
+     * @brief Show a screen resolved with find()
+     * @return false if the handle is stale, the condition fails or the stack is full
+     */
+    static bool show(ScreenHandle handle);
+
     /**
      * @brief Go back to previous screen (pop stack)
      * @return true if went back, false if at bottom of stack
      */
     static bool back();
 
+    /// back() as a button handler, for screen tables
+    static void goBack() { back(); }
+
     /**
      * @brief Clear navigation stack and return to default
      */
@@ -131,6 +198,12 @@ public:
      */
     static const Screen* getActiveScreen();
 
+    /**
+     * @brief Get the handle of the active screen
+     * @return Handle, or kNoScreen if none
+     */
+    static ScreenHandle getActiveHandle();
+
     /**
      * @brief Check if a custom screen is active
      * @return true if screen stack is not empty
@@ -174,17 +247,56 @@ public:
     static void updateActiveScreen();
 
 private:
-    static std::vector<Screen> screens_;
-    static std::vector<const Screen*> navigationStack_;
+    /// Handlers of the top screen, copied out of its record by install()
+    struct Dispatch {
+        const Screen* screen;
+        Delegate<void(DisplayCanvas&)> draw;
+        Delegate<void()> update;
+        Delegate<void(int delta)> rotate;
+        Delegate<void()> press;
+        Delegate<void()> buttons[3];
+        bool modal;
+    };
+
+    /// Warn and return true if the screen's ID is taken
+    static bool isDuplicate(const Screen& screen);
+    static void add(const Screen* screen);
+    static bool indexScreen(uint16_t index);
+    static bool rebuildIndex(size_t slots);
+
+    /// Publish the dispatch table of `screen` (nullptr: no active screen)
+    static void install(const Screen* screen);
+    static const Dispatch& active() { return dispatch_[activeDispatch_.load(std::memory_order_acquire)]; }
+
+    static std::vector<const Screen*> screens_;     ///< Flash records and heap copies
+    static std::vector<Screen*> copies_;            ///< registerScreen() copies (RAM overlay)
+
+    static int16_t* index_;                         ///< Open addressing by ID hash, -1 = empty
+    static size_t indexSlots_;                      ///< Power of 2, at least twice the screens
+    static uint16_t generation_;                    ///< Bumped by clear()
+
+    static ScreenHandle stack_[kMaxDepth];
+    static uint8_t depth_;
+
+    // Double-buffered, so a draw on the display task never sees a half-copied table
+    static Dispatch dispatch_[2];
+    static std::atomic<uint8_t> activeDispatch_;
 };
 
 // ============================================================================
 // Registration Macros
 // ============================================================================
 
+// Unique names per use, so IDs can be string literals
+#define ILITE_SCREEN_CONCAT_INNER(a, b) a##b
+#define ILITE_SCREEN_CONCAT(a, b) ILITE_SCREEN_CONCAT_INNER(a, b)
+
 /**
  * @brief Macro for registering simple screens
  *
+ * The screen is registered by address. It is a constant (flash) when
+ * drawFunc is a function.
+ *
  * @example
  * ```cpp
  * REGISTER_SCREEN_SIMPLE(
@@ -197,33 +309,20 @@ private:
  */
 #define REGISTER_SCREEN_SIMPLE(id, title, icon, drawFunc) \
     namespace { \
-        struct ScreenRegistrar_##id { \
-            ScreenRegistrar_##id() { \
-                ScreenRegistry::registerScreen({ \
-                    #id, \
-                    title, \
-                    icon, \
-                    drawFunc, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr, \
-                    false, \
-                    nullptr, \
-                    nullptr, \
-                    nullptr \
-                }); \
+        const Screen ILITE_SCREEN_CONCAT(g_screen_, __LINE__)[] = {{id, title, icon, drawFunc}}; \
+        struct ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__) { \
+            ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__)() { \
+                ScreenRegistry::registerTable(ILITE_SCREEN_CONCAT(g_screen_, __LINE__), 1); \
             } \
         }; \
-        static ScreenRegistrar_##id g_screenRegistrar_##id; \
+        ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__) ILITE_SCREEN_CONCAT(g_screenRegistrar_, __LINE__); \
     }
 
 /**
  * @brief Macro for registering screens with full configuration
  *
- * Uses designated initializers for cleaner syntax.
+ * Uses designated initializers for cleaner syntax. The screen is defined
+ * in place and registered by address; the ID is filled in at startup.
  *
  * @example
  * ```cpp
@@ -235,15 +334,16 @@ private:
  * });
  * ```
  */
-#define REGISTER_SCREEN(id, ...) \
+#define REGISTER_SCREEN(screenId, ...) \
     namespace { \
-        struct ScreenRegistrar_##id { \
-            ScreenRegistrar_##id() { \
-                Screen screen = {#id, __VA_ARGS__}; \
-                ScreenRegistry::registerScreen(screen); \
+        Screen ILITE_SCREEN_CONCAT(g_screen_, __LINE__)[] = {__VA_ARGS__}; \
+        struct ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__) { \
+            ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__)() { \
+                ILITE_SCREEN_CONCAT(g_screen_, __LINE__)[0].id = screenId; \
+                ScreenRegistry::registerTable(ILITE_SCREEN_CONCAT(g_screen_, __LINE__), 1); \
             } \
         }; \
-        static ScreenRegistrar_##id g_screenRegistrar_##id; \
+        ILITE_SCREEN_CONCAT(ScreenRegistrar_, __LINE__) ILITE_SCREEN_CONCAT(g_screenRegistrar_, __LINE__); \
     }
 
 #endif // ILITE_SCREEN_REGISTRY_H
@@ -0,0 +1,157 @@
+/**
+ * @file SerialBridge.h
+ * @brief PC-to-robot bridge: command frames from USB serial straight onto the link
+ *
+ * For autonomous testing a PC script drives the paired robot through the
+ * controller. "bridge" on the console hands the port to SerialBridge:
+ *
+ * - Serial switches to ILITEConfig::bridgeBaud with a larger RX buffer.
+ *   The UART's receive event wakes the bridge task, so a frame is
+ *   forwarded as soon as its delimiter is read instead of on the next
+ *   console poll.
+ * - Each command frame from the host goes to the paired robot as-is
+ *   through the active Transport, decoded in place. The host's bytes
+ *   replace what the module's prepareCommandPacket() would have produced.
+ *   No change-only cache, redundancy, bundling or stamps are applied.
+ * - The active module's updateControl() and command packets stop for the
+ *   paired robot; team peers keep running. Every frame the robot sends
+ *   still reaches the module, and is also copied to the host.
+ * - The display shows a static bridge screen, refreshed once a second,
+ *   instead of the UI.
+ *
+ * The bridge ends when the host sends the end frame, goes quiet for
+ * kIdleTimeoutMs, or the encoder is pressed. The console baud returns and
+ * the summary prints; "bridge stats" prints it again.
+ *
+ * ## Wire Format
+ * TelemetryTap framing (COBS, 0x00 delimiter, CRC-16/CCITT-FALSE, little-
+ * endian):
+ * ```
+ * frame   = COBS(kind:u8 timeUs:u32 body crc:u16) 0x00
+ *
+ * kind 0x20 command    host -> controller, body = ESP-NOW frame (1-250 bytes)
+ *                      timeUs = host clock, echoed in the sent report
+ * kind 0x21 telemetry  controller -> host, body = frame from the robot
+ *                      timeUs = receive callback time
+ * kind 0x22 sent       controller -> host, timeUs = echoed host time
+ *                      body = status:u8 forwardUs:u32 airUs:u32
+ * kind 0x12 dropped    controller -> host, count:u32 (telemetry lost)
+ * kind 0x13 end        host -> controller, leave the bridge
+ * ```
+ * `status` is 0 when the driver reported the frame sent, 1 when it
+ * failed, 2 when the driver queue was full (not sent). `forwardUs` is the
+ * time from reading the frame's last byte to calling send(), `airUs` from
+ * there to the send callback.
+ *
+ * The send callback only names the peer, so sent reports are matched to
+ * commands in send order. A callback for another frame to the robot (a
+ * discovery ping, say) can shift one report; entries without a callback
+ * are dropped after kCallbackTimeoutUs.
+ *
+ * ## Thread Safety:
+ * start() and service() run on ServiceTask. onTelemetry() runs on RxTask,
+ * onSendComplete() on the WiFi task; both only queue. The bridge task owns
+ * the port while the bridge is active.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SERIAL_BRIDGE_H
+#define ILITE_SERIAL_BRIDGE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class DisplayCanvas;
+
+static constexpr size_t kBridgeLatencyBuckets = 8;
+
+/**
+ * @brief Counters of the current or last bridge session
+ */
+struct SerialBridgeStats {
+    uint32_t commands = 0;          ///< Frames sent to the robot
+    uint32_t telemetry = 0;         ///< Robot frames copied to the host
+    uint32_t dropped = 0;           ///< Robot frames lost on a full queue
+    uint32_t badFrames = 0;         ///< COBS/CRC/format errors from the host
+    uint32_t sendFailures = 0;      ///< send() errors and failed callbacks
+    uint32_t driverFull = 0;        ///< ESP_ERR_ESPNOW_NO_MEM
+    uint32_t unmatched = 0;         ///< Commands whose callback never came
+    uint32_t rxBytes = 0;
+    uint32_t txBytes = 0;
+    uint32_t forwardMinUs = 0;      ///< Last byte read -> send() called
+    uint32_t forwardMaxUs = 0;
+    uint32_t forwardAvgUs = 0;
+    uint32_t airMinUs = 0;          ///< send() called -> send callback
+    uint32_t airMaxUs = 0;
+    uint32_t airAvgUs = 0;
+    uint32_t histogram[kBridgeLatencyBuckets] = {};  ///< Last byte read -> send callback
+    uint32_t elapsedMs = 0;
+};
+
+/**
+ * @class SerialBridge
+ * @brief Static bridge session and its task
+ */
+class SerialBridge {
+public:
+    enum FrameKind : uint8_t {
+        FRAME_COMMAND = 0x20,
+        FRAME_TELEMETRY = 0x21,
+        FRAME_SENT = 0x22
+    };
+
+    enum SentStatus : uint8_t {
+        SENT_OK = 0,
+        SENT_FAILED = 1,
+        SENT_BUSY = 2
+    };
+
+    static constexpr size_t kQueueSize = 16;            ///< Records waiting for the host
+    static constexpr size_t kPending = 8;               ///< Commands awaiting their callback
+    static constexpr size_t kRxBufferBytes = 4096;      ///< UART driver buffer while bridging
+    static constexpr uint32_t kIdleTimeoutMs = 2000;
+    static constexpr uint32_t kCallbackTimeoutUs = 20000;
+
+    /// Upper bound (us) of each latency bucket; the last is open-ended
+    static const uint32_t kBucketUs[kBridgeLatencyBuckets];
+
+    /**
+     * @brief Hand `port` to the bridge (ServiceTask)
+     *
+     * Creates the bridge task on first use with the given placement.
+     *
+     * @param peerMac Robot the commands go to
+     * @return false if already active or out of memory
+     */
+    static bool start(HardwareSerial& port, uint32_t baud, const uint8_t* peerMac,
+                      UBaseType_t priority, BaseType_t core);
+
+    /// Leave the bridge (any task); the bridge task restores the port
+    static void stop();
+
+    /// Bridge active: the port and the paired robot's commands belong to the PC
+    static bool isActive() { return active_.load(std::memory_order_acquire); }
+
+    /// End a finished session and print its summary (ServiceTask)
+    static void service();
+
+    /// A frame from the bridged robot (RxTask)
+    static void onTelemetry(const uint8_t* mac, const uint8_t* data, size_t length,
+                            uint32_t timestampUs);
+
+    /// Send callback hook (WiFi task)
+    static void onSendComplete(const uint8_t* mac, bool success);
+
+    /// The static screen shown while the UI is paused
+    static void drawScreen(DisplayCanvas& canvas);
+
+    static SerialBridgeStats getStats();
+    static void dump(Print& out);
+
+private:
+    static std::atomic<bool> active_;
+};
+
+#endif // ILITE_SERIAL_BRIDGE_H
@@ -0,0 +1,141 @@
+/**
+ * @file SeriesBuffer.h
+ * @brief Long sample history with a min/max decimation pyramid for plotting
+ *
+ * A 128-pixel plot of a 10 s window at 100 Hz covers ~8 samples per column.
+ * Scanning every sample each frame works for short windows but not for
+ * thousands of samples. SeriesBuffer keeps, next to the raw ring, min/max
+ * buckets of 2, 4, 8 ... samples that are updated as each sample arrives.
+ * decimate() then builds every column from a handful of aligned buckets, so
+ * the cost per frame depends on the plot width, not the window length.
+ *
+ * The buffer also tracks an auto-range that grows immediately with new
+ * extremes and shrinks as old samples leave the window.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * SeriesBuffer history(11);                // 2048 samples
+ * history.push(sample);                    // O(log N), from the telemetry path
+ *
+ * // DisplayTask: last 1000 samples across the full width, auto-ranged
+ * UIComponents::drawSeries(canvas, 0, 16, 128, 40, history, 1000);
+ * ```
+ *
+ * ## Thread Safety:
+ * Single writer. A reader racing the writer may see one half-updated column,
+ * which is harmless for plotting.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SERIES_BUFFER_H
+#define ILITE_SERIES_BUFFER_H
+
+#include <Arduino.h>
+
+/**
+ * @class SeriesBuffer
+ * @brief Ring of int16 samples plus per-level min/max buckets
+ */
+class SeriesBuffer {
+public:
+    static constexpr uint8_t kMinCapacityLog2 = 4;    ///< 16 samples
+    static constexpr uint8_t kMaxCapacityLog2 = 14;   ///< 16384 samples
+    static constexpr uint8_t kTopBuckets = 8;         ///< Buckets at the coarsest level
+
+    /**
+     * @brief Allocate a buffer of 2^capacityLog2 samples
+     *
+     * Uses ~6 bytes per sample (raw + pyramid). Out-of-range sizes are clamped.
+     */
+    explicit SeriesBuffer(uint8_t capacityLog2 = 10);
+
+    /**
+     * @brief Use caller-owned storage instead of allocating
+     *
+     * `storage` must hold storageValues(capacityLog2) values and outlive the
+     * buffer; it is not freed (e.g. a module's ModuleArena state block).
+     */
+    SeriesBuffer(uint8_t capacityLog2, int16_t* storage);
+    ~SeriesBuffer();
+
+    /// int16 values of storage for 2^capacityLog2 samples (clamped like the constructor)
+    static size_t storageValues(uint8_t capacityLog2);
+
+    SeriesBuffer(const SeriesBuffer&) = delete;
+    SeriesBuffer& operator=(const SeriesBuffer&) = delete;
+
+    /**
+     * @brief Append a sample, dropping the oldest once full
+     */
+    void push(int16_t value);
+
+    /**
+     * @brief Remove all samples and reset the auto-range
+     */
+    void clear();
+
+    /// Retained samples (<= capacity())
+    size_t size() const;
+
+    /// Maximum retained samples
+    size_t capacity() const { return capacity_; }
+
+    /// Most recent sample (0 if empty)
+    int16_t newest() const;
+
+    /// Samples pushed since construction or clear()
+    uint32_t getTotalCount() const { return total_; }
+
+    /**
+     * @brief Copy the most recent raw samples, oldest first
+     * @return Samples copied (min of count and size())
+     */
+    size_t copyRecent(size_t count, int16_t* out) const;
+
+    /**
+     * @brief Auto-range over (approximately) the retained window
+     *
+     * Widens immediately on new extremes; narrows each time a coarsest-level
+     * bucket completes, so old spikes age out.
+     *
+     * @return false if no samples yet
+     */
+    bool getRange(int16_t& minValue, int16_t& maxValue) const;
+
+    /**
+     * @brief Per-column min/max of the most recent `window` samples
+     *
+     * When the window has fewer samples than columns, one sample per column
+     * is returned (min == max) and fewer columns are filled.
+     *
+     * @param window Samples to cover (0 or > size() = everything retained)
+     * @param columns Output columns available
+     * @param minOut Column minima, oldest column first
+     * @param maxOut Column maxima, oldest column first
+     * @return Columns filled
+     */
+    size_t decimate(size_t window, size_t columns, int16_t* minOut, int16_t* maxOut) const;
+
+private:
+    static constexpr uint8_t kMaxLevels = kMaxCapacityLog2;
+
+    void mergeRange(uint32_t start, uint32_t end, uint8_t maxLevel,
+                    int16_t& minValue, int16_t& maxValue) const;
+    void recomputeRange();
+    void layout(int16_t* storage);
+
+    int16_t* raw_;
+    int16_t* levelMin_[kMaxLevels + 1];   ///< [l] buckets of 2^l samples (l >= 1)
+    int16_t* levelMax_[kMaxLevels + 1];
+    uint32_t capacity_;
+    uint8_t capacityLog2_;
+    uint8_t levels_;                      ///< Coarsest level in use
+    uint32_t total_;
+    int16_t rangeMin_;
+    int16_t rangeMax_;
+    bool ownsStorage_;
+};
+
+#endif // ILITE_SERIES_BUFFER_H
@@ -0,0 +1,229 @@
+/**
+ * @file SettingsStore.h
+ * @brief RAM-cached settings with deferred, batched NVS commits
+ *
+ * PreferencesManager writes through to NVS: every put is a flash write and
+ * a commit, on whatever task made the edit. A menu value turned with the
+ * encoder can produce dozens of writes per second. SettingsStore keeps each
+ * setting in RAM instead:
+ *
+ * - **Typed keys**: add() reads the stored value once (or keeps the
+ *   default) and returns a Setting<T> handle; get() and set() only touch RAM.
+ * - **Dirty tracking**: set() marks a key dirty only if its bytes change.
+ * - **Batched commit**: a background task writes all dirty keys once the
+ *   oldest edit is commitPeriodMs old, with one nvs_commit per namespace.
+ *   flush() asks for a commit now (module switch); commitNow() commits on
+ *   the calling task (before sleep or an OTA update).
+ * - **Wear-aware**: keys whose stored value already matches (an edit that
+ *   was undone before the commit) are not written.
+ *
+ * Values are stored with the same NVS types as Preferences (putInt, putUInt,
+ * putFloat, putBool, putString, putBytes), so keys written by either API
+ * read back through the other.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * static Setting<float> kp;
+ * kp = SettingsStore::getInstance().add("drongaze", "kp", 1.0f);
+ *
+ * kp.set(kp.get() + 0.05f);       // RAM only, committed within 5 s
+ * SettingsStore::getInstance().flush();
+ * ```
+ *
+ * Namespace and key strings are kept by pointer (use literals). Keys are
+ * limited to 15 characters and values to kMaxValueBytes, as in NVS.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SETTINGS_STORE_H
+#define ILITE_SETTINGS_STORE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <type_traits>
+
+/**
+ * @brief Stored representation of a setting
+ */
+enum class SettingType : uint8_t {
+    Int,        ///< int32_t (nvs i32)
+    UInt,       ///< uint32_t (nvs u32)
+    Float,      ///< float (4-byte blob, like Preferences::putFloat)
+    Bool,       ///< bool (nvs u8)
+    String,     ///< NUL-terminated text (nvs str)
+    Bytes       ///< Any trivially copyable struct (nvs blob)
+};
+
+/**
+ * @brief Commit counters (see SettingsStore::getStats)
+ */
+struct SettingsStats {
+    uint32_t commits;           ///< Batches that wrote at least one key
+    uint32_t keysWritten;
+    uint32_t keysUnchanged;     ///< Dirty keys skipped because NVS already matched
+    uint32_t failures;          ///< NVS errors
+    uint32_t lastCommitUs;
+    uint32_t maxCommitUs;
+    uint32_t totalCommitUs;
+};
+
+template <typename T>
+class Setting;
+class SettingString;
+
+/**
+ * @class SettingsStore
+ * @brief Singleton table of cached settings and the commit task
+ */
+class SettingsStore {
+public:
+    static constexpr size_t kMaxEntries = 32;
+    static constexpr size_t kMaxValueBytes = 64;
+    static constexpr uint32_t kDefaultCommitMs = 5000;
+
+    static SettingsStore& getInstance();
+
+    /**
+     * @brief Start the commit task
+     * @param commitPeriodMs Commit once the oldest pending edit is this old
+     * @return true if the task runs (settings work without it, but only
+     *         commitNow() writes them)
+     */
+    bool begin(uint32_t commitPeriodMs = kDefaultCommitMs);
+
+    /**
+     * @brief Register a typed setting and load its stored value
+     *
+     * Adding the same namespace/key again returns the existing handle.
+     * @return Handle; invalid (isValid() false) if the table is full
+     */
+    template <typename T>
+    Setting<T> add(const char* space, const char* key, const T& defaultValue) {
+        static_assert(std::is_trivially_copyable<T>::value, "Settings must be trivially copyable");
+        static_assert(sizeof(T) <= kMaxValueBytes, "Setting too large");
+        return Setting<T>(addEntry(space, key, typeOf(static_cast<T*>(nullptr)),
+                                   &defaultValue, sizeof(T)));
+    }
+
+    /// Register a text setting of at most `maxLength` characters
+    SettingString addString(const char* space, const char* key, const char* defaultValue,
+                            size_t maxLength = kMaxValueBytes - 1);
+
+    /// Ask the commit task to write pending edits now (non-blocking)
+    void flush();
+
+    /**
+     * @brief Write pending edits on the calling task
+     *
+     * Use before deep sleep, a restart or an OTA update.
+     * @return false if any key failed to write
+     */
+    bool commitNow();
+
+    /// Keys with uncommitted edits
+    size_t getDirtyCount() const;
+
+    const SettingsStats& getStats() const { return stats_; }
+
+    /// Print counters and pending keys
+    void dump(Print& out);
+
+private:
+    template <typename T>
+    friend class Setting;
+    friend class SettingString;
+
+    struct Entry {
+        const char* space;
+        const char* key;
+        SettingType type;
+        uint8_t size;               ///< Value bytes (capacity for String)
+        bool dirty;
+        uint8_t value[kMaxValueBytes];
+    };
+
+    SettingsStore();
+    SettingsStore(const SettingsStore&) = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    static SettingType typeOf(int32_t*) { return SettingType::Int; }
+    static SettingType typeOf(uint32_t*) { return SettingType::UInt; }
+    static SettingType typeOf(float*) { return SettingType::Float; }
+    static SettingType typeOf(bool*) { return SettingType::Bool; }
+    static SettingType typeOf(void*) { return SettingType::Bytes; }
+
+    int16_t addEntry(const char* space, const char* key, SettingType type,
+                     const void* defaultValue, size_t size);
+    void read(int16_t slot, void* out, size_t size) const;
+    void write(int16_t slot, const void* value, size_t size);
+    void markDirtyLocked(Entry& entry);
+    bool commit();
+    static void commitTask(void* parameter);
+
+    Entry entries_[kMaxEntries];
+    size_t entryCount_;
+    volatile size_t dirtyCount_;
+    mutable portMUX_TYPE lock_;         ///< Guards values and dirty flags
+    SemaphoreHandle_t commitMutex_;     ///< One commit at a time
+    TaskHandle_t taskHandle_;
+    uint32_t commitPeriodMs_;
+    uint32_t firstDirtyMs_;             ///< millis() of the oldest pending edit
+    SettingsStats stats_;
+};
+
+/**
+ * @brief Handle of a typed setting (cheap to copy, valid for the program)
+ */
+template <typename T>
+class Setting {
+public:
+    Setting() : slot_(-1) {}
+
+    bool isValid() const { return slot_ >= 0; }
+
+    /// Cached value
+    T get() const {
+        T value{};
+        SettingsStore::getInstance().read(slot_, &value, sizeof(T));
+        return value;
+    }
+
+    /// Update the cached value; committed later if it changed
+    void set(const T& value) {
+        SettingsStore::getInstance().write(slot_, &value, sizeof(T));
+    }
+
+private:
+    friend class SettingsStore;
+    explicit Setting(int16_t slot) : slot_(slot) {}
+
+    int16_t slot_;
+};
+
+/**
+ * @brief Handle of a text setting
+ */
+class SettingString {
+public:
+    SettingString() : slot_(-1) {}
+
+    bool isValid() const { return slot_ >= 0; }
+
+    /// Copy the cached text into `buffer`; returns its length
+    size_t get(char* buffer, size_t bufferSize) const;
+
+    /// Update the cached text (truncated to the registered length)
+    void set(const char* text);
+
+private:
+    friend class SettingsStore;
+    explicit SettingString(int16_t slot) : slot_(slot) {}
+
+    int16_t slot_;
+};
+
+#endif // ILITE_SETTINGS_STORE_H
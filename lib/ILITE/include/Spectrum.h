@@ -0,0 +1,132 @@
+/**
+ * @file Spectrum.h
+ * @brief Fixed-size real FFT that runs in bounded slices
+ *
+ * Which frequency an axis oscillates at decides the filter and the gains,
+ * and telemetry traces alone do not show it. Spectrum turns a frame of
+ * int16 samples (e.g. the PID error history) into a magnitude spectrum and
+ * its dominant frequency.
+ *
+ * - **Real FFT**: the N real samples are packed into N/2 complex points,
+ *   transformed with an iterative radix-2 FFT and split into the N/2 bins
+ *   of the real spectrum. The mean is removed and a Hann window applied, so
+ *   DC and the frame edges do not leak across the bins.
+ * - **Slices**: begin() loads a frame and each step() does one bounded
+ *   piece of work - one butterfly stage, or the final split - so a 256-point
+ *   frame takes 8 calls of a few tens of microseconds each. A low-priority
+ *   task can call step() once per tick and never holds the CPU long enough
+ *   to delay the control path.
+ * - **esp-dsp**: where the esp-dsp component is available the butterflies
+ *   run as one dsps_fft2r_fc32() call instead of per-stage slices; its
+ *   assembly kernel takes less than one portable stage. Define
+ *   ILITE_SPECTRUM_NO_ESP_DSP to keep the portable path.
+ *
+ * Magnitudes are amplitudes in input units: a sine of amplitude A at a bin
+ * centre reads A. The dominant frequency is refined between bins by a
+ * parabola through the peak and its neighbours.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * Spectrum spectrum(256);
+ * history.copyRecent(256, frame);
+ * spectrum.begin(frame, 100.0f);
+ *
+ * // Low-priority task, once per tick
+ * if (spectrum.isBusy() && spectrum.step()) {
+ *     Serial.printf("%.1f Hz\n", spectrum.getDominantHz());
+ * }
+ * ```
+ *
+ * Single-threaded; the owner publishes results to other tasks.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SPECTRUM_H
+#define ILITE_SPECTRUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(ILITE_NATIVE) && !defined(ILITE_SPECTRUM_NO_ESP_DSP) && defined(__has_include)
+#if __has_include(<dsps_fft2r.h>)
+#define ILITE_SPECTRUM_ESP_DSP 1
+#endif
+#endif
+
+/**
+ * @class Spectrum
+ * @brief Sliced real FFT with windowing and peak search
+ */
+class Spectrum {
+public:
+    static constexpr size_t kMinPoints = 16;
+    static constexpr size_t kMaxPoints = 256;
+
+    /**
+     * @param points Frame length, a power of two in kMinPoints..kMaxPoints
+     *               (rounded down and clamped)
+     */
+    explicit Spectrum(size_t points = kMaxPoints);
+
+    size_t getPoints() const { return points_; }
+
+    /// Bins of the real spectrum (points / 2; bin 0 is DC)
+    size_t getBinCount() const { return points_ / 2; }
+
+    /**
+     * @brief Load a frame and start transforming it
+     * @param samples getPoints() samples, oldest first
+     * @param sampleHz Rate the samples were taken at
+     * @return false while the previous frame is still in progress
+     */
+    bool begin(const int16_t* samples, float sampleHz);
+
+    /**
+     * @brief Do one slice of the transform
+     * @return true when this slice finished the frame
+     */
+    bool step();
+
+    bool isBusy() const { return stage_ != kIdle; }
+
+    /// Slices one frame takes (including the split)
+    size_t getSliceCount() const;
+
+    // Results of the last finished frame
+
+    const float* getMagnitudes() const { return magnitude_; }
+    float getBinHz() const { return binHz_; }
+    float getDominantHz() const { return dominantHz_; }
+    float getDominantMagnitude() const { return dominantMagnitude_; }
+    size_t getDominantBin() const { return dominantBin_; }
+    uint32_t getFrameCount() const { return frames_; }
+
+private:
+    static constexpr size_t kHalf = kMaxPoints / 2;
+    static constexpr uint8_t kIdle = 0xFF;
+
+    void butterflyStage(uint8_t stage);
+    void split();
+
+    size_t points_;
+    size_t half_;                   ///< Complex points (points / 2)
+    uint8_t stages_;                ///< log2(half_)
+    uint8_t stage_;                 ///< Next butterfly stage, stages_ = split, kIdle = done
+    float sampleHz_;
+
+    float window_[kMaxPoints];
+    float cos_[kHalf];              ///< cos(2 pi k / points), k < points / 2
+    float sin_[kHalf];
+    float work_[kMaxPoints];        ///< half_ interleaved complex points
+
+    float magnitude_[kHalf];
+    float binHz_;
+    float dominantHz_;
+    float dominantMagnitude_;
+    size_t dominantBin_;
+    uint32_t frames_;
+};
+
+#endif // ILITE_SPECTRUM_H
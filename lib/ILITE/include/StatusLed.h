@@ -0,0 +1,90 @@
+/**
+ * @file StatusLed.h
+ * @brief Status LED patterns on the LEDC peripheral, stepped by a timer
+ *
+ * FrameworkEngine toggled GPIO2 from its update loop, comparing millis()
+ * against the last toggle every tick, so blinks stretched and shrank with
+ * the loop's load. StatusLed moves the timing off the loop:
+ *
+ * - **LEDC**: the LED is a PWM channel; a step's ramp to its level is a
+ *   hardware fade, so soft edges and breathing cost no CPU.
+ * - **Patterns**: a pattern is a short table of steps (level, fade time,
+ *   hold time). An esp_timer one-shot fires once per step to start the
+ *   next fade; a pattern of one held step stops the timer.
+ * - **Callers** only pick the pattern (setPattern() with the current one
+ *   is a no-op) or show a level for a while (preview(), e.g. a robot LED
+ *   being adjusted), from any task. Only the timer callback touches LEDC.
+ *
+ * Without LEDC (begin() failed) the steps switch the pin digitally, still
+ * from the timer.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * StatusLed::begin(2);
+ * StatusLed::setPattern(LedPattern::Scanning);
+ *
+ * // Robot light dialled to 180/255: show it for two seconds
+ * StatusLed::preview(180);
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_STATUS_LED_H
+#define ILITE_STATUS_LED_H
+
+#include <Arduino.h>
+
+enum class LedPattern : uint8_t {
+    Off,
+    Scanning,       ///< 200 ms on / 200 ms off
+    Pairing,        ///< 100 ms on / 100 ms off
+    Paired,         ///< On, two short dips every 2 s
+    LowBattery,     ///< Slow breathing
+    Error,          ///< SOS
+    Count
+};
+
+/// Ramp to `level` over fadeMs, then stay for holdMs
+struct LedStep {
+    uint8_t level;
+    uint16_t fadeMs;
+    uint16_t holdMs;
+};
+
+/**
+ * @class StatusLed
+ * @brief Static pattern engine for the one status LED
+ */
+class StatusLed {
+public:
+    static constexpr uint32_t kPwmHz = 5000;
+    static constexpr uint8_t kChannel = 7;          ///< LEDC low-speed channel
+    static constexpr uint8_t kTimer = 3;            ///< LEDC low-speed timer
+    static constexpr uint32_t kPreviewMs = 2000;
+    static constexpr uint16_t kPreviewFadeMs = 150;
+
+    /**
+     * @brief Attach the pin to LEDC and create the step timer
+     * @return false if LEDC could not be set up (digital fallback)
+     */
+    static bool begin(uint8_t pin);
+
+    /// Start `pattern` from its first step, unless it is already showing
+    static void setPattern(LedPattern pattern);
+    static LedPattern getPattern();
+
+    /// Fade to `level` and hold it for holdMs, then resume the pattern
+    static void preview(uint8_t level, uint32_t holdMs = kPreviewMs);
+
+    /// Pattern and driver ("led" on the console)
+    static void dump(Print& out);
+
+private:
+    static void timerCallback(void* arg);
+    static void applyStep(const LedStep& step);
+    static void kick();
+};
+
+#endif // ILITE_STATUS_LED_H
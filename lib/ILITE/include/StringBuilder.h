@@ -4,9 +4,24 @@
  * @file StringBuilder.h
  * @brief On-device keyboard + string input helper.
  *
- * Provides a reusable on-screen keyboard that captures textual input using
+ * Provides a reusable text entry screen that captures textual input using
  * the encoder/buttons. Framework features (menus, settings, terminal, modules)
  * can invoke it to edit strings without reimplementing UI logic.
+ *
+ * Input is a single character wheel instead of a grid keyboard:
+ * - The encoder spins the wheel, a press inserts the selected character,
+ *   BTN1 deletes, BTN2 toggles case and BTN3 submits. Joystick A X spins,
+ *   Y up accepts the completion, Y down deletes.
+ * - After each edit the wheel is rebuilt and the selection returns to its
+ *   front: first the accept-completion entry (">") when the text is the
+ *   prefix of a known string, then the next characters of matching
+ *   candidates, then letters by English frequency, digits and symbols.
+ * - Candidates are, in rank order, the last submitted strings, the caller's
+ *   `suggestions` (the terminal passes its command names) and a small
+ *   dictionary in flash (module IDs and names, SSID prefixes). Matching
+ *   ignores case.
+ * - The screen redraws only the title, text or wheel region that changed;
+ *   the canvas tile diff then sends just those tiles to the panel.
  */
 
 #include <Arduino.h>
@@ -18,6 +33,8 @@ struct StringBuilderConfig {
     const char* subtitle = nullptr;              ///< Optional subtitle (instructions)
     const char* initialValue = "";               ///< Initial text (can be nullptr)
     size_t maxLength = 32;                       ///< Max characters (excluding null terminator)
+    const char* const* suggestions = nullptr;    ///< Optional completion candidates (must outlive the session)
+    size_t suggestionCount = 0;                  ///< Entries in suggestions
     std::function<void(const char*)> onSubmit;   ///< Called when user presses OK/Enter
     std::function<void()> onCancel;              ///< Called when user cancels
 };
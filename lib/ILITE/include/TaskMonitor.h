@@ -0,0 +1,99 @@
+/**
+ * @file TaskMonitor.h
+ * @brief Per-task stack watermarks and per-core CPU load
+ *
+ * Framework tasks register themselves with watch() right after creation.
+ * Once per second sample() reads each task's stack high-water mark and,
+ * when FreeRTOS run-time stats are compiled in, the share of CPU time the
+ * task used since the last sample.
+ *
+ * Core load comes from an idle hook on each core. The hook counts idle loop
+ * iterations, and the highest count seen in one sample period is taken as
+ * "100% idle", so the estimate calibrates itself after the first quiet
+ * second. The hook keeps the core spinning only while the controller is
+ * active (PowerManager::isIdle()); while idle it lets the core wait for
+ * interrupts, and periods in which that happened keep the previous load.
+ *
+ * Stacks that drop below kLowStackPercent free, and cores that go above
+ * kHighLoadPercent, are reported in connection_log once per crossing.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TASK_MONITOR_H
+#define ILITE_TASK_MONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Latest sample of one watched task
+ */
+struct TaskSample {
+    TaskHandle_t handle = nullptr;
+    const char* name = "";
+    uint32_t stackSize = 0;        ///< Configured stack (bytes)
+    uint32_t stackFree = 0;        ///< Smallest free stack ever seen (bytes)
+    int8_t core = -1;              ///< Pinned core, -1 = any
+    uint8_t priority = 0;
+    int8_t cpuPercent = -1;        ///< Share of one core in the last period, -1 = unavailable
+    bool lowStackReported = false;
+};
+
+/**
+ * @class TaskMonitor
+ * @brief Static registry of watched tasks
+ */
+class TaskMonitor {
+public:
+    static constexpr size_t kMaxTasks = 12;
+    static constexpr size_t kCoreCount = 2;
+    static constexpr uint32_t kSampleIntervalMs = 1000;
+    static constexpr uint8_t kLowStackPercent = 15;
+    static constexpr uint8_t kHighLoadPercent = 90;
+
+    /// Install the idle hooks and register the monitor screen
+    static void begin();
+
+    /**
+     * @brief Watch a task
+     * @param handle Task handle
+     * @param stackSize Stack size passed to xTaskCreate (bytes)
+     * @param core Pinned core, or -1
+     * @return false if the table is full
+     */
+    static bool watch(TaskHandle_t handle, uint32_t stackSize, int8_t core);
+
+    /// Take a sample if kSampleIntervalMs has elapsed (call from the main loop)
+    static void update();
+
+    /// Take a sample now
+    static void sample();
+
+    static size_t getTaskCount() { return taskCount_; }
+    static const TaskSample* getTask(size_t index);
+
+    /// Estimated load of a core in the last period (0-100)
+    static uint8_t getCoreLoad(size_t core);
+
+    /// Print a table of all watched tasks
+    static void dump(Print& out);
+
+private:
+    static bool idleHook(size_t core);
+    static bool idleHook0();
+    static bool idleHook1();
+
+    static TaskSample tasks_[kMaxTasks];
+    static size_t taskCount_;
+    static volatile uint32_t idleCount_[kCoreCount];
+    static volatile bool idleSlept_[kCoreCount];   ///< Hook returned true this period
+    static uint32_t idleMax_[kCoreCount];
+    static uint8_t coreLoad_[kCoreCount];
+    static bool highLoadReported_[kCoreCount];
+    static uint32_t lastSampleMs_;
+};
+
+#endif // ILITE_TASK_MONITOR_H
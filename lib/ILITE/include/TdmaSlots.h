@@ -0,0 +1,103 @@
+/**
+ * @file TdmaSlots.h
+ * @brief Beacon-synchronized send slots for controllers sharing a channel
+ *
+ * At a competition several controllers send at the same control rate on one
+ * channel, each with its own timer phase. Their command frames drift into
+ * each other, collide and retry. With ILITEConfig::tdmaSlots, controllers
+ * at the same rate share one superframe (the control tick) cut into kSlots
+ * slots:
+ *
+ * - Every controller broadcasts MSG_SLOT_BEACON every kBeaconIntervalMs
+ *   from its own slot. The beacon carries its slot, its control period and
+ *   how far into the superframe it was sent.
+ * - The controller with the lowest MAC among those heard at the same
+ *   period is the master; the others take the superframe start from its
+ *   beacons. Nothing has to be configured, and when the master leaves,
+ *   the next-lowest MAC takes over.
+ * - After listening for kListenMs, a controller claims the lowest free
+ *   slot. If two claim the same slot, the one with the higher MAC moves.
+ * - CommTask measures how far the paired peer's tick is from its slot
+ *   start. Past kToleranceUs, it re-times the control timer so the next
+ *   tick lands in the slot.
+ *
+ * Controllers at another control rate are ignored. Team peers keep their
+ * spread across the tick, so only the paired peer's sends sit in the slot.
+ * The beacon's flight time is estimated at 1 Mbit/s; the rest of the TX
+ * delay is the same for everyone and is absorbed by the slot.
+ *
+ * Slot occupancy, the master and the phase error are shown on the
+ * "framework.slots" screen (Status menu) and by "slots" on the console.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TDMA_SLOTS_H
+#define ILITE_TDMA_SLOTS_H
+
+#include <Arduino.h>
+
+class EspNowDiscovery;
+
+/**
+ * @brief Slot state and counters
+ */
+struct TdmaSlotStats {
+    bool synced = false;            ///< Holding a slot on a known superframe
+    bool master = false;            ///< This controller sets the phase
+    uint8_t slot = 0xFF;            ///< 0xFF = not claimed
+    uint8_t occupied = 0;           ///< Bit per slot claimed by another controller
+    uint8_t nodes = 0;              ///< Controllers heard at this period
+    uint8_t masterMac[6] = {};
+    uint32_t periodUs = 0;
+    int32_t lastErrorUs = 0;        ///< Paired tick start minus slot start
+    uint32_t realigns = 0;          ///< Timer re-timed
+    uint32_t claims = 0;            ///< Slots claimed (first claim and moves)
+    uint32_t beaconsSent = 0;
+    uint32_t beaconsHeard = 0;
+    uint32_t otherPeriod = 0;       ///< Beacons at another control period
+};
+
+/**
+ * @class TdmaSlots
+ * @brief Static slot table, election and phase tracking
+ */
+class TdmaSlots {
+public:
+    static constexpr uint8_t kSlots = 8;
+    static constexpr uint8_t kNoSlot = 0xFF;
+    static constexpr size_t kMaxNodes = 8;
+    static constexpr uint32_t kBeaconIntervalMs = 500;
+    static constexpr uint32_t kNodeTimeoutMs = 2000;
+    static constexpr uint32_t kListenMs = 1500;
+    static constexpr int32_t kToleranceUs = 250;
+
+    /// Start or stop taking part (also registers the screen once)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// A beacon arrived (RxTask); rxUs is the receive stamp
+    static void onBeacon(const uint8_t* mac, uint32_t offsetUs, uint32_t info, uint32_t rxUs);
+
+    /**
+     * @brief Paired peer's tick (CommTask)
+     *
+     * Claims or moves the slot, sends the beacon when due and measures the
+     * tick against the slot start.
+     *
+     * @return Phase error in us (positive = late); 0 when not synced
+     */
+    static int32_t onTick(EspNowDiscovery& discovery, int64_t tickStartUs, uint32_t periodUs);
+
+    /// CommTask re-timed the control timer for the last error
+    static void onRealigned();
+
+    /// Beacon `reserved` field: slot in bits 0-7, period / 10 us in bits 16-31
+    static uint32_t packInfo(uint8_t slot, uint32_t periodUs);
+
+    static TdmaSlotStats getStats();
+    static void dump(Print& out);
+};
+
+#endif // ILITE_TDMA_SLOTS_H
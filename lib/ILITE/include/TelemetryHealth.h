@@ -0,0 +1,133 @@
+/**
+ * @file TelemetryHealth.h
+ * @brief Per-descriptor telemetry arrival rate, gaps and staleness
+ *
+ * Freshness used to be one timestamp per module (lastTelemetryTime_), so a
+ * module could not tell a stale arm state from a live status packet that
+ * kept the timestamp fresh. TelemetryHealth keeps one record per telemetry
+ * descriptor of the active module, updated by PacketRouter on RxTask:
+ *
+ * - **Arrival**: time of the last packet (micros) and the packet count.
+ * - **Rate**: running average (EWMA, 1/8) of the inter-arrival time;
+ *   getRateHz() reports its inverse, or 0 while the type is stale.
+ * - **Max gap**: the longest inter-arrival time since the last reset.
+ * - **Latency**: for descriptors with a robot timestamp, the running
+ *   average from sampling to arrival once ClockSync is synced.
+ * - **Staleness**: a type is stale once it has been silent for its
+ *   PacketDescriptor::staleAfterMs, or for kStaleIntervals average
+ *   intervals (at least kMinStaleMs) when that is 0. Reply packets set
+ *   PacketDescriptor::kNeverStale and are only counted.
+ *
+ * When the module asks the robot for a different rate (RateRequest.h),
+ * onRateRequested() drops the measured interval: the next packets measure
+ * the new one, and until then the stale limit follows the requested
+ * interval instead of the old rate, so a type slowed from 20 to 2 Hz does
+ * not flap stale.
+ *
+ * service() runs on ServiceTask with the pairing job. When a type that has
+ * been received goes stale or recovers, it calls
+ * ILITEModule::onTelemetryStale() and the framework plays the error cue, so
+ * modules can fall back to a failsafe display per packet type.
+ *
+ * "telemetry" on the console lists the rates and gaps, which is what the
+ * robot's telemetry rates can be trimmed to.
+ *
+ * ## Thread Safety:
+ * record() runs on RxTask only, service() on ServiceTask only,
+ * onRateRequested() on CommTask only (atomics hand it over). The getters
+ * read without locking from any task; a value may be one packet stale.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TELEMETRY_HEALTH_H
+#define ILITE_TELEMETRY_HEALTH_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class ILITEModule;
+
+/**
+ * @brief Arrival statistics of one telemetry packet type
+ */
+struct TelemetryRate {
+    uint32_t magic;
+    uint32_t packets;
+    uint32_t lastUs;            ///< Arrival time of the last packet (micros)
+    uint32_t intervalAvgUs;     ///< Running average inter-arrival time
+    uint32_t maxGapUs;          ///< Longest inter-arrival time since reset
+    uint32_t latencyAvgUs;      ///< Running average sampling-to-arrival time (0 if unknown)
+    uint32_t staleCount;        ///< Fresh -> stale transitions seen by service()
+    bool stale;                 ///< State reported by the last service()
+};
+
+/**
+ * @class TelemetryHealth
+ * @brief Static per-type telemetry rate and staleness tracking
+ */
+class TelemetryHealth {
+public:
+    static constexpr size_t kMaxTypes = 8;              ///< TelemetryStore::kMaxSlots
+    static constexpr uint32_t kStaleIntervals = 4;      ///< Default: silent for this many intervals
+    static constexpr uint32_t kMinStaleMs = 100;
+    static constexpr uint32_t kUnknownRateStaleMs = 1000; ///< Default before an interval is known
+
+    /**
+     * @brief Account one validated telemetry packet (RxTask)
+     * @param typeIndex Descriptor index in the active module
+     * @param timestampUs micros() when the frame arrived
+     * @param sampleUs When the data was sampled, on the same clock
+     *        (timestampUs if the packet carries no robot timestamp)
+     * @return Interval to the previous packet of the type (0 for the first)
+     */
+    static uint32_t record(size_t typeIndex, uint32_t magic, uint32_t timestampUs, uint32_t sampleUs);
+
+    /// Clear all records (module change)
+    static void reset();
+
+    /**
+     * @brief The rate asked of the robot for a type was sent (CommTask)
+     *
+     * If the interval differs from the previous request, the next packet
+     * restarts the interval average; until it is measured again the stale
+     * limit is derived from `intervalMs`.
+     *
+     * @param intervalMs Requested interval, 0 = robot's default
+     */
+    static void onRateRequested(size_t typeIndex, uint16_t intervalMs);
+
+    /**
+     * @brief Report stale/fresh transitions of the module's types (ServiceTask)
+     * @return Types that went stale since the previous call
+     */
+    static size_t service(ILITEModule* module, uint32_t nowUs);
+
+    /// Record of one type (nullptr if out of range)
+    static const TelemetryRate* get(size_t typeIndex);
+
+    /// Milliseconds since the last packet of the type (UINT32_MAX if none yet)
+    static uint32_t getAgeMs(size_t typeIndex);
+
+    /// Average arrival rate, 0 if fewer than two packets or stale at the last service()
+    static float getRateHz(size_t typeIndex);
+
+    /// Silence after which the type counts as stale
+    static uint32_t getStaleAfterMs(size_t typeIndex, uint16_t staleAfterMs);
+
+    /**
+     * @brief Whether the type is stale now (never received counts as stale)
+     * @param staleAfterMs The descriptor's limit (0 = from the average interval)
+     */
+    static bool isStale(size_t typeIndex, uint16_t staleAfterMs = 0);
+
+    static void dump(Print& out);
+
+private:
+    static TelemetryRate rates_[kMaxTypes];
+    static std::atomic<uint16_t> requestedMs_[kMaxTypes];  ///< Last requested interval
+    static std::atomic<bool> rebase_[kMaxTypes];           ///< Rate changed: restart the average
+};
+
+#endif // ILITE_TELEMETRY_HEALTH_H
@@ -0,0 +1,205 @@
+/**
+ * @file TelemetryStore.h
+ * @brief Framework-owned telemetry slots with consistent, lock-free snapshots
+ *
+ * PacketRouter publishes every validated telemetry packet into the slot for
+ * its descriptor index before calling the module's handleTelemetry(). Modules
+ * and drawDashboard() then read typed snapshots through TelemetryView<T>
+ * instead of memcpy'ing into their own globals.
+ *
+ * Each slot is a seqlock: the writer (RxTask, core 0) bumps the sequence to
+ * odd, copies, then bumps it to even. Readers (DisplayTask, CommTask) retry
+ * if the sequence was odd or changed while they copied, so a snapshot is
+ * never torn across two packets.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * void drawDashboard(DisplayCanvas& canvas) override {
+ *     DroneTelemetry t = TelemetryView<DroneTelemetry>(0).get();
+ *     canvas.drawTextF(0, 20, "Roll: %.1f", t.roll);
+ * }
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TELEMETRY_STORE_H
+#define ILITE_TELEMETRY_STORE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+
+/**
+ * @class TelemetrySlot
+ * @brief Seqlock-protected copy of the latest packet of one telemetry type
+ */
+class TelemetrySlot {
+public:
+    static constexpr size_t kMaxSize = 250;  ///< ESP-NOW maximum payload
+
+    /**
+     * @brief Store a packet (single writer only)
+     */
+    void publish(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Copy up to maxLength bytes of the latest packet
+     *
+     * @param out Destination buffer
+     * @param maxLength Destination size
+     * @param sequenceOut Optional: sequence number of the copied packet
+     * @return Bytes copied (0 if nothing received yet)
+     */
+    size_t read(void* out, size_t maxLength, uint32_t* sequenceOut = nullptr) const;
+
+    /**
+     * @brief Run fn(data, length) on the latest packet in place, without copying
+     *
+     * fn must only read the bytes and copy out what it needs: it may run
+     * more than once, and a pass that overlapped a publish is discarded and
+     * repeated.
+     *
+     * @return false if nothing was received yet or no pass was consistent
+     */
+    template<typename Fn>
+    bool inspect(Fn&& fn, uint32_t* sequenceOut = nullptr) const {
+        for (int attempt = 0; attempt < 32; ++attempt) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            if (before & 1u) {
+                taskYIELD();
+                continue;
+            }
+
+            fn(static_cast<const uint8_t*>(data_), static_cast<size_t>(length_));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                if (sequenceOut != nullptr) {
+                    *sequenceOut = before;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Clear the slot (call only while no writer is active)
+     */
+    void reset();
+
+    /// Seqlock counter: odd while a write is in progress, +2 per packet
+    uint32_t getSequence() const { return sequence_.load(std::memory_order_acquire); }
+
+    /// True once at least one packet has been published
+    bool hasData() const { return getSequence() != 0; }
+
+    /// millis() of the last publish
+    uint32_t getUpdatedMs() const { return updatedMs_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> sequence_{0};
+    std::atomic<uint32_t> updatedMs_{0};
+    uint16_t length_ = 0;
+    uint8_t data_[kMaxSize] = {};
+};
+
+/**
+ * @class TelemetryStore
+ * @brief One TelemetrySlot per telemetry descriptor of the active module
+ */
+class TelemetryStore {
+public:
+    static constexpr size_t kMaxSlots = 8;
+
+    static TelemetryStore& getInstance();
+
+    /**
+     * @brief Publish a validated packet for descriptor `typeIndex`
+     */
+    void publish(size_t typeIndex, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Slot for descriptor `typeIndex` (nullptr if out of range)
+     */
+    const TelemetrySlot* getSlot(size_t typeIndex) const;
+
+    /**
+     * @brief Clear all slots (called by PacketRouter on module change)
+     */
+    void reset();
+
+    /**
+     * @brief Trade the slots for the second bank's
+     *
+     * PacketRouter keeps the last packets of the module in standby there
+     * (see ILITEConfig::moduleStandby). Same rules as reset().
+     */
+    void swapBanks();
+
+private:
+    TelemetryStore() = default;
+    TelemetryStore(const TelemetryStore&) = delete;
+    TelemetryStore& operator=(const TelemetryStore&) = delete;
+
+    TelemetrySlot slots_[2][kMaxSlots];
+    uint8_t bank_ = 0;
+};
+
+/**
+ * @class TelemetryView
+ * @brief Typed, consistent read access to a telemetry slot
+ *
+ * @tparam T Packed packet struct matching the descriptor's layout
+ */
+template<typename T>
+class TelemetryView {
+public:
+    static_assert(sizeof(T) <= TelemetrySlot::kMaxSize, "Telemetry type larger than ESP-NOW payload");
+
+    explicit TelemetryView(size_t typeIndex)
+        : slot_(TelemetryStore::getInstance().getSlot(typeIndex)) {}
+
+    /**
+     * @brief Copy a consistent snapshot into `out`
+     * @return false if no complete packet of this type has arrived yet
+     */
+    bool read(T& out) const {
+        if (slot_ == nullptr) {
+            return false;
+        }
+        return slot_->read(&out, sizeof(T)) == sizeof(T);
+    }
+
+    /**
+     * @brief Snapshot by value (zero-initialized if nothing received)
+     */
+    T get() const {
+        T value{};
+        if (!read(value)) {
+            memset(&value, 0, sizeof(T));
+        }
+        return value;
+    }
+
+    /// True once a packet of this type has arrived
+    bool hasData() const { return slot_ != nullptr && slot_->hasData(); }
+
+    /// Milliseconds since the last packet (UINT32_MAX if none)
+    uint32_t getAgeMs() const {
+        return hasData() ? millis() - slot_->getUpdatedMs() : UINT32_MAX;
+    }
+
+    /// Changes whenever a new packet arrives (for cheap change detection)
+    uint32_t getSequence() const { return slot_ != nullptr ? slot_->getSequence() : 0; }
+
+private:
+    const TelemetrySlot* slot_;
+};
+
+#endif // ILITE_TELEMETRY_STORE_H
@@ -0,0 +1,149 @@
+/**
+ * @file TelemetryTap.h
+ * @brief Binary serial mirror of every telemetry packet and command packet
+ *
+ * Text logging over Serial tops out at a few hundred short lines per second
+ * at 115200 baud. For bench tuning, TelemetryTap mirrors every packet the
+ * router accepts (RX) and every command packet the comm task sends (TX) to
+ * the serial port as compact binary frames, with microsecond timestamps.
+ *
+ * Producers (RxTask, CommTask) only copy the packet into a lock-free queue;
+ * a low-priority drainer task encodes and writes the frames, so a slow or
+ * disconnected PC never blocks the comm task. A full queue drops records
+ * and the drainer reports how many were lost.
+ *
+ * ## Wire Format
+ * Every frame is COBS-encoded and ends with a 0x00 delimiter, so a decoder
+ * resynchronizes on the next zero byte (console text on the same port is
+ * discarded by the CRC check):
+ * ```
+ * frame   = COBS(kind:u8 timeUs:u32 body  crc:u16) 0x00
+ * crc     = CRC-16/CCITT-FALSE over kind..body, little-endian like all fields
+ *
+ * kind 0x01 RX packet      typeIndex:u8  bytes...
+ * kind 0x02 TX packet      typeIndex:u8  bytes...
+ * kind 0x03 input          version:u8 snapshot   (InputReplay::encodeSnapshot)
+ * kind 0x04 display        flags:u8 sequence:u16 tileWidth:u8 pageCount:u8
+ *                          {page:u8 length:u8 delta}*   (ScreenCapture)
+ * kind 0x10 module         name...            (decoder drops its tables)
+ * kind 0x11 descriptor     dir:u8 typeIndex:u8 magic:u32 minSize:u16
+ *                          maxSize:u16 nameLen:u8 name fieldCount:u8
+ *                          {offset:u8 size:u8 type:u8 nameLen:u8 name}*
+ * kind 0x12 dropped        count:u32          (records lost since last report)
+ * kind 0x13 end            (host to controller: end of a replay stream)
+ * ```
+ * `dir` is 0x01 for telemetry and 0x02 for commands, `type` is a
+ * PacketDescriptor::Field::Type. Descriptors are sent for the active module
+ * whenever it changes and when the tap is enabled, so a decoder can name
+ * and format every field of the packets that follow.
+ *
+ * Display frames are sent only while "screen on" streams them. flags bit 0
+ * (keyframe) clears the picture before the chunk is applied, bit 1 marks
+ * the last chunk of a frame; the delta coding is described in
+ * ScreenCapture.h.
+ *
+ * TX packets are recorded before redundancy, bundling and stamps are
+ * applied, so each record is exactly what prepareCommandPacket() produced.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * ILITEConfig config;
+ * config.telemetryTap = true;
+ * config.telemetryTapBaud = 2000000;   // Reconfigures Serial
+ * ILITE.begin(config);
+ * ```
+ * The serial console toggles it with "tap on" / "tap off"; "tap" prints
+ * the counters.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TELEMETRY_TAP_H
+#define ILITE_TELEMETRY_TAP_H
+
+#include <Arduino.h>
+#include <atomic>
+
+class ILITEModule;
+
+/**
+ * @class TelemetryTap
+ * @brief Static packet mirror with a queue and a drainer task
+ */
+class TelemetryTap {
+public:
+    static constexpr size_t kQueueSize = 16;            ///< Pending records
+    static constexpr size_t kMaxPayload = 250;          ///< ESP-NOW maximum
+
+    enum FrameKind : uint8_t {
+        FRAME_RX = 0x01,
+        FRAME_TX = 0x02,
+        FRAME_INPUT = 0x03,
+        FRAME_DISPLAY = 0x04,
+        FRAME_MODULE = 0x10,
+        FRAME_DESCRIPTOR = 0x11,
+        FRAME_DROPPED = 0x12,
+        FRAME_END = 0x13
+    };
+
+    /**
+     * @brief Allocate the queue and start the drainer task
+     * @param out Port the frames are written to (normally Serial)
+     * @param baud New baud rate of `out` if it is Serial, 0 keeps it
+     * @return true if the drainer runs; recording starts disabled
+     */
+    static bool begin(HardwareSerial& out, uint32_t baud);
+
+    /// Start or stop mirroring; enabling resends the module descriptors
+    static void setEnabled(bool enabled);
+
+    /// True while packets are mirrored
+    static inline bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// A telemetry packet was accepted by PacketRouter (RxTask)
+    static inline void onTelemetry(uint8_t typeIndex, const uint8_t* data, size_t length,
+                                   uint32_t timestampUs) {
+        if (isEnabled()) {
+            record(FRAME_RX, typeIndex, data, length, timestampUs);
+        }
+    }
+
+    /// A command packet is about to be sent (CommTask)
+    static inline void onCommand(uint8_t typeIndex, const uint8_t* data, size_t length,
+                                 uint32_t timestampUs) {
+        if (isEnabled()) {
+            record(FRAME_TX, typeIndex, data, length, timestampUs);
+        }
+    }
+
+    /// An encoded InputSnapshot was captured (CommTask)
+    static inline void onInput(uint8_t version, const uint8_t* data, size_t length,
+                               uint32_t timestampUs) {
+        if (isEnabled()) {
+            record(FRAME_INPUT, version, data, length, timestampUs);
+        }
+    }
+
+    /// A chunk of an encoded display frame (display task); false if the queue was full
+    static inline bool onDisplay(uint8_t flags, const uint8_t* data, size_t length,
+                                 uint32_t timestampUs) {
+        return isEnabled() && record(FRAME_DISPLAY, flags, data, length, timestampUs);
+    }
+
+    /// Queue the module frame and every packet descriptor of `module`
+    static void describeModule(ILITEModule* module);
+
+    /// Print record, drop and byte counters
+    static void dump(Print& out);
+
+private:
+    static bool record(uint8_t kind, uint8_t typeIndex, const uint8_t* data, size_t length,
+                       uint32_t timestampUs);
+
+    static std::atomic<bool> enabled_;
+};
+
+#endif // ILITE_TELEMETRY_TAP_H
@@ -0,0 +1,122 @@
+/**
+ * @file TextCache.h
+ * @brief Pre-rasterized label cache and text-width cache for DisplayCanvas
+ *
+ * Headers, footers and menu labels are redrawn with identical text every
+ * frame, and every draw decodes the U8G2 font again. TextCache keeps small
+ * bitmaps of recently drawn labels keyed by (font, string hash), and copies
+ * them straight into the framebuffer on later frames. Text widths used for
+ * centering are cached the same way.
+ *
+ * A label is only rasterized the second time it is seen, so text that
+ * changes every frame (counters, timers) is not cached. Labels taller than
+ * kMaxHeight or wider than kMaxColumns, XOR drawing, and labels that are
+ * clipped by the screen edge always go through U8G2 directly.
+ *
+ * Each cached label stores a foreground mask and a background mask, because
+ * U8G2's default solid font mode also clears the glyph background. Replaying
+ * both masks gives exactly the pixels U8G2 would have drawn.
+ *
+ * @note Keys use the DisplayCanvas font. Text drawn after changing the font
+ *       directly on the U8G2 instance must not go through the cache.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TEXT_CACHE_H
+#define ILITE_TEXT_CACHE_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+/**
+ * @class TextCache
+ * @brief Fixed-size label bitmap cache (LRU) plus direct-mapped width cache
+ */
+class TextCache {
+public:
+    static constexpr size_t kLabelSlots = 16;   ///< Cached label bitmaps
+    static constexpr size_t kWidthSlots = 32;   ///< Cached text widths
+    static constexpr size_t kSeenSlots = 16;    ///< Admission filter history
+    static constexpr uint8_t kMaxColumns = 64;  ///< Widest cacheable label (px)
+    static constexpr uint8_t kMaxHeight = 16;   ///< Tallest cacheable label (px)
+
+    explicit TextCache(U8G2& u8g2);
+
+    /// Enable or disable the cache (disabling also drops all entries)
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+
+    /// Drop every cached label and width
+    void clear();
+
+    /// Advance the LRU clock (DisplayCanvas calls this once per flush)
+    void beginFrame() { frame_++; }
+
+    /**
+     * @brief Cached U8G2 UTF-8 width of `text` in `font`
+     *
+     * The U8G2 font must already be set to `font`.
+     */
+    int16_t getWidth(uint8_t font, const char* text);
+
+    /**
+     * @brief Draw `text` from the cache, rasterizing it if admitted
+     *
+     * The U8G2 font must already be set to `font`.
+     *
+     * @return false if the caller must draw the text itself
+     */
+    bool drawText(uint8_t font, int16_t x, int16_t y, const char* text);
+
+    /// Label draws served from cached bitmaps
+    uint32_t getHitCount() const { return hits_; }
+
+    /// Label draws that went through U8G2
+    uint32_t getMissCount() const { return misses_; }
+
+private:
+    struct Label {
+        uint32_t hash;
+        uint32_t lastUsed;          ///< frame_ at last use (0 = empty)
+        uint8_t font;
+        uint8_t width;
+        uint8_t height;
+        int8_t ascent;
+        uint16_t fg[kMaxColumns];   ///< Pixels drawn in the draw color (bit 0 = top row)
+        uint16_t bg[kMaxColumns];   ///< Pixels drawn in the opposite color
+    };
+
+    struct Width {
+        uint32_t hash;
+        int16_t width;
+        bool valid;
+    };
+
+    static uint32_t hashText(uint8_t font, const char* text);
+
+    Label* findLabel(uint32_t hash, uint8_t font);
+    bool admit(uint32_t hash);
+    bool rasterize(Label& label, uint32_t hash, uint8_t font,
+                   int16_t x, int16_t y, const char* text);
+    void blit(const Label& label, int16_t x, int16_t top, uint8_t color);
+
+    // Framebuffer column access (page-major, bit 0 = top pixel of a page)
+    int16_t bandTop() const;
+    int16_t bandBottom() const;
+    uint16_t readColumn(int16_t x, int16_t top, uint8_t height) const;
+    void writeColumn(int16_t x, int16_t top, uint8_t height, uint16_t bits);
+
+    U8G2& u8g2_;
+    bool enabled_;
+    uint32_t frame_;
+    uint32_t hits_;
+    uint32_t misses_;
+    Label labels_[kLabelSlots];
+    Width widths_[kWidthSlots];
+    uint32_t seen_[kSeenSlots];
+    uint8_t seenNext_;
+};
+
+#endif // ILITE_TEXT_CACHE_H
@@ -0,0 +1,200 @@
+/**
+ * @file TrainerLink.h
+ * @brief Trainer ("buddy box") mode: a second controller drives, the first can take over
+ *
+ * The robot stays paired with the instructor's controller. A second ILITE
+ * controller, the trainee's, sends each InputSnapshot it captures to the
+ * instructor over the active Transport, one frame per control tick:
+ *
+ *     [TRAINER_MAGIC:4][sequence:4][captureUs:4][format:1][InputReplay snapshot]
+ *
+ * On the instructor's CommTask the trainee's snapshot is merged into the
+ * live one before the module's updateControl() sees it:
+ *
+ * | Mode     | Sticks and potentiometer   | Buttons               | Encoder    |
+ * |----------|----------------------------|-----------------------|------------|
+ * | Override | Trainee                    | Trainee               | Instructor |
+ * | Mix      | Sum of both, clamped       | Either                | Instructor |
+ *
+ * While the instructor holds the takeover button (BUTTON_3 by default) the
+ * module sees the instructor's own input only. The takeover button itself
+ * never reaches the module.
+ *
+ * - **Timing**: the two clocks are not synced. The instructor keeps the
+ *   lowest (arrival - capture) seen as the offset between them (creeping up
+ *   1 us per frame to follow crystal drift), so a frame's age is how much
+ *   later than the fastest frame it is used.
+ * - **Jitter buffer**: a frame is held until it is `delayTicks` control
+ *   ticks old (0-kMaxDelayTicks, default 1), so frames that arrive unevenly
+ *   are still used one per tick. Each tick takes the newest frame that is
+ *   old enough. A frame older than delayTicks + 1 ticks is late and is
+ *   never used: the added latency is bounded by construction.
+ * - **Gaps**: without a fresh frame the previous one is repeated for up to
+ *   kMaxRepeatTicks ticks, then the trainee's input is neutral (sticks
+ *   centered, no buttons). After kLostMs without a frame the instructor's
+ *   input is used alone until frames arrive again.
+ * - **Statistics**: age of every frame used (min/avg/max, histogram),
+ *   repeats, neutral ticks, late, out-of-order and overflowed frames;
+ *   "trainer" on the console prints them.
+ *
+ * The age does not include the radio time itself, which is the same for
+ * every frame (about 0.4 ms for a 60-byte ESP-NOW frame at 1 Mbit/s).
+ * The trainee's controller should stay unpaired.
+ *
+ * ## Usage Example:
+ * ```
+ * trainee>    trainer trainee 24:6F:28:AA:BB:CC      (instructor's MAC)
+ * instructor> trainer instructor 24:6F:28:11:22:33   (trainee's MAC)
+ * instructor> trainer mode mix
+ * instructor> trainer delay 2
+ * ```
+ *
+ * ## Thread Safety:
+ * onFrame() runs on RxTask, onInput() and merge() on CommTask; the buffer
+ * is shared under a spinlock. start(), stop() and the settings are for
+ * ServiceTask (console).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TRAINER_LINK_H
+#define ILITE_TRAINER_LINK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "InputManager.h"
+
+/// Magic of a trainee input frame ('TRNR')
+constexpr uint32_t TRAINER_PACKET_MAGIC = 0x54524E52;
+
+static constexpr size_t kTrainerLatencyBuckets = 8;
+
+/// Which end of a trainer link this controller is
+enum class TrainerRole : uint8_t {
+    Off,
+    Trainee,        ///< Sends its inputs
+    Instructor      ///< Merges the trainee's inputs into its own
+};
+
+/// How the instructor merges the trainee's input
+enum class TrainerMix : uint8_t {
+    Override,       ///< Trainee drives alone
+    Mix             ///< Sticks summed, buttons of either
+};
+
+#pragma pack(push, 1)
+/// Header of a trainee input frame
+struct TrainerFrameHeader {
+    uint32_t magic;
+    uint32_t sequence;      ///< Trainee capture counter
+    uint32_t captureUs;     ///< Trainee esp_timer (low 32 bits) at capture
+    uint8_t format;         ///< InputReplay::kFormatVersion
+};
+#pragma pack(pop)
+
+/**
+ * @brief Trainer link counters (reset by start() and reset())
+ */
+struct TrainerStats {
+    // Trainee
+    uint32_t framesSent = 0;
+    uint32_t sendFailures = 0;
+    // Instructor, RxTask
+    uint32_t framesReceived = 0;
+    uint32_t badFrames = 0;         ///< Wrong size or format
+    uint32_t outOfOrder = 0;        ///< Not newer than a frame already received
+    uint32_t overflows = 0;         ///< Unused frames pushed out of a full buffer
+    // Instructor, CommTask
+    uint32_t ticks = 0;             ///< Ticks merged while the link was up
+    uint32_t used = 0;              ///< Ticks on a fresh frame
+    uint32_t repeats = 0;           ///< Ticks on the previous frame
+    uint32_t neutral = 0;           ///< Ticks with the trainee centered
+    uint32_t late = 0;              ///< Frames too old to use
+    uint32_t takeover = 0;          ///< Ticks with the takeover button held
+    uint32_t lost = 0;              ///< Times the link went quiet for kLostMs
+    uint32_t minUs = 0;             ///< Age of the frames used
+    uint32_t maxUs = 0;
+    uint32_t avgUs = 0;             ///< Moving average (1/16 weight)
+    uint32_t histogram[kTrainerLatencyBuckets] = {};
+};
+
+/**
+ * @class TrainerLink
+ * @brief Static trainer link of this controller
+ */
+class TrainerLink {
+public:
+    static constexpr size_t kBufferFrames = 4;
+    static constexpr uint8_t kMaxDelayTicks = 2;
+    static constexpr uint8_t kMaxRepeatTicks = 2;
+    static constexpr uint32_t kLostMs = 200;
+
+    /// Upper bound (us) of each age bucket; the last is open-ended
+    static const uint32_t kBucketUs[kTrainerLatencyBuckets];
+
+    /**
+     * @brief Start a link with the other controller
+     *
+     * Registers `mac` with discovery (ESP-NOW peer, foreign filter) and
+     * clears the statistics.
+     *
+     * @return false if the peer could not be added
+     */
+    static bool start(TrainerRole role, const uint8_t* mac);
+    static void stop();
+
+    static TrainerRole getRole() { return role_.load(std::memory_order_acquire); }
+    static bool isActive() { return getRole() != TrainerRole::Off; }
+
+    static void setMix(TrainerMix mix) { mix_.store(mix, std::memory_order_relaxed); }
+    static TrainerMix getMix() { return mix_.load(std::memory_order_relaxed); }
+
+    /// Jitter buffer depth in control ticks (clamped to kMaxDelayTicks)
+    static void setDelayTicks(uint8_t ticks);
+    static uint8_t getDelayTicks() { return delayTicks_.load(std::memory_order_relaxed); }
+
+    /// InputSnapshot::Button bit the instructor holds to take over
+    static void setTakeoverButton(uint8_t mask) { takeoverMask_.store(mask, std::memory_order_relaxed); }
+
+    /// Instructor: merging the trainee right now (link up, no takeover)
+    static bool isTraineeDriving() { return traineeDriving_.load(std::memory_order_relaxed); }
+
+    // ========================================================================
+    // RxTask
+    // ========================================================================
+
+    /**
+     * @brief Consume a trainee input frame (any other frame returns false)
+     */
+    static bool onFrame(const uint8_t* mac, const uint8_t* data, size_t length, uint32_t rxUs);
+
+    // ========================================================================
+    // CommTask
+    // ========================================================================
+
+    /// Trainee: send this tick's snapshot
+    static void onInput(const InputSnapshot& snapshot, uint32_t captureUs);
+
+    /**
+     * @brief Instructor: merge the trainee's input into `live`
+     *
+     * @param nowUs esp_timer (low 32 bits) of this tick's capture
+     * @param tickUs Control tick period
+     * @return true if `live` changed and has to be published
+     */
+    static bool merge(InputSnapshot& live, uint32_t nowUs, uint32_t tickUs);
+
+    static TrainerStats getStats();
+    static void reset();
+    static void dump(Print& out);
+
+private:
+    static std::atomic<TrainerRole> role_;
+    static std::atomic<TrainerMix> mix_;
+    static std::atomic<uint8_t> delayTicks_;
+    static std::atomic<uint8_t> takeoverMask_;
+    static std::atomic<bool> traineeDriving_;
+};
+
+#endif // ILITE_TRAINER_LINK_H
@@ -0,0 +1,105 @@
+/**
+ * @file Transport.h
+ * @brief Link layer under PacketRouter: ESP-NOW by default, or a wired UART/RS485 bus
+ *
+ * Everything above the link (discovery, TxWindow, group commands, bundles,
+ * PacketRouter and the modules) deals in "a frame of up to 250 bytes to or
+ * from a 6-byte address". Transport is that boundary:
+ *
+ * - send() hands one frame to the link and reports errors with the ESP-NOW
+ *   codes the callers already handle (ESP_ERR_ESPNOW_NO_MEM = busy, retry).
+ * - Completions are reported through the sent callback registered with
+ *   setSentCallback(), with the signature of the ESP-NOW send callback.
+ * - Received frames go into the RxRing registered with setReceiver(), and
+ *   the receiver is woken; the ring's consumer does not care which link
+ *   filled it.
+ *
+ * Exactly one transport is active. Only the active transport may produce
+ * into the ring, which keeps it single-producer: the ESP-NOW receive
+ * callback drops frames while another transport is active.
+ *
+ * ESP-NOW itself stays initialised under a wired transport, since discovery
+ * still registers peers with it; nothing is sent over the air.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TRANSPORT_H
+#define ILITE_TRANSPORT_H
+
+#include <Arduino.h>
+#include <esp_now.h>
+
+class RxRing;
+
+/**
+ * @class Transport
+ * @brief One link layer; the static side selects the active one
+ */
+class Transport {
+public:
+    using SentCallback = void (*)(const uint8_t* mac, esp_now_send_status_t status);
+    using NotifyCallback = void (*)();
+
+    virtual ~Transport() = default;
+
+    virtual const char* getName() const = 0;
+
+    /**
+     * @brief Bring the link up (called by setActive())
+     */
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Send one frame to `mac` (any task)
+     * @return ESP_OK, ESP_ERR_ESPNOW_NO_MEM when the link is busy, or another error
+     */
+    virtual esp_err_t send(const uint8_t* mac, const uint8_t* data, size_t length) = 0;
+
+    /// True for the ESP-NOW transport (its receive callback checks this)
+    virtual bool isEspNow() const { return false; }
+
+    virtual void dump(Print& out) const;
+
+    // ------------------------------------------------------------------------
+    // Active transport
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Make `transport` the active link; ESP-NOW until this is called
+     * @return false if its begin() failed (the previous transport stays active)
+     */
+    static bool setActive(Transport& transport);
+    static Transport& getActive() { return *active_; }
+
+    static void setSentCallback(SentCallback callback) { sentCallback_ = callback; }
+    static void setReceiver(RxRing* ring, NotifyCallback notify);
+
+protected:
+    /// Report a completion to the registered sent callback
+    static void reportSent(const uint8_t* mac, bool success);
+
+    static RxRing* receiveRing_;
+    static NotifyCallback receiveNotify_;
+
+private:
+    static Transport* active_;
+    static SentCallback sentCallback_;
+};
+
+/**
+ * @class EspNowTransport
+ * @brief esp_now_send(); completions come from the ESP-NOW send callback
+ */
+class EspNowTransport : public Transport {
+public:
+    static EspNowTransport& instance();
+
+    const char* getName() const override { return "ESP-NOW"; }
+    bool begin() override { return true; }      // esp_now_init() runs in initHardware()
+    esp_err_t send(const uint8_t* mac, const uint8_t* data, size_t length) override;
+    bool isEspNow() const override { return true; }
+};
+
+#endif // ILITE_TRANSPORT_H
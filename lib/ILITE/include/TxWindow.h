@@ -0,0 +1,134 @@
+/**
+ * @file TxWindow.h
+ * @brief Bounded in-flight window for command frames, with coalescing
+ *
+ * esp_now_send() only queues a frame; the driver reports completion later
+ * through the send callback. CommTask used to fire frames without looking
+ * at either, so a full driver queue made sends fail silently (or block),
+ * and an old drive command could still be waiting when a newer one was
+ * ready.
+ *
+ * TxWindow counts command frames between esp_now_send() and their send
+ * callback and keeps at most `maxInFlight` of them outstanding. A frame
+ * that cannot go out yet is held, keyed by destination and command type:
+ *
+ * - A newer frame with the same key replaces the held one (coalesced), so
+ *   the newest control input always goes out first and nothing queues
+ *   behind a stale command.
+ * - Held frames go out from pump() as the window opens, oldest first, and
+ *   are dropped once older than the age limit.
+ * - Frames submitted with kTxNoCoalesce (bundles, whose contents differ
+ *   from tick to tick) are held but never replaced.
+ * - ESP_ERR_ESPNOW_NO_MEM holds the frame for a retry instead of losing it.
+ *
+ * The send callback only reports a MAC, so a completion for another frame
+ * to the same peer (a keepalive, say) may close a window slot early; slots
+ * whose callback never arrives are released after kCallbackTimeoutUs.
+ *
+ * Frames go out through the active Transport; a wired one reports its
+ * completion from inside send(), so the window slot is claimed first.
+ *
+ * submit() and pump() are CommTask only; onSendComplete() runs on the WiFi
+ * task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_TX_WINDOW_H
+#define ILITE_TX_WINDOW_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+/// Key of frames that may be held but never replaced by a newer one
+constexpr uint8_t kTxNoCoalesce = 0xFF;
+
+/**
+ * @brief Counters of the TX window
+ */
+struct TxWindowStats {
+    uint32_t sent = 0;              ///< Frames handed to the driver
+    uint32_t held = 0;              ///< Frames that had to wait for the window
+    uint32_t coalesced = 0;         ///< Held frames replaced by a newer one
+    uint32_t dropped = 0;           ///< Held frames dropped as stale (or evicted)
+    uint32_t driverFull = 0;        ///< esp_now_send() returned ESP_ERR_ESPNOW_NO_MEM
+    uint32_t failures = 0;          ///< Other esp_now_send() errors
+    uint32_t timeouts = 0;          ///< Window slots released without a callback
+    uint8_t inFlight = 0;           ///< Frames awaiting their callback
+    uint8_t maxInFlight = 0;        ///< Window size
+};
+
+/**
+ * @class TxWindow
+ * @brief Static in-flight window for command frames
+ */
+class TxWindow {
+public:
+    static constexpr size_t kMaxWindow = 4;             ///< Largest allowed window
+    static constexpr size_t kHeldSlots = 8;             ///< Frames held at once
+    static constexpr uint32_t kCallbackTimeoutUs = 20000;
+
+    /**
+     * @brief Set the window size (0 disables the window; frames go out at once)
+     */
+    static void begin(uint8_t maxInFlight);
+
+    /**
+     * @brief Send a frame now, or hold it until the window opens
+     *
+     * @param key Command type; a held frame with the same peer and key is replaced
+     * @return false if the frame was rejected by the driver
+     */
+    static bool submit(const uint8_t* mac, uint8_t key, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Send held frames while the window allows; drop stale ones
+     * @param maxAgeUs Held frames older than this are dropped
+     */
+    static void pump(uint32_t maxAgeUs);
+
+    /**
+     * @brief Send callback hook (WiFi task)
+     */
+    static void onSendComplete(const uint8_t* mac);
+
+    static TxWindowStats getStats();
+    static void reset();
+    static void dump(Print& out);
+
+private:
+    struct InFlight {
+        uint8_t mac[6];
+        uint32_t sentUs;
+        bool used;
+    };
+
+    struct Held {
+        uint8_t mac[6];
+        uint8_t key;
+        uint8_t length;
+        uint32_t heldUs;
+        bool used;
+        uint8_t data[250];
+    };
+
+    /// Release slots whose callback is overdue (CommTask, lock held)
+    static void expireLocked(uint32_t nowUs);
+
+    /// True if a window slot is free (takes the lock)
+    static bool hasRoom(uint32_t nowUs);
+
+    /// Hand a frame to the driver; false on NO_MEM (retry) or failure
+    static bool transmit(const uint8_t* mac, const uint8_t* data, size_t length, bool& retry);
+
+    static void hold(const uint8_t* mac, uint8_t key, const uint8_t* data, size_t length,
+                     uint32_t nowUs);
+
+    static portMUX_TYPE lock_;
+    static InFlight inFlight_[kMaxWindow];
+    static Held held_[kHeldSlots];
+    static TxWindowStats stats_;
+};
+
+#endif // ILITE_TX_WINDOW_H
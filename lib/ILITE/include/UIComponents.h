@@ -22,6 +22,7 @@
 #include <Arduino.h>
 #include "DisplayCanvas.h"
 #include "IconLibrary.h"
+#include "SeriesBuffer.h"
 
 /**
  * @brief Modern UI Components - High-level interface building blocks
@@ -302,6 +303,33 @@ public:
                              IconID icon,
                              const char* label);
 
+    /**
+     * @brief Draw a scrolling time-series plot from a SeriesBuffer
+     *
+     * Each column shows the min/max envelope of the samples it covers, so
+     * spikes survive decimation. Newest samples are at the right edge; a
+     * window shorter than the plot width is right-aligned.
+     *
+     * @param canvas Drawing canvas
+     * @param x Left edge
+     * @param y Top edge
+     * @param w Width in pixels (at most SERIES_MAX_COLUMNS)
+     * @param h Height in pixels
+     * @param series Sample history
+     * @param window Samples to show (0 = everything retained)
+     * @param minValue Bottom of the Y range
+     * @param maxValue Top of the Y range (minValue == maxValue = auto-range)
+     */
+    static void drawSeries(DisplayCanvas& canvas,
+                           int16_t x, int16_t y,
+                           int16_t w, int16_t h,
+                           const SeriesBuffer& series,
+                           size_t window = 0,
+                           int16_t minValue = 0,
+                           int16_t maxValue = 0);
+
+    static constexpr int16_t SERIES_MAX_COLUMNS = 128;
+
     /**
      * @brief Draw connection status indicator
      *
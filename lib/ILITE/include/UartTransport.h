@@ -0,0 +1,125 @@
+/**
+ * @file UartTransport.h
+ * @brief Wired transport over a UART, optionally an RS485 half-duplex bus
+ *
+ * For robots on a tether, or a bench where the 2.4 GHz band is crowded, the
+ * same frames can travel over a UART at 1-2 Mbaud instead of ESP-NOW. Each
+ * frame is COBS-encoded and ends with a 0x00 delimiter, as in TelemetryTap:
+ *
+ *     COBS([src MAC:6][dst MAC:6][frame bytes...][crc16:2]) 0x00
+ *
+ * CRC-16/CCITT-FALSE covers both addresses and the frame. A receiver keeps
+ * frames addressed to its own MAC or to FF:FF:FF:FF:FF:FF, so several robots
+ * can share an RS485 bus; `src` is what the layers above see as the sender.
+ *
+ * The ESP32 UART has no general-purpose DMA; the IDF driver moves bytes
+ * between the hardware FIFO and its ring buffers from the UART interrupt.
+ * On top of that, the receive task decodes each chunk straight into a
+ * reserved RxRing slot (no intermediate frame buffer), holding back the last
+ * two decoded bytes since they may turn out to be the CRC.
+ *
+ * send() is one uart_write_bytes() per frame, so frames from different
+ * tasks never interleave. The frame is in the driver's TX buffer when it
+ * returns, so the completion is reported at once.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_UART_TRANSPORT_H
+#define ILITE_UART_TRANSPORT_H
+
+#include "Framing.h"
+#include "Transport.h"
+#include "RxRing.h"
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Wiring of the UART transport
+ */
+struct UartTransportConfig {
+    uart_port_t port = UART_NUM_2;
+    uint32_t baud = 2000000;
+    int8_t txPin = 14;
+    int8_t rxPin = 4;
+    int8_t dePin = -1;              ///< RS485 driver enable (-1 = plain UART)
+};
+
+/**
+ * @brief Counters of the UART transport
+ */
+struct UartTransportStats {
+    uint32_t txFrames = 0;
+    uint32_t txBytes = 0;           ///< Encoded bytes, delimiters included
+    uint32_t rxFrames = 0;          ///< Frames delivered to the ring
+    uint32_t rxBytes = 0;
+    uint32_t crcErrors = 0;
+    uint32_t framingErrors = 0;     ///< Bad COBS, oversized or truncated frames
+    uint32_t notForUs = 0;          ///< Frames addressed to another MAC
+    uint32_t ringFull = 0;
+    uint32_t driverOverflows = 0;   ///< UART FIFO or RX buffer overflows
+};
+
+/**
+ * @class UartTransport
+ * @brief COBS-framed frames over a UART
+ */
+class UartTransport : public Transport {
+public:
+    static UartTransport& instance();
+
+    /// Must be called before setActive()
+    void configure(const UartTransportConfig& config) { config_ = config; }
+
+    const char* getName() const override { return "UART"; }
+    bool begin() override;
+    esp_err_t send(const uint8_t* mac, const uint8_t* data, size_t length) override;
+    void dump(Print& out) const override;
+
+    const UartTransportStats& getStats() const { return stats_; }
+
+    /// Receive task priority/core (set before begin())
+    void setTaskPlacement(UBaseType_t priority, BaseType_t core) {
+        taskPriority_ = priority;
+        taskCore_ = core;
+    }
+
+private:
+    static constexpr size_t kAddressBytes = 12;             ///< src + dst
+    static constexpr size_t kMaxDecoded = kAddressBytes + RxFrame::kMaxPayload + 2;
+    static constexpr size_t kMaxEncoded = Framing::cobsMaxEncoded(kMaxDecoded);
+
+    UartTransport() = default;
+
+    static void rxTaskEntry(void* param);
+    void receive(const uint8_t* bytes, size_t length);
+    void emit(uint8_t byte);            ///< One decoded byte, CRC lag applied
+    void store(uint8_t byte);           ///< One frame byte past the lag
+    void endFrame();
+    void restartFrame();
+
+    UartTransportConfig config_;
+    UBaseType_t taskPriority_ = 5;
+    BaseType_t taskCore_ = 0;
+    QueueHandle_t events_ = nullptr;
+    TaskHandle_t rxTask_ = nullptr;
+    uint8_t selfMac_[6] = {};
+    UartTransportStats stats_;
+
+    // Decoder state (receive task only)
+    RxFrame* slot_ = nullptr;
+    uint8_t dst_[6] = {};
+    uint16_t decoded_ = 0;              ///< Bytes past the lag
+    uint16_t crc_ = Framing::kCrcInit;
+    uint8_t lag_[2] = {};
+    uint8_t lagCount_ = 0;
+    uint8_t blockCode_ = 0;
+    uint8_t blockRemaining_ = 0;
+    bool inFrame_ = false;
+    bool dropping_ = false;             ///< Rest of the frame is ignored
+};
+
+#endif // ILITE_UART_TRANSPORT_H
@@ -0,0 +1,103 @@
+/**
+ * @file WebDashboard.h
+ * @brief Telemetry dashboard for a phone on the softAP, pushed over a binary WebSocket
+ *
+ * The pit crew wants live telemetry on a phone without a laptop on the
+ * console. With ILITEConfig::webDashboard (or "web on") the controller keeps
+ * its access point up outside the maintenance mode and serves:
+ *
+ * - `GET /` - a small static page from flash (no filesystem)
+ * - `GET /ws` - a WebSocket that pushes the active module's telemetry,
+ *   decoded with the PacketDescriptor field tables, and the controller's
+ *   own screen (see ScreenCapture)
+ *
+ * Everything runs on one low-priority task that polls non-blocking
+ * sockets; CommTask and RxTask never wait for the network. Telemetry is
+ * read from TelemetryStore slots, so nothing is queued per packet.
+ *
+ * ## Push rate
+ * A push is one WebSocket frame batching the newest packet of every type
+ * that changed since the previous push. The page answers each frame with
+ * a one-byte ack after it has drawn it. At most kCredits frames are
+ * unacknowledged; a slow phone gets fewer, fuller frames (intermediate
+ * packets are coalesced), a fast one up to 1000 / kMinPushIntervalMs per
+ * second. The interval floor and the small frames also cap the AP's share
+ * of airtime next to ESP-NOW. The AP beacons every kBeaconIntervalTu.
+ *
+ * ## Wire Format (little-endian, binary frames)
+ * ```
+ * schema  0x01 typeCount:u8 nameLen:u8 moduleName
+ *              { nameLen:u8 name fieldCount:u8 { type:u8 nameLen:u8 name }* }*
+ * batch   0x02 count:u8 timeMs:u32
+ *              { typeIndex:u8 coalesced:u16 fieldCount:u8 value:f32* }*
+ * screen  0x03 flags:u8 tileWidth:u8 pageCount:u8 { page:u8 length:u16 delta }*
+ * ack     any frame from the page (one credit)
+ * ```
+ * `type` is a PacketDescriptor::Field::Type; every field is sent as a
+ * float (NaN for BYTE_ARRAY). `coalesced` counts packets of the type that
+ * arrived since the previous push and were not sent. The schema is sent
+ * on connect and whenever the active module changes.
+ *
+ * A screen frame carries the display pages that changed since the last
+ * one, coded as in ScreenCapture.h; flags bit 0 (keyframe, the first
+ * after connecting) clears the picture first. Screens take credits like
+ * batches, at most one per kMinScreenIntervalMs.
+ *
+ * One WebSocket client at a time; a new one replaces the old. "web" on the
+ * console prints the counters.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_WEB_DASHBOARD_H
+#define ILITE_WEB_DASHBOARD_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Counters since begin()
+ */
+struct WebDashboardStats {
+    uint32_t pages = 0;             ///< Page requests served
+    uint32_t clients = 0;           ///< WebSocket handshakes
+    uint32_t schemas = 0;
+    uint32_t batches = 0;           ///< Frames pushed
+    uint32_t screens = 0;           ///< Display frames pushed
+    uint32_t packets = 0;           ///< Packets in those frames
+    uint32_t coalesced = 0;         ///< Packets superseded before a push
+    uint32_t creditStalls = 0;      ///< Pushes held for the client's ack
+    uint32_t bytes = 0;             ///< WebSocket payload bytes sent
+    uint32_t pushHz = 0;            ///< Frames in the last second
+    bool connected = false;
+};
+
+/**
+ * @class WebDashboard
+ * @brief Static HTTP + WebSocket server and its task
+ */
+class WebDashboard {
+public:
+    static constexpr size_t kCredits = 4;               ///< Unacknowledged frames
+    static constexpr uint32_t kMinPushIntervalMs = 20;  ///< 50 frames/s at most
+    static constexpr size_t kMaxFrameBytes = 1400;      ///< One TCP segment per push
+    static constexpr uint32_t kMinScreenIntervalMs = 50;    ///< 20 screens/s at most
+    static constexpr uint16_t kBeaconIntervalTu = 300;  ///< AP beacon period (1.024 ms units)
+
+    /**
+     * @brief Start serving on `port` (the AP must be up)
+     *
+     * Creates the task on first use; later calls restart the server.
+     */
+    static bool begin(uint16_t port, UBaseType_t priority, BaseType_t core);
+
+    /// Stop serving and drop the client; the task parks
+    static void end();
+
+    static bool isRunning();
+
+    static WebDashboardStats getStats();
+    static void dump(Print& out);
+};
+
+#endif // ILITE_WEB_DASHBOARD_H
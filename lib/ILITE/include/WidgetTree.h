@@ -0,0 +1,269 @@
+/**
+ * @file WidgetTree.h
+ * @brief Retained-mode widgets on top of UIComponents
+ *
+ * Immediate-mode dashboards redraw every element every frame, even when
+ * nothing changed. A WidgetScreen instead holds widgets that are bound to a
+ * data source. Each frame, every widget polls its source. Only widgets whose
+ * value changed, or that were explicitly invalidated, clear their bounds and
+ * redraw. Unchanged pixels stay in the framebuffer, so DisplayCanvas'
+ * page-diff flush then only sends the tiles those widgets touched.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * class MyModule : public ILITEModule {
+ *     TextWidget title_{0, 12, 128, 10, DisplayCanvas::NORMAL, [] { return "My Robot"; }, true};
+ *     BatteryWidget battery_{100, 14, 28, 8, [] { return robotBattery; }};
+ *     WidgetScreen screen_;
+ *
+ *     void onInit() override {
+ *         screen_.add(title_);
+ *         screen_.add(battery_);
+ *     }
+ *
+ *     WidgetScreen* getDashboardWidgets() override { return &screen_; }
+ * };
+ * ```
+ *
+ * Widgets must stay inside their declared bounds; the bounds are cleared
+ * before each redraw.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_WIDGET_TREE_H
+#define ILITE_WIDGET_TREE_H
+
+#include <Arduino.h>
+#include <functional>
+#include "DisplayCanvas.h"
+#include "UIComponents.h"
+
+// ============================================================================
+// Widget Base
+// ============================================================================
+
+/**
+ * @class Widget
+ * @brief Rectangle of the screen that redraws only when invalidated
+ */
+class Widget {
+public:
+    Widget(int16_t x, int16_t y, int16_t w, int16_t h)
+        : x_(x), y_(y), w_(w), h_(h), dirty_(true) {}
+    virtual ~Widget() = default;
+
+    /// Force a redraw on the next frame
+    void invalidate() { dirty_ = true; }
+
+    /// True if the widget will redraw on the next frame
+    bool isDirty() const { return dirty_; }
+
+    int16_t getX() const { return x_; }
+    int16_t getY() const { return y_; }
+    int16_t getWidth() const { return w_; }
+    int16_t getHeight() const { return h_; }
+
+    /**
+     * @brief Poll the bound source
+     * @return true if the displayed value changed since the last draw
+     */
+    virtual bool refresh() { return false; }
+
+    /**
+     * @brief Render inside the bounds (bounds are already cleared)
+     */
+    virtual void draw(DisplayCanvas& canvas) = 0;
+
+protected:
+    int16_t x_;
+    int16_t y_;
+    int16_t w_;
+    int16_t h_;
+
+private:
+    friend class WidgetScreen;
+    bool dirty_;
+};
+
+// ============================================================================
+// Widget Screen
+// ============================================================================
+
+/**
+ * @class WidgetScreen
+ * @brief Flat list of widgets rendered incrementally
+ */
+class WidgetScreen {
+public:
+    static constexpr size_t kMaxWidgets = 16;
+
+    /**
+     * @brief Add a widget (the widget must outlive the screen)
+     * @return false if the screen is full
+     */
+    bool add(Widget& widget);
+
+    /// Widgets in this screen
+    size_t getWidgetCount() const { return count_; }
+
+    /// Mark every widget dirty
+    void invalidateAll();
+
+    /**
+     * @brief Render the screen
+     *
+     * @param canvas Drawing canvas
+     * @param full true if the framebuffer was cleared and everything must
+     *             be drawn; false to redraw only changed widgets
+     * @return Number of widgets drawn
+     */
+    size_t render(DisplayCanvas& canvas, bool full);
+
+private:
+    Widget* widgets_[kMaxWidgets] = {};
+    size_t count_ = 0;
+};
+
+// ============================================================================
+// Standard Widgets
+// ============================================================================
+
+/**
+ * @brief Single line of text from a string source
+ */
+class TextWidget : public Widget {
+public:
+    using Source = std::function<const char*()>;
+
+    /**
+     * @param y Top of the bounds; text baseline is placed at the bottom
+     * @param centered Center horizontally within the bounds
+     */
+    TextWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+               DisplayCanvas::Font font, Source source, bool centered = false);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    static constexpr size_t kMaxText = 32;
+
+    DisplayCanvas::Font font_;
+    Source source_;
+    bool centered_;
+    char text_[kMaxText];
+};
+
+/**
+ * @brief Battery icon + percentage (UIComponents::drawBatteryIndicator)
+ */
+class BatteryWidget : public Widget {
+public:
+    using Source = std::function<uint8_t()>;
+
+    /// x/y are the top-right corner, as in drawBatteryIndicator()
+    BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h, Source source);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    Source source_;
+    uint8_t percent_;
+};
+
+/**
+ * @brief Signal bars (UIComponents::drawSignalIndicator)
+ */
+class SignalWidget : public Widget {
+public:
+    using Source = std::function<uint8_t()>;
+
+    /// x/y are the top-right corner, as in drawSignalIndicator()
+    SignalWidget(int16_t x, int16_t y, int16_t w, int16_t h, Source source);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    Source source_;
+    uint8_t strength_;
+};
+
+/**
+ * @brief Icon + label + formatted value (UIComponents::drawLabeledValue)
+ */
+class LabeledValueWidget : public Widget {
+public:
+    /// Writes the value text into the buffer
+    using Formatter = std::function<void(char* buffer, size_t size)>;
+
+    LabeledValueWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+                       IconID icon, const char* label, Formatter formatter);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    static constexpr size_t kMaxValue = 16;
+
+    IconID icon_;
+    const char* label_;
+    Formatter formatter_;
+    char value_[kMaxValue];
+};
+
+/**
+ * @brief Mini gauge (UIComponents::drawMiniGauge)
+ *
+ * The value is quantized to `resolution` so sensor noise does not cause a
+ * redraw every frame.
+ */
+class GaugeWidget : public Widget {
+public:
+    using Source = std::function<float()>;
+
+    /// cx/cy/radius as in drawMiniGauge(); bounds include icon and label
+    GaugeWidget(int16_t cx, int16_t cy, int16_t radius,
+                float min, float max, IconID icon, const char* label,
+                Source source, float resolution = 0.0f);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    int16_t cx_;
+    int16_t cy_;
+    int16_t radius_;
+    float min_;
+    float max_;
+    IconID icon_;
+    const char* label_;
+    Source source_;
+    float resolution_;
+    int32_t step_;      ///< Quantized value last drawn
+    float value_;
+};
+
+/**
+ * @brief Module card (UIComponents::drawModuleCard) with a focus source
+ */
+class CardWidget : public Widget {
+public:
+    using FocusSource = std::function<bool()>;
+
+    CardWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+               const UIComponents::ModuleCard& card, FocusSource focused);
+
+    bool refresh() override;
+    void draw(DisplayCanvas& canvas) override;
+
+private:
+    UIComponents::ModuleCard card_;
+    FocusSource focusedSource_;
+    bool focused_;
+};
+
+#endif // ILITE_WIDGET_TREE_H
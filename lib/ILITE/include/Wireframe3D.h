@@ -0,0 +1,156 @@
+/**
+ * @file Wireframe3D.h
+ * @brief Fixed-point wireframe rendering through DisplayCanvas
+ *
+ * The orientation cubes rotated every vertex with three Euler steps of
+ * libm sin()/cos() (48 calls per frame for 8 vertices), and TheGill's arm
+ * view walked Bresenham over grid lines that run far off the panel.
+ * Wireframe3D shares the pieces between those screens:
+ *
+ * - **WireRotation**: a Q15 rotation matrix built once per frame from
+ *   Euler angles (six sinf()/cosf() calls) or a unit quaternion (none).
+ * - **Transforms**: vertices are int16 model units; rotating one is nine
+ *   integer multiply-adds, projecting it a scale and a shift.
+ * - **Clipping**: lines are clipped to the panel (Cohen-Sutherland)
+ *   before DisplayCanvas draws them, so a segment mostly off screen costs
+ *   its visible pixels only, and one fully off screen costs nothing.
+ * - **Edge lists**: a WireMesh is a vertex table plus index pairs; each
+ *   vertex is projected once however many edges share it.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * static const WireVertex box[8] = {
+ *     {-20, -10, -5}, {20, -10, -5}, {20, 10, -5}, {-20, 10, -5},
+ *     {-20, -10,  5}, {20, -10,  5}, {20, 10,  5}, {-20, 10,  5}
+ * };
+ * const WireMesh mesh{box, 8, Wireframe3D::kBoxEdges, Wireframe3D::kBoxEdgeCount};
+ *
+ * const WireRotation rotation = WireRotation::fromEuler(roll, pitch, yaw);
+ * Wireframe3D::drawMesh(canvas, mesh, rotation, 64, 38);
+ * ```
+ *
+ * Screen X follows model X and screen up follows model Y; model Z is depth.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_WIREFRAME_3D_H
+#define ILITE_WIREFRAME_3D_H
+
+#include <Arduino.h>
+
+class DisplayCanvas;
+
+/// Model-space vertex; keep coordinates within +/-16383
+struct WireVertex {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+/// Screen-space point
+struct WirePoint {
+    int16_t x;
+    int16_t y;
+};
+
+/// Indices of the two vertices an edge joins
+struct WireEdge {
+    uint8_t a;
+    uint8_t b;
+};
+
+struct WireMesh {
+    const WireVertex* vertices;
+    uint8_t vertexCount;            ///< At most Wireframe3D::kMaxVertices
+    const WireEdge* edges;
+    uint8_t edgeCount;
+};
+
+/// Inclusive screen rectangle lines are clipped to
+struct WireViewport {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+};
+
+/**
+ * @class WireRotation
+ * @brief 3x3 rotation matrix in Q15 (1.0 = 32768)
+ */
+class WireRotation {
+public:
+    static constexpr uint8_t kShift = 15;
+
+    static WireRotation identity();
+
+    /**
+     * @brief Rotate about X by roll, then Y by pitch, then Z by yaw
+     * @param roll Radians
+     * @param pitch Radians
+     * @param yaw Radians
+     */
+    static WireRotation fromEuler(float roll, float pitch, float yaw);
+
+    /// Unit quaternion (w, x, y, z); not renormalised
+    static WireRotation fromQuaternion(float w, float x, float y, float z);
+
+    /// Rotated vertex, rounded to model units
+    void apply(const WireVertex& in, int32_t out[3]) const;
+
+    int32_t m[3][3];
+};
+
+/**
+ * @class Wireframe3D
+ * @brief Static projection, clipping and edge drawing
+ */
+class Wireframe3D {
+public:
+    static constexpr size_t kMaxVertices = 32;
+
+    /**
+     * @brief Edges of a box
+     *
+     * For eight corners listed back face (-z) counter-clockwise from
+     * (-x, -y), then the front face in the same order.
+     */
+    static const WireEdge kBoxEdges[12];
+    static constexpr uint8_t kBoxEdgeCount = 12;
+
+    /// The whole panel of the canvas
+    static WireViewport viewport(const DisplayCanvas& canvas);
+
+    /**
+     * @brief Rotate and project vertices orthographically
+     * @param scaleQ8 Model units to pixels in Q8 (256 = 1:1)
+     * @param out One point per vertex
+     */
+    static void project(const WireVertex* vertices, size_t count, const WireRotation& rotation,
+                        int16_t centerX, int16_t centerY, WirePoint* out, int32_t scaleQ8 = 256);
+
+    /**
+     * @brief Cohen-Sutherland clip of a segment to a viewport
+     * @return false if no part of the segment is inside
+     */
+    static bool clipLine(int16_t& x0, int16_t& y0, int16_t& x1, int16_t& y1, const WireViewport& view);
+
+    /// Clipped canvas.drawLine()
+    static void drawLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+    /// Clipped canvas.drawPatternLine(); the pattern restarts at the clipped start
+    static void drawPatternLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                uint8_t pattern, uint8_t length = 8);
+
+    /// Clipped lines between projected points
+    static void drawEdges(DisplayCanvas& canvas, const WirePoint* points,
+                          const WireEdge* edges, size_t edgeCount);
+
+    /// project() then drawEdges()
+    static void drawMesh(DisplayCanvas& canvas, const WireMesh& mesh, const WireRotation& rotation,
+                         int16_t centerX, int16_t centerY, int32_t scaleQ8 = 256);
+};
+
+#endif // ILITE_WIREFRAME_3D_H
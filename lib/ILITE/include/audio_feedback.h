@@ -13,6 +13,14 @@ enum class AudioCue : uint8_t {
   Error
 };
 
+/**
+ * @brief One step of a tone sequence (frequencyHz 0 = rest)
+ */
+struct AudioNote {
+  uint16_t frequencyHz;
+  uint16_t durationMs;
+};
+
 void audioFeedback(AudioCue cue);
 void audioUpdate();
 void audioSetup();
@@ -24,3 +32,19 @@ void audioPlayStartup();
  * @param durationMs Duration in milliseconds
  */
 void audioPlayTone(uint16_t frequencyHz, uint16_t durationMs);
+
+/**
+ * @brief Play a note table without blocking
+ *
+ * With AudioSynth running, each request gets its own voice and overlapping
+ * cues mix. On the cosine-generator fallback, notes are timed by a 1 ms
+ * esp_timer and the newest request replaces whatever is playing. Safe to
+ * call from any task.
+ *
+ * @param notes Table that must outlive playback (normally static const)
+ * @param count Number of notes in the table
+ */
+void audioPlaySequence(const AudioNote* notes, size_t count);
+
+/// True while a tone or sequence is playing
+bool audioIsPlaying();
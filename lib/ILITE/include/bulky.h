@@ -16,8 +16,21 @@
 
 constexpr uint32_t BULKY_PACKET_MAGIC = 0x42554C4B; // 'BULK'
 
+constexpr uint8_t BULKY_COMMAND_V1 = 1;    ///< BulkyCommand, one byte per button
+constexpr uint8_t BULKY_COMMAND_V2 = 2;    ///< BulkyCommandV2, packed state byte
+
+/**
+ * @brief Button bits of BulkyControlState::buttons and BulkyCommandV2::state
+ */
+namespace BulkyButton {
+constexpr uint8_t Button1 = 1u << 0;
+constexpr uint8_t Button2 = 1u << 1;
+constexpr uint8_t Button3 = 1u << 2;
+constexpr uint8_t All = Button1 | Button2 | Button3;
+} // namespace BulkyButton
+
 /**
- * @brief Command packet sent from ILITE to Bulky
+ * @brief Command packet sent from ILITE to Bulky (v1, legacy robots)
  */
 struct BulkyCommand {
     uint8_t replyIndex;
@@ -26,6 +39,24 @@ struct BulkyCommand {
     uint8_t buttonStates[3];
 } __attribute__((packed));
 
+/**
+ * @brief Command packet v2: motion state and buttons share one byte
+ *
+ * Sent only after the robot's telemetry reports commandVersion >=
+ * BULKY_COMMAND_V2; robots that leave that byte at 0 keep receiving the
+ * 6-byte BulkyCommand. The leading version byte and the 4-byte length tell
+ * the two layouts apart on the robot.
+ */
+struct BulkyCommandV2 {
+    uint8_t version;             ///< BULKY_COMMAND_V2
+    uint8_t replyIndex;
+    int8_t speed;
+    uint8_t state;               ///< Bits 0-2: motion state, bits 3-5: BulkyButton bits
+} __attribute__((packed));
+
+constexpr uint8_t BULKY_MOTION_MASK = 0x07;
+constexpr uint8_t BULKY_BUTTON_SHIFT = 3;
+
 /**
  * @brief Telemetry packet sent from Bulky to ILITE
  */
@@ -36,7 +67,8 @@ struct BulkyTelemetry {
     uint8_t linePosition;        ///< Line sensor position (bitmask: 4 bits)
     uint8_t firePose;            ///< Fire detection angle (0-180 degrees)
     uint8_t currentSpeed;        ///< Current speed (0-100%)
-    uint8_t reserved[3];         ///< Reserved for future use
+    uint8_t commandVersion;      ///< Newest command layout the robot accepts (0 = v1 only)
+    uint8_t reserved[2];         ///< Reserved for future use
 } __attribute__((packed));
 
 /**
@@ -48,13 +80,14 @@ struct BulkyControlState {
     bool honkActive;             ///< Honk/buzzer active
     bool lightActive;            ///< Light active
     bool slowModeActive;         ///< Slow mode active
+    uint8_t buttons;             ///< BulkyButton bits held this tick
+    uint8_t commandVersion;      ///< Command layout in use, negotiated from telemetry
     uint32_t lastTelemetryTime;  ///< Last telemetry received (ms)
     bool connectionActive;       ///< Connection status
 };
 
 // Global instances
 extern BulkyCommand bulkyCommand;
-extern BulkyTelemetry bulkyTelemetry;
 extern BulkyControlState bulkyState;
 
 /**
@@ -74,10 +107,18 @@ void updateBulkyControl();
  */
 void handleBulkyTelemetry(const uint8_t* data, size_t length);
 
+/**
+ * @brief Encode the command in the negotiated layout
+ * @param buffer Output buffer
+ * @param bufferSize Buffer capacity
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t packBulkyCommand(uint8_t* buffer, size_t bufferSize);
+
 /**
  * @brief Get command packet for transmission
  * @param size Output: packet size
- * @return Pointer to command packet
+ * @return Pointer to command packet (negotiated layout)
  */
 const uint8_t* getBulkyPayload(size_t& size);
 
@@ -1,23 +1,60 @@
 #pragma once
 
 #include <Arduino.h>
+#include <atomic>
+
+// Entries are stored as binary records: the format string pointer, the raw
+// arguments and copies of any RAM strings. Nothing is formatted when a
+// message is added; connectionLogGetEntry() and connectionLogDump() format
+// on read. Adding an entry is lock-free and safe from any task, including
+// WiFi/ESP-NOW callbacks.
+//
+// A format string in flash (a string literal) is kept by pointer; any
+// other format is copied into the record's string pool, ahead of and
+// sharing the kStringBytes with the RAM string arguments.
+// Integer length modifiers (l, ll, z, h) are accepted but ignored, since
+// each argument records its own type.
 
 // Initializes the connection log system. Currently a no-op but provided for completeness.
 void connectionLogInit();
 
-// Adds a message to the log (truncated if necessary).
+// Adds a message to the log. Flash strings are kept by pointer, RAM strings
+// are copied (up to 79 chars).
 void connectionLogAdd(const char* message);
 
-// Adds a formatted message to the log using printf-style formatting.
-void connectionLogAddf(const char* fmt, ...);
-
 // Returns the number of log entries currently stored.
 size_t connectionLogGetCount();
 
-// Returns a pointer to the log entry at the provided index (0 = oldest).
-// Returns nullptr if the index is out of range.
+// Returns the formatted log entry at the provided index (0 = oldest).
+// Returns nullptr if the index is out of range. The text stays valid until
+// the same entry is overwritten; call from UI/console tasks only.
 const char* connectionLogGetEntry(size_t index);
 
+// Wrapped view for the log screens (same tasks as connectionLogGetEntry).
+// Each entry is word-wrapped at kConnectionLogColumns once, the first time
+// the view sees it; lines are then found by binary search, so drawing a
+// screen costs the visible lines regardless of how many entries are stored.
+constexpr size_t kConnectionLogColumns = 30;
+
+// Returns the number of wrapped lines of all stored entries.
+size_t connectionLogGetLineCount();
+
+// Copies wrapped line `line` into buffer. Lines are counted from the oldest
+// entry, or from the newest entry with newestFirst (each entry's own lines
+// stay in reading order). Returns false if the line does not exist.
+bool connectionLogGetLine(size_t line, char* buffer, size_t size, bool newestFirst = false);
+
+// Sequential reader for background persistence (EventLog; one reader task).
+// Formats the record at `cursor` (counted from boot) into text and advances
+// the cursor. Records the ring overwrote before they were read are skipped
+// and added to `lost`. Returns false when caught up or when the next record
+// is still being written.
+bool connectionLogReadNext(uint32_t& cursor, uint32_t& timeMs, char* text, size_t size,
+                           uint32_t& lost);
+
+// Formats every stored entry with its timestamp to the given output.
+void connectionLogDump(Print& out);
+
 // Clears all stored log entries.
 void connectionLogClear();
 
@@ -26,3 +63,99 @@ void connectionLogSetRecordingEnabled(bool enabled);
 
 // Returns true if recording is currently enabled.
 bool connectionLogIsRecordingEnabled();
+
+namespace connection_log_detail {
+
+constexpr size_t kMaxArgs = 6;
+constexpr size_t kStringBytes = 80;
+
+enum ArgType : uint8_t {
+  ARG_SIGNED,
+  ARG_UNSIGNED,
+  ARG_DOUBLE,
+  ARG_POINTER,
+  ARG_STATIC_TEXT,   // Pointer into flash
+  ARG_TEXT           // Offset into Record::strings
+};
+
+struct Arg {
+  union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+    const char* s;
+  };
+};
+
+struct Record {
+  std::atomic<uint32_t> sequence;   // Odd while being written
+  uint32_t timeMs;
+  const char* fmt;                  // nullptr: the format is at strings[0]
+  uint8_t argCount;
+  uint8_t stringBytes;
+  uint8_t types[kMaxArgs];
+  Arg args[kMaxArgs];
+  char strings[kStringBytes];
+};
+
+// Claims a record in the constructor, publishes it in the destructor
+class RecordWriter {
+public:
+  explicit RecordWriter(const char* fmt);
+  ~RecordWriter();
+
+  void add(int value) { addSigned(value); }
+  void add(long value) { addSigned(value); }
+  void add(long long value) { addSigned(value); }
+  void add(unsigned value) { addUnsigned(value); }
+  void add(unsigned long value) { addUnsigned(value); }
+  void add(unsigned long long value) { addUnsigned(value); }
+  void add(double value) {
+    if (Arg* arg = next(ARG_DOUBLE)) {
+      arg->d = value;
+    }
+  }
+  void add(const void* value) {
+    if (Arg* arg = next(ARG_POINTER)) {
+      arg->p = value;
+    }
+  }
+  void add(const char* value);
+
+private:
+  RecordWriter(const RecordWriter&) = delete;
+  RecordWriter& operator=(const RecordWriter&) = delete;
+
+  Arg* next(ArgType type) {
+    if (record_ == nullptr || record_->argCount >= kMaxArgs) {
+      return nullptr;
+    }
+    record_->types[record_->argCount] = type;
+    return &record_->args[record_->argCount++];
+  }
+  void addSigned(long long value) {
+    if (Arg* arg = next(ARG_SIGNED)) {
+      arg->i = value;
+    }
+  }
+  void addUnsigned(unsigned long long value) {
+    if (Arg* arg = next(ARG_UNSIGNED)) {
+      arg->u = value;
+    }
+  }
+
+  Record* record_;
+  uint32_t sequence_;
+};
+
+}  // namespace connection_log_detail
+
+// Adds a printf-style message to the log. Arguments are captured, not
+// formatted; at most connection_log_detail::kMaxArgs are kept.
+template <typename... Args>
+inline void connectionLogAddf(const char* fmt, Args... args) {
+  connection_log_detail::RecordWriter writer(fmt);
+  int expand[] = {0, (writer.add(args), 0)...};
+  (void)expand;
+}
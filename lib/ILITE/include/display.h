@@ -5,8 +5,21 @@
 #include "telemetry.h"
 #include "input.h"
 #include "ui_modules.h"
+#include "DisplayBus.h"
 
-extern U8G2_SH1106_128X64_NONAME_F_HW_I2C oled;
+class DisplayCanvas;
+
+// Panel object of the pre-framework screens below (the framework draws
+// through DisplayBus). Its framebuffer follows ILITE_DISPLAY_PAGE_BUFFER so
+// page-buffer builds do not keep a full frame for it; those screens draw
+// full frames and are not supported there.
+#if ILITE_DISPLAY_PAGE_BUFFER
+using OledDisplay = U8G2_SH1106_128X64_NONAME_1_HW_I2C;
+#else
+using OledDisplay = U8G2_SH1106_128X64_NONAME_F_HW_I2C;
+#endif
+
+extern OledDisplay oled;
 extern EspNowDiscovery discovery;
 
 void initDisplay();
@@ -63,7 +76,8 @@ void drawDrongazInterface();
 void drawTelemetryInfo();
 // Draw a single PID graph based on the currently selected axis
 void drawPidGraph();
-void drawOrientationCube();
+// Drawn into the canvas; the caller presents the frame
+void drawOrientationCube(DisplayCanvas& canvas);
 
 constexpr uint8_t PID_FOCUS_AXIS = 0;
 constexpr uint8_t PID_FOCUS_KP = 1;
@@ -67,6 +67,61 @@ struct DrongazeTelemetry {
     uint32_t commandAge;              ///< Age of last received command in milliseconds
 } __attribute__((packed));
 
+/// Magic of a binary parameter frame, controller to DroneGaze ('DGPR')
+constexpr uint32_t DRONGAZE_PARAM_MAGIC = 0x44475052;
+
+/// Magic of DroneGaze's reply to a parameter frame ('DGPA')
+constexpr uint32_t DRONGAZE_PARAM_ACK_MAGIC = 0x44475041;
+
+/// Most entries in one parameter frame
+constexpr size_t DRONGAZE_PARAM_MAX_ENTRIES = 16;
+
+/**
+ * @brief Tunable parameters of the binary parameter channel
+ *
+ * PID gains are numbered axis * 3 + term (pitch/roll/yaw, Kp/Ki/Kd).
+ * Stabilization entries carry 1.0 (on) or 0.0 (off).
+ */
+enum class DrongazeParam : uint8_t {
+    PitchKp = 0, PitchKi, PitchKd,
+    RollKp, RollKi, RollKd,
+    YawKp, YawKi, YawKd,
+    StabilizePitch, StabilizeRoll, StabilizeYaw,
+    Count
+};
+
+/// What a parameter frame asks for
+enum class DrongazeParamOp : uint8_t {
+    Set = 1,        ///< Apply the entries; the reply carries the values now in effect
+    Get = 2         ///< Report the listed parameters (count 0 = all of them)
+};
+
+/**
+ * @brief Header of a parameter frame and of its reply
+ *
+ * Frame:  [header: DRONGAZE_PARAM_MAGIC][entry x count]
+ * Reply:  [header: DRONGAZE_PARAM_ACK_MAGIC, same sequence and op][entry x count]
+ *
+ * The reply acknowledges the frame with the same sequence and reports the
+ * values the drone actually uses (after its own clamping), so one round trip
+ * both confirms an edit and reads it back. The controller keeps one frame in
+ * flight and resends it, with a new sequence and the newest values, until a
+ * reply arrives; edits made meanwhile are batched into the next frame (see
+ * ParamSync.h).
+ */
+struct DrongazeParamHeader {
+    uint32_t magic;
+    uint16_t sequence;        ///< Incremented per new frame (resends keep it)
+    uint8_t op;               ///< DrongazeParamOp
+    uint8_t count;            ///< Entries that follow
+} __attribute__((packed));
+
+/// One parameter value
+struct DrongazeParamEntry {
+    uint8_t id;               ///< DrongazeParam
+    float value;
+} __attribute__((packed));
+
 /**
  * @brief PID gain triplet for one control axis
  */
@@ -185,6 +240,39 @@ void actionDrongazeOpenPidSettings(ModuleState& state, size_t slot);
  */
 void sendDrongazePidGains(int axisIndex);
 
+/**
+ * @brief Queue a parameter edit for the next parameter frame
+ *
+ * Edits are coalesced per parameter (see ParamSync): a fast encoder spin
+ * sends only the latest value, and the final value is resent until the
+ * drone confirms it.
+ */
+void setDrongazeParam(DrongazeParam param, float value);
+
+/// True while an edit of `param` is not yet confirmed by the drone
+bool isDrongazeParamPending(DrongazeParam param);
+
+/// Parameters with unconfirmed edits
+size_t getDrongazePendingParamCount();
+
+/**
+ * @brief Send queued parameter frames and resend unacknowledged ones
+ *
+ * Called every control tick by the DroneGaze module.
+ *
+ * @param nowMs millis()
+ */
+void serviceDrongazeParams(uint32_t nowMs);
+
+/**
+ * @brief Set one PID gain locally and queue it for the drone
+ *
+ * @param axisIndex Axis index: 0=pitch, 1=roll, 2=yaw
+ * @param paramIndex Parameter: 0=Kp, 1=Ki, 2=Kd
+ * @param value New gain (clamped to the gain's range)
+ */
+void setDrongazePidGain(int axisIndex, int paramIndex, float value);
+
 /**
  * @brief Adjust PID gain by delta step
  *
@@ -197,7 +285,7 @@ void adjustDrongazePidGain(int axisIndex, int paramIndex, int delta);
 /**
  * @brief Request current PID gains from DroneGaze
  *
- * Sends "pid show" command via ESP-NOW command channel.
+ * Queues a Get of every parameter; the reply fills drongazeState.
  */
 void requestDrongazePidGains();
 
@@ -209,13 +297,15 @@ void requestDrongazePidGains();
 void toggleDrongazeAxisStabilization(int axisIndex);
 
 /**
- * @brief Process PID response message from DroneGaze
+ * @brief Process DroneGaze's reply to a parameter frame
  *
- * Parses "PID axis: Kp=X Ki=Y Kd=Z" format messages and updates local state.
+ * Acknowledges the frame in flight (by sequence) and copies the reported
+ * values into drongazeState, except for parameters edited since.
  *
- * @param message Command response string
+ * @param data Reply starting with DRONGAZE_PARAM_ACK_MAGIC
+ * @param length Reply length in bytes
  */
-void handleDrongazeCommandMessage(const char* message);
+void handleDrongazeParamAck(const uint8_t* data, size_t length);
 
 /// DroneGaze module descriptor (defined in drongaze.cpp)
 extern const ModuleDescriptor kDrongazeDescriptor;
@@ -5,6 +5,8 @@
 #include <WiFi.h>
 #include <esp_now.h>
 #include <esp_wifi.h>
+#include "RxRing.h"
+#include <atomic>
 
 // -----------------------------------------------------------------------------
 // Compile-time configuration
@@ -32,6 +34,18 @@ static constexpr uint32_t DEVICE_TTL_MS = 30000;  // 30 seconds - increased to p
 static constexpr uint32_t LINK_TIMEOUT_MS = 30000;  // 30 seconds without ANY message from robot
 static constexpr uint32_t KEEPALIVE_INTERVAL_MS = 5000;  // Send keepalive every 5 seconds when paired
 
+// PAIR_REQ broadcasts start at the minimum interval and double after every
+// broadcast that turned up no new peer, up to the maximum (and stay at the
+// maximum while paired). A new peer, a link reset or re-enabling discovery
+// drops back to the minimum. Must stay well below DEVICE_TTL_MS, since
+// robots only refresh their entry by answering.
+static constexpr uint32_t BROADCAST_MIN_INTERVAL_MS = 250;
+static constexpr uint32_t BROADCAST_MAX_INTERVAL_MS = 8000;
+
+// Channels the survey picks from and robots search (non-overlapping in 2.4 GHz)
+static constexpr uint8_t kChannelCandidates[] = {1, 6, 11};
+static constexpr uint8_t kMaxWifiChannel = 13;
+
 // -----------------------------------------------------------------------------
 // Identity & packet layout
 // -----------------------------------------------------------------------------
@@ -51,6 +65,12 @@ enum class MessageType : uint8_t {
     MSG_PAIR_ACK = 0x04,
     MSG_KEEPALIVE = 0x05,
     MSG_COMMAND = 0x06,
+    MSG_PING = 0x07,            ///< monotonicMs = esp_timer stamp (us), reserved = sequence
+    MSG_PONG = 0x08,            ///< Echo of a ping's monotonicMs and reserved (PongPacket)
+    MSG_CHANNEL = 0x09,         ///< reserved = new channel, monotonicMs = ms until both switch
+    MSG_SLOT_BEACON = 0x0A,     ///< Controller to controllers (TdmaSlots): monotonicMs = us into the superframe
+    MSG_RESUME = 0x0B,          ///< reserved = session token (from PAIR_CONFIRM's reserved)
+    MSG_RESUME_ACK = 0x0C,      ///< reserved = the token, or 0 for a session the peer does not hold
 };
 
 struct Packet {
@@ -65,8 +85,42 @@ struct CommandPacket {
     Packet header;
     char command[48];
 };
+
+/// MSG_PONG with the answering side's esp_timer stamps for ClockSync. Peers
+/// that send a bare Packet still count for LinkMetrics.
+struct PongPacket {
+    Packet header;
+    uint32_t pingRxUs;          ///< When the ping arrived (us)
+    uint32_t pongTxUs;          ///< When the pong was sent (us)
+};
 #pragma pack(pop)
 
+/// Frames, bytes and estimated on-air time for one message type
+struct AirtimeStats {
+    uint32_t txFrames = 0;
+    uint32_t txBytes = 0;
+    uint32_t txAirUs = 0;
+    uint32_t rxFrames = 0;
+    uint32_t rxBytes = 0;
+    uint32_t rxAirUs = 0;
+};
+
+/// Session resumes (see EspNowDiscovery::resumeSession)
+struct ResumeStats {
+    uint32_t attempts = 0;          ///< Resumes this side started
+    uint32_t resumed = 0;           ///< Links restored by a resume (either side started it)
+    uint32_t refused = 0;           ///< Token unknown on one side; full confirm instead
+    uint32_t lastResumeMs = 0;      ///< First MSG_RESUME to the ack, of the latest one started here
+};
+
+/// Frames the receive callback dropped as foreign (see setForeignFilter)
+struct ForeignTrafficStats {
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    uint32_t airUs = 0;             ///< Same estimate as AirtimeStats
+    uint8_t lastMac[6] = {};        ///< Sender of the latest one
+};
+
 // -----------------------------------------------------------------------------
 // Simple ESP-NOW discovery helper that implements a controller/controlled
 // pairing workflow with identity exchange.
@@ -74,15 +128,36 @@ struct CommandPacket {
 
 class EspNowDiscovery {
 public:
+    EspNowDiscovery() {
+        memset(peerMap, kSlotEmpty, sizeof(peerMap));
+        memset(peerRanks, -1, sizeof(peerRanks));
+    }
+
     void begin();
     void discover();
-    bool handleIncoming(const uint8_t *mac, const uint8_t *incomingData, int len);
+    bool handleIncoming(const uint8_t *mac, const uint8_t *incomingData, int len, uint32_t rxUs = 0);
     bool hasPeers() const;
     int  getPeerCount() const { return peerCount; }
     const uint8_t* getPeer(int index) const;
     const char* getPeerName(int index) const;
     const Identity* getPeerIdentity(int index) const;
     int findPeerIndex(const uint8_t* mac) const;
+
+    // Ranked view of the peer table for device lists: peers heard within
+    // kRankFadingMs first, then strongest RSSI (LinkMetrics, taken in
+    // kRankRssiStepDb steps so jitter does not reshuffle the list), then
+    // discovery order. The owning task keeps it sorted as peers arrive,
+    // expire or change rank; getRankedPeers() copies a window of peer
+    // indices (for getPeer() and friends) consistently from any task, and
+    // getRankVersion() changes whenever the order does.
+    static constexpr uint32_t kRankRefreshMs = 500;
+    static constexpr uint32_t kRankFadingMs = 10000;
+    static constexpr int16_t kRankRssiStepDb = 4;
+    static constexpr int8_t kNoRssi = -128;
+    int getRankedPeers(int firstRank, int8_t* indices, int maxCount) const;
+    int getPeerRank(int index) const;
+    int8_t getPeerRssi(int index) const;
+    uint32_t getRankVersion() const { return rankVersion.load(std::memory_order_acquire) >> 1; }
     bool sendCommand(const uint8_t* mac, const char* command);
     void resetLinkState();
     bool isPaired() const;
@@ -96,12 +171,114 @@ public:
     bool isContinuousScanning() const;
     void setAutoPairEnabled(bool enabled);
     bool isAutoPairEnabled() const;
+
+    // Passive listening: never broadcast PAIR_REQ; learn robots only from
+    // frames they send on their own (identity broadcasts, keepalives).
+    void setPassiveListening(bool enabled);
+    bool isPassiveListening() const { return passiveListening; }
+    uint32_t getBroadcastIntervalMs() const { return broadcastIntervalMs; }
+
+    // Link pings to the paired peer (LinkMetrics RTT and loss); 0 disables.
+    void setPingInterval(uint32_t intervalMs) { pingIntervalMs = intervalMs; }
+    uint32_t getPingInterval() const { return pingIntervalMs; }
+
+    // Airtime accounting. Index 0 collects frames that are not discovery
+    // packets (telemetry and other module traffic); 1-12 are MessageType.
+    static constexpr size_t kAirtimeSlots = 13;
+    const AirtimeStats& getAirtimeStats(size_t slot) const;
+    void resetAirtimeStats();
+    void dumpAirtime(Print& out) const;
+    /// 1 Mbit/s long-preamble estimate including ESP-NOW framing
+    static uint32_t estimateAirtimeUs(size_t payloadBytes);
+
+    // Foreign traffic filter. Other teams' devices on the channel send
+    // frames nobody here uses; with the filter on, the receive callback
+    // drops anything that is neither a discovery packet nor from a peer in
+    // the table before it is copied into the ring. Peers are checked
+    // against a 64-bit Bloom set of their MAC hashes, so a false positive
+    // only costs the old path (the router drops it).
+    void setForeignFilter(bool enabled) { foreignFilter = enabled; }
+    bool isForeignFilterEnabled() const { return foreignFilter; }
+    ForeignTrafficStats getForeignStats() const { return foreign; }
+
+    // Channel moves. The controller announces MSG_CHANNEL to the paired and
+    // team peers on every discovery tick until the switch time; both sides
+    // then switch and send keepalives, and either side goes back to the old
+    // channel if it hears nothing from its peer within kChannelRecoverMs.
+    // Refused while the softAP runs, since the AP owns the channel then.
+    // With auto channel on, an unpaired robot walks kChannelCandidates until
+    // it hears a pair request, and an unpaired controller keeps its
+    // broadcasts frequent enough for that walk.
+    static constexpr uint32_t kChannelSwitchDelayMs = 300;
+    static constexpr uint32_t kChannelRecoverMs = 2000;
+    static constexpr uint32_t kChannelSearchDwellMs = 1200;
+    static constexpr uint32_t kChannelSearchBroadcastMs = 1000;
+    void setAutoChannel(bool enabled) { autoChannel = enabled; }
+    bool isAutoChannel() const { return autoChannel; }
+    bool requestChannelSwitch(uint8_t channel);     // Controller only
+    bool isChannelSwitchPending() const { return channelMove.target != 0 || channelMove.switchedMs != 0; }
+    static uint8_t getChannel();
+    uint32_t getChannelSwitches() const { return channelSwitches; }
+    uint32_t getChannelReverts() const { return channelReverts; }
+
+    // TDMA slot beacon (broadcast); see TdmaSlots for the fields
+    bool sendSlotBeacon(uint32_t offsetUs, uint32_t info);
     bool beginPairingWith(const uint8_t* mac);
+    // Resume a link from an earlier boot without the identity exchange: the
+    // peer counts as paired at once, and PAIR_CONFIRM is repeated until it
+    // acks (a robot that rebooted too pairs back). A peer that never answers
+    // goes stale and drops the link as usual.
+    bool restorePairing(const uint8_t* mac, const char* customId, uint32_t sessionToken = 0);
+
+    // Session resume. Every PAIR_CONFIRM carries a fresh session token in
+    // `reserved`, and both sides keep it with the peer's MAC. The side that
+    // still holds the session sends MSG_RESUME (unicast, repeated with
+    // backoff); a peer holding the same session answers MSG_RESUME_ACK and
+    // the link is back without the broadcast and identity exchange. A peer
+    // that lost the session answers with token 0, and the controller sends
+    // a new PAIR_CONFIRM at once. The controller resumes on its own when
+    // the paired peer goes silent for several of its usual frame gaps (at
+    // least kResumeSilenceMs); a robot calls resumeSession(), e.g. at boot
+    // after setSession() restored the session from flash.
+    static constexpr uint32_t kResumeSilenceMs = 300;
+    static constexpr uint32_t kResumeRetryMs = 100;
+    static constexpr uint32_t kResumeMaxRetryMs = 1000;
+    void setSession(const uint8_t* mac, uint32_t token);
+    uint32_t getSessionToken() const { return session.token; }
+    const uint8_t* getSessionMac() const { return session.mac; }
+    bool resumeSession();
+    ResumeStats getResumeStats() const { return resume; }
+    void dumpSession(Print& out) const;
+
+    // Team links: extra robots driven next to the paired peer. Each gets a
+    // PAIR_CONFIRM (repeated until acked) and keepalives like the main link;
+    // a team peer that goes stale loses its link. The main link is not
+    // affected by any of these.
+    static constexpr int kMaxTeamLinks = 2;
+    bool addTeamLink(const uint8_t* mac);
+    bool removeTeamLink(const uint8_t* mac);
+    bool isTeamLink(const uint8_t* mac) const;
+
+    // Trainer link: the other controller of a TrainerLink pair. It is not a
+    // robot, so it never enters the peer table; it is registered with
+    // ESP-NOW and passed by the foreign filter instead. nullptr removes it.
+    bool setTrainerPeer(const uint8_t* mac);
+    const uint8_t* getTrainerPeer() const;
+    bool isTeamLinkAcked(const uint8_t* mac) const;
     void setCommandCallback(void (*callback)(const char* message));
 
+    // Receive path. The ESP-NOW callback only copies frames into the ring;
+    // drainReceived() runs the protocol handler for each frame on the caller's
+    // task and hands anything that is not a discovery packet to `unhandled`.
+    void setReceiveTask(TaskHandle_t task);
+    size_t drainReceived(size_t maxFrames, void (*unhandled)(const RxFrame& frame));
+    RxRing& getReceiveRing() { return rxRing; }
+    void notifyReceiveTask();   // For producers other than the ESP-NOW callback
+
     // Utility helpers.
     static void macToString(const uint8_t* mac, char* buffer, size_t bufferLen);
     static bool macEqual(const uint8_t* a, const uint8_t* b);
+    static bool macFromString(const char* text, uint8_t* mac);   // "AA:BB:CC:DD:EE:FF"
 
 private:
     struct PeerEntry {
@@ -111,6 +288,25 @@ private:
         uint32_t lastSeen = 0;
         bool confirmed = false;
         bool acked = false;
+        int8_t rssiDbm = kNoRssi;       ///< Ranked RSSI (moves in kRankRssiStepDb steps)
+        bool fading = false;            ///< Not heard for kRankFadingMs
+        uint16_t discoveryOrder = 0;
+    };
+
+    struct TeamLink {
+        bool inUse = false;
+        uint8_t mac[6] = {};
+        bool awaitingAck = false;
+        uint32_t lastConfirmSentMs = 0;
+        uint32_t lastKeepaliveMs = 0;
+    };
+
+    struct ChannelMove {
+        uint8_t target = 0;             ///< Announced channel; 0 = none
+        uint8_t previous = 0;           ///< Where to go back to
+        uint32_t switchAtMs = 0;
+        uint32_t switchedMs = 0;        ///< Waiting to hear the peer since; 0 = not
+        uint32_t lastKeepaliveMs = 0;
     };
 
     struct LinkState {
@@ -120,30 +316,127 @@ private:
         uint32_t lastActivityMs = 0;
         uint32_t lastConfirmSentMs = 0;
         uint32_t lastKeepaliveMs = 0;
-        bool awaitingAck = false;
+        bool awaitingAck = false;       ///< PAIR_ACK, or MSG_RESUME_ACK while resuming
+        bool resuming = false;          ///< Repeats send MSG_RESUME instead of PAIR_CONFIRM
+        uint32_t resumeStartMs = 0;
+        uint32_t resumeRetryMs = 0;
+        uint32_t gapAvgMs = 0;          ///< Usual time between the peer's frames (1/8 average)
     };
 
-    static constexpr int kMaxPeers = 8;
+    struct Session {
+        uint8_t mac[6] = {};
+        uint32_t token = 0;             ///< 0 = none
+    };
+
+    static constexpr int kMaxPeers = 32;
     static constexpr uint8_t kProtocolVersion = 1;
 
+    // Open-addressed MAC -> peer index map (linear probing, power-of-2 size,
+    // at most half full). Deleted slots stay as tombstones until the map is
+    // rebuilt.
+    static constexpr int kPeerMapSize = 64;
+    static constexpr int8_t kSlotEmpty = -1;
+    static constexpr int8_t kSlotDeleted = -2;
+
     void fillSelfIdentity();
     bool ensurePeer(const uint8_t* mac) const;
     bool sendPacket(MessageType type, const uint8_t* mac);
+    bool sendPacket(MessageType type, const uint8_t* mac, uint32_t stamp, uint32_t reserved);
+    bool sendPong(const uint8_t* mac, const Packet& ping, uint32_t pingRxUs);
+    bool transmit(MessageType type, const uint8_t* mac, const uint8_t* frame, size_t size);
+    void sendPing(uint32_t now);
     int upsertPeer(const Identity& id, const uint8_t* mac, uint32_t now);
     void pruneExpiredPeers(uint32_t now);
     int selectTarget() const;
     void resetLink();
-    int computePeerCount() const;
+    TeamLink* findTeamLink(const uint8_t* mac);
+    const TeamLink* findTeamLink(const uint8_t* mac) const;
+    void serviceTeamLinks(uint32_t now);
+    static uint32_t macHash(const uint8_t* mac);
+    int lookupPeer(const uint8_t* mac) const;
+    void mapInsert(int index);
+    void mapPlace(int index);
+    void mapErase(int index);
+    void rebuildPeerMap(int except = -1);
+    bool outranks(int a, int b) const;
+    void beginRankUpdate();
+    void endRankUpdate();
+    void siftRank(int index);
+    void rankInsert(int index);
+    void rankErase(int index);
+    void rankUpdate(int index);
+    void refreshPeerRanks(uint32_t now);
+    static uint32_t peerFilterBits(const uint8_t* mac, int word);
+    bool acceptsFrame(const uint8_t* mac, const uint8_t* data, int len) const;
+    void clearPeers();
+    void resetBroadcastBackoff();
+    static uint32_t newSessionToken();
+    void startResume(uint32_t now);
+    void retryResume(uint32_t now);
+    void handleResume(const uint8_t* mac, const Packet& packet, uint32_t now);
+    void handleResumeAck(const uint8_t* mac, const Packet& packet, uint32_t now);
+    void completeResume(const uint8_t* mac, const Packet& packet, uint32_t now);
+    void scheduleChannelMove(uint8_t channel, uint32_t switchAtMs);
+    void announceChannel(uint32_t now);
+    void serviceChannel(uint32_t now);
+    static bool setRadioChannel(uint8_t channel);
+    void recordTx(MessageType type, size_t bytes);
+    void recordRx(size_t slot, size_t bytes);
 
     Identity selfIdentity{};
     PeerEntry peers[kMaxPeers] = {};
+    // The peer table has two writers, RxTask (upsertPeer) and ServiceTask
+    // (pruneExpiredPeers, refreshPeerRanks, restorePairing). Slot claims,
+    // peerCount, the map and its tombstones, nextExpiryMs and the ranked
+    // view change only under this lock; logging and events happen after it.
+    mutable portMUX_TYPE peerLock = portMUX_INITIALIZER_UNLOCKED;
     int peerCount = 0;
+    int8_t peerMap[kPeerMapSize];
+    int peerMapDeleted = 0;
+    // Ranked view: rank -> peer index and back. rankVersion is odd while a
+    // writer holding peerLock rewrites it (sequence lock for getRankedPeers)
+    int8_t rankedPeers[kMaxPeers] = {};
+    int8_t peerRanks[kMaxPeers];
+    int rankedCount = 0;
+    std::atomic<uint32_t> rankVersion{0};
+    uint16_t nextDiscoveryOrder = 0;
+    uint32_t lastRankRefreshMs = 0;
+    // No peer can expire before this time; lastSeen only moves forward, so
+    // pruning sleeps until the oldest peer could be stale
+    uint32_t nextExpiryMs = 0;
     LinkState link{};
+    TeamLink teamLinks[kMaxTeamLinks] = {};
     uint32_t lastBroadcastMs = 0;
+    uint32_t broadcastIntervalMs = BROADCAST_MIN_INTERVAL_MS;
+    bool discoveredSinceBroadcast = false;
+    bool passiveListening = false;
+    uint32_t pingIntervalMs = 0;
+    uint32_t lastPingMs = 0;
+    uint32_t pingSequence = 0;
+    AirtimeStats airtime[kAirtimeSlots];
+    ChannelMove channelMove{};
+    Session session{};
+    ResumeStats resume;
+    bool autoChannel = false;
+    uint32_t lastChannelSearchMs = 0;
+    uint32_t channelSwitches = 0;
+    uint32_t channelReverts = 0;
     bool discoveryEnabled = true;
     bool continuousScanning = false;  // Keep scanning even when paired
     bool autoPairingEnabled = true;
     void (*commandCallback)(const char* message) = nullptr;
+    RxRing rxRing;
+    TaskHandle_t rxTask = nullptr;
+    // Bloom set of peer MACs: written under peerLock, read by
+    // the receive callback. Removal rebuilds it, so a present peer is never
+    // missing from either word.
+    std::atomic<uint32_t> peerFilter[2] = {};
+    bool foreignFilter = false;
+    uint8_t trainerMac[6] = {};
+    std::atomic<bool> hasTrainerPeer{false};    // Set after trainerMac is written
+    ForeignTrafficStats foreign;    // Receive callback only
+
+    friend void onEspNowDataRecv(const uint8_t* mac, const uint8_t* incomingData, int len);
 };
 
 #endif // ESPNOW_DISCOVERY_H
@@ -30,7 +30,7 @@ extern volatile bool button2State;
 extern volatile bool button3State;
 extern volatile bool joystickBtnAState;
 extern volatile bool encoderBtnState;
-extern volatile int encoderCount;
+extern volatile int encoderCount;  ///< Absolute detents, mirrored by EncoderSampler (read-only)
 extern volatile unsigned long button1Millis;
 extern volatile unsigned long button2Millis;
 extern volatile unsigned long button3Millis;
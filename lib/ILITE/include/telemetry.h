@@ -1,5 +1,7 @@
 #pragma once
 #include <Arduino.h>
+#include "RingSeries.h"
+#include <atomic>
 
 constexpr int screen_Width = 128;
 constexpr int screen_Height = 64;
@@ -55,8 +57,19 @@ extern BulkyCommand bulkyCommand;
 extern WifiControlCommand wifiControlCommand;
 extern uint8_t droneStabilizationMask;
 extern bool droneStabilizationGlobal;
-extern int16_t pidCorrectionHistory[PID_AXIS_COUNT][screen_Width];
-extern int16_t pidActualHistory[PID_AXIS_COUNT][screen_Width];
-extern int16_t pidTargetHistory[PID_AXIS_COUNT][screen_Width];
-extern int16_t pidErrorHistory[PID_AXIS_COUNT][screen_Width];
+// Scrolling per-axis PID traces, one sample per telemetry packet. Allocated
+// by the first appendPidSample(), so builds that never record a PID sample
+// don't keep ~3 KB of history resident. The receive path publishes the
+// pointer with release order; readers load it with acquire order.
+using PidHistory = RingSeries<int16_t, screen_Width>;
+struct PidHistories {
+  PidHistory correction[PID_AXIS_COUNT];
+  PidHistory actual[PID_AXIS_COUNT];
+  PidHistory target[PID_AXIS_COUNT];
+  PidHistory error[PID_AXIS_COUNT];
+};
+extern std::atomic<PidHistories*> pidHistories;  // nullptr until the first sample
 void appendPidSample();
+// Free the histories (module deactivation, after the handoff grace period,
+// so no reader is still drawing them)
+void releasePidHistories();
@@ -1,12 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
-
-// Forward declarations
-namespace IKEngine {
-    struct Vec3;
-    class InverseKinematics;
-}
+#include "InverseKinematics.h"
 
 constexpr uint32_t THEGILL_PACKET_MAGIC = 0x54474C4C; // 'TGLL'
 
@@ -171,12 +166,13 @@ extern ThegillCommand thegillCommand;
 extern PeripheralCommand thegillPeripheralCommand;
 extern ConfigurationPacket thegillConfigurationPacket;
 extern SettingsPacket thegillSettingsPacket;
-extern StatusPacket thegillStatusPacket;
-extern ArmStatePacket thegillArmStatePacket;
 extern ThegillConfig thegillConfig;
 extern ThegillRuntime thegillRuntime;
 
-void updateThegillControl();
+class InputManager;
+
+/// One control tick: read, intent, kinematics and pack stages (CommTask)
+void updateThegillControl(const InputManager& inputs, float dt);
 
 // ============================================================================
 // Mech'Iane Arm Control
@@ -222,6 +218,29 @@ struct ArmControlCommand {
     uint8_t reserved;
 } __attribute__((packed));
 
+constexpr uint32_t ARM_TRAJECTORY_MAGIC = 0x5447544A; // 'TGTJ'
+constexpr size_t kArmTrajectoryAxes = 7;   // Extension, Base, Shoulder, Elbow, Pitch, Roll, Yaw
+constexpr size_t kArmTrajectoryKnots = 3;
+constexpr float kArmTrajectoryPositionScale = 50.0f;  // Counts per degree (extension: per mm)
+constexpr float kArmTrajectoryVelocityScale = 10.0f;  // Counts per degree/s (extension: per mm/s)
+
+// Joint state at one knot of a streamed trajectory
+struct ArmTrajectoryKnot {
+    int16_t position[kArmTrajectoryAxes];
+    int16_t velocity[kArmTrajectoryAxes];
+} __attribute__((packed));
+
+// Cubic Hermite spline through knots segmentMs apart; knot 0 is "now"
+struct ArmTrajectoryPacket {
+    uint32_t magic;
+    uint16_t sequence;
+    uint16_t segmentMs;
+    uint16_t validMask;     // ArmCommandMask bits of the axes carried
+    uint8_t flags;          // ArmCommandFlag bits
+    uint8_t knotCount;
+    ArmTrajectoryKnot knots[kArmTrajectoryKnots];
+} __attribute__((packed));
+
 // Control modes for Mech'Iane
 enum class MechIaneMode : uint8_t {
     DriveMode = 0,    // Normal drivetrain control
@@ -274,6 +293,11 @@ bool acquirePeripheralCommand(PeripheralCommand& out);
 bool acquireConfigurationPacket(ConfigurationPacket& out);
 bool acquireSettingsPacket(SettingsPacket& out);
 bool acquireArmCommand(ArmControlCommand& out);
+bool acquireArmTrajectory(ArmTrajectoryPacket& out);
+void setArmTrajectoryStreaming(bool enabled);
+bool isArmTrajectoryStreaming();
+/// Wheel speed as a fraction of full speed (motor bars), clamped to +/-1.2
+float thegillWheelFraction(int16_t wheelSpeedMmPerSec);
 void processStatusPacket(const StatusPacket& packet);
 void processArmStatePacket(const ArmStatePacket& packet);
 void queueStatusRequest();
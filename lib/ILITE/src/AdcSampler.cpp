@@ -0,0 +1,221 @@
+/**
+ * @file AdcSampler.cpp
+ * @brief ADC1 continuous (DMA) sampling implementation
+ */
+
+#include "AdcSampler.h"
+#include "input.h"
+#include "TaskMonitor.h"
+#include <driver/adc.h>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kChannelPins[AdcSampler::CHANNEL_COUNT] = {
+    joystickA_X, joystickA_Y, joystickB_X, joystickB_Y, potA, batteryPin
+};
+
+constexpr uint32_t kFrameBytes = 256;   // 128 conversions per DMA frame
+constexpr uint32_t kStoreBytes = 1024;  // Driver ring buffer (4 frames)
+
+}  // namespace
+
+// ============================================================================
+// Singleton
+// ============================================================================
+
+AdcSampler& AdcSampler::getInstance() {
+    static AdcSampler instance;
+    return instance;
+}
+
+AdcSampler::AdcSampler()
+    : taskHandle_(nullptr),
+      running_(false),
+      sampleCount_(0)
+{
+    lock_ = portMUX_INITIALIZER_UNLOCKED;
+    memset(acc_, 0, sizeof(acc_));
+    memset(last_, 0, sizeof(last_));
+    memset(channelMap_, -1, sizeof(channelMap_));
+}
+
+uint8_t AdcSampler::pinFor(Channel channel) {
+    return channel < CHANNEL_COUNT ? kChannelPins[channel] : 0;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool AdcSampler::begin() {
+    if (running_) {
+        return true;
+    }
+
+    adc_digi_pattern_config_t pattern[CHANNEL_COUNT] = {};
+    uint32_t channelMask = 0;
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        int8_t hwChannel = digitalPinToAnalogChannel(kChannelPins[i]);
+        // Only ADC1 (channels 0-7) supports DMA alongside WiFi
+        if (hwChannel < 0 || hwChannel > 7) {
+            Serial.printf("[AdcSampler] GPIO %d is not on ADC1\n", kChannelPins[i]);
+            return false;
+        }
+        channelMap_[hwChannel] = static_cast<int8_t>(i);
+        channelMask |= (1u << hwChannel);
+
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = static_cast<uint8_t>(hwChannel);
+        pattern[i].unit = 0;  // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+        // Seed with a one-shot read so early latches are sensible
+        last_[i] = analogRead(kChannelPins[i]);
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = kStoreBytes;
+    initConfig.conv_num_each_intr = kFrameBytes;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+
+    if (adc_digi_initialize(&initConfig) != ESP_OK) {
+        Serial.println("[AdcSampler] adc_digi_initialize failed");
+        return false;
+    }
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = true;    // Required on ESP32 (I2S-based DMA)
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = CHANNEL_COUNT;
+    digiConfig.adc_pattern = pattern;
+    digiConfig.sample_freq_hz = kSampleRateHz;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&digiConfig) != ESP_OK) {
+        Serial.println("[AdcSampler] adc_digi_controller_configure failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    if (adc_digi_start() != ESP_OK) {
+        Serial.println("[AdcSampler] adc_digi_start failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    running_ = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        readerTask,
+        "AdcSampler",
+        3072,
+        this,
+        2,          // Above DisplayTask; mostly blocked on DMA
+        &taskHandle_,
+        1           // Core 1 keeps core 0 free for radio + control
+    );
+
+    if (result != pdPASS) {
+        Serial.println("[AdcSampler] Failed to create reader task");
+        running_ = false;
+        taskHandle_ = nullptr;
+        adc_digi_stop();
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    TaskMonitor::watch(taskHandle_, 3072, 1);
+
+    Serial.printf("[AdcSampler] DMA sampling %u channels at %lu Hz\n",
+                  CHANNEL_COUNT, static_cast<unsigned long>(kSampleRateHz));
+    return true;
+}
+
+void AdcSampler::end() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+    // Reader exits on its own after its current read times out
+    for (int i = 0; i < 20 && taskHandle_ != nullptr; ++i) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    adc_digi_stop();
+    adc_digi_deinitialize();
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void AdcSampler::readerTask(void* parameter) {
+    AdcSampler* self = static_cast<AdcSampler*>(parameter);
+    uint8_t buffer[kFrameBytes];
+
+    while (self->running_) {
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(buffer, sizeof(buffer), &length, 100);
+        // ESP_ERR_INVALID_STATE means the driver buffer overflowed; the data
+        // we got is still valid, we just lost some older conversions.
+        if ((err == ESP_OK || err == ESP_ERR_INVALID_STATE) && length > 0) {
+            self->accumulate(buffer, length);
+        }
+    }
+
+    self->taskHandle_ = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void AdcSampler::accumulate(const uint8_t* buffer, uint32_t length) {
+    Accumulator local[CHANNEL_COUNT] = {};
+    uint32_t converted = 0;
+
+    for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length;
+         i += sizeof(adc_digi_output_data_t)) {
+        adc_digi_output_data_t sample;
+        memcpy(&sample, buffer + i, sizeof(sample));
+        uint8_t hwChannel = sample.type1.channel;
+        if (hwChannel >= 16 || channelMap_[hwChannel] < 0) {
+            continue;
+        }
+        Accumulator& a = local[channelMap_[hwChannel]];
+        a.sum += sample.type1.data;
+        a.count++;
+        converted++;
+    }
+
+    portENTER_CRITICAL(&lock_);
+    for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+        // Nobody latched for a while: halve to keep the average without overflow
+        if (acc_[c].count > 0x8000) {
+            acc_[c].sum >>= 1;
+            acc_[c].count >>= 1;
+        }
+        acc_[c].sum += local[c].sum;
+        acc_[c].count += local[c].count;
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    sampleCount_ += converted;
+}
+
+void AdcSampler::latch(uint16_t out[CHANNEL_COUNT]) {
+    Accumulator taken[CHANNEL_COUNT];
+
+    portENTER_CRITICAL(&lock_);
+    memcpy(taken, acc_, sizeof(taken));
+    memset(acc_, 0, sizeof(acc_));
+    portEXIT_CRITICAL(&lock_);
+
+    for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+        if (taken[c].count > 0) {
+            last_[c] = static_cast<uint16_t>(taken[c].sum / taken[c].count);
+        }
+        out[c] = last_[c];
+    }
+}
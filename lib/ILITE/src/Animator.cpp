@@ -0,0 +1,136 @@
+/**
+ * @file Animator.cpp
+ * @brief Step accumulator, Q16 easing and tween evaluation
+ */
+
+#include "Animator.h"
+
+uint32_t Animator::lastMs_ = 0;
+uint32_t Animator::accumulatorMs_ = 0;
+uint32_t Animator::steps_ = 0;
+int32_t Animator::alpha_ = 0;
+bool Animator::started_ = false;
+bool Animator::alive_ = false;
+uint32_t Animator::animatedFrames_ = 0;
+
+namespace {
+
+inline int32_t mulQ16(int32_t a, int32_t b) {
+    return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 16);
+}
+
+}  // namespace
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+void Animator::beginFrame(uint32_t nowMs) {
+    alive_ = false;
+    if (!started_) {
+        started_ = true;
+        lastMs_ = nowMs;
+        return;
+    }
+
+    uint32_t deltaMs = nowMs - lastMs_;
+    lastMs_ = nowMs;
+    if (deltaMs > kMaxFrameMs) {
+        deltaMs = kMaxFrameMs;
+    }
+
+    accumulatorMs_ += deltaMs;
+    steps_ += accumulatorMs_ / kStepMs;
+    accumulatorMs_ %= kStepMs;
+    alpha_ = static_cast<int32_t>(accumulatorMs_ * kOne / kStepMs);
+}
+
+bool Animator::endFrame() {
+    if (alive_) {
+        animatedFrames_++;
+    }
+    return alive_;
+}
+
+int32_t Animator::ease(Ease curve, int32_t t) {
+    if (t <= 0) {
+        return 0;
+    }
+    if (t >= kOne) {
+        return kOne;
+    }
+
+    switch (curve) {
+        case Ease::Linear:
+            return t;
+        case Ease::OutCubic: {
+            // 1 - (1 - t)^3
+            const int32_t u = kOne - t;
+            return kOne - mulQ16(mulQ16(u, u), u);
+        }
+        case Ease::InOutCubic: {
+            // 4t^3 below one half, 1 - (2 - 2t)^3 / 2 above
+            if (t < kOne / 2) {
+                return 4 * mulQ16(mulQ16(t, t), t);
+            }
+            const int32_t u = 2 * (kOne - t);
+            return kOne - mulQ16(mulQ16(u, u), u) / 2;
+        }
+    }
+    return t;
+}
+
+// ============================================================================
+// Tween
+// ============================================================================
+
+Tween::Tween(uint16_t durationMs, Ease curve)
+    : durationSteps_(static_cast<uint16_t>((durationMs + Animator::kStepMs - 1) / Animator::kStepMs)),
+      curve_(curve)
+{
+}
+
+void Tween::snap(int32_t value) {
+    from_ = value;
+    to_ = value;
+    running_ = false;
+}
+
+void Tween::retarget(int32_t target) {
+    if (target == to_) {
+        return;
+    }
+    // Start from wherever the value is now, so a retarget mid-flight bends
+    // the motion instead of restarting it
+    const int32_t t = running_ ? Animator::ease(curve_, progress()) : Animator::kOne;
+    from_ = from_ + static_cast<int32_t>((static_cast<int64_t>(to_ - from_) * t) >> 16);
+    to_ = target;
+    startStep_ = Animator::getSteps();
+    startAlpha_ = Animator::getAlpha();
+    running_ = durationSteps_ > 0;
+}
+
+int32_t Tween::value() {
+    if (!running_) {
+        return to_;
+    }
+    const int32_t t = progress();
+    if (t >= Animator::kOne) {
+        running_ = false;
+        return to_;
+    }
+    Animator::keepAlive();
+    const int64_t span = static_cast<int64_t>(to_ - from_) * Animator::ease(curve_, t);
+    return from_ + static_cast<int32_t>((span + Animator::kOne / 2) >> 16);
+}
+
+int32_t Tween::progress() const {
+    const uint32_t elapsedSteps = Animator::getSteps() - startStep_;
+    if (elapsedSteps > durationSteps_) {
+        return Animator::kOne;
+    }
+    // Whole steps plus the alpha of this frame, relative to the start's alpha
+    const int32_t elapsed = static_cast<int32_t>(elapsedSteps << 16) + Animator::getAlpha() - startAlpha_;
+    const int32_t t = elapsed / durationSteps_;
+    return t < 0 ? 0 : t;
+}
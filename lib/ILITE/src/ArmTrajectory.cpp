@@ -0,0 +1,242 @@
+/**
+ * @file ArmTrajectory.cpp
+ * @brief Jerk-limited joint following and trajectory packet encoding
+ */
+
+#include "ArmTrajectory.h"
+#include <math.h>
+#include <cstring>
+
+static_assert(ArmTrajectoryPlanner::AXIS_COUNT == kArmTrajectoryAxes,
+              "Planner axes must match ArmTrajectoryKnot");
+
+namespace {
+
+// Defaults sized for the hobby servos; base and extension are geared slower
+constexpr ArmTrajectoryPlanner::AxisLimits kDefaultLimits[ArmTrajectoryPlanner::AXIS_COUNT] = {
+    {0.0f, 130.0f, 80.0f, 400.0f, 4000.0f},     // Extension (mm)
+    {0.0f, 360.0f, 90.0f, 360.0f, 3600.0f},     // Base
+    {0.0f, 180.0f, 150.0f, 900.0f, 9000.0f},    // Shoulder
+    {0.0f, 180.0f, 150.0f, 900.0f, 9000.0f},    // Elbow
+    {0.0f, 180.0f, 240.0f, 1200.0f, 12000.0f},  // Pitch
+    {0.0f, 180.0f, 240.0f, 1200.0f, 12000.0f},  // Roll
+    {0.0f, 180.0f, 240.0f, 1200.0f, 12000.0f},  // Yaw
+};
+
+constexpr float kSettledPosition = 0.02f;
+constexpr float kSettledVelocity = 0.05f;
+
+inline float clampf(float value, float lo, float hi) {
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+inline void orderRange(float& lo, float& hi) {
+    if (lo > hi) {
+        const float t = lo;
+        lo = hi;
+        hi = t;
+    }
+}
+
+}  // namespace
+
+ArmTrajectoryPlanner::ArmTrajectoryPlanner()
+    : pendingSeconds_(0.0f),
+      lastSendMs_(0),
+      sequence_(0),
+      initialized_(false),
+      lastSentSettled_(false)
+{
+    memcpy(limits_, kDefaultLimits, sizeof(limits_));
+    memset(state_, 0, sizeof(state_));
+    memset(goal_, 0, sizeof(goal_));
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void ArmTrajectoryPlanner::configure(const IKEngine::IKConfiguration& config) {
+    const IKEngine::JointLimits* joints[AXIS_COUNT] = {
+        nullptr, &config.baseYaw, &config.shoulder, &config.elbow,
+        &config.gripperPitch, &config.gripperRoll, &config.gripperYaw
+    };
+    for (size_t i = 0; i < AXIS_COUNT; ++i) {
+        AxisLimits& limits = limits_[i];
+        if (joints[i] != nullptr) {
+            limits.minPosition = joints[i]->minDeg;
+            limits.maxPosition = joints[i]->maxDeg;
+        } else {
+            limits.minPosition = config.elbowExtension.minMm;
+            limits.maxPosition = config.elbowExtension.maxMm;
+        }
+        orderRange(limits.minPosition, limits.maxPosition);
+    }
+}
+
+void ArmTrajectoryPlanner::setAxisLimits(Axis axis, const AxisLimits& limits) {
+    if (axis >= AXIS_COUNT) {
+        return;
+    }
+    AxisLimits& target = limits_[axis];
+    target = limits;
+    orderRange(target.minPosition, target.maxPosition);
+    target.maxVelocity = fmaxf(target.maxVelocity, 1e-3f);
+    target.maxAcceleration = fmaxf(target.maxAcceleration, 1e-3f);
+    target.maxJerk = fmaxf(target.maxJerk, 1e-3f);
+}
+
+void ArmTrajectoryPlanner::fromCommand(const ArmControlCommand& command, float out[AXIS_COUNT]) {
+    out[EXTENSION] = command.extensionMillimeters;
+    out[BASE] = command.baseDegrees;
+    out[SHOULDER] = command.shoulderDegrees;
+    out[ELBOW] = command.elbowDegrees;
+    out[PITCH] = command.pitchDegrees;
+    out[ROLL] = command.rollDegrees;
+    out[YAW] = command.yawDegrees;
+}
+
+// ============================================================================
+// Planning
+// ============================================================================
+
+void ArmTrajectoryPlanner::reset(const float positions[AXIS_COUNT]) {
+    for (size_t i = 0; i < AXIS_COUNT; ++i) {
+        const float position = clampf(positions[i], limits_[i].minPosition, limits_[i].maxPosition);
+        state_[i] = AxisState{position, 0.0f, 0.0f};
+        goal_[i] = position;
+    }
+    pendingSeconds_ = 0.0f;
+    initialized_ = true;
+    lastSentSettled_ = false;   // Announce the new pose right away
+}
+
+void ArmTrajectoryPlanner::setGoal(const float positions[AXIS_COUNT]) {
+    if (!initialized_) {
+        reset(positions);
+        return;
+    }
+    for (size_t i = 0; i < AXIS_COUNT; ++i) {
+        goal_[i] = clampf(positions[i], limits_[i].minPosition, limits_[i].maxPosition);
+    }
+}
+
+void ArmTrajectoryPlanner::update(float dtSeconds) {
+    if (!initialized_ || !(dtSeconds > 0.0f)) {
+        return;
+    }
+    // A long stall (menus, link drop) should not replay as a burst of steps
+    pendingSeconds_ += fminf(dtSeconds, 0.25f);
+    const int steps = static_cast<int>(pendingSeconds_ / kStepSeconds);
+    pendingSeconds_ -= steps * kStepSeconds;
+    for (int s = 0; s < steps; ++s) {
+        for (size_t i = 0; i < AXIS_COUNT; ++i) {
+            step(limits_[i], goal_[i], state_[i], kStepSeconds);
+        }
+    }
+}
+
+void ArmTrajectoryPlanner::step(const AxisLimits& limits, float goal, AxisState& state, float dt) {
+    const float error = goal - state.position;
+    if (fabsf(error) < kSettledPosition && fabsf(state.velocity) < kSettledVelocity) {
+        state = AxisState{goal, 0.0f, 0.0f};
+        return;
+    }
+
+    const float vMax = limits.maxVelocity;
+    const float aMax = limits.maxAcceleration;
+    // Time for the acceleration to swing across its range at maxJerk
+    const float tau = fmaxf(aMax / limits.maxJerk, 2.0f * dt);
+
+    // Fastest velocity that still brakes onto the goal at 80% of
+    // maxAcceleration (the rest absorbs the jerk ramp): a sqrt profile far
+    // away, blending into a linear one with gain 1/(3 tau) near the goal.
+    // Overshoot stays below 0.1 deg with the default limits.
+    const float brake = 0.8f * aMax;
+    const float c = 3.0f * brake * tau;
+    float vTarget = sqrtf(2.0f * brake * fabsf(error) + c * c) - c;
+    if (vTarget > vMax) vTarget = vMax;
+    vTarget = copysignf(vTarget, error);
+
+    const float aTarget = clampf((vTarget - state.velocity) / tau, -aMax, aMax);
+    const float jerkMax = limits.maxJerk;
+    const float jerk = clampf((aTarget - state.acceleration) / dt, -jerkMax, jerkMax);
+
+    state.acceleration += jerk * dt;
+    state.velocity = clampf(state.velocity + state.acceleration * dt, -vMax, vMax);
+    state.position += state.velocity * dt;
+
+    if (state.position < limits.minPosition || state.position > limits.maxPosition) {
+        state.position = clampf(state.position, limits.minPosition, limits.maxPosition);
+        state.velocity = 0.0f;
+        state.acceleration = 0.0f;
+    }
+}
+
+bool ArmTrajectoryPlanner::isSettled() const {
+    for (size_t i = 0; i < AXIS_COUNT; ++i) {
+        if (state_[i].position != goal_[i] || state_[i].velocity != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ArmTrajectoryPlanner::advance(AxisState* state, float seconds) const {
+    const int steps = static_cast<int>(seconds / kStepSeconds + 0.5f);
+    for (int s = 0; s < steps; ++s) {
+        for (size_t i = 0; i < AXIS_COUNT; ++i) {
+            step(limits_[i], goal_[i], state[i], kStepSeconds);
+        }
+    }
+}
+
+// ============================================================================
+// Packets
+// ============================================================================
+
+int16_t ArmTrajectoryPlanner::toCounts(float value, float scale) {
+    const float counts = lroundf(value * scale);
+    return static_cast<int16_t>(clampf(counts, -32767.0f, 32767.0f));
+}
+
+void ArmTrajectoryPlanner::writeKnot(const AxisState* state, ArmTrajectoryKnot& knot) const {
+    for (size_t i = 0; i < AXIS_COUNT; ++i) {
+        knot.position[i] = toCounts(state[i].position, kArmTrajectoryPositionScale);
+        knot.velocity[i] = toCounts(state[i].velocity, kArmTrajectoryVelocityScale);
+    }
+}
+
+bool ArmTrajectoryPlanner::buildPacket(uint32_t nowMs, uint8_t flags, ArmTrajectoryPacket& out) {
+    if (!initialized_) {
+        return false;
+    }
+    const bool settled = isSettled();
+    const uint32_t elapsed = nowMs - lastSendMs_;
+    const uint32_t interval = (settled && lastSentSettled_) ? kIdleResendMs : kSegmentMs;
+    if (lastSendMs_ != 0 && elapsed < interval) {
+        return false;
+    }
+
+    out.magic = ARM_TRAJECTORY_MAGIC;
+    out.sequence = sequence_++;
+    out.segmentMs = kSegmentMs;
+    out.validMask = kValidMask;
+    out.flags = flags;
+    out.knotCount = settled ? 1 : static_cast<uint8_t>(kArmTrajectoryKnots);
+
+    AxisState lookahead[AXIS_COUNT];
+    memcpy(lookahead, state_, sizeof(lookahead));
+    writeKnot(lookahead, out.knots[0]);
+    for (size_t k = 1; k < kArmTrajectoryKnots; ++k) {
+        if (k < out.knotCount) {
+            advance(lookahead, kSegmentMs * 0.001f);
+        }
+        // Unused knots repeat the last one so the packet stays deterministic
+        writeKnot(lookahead, out.knots[k]);
+    }
+
+    lastSendMs_ = nowMs != 0 ? nowMs : 1;
+    lastSentSettled_ = settled;
+    return true;
+}
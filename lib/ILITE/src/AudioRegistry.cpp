@@ -53,6 +53,12 @@ bool AudioRegistry::play(const char* name) {
                 return true;
             }
 
+            // Hand note tables to the sequencer (returns immediately)
+            if (cue.noteCount > 0) {
+                audioPlaySequence(cue.notes, cue.noteCount);
+                return true;
+            }
+
             // Play simple tone using audio hardware
             audioPlayTone(cue.frequencyHz, cue.durationMs);
             Serial.printf("[AudioRegistry] Playing: %s (%uHz, %ums)\n",
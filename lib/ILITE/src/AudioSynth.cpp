@@ -0,0 +1,367 @@
+/**
+ * @file AudioSynth.cpp
+ * @brief Wavetable voices, ADSR envelopes and the timer-fed DAC buffers
+ */
+
+#include "AudioSynth.h"
+#include "TaskMonitor.h"
+#include <driver/dac.h>
+#include <soc/rtc_io_reg.h>
+#include <soc/sens_reg.h>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr dac_channel_t kDacChannel = DAC_CHANNEL_2;   // GPIO26 (buzzer)
+constexpr uint8_t kTimerNumber = 3;
+constexpr uint16_t kTimerDivider = 5;                   // 80 MHz / 5 = 16 MHz
+constexpr uint32_t kTimerTicksPerSample = 16000000UL / AudioSynth::kSampleRate;
+constexpr uint32_t kTaskStackSize = 2048;
+
+constexpr int32_t kLevelMax = 1 << 23;                  // Q23 envelope full scale
+constexpr uint8_t kDacMidpoint = 128;
+
+constexpr AudioSynth::Envelope kDefaultEnvelope = {3, 30, 70, 15};
+
+// The ISR cannot go through getInstance() (function-local static guard)
+AudioSynth* isrSynth = nullptr;
+
+int32_t stepFor(int32_t span, uint16_t ms) {
+    const uint32_t samples = (static_cast<uint32_t>(ms) * AudioSynth::kSampleRate) / 1000;
+    return samples == 0 ? span : span / static_cast<int32_t>(samples);
+}
+
+inline void IRAM_ATTR writeDac(uint8_t value) {
+    SET_PERI_REG_BITS(RTC_IO_PAD_DAC2_REG, RTC_IO_PDAC2_DAC, value, RTC_IO_PDAC2_DAC_S);
+}
+
+}  // namespace
+
+// ============================================================================
+// Singleton
+// ============================================================================
+
+AudioSynth& AudioSynth::getInstance() {
+    static AudioSynth instance;
+    return instance;
+}
+
+AudioSynth::AudioSynth()
+    : playBuffer_(0),
+      playIndex_(0),
+      envelope_(kDefaultEnvelope),
+      volume_(100),
+      activeVoices_(0),
+      voiceOrder_(0),
+      timer_(nullptr),
+      taskHandle_(nullptr),
+      sleeping_(true),
+      running_(false)
+{
+    memset(voices_, 0, sizeof(voices_));
+    memset(buffers_, kDacMidpoint, sizeof(buffers_));
+    memset(wavetable_, 0, sizeof(wavetable_));
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool AudioSynth::begin() {
+    if (running_) {
+        return true;
+    }
+
+    constexpr size_t kTableSize = 1 << kWavetableBits;
+    for (size_t i = 0; i < kTableSize; ++i) {
+        wavetable_[i] = static_cast<int16_t>(lroundf(sinf(2.0f * PI * i / kTableSize) * 32767.0f));
+    }
+
+    // Direct DAC writes: the cosine generator must be off for this channel
+    if (dac_output_enable(kDacChannel) != ESP_OK) {
+        Serial.println("[AudioSynth] dac_output_enable failed");
+        return false;
+    }
+    dac_cw_generator_disable();
+    CLEAR_PERI_REG_MASK(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_CW_EN2_M);
+    writeDac(kDacMidpoint);
+
+    isrSynth = this;
+    timer_ = timerBegin(kTimerNumber, kTimerDivider, true);
+    if (timer_ == nullptr) {
+        Serial.println("[AudioSynth] Failed to claim hardware timer");
+        isrSynth = nullptr;
+        return false;
+    }
+    timerAttachInterrupt(timer_, &AudioSynth::onSampleTimer, true);
+    timerAlarmWrite(timer_, kTimerTicksPerSample, true);
+
+    // Set before the task starts so play() from other tasks is accepted
+    running_ = true;
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        synthTask,
+        "AudioSynth",
+        kTaskStackSize,
+        this,
+        3,          // Must refill a buffer within 8 ms; renders in well under 1 ms
+        &taskHandle_,
+        1
+    );
+
+    if (result != pdPASS) {
+        Serial.println("[AudioSynth] Failed to create synth task");
+        running_ = false;
+        taskHandle_ = nullptr;
+        timerDetachInterrupt(timer_);
+        timerEnd(timer_);
+        timer_ = nullptr;
+        isrSynth = nullptr;
+        return false;
+    }
+
+    TaskMonitor::watch(taskHandle_, kTaskStackSize, 1);
+
+    Serial.printf("[AudioSynth] %u voices at %lu Hz\n",
+                  kVoiceCount, static_cast<unsigned long>(kSampleRate));
+    return true;
+}
+
+// ============================================================================
+// Requests (any task)
+// ============================================================================
+
+bool AudioSynth::play(const AudioNote* notes, size_t count) {
+    if (!running_ || notes == nullptr || count == 0) {
+        return false;
+    }
+    Request request = {notes, static_cast<uint16_t>(count > UINT16_MAX ? UINT16_MAX : count), {0, 0}};
+    return submit(request);
+}
+
+bool AudioSynth::playTone(uint16_t frequencyHz, uint16_t durationMs) {
+    if (!running_) {
+        return false;
+    }
+    Request request = {nullptr, 1, {frequencyHz, durationMs}};
+    return submit(request);
+}
+
+bool AudioSynth::submit(const Request& request) {
+    if (!requests_.push(request)) {
+        return false;
+    }
+    // While the timer runs, the ISR wakes the task every buffer anyway; an
+    // extra wake-up then would render a buffer early and skip audio
+    if (sleeping_.exchange(false)) {
+        xTaskNotifyGive(taskHandle_);
+    }
+    return true;
+}
+
+// ============================================================================
+// Sample output (timer ISR)
+// ============================================================================
+
+void IRAM_ATTR AudioSynth::onSampleTimer() {
+    AudioSynth* self = isrSynth;
+    uint16_t index = self->playIndex_;
+    const uint8_t buffer = self->playBuffer_;
+
+    writeDac(self->buffers_[buffer][index]);
+
+    if (++index >= kBufferFrames) {
+        index = 0;
+        self->playBuffer_ = buffer ^ 1;
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->taskHandle_, &woken);
+        if (woken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    }
+    self->playIndex_ = index;
+}
+
+// ============================================================================
+// Synth task
+// ============================================================================
+
+void AudioSynth::synthTask(void* parameter) {
+    AudioSynth* self = static_cast<AudioSynth*>(parameter);
+    bool timerRunning = false;
+    uint8_t silentBuffers = 0;
+
+    for (;;) {
+        // Woken by the ISR after each buffer, or by submit() while stopped
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        Request request;
+        while (self->requests_.pop(request)) {
+            self->startRequest(request);
+        }
+
+        if (!timerRunning) {
+            bool sounding = false;
+            for (const Voice& voice : self->voices_) {
+                sounding |= voice.stage != IDLE;
+            }
+            if (!sounding) {
+                self->sleeping_.store(true);
+                if (!self->requests_.empty() && self->sleeping_.exchange(false)) {
+                    xTaskNotifyGive(self->taskHandle_);
+                }
+                continue;
+            }
+            // Fill both buffers, then let the timer play them from the start
+            self->playIndex_ = 0;
+            self->render(self->buffers_[self->playBuffer_], kBufferFrames);
+            self->render(self->buffers_[self->playBuffer_ ^ 1], kBufferFrames);
+            timerAlarmEnable(self->timer_);
+            timerRunning = true;
+            silentBuffers = 0;
+            continue;
+        }
+
+        self->render(self->buffers_[self->playBuffer_ ^ 1], kBufferFrames);
+
+        // Stop the 16 kHz interrupt once both buffers hold only silence
+        silentBuffers = self->activeVoices_ == 0 ? silentBuffers + 1 : 0;
+        if (silentBuffers >= 2) {
+            timerAlarmDisable(self->timer_);
+            timerRunning = false;
+            writeDac(kDacMidpoint);
+
+            // Requests pushed from here on wake the task directly
+            self->sleeping_.store(true);
+            if (!self->requests_.empty() && self->sleeping_.exchange(false)) {
+                xTaskNotifyGive(self->taskHandle_);
+            }
+        }
+    }
+}
+
+void AudioSynth::startRequest(const Request& request) {
+    // Free voice first, otherwise steal the oldest
+    Voice* target = nullptr;
+    for (Voice& voice : voices_) {
+        if (voice.stage == IDLE) {
+            target = &voice;
+            break;
+        }
+        if (target == nullptr || voice.startOrder < target->startOrder) {
+            target = &voice;
+        }
+    }
+
+    // A stolen voice keeps its level and phase, so it moves on without a click
+    Voice& voice = *target;
+    voice.request = request;
+    voice.index = 0;
+    voice.startOrder = ++voiceOrder_;
+
+    const Envelope envelope = envelope_;
+    voice.sustainLevel = static_cast<int32_t>((static_cast<int64_t>(kLevelMax) * envelope.sustainPercent) / 100);
+    voice.attackStep = stepFor(kLevelMax, envelope.attackMs);
+    voice.decayStep = stepFor(kLevelMax - voice.sustainLevel, envelope.decayMs);
+    voice.releaseStep = stepFor(kLevelMax, envelope.releaseMs);
+    if (voice.decayStep == 0) {
+        voice.decayStep = 1;
+    }
+
+    beginNote(voice);
+}
+
+void AudioSynth::beginNote(Voice& voice) {
+    const Request& request = voice.request;
+    while (voice.index < request.count) {
+        const AudioNote& note = request.notes ? request.notes[voice.index] : request.tone;
+        if (note.durationMs == 0) {
+            voice.index++;
+            continue;
+        }
+        voice.samplesLeft = (static_cast<uint32_t>(note.durationMs) * kSampleRate) / 1000;
+        if (note.frequencyHz != 0) {
+            voice.phaseStep = static_cast<uint32_t>((static_cast<uint64_t>(note.frequencyHz) << 32) / kSampleRate);
+            voice.stage = ATTACK;   // From the current level, no reset to 0
+        } else {
+            voice.stage = RELEASE;  // Rest
+        }
+        return;
+    }
+
+    // Table finished: fade out, then the voice is free
+    voice.samplesLeft = UINT32_MAX;
+    voice.stage = RELEASE;
+}
+
+void AudioSynth::render(uint8_t* out, size_t frames) {
+    int32_t mix[kBufferFrames] = {};
+    uint8_t active = 0;
+    constexpr uint32_t kPhaseShift = 32 - kWavetableBits;
+
+    for (Voice& voice : voices_) {
+        if (voice.stage == IDLE) {
+            continue;
+        }
+        for (size_t i = 0; i < frames; ++i) {
+            if (voice.samplesLeft == 0) {
+                voice.index++;
+                beginNote(voice);
+            }
+            voice.samplesLeft--;
+
+            switch (voice.stage) {
+            case ATTACK:
+                voice.level += voice.attackStep;
+                if (voice.level >= kLevelMax) {
+                    voice.level = kLevelMax;
+                    voice.stage = DECAY;
+                }
+                break;
+            case DECAY:
+                voice.level -= voice.decayStep;
+                if (voice.level <= voice.sustainLevel) {
+                    voice.level = voice.sustainLevel;
+                    voice.stage = SUSTAIN;
+                }
+                break;
+            case RELEASE:
+                voice.level -= voice.releaseStep;
+                if (voice.level <= 0) {
+                    voice.level = 0;
+                    if (voice.index >= voice.request.count) {
+                        voice.stage = IDLE;
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+            if (voice.stage == IDLE) {
+                break;
+            }
+
+            // Q15 sample x Q15 level
+            mix[i] += (wavetable_[voice.phase >> kPhaseShift] * (voice.level >> 8)) >> 15;
+            voice.phase += voice.phaseStep;
+        }
+        if (voice.stage != IDLE) {
+            active++;
+        }
+    }
+    activeVoices_ = active;
+
+    // One full-scale voice spans half the DAC range, so two voices fit
+    // without clipping; three or more clip only at envelope peaks
+    const int32_t gain = (static_cast<int32_t>(volume_) * 127) / 100;
+    for (size_t i = 0; i < frames; ++i) {
+        int32_t sample = kDacMidpoint + ((mix[i] * gain) >> 16);
+        if (sample < 0) {
+            sample = 0;
+        } else if (sample > 255) {
+            sample = 255;
+        }
+        out[i] = static_cast<uint8_t>(sample);
+    }
+}
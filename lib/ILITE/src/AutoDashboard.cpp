@@ -0,0 +1,557 @@
+/**
+ * @file AutoDashboard.cpp
+ * @brief Field-table dashboard layout and its retained cells
+ */
+
+#include "AutoDashboard.h"
+#include "DisplayCanvas.h"
+#include "ILITEModule.h"
+#include "LogChannels.h"
+#include "PacketInspector.h"
+#include "TelemetryStore.h"
+#include "WidgetTree.h"
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Grid below the framework strip (FrameworkEngine::DASHBOARD_Y)
+constexpr int16_t kTop = 12;
+constexpr int16_t kRowHeight = 8;
+constexpr size_t kRows = 6;
+constexpr int16_t kHalfWidth = 64;
+constexpr int16_t kFullWidth = 128;
+constexpr int16_t kCharWidth = 4;               ///< TINY advance
+constexpr int16_t kBarLabelWidth = 26;
+constexpr size_t kHexBytes = 12;
+constexpr size_t kTextChars = 28;
+
+// Every grid slot of every page, plus a page tag per page
+constexpr size_t kMaxCells = AutoDashboard::kMaxPages * (kRows * 2 + 1);
+
+static_assert(kRows * 2 + 1 <= WidgetScreen::kMaxWidgets, "A full page must fit one WidgetScreen");
+static_assert(AutoDashboard::kSparkSamples <= kFullWidth / 2, "Sparkline must fit beside its text");
+
+enum class CellKind : uint8_t {
+    Value,
+    Flag,
+    Bar,
+    Sparkline,
+    Hex,
+    Note,           ///< Fixed text (page tag, empty notice)
+};
+
+bool isFullWidth(CellKind kind) {
+    return kind == CellKind::Sparkline || kind == CellKind::Hex;
+}
+
+float fieldValue(const PacketDescriptor::Field& field, const uint8_t* data, size_t length) {
+    if (field.offset + field.size > length) {
+        return NAN;
+    }
+    const uint8_t* at = data + field.offset;
+    switch (field.type) {
+        case PacketDescriptor::Field::INT8:   { int8_t v;   memcpy(&v, at, 1); return v; }
+        case PacketDescriptor::Field::UINT8:  { uint8_t v;  memcpy(&v, at, 1); return v; }
+        case PacketDescriptor::Field::BOOL:   { uint8_t v;  memcpy(&v, at, 1); return v ? 1.0f : 0.0f; }
+        case PacketDescriptor::Field::INT16:  { int16_t v;  memcpy(&v, at, 2); return v; }
+        case PacketDescriptor::Field::UINT16: { uint16_t v; memcpy(&v, at, 2); return v; }
+        case PacketDescriptor::Field::INT32:  { int32_t v;  memcpy(&v, at, 4); return static_cast<float>(v); }
+        case PacketDescriptor::Field::UINT32: { uint32_t v; memcpy(&v, at, 4); return static_cast<float>(v); }
+        case PacketDescriptor::Field::FLOAT:  { float v;    memcpy(&v, at, 4); return v; }
+        default:
+            return NAN;
+    }
+}
+
+/// Fewer decimals as the magnitude grows, so values fit a half cell
+void formatCompact(float value, char* out, size_t size) {
+    const float magnitude = fabsf(value);
+    if (std::isnan(value)) {
+        snprintf(out, size, "--");
+    } else if (magnitude < 10.0f) {
+        snprintf(out, size, "%.2f", value);
+    } else if (magnitude < 1000.0f) {
+        snprintf(out, size, "%.1f", value);
+    } else {
+        snprintf(out, size, "%.0f", value);
+    }
+}
+
+bool containsNoCase(const char* text, const char* part) {
+    const size_t partLength = strlen(part);
+    for (; *text != '\0'; ++text) {
+        size_t i = 0;
+        while (i < partLength && text[i] != '\0' &&
+               tolower(static_cast<unsigned char>(text[i])) == part[i]) {
+            ++i;
+        }
+        if (i == partLength) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isPercentName(const char* name) {
+    return name != nullptr && (containsNoCase(name, "batt") || containsNoCase(name, "pct") ||
+                               containsNoCase(name, "percent") || containsNoCase(name, "level"));
+}
+
+void drawClipped(DisplayCanvas& canvas, int16_t x, int16_t y, const char* text, int16_t width) {
+    char clipped[kTextChars];
+    const int16_t chars = width > 0 ? width / kCharWidth : 0;
+    const size_t count = chars < static_cast<int16_t>(kTextChars) ? static_cast<size_t>(chars) : kTextChars - 1;
+    strncpy(clipped, text != nullptr ? text : "?", count);
+    clipped[count] = '\0';
+    canvas.drawText(x, y, clipped);
+}
+
+// ============================================================================
+// Cell widget
+// ============================================================================
+
+class FieldWidget : public Widget {
+public:
+    FieldWidget() : Widget(0, 0, 0, 0) {}
+
+    void assign(CellKind kind, size_t typeIndex, const PacketDescriptor::Field& field, float* history) {
+        kind_ = kind;
+        typeIndex_ = static_cast<uint8_t>(typeIndex);
+        field_ = field;
+        history_ = history;
+        historyCount_ = 0;
+        historyHead_ = 0;
+        sequence_ = UINT32_MAX;
+        state_ = 0;
+        text_[0] = '\0';
+    }
+
+    void assignNote(const char* text) {
+        assign(CellKind::Note, 0, PacketDescriptor::Field{nullptr, 0, 0, PacketDescriptor::Field::BYTE_ARRAY},
+               nullptr);
+        strncpy(text_, text, kTextChars - 1);
+        text_[kTextChars - 1] = '\0';
+    }
+
+    void place(int16_t x, int16_t y, int16_t w, int16_t h) {
+        x_ = x;
+        y_ = y;
+        w_ = w;
+        h_ = h;
+        invalidate();
+    }
+
+    bool refresh() override {
+        if (kind_ == CellKind::Note) {
+            return false;
+        }
+        const TelemetrySlot* slot = TelemetryStore::getInstance().getSlot(typeIndex_);
+        const uint32_t sequence = slot != nullptr ? slot->getSequence() : 0;
+        if (sequence == sequence_) {
+            return false;
+        }
+
+        char text[kTextChars] = "--";
+        float value = NAN;
+        uint32_t seen = 0;
+        if (sequence != 0) {
+            // Decode this field only, in place; a torn pass is redone by inspect()
+            const bool ok = slot->inspect([&](const uint8_t* data, size_t length) {
+                decode(data, length, text, value);
+            }, &seen);
+            if (!ok) {
+                return false;           // Writer busy: try again next frame
+            }
+        } else {
+            historyCount_ = 0;          // Slot cleared (module change)
+        }
+        sequence_ = seen;
+
+        uint8_t state = 0;
+        switch (kind_) {
+            case CellKind::Flag:
+                state = std::isnan(value) ? 0 : (value != 0.0f ? 2 : 1);
+                break;
+            case CellKind::Bar:
+                if (!std::isnan(value)) {
+                    const float clamped = value < 0.0f ? 0.0f : (value > 100.0f ? 100.0f : value);
+                    state = static_cast<uint8_t>(1 + lroundf(clamped * (w_ - kBarLabelWidth - 4) / 100.0f));
+                }
+                break;
+            case CellKind::Sparkline:
+                if (!std::isnan(value) && history_ != nullptr) {
+                    history_[historyHead_] = value;
+                    historyHead_ = static_cast<uint8_t>((historyHead_ + 1) % AutoDashboard::kSparkSamples);
+                    if (historyCount_ < AutoDashboard::kSparkSamples) {
+                        historyCount_++;
+                    }
+                    strncpy(text_, text, kTextChars);
+                    return true;        // The trace moved
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (state == state_ && strcmp(text, text_) == 0) {
+            return false;
+        }
+        state_ = state;
+        memcpy(text_, text, kTextChars);
+        return true;
+    }
+
+    void draw(DisplayCanvas& canvas) override {
+        canvas.setFont(DisplayCanvas::TINY);
+        const int16_t baseline = y_ + 6;
+        switch (kind_) {
+            case CellKind::Value: {
+                const int16_t valueWidth = canvas.getTextWidth(text_);
+                canvas.drawText(x_ + w_ - 2 - valueWidth, baseline, text_);
+                drawClipped(canvas, x_, baseline, field_.name, w_ - valueWidth - 4);
+                break;
+            }
+            case CellKind::Flag:
+                drawClipped(canvas, x_, baseline, field_.name, w_ - 10);
+                if (state_ == 0) {
+                    canvas.drawText(x_ + w_ - 10, baseline, "--");
+                } else {
+                    canvas.drawRect(x_ + w_ - 8, y_ + 1, 5, 5, state_ == 2);
+                }
+                break;
+            case CellKind::Bar:
+                drawClipped(canvas, x_, baseline, field_.name, kBarLabelWidth - 2);
+                canvas.drawRect(x_ + kBarLabelWidth, y_ + 1, w_ - kBarLabelWidth - 2, 5);
+                if (state_ > 1) {
+                    canvas.drawRect(x_ + kBarLabelWidth + 1, y_ + 2, state_ - 1, 3, true);
+                }
+                break;
+            case CellKind::Sparkline:
+                drawClipped(canvas, x_, baseline, field_.name, w_ - AutoDashboard::kSparkSamples - 2);
+                canvas.drawText(x_, baseline + kRowHeight, text_);
+                drawTrace(canvas);
+                break;
+            case CellKind::Hex: {
+                const int16_t labelWidth = 9 * kCharWidth;
+                drawClipped(canvas, x_, baseline, field_.name, labelWidth - kCharWidth);
+                drawClipped(canvas, x_ + labelWidth, baseline, text_, w_ - labelWidth);
+                break;
+            }
+            case CellKind::Note:
+                canvas.drawText(x_ + w_ - 2 - canvas.getTextWidth(text_), baseline, text_);
+                break;
+        }
+    }
+
+private:
+    void decode(const uint8_t* data, size_t length, char* text, float& value) const {
+        if (kind_ == CellKind::Hex) {
+            size_t pos = 0;
+            for (size_t i = 0; i < kHexBytes && i < length && pos + 3 <= kTextChars; ++i) {
+                pos += snprintf(text + pos, kTextChars - pos, "%02X", data[i]);
+            }
+            text[pos] = '\0';
+            return;
+        }
+        value = fieldValue(field_, data, length);
+        if (field_.type == PacketDescriptor::Field::FLOAT || kind_ == CellKind::Bar) {
+            formatCompact(value, text, kTextChars);
+        } else {
+            PacketInspector::formatField(field_, data, length, text, kTextChars);
+        }
+    }
+
+    void drawTrace(DisplayCanvas& canvas) {
+        if (historyCount_ < 2) {
+            return;
+        }
+        const size_t oldest = (historyHead_ + AutoDashboard::kSparkSamples - historyCount_) %
+                              AutoDashboard::kSparkSamples;
+        float low = history_[oldest];
+        float high = low;
+        for (size_t i = 1; i < historyCount_; ++i) {
+            const float sample = history_[(oldest + i) % AutoDashboard::kSparkSamples];
+            low = sample < low ? sample : low;
+            high = sample > high ? sample : high;
+        }
+
+        // Newest sample at the right edge
+        const int16_t plotHeight = h_ - 3;
+        const int16_t right = x_ + w_ - 1;
+        const float scale = high > low ? plotHeight / (high - low) : 0.0f;
+        int16_t previousY = 0;
+        for (size_t i = 0; i < historyCount_; ++i) {
+            const float sample = history_[(oldest + i) % AutoDashboard::kSparkSamples];
+            const int16_t px = right - static_cast<int16_t>(historyCount_ - 1 - i);
+            const int16_t py = y_ + 1 + plotHeight -
+                               (scale > 0.0f ? static_cast<int16_t>((sample - low) * scale) : plotHeight / 2);
+            if (i > 0) {
+                canvas.drawLine(px - 1, previousY, px, py);
+            }
+            previousY = py;
+        }
+    }
+
+    PacketDescriptor::Field field_ = {nullptr, 0, 0, PacketDescriptor::Field::BYTE_ARRAY};
+    float* history_ = nullptr;
+    uint32_t sequence_ = UINT32_MAX;    ///< Slot sequence last decoded
+    CellKind kind_ = CellKind::Note;
+    uint8_t typeIndex_ = 0;
+    uint8_t state_ = 0;                 ///< Flag: 0 none, 1 off, 2 on; Bar: 1 + filled pixels
+    uint8_t historyHead_ = 0;
+    uint8_t historyCount_ = 0;
+    char text_[kTextChars] = {};
+};
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+struct CellSpec {
+    CellKind kind;
+    uint8_t typeIndex;
+    int8_t history;                     ///< Sparkline history, -1 for none
+    PacketDescriptor::Field field;
+};
+
+struct Layout {
+    // Cache key: the module and its descriptors' field tables
+    const ILITEModule* module = nullptr;
+    size_t typeCount = 0;
+    const PacketDescriptor::Field* tables[TelemetryStore::kMaxSlots] = {};
+    size_t fieldCounts[TelemetryStore::kMaxSlots] = {};
+
+    WidgetScreen pages[AutoDashboard::kMaxPages];
+    FieldWidget cells[kMaxCells];
+    float history[AutoDashboard::kMaxSparklines][AutoDashboard::kSparkSamples] = {};
+    CellSpec specs[kMaxCells];
+    size_t specCount = 0;
+    size_t cellCount = 0;
+    size_t pageCount = 1;
+    size_t page = 0;
+    size_t placed = 0;
+    size_t hidden = 0;
+    uint32_t pageStartMs = 0;
+};
+
+Layout* g_layout = nullptr;
+
+size_t typeCount(const ILITEModule& module) {
+    const size_t count = module.getTelemetryPacketTypeCount();
+    return count < TelemetryStore::kMaxSlots ? count : TelemetryStore::kMaxSlots;
+}
+
+bool matches(const Layout& layout, const ILITEModule& module) {
+    if (layout.module != &module) {
+        return false;
+    }
+    const size_t count = typeCount(module);
+    if (count != layout.typeCount) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const PacketDescriptor desc = module.getTelemetryPacketDescriptor(i);
+        if (desc.fields != layout.tables[i] || desc.fieldCount != layout.fieldCounts[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CellKind classify(const PacketDescriptor::Field& field, size_t& sparklines) {
+    if (field.type == PacketDescriptor::Field::BOOL) {
+        return CellKind::Flag;
+    }
+    if (field.type == PacketDescriptor::Field::BYTE_ARRAY) {
+        return CellKind::Value;
+    }
+    if (isPercentName(field.name)) {
+        return CellKind::Bar;
+    }
+    const bool continuous = field.type == PacketDescriptor::Field::FLOAT ||
+                            field.type == PacketDescriptor::Field::INT16 ||
+                            field.type == PacketDescriptor::Field::INT32;
+    if (continuous && sparklines < AutoDashboard::kMaxSparklines) {
+        sparklines++;
+        return CellKind::Sparkline;
+    }
+    return CellKind::Value;
+}
+
+void collectSpecs(Layout& layout, const ILITEModule& module) {
+    size_t sparklines = 0;
+    layout.specCount = 0;
+    layout.hidden = 0;
+    layout.typeCount = typeCount(module);
+
+    for (size_t t = 0; t < layout.typeCount; ++t) {
+        const PacketDescriptor desc = module.getTelemetryPacketDescriptor(t);
+        layout.tables[t] = desc.fields;
+        layout.fieldCounts[t] = desc.fieldCount;
+
+        const bool hex = desc.fields == nullptr || desc.fieldCount == 0;
+        const size_t fieldCount = hex ? 1 : desc.fieldCount;
+        for (size_t f = 0; f < fieldCount; ++f) {
+            if (layout.specCount >= kMaxCells - AutoDashboard::kMaxPages) {
+                layout.hidden++;
+                continue;
+            }
+            CellSpec& spec = layout.specs[layout.specCount++];
+            spec.typeIndex = static_cast<uint8_t>(t);
+            spec.history = -1;
+            if (hex) {
+                spec.kind = CellKind::Hex;
+                spec.field = {desc.name != nullptr ? desc.name : "?", 0, kHexBytes,
+                              PacketDescriptor::Field::BYTE_ARRAY};
+            } else {
+                const size_t before = sparklines;
+                spec.field = desc.fields[f];
+                spec.kind = classify(spec.field, sparklines);
+                if (sparklines != before) {
+                    spec.history = static_cast<int8_t>(before);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Place the specs on pages: full-width cells first, then half cells two
+ * per row, both in field order. With `reserveTag` the right half of each
+ * page's last row is kept for the page tag.
+ *
+ * @return Pages used
+ */
+size_t placeCells(Layout& layout, bool reserveTag) {
+    for (size_t p = 0; p < AutoDashboard::kMaxPages; ++p) {
+        layout.pages[p] = WidgetScreen();
+    }
+    layout.cellCount = 0;
+    layout.placed = 0;
+    size_t overflow = 0;
+
+    size_t page = 0;
+    size_t row = 0;
+    size_t column = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < layout.specCount; ++i) {
+            const CellSpec& spec = layout.specs[i];
+            const bool full = isFullWidth(spec.kind);
+            if (full != (pass == 0)) {
+                continue;
+            }
+
+            const size_t rows = spec.kind == CellKind::Sparkline ? 2 : 1;
+            const bool fits = full ? row + rows <= kRows - (reserveTag ? 1 : 0)
+                                   : row < kRows && !(reserveTag && row == kRows - 1 && column == 1);
+            if (!fits) {
+                page++;
+                row = 0;
+                column = 0;
+            }
+            if (page >= AutoDashboard::kMaxPages) {
+                overflow++;
+                continue;
+            }
+
+            FieldWidget& cell = layout.cells[layout.cellCount++];
+            cell.assign(spec.kind, spec.typeIndex, spec.field,
+                        spec.history >= 0 ? layout.history[spec.history] : nullptr);
+            const int16_t y = kTop + static_cast<int16_t>(row) * kRowHeight;
+            if (full) {
+                cell.place(0, y, kFullWidth, static_cast<int16_t>(rows) * kRowHeight);
+                row += rows;
+            } else {
+                cell.place(static_cast<int16_t>(column) * kHalfWidth, y, kHalfWidth, kRowHeight);
+                column ^= 1;
+                row += column == 0 ? 1 : 0;
+            }
+            layout.pages[page].add(cell);
+            layout.placed++;
+        }
+    }
+
+    const size_t pages = layout.placed > 0 ? (page < AutoDashboard::kMaxPages ? page + 1 : page) : 1;
+    if (reserveTag) {
+        for (size_t p = 0; p < pages; ++p) {
+            char tag[8];
+            snprintf(tag, sizeof(tag), "%u/%u", static_cast<unsigned>(p + 1), static_cast<unsigned>(pages));
+            FieldWidget& cell = layout.cells[layout.cellCount++];
+            cell.assignNote(tag);
+            cell.place(kHalfWidth, kTop + static_cast<int16_t>(kRows - 1) * kRowHeight, kHalfWidth, kRowHeight);
+            layout.pages[p].add(cell);
+        }
+    }
+    layout.hidden += overflow;
+    return pages;
+}
+
+void build(Layout& layout, const ILITEModule& module) {
+    layout.module = &module;
+    collectSpecs(layout, module);
+    memset(layout.history, 0, sizeof(layout.history));
+
+    layout.pageCount = placeCells(layout, false);
+    if (layout.pageCount > 1) {
+        layout.pageCount = placeCells(layout, true);
+    }
+    if (layout.placed == 0) {
+        FieldWidget& cell = layout.cells[layout.cellCount++];
+        cell.assignNote("No telemetry fields");
+        cell.place(0, kTop + 2 * kRowHeight, 104, kRowHeight);
+        layout.pages[0].add(cell);
+    }
+    layout.page = 0;
+    layout.pageStartMs = millis();
+
+    ILITE_LOG(UI, LOG_INFO, "Dashboard for %s: %u fields on %u page(s), %u not shown",
+              module.getModuleName(), static_cast<unsigned>(layout.placed),
+              static_cast<unsigned>(layout.pageCount), static_cast<unsigned>(layout.hidden));
+}
+
+}  // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+WidgetScreen* AutoDashboard::getScreen(const ILITEModule& module) {
+    if (g_layout == nullptr) {
+        g_layout = new (std::nothrow) Layout();
+        if (g_layout == nullptr) {
+            return nullptr;
+        }
+    }
+    Layout& layout = *g_layout;
+    if (!matches(layout, module)) {
+        build(layout, module);
+    }
+
+    const uint32_t now = millis();
+    if (layout.pageCount > 1 && now - layout.pageStartMs >= kPageMs) {
+        layout.page = (layout.page + 1) % layout.pageCount;
+        layout.pageStartMs = now;
+        layout.pages[layout.page].invalidateAll();
+    }
+    return &layout.pages[layout.page];
+}
+
+void AutoDashboard::draw(const ILITEModule& module, DisplayCanvas& canvas) {
+    if (WidgetScreen* screen = getScreen(module)) {
+        screen->render(canvas, true);
+    } else {
+        canvas.setFont(DisplayCanvas::TINY);
+        canvas.drawText(0, 30, "Dashboard: no memory");
+    }
+}
+
+size_t AutoDashboard::getPlacedFields() {
+    return g_layout != nullptr ? g_layout->placed : 0;
+}
+
+size_t AutoDashboard::getHiddenFields() {
+    return g_layout != nullptr ? g_layout->hidden : 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file BatteryMonitor.cpp
+ * @brief Battery estimation: calibrated conversion, filtering, LiPo curve
+ */
+
+#include "BatteryMonitor.h"
+#include "SettingsStore.h"
+#include <esp_adc_cal.h>
+
+volatile uint32_t BatteryMonitor::publishedMillivolts_ = 0;
+volatile uint8_t BatteryMonitor::publishedPercent_ = 0;
+volatile uint16_t BatteryMonitor::minutesToEmpty_ = 0;
+
+namespace {
+
+constexpr uint32_t kDefaultVrefMv = 1100;
+
+// 1S LiPo resting voltage every 5% of charge, 0% first
+constexpr uint16_t kCurveMillivolts[] = {
+    3270, 3610, 3690, 3710, 3730, 3750, 3770, 3790, 3800, 3820, 3840,
+    3850, 3870, 3910, 3950, 3980, 4020, 4080, 4110, 4150, 4200
+};
+constexpr size_t kCurvePoints = sizeof(kCurveMillivolts) / sizeof(kCurveMillivolts[0]);
+constexpr float kPercentPerPoint = 100.0f / (kCurvePoints - 1);
+
+esp_adc_cal_characteristics_t calibration;
+esp_adc_cal_value_t calibrationSource = ESP_ADC_CAL_VAL_DEFAULT_VREF;
+bool calibrated = false;
+float dividerRatio = 0.0f;              // Trimmed ratio (0 = legacy conversion)
+uint16_t lastRaw = 0;
+Setting<float> dividerSetting;
+
+// Current window (CommTask only)
+uint32_t windowStartMs = 0;
+uint32_t windowSumMv = 0;
+uint16_t windowTicks = 0;
+uint16_t windowStreamingTicks = 0;
+float filteredMv = 0.0f;
+
+// Discharge slope
+uint32_t rateStartMs = 0;
+float rateStartPercent = -1.0f;
+float drainPercentPerMinute = 0.0f;
+
+float chargeForMillivolts(float mv) {
+    if (mv <= kCurveMillivolts[0]) {
+        return 0.0f;
+    }
+    if (mv >= kCurveMillivolts[kCurvePoints - 1]) {
+        return 100.0f;
+    }
+    size_t i = 1;
+    while (kCurveMillivolts[i] < mv) {
+        ++i;
+    }
+    const float lo = kCurveMillivolts[i - 1];
+    const float hi = kCurveMillivolts[i];
+    return ((i - 1) + (mv - lo) / (hi - lo)) * kPercentPerPoint;
+}
+
+}  // namespace
+
+// ============================================================================
+// Conversion
+// ============================================================================
+
+void BatteryMonitor::begin() {
+    // Same attenuation and width as AdcSampler's DMA pattern
+    calibrationSource = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                                 kDefaultVrefMv, &calibration);
+    calibrated = true;
+    dividerSetting = SettingsStore::getInstance().add("battery", "divider", 0.0f);
+    dividerRatio = dividerSetting.get();
+    Serial.printf("[Battery] ADC calibration: %s, divider %s\n", getCalibrationName(),
+                  dividerRatio > 0.0f ? "trimmed" : "legacy");
+}
+
+bool BatteryMonitor::trim(float measuredVolts) {
+    if (!calibrated || lastRaw == 0 || measuredVolts < 2.5f || measuredVolts > 5.0f) {
+        return false;
+    }
+    const float pinMv = static_cast<float>(esp_adc_cal_raw_to_voltage(lastRaw, &calibration));
+    if (pinMv < 100.0f) {
+        return false;
+    }
+    dividerRatio = measuredVolts * 1000.0f / pinMv;
+    dividerSetting.set(dividerRatio);
+    filteredMv = 0.0f;                  // Restart the filter at the new scale
+    rateStartPercent = -1.0f;
+    Serial.printf("[Battery] Divider trimmed to %.3f\n", dividerRatio);
+    return true;
+}
+
+float BatteryMonitor::rawToVolts(uint16_t raw) {
+    if (calibrated && dividerRatio > 0.0f) {
+        return esp_adc_cal_raw_to_voltage(raw, &calibration) * dividerRatio * 0.001f;
+    }
+    return raw * (3.3f / 4095.0f) * kLegacyDividerRatio;
+}
+
+uint8_t BatteryMonitor::percentForVoltage(float volts) {
+    return static_cast<uint8_t>(chargeForMillivolts(volts * 1000.0f) + 0.5f);
+}
+
+const char* BatteryMonitor::getCalibrationName() {
+    if (!calibrated) {
+        return "none";
+    }
+    switch (calibrationSource) {
+        case ESP_ADC_CAL_VAL_EFUSE_VREF: return "eFuse Vref";
+        case ESP_ADC_CAL_VAL_EFUSE_TP: return "eFuse two-point";
+        default: return "default Vref";
+    }
+}
+
+// ============================================================================
+// Estimation
+// ============================================================================
+
+bool BatteryMonitor::sample(uint16_t raw, bool streaming, uint32_t nowMs) {
+    lastRaw = raw;
+    if (windowTicks == 0) {
+        windowStartMs = nowMs;
+    }
+    windowSumMv += static_cast<uint32_t>(rawToVolts(raw) * 1000.0f);
+    windowTicks++;
+    if (streaming) {
+        windowStreamingTicks++;
+    }
+    if (nowMs - windowStartMs < kPublishMs) {
+        return false;
+    }
+
+    // Resting voltage: window mean plus the sag of the average load
+    const float streamingShare = static_cast<float>(windowStreamingTicks) / windowTicks;
+    const float loadMa = kIdleMilliamps + (kStreamingMilliamps - kIdleMilliamps) * streamingShare;
+    const float restingMv = static_cast<float>(windowSumMv) / windowTicks
+                            + loadMa * kInternalMilliohm * 0.001f;
+    windowSumMv = 0;
+    windowTicks = 0;
+    windowStreamingTicks = 0;
+
+    filteredMv = (filteredMv == 0.0f) ? restingMv
+                                      : filteredMv + kFilterAlpha * (restingMv - filteredMv);
+    const float charge = chargeForMillivolts(filteredMv);
+
+    // Drain per minute over kRateWindowMs; rising charge (USB) clears it
+    if (rateStartPercent < 0.0f) {
+        rateStartPercent = charge;
+        rateStartMs = nowMs;
+    } else if (nowMs - rateStartMs >= kRateWindowMs) {
+        const float minutes = (nowMs - rateStartMs) / 60000.0f;
+        const float rate = (rateStartPercent - charge) / minutes;
+        drainPercentPerMinute = (rate <= 0.0f) ? 0.0f
+                                : (drainPercentPerMinute == 0.0f ? rate
+                                                                 : 0.5f * (drainPercentPerMinute + rate));
+        rateStartPercent = charge;
+        rateStartMs = nowMs;
+    }
+
+    const float minutesLeft = drainPercentPerMinute > 0.01f ? charge / drainPercentPerMinute : 0.0f;
+    minutesToEmpty_ = static_cast<uint16_t>(minutesLeft > 65535.0f ? 65535.0f : minutesLeft);
+    publishedPercent_ = static_cast<uint8_t>(charge + 0.5f);
+    publishedMillivolts_ = static_cast<uint32_t>(filteredMv);
+    return true;
+}
+
+void BatteryMonitor::dump(Print& out) {
+    out.printf("[Battery] %.2f V %u%% time-to-empty=%u min drain=%.2f %%/min cal=%s divider=%.3f%s\n",
+               getVoltage(), getPercent(), getMinutesToEmpty(), drainPercentPerMinute,
+               getCalibrationName(), dividerRatio > 0.0f ? dividerRatio : kLegacyDividerRatio,
+               dividerRatio > 0.0f ? "" : " (legacy)");
+}
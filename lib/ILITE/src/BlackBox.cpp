@@ -0,0 +1,619 @@
+/**
+ * @file BlackBox.cpp
+ * @brief Fault recorder ring, capture slots and the decoder
+ */
+
+#include "BlackBox.h"
+#include "EventLog.h"
+#include "ILITEModule.h"
+#include "InputReplay.h"
+#include "LinkMetrics.h"
+#include "LogChannels.h"
+#include "ModuleRegistry.h"
+#include "PacketInspector.h"
+#include <esp_partition.h>
+#include <esp_timer.h>
+#include <cstdlib>
+#include <cstring>
+
+std::atomic<bool> BlackBox::recording_(false);
+BlackBoxStats BlackBox::stats_ = {};
+
+namespace {
+
+constexpr uint32_t kSlotMagic = 0x58424249;     // "IBBX"
+constexpr uint8_t kChordButtons = InputSnapshot::BUTTON_1 | InputSnapshot::BUTTON_3;
+constexpr uint32_t kMaxSlots = 8;
+
+struct RecordHeader {
+    uint8_t kind;
+    uint8_t type;
+    uint8_t length;         ///< Payload bytes stored
+    uint8_t fullLength;     ///< Packet length before truncation
+    uint32_t timeUs;
+};
+
+struct LinkSample {
+    int8_t rssiDbm;
+    uint8_t lossPercent;
+    uint8_t txSuccessPercent;
+    uint8_t reserved;
+    uint32_t rttUs;
+    uint32_t txFail;
+    uint32_t rxFrames;
+};
+
+struct SlotHeader {
+    uint32_t magic;
+    uint32_t sequence;      ///< +1 per capture, 0 never used
+    uint32_t boot;          ///< EventLog boot number (0 without the log)
+    uint32_t triggerMs;     ///< millis() at the trigger
+    uint32_t triggerUs;     ///< Record clock at the trigger
+    uint32_t bytes;         ///< Record bytes after the header
+    uint32_t records;
+    uint8_t reason;         ///< BlackBoxTrigger
+    uint8_t reserved[3];
+    char module[32];        ///< getModuleId() of the active module ("" = none)
+};
+
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader layout");
+static_assert(sizeof(LinkSample) == 16, "LinkSample layout");
+static_assert(sizeof(SlotHeader) == 64, "SlotHeader layout");
+static_assert(BlackBox::kRingBytes + sizeof(SlotHeader) <= BlackBox::kSlotBytes, "A capture fits a slot");
+static_assert(BlackBox::kMaxPayload <= 0xFF && BlackBox::kMaxPayload % 4 == 0, "Payload length is a u8");
+
+enum class State : uint8_t {
+    Recording,
+    Tail,           ///< Triggered, still recording until kTailMs
+    Frozen          ///< Being saved; writers are shut out
+};
+
+const char* const kTriggerNames[] = {"manual", "link lost", "telemetry stale", "watchdog", "chord"};
+static_assert(sizeof(kTriggerNames) / sizeof(kTriggerNames[0]) == static_cast<size_t>(BlackBoxTrigger::Count),
+              "One name per trigger");
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Ring: live records run from g_tail for g_used bytes up to g_head.
+// Records never straddle the end: a lap ends at g_wrapAt, the bytes after
+// it are unused (and not counted in g_used).
+uint8_t* g_ring = nullptr;
+size_t g_head = 0;
+size_t g_tail = 0;
+size_t g_used = 0;
+size_t g_wrapAt = BlackBox::kRingBytes;
+uint32_t g_records = 0;
+
+State g_state = State::Recording;
+BlackBoxTrigger g_reason = BlackBoxTrigger::Manual;
+uint32_t g_triggerMs = 0;
+uint32_t g_triggerUs = 0;
+
+uint32_t g_chordSinceMs = 0;
+bool g_chordFired = false;
+uint32_t g_lastLinkMs = 0;
+
+// Flash
+const esp_partition_t* g_partition = nullptr;
+uint32_t g_slotCount = 0;
+uint32_t g_sequence = 0;        // Newest capture stored
+uint32_t g_nextSlot = 0;
+uint32_t g_erasedSectors = 0;   // Of g_nextSlot, from its start
+
+// Capture being saved
+struct Span {
+    size_t start;
+    size_t length;
+};
+Span g_spans[2] = {};
+size_t g_spanIndex = 0;
+size_t g_spanOffset = 0;
+uint32_t g_flushBytes = 0;
+SlotHeader g_pending = {};
+
+inline size_t recordSize(uint8_t length) {
+    return (sizeof(RecordHeader) + length + 3) & ~static_cast<size_t>(3);
+}
+
+inline uint32_t slotAddress(uint32_t slot) {
+    return slot * BlackBox::kSlotBytes;
+}
+
+// Drop the oldest record; past the end of its lap the tail starts over
+void evictOldest() {
+    const size_t size = recordSize(reinterpret_cast<const RecordHeader*>(g_ring + g_tail)->length);
+    g_tail += size;
+    if (g_tail >= g_wrapAt) {
+        g_tail = 0;
+    }
+    g_used -= size;
+    g_records--;
+}
+
+// Caller holds g_lock
+bool appendLocked(uint8_t kind, uint8_t type, const uint8_t* data, size_t length, uint32_t timeUs,
+                  BlackBoxStats& stats) {
+    if (g_ring == nullptr || g_state == State::Frozen) {
+        return false;
+    }
+    const uint8_t stored = static_cast<uint8_t>(length < BlackBox::kMaxPayload ? length : BlackBox::kMaxPayload);
+    const size_t size = recordSize(stored);
+
+    if (g_head + size > BlackBox::kRingBytes) {
+        // Records never straddle the end: the rest of this lap stays unused
+        while (g_used > 0 && g_tail >= g_head) {
+            evictOldest();
+            stats.evicted++;
+        }
+        g_wrapAt = g_head;
+        g_head = 0;
+    }
+    // With the tail ahead of the head, the free bytes are the gap between them
+    while (g_used > 0 && g_tail >= g_head && g_tail - g_head < size) {
+        evictOldest();
+        stats.evicted++;
+    }
+    if (g_used == 0) {
+        g_head = 0;
+        g_tail = 0;
+        g_wrapAt = BlackBox::kRingBytes;
+    }
+
+    RecordHeader header = {kind, type, stored, static_cast<uint8_t>(length < 0xFF ? length : 0xFF), timeUs};
+    uint8_t* dst = g_ring + g_head;
+    memcpy(dst, &header, sizeof(header));
+    if (stored > 0) {
+        memcpy(dst + sizeof(header), data, stored);
+    }
+    g_head += size;
+    g_used += size;
+    g_records++;
+    if (g_head == BlackBox::kRingBytes) {
+        g_wrapAt = BlackBox::kRingBytes;
+        g_head = 0;
+    }
+    stats.records++;
+    if (stored < length) {
+        stats.truncated++;
+    }
+    return true;
+}
+
+void resetRing() {
+    g_head = 0;
+    g_tail = 0;
+    g_used = 0;
+    g_records = 0;
+    g_wrapAt = BlackBox::kRingBytes;
+}
+
+bool readSlotHeader(uint32_t slot, SlotHeader& header) {
+    return esp_partition_read(g_partition, slotAddress(slot), &header, sizeof(header)) == ESP_OK &&
+           header.magic == kSlotMagic && header.bytes <= BlackBox::kSlotBytes - sizeof(SlotHeader);
+}
+
+esp_err_t timedFlashOp(BlackBoxStats& stats, bool erase, uint32_t address, const void* data, size_t length) {
+    const int64_t startUs = esp_timer_get_time();
+    const esp_err_t result = erase ? esp_partition_erase_range(g_partition, address, length)
+                                   : esp_partition_write(g_partition, address, data, length);
+    const uint32_t elapsedUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+    if (elapsedUs > stats.maxFlushUs) {
+        stats.maxFlushUs = elapsedUs;
+    }
+    return result;
+}
+
+// One sector of the next slot
+bool eraseAhead(bool paired, BlackBoxStats& stats) {
+    if (timedFlashOp(stats, true, slotAddress(g_nextSlot) + g_erasedSectors * BlackBox::kSectorSize,
+                     nullptr, BlackBox::kSectorSize) != ESP_OK) {
+        return false;
+    }
+    g_erasedSectors++;
+    if (paired) {
+        stats.pairedErases++;
+    }
+    return true;
+}
+
+// Slots holding a capture, newest first
+size_t listSlots(uint32_t slots[kMaxSlots], SlotHeader headers[kMaxSlots]) {
+    size_t count = 0;
+    for (uint32_t slot = 0; slot < g_slotCount; ++slot) {
+        SlotHeader header;
+        if (!readSlotHeader(slot, header)) {
+            continue;
+        }
+        size_t pos = count++;
+        while (pos > 0 && headers[pos - 1].sequence < header.sequence) {
+            slots[pos] = slots[pos - 1];
+            headers[pos] = headers[pos - 1];
+            pos--;
+        }
+        slots[pos] = slot;
+        headers[pos] = header;
+    }
+    return count;
+}
+
+void printPacket(Print& out, const char* tag, const RecordHeader& record, const uint8_t* payload,
+                 ILITEModule* module, bool command) {
+    const size_t typeCount = module == nullptr ? 0
+                             : command ? module->getCommandPacketTypeCount()
+                                       : module->getTelemetryPacketTypeCount();
+    if (record.type >= typeCount) {
+        out.printf("%s #%u", tag, record.type);
+        for (size_t i = 0; i < record.length; ++i) {
+            out.printf(" %02X", payload[i]);
+        }
+    } else {
+        const PacketDescriptor desc = command ? module->getCommandPacketDescriptor(record.type)
+                                              : module->getTelemetryPacketDescriptor(record.type);
+        out.printf("%s %s", tag, desc.name != nullptr ? desc.name : "?");
+        for (size_t f = 0; f < desc.fieldCount && desc.fields != nullptr; ++f) {
+            char value[40];
+            PacketInspector::formatField(desc.fields[f], payload, record.length, value, sizeof(value));
+            out.printf(" %s=%s", desc.fields[f].name, value);
+        }
+    }
+    if (record.fullLength > record.length) {
+        out.printf(" (+%u bytes)", static_cast<unsigned>(record.fullLength - record.length));
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool BlackBox::begin() {
+    if (g_ring == nullptr) {
+        g_ring = static_cast<uint8_t*>(malloc(kRingBytes));
+        if (g_ring == nullptr) {
+            ILITE_LOG(SYSTEM, LOG_ERROR, "[BlackBox] No memory for the %u-byte ring",
+                      static_cast<unsigned>(kRingBytes));
+            return false;
+        }
+    }
+
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           kPartitionLabel);
+    g_slotCount = g_partition != nullptr ? g_partition->size / kSlotBytes : 0;
+    if (g_slotCount > kMaxSlots) {
+        g_slotCount = kMaxSlots;
+    }
+    if (g_slotCount == 0) {
+        g_partition = nullptr;
+        Serial.println("[BlackBox] No \"blackbox\" partition, captures are not saved");
+    } else {
+        // The slot after the newest capture is next; its contents are unknown
+        for (uint32_t slot = 0; slot < g_slotCount; ++slot) {
+            SlotHeader header;
+            if (readSlotHeader(slot, header) && header.sequence > g_sequence) {
+                g_sequence = header.sequence;
+                g_nextSlot = (slot + 1) % g_slotCount;
+            }
+        }
+        g_erasedSectors = 0;
+        Serial.printf("[BlackBox] %lu slots, %lu captures so far, next slot %lu\n",
+                      static_cast<unsigned long>(g_slotCount), static_cast<unsigned long>(g_sequence),
+                      static_cast<unsigned long>(g_nextSlot));
+    }
+
+    portENTER_CRITICAL(&g_lock);
+    resetRing();
+    g_state = State::Recording;
+    portEXIT_CRITICAL(&g_lock);
+    recording_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void BlackBox::record(uint8_t kind, uint8_t type, const uint8_t* data, size_t length,
+                      uint32_t timestampUs) {
+    portENTER_CRITICAL(&g_lock);
+    appendLocked(kind, type, data, length, timestampUs, stats_);
+    portEXIT_CRITICAL(&g_lock);
+}
+
+void BlackBox::onLink(const LinkPeerStats* stats, uint32_t nowMs) {
+    if (stats == nullptr || !isRecording() || nowMs - g_lastLinkMs < kLinkSampleMs) {
+        return;
+    }
+    g_lastLinkMs = nowMs;
+    LinkSample sample = {};
+    sample.rssiDbm = static_cast<int8_t>(stats->rssiDbm);
+    sample.lossPercent = LinkMetrics::lossPercent(*stats);
+    sample.txSuccessPercent = LinkMetrics::txSuccessPercent(*stats);
+    sample.rttUs = stats->rttLastUs;
+    sample.txFail = stats->txFail;
+    sample.rxFrames = stats->rxFrames;
+    record(RECORD_LINK, 0, reinterpret_cast<const uint8_t*>(&sample), sizeof(sample),
+           static_cast<uint32_t>(esp_timer_get_time()));
+}
+
+void BlackBox::checkChord(uint8_t debouncedButtons, uint32_t nowMs) {
+    if ((debouncedButtons & kChordButtons) != kChordButtons) {
+        g_chordSinceMs = 0;
+        g_chordFired = false;
+        return;
+    }
+    if (g_chordSinceMs == 0) {
+        g_chordSinceMs = nowMs | 1;
+    } else if (!g_chordFired && nowMs - g_chordSinceMs >= kChordMs) {
+        g_chordFired = true;
+        trigger(BlackBoxTrigger::Chord);
+    }
+}
+
+void BlackBox::trigger(BlackBoxTrigger reason) {
+    const uint32_t nowUs = static_cast<uint32_t>(esp_timer_get_time());
+    bool accepted = false;
+    portENTER_CRITICAL(&g_lock);
+    if (g_ring != nullptr && g_state == State::Recording) {
+        g_state = State::Tail;
+        g_reason = reason;
+        g_triggerMs = millis();
+        g_triggerUs = nowUs;
+        appendLocked(RECORD_TRIGGER, static_cast<uint8_t>(reason), nullptr, 0, nowUs, stats_);
+        accepted = true;
+    } else {
+        stats_.ignoredTriggers++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (accepted) {
+        ILITE_LOG(SYSTEM, LOG_WARN, "[BlackBox] Triggered: %s", name(reason));
+    }
+}
+
+// ============================================================================
+// Saving
+// ============================================================================
+
+void BlackBox::service(bool paired, uint32_t nowMs, ILITEModule* module) {
+    if (g_ring == nullptr) {
+        return;
+    }
+
+    if (g_state == State::Tail && nowMs - g_triggerMs >= kTailMs) {
+        portENTER_CRITICAL(&g_lock);
+        g_state = State::Frozen;
+        recording_.store(false, std::memory_order_relaxed);
+        if (g_used == 0) {
+            g_spans[0] = {0, 0};
+            g_spans[1] = {0, 0};
+        } else if (g_tail < g_head) {
+            g_spans[0] = {g_tail, g_head - g_tail};
+            g_spans[1] = {0, 0};
+        } else {
+            g_spans[0] = {g_tail, g_wrapAt - g_tail};
+            g_spans[1] = {0, g_head};
+        }
+        g_pending = SlotHeader{};
+        g_pending.magic = kSlotMagic;
+        g_pending.records = g_records;
+        portEXIT_CRITICAL(&g_lock);
+
+        g_pending.boot = EventLog::getBoot();
+        g_pending.triggerMs = g_triggerMs;
+        g_pending.triggerUs = g_triggerUs;
+        g_pending.reason = static_cast<uint8_t>(g_reason);
+        if (module != nullptr) {
+            strncpy(g_pending.module, module->getModuleId(), sizeof(g_pending.module) - 1);
+        }
+        g_spanIndex = 0;
+        g_spanOffset = 0;
+        g_flushBytes = 0;
+    }
+
+    if (g_state == State::Frozen) {
+        if (g_partition == nullptr) {
+            ILITE_LOG(SYSTEM, LOG_WARN, "[BlackBox] %s capture dropped: no partition", name(g_reason));
+        } else {
+            // One flash operation per call: the next sector the capture needs
+            // erased, or the next chunk of records, or finally the header
+            const uint32_t needed = sizeof(SlotHeader) + g_spans[0].length + g_spans[1].length;
+            if (g_erasedSectors * kSectorSize < needed) {
+                eraseAhead(paired, stats_);
+                return;
+            }
+            while (g_spanIndex < 2 && g_spanOffset >= g_spans[g_spanIndex].length) {
+                g_spanIndex++;
+                g_spanOffset = 0;
+            }
+            esp_err_t result = ESP_OK;
+            if (g_spanIndex < 2) {
+                const Span& span = g_spans[g_spanIndex];
+                size_t chunk = span.length - g_spanOffset;
+                if (chunk > kFlushChunk) {
+                    chunk = kFlushChunk;
+                }
+                result = timedFlashOp(stats_, false, slotAddress(g_nextSlot) + sizeof(SlotHeader) + g_flushBytes,
+                                      g_ring + span.start + g_spanOffset, chunk);
+                g_spanOffset += chunk;
+                g_flushBytes += chunk;
+                if (result == ESP_OK) {
+                    return;
+                }
+            } else {
+                g_pending.sequence = g_sequence + 1;
+                g_pending.bytes = g_flushBytes;
+                result = timedFlashOp(stats_, false, slotAddress(g_nextSlot), &g_pending, sizeof(g_pending));
+            }
+            if (result == ESP_OK) {
+                g_sequence++;
+                stats_.captures++;
+                ILITE_LOG(SYSTEM, LOG_INFO, "[BlackBox] %s capture %lu saved: %lu records, %lu bytes",
+                          name(g_reason), static_cast<unsigned long>(g_sequence),
+                          static_cast<unsigned long>(g_pending.records),
+                          static_cast<unsigned long>(g_flushBytes));
+            } else {
+                ILITE_LOG(SYSTEM, LOG_ERROR, "[BlackBox] Flash write failed (%d), capture dropped",
+                          static_cast<int>(result));
+            }
+            g_nextSlot = (g_nextSlot + 1) % g_slotCount;
+            g_erasedSectors = 0;
+        }
+
+        portENTER_CRITICAL(&g_lock);
+        resetRing();
+        g_state = State::Recording;
+        portEXIT_CRITICAL(&g_lock);
+        recording_.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    // Keep the next slot blank so a capture in a match only writes
+    if (!paired && g_partition != nullptr && g_erasedSectors < kSlotBytes / kSectorSize) {
+        eraseAhead(false, stats_);
+    }
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+const char* BlackBox::name(BlackBoxTrigger reason) {
+    const size_t index = static_cast<size_t>(reason);
+    return index < static_cast<size_t>(BlackBoxTrigger::Count) ? kTriggerNames[index] : "?";
+}
+
+void BlackBox::list(Print& out) {
+    if (g_partition == nullptr) {
+        out.println("[BlackBox] Not mounted");
+        return;
+    }
+    uint32_t slots[kMaxSlots];
+    SlotHeader headers[kMaxSlots];
+    const size_t count = listSlots(slots, headers);
+    if (count == 0) {
+        out.println("[BlackBox] No captures");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const SlotHeader& header = headers[i];
+        out.printf("[BlackBox] %u: #%lu boot %lu at %lu.%03lu s, %s, %s, %lu records\n",
+                   static_cast<unsigned>(i), static_cast<unsigned long>(header.sequence),
+                   static_cast<unsigned long>(header.boot),
+                   static_cast<unsigned long>(header.triggerMs / 1000),
+                   static_cast<unsigned long>(header.triggerMs % 1000),
+                   name(static_cast<BlackBoxTrigger>(header.reason)),
+                   header.module[0] != '\0' ? header.module : "no module",
+                   static_cast<unsigned long>(header.records));
+    }
+}
+
+void BlackBox::download(Print& out, uint32_t index) {
+    if (g_partition == nullptr) {
+        out.println("[BlackBox] Not mounted");
+        return;
+    }
+    uint32_t slots[kMaxSlots];
+    SlotHeader headers[kMaxSlots];
+    const size_t count = listSlots(slots, headers);
+    if (index >= count) {
+        out.printf("[BlackBox] No capture %lu (%u stored)\n", static_cast<unsigned long>(index),
+                   static_cast<unsigned>(count));
+        return;
+    }
+    SlotHeader header = headers[index];
+    header.module[sizeof(header.module) - 1] = '\0';
+    ILITEModule* module = header.module[0] != '\0' ? ModuleRegistry::findModuleById(header.module) : nullptr;
+    out.printf("[BlackBox] #%lu: %s at %lu ms of boot %lu, module %s%s\n",
+               static_cast<unsigned long>(header.sequence), name(static_cast<BlackBoxTrigger>(header.reason)),
+               static_cast<unsigned long>(header.triggerMs), static_cast<unsigned long>(header.boot),
+               header.module[0] != '\0' ? header.module : "none",
+               module == nullptr && header.module[0] != '\0' ? " (not built in: hex)" : "");
+
+    const uint32_t base = slotAddress(slots[index]) + sizeof(SlotHeader);
+    uint32_t offset = 0;
+    uint32_t printed = 0;
+    while (offset + sizeof(RecordHeader) <= header.bytes) {
+        RecordHeader record;
+        uint8_t payload[kMaxPayload];
+        if (esp_partition_read(g_partition, base + offset, &record, sizeof(record)) != ESP_OK ||
+            record.length > kMaxPayload ||
+            offset + recordSize(record.length) > header.bytes ||
+            esp_partition_read(g_partition, base + offset + sizeof(record), payload, record.length) != ESP_OK) {
+            out.printf("[BlackBox] Bad record at %lu\n", static_cast<unsigned long>(offset));
+            break;
+        }
+        offset += recordSize(record.length);
+
+        const int32_t relativeUs = static_cast<int32_t>(record.timeUs - header.triggerUs);
+        out.printf("%+10.3f ", relativeUs / 1000.0f);
+        switch (record.kind) {
+            case RECORD_INPUT: {
+                InputSnapshot snapshot;
+                if (record.type == InputReplay::kFormatVersion &&
+                    InputReplay::decodeSnapshot(payload, record.length, snapshot)) {
+                    out.printf("IN   A %+.2f %+.2f  B %+.2f %+.2f  pot %.2f  btn %02X  enc %d",
+                               snapshot.joystickA_X, snapshot.joystickA_Y, snapshot.joystickB_X,
+                               snapshot.joystickB_Y, snapshot.potentiometer, snapshot.debounced,
+                               snapshot.encoderCount);
+                } else {
+                    out.printf("IN   v%u, %u bytes", record.type, record.length);
+                }
+                break;
+            }
+            case RECORD_COMMAND:
+                printPacket(out, "TX  ", record, payload, module, true);
+                break;
+            case RECORD_TELEMETRY:
+                printPacket(out, "RX  ", record, payload, module, false);
+                break;
+            case RECORD_LINK: {
+                LinkSample sample = {};
+                memcpy(&sample, payload, record.length < sizeof(sample) ? record.length : sizeof(sample));
+                out.printf("LINK rssi %d dBm  loss %u%%  tx ok %u%%  rtt %lu us  tx fail %lu  rx %lu",
+                           sample.rssiDbm, sample.lossPercent, sample.txSuccessPercent,
+                           static_cast<unsigned long>(sample.rttUs), static_cast<unsigned long>(sample.txFail),
+                           static_cast<unsigned long>(sample.rxFrames));
+                break;
+            }
+            case RECORD_TRIGGER:
+                out.printf("TRIG %s", name(static_cast<BlackBoxTrigger>(record.type)));
+                break;
+            default:
+                out.printf("?    kind %u", record.kind);
+                break;
+        }
+        out.println();
+        printed++;
+    }
+    out.printf("[BlackBox] %lu records\n", static_cast<unsigned long>(printed));
+}
+
+void BlackBox::dump(Print& out) {
+    size_t used;
+    uint32_t records;
+    State state;
+    portENTER_CRITICAL(&g_lock);
+    used = g_used;
+    records = g_records;
+    state = g_state;
+    portEXIT_CRITICAL(&g_lock);
+
+    out.printf("[BlackBox] %s, ring %u/%u bytes, %lu records\n",
+               g_ring == nullptr ? "off" : state == State::Recording ? "recording"
+                                         : state == State::Tail      ? "triggered"
+                                                                     : "saving",
+               static_cast<unsigned>(used), static_cast<unsigned>(kRingBytes), static_cast<unsigned long>(records));
+    out.printf("[BlackBox] written %lu, evicted %lu, truncated %lu, %lu captures saved, %lu triggers ignored\n",
+               static_cast<unsigned long>(stats_.records), static_cast<unsigned long>(stats_.evicted),
+               static_cast<unsigned long>(stats_.truncated), static_cast<unsigned long>(stats_.captures),
+               static_cast<unsigned long>(stats_.ignoredTriggers));
+    if (g_partition != nullptr) {
+        out.printf("[BlackBox] slot %lu/%lu next, %lu/%lu sectors erased, %lu paired erases, max flash op %lu us\n",
+                   static_cast<unsigned long>(g_nextSlot), static_cast<unsigned long>(g_slotCount),
+                   static_cast<unsigned long>(g_erasedSectors),
+                   static_cast<unsigned long>(kSlotBytes / kSectorSize),
+                   static_cast<unsigned long>(stats_.pairedErases), static_cast<unsigned long>(stats_.maxFlushUs));
+    } else {
+        out.println("[BlackBox] No partition: captures are not saved");
+    }
+}
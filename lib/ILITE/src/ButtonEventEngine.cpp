@@ -15,6 +15,7 @@
 
 ButtonEventTracker::ButtonEventTracker(uint8_t pin, uint32_t longPressMs)
     : pin_(pin)
+    , bit_(ButtonSampler::bitForPin(pin))
     , longPressThreshold_(longPressMs)
     , state_(ButtonState::IDLE)
     , previousState_(ButtonState::IDLE)
@@ -22,33 +23,18 @@ ButtonEventTracker::ButtonEventTracker(uint8_t pin, uint32_t longPressMs)
     , lastReading_(false)
     , longPressFired_(false)
     , callback_(nullptr)
-    , lastDebounceTime_(0)
-    , lastRawReading_(false)
 {
 }
 
-ButtonEvent ButtonEventTracker::update() {
-    // Read raw pin state (buttons are active LOW with INPUT_PULLUP)
-    bool rawReading = (digitalRead(pin_) == LOW);
-
-    // TEMP DEBUG: Show encoder button state
-    if (pin_ == 18) {  // encoderBtn
-        static bool lastDebugReading = false;
-        if (rawReading != lastDebugReading) {
-            Serial.printf("[ButtonEventTracker] Pin 18 raw state: %s\n", rawReading ? "LOW (PRESSED)" : "HIGH (NOT PRESSED)");
-            lastDebugReading = rawReading;
-        }
-    }
-
-    // Debouncing logic
-    if (rawReading != lastRawReading_) {
-        lastDebounceTime_ = millis();
-    }
-    lastRawReading_ = rawReading;
-
-    // Only update if stable for DEBOUNCE_MS
-    if ((millis() - lastDebounceTime_) > DEBOUNCE_MS) {
-        lastReading_ = rawReading;
+ButtonEvent ButtonEventTracker::update(const ButtonChanges& changes) {
+    // Debounced by ButtonSampler; a press edge also covers taps shorter than our period
+    const bool level = (changes.levels & bit_) != 0;
+    const bool pressedEdge = (changes.pressed & bit_) != 0;
+    const bool releasedEdge = (changes.released & bit_) != 0;
+    if (state_ == ButtonState::IDLE) {
+        lastReading_ = level || pressedEdge;
+    } else {
+        lastReading_ = level && !releasedEdge;
     }
 
     // State machine
@@ -177,9 +163,10 @@ void ButtonEventEngine::begin() {
 }
 
 void ButtonEventEngine::update() {
-    // Update all button state machines
+    // One debounced sample set shared by all state machines
+    const ButtonChanges changes = ButtonSampler::getInstance().collect(cursor_);
     for (int i = 0; i < BUTTON_COUNT; i++) {
-        lastEvents_[i] = buttons_[i].update();
+        lastEvents_[i] = buttons_[i].update(changes);
     }
 }
 
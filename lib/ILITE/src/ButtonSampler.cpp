@@ -0,0 +1,220 @@
+/**
+ * @file ButtonSampler.cpp
+ * @brief 1 kHz button debouncing and edge queue
+ */
+
+#include "ButtonSampler.h"
+#include "input.h"
+#include "PowerManager.h"
+#include <soc/gpio_reg.h>
+#include <cstring>
+
+// All buttons must sit in the GPIO_IN_REG bank for the single-read path
+static_assert(button1 < 32 && button2 < 32 && button3 < 32 &&
+              joystickBtnA < 32 && joystickBtnB < 32 && encoderBtn < 32,
+              "Buttons must be on GPIO 0-31");
+
+static_assert((ButtonSampler::kQueueSize & (ButtonSampler::kQueueSize - 1)) == 0,
+              "kQueueSize must be a power of 2");
+
+namespace {
+
+struct ButtonPin {
+    uint8_t pin;
+    uint8_t bit;
+};
+
+constexpr ButtonPin kButtonPins[ButtonSampler::kButtonCount] = {
+    {button1, ButtonSampler::BUTTON_1},
+    {button2, ButtonSampler::BUTTON_2},
+    {button3, ButtonSampler::BUTTON_3},
+    {joystickBtnA, ButtonSampler::JOY_BUTTON_A},
+    {joystickBtnB, ButtonSampler::JOY_BUTTON_B},
+    {encoderBtn, ButtonSampler::ENCODER_BUTTON},
+};
+
+}  // namespace
+
+// ============================================================================
+// Singleton
+// ============================================================================
+
+ButtonSampler& ButtonSampler::getInstance() {
+    static ButtonSampler instance;
+    return instance;
+}
+
+ButtonSampler::ButtonSampler()
+    : head_(0),
+      levels_(0),
+      raw_(0),
+      pending_(0),
+      timer_(nullptr),
+      running_(false)
+{
+    memset(queue_, 0, sizeof(queue_));
+    memset(pendingSinceMs_, 0, sizeof(pendingSinceMs_));
+}
+
+uint8_t ButtonSampler::bitForPin(uint8_t pin) {
+    for (const ButtonPin& button : kButtonPins) {
+        if (button.pin == pin) {
+            return button.bit;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool ButtonSampler::begin() {
+    if (running_) {
+        return true;
+    }
+
+    // Start from the current levels so held buttons don't report a press
+    const uint8_t levels = readButtonLevels();
+    raw_.store(levels, std::memory_order_relaxed);
+    levels_.store(levels, std::memory_order_release);
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &ButtonSampler::timerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "btn_sample";
+
+    if (esp_timer_create(&timerArgs, &timer_) != ESP_OK) {
+        timer_ = nullptr;
+        return false;
+    }
+    if (esp_timer_start_periodic(timer_, kSamplePeriodUs) != ESP_OK) {
+        esp_timer_delete(timer_);
+        timer_ = nullptr;
+        return false;
+    }
+
+    running_ = true;
+    return true;
+}
+
+void ButtonSampler::poll() {
+    if (!running_) {
+        sample();
+    }
+}
+
+// ============================================================================
+// Sampling (esp_timer task)
+// ============================================================================
+
+void ButtonSampler::timerCallback(void* arg) {
+    static_cast<ButtonSampler*>(arg)->sample();
+}
+
+uint8_t ButtonSampler::readButtonLevels() {
+    // One read of GPIO 0-31; buttons are active-low with pull-ups
+    const uint32_t in = ~REG_READ(GPIO_IN_REG);
+    uint8_t levels = 0;
+    for (const ButtonPin& button : kButtonPins) {
+        if (in & (1UL << button.pin)) {
+            levels |= button.bit;
+        }
+    }
+    return levels;
+}
+
+void ButtonSampler::sample() {
+    const uint8_t raw = readButtonLevels();
+    raw_.store(raw, std::memory_order_relaxed);
+
+    uint8_t levels = levels_.load(std::memory_order_relaxed);
+    const uint8_t differing = raw ^ levels;
+    // Buttons back at their debounced level stop pending
+    uint8_t pending = pending_ & differing;
+    if (differing == 0) {
+        pending_ = 0;
+        return;
+    }
+
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < kButtonCount; ++i) {
+        const uint8_t bit = kButtonPins[i].bit;
+        if ((differing & bit) == 0) {
+            continue;
+        }
+        if ((pending & bit) == 0) {
+            pending |= bit;
+            pendingSinceMs_[i] = now;
+            continue;
+        }
+        if (now - pendingSinceMs_[i] < kDebounceMs) {
+            continue;
+        }
+
+        pending &= ~bit;
+        levels ^= bit;
+
+        ButtonEdge& edge = queue_[head & (kQueueSize - 1)];
+        edge.timeMs = now;
+        edge.button = bit;
+        edge.pressed = (levels & bit) != 0;
+        head++;
+    }
+
+    pending_ = pending;
+    levels_.store(levels, std::memory_order_release);
+    if (head != head_.load(std::memory_order_relaxed)) {
+        PowerManager::wake();       // Don't wait for an idle-rate tick
+    }
+    head_.store(head, std::memory_order_release);
+}
+
+// ============================================================================
+// Readers
+// ============================================================================
+
+size_t ButtonSampler::readEdges(Cursor& cursor, ButtonEdge* out, size_t maxEdges) {
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    if (head - cursor.tail > kQueueSize) {
+        // Fell behind; the oldest edges were overwritten
+        cursor.tail = head - kQueueSize;
+    }
+
+    const uint32_t start = cursor.tail;
+    size_t count = 0;
+    while (cursor.tail != head && count < maxEdges) {
+        out[count++] = queue_[cursor.tail & (kQueueSize - 1)];
+        cursor.tail++;
+    }
+
+    // Drop copies of slots the writer reused while we were reading
+    const uint32_t after = head_.load(std::memory_order_acquire);
+    if (after - start > kQueueSize) {
+        const uint32_t lost = after - start - kQueueSize;
+        if (lost >= count) {
+            cursor.tail = after - kQueueSize;
+            return 0;
+        }
+        memmove(out, out + lost, (count - lost) * sizeof(ButtonEdge));
+        count -= lost;
+    }
+    return count;
+}
+
+ButtonChanges ButtonSampler::collect(Cursor& cursor) {
+    ButtonChanges changes;
+    ButtonEdge edges[kQueueSize];
+    const size_t count = readEdges(cursor, edges, kQueueSize);
+    for (size_t i = 0; i < count; ++i) {
+        if (edges[i].pressed) {
+            changes.pressed |= edges[i].button;
+        } else {
+            changes.released |= edges[i].button;
+        }
+    }
+    changes.levels = getLevels();
+    return changes;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file ChannelSurvey.cpp
+ * @brief Promiscuous channel dwell, candidate scoring and the hop policy
+ */
+
+#include "ChannelSurvey.h"
+#include "espnow_discovery.h"
+#include "LinkMetrics.h"
+#include "LinkRate.h"
+#include "LogChannels.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+
+namespace {
+
+// Fixed-rate airtime estimate: OFDM preamble plus the frame at 6 Mbit/s
+constexpr uint32_t kPreambleUs = 20;
+constexpr uint32_t kAssumedMbps = 6;
+
+// 20 MHz channels 5 apart do not overlap
+constexpr int kOverlapSpan = 5;
+
+constexpr size_t kCandidateCount = sizeof(kChannelCandidates) / sizeof(kChannelCandidates[0]);
+
+ChannelActivity g_activity[kMaxWifiChannel + 1];
+bool g_surveyed = false;
+
+// Written by the promiscuous callback (WiFi task) during a dwell, read after it
+volatile uint32_t g_dwellFrames = 0;
+volatile uint32_t g_dwellBusyUs = 0;
+volatile int8_t g_dwellPeakRssi = -128;
+
+// Hop policy, ServiceTask only
+bool g_autoHop = false;
+uint32_t g_windowStartMs = 0;
+uint32_t g_lastTxOk = 0;
+uint32_t g_lastTxFail = 0;
+bool g_haveBaseline = false;
+uint8_t g_degradedWindows = 0;
+uint32_t g_lastHopMs = 0;
+uint32_t g_hops = 0;
+
+void surveyCallback(void* buffer, wifi_promiscuous_pkt_type_t type) {
+    (void)type;
+    const wifi_promiscuous_pkt_t* packet = static_cast<const wifi_promiscuous_pkt_t*>(buffer);
+    g_dwellFrames = g_dwellFrames + 1;
+    g_dwellBusyUs = g_dwellBusyUs + kPreambleUs + packet->rx_ctrl.sig_len * 8 / kAssumedMbps;
+    const int8_t rssi = static_cast<int8_t>(packet->rx_ctrl.rssi);
+    if (rssi > g_dwellPeakRssi) {
+        g_dwellPeakRssi = rssi;
+    }
+}
+
+void resetWindow() {
+    g_haveBaseline = false;
+    g_degradedWindows = 0;
+}
+
+}  // namespace
+
+// ============================================================================
+// Survey
+// ============================================================================
+
+uint8_t ChannelSurvey::run(uint32_t dwellMs) {
+    if ((WiFi.getMode() & WIFI_AP) != 0) {
+        return 0;
+    }
+    const uint8_t home = EspNowDiscovery::getChannel();
+
+    wifi_promiscuous_filter_t filter = {};
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_ALL;
+    esp_wifi_set_promiscuous_filter(&filter);
+    esp_wifi_set_promiscuous_rx_cb(&surveyCallback);
+    if (esp_wifi_set_promiscuous(true) != ESP_OK) {
+        Serial.println("[Channel] Promiscuous RX unavailable, no survey");
+        return 0;
+    }
+
+    for (uint8_t channel = 1; channel <= kMaxWifiChannel; ++channel) {
+        if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+            continue;
+        }
+        g_dwellFrames = 0;
+        g_dwellBusyUs = 0;
+        g_dwellPeakRssi = -128;
+        delay(dwellMs);
+        ChannelActivity& activity = g_activity[channel];
+        activity.frames = g_dwellFrames;
+        activity.busyUs = g_dwellBusyUs;
+        activity.peakRssi = g_dwellPeakRssi;
+    }
+
+    esp_wifi_set_promiscuous(false);
+    esp_wifi_set_promiscuous_rx_cb(nullptr);
+    if (home != 0) {
+        esp_wifi_set_channel(home, WIFI_SECOND_CHAN_NONE);
+    }
+    g_surveyed = true;
+
+    const uint8_t best = bestChannel();
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Channel survey: best %u (score %lu)", static_cast<unsigned>(best),
+              static_cast<unsigned long>(score(best)));
+    return best;
+}
+
+bool ChannelSurvey::hasResult() {
+    return g_surveyed;
+}
+
+const ChannelActivity& ChannelSurvey::getActivity(uint8_t channel) {
+    return g_activity[channel <= kMaxWifiChannel ? channel : 0];
+}
+
+uint32_t ChannelSurvey::score(uint8_t channel) {
+    uint32_t total = 0;
+    for (int other = 1; other <= kMaxWifiChannel; ++other) {
+        const int distance = other > channel ? other - channel : channel - other;
+        if (distance < kOverlapSpan) {
+            total += g_activity[other].busyUs / kOverlapSpan * (kOverlapSpan - distance);
+        }
+    }
+    return total;
+}
+
+uint8_t ChannelSurvey::bestChannel(uint8_t excluding) {
+    if (!g_surveyed) {
+        for (size_t i = 0; i < kCandidateCount; ++i) {
+            if (kChannelCandidates[i] == excluding) {
+                return kChannelCandidates[(i + 1) % kCandidateCount];
+            }
+        }
+        return kChannelCandidates[0];
+    }
+    uint8_t best = 0;
+    uint32_t bestScore = UINT32_MAX;
+    for (uint8_t candidate : kChannelCandidates) {
+        if (candidate == excluding) {
+            continue;
+        }
+        const uint32_t candidateScore = score(candidate);
+        if (candidateScore < bestScore) {
+            best = candidate;
+            bestScore = candidateScore;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// Hop policy
+// ============================================================================
+
+void ChannelSurvey::setAutoHop(bool enabled) {
+    g_autoHop = enabled;
+    resetWindow();
+}
+
+void ChannelSurvey::service(EspNowDiscovery& discovery, uint32_t now) {
+    if (!g_autoHop || !discovery.isPaired() || discovery.isChannelSwitchPending()) {
+        resetWindow();
+        return;
+    }
+    if (g_haveBaseline && now - g_windowStartMs < kEvalWindowMs) {
+        return;
+    }
+    const LinkPeerStats* stats = LinkMetrics::find(discovery.getPairedMac());
+    if (stats == nullptr) {
+        return;
+    }
+
+    const uint32_t ok = stats->txOk - g_lastTxOk;
+    const uint32_t fail = stats->txFail - g_lastTxFail;
+    g_lastTxOk = stats->txOk;
+    g_lastTxFail = stats->txFail;
+    g_windowStartMs = now;
+    if (!g_haveBaseline) {
+        g_haveBaseline = true;
+        return;
+    }
+
+    // Loss is the rate controller's to fix first
+    const uint32_t sends = ok + fail;
+    const bool lossy = sends >= kMinWindowSends && fail * 100 >= sends * kDegradedFailPercent &&
+                       !LinkRate::canStepDown();
+    const bool slow = stats->pongs > 0 && stats->rttAvgUs >= kDegradedRttUs;
+    g_degradedWindows = (lossy || slow) ? g_degradedWindows + 1 : 0;
+    if (g_degradedWindows < kDegradedWindows) {
+        return;
+    }
+    if (g_hops > 0 && now - g_lastHopMs < kHopCooldownMs) {
+        return;
+    }
+
+    const uint8_t current = EspNowDiscovery::getChannel();
+    const uint8_t next = bestChannel(current);
+    if (next == 0 || !discovery.requestChannelSwitch(next)) {
+        return;
+    }
+    g_hops++;
+    g_lastHopMs = now;
+    resetWindow();
+    ILITE_LOG(DISCOVERY, LOG_WARN, "Link degraded (%lu/%lu sends failed, rtt %lu us), hopping %u -> %u",
+              static_cast<unsigned long>(fail), static_cast<unsigned long>(sends),
+              static_cast<unsigned long>(stats->rttAvgUs), static_cast<unsigned>(current),
+              static_cast<unsigned>(next));
+}
+
+void ChannelSurvey::dump(Print& out, const EspNowDiscovery& discovery) {
+    out.printf("[Channel] on %u, auto hop %s, %lu hops, %lu switches, %lu reverts%s\n",
+               static_cast<unsigned>(EspNowDiscovery::getChannel()), g_autoHop ? "on" : "off",
+               static_cast<unsigned long>(g_hops),
+               static_cast<unsigned long>(discovery.getChannelSwitches()),
+               static_cast<unsigned long>(discovery.getChannelReverts()),
+               discovery.isChannelSwitchPending() ? " (switching)" : "");
+    if (!g_surveyed) {
+        out.println("[Channel] No survey yet (\"channel survey\" while unpaired)");
+        return;
+    }
+    out.println("[Channel] ch  frames  busy ms  peak dBm  score");
+    for (uint8_t channel = 1; channel <= kMaxWifiChannel; ++channel) {
+        const ChannelActivity& activity = g_activity[channel];
+        bool candidate = false;
+        for (uint8_t c : kChannelCandidates) {
+            candidate = candidate || c == channel;
+        }
+        char scoreText[12] = "";
+        if (candidate) {
+            snprintf(scoreText, sizeof(scoreText), "%lu", static_cast<unsigned long>(score(channel) / 1000));
+        }
+        out.printf("[Channel] %2u %7lu %8lu %9d %6s\n", static_cast<unsigned>(channel),
+                   static_cast<unsigned long>(activity.frames),
+                   static_cast<unsigned long>(activity.busyUs / 1000),
+                   activity.frames > 0 ? activity.peakRssi : 0, scoreText);
+    }
+}
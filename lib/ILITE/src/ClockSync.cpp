@@ -0,0 +1,211 @@
+/**
+ * @file ClockSync.cpp
+ * @brief Clock offset filter, skew fit and timestamp mapping
+ */
+
+#include "ClockSync.h"
+#include "LogChannels.h"
+#include <cmath>
+#include <cstring>
+
+uint8_t ClockSync::mac_[6] = {};
+ClockSync::Sample ClockSync::window_[ClockSync::kWindow] = {};
+size_t ClockSync::windowCount_ = 0;
+ClockSync::Sample ClockSync::anchors_[ClockSync::kAnchors] = {};
+size_t ClockSync::anchorHead_ = 0;
+size_t ClockSync::anchorCount_ = 0;
+uint32_t ClockSync::samples_ = 0;
+uint32_t ClockSync::rejected_ = 0;
+ClockSync::Estimate ClockSync::estimate_ = {};
+portMUX_TYPE ClockSync::lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// Sampling (RxTask)
+// ============================================================================
+
+void ClockSync::onPong(const uint8_t* mac, uint32_t sentUs, uint32_t robotRxUs,
+                       uint32_t robotTxUs, uint32_t receivedUs) {
+    if (mac == nullptr) {
+        return;
+    }
+
+    // reset() runs on ServiceTask when the link drops, so the filter state
+    // is only touched under the lock; the log lines wait until it is released
+    float rejectedPpm = 0.0f;
+    bool rejectedFit = false;
+    bool firstAnchor = false;
+    Estimate published{};
+    portENTER_CRITICAL(&lock_);
+    if (memcmp(mac, mac_, sizeof(mac_)) != 0) {
+        clear();
+        memcpy(mac_, mac, sizeof(mac_));
+    }
+    samples_++;
+
+    // Time the robot held the ping is not part of the path delay
+    const uint32_t roundTripUs = receivedUs - sentUs;
+    const uint32_t heldUs = robotTxUs - robotRxUs;
+    if (heldUs > roundTripUs || roundTripUs - heldUs > kMaxDelayUs) {
+        rejected_++;
+        portEXIT_CRITICAL(&lock_);
+        return;
+    }
+    const uint32_t delayUs = roundTripUs - heldUs;
+
+    // ((t2 - t1) + (t3 - t4)) / 2 == (t2 - t1) - delay / 2, without overflow
+    Sample& sample = window_[windowCount_++];
+    sample.localUs = sentUs + roundTripUs / 2;
+    sample.offsetUs = robotRxUs - sentUs - delayUs / 2;
+    sample.delayUs = delayUs;
+
+    if (windowCount_ >= kWindow) {
+        size_t best = 0;
+        for (size_t i = 1; i < kWindow; ++i) {
+            if (window_[i].delayUs < window_[best].delayUs) {
+                best = i;
+            }
+        }
+        windowCount_ = 0;
+        rejectedFit = !addAnchor(window_[best], rejectedPpm);
+        published = estimate_;
+        firstAnchor = published.anchors == 1;
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    if (rejectedFit) {
+        ILITE_LOG_RATE(DISCOVERY, LOG_WARN, 1, 3, "Clock skew fit out of range (%.0f ppm)", rejectedPpm);
+    }
+    if (firstAnchor) {
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Clock synced (offset %ld us, delay %lu us)",
+                  static_cast<long>(static_cast<int32_t>(published.baseOffsetUs)),
+                  static_cast<unsigned long>(published.delayUs));
+    }
+}
+
+bool ClockSync::addAnchor(const Sample& anchor, float& rejectedPpm) {
+    anchors_[anchorHead_] = anchor;
+    anchorHead_ = (anchorHead_ + 1) % kAnchors;
+    if (anchorCount_ < kAnchors) {
+        anchorCount_++;
+    }
+
+    Estimate next = estimate_;
+    next.synced = true;
+    next.delayUs = anchor.delayUs;
+    next.anchors++;
+    next.baseLocalUs = anchor.localUs;
+    next.baseOffsetUs = anchor.offsetUs;
+
+    bool accepted = true;
+    if (anchorCount_ >= kMinSkewAnchors) {
+        // Least-squares line through the anchors, relative to the oldest
+        const Sample& ref = anchors_[(anchorHead_ + kAnchors - anchorCount_) % kAnchors];
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (size_t i = 0; i < anchorCount_; ++i) {
+            const Sample& a = anchors_[(anchorHead_ + kAnchors - anchorCount_ + i) % kAnchors];
+            sumX += static_cast<int32_t>(a.localUs - ref.localUs);
+            sumY += static_cast<int32_t>(a.offsetUs - ref.offsetUs);
+        }
+        const double meanX = sumX / anchorCount_;
+        const double meanY = sumY / anchorCount_;
+        double sxx = 0.0;
+        double sxy = 0.0;
+        for (size_t i = 0; i < anchorCount_; ++i) {
+            const Sample& a = anchors_[(anchorHead_ + kAnchors - anchorCount_ + i) % kAnchors];
+            const double dx = static_cast<int32_t>(a.localUs - ref.localUs) - meanX;
+            const double dy = static_cast<int32_t>(a.offsetUs - ref.offsetUs) - meanY;
+            sxx += dx * dx;
+            sxy += dx * dy;
+        }
+
+        const double slope = sxx > 0.0 ? sxy / sxx : 0.0;
+        if (std::fabs(slope) * 1e6 <= kMaxSkewPpm) {
+            // The fitted offset at the newest anchor smooths its own noise
+            const double x = static_cast<int32_t>(anchor.localUs - ref.localUs);
+            const double fitted = meanY + slope * (x - meanX);
+            next.baseOffsetUs = ref.offsetUs + static_cast<uint32_t>(static_cast<int32_t>(std::lround(fitted)));
+            next.skew = static_cast<float>(slope);
+        } else {
+            rejected_++;
+            rejectedPpm = static_cast<float>(slope * 1e6);
+            accepted = false;
+        }
+    }
+
+    next.samples = samples_;
+    estimate_ = next;
+    return accepted;
+}
+
+void ClockSync::reset() {
+    portENTER_CRITICAL(&lock_);
+    clear();
+    portEXIT_CRITICAL(&lock_);
+}
+
+void ClockSync::clear() {
+    memset(mac_, 0, sizeof(mac_));
+    windowCount_ = 0;
+    anchorHead_ = 0;
+    anchorCount_ = 0;
+    samples_ = 0;
+    rejected_ = 0;
+    estimate_ = Estimate{};
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+ClockSync::Estimate ClockSync::snapshot() {
+    portENTER_CRITICAL(&lock_);
+    const Estimate estimate = estimate_;
+    portEXIT_CRITICAL(&lock_);
+    return estimate;
+}
+
+bool ClockSync::isSynced() {
+    return snapshot().synced;
+}
+
+uint32_t ClockSync::toLocalUs(uint32_t robotUs) {
+    const Estimate estimate = snapshot();
+    if (!estimate.synced) {
+        return robotUs;
+    }
+    // The drift term only needs the local time to within the offset's change
+    const uint32_t approxUs = robotUs - estimate.baseOffsetUs;
+    const float sinceBaseUs = static_cast<float>(static_cast<int32_t>(approxUs - estimate.baseLocalUs));
+    const int32_t driftUs = static_cast<int32_t>(estimate.skew * sinceBaseUs);
+    return robotUs - (estimate.baseOffsetUs + static_cast<uint32_t>(driftUs));
+}
+
+uint32_t ClockSync::getOffsetUs() {
+    const Estimate estimate = snapshot();
+    const float sinceBaseUs = static_cast<float>(static_cast<int32_t>(micros() - estimate.baseLocalUs));
+    return estimate.baseOffsetUs + static_cast<uint32_t>(static_cast<int32_t>(estimate.skew * sinceBaseUs));
+}
+
+float ClockSync::getSkewPpm() {
+    return snapshot().skew * 1e6f;
+}
+
+uint32_t ClockSync::getDelayUs() {
+    return snapshot().delayUs;
+}
+
+void ClockSync::dump(Print& out) {
+    const Estimate estimate = snapshot();
+    if (!estimate.synced) {
+        out.printf("[Clock] Not synced (%lu samples, %lu rejected)\n",
+                   static_cast<unsigned long>(samples_), static_cast<unsigned long>(rejected_));
+        return;
+    }
+    out.printf("[Clock] offset=%ld us skew=%.2f ppm delay=%lu us anchors=%lu samples=%lu rejected=%lu\n",
+               static_cast<long>(static_cast<int32_t>(getOffsetUs())), getSkewPpm(),
+               static_cast<unsigned long>(estimate.delayUs),
+               static_cast<unsigned long>(estimate.anchors),
+               static_cast<unsigned long>(samples_),
+               static_cast<unsigned long>(rejected_));
+}
@@ -0,0 +1,127 @@
+/**
+ * @file CommandSchedule.cpp
+ * @brief Command type phases, due checks and achieved rates
+ */
+
+#include "CommandSchedule.h"
+#include "ILITEModule.h"
+#include <cstring>
+
+CommandSchedule::CommandSchedule()
+    : count_(0),
+      windowStartUs_(0),
+      loaded_(false)
+{
+    memset(types_, 0, sizeof(types_));
+}
+
+void CommandSchedule::reset() {
+    loaded_ = false;
+}
+
+void CommandSchedule::load(const PacketDescriptor* descriptors, size_t count, uint32_t nowUs,
+                           uint32_t tickUs) {
+    count_ = count < kMaxTypes ? count : kMaxTypes;
+
+    // Slow types take consecutive ticks of their period in index order
+    size_t slowIndex = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        const PacketDescriptor& desc = descriptors[i];
+        Type& type = types_[i];
+        type.periodUs = static_cast<uint32_t>(desc.periodMs) * 1000;
+        type.nextDueUs = nowUs;
+        type.built = 0;
+        type.sent = 0;
+        if (type.periodUs > tickUs && tickUs > 0) {
+            const uint32_t ticksPerPeriod = type.periodUs / tickUs;
+            type.nextDueUs += static_cast<uint32_t>(slowIndex++ % ticksPerPeriod) * tickUs;
+        } else {
+            type.periodUs = 0;
+        }
+        rates_[i] = CommandTypeRate{};
+        rates_[i].periodMs = desc.periodMs;
+        rates_[i].priority = desc.priority;
+    }
+    windowStartUs_ = nowUs;
+    loaded_ = true;
+}
+
+size_t CommandSchedule::plan(const PacketDescriptor* descriptors, size_t count, uint32_t nowUs,
+                             uint32_t tickUs, uint8_t* due) {
+    if (!loaded_) {
+        load(descriptors, count, nowUs, tickUs);
+    }
+
+    const uint32_t windowUs = nowUs - windowStartUs_;
+    if (windowUs >= kRateWindowUs) {
+        const float seconds = windowUs / 1000000.0f;
+        for (size_t i = 0; i < count_; ++i) {
+            rates_[i].builtHz = types_[i].built / seconds;
+            rates_[i].sentHz = types_[i].sent / seconds;
+            types_[i].built = 0;
+            types_[i].sent = 0;
+        }
+        windowStartUs_ = nowUs;
+    }
+
+    size_t dueCount = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        Type& type = types_[i];
+        if (type.periodUs != 0) {
+            // Half a tick of slack, so timer jitter does not push a type a whole tick late
+            if (static_cast<int32_t>(nowUs + tickUs / 2 - type.nextDueUs) < 0) {
+                continue;
+            }
+            type.nextDueUs += type.periodUs;
+            if (static_cast<int32_t>(nowUs - type.nextDueUs) >= 0) {
+                type.nextDueUs = nowUs + type.periodUs;  // Fell behind; no catch-up burst
+            }
+        }
+
+        // Insert by priority, after the equal ones
+        size_t at = dueCount;
+        while (at > 0 && rates_[due[at - 1]].priority < rates_[i].priority) {
+            due[at] = due[at - 1];
+            at--;
+        }
+        due[at] = static_cast<uint8_t>(i);
+        dueCount++;
+    }
+    return dueCount;
+}
+
+void CommandSchedule::onBuilt(size_t typeIndex) {
+    if (typeIndex < count_) {
+        types_[typeIndex].built++;
+    }
+}
+
+void CommandSchedule::onSent(size_t typeIndex) {
+    if (typeIndex < count_) {
+        types_[typeIndex].sent++;
+    }
+}
+
+void CommandSchedule::dump(Print& out, const ILITEModule* module) const {
+    if (!loaded_ || count_ == 0) {
+        out.println("[Sched] No command types scheduled");
+        return;
+    }
+    out.println("[Sched] type             period prio  built/s  sent/s");
+    for (size_t i = 0; i < count_; ++i) {
+        const CommandTypeRate& rate = rates_[i];
+        const char* name = "?";
+        if (module != nullptr && i < module->getCommandPacketTypeCount()) {
+            const char* described = module->getCommandPacketDescriptor(i).name;
+            name = described != nullptr ? described : "?";
+        }
+        char period[12];
+        if (rate.periodMs == 0) {
+            snprintf(period, sizeof(period), "tick");
+        } else {
+            snprintf(period, sizeof(period), "%ums", static_cast<unsigned>(rate.periodMs));
+        }
+        out.printf("[Sched] %u %-14.14s %6s %4u %8.1f %7.1f\n", static_cast<unsigned>(i), name,
+                   period, static_cast<unsigned>(rate.priority), rate.builtHz, rate.sentHz);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file CommandStamp.cpp
+ * @brief Command stamp framing and end-to-end latency statistics
+ */
+
+#include "CommandStamp.h"
+#include <esp_timer.h>
+#include <cstring>
+
+CommandLatencyStats CommandLatency::stats_;
+
+const uint32_t CommandLatency::kBucketUs[kCommandLatencyBuckets] = {
+    5000, 10000, 20000, 30000, 50000, 75000, 100000, UINT32_MAX
+};
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+size_t writeStampedFrame(uint8_t* out, size_t capacity, const CommandStampHeader& header,
+                         const uint8_t* frame, size_t length) {
+    if (out == nullptr || frame == nullptr || kCommandStampSize + length > capacity) {
+        return 0;
+    }
+    memcpy(out, &header, kCommandStampSize);
+    memcpy(out + kCommandStampSize, frame, length);
+    return kCommandStampSize + length;
+}
+
+const uint8_t* unwrapStampedFrame(const uint8_t* data, size_t length, uint32_t magic,
+                                  CommandStampHeader& header, size_t& innerLength) {
+    if (data == nullptr || length <= kCommandStampSize) {
+        return nullptr;
+    }
+    memcpy(&header, data, kCommandStampSize);
+    if (header.magic != magic) {
+        return nullptr;
+    }
+    innerLength = length - kCommandStampSize;
+    return data + kCommandStampSize;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+CommandStampHeader CommandLatency::nextStamp(uint32_t inputUs) {
+    CommandStampHeader header;
+    header.magic = STAMP_PACKET_MAGIC;
+    header.sequence = ++stats_.lastSentSeq;
+    header.inputUs = inputUs;
+    return header;
+}
+
+void CommandLatency::onEcho(const CommandStampHeader& echo) {
+    CommandLatencyStats& stats = stats_;
+
+    // The robot repeats its last applied stamp until a newer one arrives
+    if (static_cast<int32_t>(echo.sequence - stats.lastEchoSeq) <= 0) {
+        return;
+    }
+    if (stats.echoes > 0) {
+        stats.skippedSeq += echo.sequence - stats.lastEchoSeq - 1;
+    }
+    stats.lastEchoSeq = echo.sequence;
+
+    const uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time()) - echo.inputUs;
+    stats.lastUs = latencyUs;
+    if (stats.echoes == 0 || latencyUs < stats.minUs) {
+        stats.minUs = latencyUs;
+    }
+    if (latencyUs > stats.maxUs) {
+        stats.maxUs = latencyUs;
+    }
+    stats.avgUs = stats.echoes == 0
+        ? latencyUs
+        : static_cast<uint32_t>((static_cast<uint64_t>(stats.avgUs) * 7 + latencyUs) / 8);
+    stats.echoes++;
+
+    size_t bucket = 0;
+    while (latencyUs > kBucketUs[bucket] && bucket < kCommandLatencyBuckets - 1) {
+        ++bucket;
+    }
+    stats.histogram[bucket]++;
+}
+
+void CommandLatency::reset() {
+    const uint32_t lastSent = stats_.lastSentSeq;
+    stats_ = CommandLatencyStats{};
+    // Keep numbering monotonic so the robot never sees the sequence go back
+    stats_.lastSentSeq = lastSent;
+    stats_.lastEchoSeq = lastSent;
+}
+
+void CommandLatency::dump(Print& out) {
+    const CommandLatencyStats& stats = stats_;
+    out.printf("[CmdLatency] sent=%lu echoed=%lu skipped=%lu outstanding=%lu\n",
+               static_cast<unsigned long>(stats.lastSentSeq),
+               static_cast<unsigned long>(stats.echoes),
+               static_cast<unsigned long>(stats.skippedSeq),
+               static_cast<unsigned long>(getOutstanding()));
+    out.printf("[CmdLatency] input->echo us: last=%lu min=%lu avg=%lu max=%lu\n",
+               static_cast<unsigned long>(stats.lastUs),
+               static_cast<unsigned long>(stats.minUs),
+               static_cast<unsigned long>(stats.avgUs),
+               static_cast<unsigned long>(stats.maxUs));
+    out.print("[CmdLatency] hist (<=5/10/20/30/50/75/100/+ ms):");
+    for (size_t i = 0; i < kCommandLatencyBuckets; ++i) {
+        out.printf(" %lu", static_cast<unsigned long>(stats.histogram[i]));
+    }
+    out.println();
+}
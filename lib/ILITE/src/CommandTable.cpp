@@ -0,0 +1,308 @@
+/**
+ * @file CommandTable.cpp
+ * @brief Hash-and-displace index, tokenizer and argument conversion
+ */
+
+#include "CommandTable.h"
+#include "LogChannels.h"
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+namespace {
+
+constexpr uint32_t kFnvOffset = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+constexpr uint8_t kSlotBits = 7;            // log2(CommandTable::kSlots)
+constexpr size_t kMaxWords = 2 + CommandArgs::kMaxArgs + 1;   // One extra to spot surplus arguments
+
+static_assert(CommandTable::kSlots == (1u << kSlotBits), "kSlotBits must match kSlots");
+static_assert(CommandTable::kMaxCommands < 0xFF, "Slot entries are uint8_t");
+
+char lower(char c) {
+    return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+}
+
+uint32_t hashAppend(uint32_t hash, const char* text) {
+    for (; *text != '\0'; ++text) {
+        hash = (hash ^ static_cast<uint8_t>(lower(*text))) * kFnvPrime;
+    }
+    return hash;
+}
+
+/// Hash of the words joined by one space, the form names are written in
+uint32_t hashWords(const char* const* words, size_t wordCount) {
+    uint32_t hash = kFnvOffset;
+    for (size_t i = 0; i < wordCount; ++i) {
+        if (i > 0) {
+            hash = (hash ^ static_cast<uint8_t>(' ')) * kFnvPrime;
+        }
+        hash = hashAppend(hash, words[i]);
+    }
+    return hash;
+}
+
+size_t bucketOf(uint32_t hash) {
+    return hash & (CommandTable::kBuckets - 1);
+}
+
+size_t slotOf(uint32_t hash, uint8_t displacement) {
+    return ((hash ^ (displacement * 0x9E3779B1u)) * 0x85EBCA6Bu) >> (32 - kSlotBits);
+}
+
+bool matchesWords(const char* name, const char* const* words, size_t wordCount) {
+    for (size_t i = 0; i < wordCount; ++i) {
+        if (i > 0 && *name++ != ' ') {
+            return false;
+        }
+        for (const char* w = words[i]; *w != '\0'; ++w, ++name) {
+            if (lower(*name) != lower(*w)) {
+                return false;
+            }
+        }
+    }
+    return *name == '\0';
+}
+
+bool startsWith(const char* name, const char* prefix) {
+    for (; *prefix != '\0'; ++prefix, ++name) {
+        if (lower(*name) != lower(*prefix)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Split `line` in place on blanks
+size_t tokenize(char* line, char* words[], size_t maxWords) {
+    size_t count = 0;
+    char* cursor = line;
+    while (count < maxWords) {
+        while (*cursor == ' ' || *cursor == '\t') {
+            ++cursor;
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+        words[count++] = cursor;
+        while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t') {
+            ++cursor;
+        }
+        if (*cursor != '\0') {
+            *cursor++ = '\0';
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+// ============================================================================
+// Index
+// ============================================================================
+
+bool CommandTable::assign(const CommandSpec* specs, size_t count) {
+    specs_ = specs;
+    count_ = specs != nullptr ? count : 0;
+    perfect_ = buildIndex();
+    if (!perfect_ && count_ > 0) {
+        ILITE_LOG(SYSTEM, LOG_WARN, "[Commands] No perfect index for %u commands; scanning",
+                  static_cast<unsigned>(count_));
+    }
+    return perfect_;
+}
+
+bool CommandTable::buildIndex() {
+    memset(displacement_, 0, sizeof(displacement_));
+    memset(slots_, kEmpty, sizeof(slots_));
+    if (count_ > kMaxCommands) {
+        return false;
+    }
+
+    uint32_t hashes[kMaxCommands];
+    uint8_t bucketSize[kBuckets] = {};
+    for (size_t i = 0; i < count_; ++i) {
+        hashes[i] = hashAppend(kFnvOffset, specs_[i].name);
+        bucketSize[bucketOf(hashes[i])]++;
+    }
+
+    // Fullest buckets first, while most slots are free
+    bool placed[kBuckets] = {};
+    for (size_t round = 0; round < kBuckets; ++round) {
+        size_t bucket = kBuckets;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            if (!placed[b] && (bucket == kBuckets || bucketSize[b] > bucketSize[bucket])) {
+                bucket = b;
+            }
+        }
+        placed[bucket] = true;
+        if (bucketSize[bucket] == 0) {
+            break;
+        }
+
+        uint8_t members[kMaxCommands];
+        size_t memberCount = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            if (bucketOf(hashes[i]) == bucket) {
+                members[memberCount++] = static_cast<uint8_t>(i);
+            }
+        }
+
+        bool found = false;
+        for (uint16_t d = 0; d <= 0xFF && !found; ++d) {
+            size_t chosen[kMaxCommands];
+            found = true;
+            for (size_t m = 0; m < memberCount && found; ++m) {
+                chosen[m] = slotOf(hashes[members[m]], static_cast<uint8_t>(d));
+                found = slots_[chosen[m]] == kEmpty;
+                for (size_t k = 0; k < m && found; ++k) {
+                    found = chosen[k] != chosen[m];
+                }
+            }
+            if (found) {
+                displacement_[bucket] = static_cast<uint8_t>(d);
+                for (size_t m = 0; m < memberCount; ++m) {
+                    slots_[chosen[m]] = members[m];
+                }
+            }
+        }
+        if (!found) {
+            // Duplicate names always end here: equal hashes never separate
+            return false;
+        }
+    }
+    return true;
+}
+
+const CommandSpec* CommandTable::lookup(const char* const* words, size_t wordCount) const {
+    if (wordCount == 0 || count_ == 0) {
+        return nullptr;
+    }
+    if (perfect_) {
+        const uint32_t hash = hashWords(words, wordCount);
+        const uint8_t index = slots_[slotOf(hash, displacement_[bucketOf(hash)])];
+        if (index == kEmpty) {
+            return nullptr;
+        }
+        return matchesWords(specs_[index].name, words, wordCount) ? &specs_[index] : nullptr;
+    }
+    for (size_t i = 0; i < count_; ++i) {
+        if (matchesWords(specs_[i].name, words, wordCount)) {
+            return &specs_[i];
+        }
+    }
+    return nullptr;
+}
+
+const CommandSpec* CommandTable::find(const char* name) const {
+    if (name == nullptr) {
+        return nullptr;
+    }
+    char buffer[kMaxLine];
+    strncpy(buffer, name, sizeof(buffer));
+    buffer[sizeof(buffer) - 1] = '\0';
+    char* words[2];
+    const size_t wordCount = tokenize(buffer, words, 2);
+    return lookup(words, wordCount);
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+CommandResult CommandTable::dispatch(const char* line, Print& out) const {
+    if (line == nullptr) {
+        return CommandResult::Unknown;
+    }
+    char buffer[kMaxLine];
+    strncpy(buffer, line, sizeof(buffer));
+    buffer[sizeof(buffer) - 1] = '\0';
+    char* words[kMaxWords];
+    const size_t wordCount = tokenize(buffer, words, kMaxWords);
+
+    // Two-word names take precedence: "log clear" over "log <channel> <level>"
+    size_t first = 2;
+    const CommandSpec* spec = wordCount >= 2 ? lookup(words, 2) : nullptr;
+    if (spec == nullptr) {
+        first = 1;
+        spec = lookup(words, 1);
+    }
+    if (spec == nullptr) {
+        return CommandResult::Unknown;
+    }
+
+    CommandArgs args;
+    bool valid = true;
+    bool optional = false;
+    size_t next = first;
+    for (const char* schema = spec->args != nullptr ? spec->args : ""; *schema != '\0' && valid; ++schema) {
+        if (*schema == '?') {
+            optional = true;
+            continue;
+        }
+        if (next >= wordCount || args.count >= CommandArgs::kMaxArgs) {
+            valid = optional;
+            break;
+        }
+        const char* text = words[next++];
+        char* end = nullptr;
+        CommandArgs::Value& value = args.value_[args.count];
+        switch (*schema) {
+            case 'u':
+                value.u = static_cast<uint32_t>(strtoul(text, &end, 10));
+                valid = *text != '-';
+                break;
+            case 'i':
+                value.i = static_cast<int32_t>(strtol(text, &end, 10));
+                break;
+            case 'x':
+                value.u = static_cast<uint32_t>(strtoul(text, &end, 16));
+                break;
+            case 'f':
+                value.f = strtof(text, &end);
+                break;
+            default:
+                value.u = 0;
+                break;
+        }
+        valid = valid && (end == nullptr || (end != text && *end == '\0'));
+        args.text[args.count++] = text;
+    }
+    valid = valid && next == wordCount;
+
+    if (!valid) {
+        out.printf("Usage: %s %s\n", spec->name, spec->usage != nullptr ? spec->usage : "");
+        return CommandResult::BadArgs;
+    }
+    if (spec->handler) {
+        spec->handler(args, out);
+    }
+    return CommandResult::Ran;
+}
+
+// ============================================================================
+// Completion
+// ============================================================================
+
+size_t CommandTable::complete(const char* prefix, const char** matches, size_t maxMatches) const {
+    size_t count = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        if (!startsWith(specs_[i].name, prefix != nullptr ? prefix : "")) {
+            continue;
+        }
+        if (matches != nullptr && count < maxMatches) {
+            matches[count] = specs_[i].name;
+        }
+        count++;
+    }
+    return count;
+}
+
+void CommandTable::dump(Print& out, const char* prefix) const {
+    for (size_t i = 0; i < count_; ++i) {
+        const CommandSpec& spec = specs_[i];
+        if (startsWith(spec.name, prefix != nullptr ? prefix : "")) {
+            out.printf("  %-16s %s\n", spec.name, spec.usage != nullptr ? spec.usage : "");
+        }
+    }
+}
@@ -5,14 +5,15 @@
 
 #include "ControlBindingSystem.h"
 #include "ScreenRegistry.h"
+#include "EncoderSampler.h"
 #include "input.h"  // Existing input pin definitions
-#include <algorithm>
+#include <cstring>
 
 // Static storage
-std::vector<ControlBinding> ControlBindingSystem::bindings_;
 bool ControlBindingSystem::enabled_ = true;
 ControlBindingSystem::ButtonState ControlBindingSystem::buttonStates_[7];
 ControlBindingSystem::EncoderState ControlBindingSystem::encoderState_;
+ButtonSampler::Cursor ControlBindingSystem::buttonCursor_;
 bool ControlBindingSystem::capturingModuleBindings_ = false;
 
 // Constants
@@ -31,7 +32,7 @@ void ControlBindingSystem::begin() {
     }
 
     // Initialize encoder state
-    encoderState_.lastCount = encoderCount;  // Use global from input.h
+    encoderState_.lastCount = EncoderSampler::getInstance().getPosition();
 
     Serial.println("[ControlBindingSystem] Initialized");
 }
@@ -40,29 +41,110 @@ void ControlBindingSystem::begin() {
 // Registration
 // ============================================================================
 
-void ControlBindingSystem::registerBinding(const ControlBinding& binding) {
-    ControlBinding stored = binding;
-    stored.moduleOwned = capturingModuleBindings_;
-    bindings_.push_back(stored);
+ControlBindingSystem::Table::Table() : freeHead(0), count(0) {
+    memset(heads, kNoSlot, sizeof(heads));
+    for (size_t i = 0; i < kMaxBindings; ++i) {
+        slots[i].next = (i + 1 < kMaxBindings) ? static_cast<uint8_t>(i + 1) : kNoSlot;
+        slots[i].generation = 0;
+        slots[i].used = false;
+    }
+}
+
+ControlBindingSystem::Table& ControlBindingSystem::table() {
+    static Table instance;
+    return instance;
+}
+
+bool ControlBindingSystem::registerBinding(const ControlBinding& binding) {
+    Table& t = table();
+    if (binding.input >= INPUT_COUNT || binding.event >= EVENT_COUNT) {
+        return false;
+    }
+    if (t.freeHead == kNoSlot) {
+        Serial.printf("[ControlBindingSystem] Binding pool full (%u), input %d event %d dropped\n",
+                      static_cast<unsigned>(kMaxBindings), binding.input, binding.event);
+        return false;
+    }
+
+    const uint8_t index = t.freeHead;
+    Slot& slot = t.slots[index];
+    t.freeHead = slot.next;
+
+    slot.binding = binding;
+    slot.binding.moduleOwned = capturingModuleBindings_;
+    slot.binding.standby = false;
+    slot.used = true;
+
+    // Insert after every binding of equal or higher priority (stable order)
+    uint8_t* link = &t.heads[binding.input][binding.event];
+    while (*link != kNoSlot && t.slots[*link].binding.priority >= binding.priority) {
+        link = &t.slots[*link].next;
+    }
+    slot.next = *link;
+    *link = index;
+    t.count++;
+
     Serial.printf("[ControlBindingSystem] Registered binding for input %d, event %d (priority %d)\n",
                   binding.input, binding.event, binding.priority);
+    return true;
 }
 
-std::vector<ControlBinding>& ControlBindingSystem::getAllBindings() {
-    return bindings_;
+size_t ControlBindingSystem::getBindingCount() {
+    return table().count;
+}
+
+void ControlBindingSystem::releaseSlot(Table& t, uint8_t index) {
+    Slot& slot = t.slots[index];
+    slot.binding.action = nullptr;
+    slot.binding.actionWithValue = nullptr;
+    slot.binding.condition = nullptr;
+    slot.used = false;
+    slot.generation++;
+    slot.next = t.freeHead;
+    t.freeHead = index;
+    t.count--;
 }
 
 void ControlBindingSystem::clear() {
-    bindings_.clear();
+    Table& t = table();
+    for (size_t input = 0; input < INPUT_COUNT; ++input) {
+        for (size_t event = 0; event < EVENT_COUNT; ++event) {
+            uint8_t index = t.heads[input][event];
+            while (index != kNoSlot) {
+                const uint8_t next = t.slots[index].next;
+                releaseSlot(t, index);
+                index = next;
+            }
+            t.heads[input][event] = kNoSlot;
+        }
+    }
 }
 
 void ControlBindingSystem::clearModuleBindings() {
-    bindings_.erase(
-        std::remove_if(bindings_.begin(), bindings_.end(),
-                       [](const ControlBinding& binding) {
-                           return binding.moduleOwned;
-                       }),
-        bindings_.end());
+    Table& t = table();
+    for (size_t input = 0; input < INPUT_COUNT; ++input) {
+        for (size_t event = 0; event < EVENT_COUNT; ++event) {
+            uint8_t* link = &t.heads[input][event];
+            while (*link != kNoSlot) {
+                const uint8_t index = *link;
+                if (t.slots[index].binding.moduleOwned && !t.slots[index].binding.standby) {
+                    *link = t.slots[index].next;
+                    releaseSlot(t, index);
+                } else {
+                    link = &t.slots[index].next;
+                }
+            }
+        }
+    }
+}
+
+void ControlBindingSystem::swapModuleBindings() {
+    Table& t = table();
+    for (Slot& slot : t.slots) {
+        if (slot.used && slot.binding.moduleOwned) {
+            slot.binding.standby = !slot.binding.standby;
+        }
+    }
 }
 
 void ControlBindingSystem::beginModuleCapture() {
@@ -90,33 +172,37 @@ void ControlBindingSystem::update() {
         return;
     }
 
-    uint32_t now = millis();
-
-    // Update all button states
-    updateButton(INPUT_BUTTON1, digitalRead(button1) == LOW);
-    updateButton(INPUT_BUTTON2, digitalRead(button2) == LOW);
-    updateButton(INPUT_BUTTON3, digitalRead(button3) == LOW);
-    updateButton(INPUT_JOYSTICK_A_BUTTON, digitalRead(joystickBtnA) == LOW);
-    updateButton(INPUT_JOYSTICK_B_BUTTON, digitalRead(joystickBtnB) == LOW);
-    updateButton(INPUT_ENCODER_BUTTON, digitalRead(encoderBtn) == LOW);
+    // Update all button states from the shared debounced source
+    const ButtonChanges changes = ButtonSampler::getInstance().collect(buttonCursor_);
+    updateButton(INPUT_BUTTON1, changes, ButtonSampler::BUTTON_1);
+    updateButton(INPUT_BUTTON2, changes, ButtonSampler::BUTTON_2);
+    updateButton(INPUT_BUTTON3, changes, ButtonSampler::BUTTON_3);
+    updateButton(INPUT_JOYSTICK_A_BUTTON, changes, ButtonSampler::JOY_BUTTON_A);
+    updateButton(INPUT_JOYSTICK_B_BUTTON, changes, ButtonSampler::JOY_BUTTON_B);
+    updateButton(INPUT_ENCODER_BUTTON, changes, ButtonSampler::ENCODER_BUTTON);
 
     // Update encoder
-    updateEncoder(encoderCount);  // Use global from input.h
+    updateEncoder(EncoderSampler::getInstance().getPosition());
 }
 
 // ============================================================================
 // Button State Management
 // ============================================================================
 
-void ControlBindingSystem::updateButton(ControlInput input, bool currentValue) {
+void ControlBindingSystem::updateButton(ControlInput input, const ButtonChanges& changes, uint8_t bit) {
     int stateIndex = getButtonStateIndex(input);
     if (stateIndex < 0) return;
 
     ButtonState& state = buttonStates_[stateIndex];
     uint32_t now = millis();
 
+    // A press edge counts even if already released, so short taps still click
     state.previous = state.current;
-    state.current = currentValue;
+    if (state.current) {
+        state.current = (changes.levels & bit) != 0 && (changes.released & bit) == 0;
+    } else {
+        state.current = (changes.levels & bit) != 0 || (changes.pressed & bit) != 0;
+    }
 
     // Press event (rising edge)
     if (state.current && !state.previous) {
@@ -150,15 +236,19 @@ void ControlBindingSystem::updateButton(ControlInput input, bool currentValue) {
     // Hold event (button held down)
     if (state.current && !state.holdFired) {
         // Check for custom hold duration bindings
-        for (const auto& binding : bindings_) {
-            if (binding.input == input && binding.event == EVENT_HOLD) {
-                uint32_t holdDuration = binding.duration > 0 ? binding.duration : 1000;
-                if ((now - state.pressTime) >= holdDuration) {
-                    if (checkCondition(binding)) {
-                        if (binding.action) {
-                            binding.action();
-                        }
-                        state.holdFired = true;
+        Table& t = table();
+        for (uint8_t index = t.heads[input][EVENT_HOLD]; index != kNoSlot; index = t.slots[index].next) {
+            const ControlBinding& binding = t.slots[index].binding;
+            uint32_t holdDuration = binding.duration > 0 ? binding.duration : 1000;
+            if ((now - state.pressTime) >= holdDuration) {
+                if (checkCondition(binding)) {
+                    const uint8_t generation = t.slots[index].generation;
+                    if (binding.action) {
+                        binding.action();
+                    }
+                    state.holdFired = true;
+                    if (t.slots[index].generation != generation) {
+                        break;  // The action cleared bindings; the list changed under us
                     }
                 }
             }
@@ -195,34 +285,42 @@ void ControlBindingSystem::updateEncoder(int currentCount) {
 // ============================================================================
 
 void ControlBindingSystem::triggerBindings(ControlInput input, ControlEvent event, int value) {
-    // Collect matching bindings
-    std::vector<const ControlBinding*> matchingBindings;
+    if (input >= INPUT_COUNT || event >= EVENT_COUNT) {
+        return;
+    }
 
-    for (const auto& binding : bindings_) {
-        if (binding.input == input && binding.event == event) {
-            if (checkCondition(binding)) {
-                matchingBindings.push_back(&binding);
-            }
+    // Collect matching bindings (lists are already sorted by priority, highest first)
+    Table& t = table();
+    uint8_t matches[kMaxBindings];
+    uint8_t generations[kMaxBindings];
+    size_t matchCount = 0;
+    for (uint8_t index = t.heads[input][event]; index != kNoSlot; index = t.slots[index].next) {
+        if (checkCondition(t.slots[index].binding)) {
+            matches[matchCount] = index;
+            generations[matchCount] = t.slots[index].generation;
+            matchCount++;
         }
     }
 
-    // Sort by priority (highest first)
-    std::sort(matchingBindings.begin(), matchingBindings.end(),
-              [](const ControlBinding* a, const ControlBinding* b) {
-                  return a->priority > b->priority;
-              });
-
-    // Execute bindings
-    for (const ControlBinding* binding : matchingBindings) {
-        if (input == INPUT_ENCODER_ROTATE && binding->actionWithValue) {
-            binding->actionWithValue(value);
-        } else if (binding->action) {
-            binding->action();
+    // Execute bindings; skip any an earlier action released
+    for (size_t i = 0; i < matchCount; ++i) {
+        const Slot& slot = t.slots[matches[i]];
+        if (!slot.used || slot.generation != generations[i]) {
+            continue;
+        }
+        if (input == INPUT_ENCODER_ROTATE && slot.binding.actionWithValue) {
+            slot.binding.actionWithValue(value);
+        } else if (slot.binding.action) {
+            slot.binding.action();
         }
     }
 }
 
 bool ControlBindingSystem::checkCondition(const ControlBinding& binding) {
+    if (binding.standby) {
+        return false;
+    }
+
     // Check screen condition
     if (binding.screenId != nullptr) {
         const Screen* activeScreen = ScreenRegistry::getActiveScreen();
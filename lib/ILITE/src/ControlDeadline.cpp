@@ -0,0 +1,182 @@
+/**
+ * @file ControlDeadline.cpp
+ * @brief Stage budgets, overrun history and the degraded-mode switch
+ */
+
+#include "ControlDeadline.h"
+#include "LogChannels.h"
+#include "RenderScheduler.h"
+#include <esp_timer.h>
+
+namespace {
+
+const char* const kStageNames[ControlDeadline::kStageCount] = {
+    "input", "ui", "control", "transmit"
+};
+
+uint8_t g_budgetPercent[ControlDeadline::kStageCount] = {10, 15, 40, 25};
+bool g_degradation = true;
+
+// CommTask only (the stats are also read for display)
+ControlStageStats g_stages[ControlDeadline::kStageCount];
+ControlDeadlineStats g_stats;
+volatile bool g_degraded = false;
+int64_t g_tickStartUs = 0;
+int64_t g_stageStartUs = 0;
+uint32_t g_periodUs = 0;
+uint32_t g_missed = 0;
+uint32_t g_tick = 0;
+uint16_t g_history = 0;         // Bit per tick, newest in bit 0: overran
+uint16_t g_controlHistory = 0;  // Bit per updateControl(): over its budget
+uint32_t g_lastOverrunMs = 0;
+
+uint8_t overrunsIn(uint16_t history) {
+    return static_cast<uint8_t>(__builtin_popcount(history));
+}
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void ControlDeadline::configure(const uint8_t budgetPercent[kStageCount], bool degradation) {
+    for (size_t i = 0; i < kStageCount; ++i) {
+        g_budgetPercent[i] = budgetPercent[i];
+    }
+    g_degradation = degradation;
+}
+
+// ============================================================================
+// Ticks
+// ============================================================================
+
+void ControlDeadline::beginTick(uint32_t periodUs, int64_t startUs, uint32_t missedTicks) {
+    g_tickStartUs = startUs;
+    g_stageStartUs = startUs;
+    g_missed = missedTicks;
+    if (periodUs != g_periodUs) {
+        g_periodUs = periodUs;
+        for (size_t i = 0; i < kStageCount; ++i) {
+            g_stages[i].budgetUs = periodUs / 100 * g_budgetPercent[i];
+        }
+    }
+}
+
+void ControlDeadline::endStage(ControlStage stage) {
+    const int64_t nowUs = esp_timer_get_time();
+    const uint32_t spentUs = static_cast<uint32_t>(nowUs - g_stageStartUs);
+    g_stageStartUs = nowUs;
+
+    ControlStageStats& stats = g_stages[static_cast<size_t>(stage)];
+    stats.lastUs = spentUs;
+    if (spentUs > stats.maxUs) {
+        stats.maxUs = spentUs;
+    }
+    const bool over = spentUs > stats.budgetUs;
+    if (over) {
+        stats.overruns++;
+    }
+    if (stage == ControlStage::Control) {
+        g_controlHistory = static_cast<uint16_t>((g_controlHistory << 1) | (over ? 1 : 0));
+    }
+}
+
+void ControlDeadline::skipStage(ControlStage stage) {
+    g_stageStartUs = esp_timer_get_time();
+    g_stages[static_cast<size_t>(stage)].skipped++;
+}
+
+void ControlDeadline::endTick(uint32_t nowMs) {
+    const uint32_t execUs = static_cast<uint32_t>(esp_timer_get_time() - g_tickStartUs);
+    const bool overran = execUs > g_periodUs || g_missed > 0;
+    g_history = static_cast<uint16_t>((g_history << 1) | (overran ? 1 : 0));
+    g_tick++;
+    if (overran) {
+        g_stats.overrunTicks++;
+        g_stats.missedTicks += g_missed;
+        g_lastOverrunMs = nowMs;
+    }
+
+    if (!g_degraded) {
+        if (g_degradation && overrunsIn(g_history) >= kEnterOverruns) {
+            g_degraded = true;
+            g_stats.degraded = true;
+            g_stats.entries++;
+            g_stats.lastEntryMs = nowMs;
+            ILITE_LOG(SYSTEM, LOG_WARN, "Control tick overrunning (%u of %u, last %lu us): degraded",
+                      static_cast<unsigned>(overrunsIn(g_history)), static_cast<unsigned>(kHistoryTicks),
+                      static_cast<unsigned long>(execUs));
+            RenderScheduler::invalidate(RenderReason::Data);
+        }
+        return;
+    }
+
+    g_stats.degradedTicks++;
+    if (nowMs - g_lastOverrunMs >= kRecoverMs || !g_degradation) {
+        g_degraded = false;
+        g_stats.degraded = false;
+        g_history = 0;
+        g_controlHistory = 0;
+        ILITE_LOG(SYSTEM, LOG_INFO, "Control tick back on time after %lu degraded ticks",
+                  static_cast<unsigned long>(g_stats.degradedTicks));
+        RenderScheduler::invalidate(RenderReason::Data);
+    }
+}
+
+bool ControlDeadline::isDegraded() {
+    return g_degraded;
+}
+
+bool ControlDeadline::runsUi() {
+    return !g_degraded || g_tick % kDegradedUiDivider == 0;
+}
+
+bool ControlDeadline::runsControl() {
+    return !g_degraded || overrunsIn(g_controlHistory) < kEnterOverruns || (g_tick & 1) == 0;
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+const char* ControlDeadline::name(ControlStage stage) {
+    const size_t index = static_cast<size_t>(stage);
+    return index < kStageCount ? kStageNames[index] : "?";
+}
+
+const ControlStageStats& ControlDeadline::getStageStats(ControlStage stage) {
+    return g_stages[static_cast<size_t>(stage) < kStageCount ? static_cast<size_t>(stage) : 0];
+}
+
+ControlDeadlineStats ControlDeadline::getStats() {
+    return g_stats;
+}
+
+void ControlDeadline::reset() {
+    for (ControlStageStats& stats : g_stages) {
+        const uint32_t budgetUs = stats.budgetUs;
+        stats = ControlStageStats{};
+        stats.budgetUs = budgetUs;
+    }
+    const bool degraded = g_stats.degraded;
+    g_stats = ControlDeadlineStats{};
+    g_stats.degraded = degraded;
+}
+
+void ControlDeadline::dump(Print& out) {
+    const ControlDeadlineStats stats = g_stats;
+    out.printf("[Deadline] %s, period %lu us, %lu overrun ticks (%lu releases missed)\n",
+               stats.degraded ? "DEGRADED" : "normal", static_cast<unsigned long>(g_periodUs),
+               static_cast<unsigned long>(stats.overrunTicks), static_cast<unsigned long>(stats.missedTicks));
+    out.printf("[Deadline] degraded %lu times, %lu ticks%s\n", static_cast<unsigned long>(stats.entries),
+               static_cast<unsigned long>(stats.degradedTicks), g_degradation ? "" : " (degradation off)");
+    out.println("[Deadline] stage     budget    last     max  overruns  skipped");
+    for (size_t i = 0; i < kStageCount; ++i) {
+        const ControlStageStats& stage = g_stages[i];
+        out.printf("[Deadline] %-8s %7lu %7lu %7lu %9lu %8lu\n", kStageNames[i],
+                   static_cast<unsigned long>(stage.budgetUs), static_cast<unsigned long>(stage.lastUs),
+                   static_cast<unsigned long>(stage.maxUs), static_cast<unsigned long>(stage.overruns),
+                   static_cast<unsigned long>(stage.skipped));
+    }
+}
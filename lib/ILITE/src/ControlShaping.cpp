@@ -0,0 +1,45 @@
+/**
+ * @file ControlShaping.cpp
+ * @brief Curve evaluation and table construction for ControlShaping
+ */
+
+#include "ControlShaping.h"
+
+namespace ControlShaping {
+
+namespace {
+constexpr float kHalfPi = 1.57079632679f;
+}
+
+float evaluateCurve(Curve curve, float strength, float magnitude) {
+    const float s = clamp(strength, 0.0f, 1.0f);
+    const float v = clamp(magnitude, 0.0f, 1.0f);
+
+    switch (curve) {
+        case Curve::Expo:
+            return expo(v, s);
+        case Curve::Power:
+            return powf(v, 1.0f + s * 3.0f);
+        case Curve::Sine:
+            return (1.0f - s) * v + s * sinf(v * kHalfPi);
+        case Curve::EaseOut:
+            return 1.0f - powf(1.0f - v, 1.0f + s * 3.0f);
+        case Curve::Smoothstep:
+            return (1.0f - s) * v + s * v * v * (3.0f - 2.0f * v);
+        case Curve::Linear:
+        default:
+            return v;
+    }
+}
+
+void CurveTable::build(Curve curve, float strength) {
+    for (uint16_t i = 0; i <= kSegments; ++i) {
+        const float magnitude = static_cast<float>(i) / kSegments;
+        const float shaped = clamp(evaluateCurve(curve, strength, magnitude), 0.0f, 1.0f);
+        table_[i] = static_cast<uint16_t>(shaped * 65535.0f + 0.5f);
+    }
+    curve_ = curve;
+    strength_ = strength;
+}
+
+}  // namespace ControlShaping
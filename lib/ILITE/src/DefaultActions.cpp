@@ -11,8 +11,10 @@
 #include "ModuleRegistry.h"
 #include "AudioRegistry.h"
 #include "connection_log.h"
+#include "LogChannels.h"
 #include "espnow_discovery.h"
 #include "StringBuilder.h"
+#include "CommandTable.h"
 #include "ILITE.h"
 #include <Arduino.h>
 #include <cstring>
@@ -30,6 +32,11 @@ enum class ActiveScreen {
     SETTINGS
 };
 
+// Terminal log area (TINY font, below the top strip)
+static constexpr int kTerminalLogTop = 14;
+static constexpr int kTerminalLogBottom = 50;
+static constexpr int kTerminalLineHeight = 7;
+
 static ActiveScreen currentScreen = ActiveScreen::NONE;
 static int scrollOffset = 0;
 static int selectedItem = 0;
@@ -38,6 +45,7 @@ static int deviceDetailAction = 0;
 static char terminalCommandBuffer[64] = "";
 static char terminalStatusMessage[32] = "";
 static uint32_t terminalStatusTimestamp = 0;
+static const char* terminalSuggestions[CommandTable::kMaxCommands];
 
 static void refreshDiscoveryScanMode() {
     const bool browsingDevices = (currentScreen == ActiveScreen::DEVICES) ||
@@ -59,16 +67,34 @@ void submitTerminalCommand(const char* command) {
         return;
     }
 
-    connectionLogAddf("> %s", command);
+    ILITE_LOG(UI, LOG_INFO, "> %s", command);
 
+    // The module's table, then the console's, then the module's own parser
     ILITEModule* module = ILITE.getActiveModule();
-    if (module != nullptr && module->hasCommandProcessor()) {
+    const CommandTable* moduleCommands = module != nullptr ? module->getCommandTable() : nullptr;
+    CommandResult result = CommandResult::Unknown;
+    if (moduleCommands != nullptr) {
+        result = moduleCommands->dispatch(command, Serial);
+    }
+    if (result == CommandResult::Unknown) {
+        result = ILITE.getConsoleCommands().dispatch(command, Serial);
+    }
+
+    if (result == CommandResult::Ran) {
+        strncpy(terminalStatusMessage, "Done", sizeof(terminalStatusMessage));
+        terminalStatusMessage[sizeof(terminalStatusMessage) - 1] = '\0';
+        AudioRegistry::play("paired");
+    } else if (result == CommandResult::BadArgs) {
+        strncpy(terminalStatusMessage, "Bad arguments", sizeof(terminalStatusMessage));
+        terminalStatusMessage[sizeof(terminalStatusMessage) - 1] = '\0';
+        AudioRegistry::play("error");
+    } else if (module != nullptr && module->hasCommandProcessor()) {
         module->handleCommand(command);
         strncpy(terminalStatusMessage, "Sent to module", sizeof(terminalStatusMessage));
         terminalStatusMessage[sizeof(terminalStatusMessage) - 1] = '\0';
         AudioRegistry::play("paired");
     } else {
-        connectionLogAdd("[Terminal] No module command handler");
+        ILITE_LOG(UI, LOG_WARN, "[Terminal] No module command handler");
         strncpy(terminalStatusMessage, "No handler", sizeof(terminalStatusMessage));
         terminalStatusMessage[sizeof(terminalStatusMessage) - 1] = '\0';
         AudioRegistry::play("error");
@@ -76,6 +102,22 @@ void submitTerminalCommand(const char* command) {
     terminalStatusTimestamp = millis();
 }
 
+// Module command names first, then the console's
+static size_t collectTerminalSuggestions() {
+    const size_t capacity = sizeof(terminalSuggestions) / sizeof(terminalSuggestions[0]);
+    size_t count = 0;
+    ILITEModule* module = ILITE.getActiveModule();
+    const CommandTable* tables[] = {module != nullptr ? module->getCommandTable() : nullptr,
+                                    &ILITE.getConsoleCommands()};
+    for (const CommandTable* table : tables) {
+        if (table != nullptr) {
+            const size_t found = table->complete("", terminalSuggestions + count, capacity - count);
+            count += found < capacity - count ? found : capacity - count;
+        }
+    }
+    return count;
+}
+
 void promptTerminalCommand() {
     if (StringBuilder::isActive()) {
         return;
@@ -83,9 +125,11 @@ void promptTerminalCommand() {
 
     StringBuilderConfig cfg;
     cfg.title = "Terminal Command";
-    cfg.subtitle = "Encoder = type, BTN3 = OK";
+    cfg.subtitle = "Enc:pick B1:Del B2:Aa B3:OK";
     cfg.initialValue = terminalCommandBuffer;
     cfg.maxLength = sizeof(terminalCommandBuffer) - 1;
+    cfg.suggestions = terminalSuggestions;
+    cfg.suggestionCount = collectTerminalSuggestions();
     cfg.onSubmit = [](const char* value) {
         if (value) {
             strncpy(terminalCommandBuffer, value, sizeof(terminalCommandBuffer));
@@ -209,70 +253,24 @@ void renderActiveScreen(DisplayCanvas& canvas) {
 // ============================================================================
 
 void renderTerminalScreen(DisplayCanvas& canvas) {
-    const int startY = 14;  // Below top strip
-    const int lineHeight = 7;  // Tiny font line height
-    const int maxCharsPerLine = 30;  // TINY font is 4px wide, 128/4 = 32, use 30 for margin
-    const int logAreaBottom = 50;
     const uint32_t now = millis();
 
-    // Get connection log entries
-    const int logCount = connectionLogGetCount();
-
     canvas.setFont(DisplayCanvas::TINY);
 
-    int y = startY;
-    int linesDisplayed = 0;
-    int linesToSkip = scrollOffset;  // Number of wrapped lines to skip
-
-    // Show newest entries first (reverse order)
-    for (int i = logCount - 1; i >= 0 && y < logAreaBottom; i--) {
-        const char* entry = connectionLogGetEntry(i);
-        if (!entry || entry[0] == '\0') continue;
-
-        // Wrap this entry into multiple lines
-        int entryLen = strlen(entry);
-        int startPos = 0;
-
-        while (startPos < entryLen && y < logAreaBottom) {
-            // Find end of this line (word wrap)
-            int lineLen = maxCharsPerLine;
-            if (startPos + lineLen > entryLen) {
-                lineLen = entryLen - startPos;
-            } else {
-                // Try to break at a space for word wrapping
-                int lastSpace = -1;
-                for (int j = 0; j < lineLen && (startPos + j) < entryLen; j++) {
-                    if (entry[startPos + j] == ' ') {
-                        lastSpace = j;
-                    }
-                }
-                if (lastSpace > lineLen / 2) {  // Only break at space if it's not too early
-                    lineLen = lastSpace + 1;  // Include the space
-                }
-            }
-
-            // Skip lines for scrolling
-            if (linesToSkip > 0) {
-                linesToSkip--;
-            } else {
-                // Draw this line
-                char lineBuf[32];
-                int copyLen = (lineLen < 31) ? lineLen : 31;
-                strncpy(lineBuf, entry + startPos, copyLen);
-                lineBuf[copyLen] = '\0';
-
-                canvas.drawText(2, y, lineBuf);
-                y += lineHeight;
-                linesDisplayed++;
-            }
-
-            startPos += lineLen;
+    // Newest entries first; the log keeps every entry pre-wrapped, so only
+    // the visible lines are touched
+    int y = kTerminalLogTop;
+    char lineBuf[kConnectionLogColumns + 1];
+    for (int line = 0; y < kTerminalLogBottom; line++) {
+        if (!connectionLogGetLine(scrollOffset + line, lineBuf, sizeof(lineBuf), true)) {
+            break;
         }
+        canvas.drawText(2, y, lineBuf);
+        y += kTerminalLineHeight;
     }
 
-    if (logCount == 0 && y < logAreaBottom) {
+    if (connectionLogGetCount() == 0) {
         canvas.drawText(2, y, "No log entries yet");
-        y += lineHeight;
     }
 
     // Status line
@@ -453,9 +451,10 @@ void handleEncoderRotate(int delta) {
     if (currentScreen == ActiveScreen::TERMINAL) {
         scrollOffset += delta;
 
-        // Allow generous scrolling (assume average 2 wrapped lines per log entry)
-        const int logCount = connectionLogGetCount();
-        const int maxScroll = logCount * 3;  // Allow scrolling through ~3x wrapped lines
+        const int visibleLines = (kTerminalLogBottom - kTerminalLogTop + kTerminalLineHeight - 1) /
+                                 kTerminalLineHeight;
+        const int lineCount = static_cast<int>(connectionLogGetLineCount());
+        const int maxScroll = lineCount > visibleLines ? lineCount - visibleLines : 0;
 
         if (scrollOffset < 0) {
             scrollOffset = 0;
@@ -0,0 +1,341 @@
+/**
+ * @file DeltaPacket.cpp
+ * @brief Delta packet layout, encoder and decoder
+ */
+
+#include "DeltaPacket.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kKindKeyframe = 0;
+constexpr uint8_t kKindDelta = 1;
+
+uint32_t loadValue(const uint8_t* data, size_t size) {
+    uint32_t value = 0;
+    memcpy(&value, data, size);     // Little-endian, like the packets
+    return value;
+}
+
+void storeValue(uint8_t* data, size_t size, uint32_t value) {
+    memcpy(data, &value, size);
+}
+
+uint32_t sizeMask(size_t size) {
+    return size >= 4 ? 0xFFFFFFFFu : (1u << (size * 8)) - 1u;
+}
+
+size_t putVarint(uint8_t* out, size_t capacity, uint32_t value) {
+    size_t n = 0;
+    do {
+        if (n >= capacity) {
+            return 0;
+        }
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[n++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    return n;
+}
+
+size_t getVarint(const uint8_t* in, size_t available, uint32_t& value) {
+    value = 0;
+    for (size_t n = 0; n < available && n < 5; ++n) {
+        value |= static_cast<uint32_t>(in[n] & 0x7F) << (7 * n);
+        if ((in[n] & 0x80) == 0) {
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+// Zigzag of the difference, wrapped to the segment size and sign-extended
+uint32_t encodeDifference(uint32_t current, uint32_t base, size_t size) {
+    const uint32_t bits = static_cast<uint32_t>(size * 8);
+    uint32_t wrapped = (current - base) & sizeMask(size);
+    if (bits < 32 && (wrapped >> (bits - 1))) {
+        wrapped |= ~sizeMask(size);
+    }
+    const int32_t difference = static_cast<int32_t>(wrapped);
+    return (static_cast<uint32_t>(difference) << 1) ^ static_cast<uint32_t>(difference >> 31);
+}
+
+uint32_t decodeDifference(uint32_t zigzag, uint32_t base, size_t size) {
+    const uint32_t difference = (zigzag >> 1) ^ (0u - (zigzag & 1u));
+    return (base + difference) & sizeMask(size);
+}
+
+}  // namespace
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+void DeltaLayout::build(const PacketDescriptor::Field* fields, size_t fieldCount, size_t packetSize) {
+    count = 0;
+    memset(covered, 0, sizeof(covered));
+
+    auto add = [this](size_t offset, size_t size, Kind kind) {
+        if (count >= kMaxSegments || size == 0 || offset + size > kMaxPacketSize) {
+            return;     // Left uncovered: a change there forces a keyframe
+        }
+        segments[count++] = Segment{static_cast<uint8_t>(offset), static_cast<uint8_t>(size), kind};
+        for (size_t i = offset; i < offset + size; ++i) {
+            covered[i / 8] |= static_cast<uint8_t>(1U << (i % 8));
+        }
+    };
+
+    if (fields == nullptr || fieldCount == 0) {
+        packetSize = packetSize < kMaxPacketSize ? packetSize : kMaxPacketSize;
+        for (size_t offset = 0; offset < packetSize; offset += 4) {
+            const size_t size = packetSize - offset < 4 ? packetSize - offset : 4;
+            add(offset, size, Xor);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < fieldCount; ++i) {
+        const PacketDescriptor::Field& field = fields[i];
+        const bool word = field.size == 1 || field.size == 2 || field.size == 4;
+        Kind kind = Raw;
+        if (field.type == PacketDescriptor::Field::FLOAT && field.size == 4) {
+            kind = Xor;
+        } else if (field.type != PacketDescriptor::Field::BYTE_ARRAY &&
+                   field.type != PacketDescriptor::Field::FLOAT && word) {
+            kind = Zigzag;
+        }
+        add(field.offset, field.size, kind);
+    }
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+DeltaPacketWriter::DeltaPacketWriter(const PacketDescriptor::Field* fields, size_t fieldCount,
+                                     size_t packetSize, uint8_t keyframeInterval)
+    : keyLength_(0),
+      keySeq_(0),
+      sinceKey_(0),
+      interval_(keyframeInterval > 0 ? keyframeInterval : 1),
+      haveKey_(false),
+      keyframes_(0),
+      deltas_(0)
+{
+    layout_.build(fields, fieldCount, packetSize);
+    memset(key_, 0, sizeof(key_));
+}
+
+void DeltaPacketWriter::reset() {
+    haveKey_ = false;
+}
+
+size_t DeltaPacketWriter::encode(const uint8_t* packet, size_t length, uint8_t* out, size_t capacity) {
+    if (packet == nullptr || out == nullptr || length < sizeof(uint32_t) ||
+        length > DeltaLayout::kMaxPacketSize) {
+        return 0;
+    }
+
+    if (haveKey_ && length == keyLength_ && sinceKey_ < interval_) {
+        const size_t size = encodeDelta(packet, length, out, capacity);
+        if (size > 0) {
+            sinceKey_++;
+            deltas_++;
+            return size;
+        }
+    }
+
+    // Keyframe
+    if (kHeaderSize + length > capacity) {
+        return 0;
+    }
+    keySeq_++;
+    const uint32_t magic = DELTA_PACKET_MAGIC;
+    memcpy(out, &magic, sizeof(magic));
+    memcpy(out + sizeof(magic), packet, sizeof(uint32_t));
+    out[8] = keySeq_;
+    out[9] = kKindKeyframe;
+    memcpy(out + kHeaderSize, packet, length);
+
+    memcpy(key_, packet, length);
+    keyLength_ = static_cast<uint8_t>(length);
+    sinceKey_ = 0;
+    haveKey_ = true;
+    keyframes_++;
+    return kHeaderSize + length;
+}
+
+size_t DeltaPacketWriter::encodeDelta(const uint8_t* packet, size_t length, uint8_t* out,
+                                      size_t capacity) const {
+    // Bytes no segment covers travel only in keyframes
+    for (size_t i = 0; i < length; ++i) {
+        if (!layout_.isCovered(i) && packet[i] != key_[i]) {
+            return 0;
+        }
+    }
+
+    // Never larger than the keyframe it replaces
+    const size_t maskBytes = (layout_.count + 7) / 8;
+    const size_t limit = capacity < kHeaderSize + length ? capacity : kHeaderSize + length - 1;
+    if (kHeaderSize + maskBytes > limit) {
+        return 0;
+    }
+
+    uint8_t* mask = out + kHeaderSize;
+    memset(mask, 0, maskBytes);
+    size_t offset = kHeaderSize + maskBytes;
+    for (size_t s = 0; s < layout_.count; ++s) {
+        const DeltaLayout::Segment& segment = layout_.segments[s];
+        if (segment.offset + segment.size > length) {
+            // Cut short by this packet: its bytes cannot travel as a delta
+            if (segment.offset < length &&
+                memcmp(packet + segment.offset, key_ + segment.offset, length - segment.offset) != 0) {
+                return 0;
+            }
+            continue;
+        }
+        if (memcmp(packet + segment.offset, key_ + segment.offset, segment.size) == 0) {
+            continue;
+        }
+        mask[s / 8] |= static_cast<uint8_t>(1U << (s % 8));
+
+        size_t written;
+        if (segment.kind == DeltaLayout::Raw) {
+            if (offset + segment.size > limit) {
+                return 0;
+            }
+            memcpy(out + offset, packet + segment.offset, segment.size);
+            written = segment.size;
+        } else {
+            const uint32_t current = loadValue(packet + segment.offset, segment.size);
+            const uint32_t base = loadValue(key_ + segment.offset, segment.size);
+            const uint32_t value = segment.kind == DeltaLayout::Xor
+                                       ? current ^ base
+                                       : encodeDifference(current, base, segment.size);
+            written = putVarint(out + offset, limit - offset, value);
+            if (written == 0) {
+                return 0;
+            }
+        }
+        offset += written;
+    }
+
+    const uint32_t magic = DELTA_PACKET_MAGIC;
+    memcpy(out, &magic, sizeof(magic));
+    memcpy(out + sizeof(magic), packet, sizeof(uint32_t));
+    out[8] = keySeq_;
+    out[9] = kKindDelta;
+    return offset;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+DeltaPacketReader::DeltaPacketReader()
+    : keyLength_(0),
+      keySeq_(0),
+      haveKey_(false),
+      dropped_(0)
+{
+    layout_.build(nullptr, 0, 0);
+    memset(key_, 0, sizeof(key_));
+}
+
+void DeltaPacketReader::configure(const PacketDescriptor::Field* fields, size_t fieldCount,
+                                  size_t packetSize) {
+    layout_.build(fields, fieldCount, packetSize);
+    reset();
+}
+
+void DeltaPacketReader::reset() {
+    haveKey_ = false;
+    dropped_ = 0;
+}
+
+size_t DeltaPacketReader::decode(const uint8_t* frame, size_t length, uint8_t* out, size_t capacity) {
+    const size_t header = DeltaPacketWriter::kHeaderSize;
+    if (!isDeltaPacket(frame, length) || out == nullptr) {
+        dropped_++;
+        return 0;
+    }
+    const uint8_t sequence = frame[8];
+    const uint8_t kind = frame[9];
+
+    if (kind == kKindKeyframe) {
+        const size_t packetLength = length - header;
+        if (packetLength < sizeof(uint32_t) || packetLength > DeltaLayout::kMaxPacketSize ||
+            packetLength > capacity) {
+            dropped_++;
+            return 0;
+        }
+        memcpy(key_, frame + header, packetLength);
+        keyLength_ = static_cast<uint8_t>(packetLength);
+        keySeq_ = sequence;
+        haveKey_ = true;
+        memcpy(out, key_, packetLength);
+        return packetLength;
+    }
+
+    const size_t maskBytes = (layout_.count + 7) / 8;
+    if (kind != kKindDelta || !haveKey_ || sequence != keySeq_ || keyLength_ > capacity ||
+        length < header + maskBytes) {
+        dropped_++;     // Keyframe lost (or not ours): wait for the next one
+        return 0;
+    }
+
+    memcpy(out, key_, keyLength_);
+    const uint8_t* mask = frame + header;
+    size_t offset = header + maskBytes;
+    for (size_t s = 0; s < layout_.count; ++s) {
+        if ((mask[s / 8] & (1U << (s % 8))) == 0) {
+            continue;
+        }
+        const DeltaLayout::Segment& segment = layout_.segments[s];
+        if (segment.offset + segment.size > keyLength_) {
+            dropped_++;
+            return 0;
+        }
+        if (segment.kind == DeltaLayout::Raw) {
+            if (offset + segment.size > length) {
+                dropped_++;
+                return 0;
+            }
+            memcpy(out + segment.offset, frame + offset, segment.size);
+            offset += segment.size;
+            continue;
+        }
+        uint32_t value;
+        const size_t read = getVarint(frame + offset, length - offset, value);
+        if (read == 0) {
+            dropped_++;
+            return 0;
+        }
+        offset += read;
+        const uint32_t base = loadValue(key_ + segment.offset, segment.size);
+        const uint32_t current = segment.kind == DeltaLayout::Xor
+                                     ? (base ^ value) & sizeMask(segment.size)
+                                     : decodeDifference(value, base, segment.size);
+        storeValue(out + segment.offset, segment.size, current);
+    }
+    return keyLength_;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+bool isDeltaPacket(const uint8_t* data, size_t length) {
+    if (data == nullptr || length < DeltaPacketWriter::kHeaderSize) {
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == DELTA_PACKET_MAGIC;
+}
+
+uint32_t deltaPacketInnerMagic(const uint8_t* data) {
+    uint32_t magic;
+    memcpy(&magic, data + sizeof(uint32_t), sizeof(magic));
+    return magic;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file DisplayBus.cpp
+ * @brief Display transport factory and throughput benchmark
+ */
+
+#include "DisplayBus.h"
+#include "DisplayCanvas.h"
+#include <SPI.h>
+#include <Wire.h>
+#include <esp_timer.h>
+
+U8G2* DisplayBus::u8g2_ = nullptr;
+DisplayBusConfig DisplayBus::config_;
+uint32_t DisplayBus::clockHz_ = 0;
+
+namespace {
+
+constexpr uint32_t kI2CSweepHz[] = {100000, 400000, 700000, 1000000};
+constexpr uint32_t kSpiSweepHz[] = {1000000, 4000000, 8000000, 10000000};
+
+// Bytes of one full frame on the wire (page data only)
+constexpr uint32_t kFrameBytes = 128 * 64 / 8;
+
+// U8g2 class for a controller and bus in the configured buffer mode
+#if ILITE_DISPLAY_PAGE_BUFFER == 1
+#define ILITE_U8G2(controller, bus) U8G2_##controller##_128X64_NONAME_1_##bus
+#elif ILITE_DISPLAY_PAGE_BUFFER == 2
+#define ILITE_U8G2(controller, bus) U8G2_##controller##_128X64_NONAME_2_##bus
+#else
+#define ILITE_U8G2(controller, bus) U8G2_##controller##_128X64_NONAME_F_##bus
+#endif
+
+uint32_t clampClock(const DisplayBusConfig& config) {
+    const bool spi = config.bus == DisplayBusType::SPI;
+    const uint32_t maxHz = spi ? DisplayBus::kSpiMaxHz : DisplayBus::kI2CMaxHz;
+    if (config.clockHz == 0) {
+        return spi ? DisplayBus::kSpiDefaultHz : DisplayBus::kI2CDefaultHz;
+    }
+    return config.clockHz < maxHz ? config.clockHz : maxHz;
+}
+
+// Every tile non-blank so no controller shortcut skips data
+void drawTestPattern(DisplayCanvas& canvas) {
+    canvas.clear();
+    canvas.drawRect(0, 0, 128, 64, false);
+    canvas.setFont(DisplayCanvas::NORMAL);
+    canvas.drawTextCentered(28, "Bus benchmark");
+    canvas.setFont(DisplayCanvas::SMALL);
+    canvas.drawTextCentered(42, DisplayBus::getName());
+}
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+U8G2* DisplayBus::create(const DisplayBusConfig& config) {
+    config_ = config;
+    clockHz_ = clampClock(config);
+
+    if (config.bus == DisplayBusType::SPI) {
+        // U8g2 calls SPI.begin() without pins, which keeps an already started bus
+        SPI.begin(config.spiClock, -1, config.spiData, config.spiCs);
+        if (config.controller == DisplayController::SSD1306) {
+            u8g2_ = new ILITE_U8G2(SSD1306, 4W_HW_SPI)(U8G2_R0, config.spiCs, config.spiDc,
+                                                       config.spiReset);
+        } else {
+            u8g2_ = new ILITE_U8G2(SH1106, 4W_HW_SPI)(U8G2_R0, config.spiCs, config.spiDc,
+                                                      config.spiReset);
+        }
+    } else {
+        Wire.begin();
+        if (config.controller == DisplayController::SSD1306) {
+            u8g2_ = new ILITE_U8G2(SSD1306, HW_I2C)(U8G2_R0, U8X8_PIN_NONE);
+        } else {
+            u8g2_ = new ILITE_U8G2(SH1106, HW_I2C)(U8G2_R0, U8X8_PIN_NONE);
+        }
+        u8g2_->setI2CAddress(config.i2cAddress << 1);
+    }
+
+    // Applied by U8g2 at the start of every transfer
+    u8g2_->setBusClock(clockHz_);
+    return u8g2_;
+}
+
+const char* DisplayBus::getName() {
+    const bool ssd = config_.controller == DisplayController::SSD1306;
+    if (config_.bus == DisplayBusType::SPI) {
+        return ssd ? "SPI SSD1306" : "SPI SH1106";
+    }
+    return ssd ? "I2C SSD1306" : "I2C SH1106";
+}
+
+const char* DisplayBus::getBufferModeName() {
+#if ILITE_DISPLAY_PAGE_BUFFER == 1
+    return "1-page";
+#elif ILITE_DISPLAY_PAGE_BUFFER == 2
+    return "2-page";
+#else
+    return "full frame";
+#endif
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+float DisplayBus::measureFps(DisplayCanvas& canvas, uint32_t clockHz, uint16_t frames) {
+    if (u8g2_ == nullptr || frames == 0) {
+        return 0.0f;
+    }
+    canvas.waitForFlush();
+    u8g2_->setBusClock(clockHz);
+
+    const int64_t startUs = esp_timer_get_time();
+    for (uint16_t i = 0; i < frames; i++) {
+        canvas.invalidate();
+        canvas.firstPage();
+        do {
+            drawTestPattern(canvas);
+        } while (canvas.nextPage());
+    }
+    canvas.waitForFlush();
+    const int64_t elapsedUs = esp_timer_get_time() - startUs;
+    return elapsedUs > 0 ? frames * 1000000.0f / static_cast<float>(elapsedUs) : 0.0f;
+}
+
+void DisplayBus::benchmark(DisplayCanvas& canvas, Print& out, uint16_t frames) {
+    if (u8g2_ == nullptr) {
+        out.println("[Display] Bench needs a panel created by DisplayBus");
+        return;
+    }
+
+    const bool spi = config_.bus == DisplayBusType::SPI;
+    const uint32_t* clocks = spi ? kSpiSweepHz : kI2CSweepHz;
+    const size_t count = spi ? sizeof(kSpiSweepHz) / sizeof(kSpiSweepHz[0])
+                             : sizeof(kI2CSweepHz) / sizeof(kI2CSweepHz[0]);
+
+    out.printf("[Display] %s buffer, %u bytes RAM (framebuffer and diff state)\n",
+               getBufferModeName(), static_cast<unsigned>(canvas.getBufferBytes()));
+    out.printf("[Display] %s, %u full frames per clock\n", getName(), frames);
+    for (size_t i = 0; i < count; i++) {
+        const float fps = measureFps(canvas, clocks[i], frames);
+        out.printf("[Display] %7lu Hz: %6.1f fps, %6.1f ms/frame, %5lu kbit/s payload\n",
+                   static_cast<unsigned long>(clocks[i]), fps,
+                   fps > 0.0f ? 1000.0f / fps : 0.0f,
+                   static_cast<unsigned long>(fps * kFrameBytes * 8 / 1000));
+    }
+
+    canvas.waitForFlush();
+    u8g2_->setBusClock(clockHz_);
+    canvas.invalidate();
+}
+
+void DisplayBus::dump(Print& out) {
+    out.printf("[Display] %s at %lu Hz, %s buffer", getName(), static_cast<unsigned long>(clockHz_),
+               getBufferModeName());
+    if (config_.bus == DisplayBusType::SPI) {
+        out.printf(" (SCK %u, MOSI %u, CS %u, DC %u)\n", config_.spiClock, config_.spiData,
+                   config_.spiCs, config_.spiDc);
+    } else {
+        out.printf(" (address 0x%02X)\n", config_.i2cAddress);
+    }
+}
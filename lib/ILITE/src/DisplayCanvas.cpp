@@ -5,9 +5,19 @@
 
 #include "DisplayCanvas.h"
 #include "IconLibrary.h"
+#include "Profiler.h"
+#include "LatencyPins.h"
+#include "ScreenCapture.h"
+#include "TaskMonitor.h"
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cmath>
+#include <cstring>
+
+#if ILITE_PAGE_FONTS
+#include "ILITEPageFonts.h"     // Generated by tools/font_subset.py
+#endif
 
 // Static instance pointer
 DisplayCanvas* DisplayCanvas::instance_ = nullptr;
@@ -18,9 +28,28 @@ DisplayCanvas* DisplayCanvas::instance_ = nullptr;
 
 DisplayCanvas::DisplayCanvas(U8G2& u8g2)
     : u8g2_(u8g2),
-      currentFont_(NORMAL)
+      currentFont_(NORMAL),
+      textCache_(u8g2),
+      shadowValid_(false),
+      lastFlushTiles_(0),
+      keepFrame_(false),
+      pageCount_(0),
+      tileWidth_(0),
+      flushTask_(nullptr),
+      flushIdle_(nullptr),
+      clipActive_(false),
+      clipX0_(0),
+      clipY0_(0),
+      clipX1_(0),
+      clipY1_(0)
 {
     instance_ = this;
+#if ILITE_DISPLAY_PAGE_BUFFER
+    memset(tileHash_, 0, sizeof(tileHash_));
+#else
+    memset(shadow_, 0, sizeof(shadow_));
+#endif
+    memset(spans_, 0, sizeof(spans_));
 }
 
 DisplayCanvas& DisplayCanvas::getInstance() {
@@ -35,8 +64,329 @@ void DisplayCanvas::clear() {
     u8g2_.clearBuffer();
 }
 
+#if ILITE_DISPLAY_PAGE_BUFFER
+
+// ============================================================================
+// Page Mode
+// ============================================================================
+//
+// The U8G2 buffer holds one band of ILITE_DISPLAY_PAGE_BUFFER pages. Each
+// band is drawn, diffed tile by tile against the hashes of what the panel
+// shows, and the changed span of each page row is sent before the buffer
+// moves on to the next band. Nothing is kept to transmit from later, so
+// there is no flush task.
+
+namespace {
+
+// 16-bit hash of one 8x8 tile. A change that keeps the hash (1 in 65536)
+// stays off the panel until the tile changes again or invalidate().
+inline uint16_t hashTile(const uint8_t* tile) {
+    uint32_t lo;
+    uint32_t hi;
+    memcpy(&lo, tile, sizeof(lo));
+    memcpy(&hi, tile + 4, sizeof(hi));
+    uint32_t hash = lo * 0x9E3779B1u ^ (hi + 0x7F4A7C15u) * 0x85EBCA77u;
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    return static_cast<uint16_t>(hash ^ (hash >> 16));
+}
+
+}  // namespace
+
 void DisplayCanvas::sendBuffer() {
-    u8g2_.sendBuffer();
+    // Frames go out band by band from nextPage()
+}
+
+void DisplayCanvas::firstPage() {
+    textCache_.beginFrame();
+    lastFlushTiles_ = 0;
+    u8g2_.clearBuffer();
+    u8g2_.setBufferCurrTileRow(0);
+}
+
+bool DisplayCanvas::nextPage() {
+    if (keepFrame_) {
+        // Band hashes still describe what the panel shows
+        keepFrame_ = false;
+    } else {
+        ILITE_PROFILE(ProfileZone::SendBuffer);
+        ILITE_LATENCY_SPAN(SendBuffer);
+        lastFlushTiles_ += transmitBand();
+    }
+
+    const uint8_t next = u8g2_.getBufferCurrTileRow() + u8g2_.getBufferTileHeight();
+    if (next * 8 >= u8g2_.getDisplayHeight()) {
+        shadowValid_ = true;
+        u8x8_RefreshDisplay(u8g2_.getU8x8());
+        // Drawing outside a pass lands in the top band
+        u8g2_.setBufferCurrTileRow(0);
+        return false;
+    }
+    u8g2_.clearBuffer();
+    u8g2_.setBufferCurrTileRow(next);
+    return true;
+}
+
+uint16_t DisplayCanvas::transmitBand() {
+    u8x8_t* u8x8 = u8g2_.getU8x8();
+    uint8_t* buffer = u8g2_.getBufferPtr();
+    const uint8_t firstRow = u8g2_.getBufferCurrTileRow();
+    const uint8_t rows = u8g2_.getBufferTileHeight();
+    tileWidth_ = u8g2_.getBufferTileWidth();
+    pageCount_ = static_cast<uint8_t>(u8g2_.getDisplayHeight() / 8);
+    const size_t pageBytes = static_cast<size_t>(tileWidth_) * 8;
+
+    // Geometry the hashes cannot cover: send the band as it is
+    if (static_cast<size_t>(tileWidth_) * pageCount_ > kMaxTiles) {
+        for (uint8_t row = 0; row < rows && firstRow + row < pageCount_; ++row) {
+            u8x8_DrawTile(u8x8, 0, firstRow + row, tileWidth_, buffer + row * pageBytes);
+        }
+        return static_cast<uint16_t>(tileWidth_) * rows;
+    }
+
+    uint16_t tiles = 0;
+    for (uint8_t row = 0; row < rows && firstRow + row < pageCount_; ++row) {
+        uint8_t* current = buffer + row * pageBytes;
+        uint16_t* hashes = tileHash_ + (firstRow + row) * tileWidth_;
+        int first = -1;
+        int last = -1;
+        for (uint8_t tile = 0; tile < tileWidth_; ++tile) {
+            const uint16_t hash = hashTile(current + tile * 8);
+            if (!shadowValid_ || hash != hashes[tile]) {
+                hashes[tile] = hash;
+                if (first < 0) {
+                    first = tile;
+                }
+                last = tile;
+            }
+        }
+        if (first >= 0) {
+            u8x8_DrawTile(u8x8, first, firstRow + row, last - first + 1, current + first * 8);
+            tiles += last - first + 1;
+        }
+    }
+    return tiles;
+}
+
+bool DisplayCanvas::startAsyncFlush(BaseType_t core, UBaseType_t priority) {
+    (void)core;
+    (void)priority;
+    return false;
+}
+
+bool DisplayCanvas::waitForFlush(TickType_t timeout) {
+    (void)timeout;
+    return true;
+}
+
+bool DisplayCanvas::isFlushPending() const {
+    return false;
+}
+
+bool DisplayCanvas::isPageMode() const {
+    return true;
+}
+
+size_t DisplayCanvas::getBufferBytes() const {
+    return static_cast<size_t>(u8g2_.getBufferTileWidth()) * 8 * u8g2_.getBufferTileHeight() +
+           sizeof(tileHash_);
+}
+
+#else  // Full frame
+
+void DisplayCanvas::sendBuffer() {
+    ILITE_PROFILE(ProfileZone::SendBuffer);
+    ILITE_LATENCY_SPAN(SendBuffer);
+    textCache_.beginFrame();
+
+    const uint8_t tileWidth = u8g2_.getBufferTileWidth();
+    const uint8_t tileRows = u8g2_.getBufferTileHeight();
+
+    // Geometry the shadow cannot hold: plain full transfer
+    if (static_cast<size_t>(tileWidth) * 8 * tileRows > kShadowSize) {
+        u8g2_.sendBuffer();
+        lastFlushTiles_ = static_cast<uint16_t>(tileWidth) * tileRows;
+        return;
+    }
+
+    if (flushTask_ == nullptr) {
+        lastFlushTiles_ = collectDirtySpans();
+        ScreenCapture::onFrame(shadow_, tileWidth_, pageCount_, lastFlushTiles_ > 0);
+        transmitSpans();
+        return;
+    }
+
+    // Fence on the previous frame before touching the front buffer
+    if (xSemaphoreTake(flushIdle_, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+
+    lastFlushTiles_ = collectDirtySpans();
+    // The flush task only reads the front buffer, so the capture can too
+    ScreenCapture::onFrame(shadow_, tileWidth_, pageCount_, lastFlushTiles_ > 0);
+    if (lastFlushTiles_ == 0) {
+        xSemaphoreGive(flushIdle_);
+        return;
+    }
+    xTaskNotifyGive(flushTask_);
+}
+
+bool DisplayCanvas::startAsyncFlush(BaseType_t core, UBaseType_t priority) {
+    if (flushTask_ != nullptr) {
+        return true;
+    }
+    if (static_cast<size_t>(u8g2_.getBufferTileWidth()) * 8 *
+        u8g2_.getBufferTileHeight() > kShadowSize) {
+        return false;
+    }
+
+    flushIdle_ = xSemaphoreCreateBinary();
+    if (flushIdle_ == nullptr) {
+        return false;
+    }
+    xSemaphoreGive(flushIdle_);
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        flushTask,
+        "DisplayFlush",
+        2048,
+        this,
+        priority,
+        &flushTask_,
+        core
+    );
+
+    if (result != pdPASS) {
+        flushTask_ = nullptr;
+        vSemaphoreDelete(flushIdle_);
+        flushIdle_ = nullptr;
+        return false;
+    }
+    TaskMonitor::watch(flushTask_, 2048, static_cast<int8_t>(core));
+    return true;
+}
+
+bool DisplayCanvas::waitForFlush(TickType_t timeout) {
+    if (flushTask_ == nullptr) {
+        return true;
+    }
+    if (xSemaphoreTake(flushIdle_, timeout) != pdTRUE) {
+        return false;
+    }
+    xSemaphoreGive(flushIdle_);
+    return true;
+}
+
+bool DisplayCanvas::isFlushPending() const {
+    return flushTask_ != nullptr && uxSemaphoreGetCount(flushIdle_) == 0;
+}
+
+uint16_t DisplayCanvas::collectDirtySpans() {
+    const uint8_t* buffer = u8g2_.getBufferPtr();
+    tileWidth_ = u8g2_.getBufferTileWidth();
+    pageCount_ = u8g2_.getBufferTileHeight();
+    const size_t pageBytes = static_cast<size_t>(tileWidth_) * 8;
+
+    // Full-buffer layout is page major: page p is bytes [p*pageBytes, +pageBytes),
+    // tile x of that page is the 8 bytes starting at x*8.
+    uint16_t tiles = 0;
+    for (uint8_t page = 0; page < pageCount_; ++page) {
+        const uint8_t* current = buffer + page * pageBytes;
+        uint8_t* front = shadow_ + page * pageBytes;
+        PageSpan& span = spans_[page];
+        span.count = 0;
+
+        if (!shadowValid_) {
+            span.first = 0;
+            span.count = tileWidth_;
+        } else if (memcmp(current, front, pageBytes) != 0) {
+            int first = -1;
+            int last = -1;
+            for (uint8_t tile = 0; tile < tileWidth_; ++tile) {
+                if (memcmp(current + tile * 8, front + tile * 8, 8) != 0) {
+                    if (first < 0) {
+                        first = tile;
+                    }
+                    last = tile;
+                }
+            }
+            span.first = static_cast<uint8_t>(first);
+            span.count = static_cast<uint8_t>(last - first + 1);
+        }
+
+        if (span.count > 0) {
+            memcpy(front + span.first * 8, current + span.first * 8, span.count * 8);
+            tiles += span.count;
+        }
+    }
+
+    shadowValid_ = true;
+    return tiles;
+}
+
+void DisplayCanvas::transmitSpans() {
+    u8x8_t* u8x8 = u8g2_.getU8x8();
+    const size_t pageBytes = static_cast<size_t>(tileWidth_) * 8;
+
+    for (uint8_t page = 0; page < pageCount_; ++page) {
+        const PageSpan& span = spans_[page];
+        if (span.count == 0) {
+            continue;
+        }
+        u8x8_DrawTile(u8x8, span.first, page, span.count,
+                      shadow_ + page * pageBytes + span.first * 8);
+    }
+    u8x8_RefreshDisplay(u8x8);
+}
+
+void DisplayCanvas::firstPage() {
+    // The buffer is the whole frame: nothing to set up, retained pixels stay
+}
+
+bool DisplayCanvas::nextPage() {
+    if (keepFrame_) {
+        keepFrame_ = false;
+    } else {
+        sendBuffer();
+    }
+    return false;
+}
+
+bool DisplayCanvas::isPageMode() const {
+    return false;
+}
+
+size_t DisplayCanvas::getBufferBytes() const {
+    return static_cast<size_t>(u8g2_.getBufferTileWidth()) * 8 * u8g2_.getBufferTileHeight() +
+           sizeof(shadow_);
+}
+
+void DisplayCanvas::flushTask(void* parameter) {
+    DisplayCanvas* canvas = static_cast<DisplayCanvas*>(parameter);
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Blocks on the I2C driver while the bus works; the renderer keeps
+        // drawing the next frame into the U8G2 buffer meanwhile.
+        canvas->transmitSpans();
+        xSemaphoreGive(canvas->flushIdle_);
+    }
+}
+
+#endif // ILITE_DISPLAY_PAGE_BUFFER
+
+void DisplayCanvas::invalidate() {
+    waitForFlush();
+    shadowValid_ = false;
+}
+
+void DisplayCanvas::setContrast(uint8_t value) {
+    waitForFlush();
+    u8g2_.setContrast(value);
+}
+
+uint16_t DisplayCanvas::getLastFlushTiles() const {
+    return lastFlushTiles_;
 }
 
 void DisplayCanvas::setDrawColor(uint8_t color) {
@@ -51,28 +401,188 @@ uint8_t DisplayCanvas::getDrawColor() const {
 // Basic Shapes
 // ============================================================================
 
+namespace {
+
+inline void applyMask(uint8_t& byte, uint8_t mask, uint8_t color) {
+    if (color == 0) {
+        byte &= static_cast<uint8_t>(~mask);
+    } else if (color == 1) {
+        byte |= mask;
+    } else {
+        byte ^= mask;
+    }
+}
+
+// One page row of `count` bytes under the same mask. Whole bytes are
+// filled by memset or inverted 32 bits at a time.
+void applyRow(uint8_t* row, int16_t count, uint8_t mask, uint8_t color) {
+    if (mask == 0xFF && color < 2) {
+        memset(row, color ? 0xFF : 0x00, count);
+        return;
+    }
+    if (mask == 0xFF) {
+        while (count > 0 && (reinterpret_cast<uintptr_t>(row) & 3) != 0) {
+            *row++ ^= 0xFF;
+            count--;
+        }
+        uint32_t* words = reinterpret_cast<uint32_t*>(row);
+        for (; count >= 4; count -= 4) {
+            *words++ ^= 0xFFFFFFFFu;
+        }
+        row = reinterpret_cast<uint8_t*>(words);
+    }
+    for (int16_t i = 0; i < count; ++i) {
+        applyMask(row[i], mask, color);
+    }
+}
+
+}  // namespace
+
+int16_t DisplayCanvas::bandTop() const {
+    return static_cast<int16_t>(u8g2_.getBufferCurrTileRow()) * 8;
+}
+
+int16_t DisplayCanvas::bandBottom() const {
+    return bandTop() + static_cast<int16_t>(u8g2_.getBufferTileHeight()) * 8;
+}
+
+uint8_t* DisplayCanvas::band(int16_t page) const {
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    return u8g2_.getBufferPtr() + (page - u8g2_.getBufferCurrTileRow()) * stride;
+}
+
+DisplayCanvas::Bounds DisplayCanvas::drawBounds() const {
+    Bounds bounds = {0, bandTop(), getWidth(), std::min(bandBottom(), getHeight())};
+    if (clipActive_) {
+        bounds.x0 = std::max(bounds.x0, clipX0_);
+        bounds.y0 = std::max(bounds.y0, clipY0_);
+        bounds.x1 = std::min(bounds.x1, clipX1_);
+        bounds.y1 = std::min(bounds.y1, clipY1_);
+    }
+    return bounds;
+}
+
+void DisplayCanvas::fillSpans(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
+    const Bounds bounds = drawBounds();
+    const int16_t x0 = std::max(x, bounds.x0);
+    const int16_t y0 = std::max(y, bounds.y0);
+    const int16_t x1 = std::min(static_cast<int16_t>(x + w), bounds.x1);
+    const int16_t y1 = std::min(static_cast<int16_t>(y + h), bounds.y1);
+    if (w <= 0 || h <= 0 || x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const int16_t lastPage = (y1 - 1) >> 3;
+    for (int16_t page = y0 >> 3; page <= lastPage; ++page) {
+        uint8_t mask = 0xFF;
+        if (page == (y0 >> 3)) {
+            mask &= static_cast<uint8_t>(0xFF << (y0 & 7));
+        }
+        if (page == lastPage) {
+            mask &= static_cast<uint8_t>(0xFF >> (7 - ((y1 - 1) & 7)));
+        }
+        applyRow(band(page) + x0, x1 - x0, mask, color);
+    }
+}
+
 void DisplayCanvas::drawPixel(int16_t x, int16_t y) {
-    u8g2_.drawPixel(x, y);
+    const Bounds bounds = drawBounds();
+    if (x < bounds.x0 || x >= bounds.x1 || y < bounds.y0 || y >= bounds.y1) {
+        return;
+    }
+    applyMask(band(y >> 3)[x], static_cast<uint8_t>(1U << (y & 7)), u8g2_.getDrawColor());
 }
 
 void DisplayCanvas::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
-    u8g2_.drawLine(x0, y0, x1, y1);
+    drawPatternLine(x0, y0, x1, y1, 0xFF, 8);
 }
 
 void DisplayCanvas::drawHLine(int16_t x, int16_t y, int16_t w) {
-    u8g2_.drawHLine(x, y, w);
+    fillSpans(x, y, w, 1, u8g2_.getDrawColor());
 }
 
 void DisplayCanvas::drawVLine(int16_t x, int16_t y, int16_t h) {
-    u8g2_.drawVLine(x, y, h);
+    fillSpans(x, y, 1, h, u8g2_.getDrawColor());
 }
 
 void DisplayCanvas::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool filled) {
-    if (filled) {
-        u8g2_.drawBox(x, y, w, h);
-    } else {
-        u8g2_.drawFrame(x, y, w, h);
+    const uint8_t color = u8g2_.getDrawColor();
+    if (filled || w <= 2 || h <= 2) {
+        fillSpans(x, y, w, h, color);
+        return;
     }
+    // Each pixel once, so XOR frames close cleanly
+    fillSpans(x, y, w, 1, color);
+    fillSpans(x, y + h - 1, w, 1, color);
+    fillSpans(x, y + 1, 1, h - 2, color);
+    fillSpans(x + w - 1, y + 1, 1, h - 2, color);
+}
+
+void DisplayCanvas::drawPatternLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                    uint8_t pattern, uint8_t length) {
+    const uint8_t color = u8g2_.getDrawColor();
+    if (length == 0 || length > 8) {
+        length = 8;
+    }
+
+    // Solid axis-aligned lines are spans
+    if (pattern == 0xFF && (y0 == y1 || x0 == x1)) {
+        const int16_t x = std::min(x0, x1);
+        const int16_t y = std::min(y0, y1);
+        fillSpans(x, y, std::max(x0, x1) - x + 1, std::max(y0, y1) - y + 1, color);
+        return;
+    }
+
+    const Bounds bounds = drawBounds();
+    const int16_t minX = std::min(x0, x1);
+    const int16_t maxX = std::max(x0, x1);
+    const int16_t minY = std::min(y0, y1);
+    const int16_t maxY = std::max(y0, y1);
+    if (maxX < bounds.x0 || minX >= bounds.x1 || maxY < bounds.y0 || minY >= bounds.y1) {
+        return;
+    }
+    const bool inside = minX >= bounds.x0 && maxX < bounds.x1 &&
+                        minY >= bounds.y0 && maxY < bounds.y1;
+
+    uint8_t* buffer = u8g2_.getBufferPtr();
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    const int16_t top = bandTop();
+
+    // Bresenham over all octants; one pattern step per major-axis pixel
+    const int16_t dx = maxX - minX;
+    const int16_t dy = -(maxY - minY);
+    const int16_t sx = x0 < x1 ? 1 : -1;
+    const int16_t sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    int16_t x = x0;
+    int16_t y = y0;
+    uint8_t step = 0;
+
+    while (true) {
+        if (((pattern >> step) & 1) != 0 &&
+            (inside || (x >= bounds.x0 && x < bounds.x1 && y >= bounds.y0 && y < bounds.y1))) {
+            applyMask(buffer[((y - top) >> 3) * stride + x], static_cast<uint8_t>(1U << (y & 7)), color);
+        }
+        if (++step == length) {
+            step = 0;
+        }
+        if (x == x1 && y == y1) {
+            break;
+        }
+        const int16_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+void DisplayCanvas::invertRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+    fillSpans(x, y, w, h, 2);
 }
 
 void DisplayCanvas::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool filled) {
@@ -124,7 +634,10 @@ DisplayCanvas::Font DisplayCanvas::getFont() const {
 }
 
 void DisplayCanvas::drawText(int16_t x, int16_t y, const char* text) {
-    if (text) {
+    if (text == nullptr || drawPageText(x, y, text)) {
+        return;
+    }
+    if (!textCache_.drawText(currentFont_, x, y, text)) {
         u8g2_.setCursor(x, y);
         u8g2_.print(text);
     }
@@ -143,7 +656,23 @@ void DisplayCanvas::drawTextF(int16_t x, int16_t y, const char* fmt, ...) {
 }
 
 int16_t DisplayCanvas::getTextWidth(const char* text) const {
-    return text ? u8g2_.getUTF8Width(text) : 0;
+    if (text == nullptr) {
+        return 0;
+    }
+    const PageFontData* font = getPageFont(currentFont_);
+    int16_t width = 0;
+    if (font != nullptr && measurePageText(*font, text, width)) {
+        return width;
+    }
+    return textCache_.getWidth(currentFont_, text);
+}
+
+void DisplayCanvas::setTextCacheEnabled(bool enabled) {
+    textCache_.setEnabled(enabled);
+}
+
+TextCache& DisplayCanvas::getTextCache() {
+    return textCache_;
 }
 
 int16_t DisplayCanvas::getTextHeight() const {
@@ -163,6 +692,104 @@ void DisplayCanvas::drawTextRight(int16_t x, int16_t y, const char* text) {
     drawText(x - w, y, text);
 }
 
+// ============================================================================
+// Page Fonts
+// ============================================================================
+
+const PageFontData* DisplayCanvas::getPageFont(Font font) const {
+#if ILITE_PAGE_FONTS
+    return static_cast<size_t>(font) < kPageFontCount ? kPageFonts[font] : nullptr;
+#else
+    (void)font;
+    return nullptr;
+#endif
+}
+
+bool DisplayCanvas::measurePageText(const PageFontData& font, const char* text, int16_t& width) const {
+    // As U8G2's getUTF8Width(): advances, except the last glyph counts its
+    // bitmap width and x offset
+    const PageGlyph* last = nullptr;
+    int16_t sum = 0;
+    for (const char* p = text; *p != '\0'; ++p) {
+        const uint8_t code = static_cast<uint8_t>(*p);
+        if (code < PageFontData::kFirst || code > PageFontData::kLast) {
+            return false;
+        }
+        last = &font.glyphs[code - PageFontData::kFirst];
+        if (!last->present) {
+            return false;
+        }
+        sum += last->advance;
+    }
+    if (last != nullptr && last->width != 0) {
+        sum += last->width + last->x - last->advance;
+    }
+    width = sum;
+    return true;
+}
+
+bool DisplayCanvas::drawPageText(int16_t x, int16_t y, const char* text) {
+    const PageFontData* font = getPageFont(currentFont_);
+    const uint8_t color = u8g2_.getDrawColor();
+    if (font == nullptr || color > 1) {
+        return false;
+    }
+
+    // Every glyph must be in the subset and inside the bounds (no clipping)
+    const Bounds bounds = drawBounds();
+    int16_t cursor = x;
+    for (const char* p = text; *p != '\0'; ++p) {
+        const uint8_t code = static_cast<uint8_t>(*p);
+        if (code < PageFontData::kFirst || code > PageFontData::kLast) {
+            return false;
+        }
+        const PageGlyph& glyph = font->glyphs[code - PageFontData::kFirst];
+        if (!glyph.present) {
+            return false;
+        }
+        if (glyph.width != 0) {
+            const int16_t left = cursor + glyph.x;
+            const int16_t top = y - glyph.top;
+            if (left < bounds.x0 || left + glyph.width > bounds.x1 ||
+                top < bounds.y0 || top + glyph.height > bounds.y1) {
+                return false;
+            }
+        }
+        cursor += glyph.advance;
+    }
+
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    cursor = x;
+    for (const char* p = text; *p != '\0'; ++p) {
+        const PageGlyph& glyph = font->glyphs[static_cast<uint8_t>(*p) - PageFontData::kFirst];
+        const int16_t top = y - glyph.top;
+        const uint8_t shift = top & 7;
+        const uint32_t box = (1UL << glyph.height) - 1;
+        const uint32_t mask = box << shift;
+        const uint8_t pages = (glyph.height + 7) >> 3;
+        const uint8_t* src = font->bitmaps + glyph.offset;
+        uint8_t* dst = band(top >> 3) + cursor + glyph.x;
+
+        // Solid font mode: the glyph box takes the background color too
+        for (uint8_t c = 0; c < glyph.width; ++c, ++dst) {
+            uint32_t bits = src[c];
+            if (pages > 1) {
+                bits |= static_cast<uint32_t>(src[glyph.width + c]) << 8;
+            }
+            const uint32_t value = (color ? bits : ~bits & box) << shift;
+            for (uint8_t k = 0; k < 3; ++k) {
+                const uint8_t m = static_cast<uint8_t>(mask >> (8 * k));
+                if (m != 0) {
+                    uint8_t& byte = dst[k * stride];
+                    byte = static_cast<uint8_t>((byte & ~m) | (static_cast<uint8_t>(value >> (8 * k)) & m));
+                }
+            }
+        }
+        cursor += glyph.advance;
+    }
+    return true;
+}
+
 // ============================================================================
 // Icons
 // ============================================================================
@@ -180,8 +807,112 @@ bool DisplayCanvas::drawIconByID(int16_t x, int16_t y, const char* iconId) {
         return false;
     }
 
-    // Draw bitmap using U8G2's XBM function
-    u8g2_.drawXBM(x, y, icon->width, icon->height, icon->data);
+    drawIconBitmap(x, y, *icon);
+    return true;
+}
+
+void DisplayCanvas::drawIconBitmap(int16_t x, int16_t y, const Icon& icon) {
+    const uint8_t color = u8g2_.getDrawColor();
+    if (icon.pages == nullptr || color > 1 ||
+        x < 0 || y < bandTop() ||
+        x + icon.width > getWidth() || y + icon.height > std::min(bandBottom(), getHeight())) {
+        u8g2_.drawXBM(x, y, icon.width, icon.height, icon.data);
+        return;
+    }
+
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    const uint8_t width = icon.width;
+    const uint8_t pageCount = (icon.height + 7) >> 3;
+    const uint8_t invert = color ? 0x00 : 0xFF;
+    const uint8_t shift = y & 7;
+    uint8_t* dst = band(y >> 3) + x;
+    const uint8_t* src = icon.pages;
+
+    if (shift == 0 && (icon.height & 7) == 0) {
+        // Byte-aligned: every destination byte is fully covered
+        for (uint8_t p = 0; p < pageCount; ++p, dst += stride, src += width) {
+            if (invert == 0) {
+                memcpy(dst, src, width);
+            } else {
+                for (uint8_t c = 0; c < width; ++c) {
+                    dst[c] = src[c] ^ invert;
+                }
+            }
+        }
+        return;
+    }
+
+    // Unaligned: each icon page straddles up to two framebuffer pages.
+    // The bounds check above guarantees the second page exists whenever
+    // the mask reaches into it.
+    for (uint8_t p = 0; p < pageCount; ++p, dst += stride, src += width) {
+        const uint8_t rows = (icon.height - p * 8) < 8 ? (icon.height - p * 8) : 8;
+        const uint16_t mask = static_cast<uint16_t>(((1U << rows) - 1) << shift);
+        const uint8_t maskLo = static_cast<uint8_t>(mask);
+        const uint8_t maskHi = static_cast<uint8_t>(mask >> 8);
+        for (uint8_t c = 0; c < width; ++c) {
+            const uint16_t bits = static_cast<uint16_t>(static_cast<uint8_t>(src[c] ^ invert)) << shift;
+            dst[c] = static_cast<uint8_t>((dst[c] & ~maskLo) | (bits & maskLo));
+            if (maskHi != 0) {
+                uint8_t& next = dst[c + stride];
+                next = static_cast<uint8_t>((next & ~maskHi) | ((bits >> 8) & maskHi));
+            }
+        }
+    }
+}
+
+void DisplayCanvas::drawPages(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* pages) {
+    const Bounds bounds = drawBounds();
+    const int16_t x0 = std::max(x, bounds.x0);
+    const int16_t x1 = std::min(static_cast<int16_t>(x + w), bounds.x1);
+    if (pages == nullptr || w <= 0 || h <= 0 || x0 >= x1) {
+        return;
+    }
+
+    const int16_t pageCount = (h + 7) >> 3;
+
+    // Each source page lands on rows y + 8p .. y + 8p + 7, i.e. across one
+    // or two framebuffer pages; rows are masked to the bounds and to h
+    for (int16_t p = 0; p < pageCount; ++p) {
+        const int16_t top = y + p * 8;
+        const int16_t rows = std::min<int16_t>(8, h - p * 8);
+        const int16_t rowStart = std::max<int16_t>(top, bounds.y0);
+        const int16_t rowEnd = std::min<int16_t>(top + rows, bounds.y1);
+        if (rowStart >= rowEnd) {
+            continue;
+        }
+        const uint8_t* src = pages + p * w + (x0 - x);
+
+        // Floor division: rows above the screen fall in negative pages
+        const int16_t firstPage = top >= 0 ? top >> 3 : -((7 - top) >> 3);
+        const uint8_t shift = static_cast<uint8_t>(top - firstPage * 8);
+        for (int16_t k = 0; k < 2; ++k) {
+            const int16_t page = firstPage + k;
+            const int16_t pageTop = page * 8;
+            const int16_t from = std::max<int16_t>(rowStart, pageTop);
+            const int16_t to = std::min<int16_t>(rowEnd, pageTop + 8);
+            if (from >= to) {
+                continue;
+            }
+            const uint8_t mask = static_cast<uint8_t>((0xFF << (from - pageTop)) & (0xFF >> (pageTop + 8 - to)));
+            uint8_t* dst = band(page) + x0;
+            for (int16_t c = 0; c < x1 - x0; ++c) {
+                const uint16_t bits = static_cast<uint16_t>(src[c]) << shift;
+                const uint8_t value = static_cast<uint8_t>(k == 0 ? bits : bits >> 8);
+                dst[c] = static_cast<uint8_t>((dst[c] & ~mask) | (value & mask));
+            }
+        }
+    }
+}
+
+bool DisplayCanvas::readPages(int16_t x, uint8_t firstPage, int16_t w, uint8_t pageCount, uint8_t* out) const {
+    if (out == nullptr || x < 0 || w <= 0 || x + w > getWidth() ||
+        firstPage * 8 < bandTop() || (firstPage + pageCount) * 8 > bandBottom()) {
+        return false;
+    }
+    for (uint8_t p = 0; p < pageCount; ++p) {
+        memcpy(out + p * w, band(firstPage + p) + x, w);
+    }
     return true;
 }
 
@@ -401,10 +1132,16 @@ void DisplayCanvas::drawFooter(const char* leftText, const char* centerText, con
 
 void DisplayCanvas::setClipRect(int16_t x, int16_t y, int16_t w, int16_t h) {
     u8g2_.setClipWindow(x, y, x + w - 1, y + h - 1);
+    clipActive_ = true;
+    clipX0_ = x;
+    clipY0_ = y;
+    clipX1_ = x + w;
+    clipY1_ = y + h;
 }
 
 void DisplayCanvas::clearClipRect() {
     u8g2_.setMaxClipWindow();
+    clipActive_ = false;
 }
 
 int16_t DisplayCanvas::getWidth() const {
@@ -0,0 +1,123 @@
+/**
+ * @file DriveMixer.cpp
+ * @brief Wheel layout matrices and the mixing pass
+ */
+
+#include "DriveMixer.h"
+#include <math.h>
+
+namespace {
+
+struct LayoutRow {
+    float forward;
+    float strafe;
+    float turn;
+};
+
+struct LayoutTable {
+    uint8_t wheels;
+    LayoutRow rows[DriveMixer::kMaxWheels];
+};
+
+constexpr float kSin60 = 0.866025404f;
+
+// Rows in wheel order; see DriveMixer.h for order and sign conventions
+constexpr LayoutTable kDifferential = {2, {{1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, -1.0f}}};
+constexpr LayoutTable kSkid = {4, {{1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f},
+                                   {1.0f, 0.0f, -1.0f}, {1.0f, 0.0f, -1.0f}}};
+// Omni wheels at 45 deg in an X share the mecanum matrix
+constexpr LayoutTable kMecanum = {4, {{1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f},
+                                      {1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, -1.0f}}};
+// Kiwi wheels at 60, 180 and 300 deg, driving counterclockwise-positive:
+// -sin(a) * forward - cos(a) * strafe - turn
+constexpr LayoutTable kOmni3 = {3, {{-kSin60, -0.5f, -1.0f}, {0.0f, 1.0f, -1.0f},
+                                    {kSin60, -0.5f, -1.0f}}};
+
+const LayoutTable& tableFor(DriveMixer::Layout layout) {
+    switch (layout) {
+        case DriveMixer::Layout::Skid:
+            return kSkid;
+        case DriveMixer::Layout::Mecanum:
+        case DriveMixer::Layout::Omni4:
+            return kMecanum;
+        case DriveMixer::Layout::Omni3:
+            return kOmni3;
+        case DriveMixer::Layout::Differential:
+        default:
+            return kDifferential;
+    }
+}
+
+}  // namespace
+
+DriveMixer::DriveMixer(Layout layout)
+    : layout_(layout),
+      normalize_(Normalize::Scale),
+      wheelCount_(0)
+{
+    configure(layout);
+}
+
+void DriveMixer::configure(Layout layout) {
+    const LayoutTable& table = tableFor(layout);
+    layout_ = layout;
+    wheelCount_ = table.wheels;
+    for (size_t i = 0; i < kMaxWheels; ++i) {
+        forward_[i] = table.rows[i].forward;
+        strafe_[i] = table.rows[i].strafe;
+        turn_[i] = table.rows[i].turn;
+        gain_[i] = 1.0f;
+        limit_[i] = 1.0f;
+        inverseLimit_[i] = 1.0f;
+    }
+}
+
+void DriveMixer::setGain(size_t wheel, float gain) {
+    if (wheel < wheelCount_) {
+        gain_[wheel] = gain;
+    }
+}
+
+void DriveMixer::setLimit(size_t wheel, float limit) {
+    if (wheel < wheelCount_ && limit > 0.0f) {
+        limit_[wheel] = limit;
+        inverseLimit_[wheel] = 1.0f / limit;
+    }
+}
+
+float DriveMixer::mix(const Motion& motion, float* out) const {
+    // One pass over every row; unused rows are zero and fall out
+    float peak = 0.0f;
+    for (size_t i = 0; i < kMaxWheels; ++i) {
+        const float value = gain_[i] * (forward_[i] * motion.forward +
+                                        strafe_[i] * motion.strafe +
+                                        turn_[i] * motion.turn);
+        out[i] = value;
+        const float ratio = fabsf(value) * inverseLimit_[i];
+        peak = ratio > peak ? ratio : peak;
+    }
+
+    if (peak <= 1.0f) {
+        return 1.0f;
+    }
+    if (normalize_ == Normalize::Clamp) {
+        for (size_t i = 0; i < kMaxWheels; ++i) {
+            out[i] = out[i] > limit_[i] ? limit_[i] : (out[i] < -limit_[i] ? -limit_[i] : out[i]);
+        }
+        return 1.0f;
+    }
+    const float scale = 1.0f / peak;
+    for (size_t i = 0; i < kMaxWheels; ++i) {
+        out[i] *= scale;
+    }
+    return scale;
+}
+
+int16_t DriveMixer::toCommand(float value, int16_t fullScale) {
+    if (value > 1.0f) {
+        value = 1.0f;
+    } else if (value < -1.0f) {
+        value = -1.0f;
+    }
+    return static_cast<int16_t>(value * fullScale);
+}
@@ -0,0 +1,342 @@
+/**
+ * @file EncoderSampler.cpp
+ * @brief Quadrature decoding, detent queue and velocity acceleration
+ */
+
+#include "EncoderSampler.h"
+#include "input.h"
+#include "PowerManager.h"
+#include <esp_timer.h>
+#include <driver/pcnt.h>
+#include <soc/gpio_reg.h>
+#include <cstring>
+
+static_assert(encoderA < 32 && encoderB < 32, "Encoder pins must be on GPIO 0-31");
+
+static_assert((EncoderSampler::kQueueSize & (EncoderSampler::kQueueSize - 1)) == 0,
+              "kQueueSize must be a power of 2");
+static_assert(EncoderSampler::kPcntLimit % 4 == 0, "kPcntLimit must be a whole number of detents");
+
+namespace {
+
+constexpr pcnt_unit_t kPcntUnit = PCNT_UNIT_0;
+
+// Counts per detent (one full quadrature cycle) and the travel that
+// commits one; the remaining count is hysteresis around the rest position
+constexpr int16_t kCountsPerDetent = 4;
+constexpr int16_t kCountsToCommit = 3;
+
+// Step for a transition, indexed by previous state << 2 | new state
+// (state = A << 1 | B). Clockwise is 01 -> 11 -> 10 -> 00: B is high when
+// A rises, the direction the old RISING interrupt counted as +1. Entries
+// where both pins changed are invalid and count as 0.
+constexpr int8_t kTransition[16] = {
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0,
+};
+
+inline bool isInvalid(uint8_t previous, uint8_t state) {
+    return (previous ^ state) == 0x3;
+}
+
+inline uint8_t IRAM_ATTR readPins() {
+    const uint32_t in = REG_READ(GPIO_IN_REG);
+    return static_cast<uint8_t>((((in >> encoderA) & 1U) << 1) | ((in >> encoderB) & 1U));
+}
+
+}  // namespace
+
+// ============================================================================
+// Singleton
+// ============================================================================
+
+EncoderSampler& EncoderSampler::getInstance() {
+    static EncoderSampler instance;
+    return instance;
+}
+
+EncoderSampler::EncoderSampler()
+    : head_(0),
+      position_(0),
+      state_(0),
+      restState_(0),
+      travel_(0),
+      invalid_(0),
+      maxAcceleration_(1),
+      backend_(EncoderBackend::Interrupt),
+      attached_(false),
+      pcntLast_(0),
+      pcntTravel_(0),
+      pcntPollUs_(0)
+{
+    memset(queue_, 0, sizeof(queue_));
+}
+
+void EncoderSampler::begin(EncoderBackend backend) {
+    if (attached_) {
+        return;
+    }
+    pinMode(encoderA, INPUT_PULLUP);
+    pinMode(encoderB, INPUT_PULLUP);
+
+    state_ = readPins();
+    restState_ = state_;
+    travel_ = 0;
+    attached_ = true;
+
+    if (backend == EncoderBackend::Pcnt && beginPcnt()) {
+        backend_ = EncoderBackend::Pcnt;
+        return;
+    }
+    if (backend == EncoderBackend::Pcnt) {
+        Serial.println("[Encoder] PCNT unavailable, decoding in interrupts");
+    }
+    backend_ = EncoderBackend::Interrupt;
+    attachInterrupt(encoderA, &EncoderSampler::onPinChange, CHANGE);
+    attachInterrupt(encoderB, &EncoderSampler::onPinChange, CHANGE);
+}
+
+bool EncoderSampler::beginPcnt() {
+    // Channel 0 counts A edges, channel 1 B edges; the other pin sets the
+    // direction. Clockwise (01 -> 11 -> 10 -> 00, A << 1 | B) counts up on
+    // all four edges.
+    pcnt_config_t config = {};
+    config.unit = kPcntUnit;
+    config.counter_h_lim = kPcntLimit;
+    config.counter_l_lim = -kPcntLimit;
+
+    config.channel = PCNT_CHANNEL_0;
+    config.pulse_gpio_num = encoderA;
+    config.ctrl_gpio_num = encoderB;
+    config.pos_mode = PCNT_COUNT_INC;
+    config.neg_mode = PCNT_COUNT_DEC;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.lctrl_mode = PCNT_MODE_REVERSE;
+    if (pcnt_unit_config(&config) != ESP_OK) {
+        return false;
+    }
+
+    config.channel = PCNT_CHANNEL_1;
+    config.pulse_gpio_num = encoderB;
+    config.ctrl_gpio_num = encoderA;
+    config.pos_mode = PCNT_COUNT_DEC;
+    config.neg_mode = PCNT_COUNT_INC;
+    if (pcnt_unit_config(&config) != ESP_OK) {
+        return false;
+    }
+
+    // pcnt_unit_config() drops the pull-ups the pins were given above
+    gpio_pullup_en(static_cast<gpio_num_t>(encoderA));
+    gpio_pullup_en(static_cast<gpio_num_t>(encoderB));
+
+    pcnt_set_filter_value(kPcntUnit, kPcntFilter);
+    pcnt_filter_enable(kPcntUnit);
+    pcnt_counter_pause(kPcntUnit);
+    pcnt_counter_clear(kPcntUnit);
+    pcnt_counter_resume(kPcntUnit);
+
+    pcntLast_ = 0;
+    pcntTravel_ = 0;
+    pcntPollUs_ = static_cast<uint32_t>(esp_timer_get_time());
+    return true;
+}
+
+// ============================================================================
+// Decoding (ISR)
+// ============================================================================
+
+void IRAM_ATTR EncoderSampler::onPinChange() {
+    // A level wake interrupt still reads valid pin levels: decode it too
+    PowerManager::wakeFromPinIsr();
+    getInstance().decode(readPins());
+}
+
+void IRAM_ATTR EncoderSampler::decode(uint8_t state) {
+    const uint8_t previous = state_;
+    if (state == previous) {
+        return;
+    }
+    state_ = state;
+
+    if (isInvalid(previous, state)) {
+        invalid_++;
+    } else {
+        travel_ += kTransition[(previous << 2) | state];
+    }
+    if (state != restState_) {
+        return;
+    }
+
+    // Back in a detent: a full cycle is 4 transitions, accept 2 or more in
+    // case a bounce or an invalid transition swallowed some
+    const int8_t travel = travel_;
+    travel_ = 0;
+    if (travel > -2 && travel < 2) {
+        return;
+    }
+
+    pushDetent(travel > 0 ? 1 : -1, static_cast<uint32_t>(esp_timer_get_time()));
+    PowerManager::wakeFromIsr();
+}
+
+void IRAM_ATTR EncoderSampler::pushDetent(int8_t direction, uint32_t timeUs) {
+    const int32_t position = position_.load(std::memory_order_relaxed) + direction;
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    EncoderDetent& detent = queue_[head & (kQueueSize - 1)];
+    detent.timeUs = timeUs;
+    detent.position = position;
+    detent.direction = direction;
+
+    position_.store(position, std::memory_order_release);
+    head_.store(head + 1, std::memory_order_release);
+    encoderCount = position;    // Read-only mirror for older sketches
+}
+
+// ============================================================================
+// Polling (Pcnt backend)
+// ============================================================================
+
+void EncoderSampler::poll() {
+    if (backend_ != EncoderBackend::Pcnt) {
+        return;
+    }
+
+    int16_t count = 0;
+    if (pcnt_get_counter_value(kPcntUnit, &count) != ESP_OK) {
+        return;
+    }
+    const uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+    const uint32_t since = pcntPollUs_;
+    pcntPollUs_ = now;
+
+    // The counter restarts at 0 on reaching either limit; take the shorter way round
+    int32_t counts = static_cast<int32_t>(count) - pcntLast_;
+    if (counts > kPcntLimit / 2) {
+        counts -= kPcntLimit;
+    } else if (counts < -kPcntLimit / 2) {
+        counts += kPcntLimit;
+    }
+    pcntLast_ = count;
+    if (counts == 0) {
+        return;
+    }
+
+    // Detents committed by this travel, each kCountsPerDetent past the last
+    int32_t travel = pcntTravel_ + counts;
+    int32_t detents = 0;
+    if (travel >= kCountsToCommit) {
+        detents = (travel - kCountsToCommit) / kCountsPerDetent + 1;
+    } else if (travel <= -kCountsToCommit) {
+        detents = -((-travel - kCountsToCommit) / kCountsPerDetent + 1);
+    }
+    travel -= detents * kCountsPerDetent;
+    pcntTravel_ = static_cast<int16_t>(travel);
+
+    // Spread the detents over the poll interval so readAccelerated() sees
+    // the spin rate rather than the poll rate
+    const int8_t direction = detents > 0 ? 1 : -1;
+    const uint32_t n = static_cast<uint32_t>(detents > 0 ? detents : -detents);
+    const uint32_t elapsed = now - since;
+    for (uint32_t i = 1; i <= n; ++i) {
+        pushDetent(direction, since + static_cast<uint32_t>(static_cast<uint64_t>(elapsed) * i / n));
+    }
+}
+
+// ============================================================================
+// Readers
+// ============================================================================
+
+void EncoderSampler::sync(Cursor& cursor) const {
+    cursor = Cursor{};
+    cursor.tail = head_.load(std::memory_order_acquire);
+    cursor.position = position_.load(std::memory_order_acquire);
+}
+
+int EncoderSampler::accelerationFor(uint32_t intervalUs) {
+    if (intervalUs == 0 || intervalUs >= kSlowDetentUs) {
+        return 1;
+    }
+    if (intervalUs <= kFastDetentUs) {
+        return kMaxAcceleration;
+    }
+    const uint32_t span = kSlowDetentUs - kFastDetentUs;
+    return 1 + static_cast<int>((kMaxAcceleration - 1) * (kSlowDetentUs - intervalUs) / span);
+}
+
+EncoderDelta EncoderSampler::readAccelerated(Cursor& cursor) {
+    EncoderDelta delta;
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    if (head == cursor.tail) {
+        return delta;
+    }
+
+    uint32_t start = cursor.tail;
+    if (head - start > kQueueSize) {
+        start = head - kQueueSize;
+    }
+    EncoderDetent detents[kQueueSize];
+    size_t count = 0;
+    for (uint32_t i = start; i != head; ++i) {
+        detents[count++] = queue_[i & (kQueueSize - 1)];
+    }
+
+    // Drop copies of slots the ISR reused while we were reading
+    size_t first = 0;
+    const uint32_t after = head_.load(std::memory_order_acquire);
+    if (after - start > kQueueSize) {
+        first = after - start - kQueueSize;
+    }
+    cursor.tail = head;
+    if (first >= count) {
+        // Too far behind to trust any copy: exact count, no acceleration
+        const int32_t position = position_.load(std::memory_order_acquire);
+        delta.steps = position - cursor.position;
+        delta.accelerated = delta.steps;
+        cursor.position = position;
+        cursor.tail = after;
+        cursor.intervalUs = 0;
+        return delta;
+    }
+
+    // Detents skipped before the first usable copy count once each
+    const int32_t last = detents[count - 1].position;
+    const int32_t skipped = detents[first].position - detents[first].direction - cursor.position;
+    delta.steps = last - cursor.position;
+    delta.accelerated = skipped;
+
+    int weightMax = 1;
+    for (size_t i = first; i < count; ++i) {
+        const EncoderDetent& detent = detents[i];
+        const uint32_t interval = detent.timeUs - cursor.lastUs;
+        if (detent.direction != cursor.direction || interval >= 2 * kSlowDetentUs) {
+            cursor.intervalUs = 0;      // Reversal or pause: start slow
+        } else {
+            cursor.intervalUs = cursor.intervalUs == 0
+                                    ? interval
+                                    : (cursor.intervalUs * 3 + interval) / 4;
+        }
+        const int weight = accelerationFor(cursor.intervalUs);
+        weightMax = weight > weightMax ? weight : weightMax;
+        delta.accelerated += detent.direction * weight;
+        cursor.lastUs = detent.timeUs;
+        cursor.direction = detent.direction;
+    }
+    cursor.position = last;
+
+    if (static_cast<uint32_t>(weightMax) > maxAcceleration_) {
+        maxAcceleration_ = weightMax;
+    }
+    return delta;
+}
+
+void EncoderSampler::dump(Print& out) const {
+    out.printf("[Encoder] %s position=%ld detents=%lu invalid=%lu max accel=%lux rest=%u%u\n",
+               backend_ == EncoderBackend::Pcnt ? "PCNT" : "interrupt",
+               static_cast<long>(getPosition()),
+               static_cast<unsigned long>(head_.load(std::memory_order_relaxed)),
+               static_cast<unsigned long>(invalid_),
+               static_cast<unsigned long>(maxAcceleration_),
+               (restState_ >> 1) & 1, restState_ & 1);
+}
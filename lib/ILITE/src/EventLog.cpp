@@ -0,0 +1,350 @@
+/**
+ * @file EventLog.cpp
+ * @brief Connection log persistence in a circular flash partition
+ */
+
+#include "EventLog.h"
+#include "connection_log.h"
+#include "SettingsStore.h"
+#include <esp_partition.h>
+#include <esp_timer.h>
+#include <string.h>
+
+bool EventLog::mounted_ = false;
+uint32_t EventLog::boot_ = 0;
+EventLogStats EventLog::stats_ = {};
+
+namespace {
+
+constexpr uint32_t kSectorMagic = 0x474F4C49;   // "ILOG"
+constexpr uint16_t kRecordMarker = 0xA55A;
+constexpr size_t kMaxText = 95;
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;      ///< +1 per sector opened, 0 never used
+    uint32_t boot;          ///< Boot and time of the sector's first record
+    uint32_t timeMs;
+};
+
+struct RecordHeader {
+    uint16_t marker;
+    uint8_t length;         ///< Text bytes, no terminator
+    uint8_t reserved;
+    uint32_t boot;
+    uint32_t timeMs;
+};
+
+static_assert(sizeof(SectorHeader) == 16, "SectorHeader layout");
+static_assert(sizeof(RecordHeader) == 12, "RecordHeader layout");
+
+inline size_t recordSize(uint8_t length) {
+    return (sizeof(RecordHeader) + length + 3) & ~static_cast<size_t>(3);
+}
+
+const esp_partition_t* partition = nullptr;
+uint32_t sectorCount = 0;
+uint32_t currentSector = 0;
+uint32_t currentSequence = 0;   // 0 = nothing written yet
+uint32_t writeOffset = 0;       // Within the current sector
+int32_t erasedSector = -1;      // Blank and ready to be opened
+
+uint8_t page[EventLog::kPageSize];
+size_t pageUsed = 0;
+uint32_t pageSinceMs = 0;
+
+uint32_t readCursor = 0;        // Next connection log record to persist
+Setting<uint32_t> bootSetting;
+
+inline uint32_t sectorAddress(uint32_t sector) {
+    return sector * EventLog::kSectorSize;
+}
+
+bool readSectorHeader(uint32_t sector, SectorHeader& header) {
+    return esp_partition_read(partition, sectorAddress(sector), &header, sizeof(header)) == ESP_OK &&
+           header.magic == kSectorMagic;
+}
+
+// End of the records in a sector; a torn or foreign record closes the sector
+uint32_t findSectorEnd(uint32_t sector, uint32_t& lastBoot) {
+    uint32_t offset = sizeof(SectorHeader);
+    while (offset + sizeof(RecordHeader) <= EventLog::kSectorSize) {
+        RecordHeader header;
+        if (esp_partition_read(partition, sectorAddress(sector) + offset, &header, sizeof(header)) != ESP_OK) {
+            return EventLog::kSectorSize;
+        }
+        if (header.marker == 0xFFFF) {
+            return offset;
+        }
+        if (header.marker != kRecordMarker || offset + recordSize(header.length) > EventLog::kSectorSize) {
+            return EventLog::kSectorSize;
+        }
+        lastBoot = header.boot;
+        offset += recordSize(header.length);
+    }
+    return EventLog::kSectorSize;
+}
+
+bool eraseSector(uint32_t sector, bool paired, EventLogStats& stats) {
+    const int64_t startUs = esp_timer_get_time();
+    if (esp_partition_erase_range(partition, sectorAddress(sector), EventLog::kSectorSize) != ESP_OK) {
+        return false;
+    }
+    const uint32_t elapsedUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+    stats.erases++;
+    if (paired) {
+        stats.pairedErases++;
+    }
+    if (elapsedUs > stats.maxEraseUs) {
+        stats.maxEraseUs = elapsedUs;
+    }
+    erasedSector = static_cast<int32_t>(sector);
+    return true;
+}
+
+void writePage(EventLogStats& stats) {
+    if (pageUsed == 0) {
+        return;
+    }
+    const int64_t startUs = esp_timer_get_time();
+    esp_partition_write(partition, sectorAddress(currentSector) + writeOffset, page, pageUsed);
+    const uint32_t elapsedUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+    stats.pageWrites++;
+    if (elapsedUs > stats.maxWriteUs) {
+        stats.maxWriteUs = elapsedUs;
+    }
+    writeOffset += pageUsed;
+    pageUsed = 0;
+}
+
+bool openNextSector(uint32_t boot, uint32_t timeMs, bool paired, EventLogStats& stats) {
+    const uint32_t next = currentSequence == 0 ? 0 : (currentSector + 1) % sectorCount;
+    if (erasedSector != static_cast<int32_t>(next) && !eraseSector(next, paired, stats)) {
+        return false;
+    }
+    const SectorHeader header = {kSectorMagic, currentSequence + 1, boot, timeMs};
+    if (esp_partition_write(partition, sectorAddress(next), &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    currentSector = next;
+    currentSequence++;
+    writeOffset = sizeof(SectorHeader);
+    erasedSector = -1;
+    return true;
+}
+
+void append(uint32_t boot, uint32_t timeMs, const char* text, bool paired, EventLogStats& stats) {
+    const size_t textLength = strlen(text);
+    const uint8_t length = static_cast<uint8_t>(textLength < kMaxText ? textLength : kMaxText);
+    const size_t size = recordSize(length);
+
+    // Records never straddle sectors
+    if (currentSequence == 0 || writeOffset + pageUsed + size > EventLog::kSectorSize) {
+        writePage(stats);
+        if (!openNextSector(boot, timeMs, paired, stats)) {
+            stats.lost++;
+            return;
+        }
+    }
+    if (pageUsed + size > EventLog::kPageSize) {
+        writePage(stats);
+    }
+    if (pageUsed == 0) {
+        pageSinceMs = millis();
+    }
+
+    const RecordHeader header = {kRecordMarker, length, 0, boot, timeMs};
+    uint8_t* dst = page + pageUsed;
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), text, length);
+    memset(dst + sizeof(header) + length, 0, size - sizeof(header) - length);
+    pageUsed += size;
+    stats.written++;
+}
+
+// Calls visit(header, text) for every stored record, oldest sector first.
+// Sectors whose first record is newer than maxBoot are skipped unread.
+template <typename Visitor>
+void forEachRecord(uint32_t maxBoot, Visitor visit) {
+    for (uint32_t k = 1; k <= sectorCount; k++) {
+        const uint32_t sector = (currentSector + k) % sectorCount;
+        SectorHeader sectorHeader;
+        if (!readSectorHeader(sector, sectorHeader) || sectorHeader.boot > maxBoot) {
+            continue;
+        }
+        const uint32_t end = (sector == currentSector && currentSequence != 0)
+                                 ? writeOffset : EventLog::kSectorSize;
+        uint32_t offset = sizeof(SectorHeader);
+        while (offset + sizeof(RecordHeader) <= end) {
+            RecordHeader header;
+            char text[kMaxText + 1];
+            if (esp_partition_read(partition, sectorAddress(sector) + offset, &header, sizeof(header)) != ESP_OK ||
+                header.marker != kRecordMarker || offset + recordSize(header.length) > end) {
+                break;
+            }
+            esp_partition_read(partition, sectorAddress(sector) + offset + sizeof(header), text, header.length);
+            text[header.length] = '\0';
+            visit(header, text);
+            offset += recordSize(header.length);
+        }
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool EventLog::begin() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         kPartitionLabel);
+    if (partition == nullptr || partition->size / kSectorSize < 2) {
+        Serial.println("[EventLog] No \"eventlog\" partition, log stays in RAM");
+        return false;
+    }
+    sectorCount = partition->size / kSectorSize;
+
+    // Newest sector by sequence; the write position follows its last record
+    for (uint32_t sector = 0; sector < sectorCount; sector++) {
+        SectorHeader header;
+        if (readSectorHeader(sector, header) && header.sequence > currentSequence) {
+            currentSequence = header.sequence;
+            currentSector = sector;
+        }
+    }
+    uint32_t lastBoot = 0;
+    if (currentSequence != 0) {
+        writeOffset = findSectorEnd(currentSector, lastBoot);
+    }
+
+    // Boots are counted in NVS; the flash contents win if NVS was wiped
+    bootSetting = SettingsStore::getInstance().add("eventlog", "boots", static_cast<uint32_t>(0));
+    boot_ = (bootSetting.get() > lastBoot ? bootSetting.get() : lastBoot) + 1;
+    bootSetting.set(boot_);
+    SettingsStore::getInstance().commitNow();
+
+    mounted_ = true;
+    Serial.printf("[EventLog] Boot %lu, %lu KiB partition, sector %lu at %lu\n",
+                  static_cast<unsigned long>(boot_),
+                  static_cast<unsigned long>(partition->size / 1024),
+                  static_cast<unsigned long>(currentSector),
+                  static_cast<unsigned long>(writeOffset));
+    return true;
+}
+
+// ============================================================================
+// Flushing
+// ============================================================================
+
+void EventLog::service(bool paired, uint32_t nowMs) {
+    if (!mounted_) {
+        return;
+    }
+
+    char text[kMaxText + 1];
+    uint32_t timeMs = 0;
+    while (connectionLogReadNext(readCursor, timeMs, text, sizeof(text), stats_.lost)) {
+        append(boot_, timeMs, text, paired, stats_);
+    }
+    if (pageUsed > 0 && nowMs - pageSinceMs >= kFlushMs) {
+        writePage(stats_);
+    }
+
+    // Keep the next sector blank so a match never waits for an erase
+    if (!paired && currentSequence != 0) {
+        const uint32_t next = (currentSector + 1) % sectorCount;
+        if (erasedSector != static_cast<int32_t>(next)) {
+            eraseSector(next, false, stats_);
+        }
+    }
+}
+
+void EventLog::flush() {
+    if (mounted_) {
+        writePage(stats_);
+    }
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+void EventLog::dumpBoots(Print& out) {
+    if (!mounted_) {
+        out.println("[EventLog] Not mounted");
+        return;
+    }
+    flush();
+
+    uint32_t boot = 0;
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+    uint32_t count = 0;
+    auto report = [&]() {
+        if (count > 0) {
+            out.printf("[EventLog] boot %lu: %lu records, %lu.%03lu-%lu.%03lu s\n",
+                       static_cast<unsigned long>(boot), static_cast<unsigned long>(count),
+                       static_cast<unsigned long>(firstMs / 1000), static_cast<unsigned long>(firstMs % 1000),
+                       static_cast<unsigned long>(lastMs / 1000), static_cast<unsigned long>(lastMs % 1000));
+        }
+    };
+    forEachRecord(UINT32_MAX, [&](const RecordHeader& header, const char*) {
+        if (header.boot != boot || count == 0) {
+            report();
+            boot = header.boot;
+            firstMs = header.timeMs;
+            count = 0;
+        }
+        lastMs = header.timeMs;
+        count++;
+    });
+    report();
+}
+
+void EventLog::download(Print& out, uint32_t boot) {
+    if (!mounted_) {
+        out.println("[EventLog] Not mounted");
+        return;
+    }
+    flush();
+
+    uint32_t count = 0;
+    out.println("boot,ms,text");
+    forEachRecord(boot != 0 ? boot : UINT32_MAX, [&](const RecordHeader& header, const char* text) {
+        if (boot == 0 || header.boot == boot) {
+            out.printf("%lu,%lu,%s\n", static_cast<unsigned long>(header.boot),
+                       static_cast<unsigned long>(header.timeMs), text);
+            count++;
+        }
+    });
+    out.printf("[EventLog] %lu records\n", static_cast<unsigned long>(count));
+}
+
+void EventLog::erase() {
+    if (!mounted_) {
+        return;
+    }
+    esp_partition_erase_range(partition, 0, sectorCount * kSectorSize);
+    currentSector = 0;
+    currentSequence = 0;
+    writeOffset = 0;
+    erasedSector = 0;
+    pageUsed = 0;
+}
+
+void EventLog::dump(Print& out) {
+    if (!mounted_) {
+        out.println("[EventLog] Not mounted (RAM log only)");
+        return;
+    }
+    out.printf("[EventLog] boot %lu, sector %lu/%lu seq %lu at %lu, %u bytes pending\n",
+               static_cast<unsigned long>(boot_), static_cast<unsigned long>(currentSector),
+               static_cast<unsigned long>(sectorCount), static_cast<unsigned long>(currentSequence),
+               static_cast<unsigned long>(writeOffset), static_cast<unsigned>(pageUsed));
+    out.printf("[EventLog] written %lu, lost %lu, %lu page writes (max %lu us), %lu erases (%lu paired, max %lu us)\n",
+               static_cast<unsigned long>(stats_.written), static_cast<unsigned long>(stats_.lost),
+               static_cast<unsigned long>(stats_.pageWrites), static_cast<unsigned long>(stats_.maxWriteUs),
+               static_cast<unsigned long>(stats_.erases), static_cast<unsigned long>(stats_.pairedErases),
+               static_cast<unsigned long>(stats_.maxEraseUs));
+}
@@ -0,0 +1,674 @@
+/**
+ * @file FirmwareRelay.cpp
+ * @brief Console staging into the spare OTA slot and the windowed chunk sender
+ */
+
+#include "FirmwareRelay.h"
+#include "DisplayCanvas.h"
+#include "ScreenRegistry.h"
+#include "IconLibrary.h"
+#include "Transport.h"
+#include "espnow_discovery.h"
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp32/rom/crc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <algorithm>
+#include <string.h>
+
+extern EspNowDiscovery discovery;
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 4096;
+constexpr UBaseType_t kTaskPriority = 2;
+constexpr BaseType_t kTaskCore = 1;
+constexpr uint32_t kBeginRepeatMs = 500;
+constexpr uint32_t kEndRepeatMs = 300;
+constexpr uint32_t kDoneTimeoutMs = 10000;      // Robot checking the CRC and switching partitions
+constexpr uint32_t kSectorBytes = 4096;
+
+static_assert(FirmwareRelay::kWindow <= 32, "ACK bitmap covers 32 chunks past the base");
+static_assert(sizeof(FirmwareChunkHeader) + kFirmwareChunkBytes == 250, "Chunk frame is one ESP-NOW frame");
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Shared with RxTask (ACKs) and the WiFi task (send callbacks), under g_lock
+FirmwareRelayStats g_stats;
+uint8_t g_mac[6] = {};
+uint16_t g_session = 0;
+uint16_t g_base = 0;                // Robot's cumulative ACK
+uint32_t g_received = 0;            // Robot's bitmap past g_base
+uint8_t g_robotStatus = kFirmwareReceiving;
+bool g_statusFresh = false;
+uint8_t g_inFlight = 0;
+uint32_t g_lastActivityUs = 0;      // Last claim or callback of a queued frame
+
+// Relay task only
+TaskHandle_t g_task = nullptr;
+volatile bool g_abortRequested = false;
+uint32_t g_sentUs[FirmwareRelay::kWindow];
+uint32_t g_startMs = 0;
+
+// Staged image (ServiceTask while staging, read-only during a transfer)
+const esp_partition_t* g_slot = nullptr;
+uint32_t g_imageBytes = 0;
+uint32_t g_imageCrc = 0;
+bool g_haveImage = false;
+uint8_t g_block[FirmwareRelay::kStageBlockBytes];
+size_t g_blockFill = 0;
+uint32_t g_stagedBytes = 0;
+uint32_t g_stageCrc = 0;
+uint32_t g_lastByteMs = 0;
+
+inline uint32_t nowUs() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+void setState(RelayState state, const char* error = nullptr) {
+    portENTER_CRITICAL(&g_lock);
+    g_stats.state = state;
+    g_stats.error = error;
+    portEXIT_CRITICAL(&g_lock);
+}
+
+RelayState getState() {
+    portENTER_CRITICAL(&g_lock);
+    const RelayState state = g_stats.state;
+    portEXIT_CRITICAL(&g_lock);
+    return state;
+}
+
+bool isTransferState(RelayState state) {
+    return state == RelayState::Starting || state == RelayState::Sending ||
+           state == RelayState::Finishing;
+}
+
+const char* stateName(RelayState state) {
+    switch (state) {
+        case RelayState::Idle: return "idle";
+        case RelayState::Staging: return "staging";
+        case RelayState::Staged: return "staged";
+        case RelayState::Starting: return "waiting for robot";
+        case RelayState::Sending: return "sending";
+        case RelayState::Finishing: return "verifying";
+        case RelayState::Done: return "done";
+        case RelayState::Failed: return "failed";
+    }
+    return "?";
+}
+
+const char* robotError(uint8_t status) {
+    switch (status) {
+        case kFirmwareErrorSpace: return "image too large for robot";
+        case kFirmwareErrorCrc: return "robot CRC mismatch";
+        case kFirmwareErrorFlash: return "robot flash error";
+        case kFirmwareErrorSession: return "robot lost the session";
+    }
+    return "robot error";
+}
+
+// ============================================================================
+// Staging
+// ============================================================================
+
+void failStaging(const char* error) {
+    g_haveImage = false;
+    setState(RelayState::Failed, error);
+    Serial.printf("[Relay] Staging failed: %s\n", error);
+}
+
+void writeBlock() {
+    // Blocks divide sectors, so a sector is erased when its first block arrives
+    if (g_stagedBytes % kSectorBytes == 0 &&
+        esp_partition_erase_range(g_slot, g_stagedBytes, kSectorBytes) != ESP_OK) {
+        failStaging("flash erase");
+        return;
+    }
+    if (esp_partition_write(g_slot, g_stagedBytes, g_block, g_blockFill) != ESP_OK) {
+        failStaging("flash write");
+        return;
+    }
+    g_stageCrc = crc32_le(g_stageCrc, g_block, g_blockFill);
+    g_stagedBytes += g_blockFill;
+    g_blockFill = 0;
+    Serial.printf("[Relay] staged %lu\n", static_cast<unsigned long>(g_stagedBytes));
+
+    if (g_stagedBytes < g_imageBytes) {
+        return;
+    }
+    if (g_stageCrc != g_imageCrc) {
+        failStaging("CRC mismatch");
+        return;
+    }
+    g_haveImage = true;
+    setState(RelayState::Staged);
+    Serial.printf("[Relay] Image staged: %lu B, CRC %08lx\n",
+                  static_cast<unsigned long>(g_imageBytes), static_cast<unsigned long>(g_imageCrc));
+}
+
+// ============================================================================
+// Transfer
+// ============================================================================
+
+/// Hand one frame to the link, claiming a queue slot first (a wired
+/// transport completes inside send())
+esp_err_t sendFrame(const void* frame, size_t length) {
+    portENTER_CRITICAL(&g_lock);
+    g_inFlight++;
+    g_lastActivityUs = nowUs();
+    portEXIT_CRITICAL(&g_lock);
+
+    const esp_err_t err = Transport::getActive().send(g_mac, static_cast<const uint8_t*>(frame), length);
+    if (err != ESP_OK) {
+        portENTER_CRITICAL(&g_lock);
+        if (g_inFlight > 0) {
+            g_inFlight--;
+        }
+        if (err == ESP_ERR_ESPNOW_NO_MEM) {
+            g_stats.driverFull++;
+        }
+        portEXIT_CRITICAL(&g_lock);
+    }
+    return err;
+}
+
+esp_err_t sendChunk(uint16_t index) {
+    uint8_t frame[sizeof(FirmwareChunkHeader) + kFirmwareChunkBytes];
+    uint8_t* data = frame + sizeof(FirmwareChunkHeader);
+    const uint32_t offset = static_cast<uint32_t>(index) * kFirmwareChunkBytes;
+    const size_t length = std::min<uint32_t>(kFirmwareChunkBytes, g_imageBytes - offset);
+    if (esp_partition_read(g_slot, offset, data, length) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    FirmwareChunkHeader header;
+    header.magic = FIRMWARE_CHUNK_MAGIC;
+    header.session = g_session;
+    header.index = index;
+    header.crc = firmwareChunkCrc(data, length);
+    memcpy(frame, &header, sizeof(header));
+    return sendFrame(frame, sizeof(header) + length);
+}
+
+void sendEnd(uint32_t magic) {
+    FirmwareEndFrame end;
+    end.magic = magic;
+    end.session = g_session;
+    end.reserved = 0;
+    end.imageCrc = g_imageCrc;
+    sendFrame(&end, sizeof(end));
+}
+
+/// Status of the newest ACK, once
+bool takeStatus(uint8_t& status) {
+    portENTER_CRITICAL(&g_lock);
+    const bool fresh = g_statusFresh;
+    status = g_robotStatus;
+    g_statusFresh = false;
+    portEXIT_CRITICAL(&g_lock);
+    return fresh;
+}
+
+bool isAcknowledged(uint16_t index, uint16_t base, uint32_t received) {
+    if (index < base) {
+        return true;
+    }
+    if (index == base) {
+        return false;
+    }
+    return (received >> (index - base - 1)) & 1u;
+}
+
+/**
+ * @brief Next chunk to send: a lost one first, else the next new one
+ *
+ * A chunk is lost when a chunk sent after it was acknowledged (the link
+ * keeps order) or when it has gone kRetransmitUs without an ACK.
+ */
+int pickChunk(uint16_t base, uint32_t received, uint16_t nextNew, uint32_t now) {
+    uint32_t lostBeforeUs = 0;
+    bool haveEvidence = false;
+    if (received != 0) {
+        const uint16_t highest = base + 1 + (31 - __builtin_clz(received));
+        if (highest < nextNew) {
+            lostBeforeUs = g_sentUs[highest % FirmwareRelay::kWindow];
+            haveEvidence = true;
+        }
+    }
+
+    for (uint16_t index = base; index < nextNew; ++index) {
+        if (isAcknowledged(index, base, received)) {
+            continue;
+        }
+        const uint32_t sentUs = g_sentUs[index % FirmwareRelay::kWindow];
+        if (now - sentUs >= FirmwareRelay::kRetransmitUs ||
+            (haveEvidence && static_cast<int32_t>(lostBeforeUs - sentUs) > 0)) {
+            return index;
+        }
+    }
+
+    const uint32_t windowEnd = static_cast<uint32_t>(base) + FirmwareRelay::kWindow;
+    if (nextNew < g_stats.chunkCount && nextNew < windowEnd) {
+        return nextNew;
+    }
+    return -1;
+}
+
+void updateRate() {
+    portENTER_CRITICAL(&g_lock);
+    g_stats.elapsedMs = millis() - g_startMs;
+    g_stats.acknowledged = g_base;
+    const uint32_t bytes = std::min<uint32_t>(static_cast<uint32_t>(g_base) * kFirmwareChunkBytes, g_imageBytes);
+    g_stats.bytesPerSecond = g_stats.elapsedMs ? static_cast<uint32_t>(
+        static_cast<uint64_t>(bytes) * 1000 / g_stats.elapsedMs) : 0;
+    portEXIT_CRITICAL(&g_lock);
+}
+
+const char* waitForReady() {
+    FirmwareBeginFrame begin;
+    begin.magic = FIRMWARE_BEGIN_MAGIC;
+    begin.session = g_session;
+    begin.chunkBytes = kFirmwareChunkBytes;
+    begin.reserved = 0;
+    begin.imageBytes = g_imageBytes;
+    begin.chunkCount = g_stats.chunkCount;
+    begin.reserved2 = 0;
+    begin.imageCrc = g_imageCrc;
+
+    uint32_t lastSentMs = 0;
+    bool sent = false;
+    while (!g_abortRequested) {
+        uint8_t status;
+        if (takeStatus(status)) {
+            if (status == kFirmwareReady) {
+                return nullptr;
+            }
+            if (status >= kFirmwareErrorSpace) {
+                return robotError(status);
+            }
+        }
+        if (millis() - g_startMs > FirmwareRelay::kReadyTimeoutMs) {
+            return "robot not ready";
+        }
+        if (!sent || millis() - lastSentMs >= kBeginRepeatMs) {
+            sendFrame(&begin, sizeof(begin));
+            lastSentMs = millis();
+            sent = true;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+    }
+    return "aborted";
+}
+
+const char* sendChunks() {
+    uint16_t nextNew = 0;
+    uint16_t lastBase = 0;
+    uint32_t lastProgressMs = millis();
+    unsigned lastDecile = 0;
+
+    while (!g_abortRequested) {
+        const uint32_t now = nowUs();
+        portENTER_CRITICAL(&g_lock);
+        // Callbacks lost (or spent on other frames to the robot) release their slots
+        if (g_inFlight > 0 && now - g_lastActivityUs > FirmwareRelay::kCallbackTimeoutUs) {
+            g_inFlight = 0;
+        }
+        const uint16_t base = g_base;
+        const uint32_t received = g_received;
+        uint8_t inFlight = g_inFlight;
+        portEXIT_CRITICAL(&g_lock);
+
+        if (base >= g_stats.chunkCount) {
+            return nullptr;
+        }
+        uint8_t status;
+        if (takeStatus(status) && status >= kFirmwareErrorSpace) {
+            return robotError(status);
+        }
+
+        if (base != lastBase) {
+            lastBase = base;
+            lastProgressMs = millis();
+            updateRate();
+            const unsigned decile = static_cast<unsigned>(base) * 10 / g_stats.chunkCount;
+            if (decile != lastDecile) {
+                lastDecile = decile;
+                Serial.printf("[Relay] %u%% %lu B/s\n", decile * 10,
+                              static_cast<unsigned long>(g_stats.bytesPerSecond));
+            }
+        } else if (millis() - lastProgressMs > FirmwareRelay::kStallTimeoutMs) {
+            return "robot stopped acknowledging";
+        }
+
+        while (inFlight < FirmwareRelay::kMaxQueued) {
+            const int index = pickChunk(base, received, nextNew, nowUs());
+            if (index < 0) {
+                break;
+            }
+            const esp_err_t err = sendChunk(static_cast<uint16_t>(index));
+            if (err == ESP_ERR_ESPNOW_NO_MEM) {
+                break;
+            }
+            if (err != ESP_OK) {
+                return "send failed";
+            }
+            g_sentUs[index % FirmwareRelay::kWindow] = nowUs();
+            inFlight++;
+
+            portENTER_CRITICAL(&g_lock);
+            g_stats.chunksSent++;
+            if (index < nextNew) {
+                g_stats.retransmits++;
+            }
+            portEXIT_CRITICAL(&g_lock);
+            if (index == nextNew) {
+                nextNew++;
+            }
+        }
+
+        // Woken by every send completion and ACK
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2));
+    }
+    return "aborted";
+}
+
+const char* waitForDone() {
+    const uint32_t startMs = millis();
+    uint32_t lastSentMs = 0;
+    bool sent = false;
+    while (!g_abortRequested) {
+        uint8_t status;
+        if (takeStatus(status)) {
+            if (status == kFirmwareDone) {
+                return nullptr;
+            }
+            if (status >= kFirmwareErrorSpace) {
+                return robotError(status);
+            }
+        }
+        if (millis() - startMs > kDoneTimeoutMs) {
+            return "no DONE from robot";
+        }
+        if (!sent || millis() - lastSentMs >= kEndRepeatMs) {
+            sendEnd(FIRMWARE_END_MAGIC);
+            lastSentMs = millis();
+            sent = true;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+    }
+    return "aborted";
+}
+
+void relayTask(void*) {
+    const char* error = waitForReady();
+    if (error == nullptr) {
+        setState(RelayState::Sending);
+        error = sendChunks();
+    }
+    if (error == nullptr) {
+        setState(RelayState::Finishing);
+        error = waitForDone();
+    }
+    if (error != nullptr) {
+        sendEnd(FIRMWARE_ABORT_MAGIC);
+    }
+
+    updateRate();
+    setState(error == nullptr ? RelayState::Done : RelayState::Failed, error);
+    FirmwareRelay::dump(Serial);
+
+    g_task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+// ============================================================================
+// Screen
+// ============================================================================
+
+void drawRelayScreen(DisplayCanvas& canvas) {
+    const FirmwareRelayStats stats = FirmwareRelay::getStats();
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+    canvas.drawText(0, 6, "Robot Firmware");
+    canvas.drawLine(0, 8, 127, 8);
+
+    canvas.drawTextF(0, 17, "%s", stats.error != nullptr ? stats.error : stateName(stats.state));
+    if (g_imageBytes > 0) {
+        canvas.drawTextF(0, 25, "Image %lu B", static_cast<unsigned long>(g_imageBytes));
+    }
+    if (stats.chunkCount > 0) {
+        const float done = static_cast<float>(stats.acknowledged) / stats.chunkCount;
+        canvas.drawProgressBar(0, 30, 128, 7, done);
+        canvas.drawTextF(0, 46, "%u%%  %lu B/s", static_cast<unsigned>(done * 100.0f),
+                         static_cast<unsigned long>(stats.bytesPerSecond));
+        canvas.drawTextF(0, 54, "re %lu  fail %lu  full %lu",
+                         static_cast<unsigned long>(stats.retransmits),
+                         static_cast<unsigned long>(stats.sendFailures),
+                         static_cast<unsigned long>(stats.driverFull));
+    }
+    canvas.drawText(0, 63, FirmwareRelay::isActive() ? "B1:Back B3:Abort" : "B1:Back B2:Send");
+}
+
+void startToPaired() {
+    if (discovery.isPaired()) {
+        FirmwareRelay::start(discovery.getPairedMac());
+    }
+}
+
+constexpr Screen kRelayScreen[] = {{
+    "framework.relay", "Robot Firmware", ICON_SETTINGS,
+    &drawRelayScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, &startToPaired, &FirmwareRelay::abort,
+    false
+}};
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void FirmwareRelay::begin() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+    ScreenRegistry::registerTable(kRelayScreen, 1);
+    registered = true;
+}
+
+// ============================================================================
+// Staging
+// ============================================================================
+
+bool FirmwareRelay::beginStaging(uint32_t imageBytes, uint32_t crc32) {
+    const RelayState state = getState();
+    if (isTransferState(state) || state == RelayState::Staging) {
+        return false;
+    }
+    g_slot = esp_ota_get_next_update_partition(nullptr);
+    if (g_slot == nullptr || imageBytes == 0 || imageBytes > g_slot->size) {
+        Serial.printf("[Relay] No room for %lu B\n", static_cast<unsigned long>(imageBytes));
+        return false;
+    }
+
+    g_haveImage = false;
+    g_imageBytes = imageBytes;
+    g_imageCrc = crc32;
+    g_blockFill = 0;
+    g_stagedBytes = 0;
+    g_stageCrc = 0;
+    g_lastByteMs = millis();
+    portENTER_CRITICAL(&g_lock);
+    g_stats = FirmwareRelayStats{};
+    g_stats.state = RelayState::Staging;
+    g_stats.imageBytes = imageBytes;
+    portEXIT_CRITICAL(&g_lock);
+    Serial.printf("[Relay] ready for %lu B in %s\n", static_cast<unsigned long>(imageBytes), g_slot->label);
+    return true;
+}
+
+bool FirmwareRelay::isStaging() {
+    return getState() == RelayState::Staging;
+}
+
+void FirmwareRelay::feed(uint8_t byte) {
+    g_block[g_blockFill++] = byte;
+    g_lastByteMs = millis();
+    if (g_blockFill == kStageBlockBytes || g_stagedBytes + g_blockFill == g_imageBytes) {
+        writeBlock();
+    }
+}
+
+void FirmwareRelay::service(uint32_t nowMs) {
+    if (isStaging() && nowMs - g_lastByteMs > kStageTimeoutMs) {
+        failStaging("console went quiet");
+    }
+}
+
+// ============================================================================
+// Transfer
+// ============================================================================
+
+bool FirmwareRelay::start(const uint8_t* mac) {
+    if (mac == nullptr || !g_haveImage || g_task != nullptr || isTransferState(getState())) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&g_lock);
+    memcpy(g_mac, mac, sizeof(g_mac));
+    g_session = static_cast<uint16_t>(esp_random());
+    g_base = 0;
+    g_received = 0;
+    g_robotStatus = kFirmwareReceiving;
+    g_statusFresh = false;
+    g_inFlight = 0;
+    g_stats = FirmwareRelayStats{};
+    g_stats.state = RelayState::Starting;
+    g_stats.imageBytes = g_imageBytes;
+    g_stats.chunkCount = static_cast<uint16_t>((g_imageBytes + kFirmwareChunkBytes - 1) / kFirmwareChunkBytes);
+    portEXIT_CRITICAL(&g_lock);
+    g_abortRequested = false;
+    g_startMs = millis();
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        relayTask,
+        "FwRelay",
+        kTaskStackSize,
+        nullptr,
+        kTaskPriority,
+        &g_task,
+        kTaskCore
+    );
+    if (result != pdPASS) {
+        g_task = nullptr;
+        setState(RelayState::Failed, "no task");
+        return false;
+    }
+    Serial.printf("[Relay] Sending %lu B in %u chunks\n", static_cast<unsigned long>(g_imageBytes),
+                  static_cast<unsigned>(g_stats.chunkCount));
+    return true;
+}
+
+void FirmwareRelay::abort() {
+    if (isStaging()) {
+        failStaging("aborted");
+        return;
+    }
+    g_abortRequested = true;
+    if (g_task != nullptr) {
+        xTaskNotifyGive(g_task);
+    }
+}
+
+bool FirmwareRelay::isActive() {
+    return isTransferState(getState());
+}
+
+bool FirmwareRelay::isTarget(const uint8_t* mac) {
+    return mac != nullptr && isActive() && memcmp(mac, g_mac, sizeof(g_mac)) == 0;
+}
+
+bool FirmwareRelay::onFrame(const uint8_t* mac, const uint8_t* data, size_t length) {
+    if (length < sizeof(FirmwareAckFrame)) {
+        return false;
+    }
+    FirmwareAckFrame ack;
+    memcpy(&ack, data, sizeof(ack));
+    if (ack.magic != FIRMWARE_ACK_MAGIC) {
+        return false;
+    }
+    if (!isTarget(mac)) {
+        return true;
+    }
+
+    portENTER_CRITICAL(&g_lock);
+    if (ack.session == g_session) {
+        g_stats.acks++;
+        g_robotStatus = ack.status;
+        g_statusFresh = true;
+        if (ack.base > g_base) {
+            g_base = ack.base;
+            g_received = ack.received;
+        } else if (ack.base == g_base) {
+            g_received |= ack.received;
+        }
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (g_task != nullptr) {
+        xTaskNotifyGive(g_task);
+    }
+    return true;
+}
+
+void FirmwareRelay::onSendComplete(const uint8_t* mac, bool success) {
+    if (!isTarget(mac)) {
+        return;
+    }
+    portENTER_CRITICAL(&g_lock);
+    if (g_inFlight > 0) {
+        g_inFlight--;
+    }
+    g_lastActivityUs = nowUs();
+    if (!success) {
+        g_stats.sendFailures++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (g_task != nullptr) {
+        xTaskNotifyGive(g_task);
+    }
+}
+
+FirmwareRelayStats FirmwareRelay::getStats() {
+    portENTER_CRITICAL(&g_lock);
+    FirmwareRelayStats stats = g_stats;
+    portEXIT_CRITICAL(&g_lock);
+    if (isTransferState(stats.state)) {
+        stats.elapsedMs = millis() - g_startMs;
+    }
+    return stats;
+}
+
+void FirmwareRelay::dump(Print& out) {
+    const FirmwareRelayStats s = getStats();
+    out.printf("[Relay] %s%s%s, image %lu B%s\n", stateName(s.state),
+               s.error != nullptr ? ": " : "", s.error != nullptr ? s.error : "",
+               static_cast<unsigned long>(g_imageBytes), g_haveImage ? " staged" : "");
+    if (s.chunkCount == 0) {
+        return;
+    }
+    out.printf("[Relay] %u/%u chunks in %lu ms (%lu B/s)\n",
+               static_cast<unsigned>(s.acknowledged), static_cast<unsigned>(s.chunkCount),
+               static_cast<unsigned long>(s.elapsedMs), static_cast<unsigned long>(s.bytesPerSecond));
+    out.printf("[Relay] sent %lu, resent %lu, acks %lu, send failures %lu, driver full %lu\n",
+               static_cast<unsigned long>(s.chunksSent), static_cast<unsigned long>(s.retransmits),
+               static_cast<unsigned long>(s.acks), static_cast<unsigned long>(s.sendFailures),
+               static_cast<unsigned long>(s.driverFull));
+}
@@ -14,9 +14,24 @@
 #include "DefaultActions.h"
 #include "IconLibrary.h"
 #include "InputManager.h"
+#include "BatteryMonitor.h"
+#include "StatusLed.h"
+#include "LatencyPins.h"
 #include "StringBuilder.h"
 #include "ILITE.h"
 #include "ControlBindingSystem.h"
+#include "Profiler.h"
+#include "RenderScheduler.h"
+#include "TaskMonitor.h"
+#include "LinkMetrics.h"
+#include "TelemetryHealth.h"
+#include "CommandStamp.h"
+#include "espnow_discovery.h"
+#include "ModuleArena.h"
+#include "ModuleHandoff.h"
+#include "FirmwareRelay.h"
+#include "TdmaSlots.h"
+#include "ControlDeadline.h"
 #include "input.h"
 #include <WiFi.h>
 #include <algorithm>
@@ -24,6 +39,8 @@
 #include <vector>
 #include <string>
 
+extern EspNowDiscovery discovery;
+
 // ============================================================================
 // Singleton Instance
 // ============================================================================
@@ -50,26 +67,45 @@ FrameworkEngine::FrameworkEngine()
     , editingEntry_(nullptr)
     , editValueInt_(0)
     , editValueFloat_(0.0f)
-    , lastEncoderRotateMs_(0)
+    , editStartInt_(0)
+    , editStartFloat_(0.0f)
+    , editDirty_(false)
+    , editDirtyMs_(0)
     , cursorBlinkTimer_(0)
     , batteryPercent_(100)
     , statusAnimFrame_(0)
-    , ledLastUpdateMs_(0)
-    , ledBlinkPhase_(0)
-    , ledState_(false)
+    , retainedScreen_(nullptr)
+    , dashboardSkipped_(false)
+    , genericTitle_(0, DASHBOARD_Y + 4, 128, 10, DisplayCanvas::NORMAL,
+                    [] { return "ILITE v2.0"; }, true)
+    , genericCount_(0, DASHBOARD_Y + 19, 128, 9, DisplayCanvas::SMALL,
+                    [this] {
+                        snprintf(genericCountText_, sizeof(genericCountText_), "Modules: %d",
+                                 static_cast<int>(ModuleRegistry::getModuleCount()));
+                        return genericCountText_;
+                    }, true)
+    , genericStatus_(0, DASHBOARD_Y + 31, 128, 9, DisplayCanvas::SMALL,
+                     [this] { return genericStatusText(); }, true)
+    , genericHelp_(0, DASHBOARD_Y + 45, 128, 7, DisplayCanvas::TINY,
+                   [] { return "Press encoder for menu"; }, true)
     , menuSelection_(0)
     , menuScrollOffset_(0)
+    , menuScrollTween_(120, Ease::OutCubic)
+    , menuCursorTween_(90, Ease::OutCubic)
+    , menuAnimMenu_(nullptr)
 {
     hasEncoderFunction_[0] = false;
     hasEncoderFunction_[1] = false;
 
+    genericCountText_[0] = '\0';
+    genericScreen_.add(genericTitle_);
+    genericScreen_.add(genericCount_);
+    genericScreen_.add(genericStatus_);
+    genericScreen_.add(genericHelp_);
+
     for (int i = 0; i < 3; i++) {
         defaultButtonCallbacks_[i] = nullptr;
     }
-
-    // Initialize LED pin
-    pinMode(LED_PIN, OUTPUT);
-    digitalWrite(LED_PIN, LOW);
 }
 
 // ============================================================================
@@ -196,10 +232,14 @@ void FrameworkEngine::registerDefaultMenuEntries() {
     battery.condition = nullptr;
     battery.getValue = []() {
         static char battStr[32];
-        const InputManager& inputs = InputManager::getInstance();
-        float voltage = inputs.getBatteryVoltage();
-        uint8_t percent = inputs.getBatteryPercent();
-        snprintf(battStr, sizeof(battStr), "%.2fV (%d%%)", voltage, percent);
+        const uint16_t minutes = BatteryMonitor::getMinutesToEmpty();
+        if (minutes > 0) {
+            snprintf(battStr, sizeof(battStr), "%.2fV %d%% %uh%02u", BatteryMonitor::getVoltage(),
+                     BatteryMonitor::getPercent(), minutes / 60, minutes % 60);
+        } else {
+            snprintf(battStr, sizeof(battStr), "%.2fV (%d%%)", BatteryMonitor::getVoltage(),
+                     BatteryMonitor::getPercent());
+        }
         return battStr;
     };
     battery.priority = 2;
@@ -250,6 +290,249 @@ void FrameworkEngine::registerDefaultMenuEntries() {
     espnow.customDraw = nullptr;
     MenuRegistry::registerEntry(espnow);
 
+    // Control loop timing
+    MenuEntry loop;
+    loop.id = "framework.status.loop";
+    loop.parent = "framework.status";
+    loop.icon = ICON_INFO;
+    loop.label = "Control Loop";
+    loop.shortLabel = "Loop";
+    loop.onSelect = []() {
+        ILITE.resetControlLoopStats();
+    };
+    loop.condition = nullptr;
+    loop.getValue = []() {
+        static char loopStr[32];
+        const ControlLoopStats& stats = ILITE.getControlLoopStats();
+        uint32_t hz = stats.targetPeriodUs ? 1000000UL / stats.targetPeriodUs : 0;
+        snprintf(loopStr, sizeof(loopStr), "%luHz j%lu o%lu%s%s",
+                 hz, stats.maxJitterUs, stats.overrunCount,
+                 stats.telemetryTicks > 0 ? " T" : "",
+                 ControlDeadline::isDegraded() ? " DEG" : "");
+        return loopStr;
+    };
+    loop.priority = 5;
+    loop.isSubmenu = false;
+    loop.isToggle = false;
+    loop.getToggleState = nullptr;
+    loop.isReadOnly = false;
+    loop.customDraw = nullptr;
+    MenuRegistry::registerEntry(loop);
+
+    // Frame profiler (opens the "framework.profiler" screen)
+    MenuEntry profiler;
+    profiler.id = "framework.profiler";
+    profiler.parent = "framework.status";
+    profiler.icon = ICON_TUNING;
+    profiler.label = "Profiler";
+    profiler.shortLabel = "Prof";
+    profiler.onSelect = nullptr;
+    profiler.condition = nullptr;
+    profiler.getValue = []() {
+        static char frameStr[16];
+        const ProfileStats stats = Profiler::getStats(ProfileZone::DisplayFrame);
+        snprintf(frameStr, sizeof(frameStr), "p99 %lums",
+                 static_cast<unsigned long>(stats.p99Us / 1000));
+        return frameStr;
+    };
+    profiler.priority = 6;
+    profiler.isSubmenu = false;
+    profiler.isToggle = false;
+    profiler.getToggleState = nullptr;
+    profiler.isReadOnly = false;
+    profiler.customDraw = nullptr;
+    MenuRegistry::registerEntry(profiler);
+
+    // Task stacks and core load (opens the "framework.tasks" screen)
+    MenuEntry tasks;
+    tasks.id = "framework.tasks";
+    tasks.parent = "framework.status";
+    tasks.icon = ICON_INFO;
+    tasks.label = "Tasks";
+    tasks.shortLabel = nullptr;
+    tasks.onSelect = nullptr;
+    tasks.condition = nullptr;
+    tasks.getValue = []() {
+        static char loadStr[16];
+        snprintf(loadStr, sizeof(loadStr), "%u%% / %u%%",
+                 TaskMonitor::getCoreLoad(0), TaskMonitor::getCoreLoad(1));
+        return loadStr;
+    };
+    tasks.priority = 7;
+    tasks.isSubmenu = false;
+    tasks.isToggle = false;
+    tasks.getToggleState = nullptr;
+    tasks.isReadOnly = false;
+    tasks.customDraw = nullptr;
+    MenuRegistry::registerEntry(tasks);
+
+    // Command-to-air latency of the current task profile
+    MenuEntry air;
+    air.id = "framework.status.air";
+    air.parent = "framework.status";
+    air.icon = ICON_SIGNAL_FULL;
+    air.label = "Air Latency";
+    air.shortLabel = "Air";
+    air.onSelect = []() {
+        ILITE.resetRadioLatencyStats();
+    };
+    air.condition = nullptr;
+    air.getValue = []() {
+        static char airStr[24];
+        const RadioLatencyStats& stats = ILITE.getRadioLatencyStats();
+        snprintf(airStr, sizeof(airStr), "%lu/%luus",
+                 static_cast<unsigned long>(stats.avgUs),
+                 static_cast<unsigned long>(stats.maxUs));
+        return airStr;
+    };
+    air.priority = 8;
+    air.isSubmenu = false;
+    air.isToggle = false;
+    air.getToggleState = nullptr;
+    air.isReadOnly = false;
+    air.customDraw = nullptr;
+    MenuRegistry::registerEntry(air);
+
+    // Link quality of the paired peer (opens the "framework.link" screen)
+    MenuEntry link;
+    link.id = "framework.link";
+    link.parent = "framework.status";
+    link.icon = ICON_SIGNAL_FULL;
+    link.label = "Link";
+    link.shortLabel = nullptr;
+    link.onSelect = nullptr;
+    link.condition = nullptr;
+    link.getValue = []() {
+        static char linkStr[24];
+        const LinkPeerStats* stats = LinkMetrics::find(discovery.getPairedMac());
+        if (stats == nullptr) {
+            return "--";
+        }
+        snprintf(linkStr, sizeof(linkStr), "%ddBm %u%%",
+                 stats->rssiSamples ? stats->rssiDbm : 0,
+                 LinkMetrics::txSuccessPercent(*stats));
+        return static_cast<const char*>(linkStr);
+    };
+    link.priority = 9;
+    link.isSubmenu = false;
+    link.isToggle = false;
+    link.getToggleState = nullptr;
+    link.isReadOnly = false;
+    link.customDraw = nullptr;
+    MenuRegistry::registerEntry(link);
+
+    // Decoded telemetry and per-type traffic (opens the "framework.packets" screen)
+    MenuEntry packets;
+    packets.id = "framework.packets";
+    packets.parent = "framework.status";
+    packets.icon = ICON_SIGNAL_FULL;
+    packets.label = "Packets";
+    packets.shortLabel = nullptr;
+    packets.onSelect = nullptr;
+    packets.condition = nullptr;
+    packets.getValue = []() {
+        static char packetStr[16];
+        const TelemetryRate* rate = TelemetryHealth::get(0);
+        if (rate == nullptr || rate->packets == 0) {
+            return "--";
+        }
+        snprintf(packetStr, sizeof(packetStr), "%.0f/s", TelemetryHealth::getRateHz(0));
+        return static_cast<const char*>(packetStr);
+    };
+    packets.priority = 9;
+    packets.isSubmenu = false;
+    packets.isToggle = false;
+    packets.getToggleState = nullptr;
+    packets.isReadOnly = false;
+    packets.customDraw = nullptr;
+    MenuRegistry::registerEntry(packets);
+
+    // TDMA slot occupancy (opens the "framework.slots" screen)
+    MenuEntry slots;
+    slots.id = "framework.slots";
+    slots.parent = "framework.status";
+    slots.icon = ICON_SIGNAL_FULL;
+    slots.label = "Slots";
+    slots.shortLabel = nullptr;
+    slots.onSelect = nullptr;
+    slots.condition = []() { return TdmaSlots::isEnabled(); };
+    slots.getValue = []() {
+        static char slotStr[12];
+        const TdmaSlotStats stats = TdmaSlots::getStats();
+        if (stats.slot == TdmaSlots::kNoSlot) {
+            return "--";
+        }
+        snprintf(slotStr, sizeof(slotStr), "%u/%u", static_cast<unsigned>(stats.slot),
+                 static_cast<unsigned>(TdmaSlots::kSlots));
+        return static_cast<const char*>(slotStr);
+    };
+    slots.priority = 9;
+    slots.isSubmenu = false;
+    slots.isToggle = false;
+    slots.getToggleState = nullptr;
+    slots.isReadOnly = false;
+    slots.customDraw = nullptr;
+    MenuRegistry::registerEntry(slots);
+
+    // Firmware relay to the paired robot (opens the "framework.relay" screen)
+    MenuEntry relay;
+    relay.id = "framework.relay";
+    relay.parent = "framework.status";
+    relay.icon = ICON_SETTINGS;
+    relay.label = "Robot Firmware";
+    relay.shortLabel = "Relay";
+    relay.onSelect = nullptr;
+    relay.condition = nullptr;
+    relay.getValue = []() {
+        static char relayStr[8];
+        const FirmwareRelayStats stats = FirmwareRelay::getStats();
+        if (!FirmwareRelay::isActive() || stats.chunkCount == 0) {
+            return "--";
+        }
+        snprintf(relayStr, sizeof(relayStr), "%u%%",
+                 static_cast<unsigned>(stats.acknowledged * 100u / stats.chunkCount));
+        return static_cast<const char*>(relayStr);
+    };
+    relay.priority = 9;
+    relay.isSubmenu = false;
+    relay.isToggle = false;
+    relay.getToggleState = nullptr;
+    relay.isReadOnly = false;
+    relay.customDraw = nullptr;
+    MenuRegistry::registerEntry(relay);
+
+    // Input-to-echo latency of stamped commands (select to reset)
+    MenuEntry e2e;
+    e2e.id = "framework.status.e2e";
+    e2e.parent = "framework.status";
+    e2e.icon = ICON_SIGNAL_FULL;
+    e2e.label = "Cmd Latency";
+    e2e.shortLabel = "E2E";
+    e2e.onSelect = []() {
+        CommandLatency::reset();
+    };
+    e2e.condition = []() {
+        return ILITE.getConfig().commandStamps;
+    };
+    e2e.getValue = []() {
+        static char e2eStr[24];
+        const CommandLatencyStats& stats = CommandLatency::getStats();
+        if (stats.echoes == 0) {
+            return "--";
+        }
+        snprintf(e2eStr, sizeof(e2eStr), "%lu/%lums",
+                 static_cast<unsigned long>(stats.avgUs / 1000),
+                 static_cast<unsigned long>(stats.maxUs / 1000));
+        return static_cast<const char*>(e2eStr);
+    };
+    e2e.priority = 10;
+    e2e.isSubmenu = false;
+    e2e.isToggle = false;
+    e2e.getToggleState = nullptr;
+    e2e.isReadOnly = false;
+    e2e.customDraw = nullptr;
+    MenuRegistry::registerEntry(e2e);
+
     // Network submenu entries (SSID / Password)
     MenuEntry wifiSSID;
     wifiSSID.id = "framework.network.ssid";
@@ -327,6 +610,28 @@ void FrameworkEngine::registerDefaultMenuEntries() {
     };
     MenuRegistry::registerEntry(wifiPassword);
 
+    // OTA maintenance mode (parks control and display, starts the AP)
+    MenuEntry otaMode;
+    otaMode.id = "framework.network.ota";
+    otaMode.parent = MENU_NETWORK;
+    otaMode.icon = ICON_SIGNAL_FULL;
+    otaMode.label = "OTA Update Mode";
+    otaMode.shortLabel = "OTA";
+    otaMode.onSelect = []() {
+        ILITE.requestMaintenanceMode(true);
+    };
+    otaMode.condition = []() {
+        return ILITE.getConfig().enableOTA;
+    };
+    otaMode.getValue = nullptr;
+    otaMode.priority = 10;
+    otaMode.isSubmenu = false;
+    otaMode.isToggle = false;
+    otaMode.getToggleState = nullptr;
+    otaMode.isReadOnly = false;
+    otaMode.customDraw = nullptr;
+    MenuRegistry::registerEntry(otaMode);
+
     // Deactivate Module entry (under Modules submenu)
     MenuEntry deactivateModule;
     deactivateModule.id = "framework.modules.deactivate";
@@ -334,15 +639,15 @@ void FrameworkEngine::registerDefaultMenuEntries() {
     deactivateModule.icon = ICON_STOP;
     deactivateModule.label = "Deactivate Module";
     deactivateModule.shortLabel = nullptr;
-    deactivateModule.onSelect = [this]() {
-        if (currentModule_) {
+    deactivateModule.onSelect = []() {
+        if (ModuleHandoff::current()) {
             Serial.println("[FrameworkEngine] Deactivating current module");
-            loadModule(nullptr);  // Unload current module
+            ILITE.requestModuleActivation(nullptr);  // Unloaded on ServiceTask
             AudioRegistry::play("unpaired");
         }
     };
-    deactivateModule.condition = [this]() {
-        return currentModule_ != nullptr;  // Only show if module is loaded
+    deactivateModule.condition = []() {
+        return ModuleHandoff::current() != nullptr;  // Only show if module is loaded
     };
     deactivateModule.getValue = nullptr;
     deactivateModule.priority = 0;  // Show at top of Modules submenu
@@ -359,6 +664,15 @@ void FrameworkEngine::registerDefaultMenuEntries() {
 void FrameworkEngine::begin() {
     Serial.println("[FrameworkEngine] begin() called");
     buttonEngine_.begin();
+#if ILITE_LATENCY_PINS
+    // The LED pin may carry a latency marker (LatencyPins.h)
+    if (LatencyPins::usesPin(LED_PIN)) {
+        Serial.println("[FrameworkEngine] Status LED off: GPIO is a latency marker");
+    } else
+#endif
+    if (!StatusLed::begin(LED_PIN)) {
+        Serial.println("[FrameworkEngine] Status LED without LEDC, switching digitally");
+    }
     Serial.println("[FrameworkEngine] ButtonEventEngine initialized");
 
     // Register default menu entries
@@ -390,25 +704,30 @@ void FrameworkEngine::begin() {
 void FrameworkEngine::update() {
     // Update button state machines
     buttonEngine_.update();
+    for (uint8_t i = 0; i < ButtonEventEngine::BUTTON_COUNT; i++) {
+        if (buttonEngine_.getLastEvent(i) != ButtonEvent::NONE) {
+            RenderScheduler::invalidate(RenderReason::Input);
+            break;
+        }
+    }
 
     if (ScreenRegistry::hasActiveScreen()) {
         ScreenRegistry::updateActiveScreen();
     }
 
     // Handle encoder rotation for strip navigation
-    if (encoderCount != 0) {
-        onEncoderRotate(encoderCount);
-        encoderCount = 0; // Reset encoder count after handling
+    const EncoderDelta encoder = EncoderSampler::getInstance().readAccelerated(encoderCursor_);
+    if (encoder.steps != 0) {
+        onEncoderRotate(encoder.steps, encoder.accelerated);
+        RenderScheduler::invalidate(RenderReason::Input);
     }
 
-    // Update status animation frame
-    statusAnimFrame_++;
+    uint32_t now = millis();
+    serviceLiveEdit(now);
 
-    // Update battery reading (every ~1 second at 50Hz)
-    static uint8_t batteryUpdateCounter = 0;
-    if (++batteryUpdateCounter >= 50) {
-        batteryUpdateCounter = 0;
-        batteryPercent_ = InputManager::getInstance().getBatteryPercent();
+    // Battery estimate: fed every tick, published once per second
+    if (BatteryMonitor::sample(InputManager::getInstance().getBatteryRaw(), isPaired_, now)) {
+        batteryPercent_ = BatteryMonitor::getPercent();
     }
 
     // Update current module if loaded and paired
@@ -422,107 +741,69 @@ void FrameworkEngine::update() {
 }
 
 void FrameworkEngine::updateStatusLED() {
-    uint32_t now = millis();
-
-    // Determine current system status
-    FrameworkStatus status = FrameworkStatus::IDLE;
-
-    if (isPaired_) {
-        status = FrameworkStatus::PAIRED;
+    // Blink timing runs on StatusLed's timer; this only picks the pattern
+    LedPattern pattern = LedPattern::Off;
+    if (status_ == FrameworkStatus::ERROR_COMM || status_ == FrameworkStatus::ERROR_MODULE) {
+        pattern = LedPattern::Error;
+    } else if (BatteryMonitor::isValid() && batteryPercent_ <= LOW_BATTERY_PERCENT) {
+        pattern = LedPattern::LowBattery;
+    } else if (isPaired_) {
+        pattern = LedPattern::Paired;
+    } else if (status_ == FrameworkStatus::PAIRING) {
+        pattern = LedPattern::Pairing;
     } else if (currentModule_ != nullptr) {
-        status = FrameworkStatus::SCANNING;  // Module loaded, searching for device
+        pattern = LedPattern::Scanning;     // Module loaded, searching for its device
     }
+    StatusLed::setPattern(pattern);
+}
 
-    // LED blink patterns based on status
-    // IDLE: Off
-    // SCANNING: Fast blink (200ms on, 200ms off)
-    // PAIRING: Very fast blink (100ms on, 100ms off)
-    // PAIRED: Solid on
-    // ERROR: SOS pattern (3 short, 3 long, 3 short)
-
-    bool newLedState = ledState_;
+// ============================================================================
+// Rendering
+// ============================================================================
 
-    switch (status) {
-        case FrameworkStatus::IDLE:
-            // LED off when idle
-            newLedState = false;
-            break;
+void FrameworkEngine::render(DisplayCanvas& canvas) {
+    // A retained dashboard that was on screen last frame keeps its pixels;
+    // only the strip is redrawn in full. A page buffer keeps no pixels.
+    WidgetScreen* widgets = activeWidgetScreen();
+    const bool incremental = widgets != nullptr && widgets == retainedScreen_ &&
+                             !canvas.isPageMode();
 
-        case FrameworkStatus::SCANNING:
-            // Fast blink: 200ms cycle
-            if (now - ledLastUpdateMs_ >= 200) {
-                newLedState = !ledState_;
-                ledLastUpdateMs_ = now;
-            }
-            break;
+    // Status animations run on the frame clock (20 ms steps), not on update() calls
+    statusAnimFrame_ = Animator::getFrameMs() / 20;
 
-        case FrameworkStatus::PAIRING:
-            // Very fast blink: 100ms cycle
-            if (now - ledLastUpdateMs_ >= 100) {
-                newLedState = !ledState_;
-                ledLastUpdateMs_ = now;
-            }
-            break;
+    {
+        ILITE_PROFILE(ProfileZone::Render);
 
-        case FrameworkStatus::PAIRED: {
-            // Solid on, with subtle heartbeat
-            // Quick double pulse every 2 seconds
-            uint32_t cycleTime = now % 2000;
-            if (cycleTime < 50 || (cycleTime >= 100 && cycleTime < 150)) {
-                newLedState = false;  // Brief off pulses
-            } else {
-                newLedState = true;   // Mostly on
-            }
-            break;
+        if (incremental) {
+            canvas.setDrawColor(0);
+            canvas.drawRect(0, 0, 128, STRIP_HEIGHT, true);
+            canvas.setDrawColor(1);
+        } else {
+            canvas.clear();
         }
 
-        case FrameworkStatus::ERROR_COMM:
-        case FrameworkStatus::ERROR_MODULE: {
-            // SOS pattern: ... --- ... (dot=100ms, dash=300ms, gap=100ms)
-            // Total cycle: 3*100 + 3*100 + 3*300 + 3*100 + 3*100 + 3*100 = 1800ms
-            uint32_t sosTime = now % 2000;
-
-            // 3 short dots
-            if (sosTime < 100 || (sosTime >= 200 && sosTime < 300) || (sosTime >= 400 && sosTime < 500)) {
-                newLedState = true;
-            }
-            // 3 long dashes
-            else if ((sosTime >= 600 && sosTime < 900) || (sosTime >= 1000 && sosTime < 1300) || (sosTime >= 1400 && sosTime < 1700)) {
-                newLedState = true;
-            }
-            // 3 short dots again
-            else if ((sosTime >= 1800 && sosTime < 1900)) {
-                newLedState = true;
-            }
-            else {
-                newLedState = false;
-            }
-            break;
+        // Render top strip (always framework-owned)
+        renderTopStrip(canvas);
+
+        // Render dashboard area
+        dashboardSkipped_ = false;
+        if (widgets != nullptr) {
+            widgets->render(canvas, !incremental);
+        } else {
+            renderDashboard(canvas);
         }
+        retainedScreen_ = widgets;
     }
 
-    // Update LED if state changed
-    if (newLedState != ledState_) {
-        ledState_ = newLedState;
-        digitalWrite(LED_PIN, ledState_ ? HIGH : LOW);
+    // DisplayTask's nextPage() sends the frame. A throttled module
+    // dashboard leaves the last frame on the panel.
+    if (dashboardSkipped_) {
+        canvas.keepLastFrame();
     }
 }
 
-// ============================================================================
-// Rendering
-// ============================================================================
-
-void FrameworkEngine::render(DisplayCanvas& canvas) {
-    canvas.clear();
-
-    // Render top strip (always framework-owned)
-    renderTopStrip(canvas);
-
-    // Render dashboard area
-    renderDashboard(canvas);
-
-    // Framework sends buffer (only one place does this)
-    canvas.sendBuffer();
+void FrameworkEngine::invalidateDashboard() {
+    retainedScreen_ = nullptr;
 }
 
 void FrameworkEngine::renderTopStrip(DisplayCanvas& canvas) {
@@ -538,7 +819,7 @@ void FrameworkEngine::renderTopStrip(DisplayCanvas& canvas) {
 
     // Left side: Show strip buttons based on context
     // Only show buttons when NOT in menu or screens
-    bool inModuleDashboard = currentModule_ && !menuOpen_ && !DefaultActions::hasActiveScreen();
+    bool inModuleDashboard = liveModule() && !menuOpen_ && !DefaultActions::hasActiveScreen();
     bool showButtons = !menuOpen_ && !DefaultActions::hasActiveScreen();
 
     if (showButtons) {
@@ -601,7 +882,7 @@ void FrameworkEngine::renderTopStrip(DisplayCanvas& canvas) {
         canvas.setFont(DisplayCanvas::SMALL);
         // Show current menu page title if in submenu, otherwise just "MENU"
         if (!menuStack_.empty()) {
-            const MenuEntry* currentEntry = MenuRegistry::findEntry(menuStack_.back());
+            const MenuEntry* currentEntry = MenuRegistry::getEntry(menuStack_.back());
             if (currentEntry && currentEntry->label) {
                 canvas.drawText(leftBoundary + 4, stripY + 8, currentEntry->label);
                 leftBoundary += strlen(currentEntry->label) * 5 + 8;
@@ -673,13 +954,18 @@ void FrameworkEngine::renderTopStrip(DisplayCanvas& canvas) {
             statusIcon = "\u0046";  // Circle/dot icon: char 70 (F)
             break;
     }
+    // Control tick overrunning: flash the warning icon over the status
+    if (ControlDeadline::isDegraded() && (statusAnimFrame_ / 10) % 2) {
+        statusIcon = "\u0078";
+    }
     canvas.setFont(DisplayCanvas::ICON_SMALL);
     canvas.drawText(battBarX - 10, stripY + 7, statusIcon);
     canvas.setFont(DisplayCanvas::TINY);
 
     // Module name (if loaded and not in menu/screens mode)
-    if (currentModule_ && !menuOpen_ && !DefaultActions::hasActiveScreen()) {
-        const char* moduleName = currentModule_->getModuleName();
+    ILITEModule* module = liveModule();
+    if (module && !menuOpen_ && !DefaultActions::hasActiveScreen()) {
+        const char* moduleName = module->getModuleName();
         uint8_t nameWidth = strlen(moduleName) * 4;
         uint8_t maxNameX = battBarX - 12;  // Position before status icon
 
@@ -711,8 +997,14 @@ void FrameworkEngine::renderDashboard(DisplayCanvas& canvas) {
 
     // If a module is loaded (selected), show its dashboard
     // The module can handle rendering "waiting to pair..." if needed
-    if (currentModule_) {
-        currentModule_->drawDashboard(canvas);
+    if (ILITEModule* module = liveModule()) {
+        ILITE_PROFILE(ProfileZone::ModuleDraw);
+        ModuleCall call(module, ModuleCallback::Draw);
+        if (call.allowed()) {
+            module->drawDashboard(canvas);
+        } else {
+            dashboardSkipped_ = true;
+        }
         return;
     }
 
@@ -720,29 +1012,29 @@ void FrameworkEngine::renderDashboard(DisplayCanvas& canvas) {
     renderGenericDashboard(canvas);
 }
 
+ILITEModule* FrameworkEngine::liveModule() {
+    return ModuleHandoff::current();
+}
+
+WidgetScreen* FrameworkEngine::activeWidgetScreen() {
+    if (menuOpen_ || DefaultActions::hasActiveScreen() || ScreenRegistry::hasActiveScreen()) {
+        return nullptr;
+    }
+    if (ILITEModule* module = liveModule()) {
+        return module->getDashboardWidgets();
+    }
+    return &genericScreen_;
+}
+
 void FrameworkEngine::renderGenericDashboard(DisplayCanvas& canvas) {
     // Generic dashboard showing framework status (centered text)
+    genericScreen_.render(canvas, true);
+}
 
-    // Title - centered
-    canvas.setFont(DisplayCanvas::NORMAL);
-    const char* title = "ILITE v2.0";
-    int16_t titleWidth = canvas.getTextWidth(title);
-    canvas.drawText((128 - titleWidth) / 2, DASHBOARD_Y + 12, title);
-
-    // Module count - centered
-    size_t moduleCount = ModuleRegistry::getModuleCount();
-    char countStr[32];
-    snprintf(countStr, sizeof(countStr), "Modules: %d", moduleCount);
-    canvas.setFont(DisplayCanvas::SMALL);
-    int16_t countWidth = canvas.getTextWidth(countStr);
-    canvas.drawText((128 - countWidth) / 2, DASHBOARD_Y + 26, countStr);
-
-    // Status - centered
-    const char* statusStr = "";
+const char* FrameworkEngine::genericStatusText() {
     switch (status_) {
         case FrameworkStatus::IDLE:
-            statusStr = "Status: Idle";
-            break;
+            return "Status: Idle";
         case FrameworkStatus::SCANNING:
             // Animated scanning indicator
             {
@@ -752,30 +1044,18 @@ void FrameworkEngine::renderGenericDashboard(DisplayCanvas& canvas) {
                     scanStr[16 + i] = (i < dots) ? '.' : ' ';
                 }
                 scanStr[19] = '\0';
-                statusStr = scanStr;
+                return scanStr;
             }
-            break;
         case FrameworkStatus::PAIRING:
-            statusStr = "Status: Pairing...";
-            break;
+            return "Status: Pairing...";
         case FrameworkStatus::PAIRED:
-            statusStr = "Status: Paired";
-            break;
+            return "Status: Paired";
         case FrameworkStatus::ERROR_COMM:
-            statusStr = "ERROR: Comm Fail";
-            break;
+            return "ERROR: Comm Fail";
         case FrameworkStatus::ERROR_MODULE:
-            statusStr = "ERROR: Module Fail";
-            break;
+            return "ERROR: Module Fail";
     }
-    int16_t statusWidth = canvas.getTextWidth(statusStr);
-    canvas.drawText((128 - statusWidth) / 2, DASHBOARD_Y + 38, statusStr);
-
-    // Help text - centered
-    canvas.setFont(DisplayCanvas::TINY);
-    const char* helpText = "Press encoder for menu";
-    int16_t helpWidth = canvas.getTextWidth(helpText);
-    canvas.drawText((128 - helpWidth) / 2, DASHBOARD_Y + 50, helpText);
+    return "";
 }
 
 // ============================================================================
@@ -786,7 +1066,9 @@ void FrameworkEngine::renderMenu(DisplayCanvas& canvas) {
     const int16_t startY = DASHBOARD_Y;
     const MenuID activeMenu = currentMenuId();
 
-    auto entries = MenuRegistry::getVisibleEntries(activeMenu);
+    // Conditions are re-evaluated once per frame; navigation reuses this list
+    MenuRegistry::invalidateVisibility();
+    const MenuList entries = MenuRegistry::getVisibleEntries(activeMenu);
     if (entries.empty()) {
         canvas.setFont(DisplayCanvas::SMALL);
         canvas.drawText(2, startY + 12, "No entries available");
@@ -814,20 +1096,33 @@ void FrameworkEngine::renderMenu(DisplayCanvas& canvas) {
         menuScrollOffset_ = menuSelection_ - maxVisibleItems + 1;
     }
 
+    // Scroll and selection slide to their rows; entering another menu jumps
+    if (activeMenu != menuAnimMenu_) {
+        menuAnimMenu_ = activeMenu;
+        menuScrollTween_.snap(menuScrollOffset_ * itemHeight);
+        menuCursorTween_.snap(menuSelection_ * itemHeight);
+    } else {
+        menuScrollTween_.retarget(menuScrollOffset_ * itemHeight);
+        menuCursorTween_.retarget(menuSelection_ * itemHeight);
+    }
+    const int scrollPx = menuScrollTween_.value();
+    const int cursorPx = menuCursorTween_.value();
+
+    // Rows partly scrolled out are clipped to the dashboard
+    canvas.setClipRect(0, startY, canvas.getWidth(), availableHeight);
+    canvas.drawRect(0, startY + cursorPx - scrollPx, canvas.getWidth(), 11, false);
+
     // Render visible entries
-    int16_t y = startY + 6;
-    const int endIndex = std::min(menuScrollOffset_ + maxVisibleItems, entryCount);
-    for (int i = menuScrollOffset_; i < endIndex; ++i) {
+    const int firstIndex = scrollPx / itemHeight;
+    int16_t y = startY + 6 + firstIndex * itemHeight - scrollPx;
+    const int endIndex = std::min(firstIndex + maxVisibleItems + 1, entryCount);
+    for (int i = firstIndex; i < endIndex; ++i) {
         const MenuEntry* entry = entries[i];
         if (!entry) {
+            y += itemHeight;
             continue;
         }
 
-        const bool selected = (i == menuSelection_);
-        if (selected) {
-            canvas.drawRect(0, y - 6, canvas.getWidth(), 11, false);
-        }
-
         int16_t textX = 4;
         if (entry->icon != nullptr) {
             canvas.drawIconByID(4, y - 8, entry->icon);
@@ -882,18 +1177,19 @@ void FrameworkEngine::renderMenu(DisplayCanvas& canvas) {
                 const char* value = entry->getValue();
                 if (value != nullptr) {
                     canvas.drawTextRight(canvas.getWidth() - 4, y, value);
+                    // Edit not yet confirmed by the robot
+                    if (entry->isPending && entry->isPending()) {
+                        canvas.drawTextRight(canvas.getWidth() - 6 - canvas.getTextWidth(value), y, "*");
+                    }
                 }
             }
         } else if (MenuRegistry::hasChildren(entry->id) || entry->isSubmenu) {
             canvas.drawTextRight(canvas.getWidth() - 4, y, ">");
         }
 
-        if (selected) {
-            canvas.setDrawColor(1);
-        }
-
         y += itemHeight;
     }
+    canvas.clearClipRect();
 
     // Draw scroll indicators
     if (entryCount > maxVisibleItems) {
@@ -902,7 +1198,7 @@ void FrameworkEngine::renderMenu(DisplayCanvas& canvas) {
         const int scrollbarY = startY + 6;
 
         // Scroll indicator position
-        const float scrollPercent = static_cast<float>(menuScrollOffset_) / (entryCount - maxVisibleItems);
+        const float scrollPercent = static_cast<float>(scrollPx) / ((entryCount - maxVisibleItems) * itemHeight);
         const int indicatorY = scrollbarY + static_cast<int>(scrollPercent * (scrollbarHeight - 4));
 
         // Draw small scroll indicator
@@ -911,7 +1207,7 @@ void FrameworkEngine::renderMenu(DisplayCanvas& canvas) {
 }
 
 void FrameworkEngine::navigateMenu(int delta) {
-    auto entries = MenuRegistry::getVisibleEntries(currentMenuId());
+    const MenuList entries = MenuRegistry::getVisibleEntries(currentMenuId());
     if (entries.empty()) {
         menuSelection_ = 0;
         return;
@@ -927,7 +1223,7 @@ void FrameworkEngine::navigateMenu(int delta) {
 }
 
 void FrameworkEngine::activateMenuSelection() {
-    auto entries = MenuRegistry::getVisibleEntries(currentMenuId());
+    const MenuList entries = MenuRegistry::getVisibleEntries(currentMenuId());
     if (entries.empty()) {
         AudioRegistry::play("error");
         return;
@@ -964,7 +1260,8 @@ void FrameworkEngine::activateMenuSelection() {
     }
 
     // Screens - open and close menu
-    if (ScreenRegistry::hasScreen(entry->id) && ScreenRegistry::show(entry->id)) {
+    const ScreenHandle screen = ScreenRegistry::find(entry->id);
+    if (screen != ScreenRegistry::kNoScreen && ScreenRegistry::show(screen)) {
         AudioRegistry::play("paired");
         closeMenu();
         return;
@@ -994,11 +1291,13 @@ void FrameworkEngine::activateMenuSelection() {
         // Store initial value
         if (entry->isEditableInt) {
             editValueInt_ = entry->getIntValue();
+            editStartInt_ = editValueInt_;
         } else {
             editValueFloat_ = entry->getFloatValue();
+            editStartFloat_ = editValueFloat_;
         }
+        editDirty_ = false;
 
-        lastEncoderRotateMs_ = millis();
         cursorBlinkTimer_ = millis();
         AudioRegistry::play("edit_start");
         return;
@@ -1030,6 +1329,13 @@ void FrameworkEngine::activateMenuSelection() {
 void FrameworkEngine::menuGoBack() {
     // Cancel edit mode if active
     if (menuEditMode_) {
+        // A live edit already reached the setter; put the start value back
+        if (editingEntry_ != nullptr && editingEntry_->liveEdit) {
+            editValueInt_ = editStartInt_;
+            editValueFloat_ = editStartFloat_;
+            applyEditValue();
+        }
+        editDirty_ = false;
         menuEditMode_ = false;
         editingEntry_ = nullptr;
         AudioRegistry::play("edit_cancel");
@@ -1059,6 +1365,8 @@ MenuID FrameworkEngine::currentMenuId() const {
 // ============================================================================
 
 void FrameworkEngine::loadModule(ILITEModule* module) {
+    ModuleArena::dumpHeap(Serial, "before module switch");
+
     // Clear module menu entries from previous module
     clearModuleMenuEntries();
     ControlBindingSystem::clearModuleBindings();
@@ -1072,6 +1380,10 @@ void FrameworkEngine::loadModule(ILITEModule* module) {
 
     // Activate new module (it will register its own encoder functions)
     if (currentModule_) {
+        // Working state is reserved per activation; the previous module's
+        // block went with the arena reset above
+        ModuleArena::reserveState(currentModule_->getStateSize());
+
         ControlBindingSystem::beginModuleCapture();
         currentModule_->onActivate();
         ControlBindingSystem::endModuleCapture();
@@ -1080,12 +1392,40 @@ void FrameworkEngine::loadModule(ILITEModule* module) {
         registerModuleMenuEntries();
     }
 
+    updateStripButtons();
+    ModuleArena::dumpHeap(Serial, "after module switch");
+}
+
+void FrameworkEngine::swapStandbyModule() {
+    // Park the loaded module's entries; the registry drops them, the copies keep them
+    leaveModuleSubmenus();
+    parkedEntries_.clear();
+    MenuRegistry::takeEntries(moduleMenuIds_.data(), moduleMenuIds_.size(), parkedEntries_);
+
+    // Bring the standby module's entries back in their original order
+    MenuRegistry::registerEntries(standby_.menuEntries.data(), standby_.menuEntries.size());
+    standby_.menuEntries.swap(parkedEntries_);
+    parkedEntries_.clear();
+
+    moduleMenuRoot_.children.swap(standby_.menuItems);
+    moduleMenuIds_.swap(standby_.menuIds);
+    for (size_t slot = 0; slot < 2; ++slot) {
+        std::swap(encoderFunctions_[slot], standby_.encoderFunctions[slot]);
+        std::swap(hasEncoderFunction_[slot], standby_.hasEncoderFunction[slot]);
+    }
+    std::swap(currentModule_, standby_.module);
+    ModuleArena::swapBanks();
+    ControlBindingSystem::swapModuleBindings();
+
     updateStripButtons();
 }
 
 void FrameworkEngine::setPaired(bool paired) {
     bool wasPaired = isPaired_;
     isPaired_ = paired;
+    if (paired != wasPaired) {
+        RenderScheduler::invalidate(RenderReason::Input);
+    }
 
     if (paired && !wasPaired) {
         // Just paired
@@ -1142,10 +1482,10 @@ void FrameworkEngine::routeButtonEvent(uint8_t buttonIndex, ButtonEvent event) {
         return;
     }
 
-    if (currentModule_) {
+    if (ILITEModule* module = liveModule()) {
         // Route to active module regardless of pairing so developers can test bindings offline
         if (event == ButtonEvent::PRESSED) {
-            currentModule_->onFunctionButton(buttonIndex);
+            module->onFunctionButton(buttonIndex);
         }
         return;
     }
@@ -1195,7 +1535,7 @@ void FrameworkEngine::updateStripButtons() {
     }
 }
 
-void FrameworkEngine::onEncoderRotate(int delta) {
+void FrameworkEngine::onEncoderRotate(int delta, int accelerated) {
     if (delta == 0) {
         return;
     }
@@ -1203,18 +1543,20 @@ void FrameworkEngine::onEncoderRotate(int delta) {
     // Handle value editing mode (highest priority)
     if (menuOpen_ && menuEditMode_ && editingEntry_ != nullptr) {
         uint32_t now = millis();
-        uint32_t timeSinceLastRotate = now - lastEncoderRotateMs_;
-        lastEncoderRotateMs_ = now;
 
-        // Speed-based coarse/fine adjustment
-        // Fast rotation (< 50ms between ticks) = coarse step
-        // Slow rotation (>= 50ms) = fine step
-        bool isFastRotation = (timeSinceLastRotate < 50);
+        // Velocity acceleration: `accelerated` weighs each detent 1x..10x by
+        // spin speed; coarseStep caps the change per detent
+        float change = editingEntry_->step * accelerated;
+        const float limit = editingEntry_->coarseStep * abs(delta);
+        if (change > limit) {
+            change = limit;
+        } else if (change < -limit) {
+            change = -limit;
+        }
 
         if (editingEntry_->isEditableInt) {
             // Integer value editing
-            float stepSize = isFastRotation ? editingEntry_->coarseStep : editingEntry_->step;
-            editValueInt_ += static_cast<int>(stepSize * delta);
+            editValueInt_ += static_cast<int>(change);
 
             // Clamp to min/max
             if (editValueInt_ < editingEntry_->minValue) {
@@ -1225,12 +1567,11 @@ void FrameworkEngine::onEncoderRotate(int delta) {
             }
 
             AudioRegistry::play("edit_adjust");
-            Serial.printf("[Edit] Int value: %d (step: %.1f)\n", editValueInt_, stepSize);
+            Serial.printf("[Edit] Int value: %d (change: %.1f)\n", editValueInt_, change);
 
         } else if (editingEntry_->isEditableFloat) {
             // Float value editing
-            float stepSize = isFastRotation ? editingEntry_->coarseStep : editingEntry_->step;
-            editValueFloat_ += stepSize * delta;
+            editValueFloat_ += change;
 
             // Clamp to min/max
             if (editValueFloat_ < editingEntry_->minValueFloat) {
@@ -1241,9 +1582,13 @@ void FrameworkEngine::onEncoderRotate(int delta) {
             }
 
             AudioRegistry::play("edit_adjust");
-            Serial.printf("[Edit] Float value: %.2f (step: %.2f)\n", editValueFloat_, stepSize);
+            Serial.printf("[Edit] Float value: %.2f (change: %.2f)\n", editValueFloat_, change);
         }
 
+        if (editingEntry_->liveEdit && !editDirty_) {
+            editDirty_ = true;
+            editDirtyMs_ = now;
+        }
         return;
     }
 
@@ -1285,16 +1630,16 @@ void FrameworkEngine::onEncoderRotate(int delta) {
 void FrameworkEngine::onEncoderPress() {
     // Handle value editing mode - save and exit
     if (menuOpen_ && menuEditMode_ && editingEntry_ != nullptr) {
-        // Save the edited value
-        if (editingEntry_->isEditableInt && editingEntry_->setIntValue) {
-            editingEntry_->setIntValue(editValueInt_);
+        // Save the edited value (a live edit gets its final value here too)
+        applyEditValue();
+        if (editingEntry_->isEditableInt) {
             Serial.printf("[Edit] Saved int value: %d\n", editValueInt_);
-        } else if (editingEntry_->isEditableFloat && editingEntry_->setFloatValue) {
-            editingEntry_->setFloatValue(editValueFloat_);
+        } else {
             Serial.printf("[Edit] Saved float value: %.2f\n", editValueFloat_);
         }
 
         // Exit edit mode
+        editDirty_ = false;
         menuEditMode_ = false;
         editingEntry_ = nullptr;
         AudioRegistry::play("edit_save");
@@ -1317,7 +1662,7 @@ void FrameworkEngine::onEncoderPress() {
         return;
     }
 
-    bool inDashboard = (currentModule_ != nullptr && isPaired_);
+    bool inDashboard = (liveModule() != nullptr && isPaired_);
 
     // Audio feedback for encoder press
     AudioRegistry::play("paired");
@@ -1422,16 +1767,32 @@ void FrameworkEngine::registerModuleMenuEntries() {
 
 void FrameworkEngine::clearModuleMenuEntries() {
     // Remove all module menu entries from MenuRegistry
-    for (const std::string& id : moduleMenuIds_) {
-        MenuRegistry::removeEntry(id.c_str());
+    for (MenuID id : moduleMenuIds_) {
+        MenuRegistry::removeEntry(id);
     }
 
     Serial.printf("[FrameworkEngine] Cleared %d module menu entries\n",
                   moduleMenuIds_.size());
 
+    // Leave any module submenu before its IDs are released
+    leaveModuleSubmenus();
+
+    // Capacity is kept, so later modules reuse the same blocks
     moduleMenuIds_.clear();
     moduleMenuBuilder_.clear();
     moduleMenuRoot_.children.clear();
+    ModuleArena::reset();
+}
+
+void FrameworkEngine::leaveModuleSubmenus() {
+    for (size_t i = 0; i < menuStack_.size(); ++i) {
+        if (ModuleArena::owns(menuStack_[i])) {
+            menuStack_.resize(i);
+            menuSelection_ = 0;
+            menuScrollOffset_ = 0;
+            break;
+        }
+    }
 }
 
 void FrameworkEngine::convertModuleMenuItems(const ModuleMenuItem& parent, MenuID parentMenuId) {
@@ -1440,65 +1801,87 @@ void FrameworkEngine::convertModuleMenuItems(const ModuleMenuItem& parent, MenuI
         // Create MenuEntry from ModuleMenuItem
         MenuEntry entry;
 
-        // Allocate persistent strings for ID and label
-        std::string* persistentId = new std::string(item.id);
-        std::string* persistentLabel = new std::string(item.label);
+        // ID and label live in the module arena until the module is unloaded
+        const char* id = ModuleArena::copyString(item.id.c_str());
+        const char* label = ModuleArena::copyString(item.label.c_str());
+        if (id == nullptr || label == nullptr) {
+            Serial.printf("[FrameworkEngine] WARNING: Module arena full, skipping '%s'\n",
+                          item.id.c_str());
+            continue;
+        }
+
+        // The item stays in moduleMenuRoot_ as long as the entry exists, so
+        // callbacks forward through one pointer (fits std::function's local
+        // storage) instead of copying each callable onto the heap
+        const ModuleMenuItem* source = &item;
 
-        entry.id = persistentId->c_str();
+        entry.id = id;
         entry.parent = parentMenuId;
         entry.icon = item.icon;
-        entry.label = persistentLabel->c_str();
+        entry.label = label;
         entry.shortLabel = nullptr;
         entry.priority = item.priority;
         entry.isReadOnly = false;
 
         // Track this ID for cleanup
-        moduleMenuIds_.push_back(item.id);
+        moduleMenuIds_.push_back(id);
+
+        if (item.onSelect) {
+            entry.onSelect = [source]() { source->onSelect(); };
+        }
+        if (item.value) {
+            entry.getValue = [source]() { return source->value(); };
+        }
 
         // Convert item type
         switch (item.type) {
             case ModuleMenuItem::Type::Action:
                 entry.isSubmenu = false;
                 entry.isToggle = false;
-                entry.onSelect = item.onSelect;
-                entry.getValue = item.value;
                 break;
 
             case ModuleMenuItem::Type::Toggle:
                 entry.isSubmenu = false;
                 entry.isToggle = true;
-                entry.onSelect = item.onSelect;
-                entry.getToggleState = item.toggleState;
-                entry.getValue = item.value;
+                if (item.toggleState) {
+                    entry.getToggleState = [source]() { return source->toggleState(); };
+                }
                 break;
 
             case ModuleMenuItem::Type::Submenu:
                 entry.isSubmenu = true;
                 entry.isToggle = false;
                 entry.onSelect = nullptr;
+                entry.getValue = nullptr;
                 break;
 
             case ModuleMenuItem::Type::Screen:
                 entry.isSubmenu = false;
                 entry.isToggle = false;
-                entry.onSelect = item.onSelect;
-                entry.getValue = item.value;
                 break;
 
             case ModuleMenuItem::Type::EditableInt:
                 entry.isSubmenu = false;
                 entry.isToggle = false;
                 entry.isEditableInt = true;
-                entry.getIntValue = item.getIntValue;
-                entry.setIntValue = item.setIntValue;
+                if (item.getIntValue) {
+                    entry.getIntValue = [source]() { return source->getIntValue(); };
+                }
+                if (item.setIntValue) {
+                    entry.setIntValue = [source](int value) { source->setIntValue(value); };
+                }
                 entry.minValue = item.minValue;
                 entry.maxValue = item.maxValue;
                 entry.step = item.step;
                 entry.coarseStep = item.coarseStep;
+                entry.liveEdit = item.liveEdit;
+                if (item.isPending) {
+                    entry.isPending = [source]() { return source->isPending(); };
+                }
                 // Auto-generate getValue function to display current value
-                entry.getValue = [item]() -> const char* {
+                entry.getValue = [source]() -> const char* {
                     static char buffer[32];
-                    snprintf(buffer, sizeof(buffer), "%d", item.getIntValue());
+                    snprintf(buffer, sizeof(buffer), "%d", source->getIntValue());
                     return buffer;
                 };
                 break;
@@ -1507,16 +1890,24 @@ void FrameworkEngine::convertModuleMenuItems(const ModuleMenuItem& parent, MenuI
             entry.isSubmenu = false;
             entry.isToggle = false;
             entry.isEditableFloat = true;
-            entry.getFloatValue = item.getFloatValue;
-            entry.setFloatValue = item.setFloatValue;
+            if (item.getFloatValue) {
+                entry.getFloatValue = [source]() { return source->getFloatValue(); };
+            }
+            if (item.setFloatValue) {
+                entry.setFloatValue = [source](float value) { source->setFloatValue(value); };
+            }
             entry.minValueFloat = item.minValueFloat;
             entry.maxValueFloat = item.maxValueFloat;
             entry.step = item.step;
             entry.coarseStep = item.coarseStep;
+            entry.liveEdit = item.liveEdit;
+            if (item.isPending) {
+                entry.isPending = [source]() { return source->isPending(); };
+            }
             // Auto-generate getValue function to display current value
-            entry.getValue = [item]() -> const char* {
+            entry.getValue = [source]() -> const char* {
                 static char buffer[32];
-                snprintf(buffer, sizeof(buffer), "%.2f", item.getFloatValue());
+                snprintf(buffer, sizeof(buffer), "%.2f", source->getFloatValue());
                 return buffer;
             };
             break;
@@ -1526,12 +1917,18 @@ void FrameworkEngine::convertModuleMenuItems(const ModuleMenuItem& parent, MenuI
             entry.isToggle = false;
             entry.isEditableString = true;
             entry.maxStringLength = item.maxStringLength > 0 ? item.maxStringLength : 32;
-            entry.getStringValueForEdit = item.getStringValue;
-            entry.setStringValue = item.setStringValue;
-            entry.getValue = [item]() -> const char* {
+            if (item.getStringValue) {
+                entry.getStringValueForEdit = [source](char* buffer, size_t size) {
+                    source->getStringValue(buffer, size);
+                };
+            }
+            if (item.setStringValue) {
+                entry.setStringValue = [source](const char* value) { source->setStringValue(value); };
+            }
+            entry.getValue = [source]() -> const char* {
                 static char buffer[64];
-                if (item.getStringValue) {
-                    item.getStringValue(buffer, sizeof(buffer));
+                if (source->getStringValue) {
+                    source->getStringValue(buffer, sizeof(buffer));
                 } else {
                     buffer[0] = '\0';
                 }
@@ -1541,7 +1938,9 @@ void FrameworkEngine::convertModuleMenuItems(const ModuleMenuItem& parent, MenuI
         }
 
         // Set visibility condition
-        entry.condition = item.condition;
+        if (item.condition) {
+            entry.condition = [source]() { return source->condition(); };
+        }
         entry.customDraw = nullptr;
 
         // Register with MenuRegistry
@@ -1593,6 +1992,29 @@ bool FrameworkEngine::beginStringEdit(const MenuEntry* entry) {
     return false;
 }
 
+void FrameworkEngine::applyEditValue() {
+    if (editingEntry_ == nullptr) {
+        return;
+    }
+    if (editingEntry_->isEditableInt && editingEntry_->setIntValue) {
+        editingEntry_->setIntValue(editValueInt_);
+    } else if (editingEntry_->isEditableFloat && editingEntry_->setFloatValue) {
+        editingEntry_->setFloatValue(editValueFloat_);
+    }
+}
+
+void FrameworkEngine::serviceLiveEdit(uint32_t nowMs) {
+    static constexpr uint32_t kLiveEditWindowMs = 30;
+    if (!editDirty_ || !menuEditMode_ || editingEntry_ == nullptr) {
+        return;
+    }
+    // One setter call per window, carrying the newest value
+    if (nowMs - editDirtyMs_ >= kLiveEditWindowMs) {
+        editDirty_ = false;
+        applyEditValue();
+    }
+}
+
 void FrameworkEngine::drawBlinkUnderline(DisplayCanvas& canvas, int16_t x, int16_t y, int16_t width) {
     if (width <= 0) {
         return;
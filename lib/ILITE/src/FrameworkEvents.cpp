@@ -0,0 +1,78 @@
+/**
+ * @file FrameworkEvents.cpp
+ * @brief Event queue and its counters
+ */
+
+#include "FrameworkEvents.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+MpscQueue<FrameworkEvent, FrameworkEvents::kQueueSize> g_events;
+
+// Producers count with atomics; handled is ServiceTask only
+std::atomic<uint32_t> g_posted{0};
+std::atomic<uint32_t> g_dropped{0};
+uint32_t g_handled = 0;
+
+}  // namespace
+
+bool FrameworkEvents::post(FrameworkEventType type, const uint8_t* mac, uint8_t value) {
+    FrameworkEvent event;
+    event.type = type;
+    if (mac != nullptr) {
+        memcpy(event.mac, mac, sizeof(event.mac));
+    } else {
+        memset(event.mac, 0, sizeof(event.mac));
+    }
+    event.value = value;
+    event.timeMs = millis();
+    if (!g_events.push(event)) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    g_posted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameworkEvents::postPeerSeen(const uint8_t* mac) {
+    return post(FrameworkEventType::PeerSeen, mac, 0);
+}
+
+bool FrameworkEvents::postPairState(const uint8_t* mac, bool paired) {
+    return post(FrameworkEventType::PairState, mac, paired ? 1 : 0);
+}
+
+bool FrameworkEvents::postCue(AudioCue cue) {
+    return post(FrameworkEventType::Cue, nullptr, static_cast<uint8_t>(cue));
+}
+
+bool FrameworkEvents::postModuleSeen(const uint8_t* mac, uint8_t moduleIndex) {
+    return post(FrameworkEventType::ModuleSeen, mac, moduleIndex);
+}
+
+bool FrameworkEvents::pop(FrameworkEvent& event) {
+    if (!g_events.pop(event)) {
+        return false;
+    }
+    g_handled++;
+    return true;
+}
+
+FrameworkEventStats FrameworkEvents::getStats() {
+    FrameworkEventStats stats;
+    stats.posted = g_posted.load(std::memory_order_relaxed);
+    stats.dropped = g_dropped.load(std::memory_order_relaxed);
+    stats.handled = g_handled;
+    return stats;
+}
+
+void FrameworkEvents::dump(Print& out) {
+    const FrameworkEventStats stats = getStats();
+    out.printf("[Events] posted=%lu handled=%lu dropped=%lu\n",
+               static_cast<unsigned long>(stats.posted),
+               static_cast<unsigned long>(stats.handled),
+               static_cast<unsigned long>(stats.dropped));
+}
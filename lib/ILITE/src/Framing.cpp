@@ -0,0 +1,38 @@
+/**
+ * @file Framing.cpp
+ * @brief CRC16 and COBS encoding shared by the serial framers
+ */
+
+#include "Framing.h"
+
+namespace Framing {
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = kCrcInit;
+    for (size_t i = 0; i < length; ++i) {
+        crc = crc16Update(crc, data[i]);
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t pos = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; ++i) {
+        if (in[i] != 0) {
+            out[pos++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[codeIndex] = code;
+            codeIndex = pos++;
+            code = 1;
+        }
+    }
+    out[codeIndex] = code;
+    out[pos++] = 0x00;
+    return pos;
+}
+
+} // namespace Framing
@@ -0,0 +1,151 @@
+/**
+ * @file GroupCommand.cpp
+ * @brief Group command framing and ACK statistics
+ */
+
+#include "GroupCommand.h"
+#include "PacketBundle.h"
+#include "Transport.h"
+#include <esp_timer.h>
+#include <cstring>
+
+namespace {
+
+const uint8_t kBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+}  // namespace
+
+uint16_t GroupCommand::sequence_ = 0;
+uint32_t GroupCommand::framesSent_ = 0;
+uint32_t GroupCommand::ackRequests_ = 0;
+uint16_t GroupCommand::lastAckSequence_ = 0;
+uint32_t GroupCommand::lastAckSentUs_ = 0;
+GroupMemberStats GroupCommand::members_[kMaxMembers];
+size_t GroupCommand::memberCount_ = 0;
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+size_t writeGroupFrame(uint8_t* out, size_t capacity, const GroupCommandHeader& header,
+                       const uint8_t* command, size_t length) {
+    if (out == nullptr || command == nullptr || kGroupHeaderSize + length > capacity) {
+        return 0;
+    }
+    memcpy(out, &header, kGroupHeaderSize);
+    memcpy(out + kGroupHeaderSize, command, length);
+    return kGroupHeaderSize + length;
+}
+
+const uint8_t* acceptGroupCommand(const uint8_t* data, size_t length, uint32_t memberOf,
+                                  GroupCommandHeader& header, size_t& innerLength) {
+    if (data == nullptr || length <= kGroupHeaderSize) {
+        return nullptr;
+    }
+    memcpy(&header, data, kGroupHeaderSize);
+    if (header.magic != GROUP_PACKET_MAGIC) {
+        return nullptr;
+    }
+    if (header.group != kGroupAll &&
+        (header.group >= 32 || (memberOf & (1UL << header.group)) == 0)) {
+        return nullptr;
+    }
+    innerLength = length - kGroupHeaderSize;
+    return data + kGroupHeaderSize;
+}
+
+// ============================================================================
+// Sending
+// ============================================================================
+
+bool GroupCommand::send(uint8_t group, const uint8_t* command, size_t length, uint8_t ackEvery) {
+    GroupCommandHeader header;
+    header.magic = GROUP_PACKET_MAGIC;
+    header.group = group;
+    header.sequence = ++sequence_;
+    header.flags = (ackEvery > 0 && header.sequence % ackEvery == 0) ? kGroupFlagAck : 0;
+
+    uint8_t frame[PacketBundleWriter::kMaxFrameSize];
+    const size_t frameLength = writeGroupFrame(frame, sizeof(frame), header, command, length);
+    if (frameLength == 0) {
+        return false;
+    }
+
+    const uint32_t sentUs = static_cast<uint32_t>(esp_timer_get_time());
+    if (Transport::getActive().send(kBroadcastMac, frame, frameLength) != ESP_OK) {
+        return false;
+    }
+    framesSent_++;
+    if (header.flags & kGroupFlagAck) {
+        ackRequests_++;
+        lastAckSequence_ = header.sequence;
+        lastAckSentUs_ = sentUs;
+    }
+    return true;
+}
+
+// ============================================================================
+// ACK Statistics
+// ============================================================================
+
+bool GroupCommand::onFrame(const uint8_t* mac, const uint8_t* data, size_t length) {
+    if (mac == nullptr || data == nullptr || length < sizeof(GroupAckFrame)) {
+        return false;
+    }
+    GroupAckFrame ack;
+    memcpy(&ack, data, sizeof(ack));
+    if (ack.magic != GROUP_ACK_MAGIC) {
+        return false;
+    }
+
+    GroupMemberStats* member = nullptr;
+    for (size_t i = 0; i < memberCount_; ++i) {
+        if (memcmp(members_[i].mac, mac, sizeof(members_[i].mac)) == 0) {
+            member = &members_[i];
+            break;
+        }
+    }
+    if (member == nullptr) {
+        if (memberCount_ >= kMaxMembers) {
+            return true;
+        }
+        member = &members_[memberCount_++];
+        *member = GroupMemberStats{};
+        memcpy(member->mac, mac, sizeof(member->mac));
+    }
+
+    member->acks++;
+    member->lastSequence = ack.sequence;
+    // Round trips are only known for the newest request
+    if (ack.sequence == lastAckSequence_) {
+        const uint32_t rttUs = static_cast<uint32_t>(esp_timer_get_time()) - lastAckSentUs_;
+        member->lastRttUs = rttUs;
+        member->avgRttUs = member->acks == 1
+            ? rttUs
+            : static_cast<uint32_t>((static_cast<uint64_t>(member->avgRttUs) * 7 + rttUs) / 8);
+    }
+    return true;
+}
+
+void GroupCommand::reset() {
+    framesSent_ = 0;
+    ackRequests_ = 0;
+    memberCount_ = 0;
+}
+
+void GroupCommand::dump(Print& out) {
+    out.printf("[Group] sent=%lu ack requests=%lu\n",
+               static_cast<unsigned long>(framesSent_),
+               static_cast<unsigned long>(ackRequests_));
+    for (size_t i = 0; i < memberCount_; ++i) {
+        const GroupMemberStats& member = members_[i];
+        const unsigned percent = ackRequests_ > 0
+            ? static_cast<unsigned>(member.acks * 100ULL / ackRequests_) : 0;
+        out.printf("  %02X:%02X:%02X:%02X:%02X:%02X acks=%lu (%u%%) rtt last=%luus avg=%luus\n",
+                   member.mac[0], member.mac[1], member.mac[2],
+                   member.mac[3], member.mac[4], member.mac[5],
+                   static_cast<unsigned long>(member.acks), percent,
+                   static_cast<unsigned long>(member.lastRttUs),
+                   static_cast<unsigned long>(member.avgRttUs));
+    }
+}
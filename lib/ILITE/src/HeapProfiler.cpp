@@ -0,0 +1,408 @@
+/**
+ * @file HeapProfiler.cpp
+ * @brief Fragmentation history, per-task allocation counters and the malloc hooks
+ */
+
+#include "HeapProfiler.h"
+#include "LogChannels.h"
+#include "Profiler.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include <esp_rom_sys.h>
+#include <sdkconfig.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kHeapCaps = MALLOC_CAP_8BIT;
+
+HeapSample g_history[HeapProfiler::kHistory];
+size_t g_historyCount = 0;
+uint32_t g_intervalMs = HeapProfiler::kSampleMs;
+uint32_t g_intervalStartMs = 0;
+HeapSample g_pending = {0, UINT32_MAX, UINT32_MAX};    // Worst values of the open interval
+bool g_lowBlockReported = false;
+
+std::atomic<uint8_t> g_mode{static_cast<uint8_t>(HeapProfiler::Mode::Log)};
+
+/// Merge neighbours so the history covers twice the time
+void decimateHistory() {
+    for (size_t i = 0; i < HeapProfiler::kHistory / 2; ++i) {
+        const HeapSample& a = g_history[2 * i];
+        const HeapSample& b = g_history[2 * i + 1];
+        g_history[i].timeMs = b.timeMs;
+        g_history[i].freeBytes = a.freeBytes < b.freeBytes ? a.freeBytes : b.freeBytes;
+        g_history[i].largestBlock = a.largestBlock < b.largestBlock ? a.largestBlock : b.largestBlock;
+    }
+    g_historyCount = HeapProfiler::kHistory / 2;
+    g_intervalMs *= 2;
+}
+
+void printBytes(Print& out, uint32_t bytes) {
+    if (bytes >= 10240) {
+        out.printf("%5luK", static_cast<unsigned long>(bytes / 1024));
+    } else {
+        out.printf("%6lu", static_cast<unsigned long>(bytes));
+    }
+}
+
+#if ILITE_HEAP_PROFILE
+
+constexpr size_t kZoneSlots = Profiler::kZoneCount + 1;    // Last slot: outside any zone
+constexpr size_t kOtherRow = HeapProfiler::kMaxTasks;      // Tasks past the table, boot code
+
+struct TaskRow {
+    std::atomic<TaskHandle_t> handle;
+    char name[configMAX_TASK_NAME_LEN];
+    uint8_t zone;               ///< Profiler zone the task is in, kNoZone outside
+    uint8_t noAllocDepth;
+    uint32_t allocs[kZoneSlots];
+    uint32_t bytes[kZoneSlots];
+    uint32_t frees;
+};
+
+struct Violation {
+    uint8_t row;
+    uint8_t zone;
+    uint32_t size;
+    void* caller;
+    uint32_t timeMs;
+};
+
+// Each row is written only by its task (the "other" row is shared and may undercount)
+TaskRow g_rows[HeapProfiler::kMaxTasks + 1];
+std::atomic<uint32_t> g_failures{0};
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+Violation g_violations[HeapProfiler::kMaxViolations];      // Guarded by g_lock
+uint32_t g_violationCount = 0;                              // Guarded by g_lock
+uint32_t g_reportedViolations = 0;                          // ServiceTask only
+
+/// Row of the calling task, claimed on its first allocation; nullptr in an ISR
+TaskRow* currentRow() {
+    if (xPortInIsrContext()) {
+        return nullptr;
+    }
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (self == nullptr) {
+        return &g_rows[kOtherRow];
+    }
+    for (size_t i = 0; i < HeapProfiler::kMaxTasks; ++i) {
+        TaskRow& row = g_rows[i];
+        TaskHandle_t owner = row.handle.load(std::memory_order_acquire);
+        if (owner == self) {
+            return &row;
+        }
+        if (owner == nullptr) {
+            if (row.handle.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) {
+                strncpy(row.name, pcTaskGetName(nullptr), sizeof(row.name) - 1);
+                row.zone = HeapProfiler::kNoZone;
+                return &row;
+            }
+            if (owner == self) {
+                return &row;
+            }
+        }
+    }
+    return &g_rows[kOtherRow];
+}
+
+size_t slotOf(const TaskRow* row) {
+    return row != &g_rows[kOtherRow] && row->zone < Profiler::kZoneCount ? row->zone : kZoneSlots - 1;
+}
+
+const char* zoneName(size_t slot) {
+    return slot < Profiler::kZoneCount ? Profiler::getZoneName(static_cast<ProfileZone>(slot)) : "-";
+}
+
+const char* rowName(size_t index) {
+    return index == kOtherRow ? "other" : g_rows[index].name;
+}
+
+void recordViolation(TaskRow* row, size_t slot, size_t size, void* caller) {
+    const Violation violation = {
+        static_cast<uint8_t>(row - g_rows), static_cast<uint8_t>(slot),
+        static_cast<uint32_t>(size), caller, millis()
+    };
+    portENTER_CRITICAL(&g_lock);
+    g_violations[g_violationCount % HeapProfiler::kMaxViolations] = violation;
+    g_violationCount++;
+    portEXIT_CRITICAL(&g_lock);
+
+    if (HeapProfiler::getMode() == HeapProfiler::Mode::Assert) {
+        // No printf here: it may allocate. The abort backtrace shows the caller.
+        esp_rom_printf("[Heap] %s allocated %u bytes in a no-alloc region (zone %s)\n",
+                       rowName(violation.row), static_cast<unsigned>(size), zoneName(slot));
+        abort();
+    }
+}
+
+#endif // ILITE_HEAP_PROFILE
+
+}  // namespace
+
+// ============================================================================
+// Allocation hooks
+// ============================================================================
+
+#if ILITE_HEAP_PROFILE
+
+#if CONFIG_HEAP_USE_HOOKS
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)caps;
+    HeapProfiler::onAlloc(ptr, size, nullptr);
+}
+
+extern "C" void esp_heap_trace_free_hook(void* ptr) {
+    HeapProfiler::onFree(ptr);
+}
+#else
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    void* ptr = __real_malloc(size);
+    HeapProfiler::onAlloc(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    void* ptr = __real_calloc(count, size);
+    HeapProfiler::onAlloc(ptr, count * size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    void* moved = __real_realloc(ptr, size);
+    if (ptr != nullptr && moved != nullptr) {
+        HeapProfiler::onFree(ptr);
+    }
+    HeapProfiler::onAlloc(moved, size, __builtin_return_address(0));
+    return moved;
+}
+
+void __wrap_free(void* ptr) {
+    __real_free(ptr);
+    HeapProfiler::onFree(ptr);
+}
+}  // extern "C"
+#endif // CONFIG_HEAP_USE_HOOKS
+
+void HeapProfiler::onAlloc(void* ptr, size_t size, void* caller) {
+    TaskRow* row = currentRow();
+    if (row == nullptr) {
+        return;
+    }
+    const size_t slot = slotOf(row);
+    row->allocs[slot]++;
+    row->bytes[slot] += size;
+    if (ptr == nullptr) {
+        g_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (row->noAllocDepth > 0) {
+        recordViolation(row, slot, size, caller);
+    }
+}
+
+void HeapProfiler::onFree(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    TaskRow* row = currentRow();
+    if (row != nullptr) {
+        row->frees++;
+    }
+}
+
+uint8_t HeapProfiler::enterZone(uint8_t zone) {
+    TaskRow* row = currentRow();
+    if (row == nullptr || row == &g_rows[kOtherRow]) {
+        return kNoZone;
+    }
+    const uint8_t previous = row->zone;
+    row->zone = zone;
+    return previous;
+}
+
+void HeapProfiler::leaveZone(uint8_t previous) {
+    TaskRow* row = currentRow();
+    if (row != nullptr && row != &g_rows[kOtherRow]) {
+        row->zone = previous;
+    }
+}
+
+void HeapProfiler::enterNoAlloc() {
+    TaskRow* row = currentRow();
+    if (row != nullptr) {
+        row->noAllocDepth++;
+    }
+}
+
+void HeapProfiler::leaveNoAlloc() {
+    TaskRow* row = currentRow();
+    if (row != nullptr && row->noAllocDepth > 0) {
+        row->noAllocDepth--;
+    }
+}
+
+#else
+
+void HeapProfiler::onAlloc(void*, size_t, void*) {}
+void HeapProfiler::onFree(void*) {}
+uint8_t HeapProfiler::enterZone(uint8_t) { return kNoZone; }
+void HeapProfiler::leaveZone(uint8_t) {}
+void HeapProfiler::enterNoAlloc() {}
+void HeapProfiler::leaveNoAlloc() {}
+
+#endif // ILITE_HEAP_PROFILE
+
+void HeapProfiler::setMode(Mode mode) {
+    g_mode.store(static_cast<uint8_t>(mode), std::memory_order_relaxed);
+}
+
+HeapProfiler::Mode HeapProfiler::getMode() {
+    return static_cast<Mode>(g_mode.load(std::memory_order_relaxed));
+}
+
+// ============================================================================
+// History
+// ============================================================================
+
+void HeapProfiler::sample(uint32_t nowMs) {
+    const uint32_t freeBytes = heap_caps_get_free_size(kHeapCaps);
+    const uint32_t largest = heap_caps_get_largest_free_block(kHeapCaps);
+    if (freeBytes < g_pending.freeBytes) {
+        g_pending.freeBytes = freeBytes;
+    }
+    if (largest < g_pending.largestBlock) {
+        g_pending.largestBlock = largest;
+    }
+
+    if (largest < kLowBlockBytes && !g_lowBlockReported) {
+        ILITE_LOG(SYSTEM, LOG_WARN, "[Heap] Largest free block %lu bytes (%lu free): fragmented",
+                  static_cast<unsigned long>(largest), static_cast<unsigned long>(freeBytes));
+        g_lowBlockReported = true;
+    } else if (largest >= 2 * kLowBlockBytes) {
+        g_lowBlockReported = false;
+    }
+
+    if (nowMs - g_intervalStartMs >= g_intervalMs || g_historyCount == 0) {
+        if (g_historyCount == kHistory) {
+            decimateHistory();
+        }
+        g_pending.timeMs = nowMs;
+        g_history[g_historyCount++] = g_pending;
+        g_pending = {0, UINT32_MAX, UINT32_MAX};
+        g_intervalStartMs = nowMs;
+    }
+
+#if ILITE_HEAP_PROFILE
+    // Region violations are logged here, never from the allocating task
+    uint32_t count;
+    portENTER_CRITICAL(&g_lock);
+    count = g_violationCount;
+    portEXIT_CRITICAL(&g_lock);
+    if (count - g_reportedViolations > kMaxViolations) {
+        g_reportedViolations = count - kMaxViolations;
+    }
+    for (; g_reportedViolations != count; ++g_reportedViolations) {
+        Violation violation;
+        portENTER_CRITICAL(&g_lock);
+        violation = g_violations[g_reportedViolations % kMaxViolations];
+        portEXIT_CRITICAL(&g_lock);
+        ILITE_LOG_RATE(SYSTEM, LOG_WARN, 1, 4, "[Heap] %s allocated %lu bytes in a no-alloc region (zone %s, caller %p)",
+                       rowName(violation.row), static_cast<unsigned long>(violation.size),
+                       zoneName(violation.zone), violation.caller);
+    }
+#endif
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+void HeapProfiler::reset() {
+#if ILITE_HEAP_PROFILE
+    for (TaskRow& row : g_rows) {
+        memset(row.allocs, 0, sizeof(row.allocs));
+        memset(row.bytes, 0, sizeof(row.bytes));
+        row.frees = 0;
+    }
+    g_failures.store(0, std::memory_order_relaxed);
+    portENTER_CRITICAL(&g_lock);
+    g_violationCount = 0;
+    portEXIT_CRITICAL(&g_lock);
+    g_reportedViolations = 0;
+#endif
+}
+
+void HeapProfiler::dump(Print& out) {
+    const uint32_t freeBytes = heap_caps_get_free_size(kHeapCaps);
+    const uint32_t largest = heap_caps_get_largest_free_block(kHeapCaps);
+    out.printf("[Heap] free=%lu largest=%lu (%lu%% fragmented) minFree=%lu\n",
+               static_cast<unsigned long>(freeBytes), static_cast<unsigned long>(largest),
+               static_cast<unsigned long>(freeBytes > 0 ? 100 - 100ull * largest / freeBytes : 0),
+               static_cast<unsigned long>(heap_caps_get_minimum_free_size(kHeapCaps)));
+    out.printf("[Heap] history every %lus, worst per interval (time s: free largest)\n",
+               static_cast<unsigned long>(g_intervalMs / 1000));
+    for (size_t i = 0; i < g_historyCount; ++i) {
+        out.printf("  %6lu:", static_cast<unsigned long>(g_history[i].timeMs / 1000));
+        printBytes(out, g_history[i].freeBytes);
+        printBytes(out, g_history[i].largestBlock);
+        out.print((i % 3 == 2 || i + 1 == g_historyCount) ? "\n" : " ");
+    }
+}
+
+void HeapProfiler::dumpAllocations(Print& out) {
+#if ILITE_HEAP_PROFILE
+    out.printf("[Heap] allocations by task and zone (%s mode, %lu failed)\n",
+               getMode() == Mode::Assert ? "assert" : "log",
+               static_cast<unsigned long>(g_failures.load(std::memory_order_relaxed)));
+    for (size_t r = 0; r <= kMaxTasks; ++r) {
+        const TaskRow& row = g_rows[r];
+        if (r < kMaxTasks && row.handle.load(std::memory_order_acquire) == nullptr) {
+            continue;
+        }
+        uint32_t allocs = 0;
+        for (size_t z = 0; z < kZoneSlots; ++z) {
+            allocs += row.allocs[z];
+        }
+        if (allocs == 0 && row.frees == 0) {
+            continue;
+        }
+        out.printf("  %-12s allocs=%lu frees=%lu\n", rowName(r),
+                   static_cast<unsigned long>(allocs), static_cast<unsigned long>(row.frees));
+        for (size_t z = 0; z < kZoneSlots; ++z) {
+            if (row.allocs[z] > 0) {
+                out.printf("    %-9s %8lu allocs %9lu bytes\n", zoneName(z),
+                           static_cast<unsigned long>(row.allocs[z]),
+                           static_cast<unsigned long>(row.bytes[z]));
+            }
+        }
+    }
+
+    Violation recent[kMaxViolations];
+    uint32_t count;
+    portENTER_CRITICAL(&g_lock);
+    count = g_violationCount;
+    memcpy(recent, g_violations, sizeof(recent));
+    portEXIT_CRITICAL(&g_lock);
+    out.printf("[Heap] no-alloc region violations: %lu\n", static_cast<unsigned long>(count));
+    const uint32_t first = count > kMaxViolations ? count - kMaxViolations : 0;
+    for (uint32_t i = first; i < count; ++i) {
+        const Violation& v = recent[i % kMaxViolations];
+        out.printf("  %8lums %-12s %-9s %5lu bytes caller %p\n",
+                   static_cast<unsigned long>(v.timeMs), rowName(v.row), zoneName(v.zone),
+                   static_cast<unsigned long>(v.size), v.caller);
+    }
+#else
+    out.println("[Heap] Allocation counters need a build with ILITE_HEAP_PROFILE=1 (env ILITE_heap)");
+#endif
+}
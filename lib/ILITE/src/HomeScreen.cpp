@@ -17,6 +17,8 @@ DisplayMode HomeScreen::currentMode_ = DisplayMode::HOME;
 DisplayMode HomeScreen::previousMode_ = DisplayMode::HOME;
 uint32_t HomeScreen::lastUpdate_ = 0;
 int HomeScreen::deviceListIndex_ = 0;
+int HomeScreen::listPeerIndex_ = -1;
+uint32_t HomeScreen::listRankVersion_ = 0;
 int HomeScreen::selectedDeviceIndex_ = -1;
 int HomeScreen::selectedButtonIndex_ = 0;  // 0 = Pair, 1 = Cancel
 
@@ -25,6 +27,9 @@ static int menuIndex = 0;
 static const char* menuItems[] = {"Terminal", "Device list", "Modules", "Settings"};
 static const int menuItemCount = 4;
 
+// Device list rows
+static const int kVisibleDevices = 5;
+
 // Terminal log buffer
 static String terminalLogs[8];
 static int terminalLogCount = 0;
@@ -39,6 +44,7 @@ void HomeScreen::begin() {
     lastUpdate_ = millis();
     menuIndex = 0;
     deviceListIndex_ = 0;
+    listPeerIndex_ = -1;
     selectedDeviceIndex_ = -1;
 
     // Initialize terminal with some default logs
@@ -86,8 +92,6 @@ void HomeScreen::draw(DisplayCanvas& canvas) {
             drawHome(canvas);
             break;
     }
-
-    canvas.sendBuffer();
 }
 
 void HomeScreen::onEncoderButton() {
@@ -106,6 +110,7 @@ void HomeScreen::onEncoderButton() {
                 currentMode_ = DisplayMode::TERMINAL;
             } else if (menuIndex == 1) {
                 deviceListIndex_ = 0;
+                listPeerIndex_ = -1;
                 currentMode_ = DisplayMode::DEVICE_LIST;
             } else if (menuIndex == 2) {
                 currentMode_ = DisplayMode::MODULE_BROWSER;
@@ -119,8 +124,15 @@ void HomeScreen::onEncoderButton() {
             break;
 
         case DisplayMode::DEVICE_LIST:
-            // Select device from list
-            selectedDeviceIndex_ = deviceListIndex_;
+            {
+                // Select device from list (ranks move, peer table slots do not)
+                auto& discovery = ILITEFramework::getInstance().getDiscovery();
+                int8_t peer = -1;
+                if (discovery.getRankedPeers(deviceListIndex_, &peer, 1) == 0) {
+                    break;
+                }
+                selectedDeviceIndex_ = peer;
+            }
             selectedButtonIndex_ = 0;  // Reset to Pair button
             previousMode_ = DisplayMode::DEVICE_LIST;
             currentMode_ = DisplayMode::DEVICE_PROPERTIES;
@@ -131,13 +143,11 @@ void HomeScreen::onEncoderButton() {
             if (selectedButtonIndex_ == 0) {
                 // Pair button pressed
                 auto& discovery = ILITEFramework::getInstance().getDiscovery();
-                if (selectedDeviceIndex_ >= 0 && selectedDeviceIndex_ < discovery.getPeerCount()) {
-                    const uint8_t* mac = discovery.getPeer(selectedDeviceIndex_);
-                    if (mac != nullptr) {
-                        discovery.beginPairingWith(mac);
-                        Serial.println("[HomeScreen] Initiated pairing with selected device");
-                        currentMode_ = DisplayMode::HOME;
-                    }
+                const uint8_t* mac = discovery.getPeer(selectedDeviceIndex_);
+                if (mac != nullptr) {
+                    discovery.beginPairingWith(mac);
+                    Serial.println("[HomeScreen] Initiated pairing with selected device");
+                    currentMode_ = DisplayMode::HOME;
                 }
             } else {
                 // Cancel button pressed
@@ -170,8 +180,10 @@ void HomeScreen::onEncoderRotate(int delta) {
                 auto& discovery = ILITEFramework::getInstance().getDiscovery();
                 int peerCount = discovery.getPeerCount();
                 deviceListIndex_ += delta;
-                if (deviceListIndex_ < 0) deviceListIndex_ = 0;
                 if (deviceListIndex_ >= peerCount) deviceListIndex_ = peerCount - 1;
+                if (deviceListIndex_ < 0) deviceListIndex_ = 0;
+                int8_t peer = -1;
+                listPeerIndex_ = discovery.getRankedPeers(deviceListIndex_, &peer, 1) ? peer : -1;
             }
             break;
 
@@ -384,20 +396,36 @@ void HomeScreen::drawDeviceList(DisplayCanvas& canvas) {
         canvas.setFont(DisplayCanvas::TINY);
         canvas.drawTextCentered(42, "Searching...");
     } else {
-        // Display devices (up to 5 visible)
+        // Keep the highlight on the same device when the ranking moves it
+        const uint32_t rankVersion = discovery.getRankVersion();
+        if (rankVersion != listRankVersion_) {
+            listRankVersion_ = rankVersion;
+            const int rank = discovery.getPeerRank(listPeerIndex_);
+            if (rank >= 0) {
+                deviceListIndex_ = rank;
+            }
+        }
+        if (deviceListIndex_ >= deviceCount) deviceListIndex_ = deviceCount - 1;
+
+        // Display the visible window of the ranked list
         canvas.setFont(DisplayCanvas::TINY);
         int startIdx = deviceListIndex_;
-        if (startIdx > deviceCount - 5 && deviceCount > 5) {
-            startIdx = deviceCount - 5;
+        if (startIdx > deviceCount - kVisibleDevices && deviceCount > kVisibleDevices) {
+            startIdx = deviceCount - kVisibleDevices;
         }
         if (startIdx < 0) startIdx = 0;
 
-        for (int i = 0; i < 5 && (startIdx + i) < deviceCount; i++) {
+        int8_t visible[kVisibleDevices];
+        const int shown = discovery.getRankedPeers(startIdx, visible, kVisibleDevices);
+        for (int i = 0; i < shown; i++) {
             int deviceIdx = startIdx + i;
             int y = 18 + (i * 9);
 
-            const char* deviceName = discovery.getPeerName(deviceIdx);
+            const char* deviceName = discovery.getPeerName(visible[i]);
             bool selected = (deviceIdx == deviceListIndex_);
+            if (selected) {
+                listPeerIndex_ = visible[i];
+            }
 
             if (selected) {
                 // Highlight selected device
@@ -405,10 +433,17 @@ void HomeScreen::drawDeviceList(DisplayCanvas& canvas) {
                 canvas.setDrawColor(0);  // Invert for text
             }
 
-            // Draw device name (truncate if needed)
+            // Draw device name (truncate if needed) and signal
             char nameBuffer[22];
             strncpy(nameBuffer, deviceName != nullptr ? deviceName : "Unknown", 21);
             nameBuffer[21] = '\0';
+            const int8_t rssi = discovery.getPeerRssi(visible[i]);
+            if (rssi != EspNowDiscovery::kNoRssi) {
+                nameBuffer[16] = '\0';
+                char rssiBuffer[8];
+                snprintf(rssiBuffer, sizeof(rssiBuffer), "%d", static_cast<int>(rssi));
+                canvas.drawText(124 - canvas.getTextWidth(rssiBuffer), y, rssiBuffer);
+            }
             canvas.drawText(4, y, nameBuffer);
 
             if (selected) {
@@ -434,13 +469,12 @@ void HomeScreen::drawDeviceProperties(DisplayCanvas& canvas) {
     // Get device info
     auto& discovery = ILITEFramework::getInstance().getDiscovery();
 
-    if (selectedDeviceIndex_ < 0 || selectedDeviceIndex_ >= discovery.getPeerCount()) {
+    const uint8_t* mac = discovery.getPeer(selectedDeviceIndex_);
+    if (mac == nullptr) {
         canvas.setFont(DisplayCanvas::SMALL);
         canvas.drawTextCentered(32, "Invalid device");
         return;
     }
-
-    const uint8_t* mac = discovery.getPeer(selectedDeviceIndex_);
     const char* name = discovery.getPeerName(selectedDeviceIndex_);
 
     // Device information section
@@ -454,11 +488,16 @@ void HomeScreen::drawDeviceProperties(DisplayCanvas& canvas) {
     // MAC address
     canvas.setFont(DisplayCanvas::TINY);
     canvas.drawText(2, 36, "MAC Address:");
-    if (mac != nullptr) {
-        char macStr[18];
-        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-                mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-        canvas.drawText(2, 44, macStr);
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
+            mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    canvas.drawText(2, 44, macStr);
+
+    const int8_t rssi = discovery.getPeerRssi(selectedDeviceIndex_);
+    if (rssi != EspNowDiscovery::kNoRssi) {
+        char rssiStr[12];
+        snprintf(rssiStr, sizeof(rssiStr), "%d dBm", static_cast<int>(rssi));
+        canvas.drawText(126 - canvas.getTextWidth(rssiStr), 36, rssiStr);
     }
 
     // Buttons at the bottom
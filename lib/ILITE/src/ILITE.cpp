@@ -9,9 +9,13 @@
 #include "input.h"
 #include <WiFi.h>
 #include <esp_now.h>
+#include <esp_wifi.h>
 #include <ArduinoOTA.h>
-#include <Wire.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstdarg>
 #include <cstring>
+#include <atomic>
 
 // Extension systems (optional)
 #include "IconLibrary.h"
@@ -19,9 +23,54 @@
 #include "AudioCues.h"
 #include "MenuRegistry.h"
 #include "ScreenRegistry.h"
+#include "ScreenCapture.h"
 #include "ControlBindingSystem.h"
+#include "Profiler.h"
+#include "HeapProfiler.h"
+#include "TaskMonitor.h"
+#include "BatteryMonitor.h"
+#include "PowerManager.h"
+#include "RenderScheduler.h"
+#include "Animator.h"
+#include "EncoderSampler.h"
+#include "EventLog.h"
+#include "BlackBox.h"
+#include "LinkMetrics.h"
+#include "PacketInspector.h"
+#include "TelemetryHealth.h"
+#include "ClockSync.h"
+#include "ModuleHandoff.h"
 #include "FrameworkEngine.h"
 #include "connection_log.h"
+#include "LogChannels.h"
+#include "TelemetryTap.h"
+#include "InputReplay.h"
+#include "SettingsStore.h"
+#include "ModuleConfig.h"
+#include "PacketBundle.h"
+#include "DeltaPacket.h"
+#include "CommandStamp.h"
+#include "RedundantPacket.h"
+#include "RateRequest.h"
+#include "CommandSchedule.h"
+#include "GroupCommand.h"
+#include "TxWindow.h"
+#include "Transport.h"
+#include "UartTransport.h"
+#include "OtaReceiver.h"
+#include "FirmwareRelay.h"
+#include "SerialBridge.h"
+#include "WebDashboard.h"
+#include "FrameworkEvents.h"
+#include "ChannelSurvey.h"
+#include "TdmaSlots.h"
+#include "ControlDeadline.h"
+#include "JobQueue.h"
+#include "CommandTable.h"
+#include "StatusLed.h"
+#include "LatencyPins.h"
+#include "JoystickCalibrator.h"
+#include "TrainerLink.h"
 
 // ============================================================================
 // Global Instances
@@ -30,6 +79,56 @@
 // Discovery instance (used globally throughout the framework)
 EspNowDiscovery discovery;
 
+// Arduino loop task stack (sdkconfig value when the core provides it)
+#ifdef CONFIG_ARDUINO_LOOP_STACK_SIZE
+static constexpr uint32_t kLoopTaskStackSize = CONFIG_ARDUINO_LOOP_STACK_SIZE;
+#else
+static constexpr uint32_t kLoopTaskStackSize = 8192;
+#endif
+
+namespace {
+
+// Last paired peer, cached for fast boot (fits one SettingsStore value)
+struct LastPeer {
+    uint8_t mac[6];
+    uint8_t channel;            ///< WiFi channel the link ran on (0 = unknown)
+    uint8_t valid;
+    char customId[32];          ///< Peer identity, the fallback module match
+    char moduleId[24];          ///< Module active while paired
+};
+
+Setting<LastPeer>& lastPeerSetting() {
+    static Setting<LastPeer> setting =
+        SettingsStore::getInstance().add("fastboot", "peer", LastPeer{});
+    return setting;
+}
+
+// Session token of the last pairing (see EspNowDiscovery::resumeSession);
+// LastPeer already fills its value
+Setting<uint32_t>& lastSessionSetting() {
+    static Setting<uint32_t> setting =
+        SettingsStore::getInstance().add("fastboot", "session", static_cast<uint32_t>(0));
+    return setting;
+}
+
+// Boot progress lines. At 115200 baud each character blocks for ~87 us, so
+// fast boot drops them (errors still print).
+bool quietBoot = false;
+
+void bootLog(const char* format, ...) {
+    if (quietBoot) {
+        return;
+    }
+    char line[96];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    Serial.println(line);
+}
+
+}  // namespace
+
 // ============================================================================
 // Static Instance Management
 // ============================================================================
@@ -52,16 +151,36 @@ ILITEFramework::ILITEFramework()
     : config_(),
       initialized_(false),
       bootTime_(0),
+      deferredInitPending_(false),
+      maintenanceMode_(false),
+      maintenanceRequested_(false),
+      otaHandlersSet_(false),
+      displayParked_(false),
+      displayBenchRequested_(false),
+      teamPeers_(),
+      txFrames_(),
+      txFramesLastSecond_(),
+      txHz_(),
+      firstCommandMs_(0),
       activeModule_(nullptr),
       previousModule_(nullptr),
-      pendingModule_(nullptr),
-      moduleChangePending_(false),
       paired_(false),
+      pairEpoch_(0),
+      standbyPairEpoch_(0),
       lastTelemetryTime_(0),
       packetTxCount_(0),
       packetRxCount_(0),
+      packetSkippedCount_(0),
       commTaskHandle_(nullptr),
       displayTaskHandle_(nullptr),
+      rxTaskHandle_(nullptr),
+      serviceTaskHandle_(nullptr),
+      controlTimer_(nullptr),
+      alignTimer_(nullptr),
+      controlStats_(),
+      controlStatsResetPending_(false),
+      radioStats_(),
+      radioStatsResetPending_(false),
       u8g2_(nullptr),
       displayCanvas_(nullptr),
       discovery_(nullptr),
@@ -79,20 +198,29 @@ ILITEFramework::ILITEFramework()
 bool ILITEFramework::begin(const ILITEConfig& config) {
     // Store configuration
     config_ = config;
+    if (config_.controlLoopHz == 0) {
+        config_.controlLoopHz = 50;
+    } else if (config_.controlLoopHz > MAX_CONTROL_LOOP_HZ) {
+        Serial.printf("WARNING: controlLoopHz %u clamped to %u\n",
+                      config_.controlLoopHz, MAX_CONTROL_LOOP_HZ);
+        config_.controlLoopHz = MAX_CONTROL_LOOP_HZ;
+    }
     bootTime_ = millis();
+    quietBoot = config_.fastBoot;
     initializeWiFiCredentials();
+    registerConsoleCommands();
 
-    Serial.println("=====================================");
-    Serial.println("   ILITE Framework v1.0.0");
-    Serial.println("=====================================");
+    bootLog("=====================================");
+    bootLog("   ILITE Framework v1.0.0");
+    bootLog("=====================================");
 
     // Step 1: Initialize hardware
-    Serial.println("\n[1/7] Initializing hardware...");
+    bootLog("\n[1/7] Initializing hardware...");
     if (!initHardware()) {
         Serial.println("ERROR: Hardware initialization failed!");
         return false;
     }
-    Serial.println("  ✓ Hardware initialized");
+    bootLog("  ✓ Hardware initialized");
 
     // Initialize connection log
     connectionLogInit();
@@ -101,68 +229,110 @@ bool ILITEFramework::begin(const ILITEConfig& config) {
     connectionLogAdd("[ILITE] Hardware initialized");
 
     // Step 2: Initialize packet router
-    Serial.println("\n[2/7] Initializing packet router...");
+    bootLog("\n[2/7] Initializing packet router...");
     if (!PacketRouter::getInstance().begin()) {
         Serial.println("ERROR: PacketRouter initialization failed!");
         return false;
     }
-    Serial.println("  ✓ Packet router initialized");
+    PacketRouter::getInstance().setModuleStandby(config_.moduleStandby);
+    bootLog("  ✓ Packet router initialized");
 
     // Step 3: Register and initialize modules
-    Serial.println("\n[3/7] Initializing modules...");
+    bootLog("\n[3/7] Initializing modules...");
     registerBuiltInModules();
     if (!initModules()) {
         Serial.println("ERROR: Module initialization failed!");
         return false;
     }
-    Serial.printf("  ✓ %zu modules initialized\n", ModuleRegistry::getModuleCount());
+    bootLog("  ✓ %zu modules initialized", ModuleRegistry::getModuleCount());
+
+    // Fast boot: paired before the tasks start, so CommTask's first tick sends
+    if (config_.fastBoot) {
+        if (resumeLastPeer()) {
+            bootLog("  ✓ Resumed cached peer");
+        } else {
+            bootLog("  - No cached peer, discovering");
+        }
+    }
+
+    // The tasks below read these registries from their first tick. They only
+    // take flash tables by address, so fast boot starts them here too.
+    IconLibrary::initBuiltInIcons();
+    MenuRegistry::initBuiltInMenus();
+    Profiler::registerScreen();
+    JoystickCalibrator::registerScreen();
 
     // Step 4: Create FreeRTOS tasks
-    Serial.println("\n[4/7] Creating FreeRTOS tasks...");
+    bootLog("\n[4/7] Creating FreeRTOS tasks...");
     if (!createTasks()) {
         Serial.println("ERROR: Task creation failed!");
         return false;
     }
-    Serial.println("  ✓ Control and display tasks created");
+    bootLog("  ✓ Control and display tasks created");
+    if (!SettingsStore::getInstance().begin(config_.settingsCommitMs)) {
+        Serial.println("WARNING: Settings commit task failed (edits kept in RAM)");
+    }
+    if (config_.powerManagement) {
+        PowerManager::begin(config_.cpuMaxMhz, config_.cpuMinMhz, config_.lightSleep,
+                            config_.idleTimeoutMs);
+        PowerManager::setWakeTask(commTaskHandle_);
+    }
+    if (config_.eventLog) {
+        EventLog::begin();
+    }
+    if (config_.blackBox) {
+        BlackBox::begin();
+    }
 
-    // Step 5: Initialize OTA if enabled
+    // Step 5: OTA only starts with the maintenance mode
     if (config_.enableOTA) {
-        Serial.println("\n[5/7] Initializing OTA...");
-        if (!initOTA()) {
-            Serial.println("WARNING: OTA initialization failed (continuing anyway)");
-        } else {
-            Serial.println("  ✓ OTA initialized");
-        }
+        bootLog("\n[5/7] OTA available in maintenance mode");
     } else {
-        Serial.println("\n[5/7] OTA disabled (skipped)");
+        bootLog("\n[5/7] OTA disabled (skipped)");
+    }
+    if (config_.fastBoot) {
+        // The boot timing is reported once commands flow
+        deferredInitPending_ = true;
     }
 
     // Step 6: Start discovery
     if (config_.enableDiscovery) {
-        Serial.println("\n[6/7] Starting ESP-NOW discovery...");
+        bootLog("\n[6/7] Starting ESP-NOW discovery...");
         discovery.setDiscoveryEnabled(true);
-        Serial.println("  ✓ Discovery enabled");
+        bootLog("  ✓ Discovery enabled");
     } else {
-        Serial.println("\n[6/7] Discovery disabled (skipped)");
+        bootLog("\n[6/7] Discovery disabled (skipped)");
     }
 
     // Step 7: Initialize extension systems (optional, non-breaking)
-    Serial.println("\n[7/7] Initializing extension systems...");
-    IconLibrary::initBuiltInIcons();
-    MenuRegistry::initBuiltInMenus();
+    bootLog("\n[7/7] Initializing extension systems...");
+    TaskMonitor::begin();
+    // begin() runs on the Arduino loop task
+    TaskMonitor::watch(xTaskGetCurrentTaskHandle(), kLoopTaskStackSize, ARDUINO_RUNNING_CORE);
     ControlBindingSystem::begin();
-    Serial.println("  ✓ Extension systems initialized");
+    bootLog("  ✓ Extension systems initialized");
+    if (config_.webDashboard && !setWebDashboard(true)) {
+        Serial.println("  WARNING: Web dashboard unavailable");
+    }
 
     initialized_ = true;
 
-    Serial.println("\n=====================================");
-    Serial.println("   ILITE Framework Ready!");
-    Serial.println("=====================================");
-    Serial.printf("Uptime: %lu ms\n", getUptimeMs());
-    Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
-    Serial.printf("Control loop: %u Hz\n", config_.controlLoopHz);
-    Serial.printf("Display refresh: %u Hz\n", config_.displayRefreshHz);
-    Serial.println();
+    // Housekeeping needs a finished init, so its task starts last
+    if (startServiceTask()) {
+        bootLog("  - ServiceTask created");
+    } else {
+        Serial.println("  WARNING: ServiceTask unavailable, housekeeping runs in loop()");
+    }
+
+    bootLog("\n=====================================");
+    bootLog("   ILITE Framework Ready!");
+    bootLog("=====================================");
+    bootLog("Uptime: %lu ms", getUptimeMs());
+    bootLog("Free heap: %u bytes", ESP.getFreeHeap());
+    bootLog("Control loop: %u Hz", config_.controlLoopHz);
+    bootLog("Display refresh: %u Hz data, %u Hz input, %u Hz floor",
+            config_.displayRefreshHz, config_.displayMaxFps, config_.displayFloorHz);
+    bootLog("");
 
     return true;
 }
@@ -173,48 +343,99 @@ bool ILITEFramework::begin(const ILITEConfig& config) {
 
 bool ILITEFramework::initHardware() {
     // Initialize WiFi for ESP-NOW
-    Serial.println("  - WiFi...");
-    WiFi.mode(WIFI_AP_STA);
+    bootLog("  - WiFi...");
+    // STA only: no AP beacons competing with ESP-NOW outside the maintenance mode
+    WiFi.mode(WIFI_STA);
     WiFi.setSleep(false);
-
-    if (config_.enableOTA) {
-        WiFi.softAP(config_.wifiSSID, config_.wifiPassword);
-        Serial.printf("    AP: %s\n", config_.wifiSSID);
+    // On the channel the cached peer used, else the quietest one when asked
+    const uint8_t cachedChannel = config_.fastBoot ? lastPeerSetting().get().channel : 0;
+    if (cachedChannel != 0) {
+        esp_wifi_set_channel(cachedChannel, WIFI_SECOND_CHAN_NONE);
+    } else if (config_.autoChannel) {
+        bootLog("  - Channel survey...");
+        const uint8_t channel = ChannelSurvey::run(config_.channelSurveyDwellMs);
+        if (channel != 0) {
+            esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+            bootLog("    Channel %u", channel);
+        }
     }
 
     // Initialize ESP-NOW
-    Serial.println("  - ESP-NOW...");
+    bootLog("  - ESP-NOW...");
     if (esp_now_init() != ESP_OK) {
         Serial.println("    ERROR: ESP-NOW init failed");
         return false;
     }
+    esp_now_register_send_cb(&ILITEFramework::onEspNowSent);
+    Transport::setSentCallback(&ILITEFramework::onEspNowSent);
+    Transport::setReceiver(&discovery.getReceiveRing(), [] { discovery.notifyReceiveTask(); });
+    if (config_.transport == LinkTransport::Uart) {
+        bootLog("  - UART transport...");
+        UartTransportConfig uartConfig;
+        uartConfig.baud = config_.uartTransportBaud;
+        uartConfig.txPin = config_.uartTransportTxPin;
+        uartConfig.rxPin = config_.uartTransportRxPin;
+        uartConfig.dePin = config_.uartTransportDePin;
+        UartTransport& uart = UartTransport::instance();
+        const TaskPlacement placement = getTaskLayout(config_.taskProfile).rx;
+        uart.configure(uartConfig);
+        uart.setTaskPlacement(placement.priority, placement.core);
+        if (!Transport::setActive(uart)) {
+            Serial.println("    WARNING: UART transport failed, staying on ESP-NOW");
+        }
+    }
+    TxWindow::begin(config_.txWindow);
 
     // Initialize discovery system
-    Serial.println("  - Discovery protocol...");
+    bootLog("  - Discovery protocol...");
     discovery.begin();
+    discovery.setPassiveListening(config_.passiveDiscovery);
+    discovery.setForeignFilter(config_.foreignFilter);
+    discovery.setAutoChannel(config_.autoChannel);
+    esp_wifi_set_max_tx_power(config_.txPowerQuarterDbm);
+    LinkRate::begin(config_.linkRate, config_.linkRateAdaptive, config_.linkLongRange);
+    ChannelSurvey::setAutoHop(config_.autoChannel);
+    if (config_.tdmaSlots) {
+        TdmaSlots::setEnabled(true);
+    }
+    discovery.setPingInterval(config_.linkPingMs);
+    LinkMetrics::begin(config_.linkRssi);
+#if ILITE_LATENCY_PINS
+    LatencyPins::begin();
+#endif
+    PacketInspector::begin();
+    FirmwareRelay::begin();
     discovery_ = &discovery;
 
+    if (config_.telemetryTap) {
+        bootLog("  - Telemetry tap...");
+        if (TelemetryTap::begin(Serial, config_.telemetryTapBaud)) {
+            TelemetryTap::setEnabled(true);
+            if (config_.screenTap) {
+                ScreenCapture::setTapStreaming(true);
+            }
+        }
+    }
+
     // Initialize GPIO for inputs
-    Serial.println("  - Input GPIOs...");
+    bootLog("  - Input GPIOs...");
+    EncoderSampler::getInstance().begin(config_.encoderBackend);
     initInput();  // From input.h/cpp
 
     // Initialize InputManager
-    Serial.println("  - InputManager...");
+    bootLog("  - InputManager...");
     InputManager& inputMgr = InputManager::getInstance();
     inputMgr.setJoystickDeadzone(config_.joystickDeadzone);
     inputMgr.setJoystickSensitivity(config_.joystickSensitivity);
     inputMgr.setJoystickFiltering(config_.joystickFiltering);
+    inputMgr.loadJoystickCalibration();
 
-    // Initialize I2C for display
-    Serial.println("  - I2C bus...");
-    Wire.begin();
-
-    // Initialize U8G2 display (SH1106 128x64 OLED)
-    Serial.println("  - OLED display...");
-    u8g2_ = new U8G2_SH1106_128X64_NONAME_F_HW_I2C(
-        U8G2_R0,  // Rotation
-        /* reset=*/ U8X8_PIN_NONE
-    );
+    // Initialize U8G2 display (128x64 OLED on I2C or SPI)
+    DisplayBusConfig displayBus = config_.displayBus;
+    displayBus.i2cAddress = config_.displayI2CAddress;
+    u8g2_ = DisplayBus::create(displayBus);
+    bootLog("  - OLED display (%s, %lu Hz)...", DisplayBus::getName(),
+            static_cast<unsigned long>(DisplayBus::getClockHz()));
 
     if (!u8g2_->begin()) {
         Serial.println("    ERROR: Display init failed");
@@ -224,27 +445,30 @@ bool ILITEFramework::initHardware() {
     u8g2_->setContrast(config_.displayContrast);
 
     // Initialize DisplayCanvas wrapper
-    Serial.println("  - DisplayCanvas...");
+    bootLog("  - DisplayCanvas...");
     displayCanvas_ = new DisplayCanvas(*u8g2_);
+    displayCanvas_->setTextCacheEnabled(config_.displayTextCache);
 
     // Draw boot screen
-    displayCanvas_->clear();
-    displayCanvas_->setFont(DisplayCanvas::NORMAL);
-    displayCanvas_->drawTextCentered(28, "ILITE Framework");
-    displayCanvas_->setFont(DisplayCanvas::SMALL);
-    displayCanvas_->drawTextCentered(40, "Initializing...");
-    displayCanvas_->sendBuffer();
+    displayCanvas_->firstPage();
+    do {
+        displayCanvas_->clear();
+        displayCanvas_->setFont(DisplayCanvas::NORMAL);
+        displayCanvas_->drawTextCentered(28, "ILITE Framework");
+        displayCanvas_->setFont(DisplayCanvas::SMALL);
+        displayCanvas_->drawTextCentered(40, "Initializing...");
+    } while (displayCanvas_->nextPage());
 
     // Initialize audio
     if (config_.enableAudio) {
-        Serial.println("  - Audio feedback...");
+        bootLog("  - Audio feedback...");
         audioSetup();
         audioPlayStartup();
     }
     ensureDefaultAudioCuesRegistered();
 
     // Initialize Framework Engine (v2.0)
-    Serial.println("  - FrameworkEngine...");
+    bootLog("  - FrameworkEngine...");
     frameworkEngine_->begin();
 
     return true;
@@ -262,16 +486,15 @@ bool ILITEFramework::initModules() {
         return true;  // Not an error, just no modules
     }
 
-    // Call onInit() for each registered module
+    // onInit() runs on first activation (ModuleRegistry::ensureInitialized()),
+    // so boot only lists the modules
     for (size_t i = 0; i < moduleCount; ++i) {
         ILITEModule* module = ModuleRegistry::getModuleByIndex(i);
 
-        Serial.printf("  - Module %zu: %s v%s\n",
-                     i + 1,
-                     module->getModuleName(),
-                     module->getVersion());
-
-        module->onInit();
+        bootLog("  - Module %zu: %s v%s",
+                i + 1,
+                module->getModuleName(),
+                module->getVersion());
     }
 
     return true;
@@ -282,15 +505,25 @@ bool ILITEFramework::initModules() {
 // ============================================================================
 
 bool ILITEFramework::createTasks() {
-    // Create communication task (Core 0, high priority)
+    const TaskLayout layout = getTaskLayout(config_.taskProfile);
+    bootLog("  - Task profile: %s", getTaskProfileName(config_.taskProfile));
+
+    const uint8_t budgets[ControlDeadline::kStageCount] = {
+        config_.inputBudgetPercent, config_.uiBudgetPercent,
+        config_.controlBudgetPercent, config_.transmitBudgetPercent
+    };
+    ControlDeadline::configure(budgets, config_.degradedMode);
+    ModuleBudget::setPolicy(config_.moduleBudgets);
+
+    // Create communication task
     BaseType_t result = xTaskCreatePinnedToCore(
         commTask,                          // Task function
         "CommTask",                        // Name
         4096,                              // Stack size
         this,                              // Parameter (this instance)
-        2,                                 // Priority (high)
+        layout.comm.priority,              // Priority
         &commTaskHandle_,                  // Handle
-        0                                  // Core 0
+        layout.comm.core                   // Core
     );
 
     if (result != pdPASS) {
@@ -298,17 +531,29 @@ bool ILITEFramework::createTasks() {
         return false;
     }
 
-    Serial.println("  - CommTask created (Core 0, Priority 2)");
+    TaskMonitor::watch(commTaskHandle_, 4096, layout.comm.core);
+    bootLog("  - CommTask created (Core %d, Priority %u)",
+            static_cast<int>(layout.comm.core), static_cast<unsigned>(layout.comm.priority));
 
-    // Create display task (Core 1, lower priority)
+    // I2C transfers run in their own task so DisplayTask can render meanwhile
+    if (displayCanvas_->isPageMode()) {
+        bootLog("  - %s display buffer, flushing per band", DisplayBus::getBufferModeName());
+    } else if (displayCanvas_->startAsyncFlush(layout.flush.core, layout.flush.priority)) {
+        bootLog("  - DisplayFlush created (Core %d, Priority %u)",
+                static_cast<int>(layout.flush.core), static_cast<unsigned>(layout.flush.priority));
+    } else {
+        Serial.println("  WARNING: Async display flush unavailable, flushing inline");
+    }
+
+    // Create display task
     result = xTaskCreatePinnedToCore(
         displayTask,                       // Task function
         "DisplayTask",                     // Name
         4096,                              // Stack size
         this,                              // Parameter (this instance)
-        1,                                 // Priority (lower)
+        layout.display.priority,           // Priority
         &displayTaskHandle_,               // Handle
-        1                                  // Core 1
+        layout.display.core                // Core
     );
 
     if (result != pdPASS) {
@@ -316,7 +561,67 @@ bool ILITEFramework::createTasks() {
         return false;
     }
 
-    Serial.println("  - DisplayTask created (Core 1, Priority 1)");
+    TaskMonitor::watch(displayTaskHandle_, 4096, layout.display.core);
+    RenderScheduler::begin(displayTaskHandle_, config_.displayMaxFps, config_.displayRefreshHz);
+    bootLog("  - DisplayTask created (Core %d, Priority %u)",
+            static_cast<int>(layout.display.core), static_cast<unsigned>(layout.display.priority));
+
+    // Create receive consumer (above CommTask so telemetry never waits a control tick)
+    result = xTaskCreatePinnedToCore(
+        rxTask,                            // Task function
+        "RxTask",                          // Name
+        4096,                              // Stack size
+        this,                              // Parameter (this instance)
+        layout.rx.priority,                // Priority
+        &rxTaskHandle_,                    // Handle
+        layout.rx.core                     // Core
+    );
+
+    if (result != pdPASS) {
+        Serial.println("  ERROR: Failed to create RxTask");
+        return false;
+    }
+
+    discovery.setReceiveTask(rxTaskHandle_);
+    TaskMonitor::watch(rxTaskHandle_, 4096, layout.rx.core);
+    bootLog("  - RxTask created (Core %d, Priority %u)",
+            static_cast<int>(layout.rx.core), static_cast<unsigned>(layout.rx.priority));
+
+    // Background jobs; ServiceTask runs them if the worker cannot start
+    if (JobQueue::begin(layout.worker.core, layout.worker.priority)) {
+        bootLog("  - JobWorker created (Core %d, Priority %u)",
+                static_cast<int>(layout.worker.core), static_cast<unsigned>(layout.worker.priority));
+    } else {
+        Serial.println("  WARNING: Failed to create JobWorker, jobs run on ServiceTask");
+    }
+
+    // Drive CommTask from a microsecond esp_timer instead of the 1 ms RTOS tick
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &ILITEFramework::controlTimerCallback;
+    timerArgs.arg = commTaskHandle_;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "ctrl_loop";
+
+    if (esp_timer_create(&timerArgs, &controlTimer_) != ESP_OK ||
+        esp_timer_start_periodic(controlTimer_, 1000000ULL / config_.controlLoopHz) != ESP_OK) {
+        Serial.println("  ERROR: Failed to start control loop timer");
+        return false;
+    }
+
+    bootLog("  - Control timer started (%u Hz, %lu us period)",
+            config_.controlLoopHz, 1000000UL / config_.controlLoopHz);
+
+    if (config_.tdmaSlots) {
+        esp_timer_create_args_t alignArgs = {};
+        alignArgs.callback = &ILITEFramework::alignTimerCallback;
+        alignArgs.arg = this;
+        alignArgs.dispatch_method = ESP_TIMER_TASK;
+        alignArgs.name = "ctrl_align";
+        if (esp_timer_create(&alignArgs, &alignTimer_) != ESP_OK) {
+            Serial.println("  WARNING: No TDMA align timer, slots stay unsynchronized");
+            alignTimer_ = nullptr;
+        }
+    }
 
     return true;
 }
@@ -325,19 +630,46 @@ bool ILITEFramework::createTasks() {
 // OTA Initialization
 // ============================================================================
 
+void ILITEFramework::prepareForFlashing() {
+    Serial.println("OTA: Starting update...");
+    // The update reboots the controller; pending edits must reach flash first
+    ILITEFramework& framework = getInstance();
+    framework.saveModuleConfig(framework.activeModule_);
+    SettingsStore::getInstance().commitNow();
+}
+
 bool ILITEFramework::initOTA() {
     ArduinoOTA.setHostname(config_.wifiSSID);
+    if (!otaHandlersSet_) {
+        registerOTAHandlers();
+        otaHandlersSet_ = true;
+    }
+
+    ArduinoOTA.begin();
 
-    ArduinoOTA.onStart([]() {
-        Serial.println("OTA: Starting update...");
+    // Compressed images (tools/ota_push.py) on the port next to ArduinoOTA
+    OtaReceiver::begin(OtaReceiver::kDefaultPort, &ILITEFramework::prepareForFlashing, [](int percent) {
+        ILITEFramework::getInstance().drawMaintenanceScreen(percent);
     });
 
+    return true;
+}
+
+void ILITEFramework::registerOTAHandlers() {
+    ArduinoOTA.onStart(&ILITEFramework::prepareForFlashing);
+
     ArduinoOTA.onEnd([]() {
         Serial.println("\nOTA: Update complete!");
     });
 
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
-        Serial.printf("OTA: Progress: %u%%\r", (progress / (total / 100)));
+        static int lastPercent = -1;
+        const int percent = total > 0 ? static_cast<int>(progress / (total / 100 + 1)) : 0;
+        Serial.printf("OTA: Progress: %u%%\r", static_cast<unsigned>(percent));
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            ILITEFramework::getInstance().drawMaintenanceScreen(percent);
+        }
     });
 
     ArduinoOTA.onError([](ota_error_t error) {
@@ -348,233 +680,1743 @@ bool ILITEFramework::initOTA() {
         else if (error == OTA_RECEIVE_ERROR) Serial.println("Receive Failed");
         else if (error == OTA_END_ERROR) Serial.println("End Failed");
     });
-
-    ArduinoOTA.begin();
-
-    return true;
 }
 
 // ============================================================================
-// Control Loop Task (50Hz default)
+// Control Loop Task (50Hz default, up to MAX_CONTROL_LOOP_HZ)
 // ============================================================================
 
-void ILITEFramework::commTask(void* parameter) {
-    ILITEFramework* framework = static_cast<ILITEFramework*>(parameter);
-    const TickType_t period = pdMS_TO_TICKS(1000 / framework->config_.controlLoopHz);
-    TickType_t lastWakeTime = xTaskGetTickCount();
+namespace {
 
-    uint32_t lastLoopTime = millis();
+// TxWindow key of rate requests: above any command type, below kTxNoCoalesce
+constexpr uint8_t kRateRequestTxKey = 0xFE;
 
-    Serial.println("CommTask: Started");
+// Last transmitted bytes per command type, used for change-only sending.
+// Only touched from CommTask.
+struct CommandTxCache {
+    static constexpr size_t kMaxTypes = 8;
 
-    while (true) {
-        uint32_t now = millis();
-        float dt = (now - lastLoopTime) / 1000.0f;
-        lastLoopTime = now;
+    struct Entry {
+        uint8_t data[250];
+        uint8_t length;
+        bool valid;
+        uint8_t repeatsLeft;    // Unchanged resends still owed to a redundant type
+        uint32_t lastSentMs;
+    };
 
-        // Update Framework Engine (button events, encoder, etc)
-        framework->frameworkEngine_->update();
+    Entry entries[kMaxTypes];
 
-        // Get active module
-        ILITEModule* module = framework->activeModule_;
+    void reset() {
+        for (size_t i = 0; i < kMaxTypes; ++i) {
+            entries[i].valid = false;
+        }
+    }
 
-        // Update control scheme when module is loaded (even if not paired)
-        if (module != nullptr) {
-            // Read inputs
-            InputManager& inputs = InputManager::getInstance();
-            inputs.update();
+    // Returns true (and records the packet) if it changed, its keepalive
+    // expired, or a recent change still has `repeats` resends owed
+    bool shouldSend(size_t typeIndex, const uint8_t* packet, size_t length,
+                    uint32_t keepaliveMs, uint8_t repeats, uint32_t now) {
+        if (typeIndex >= kMaxTypes || length > sizeof(Entry::data)) {
+            return true;
+        }
+        Entry& entry = entries[typeIndex];
+        bool unchanged = entry.valid && entry.length == length &&
+                         memcmp(entry.data, packet, length) == 0;
+        if (unchanged && entry.repeatsLeft > 0) {
+            entry.repeatsLeft--;
+        } else if (unchanged && now - entry.lastSentMs < keepaliveMs) {
+            return false;
+        }
+        if (!unchanged) {
+            memcpy(entry.data, packet, length);
+            entry.length = static_cast<uint8_t>(length);
+            entry.valid = true;
+            entry.repeatsLeft = repeats;
+        }
+        entry.lastSentMs = now;
+        return true;
+    }
+};
+
+// Wrapped frame of a redundant command type, with room for the stamp in
+// front (CommTask only)
+uint8_t redundantFrame[kCommandStampSize + PacketBundleWriter::kMaxFrameSize];
+
+// Command-to-air latency. The timer callback stamps each release of CommTask
+// (low 32 bits of esp_timer time); the first command sent in a tick arms
+// airPendingUs with that stamp, and the ESP-NOW send callback consumes it.
+// 0 means "nothing in flight".
+std::atomic<uint32_t> tickReleaseUs(0);
+// Control timer period that alignTimerCallback() restarts it with
+std::atomic<uint32_t> alignPeriodUs(0);
+std::atomic<uint32_t> airPendingUs(0);
+uint32_t txTickReleaseUs = 0;   // CommTask only
+bool txTickArmed = false;       // CommTask only
+
+// ControlSchedule::OnTelemetry: RxTask sets the flag before its notify, so
+// CommTask can tell that wake-up from the timer's
+std::atomic<bool> telemetryTriggered(false);
+int64_t lastTriggeredUs = 0;    // CommTask only: start of the latest triggered run
+
+void armAirLatency() {
+    if (!txTickArmed) {
+        airPendingUs.store(txTickReleaseUs != 0 ? txTickReleaseUs : 1);
+        txTickArmed = true;
+    }
+}
 
-            // Call module's control loop (runs regardless of pairing for testing)
-            module->updateControl(inputs, dt);
+}  // namespace
+
+// Transmit state of one driven peer (CommTask only)
+struct ILITEFramework::PeerTxState {
+    CommandTxCache cache;
+    // History for command types with PacketDescriptor::redundancy
+    RedundantPacketWriter redundant[CommandTxCache::kMaxTypes];
+    PacketBundleWriter bundle;
+    RateRequestWriter rates;
+    CommandSchedule schedule;
+    // Command descriptors of lastModule, read once when it became active
+    PacketDescriptor commands[CommandSchedule::kMaxTypes];
+    size_t commandCount = 0;
+    // Highest-priority type: the only one a degraded tick sends
+    uint8_t safetyType = 0;
+    // prepareCommandPacket() writes at kCommandStampSize, so the stamp is
+    // put in front in place and the frame is submitted from here
+    uint8_t frame[kCommandStampSize + PacketBundleWriter::kMaxFrameSize];
+    ILITEModule* lastModule = nullptr;
+    bool lastLinked = false;
+    int64_t lastUpdateUs = 0;       ///< Last updateControl() of this peer's module
+
+    void reset() {
+        cache.reset();
+        for (RedundantPacketWriter& writer : redundant) {
+            writer.reset();
+        }
+        rates.reset();
+        schedule.reset();
+    }
 
-            // Only send command packets if paired
-            if (framework->paired_) {
-                size_t packetTypeCount = module->getCommandPacketTypeCount();
-                for (size_t i = 0; i < packetTypeCount; ++i) {
-                    PacketDescriptor desc = module->getCommandPacketDescriptor(i);
-
-                    uint8_t buffer[256];  // Max ESP-NOW packet size = 250
-                    size_t packetSize = module->prepareCommandPacket(i, buffer, sizeof(buffer));
-
-                    if (packetSize > 0 && packetSize <= desc.maxSize) {
-                        // Send via ESP-NOW
-                        const uint8_t* peerMac = framework->discovery_->getPairedMac();
-                        if (peerMac != nullptr) {
-                            esp_now_send(peerMac, buffer, packetSize);
-                            framework->packetTxCount_++;
-                        }
-                    }
-                }
+    void loadCommands(ILITEModule* module) {
+        const size_t count = module != nullptr ? module->getCommandPacketTypeCount() : 0;
+        commandCount = count < CommandSchedule::kMaxTypes ? count : CommandSchedule::kMaxTypes;
+        safetyType = 0;
+        for (size_t i = 0; i < commandCount; ++i) {
+            commands[i] = module->getCommandPacketDescriptor(i);
+            if (commands[i].priority > commands[safetyType].priority) {
+                safetyType = static_cast<uint8_t>(i);
             }
         }
+    }
+};
 
-        // Wait for next period
-        vTaskDelayUntil(&lastWakeTime, period);
+ILITEFramework::PeerTxState ILITEFramework::txStates_[1 + kMaxTeamPeers];
+
+void ILITEFramework::controlTimerCallback(void* arg) {
+    // esp_timer task context: just release CommTask for the next iteration
+    tickReleaseUs.store(static_cast<uint32_t>(esp_timer_get_time()));
+    TaskHandle_t task = static_cast<TaskHandle_t>(arg);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
     }
 }
 
-// ============================================================================
-// Display Rendering Task (10Hz default)
-// ============================================================================
+void ILITEFramework::alignTimerCallback(void* arg) {
+    // The slot start: the periodic timer counts from here
+    ILITEFramework* framework = static_cast<ILITEFramework*>(arg);
+    esp_timer_start_periodic(framework->controlTimer_, alignPeriodUs.load());
+    controlTimerCallback(framework->commTaskHandle_);
+}
 
-void ILITEFramework::displayTask(void* parameter) {
+void ILITEFramework::commTask(void* parameter) {
     ILITEFramework* framework = static_cast<ILITEFramework*>(parameter);
-    const TickType_t period = pdMS_TO_TICKS(1000 / framework->config_.displayRefreshHz);
-    TickType_t lastWakeTime = xTaskGetTickCount();
+    uint32_t tickPeriodUs = 1000000UL / framework->getControlLoopHz();
+    // One timer slot per driven peer: slot 0 is the paired peer, then the team
+    size_t slotCount = 1;
+    size_t slot = 0;
+    uint32_t periodUs = tickPeriodUs;
+    // If the timer ever stops, fall back to a slow heartbeat instead of hanging
+    const TickType_t watchdogTicks = pdMS_TO_TICKS(100);
+
+    int64_t lastLoopUs = esp_timer_get_time();
+    uint32_t lastInputUs = 0;
+    bool realigned = false;     // The last tick was re-timed; its period is no jitter sample
+    bool lastTickOverran = false;   // Counted at its end; its queued release is not counted again
+    for (PeerTxState& tx : txStates_) {
+        tx.bundle.setHeadroom(framework->config_.commandStamps ? kCommandStampSize : 0);
+        tx.reset();
+    }
 
-    Serial.println("DisplayTask: Started");
+    framework->controlStats_ = ControlLoopStats{};
+    framework->controlStats_.targetPeriodUs = periodUs;
+
+    ILITE_LOG(SYSTEM, LOG_INFO, "CommTask: Started");
 
     while (true) {
-        DisplayCanvas& canvas = *framework->displayCanvas_;
-        ILITEModule* module = framework->activeModule_;
+        // Wait for the scheduler tick; more than one pending means we missed deadlines
+        uint32_t pendingTicks = ulTaskNotifyTake(pdTRUE, watchdogTicks);
 
-        // Update and draw custom screen if active (extension system)
-        if (ScreenRegistry::hasActiveScreen()) {
-            ScreenRegistry::updateActiveScreen();
-            ScreenRegistry::drawActiveScreen(canvas);
-        } else {
-            // Use FrameworkEngine v2.0 rendering system
-            canvas.clear();
-            framework->frameworkEngine_->render(canvas);
+        // Maintenance mode: park until exitMaintenanceMode() wakes us
+        if (framework->maintenanceMode_) {
+            while (framework->maintenanceMode_) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+            lastLoopUs = esp_timer_get_time();
+            for (PeerTxState& tx : txStates_) {
+                tx.lastModule = nullptr;
+                tx.lastUpdateUs = 0;
+            }
+            // The timer restarts at the full tick; re-time it for the team
+            slotCount = 0;
+            framework->controlStatsResetPending_ = true;
+            continue;
         }
 
-        canvas.sendBuffer();
+        // A telemetry trigger is one of the notifications; on its own it
+        // runs only the module's control and transmit, off the timer grid
+        if (telemetryTriggered.exchange(false) && pendingTicks > 0 && --pendingTicks == 0) {
+            if (slotCount == 1) {
+                framework->runTelemetryTick(lastInputUs);
+            }
+            continue;
+        }
 
-        // Wait for next period
-        vTaskDelayUntil(&lastWakeTime, period);
-    }
-}
+        // Woken by the watchdog timeout instead of the timer while paired
+        if (pendingTicks == 0 && framework->paired_) {
+            BlackBox::trigger(BlackBoxTrigger::Watchdog);
+        }
 
-// ============================================================================
-// Main Loop Update
-// ============================================================================
+        // The modules driven this tick stay active until the tick ends
+        ModulePin pin(ModuleHandoff::Reader::Comm);
+
+        // A team change re-times the timer so every peer's sends get their
+        // own slot of the tick instead of leaving in one burst. So does a
+        // rate change (pairing while unpaired runs slower).
+        const size_t teamCount = framework->getTeamPeerCount();
+        const uint32_t wantedPeriodUs = 1000000UL / framework->getControlLoopHz();
+        if (1 + teamCount != slotCount || wantedPeriodUs != tickPeriodUs) {
+            tickPeriodUs = wantedPeriodUs;
+            slotCount = 1 + teamCount;
+            slot = 0;
+            periodUs = tickPeriodUs / slotCount;
+            if (framework->alignTimer_ != nullptr) {
+                esp_timer_stop(framework->alignTimer_);
+            }
+            if (framework->controlTimer_ != nullptr) {
+                esp_timer_stop(framework->controlTimer_);
+                esp_timer_start_periodic(framework->controlTimer_, periodUs);
+            }
+            framework->controlStatsResetPending_ = true;
+        }
 
-void ILITEFramework::update() {
-    if (!initialized_) {
-        return;
-    }
+        int64_t loopStartUs = esp_timer_get_time();
+        uint32_t elapsedUs = static_cast<uint32_t>(loopStartUs - lastLoopUs);
+        lastLoopUs = loopStartUs;
+        uint32_t now = millis();
+        const uint32_t tickCycles = Profiler::cycles();
+        // A control tick must not touch the heap (checked in ILITE_HEAP_PROFILE builds)
+        ILITE_NO_ALLOC();
+        txTickReleaseUs = tickReleaseUs.load();
+        txTickArmed = false;
+
+        ControlLoopStats& stats = framework->controlStats_;
+        ControlDeadline::beginTick(periodUs, loopStartUs, pendingTicks > 1 ? pendingTicks - 1 : 0);
+        if (framework->controlStatsResetPending_) {
+            stats = ControlLoopStats{};
+            stats.targetPeriodUs = periodUs;
+            ControlDeadline::reset();
+            framework->controlStatsResetPending_ = false;
+        } else if (realigned) {
+            realigned = false;
+        } else {
+            uint32_t jitterUs = elapsedUs > periodUs ? elapsedUs - periodUs : periodUs - elapsedUs;
+            stats.lastPeriodUs = elapsedUs;
+            stats.lastJitterUs = jitterUs;
+            if (jitterUs > stats.maxJitterUs) {
+                stats.maxJitterUs = jitterUs;
+            }
+            if (pendingTicks > 1) {
+                stats.overrunCount += pendingTicks - (lastTickOverran ? 2 : 1);
+            }
+        }
+        lastTickOverran = false;
+        stats.iterations++;
+
+        // TDMA: keep the paired peer's tick at this controller's slot start.
+        // The next wake is one timer period after the slot start; a late
+        // tick too close to it waits one more superframe.
+        if (slot == 0 && framework->alignTimer_ != nullptr && TdmaSlots::isEnabled()) {
+            const int32_t errorUs = TdmaSlots::onTick(*framework->discovery_, loopStartUs, tickPeriodUs);
+            if (errorUs > TdmaSlots::kToleranceUs || errorUs < -TdmaSlots::kToleranceUs) {
+                int64_t delayUs = loopStartUs - errorUs + periodUs - esp_timer_get_time();
+                if (delayUs < static_cast<int64_t>(periodUs) / 4) {
+                    delayUs += tickPeriodUs;
+                }
+                alignPeriodUs.store(periodUs);
+                esp_timer_stop(framework->controlTimer_);
+                esp_timer_start_once(framework->alignTimer_, static_cast<uint64_t>(delayUs));
+                TdmaSlots::onRealigned();
+                realigned = true;
+            }
+        }
 
-    // Update input manager for button edge detection
-    InputManager::getInstance().update();
+        // Inputs, idle tracking and the UI run once per control tick, in
+        // slot 0; the team slots that follow reuse the same snapshot
+        // (CommTask is the only writer)
+        InputManager& inputs = InputManager::getInstance();
+        float replayDt = 0.0f;
+        if (slot == 0) {
+            if (InputReplay::isActive()) {
+                InputSnapshot recorded;
+                if (!InputReplay::nextTick(recorded, replayDt)) {
+                    continue;   // Held until the host's next snapshot arrives
+                }
+                inputs.replay(recorded);
+            } else {
+                inputs.update();
+            }
+            const uint32_t inputUs = static_cast<uint32_t>(esp_timer_get_time());
+            lastInputUs = inputUs;
+            if (TrainerLink::isActive() && !InputReplay::isActive()) {
+                // Trainer link: send ours, or merge the trainee's before any module reads it
+                InputSnapshot merged = inputs.getSnapshot();
+                TrainerLink::onInput(merged, inputUs);
+                if (TrainerLink::merge(merged, inputUs, tickPeriodUs)) {
+                    inputs.replay(merged);
+                }
+            }
+            const bool tapInput = TelemetryTap::isEnabled() && !ControlDeadline::isDegraded();
+            if (tapInput || BlackBox::isRecording()) {
+                uint8_t encoded[InputReplay::kSnapshotSize];
+                InputReplay::encodeSnapshot(inputs.getSnapshot(), encoded);
+                if (tapInput) {
+                    TelemetryTap::onInput(InputReplay::kFormatVersion, encoded, sizeof(encoded), inputUs);
+                }
+                BlackBox::onInput(InputReplay::kFormatVersion, encoded, sizeof(encoded), inputUs);
+            }
+            BlackBox::checkChord(inputs.getSnapshot().debounced, now);
 
-    if (moduleChangePending_) {
-        ILITEModule* requested = pendingModule_;
-        pendingModule_ = nullptr;
-        moduleChangePending_ = false;
-        if (requested != activeModule_) {
-            setActiveModule(requested);
+            // Idle tracking; waking up redraws at once instead of at the idle rate
+            if (PowerManager::update(inputs.getSnapshot(), framework->paired_, now) &&
+                !PowerManager::isIdle()) {
+                RenderScheduler::invalidate(RenderReason::Input);
+            }
+            ControlDeadline::endStage(ControlStage::Input);
+
+            // Update Framework Engine (button events, encoder, etc). A degraded
+            // tick runs the UI hooks, and redraws, only now and then.
+            if (ControlDeadline::runsUi()) {
+                // A paired dashboard shows live control and telemetry values
+                if (framework->paired_) {
+                    RenderScheduler::invalidate(RenderReason::Data);
+                }
+                framework->frameworkEngine_->update();
+                ControlDeadline::endStage(ControlStage::Ui);
+            } else {
+                ControlDeadline::skipStage(ControlStage::Ui);
+            }
+        }
+        const uint32_t inputUs = lastInputUs;
+
+        // This slot's module and the peer it drives (nullptr = not linked)
+        size_t txSlot = 0;
+        ILITEModule* module = nullptr;
+        const uint8_t* peerMac = nullptr;
+        if (slot == 0 && SerialBridge::isActive()) {
+            // The PC supplies the paired robot's commands; a full frame follows the bridge
+            txStates_[0].lastModule = nullptr;
+        } else if (slot == 0) {
+            // Update control scheme when module is loaded (even if not paired)
+            module = pin.get();
+            if (framework->paired_) {
+                peerMac = framework->discovery_->getPairedMac();
+            }
+        } else {
+            // The (slot)th team peer in use
+            size_t seen = 0;
+            for (size_t i = 0; i < kMaxTeamPeers; ++i) {
+                const TeamPeer& peer = framework->teamPeers_[i];
+                ILITEModule* teamModule = peer.module;
+                if (teamModule != nullptr && ++seen == slot) {
+                    txSlot = i + 1;
+                    module = teamModule;
+                    peerMac = peer.mac;
+                    break;
+                }
+            }
         }
-    }
 
-    // Handle OTA updates
-    if (config_.enableOTA) {
-        handleOTA();
-    }
+        // A triggered run just served the paired peer; the timer is its floor
+        const bool triggeredRecently = txSlot == 0 && lastTriggeredUs != 0 &&
+                                       loopStartUs - lastTriggeredUs < static_cast<int64_t>(periodUs / 2);
 
-    // Handle discovery protocol
-    if (config_.enableDiscovery) {
-        handleDiscovery();
-    }
+        if (module != nullptr && triggeredRecently && module == txStates_[0].lastModule) {
+            ControlDeadline::skipStage(ControlStage::Control);
+        } else if (module != nullptr) {
+            PeerTxState& tx = txStates_[txSlot];
+            if (tx.lastUpdateUs == 0 || module != tx.lastModule) {
+                tx.lastUpdateUs = loopStartUs - tickPeriodUs;
+            }
+            // A degraded tick may leave out an overrunning updateControl();
+            // the next call's dt covers the skipped tick
+            if (ControlDeadline::runsControl() || module != tx.lastModule) {
+                float dt = static_cast<uint32_t>(loopStartUs - tx.lastUpdateUs) / 1000000.0f;
+                tx.lastUpdateUs = loopStartUs;
+                if (replayDt > 0.0f && txSlot == 0) {
+                    dt = replayDt;
+                }
 
-    // Handle pairing state
-    handlePairing();
+                // Call module's control loop (runs regardless of pairing for testing)
+                {
+                    ILITE_PROFILE(ProfileZone::UpdateControl);
+                    ILITE_LATENCY_SPAN(Control);
+                    ModuleCall call(module, ModuleCallback::Control);
+                    module->updateControl(inputs, dt);
+                }
+                ControlDeadline::endStage(ControlStage::Control);
+            } else {
+                ControlDeadline::skipStage(ControlStage::Control);
+            }
 
-    // Handle connection timeout
-    if (paired_) {
-        handleConnectionTimeout();
+            framework->transmitCommands(txSlot, module, peerMac, now, inputUs);
+        } else {
+            ControlDeadline::endStage(ControlStage::Control);
+        }
+        // Frames held for the window go out after this tick's newer ones
+        TxWindow::pump(2 * tickPeriodUs);
+        ControlDeadline::endStage(ControlStage::Transmit);
+        ControlDeadline::endTick(now);
+        slot = (slot + 1) % slotCount;
+
+        uint32_t execUs = static_cast<uint32_t>(esp_timer_get_time() - loopStartUs);
+        stats.lastExecUs = execUs;
+        if (execUs > stats.maxExecUs) {
+            stats.maxExecUs = execUs;
+        }
+        if (execUs > periodUs) {
+            stats.overrunCount++;
+            lastTickOverran = true;
+        }
+        Profiler::record(ProfileZone::CommTick, Profiler::cycles() - tickCycles);
     }
+}
 
-    // Update control bindings (extension system)
-    ControlBindingSystem::update();
+void ILITEFramework::runTelemetryTick(uint32_t inputUs) {
+    // The timer tick sets up modules and links; this only repeats its
+    // control and transmit steps for the paired peer
+    ModulePin pin(ModuleHandoff::Reader::Comm);
+    ILITEModule* module = pin.get();
+    PeerTxState& tx = txStates_[0];
+    if (module == nullptr || !paired_ || module != tx.lastModule || !tx.lastLinked ||
+        tx.lastUpdateUs == 0 || SerialBridge::isActive() || InputReplay::isActive() ||
+        TdmaSlots::isEnabled() || ControlDeadline::isDegraded() ||
+        module->getControlSchedule() != ControlSchedule::OnTelemetry) {
+        return;
+    }
 
-    // Update audio feedback
-    if (config_.enableAudio) {
-        audioUpdate();
+    ILITE_NO_ALLOC();
+    const int64_t startUs = esp_timer_get_time();
+    const float dt = static_cast<uint32_t>(startUs - tx.lastUpdateUs) / 1000000.0f;
+    tx.lastUpdateUs = startUs;
+    lastTriggeredUs = startUs;
+    txTickReleaseUs = static_cast<uint32_t>(startUs);
+    txTickArmed = false;
+    {
+        ILITE_PROFILE(ProfileZone::UpdateControl);
+        ILITE_LATENCY_SPAN(Control);
+        ModuleCall call(module, ModuleCallback::Control);
+        module->updateControl(InputManager::getInstance(), dt);
     }
+    transmitCommands(0, module, discovery_->getPairedMac(), millis(), inputUs);
+    controlStats_.telemetryTicks++;
 }
 
-// ============================================================================
-// Runtime Helpers
-// ============================================================================
-
-void ILITEFramework::handleOTA() {
-    ArduinoOTA.handle();
-}
+void ILITEFramework::transmitCommands(size_t txSlot, ILITEModule* module, const uint8_t* peerMac,
+                                      uint32_t now, uint32_t inputUs) {
+    PeerTxState& tx = txStates_[txSlot];
 
-void ILITEFramework::handleDiscovery() {
-    discovery.discover();
-}
+    // A new module or a fresh link always gets a full first frame
+    const bool linked = peerMac != nullptr;
+    if (module != tx.lastModule || linked != tx.lastLinked) {
+        tx.reset();
+        if (module != tx.lastModule) {
+            tx.loadCommands(module);
+        }
+        tx.lastModule = module;
+        tx.lastLinked = linked;
+    }
+    // A replay without a robot still builds the packets to compare them
+    const bool replaying = txSlot == 0 && InputReplay::isActive();
+    if (!linked && !replaying) {
+        return;
+    }
 
-void ILITEFramework::handlePairing() {
-    // Check if we just became paired
-    if (discovery.isPaired() && !paired_) {
-        paired_ = true;
-        frameworkEngine_->setPaired(true);  // Sync with FrameworkEngine
-        lastTelemetryTime_ = millis();
+    const uint32_t framesBefore = packetTxCount_;
+    // Scheduled types in priority order, then any beyond the schedule every
+    // tick. A degraded tick sends the safety type alone, every tick.
+    const bool degraded = ControlDeadline::isDegraded();
+    uint8_t due[CommandSchedule::kMaxTypes];
+    size_t dueCount = 0;
+    size_t unscheduled = 0;
+    if (degraded) {
+        due[0] = tx.safetyType;
+        dueCount = tx.commandCount > 0 ? 1 : 0;
+    } else {
+        dueCount = tx.schedule.plan(tx.commands, tx.commandCount,
+                                    static_cast<uint32_t>(esp_timer_get_time()),
+                                    1000000UL / getControlLoopHz(), due);
+        const size_t packetTypeCount = module->getCommandPacketTypeCount();
+        unscheduled = packetTypeCount > CommandSchedule::kMaxTypes
+            ? packetTypeCount - CommandSchedule::kMaxTypes : 0;
+    }
+    uint8_t* const buffer = tx.frame + kCommandStampSize;
+    const size_t bufferSize = sizeof(tx.frame) - kCommandStampSize;
+    for (size_t n = 0; n < dueCount + unscheduled; ++n) {
+        const size_t i = n < dueCount ? due[n] : CommandSchedule::kMaxTypes + (n - dueCount);
+        // Types past the cache are rare enough to ask for each tick
+        const PacketDescriptor desc = i < tx.commandCount
+            ? tx.commands[i] : module->getCommandPacketDescriptor(i);
+
+        size_t packetSize;
+        {
+            ILITE_PROFILE_ACCUMULATE(ProfileZone::PrepareCommand);
+            ILITE_LATENCY_SPAN(Prepare);
+            ModuleCall call(module, ModuleCallback::Prepare);
+            packetSize = module->prepareCommandPacket(i, buffer, bufferSize);
+        }
+        tx.schedule.onBuilt(i);
 
-        const Identity* peerIdentity = discovery.getPairedIdentity();
-        if (peerIdentity != nullptr) {
-            Logger::getInstance().logf("Paired with: %s", peerIdentity->customId);
+        if (packetSize == 0 || packetSize > desc.maxSize) {
+            continue;
+        }
 
-            // Try to find matching module by keywords
-            ILITEModule* matchedModule = ModuleRegistry::findModuleByName(peerIdentity->customId);
+        // Robots that predate REDN frames get the plain packet
+        const uint8_t redundancy = config_.redundantCommands ? desc.redundancy : 0;
+
+        // Change-only for types that set a keepalive, or for all with the config flag
+        if ((config_.changeOnlyCommands || desc.keepaliveMs != 0) && !degraded) {
+            uint32_t keepaliveMs = desc.keepaliveMs != 0
+                ? desc.keepaliveMs : config_.commandKeepaliveMs;
+            if (!tx.cache.shouldSend(i, buffer, packetSize, keepaliveMs,
+                                     redundancy, now)) {
+                packetSkippedCount_++;
+                continue;
+            }
+        }
 
-            if (matchedModule != nullptr) {
-                setActiveModule(matchedModule);
-                Logger::getInstance().logf("Auto-selected module: %s",
-                                          matchedModule->getModuleName());
-            } else {
-                Logger::getInstance().log("No matching module found for device");
+        // The tap and the black box describe the active module only
+        if (txSlot == 0) {
+            BlackBox::onCommand(static_cast<uint8_t>(i), buffer, packetSize,
+                                static_cast<uint32_t>(esp_timer_get_time()));
+        }
+        if (txSlot == 0 && !degraded) {
+            TelemetryTap::onCommand(static_cast<uint8_t>(i), buffer, packetSize,
+                                    static_cast<uint32_t>(esp_timer_get_time()));
+            if (replaying) {
+                InputReplay::onCommand(static_cast<uint8_t>(i), buffer, packetSize, inputUs);
+            }
+        }
+        if (!linked) {
+            continue;
+        }
+        tx.schedule.onSent(i);
+
+        uint8_t* packet = buffer;
+        if (redundancy > 0 && i < CommandTxCache::kMaxTypes) {
+            // Piggyback the previous versions; plain if it cannot be wrapped
+            size_t wrappedSize = tx.redundant[i].wrap(buffer, packetSize, redundancy,
+                                                      redundantFrame + kCommandStampSize,
+                                                      sizeof(redundantFrame) - kCommandStampSize);
+            if (wrappedSize > 0) {
+                packet = redundantFrame + kCommandStampSize;
+                packetSize = wrappedSize;
             }
+        }
 
-            if (config_.enableAudio) {
-                audioFeedback(AudioCue::PeerAcknowledge);
+        if (desc.bundleable) {
+            // Pack with the other bundleable types; flush if full
+            if (!tx.bundle.fits(packetSize)) {
+                flushCommandBundle(tx.bundle, peerMac, inputUs);
+            }
+            if (tx.bundle.append(packet, packetSize)) {
+                continue;
             }
+            // Too large to bundle at all - fall through and send alone
         }
-    }
 
-    // Check if we just became unpaired
-    if (!discovery.isPaired() && paired_) {
-        Logger::getInstance().log("Unpaired from device");
-        unpair();
+        // Send via ESP-NOW, straight from the frame it was built in
+        sendCommandFrame(peerMac, static_cast<uint8_t>(i), packet, packetSize, inputUs,
+                         kCommandStampSize);
+    }
+    flushCommandBundle(tx.bundle, peerMac, inputUs);
+    if (linked && !degraded) {
+        sendRateRequest(tx.rates, module, peerMac, now, inputUs, txSlot == 0);
     }
+    Profiler::commit(ProfileZone::PrepareCommand);
+    txFrames_[txSlot] += packetTxCount_ - framesBefore;
 }
 
-void ILITEFramework::handleConnectionTimeout() {
-    // Automatic disconnects are disabled; users can unpair via the devices menu.
+void ILITEFramework::sendRateRequest(RateRequestWriter& rates, ILITEModule* module,
+                                     const uint8_t* peerMac, uint32_t now, uint32_t inputUs,
+                                     bool primary) {
+    const size_t count = module->getTelemetryPacketTypeCount();
+    rates.setCount(count);
+    for (size_t i = 0; i < count && i < RateRequestWriter::kMaxEntries; ++i) {
+        rates.set(i, module->getTelemetryPacketDescriptor(i).magicNumber,
+                  module->getTelemetryRequestHz(i));
+    }
+
+    uint8_t frame[RateRequestWriter::kMaxFrameSize];
+    const size_t length = rates.poll(now, frame, sizeof(frame));
+    if (length > 0) {
+        sendCommandFrame(peerMac, kRateRequestTxKey, frame, length, inputUs);
+        // A changed rate makes the measured interval meaningless
+        for (size_t i = 0; primary && i < count && i < RateRequestWriter::kMaxEntries; ++i) {
+            TelemetryHealth::onRateRequested(i, rates.getIntervalMs(i));
+        }
+    }
 }
 
-void ILITEFramework::onTelemetryReceived(ILITEModule* module) {
-    // Update telemetry timestamp to prevent timeout
-    lastTelemetryTime_ = millis();
+void ILITEFramework::flushCommandBundle(PacketBundleWriter& bundle, const uint8_t* peerMac,
+                                        uint32_t inputUs) {
+    if (bundle.isEmpty()) {
+        return;
+    }
 
-    // Update packet count
-    packetRxCount_++;
+    // Bundles carry a different set of types each tick, so they are never coalesced
+    if (bundle.getCount() == 1) {
+        // Nothing to share the frame with; send the packet unframed
+        size_t length = 0;
+        const uint8_t* packet = bundle.firstPacket(length);
+        sendCommandFrame(peerMac, kTxNoCoalesce, packet, length, inputUs);
+    } else {
+        sendCommandFrame(peerMac, kTxNoCoalesce, bundle.data(), bundle.size(), inputUs);
+    }
+    bundle.reset();
 }
 
-// ============================================================================
-// Module Management
-// ============================================================================
+void ILITEFramework::sendCommandFrame(const uint8_t* peerMac, uint8_t key, const uint8_t* data,
+                                      size_t length, uint32_t inputUs, size_t headroom) {
+    // A robot taking new firmware gets the airtime to itself
+    if (FirmwareRelay::isTarget(peerMac)) {
+        return;
+    }
 
-void ILITEFramework::setActiveModule(ILITEModule* module) {
-    // Deactivate previous module
-    if (previousModule_ != nullptr && previousModule_ != module) {
-        previousModule_->onDeactivate();
-        Logger::getInstance().logf("Deactivated: %s", previousModule_->getModuleName());
+    // Air latency follows the paired peer only
+    if (EspNowDiscovery::macEqual(peerMac, discovery_->getPairedMac())) {
+        armAirLatency();
     }
 
-    // Set new active module
-    activeModule_ = module;
-    previousModule_ = activeModule_;
+    // Frames that would overflow with the stamp go out plain rather than not at all
+    bool accepted;
+    if (config_.commandStamps && headroom >= kCommandStampSize &&
+        length + kCommandStampSize <= PacketBundleWriter::kMaxFrameSize) {
+        // The caller's frame has the stamp's bytes in front of the packet
+        uint8_t* stamped = const_cast<uint8_t*>(data) - kCommandStampSize;
+        const CommandStampHeader header = CommandLatency::nextStamp(inputUs);
+        memcpy(stamped, &header, kCommandStampSize);
+        accepted = TxWindow::submit(peerMac, key, stamped, length + kCommandStampSize);
+    } else if (config_.commandStamps &&
+               length + kCommandStampSize <= PacketBundleWriter::kMaxFrameSize) {
+        uint8_t stamped[PacketBundleWriter::kMaxFrameSize];
+        const size_t stampedLength = writeStampedFrame(stamped, sizeof(stamped),
+                                                       CommandLatency::nextStamp(inputUs),
+                                                       data, length);
+        accepted = TxWindow::submit(peerMac, key, stamped, stampedLength);
+    } else {
+        accepted = TxWindow::submit(peerMac, key, data, length);
+    }
+    if (!accepted) {
+        return;
+    }
+    if (packetTxCount_++ == 0) {
+        firstCommandMs_ = millis();
+    }
+}
+
+void ILITEFramework::onEspNowSent(const uint8_t* mac, esp_now_send_status_t status) {
+    // WiFi task context; every destination feeds the link statistics
+    ILITE_LATENCY_SEND_DONE();
+    LinkMetrics::onSendStatus(mac, status == ESP_NOW_SEND_SUCCESS);
+    TxWindow::onSendComplete(mac);
+    FirmwareRelay::onSendComplete(mac, status == ESP_NOW_SEND_SUCCESS);
+    SerialBridge::onSendComplete(mac, status == ESP_NOW_SEND_SUCCESS);
+
+    // Only command packets to the paired peer are measured for air latency
+    ILITEFramework* framework = instance_;
+    if (framework == nullptr || mac == nullptr ||
+        !EspNowDiscovery::macEqual(mac, discovery.getPairedMac())) {
+        return;
+    }
+
+    RadioLatencyStats& stats = framework->radioStats_;
+    if (framework->radioStatsResetPending_) {
+        stats = RadioLatencyStats{};
+        framework->radioStatsResetPending_ = false;
+    }
+
+    const uint32_t releaseUs = airPendingUs.exchange(0);
+    if (status != ESP_NOW_SEND_SUCCESS) {
+        stats.failures++;
+        return;
+    }
+    if (releaseUs == 0) {
+        return;
+    }
+
+    const uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time()) - releaseUs;
+    stats.lastUs = latencyUs;
+    if (stats.samples == 0 || latencyUs < stats.minUs) {
+        stats.minUs = latencyUs;
+    }
+    if (latencyUs > stats.maxUs) {
+        stats.maxUs = latencyUs;
+    }
+    stats.avgUs = stats.samples == 0
+        ? latencyUs
+        : static_cast<uint32_t>((static_cast<int64_t>(stats.avgUs) * 15 + latencyUs) / 16);
+    stats.samples++;
+}
+
+// ============================================================================
+// Receive Consumer Task
+// ============================================================================
+
+namespace {
+
+constexpr size_t kRxBatchSize = 8;
+
+// Set when pairing matched no module by name: the paired peer's telemetry
+// then picks one by magic (ModuleRegistry::findModuleByMagic). Cleared once
+// a module is posted, selected by hand, or the link drops.
+std::atomic<bool> moduleDetectArmed(false);
+
+// Magic of the first packet a telemetry frame carries (0 if none)
+uint32_t firstTelemetryMagic(const uint8_t* data, size_t length) {
+    CommandStampHeader echo;
+    size_t innerLength = 0;
+    const uint8_t* inner = unwrapStampedFrame(data, length, ECHO_PACKET_MAGIC, echo, innerLength);
+    if (inner != nullptr) {
+        data = inner;
+        length = innerLength;
+    }
+
+    if (isPacketBundle(data, length)) {
+        uint32_t magic = 0;
+        forEachBundledPacket(data, length,
+            [](const uint8_t* packet, size_t packetLength, void* ctx) {
+                uint32_t* first = static_cast<uint32_t*>(ctx);
+                if (*first == 0 && packetLength >= sizeof(uint32_t)) {
+                    memcpy(first, packet, sizeof(uint32_t));
+                }
+            },
+            &magic);
+        return magic;
+    }
+
+    if (length < sizeof(uint32_t)) {
+        return 0;
+    }
+    if (isDeltaPacket(data, length)) {
+        return deltaPacketInnerMagic(data);
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    return magic;
+}
+
+// RxTask: the router had no route for this frame; if its magic belongs to
+// another module, hand that module to ServiceTask
+void detectModule(const RxFrame& frame) {
+    const uint32_t magic = firstTelemetryMagic(frame.data, frame.length);
+    ILITEModule* module = magic != 0 ? ModuleRegistry::findModuleByMagic(magic) : nullptr;
+    if (module == nullptr || module == PacketRouter::getInstance().getActiveModule()) {
+        return;
+    }
+
+    const ModuleList& modules = ModuleRegistry::getModules();
+    for (size_t i = 0; i < modules.size(); ++i) {
+        if (modules[i] == module && moduleDetectArmed.exchange(false)) {
+            if (!FrameworkEvents::postModuleSeen(frame.mac, static_cast<uint8_t>(i))) {
+                moduleDetectArmed.store(true);  // Queue full: try the next frame
+            }
+            return;
+        }
+    }
+}
+
+// Frames that are not discovery protocol packets are telemetry; only accept
+// them from the peer we are paired with or a team peer.
+void routeTelemetryFrame(const RxFrame& frame) {
+    // Group ACKs come from any member robot, paired or not
+    if (GroupCommand::onFrame(frame.mac, frame.data, frame.length)) {
+        return;
+    }
+    if (FirmwareRelay::onFrame(frame.mac, frame.data, frame.length)) {
+        return;
+    }
+    if (TrainerLink::onFrame(frame.mac, frame.data, frame.length, frame.timestampUs)) {
+        return;
+    }
+    const bool fromPaired = discovery.isPaired() &&
+                            EspNowDiscovery::macEqual(frame.mac, discovery.getPairedMac());
+    if (!fromPaired && !discovery.isTeamLink(frame.mac)) {
+        return;
+    }
+    if (fromPaired) {
+        SerialBridge::onTelemetry(frame.mac, frame.data, frame.length, frame.timestampUs);
+    }
+    const bool routed = PacketRouter::getInstance().routePacket(frame.mac, frame.data, frame.length,
+                                                                frame.timestampUs);
+    if (!routed && fromPaired && moduleDetectArmed.load(std::memory_order_relaxed)) {
+        detectModule(frame);
+    }
+}
+
+}  // namespace
+
+void ILITEFramework::rxTask(void* parameter) {
+    ILITEFramework* framework = static_cast<ILITEFramework*>(parameter);
+
+    ILITE_LOG(SYSTEM, LOG_INFO, "RxTask: Started");
+
+    while (true) {
+        // Woken by the ESP-NOW callback; the timeout is only a safety net
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+        for (;;) {
+            size_t drained;
+            {
+                // Pinned per batch, so a module switch waits one batch at most
+                ModulePin pin(ModuleHandoff::Reader::Rx);
+                drained = framework->discovery_->drainReceived(kRxBatchSize, routeTelemetryFrame);
+            }
+            if (drained < kRxBatchSize) {
+                break;
+            }
+            taskYIELD();
+        }
+    }
+}
+
+// ============================================================================
+// Display Rendering Task (10Hz default)
+// ============================================================================
+
+void ILITEFramework::displayTask(void* parameter) {
+    ILITEFramework* framework = static_cast<ILITEFramework*>(parameter);
+    uint8_t contrast = framework->config_.displayContrast;
+
+    ILITE_LOG(SYSTEM, LOG_INFO, "DisplayTask: Started");
+
+    while (true) {
+        // Maintenance mode: show the OTA screen and park until woken
+        if (framework->maintenanceMode_) {
+            framework->displayParked_ = true;
+            framework->drawMaintenanceScreen(-1);
+            while (framework->maintenanceMode_) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+            framework->displayParked_ = false;
+            framework->frameworkEngine_->invalidateDashboard();
+        }
+
+        // Serial bridge: the CPU goes to the bridge, a static screen once a second
+        if (SerialBridge::isActive()) {
+            SerialBridge::drawScreen(*framework->displayCanvas_);
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            if (!SerialBridge::isActive()) {
+                framework->frameworkEngine_->invalidateDashboard();
+            }
+            continue;
+        }
+
+        DisplayCanvas& canvas = *framework->displayCanvas_;
+
+        // Bus benchmark: blocks this task for a few seconds, the rest keeps running
+        if (framework->displayBenchRequested_) {
+            framework->displayBenchRequested_ = false;
+            DisplayBus::benchmark(canvas, Serial);
+            framework->frameworkEngine_->invalidateDashboard();
+        }
+        const bool idle = framework->config_.powerManagement && PowerManager::isIdle();
+        const uint8_t wantedContrast = idle ? framework->config_.idleContrast
+                                            : framework->config_.displayContrast;
+        if (wantedContrast != contrast) {
+            contrast = wantedContrast;
+            canvas.setContrast(contrast);
+        }
+        const uint32_t frameCycles = Profiler::cycles();
+        ILITE_NO_ALLOC();
+        Animator::beginFrame(millis());
+
+        {
+            // A module switch waits for this frame before deactivating what it draws
+            ModulePin pin(ModuleHandoff::Reader::Display);
+
+            // Update and draw custom screen if active (extension system).
+            // One pass per frame; page-buffer builds draw it once per band.
+            if (ScreenRegistry::hasActiveScreen()) {
+                ScreenRegistry::updateActiveScreen();
+                canvas.firstPage();
+                do {
+                    ScreenRegistry::drawActiveScreen(canvas);
+                } while (canvas.nextPage());
+                framework->frameworkEngine_->invalidateDashboard();
+                // Custom screens animate without posting; keep them at the data rate
+                RenderScheduler::invalidate(RenderReason::Data);
+            } else {
+                // FrameworkEngine clears (or keeps a retained dashboard) itself
+                canvas.firstPage();
+                do {
+                    framework->frameworkEngine_->render(canvas);
+                } while (canvas.nextPage());
+            }
+        }
+
+        Profiler::record(ProfileZone::DisplayFrame, Profiler::cycles() - frameCycles);
+
+        // Something drawn this frame is still moving: come back at the input rate
+        if (Animator::endFrame()) {
+            RenderScheduler::invalidate(RenderReason::Animation);
+        }
+
+        // Sleep until something asks for a frame, or the floor period ends
+        RenderScheduler::waitForFrame((idle && framework->config_.idleDisplayHz > 0)
+                                          ? framework->config_.idleDisplayHz
+                                          : framework->config_.displayFloorHz);
+    }
+}
+
+// ============================================================================
+// Main Loop Update
+// ============================================================================
+
+void ILITEFramework::update() {
+    if (!initialized_) {
+        return;
+    }
+
+    if (serviceTaskHandle_ != nullptr) {
+        // ServiceTask owns the housekeeping; don't let loop() spin on core 1
+        vTaskDelay(pdMS_TO_TICKS(kLoopYieldMs));
+        return;
+    }
+
+    runServiceJobs(millis());
+}
+
+// ============================================================================
+// Service Task
+// ============================================================================
+
+namespace {
+
+// Fixed-period job slot for the service loop
+struct ServiceJob {
+    uint32_t periodMs;
+    uint32_t lastRunMs;
+
+    bool due(uint32_t now) {
+        if (now - lastRunMs < periodMs) {
+            return false;
+        }
+        lastRunMs = now;
+        return true;
+    }
+};
+
+ServiceJob moduleJob = {10, 0};
+ServiceJob bindingJob = {10, 0};
+ServiceJob audioJob = {10, 0};
+ServiceJob pairingJob = {20, 0};
+ServiceJob serialJob = {20, 0};
+ServiceJob otaJob = {50, 0};
+ServiceJob discoveryJob = {100, 0};
+ServiceJob monitorJob = {100, 0};
+ServiceJob logSummaryJob = {5000, 0};
+ServiceJob configJob = {5000, 0};
+ServiceJob deferredInitJob = {50, 0};
+ServiceJob maintenanceJob = {10, 0};
+ServiceJob moduleServiceJob = {10, 0};
+ServiceJob teamJob = {1000, 0};
+ServiceJob eventLogJob = {1000, 0};
+ServiceJob blackBoxJob = {BlackBox::kLinkSampleMs, 0};
+ServiceJob heapJob = {1000, 0};
+
+}  // namespace
+
+bool ILITEFramework::startServiceTask() {
+    const TaskPlacement placement = getTaskLayout(config_.taskProfile).service;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        serviceTask,                       // Task function
+        "ServiceTask",                     // Name
+        kServiceTaskStackSize,             // Stack size
+        this,                              // Parameter (this instance)
+        placement.priority,                // Priority (low)
+        &serviceTaskHandle_,               // Handle
+        placement.core                     // Core
+    );
+
+    if (result != pdPASS) {
+        serviceTaskHandle_ = nullptr;
+        return false;
+    }
+
+    TaskMonitor::watch(serviceTaskHandle_, kServiceTaskStackSize, placement.core);
+    return true;
+}
+
+void ILITEFramework::serviceTask(void* parameter) {
+    ILITEFramework* framework = static_cast<ILITEFramework*>(parameter);
+    TickType_t lastWake = xTaskGetTickCount();
+    const TickType_t period = pdMS_TO_TICKS(kServiceTickMs) > 0 ? pdMS_TO_TICKS(kServiceTickMs) : 1;
+
+    while (true) {
+        framework->runServiceJobs(millis());
+        vTaskDelayUntil(&lastWake, period);
+    }
+}
+
+void ILITEFramework::runServiceJobs(uint32_t now) {
+    // CommTask captures input snapshots; only poll here if it never started or is parked
+    if (commTaskHandle_ == nullptr || maintenanceMode_) {
+        InputManager::getInstance().update();
+    }
+
+    // Maintenance mode switches requested by the menu or console
+    if (maintenanceJob.due(now)) {
+        if (maintenanceMode_ && InputManager::getInstance().getEncoderButtonPressed()) {
+            maintenanceRequested_ = false;
+        }
+        if (maintenanceRequested_ && !maintenanceMode_) {
+            enterMaintenanceMode();
+        } else if (!maintenanceRequested_ && maintenanceMode_) {
+            exitMaintenanceMode();
+        }
+    }
+
+    ILITEModule* requested = nullptr;
+    if (moduleJob.due(now) && ModuleHandoff::takeRequest(requested) && requested != activeModule_) {
+        setActiveModule(requested);
+    }
+
+    // Fast boot: the boot timing once commands flow
+    if (deferredInitPending_ && deferredInitJob.due(now) &&
+        (packetTxCount_ > 0 || now - bootTime_ >= kDeferredInitTimeoutMs)) {
+        finishDeferredInit();
+    }
+
+    // Handle OTA updates
+    if (otaJob.due(now) && maintenanceMode_) {
+        handleOTA();
+    }
+
+    // Handle discovery protocol
+    if (discoveryJob.due(now) && config_.enableDiscovery) {
+        handleDiscovery();
+    }
+
+    // Events from the receive path; a finished handshake is handled at once
+    bool pairStateChanged = false;
+    FrameworkEvent event;
+    for (uint32_t i = 0; i < FrameworkEvents::kQueueSize && FrameworkEvents::pop(event); ++i) {
+        switch (event.type) {
+            case FrameworkEventType::PeerSeen:
+                RenderScheduler::invalidate(RenderReason::Data);
+                break;
+            case FrameworkEventType::PairState:
+                pairStateChanged = true;
+                break;
+            case FrameworkEventType::Cue:
+                if (config_.enableAudio) {
+                    audioFeedback(static_cast<AudioCue>(event.value));
+                }
+                break;
+            case FrameworkEventType::ModuleSeen: {
+                // Ignored if the link changed since RxTask posted it
+                ILITEModule* module = ModuleRegistry::getModuleByIndex(event.value);
+                if (paired_ && module != nullptr && module != activeModule_ &&
+                    EspNowDiscovery::macEqual(event.mac, discovery.getPairedMac())) {
+                    setActiveModule(module);
+                    Logger::getInstance().logf("Auto-selected module from telemetry: %s",
+                                              module->getModuleName());
+                    // Name it in the resume cache, which pairing left without a module
+                    rememberLastPeer();
+                    SettingsStore::getInstance().flush();
+                }
+                break;
+            }
+        }
+    }
+    if (pairStateChanged) {
+        handlePairing();
+        // A new confirm replaced the session token; keep it for the next boot
+        if (paired_ && discovery.getSessionToken() != lastSessionSetting().get()) {
+            rememberLastPeer();
+            SettingsStore::getInstance().flush();
+        }
+    }
+
+    // Handle pairing state, connection timeout and per-type staleness
+    if (pairingJob.due(now)) {
+        handlePairing();
+        if (paired_) {
+            handleConnectionTimeout();
+        }
+        const size_t wentStale = TelemetryHealth::service(PacketRouter::getInstance().getActiveModule(), micros());
+        if (wentStale > 0 && paired_) {
+            BlackBox::trigger(BlackBoxTrigger::TelemetryStale);
+        }
+        if (wentStale > 0 && config_.enableAudio) {
+            audioFeedback(AudioCue::Error);
+        }
+    }
+
+    // Serial console commands
+    if (serialJob.due(now) && config_.enableSerialLogging) {
+        handleSerialCommands();
+    }
+
+    // Stack watermarks and core load (once per second)
+    if (monitorJob.due(now)) {
+        TaskMonitor::update();
+    }
+
+    // Fragmentation history and no-alloc region reports
+    if (heapJob.due(now)) {
+        HeapProfiler::sample(now);
+    }
+
+    // Lost team links and per-peer command rates
+    if (teamJob.due(now)) {
+        updateTeamPeers();
+    }
+
+    // Coalesced config saves of the active module
+    if (configJob.due(now)) {
+        saveModuleConfig(activeModule_);
+    }
+
+    // Summaries of rate-limited log lines that stayed quiet
+    if (logSummaryJob.due(now)) {
+        LogChannels::flushSuppressed();
+    }
+
+    // Connection log entries to flash, in page batches
+    if (eventLogJob.due(now)) {
+        EventLog::service(paired_, now);
+    }
+
+    // Black box: link samples, then saving a triggered capture in chunks
+    if (blackBoxJob.due(now)) {
+        if (paired_) {
+            BlackBox::onLink(LinkMetrics::find(discovery.getPairedMac()), now);
+        }
+        BlackBox::service(paired_, now, activeModule_);
+    }
 
-    // Sync with FrameworkEngine
-    frameworkEngine_->loadModule(module);
+    // Background slices of the active module (analysis kept off CommTask)
+    if (moduleServiceJob.due(now) && activeModule_ != nullptr) {
+        ILITE_PROFILE(ProfileZone::ModuleService);
+        ModuleCall call(activeModule_, ModuleCallback::Service);
+        if (call.allowed()) {
+            activeModule_->onService(now);
+        }
+    }
+
+    // Background jobs, if the worker task could not be started
+    JobQueue::runPending(kServiceJobSliceUs);
+
+    // Update control bindings (extension system)
+    if (bindingJob.due(now)) {
+        ControlBindingSystem::update();
+    }
+
+    // Update audio feedback
+    if (audioJob.due(now) && config_.enableAudio) {
+        audioUpdate();
+    }
+}
+
+// ============================================================================
+// Runtime Helpers
+// ============================================================================
+
+void ILITEFramework::handleSerialCommands() {
+    static char line[CommandTable::kMaxLine];
+    static size_t length = 0;
+
+    InputReplay::service(millis());
+    FirmwareRelay::service(millis());
+    SerialBridge::service();
+
+    // The bridge task owns the port; the encoder is the way out
+    if (SerialBridge::isActive()) {
+        if (InputManager::getInstance().getEncoderButtonPressed()) {
+            SerialBridge::stop();
+        }
+        return;
+    }
+
+    while (Serial.available() > 0) {
+        const int c = Serial.read();
+        if (c < 0) {
+            break;
+        }
+        if (InputReplay::isReceiving()) {
+            InputReplay::feed(static_cast<uint8_t>(c));
+            continue;
+        }
+        if (FirmwareRelay::isStaging()) {
+            FirmwareRelay::feed(static_cast<uint8_t>(c));
+            continue;
+        }
+        if (c == '\t') {
+            // Tab lists the commands the line so far can become
+            line[length] = '\0';
+            consoleCommands_.dump(Serial, line);
+            continue;
+        }
+        if (c != '\n' && c != '\r') {
+            if (length < sizeof(line) - 1) {
+                line[length++] = static_cast<char>(c);
+            }
+            continue;
+        }
+        if (length == 0) {
+            continue;
+        }
+        line[length] = '\0';
+        length = 0;
+
+        if (consoleCommands_.dispatch(line, Serial) == CommandResult::Unknown) {
+            Serial.printf("[Console] Unknown command: %s\n", line);
+        }
+        if (SerialBridge::isActive()) {
+            return;     // Everything after "bridge" belongs to the bridge task
+        }
+    }
+}
 
-    // Update packet router
+void ILITEFramework::registerConsoleCommands() {
+    // Lambdas in a member function may reach the framework's private state
+    // through ILITE
+    static const CommandSpec kConsoleCommands[] = {
+        {"help", "?s", "[prefix]", [](const CommandArgs& args, Print& out) {
+            ILITE.consoleCommands_.dump(out, args.has(0) ? args.word(0) : "");
+        }},
+        {"prof", "", nullptr, [](const CommandArgs&, Print& out) { Profiler::dump(out); }},
+        {"prof reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            Profiler::reset();
+            out.println("[Profiler] Reset");
+        }},
+        {"render", "", nullptr, [](const CommandArgs&, Print& out) { RenderScheduler::dump(out); }},
+        {"render reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            RenderScheduler::resetStats();
+            out.println("[Render] Reset");
+        }},
+        {"packets", "", nullptr, [](const CommandArgs&, Print& out) { PacketInspector::dump(out); }},
+        {"telemetry", "", nullptr, [](const CommandArgs&, Print& out) { TelemetryHealth::dump(out); }},
+        {"clock", "", nullptr, [](const CommandArgs&, Print& out) { ClockSync::dump(out); }},
+        {"handoff", "", nullptr, [](const CommandArgs&, Print& out) { ModuleHandoff::dump(out); }},
+        {"encoder", "", nullptr, [](const CommandArgs&, Print& out) { EncoderSampler::getInstance().dump(out); }},
+        {"display", "", nullptr, [](const CommandArgs&, Print& out) { DisplayBus::dump(out); }},
+        {"display bench", "", nullptr, [](const CommandArgs&, Print& out) {
+            ILITE.displayBenchRequested_ = true;
+            RenderScheduler::invalidate(RenderReason::Input);
+            out.println("[Display] Benchmark queued on DisplayTask");
+        }},
+        {"power", "", nullptr, [](const CommandArgs&, Print& out) { PowerManager::dump(out); }},
+        {"battery", "", nullptr, [](const CommandArgs&, Print& out) { BatteryMonitor::dump(out); }},
+        {"led", "", nullptr, [](const CommandArgs&, Print& out) { StatusLed::dump(out); }},
+        {"battery trim", "f", "<volts 2.5-5.0>", [](const CommandArgs& args, Print& out) {
+            // Multimeter reading of the cell
+            if (!BatteryMonitor::trim(args.asFloat(0))) {
+                out.println("[Battery] Usage: battery trim <volts 2.5-5.0>");
+            }
+        }},
+        {"heap", "", nullptr, [](const CommandArgs&, Print& out) { HeapProfiler::dump(out); }},
+        {"heap allocs", "", nullptr, [](const CommandArgs&, Print& out) { HeapProfiler::dumpAllocations(out); }},
+        {"heap assert", "u", "<0|1>", [](const CommandArgs& args, Print& out) {
+            // 1: abort on the first allocation in a no-alloc region
+            HeapProfiler::setMode(args.asUnsigned(0) != 0 ? HeapProfiler::Mode::Assert : HeapProfiler::Mode::Log);
+            out.printf("[Heap] Region violations %s\n", args.asUnsigned(0) != 0 ? "abort" : "are logged");
+        }},
+        {"heap reset", "", nullptr, [](const CommandArgs&, Print&) { HeapProfiler::reset(); }},
+        {"tasks", "", nullptr, [](const CommandArgs&, Print& out) {
+            TaskMonitor::sample();
+            TaskMonitor::dump(out);
+        }},
+        {"radio", "", nullptr, [](const CommandArgs&, Print& out) {
+            const RadioLatencyStats& stats = ILITE.radioStats_;
+            out.printf("[Radio] profile=%s n=%lu fail=%lu us: last=%lu min=%lu avg=%lu max=%lu\n",
+                       getTaskProfileName(ILITE.config_.taskProfile),
+                       static_cast<unsigned long>(stats.samples),
+                       static_cast<unsigned long>(stats.failures),
+                       static_cast<unsigned long>(stats.lastUs),
+                       static_cast<unsigned long>(stats.minUs),
+                       static_cast<unsigned long>(stats.avgUs),
+                       static_cast<unsigned long>(stats.maxUs));
+        }},
+        {"radio reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            ILITE.resetRadioLatencyStats();
+            out.println("[Radio] Reset");
+        }},
+        {"link", "", nullptr, [](const CommandArgs&, Print& out) { LinkMetrics::dump(out); }},
+        {"link reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            LinkMetrics::reset();
+            out.println("[LinkMetrics] Reset");
+        }},
+        {"latency", "", nullptr, [](const CommandArgs&, Print& out) { CommandLatency::dump(out); }},
+        {"latency reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            CommandLatency::reset();
+            out.println("[CmdLatency] Reset");
+        }},
+        {"airtime", "", nullptr, [](const CommandArgs&, Print& out) { discovery.dumpAirtime(out); }},
+        {"airtime reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            discovery.resetAirtimeStats();
+            out.println("[ESP-NOW] Airtime reset");
+        }},
+        {"log", "?ss", "<system|router|discovery|module|ui|control|input> <off|error|warn|info|debug>",
+         [](const CommandArgs& args, Print& out) {
+            if (!args.has(0)) {
+                connectionLogDump(out);
+                return;
+            }
+            // "log <channel> <level>", e.g. "log router debug"
+            const LogChannel channel = LogChannels::fromName(args.word(0));
+            uint8_t mask = 0;
+            if (channel == LogChannel::Count || !LogChannels::levelFromName(args.word(1), mask)) {
+                out.println("[LogChannels] Usage: log <system|router|discovery|module|ui|control|input> <off|error|warn|info|debug>");
+            } else {
+                LogChannels::setMask(channel, mask);
+                out.printf("[LogChannels] %s = %s\n", LogChannels::getName(channel), args.word(1));
+            }
+        }},
+        {"log clear", "", nullptr, [](const CommandArgs&, Print& out) {
+            connectionLogClear();
+            out.println("[ConnectionLog] Cleared");
+        }},
+        {"log flash", "", nullptr, [](const CommandArgs&, Print& out) { EventLog::dump(out); }},
+        {"log boots", "", nullptr, [](const CommandArgs&, Print& out) { EventLog::dumpBoots(out); }},
+        {"log download", "?u", "[boot]", [](const CommandArgs& args, Print& out) {
+            // All boots, or the one given
+            EventLog::download(out, args.asUnsigned(0));
+        }},
+        {"log erase", "", nullptr, [](const CommandArgs&, Print& out) {
+            EventLog::erase();
+            out.println("[EventLog] Erased");
+        }},
+        {"log levels", "", nullptr, [](const CommandArgs&, Print& out) { LogChannels::dump(out); }},
+        {"blackbox", "", nullptr, [](const CommandArgs&, Print& out) { BlackBox::dump(out); }},
+        {"blackbox list", "", nullptr, [](const CommandArgs&, Print& out) { BlackBox::list(out); }},
+        {"blackbox dump", "?u", "[n, 0 = newest]", [](const CommandArgs& args, Print& out) {
+            BlackBox::download(out, args.asUnsigned(0));
+        }},
+        {"blackbox trigger", "", nullptr, [](const CommandArgs&, Print& out) {
+            BlackBox::trigger(BlackBoxTrigger::Manual);
+            out.println("[BlackBox] Triggered; saved in about a second");
+        }},
+        {"joycal", "", nullptr, [](const CommandArgs&, Print& out) { JoystickCalibrator::dump(out); }},
+        {"joycal clear", "", nullptr, [](const CommandArgs&, Print& out) {
+            InputManager::getInstance().clearJoystickCalibration();
+            SettingsStore::getInstance().flush();
+            out.println("[JoyCal] Tables cleared; sticks auto-center");
+        }},
+        {"settings", "", nullptr, [](const CommandArgs&, Print& out) { SettingsStore::getInstance().dump(out); }},
+        {"settings commit", "", nullptr, [](const CommandArgs&, Print& out) {
+            SettingsStore::getInstance().commitNow();
+            SettingsStore::getInstance().dump(out);
+        }},
+        {"tap", "", nullptr, [](const CommandArgs&, Print& out) { TelemetryTap::dump(out); }},
+        {"tap on", "", nullptr, [](const CommandArgs&, Print&) {
+            // Started on demand; switches Serial to config_.telemetryTapBaud
+            if (TelemetryTap::begin(Serial, ILITE.config_.telemetryTapBaud)) {
+                TelemetryTap::setEnabled(true);
+            }
+        }},
+        {"tap off", "", nullptr, [](const CommandArgs&, Print& out) {
+            TelemetryTap::setEnabled(false);
+            out.println("[TelemetryTap] Off");
+        }},
+        {"screen", "", nullptr, [](const CommandArgs&, Print& out) { ScreenCapture::dump(out); }},
+        {"screen on", "", nullptr, [](const CommandArgs&, Print& out) {
+            if (!ScreenCapture::setTapStreaming(true)) {
+                out.println("[Screen] Out of memory");
+            } else if (!TelemetryTap::isEnabled()) {
+                out.println("[Screen] Streaming once the tap is on (\"tap on\")");
+            }
+        }},
+        {"screen off", "", nullptr, [](const CommandArgs&, Print&) { ScreenCapture::setTapStreaming(false); }},
+        {"replay", "", nullptr, [](const CommandArgs&, Print&) { InputReplay::start(); }},
+        {"replay stats", "", nullptr, [](const CommandArgs&, Print& out) { InputReplay::dump(out); }},
+        {"ota", "", nullptr, [](const CommandArgs&, Print& out) {
+            if (!ILITE.requestMaintenanceMode(true)) {
+                out.println("[OTA] Disabled (config.enableOTA)");
+            }
+        }},
+        {"ota exit", "", nullptr, [](const CommandArgs&, Print&) { ILITE.requestMaintenanceMode(false); }},
+        {"relay", "", nullptr, [](const CommandArgs&, Print& out) { FirmwareRelay::dump(out); }},
+        {"relay stage", "ux", "<bytes> <crc32 hex>", [](const CommandArgs& args, Print& out) {
+            // Sent by tools/relay_push.py
+            if (!FirmwareRelay::beginStaging(args.asUnsigned(0), args.asUnsigned(1))) {
+                out.println("[Relay] Cannot stage now");
+            }
+        }},
+        {"relay start", "", nullptr, [](const CommandArgs&, Print& out) {
+            if (!discovery.isPaired() || !FirmwareRelay::start(discovery.getPairedMac())) {
+                out.println("[Relay] Needs a staged image and a paired robot");
+            }
+        }},
+        {"relay abort", "", nullptr, [](const CommandArgs&, Print&) { FirmwareRelay::abort(); }},
+        {"bridge", "", nullptr, [](const CommandArgs&, Print& out) {
+            if (!discovery.isPaired()) {
+                out.println("[Bridge] Pair a robot first");
+                return;
+            }
+            const TaskPlacement placement = getTaskLayout(ILITE.config_.taskProfile).comm;
+            SerialBridge::start(Serial, ILITE.config_.bridgeBaud, discovery.getPairedMac(),
+                                placement.priority, placement.core);
+        }},
+        {"bridge stats", "", nullptr, [](const CommandArgs&, Print& out) { SerialBridge::dump(out); }},
+        {"web", "", nullptr, [](const CommandArgs&, Print& out) { WebDashboard::dump(out); }},
+        {"web on", "", nullptr, [](const CommandArgs&, Print& out) {
+            if (!ILITE.setWebDashboard(true)) {
+                out.println("[Web] Dashboard unavailable");
+            }
+        }},
+        {"web off", "", nullptr, [](const CommandArgs&, Print&) { ILITE.setWebDashboard(false); }},
+        {"transport", "", nullptr, [](const CommandArgs&, Print& out) { Transport::getActive().dump(out); }},
+        {"channel", "?u", "[channel]", [](const CommandArgs& args, Print& out) {
+            if (!args.has(0)) {
+                ChannelSurvey::dump(out, discovery);
+                return;
+            }
+            // Coordinated move of the paired link
+            if (!discovery.requestChannelSwitch(static_cast<uint8_t>(args.asUnsigned(0)))) {
+                out.println("[Channel] Cannot switch now");
+            }
+        }},
+        {"channel survey", "", nullptr, [](const CommandArgs&, Print& out) {
+            // Deaf for the whole survey, so only without a link
+            if (discovery.isPaired()) {
+                out.println("[Channel] Unpair first");
+                return;
+            }
+            const uint8_t channel = ChannelSurvey::run(ILITE.config_.channelSurveyDwellMs);
+            LinkMetrics::restorePromiscuous();
+            if (channel == 0 || !discovery.requestChannelSwitch(channel)) {
+                out.printf("[Channel] Staying on %u\n", static_cast<unsigned>(EspNowDiscovery::getChannel()));
+            }
+            ChannelSurvey::dump(out, discovery);
+        }},
+        {"rate", "?s", "[1M|2M|5.5M|11M|12M|24M|36M|54M|lr250k|lr500k]", [](const CommandArgs& args, Print& out) {
+            if (!args.has(0)) {
+                LinkRate::dump(out);
+                return;
+            }
+            // Fixed rate
+            LinkPhyRate rate;
+            if (LinkRate::parse(args.word(0), rate)) {
+                LinkRate::setAdaptive(false);
+                LinkRate::setRate(rate);
+            } else {
+                out.println("[Rate] Unknown rate");
+            }
+        }},
+        {"rate reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            LinkRate::reset();
+            out.println("[Rate] Reset");
+        }},
+        {"rate auto", "", nullptr, [](const CommandArgs&, Print&) { LinkRate::setAdaptive(true); }},
+        {"slots", "", nullptr, [](const CommandArgs&, Print& out) { TdmaSlots::dump(out); }},
+        {"session", "", nullptr, [](const CommandArgs&, Print& out) { discovery.dumpSession(out); }},
+        {"deadline", "", nullptr, [](const CommandArgs&, Print& out) { ControlDeadline::dump(out); }},
+        {"deadline reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            ILITE.resetControlLoopStats();
+            out.println("[Deadline] Reset");
+        }},
+        {"budget", "", nullptr, [](const CommandArgs&, Print& out) { ModuleBudget::dump(out); }},
+        {"budget reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            ModuleBudget::reset();
+            out.println("[Budget] Reset");
+        }},
+        {"jobs", "", nullptr, [](const CommandArgs&, Print& out) { JobQueue::dump(out); }},
+        {"jobs cancel", "x", "<job id hex>", [](const CommandArgs& args, Print& out) {
+            const JobId id = static_cast<JobId>(args.asUnsigned(0));
+            out.printf("[Jobs] %08lx %s\n", static_cast<unsigned long>(id),
+                       JobQueue::cancel(id) ? "cancelled" : "not active");
+        }},
+        {"events", "", nullptr, [](const CommandArgs&, Print& out) { FrameworkEvents::dump(out); }},
+        {"sched", "", nullptr, [](const CommandArgs&, Print& out) {
+            txStates_[0].schedule.dump(out, ILITE.activeModule_);
+        }},
+        {"txwin", "", nullptr, [](const CommandArgs&, Print& out) { TxWindow::dump(out); }},
+        {"txwin reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            TxWindow::reset();
+            out.println("[TxWindow] Reset");
+        }},
+        {"group", "", nullptr, [](const CommandArgs&, Print& out) { GroupCommand::dump(out); }},
+        {"group reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            GroupCommand::reset();
+            out.println("[Group] Reset");
+        }},
+        {"team", "", nullptr, [](const CommandArgs&, Print& out) {
+            for (size_t slot = 0; slot <= kMaxTeamPeers; ++slot) {
+                const PeerTxStats stats = ILITE.getPeerTxStats(slot);
+                if (stats.mac == nullptr) {
+                    continue;
+                }
+                char mac[18];
+                EspNowDiscovery::macToString(stats.mac, mac, sizeof(mac));
+                out.printf("[Team] %u %s %-12s %s %u Hz (%lu frames)\n",
+                           static_cast<unsigned>(slot), mac,
+                           stats.moduleName ? stats.moduleName : "-",
+                           stats.acked ? "acked" : "pending",
+                           stats.achievedHz, static_cast<unsigned long>(stats.frames));
+            }
+        }},
+        {"team add", "i", "<peer index>", [](const CommandArgs& args, Print& out) {
+            // Peer indices as in the devices list
+            if (!ILITE.addTeamPeer(args.asInt(0))) {
+                out.println("[Team] Cannot drive that peer");
+            }
+        }},
+        {"team clear", "", nullptr, [](const CommandArgs&, Print&) {
+            for (TeamPeer& peer : ILITE.teamPeers_) {
+                if (peer.module != nullptr) {
+                    ILITE.removeTeamPeer(peer.mac);
+                }
+            }
+        }},
+        {"trainer", "", nullptr, [](const CommandArgs&, Print& out) { TrainerLink::dump(out); }},
+        {"trainer trainee", "s", "<instructor MAC>", [](const CommandArgs& args, Print& out) {
+            uint8_t mac[6];
+            if (!EspNowDiscovery::macFromString(args.word(0), mac) ||
+                !TrainerLink::start(TrainerRole::Trainee, mac)) {
+                out.println("[Trainer] Cannot link to that MAC");
+            }
+        }},
+        {"trainer instructor", "s", "<trainee MAC>", [](const CommandArgs& args, Print& out) {
+            uint8_t mac[6];
+            if (!EspNowDiscovery::macFromString(args.word(0), mac) ||
+                !TrainerLink::start(TrainerRole::Instructor, mac)) {
+                out.println("[Trainer] Cannot link to that MAC");
+            }
+        }},
+        {"trainer off", "", nullptr, [](const CommandArgs&, Print&) { TrainerLink::stop(); }},
+        {"trainer mode", "s", "<override|mix>", [](const CommandArgs& args, Print& out) {
+            if (strcmp(args.word(0), "override") == 0) {
+                TrainerLink::setMix(TrainerMix::Override);
+            } else if (strcmp(args.word(0), "mix") == 0) {
+                TrainerLink::setMix(TrainerMix::Mix);
+            } else {
+                out.println("[Trainer] Unknown mode");
+            }
+        }},
+        {"trainer delay", "u", "<ticks 0-2>", [](const CommandArgs& args, Print&) {
+            TrainerLink::setDelayTicks(static_cast<uint8_t>(std::min<uint32_t>(args.asUnsigned(0), 255)));
+        }},
+        {"trainer reset", "", nullptr, [](const CommandArgs&, Print& out) {
+            TrainerLink::reset();
+            out.println("[Trainer] Reset");
+        }},
+        {"passive on", "", nullptr, [](const CommandArgs&, Print&) { discovery.setPassiveListening(true); }},
+        {"passive off", "", nullptr, [](const CommandArgs&, Print&) { discovery.setPassiveListening(false); }},
+    };
+    consoleCommands_.assign(kConsoleCommands, sizeof(kConsoleCommands) / sizeof(kConsoleCommands[0]));
+}
+
+const CommandTable& ILITEFramework::getConsoleCommands() const {
+    return consoleCommands_;
+}
+
+void ILITEFramework::handleOTA() {
+    ArduinoOTA.handle();
+    OtaReceiver::handle();
+}
+
+void ILITEFramework::handleDiscovery() {
+    discovery.discover();
+    const uint32_t now = millis();
+    LinkRate::service(discovery, now);
+    ChannelSurvey::service(discovery, now);
+}
+
+void ILITEFramework::handlePairing() {
+    // Check if we just became paired
+    if (discovery.isPaired() && !paired_) {
+        paired_ = true;
+        pairEpoch_++;
+        frameworkEngine_->setPaired(true);  // Sync with FrameworkEngine
+        lastTelemetryTime_ = millis();
+
+        const Identity* peerIdentity = discovery.getPairedIdentity();
+        if (peerIdentity != nullptr) {
+            Logger::getInstance().logf("Paired with: %s", peerIdentity->customId);
+
+            // Try to find matching module by keywords
+            ILITEModule* matchedModule = ModuleRegistry::findModuleByName(peerIdentity->customId);
+
+            if (matchedModule != nullptr) {
+                setActiveModule(matchedModule);
+                Logger::getInstance().logf("Auto-selected module: %s",
+                                          matchedModule->getModuleName());
+            } else {
+                // The first telemetry packet may still name one (detectModule)
+                moduleDetectArmed.store(true);
+                Logger::getInstance().log("No matching module found for device, waiting for telemetry");
+            }
+
+            if (config_.enableAudio) {
+                audioFeedback(AudioCue::PeerAcknowledge);
+            }
+        }
+    }
+
+    // Check if we just became unpaired
+    if (!discovery.isPaired() && paired_) {
+        Logger::getInstance().log("Unpaired from device");
+        BlackBox::trigger(BlackBoxTrigger::LinkLost);
+        unpair();
+    }
+}
+
+void ILITEFramework::handleConnectionTimeout() {
+    // Automatic disconnects are disabled; users can unpair via the devices menu.
+}
+
+void ILITEFramework::onTelemetryReceived(ILITEModule* module) {
+    // Update telemetry timestamp to prevent timeout
+    lastTelemetryTime_ = millis();
+    if (module != nullptr) {
+        module->lastTelemetryTime_ = lastTelemetryTime_;
+    }
+
+    // Update packet count
+    packetRxCount_++;
+}
+
+void ILITEFramework::onControlTelemetry(ILITEModule* module, size_t typeIndex) {
+    // RxTask: wake CommTask so the module reacts now, not at the next tick
+    if (module == nullptr || !paired_ || commTaskHandle_ == nullptr ||
+        module->getControlSchedule() != ControlSchedule::OnTelemetry ||
+        !module->triggersControl(typeIndex)) {
+        return;
+    }
+    telemetryTriggered.store(true);
+    xTaskNotifyGive(commTaskHandle_);
+}
+
+// ============================================================================
+// Module Management
+// ============================================================================
+
+void ILITEFramework::setActiveModule(ILITEModule* module) {
+    // Selected by name, by hand or from telemetry: nothing left to detect
+    moduleDetectArmed.store(false);
+
+    // A module drives one peer at a time; the paired peer takes it from the team
+    bool leftTeam = false;
+    for (TeamPeer& peer : teamPeers_) {
+        if (module != nullptr && peer.module == module) {
+            removeTeamPeer(peer.mac);
+            leftTeam = true;
+        }
+    }
+
+    // Unpublish the previous module and wait for a grace period: after it no
+    // tick, frame or telemetry handler can still be running inside it
+    ModuleHandoff::publish(nullptr);
+    PacketRouter::getInstance().setActiveModule(nullptr);
+    if (!ModuleHandoff::synchronize()) {
+        // A reader is still inside the previous module: put it back rather
+        // than deactivate it under that reader, and retry on a later pass
+        PacketRouter::getInstance().setActiveModule(activeModule_);
+        ModuleHandoff::publish(activeModule_);
+        ModuleHandoff::request(module);
+        Logger::getInstance().logf("Module switch deferred: %s",
+                                   module != nullptr ? module->getModuleName() : "none");
+        return;
+    }
+
+    const int64_t switchStartUs = esp_timer_get_time();
+    ILITEModule* leaving = previousModule_ != module ? previousModule_ : nullptr;
+    ILITEModule* unparked = nullptr;
+    uint32_t unparkedEpoch = 0;
+    if (leaving != nullptr) {
+        saveModuleConfig(leaving);
+    }
+    if (leaving != nullptr && config_.moduleStandby) {
+        // Park the previous module as it is; the one parked before it comes out
+        leaving->onSuspend();
+        unparkedEpoch = standbyPairEpoch_;
+        frameworkEngine_->swapStandbyModule();
+        standbyPairEpoch_ = paired_ ? pairEpoch_ : 0;
+        unparked = frameworkEngine_->getCurrentModule();
+        Logger::getInstance().logf("Suspended: %s", leaving->getModuleName());
+    } else if (leaving != nullptr) {
+        leaving->onDeactivate();
+        Logger::getInstance().logf("Deactivated: %s", leaving->getModuleName());
+    } else if (module != nullptr && module != activeModule_ && frameworkEngine_->getStandbyModule() == module) {
+        // Nothing active: take the module straight out of standby
+        unparkedEpoch = standbyPairEpoch_;
+        frameworkEngine_->swapStandbyModule();
+        unparked = module;
+    }
+
+    // A parked module that is not the one wanted is evicted
+    if (unparked != nullptr && unparked != module) {
+        unparked->onDeactivate();
+        frameworkEngine_->loadModule(nullptr);
+        Logger::getInstance().logf("Deactivated: %s", unparked->getModuleName());
+    }
+    const bool resumed = unparked != nullptr && unparked == module;
+
+    // Set new active module
+    activeModule_ = module;
+    previousModule_ = activeModule_;
+
+    if (resumed) {
+        module->onResume();
+    } else {
+        // Initialized and stored config loaded on first activation, so boot
+        // skips both for every module
+        ModuleRegistry::ensureInitialized(module);
+        if (module != nullptr && !module->configLoaded_) {
+            module->configLoaded_ = true;
+            ModuleConfigStore::load(*module);
+        }
+
+        // Sync with FrameworkEngine (calls onActivate)
+        frameworkEngine_->loadModule(module);
+    }
+
+    // Routed and driven only once fully activated
     PacketRouter::getInstance().setActiveModule(module);
+    TelemetryTap::describeModule(module);
+    ModuleHandoff::publish(module);
+
+    // The module chosen while paired is the one fast boot resumes
+    if (paired_ && module != nullptr) {
+        rememberLastPeer();
+    }
+
+    // Write what the previous module's menus changed
+    SettingsStore::getInstance().flush();
 
     // Activate new module
-    if (module != nullptr) {
+    if (resumed) {
+        Logger::getInstance().logf("Resumed from standby: %s (%lu us)", module->getModuleName(),
+                                   static_cast<unsigned long>(esp_timer_get_time() - switchStartUs));
+
+        // Same link as when it was suspended: nothing to resynchronize
+        if (paired_ && (unparkedEpoch != pairEpoch_ || leftTeam)) {
+            module->onPair();
+        } else if (!paired_ && unparkedEpoch != 0) {
+            module->onUnpair();
+        }
+    } else if (module != nullptr) {
         Logger::getInstance().logf("Activated: %s", module->getModuleName());
 
         // Call onPair if we're already paired
@@ -584,13 +2426,336 @@ void ILITEFramework::setActiveModule(ILITEModule* module) {
     }
 }
 
+bool ILITEFramework::resumeLastPeer() {
+    LastPeer peer = lastPeerSetting().get();
+    if (!peer.valid) {
+        return false;
+    }
+    peer.customId[sizeof(peer.customId) - 1] = '\0';
+    peer.moduleId[sizeof(peer.moduleId) - 1] = '\0';
+
+    // Module IDs longer than the cache field fall back to the pairing-time name match
+    ILITEModule* module = ModuleRegistry::findModuleById(peer.moduleId);
+    if (module == nullptr) {
+        module = ModuleRegistry::findModuleByName(peer.customId);
+    }
+    const uint32_t token = lastSessionSetting().get();
+    if (module == nullptr || !discovery.restorePairing(peer.mac, peer.customId, token)) {
+        return false;
+    }
+
+    // Already paired, so handlePairing() does not select a module again
+    paired_ = true;
+    pairEpoch_++;
+    frameworkEngine_->setPaired(true);
+    lastTelemetryTime_ = millis();
+    setActiveModule(module);
+    Logger::getInstance().logf("Resumed: %s (%s)", peer.customId, module->getModuleName());
+    return true;
+}
+
+void ILITEFramework::rememberLastPeer() {
+    const uint8_t* mac = discovery.getPairedMac();
+    if (mac == nullptr || activeModule_ == nullptr) {
+        return;
+    }
+
+    LastPeer peer{};
+    memcpy(peer.mac, mac, sizeof(peer.mac));
+    peer.channel = static_cast<uint8_t>(WiFi.channel());
+    peer.valid = 1;
+    const Identity* identity = discovery.getPairedIdentity();
+    if (identity != nullptr) {
+        strncpy(peer.customId, identity->customId, sizeof(peer.customId) - 1);
+    }
+    strncpy(peer.moduleId, activeModule_->getModuleId(), sizeof(peer.moduleId) - 1);
+    // Unchanged bytes (every resumed boot) are not written
+    lastPeerSetting().set(peer);
+    lastSessionSetting().set(discovery.getSessionToken());
+}
+
+void ILITEFramework::finishDeferredInit() {
+    deferredInitPending_ = false;
+
+    Serial.printf("[ILITE] Fast boot: first command at %lu ms, reported at %lu ms\n",
+                  static_cast<unsigned long>(firstCommandMs_),
+                  static_cast<unsigned long>(millis()));
+}
+
+// ============================================================================
+// OTA Maintenance Mode
+// ============================================================================
+
+bool ILITEFramework::requestMaintenanceMode(bool enable) {
+    if (enable && !config_.enableOTA) {
+        return false;
+    }
+    maintenanceRequested_ = enable;
+    return true;
+}
+
+bool ILITEFramework::isInMaintenanceMode() const {
+    return maintenanceMode_;
+}
+
+bool ILITEFramework::setWebDashboard(bool enable) {
+    if (!enable) {
+        WebDashboard::end();
+        if (!maintenanceMode_) {
+            WiFi.softAPdisconnect(true);
+            WiFi.mode(WIFI_STA);
+        }
+        return true;
+    }
+    if (!maintenanceMode_) {
+        startAccessPoint();
+    }
+    const TaskPlacement placement = getTaskLayout(config_.taskProfile).service;
+    return WebDashboard::begin(config_.webDashboardPort, placement.priority, placement.core);
+}
+
+void ILITEFramework::startAccessPoint() {
+    if (WiFi.getMode() == WIFI_AP_STA) {
+        return;
+    }
+    // On the channel ESP-NOW already uses, so the link does not hop
+    WiFi.mode(WIFI_AP_STA);
+    WiFi.softAP(config_.wifiSSID, config_.wifiPassword, WiFi.channel());
+
+    // Fewer beacons: less airtime taken from ESP-NOW while the AP stays up
+    wifi_config_t apConfig;
+    if (esp_wifi_get_config(WIFI_IF_AP, &apConfig) == ESP_OK) {
+        apConfig.ap.beacon_interval = WebDashboard::kBeaconIntervalTu;
+        esp_wifi_set_config(WIFI_IF_AP, &apConfig);
+    }
+}
+
+void ILITEFramework::enterMaintenanceMode() {
+    Serial.println("[OTA] Entering maintenance mode");
+
+    // Flashing reboots the controller; pending edits must reach flash first
+    saveModuleConfig(activeModule_);
+    SettingsStore::getInstance().commitNow();
+
+    // CommTask parks on its next wake-up, DisplayTask after its current frame
+    maintenanceMode_ = true;
+    if (alignTimer_ != nullptr) {
+        esp_timer_stop(alignTimer_);
+    }
+    if (controlTimer_ != nullptr) {
+        esp_timer_stop(controlTimer_);
+    }
+    if (commTaskHandle_ != nullptr) {
+        xTaskNotifyGive(commTaskHandle_);
+    }
+
+    startAccessPoint();
+    if (!initOTA()) {
+        Serial.println("WARNING: OTA initialization failed");
+    }
+    connectionLogAdd("[OTA] Maintenance mode");
+    EventLog::service(false, millis());
+    EventLog::flush();
+    Serial.printf("[OTA] AP %s on channel %u, %s\n", config_.wifiSSID,
+                  static_cast<unsigned>(WiFi.channel()), WiFi.softAPIP().toString().c_str());
+}
+
+void ILITEFramework::exitMaintenanceMode() {
+    ArduinoOTA.end();
+    OtaReceiver::end();
+    if (!WebDashboard::isRunning()) {
+        WiFi.softAPdisconnect(true);
+        WiFi.mode(WIFI_STA);
+    }
+
+    maintenanceMode_ = false;
+    if (displayTaskHandle_ != nullptr) {
+        xTaskNotifyGive(displayTaskHandle_);
+    }
+    if (commTaskHandle_ != nullptr) {
+        xTaskNotifyGive(commTaskHandle_);
+    }
+    if (controlTimer_ != nullptr) {
+        esp_timer_start_periodic(controlTimer_, 1000000ULL / config_.controlLoopHz);
+    }
+    connectionLogAdd("[OTA] Maintenance mode left");
+    Serial.println("[OTA] Left maintenance mode");
+}
+
+void ILITEFramework::drawMaintenanceScreen(int progress) {
+    if (displayCanvas_ == nullptr || !displayParked_) {
+        return;
+    }
+    DisplayCanvas& canvas = *displayCanvas_;
+    char line[40];
+    if (progress < 0) {
+        snprintf(line, sizeof(line), "%s", WiFi.softAPIP().toString().c_str());
+    } else {
+        snprintf(line, sizeof(line), "Flashing %d%%", progress);
+    }
+
+    canvas.firstPage();
+    do {
+        canvas.clear();
+        canvas.setFont(DisplayCanvas::NORMAL);
+        canvas.drawTextCentered(14, "OTA Mode");
+        canvas.setFont(DisplayCanvas::SMALL);
+        canvas.drawTextCentered(28, config_.wifiSSID);
+        canvas.drawTextCentered(40, line);
+        if (progress < 0) {
+            canvas.drawTextCentered(58, "Press encoder to exit");
+        } else {
+            canvas.drawProgressBar(14, 48, 100, 8, progress / 100.0f);
+        }
+    } while (canvas.nextPage());
+}
+
+// ============================================================================
+// Group Commands
+// ============================================================================
+
+bool ILITEFramework::sendGroupCommand(uint8_t group, const uint8_t* data, size_t length,
+                                      uint8_t ackEvery) {
+    if (!initialized_ || maintenanceMode_) {
+        return false;
+    }
+    return GroupCommand::send(group, data, length, ackEvery);
+}
+
+// ============================================================================
+// Team Peers
+// ============================================================================
+
+bool ILITEFramework::addTeamPeer(int peerIndex) {
+    const uint8_t* mac = discovery.getPeer(peerIndex);
+    const Identity* identity = discovery.getPeerIdentity(peerIndex);
+    if (mac == nullptr || identity == nullptr) {
+        return false;
+    }
+
+    ILITEModule* module = ModuleRegistry::findModuleByName(identity->customId);
+    if (module == nullptr || module == activeModule_) {
+        return false;
+    }
+    TeamPeer* slot = nullptr;
+    for (TeamPeer& peer : teamPeers_) {
+        if (peer.module == module || (peer.module != nullptr && memcmp(peer.mac, mac, 6) == 0)) {
+            return false;
+        }
+        if (peer.module == nullptr && slot == nullptr) {
+            slot = &peer;
+        }
+    }
+    if (slot == nullptr || !discovery.addTeamLink(mac)) {
+        return false;
+    }
+    if (!PacketRouter::getInstance().setPeerModule(mac, module)) {
+        discovery.removeTeamLink(mac);
+        return false;
+    }
+
+    ModuleRegistry::ensureInitialized(module);
+    if (!module->configLoaded_) {
+        module->configLoaded_ = true;
+        ModuleConfigStore::load(*module);
+    }
+    module->onPair();
+
+    // CommTask picks the slot up once the module is set
+    memcpy(slot->mac, mac, sizeof(slot->mac));
+    slot->module = module;
+    Logger::getInstance().logf("Team: %s (%s)", identity->customId, module->getModuleName());
+    return true;
+}
+
+void ILITEFramework::removeTeamPeer(const uint8_t* mac) {
+    for (TeamPeer& peer : teamPeers_) {
+        if (peer.module == nullptr || !EspNowDiscovery::macEqual(peer.mac, mac)) {
+            continue;
+        }
+        ILITEModule* module = peer.module;
+        peer.module = nullptr;
+        PacketRouter::getInstance().setPeerModule(mac, nullptr);
+        // CommTask may still be inside the module's tick
+        ModuleHandoff::synchronize();
+        module->onUnpair();
+        saveModuleConfig(module);
+        discovery.removeTeamLink(mac);
+        Logger::getInstance().logf("Team: removed %s", module->getModuleName());
+    }
+}
+
+uint16_t ILITEFramework::getControlLoopHz() const {
+    // Unpaired there is nothing to drive; the loop only runs the UI and input
+    if (!config_.powerManagement || paired_ || config_.unpairedControlHz == 0 ||
+        InputReplay::isActive() || TrainerLink::isActive()) {
+        return config_.controlLoopHz;
+    }
+    return std::min(config_.unpairedControlHz, config_.controlLoopHz);
+}
+
+size_t ILITEFramework::getTeamPeerCount() const {
+    size_t count = 0;
+    for (const TeamPeer& peer : teamPeers_) {
+        if (peer.module != nullptr) {
+            count++;
+        }
+    }
+    return count;
+}
+
+PeerTxStats ILITEFramework::getPeerTxStats(size_t slot) const {
+    PeerTxStats stats;
+    if (slot > kMaxTeamPeers) {
+        return stats;
+    }
+    if (slot == 0) {
+        stats.mac = paired_ ? discovery.getPairedMac() : nullptr;
+        stats.moduleName = activeModule_ != nullptr ? activeModule_->getModuleName() : nullptr;
+        stats.acked = paired_;
+    } else {
+        const TeamPeer& peer = teamPeers_[slot - 1];
+        ILITEModule* module = peer.module;
+        if (module == nullptr) {
+            return stats;
+        }
+        stats.mac = peer.mac;
+        stats.moduleName = module->getModuleName();
+        stats.acked = discovery.isTeamLinkAcked(peer.mac);
+    }
+    stats.frames = txFrames_[slot];
+    stats.achievedHz = txHz_[slot];
+    return stats;
+}
+
+void ILITEFramework::updateTeamPeers() {
+    for (TeamPeer& peer : teamPeers_) {
+        // Discovery drops the link of a team peer that went stale
+        if (peer.module != nullptr && !discovery.isTeamLink(peer.mac)) {
+            removeTeamPeer(peer.mac);
+        }
+    }
+
+    // Called once per second, so the frame delta is the achieved rate
+    for (size_t slot = 0; slot <= kMaxTeamPeers; ++slot) {
+        const uint32_t frames = txFrames_[slot];
+        txHz_[slot] = static_cast<uint16_t>(frames - txFramesLastSecond_[slot]);
+        txFramesLastSecond_[slot] = frames;
+    }
+}
+
+void ILITEFramework::saveModuleConfig(ILITEModule* module) {
+    if (module != nullptr && module->configDirty_) {
+        module->saveConfig();
+    }
+}
+
 void ILITEFramework::requestModuleActivation(ILITEModule* module) {
-    pendingModule_ = module;
-    moduleChangePending_ = true;
+    ModuleHandoff::request(module);
 }
 
 ILITEModule* ILITEFramework::getActiveModule() const {
-    return activeModule_;
+    return ModuleHandoff::current();
 }
 
 bool ILITEFramework::activateModuleById(const char* moduleId) {
@@ -627,10 +2792,20 @@ uint32_t ILITEFramework::getTimeSinceLastTelemetry() const {
 }
 
 void ILITEFramework::unpair() {
+    moduleDetectArmed.store(false);
+
     if (activeModule_ != nullptr) {
         activeModule_->onUnpair();
     }
 
+    // Unpairing a live link forgets it; a link that dropped by itself stays
+    // cached so the next fast boot can still resume it
+    if (discovery.isPaired()) {
+        lastPeerSetting().set(LastPeer{});
+        lastSessionSetting().set(static_cast<uint32_t>(0));
+        discovery.setSession(nullptr, 0);
+    }
+
     paired_ = false;
     frameworkEngine_->setPaired(false);  // Sync with FrameworkEngine
     lastTelemetryTime_ = 0;
@@ -667,10 +2842,57 @@ uint32_t ILITEFramework::getPacketTxCount() const {
     return packetTxCount_;
 }
 
+uint32_t ILITEFramework::getFirstCommandMs() const {
+    return firstCommandMs_;
+}
+
 uint32_t ILITEFramework::getPacketRxCount() const {
     return packetRxCount_;
 }
 
+uint32_t ILITEFramework::getPacketSkippedCount() const {
+    return packetSkippedCount_;
+}
+
+const ControlLoopStats& ILITEFramework::getControlLoopStats() const {
+    return controlStats_;
+}
+
+void ILITEFramework::resetControlLoopStats() {
+    // Applied by CommTask on its next iteration so the counters have one writer
+    controlStatsResetPending_ = true;
+}
+
+const RadioLatencyStats& ILITEFramework::getRadioLatencyStats() const {
+    return radioStats_;
+}
+
+void ILITEFramework::resetRadioLatencyStats() {
+    // Applied by the send callback so the counters have one writer
+    radioStatsResetPending_ = true;
+}
+
+TaskLayout ILITEFramework::getTaskLayout(TaskProfile profile) {
+    switch (profile) {
+        case TaskProfile::RadioLatency:
+            return TaskLayout{{1, 4}, {0, 3}, {1, 1}, {1, 2}, {1, 1}, {0, 0}};
+        case TaskProfile::UiSmooth:
+            return TaskLayout{{0, 2}, {0, 3}, {1, 3}, {1, 4}, {1, 1}, {1, 0}};
+        case TaskProfile::Balanced:
+        default:
+            return TaskLayout{{0, 2}, {0, 3}, {1, 1}, {1, 2}, {1, 1}, {1, 0}};
+    }
+}
+
+const char* ILITEFramework::getTaskProfileName(TaskProfile profile) {
+    switch (profile) {
+        case TaskProfile::RadioLatency: return "radio-latency";
+        case TaskProfile::UiSmooth: return "ui-smooth";
+        case TaskProfile::Balanced:
+        default: return "balanced";
+    }
+}
+
 // ============================================================================
 // WiFi Credential Management
 // ============================================================================
@@ -710,9 +2932,11 @@ bool ILITEFramework::updateWiFiCredentials(const char* ssid, const char* passwor
         persistWiFiCredentials();
     }
 
-    if (initialized_ && config_.enableOTA) {
-        WiFi.softAPdisconnect(true);
-        WiFi.softAP(wifiSSIDBuffer_, wifiPasswordBuffer_);
+    // The AP only exists in maintenance mode; otherwise the next entry uses the new values
+    if (initialized_ && maintenanceMode_) {
+        WiFi.softAP(wifiSSIDBuffer_, wifiPasswordBuffer_, WiFi.channel());
+        ArduinoOTA.end();
+        initOTA();
     }
 
     Logger::getInstance().logf("[WiFi] Credentials updated (SSID=%s)", wifiSSIDBuffer_);
@@ -740,34 +2964,27 @@ void ILITEFramework::initializeWiFiCredentials() {
 }
 
 void ILITEFramework::loadWiFiCredentialsFromPrefs() {
-    PreferencesManager& prefs = PreferencesManager::getInstance();
-    if (!prefs.begin("wifi", true)) {
-        return;
-    }
-
+    // Empty stored values keep the configured defaults
+    SettingsStore& settings = SettingsStore::getInstance();
     char temp[WIFI_PASSWORD_MAX_LEN + 1];
-    size_t len = prefs.getString("ssid", temp, WIFI_SSID_MAX_LEN + 1, "");
+    size_t len = settings.addString("wifi", "ssid", "", WIFI_SSID_MAX_LEN).get(temp, sizeof(temp));
     if (len > 0) {
         strncpy(wifiSSIDBuffer_, temp, WIFI_SSID_MAX_LEN);
         wifiSSIDBuffer_[WIFI_SSID_MAX_LEN] = '\0';
     }
 
-    len = prefs.getString("password", temp, WIFI_PASSWORD_MAX_LEN + 1, "");
+    len = settings.addString("wifi", "password", "", WIFI_PASSWORD_MAX_LEN).get(temp, sizeof(temp));
     if (len > 0) {
         strncpy(wifiPasswordBuffer_, temp, WIFI_PASSWORD_MAX_LEN);
         wifiPasswordBuffer_[WIFI_PASSWORD_MAX_LEN] = '\0';
     }
-
-    prefs.end();
 }
 
 void ILITEFramework::persistWiFiCredentials() {
-    PreferencesManager& prefs = PreferencesManager::getInstance();
-    if (!prefs.begin("wifi", false)) {
-        return;
-    }
+    SettingsStore& settings = SettingsStore::getInstance();
+    settings.addString("wifi", "ssid", "", WIFI_SSID_MAX_LEN).set(wifiSSIDBuffer_);
+    settings.addString("wifi", "password", "", WIFI_PASSWORD_MAX_LEN).set(wifiPasswordBuffer_);
 
-    prefs.putString("ssid", wifiSSIDBuffer_);
-    prefs.putString("password", wifiPasswordBuffer_);
-    prefs.end();
+    // Rare and deliberate: no reason to wait for the commit period
+    settings.flush();
 }
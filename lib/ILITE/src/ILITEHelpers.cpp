@@ -6,8 +6,6 @@
 #include "ILITEHelpers.h"
 #include "connection_log.h"
 #include "audio_feedback.h"
-#include <cstdarg>
-#include <cstdio>
 
 // ============================================================================
 // Logger Implementation
@@ -19,16 +17,9 @@ Logger& Logger::getInstance() {
 }
 
 void Logger::log(const char* message) {
-    connectionLogAdd(message);
-}
-
-void Logger::logf(const char* fmt, ...) {
-    char buffer[128];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
-    va_end(args);
-    connectionLogAddf("%s", buffer);
+    if (LogChannels::enabled(LogChannel::SYSTEM, LOG_INFO)) {
+        connectionLogAdd(message);
+    }
 }
 
 void Logger::info(const char* message) {
@@ -36,15 +27,11 @@ void Logger::info(const char* message) {
 }
 
 void Logger::warning(const char* message) {
-    char buffer[140];
-    snprintf(buffer, sizeof(buffer), "WARN: %s", message);
-    log(buffer);
+    ILITE_LOG(SYSTEM, LOG_WARN, "WARN: %s", message);
 }
 
 void Logger::error(const char* message) {
-    char buffer[140];
-    snprintf(buffer, sizeof(buffer), "ERROR: %s", message);
-    log(buffer);
+    ILITE_LOG(SYSTEM, LOG_ERROR, "ERROR: %s", message);
 }
 
 size_t Logger::getCount() const {
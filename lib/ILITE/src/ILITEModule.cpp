@@ -4,10 +4,15 @@
  */
 
 #include "ILITEModule.h"
+#include "AutoDashboard.h"
 #include "InputManager.h"
 #include "ILITEHelpers.h"
+#include "SettingsStore.h"
+#include "ModuleConfig.h"
 #include "DisplayCanvas.h"
 #include "espnow_discovery.h"
+#include "PacketRouter.h"
+#include "TelemetryHealth.h"
 
 // External references
 extern EspNowDiscovery discovery;
@@ -16,6 +21,20 @@ extern EspNowDiscovery discovery;
 // Helper Function Implementations
 // ============================================================================
 
+uint32_t ILITEModule::getCallbackBudgetUs(ModuleCallback callback) const {
+    return ModuleBudget::defaultBudgetUs(callback);
+}
+
+void ILITEModule::drawDashboard(DisplayCanvas& canvas) {
+    // Not overridden: switch to the generated dashboard, retained from the next frame
+    generatedDashboard_ = true;
+    AutoDashboard::draw(*this, canvas);
+}
+
+WidgetScreen* ILITEModule::getDashboardWidgets() {
+    return generatedDashboard_ ? AutoDashboard::getScreen(*this) : nullptr;
+}
+
 InputManager& ILITEModule::getInputs() {
     return InputManager::getInstance();
 }
@@ -24,6 +43,19 @@ PreferencesManager& ILITEModule::getPreferences() {
     return PreferencesManager::getInstance();
 }
 
+SettingsStore& ILITEModule::getSettings() {
+    return SettingsStore::getInstance();
+}
+
+void ILITEModule::markConfigDirty() {
+    configDirty_ = true;
+}
+
+bool ILITEModule::saveConfig() {
+    configDirty_ = false;
+    return ModuleConfigStore::save(*this);
+}
+
 Logger& ILITEModule::getLogger() {
     return Logger::getInstance();
 }
@@ -43,6 +75,40 @@ uint32_t ILITEModule::getTimeSinceLastTelemetry() const {
     return millis() - lastTelemetryTime_;
 }
 
+uint32_t ILITEModule::getTelemetryAgeMs(size_t typeIndex) const {
+    if (PacketRouter::getInstance().getActiveModule() == this) {
+        return TelemetryHealth::getAgeMs(typeIndex);
+    }
+    return lastTelemetryTime_ == 0 ? UINT32_MAX : millis() - lastTelemetryTime_;
+}
+
+float ILITEModule::getTelemetryRateHz(size_t typeIndex) const {
+    if (PacketRouter::getInstance().getActiveModule() != this) {
+        return 0.0f;
+    }
+    return TelemetryHealth::getRateHz(typeIndex);
+}
+
+bool ILITEModule::isTelemetryStale(size_t typeIndex) const {
+    if (typeIndex >= getTelemetryPacketTypeCount()) {
+        return true;
+    }
+    const uint16_t staleAfterMs = getTelemetryPacketDescriptor(typeIndex).staleAfterMs;
+    if (PacketRouter::getInstance().getActiveModule() == this) {
+        return TelemetryHealth::isStale(typeIndex, staleAfterMs);
+    }
+    const uint32_t ageMs = getTelemetryAgeMs(typeIndex);
+    if (staleAfterMs == PacketDescriptor::kNeverStale) {
+        return ageMs == UINT32_MAX;
+    }
+    return ageMs == UINT32_MAX ||
+           ageMs > (staleAfterMs != 0 ? staleAfterMs : TelemetryHealth::kUnknownRateStaleMs);
+}
+
+uint32_t ILITEModule::getTelemetrySampleUs() const {
+    return PacketRouter::getInstance().getSampleTimestampUs();
+}
+
 bool ILITEModule::sendCommand(const char* command) {
     // TODO: Will be implemented when we integrate with main framework
     // For now, stub implementation
@@ -5,16 +5,21 @@
 
 #include "IconLibrary.h"
 #include <cstring>
+#include <new>
 
 // Static storage
-std::vector<Icon> IconLibrary::icons_;
+std::vector<const Icon*> IconLibrary::icons_;
+std::vector<Icon*> IconLibrary::copies_;
+std::vector<Icon> IconLibrary::bitmaps_;
+std::vector<const uint8_t*> IconLibrary::owned_;
+uint16_t IconLibrary::index_[IconLibrary::kIndexSlots];
 
 // ============================================================================
 // Built-in Icon Data (8x8 monochrome bitmaps)
 // ============================================================================
 
 // Home icon (house)
-static const uint8_t icon_home_data[] = {
+static constexpr uint8_t icon_home_data[] = {
     0b00010000,
     0b00111000,
     0b01111100,
@@ -26,7 +31,7 @@ static const uint8_t icon_home_data[] = {
 };
 
 // Settings icon (gear)
-static const uint8_t icon_settings_data[] = {
+static constexpr uint8_t icon_settings_data[] = {
     0b00111100,
     0b01111110,
     0b11111111,
@@ -38,7 +43,7 @@ static const uint8_t icon_settings_data[] = {
 };
 
 // Info icon (i in circle)
-static const uint8_t icon_info_data[] = {
+static constexpr uint8_t icon_info_data[] = {
     0b00111100,
     0b01000010,
     0b10011001,
@@ -50,7 +55,7 @@ static const uint8_t icon_info_data[] = {
 };
 
 // Warning icon (triangle with !)
-static const uint8_t icon_warning_data[] = {
+static constexpr uint8_t icon_warning_data[] = {
     0b00010000,
     0b00111000,
     0b00101000,
@@ -62,7 +67,7 @@ static const uint8_t icon_warning_data[] = {
 };
 
 // Error icon (X in circle)
-static const uint8_t icon_error_data[] = {
+static constexpr uint8_t icon_error_data[] = {
     0b00111100,
     0b01000010,
     0b10100101,
@@ -74,7 +79,7 @@ static const uint8_t icon_error_data[] = {
 };
 
 // Battery full (100%)
-static const uint8_t icon_battery_full_data[] = {
+static constexpr uint8_t icon_battery_full_data[] = {
     0b00111110,
     0b01111111,
     0b11111111,
@@ -86,7 +91,7 @@ static const uint8_t icon_battery_full_data[] = {
 };
 
 // Battery medium (50%)
-static const uint8_t icon_battery_med_data[] = {
+static constexpr uint8_t icon_battery_med_data[] = {
     0b00111110,
     0b01111111,
     0b11111111,
@@ -98,7 +103,7 @@ static const uint8_t icon_battery_med_data[] = {
 };
 
 // Battery low (20%)
-static const uint8_t icon_battery_low_data[] = {
+static constexpr uint8_t icon_battery_low_data[] = {
     0b00111110,
     0b01111111,
     0b11000011,
@@ -110,7 +115,7 @@ static const uint8_t icon_battery_low_data[] = {
 };
 
 // Signal full (4 bars)
-static const uint8_t icon_signal_full_data[] = {
+static constexpr uint8_t icon_signal_full_data[] = {
     0b00010000,
     0b00110000,
     0b01110000,
@@ -122,7 +127,7 @@ static const uint8_t icon_signal_full_data[] = {
 };
 
 // Signal medium (3 bars)
-static const uint8_t icon_signal_med_data[] = {
+static constexpr uint8_t icon_signal_med_data[] = {
     0b00000000,
     0b00000000,
     0b01110000,
@@ -134,7 +139,7 @@ static const uint8_t icon_signal_med_data[] = {
 };
 
 // Signal low (2 bars)
-static const uint8_t icon_signal_low_data[] = {
+static constexpr uint8_t icon_signal_low_data[] = {
     0b00000000,
     0b00000000,
     0b00000000,
@@ -146,7 +151,7 @@ static const uint8_t icon_signal_low_data[] = {
 };
 
 // Signal none (1 bar)
-static const uint8_t icon_signal_none_data[] = {
+static constexpr uint8_t icon_signal_none_data[] = {
     0b00000000,
     0b00000000,
     0b00000000,
@@ -158,7 +163,7 @@ static const uint8_t icon_signal_none_data[] = {
 };
 
 // Joystick
-static const uint8_t icon_joystick_data[] = {
+static constexpr uint8_t icon_joystick_data[] = {
     0b00011000,
     0b00011000,
     0b00011000,
@@ -170,7 +175,7 @@ static const uint8_t icon_joystick_data[] = {
 };
 
 // Drone (quadcopter)
-static const uint8_t icon_drone_data[] = {
+static constexpr uint8_t icon_drone_data[] = {
     0b10000001,
     0b11000011,
     0b01111110,
@@ -182,7 +187,7 @@ static const uint8_t icon_drone_data[] = {
 };
 
 // Robot
-static const uint8_t icon_robot_data[] = {
+static constexpr uint8_t icon_robot_data[] = {
     0b00111100,
     0b01111110,
     0b11011011,
@@ -194,7 +199,7 @@ static const uint8_t icon_robot_data[] = {
 };
 
 // Car
-static const uint8_t icon_car_data[] = {
+static constexpr uint8_t icon_car_data[] = {
     0b00111100,
     0b01111110,
     0b11111111,
@@ -206,7 +211,7 @@ static const uint8_t icon_car_data[] = {
 };
 
 // Tuning (wrench)
-static const uint8_t icon_tuning_data[] = {
+static constexpr uint8_t icon_tuning_data[] = {
     0b00011100,
     0b00111110,
     0b00011100,
@@ -218,7 +223,7 @@ static const uint8_t icon_tuning_data[] = {
 };
 
 // Lock (locked/disarmed)
-static const uint8_t icon_lock_data[] = {
+static constexpr uint8_t icon_lock_data[] = {
     0b00111100,
     0b01000010,
     0b01000010,
@@ -230,7 +235,7 @@ static const uint8_t icon_lock_data[] = {
 };
 
 // Unlock (unlocked/armed)
-static const uint8_t icon_unlock_data[] = {
+static constexpr uint8_t icon_unlock_data[] = {
     0b00111100,
     0b01000010,
     0b01000000,
@@ -242,7 +247,7 @@ static const uint8_t icon_unlock_data[] = {
 };
 
 // Play
-static const uint8_t icon_play_data[] = {
+static constexpr uint8_t icon_play_data[] = {
     0b00010000,
     0b00110000,
     0b01110000,
@@ -254,7 +259,7 @@ static const uint8_t icon_play_data[] = {
 };
 
 // Pause
-static const uint8_t icon_pause_data[] = {
+static constexpr uint8_t icon_pause_data[] = {
     0b01100110,
     0b01100110,
     0b01100110,
@@ -266,7 +271,7 @@ static const uint8_t icon_pause_data[] = {
 };
 
 // Stop
-static const uint8_t icon_stop_data[] = {
+static constexpr uint8_t icon_stop_data[] = {
     0b11111111,
     0b11111111,
     0b11111111,
@@ -278,7 +283,7 @@ static const uint8_t icon_stop_data[] = {
 };
 
 // Arrow up
-static const uint8_t icon_up_data[] = {
+static constexpr uint8_t icon_up_data[] = {
     0b00011000,
     0b00111100,
     0b01111110,
@@ -290,7 +295,7 @@ static const uint8_t icon_up_data[] = {
 };
 
 // Arrow down
-static const uint8_t icon_down_data[] = {
+static constexpr uint8_t icon_down_data[] = {
     0b00111100,
     0b00111100,
     0b00111100,
@@ -302,7 +307,7 @@ static const uint8_t icon_down_data[] = {
 };
 
 // Arrow left
-static const uint8_t icon_left_data[] = {
+static constexpr uint8_t icon_left_data[] = {
     0b00010000,
     0b00110000,
     0b01110000,
@@ -314,7 +319,7 @@ static const uint8_t icon_left_data[] = {
 };
 
 // Arrow right
-static const uint8_t icon_right_data[] = {
+static constexpr uint8_t icon_right_data[] = {
     0b00001000,
     0b00001100,
     0b00001110,
@@ -326,7 +331,7 @@ static const uint8_t icon_right_data[] = {
 };
 
 // Check mark
-static const uint8_t icon_check_data[] = {
+static constexpr uint8_t icon_check_data[] = {
     0b00000000,
     0b00000001,
     0b00000011,
@@ -338,7 +343,7 @@ static const uint8_t icon_check_data[] = {
 };
 
 // X mark (cross)
-static const uint8_t icon_cross_data[] = {
+static constexpr uint8_t icon_cross_data[] = {
     0b10000001,
     0b11000011,
     0b01100110,
@@ -350,7 +355,7 @@ static const uint8_t icon_cross_data[] = {
 };
 
 // Menu (hamburger)
-static const uint8_t icon_menu_data[] = {
+static constexpr uint8_t icon_menu_data[] = {
     0b11111111,
     0b00000000,
     0b11111111,
@@ -362,7 +367,7 @@ static const uint8_t icon_menu_data[] = {
 };
 
 // Back (arrow left with bar)
-static const uint8_t icon_back_data[] = {
+static constexpr uint8_t icon_back_data[] = {
     0b00010000,
     0b00110000,
     0b01110000,
@@ -373,90 +378,255 @@ static const uint8_t icon_back_data[] = {
     0b00010000
 };
 
+// ============================================================================
+// Built-in Icon Pages (page-major, converted at compile time)
+// ============================================================================
+
+static constexpr uint8_t icon_home_pages[] = ICON_PAGES_8X8(icon_home_data);
+static constexpr uint8_t icon_settings_pages[] = ICON_PAGES_8X8(icon_settings_data);
+static constexpr uint8_t icon_info_pages[] = ICON_PAGES_8X8(icon_info_data);
+static constexpr uint8_t icon_warning_pages[] = ICON_PAGES_8X8(icon_warning_data);
+static constexpr uint8_t icon_error_pages[] = ICON_PAGES_8X8(icon_error_data);
+static constexpr uint8_t icon_battery_full_pages[] = ICON_PAGES_8X8(icon_battery_full_data);
+static constexpr uint8_t icon_battery_med_pages[] = ICON_PAGES_8X8(icon_battery_med_data);
+static constexpr uint8_t icon_battery_low_pages[] = ICON_PAGES_8X8(icon_battery_low_data);
+static constexpr uint8_t icon_signal_full_pages[] = ICON_PAGES_8X8(icon_signal_full_data);
+static constexpr uint8_t icon_signal_med_pages[] = ICON_PAGES_8X8(icon_signal_med_data);
+static constexpr uint8_t icon_signal_low_pages[] = ICON_PAGES_8X8(icon_signal_low_data);
+static constexpr uint8_t icon_signal_none_pages[] = ICON_PAGES_8X8(icon_signal_none_data);
+static constexpr uint8_t icon_joystick_pages[] = ICON_PAGES_8X8(icon_joystick_data);
+static constexpr uint8_t icon_drone_pages[] = ICON_PAGES_8X8(icon_drone_data);
+static constexpr uint8_t icon_robot_pages[] = ICON_PAGES_8X8(icon_robot_data);
+static constexpr uint8_t icon_car_pages[] = ICON_PAGES_8X8(icon_car_data);
+static constexpr uint8_t icon_tuning_pages[] = ICON_PAGES_8X8(icon_tuning_data);
+static constexpr uint8_t icon_lock_pages[] = ICON_PAGES_8X8(icon_lock_data);
+static constexpr uint8_t icon_unlock_pages[] = ICON_PAGES_8X8(icon_unlock_data);
+static constexpr uint8_t icon_play_pages[] = ICON_PAGES_8X8(icon_play_data);
+static constexpr uint8_t icon_pause_pages[] = ICON_PAGES_8X8(icon_pause_data);
+static constexpr uint8_t icon_stop_pages[] = ICON_PAGES_8X8(icon_stop_data);
+static constexpr uint8_t icon_up_pages[] = ICON_PAGES_8X8(icon_up_data);
+static constexpr uint8_t icon_down_pages[] = ICON_PAGES_8X8(icon_down_data);
+static constexpr uint8_t icon_left_pages[] = ICON_PAGES_8X8(icon_left_data);
+static constexpr uint8_t icon_right_pages[] = ICON_PAGES_8X8(icon_right_data);
+static constexpr uint8_t icon_check_pages[] = ICON_PAGES_8X8(icon_check_data);
+static constexpr uint8_t icon_cross_pages[] = ICON_PAGES_8X8(icon_cross_data);
+static constexpr uint8_t icon_menu_pages[] = ICON_PAGES_8X8(icon_menu_data);
+static constexpr uint8_t icon_back_pages[] = ICON_PAGES_8X8(icon_back_data);
+
 // ============================================================================
 // Registration
 // ============================================================================
 
 void IconLibrary::registerIcon(const Icon& icon) {
     // Check for duplicate IDs
-    for (const auto& existing : icons_) {
-        if (strcmp(existing.id, icon.id) == 0) {
-            Serial.printf("[IconLibrary] WARNING: Duplicate icon '%s' (ignoring)\n", icon.id);
-            return;
-        }
+    if (indexOf(icon.id) >= 0) {
+        Serial.printf("[IconLibrary] WARNING: Duplicate icon '%s' (ignoring)\n", icon.id);
+        return;
     }
 
-    icons_.push_back(icon);
+    Icon* entry = new (std::nothrow) Icon(icon);
+    if (entry == nullptr) {
+        Serial.printf("[IconLibrary] ERROR: Out of memory for icon '%s'\n", icon.id);
+        return;
+    }
+    if (entry->pages == nullptr) {
+        entry->pages = convertPages(entry->data, entry->width, entry->height);
+    }
+
+    copies_.push_back(entry);
+    icons_.push_back(entry);
+    indexIcon(icons_.size() - 1);
     Serial.printf("[IconLibrary] Registered icon: %s (%ux%u)\n",
                   icon.id, icon.width, icon.height);
 }
 
+void IconLibrary::registerTable(const Icon* icons, size_t count) {
+    if (icons == nullptr) {
+        return;
+    }
+
+    icons_.reserve(icons_.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        const Icon& icon = icons[i];
+        if (icon.pages == nullptr) {
+            registerIcon(icon);     // Needs a converted copy
+            continue;
+        }
+        if (indexOf(icon.id) >= 0) {
+            Serial.printf("[IconLibrary] WARNING: Duplicate icon '%s' (ignoring)\n", icon.id);
+            continue;
+        }
+        icons_.push_back(&icon);
+        indexIcon(icons_.size() - 1);
+    }
+}
+
+const uint8_t* IconLibrary::convertPages(const uint8_t* xbm, uint8_t width, uint8_t height) {
+    if (xbm == nullptr || width == 0 || height == 0) {
+        return nullptr;
+    }
+
+    const uint8_t stride = (width + 7) >> 3;
+    const uint8_t pageCount = (height + 7) >> 3;
+    uint8_t* pages = new (std::nothrow) uint8_t[pageCount * width]();
+    if (pages == nullptr) {
+        return nullptr;  // Drawn through U8G2 instead
+    }
+
+    for (uint8_t row = 0; row < height; ++row) {
+        const uint8_t* src = xbm + row * stride;
+        uint8_t* dst = pages + (row >> 3) * width;
+        const uint8_t bit = 1 << (row & 7);
+        for (uint8_t col = 0; col < width; ++col) {
+            if (src[col >> 3] & (1 << (col & 7))) {
+                dst[col] |= bit;
+            }
+        }
+    }
+
+    owned_.push_back(pages);
+    return pages;
+}
+
 // ============================================================================
 // Queries
 // ============================================================================
 
-const Icon* IconLibrary::getIcon(IconID id) {
+uint32_t IconLibrary::hashId(IconID id) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* p = id; *p != '\0'; ++p) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    return hash;
+}
+
+void IconLibrary::indexIcon(size_t i) {
+    // Icons past the table capacity are still found by the linear fallback
+    if (i >= kIndexSlots - 1) {
+        return;
+    }
+
+    size_t slot = hashId(icons_[i]->id) & (kIndexSlots - 1);
+    while (index_[slot] != 0) {
+        slot = (slot + 1) & (kIndexSlots - 1);
+    }
+    index_[slot] = static_cast<uint16_t>(i + 1);
+}
+
+int16_t IconLibrary::indexOf(IconID id) {
     if (id == nullptr) {
-        return nullptr;
+        return -1;
     }
 
-    for (const auto& icon : icons_) {
-        if (strcmp(icon.id, id) == 0) {
-            return &icon;
+    size_t slot = hashId(id) & (kIndexSlots - 1);
+    while (index_[slot] != 0) {
+        const size_t i = index_[slot] - 1;
+        // Same literal is usually the same pointer; strcmp covers the rest
+        if (icons_[i]->id == id || strcmp(icons_[i]->id, id) == 0) {
+            return static_cast<int16_t>(i);
         }
+        slot = (slot + 1) & (kIndexSlots - 1);
     }
 
-    return nullptr;
+    for (size_t i = kIndexSlots - 1; i < icons_.size(); ++i) {
+        if (strcmp(icons_[i]->id, id) == 0) {
+            return static_cast<int16_t>(i);
+        }
+    }
+
+    return -1;
+}
+
+const Icon* IconLibrary::getIconAt(int16_t index) {
+    if (index < 0 || static_cast<size_t>(index) >= icons_.size()) {
+        return nullptr;
+    }
+    return icons_[index];
+}
+
+const Icon* IconLibrary::getIcon(IconID id) {
+    return getIconAt(indexOf(id));
 }
 
 bool IconLibrary::hasIcon(IconID id) {
-    return getIcon(id) != nullptr;
+    return indexOf(id) >= 0;
+}
+
+const Icon* IconLibrary::getBitmap(const uint8_t* xbm, uint8_t width, uint8_t height) {
+    if (xbm == nullptr) {
+        return nullptr;
+    }
+
+    for (const auto& bitmap : bitmaps_) {
+        if (bitmap.data == xbm && bitmap.width == width && bitmap.height == height) {
+            return bitmap.pages != nullptr ? &bitmap : nullptr;
+        }
+    }
+
+    bitmaps_.push_back({"", width, height, xbm, convertPages(xbm, width, height)});
+    const Icon& bitmap = bitmaps_.back();
+    return bitmap.pages != nullptr ? &bitmap : nullptr;
 }
 
-std::vector<Icon>& IconLibrary::getIcons() {
+const std::vector<const Icon*>& IconLibrary::getIcons() {
     return icons_;
 }
 
 void IconLibrary::clear() {
     icons_.clear();
+    for (Icon* icon : copies_) {
+        delete icon;
+    }
+    copies_.clear();
+    bitmaps_.clear();
+    for (const uint8_t* pages : owned_) {
+        delete[] pages;
+    }
+    owned_.clear();
+    memset(index_, 0, sizeof(index_));
 }
 
 // ============================================================================
 // Built-in Icon Initialization
 // ============================================================================
 
+// Records as well as bitmaps in flash, registered by address
+static constexpr Icon kBuiltInIcons[] = {
+    {ICON_HOME, 8, 8, icon_home_data, icon_home_pages},
+    {ICON_SETTINGS, 8, 8, icon_settings_data, icon_settings_pages},
+    {ICON_INFO, 8, 8, icon_info_data, icon_info_pages},
+    {ICON_WARNING, 8, 8, icon_warning_data, icon_warning_pages},
+    {ICON_ERROR, 8, 8, icon_error_data, icon_error_pages},
+    {ICON_BATTERY_FULL, 8, 8, icon_battery_full_data, icon_battery_full_pages},
+    {ICON_BATTERY_MED, 8, 8, icon_battery_med_data, icon_battery_med_pages},
+    {ICON_BATTERY_LOW, 8, 8, icon_battery_low_data, icon_battery_low_pages},
+    {ICON_SIGNAL_FULL, 8, 8, icon_signal_full_data, icon_signal_full_pages},
+    {ICON_SIGNAL_MED, 8, 8, icon_signal_med_data, icon_signal_med_pages},
+    {ICON_SIGNAL_LOW, 8, 8, icon_signal_low_data, icon_signal_low_pages},
+    {ICON_SIGNAL_NONE, 8, 8, icon_signal_none_data, icon_signal_none_pages},
+    {ICON_JOYSTICK, 8, 8, icon_joystick_data, icon_joystick_pages},
+    {ICON_DRONE, 8, 8, icon_drone_data, icon_drone_pages},
+    {ICON_ROBOT, 8, 8, icon_robot_data, icon_robot_pages},
+    {ICON_CAR, 8, 8, icon_car_data, icon_car_pages},
+    {ICON_TUNING, 8, 8, icon_tuning_data, icon_tuning_pages},
+    {ICON_LOCK, 8, 8, icon_lock_data, icon_lock_pages},
+    {ICON_UNLOCK, 8, 8, icon_unlock_data, icon_unlock_pages},
+    {ICON_PLAY, 8, 8, icon_play_data, icon_play_pages},
+    {ICON_PAUSE, 8, 8, icon_pause_data, icon_pause_pages},
+    {ICON_STOP, 8, 8, icon_stop_data, icon_stop_pages},
+    {ICON_UP, 8, 8, icon_up_data, icon_up_pages},
+    {ICON_DOWN, 8, 8, icon_down_data, icon_down_pages},
+    {ICON_LEFT, 8, 8, icon_left_data, icon_left_pages},
+    {ICON_RIGHT, 8, 8, icon_right_data, icon_right_pages},
+    {ICON_CHECK, 8, 8, icon_check_data, icon_check_pages},
+    {ICON_CROSS, 8, 8, icon_cross_data, icon_cross_pages},
+    {ICON_MENU, 8, 8, icon_menu_data, icon_menu_pages},
+    {ICON_BACK, 8, 8, icon_back_data, icon_back_pages},
+};
+
 void IconLibrary::initBuiltInIcons() {
-    // Register all built-in 8x8 icons
-    registerIcon({ICON_HOME, 8, 8, icon_home_data});
-    registerIcon({ICON_SETTINGS, 8, 8, icon_settings_data});
-    registerIcon({ICON_INFO, 8, 8, icon_info_data});
-    registerIcon({ICON_WARNING, 8, 8, icon_warning_data});
-    registerIcon({ICON_ERROR, 8, 8, icon_error_data});
-    registerIcon({ICON_BATTERY_FULL, 8, 8, icon_battery_full_data});
-    registerIcon({ICON_BATTERY_MED, 8, 8, icon_battery_med_data});
-    registerIcon({ICON_BATTERY_LOW, 8, 8, icon_battery_low_data});
-    registerIcon({ICON_SIGNAL_FULL, 8, 8, icon_signal_full_data});
-    registerIcon({ICON_SIGNAL_MED, 8, 8, icon_signal_med_data});
-    registerIcon({ICON_SIGNAL_LOW, 8, 8, icon_signal_low_data});
-    registerIcon({ICON_SIGNAL_NONE, 8, 8, icon_signal_none_data});
-    registerIcon({ICON_JOYSTICK, 8, 8, icon_joystick_data});
-    registerIcon({ICON_DRONE, 8, 8, icon_drone_data});
-    registerIcon({ICON_ROBOT, 8, 8, icon_robot_data});
-    registerIcon({ICON_CAR, 8, 8, icon_car_data});
-    registerIcon({ICON_TUNING, 8, 8, icon_tuning_data});
-    registerIcon({ICON_LOCK, 8, 8, icon_lock_data});
-    registerIcon({ICON_UNLOCK, 8, 8, icon_unlock_data});
-    registerIcon({ICON_PLAY, 8, 8, icon_play_data});
-    registerIcon({ICON_PAUSE, 8, 8, icon_pause_data});
-    registerIcon({ICON_STOP, 8, 8, icon_stop_data});
-    registerIcon({ICON_UP, 8, 8, icon_up_data});
-    registerIcon({ICON_DOWN, 8, 8, icon_down_data});
-    registerIcon({ICON_LEFT, 8, 8, icon_left_data});
-    registerIcon({ICON_RIGHT, 8, 8, icon_right_data});
-    registerIcon({ICON_CHECK, 8, 8, icon_check_data});
-    registerIcon({ICON_CROSS, 8, 8, icon_cross_data});
-    registerIcon({ICON_MENU, 8, 8, icon_menu_data});
-    registerIcon({ICON_BACK, 8, 8, icon_back_data});
+    registerTable(kBuiltInIcons, sizeof(kBuiltInIcons) / sizeof(kBuiltInIcons[0]));
 
     Serial.printf("[IconLibrary] Initialized %zu built-in icons\n", icons_.size());
 }
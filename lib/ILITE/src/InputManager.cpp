@@ -4,7 +4,56 @@
  */
 
 #include "InputManager.h"
+#include "BatteryMonitor.h"
+#include "EncoderSampler.h"
+#include "JoystickCalibrator.h"
+#include "LatencyPins.h"
+#include "PowerManager.h"
+#include "LogChannels.h"
+#include "SettingsStore.h"
 #include "input.h"  // Existing pin definitions
+#include <cstring>
+
+namespace {
+
+// Stored tables, AdcSampler::JOY_A_X to JOY_B_Y
+const char* const kCalibrationKeys[] = {"ax", "ay", "bx", "by"};
+Setting<AxisCalibration> g_calibrationSettings[4];
+
+constexpr float kQ15ToFloat = 1.0f / AxisCalibration::kFullScale;
+
+}  // namespace
+
+// ============================================================================
+// AxisCalibration
+// ============================================================================
+
+bool AxisCalibration::isValid() const {
+    if (version != kVersion || min < 0 || max > 4095 ||
+        center - min < kMinHalfSpan || max - center < kMinHalfSpan) {
+        return false;
+    }
+    for (size_t side = 0; side < 2; ++side) {
+        const uint16_t* points = curve + side * kSidePoints;
+        uint16_t previous = 0;
+        for (size_t i = 0; i < kSidePoints; ++i) {
+            if (points[i] < previous || points[i] > kFullScale) {
+                return false;
+            }
+            previous = points[i];
+        }
+        if (previous != kFullScale) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AxisCalibration::setLinear() {
+    for (size_t i = 0; i < kCurvePoints; ++i) {
+        curve[i] = static_cast<uint16_t>((i % kSidePoints + 1) * kFullScale / kSidePoints);
+    }
+}
 
 // ============================================================================
 // Singleton Instance
@@ -23,22 +72,23 @@ InputManager::InputManager()
     : deadzone_(kDefaultDeadzone),
       sensitivity_(kDefaultSensitivity),
       filteringEnabled_(true),
-      encoderCount_(0),
-      lastEncoderCount_(0)
+      lastEncoderCount_(0),
+      published_(0),
+      encoderBtnIsrMs_(0),
+      pendingLutMask_(0),
+      deadzoneQ15_(static_cast<int32_t>(kDefaultDeadzone * AxisCalibration::kFullScale)),
+      sensitivityQ8_(static_cast<int32_t>(kDefaultSensitivity * 256.0f))
 {
     // Initialize calibration structs
-    joyA_X_ = {2048, false, 0.0f};
-    joyA_Y_ = {2048, false, 0.0f};
-    joyB_X_ = {2048, false, 0.0f};
-    joyB_Y_ = {2048, false, 0.0f};
+    joyA_X_ = {2048, false, 0.0f, {}};
+    joyA_Y_ = {2048, false, 0.0f, {}};
+    joyB_X_ = {2048, false, 0.0f, {}};
+    joyB_Y_ = {2048, false, 0.0f, {}};
 
-    // Initialize button states
-    button1_ = {false, false, 0};
-    button2_ = {false, false, 0};
-    button3_ = {false, false, 0};
-    joyBtnA_ = {false, false, 0};
-    joyBtnB_ = {false, false, 0};
-    encoderBtn_ = {false, false, 0};
+    memset(calibrations_, 0, sizeof(calibrations_));
+    memset(pendingLuts_, 0, sizeof(pendingLuts_));
+    lutLock_ = portMUX_INITIALIZER_UNLOCKED;
+    memset(snapshots_, 0, sizeof(snapshots_));
 }
 
 // ============================================================================
@@ -64,40 +114,54 @@ void InputManager::begin() {
     pinMode(potA, INPUT);
     pinMode(batteryPin, INPUT);
 
-    // Attach encoder interrupt (same as original input.cpp)
-    attachInterrupt(encoderA, []() {
-        // Encoder ISR - increment/decrement count based on direction
-        if (digitalRead(encoderB) == HIGH) {
-            encoderCount++;
-        } else {
-            encoderCount--;
-        }
-        InputManager::getInstance().encoderCount_ = encoderCount;
-    }, RISING);
+    // Continuous ADC1 DMA sampling; falls back to analogRead in update()
+    if (!AdcSampler::getInstance().begin()) {
+        ILITE_LOG(INPUTS, LOG_WARN, "InputManager: ADC DMA unavailable, using analogRead");
+    }
+    BatteryMonitor::begin();
+    // 1 kHz button debouncing; falls back to one sample per update()
+    if (!ButtonSampler::getInstance().begin()) {
+        ILITE_LOG(INPUTS, LOG_WARN, "InputManager: button timer unavailable, sampling per update");
+    }
+    update();
+
+    // Quadrature decoding on both encoder pins
+    EncoderSampler::getInstance().begin();
 
     // Attach encoder button interrupt
     attachInterrupt(encoderBtn, []() {
+        if (PowerManager::wakeFromPinIsr()) {
+            return;     // Level wake interrupt: the press is not a rising edge
+        }
         uint32_t now = millis();
         auto& mgr = InputManager::getInstance();
-        if (now - mgr.encoderBtn_.lastChangeTime >= kDebounceMs) {
+        if (now - mgr.encoderBtnIsrMs_ >= kDebounceMs) {
             encoderBtnState = true;  // Set global for compatibility
-            mgr.encoderBtn_.lastChangeTime = now;
+            mgr.encoderBtnIsrMs_ = now;
+            PowerManager::wakeFromIsr();
         }
     }, RISING);
 
-    Serial.println("[InputManager] Initialized");
+    ILITE_LOG(INPUTS, LOG_INFO, "InputManager: initialized");
 
     // Verify pull-ups are working - should read HIGH (3.3V) when not pressed
     delay(100);
-    Serial.println("[InputManager] Pull-up verification:");
-    Serial.printf("  Joystick A Button (GPIO %d): %s (should be HIGH)\n",
-                  joystickBtnA, digitalRead(joystickBtnA) == HIGH ? "HIGH" : "LOW");
-    Serial.printf("  Joystick B Button (GPIO %d): %s (should be HIGH)\n",
-                  joystickBtnB, digitalRead(joystickBtnB) == HIGH ? "HIGH" : "LOW");
-    Serial.printf("  Button 1 (GPIO %d): %s\n", button1, digitalRead(button1) == HIGH ? "HIGH" : "LOW");
-    Serial.printf("  Button 2 (GPIO %d): %s\n", button2, digitalRead(button2) == HIGH ? "HIGH" : "LOW");
-    Serial.printf("  Button 3 (GPIO %d): %s\n", button3, digitalRead(button3) == HIGH ? "HIGH" : "LOW");
-    Serial.println("[InputManager] If any button shows LOW, check wiring or add external pull-up resistor");
+    const struct {
+        const char* name;
+        int pin;
+    } pullUps[] = {
+        {"joystick A button", joystickBtnA},
+        {"joystick B button", joystickBtnB},
+        {"button 1", button1},
+        {"button 2", button2},
+        {"button 3", button3},
+    };
+    for (const auto& input : pullUps) {
+        if (digitalRead(input.pin) != HIGH) {
+            ILITE_LOG(INPUTS, LOG_WARN, "InputManager: %s (GPIO %d) reads LOW; check wiring or add a pull-up",
+                      input.name, input.pin);
+        }
+    }
 }
 
 // ============================================================================
@@ -105,15 +169,71 @@ void InputManager::begin() {
 // ============================================================================
 
 void InputManager::update() {
-    uint32_t now = millis();
+    uint8_t index = published_.load(std::memory_order_relaxed);
+    const InputSnapshot& previous = snapshots_[index];
+    InputSnapshot& next = snapshots_[index ^ 1];
+
+    next.sequence = previous.sequence + 1;
+    next.timestampUs = micros();
+
+    // Analog: one latch for all channels, calibration runs once per capture
+    latchAnalogInputs(next.raw);
+    ILITE_LATENCY_PULSE(AdcLatch);
+    if (pendingLutMask_.load(std::memory_order_relaxed) != 0) {
+        takePendingLuts();
+    }
+    next.joystickA_X = readJoystickAxis(next.raw[AdcSampler::JOY_A_X], joyA_X_);
+    next.joystickA_Y = readJoystickAxis(next.raw[AdcSampler::JOY_A_Y], joyA_Y_);
+    next.joystickB_X = readJoystickAxis(next.raw[AdcSampler::JOY_B_X], joyB_X_);
+    next.joystickB_Y = readJoystickAxis(next.raw[AdcSampler::JOY_B_Y], joyB_Y_);
+    if (JoystickCalibrator::onSample(next.raw)) {
+        // The sticks are being swept end to end; a connected robot holds still
+        next.joystickA_X = next.joystickA_Y = 0.0f;
+        next.joystickB_X = next.joystickB_Y = 0.0f;
+    }
+    next.potentiometer = constrain(next.raw[AdcSampler::POT] / 4095.0f, 0.0f, 1.0f);
 
-    // Update all button states for edge detection
-    updateButtonState(button1_, button1);
-    updateButtonState(button2_, button2);
-    updateButtonState(button3_, button3);
-    updateButtonState(joyBtnA_, joystickBtnA);
-    updateButtonState(joyBtnB_, joystickBtnB);
-    updateButtonState(encoderBtn_, encoderBtn);
+    // Digital: debounced levels and every press since the previous capture
+    ButtonSampler& sampler = ButtonSampler::getInstance();
+    sampler.poll();
+    const ButtonChanges changes = sampler.collect(buttonCursor_);
+    next.buttons = sampler.getRawLevels();
+    next.debounced = changes.levels;
+    next.pressed = changes.pressed;
+
+    EncoderSampler& encoder = EncoderSampler::getInstance();
+    encoder.poll();
+    next.encoderCount = encoder.getPosition();
+
+    published_.store(index ^ 1, std::memory_order_release);
+}
+
+void InputManager::replay(const InputSnapshot& recorded) {
+    uint8_t index = published_.load(std::memory_order_relaxed);
+    const uint32_t sequence = snapshots_[index].sequence + 1;
+    InputSnapshot& next = snapshots_[index ^ 1];
+
+    next = recorded;
+    next.sequence = sequence;
+    next.timestampUs = micros();
+
+    published_.store(index ^ 1, std::memory_order_release);
+}
+
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+const InputSnapshot& InputManager::current() const {
+    return snapshots_[published_.load(std::memory_order_acquire)];
+}
+
+InputSnapshot InputManager::getSnapshot() const {
+    return current();
+}
+
+uint32_t InputManager::getSequence() const {
+    return current().sequence;
 }
 
 // ============================================================================
@@ -121,24 +241,23 @@ void InputManager::update() {
 // ============================================================================
 
 float InputManager::getJoystickA_X() const {
-    return readJoystickAxis(joystickA_X, const_cast<JoystickCalibration&>(joyA_X_));
+    return current().joystickA_X;
 }
 
 float InputManager::getJoystickA_Y() const {
-    return readJoystickAxis(joystickA_Y, const_cast<JoystickCalibration&>(joyA_Y_));
+    return current().joystickA_Y;
 }
 
 float InputManager::getJoystickB_X() const {
-    return readJoystickAxis(joystickB_X, const_cast<JoystickCalibration&>(joyB_X_));
+    return current().joystickB_X;
 }
 
 float InputManager::getJoystickB_Y() const {
-    return readJoystickAxis(joystickB_Y, const_cast<JoystickCalibration&>(joyB_Y_));
+    return current().joystickB_Y;
 }
 
 float InputManager::getPotentiometer() const {
-    uint16_t raw = analogRead(potA);
-    return constrain(raw / 4095.0f, 0.0f, 1.0f);
+    return current().potentiometer;
 }
 
 // ============================================================================
@@ -146,23 +265,23 @@ float InputManager::getPotentiometer() const {
 // ============================================================================
 
 uint16_t InputManager::getJoystickA_X_Raw() const {
-    return analogRead(joystickA_X);
+    return current().raw[AdcSampler::JOY_A_X];
 }
 
 uint16_t InputManager::getJoystickA_Y_Raw() const {
-    return analogRead(joystickA_Y);
+    return current().raw[AdcSampler::JOY_A_Y];
 }
 
 uint16_t InputManager::getJoystickB_X_Raw() const {
-    return analogRead(joystickB_X);
+    return current().raw[AdcSampler::JOY_B_X];
 }
 
 uint16_t InputManager::getJoystickB_Y_Raw() const {
-    return analogRead(joystickB_Y);
+    return current().raw[AdcSampler::JOY_B_Y];
 }
 
 uint16_t InputManager::getPotentiometer_Raw() const {
-    return analogRead(potA);
+    return current().raw[AdcSampler::POT];
 }
 
 // ============================================================================
@@ -170,61 +289,16 @@ uint16_t InputManager::getPotentiometer_Raw() const {
 // ============================================================================
 
 uint16_t InputManager::getBatteryRaw() const {
-    return analogRead(batteryPin);
+    return current().raw[AdcSampler::BATTERY];
 }
 
 float InputManager::getBatteryVoltage() const {
-    // Read ADC value (0-4095 for 12-bit ADC)
-    uint16_t adcValue = analogRead(batteryPin);
-
-    // Convert to voltage (ESP32 ADC reference is 3.3V for 4095)
-    float voltage = (adcValue / 4095.0f) * 3.3f;
-
-    // Multiply by 2 due to voltage divider with 2 equal resistors
-    voltage *= 2.0*1.82;
-
-    return voltage;
+    // This tick only; BatteryMonitor publishes the filtered value
+    return BatteryMonitor::rawToVolts(current().raw[AdcSampler::BATTERY]);
 }
 
 uint8_t InputManager::getBatteryPercent() const {
-    float voltage = getBatteryVoltage();
-
-    // Li-Po voltage curve (1S cell)
-    // 4.2V = 100%, 3.0V = 0%
-    const float voltageMax = 4.2f;
-    const float voltageMin = 3.0f;
-
-    // Clamp voltage to valid range
-    if (voltage >= voltageMax) {
-        return 100;
-    }
-    if (voltage <= voltageMin) {
-        return 0;
-    }
-
-    // Use non-linear Li-Po discharge curve for better accuracy
-    // Voltage points: 4.2, 4.0, 3.85, 3.7, 3.5, 3.3, 3.0
-    // Percent points: 100,  90,   75,  50,  25,  10,   0
-
-    if (voltage >= 4.0f) {
-        // 100% to 90%: 4.2V to 4.0V
-        return 90 + (uint8_t)((voltage - 4.0f) / 0.2f * 10.0f);
-    } else if (voltage >= 3.85f) {
-        // 90% to 75%: 4.0V to 3.85V
-        return 75 + (uint8_t)((voltage - 3.85f) / 0.15f * 15.0f);
-    } else if (voltage >= 3.7f) {
-        // 75% to 50%: 3.85V to 3.7V
-        return 50 + (uint8_t)((voltage - 3.7f) / 0.15f * 25.0f);
-    } else if (voltage >= 3.5f) {
-        // 50% to 25%: 3.7V to 3.5V
-        return 25 + (uint8_t)((voltage - 3.5f) / 0.2f * 25.0f);
-    } else if (voltage >= 3.3f) {
-        // 25% to 10%: 3.5V to 3.3V
-        return 10 + (uint8_t)((voltage - 3.3f) / 0.2f * 15.0f);
-    } else {
-        // 10% to 0%: 3.3V to 3.0V
-        return (uint8_t)((voltage - 3.0f) / 0.3f * 10.0f);
-    }
+    return BatteryMonitor::percentForVoltage(getBatteryVoltage());
 }
 
 // ============================================================================
@@ -232,27 +306,27 @@ uint8_t InputManager::getBatteryPercent() const {
 // ============================================================================
 
 bool InputManager::getButton1() const {
-    return digitalRead(button1) == LOW;
+    return (current().buttons & InputSnapshot::BUTTON_1) != 0;
 }
 
 bool InputManager::getButton2() const {
-    return digitalRead(button2) == LOW;
+    return (current().buttons & InputSnapshot::BUTTON_2) != 0;
 }
 
 bool InputManager::getButton3() const {
-    return digitalRead(button3) == LOW;
+    return (current().buttons & InputSnapshot::BUTTON_3) != 0;
 }
 
 bool InputManager::getJoystickButtonA() const {
-    return digitalRead(joystickBtnA) == LOW;
+    return (current().buttons & InputSnapshot::JOY_BUTTON_A) != 0;
 }
 
 bool InputManager::getJoystickButtonB() const {
-    return digitalRead(joystickBtnB) == LOW;
+    return (current().buttons & InputSnapshot::JOY_BUTTON_B) != 0;
 }
 
 bool InputManager::getEncoderButton() const {
-    return digitalRead(encoderBtn) == LOW;
+    return (current().buttons & InputSnapshot::ENCODER_BUTTON) != 0;
 }
 
 // ============================================================================
@@ -260,27 +334,27 @@ bool InputManager::getEncoderButton() const {
 // ============================================================================
 
 bool InputManager::getButton1Pressed() const {
-    return button1_.current && !button1_.previous;
+    return (current().pressed & InputSnapshot::BUTTON_1) != 0;
 }
 
 bool InputManager::getButton2Pressed() const {
-    return button2_.current && !button2_.previous;
+    return (current().pressed & InputSnapshot::BUTTON_2) != 0;
 }
 
 bool InputManager::getButton3Pressed() const {
-    return button3_.current && !button3_.previous;
+    return (current().pressed & InputSnapshot::BUTTON_3) != 0;
 }
 
 bool InputManager::getJoystickButtonA_Pressed() const {
-    return joyBtnA_.current && !joyBtnA_.previous;
+    return (current().pressed & InputSnapshot::JOY_BUTTON_A) != 0;
 }
 
 bool InputManager::getJoystickButtonB_Pressed() const {
-    return joyBtnB_.current && !joyBtnB_.previous;
+    return (current().pressed & InputSnapshot::JOY_BUTTON_B) != 0;
 }
 
 bool InputManager::getEncoderButtonPressed() const {
-    return encoderBtn_.current && !encoderBtn_.previous;
+    return (current().pressed & InputSnapshot::ENCODER_BUTTON) != 0;
 }
 
 // ============================================================================
@@ -288,13 +362,14 @@ bool InputManager::getEncoderButtonPressed() const {
 // ============================================================================
 
 int InputManager::getEncoderDelta() {
-    int delta = encoderCount_ - lastEncoderCount_;
-    lastEncoderCount_ = encoderCount_;
+    int count = current().encoderCount;
+    int delta = count - lastEncoderCount_;
+    lastEncoderCount_ = count;
     return delta;
 }
 
 int InputManager::getEncoderCount() const {
-    return encoderCount_;
+    return current().encoderCount;
 }
 
 // ============================================================================
@@ -303,6 +378,7 @@ int InputManager::getEncoderCount() const {
 
 void InputManager::setJoystickDeadzone(float deadzone) {
     deadzone_ = constrain(deadzone, 0.0f, 1.0f);
+    deadzoneQ15_ = static_cast<int32_t>(deadzone_ * AxisCalibration::kFullScale);
 }
 
 float InputManager::getJoystickDeadzone() const {
@@ -311,6 +387,7 @@ float InputManager::getJoystickDeadzone() const {
 
 void InputManager::setJoystickSensitivity(float sensitivity) {
     sensitivity_ = constrain(sensitivity, 0.1f, 2.0f);
+    sensitivityQ8_ = static_cast<int32_t>(sensitivity_ * 256.0f + 0.5f);
 }
 
 float InputManager::getJoystickSensitivity() const {
@@ -318,20 +395,143 @@ float InputManager::getJoystickSensitivity() const {
 }
 
 void InputManager::recalibrateJoysticks() {
-    // Read current positions as new center points
-    joyA_X_.center = analogRead(joystickA_X);
-    joyA_Y_.center = analogRead(joystickA_Y);
-    joyB_X_.center = analogRead(joystickB_X);
-    joyB_Y_.center = analogRead(joystickB_Y);
+    // Use the latest captured positions as new center points
+    const InputSnapshot& snapshot = current();
+    joyA_X_.center = snapshot.raw[AdcSampler::JOY_A_X];
+    joyA_Y_.center = snapshot.raw[AdcSampler::JOY_A_Y];
+    joyB_X_.center = snapshot.raw[AdcSampler::JOY_B_X];
+    joyB_Y_.center = snapshot.raw[AdcSampler::JOY_B_Y];
 
     joyA_X_.initialized = true;
     joyA_Y_.initialized = true;
     joyB_X_.initialized = true;
     joyB_Y_.initialized = true;
 
-    Serial.println("[InputManager] Joysticks recalibrated");
-    Serial.printf("  JoyA center: %d, %d\n", joyA_X_.center, joyA_Y_.center);
-    Serial.printf("  JoyB center: %d, %d\n", joyB_X_.center, joyB_Y_.center);
+    // Tables keep their curve and ends around the new center
+    for (uint8_t axis = 0; axis < kJoystickAxes; ++axis) {
+        portENTER_CRITICAL(&lutLock_);
+        const AxisCalibration calibration = calibrations_[axis];
+        portEXIT_CRITICAL(&lutLock_);
+        if (calibration.isValid()) {
+            queueLut(axis, calibration, static_cast<int16_t>(snapshot.raw[axis]));
+        }
+    }
+
+    ILITE_LOG(INPUTS, LOG_INFO, "InputManager: joysticks recalibrated (A %d,%d  B %d,%d)",
+              joyA_X_.center, joyA_Y_.center, joyB_X_.center, joyB_Y_.center);
+}
+
+// ============================================================================
+// Calibration Tables
+// ============================================================================
+
+void InputManager::loadJoystickCalibration() {
+    SettingsStore& settings = SettingsStore::getInstance();
+    uint8_t loaded = 0;
+    for (uint8_t axis = 0; axis < kJoystickAxes; ++axis) {
+        g_calibrationSettings[axis] = settings.add("joycal", kCalibrationKeys[axis], AxisCalibration{});
+        const AxisCalibration calibration = g_calibrationSettings[axis].get();
+        if (!calibration.isValid()) {
+            continue;
+        }
+        portENTER_CRITICAL(&lutLock_);
+        calibrations_[axis] = calibration;
+        portEXIT_CRITICAL(&lutLock_);
+        queueLut(axis, calibration, calibration.center);
+        loaded++;
+    }
+    ILITE_LOG(INPUTS, LOG_INFO, "InputManager: %u of %u joystick axes use calibration tables",
+              loaded, kJoystickAxes);
+}
+
+bool InputManager::setJoystickCalibration(AdcSampler::Channel axis, const AxisCalibration& calibration) {
+    if (axis >= kJoystickAxes || !calibration.isValid()) {
+        return false;
+    }
+    portENTER_CRITICAL(&lutLock_);
+    calibrations_[axis] = calibration;
+    portEXIT_CRITICAL(&lutLock_);
+    queueLut(axis, calibration, calibration.center);
+    g_calibrationSettings[axis].set(calibration);
+    return true;
+}
+
+bool InputManager::getJoystickCalibration(AdcSampler::Channel axis, AxisCalibration& out) const {
+    if (axis >= kJoystickAxes) {
+        return false;
+    }
+    portENTER_CRITICAL(&lutLock_);
+    out = calibrations_[axis];
+    portEXIT_CRITICAL(&lutLock_);
+    return out.isValid();
+}
+
+void InputManager::clearJoystickCalibration() {
+    const AxisCalibration none = {};
+    for (uint8_t axis = 0; axis < kJoystickAxes; ++axis) {
+        portENTER_CRITICAL(&lutLock_);
+        calibrations_[axis] = none;
+        pendingLuts_[axis].valid = false;
+        portEXIT_CRITICAL(&lutLock_);
+        g_calibrationSettings[axis].set(none);
+    }
+    pendingLutMask_.fetch_or((1u << kJoystickAxes) - 1, std::memory_order_release);
+    ILITE_LOG(INPUTS, LOG_INFO, "InputManager: joystick calibration tables cleared");
+}
+
+void InputManager::queueLut(uint8_t axis, const AxisCalibration& calibration, int16_t center) {
+    // Keep both sides at least kMinHalfSpan wide around a moved center
+    if (center - calibration.min < AxisCalibration::kMinHalfSpan) {
+        center = calibration.min + AxisCalibration::kMinHalfSpan;
+    }
+    if (calibration.max - center < AxisCalibration::kMinHalfSpan) {
+        center = calibration.max - AxisCalibration::kMinHalfSpan;
+    }
+
+    AxisLut lut;
+    lut.valid = true;
+    lut.center = center;
+    lut.halfSpan[0] = static_cast<uint16_t>(center - calibration.min);
+    lut.halfSpan[1] = static_cast<uint16_t>(calibration.max - center);
+    for (size_t side = 0; side < 2; ++side) {
+        // Floor, so the last count before the end stays inside segment 7
+        lut.scale[side] = (static_cast<uint32_t>(AxisCalibration::kSidePoints) << 16) / lut.halfSpan[side];
+        lut.knots[side][0] = 0;
+        for (size_t i = 0; i < AxisCalibration::kSidePoints; ++i) {
+            lut.knots[side][i + 1] = calibration.curve[side * AxisCalibration::kSidePoints + i];
+        }
+    }
+
+    portENTER_CRITICAL(&lutLock_);
+    pendingLuts_[axis] = lut;
+    portEXIT_CRITICAL(&lutLock_);
+    pendingLutMask_.fetch_or(static_cast<uint8_t>(1u << axis), std::memory_order_release);
+}
+
+void InputManager::takePendingLuts() {
+    const uint8_t mask = pendingLutMask_.exchange(0, std::memory_order_acquire);
+    for (uint8_t axis = 0; axis < kJoystickAxes; ++axis) {
+        if ((mask & (1u << axis)) == 0) {
+            continue;
+        }
+        JoystickCalibration* cal = joystickAxis(axis);
+        portENTER_CRITICAL(&lutLock_);
+        cal->lut = pendingLuts_[axis];
+        portEXIT_CRITICAL(&lutLock_);
+        cal->filtered = 0.0f;
+        if (!cal->lut.valid) {
+            cal->initialized = false;   // Back to auto-centering from the next read
+        }
+    }
+}
+
+InputManager::JoystickCalibration* InputManager::joystickAxis(uint8_t axis) {
+    switch (axis) {
+        case AdcSampler::JOY_A_X: return &joyA_X_;
+        case AdcSampler::JOY_A_Y: return &joyA_Y_;
+        case AdcSampler::JOY_B_X: return &joyB_X_;
+        default:                  return &joyB_Y_;
+    }
 }
 
 void InputManager::setJoystickFiltering(bool enable) {
@@ -346,8 +546,25 @@ bool InputManager::isJoystickFilteringEnabled() const {
 // Helper Methods
 // ============================================================================
 
-float InputManager::readJoystickAxis(uint8_t pin, JoystickCalibration& cal) const {
-    int raw = analogRead(pin);
+void InputManager::latchAnalogInputs(uint16_t out[AdcSampler::CHANNEL_COUNT]) {
+    AdcSampler& sampler = AdcSampler::getInstance();
+    if (sampler.isRunning()) {
+        sampler.latch(out);
+        return;
+    }
+
+    // Fallback: one blocking conversion per channel
+    for (uint8_t i = 0; i < AdcSampler::CHANNEL_COUNT; ++i) {
+        out[i] = analogRead(AdcSampler::pinFor(static_cast<AdcSampler::Channel>(i)));
+    }
+}
+
+float InputManager::readJoystickAxis(uint16_t rawValue, JoystickCalibration& cal) {
+    if (cal.lut.valid) {
+        return readTableAxis(rawValue, cal);
+    }
+
+    int raw = rawValue;
 
     // Auto-calibrate center on first read
     if (!cal.initialized) {
@@ -392,19 +609,37 @@ float InputManager::readJoystickAxis(uint8_t pin, JoystickCalibration& cal) cons
     return value;
 }
 
-void InputManager::updateButtonState(ButtonState& state, uint8_t pin) {
-    uint32_t now = millis();
-
-    // Update previous state
-    state.previous = state.current;
+float InputManager::readTableAxis(uint16_t rawValue, JoystickCalibration& cal) {
+    const AxisLut& lut = cal.lut;
+    const int delta = static_cast<int>(rawValue) - lut.center;
+    const uint8_t side = delta > 0 ? 1 : 0;
+    const uint32_t distance = static_cast<uint32_t>(delta > 0 ? delta : -delta);
+
+    // Piecewise-linear lookup: segment and 12-bit fraction from one multiply
+    int32_t magnitude = AxisCalibration::kFullScale;
+    if (distance < lut.halfSpan[side]) {
+        const uint32_t position = distance * lut.scale[side];
+        const uint32_t segment = position >> 16;
+        const int32_t fraction = static_cast<int32_t>((position >> 4) & 0xFFF);
+        const int32_t low = lut.knots[side][segment];
+        const int32_t high = lut.knots[side][segment + 1];
+        magnitude = low + (((high - low) * fraction) >> 12);
+    }
 
-    // Read current state with debouncing
-    bool reading = digitalRead(pin) == LOW;
+    // Same deadzone (no rescale) and sensitivity as the float path
+    if (magnitude <= deadzoneQ15_) {
+        return 0.0f;
+    }
+    magnitude = (magnitude * sensitivityQ8_) >> 8;
+    if (magnitude > AxisCalibration::kFullScale) {
+        magnitude = AxisCalibration::kFullScale;
+    }
+    float value = (side ? magnitude : -magnitude) * kQ15ToFloat;
 
-    if (reading != state.current) {
-        if (now - state.lastChangeTime >= kDebounceMs) {
-            state.current = reading;
-            state.lastChangeTime = now;
-        }
+    if (filteringEnabled_) {
+        cal.filtered = cal.filtered * (1.0f - kFilterAlpha) + value * kFilterAlpha;
+        value = cal.filtered;
     }
+
+    return value;
 }
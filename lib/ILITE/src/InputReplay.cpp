@@ -0,0 +1,463 @@
+/**
+ * @file InputReplay.cpp
+ * @brief Replay stream decoding, tick feeding and command comparison
+ */
+
+#include "InputReplay.h"
+#include "Framing.h"
+#include "MpscQueue.h"
+#include "PacketRouter.h"
+#include "TelemetryTap.h"
+#include <esp_timer.h>
+#include <cstring>
+#include <new>
+
+std::atomic<bool> InputReplay::receiving_{false};
+std::atomic<bool> InputReplay::active_{false};
+InputReplayStats InputReplay::stats_;
+
+const uint32_t InputReplay::kBucketUs[kReplayLatencyBuckets] = {
+    100, 200, 500, 1000, 2000, 5000, 10000, UINT32_MAX
+};
+
+namespace {
+
+constexpr size_t kMaxBody = TelemetryTap::kMaxPayload + 1;     // typeIndex + packet
+constexpr size_t kMaxFrame = 1 + 4 + kMaxBody + 2;             // kind, time, body, crc
+constexpr size_t kMaxProduced = 8;                             // Command types per tick
+const uint8_t kReplayMac[6] = {0, 0, 0, 0, 0, 0};              // Matches no team route
+
+struct ReplayRecord {
+    uint8_t kind;
+    uint8_t length;             ///< Bytes used in body
+    uint32_t timeUs;
+    uint8_t body[kMaxBody];
+};
+
+// A command the replay produced, waiting for its recorded counterpart
+struct ProducedCommand {
+    uint8_t typeIndex;
+    bool checked;
+    uint16_t length;
+    uint16_t crc;
+};
+
+using ReplayQueue = MpscQueue<ReplayRecord, InputReplay::kQueueSize>;
+
+ReplayQueue* queue = nullptr;   // Allocated by start(), kept for later replays
+
+// ServiceTask only
+uint8_t frame[kMaxFrame];
+size_t frameLength = 0;
+bool frameOverflow = false;
+uint8_t cobsCode = 0;           // Bytes left in the current COBS block
+bool cobsBlockFull = false;     // The block was 0xFF: no implied zero follows
+bool cobsStarted = false;       // A code byte of this frame has been seen
+uint32_t lastByteMs = 0;
+bool reported = true;
+
+// CommTask only
+ProducedCommand produced[kMaxProduced];
+size_t producedCount = 0;
+uint32_t lastInputUs = 0;
+bool haveLastInput = false;
+int encoderOffset = 0;
+uint32_t latencyTick = 0;
+uint64_t latencySumUs = 0;
+uint32_t latencySamples = 0;
+std::atomic<bool> finished{false};
+
+using Framing::crc16;
+using Framing::getU16;
+using Framing::getU32;
+using Framing::putU16;
+using Framing::putU32;
+
+void putFloat(uint8_t* out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+float getFloat(const uint8_t* in) {
+    const uint32_t bits = getU32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void pushRecord(const ReplayRecord& record, InputReplayStats& stats) {
+    if (!queue->push(record)) {
+        stats.overflows++;
+    }
+}
+
+void pushEnd(InputReplayStats& stats) {
+    ReplayRecord record;
+    record.kind = TelemetryTap::FRAME_END;
+    record.length = 0;
+    record.timeUs = 0;
+    pushRecord(record, stats);
+}
+
+// A complete decoded frame: kind, time, body, crc
+void acceptFrame(InputReplayStats& stats) {
+    if (frameOverflow || frameLength < 7) {
+        stats.badFrames++;
+        return;
+    }
+    const size_t bodyLength = frameLength - 7;
+    if (crc16(frame, frameLength - 2) != getU16(frame + frameLength - 2)) {
+        stats.badFrames++;     // Console text or a corrupted frame
+        return;
+    }
+
+    const uint8_t kind = frame[0];
+    switch (kind) {
+        case TelemetryTap::FRAME_INPUT:
+        case TelemetryTap::FRAME_RX:
+        case TelemetryTap::FRAME_TX: {
+            if (bodyLength < 1 || bodyLength > kMaxBody) {
+                stats.badFrames++;
+                return;
+            }
+            ReplayRecord record;
+            record.kind = kind;
+            record.length = static_cast<uint8_t>(bodyLength);
+            record.timeUs = getU32(frame + 1);
+            memcpy(record.body, frame + 5, bodyLength);
+            pushRecord(record, stats);
+            break;
+        }
+        case TelemetryTap::FRAME_DROPPED:
+            stats.recordingGaps += bodyLength >= 4 ? getU32(frame + 5) : 1;
+            break;
+        case TelemetryTap::FRAME_END:
+            pushEnd(stats);
+            break;
+    }
+}
+
+// Close the previous tick: commands nobody recorded
+void settleTick(InputReplayStats& stats) {
+    for (size_t i = 0; i < producedCount; ++i) {
+        if (!produced[i].checked) {
+            stats.extra++;
+            if (stats.firstMismatchTick == 0) {
+                stats.firstMismatchTick = stats.ticks;
+            }
+        }
+    }
+    producedCount = 0;
+}
+
+void checkRecordedCommand(const ReplayRecord& record, InputReplayStats& stats) {
+    const uint8_t typeIndex = record.body[0];
+    const uint16_t length = static_cast<uint16_t>(record.length - 1);
+    const uint16_t crc = crc16(record.body + 1, length);
+    for (size_t i = 0; i < producedCount; ++i) {
+        ProducedCommand& command = produced[i];
+        if (command.checked || command.typeIndex != typeIndex) {
+            continue;
+        }
+        command.checked = true;
+        if (command.length == length && command.crc == crc) {
+            stats.matched++;
+            return;
+        }
+        stats.mismatched++;
+        if (stats.firstMismatchTick == 0) {
+            stats.firstMismatchTick = stats.ticks;
+        }
+        return;
+    }
+    stats.missing++;
+    if (stats.firstMismatchTick == 0) {
+        stats.firstMismatchTick = stats.ticks;
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Snapshot Encoding
+// ============================================================================
+
+void InputReplay::encodeSnapshot(const InputSnapshot& snapshot, uint8_t* out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < AdcSampler::CHANNEL_COUNT; ++i) {
+        putU16(out + pos, snapshot.raw[i]);
+        pos += 2;
+    }
+    putFloat(out + pos, snapshot.joystickA_X);
+    putFloat(out + pos + 4, snapshot.joystickA_Y);
+    putFloat(out + pos + 8, snapshot.joystickB_X);
+    putFloat(out + pos + 12, snapshot.joystickB_Y);
+    putFloat(out + pos + 16, snapshot.potentiometer);
+    pos += 20;
+    out[pos++] = snapshot.buttons;
+    out[pos++] = snapshot.debounced;
+    out[pos++] = snapshot.pressed;
+    putU32(out + pos, static_cast<uint32_t>(snapshot.encoderCount));
+}
+
+bool InputReplay::decodeSnapshot(const uint8_t* data, size_t length, InputSnapshot& out) {
+    if (data == nullptr || length < kSnapshotSize) {
+        return false;
+    }
+    memset(&out, 0, sizeof(out));
+    size_t pos = 0;
+    for (size_t i = 0; i < AdcSampler::CHANNEL_COUNT; ++i) {
+        out.raw[i] = getU16(data + pos);
+        pos += 2;
+    }
+    out.joystickA_X = getFloat(data + pos);
+    out.joystickA_Y = getFloat(data + pos + 4);
+    out.joystickB_X = getFloat(data + pos + 8);
+    out.joystickB_Y = getFloat(data + pos + 12);
+    out.potentiometer = getFloat(data + pos + 16);
+    pos += 20;
+    out.buttons = data[pos++];
+    out.debounced = data[pos++];
+    out.pressed = data[pos++];
+    out.encoderCount = static_cast<int>(getU32(data + pos));
+    return true;
+}
+
+// ============================================================================
+// Receiving (ServiceTask)
+// ============================================================================
+
+bool InputReplay::start() {
+    if (isActive()) {
+        Serial.println("[Replay] Already running");
+        return false;
+    }
+    if (queue == nullptr) {
+        queue = new (std::nothrow) ReplayQueue();
+        if (queue == nullptr) {
+            Serial.println("[Replay] Out of memory for the frame queue");
+            return false;
+        }
+    }
+    ReplayRecord stale;
+    while (queue->pop(stale)) {
+    }
+
+    stats_ = InputReplayStats{};
+    frameLength = 0;
+    frameOverflow = false;
+    cobsCode = 0;
+    cobsStarted = false;
+    lastByteMs = millis();
+    reported = false;
+
+    producedCount = 0;
+    haveLastInput = false;
+    encoderOffset = 0;
+    latencyTick = 0;
+    latencySumUs = 0;
+    latencySamples = 0;
+    finished.store(false);
+
+    receiving_.store(true, std::memory_order_relaxed);
+    active_.store(true, std::memory_order_release);
+    Serial.println("[Replay] Receiving; send the recording now");
+    return true;
+}
+
+void InputReplay::feed(uint8_t byte) {
+    lastByteMs = millis();
+
+    if (byte == 0x00) {
+        // Delimiter: a frame is complete when its last block was
+        if (cobsStarted && cobsCode == 0) {
+            acceptFrame(stats_);
+        } else if (cobsStarted) {
+            stats_.badFrames++;
+        }
+        frameLength = 0;
+        frameOverflow = false;
+        cobsCode = 0;
+        cobsStarted = false;
+        return;
+    }
+
+    if (cobsCode == 0) {
+        // Code byte: the previous block ends in an implied zero unless it was full
+        if (cobsStarted && !cobsBlockFull) {
+            if (frameLength < sizeof(frame)) {
+                frame[frameLength++] = 0x00;
+            } else {
+                frameOverflow = true;
+            }
+        }
+        cobsCode = static_cast<uint8_t>(byte - 1);
+        cobsBlockFull = byte == 0xFF;
+        cobsStarted = true;
+        return;
+    }
+
+    if (frameLength < sizeof(frame)) {
+        frame[frameLength++] = byte;
+    } else {
+        frameOverflow = true;
+    }
+    cobsCode--;
+}
+
+void InputReplay::service(uint32_t nowMs) {
+    if (isReceiving()) {
+        if (nowMs - lastByteMs >= kIdleTimeoutMs) {
+            Serial.println("[Replay] Host quiet; finishing");
+            pushEnd(stats_);
+            receiving_.store(false, std::memory_order_relaxed);
+        } else if (finished.load()) {
+            receiving_.store(false, std::memory_order_relaxed);
+        }
+    }
+    if (!reported && finished.load()) {
+        reported = true;
+        dump(Serial);
+    }
+}
+
+// ============================================================================
+// Ticks (CommTask)
+// ============================================================================
+
+bool InputReplay::nextTick(InputSnapshot& out, float& dtSeconds) {
+    if (!isActive() || queue == nullptr) {
+        return false;
+    }
+
+    ReplayRecord record;
+    while (queue->pop(record)) {
+        switch (record.kind) {
+            case TelemetryTap::FRAME_RX:
+                if (record.length > 1) {
+                    PacketRouter::getInstance().routePacket(kReplayMac, record.body + 1,
+                                                            record.length - 1);
+                    stats_.telemetry++;
+                }
+                break;
+
+            case TelemetryTap::FRAME_TX:
+                if (record.length > 1) {
+                    checkRecordedCommand(record, stats_);
+                }
+                break;
+
+            case TelemetryTap::FRAME_INPUT: {
+                InputSnapshot recorded;
+                if (record.body[0] != kFormatVersion ||
+                    !decodeSnapshot(record.body + 1, record.length - 1, recorded)) {
+                    stats_.badFrames++;
+                    break;
+                }
+                settleTick(stats_);
+                if (!haveLastInput) {
+                    // Continue from the count modules last saw, so the first delta is 0
+                    encoderOffset = InputManager::getInstance().getEncoderCount() -
+                                    recorded.encoderCount;
+                    dtSeconds = 0.0f;
+                } else {
+                    dtSeconds = (record.timeUs - lastInputUs) / 1000000.0f;
+                }
+                recorded.encoderCount += encoderOffset;
+                lastInputUs = record.timeUs;
+                haveLastInput = true;
+                stats_.ticks++;
+                out = recorded;
+                return true;
+            }
+
+            case TelemetryTap::FRAME_END:
+                settleTick(stats_);
+                active_.store(false, std::memory_order_release);
+                finished.store(true);
+                return false;
+        }
+    }
+
+    stats_.stalls++;
+    return false;
+}
+
+void InputReplay::onCommand(uint8_t typeIndex, const uint8_t* data, size_t length,
+                            uint32_t inputUs) {
+    if (!isActive() || data == nullptr) {
+        return;
+    }
+
+    // First command of the tick: snapshot -> command latency
+    if (latencyTick != stats_.ticks) {
+        latencyTick = stats_.ticks;
+        const uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time()) - inputUs;
+        InputReplayStats& stats = stats_;
+        if (latencySamples == 0 || latencyUs < stats.minUs) {
+            stats.minUs = latencyUs;
+        }
+        if (latencyUs > stats.maxUs) {
+            stats.maxUs = latencyUs;
+        }
+        latencySumUs += latencyUs;
+        latencySamples++;
+        stats.avgUs = static_cast<uint32_t>(latencySumUs / latencySamples);
+        size_t bucket = 0;
+        while (latencyUs > kBucketUs[bucket] && bucket < kReplayLatencyBuckets - 1) {
+            ++bucket;
+        }
+        stats.histogram[bucket]++;
+    }
+
+    if (producedCount < kMaxProduced) {
+        ProducedCommand& command = produced[producedCount++];
+        command.typeIndex = typeIndex;
+        command.checked = false;
+        command.length = static_cast<uint16_t>(length);
+        command.crc = crc16(data, length);
+    } else {
+        stats_.extra++;
+    }
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+void InputReplay::dump(Print& out) {
+    const InputReplayStats& stats = stats_;
+    const uint32_t compared = stats.matched + stats.mismatched + stats.missing + stats.extra;
+    out.printf("[Replay] %s ticks=%lu stalls=%lu telemetry=%lu\n",
+               isActive() ? "running" : "done",
+               static_cast<unsigned long>(stats.ticks),
+               static_cast<unsigned long>(stats.stalls),
+               static_cast<unsigned long>(stats.telemetry));
+    out.printf("[Replay] commands: matched=%lu mismatched=%lu missing=%lu extra=%lu -> %s",
+               static_cast<unsigned long>(stats.matched),
+               static_cast<unsigned long>(stats.mismatched),
+               static_cast<unsigned long>(stats.missing),
+               static_cast<unsigned long>(stats.extra),
+               compared == 0 ? "NOTHING COMPARED"
+                             : (compared == stats.matched ? "IDENTICAL" : "DIFFERENT"));
+    if (stats.firstMismatchTick != 0) {
+        out.printf(" (first at tick %lu)", static_cast<unsigned long>(stats.firstMismatchTick));
+    }
+    out.println();
+    out.printf("[Replay] input->command us: min=%lu avg=%lu max=%lu\n",
+               static_cast<unsigned long>(stats.minUs),
+               static_cast<unsigned long>(stats.avgUs),
+               static_cast<unsigned long>(stats.maxUs));
+    out.print("[Replay] hist (<=0.1/0.2/0.5/1/2/5/10/+ ms):");
+    for (size_t i = 0; i < kReplayLatencyBuckets; ++i) {
+        out.printf(" %lu", static_cast<unsigned long>(stats.histogram[i]));
+    }
+    out.println();
+    if (stats.badFrames != 0 || stats.overflows != 0 || stats.recordingGaps != 0) {
+        out.printf("[Replay] bad frames=%lu overflows=%lu recording gaps=%lu\n",
+                   static_cast<unsigned long>(stats.badFrames),
+                   static_cast<unsigned long>(stats.overflows),
+                   static_cast<unsigned long>(stats.recordingGaps));
+    }
+}
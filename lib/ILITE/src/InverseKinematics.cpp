@@ -6,6 +6,12 @@
 namespace IKEngine {
 
 namespace {
+#ifdef ILITE_KINEMATICS_Q16
+typedef Kinematics::Q16 Scalar;     // For targets without an FPU
+#else
+typedef float Scalar;
+#endif
+
 constexpr float kPi = 3.14159265358979323846f;
 constexpr float kDegPerRad = 180.0f / kPi;
 
@@ -23,14 +29,32 @@ inline float clampf(float value, float minValue, float maxValue) {
     return value;
 }
 
-inline float length(const Vec3& v) {
-    return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
-}
-
 inline bool isFiniteVec(const Vec3& v) {
     return isfinite(v.x) && isfinite(v.y) && isfinite(v.z);
 }
 
+// Advance sin/cos of an angle by a small step (|step| <= kMaxStepRad)
+inline void rotateTrig(float& sinA, float& cosA, float step) {
+    const float step2 = step * step;
+    const float sinStep = step * (1.0f - step2 * (1.0f / 6.0f));
+    const float cosStep = 1.0f - step2 * (0.5f - step2 * (1.0f / 24.0f));
+    const float sinNew = sinA * cosStep + cosA * sinStep;
+    const float cosNew = cosA * cosStep - sinA * sinStep;
+    // First-order renormalisation keeps repeated steps from drifting
+    const float norm = 1.5f - 0.5f * (sinNew * sinNew + cosNew * cosNew);
+    sinA = sinNew * norm;
+    cosA = cosNew * norm;
+}
+
+JointTrig trigFor(float shoulderRad, float elbowRad) {
+    JointTrig trig;
+    trig.sinShoulder = Kinematics::sinFast(shoulderRad);
+    trig.cosShoulder = Kinematics::cosFast(shoulderRad);
+    trig.sinElbow = Kinematics::sinFast(elbowRad);
+    trig.cosElbow = Kinematics::cosFast(elbowRad);
+    return trig;
+}
+
 } // namespace
 
 InverseKinematics::InverseKinematics(const IKConfiguration& config)
@@ -42,10 +66,14 @@ const IKConfiguration& InverseKinematics::getConfiguration() const {
 
 void InverseKinematics::setConfiguration(const IKConfiguration& config) {
     config_ = config;
+    revision_++;
 }
 
 void InverseKinematics::setExtensionEnabled(bool enabled) {
-    extensionEnabled_ = enabled;
+    if (extensionEnabled_ != enabled) {
+        extensionEnabled_ = enabled;
+        revision_++;
+    }
 }
 
 bool InverseKinematics::isExtensionEnabled() const {
@@ -56,12 +84,7 @@ Vec3 InverseKinematics::normalise(const Vec3& value, float epsilon) {
     if (!isFiniteVec(value)) {
         return Vec3{1.0f, 0.0f, 0.0f};
     }
-    const float magnitude = length(value);
-    if (magnitude <= epsilon) {
-        return Vec3{1.0f, 0.0f, 0.0f};
-    }
-    const float invMag = 1.0f / magnitude;
-    return Vec3{value.x * invMag, value.y * invMag, value.z * invMag};
+    return value.normalized(epsilon, Vec3{1.0f, 0.0f, 0.0f});
 }
 
 bool InverseKinematics::solvePlanar(float horizontalMm,
@@ -78,15 +101,6 @@ bool InverseKinematics::solvePlanar(float horizontalMm,
 
     const float L1 = config_.dimensions.shoulderLengthMm;
     const float L2Base = config_.dimensions.elbowLengthMm;
-    const float configuredExtMin = std::min(config_.elbowExtension.minMm, config_.elbowExtension.maxMm);
-    const float configuredExtMax = std::max(config_.elbowExtension.minMm, config_.elbowExtension.maxMm);
-    const float extMin = extensionEnabled_ ? configuredExtMin : 0.0f;
-    const float extMax = extensionEnabled_ ? configuredExtMax : 0.0f;
-    const float shoulderMin = std::min(config_.shoulder.minDeg, config_.shoulder.maxDeg);
-    const float shoulderMax = std::max(config_.shoulder.minDeg, config_.shoulder.maxDeg);
-    const float elbowMin = std::min(config_.elbow.minDeg, config_.elbow.maxDeg);
-    const float elbowMax = std::max(config_.elbow.minDeg, config_.elbow.maxDeg);
-
     bool constrained = false;
 
     float planarX = horizontalMm;
@@ -100,32 +114,43 @@ bool InverseKinematics::solvePlanar(float horizontalMm,
         outSolution.constrained = true;
         return false;
     }
-    float extensionMm = clampf(extensionOverrideMm, extMin, extMax);
+    const float extensionMm = clampExtension(extensionOverrideMm);
     const float L2 = L2Base + extensionMm;
 
-    float distance = sqrtf(planarX * planarX + vertical * vertical);
-    const float reachMin = fabsf(L1 - L2);
-    const float reachMax = L1 + L2;
-    float distanceEval = clampf(distance, reachMin, reachMax);
-    if (fabsf(distanceEval - distance) > 1e-3f) {
+    const Kinematics::TwoLinkResult<Scalar> triangle = Kinematics::solveTwoLink<Scalar>(
+        Scalar(L1), Scalar(L2), Scalar(planarX), Scalar(vertical), Scalar(config_.geometryEpsilonMm));
+    if (triangle.distanceClamped) {
         constrained = true;
     }
-    distanceEval = fmaxf(distanceEval, config_.geometryEpsilonMm);
+    const float distanceEval = Kinematics::toFloat(triangle.distance);
+    float shoulderDeg = toDegrees(Kinematics::toFloat(triangle.angleToTarget + triangle.shoulderOffset));
+    float elbowDeg = toDegrees(Kinematics::toFloat(triangle.elbowInterior));
+
+    return completeSolution(shoulderDeg, elbowDeg, extensionMm, distanceEval, constrained, outSolution);
+}
 
-    const float angleToTarget = (distanceEval > config_.geometryEpsilonMm)
-                                    ? atan2f(vertical, planarX)
-                                    : 0.0f;
-    float cosShoulder = (L1 * L1 + distanceEval * distanceEval - L2 * L2) /
-                        (2.0f * L1 * distanceEval);
-    cosShoulder = clampf(cosShoulder, -1.0f, 1.0f);
-    float shoulderRad = angleToTarget + acosf(cosShoulder);
-    float shoulderDeg = toDegrees(shoulderRad);
+float InverseKinematics::clampExtension(float extensionMm) const {
+    if (!extensionEnabled_) {
+        return 0.0f;
+    }
+    return clampf(extensionMm,
+                  std::min(config_.elbowExtension.minMm, config_.elbowExtension.maxMm),
+                  std::max(config_.elbowExtension.minMm, config_.elbowExtension.maxMm));
+}
 
-    float cosElbow = (L1 * L1 + L2 * L2 - distanceEval * distanceEval) /
-                     (2.0f * L1 * L2);
-    cosElbow = clampf(cosElbow, -1.0f, 1.0f);
-    float elbowRad = acosf(cosElbow);
-    float elbowDeg = toDegrees(elbowRad);
+bool InverseKinematics::completeSolution(float shoulderDeg,
+                                         float elbowDeg,
+                                         float extensionMm,
+                                         float distanceMm,
+                                         bool constrained,
+                                         IKSolution& outSolution,
+                                         const JointTrig* trig) const {
+    const float L1 = config_.dimensions.shoulderLengthMm;
+    const float L2 = config_.dimensions.elbowLengthMm + extensionMm;
+    const float shoulderMin = std::min(config_.shoulder.minDeg, config_.shoulder.maxDeg);
+    const float shoulderMax = std::max(config_.shoulder.minDeg, config_.shoulder.maxDeg);
+    const float elbowMin = std::min(config_.elbow.minDeg, config_.elbow.maxDeg);
+    const float elbowMax = std::max(config_.elbow.minDeg, config_.elbow.maxDeg);
 
     float shoulderClamped = clampf(shoulderDeg, shoulderMin, shoulderMax);
     float elbowClamped = clampf(elbowDeg, elbowMin, elbowMax);
@@ -133,14 +158,25 @@ bool InverseKinematics::solvePlanar(float horizontalMm,
         constrained = true;
     }
 
-    shoulderRad = shoulderClamped * DEG_TO_RAD;
-    elbowRad = elbowClamped * DEG_TO_RAD;
-    float elbowAbsRad = shoulderRad - elbowRad;
+    JointTrig clampedTrig;
+    if (trig == nullptr || constrained) {
+        const float shoulderRad = shoulderClamped * DEG_TO_RAD;
+        const float elbowRad = elbowClamped * DEG_TO_RAD;
+        clampedTrig.sinShoulder = Kinematics::sinFast(shoulderRad);
+        clampedTrig.cosShoulder = Kinematics::cosFast(shoulderRad);
+        clampedTrig.sinElbow = Kinematics::sinFast(elbowRad);
+        clampedTrig.cosElbow = Kinematics::cosFast(elbowRad);
+        trig = &clampedTrig;
+    }
+
+    // Forearm direction is shoulder - elbow
+    const float sinAbs = trig->sinShoulder * trig->cosElbow - trig->cosShoulder * trig->sinElbow;
+    const float cosAbs = trig->cosShoulder * trig->cosElbow + trig->sinShoulder * trig->sinElbow;
 
-    float elbowLocalX = L1 * cosf(shoulderRad);
-    float elbowLocalY = L1 * sinf(shoulderRad);
-    float wristLocalX = elbowLocalX + L2 * cosf(elbowAbsRad);
-    float wristLocalY = elbowLocalY + L2 * sinf(elbowAbsRad);
+    float elbowLocalX = L1 * trig->cosShoulder;
+    float elbowLocalY = L1 * trig->sinShoulder;
+    float wristLocalX = elbowLocalX + L2 * cosAbs;
+    float wristLocalY = elbowLocalY + L2 * sinAbs;
 
     Vec3 elbowWorld{elbowLocalX, elbowLocalY, 0.0f};
     Vec3 wristWorld{wristLocalX, wristLocalY, 0.0f};
@@ -158,7 +194,7 @@ bool InverseKinematics::solvePlanar(float horizontalMm,
     outSolution.joints.gripperYawDeg = 90.0f;
     outSolution.joints.gripperRollDeg = config_.defaultGripperRollDeg;
     outSolution.forearmLengthMm = L2;
-    outSolution.wristDistanceMm = distanceEval;
+    outSolution.wristDistanceMm = distanceMm;
     outSolution.wristTarget = wristWorld;
     outSolution.toolDirection = normalise(forearmDir, config_.toolDirectionEpsilonMm);
     outSolution.constrained = constrained;
@@ -166,6 +202,183 @@ bool InverseKinematics::solvePlanar(float horizontalMm,
     return outSolution.reachable;
 }
 
-} // namespace IKEngine
+ArmPose InverseKinematics::forwardPlanar(float shoulderDeg, float elbowDeg, float extensionMm) const {
+    const float shoulderRad = shoulderDeg * DEG_TO_RAD;
+    // Forearm direction is shoulder - elbow
+    const float forearmRad = (shoulderDeg - elbowDeg) * DEG_TO_RAD;
+    const float cosShoulder = Kinematics::cosFast(shoulderRad);
+    const float sinShoulder = Kinematics::sinFast(shoulderRad);
+    const float cosForearm = Kinematics::cosFast(forearmRad);
+    const float sinForearm = Kinematics::sinFast(forearmRad);
+
+    // A negative extension shortens the rigid section instead
+    const float rigidMm = std::max(config_.dimensions.elbowLengthMm + std::min(extensionMm, 0.0f), 0.0f);
+    const float forearmMm = config_.dimensions.elbowLengthMm + extensionMm;
+
+    ArmPose pose;
+    pose.elbow = Vec3(config_.dimensions.shoulderLengthMm * cosShoulder,
+                      config_.dimensions.shoulderLengthMm * sinShoulder, 0.0f);
+    pose.extensionBase = pose.elbow + Vec3(rigidMm * cosForearm, rigidMm * sinForearm, 0.0f);
+    pose.wrist = pose.elbow + Vec3(forearmMm * cosForearm, forearmMm * sinForearm, 0.0f);
+    return pose;
+}
+
+void InverseKinematics::collisionChain(const ArmPose& pose, float baseYawDeg, Vec3 out[kCollisionJoints]) const {
+    const float yawRad = baseYawDeg * DEG_TO_RAD;
+    const float cosYaw = Kinematics::cosFast(yawRad);
+    const float sinYaw = Kinematics::sinFast(yawRad);
+    const Vec3 forearm = pose.wrist - pose.elbow;
+    const float forearmMm = forearm.magnitude();
+    const float toolMm = config_.dimensions.wristChainLength() + config_.dimensions.gripperLengthMm;
+    const Vec3 tip = forearmMm > config_.geometryEpsilonMm
+                         ? pose.wrist + forearm * (toolMm / forearmMm)
+                         : pose.wrist;
+
+    // Planar x is horizontal reach along the base heading, planar y is up
+    const Vec3 planar[kCollisionJoints] = {Vec3(), pose.elbow, pose.wrist, tip};
+    for (size_t i = 0; i < kCollisionJoints; ++i) {
+        out[i] = Vec3(planar[i].x * cosYaw, planar[i].x * sinYaw, planar[i].y);
+    }
+}
 
+// ============================================================================
+// IncrementalSolver
+// ============================================================================
 
+IncrementalSolver::IncrementalSolver(const InverseKinematics& solver)
+    : solver_(solver) {}
+
+bool IncrementalSolver::solvePlanar(const Vec3& planarTarget,
+                                    float extensionOverrideMm,
+                                    IKSolution& outSolution) {
+    const float extensionMm = solver_.clampExtension(extensionOverrideMm);
+    const bool sameRevision = valid_ && revision_ == solver_.getRevision();
+
+    if (sameRevision && planarTarget.x == target_.x && planarTarget.y == target_.y &&
+        extensionMm == extensionMm_) {
+        stats_.cacheHits++;
+        outSolution = cached_;
+        return result_;
+    }
+
+    // Only step from an exact (unclamped) previous solution
+    if (sameRevision && result_ && tryIncremental(planarTarget, extensionMm, outSolution)) {
+        stats_.incremental++;
+        return true;
+    }
+
+    stats_.fullSolves++;
+    const bool result = solver_.solvePlanar(planarTarget, extensionOverrideMm, outSolution);
+    const float shoulderRad = outSolution.joints.shoulderDeg * DEG_TO_RAD;
+    const float elbowRad = outSolution.joints.elbowDeg * DEG_TO_RAD;
+    remember(planarTarget, extensionMm, shoulderRad, elbowRad,
+             trigFor(shoulderRad, elbowRad), outSolution, result);
+    return result;
+}
+
+bool IncrementalSolver::tryIncremental(const Vec3& planarTarget, float extensionMm,
+                                       IKSolution& outSolution) {
+    const float dExt = extensionMm - extensionMm_;
+    if (planarTarget.x < 0.0f || !isfinite(planarTarget.x) || !isfinite(planarTarget.y) ||
+        fabsf(planarTarget.x - target_.x) + fabsf(planarTarget.y - target_.y) + fabsf(dExt) > kMaxStepMm ||
+        fabsf(trig_.sinElbow) < kMinElbowSin) {
+        return false;
+    }
+
+    // Planar wrist = L1*u(s) - L2*u(s + e), s = shoulder, e = interior elbow angle
+    const IKConfiguration& config = solver_.getConfiguration();
+    const float L1 = config.dimensions.shoulderLengthMm;
+    const float L2 = config.dimensions.elbowLengthMm + extensionMm;
+    const float L1L2 = L1 * L2;
+
+    JointTrig trig = trig_;
+    float shoulderRad = shoulderRad_;
+    float elbowRad = elbowRad_;
+
+    // Newton step, then one chord correction with the same Jacobian
+    float s12 = trig.sinShoulder * trig.cosElbow + trig.cosShoulder * trig.sinElbow;
+    float c12 = trig.cosShoulder * trig.cosElbow - trig.sinShoulder * trig.sinElbow;
+    const float j00 = -L1 * trig.sinShoulder + L2 * s12;
+    const float j01 = L2 * s12;
+    const float j10 = L1 * trig.cosShoulder - L2 * c12;
+    const float j11 = -L2 * c12;
+    const float invDet = -1.0f / (L1L2 * trig.sinElbow);
+
+    float errX = planarTarget.x - (L1 * trig.cosShoulder - L2 * c12);
+    float errY = planarTarget.y - (L1 * trig.sinShoulder - L2 * s12);
+    for (int pass = 0; pass < 2; ++pass) {
+        const float ds = (j11 * errX - j01 * errY) * invDet;
+        const float de = (-j10 * errX + j00 * errY) * invDet;
+        if (fabsf(ds) > kMaxStepRad || fabsf(de) > kMaxStepRad) {
+            return false;
+        }
+        shoulderRad += ds;
+        elbowRad += de;
+        rotateTrig(trig.sinShoulder, trig.cosShoulder, ds);
+        rotateTrig(trig.sinElbow, trig.cosElbow, de);
+
+        s12 = trig.sinShoulder * trig.cosElbow + trig.cosShoulder * trig.sinElbow;
+        c12 = trig.cosShoulder * trig.cosElbow - trig.sinShoulder * trig.sinElbow;
+        errX = planarTarget.x - (L1 * trig.cosShoulder - L2 * c12);
+        errY = planarTarget.y - (L1 * trig.sinShoulder - L2 * s12);
+    }
+    if (errX * errX + errY * errY > kToleranceMm * kToleranceMm ||
+        fabsf(trig.sinElbow) < kMinElbowSin) {
+        return false;
+    }
+
+    const float distanceMm = Kinematics::sqrtScalar(planarTarget.x * planarTarget.x +
+                                                    planarTarget.y * planarTarget.y);
+    IKSolution solution;
+    if (!solver_.completeSolution(shoulderRad * RAD_TO_DEG, elbowRad * RAD_TO_DEG,
+                                  extensionMm, distanceMm, false, solution, &trig)) {
+        return false;   // At a joint limit: let the full solve report it
+    }
+
+    remember(planarTarget, extensionMm, shoulderRad, elbowRad, trig, solution, true);
+    outSolution = solution;
+    return true;
+}
+
+void IncrementalSolver::remember(const Vec3& planarTarget, float extensionMm,
+                                 float shoulderRad, float elbowRad, const JointTrig& trig,
+                                 const IKSolution& solution, bool result) {
+    cached_ = solution;
+    trig_ = trig;
+    target_ = planarTarget;
+    extensionMm_ = extensionMm;
+    shoulderRad_ = shoulderRad;
+    elbowRad_ = elbowRad;
+    revision_ = solver_.getRevision();
+    result_ = result;
+    valid_ = true;
+}
+
+// ============================================================================
+// ForwardCache
+// ============================================================================
+
+ForwardCache::ForwardCache(const InverseKinematics& solver)
+    : solver_(solver) {}
+
+bool ForwardCache::update(float shoulderDeg, float elbowDeg, float extensionMm) {
+    const int32_t shoulderKey = lroundf(shoulderDeg * (1.0f / kQuantumDeg));
+    const int32_t elbowKey = lroundf(elbowDeg * (1.0f / kQuantumDeg));
+    const int32_t extensionKey = lroundf(extensionMm * (1.0f / kQuantumMm));
+    if (valid_ && revision_ == solver_.getRevision() && shoulderKey == shoulderKey_ &&
+        elbowKey == elbowKey_ && extensionKey == extensionKey_) {
+        stats_.hits++;
+        return false;
+    }
+
+    pose_ = solver_.forwardPlanar(shoulderDeg, elbowDeg, extensionMm);
+    shoulderKey_ = shoulderKey;
+    elbowKey_ = elbowKey;
+    extensionKey_ = extensionKey;
+    revision_ = solver_.getRevision();
+    valid_ = true;
+    stats_.updates++;
+    return true;
+}
+
+} // namespace IKEngine
@@ -0,0 +1,327 @@
+/**
+ * @file JobQueue.cpp
+ * @brief Job table, priority pick and the worker task
+ */
+
+#include "JobQueue.h"
+#include "TaskMonitor.h"
+#include "LogChannels.h"
+#include <esp_timer.h>
+
+namespace {
+
+struct Job {
+    JobStats stats;
+    JobQueue::Step step;
+    JobQueue::Done done;
+    uint32_t order;                 // Turn within its priority, lowest first
+    uint32_t submittedMs;
+    bool started;
+    volatile bool cancelRequested;
+};
+
+const char* const kStateNames[] = {"-", "queued", "running", "done", "cancelled"};
+const char* const kPriorityNames[] = {"high", "normal", "low"};
+
+// Steps and done callbacks run outside the lock; g_current marks the slot
+// being run so cancel() can wait for it
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+Job g_jobs[JobQueue::kMaxJobs] = {};
+JobQueueStats g_stats;
+uint32_t g_order = 0;
+uint32_t g_generation = 0;
+int g_current = -1;
+TaskHandle_t g_runner = nullptr;    // Task running g_current
+TaskHandle_t g_worker = nullptr;
+
+size_t slotOf(JobId id) {
+    return id & 0xFF;
+}
+
+bool isLive(const Job& job) {
+    return job.stats.state == JobState::Queued || job.stats.state == JobState::Running;
+}
+
+// Under g_lock. A free slot first, else the one that ended longest ago
+int findSlot() {
+    int slot = -1;
+    for (size_t i = 0; i < JobQueue::kMaxJobs; ++i) {
+        const Job& job = g_jobs[i];
+        if (job.stats.state == JobState::None) {
+            return static_cast<int>(i);
+        }
+        if (!isLive(job) && (slot < 0 || job.order < g_jobs[slot].order)) {
+            slot = static_cast<int>(i);
+        }
+    }
+    return slot;
+}
+
+// Under g_lock. Highest priority with work left, then the oldest turn
+int pickJob() {
+    int slot = -1;
+    for (size_t i = 0; i < JobQueue::kMaxJobs; ++i) {
+        const Job& job = g_jobs[i];
+        if (!isLive(job) || job.cancelRequested) {
+            continue;
+        }
+        if (slot < 0 || job.stats.priority < g_jobs[slot].stats.priority ||
+            (job.stats.priority == g_jobs[slot].stats.priority && job.order < g_jobs[slot].order)) {
+            slot = static_cast<int>(i);
+        }
+    }
+    return slot;
+}
+
+// Under g_lock
+void finishJob(Job& job, JobState state, uint32_t nowMs) {
+    job.stats.state = state;
+    job.stats.elapsedMs = nowMs - job.submittedMs;
+    job.step = nullptr;
+    job.done = nullptr;
+    job.order = ++g_order;
+    if (state == JobState::Cancelled) {
+        g_stats.cancelled++;
+    } else {
+        g_stats.completed++;
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Worker
+// ============================================================================
+
+bool JobQueue::begin(BaseType_t core, UBaseType_t priority) {
+    if (g_worker != nullptr) {
+        return true;
+    }
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(workerTask, "JobWorker", kStackSize, nullptr, priority, &handle, core) != pdPASS) {
+        return false;
+    }
+    TaskMonitor::watch(handle, kStackSize, core);
+    g_worker = handle;
+    return true;
+}
+
+bool JobQueue::hasWorker() {
+    return g_worker != nullptr;
+}
+
+void JobQueue::workerTask(void* parameter) {
+    (void)parameter;
+    while (true) {
+        if (!runSlice(UINT32_MAX)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        // A tick for the idle task (and equal-priority tasks) between slices
+        vTaskDelay(1);
+    }
+}
+
+void JobQueue::runPending(uint32_t budgetUs) {
+    if (g_worker == nullptr) {
+        runSlice(budgetUs);
+    }
+}
+
+bool JobQueue::runSlice(uint32_t budgetUs) {
+    portENTER_CRITICAL(&g_lock);
+    const int slot = pickJob();
+    if (slot >= 0) {
+        g_current = slot;
+        g_runner = xTaskGetCurrentTaskHandle();
+        Job& picked = g_jobs[slot];
+        if (!picked.started) {
+            picked.started = true;
+            picked.stats.state = JobState::Running;
+            picked.stats.waitMs = millis() - picked.submittedMs;
+        }
+    }
+    portEXIT_CRITICAL(&g_lock);
+    if (slot < 0) {
+        return false;
+    }
+
+    // Only this task touches the job's callbacks and counters while g_current is set
+    Job& job = g_jobs[slot];
+    const uint32_t sliceUs = job.stats.sliceUs < budgetUs ? job.stats.sliceUs : budgetUs;
+    const int64_t sliceStartUs = esp_timer_get_time();
+    bool finished = false;
+    int64_t nowUs = sliceStartUs;
+    do {
+        const int64_t stepStartUs = nowUs;
+        finished = job.step();
+        nowUs = esp_timer_get_time();
+        const uint32_t stepUs = static_cast<uint32_t>(nowUs - stepStartUs);
+        job.stats.steps++;
+        job.stats.runUs += stepUs;
+        if (stepUs > job.stats.maxStepUs) {
+            job.stats.maxStepUs = stepUs;
+        }
+        if (stepUs > job.stats.sliceUs) {
+            g_stats.longSteps++;
+            ILITE_LOG_RATE(SYSTEM, LOG_WARN, 1, 3, "Job %s step took %lu us (slice %lu)", job.stats.name,
+                           static_cast<unsigned long>(stepUs), static_cast<unsigned long>(job.stats.sliceUs));
+        }
+    } while (!finished && !job.cancelRequested && nowUs - sliceStartUs < sliceUs);
+    job.stats.slices++;
+
+    if (finished && !job.cancelRequested && job.done) {
+        job.done();
+    }
+
+    portENTER_CRITICAL(&g_lock);
+    if (job.cancelRequested) {
+        finishJob(job, JobState::Cancelled, millis());
+    } else if (finished) {
+        finishJob(job, JobState::Done, millis());
+    } else {
+        job.order = ++g_order;
+    }
+    g_current = -1;
+    g_runner = nullptr;
+    portEXIT_CRITICAL(&g_lock);
+    return true;
+}
+
+// ============================================================================
+// Jobs
+// ============================================================================
+
+JobId JobQueue::submit(const char* name, JobPriority priority, Step step, uint32_t sliceUs, Done done) {
+    if (!step || priority >= JobPriority::Count) {
+        return 0;
+    }
+    const uint32_t now = millis();
+    JobId id = 0;
+    portENTER_CRITICAL(&g_lock);
+    const int slot = findSlot();
+    if (slot < 0) {
+        g_stats.rejected++;
+    } else {
+        if (++g_generation > 0xFFFFFF) {
+            g_generation = 1;
+        }
+        id = (g_generation << 8) | static_cast<uint32_t>(slot);
+        Job& job = g_jobs[slot];
+        job.stats = JobStats{};
+        job.stats.id = id;
+        job.stats.name = name != nullptr ? name : "?";
+        job.stats.priority = priority;
+        job.stats.state = JobState::Queued;
+        job.stats.sliceUs = sliceUs > 0 ? sliceUs : kDefaultSliceUs;
+        job.step = step;
+        job.done = done;
+        job.order = ++g_order;
+        job.submittedMs = now;
+        job.started = false;
+        job.cancelRequested = false;
+        g_stats.submitted++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (id == 0) {
+        ILITE_LOG_RATE(SYSTEM, LOG_WARN, 1, 3, "Job %s rejected: %u jobs queued", name != nullptr ? name : "?",
+                       static_cast<unsigned>(kMaxJobs));
+    } else if (g_worker != nullptr) {
+        xTaskNotifyGive(g_worker);
+    }
+    return id;
+}
+
+bool JobQueue::cancel(JobId id) {
+    const size_t slot = slotOf(id);
+    if (id == 0 || slot >= kMaxJobs) {
+        return false;
+    }
+
+    bool wait = false;
+    portENTER_CRITICAL(&g_lock);
+    Job& job = g_jobs[slot];
+    const bool live = job.stats.id == id && isLive(job) && !job.cancelRequested;
+    if (live) {
+        if (g_current == static_cast<int>(slot)) {
+            // Mid-step: the runner ends the job after the step
+            job.cancelRequested = true;
+            wait = g_runner != xTaskGetCurrentTaskHandle();
+        } else {
+            finishJob(job, JobState::Cancelled, millis());
+        }
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    while (wait) {
+        vTaskDelay(1);
+        portENTER_CRITICAL(&g_lock);
+        wait = g_current == static_cast<int>(slot);
+        portEXIT_CRITICAL(&g_lock);
+    }
+    return live;
+}
+
+JobState JobQueue::getState(JobId id) {
+    const size_t slot = slotOf(id);
+    if (id == 0 || slot >= kMaxJobs) {
+        return JobState::None;
+    }
+    portENTER_CRITICAL(&g_lock);
+    const JobState state = g_jobs[slot].stats.id == id ? g_jobs[slot].stats.state : JobState::None;
+    portEXIT_CRITICAL(&g_lock);
+    return state;
+}
+
+bool JobQueue::isActive(JobId id) {
+    const JobState state = getState(id);
+    return state == JobState::Queued || state == JobState::Running;
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+JobStats JobQueue::getJob(size_t slot) {
+    if (slot >= kMaxJobs) {
+        return JobStats{};
+    }
+    portENTER_CRITICAL(&g_lock);
+    JobStats stats = g_jobs[slot].stats;
+    const uint32_t submittedMs = g_jobs[slot].submittedMs;
+    portEXIT_CRITICAL(&g_lock);
+    if (stats.state == JobState::Queued || stats.state == JobState::Running) {
+        stats.elapsedMs = millis() - submittedMs;
+    }
+    return stats;
+}
+
+JobQueueStats JobQueue::getStats() {
+    portENTER_CRITICAL(&g_lock);
+    const JobQueueStats stats = g_stats;
+    portEXIT_CRITICAL(&g_lock);
+    return stats;
+}
+
+void JobQueue::dump(Print& out) {
+    const JobQueueStats stats = getStats();
+    out.printf("[Jobs] %s, %lu submitted, %lu done, %lu cancelled, %lu rejected, %lu long steps\n",
+               g_worker != nullptr ? "worker" : "service task", static_cast<unsigned long>(stats.submitted),
+               static_cast<unsigned long>(stats.completed), static_cast<unsigned long>(stats.cancelled),
+               static_cast<unsigned long>(stats.rejected), static_cast<unsigned long>(stats.longSteps));
+    for (size_t i = 0; i < kMaxJobs; ++i) {
+        const JobStats job = getJob(i);
+        if (job.state == JobState::None) {
+            continue;
+        }
+        out.printf("[Jobs] %08lx %-10s %-6s %-9s %lu steps / %lu slices, run %lu us (max step %lu), "
+                   "wait %lu ms, %lu ms\n",
+                   static_cast<unsigned long>(job.id), job.name,
+                   kPriorityNames[static_cast<size_t>(job.priority)],
+                   kStateNames[static_cast<size_t>(job.state)], static_cast<unsigned long>(job.steps),
+                   static_cast<unsigned long>(job.slices), static_cast<unsigned long>(job.runUs),
+                   static_cast<unsigned long>(job.maxStepUs), static_cast<unsigned long>(job.waitMs),
+                   static_cast<unsigned long>(job.elapsedMs));
+    }
+}
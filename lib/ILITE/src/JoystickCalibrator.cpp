@@ -0,0 +1,383 @@
+/**
+ * @file JoystickCalibrator.cpp
+ * @brief Center, end and sweep recording and the stick calibration screen
+ */
+
+#include "JoystickCalibrator.h"
+#include "InputManager.h"
+#include "ScreenRegistry.h"
+#include "SettingsStore.h"
+#include "LogChannels.h"
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+
+std::atomic<bool> JoystickCalibrator::recording_{false};
+
+namespace {
+
+using Step = JoystickCalibrator::Step;
+
+constexpr size_t kBins = AxisCalibration::kSidePoints;
+const char* const kAxisNames[JoystickCalibrator::kAxisCount] = {"AX", "AY", "BX", "BY"};
+
+struct AxisRecord {
+    uint32_t centerSum;
+    uint16_t center;
+    uint16_t low;
+    uint16_t high;
+    uint16_t latest;
+    uint16_t previous;
+    uint16_t bins[2][kBins];        ///< [0] towards low, [1] towards high; from center out
+};
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+AxisRecord g_axes[JoystickCalibrator::kAxisCount];  // Guarded by g_lock
+uint16_t g_centerCount = 0;                         // Guarded by g_lock
+Step g_step = Step::Idle;                           // Guarded by g_lock
+
+char g_message[24] = "";        // Display task only
+uint8_t g_linearSides = 0;      // Display task only; bit axis * 2 + side
+
+/// Running share of the sweep at each bin edge; false if a bin is too thin
+bool buildSide(const uint16_t bins[kBins], uint16_t* curve) {
+    uint32_t total = 0;
+    for (size_t bin = 0; bin < kBins; ++bin) {
+        if (bins[bin] < JoystickCalibrator::kMinBinSamples) {
+            return false;
+        }
+        total += bins[bin];
+    }
+    uint32_t cumulative = 0;
+    for (size_t bin = 0; bin < kBins; ++bin) {
+        cumulative += bins[bin];
+        curve[bin] = static_cast<uint16_t>(static_cast<uint64_t>(cumulative) *
+                                           AxisCalibration::kFullScale / total);
+    }
+    return true;
+}
+
+void setLinearSide(uint16_t* curve) {
+    for (size_t i = 0; i < kBins; ++i) {
+        curve[i] = static_cast<uint16_t>((i + 1) * AxisCalibration::kFullScale / kBins);
+    }
+}
+
+/// Worst bin of one side as a share of kGoodBinSamples (0-100)
+unsigned sideProgress(const uint16_t bins[kBins]) {
+    uint16_t fewest = bins[0];
+    for (size_t bin = 1; bin < kBins; ++bin) {
+        if (bins[bin] < fewest) {
+            fewest = bins[bin];
+        }
+    }
+    return fewest >= JoystickCalibrator::kGoodBinSamples
+               ? 100u
+               : fewest * 100u / JoystickCalibrator::kGoodBinSamples;
+}
+
+Step currentStep(AxisRecord* copy) {
+    portENTER_CRITICAL(&g_lock);
+    const Step step = g_step;
+    memcpy(copy, g_axes, sizeof(g_axes));
+    portEXIT_CRITICAL(&g_lock);
+    return step;
+}
+
+// ============================================================================
+// Screen
+// ============================================================================
+
+void drawCalibrationScreen(DisplayCanvas& canvas) {
+    AxisRecord axes[JoystickCalibrator::kAxisCount];
+    const Step step = currentStep(axes);
+
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+    canvas.drawLine(0, 8, 127, 8);
+
+    int16_t y = 27;
+    switch (step) {
+        case Step::Center:
+            canvas.drawText(0, 6, "Stick calibration 1/3");
+            canvas.drawText(0, 15, "Let go of both sticks");
+            for (uint8_t axis = 0; axis < JoystickCalibrator::kAxisCount; ++axis, y += 6) {
+                canvas.drawTextF(0, y, "%s %u", kAxisNames[axis], axes[axis].latest);
+            }
+            canvas.drawText(0, 63, "B1:Cancel B2:Next");
+            break;
+
+        case Step::Ends:
+            canvas.drawText(0, 6, "Stick calibration 2/3");
+            canvas.drawText(0, 15, "Circle both sticks along");
+            canvas.drawText(0, 21, "their stops");
+            for (uint8_t axis = 0; axis < JoystickCalibrator::kAxisCount; ++axis, y += 6) {
+                const AxisRecord& record = axes[axis];
+                canvas.drawTextF(0, y, "%s %4u %4u %4u", kAxisNames[axis],
+                                 record.low, record.center, record.high);
+            }
+            canvas.drawText(0, 63, "B1:Cancel B2:Next");
+            break;
+
+        case Step::Sweep:
+            canvas.drawText(0, 6, "Stick calibration 3/3");
+            canvas.drawText(0, 15, "Sweep each stick end to");
+            canvas.drawText(0, 21, "end, slowly and evenly");
+            for (uint8_t axis = 0; axis < JoystickCalibrator::kAxisCount; ++axis, y += 6) {
+                canvas.drawText(0, y, kAxisNames[axis]);
+                canvas.drawProgressBar(16, y - 4, 50, 4, sideProgress(axes[axis].bins[0]) / 100.0f);
+                canvas.drawProgressBar(70, y - 4, 50, 4, sideProgress(axes[axis].bins[1]) / 100.0f);
+            }
+            canvas.drawText(0, 63, "B1:Cancel B2:Save B3:Linear");
+            break;
+
+        case Step::Done:
+        case Step::Idle:
+            canvas.drawText(0, 6, "Stick calibration");
+            canvas.drawText(0, 15, step == Step::Done ? "Stored" : "Not running");
+            for (uint8_t axis = 0; axis < JoystickCalibrator::kAxisCount; ++axis, y += 6) {
+                AxisCalibration calibration;
+                if (!InputManager::getInstance().getJoystickCalibration(
+                        static_cast<AdcSampler::Channel>(axis), calibration)) {
+                    canvas.drawTextF(0, y, "%s auto", kAxisNames[axis]);
+                    continue;
+                }
+                canvas.drawTextF(0, y, "%s %4d %4d %4d %s/%s", kAxisNames[axis],
+                                 calibration.min, calibration.center, calibration.max,
+                                 (g_linearSides >> (axis * 2)) & 1 ? "lin" : "crv",
+                                 (g_linearSides >> (axis * 2 + 1)) & 1 ? "lin" : "crv");
+            }
+            canvas.drawText(0, 63, "B1:Back");
+            break;
+    }
+
+    if (g_message[0] != '\0') {
+        canvas.drawText(0, 54, g_message);
+    }
+}
+
+void nextStep() {
+    if (JoystickCalibrator::getStep() == Step::Done) {
+        ScreenRegistry::back();
+        return;
+    }
+    JoystickCalibrator::next();
+}
+
+void skipSweep() {
+    if (JoystickCalibrator::getStep() == Step::Sweep) {
+        JoystickCalibrator::storeLinear();
+    }
+}
+
+constexpr Screen kCalibrationScreen[] = {{
+    "framework.joycal", "Calibrate Sticks", ICON_JOYSTICK,
+    &drawCalibrationScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, &nextStep, &skipSweep,
+    false, nullptr,
+    &JoystickCalibrator::start, &JoystickCalibrator::cancel
+}};
+
+}  // namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void JoystickCalibrator::record(const uint16_t raw[AdcSampler::CHANNEL_COUNT]) {
+    portENTER_CRITICAL(&g_lock);
+    for (uint8_t axis = 0; axis < kAxisCount; ++axis) {
+        AxisRecord& record = g_axes[axis];
+        const uint16_t value = raw[axis];
+        record.latest = value;
+
+        if (g_step == Step::Center) {
+            record.centerSum += value;
+        } else if (g_step == Step::Ends) {
+            if (value < record.low) {
+                record.low = value;
+            }
+            if (value > record.high) {
+                record.high = value;
+            }
+        } else if (g_step == Step::Sweep) {
+            const uint16_t moved = value > record.previous ? value - record.previous
+                                                           : record.previous - value;
+            record.previous = value;
+            if (moved < kMinStep) {
+                continue;       // Resting at a stop or at center says nothing about travel
+            }
+            const uint8_t side = value > record.center ? 1 : 0;
+            const uint32_t distance = side ? value - record.center : record.center - value;
+            const uint32_t half = side ? record.high - record.center : record.center - record.low;
+            if (distance >= half) {
+                continue;
+            }
+            uint16_t& bin = record.bins[side][distance * kBins / half];
+            if (bin < UINT16_MAX) {
+                bin++;
+            }
+        }
+    }
+    if (g_step == Step::Center && g_centerCount < UINT16_MAX) {
+        g_centerCount++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+}
+
+// ============================================================================
+// Steps
+// ============================================================================
+
+void JoystickCalibrator::start() {
+    portENTER_CRITICAL(&g_lock);
+    memset(g_axes, 0, sizeof(g_axes));
+    g_centerCount = 0;
+    g_step = Step::Center;
+    portEXIT_CRITICAL(&g_lock);
+    g_message[0] = '\0';
+    recording_.store(true, std::memory_order_relaxed);
+}
+
+void JoystickCalibrator::cancel() {
+    recording_.store(false, std::memory_order_relaxed);
+    portENTER_CRITICAL(&g_lock);
+    g_step = Step::Idle;
+    portEXIT_CRITICAL(&g_lock);
+    g_message[0] = '\0';
+}
+
+bool JoystickCalibrator::next() {
+    int shortAxis = -1;
+    bool advanced = false;
+
+    portENTER_CRITICAL(&g_lock);
+    const Step step = g_step;
+    if (step == Step::Center && g_centerCount >= kMinCenterSamples) {
+        for (AxisRecord& record : g_axes) {
+            record.center = static_cast<uint16_t>(record.centerSum / g_centerCount);
+            record.low = record.high = record.center;
+        }
+        g_step = Step::Ends;
+        advanced = true;
+    } else if (step == Step::Ends) {
+        for (uint8_t axis = 0; axis < kAxisCount && shortAxis < 0; ++axis) {
+            const AxisRecord& record = g_axes[axis];
+            if (record.center - record.low < AxisCalibration::kMinHalfSpan ||
+                record.high - record.center < AxisCalibration::kMinHalfSpan) {
+                shortAxis = axis;
+            }
+        }
+        if (shortAxis < 0) {
+            for (AxisRecord& record : g_axes) {
+                memset(record.bins, 0, sizeof(record.bins));
+                record.previous = record.latest;
+            }
+            g_step = Step::Sweep;
+            advanced = true;
+        }
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (step == Step::Sweep) {
+        return store(false);
+    }
+    if (advanced) {
+        g_message[0] = '\0';
+    } else if (step == Step::Center) {
+        snprintf(g_message, sizeof(g_message), "Hold still");
+    } else if (shortAxis >= 0) {
+        snprintf(g_message, sizeof(g_message), "%s: reach both", kAxisNames[shortAxis]);
+    }
+    return advanced;
+}
+
+bool JoystickCalibrator::storeLinear() {
+    return getStep() == Step::Sweep && store(true);
+}
+
+bool JoystickCalibrator::store(bool linear) {
+    AxisRecord axes[kAxisCount];
+    if (currentStep(axes) != Step::Sweep) {
+        return false;
+    }
+    recording_.store(false, std::memory_order_relaxed);
+
+    InputManager& inputs = InputManager::getInstance();
+    bool stored = true;
+    g_linearSides = 0;
+    for (uint8_t axis = 0; axis < kAxisCount; ++axis) {
+        const AxisRecord& record = axes[axis];
+        AxisCalibration calibration = {};
+        calibration.version = AxisCalibration::kVersion;
+        calibration.min = static_cast<int16_t>(record.low);
+        calibration.center = static_cast<int16_t>(record.center);
+        calibration.max = static_cast<int16_t>(record.high);
+        for (uint8_t side = 0; side < 2; ++side) {
+            uint16_t* curve = calibration.curve + side * kBins;
+            if (linear || !buildSide(record.bins[side], curve)) {
+                setLinearSide(curve);
+                g_linearSides |= static_cast<uint8_t>(1u << (axis * 2 + side));
+            }
+        }
+        stored = inputs.setJoystickCalibration(static_cast<AdcSampler::Channel>(axis), calibration) && stored;
+        ILITE_LOG(INPUTS, LOG_INFO, "JoystickCalibrator: %s %d/%d/%d, %s",
+                  kAxisNames[axis], calibration.min, calibration.center, calibration.max,
+                  (g_linearSides >> (axis * 2)) & 3 ? "linear side(s)" : "curve");
+    }
+    SettingsStore::getInstance().flush();
+
+    portENTER_CRITICAL(&g_lock);
+    g_step = Step::Done;
+    portEXIT_CRITICAL(&g_lock);
+    if (!stored) {
+        snprintf(g_message, sizeof(g_message), "Not stored");
+    }
+    return stored;
+}
+
+JoystickCalibrator::Step JoystickCalibrator::getStep() {
+    portENTER_CRITICAL(&g_lock);
+    const Step step = g_step;
+    portEXIT_CRITICAL(&g_lock);
+    return step;
+}
+
+const char* JoystickCalibrator::getMessage() {
+    return g_message;
+}
+
+// ============================================================================
+// Setup and Diagnostics
+// ============================================================================
+
+void JoystickCalibrator::registerScreen() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+
+    ScreenRegistry::registerTable(kCalibrationScreen, 1);
+    registered = true;
+}
+
+void JoystickCalibrator::dump(Print& out) {
+    InputManager& inputs = InputManager::getInstance();
+    for (uint8_t axis = 0; axis < kAxisCount; ++axis) {
+        AxisCalibration calibration;
+        if (!inputs.getJoystickCalibration(static_cast<AdcSampler::Channel>(axis), calibration)) {
+            out.printf("[JoyCal] %s auto-center\n", kAxisNames[axis]);
+            continue;
+        }
+        out.printf("[JoyCal] %s min=%d center=%d max=%d\n", kAxisNames[axis],
+                   calibration.min, calibration.center, calibration.max);
+        for (uint8_t side = 0; side < 2; ++side) {
+            out.printf("[JoyCal]   %c", side ? '+' : '-');
+            for (size_t i = 0; i < kBins; ++i) {
+                out.printf(" %.3f", calibration.curve[side * kBins + i] /
+                                        static_cast<float>(AxisCalibration::kFullScale));
+            }
+            out.println();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file LatencyPins.cpp
+ * @brief Marker pin setup (ILITE_LATENCY_PINS builds only)
+ */
+
+#include "LatencyPins.h"
+
+#if ILITE_LATENCY_PINS
+
+#include "LogChannels.h"
+
+namespace {
+
+const char* const kMarkerNames[LatencyPins::kMarkerCount] = {
+    "adc_latch", "control", "prepare", "air", "rx", "send_buffer"
+};
+
+constexpr LatencyMarker kMarkers[LatencyPins::kMarkerCount] = {
+    LatencyMarker::AdcLatch, LatencyMarker::Control, LatencyMarker::Prepare,
+    LatencyMarker::Air, LatencyMarker::Rx, LatencyMarker::SendBuffer
+};
+
+}  // namespace
+
+std::atomic<uint8_t> LatencyPins::airInFlight_(0);
+
+void LatencyPins::begin() {
+    for (size_t i = 0; i < kMarkerCount; ++i) {
+        const int pin = pinOf(kMarkers[i]);
+        if (maskOf(kMarkers[i]) == 0) {
+            ILITE_LOG(SYSTEM, LOG_INFO, "Latency marker %s: off", kMarkerNames[i]);
+            continue;
+        }
+        pinMode(pin, OUTPUT);
+        REG_WRITE(GPIO_OUT_W1TC_REG, maskOf(kMarkers[i]));
+        ILITE_LOG(SYSTEM, LOG_INFO, "Latency marker %s: GPIO %d", kMarkerNames[i], pin);
+    }
+}
+
+#endif // ILITE_LATENCY_PINS
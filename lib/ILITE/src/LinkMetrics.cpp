@@ -0,0 +1,349 @@
+/**
+ * @file LinkMetrics.cpp
+ * @brief Per-peer link statistics and the link quality screen
+ */
+
+#include "LinkMetrics.h"
+#include "ScreenRegistry.h"
+#include "espnow_discovery.h"
+#include <esp_timer.h>
+#include <cstring>
+
+extern EspNowDiscovery discovery;
+
+LinkPeerStats LinkMetrics::peers_[LinkMetrics::kMaxPeers];
+
+const uint32_t LinkMetrics::kRttBucketUs[kLinkRttBuckets] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, UINT32_MAX
+};
+
+namespace {
+
+enum : uint8_t {
+    kSlotFree = 0,
+    kSlotClaiming = 1,
+    kSlotReady = 2
+};
+
+constexpr uint8_t kBroadcastMac[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+// ESP-NOW frames are vendor-specific action frames with Espressif's OUI
+constexpr uint8_t kActionFrameControl = 0xD0;
+constexpr uint8_t kVendorCategory = 127;
+constexpr uint8_t kEspressifOui[3] = {0x18, 0xFE, 0x34};
+constexpr size_t kSenderOffset = 10;    // addr2 in the 802.11 header
+constexpr size_t kCategoryOffset = 24;
+
+void drawLinkScreen(DisplayCanvas& canvas) {
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+
+    const LinkPeerStats* stats = LinkMetrics::find(discovery.getPairedMac());
+    if (stats == nullptr) {
+        canvas.drawText(0, 6, "Link");
+        canvas.drawLine(0, 8, 127, 8);
+        canvas.drawText(0, 22, "No paired peer data");
+        canvas.drawText(0, 63, "B1:Back");
+        return;
+    }
+
+    const uint32_t age = millis() - stats->lastHeardMs;
+    canvas.drawTextF(0, 6, "Link  heard %lums ago", static_cast<unsigned long>(age));
+    canvas.drawLine(0, 8, 127, 8);
+
+    if (stats->rssiSamples > 0) {
+        canvas.drawTextF(0, 15, "RSSI %d dBm", stats->rssiDbm);
+    } else {
+        canvas.drawText(0, 15, "RSSI n/a");
+    }
+    canvas.drawTextF(64, 15, "TX ok %u%%", LinkMetrics::txSuccessPercent(*stats));
+    canvas.drawTextF(0, 22, "Ping %lu/%lu", static_cast<unsigned long>(stats->pongs),
+                     static_cast<unsigned long>(stats->pingsSent));
+    canvas.drawTextF(64, 22, "Loss %u%%", LinkMetrics::lossPercent(*stats));
+    canvas.drawTextF(0, 29, "RTT %lu/%lu/%lu ms",
+                     static_cast<unsigned long>(stats->rttMinUs / 1000),
+                     static_cast<unsigned long>(stats->rttAvgUs / 1000),
+                     static_cast<unsigned long>(stats->rttMaxUs / 1000));
+
+    // RTT histogram: one column per bucket
+    uint32_t peak = 0;
+    for (size_t i = 0; i < kLinkRttBuckets; ++i) {
+        if (stats->rttHistogram[i] > peak) {
+            peak = stats->rttHistogram[i];
+        }
+    }
+    static const char* const kBucketLabels[kLinkRttBuckets] = {
+        "1", "2", "5", "10", "20", "50", "99", "+"
+    };
+    const int16_t baseY = 50;
+    const int16_t maxHeight = 14;
+    for (size_t i = 0; i < kLinkRttBuckets; ++i) {
+        const int16_t x = static_cast<int16_t>(i * 16);
+        const int16_t height = peak ? static_cast<int16_t>((stats->rttHistogram[i] * maxHeight) / peak) : 0;
+        if (height > 0) {
+            canvas.drawRect(x + 2, baseY - height, 11, height, true);
+        }
+        canvas.drawText(x + 2, baseY + 7, kBucketLabels[i]);
+    }
+
+    canvas.drawText(0, 63, "B1:Back  ms buckets");
+}
+
+constexpr Screen kLinkScreen[] = {{
+    "framework.link", "Link", ICON_SIGNAL_FULL,
+    &drawLinkScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, nullptr, nullptr,
+    false
+}};
+
+bool g_promiscuousRssi = false;
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void LinkMetrics::begin(bool promiscuousRssi) {
+    static bool started = false;
+    if (started) {
+        return;
+    }
+    started = true;
+
+    g_promiscuousRssi = promiscuousRssi;
+    restorePromiscuous();
+
+    ScreenRegistry::registerTable(kLinkScreen, 1);
+}
+
+void LinkMetrics::restorePromiscuous() {
+    if (g_promiscuousRssi) {
+        wifi_promiscuous_filter_t filter = {};
+        filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+        esp_wifi_set_promiscuous_filter(&filter);
+        esp_wifi_set_promiscuous_rx_cb(&LinkMetrics::promiscuousCallback);
+        if (esp_wifi_set_promiscuous(true) != ESP_OK) {
+            Serial.println("[LinkMetrics] WARNING: Promiscuous RX unavailable, no RSSI");
+        }
+    }
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+LinkPeerStats* LinkMetrics::lookup(const uint8_t* mac) {
+    if (mac == nullptr) {
+        return nullptr;
+    }
+    for (LinkPeerStats& peer : peers_) {
+        if (peer.state.load(std::memory_order_acquire) == kSlotReady &&
+            memcmp(peer.mac, mac, sizeof(peer.mac)) == 0) {
+            return &peer;
+        }
+    }
+    return nullptr;
+}
+
+LinkPeerStats* LinkMetrics::findOrAdd(const uint8_t* mac) {
+    LinkPeerStats* existing = lookup(mac);
+    if (existing != nullptr || mac == nullptr || memcmp(mac, kBroadcastMac, 6) == 0) {
+        return existing;
+    }
+
+    for (LinkPeerStats& peer : peers_) {
+        uint8_t expected = kSlotFree;
+        if (!peer.state.compare_exchange_strong(expected, kSlotClaiming)) {
+            continue;
+        }
+        memcpy(peer.mac, mac, sizeof(peer.mac));
+        peer.txOk = 0;
+        peer.txFail = 0;
+        peer.rssiDbm = 0;
+        peer.rssiLastDbm = 0;
+        peer.rssiSamples = 0;
+        peer.rxFrames = 0;
+        peer.lastHeardMs = 0;
+        peer.pingsSent = 0;
+        peer.pongs = 0;
+        peer.seqLost = 0;
+        peer.nextSeq = 0;
+        peer.rttLastUs = 0;
+        peer.rttMinUs = 0;
+        peer.rttMaxUs = 0;
+        peer.rttAvgUs = 0;
+        memset(peer.rttHistogram, 0, sizeof(peer.rttHistogram));
+        peer.state.store(kSlotReady, std::memory_order_release);
+        return &peer;
+    }
+    return nullptr;
+}
+
+const LinkPeerStats* LinkMetrics::find(const uint8_t* mac) {
+    return lookup(mac);
+}
+
+void LinkMetrics::reset() {
+    for (LinkPeerStats& peer : peers_) {
+        peer.state.store(kSlotFree, std::memory_order_release);
+    }
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void LinkMetrics::onSendStatus(const uint8_t* mac, bool success) {
+    LinkPeerStats* peer = findOrAdd(mac);
+    if (peer == nullptr) {
+        return;
+    }
+    if (success) {
+        peer->txOk++;
+    } else {
+        peer->txFail++;
+    }
+}
+
+void LinkMetrics::onReceive(const uint8_t* mac) {
+    LinkPeerStats* peer = findOrAdd(mac);
+    if (peer == nullptr) {
+        return;
+    }
+    peer->rxFrames++;
+    peer->lastHeardMs = millis();
+}
+
+void LinkMetrics::onPingSent(const uint8_t* mac, uint32_t sequence) {
+    LinkPeerStats* peer = findOrAdd(mac);
+    if (peer == nullptr) {
+        return;
+    }
+    if (peer->pingsSent == 0) {
+        peer->nextSeq = sequence;
+    }
+    peer->pingsSent++;
+}
+
+void LinkMetrics::onPong(const uint8_t* mac, uint32_t sequence, uint32_t sentUs) {
+    LinkPeerStats* peer = lookup(mac);
+    if (peer == nullptr) {
+        return;
+    }
+
+    // Echoes older than the newest one seen are late duplicates
+    if (static_cast<int32_t>(sequence - peer->nextSeq) < 0) {
+        return;
+    }
+    peer->seqLost += sequence - peer->nextSeq;
+    peer->nextSeq = sequence + 1;
+    peer->pongs++;
+
+    const uint32_t rttUs = static_cast<uint32_t>(esp_timer_get_time()) - sentUs;
+    peer->rttLastUs = rttUs;
+    if (peer->pongs == 1 || rttUs < peer->rttMinUs) {
+        peer->rttMinUs = rttUs;
+    }
+    if (rttUs > peer->rttMaxUs) {
+        peer->rttMaxUs = rttUs;
+    }
+    peer->rttAvgUs = peer->pongs == 1
+        ? rttUs
+        : static_cast<uint32_t>((static_cast<uint64_t>(peer->rttAvgUs) * 7 + rttUs) / 8);
+
+    size_t bucket = 0;
+    while (rttUs > kRttBucketUs[bucket] && bucket < kLinkRttBuckets - 1) {
+        ++bucket;
+    }
+    peer->rttHistogram[bucket]++;
+}
+
+void LinkMetrics::promiscuousCallback(void* buffer, wifi_promiscuous_pkt_type_t type) {
+    // WiFi task; sees every management frame on the channel, so bail early
+    if (type != WIFI_PKT_MGMT) {
+        return;
+    }
+    const wifi_promiscuous_pkt_t* packet = static_cast<const wifi_promiscuous_pkt_t*>(buffer);
+    const uint8_t* frame = packet->payload;
+    if (packet->rx_ctrl.sig_len < kCategoryOffset + 4 ||
+        frame[0] != kActionFrameControl ||
+        frame[kCategoryOffset] != kVendorCategory ||
+        memcmp(frame + kCategoryOffset + 1, kEspressifOui, sizeof(kEspressifOui)) != 0) {
+        return;
+    }
+
+    LinkPeerStats* peer = lookup(frame + kSenderOffset);
+    if (peer == nullptr) {
+        return;
+    }
+    const int8_t rssi = static_cast<int8_t>(packet->rx_ctrl.rssi);
+    peer->rssiLastDbm = rssi;
+    peer->rssiDbm = peer->rssiSamples == 0
+        ? rssi
+        : static_cast<int16_t>((peer->rssiDbm * 3 + rssi) / 4);
+    peer->rssiSamples++;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+uint8_t LinkMetrics::txSuccessPercent(const LinkPeerStats& stats) {
+    const uint32_t total = stats.txOk + stats.txFail;
+    return total ? static_cast<uint8_t>((stats.txOk * 100ULL) / total) : 100;
+}
+
+uint8_t LinkMetrics::lossPercent(const LinkPeerStats& stats) {
+    const uint32_t total = stats.pongs + stats.seqLost;
+    return total ? static_cast<uint8_t>((stats.seqLost * 100ULL) / total) : 0;
+}
+
+uint8_t LinkMetrics::getSignalBars(const uint8_t* mac) {
+    const LinkPeerStats* stats = lookup(mac);
+    if (stats == nullptr || stats->lastHeardMs == 0) {
+        return 0;
+    }
+    if (millis() - stats->lastHeardMs > kStaleMs) {
+        return 1;
+    }
+
+    int bars;
+    if (stats->rssiSamples > 0) {
+        bars = stats->rssiDbm >= -60 ? 4 : stats->rssiDbm >= -70 ? 3 : stats->rssiDbm >= -80 ? 2 : 1;
+    } else {
+        const uint8_t ok = txSuccessPercent(*stats);
+        bars = ok >= 95 ? 4 : ok >= 80 ? 3 : ok >= 50 ? 2 : 1;
+    }
+
+    // Round-trip loss costs bars even when the signal looks strong
+    const uint8_t loss = lossPercent(*stats);
+    bars -= loss >= 25 ? 2 : loss >= 10 ? 1 : 0;
+    return static_cast<uint8_t>(bars < 1 ? 1 : bars);
+}
+
+void LinkMetrics::dump(Print& out) {
+    out.println("[LinkMetrics] peer               txok  rssi  loss  ping   rtt min/avg/max us");
+    for (const LinkPeerStats& peer : peers_) {
+        if (peer.state.load(std::memory_order_acquire) != kSlotReady) {
+            continue;
+        }
+        char label[18];
+        EspNowDiscovery::macToString(peer.mac, label, sizeof(label));
+        out.printf("%s %4u%% %5d %4u%% %5lu   %lu/%lu/%lu\n",
+                   label,
+                   txSuccessPercent(peer),
+                   peer.rssiSamples ? peer.rssiDbm : 0,
+                   lossPercent(peer),
+                   static_cast<unsigned long>(peer.pongs),
+                   static_cast<unsigned long>(peer.rttMinUs),
+                   static_cast<unsigned long>(peer.rttAvgUs),
+                   static_cast<unsigned long>(peer.rttMaxUs));
+        out.print("  rtt hist:");
+        for (size_t i = 0; i < kLinkRttBuckets; ++i) {
+            out.printf(" %lu", static_cast<unsigned long>(peer.rttHistogram[i]));
+        }
+        out.println();
+    }
+}
@@ -0,0 +1,275 @@
+/**
+ * @file LinkRate.cpp
+ * @brief Rate ladder, per-rate booking and adaptive ARF stepping
+ */
+
+#include "LinkRate.h"
+#include "espnow_discovery.h"
+#include "LinkMetrics.h"
+#include "LogChannels.h"
+#include <esp_wifi.h>
+#include <cstring>
+
+namespace {
+
+struct RateStep {
+    wifi_phy_rate_t phy;
+    const char* name;
+    int8_t minRssi;                 ///< Smoothed RSSI needed to step up to it (dBm)
+};
+
+// Order matches LinkPhyRate. The floors sit a few dB above the ESP32's
+// sensitivity for each rate.
+const RateStep kSteps[static_cast<size_t>(LinkPhyRate::Count)] = {
+    {WIFI_PHY_RATE_LORA_250K, "lr250k", -128},
+    {WIFI_PHY_RATE_LORA_500K, "lr500k", -100},
+    {WIFI_PHY_RATE_1M_L, "1M", -95},
+    {WIFI_PHY_RATE_2M_S, "2M", -91},
+    {WIFI_PHY_RATE_5M_S, "5.5M", -88},
+    {WIFI_PHY_RATE_11M_S, "11M", -85},
+    {WIFI_PHY_RATE_12M, "12M", -82},
+    {WIFI_PHY_RATE_24M, "24M", -78},
+    {WIFI_PHY_RATE_36M, "36M", -74},
+    {WIFI_PHY_RATE_54M, "54M", -68},
+};
+
+constexpr size_t kRateCount = static_cast<size_t>(LinkPhyRate::Count);
+
+bool g_started = false;
+bool g_longRange = false;
+bool g_adaptive = false;
+size_t g_base = static_cast<size_t>(LinkPhyRate::Mbps1);     // Configured / unpaired rate
+size_t g_current = static_cast<size_t>(LinkPhyRate::Mbps1);
+LinkRateStats g_stats[kRateCount];
+
+// Window state, ServiceTask only
+bool g_haveBaseline = false;
+uint32_t g_windowStartMs = 0;
+uint32_t g_lastTxOk = 0;
+uint32_t g_lastTxFail = 0;
+uint32_t g_lastPongs = 0;
+uint32_t g_lastSeqLost = 0;
+uint8_t g_cleanWindows = 0;
+uint8_t g_stepUpWindows = LinkRate::kStepUpWindows;
+bool g_probing = false;
+
+size_t floorIndex() {
+    return g_longRange ? 0 : static_cast<size_t>(LinkPhyRate::Mbps1);
+}
+
+bool apply(size_t index) {
+    const esp_err_t err = esp_wifi_config_espnow_rate(WIFI_IF_STA, kSteps[index].phy);
+    if (err != ESP_OK) {
+        ILITE_LOG(DISCOVERY, LOG_WARN, "Rate %s failed: %d", kSteps[index].name, err);
+        return false;
+    }
+    g_current = index;
+    return true;
+}
+
+void resetAdaptation() {
+    g_haveBaseline = false;
+    g_cleanWindows = 0;
+    g_stepUpWindows = LinkRate::kStepUpWindows;
+    g_probing = false;
+}
+
+}  // namespace
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+bool LinkRate::begin(LinkPhyRate rate, bool adaptive, bool longRange) {
+    g_longRange = longRange;
+    if (longRange) {
+        const esp_err_t err = esp_wifi_set_protocol(
+            WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+        if (err != ESP_OK) {
+            Serial.printf("[Rate] WARNING: 802.11 LR unavailable (%d)\n", err);
+            g_longRange = false;
+        }
+    }
+    g_started = true;
+    g_adaptive = adaptive;
+    resetAdaptation();
+    if (!setRate(rate)) {
+        return setRate(LinkPhyRate::Mbps1);
+    }
+    return true;
+}
+
+bool LinkRate::setRate(LinkPhyRate rate) {
+    const size_t index = static_cast<size_t>(rate);
+    if (!g_started || index >= kRateCount || index < floorIndex() || !apply(index)) {
+        return false;
+    }
+    g_base = index;
+    resetAdaptation();
+    return true;
+}
+
+LinkPhyRate LinkRate::getRate() {
+    return static_cast<LinkPhyRate>(g_current);
+}
+
+void LinkRate::setAdaptive(bool enabled) {
+    g_adaptive = enabled;
+    resetAdaptation();
+    if (!enabled && g_started && g_current != g_base) {
+        apply(g_base);
+    }
+}
+
+bool LinkRate::isAdaptive() {
+    return g_adaptive;
+}
+
+bool LinkRate::canStepDown() {
+    return g_adaptive && g_current > floorIndex();
+}
+
+// ============================================================================
+// Adaptation
+// ============================================================================
+
+void LinkRate::service(const EspNowDiscovery& discovery, uint32_t now) {
+    if (!g_started) {
+        return;
+    }
+    if (!discovery.isPaired()) {
+        if (g_adaptive && g_current != g_base) {
+            apply(g_base);
+        }
+        resetAdaptation();
+        return;
+    }
+    if (g_haveBaseline && now - g_windowStartMs < kWindowMs) {
+        return;
+    }
+    const LinkPeerStats* stats = LinkMetrics::find(discovery.getPairedMac());
+    if (stats == nullptr) {
+        return;
+    }
+
+    const uint32_t elapsed = now - g_windowStartMs;
+    const uint32_t ok = stats->txOk - g_lastTxOk;
+    const uint32_t fail = stats->txFail - g_lastTxFail;
+    const uint32_t pongs = stats->pongs - g_lastPongs;
+    const uint32_t lost = stats->seqLost - g_lastSeqLost;
+    g_lastTxOk = stats->txOk;
+    g_lastTxFail = stats->txFail;
+    g_lastPongs = stats->pongs;
+    g_lastSeqLost = stats->seqLost;
+    g_windowStartMs = now;
+    if (!g_haveBaseline) {
+        g_haveBaseline = true;
+        return;
+    }
+
+    const uint32_t sends = ok + fail;
+    LinkRateStats& booked = g_stats[g_current];
+    booked.activeMs += elapsed;
+    booked.sends += sends;
+    booked.sendFails += fail;
+    booked.pings += pongs;
+    booked.pingsLost += lost;
+    booked.rttSumUs += static_cast<uint64_t>(stats->rttAvgUs) * pongs;
+
+    if (!g_adaptive || sends < kMinWindowSends) {
+        return;
+    }
+
+    const uint32_t probes = pongs + lost;
+    const bool failing = fail * 100 >= sends * kStepDownFailPercent ||
+                         (probes > 0 && lost * 100 >= probes * kStepDownFailPercent);
+    if (failing) {
+        // A failed probe makes the next one wait twice as long
+        if (g_probing && g_stepUpWindows < kMaxStepUpWindows) {
+            g_stepUpWindows = static_cast<uint8_t>(
+                g_stepUpWindows * 2 < kMaxStepUpWindows ? g_stepUpWindows * 2 : kMaxStepUpWindows);
+        }
+        g_probing = false;
+        g_cleanWindows = 0;
+        if (g_current > floorIndex() && apply(g_current - 1)) {
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Rate down to %s (%lu/%lu sends failed, %lu pings lost)",
+                      kSteps[g_current].name, static_cast<unsigned long>(fail),
+                      static_cast<unsigned long>(sends), static_cast<unsigned long>(lost));
+        }
+        return;
+    }
+    if (g_probing) {
+        g_probing = false;
+        g_stepUpWindows = kStepUpWindows;
+    }
+
+    const bool clean = fail * 100 < sends * kStepUpFailPercent && lost == 0;
+    g_cleanWindows = clean ? g_cleanWindows + 1 : 0;
+    if (g_cleanWindows < g_stepUpWindows || g_current + 1 >= kRateCount) {
+        return;
+    }
+    g_cleanWindows = 0;
+    const size_t higher = g_current + 1;
+    if (stats->rssiSamples > 0 && stats->rssiDbm < kSteps[higher].minRssi) {
+        return;
+    }
+    if (apply(higher)) {
+        g_probing = true;
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Rate up to %s (rssi %d)", kSteps[higher].name,
+                  static_cast<int>(stats->rssiDbm));
+    }
+}
+
+// ============================================================================
+// Names and statistics
+// ============================================================================
+
+const char* LinkRate::name(LinkPhyRate rate) {
+    const size_t index = static_cast<size_t>(rate);
+    return index < kRateCount ? kSteps[index].name : "?";
+}
+
+bool LinkRate::parse(const char* text, LinkPhyRate& rate) {
+    if (text == nullptr) {
+        return false;
+    }
+    for (size_t i = floorIndex(); i < kRateCount; ++i) {
+        if (strcmp(text, kSteps[i].name) == 0) {
+            rate = static_cast<LinkPhyRate>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const LinkRateStats& LinkRate::getStats(LinkPhyRate rate) {
+    const size_t index = static_cast<size_t>(rate);
+    return g_stats[index < kRateCount ? index : g_current];
+}
+
+void LinkRate::reset() {
+    for (LinkRateStats& stats : g_stats) {
+        stats = LinkRateStats{};
+    }
+}
+
+void LinkRate::dump(Print& out) {
+    out.printf("[Rate] %s, %s (base %s%s)\n", kSteps[g_current].name,
+               g_adaptive ? "adaptive" : "fixed", kSteps[g_base].name,
+               g_longRange ? ", LR on" : "");
+    out.println("[Rate] rate      secs   sends  fail%  pings  loss%  rtt ms");
+    for (size_t i = floorIndex(); i < kRateCount; ++i) {
+        const LinkRateStats& stats = g_stats[i];
+        if (stats.activeMs == 0) {
+            continue;
+        }
+        const uint32_t probes = stats.pings + stats.pingsLost;
+        out.printf("[Rate] %-7s %6lu %7lu %6.1f %6lu %6.1f %7.2f\n", kSteps[i].name,
+                   static_cast<unsigned long>(stats.activeMs / 1000),
+                   static_cast<unsigned long>(stats.sends),
+                   stats.sends ? stats.sendFails * 100.0f / stats.sends : 0.0f,
+                   static_cast<unsigned long>(stats.pings),
+                   probes ? stats.pingsLost * 100.0f / probes : 0.0f,
+                   stats.pings ? static_cast<float>(stats.rttSumUs / stats.pings) / 1000.0f : 0.0f);
+    }
+}
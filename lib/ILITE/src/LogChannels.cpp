@@ -0,0 +1,163 @@
+/**
+ * @file LogChannels.cpp
+ * @brief Channel level masks, token buckets and suppressed-count summaries
+ */
+
+#include "LogChannels.h"
+#include <cstring>
+
+volatile uint8_t LogChannels::masks_[LogChannels::kChannelCount] = {
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+    LogChannels::kDefaultMask,
+};
+
+namespace {
+
+const char* const kChannelNames[LogChannels::kChannelCount] = {
+    "system", "router", "discovery", "module", "ui", "control", "input"
+};
+
+struct LevelName {
+    const char* name;
+    uint8_t mask;
+};
+
+// Each name enables that level and everything more severe
+constexpr LevelName kLevelNames[] = {
+    {"off", 0},
+    {"error", LOG_ERROR},
+    {"warn", LOG_ERROR | LOG_WARN},
+    {"info", LOG_ERROR | LOG_WARN | LOG_INFO},
+    {"debug", LOG_ERROR | LOG_WARN | LOG_INFO | LOG_DEBUG},
+};
+
+// Sites that have dropped at least one line (push-only list)
+std::atomic<LogRateLimit*> limitedSites{nullptr};
+
+}  // namespace
+
+// ============================================================================
+// Channel masks
+// ============================================================================
+
+void LogChannels::setMask(LogChannel channel, uint8_t mask) {
+    if (channel < LogChannel::Count) {
+        masks_[static_cast<size_t>(channel)] = mask;
+    }
+}
+
+uint8_t LogChannels::getMask(LogChannel channel) {
+    return channel < LogChannel::Count ? masks_[static_cast<size_t>(channel)] : 0;
+}
+
+void LogChannels::setLevel(LogChannel channel, LogLevel minimum) {
+    // Levels are ordered by bit: everything at or below `minimum` is more severe
+    setMask(channel, static_cast<uint8_t>((minimum << 1) - 1));
+}
+
+const char* LogChannels::getName(LogChannel channel) {
+    return channel < LogChannel::Count ? kChannelNames[static_cast<size_t>(channel)] : "?";
+}
+
+LogChannel LogChannels::fromName(const char* name) {
+    if (name != nullptr) {
+        for (size_t i = 0; i < kChannelCount; ++i) {
+            if (strcmp(name, kChannelNames[i]) == 0) {
+                return static_cast<LogChannel>(i);
+            }
+        }
+    }
+    return LogChannel::Count;
+}
+
+bool LogChannels::levelFromName(const char* name, uint8_t& level) {
+    if (name != nullptr) {
+        for (const LevelName& entry : kLevelNames) {
+            if (strcmp(name, entry.name) == 0) {
+                level = entry.mask;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void LogChannels::dump(Print& out) {
+    out.println("[LogChannels] channel    error warn info debug");
+    for (size_t i = 0; i < kChannelCount; ++i) {
+        const uint8_t mask = masks_[i];
+        out.printf("%-10s  %5s %4s %4s %5s\n", kChannelNames[i],
+                   (mask & LOG_ERROR) ? "on" : "-",
+                   (mask & LOG_WARN) ? "on" : "-",
+                   (mask & LOG_INFO) ? "on" : "-",
+                   (mask & LOG_DEBUG) ? "on" : "-");
+    }
+}
+
+// ============================================================================
+// Suppressed summaries
+// ============================================================================
+
+void LogChannels::flushSuppressed() {
+    for (LogRateLimit* site = limitedSites.load(std::memory_order_acquire);
+         site != nullptr;
+         site = site->next_) {
+        if (site->suppressed_ != 0) {
+            site->reportSuppressed();
+        }
+    }
+}
+
+void LogRateLimit::reportSuppressed() {
+    const uint32_t count = suppressed_;
+    suppressed_ = 0;
+    // fmt_ is a literal, so the summary keeps it by pointer like any other line
+    connectionLogAddf("[%s] %lu suppressed: %s", LogChannels::getName(channel_),
+                      static_cast<unsigned long>(count), fmt_);
+}
+
+// ============================================================================
+// Token bucket
+// ============================================================================
+
+bool LogRateLimit::allow() {
+    const uint32_t now = millis();
+    const uint32_t capacity = static_cast<uint32_t>(burst_) * 1000;
+    uint32_t elapsed = now - lastMs_;
+    lastMs_ = now;
+
+    // perSecond tokens per 1000 ms = perSecond milli-tokens per ms
+    if (perSecond_ != 0 && elapsed > capacity / perSecond_) {
+        elapsed = capacity / perSecond_ + 1;
+    }
+    uint32_t tokens = tokensMilli_ + elapsed * perSecond_;
+    if (tokens > capacity) {
+        tokens = capacity;
+    }
+
+    if (tokens >= 1000) {
+        tokensMilli_ = tokens - 1000;
+        if (suppressed_ != 0) {
+            reportSuppressed();
+        }
+        return true;
+    }
+
+    tokensMilli_ = tokens;
+    suppressed_++;
+    if (!linked_) {
+        linked_ = true;
+        LogRateLimit* head = limitedSites.load(std::memory_order_relaxed);
+        do {
+            next_ = head;
+        } while (!limitedSites.compare_exchange_weak(head, this,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    }
+    return false;
+}
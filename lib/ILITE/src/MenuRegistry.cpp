@@ -5,119 +5,303 @@
 
 #include "MenuRegistry.h"
 #include "FrameworkEngine.h"
+#include "InputManager.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <cstring>
 #include <algorithm>
 
-// Helper to create MenuEntry with editable value defaults
-static MenuEntry makeMenuEntry(
-    MenuID id, MenuID parent, IconID icon, const char* label, const char* shortLabel,
-    std::function<void()> onSelect, std::function<bool()> condition, std::function<const char*()> getValue,
-    int priority, bool isSubmenu, bool isToggle, std::function<bool()> getToggleState,
-    bool isReadOnly, std::function<void(int16_t, int16_t, int16_t, bool)> customDraw
-) {
-    MenuEntry entry;
-    entry.id = id;
-    entry.parent = parent;
-    entry.icon = icon;
-    entry.label = label;
-    entry.shortLabel = shortLabel;
-    entry.onSelect = onSelect;
-    entry.condition = condition;
-    entry.getValue = getValue;
-    entry.priority = priority;
-    entry.isSubmenu = isSubmenu;
-    entry.isToggle = isToggle;
-    entry.getToggleState = getToggleState;
-    entry.isReadOnly = isReadOnly;
-    entry.customDraw = customDraw;
-    entry.isEditableString = false;
-    entry.maxStringLength = 0;
-    entry.getStringValueForEdit = nullptr;
-    entry.setStringValue = nullptr;
-    // Editable value fields use defaults from struct definition
-    return entry;
-}
-
 // Static storage
+std::vector<MenuRegistry::Table> MenuRegistry::tables_;
 std::vector<MenuEntry> MenuRegistry::entries_;
+std::vector<MenuRegistry::Group> MenuRegistry::groups_;
+std::vector<const MenuEntry*> MenuRegistry::children_;
+MenuRegistry::IdSlot MenuRegistry::idCache_[MenuRegistry::kIdCacheSize];
+int16_t MenuRegistry::rootGroup_ = MenuRegistry::kNoGroup;
+bool MenuRegistry::indexDirty_ = true;
+MenuList MenuRegistry::visible_;
+int16_t MenuRegistry::visibleGroup_ = MenuRegistry::kUnset;
+uint32_t MenuRegistry::visibleGeneration_ = 0;
+uint32_t MenuRegistry::generation_ = 0;
+
+namespace {
+
+// The renderer (DisplayTask) and navigation (CommTask) share the index and
+// the visibility cache. Recursive, because conditions may query the registry.
+SemaphoreHandle_t registryLock() {
+    static SemaphoreHandle_t lock = xSemaphoreCreateRecursiveMutex();
+    return lock;
+}
+
+struct RegistryGuard {
+    RegistryGuard() { xSemaphoreTakeRecursive(registryLock(), portMAX_DELAY); }
+    ~RegistryGuard() { xSemaphoreGiveRecursive(registryLock()); }
+};
+
+bool sameId(MenuID a, MenuID b) {
+    if (a == b) {
+        return true;
+    }
+    return a != nullptr && b != nullptr && strcmp(a, b) == 0;
+}
+
+}  // namespace
 
 // ============================================================================
 // Registration
 // ============================================================================
 
 void MenuRegistry::registerEntry(const MenuEntry& entry) {
+    RegistryGuard guard;
+
     // Check for duplicate IDs
-    for (const auto& existing : entries_) {
-        if (strcmp(existing.id, entry.id) == 0) {
-            Serial.printf("[MenuRegistry] WARNING: Duplicate entry '%s' (ignoring)\n", entry.id);
-            return;
-        }
+    if (lookup(entry.id) != nullptr) {
+        Serial.printf("[MenuRegistry] WARNING: Duplicate entry '%s' (ignoring)\n", entry.id);
+        return;
     }
 
     entries_.push_back(entry);
+    markDirty();
     Serial.printf("[MenuRegistry] Registered menu entry: %s (parent: %s)\n",
                   entry.id, entry.parent ? entry.parent : "root");
 }
 
-// ============================================================================
-// Queries
-// ============================================================================
+void MenuRegistry::registerEntries(const MenuEntry* entries, size_t count) {
+    if (entries == nullptr || count == 0) {
+        return;
+    }
 
-const MenuEntry* MenuRegistry::getEntry(MenuID id) {
-    if (id == nullptr) {
-        return nullptr;
+    RegistryGuard guard;
+    size_t added = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (lookup(entries[i].id) == nullptr) {
+            entries_.push_back(entries[i]);
+            added++;
+        }
+    }
+    markDirty();
+    Serial.printf("[MenuRegistry] Registered %u entries\n", static_cast<unsigned>(added));
+}
+
+void MenuRegistry::registerTable(const MenuEntry* entries, size_t count) {
+    if (entries == nullptr || count == 0) {
+        return;
     }
 
-    for (const auto& entry : entries_) {
+    RegistryGuard guard;
+
+    // Duplicates split the table into the runs around them
+    size_t runStart = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (lookup(entries[i].id) == nullptr) {
+            continue;
+        }
+        Serial.printf("[MenuRegistry] WARNING: Duplicate entry '%s' (ignoring)\n", entries[i].id);
+        if (i > runStart) {
+            tables_.push_back(Table{entries + runStart, i - runStart});
+        }
+        runStart = i + 1;
+    }
+    if (count > runStart) {
+        tables_.push_back(Table{entries + runStart, count - runStart});
+    }
+
+    markDirty();
+}
+
+const MenuEntry* MenuRegistry::lookup(MenuID id) {
+    for (const Table& table : tables_) {
+        for (size_t i = 0; i < table.count; ++i) {
+            if (strcmp(table.entries[i].id, id) == 0) {
+                return &table.entries[i];
+            }
+        }
+    }
+    for (const MenuEntry& entry : entries_) {
         if (strcmp(entry.id, id) == 0) {
             return &entry;
         }
     }
-
     return nullptr;
 }
 
-std::vector<const MenuEntry*> MenuRegistry::getEntriesInMenu(MenuID parentId) {
-    std::vector<const MenuEntry*> result;
+// ============================================================================
+// Navigation Index
+// ============================================================================
 
-    for (auto& entry : entries_) {
-        // Check if parent matches
-        bool parentMatches = false;
-        if (parentId == nullptr && entry.parent == nullptr) {
-            parentMatches = true;
-        } else if (parentId != nullptr && entry.parent != nullptr &&
-                   strcmp(entry.parent, parentId) == 0) {
-            parentMatches = true;
+void MenuRegistry::markDirty() {
+    indexDirty_ = true;
+}
+
+void MenuRegistry::ensureIndex() {
+    if (!indexDirty_) {
+        return;
+    }
+    indexDirty_ = false;
+
+    // Flash tables first, then the overlay (registration order within each)
+    std::vector<const MenuEntry*> all;
+    size_t total = entries_.size();
+    for (const Table& table : tables_) {
+        total += table.count;
+    }
+    all.reserve(total);
+    for (const Table& table : tables_) {
+        for (size_t i = 0; i < table.count; ++i) {
+            all.push_back(&table.entries[i]);
         }
+    }
+    for (const MenuEntry& entry : entries_) {
+        all.push_back(&entry);
+    }
 
-        if (parentMatches) {
-            result.push_back(&entry);
+    groups_.clear();
+    children_.assign(all.size(), nullptr);
+    rootGroup_ = kNoGroup;
+
+    // Pass 1: one group per distinct parent ID, counting children
+    std::vector<int16_t> groupOf(all.size(), kNoGroup);
+    for (size_t i = 0; i < all.size(); ++i) {
+        MenuID parent = all[i]->parent;
+        int16_t group = kNoGroup;
+        for (size_t g = 0; g < groups_.size(); ++g) {
+            if (sameId(groups_[g].id, parent)) {
+                group = static_cast<int16_t>(g);
+                break;
+            }
+        }
+        if (group == kNoGroup) {
+            group = static_cast<int16_t>(groups_.size());
+            groups_.push_back(Group{parent, 0, 0});
+            if (parent == nullptr) {
+                rootGroup_ = group;
+            }
         }
+        groups_[group].count++;
+        groupOf[i] = group;
     }
 
-    // Sort by priority
-    std::sort(result.begin(), result.end(), compareByPriority);
+    // Pass 2: lay the groups out contiguously in children_
+    uint16_t offset = 0;
+    for (Group& group : groups_) {
+        group.first = offset;
+        offset += group.count;
+        group.count = 0;
+    }
+    for (size_t i = 0; i < all.size(); ++i) {
+        Group& group = groups_[groupOf[i]];
+        children_[group.first + group.count++] = all[i];
+    }
+
+    // Priority order within each group; ties keep registration order
+    for (Group& group : groups_) {
+        std::stable_sort(children_.begin() + group.first,
+                         children_.begin() + group.first + group.count,
+                         compareByPriority);
+
+        // Intern: use the parent entry's own ID pointer when it exists, so
+        // lookups with entry->id (e.g. from the menu stack) match by identity
+        if (group.id != nullptr) {
+            for (const MenuEntry* entry : all) {
+                if (strcmp(entry->id, group.id) == 0) {
+                    group.id = entry->id;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (IdSlot& slot : idCache_) {
+        slot.id = nullptr;
+        slot.group = kUnset;
+    }
+    visibleGroup_ = kUnset;
+}
+
+int16_t MenuRegistry::findGroup(MenuID parentId) {
+    ensureIndex();
+    if (parentId == nullptr) {
+        return rootGroup_;
+    }
+
+    IdSlot& slot = idCache_[(reinterpret_cast<uintptr_t>(parentId) >> 2) & (kIdCacheSize - 1)];
+    if (slot.id == parentId && slot.group != kUnset) {
+        return slot.group;
+    }
+
+    int16_t found = kNoGroup;
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        if (groups_[g].id != nullptr && sameId(groups_[g].id, parentId)) {
+            found = static_cast<int16_t>(g);
+            break;
+        }
+    }
+    slot.id = parentId;
+    slot.group = found;
+    return found;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+const MenuEntry* MenuRegistry::getEntry(MenuID id) {
+    if (id == nullptr) {
+        return nullptr;
+    }
+
+    RegistryGuard guard;
+    return lookup(id);
+}
+
+std::vector<const MenuEntry*> MenuRegistry::getEntriesInMenu(MenuID parentId) {
+    RegistryGuard guard;
+    std::vector<const MenuEntry*> result;
+
+    const int16_t group = findGroup(parentId);
+    if (group >= 0) {
+        const Group& g = groups_[group];
+        result.assign(children_.begin() + g.first, children_.begin() + g.first + g.count);
+    }
 
     return result;
 }
 
-std::vector<const MenuEntry*> MenuRegistry::getVisibleEntries(MenuID parentId) {
-    std::vector<const MenuEntry*> allEntries = getEntriesInMenu(parentId);
-    std::vector<const MenuEntry*> visible;
+MenuList MenuRegistry::getVisibleEntries(MenuID parentId) {
+    RegistryGuard guard;
 
-    for (const MenuEntry* entry : allEntries) {
-        // Check visibility condition
-        if (entry->condition) {
-            if (entry->condition()) {
-                visible.push_back(entry);
-            }
-        } else {
+    const int16_t group = findGroup(parentId);
+    if (group == visibleGroup_ && visibleGeneration_ == generation_) {
+        return visible_;
+    }
+
+    visible_.count = 0;
+    if (group >= 0) {
+        const Group& g = groups_[group];
+        for (uint16_t i = 0; i < g.count; ++i) {
+            const MenuEntry* entry = children_[g.first + i];
             // No condition = always visible
-            visible.push_back(entry);
+            if (entry->condition && !entry->condition()) {
+                continue;
+            }
+            if (visible_.count >= MenuList::kCapacity) {
+                Serial.printf("[MenuRegistry] WARNING: '%s' has more than %u visible entries\n",
+                              parentId ? parentId : "root",
+                              static_cast<unsigned>(MenuList::kCapacity));
+                break;
+            }
+            visible_.items[visible_.count++] = entry;
         }
     }
 
-    return visible;
+    visibleGroup_ = group;
+    visibleGeneration_ = generation_;
+    return visible_;
+}
+
+void MenuRegistry::invalidateVisibility() {
+    RegistryGuard guard;
+    generation_++;
 }
 
 bool MenuRegistry::hasChildren(MenuID id) {
@@ -125,21 +309,22 @@ bool MenuRegistry::hasChildren(MenuID id) {
         return false;
     }
 
-    for (const auto& entry : entries_) {
-        if (entry.parent != nullptr && strcmp(entry.parent, id) == 0) {
-            return true;
-        }
-    }
-
-    return false;
+    RegistryGuard guard;
+    return findGroup(id) >= 0;
 }
 
 std::vector<MenuEntry>& MenuRegistry::getAllEntries() {
+    // Callers may edit parents or priorities through the reference
+    RegistryGuard guard;
+    markDirty();
     return entries_;
 }
 
 void MenuRegistry::clear() {
+    RegistryGuard guard;
+    tables_.clear();
     entries_.clear();
+    markDirty();
 }
 
 bool MenuRegistry::removeEntry(MenuID id) {
@@ -147,10 +332,12 @@ bool MenuRegistry::removeEntry(MenuID id) {
         return false;
     }
 
+    RegistryGuard guard;
     for (auto it = entries_.begin(); it != entries_.end(); ++it) {
         if (strcmp(it->id, id) == 0) {
             Serial.printf("[MenuRegistry] Removed entry: %s\n", id);
             entries_.erase(it);
+            markDirty();
             return true;
         }
     }
@@ -158,7 +345,28 @@ bool MenuRegistry::removeEntry(MenuID id) {
     return false;
 }
 
+size_t MenuRegistry::takeEntries(const MenuID* ids, size_t count, std::vector<MenuEntry>& out) {
+    RegistryGuard guard;
+    size_t taken = 0;
+    for (size_t i = 0; i < count; ++i) {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (strcmp(it->id, ids[i]) == 0) {
+                out.push_back(*it);
+                entries_.erase(it);
+                taken++;
+                break;
+            }
+        }
+    }
+    if (taken > 0) {
+        markDirty();
+    }
+    Serial.printf("[MenuRegistry] Took %u entries\n", static_cast<unsigned>(taken));
+    return taken;
+}
+
 int MenuRegistry::removeEntriesByParent(MenuID parentId) {
+    RegistryGuard guard;
     int removed = 0;
 
     // Iterate backwards to safely erase while iterating
@@ -183,6 +391,9 @@ int MenuRegistry::removeEntriesByParent(MenuID parentId) {
         }
     }
 
+    if (removed > 0) {
+        markDirty();
+    }
     return removed;
 }
 
@@ -215,320 +426,71 @@ bool MenuRegistry::compareByPriority(const MenuEntry* a, const MenuEntry* b) {
 // Built-in Menu Structure
 // ============================================================================
 
+namespace {
+
+// Table callbacks are plain functions so the table stays a constant
+
+void showDashboard() {
+    // Close menu to show dashboard
+    FrameworkEngine::getInstance().closeMenu();
+}
+
+// Placeholder value and state getters
+const char* brightnessValue() { return "Auto"; }
+const char* contrastValue() { return "128"; }
+const char* volumeValue() { return "50%"; }
+const char* deadzoneValue() { return "5%"; }
+const char* sensitivityValue() { return "100%"; }
+bool alwaysOn() { return true; }
+
+const char* stickCalibrationValue() {
+    AxisCalibration calibration;
+    for (uint8_t axis = AdcSampler::JOY_A_X; axis <= AdcSampler::JOY_B_Y; ++axis) {
+        if (InputManager::getInstance().getJoystickCalibration(static_cast<AdcSampler::Channel>(axis),
+                                                               calibration)) {
+            return "Table";
+        }
+    }
+    return "Auto";
+}
+
+// id, parent, icon, label, shortLabel, onSelect, condition, getValue,
+// priority, isSubmenu, isToggle, getToggleState, isReadOnly, customDraw
+constexpr MenuEntry kBuiltInMenus[] = {
+    // Root level menus ("Home" is not a submenu - it shows the dashboard)
+    {MENU_HOME, MENU_ROOT, ICON_HOME, "Home", nullptr, &showDashboard, nullptr, nullptr, 0, false, false, nullptr, false, nullptr},
+    {MENU_MODULES, MENU_ROOT, ICON_ROBOT, "Modules", nullptr, nullptr, nullptr, nullptr, 10, true, false, nullptr, false, nullptr},
+    {MENU_SETTINGS, MENU_ROOT, ICON_SETTINGS, "Settings", nullptr, nullptr, nullptr, nullptr, 20, true, false, nullptr, false, nullptr},
+    {MENU_QUICK_ACTIONS, MENU_ROOT, ICON_PLAY, "Quick Actions", nullptr, nullptr, nullptr, nullptr, 30, true, false, nullptr, false, nullptr},
+    {MENU_LOGS, MENU_ROOT, ICON_INFO, "Logs", nullptr, nullptr, nullptr, nullptr, 40, false, false, nullptr, false, nullptr},
+    {MENU_ABOUT, MENU_ROOT, ICON_INFO, "About", nullptr, nullptr, nullptr, nullptr, 50, false, false, nullptr, false, nullptr},
+
+    // Settings submenus
+    {MENU_DISPLAY, MENU_SETTINGS, ICON_HOME, "Display", nullptr, nullptr, nullptr, nullptr, 0, true, false, nullptr, false, nullptr},
+    {MENU_AUDIO, MENU_SETTINGS, ICON_SETTINGS, "Audio", nullptr, nullptr, nullptr, nullptr, 10, true, false, nullptr, false, nullptr},
+    {MENU_CONTROLS, MENU_SETTINGS, ICON_JOYSTICK, "Controls", nullptr, nullptr, nullptr, nullptr, 20, true, false, nullptr, false, nullptr},
+    {MENU_NETWORK, MENU_SETTINGS, ICON_SIGNAL_FULL, "Network", nullptr, nullptr, nullptr, nullptr, 30, true, false, nullptr, false, nullptr},
+
+    // Display settings
+    {"display.brightness", MENU_DISPLAY, ICON_SETTINGS, "Brightness", nullptr, nullptr, nullptr, &brightnessValue, 0, false, false, nullptr, false, nullptr},
+    {"display.contrast", MENU_DISPLAY, ICON_SETTINGS, "Contrast", nullptr, nullptr, nullptr, &contrastValue, 10, false, false, nullptr, false, nullptr},
+
+    // Audio settings
+    {"audio.enable", MENU_AUDIO, ICON_SETTINGS, "Enable Audio", nullptr, nullptr, nullptr, nullptr, 0, false, true, &alwaysOn, false, nullptr},
+    {"audio.volume", MENU_AUDIO, ICON_SETTINGS, "Volume", nullptr, nullptr, nullptr, &volumeValue, 10, false, false, nullptr, false, nullptr},
+
+    // Control settings
+    {"controls.deadzone", MENU_CONTROLS, ICON_JOYSTICK, "Joystick Deadzone", nullptr, nullptr, nullptr, &deadzoneValue, 0, false, false, nullptr, false, nullptr},
+    {"controls.sensitivity", MENU_CONTROLS, ICON_JOYSTICK, "Sensitivity", nullptr, nullptr, nullptr, &sensitivityValue, 10, false, false, nullptr, false, nullptr},
+    {"controls.filtering", MENU_CONTROLS, ICON_SETTINGS, "Input Filtering", nullptr, nullptr, nullptr, nullptr, 20, false, true, &alwaysOn, false, nullptr},
+    // Opens the "framework.joycal" screen (JoystickCalibrator)
+    {"framework.joycal", MENU_CONTROLS, ICON_JOYSTICK, "Calibrate Sticks", "Calib", nullptr, nullptr, &stickCalibrationValue, 30, false, false, nullptr, false, nullptr},
+};
+
+}  // namespace
+
 void MenuRegistry::initBuiltInMenus() {
-    Serial.println("[MenuRegistry] Initializing built-in menus...");
-
-    // ========================================================================
-    // Root Level Menus
-    // ========================================================================
-
-    registerEntry(makeMenuEntry(
-        MENU_HOME,
-        MENU_ROOT,
-        ICON_HOME,
-        "Home",
-        nullptr,
-        []() {
-            // Close menu to show dashboard
-            FrameworkEngine::getInstance().closeMenu();
-        },
-        nullptr,
-        nullptr,
-        0,
-        false,  // Not a submenu - directly shows dashboard
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_MODULES,
-        MENU_ROOT,
-        ICON_ROBOT,
-        "Modules",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        10,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_SETTINGS,
-        MENU_ROOT,
-        ICON_SETTINGS,
-        "Settings",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        20,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_QUICK_ACTIONS,
-        MENU_ROOT,
-        ICON_PLAY,
-        "Quick Actions",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        30,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_LOGS,
-        MENU_ROOT,
-        ICON_INFO,
-        "Logs",
-        nullptr,
-        nullptr,  // Screen will be opened by framework
-        nullptr,
-        nullptr,
-        40,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_ABOUT,
-        MENU_ROOT,
-        ICON_INFO,
-        "About",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        50,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    // ========================================================================
-    // Settings Submenus
-    // ========================================================================
-
-    registerEntry(makeMenuEntry(
-        MENU_DISPLAY,
-        MENU_SETTINGS,
-        ICON_HOME,
-        "Display",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        0,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_AUDIO,
-        MENU_SETTINGS,
-        ICON_SETTINGS,
-        "Audio",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        10,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_CONTROLS,
-        MENU_SETTINGS,
-        ICON_JOYSTICK,
-        "Controls",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        20,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        MENU_NETWORK,
-        MENU_SETTINGS,
-        ICON_SIGNAL_FULL,
-        "Network",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        30,
-        true,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    // ========================================================================
-    // Display Settings
-    // ========================================================================
-
-    registerEntry(makeMenuEntry(
-        "display.brightness",
-        MENU_DISPLAY,
-        ICON_SETTINGS,
-        "Brightness",
-        nullptr,
-        nullptr,
-        nullptr,
-        []() { return "Auto"; },  // Placeholder value getter
-        0,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        "display.contrast",
-        MENU_DISPLAY,
-        ICON_SETTINGS,
-        "Contrast",
-        nullptr,
-        nullptr,
-        nullptr,
-        []() { return "128"; },
-        10,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    // ========================================================================
-    // Audio Settings
-    // ========================================================================
-
-    registerEntry(makeMenuEntry(
-        "audio.enable",
-        MENU_AUDIO,
-        ICON_SETTINGS,
-        "Enable Audio",
-        nullptr,
-        nullptr,  // Callback set by framework
-        nullptr,
-        nullptr,
-        0,
-        false,
-        true,  // Is toggle
-        []() { return true; },  // Placeholder state getter
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        "audio.volume",
-        MENU_AUDIO,
-        ICON_SETTINGS,
-        "Volume",
-        nullptr,
-        nullptr,
-        nullptr,
-        []() { return "50%"; },
-        10,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    // ========================================================================
-    // Control Settings
-    // ========================================================================
-
-    registerEntry(makeMenuEntry(
-        "controls.deadzone",
-        MENU_CONTROLS,
-        ICON_JOYSTICK,
-        "Joystick Deadzone",
-        nullptr,
-        nullptr,
-        nullptr,
-        []() { return "5%"; },
-        0,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        "controls.sensitivity",
-        MENU_CONTROLS,
-        ICON_JOYSTICK,
-        "Sensitivity",
-        nullptr,
-        nullptr,
-        nullptr,
-        []() { return "100%"; },
-        10,
-        false,
-        false,
-        nullptr,
-        false,
-        nullptr
-    ));
-
-    registerEntry(makeMenuEntry(
-        "controls.filtering",
-        MENU_CONTROLS,
-        ICON_SETTINGS,
-        "Input Filtering",
-        nullptr,
-        nullptr,
-        nullptr,
-        nullptr,
-        20,
-        false,
-        true,
-        []() { return true; },
-        false,
-        nullptr
-    ));
-
-    Serial.printf("[MenuRegistry] Initialized %zu built-in menu entries\n", entries_.size());
+    registerTable(kBuiltInMenus, sizeof(kBuiltInMenus) / sizeof(kBuiltInMenus[0]));
+    Serial.printf("[MenuRegistry] Initialized %zu built-in menu entries (flash)\n",
+                  sizeof(kBuiltInMenus) / sizeof(kBuiltInMenus[0]));
 }
@@ -0,0 +1,216 @@
+/**
+ * @file MicroBench.cpp
+ * @brief Kernel timing, stack painting and allocation counting
+ */
+
+#include "MicroBench.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef ILITE_NATIVE
+#include <chrono>
+#endif
+
+float MicroBench::overheadTicks_ = 0.0f;
+uint32_t MicroBench::overheadStack_ = 0;
+bool MicroBench::calibrated_ = false;
+
+namespace {
+
+constexpr uint8_t kPaint = 0xA5;
+constexpr uint32_t kCalibrationCalls = 2000;
+
+volatile uint32_t allocCount = 0;
+volatile uint32_t allocBytes = 0;
+
+void emptyKernel(void*) {}
+
+// Both frames hold the probe at the same depth below the caller, so the
+// kernel called in between runs over the painted bytes
+__attribute__((noinline)) void paintStack() {
+    volatile uint8_t area[MicroBench::kStackProbeBytes];
+    for (size_t i = 0; i < sizeof(area); ++i) {
+        area[i] = kPaint;
+    }
+}
+
+// Stack grows down: area[0] is the deepest byte. Reading the bytes left by
+// paintStack() and the kernel is the point, hence the pragmas.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((noinline)) size_t untouchedStack() {
+    volatile uint8_t area[MicroBench::kStackProbeBytes];
+    size_t untouched = 0;
+    while (untouched < sizeof(area) && area[untouched] == kPaint) {
+        untouched++;
+    }
+    return untouched;
+}
+#pragma GCC diagnostic pop
+
+}  // namespace
+
+// ============================================================================
+// Allocation Counting (ILITE_BENCH builds)
+// ============================================================================
+
+#ifdef ILITE_BENCH
+
+namespace {
+
+void* countedAlloc(size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&allocBytes, static_cast<uint32_t>(size), __ATOMIC_RELAXED);
+    void* block = malloc(size != 0 ? size : 1);
+    if (block == nullptr) {
+        abort();
+    }
+    return block;
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+
+bool MicroBench::isCountingAllocs() { return true; }
+
+#else
+
+bool MicroBench::isCountingAllocs() { return false; }
+
+#endif // ILITE_BENCH
+
+uint32_t MicroBench::getAllocCount() { return allocCount; }
+uint32_t MicroBench::getAllocBytes() { return allocBytes; }
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+uint64_t MicroBench::ticks() {
+#ifdef ILITE_NATIVE
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#else
+    return ESP.getCycleCount();
+#endif
+}
+
+uint64_t MicroBench::elapsedTicks(uint64_t start, uint64_t end) {
+#ifdef ILITE_NATIVE
+    return end - start;
+#else
+    return static_cast<uint32_t>(end - start);     // CCOUNT wraps at 32 bits
+#endif
+}
+
+float MicroBench::ticksToNs(float ticks) {
+#ifdef ILITE_NATIVE
+    return ticks;
+#else
+    const uint32_t mhz = getCpuFrequencyMhz();
+    return mhz != 0 ? ticks * 1000.0f / static_cast<float>(mhz) : 0.0f;
+#endif
+}
+
+float MicroBench::ticksToCycles(float ticks) {
+#ifdef ILITE_NATIVE
+    (void)ticks;
+    return 0.0f;
+#else
+    return ticks;
+#endif
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+uint32_t MicroBench::stackUsed(Kernel kernel, void* context) {
+    paintStack();
+    kernel(context);
+    return static_cast<uint32_t>(kStackProbeBytes - untouchedStack());
+}
+
+BenchResult MicroBench::run(const char* name, Kernel kernel, void* context,
+                            uint32_t iterations, uint32_t warmup) {
+    if (!calibrated_) {
+        calibrated_ = true;
+        const uint64_t start = ticks();
+        for (uint32_t i = 0; i < kCalibrationCalls; ++i) {
+            emptyKernel(nullptr);
+            __asm__ __volatile__("" ::: "memory");
+        }
+        overheadTicks_ = static_cast<float>(elapsedTicks(start, ticks())) / kCalibrationCalls;
+        overheadStack_ = stackUsed(emptyKernel, nullptr);
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    for (uint32_t i = 0; i < warmup; ++i) {
+        kernel(context);
+    }
+
+    // Stack first, so the timed loop does not depend on the painting
+    const uint32_t stack = stackUsed(kernel, context);
+
+    const uint32_t allocsBefore = allocCount;
+    const uint32_t bytesBefore = allocBytes;
+    const uint64_t start = ticks();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        kernel(context);
+    }
+    const uint64_t elapsed = elapsedTicks(start, ticks());
+    const uint32_t allocs = allocCount - allocsBefore;
+    const uint32_t bytes = allocBytes - bytesBefore;
+
+    float perOp = static_cast<float>(elapsed) / static_cast<float>(iterations) - overheadTicks_;
+    if (perOp < 0.0f) {
+        perOp = 0.0f;
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = ticksToNs(perOp);
+    result.cyclesPerOp = ticksToCycles(perOp);
+    result.stackBytes = stack > overheadStack_ ? stack - overheadStack_ : 0;
+    result.allocsPerOp = static_cast<float>(allocs) / static_cast<float>(iterations);
+    result.allocBytesPerOp = static_cast<float>(bytes) / static_cast<float>(iterations);
+    return result;
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+void MicroBench::printHeader(Print& out) {
+#ifdef ILITE_NATIVE
+    out.printf("#build,native,%s %s,cpu_mhz=0,allocs=%d\n", __DATE__, __TIME__,
+               isCountingAllocs() ? 1 : 0);
+#else
+    out.printf("#build,esp32,%s %s,cpu_mhz=%lu,allocs=%d\n", __DATE__, __TIME__,
+               static_cast<unsigned long>(getCpuFrequencyMhz()), isCountingAllocs() ? 1 : 0);
+#endif
+    out.println("#bench,name,iterations,ns_per_op,cycles_per_op,stack_bytes,allocs_per_op,alloc_bytes_per_op");
+}
+
+void MicroBench::print(Print& out, const BenchResult& result) {
+    out.printf("bench,%s,%lu,%.1f,%.1f,%lu,%.3f,%.1f\n",
+               result.name,
+               static_cast<unsigned long>(result.iterations),
+               result.nsPerOp,
+               result.cyclesPerOp,
+               static_cast<unsigned long>(result.stackBytes),
+               result.allocsPerOp,
+               result.allocBytesPerOp);
+}
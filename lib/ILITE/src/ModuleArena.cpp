@@ -0,0 +1,141 @@
+/**
+ * @file ModuleArena.cpp
+ * @brief Module-scoped bump arena and heap reporting
+ */
+
+#include "ModuleArena.h"
+#include <esp_heap_caps.h>
+#include <cstring>
+
+alignas(8) uint8_t ModuleArena::buffer_[ModuleArena::kBanks][ModuleArena::kCapacity];
+uint8_t* ModuleArena::base_ = ModuleArena::buffer_[0];
+ModuleArena::Bank ModuleArena::standby_ = {ModuleArena::buffer_[1], 0, nullptr, 0, 0};
+size_t ModuleArena::used_ = 0;
+size_t ModuleArena::peak_ = 0;
+uint32_t ModuleArena::failures_ = 0;
+uint8_t* ModuleArena::state_ = nullptr;
+size_t ModuleArena::stateCapacity_ = 0;
+size_t ModuleArena::stateUsed_ = 0;
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+void* ModuleArena::allocate(size_t size, size_t align) {
+    const size_t start = (used_ + align - 1) & ~(align - 1);
+    if (start + size > kCapacity) {
+        if (failures_++ == 0) {
+            Serial.printf("[ModuleArena] WARNING: out of space (%u + %u > %u)\n",
+                          static_cast<unsigned>(used_),
+                          static_cast<unsigned>(size),
+                          static_cast<unsigned>(kCapacity));
+        }
+        return nullptr;
+    }
+
+    used_ = start + size;
+    if (used_ > peak_) {
+        peak_ = used_;
+    }
+    return base_ + start;
+}
+
+const char* ModuleArena::copyString(const char* text) {
+    if (text == nullptr) {
+        return nullptr;
+    }
+
+    const size_t length = strlen(text) + 1;
+    char* copy = static_cast<char*>(allocate(length, 1));
+    if (copy != nullptr) {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+bool ModuleArena::owns(const void* ptr) {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    return p >= base_ && p < base_ + kCapacity;
+}
+
+void ModuleArena::reset() {
+    used_ = 0;
+    failures_ = 0;
+
+    delete[] state_;
+    state_ = nullptr;
+    stateCapacity_ = 0;
+    stateUsed_ = 0;
+}
+
+void ModuleArena::swapBanks() {
+    const Bank active = {base_, used_, state_, stateCapacity_, stateUsed_};
+    base_ = standby_.base;
+    used_ = standby_.used;
+    state_ = standby_.state;
+    stateCapacity_ = standby_.stateCapacity;
+    stateUsed_ = standby_.stateUsed;
+    standby_ = active;
+}
+
+// ============================================================================
+// Working State
+// ============================================================================
+
+bool ModuleArena::reserveState(size_t bytes) {
+    delete[] state_;
+    state_ = nullptr;
+    stateCapacity_ = 0;
+    stateUsed_ = 0;
+    if (bytes == 0) {
+        return true;
+    }
+
+    state_ = new (std::nothrow) uint8_t[bytes]();
+    if (state_ == nullptr) {
+        Serial.printf("[ModuleArena] WARNING: no heap for %u bytes of module state\n",
+                      static_cast<unsigned>(bytes));
+        return false;
+    }
+    stateCapacity_ = bytes;
+    return true;
+}
+
+void* ModuleArena::allocateState(size_t size) {
+    const size_t bytes = stateBytes(size);
+    if (state_ == nullptr || stateUsed_ + bytes > stateCapacity_) {
+        Serial.printf("[ModuleArena] WARNING: module state full (%u + %u > %u)\n",
+                      static_cast<unsigned>(stateUsed_),
+                      static_cast<unsigned>(bytes),
+                      static_cast<unsigned>(stateCapacity_));
+        return nullptr;
+    }
+
+    void* memory = state_ + stateUsed_;
+    stateUsed_ += bytes;
+    return memory;
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+void ModuleArena::dumpHeap(Print& out, const char* stage) {
+    const size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    const unsigned fragmentation = freeBytes ? 100 - static_cast<unsigned>((largest * 100ULL) / freeBytes) : 0;
+
+    out.printf("[Heap] %s: free %u, largest %u (frag %u%%), min %u | arena %u/%u peak %u | state %u/%u"
+               " | standby %u\n",
+               stage,
+               static_cast<unsigned>(freeBytes),
+               static_cast<unsigned>(largest),
+               fragmentation,
+               static_cast<unsigned>(heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT)),
+               static_cast<unsigned>(used_),
+               static_cast<unsigned>(kCapacity),
+               static_cast<unsigned>(peak_),
+               static_cast<unsigned>(stateUsed_),
+               static_cast<unsigned>(stateCapacity_),
+               static_cast<unsigned>(standbyUsed()));
+}
@@ -9,11 +9,26 @@
 #include "ILITEModule.h"
 #include "HomeScreen.h"
 #include "ILITE.h"
+#include "IconLibrary.h"
+#include "Animator.h"
 #include <Arduino.h>
+#include <new>
 
 // Static member initialization
 int ModuleBrowser::currentIndex_ = 0;
 int ModuleBrowser::scrollOffset_ = 0;
+ModuleBrowser::Thumbnail ModuleBrowser::thumbnails_[ModuleBrowser::kMaxThumbnails] = {};
+size_t ModuleBrowser::thumbnailCount_ = 0;
+
+// Thumbnail sizes (Small is the unselected card box, Large includes its outer border)
+static constexpr int16_t kSmallW = 56;
+static constexpr int16_t kSmallH = 40;
+static constexpr int16_t kLargeW = 66;
+static constexpr int16_t kLargeH = 50;
+
+// Cards sit kCardPitch apart on a strip that slides to the selected one
+static constexpr int kCardPitch = 80;
+static Tween cardScroll(180, Ease::OutCubic);
 
 // Generic/fallback logo (32x32 XBM format - simple grid)
 static const uint8_t generic_logo_32x32[] = {
@@ -37,6 +52,7 @@ static const uint8_t generic_logo_32x32[] = {
 void ModuleBrowser::begin() {
     currentIndex_ = 0;
     scrollOffset_ = 0;
+    cardScroll.snap(0);
     Serial.println("[ModuleBrowser] Initialized");
 }
 
@@ -54,20 +70,24 @@ void ModuleBrowser::draw(DisplayCanvas& canvas) {
     if (moduleCount == 0) {
         canvas.setFont(DisplayCanvas::SMALL);
         canvas.drawTextCentered(32, "No modules");
-        canvas.sendBuffer();
         return;
     }
 
-    // Draw single card centered (horizontal scrolling UI)
-    ILITEModule* module = ModuleRegistry::getModuleByIndex(currentIndex_);
-    if (module != nullptr) {
-        // Large centered card (64x48)
-        int cardWidth = 64;
-        int cardHeight = 48;
-        int x = (128 - cardWidth) / 2;  // Center horizontally
-        int y = 18;  // Below title bar
-
-        drawLargeCard(canvas, module, x, y);
+    // Draw the card strip (horizontal scrolling UI); neighbours show while sliding
+    cardScroll.retarget(currentIndex_ * kCardPitch);
+    scrollOffset_ = cardScroll.value();
+
+    const int cardWidth = 64;
+    const int y = 18;  // Below title bar
+    for (int i = 0; i < moduleCount; ++i) {
+        const int x = (128 - cardWidth) / 2 + i * kCardPitch - scrollOffset_;
+        if (x <= -cardWidth - 2 || x >= 128 + 1) {
+            continue;
+        }
+        ILITEModule* module = ModuleRegistry::getModuleByIndex(i);
+        if (module != nullptr) {
+            drawLargeCard(canvas, module, x, y);
+        }
     }
 
     // Module counter
@@ -102,8 +122,9 @@ void ModuleBrowser::onEncoderButton() {
     if (module != nullptr) {
         Serial.printf("[ModuleBrowser] Selected: %s\n", module->getModuleName());
 
-        // Activate the module (this is like inserting the game cartridge)
-        ::ILITEFramework::getInstance().setActiveModule(module);
+        // Activate the module (this is like inserting the game cartridge);
+        // input runs pinned on CommTask, so the switch happens on ServiceTask
+        ::ILITEFramework::getInstance().requestModuleActivation(module);
 
         // Switch to module dashboard to show it's running
         HomeScreen::setMode(DisplayMode::MODULE_DASHBOARD);
@@ -125,24 +146,111 @@ int ModuleBrowser::getCurrentIndex() {
     return currentIndex_;
 }
 
+void ModuleBrowser::clearThumbnails() {
+    for (size_t i = 0; i < thumbnailCount_; ++i) {
+        delete[] thumbnails_[i].pages;
+        thumbnails_[i] = Thumbnail{};
+    }
+    thumbnailCount_ = 0;
+}
+
+size_t ModuleBrowser::getThumbnailBytes() {
+    size_t bytes = 0;
+    for (size_t i = 0; i < thumbnailCount_; ++i) {
+        const bool large = thumbnails_[i].style == CardStyle::Large;
+        bytes += large ? kLargeW * ((kLargeH + 7) / 8) : kSmallW * ((kSmallH + 7) / 8);
+    }
+    return bytes;
+}
+
 // ============================================================================
 // Private Methods
 // ============================================================================
 
+void ModuleBrowser::drawLogo(DisplayCanvas& canvas, int16_t x, int16_t y, const uint8_t* logo) {
+    // Logos are converted to page format once and blitted from then on
+    const Icon* bitmap = IconLibrary::getBitmap(logo, 32, 32);
+    if (bitmap != nullptr) {
+        canvas.drawIconBitmap(x, y, *bitmap);
+    } else {
+        canvas.getU8G2().drawXBM(x, y, 32, 32, logo);
+    }
+}
+
+const uint8_t* ModuleBrowser::getThumbnail(DisplayCanvas& canvas, ILITEModule* module, CardStyle style) {
+    for (size_t i = 0; i < thumbnailCount_; ++i) {
+        if (thumbnails_[i].module == module && thumbnails_[i].style == style) {
+            return thumbnails_[i].pages;
+        }
+    }
+    if (thumbnailCount_ >= kMaxThumbnails) {
+        return nullptr;
+    }
+
+    // Rasterize like TextCache does: render into a page-aligned corner of
+    // the framebuffer, copy the pages out and put back what was there
+    const bool large = style == CardStyle::Large;
+    const int16_t width = large ? kLargeW : kSmallW;
+    const uint8_t pageCount = ((large ? kLargeH : kSmallH) + 7) / 8;
+    uint8_t saved[kLargeW * ((kLargeH + 7) / 8)];
+    if (!canvas.readPages(0, 0, width, pageCount, saved)) {
+        return nullptr;
+    }
+    uint8_t* pages = new (std::nothrow) uint8_t[width * pageCount];
+    if (pages == nullptr) {
+        return nullptr;
+    }
+
+    canvas.setDrawColor(0);
+    canvas.drawRect(0, 0, width, pageCount * 8, true);
+    canvas.setDrawColor(1);
+    if (large) {
+        renderLargeCard(canvas, module, 1, 1);
+    } else {
+        renderCard(canvas, module, 0, 0);
+    }
+    canvas.readPages(0, 0, width, pageCount, pages);
+    canvas.drawPages(0, 0, width, pageCount * 8, saved);
+
+    thumbnails_[thumbnailCount_++] = Thumbnail{module, style, pages};
+    return pages;
+}
+
 void ModuleBrowser::drawCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y, bool selected) {
     if (module == nullptr) return;
 
-    const char* moduleName = module->getModuleName();
-
-    // Draw card border
     if (selected) {
-        // Double border for selected card
+        // Double border for selected card (the thumbnail has the inner box)
         canvas.drawRect(x - 2, y - 2, 60, 44, false);
         canvas.drawRect(x - 1, y - 1, 58, 42, false);
+    }
+
+    const uint8_t* pages = getThumbnail(canvas, module, CardStyle::Small);
+    if (pages != nullptr) {
+        canvas.drawPages(x, y, kSmallW, kSmallH, pages);
+    } else {
+        renderCard(canvas, module, x, y);
+    }
+}
+
+void ModuleBrowser::drawLargeCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y) {
+    if (module == nullptr) return;
+
+    const uint8_t* pages = getThumbnail(canvas, module, CardStyle::Large);
+    if (pages != nullptr) {
+        canvas.drawPages(x - 1, y - 1, kLargeW, kLargeH, pages);
     } else {
-        // Simple border for unselected card
-        canvas.drawRect(x, y, 56, 40, false);
+        renderLargeCard(canvas, module, x, y);
     }
+}
+
+void ModuleBrowser::renderCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y) {
+    if (module == nullptr) return;
+
+    const char* moduleName = module->getModuleName();
+
+    // Draw card border
+    canvas.drawRect(x, y, 56, 40, false);
 
     // Get logo from module (or use generic fallback)
     const uint8_t* logo = module->getLogo32x32();
@@ -154,8 +262,7 @@ void ModuleBrowser::drawCard(DisplayCanvas& canvas, ILITEModule* module, int16_t
     int logoX = x + 12;  // Center horizontally (56-32)/2 = 12
     int logoY = y + 4;   // Top of card with small margin
 
-    // Use U8G2 directly for XBM drawing
-    canvas.getU8G2().drawXBM(logoX, logoY, 32, 32, logo);
+    drawLogo(canvas, logoX, logoY, logo);
 
     // Draw module name below logo (truncated if needed)
     canvas.setFont(DisplayCanvas::TINY);
@@ -168,7 +275,7 @@ void ModuleBrowser::drawCard(DisplayCanvas& canvas, ILITEModule* module, int16_t
     canvas.drawText(textX, y + 38, nameBuffer);
 }
 
-void ModuleBrowser::drawLargeCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y) {
+void ModuleBrowser::renderLargeCard(DisplayCanvas& canvas, ILITEModule* module, int16_t x, int16_t y) {
     if (module == nullptr) return;
 
     const char* moduleName = module->getModuleName();
@@ -187,8 +294,7 @@ void ModuleBrowser::drawLargeCard(DisplayCanvas& canvas, ILITEModule* module, in
     int logoX = x + 16;  // Center horizontally (64-32)/2 = 16
     int logoY = y + 2;   // Top of card with small margin
 
-    // Use U8G2 directly for XBM drawing
-    canvas.getU8G2().drawXBM(logoX, logoY, 32, 32, logo);
+    drawLogo(canvas, logoX, logoY, logo);
 
     // Draw module name below logo (centered)
     canvas.setFont(DisplayCanvas::SMALL);
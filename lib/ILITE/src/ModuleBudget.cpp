@@ -0,0 +1,221 @@
+/**
+ * @file ModuleBudget.cpp
+ * @brief Callback timing table, throttling and the budget report
+ */
+
+#include "ModuleBudget.h"
+#include "ILITEModule.h"
+#include "LogChannels.h"
+#include <esp_timer.h>
+
+struct ModuleBudgetEntry {
+    ILITEModule* module;
+    uint32_t lastCallMs;
+    bool budgetsLoaded;
+    ModuleCallbackStats stats[ModuleBudget::kCallbackCount];
+    uint8_t strikes[ModuleBudget::kCallbackCount];
+    uint8_t throttleCalls[ModuleBudget::kCallbackCount];
+};
+
+namespace {
+
+const char* const kCallbackNames[ModuleBudget::kCallbackCount] = {
+    "draw", "control", "prepare", "telemetry", "service"
+};
+
+// Defaults: a dashboard well inside a 30 fps frame, control and packet
+// building well inside a 100 Hz tick, service calls a slice of its 10 ms
+const uint32_t kDefaultBudgetUs[ModuleBudget::kCallbackCount] = {
+    20000, 2000, 500, 500, 5000
+};
+
+// Each callback's stats have one writer (the task it runs on); the lock
+// only covers finding and replacing entries
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+ModuleBudgetEntry g_entries[ModuleBudget::kMaxModules] = {};
+ModuleBudgetPolicy g_policy = ModuleBudgetPolicy::Skip;
+
+}  // namespace
+
+// ============================================================================
+// Policy
+// ============================================================================
+
+void ModuleBudget::setPolicy(ModuleBudgetPolicy policy) {
+    g_policy = policy;
+}
+
+ModuleBudgetPolicy ModuleBudget::getPolicy() {
+    return g_policy;
+}
+
+uint32_t ModuleBudget::defaultBudgetUs(ModuleCallback callback) {
+    const size_t index = static_cast<size_t>(callback);
+    return index < kCallbackCount ? kDefaultBudgetUs[index] : 0;
+}
+
+bool ModuleBudget::isSkippable(ModuleCallback callback) {
+    return callback == ModuleCallback::Draw || callback == ModuleCallback::Service;
+}
+
+const char* ModuleBudget::name(ModuleCallback callback) {
+    const size_t index = static_cast<size_t>(callback);
+    return index < kCallbackCount ? kCallbackNames[index] : "?";
+}
+
+// ============================================================================
+// Calls
+// ============================================================================
+
+ModuleBudgetEntry* ModuleBudget::entryFor(ILITEModule* module) {
+    const uint32_t now = millis();
+    ModuleBudgetEntry* entry = nullptr;
+    portENTER_CRITICAL(&g_lock);
+    ModuleBudgetEntry* oldest = &g_entries[0];
+    for (ModuleBudgetEntry& candidate : g_entries) {
+        if (candidate.module == module) {
+            entry = &candidate;
+            break;
+        }
+        if (oldest->module != nullptr &&
+            (candidate.module == nullptr || now - candidate.lastCallMs > now - oldest->lastCallMs)) {
+            oldest = &candidate;
+        }
+    }
+    if (entry == nullptr) {
+        entry = oldest;
+        *entry = ModuleBudgetEntry{};
+        entry->module = module;
+    }
+    entry->lastCallMs = now;
+    portEXIT_CRITICAL(&g_lock);
+
+    // Module code runs outside the lock
+    if (!entry->budgetsLoaded) {
+        for (size_t i = 0; i < kCallbackCount; ++i) {
+            entry->stats[i].budgetUs = module->getCallbackBudgetUs(static_cast<ModuleCallback>(i));
+        }
+        entry->budgetsLoaded = true;
+    }
+    return entry;
+}
+
+bool ModuleBudget::admit(ModuleBudgetEntry* entry, ModuleCallback callback) {
+    const size_t index = static_cast<size_t>(callback);
+    ModuleCallbackStats& stats = entry->stats[index];
+    if (!stats.throttled) {
+        return true;
+    }
+    // A throttled callback still runs now and then to notice recovery
+    if (++entry->throttleCalls[index] >= kSkipDivider) {
+        entry->throttleCalls[index] = 0;
+        return true;
+    }
+    stats.skipped++;
+    return false;
+}
+
+void ModuleBudget::finish(ModuleBudgetEntry* entry, ModuleCallback callback, uint32_t elapsedUs) {
+    const size_t index = static_cast<size_t>(callback);
+    ModuleCallbackStats& stats = entry->stats[index];
+    stats.avgUs = stats.calls == 0 ? elapsedUs
+                                   : stats.avgUs + static_cast<int32_t>(elapsedUs - stats.avgUs) / 8;
+    if (elapsedUs > stats.maxUs) {
+        stats.maxUs = elapsedUs;
+    }
+    stats.calls++;
+
+    // A budget of 0 is unlimited
+    if (stats.budgetUs == 0 || elapsedUs <= stats.budgetUs) {
+        entry->strikes[index] = 0;
+        if (stats.throttled) {
+            stats.throttled = false;
+            ILITE_LOG(SYSTEM, LOG_INFO, "%s %s back within budget", entry->module->getModuleName(),
+                      kCallbackNames[index]);
+        }
+        return;
+    }
+
+    stats.violations++;
+    if (entry->strikes[index] < UINT8_MAX) {
+        entry->strikes[index]++;
+    }
+    ILITE_LOG_RATE(SYSTEM, LOG_WARN, 1, 3, "%s %s took %lu us (budget %lu)",
+                   entry->module->getModuleName(), kCallbackNames[index],
+                   static_cast<unsigned long>(elapsedUs), static_cast<unsigned long>(stats.budgetUs));
+    if (g_policy == ModuleBudgetPolicy::Skip && isSkippable(callback) && !stats.throttled &&
+        entry->strikes[index] >= kStrikes) {
+        stats.throttled = true;
+        entry->throttleCalls[index] = 0;
+        ILITE_LOG(SYSTEM, LOG_WARN, "%s %s over budget %u times in a row, running 1 call in %u",
+                  entry->module->getModuleName(), kCallbackNames[index],
+                  static_cast<unsigned>(kStrikes), static_cast<unsigned>(kSkipDivider));
+    }
+}
+
+ModuleCall::ModuleCall(ILITEModule* module, ModuleCallback callback)
+    : entry_(nullptr), callback_(callback), startUs_(0), allowed_(true) {
+    if (module == nullptr || g_policy == ModuleBudgetPolicy::Off) {
+        return;
+    }
+    entry_ = ModuleBudget::entryFor(module);
+    allowed_ = ModuleBudget::admit(entry_, callback);
+    startUs_ = esp_timer_get_time();
+}
+
+ModuleCall::~ModuleCall() {
+    if (entry_ != nullptr && allowed_) {
+        ModuleBudget::finish(entry_, callback_, static_cast<uint32_t>(esp_timer_get_time() - startUs_));
+    }
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+const ILITEModule* ModuleBudget::getModule(size_t slot) {
+    return slot < kMaxModules ? g_entries[slot].module : nullptr;
+}
+
+ModuleCallbackStats ModuleBudget::getStats(size_t slot, ModuleCallback callback) {
+    const size_t index = static_cast<size_t>(callback);
+    if (slot >= kMaxModules || index >= kCallbackCount) {
+        return ModuleCallbackStats{};
+    }
+    return g_entries[slot].stats[index];
+}
+
+void ModuleBudget::reset() {
+    portENTER_CRITICAL(&g_lock);
+    for (ModuleBudgetEntry& entry : g_entries) {
+        for (size_t i = 0; i < kCallbackCount; ++i) {
+            const uint32_t budgetUs = entry.stats[i].budgetUs;
+            entry.stats[i] = ModuleCallbackStats{};
+            entry.stats[i].budgetUs = budgetUs;
+            entry.strikes[i] = 0;
+        }
+    }
+    portEXIT_CRITICAL(&g_lock);
+}
+
+void ModuleBudget::dump(Print& out) {
+    static const char* const kPolicyNames[] = {"off", "warn", "skip"};
+    out.printf("[Budget] policy %s\n", kPolicyNames[static_cast<size_t>(g_policy)]);
+    for (const ModuleBudgetEntry& entry : g_entries) {
+        if (entry.module == nullptr) {
+            continue;
+        }
+        out.printf("[Budget] %s\n", entry.module->getModuleName());
+        for (size_t i = 0; i < kCallbackCount; ++i) {
+            const ModuleCallbackStats& stats = entry.stats[i];
+            if (stats.calls == 0 && stats.skipped == 0) {
+                continue;
+            }
+            out.printf("[Budget]   %-9s budget %6lu  avg %6lu  max %6lu  %lu/%lu over, %lu skipped%s\n",
+                       kCallbackNames[i], static_cast<unsigned long>(stats.budgetUs),
+                       static_cast<unsigned long>(stats.avgUs), static_cast<unsigned long>(stats.maxUs),
+                       static_cast<unsigned long>(stats.violations), static_cast<unsigned long>(stats.calls),
+                       static_cast<unsigned long>(stats.skipped), stats.throttled ? " (throttled)" : "");
+        }
+    }
+}
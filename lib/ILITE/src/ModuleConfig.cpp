@@ -0,0 +1,208 @@
+/**
+ * @file ModuleConfig.cpp
+ * @brief Config blob codec, field-ID migration and NVS storage
+ */
+
+#include "ModuleConfig.h"
+#include "Framing.h"
+#include "ILITEHelpers.h"
+#include "LogChannels.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint16_t kBlobMagic = 0x4349;    // 'IC'
+constexpr uint8_t kBlobFormat = 1;
+constexpr const char* kNamespace = "modcfg";
+
+using Framing::crc16;
+using Framing::getU16;
+using Framing::getU32;
+using Framing::putU16;
+using Framing::putU32;
+
+// NVS keys are at most 15 characters; module IDs ("com.ilite.thegill") are longer
+void makeKey(const char* moduleId, char* key, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (const char* c = moduleId; c != nullptr && *c != '\0'; ++c) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    snprintf(key, size, "cfg%08lx", static_cast<unsigned long>(hash));
+}
+
+const ConfigField* findField(const ConfigDescriptor& desc, uint8_t id) {
+    for (size_t i = 0; i < desc.fieldCount; ++i) {
+        if (desc.fields[i].id == id) {
+            return &desc.fields[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+// ============================================================================
+// Codec
+// ============================================================================
+
+uint32_t ModuleConfigStore::layoutHash(const ConfigDescriptor& desc) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(value >> (8 * i))) * 16777619u;
+        }
+    };
+    mix(static_cast<uint32_t>(desc.size));
+    for (size_t i = 0; i < desc.fieldCount; ++i) {
+        const ConfigField& field = desc.fields[i];
+        mix(field.id | (static_cast<uint32_t>(field.type) << 8));
+        mix(static_cast<uint32_t>(field.offset) | (static_cast<uint32_t>(field.size) << 16));
+    }
+    return hash;
+}
+
+size_t ModuleConfigStore::encode(const ConfigDescriptor& desc, const void* data,
+                                 uint8_t* out, size_t capacity) {
+    const size_t length = kHeaderSize + desc.fieldCount * kFieldEntrySize + desc.size + 2;
+    if (data == nullptr || out == nullptr || desc.fieldCount > 255 || desc.size > 0xFFFF ||
+        length > capacity) {
+        return 0;
+    }
+
+    putU16(out, kBlobMagic);
+    out[2] = kBlobFormat;
+    out[3] = static_cast<uint8_t>(desc.fieldCount);
+    putU16(out + 4, desc.version);
+    putU16(out + 6, static_cast<uint16_t>(desc.size));
+    putU32(out + 8, layoutHash(desc));
+
+    uint8_t* entry = out + kHeaderSize;
+    for (size_t i = 0; i < desc.fieldCount; ++i, entry += kFieldEntrySize) {
+        const ConfigField& field = desc.fields[i];
+        entry[0] = field.id;
+        entry[1] = static_cast<uint8_t>(field.type);
+        putU16(entry + 2, static_cast<uint16_t>(field.offset));
+        putU16(entry + 4, static_cast<uint16_t>(field.size));
+    }
+    memcpy(entry, data, desc.size);
+    putU16(entry + desc.size, crc16(out, length - 2));
+    return length;
+}
+
+ModuleConfigStore::LoadResult ModuleConfigStore::decode(const ConfigDescriptor& desc,
+                                                        const uint8_t* blob, size_t length,
+                                                        void* data) {
+    if (blob == nullptr || length == 0) {
+        return LoadResult::Missing;
+    }
+    if (length < kHeaderSize + 2 || getU16(blob) != kBlobMagic || blob[2] != kBlobFormat) {
+        return LoadResult::Invalid;
+    }
+    const size_t fieldCount = blob[3];
+    const size_t storedSize = getU16(blob + 6);
+    const uint8_t* table = blob + kHeaderSize;
+    const uint8_t* image = table + fieldCount * kFieldEntrySize;
+    if (kHeaderSize + fieldCount * kFieldEntrySize + storedSize + 2 != length ||
+        crc16(blob, length - 2) != getU16(blob + length - 2)) {
+        return LoadResult::Invalid;
+    }
+
+    uint8_t* target = static_cast<uint8_t*>(data);
+    if (storedSize == desc.size && getU32(blob + 8) == layoutHash(desc)) {
+        memcpy(target, image, desc.size);
+        return LoadResult::Exact;
+    }
+
+    // Copy every stored field that still exists unchanged, wherever it moved
+    for (size_t i = 0; i < fieldCount; ++i) {
+        const uint8_t* entry = table + i * kFieldEntrySize;
+        const ConfigField* field = findField(desc, entry[0]);
+        const size_t oldOffset = getU16(entry + 2);
+        const size_t oldSize = getU16(entry + 4);
+        if (field == nullptr || static_cast<uint8_t>(field->type) != entry[1] ||
+            field->size != oldSize || oldOffset + oldSize > storedSize ||
+            field->offset + field->size > desc.size) {
+            continue;
+        }
+        memcpy(target + field->offset, image + oldOffset, oldSize);
+    }
+    return LoadResult::Migrated;
+}
+
+const char* ModuleConfigStore::resultName(LoadResult result) {
+    switch (result) {
+        case LoadResult::Missing: return "missing";
+        case LoadResult::Invalid: return "invalid";
+        case LoadResult::Exact: return "exact";
+        case LoadResult::Migrated: return "migrated";
+    }
+    return "?";
+}
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+ModuleConfigStore::LoadResult ModuleConfigStore::load(ILITEModule& module) {
+    const ConfigDescriptor* desc = module.getConfigDescriptor();
+    void* data = module.getConfigData();
+    if (desc == nullptr || data == nullptr) {
+        return LoadResult::Missing;
+    }
+
+    char key[16];
+    makeKey(module.getModuleId(), key, sizeof(key));
+    uint8_t blob[kMaxBlobSize];
+    size_t length = 0;
+    PreferencesManager& prefs = PreferencesManager::getInstance();
+    if (prefs.begin(kNamespace, true)) {
+        length = prefs.getBytes(key, blob, sizeof(blob));
+        prefs.end();
+    }
+
+    const LoadResult result = decode(*desc, blob, length, data);
+    if (result == LoadResult::Exact || result == LoadResult::Migrated) {
+        module.onConfigLoaded();
+    }
+    if (result != LoadResult::Missing) {
+        ILITE_LOG(MODULE, result == LoadResult::Invalid ? LOG_WARN : LOG_INFO,
+                  "[Config] %s: %s (v%u)", module.getModuleName(), resultName(result),
+                  static_cast<unsigned>(desc->version));
+    }
+    return result;
+}
+
+bool ModuleConfigStore::save(ILITEModule& module) {
+    const ConfigDescriptor* desc = module.getConfigDescriptor();
+    const void* data = module.getConfigData();
+    if (desc == nullptr || data == nullptr) {
+        return false;
+    }
+
+    uint8_t blob[kMaxBlobSize];
+    const size_t length = encode(*desc, data, blob, sizeof(blob));
+    if (length == 0) {
+        ILITE_LOG(MODULE, LOG_ERROR, "[Config] %s: config too large", module.getModuleName());
+        return false;
+    }
+
+    char key[16];
+    makeKey(module.getModuleId(), key, sizeof(key));
+    PreferencesManager& prefs = PreferencesManager::getInstance();
+    if (!prefs.begin(kNamespace, false)) {
+        return false;
+    }
+
+    // Identical blobs (an edit that was undone) are not rewritten
+    uint8_t stored[kMaxBlobSize];
+    bool ok = prefs.getBytes(key, stored, sizeof(stored)) == length &&
+              memcmp(stored, blob, length) == 0;
+    if (!ok) {
+        ok = prefs.putBytes(key, blob, length);
+        ILITE_LOG(MODULE, ok ? LOG_INFO : LOG_WARN, "[Config] %s: %s %u bytes",
+                  module.getModuleName(), ok ? "saved" : "failed to save",
+                  static_cast<unsigned>(length));
+    }
+    prefs.end();
+    return ok;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file ModuleHandoff.cpp
+ * @brief Reader pins, grace periods and queued module requests
+ */
+
+#include "ModuleHandoff.h"
+#include "LogChannels.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace {
+
+constexpr size_t kReaderCount = static_cast<size_t>(ModuleHandoff::Reader::Count);
+
+const char* const kReaderNames[kReaderCount] = {"comm", "display", "rx", "web"};
+
+}  // namespace
+
+std::atomic<ILITEModule*> ModuleHandoff::current_{nullptr};
+std::atomic<uint32_t> ModuleHandoff::epoch_{1};
+std::atomic<uint32_t> ModuleHandoff::pins_[kReaderCount] = {};
+std::atomic<ILITEModule*> ModuleHandoff::requested_{nullptr};
+std::atomic<bool> ModuleHandoff::requestPending_{false};
+uint32_t ModuleHandoff::syncs_ = 0;
+uint32_t ModuleHandoff::timeouts_ = 0;
+uint32_t ModuleHandoff::maxGraceUs_ = 0;
+
+// ============================================================================
+// Readers
+// ============================================================================
+
+ILITEModule* ModuleHandoff::pin(Reader reader) {
+    std::atomic<uint32_t>& slot = pins_[static_cast<size_t>(reader)];
+
+    // Re-announce until the epoch holds still: a writer that checked this
+    // slot before the store must see the pointer load below come after it
+    uint32_t epoch = epoch_.load();
+    for (;;) {
+        slot.store(epoch);
+        const uint32_t now = epoch_.load();
+        if (now == epoch) {
+            break;
+        }
+        epoch = now;
+    }
+    return current_.load();
+}
+
+void ModuleHandoff::unpin(Reader reader) {
+    pins_[static_cast<size_t>(reader)].store(0, std::memory_order_release);
+}
+
+ILITEModule* ModuleHandoff::current() {
+    return current_.load();
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+void ModuleHandoff::publish(ILITEModule* module) {
+    current_.store(module);
+}
+
+bool ModuleHandoff::synchronize(uint32_t timeoutMs) {
+    // Epochs skip 0, which marks a quiescent slot
+    uint32_t target = epoch_.fetch_add(1) + 1;
+    if (target == 0) {
+        target = epoch_.fetch_add(1) + 1;
+    }
+    syncs_++;
+
+    const int64_t startUs = esp_timer_get_time();
+    for (size_t i = 0; i < kReaderCount; ++i) {
+        for (;;) {
+            const uint32_t pinned = pins_[i].load();
+            // Quiescent, or pinned again after the pointer was published
+            if (pinned == 0 || static_cast<int32_t>(pinned - target) >= 0) {
+                break;
+            }
+            if (esp_timer_get_time() - startUs > static_cast<int64_t>(timeoutMs) * 1000) {
+                timeouts_++;
+                ILITE_LOG(MODULE, LOG_ERROR, "Module handoff: %s task stayed pinned for %lu ms",
+                          kReaderNames[i], static_cast<unsigned long>(timeoutMs));
+                return false;
+            }
+            vTaskDelay(1);
+        }
+    }
+
+    const uint32_t graceUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+    maxGraceUs_ = graceUs > maxGraceUs_ ? graceUs : maxGraceUs_;
+    return true;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+void ModuleHandoff::request(ILITEModule* module) {
+    requested_.store(module);
+    requestPending_.store(true);
+}
+
+bool ModuleHandoff::takeRequest(ILITEModule*& module) {
+    if (!requestPending_.exchange(false)) {
+        return false;
+    }
+    module = requested_.load();
+    return true;
+}
+
+void ModuleHandoff::dump(Print& out) {
+    out.printf("[Handoff] epoch=%lu syncs=%lu timeouts=%lu max grace=%lu us\n",
+               static_cast<unsigned long>(epoch_.load()), static_cast<unsigned long>(syncs_),
+               static_cast<unsigned long>(timeouts_), static_cast<unsigned long>(maxGraceUs_));
+    for (size_t i = 0; i < kReaderCount; ++i) {
+        const uint32_t pinned = pins_[i].load();
+        if (pinned == 0) {
+            out.printf("[Handoff]   %-8s quiescent\n", kReaderNames[i]);
+        } else {
+            out.printf("[Handoff]   %-8s pinned at %lu\n", kReaderNames[i],
+                       static_cast<unsigned long>(pinned));
+        }
+    }
+}
@@ -12,17 +12,28 @@
 
 #include <ILITEModule.h>
 #include <ModuleRegistry.h>
+#include <ModuleSelection.h>
+#include <ModuleArena.h>
 #include <DisplayCanvas.h>
 #include <ModuleMenu.h>
 #include <IconLibrary.h>
 #include <ScreenRegistry.h>
 #include <InputManager.h>
+#include <ControlShaping.h>
 #include <AudioRegistry.h>
 #include <UIComponents.h>
 #include <FrameworkEngine.h>
 #include <ILITE.h>
+#include <TelemetryStore.h>
+#include <SeriesBuffer.h>
+#include <Spectrum.h>
+#include <JobQueue.h>
+#include <CommandTable.h>
+#include <Wireframe3D.h>
 #include <espnow_discovery.h>
 #include <connection_log.h>
+#include <LogChannels.h>
+#include <PacketLayout.h>
 #include <strings.h>
 #include <cstring>
 #include <algorithm>
@@ -51,11 +62,16 @@ uint8_t targetAddress[6] = {0};
 // Include platform module headers
 #include <ControlBindingSystem.h>
 #include <thegill.h>
+#include <PoseRecorder.h>
 #include <drongaze.h>
+#include <telemetry.h>
+#include <PidAutoTune.h>
 #include <bulky.h>
 
 #include <cstring>
 
+#if ILITE_MODULE_THEGILL
+
 // ============================================================================
 // TheGill Module
 // ============================================================================
@@ -75,6 +91,53 @@ static const uint8_t thegill_logo_32x32[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
+// Drive setup kept across reboots (see ModuleConfig.h); never reuse an ID
+static const ConfigField kThegillConfigFields[] = {
+    ILITE_CONFIG_FIELD(1, ThegillConfig, profile, UINT8),
+    ILITE_CONFIG_FIELD(2, ThegillConfig, easing, UINT8),
+    ILITE_CONFIG_FIELD(3, ThegillConfig, easingRate, FLOAT),
+};
+
+static const ConfigDescriptor kThegillConfigDescriptor = {
+    1, sizeof(ThegillConfig), kThegillConfigFields,
+    sizeof(kThegillConfigFields) / sizeof(kThegillConfigFields[0])
+};
+
+// Packet layouts, derived from thegill.h at compile time (see PacketLayout.h)
+constexpr PacketDescriptor kThegillCommands[] = {
+    // Drive command doubles as the robot's failsafe heartbeat; its system
+    // bits (arm outputs, failsafe) ride with two previous copies once the
+    // robot unwraps them (ILITEConfig::redundantCommands)
+    {ILITE_PACKET(ThegillCommand, "TheGill Command", THEGILL_PACKET_MAGIC), false, 50, 2},  // keepaliveMs, redundancy
+    {ILITE_PACKET(PeripheralCommand, "Peripheral Command", THEGILL_PERIPHERAL_MAGIC)},
+    // Carries ArmOutputs / FailsafeEnable
+    {ILITE_PACKET(ConfigurationPacket, "Configuration Packet", THEGILL_CONFIG_MAGIC), false, 0, 2},  // redundancy
+    {ILITE_PACKET(ArmControlCommand, "Arm Command", ARM_COMMAND_MAGIC)},
+    {ILITE_PACKET(SettingsPacket, "Settings Packet", THEGILL_SETTINGS_MAGIC)},
+    {ILITE_PACKET(ArmTrajectoryPacket, "Arm Trajectory", ARM_TRAJECTORY_MAGIC)},
+};
+
+constexpr PacketDescriptor::Field kArmStateFields[] = {
+    ILITE_PACKET_FIELD(ArmStatePacket, magic),
+    ILITE_PACKET_FIELD_NAMED(ArmStatePacket, baseDegrees, "base"),
+    ILITE_PACKET_FIELD_NAMED(ArmStatePacket, extensionCentimeters, "extensionCm"),
+    ILITE_PACKET_ELEMENT(ArmStatePacket, servoDegrees, 0, "shoulder"),
+    ILITE_PACKET_ELEMENT(ArmStatePacket, servoDegrees, 1, "elbow"),
+    ILITE_PACKET_ELEMENT(ArmStatePacket, servoDegrees, 2, "pitch"),
+    ILITE_PACKET_ELEMENT(ArmStatePacket, servoDegrees, 3, "roll"),
+    ILITE_PACKET_ELEMENT(ArmStatePacket, servoDegrees, 4, "yaw"),
+    ILITE_PACKET_FIELD_NAMED(ArmStatePacket, servoEnabledMask, "enabledMask"),
+    ILITE_PACKET_FIELD_NAMED(ArmStatePacket, servoAttachedMask, "attachedMask"),
+    ILITE_PACKET_FIELD(ArmStatePacket, flags),
+};
+
+constexpr PacketDescriptor kThegillTelemetry[] = {
+    {ILITE_PACKET(StatusPacket, "Status Packet", THEGILL_STATUS_MAGIC)},
+    // Mostly unchanged floats between frames: the robot may send it delta-encoded
+    {ILITE_PACKET_WITH_FIELDS(ArmStatePacket, "Arm State Packet", THEGILL_ARM_STATE_MAGIC, kArmStateFields),
+     false, 0, 0, 0, 0, 0, true},      // deltaEncoded
+};
+
 class TheGillModule : public ILITEModule {
 public:
     const char* getModuleId() const override { return "com.ilite.thegill"; }
@@ -89,98 +152,46 @@ public:
     size_t getDetectionKeywordCount() const override { return 3; }
     const uint8_t* getLogo32x32() const override { return thegill_logo_32x32; }
 
-    size_t getCommandPacketTypeCount() const override { return 5; }
+    size_t getCommandPacketTypeCount() const override { return PacketLayout::countOf(kThegillCommands); }
     PacketDescriptor getCommandPacketDescriptor(size_t index) const override {
-        if (index == 0) {
-            return {"TheGill Command", THEGILL_PACKET_MAGIC, sizeof(ThegillCommand),
-                    sizeof(ThegillCommand), true, nullptr, 0};
-        }
-        if (index == 1) {
-            return {"Peripheral Command", THEGILL_PERIPHERAL_MAGIC, sizeof(PeripheralCommand),
-                    sizeof(PeripheralCommand), true, nullptr, 0};
-        }
-        if (index == 2) {
-            return {"Configuration Packet", THEGILL_CONFIG_MAGIC, sizeof(ConfigurationPacket),
-                    sizeof(ConfigurationPacket), true, nullptr, 0};
-        }
-        if (index == 3) {
-            return {"Arm Command", ARM_COMMAND_MAGIC, sizeof(ArmControlCommand),
-                    sizeof(ArmControlCommand), true, nullptr, 0};
-        }
-        if (index == 4) {
-            return {"Settings Packet", THEGILL_SETTINGS_MAGIC, sizeof(SettingsPacket),
-                    sizeof(SettingsPacket), true, nullptr, 0};
-        }
-        return {};
+        return PacketLayout::at(kThegillCommands, index);
     }
 
-    size_t getTelemetryPacketTypeCount() const override { return 2; }
+    size_t getTelemetryPacketTypeCount() const override { return PacketLayout::countOf(kThegillTelemetry); }
     PacketDescriptor getTelemetryPacketDescriptor(size_t index) const override {
-        if (index == 0) {
-            return {"Status Packet", THEGILL_STATUS_MAGIC, sizeof(StatusPacket),
-                    sizeof(StatusPacket), true, nullptr, 0};
-        }
-        if (index == 1) {
-            return {"Arm State Packet", THEGILL_ARM_STATE_MAGIC, sizeof(ArmStatePacket),
-                    sizeof(ArmStatePacket), true, nullptr, 0};
-        }
-        return {};
+        return PacketLayout::at(kThegillTelemetry, index);
     }
 
-    bool hasCommandProcessor() const override { return true; }
-    void handleCommand(const char* command) override {
-        if (command == nullptr) {
-            return;
-        }
-
-        String cmd = command;
-        cmd.trim();
-        cmd.toLowerCase();
-
-        if (cmd == "status") {
-            connectionLogAddf("[TheGill] Mode=%s, Mech Mode=%d",
-                              profileLabel(thegillConfig.profile),
-                              static_cast<int>(mechIaneMode));
-            return;
+    float getTelemetryRequestHz(size_t typeIndex) const override {
+        // The arm state animates the 3D view; elsewhere it only keeps the
+        // trajectory sync fresh
+        if (typeIndex == 1) {
+            return millis() - armViewDrawnMs_ < kViewVisibleMs ? 20.0f : 2.0f;
         }
+        return 0.0f;
+    }
 
-        if (cmd == "mode drive") {
-            mechIaneMode = MechIaneMode::DriveMode;
-            connectionLogAdd("[TheGill] Switched to Drive mode");
-            return;
-        }
+    const CommandTable* getCommandTable() const override { return &commands_; }
 
-        if (cmd == "mode arm" || cmd == "mode xyz") {
-            mechIaneMode = MechIaneMode::ArmXYZ;
-            connectionLogAdd("[TheGill] Switched to Arm XYZ mode");
-            return;
-        }
+    void onInit() override {
+        onThegillUnpaired();
+        markThegillConfigDirty();
+        Serial.println("[TheGillModule] Initialized");
+    }
 
-        if (cmd == "mode ori") {
-            mechIaneMode = MechIaneMode::ArmOrientation;
-            connectionLogAdd("[TheGill] Switched to Orientation mode");
-            return;
-        }
+    const ConfigDescriptor* getConfigDescriptor() const override { return &kThegillConfigDescriptor; }
+    void* getConfigData() override { return &thegillConfig; }
 
-        if (cmd == "precision on") {
-            setPrecisionMode(true);
-            connectionLogAdd("[TheGill] Precision mode ON");
-            return;
+    void onConfigLoaded() override {
+        // Stored enums may come from a build with more options
+        if (static_cast<uint8_t>(thegillConfig.profile) > static_cast<uint8_t>(GillDriveProfile::Differential)) {
+            thegillConfig.profile = GillDriveProfile::Tank;
         }
-
-        if (cmd == "precision off") {
-            setPrecisionMode(false);
-            connectionLogAdd("[TheGill] Precision mode OFF");
-            return;
+        if (static_cast<uint8_t>(thegillConfig.easing) > static_cast<uint8_t>(GillDriveEasing::EaseInOut)) {
+            thegillConfig.easing = GillDriveEasing::None;
         }
-
-        connectionLogAddf("[TheGill] Unknown command: %s", command);
-    }
-
-    void onInit() override {
-        onThegillUnpaired();
+        thegillConfig.easingRate = constrain(thegillConfig.easingRate, 0.0f, 1.0f);
         markThegillConfigDirty();
-        Serial.println("[TheGillModule] Initialized");
     }
 
     void onPair() override {
@@ -194,10 +205,8 @@ public:
     }
 
     void updateControl(const InputManager& inputs, float dt) override {
-        (void)inputs;
-        (void)dt;
         // Call the centralized control update function from thegill.cpp
-        updateThegillControl();
+        updateThegillControl(inputs, dt);
     }
 
     size_t prepareCommandPacket(size_t typeIndex, uint8_t* buffer, size_t bufferSize) override {
@@ -244,6 +253,15 @@ public:
                     }
                 }
                 break;
+            case 5:
+                if (bufferSize >= sizeof(ArmTrajectoryPacket)) {
+                    ArmTrajectoryPacket pkt{};
+                    if (acquireArmTrajectory(pkt)) {
+                        memcpy(buffer, &pkt, sizeof(ArmTrajectoryPacket));
+                        return sizeof(ArmTrajectoryPacket);
+                    }
+                }
+                break;
         }
         return 0;
     }
@@ -262,6 +280,7 @@ public:
 
     void drawDashboard(DisplayCanvas& canvas) override {
         const int16_t top = 14;  // Below top strip
+        const StatusPacket status = TelemetryView<StatusPacket>(0).get();
 
         if (mechIaneMode != MechIaneMode::DriveMode) {
             // Draw 3D arm visualization
@@ -278,13 +297,14 @@ public:
             solution.joints.elbowExtensionMm = armCommand.extensionMillimeters;
 
             draw3DArmVisualization(canvas, solution);
+            armViewDrawnMs_ = millis();
 
             canvas.setFont(DisplayCanvas::TINY);
             canvas.drawText(0, top, (mechIaneMode == MechIaneMode::ArmXYZ) ? "ARM XYZ" : "ARM ORI");
             canvas.drawTextF(66, top, "Cam:%s", cameraViewLabel(thegillRuntime.cameraView));
-            canvas.drawTextF(0, 54, "Cmd:%ums", thegillRuntime.commandAgeMs);
+            canvas.drawTextF(0, 54, "Cmd:%ums", status.commandAgeMs);
             canvas.drawTextF(0, 62, "Focus:%s", gripperFocusLabel(thegillRuntime.gripperTarget));
-            drawBatteryWidget(canvas, 74, 48);
+            drawBatteryWidget(canvas, 74, 48, status.batteryMillivolts);
             return;
         }
 
@@ -295,7 +315,7 @@ public:
         y += 6;
         canvas.drawTextF(0, y, "Speed:%3d%%",
                          static_cast<int>(roundf(thegillRuntime.driveSpeedScalar * 100.0f)));
-        canvas.drawTextF(70, y, "Pump:%3u", thegillRuntime.pumpDuty);
+        canvas.drawTextF(70, y, "Pump:%3u", status.pumpDuty);
         y += 6;
         canvas.drawTextF(0, y, "Ease:%s", easingLabel(thegillConfig.easing));
         canvas.drawTextF(70, y, "Rate:%3d%%",
@@ -307,24 +327,25 @@ public:
 
         const float leftTarget = 0.5f * (thegillRuntime.targetLeftFront + thegillRuntime.targetLeftRear);
         const float rightTarget = 0.5f * (thegillRuntime.targetRightFront + thegillRuntime.targetRightRear);
-        const float leftActual = 0.5f * (thegillRuntime.actualLeftFront + thegillRuntime.actualLeftRear);
-        const float rightActual = 0.5f * (thegillRuntime.actualRightFront + thegillRuntime.actualRightRear);
+        const float leftActual = 0.5f * (thegillWheelFraction(status.wheelSpeedMmPerSec[0]) +
+                                         thegillWheelFraction(status.wheelSpeedMmPerSec[1]));
+        const float rightActual = 0.5f * (thegillWheelFraction(status.wheelSpeedMmPerSec[2]) +
+                                          thegillWheelFraction(status.wheelSpeedMmPerSec[3]));
 
         drawMotorBar(canvas, 2, y, leftActual, leftTarget);
         drawMotorBarLabels(canvas, 2, y, leftTarget, leftActual);
         drawMotorBar(canvas, 2, y + 12, rightActual, rightTarget);
         drawMotorBarLabels(canvas, 2, y + 12, rightTarget, rightActual);
 
-        const bool linked = (thegillRuntime.statusFlags & StatusFlag::PairedLink) != 0;
         int tagY = top;
-        drawStatusTag(canvas, 100, tagY, "DRV", thegillRuntime.driveEnabled);
-        drawStatusTag(canvas, 100, tagY + 10, "ARM", thegillRuntime.armOutputsEnabled);
-        drawStatusTag(canvas, 100, tagY + 20, "TEL", thegillRuntime.telemetryEnabled);
-        drawStatusTag(canvas, 100, tagY + 30, "FS", thegillRuntime.failsafeEnabled);
-        drawStatusTag(canvas, 100, tagY + 40, "LNK", linked);
+        drawStatusTag(canvas, 100, tagY, "DRV", (status.flags & StatusFlag::DriveArmed) != 0);
+        drawStatusTag(canvas, 100, tagY + 10, "ARM", (status.flags & StatusFlag::ArmOutputsEnabled) != 0);
+        drawStatusTag(canvas, 100, tagY + 20, "TEL", (status.flags & StatusFlag::TelemetryOn) != 0);
+        drawStatusTag(canvas, 100, tagY + 30, "FS", (status.flags & StatusFlag::FailsafeArmed) != 0);
+        drawStatusTag(canvas, 100, tagY + 40, "LNK", (status.flags & StatusFlag::PairedLink) != 0);
 
-        canvas.drawTextF(0, 60, "Cmd:%ums", thegillRuntime.commandAgeMs);
-        drawBatteryWidget(canvas, 64, 52);
+        canvas.drawTextF(0, 60, "Cmd:%ums", status.commandAgeMs);
+        drawBatteryWidget(canvas, 64, 52, status.batteryMillivolts);
     }
 
     void buildModuleMenu(ModuleMenuBuilder& builder) override {
@@ -348,9 +369,10 @@ public:
             "thegill.rate.edit",
             "Easing Strength",
             []() { return thegillConfig.easingRate; },
-            [](float val) {
+            [this](float val) {
                 thegillConfig.easingRate = constrain(val, 0.0f, 1.0f);
                 markThegillConfigDirty();
+                markConfigDirty();
                 Serial.printf("[TheGill] Easing strength: %.2f\n", thegillConfig.easingRate);
             },
             0.0f,
@@ -368,6 +390,60 @@ public:
             ICON_SETTINGS,
             &root);
 
+        builder.addToggle(
+            "thegill.trajectory",
+            "Smooth Arm Stream",
+            []() { setArmTrajectoryStreaming(!isArmTrajectoryStreaming()); },
+            []() { return isArmTrajectoryStreaming(); },
+            ICON_TUNING,
+            &root);
+
+        ModuleMenuItem& posesMenu = builder.addSubmenu("thegill.poses", "Pose Recorder", ICON_PLAY, &root);
+
+        builder.addToggle(
+            "thegill.poses.record",
+            "Record",
+            []() {
+                PoseRecorder& poses = PoseRecorder::getInstance();
+                if (poses.getState() == PoseRecorder::State::Recording) {
+                    poses.stopRecording();
+                } else {
+                    poses.stopPlayback();
+                    poses.startRecording();
+                }
+            },
+            []() { return PoseRecorder::getInstance().getState() == PoseRecorder::State::Recording; },
+            ICON_STOP,
+            &posesMenu);
+
+        builder.addToggle(
+            "thegill.poses.play",
+            "Play",
+            []() {
+                PoseRecorder& poses = PoseRecorder::getInstance();
+                if (poses.getState() == PoseRecorder::State::Playing) {
+                    poses.stopPlayback();
+                } else {
+                    poses.stopRecording();
+                    poses.startPlayback(poses.getPlaybackSpeed());
+                }
+            },
+            []() { return PoseRecorder::getInstance().getState() == PoseRecorder::State::Playing; },
+            ICON_PLAY,
+            &posesMenu);
+
+        builder.addEditableFloat(
+            "thegill.poses.speed",
+            "Play Speed",
+            []() { return PoseRecorder::getInstance().getPlaybackSpeed(); },
+            [](float val) { PoseRecorder::getInstance().setPlaybackSpeed(val); },
+            PoseRecorder::kMinSpeed,
+            PoseRecorder::kMaxSpeed,
+            0.25f,
+            0.5f,
+            ICON_TUNING,
+            &posesMenu);
+
         // Camera view submenu (for arm visualization)
         ModuleMenuItem& cameraMenu = builder.addSubmenu("thegill.camera", "Camera View", ICON_HOME, &root);
 
@@ -494,11 +570,12 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[48];
+                const StatusPacket status = TelemetryView<StatusPacket>(0).get();
                 snprintf(buffer, sizeof(buffer), "LF:%d LR:%d RF:%d RR:%d",
-                         thegillStatusPacket.wheelSpeedMmPerSec[0],
-                         thegillStatusPacket.wheelSpeedMmPerSec[1],
-                         thegillStatusPacket.wheelSpeedMmPerSec[2],
-                         thegillStatusPacket.wheelSpeedMmPerSec[3]);
+                         status.wheelSpeedMmPerSec[0],
+                         status.wheelSpeedMmPerSec[1],
+                         status.wheelSpeedMmPerSec[2],
+                         status.wheelSpeedMmPerSec[3]);
                 return buffer;
             });
 
@@ -512,7 +589,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[32];
-                const uint16_t mv = thegillRuntime.batteryMillivolts;
+                const uint16_t mv = TelemetryView<StatusPacket>(0).get().batteryMillivolts;
                 const uint8_t pct = batteryPercent4S(mv);
                 snprintf(buffer, sizeof(buffer), "%umV (%u%%)", mv, pct);
                 return buffer;
@@ -528,10 +605,11 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[24];
+                const StatusPacket status = TelemetryView<StatusPacket>(0).get();
                 snprintf(buffer, sizeof(buffer), "%u/%u/%u",
-                         thegillRuntime.ledPwm[0],
-                         thegillRuntime.ledPwm[1],
-                         thegillRuntime.ledPwm[2]);
+                         status.ledPwm[0],
+                         status.ledPwm[1],
+                         status.ledPwm[2]);
                 return buffer;
             });
 
@@ -545,7 +623,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[16];
-                snprintf(buffer, sizeof(buffer), "%u", thegillRuntime.pumpDuty);
+                snprintf(buffer, sizeof(buffer), "%u", TelemetryView<StatusPacket>(0).get().pumpDuty);
                 return buffer;
             });
 
@@ -559,7 +637,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[16];
-                snprintf(buffer, sizeof(buffer), "0x%02X", thegillRuntime.userMask);
+                snprintf(buffer, sizeof(buffer), "0x%02X", TelemetryView<StatusPacket>(0).get().userMask);
                 return buffer;
             });
 
@@ -572,7 +650,7 @@ public:
             0,
             nullptr,
             []() -> const char* {
-                return formatStatusFlags(thegillRuntime.statusFlags);
+                return formatStatusFlags(TelemetryView<StatusPacket>(0).get().flags);
             });
 
         builder.addAction(
@@ -585,7 +663,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[16];
-                snprintf(buffer, sizeof(buffer), "%ums", thegillRuntime.commandAgeMs);
+                snprintf(buffer, sizeof(buffer), "%ums", TelemetryView<StatusPacket>(0).get().commandAgeMs);
                 return buffer;
             });
 
@@ -600,7 +678,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[16];
-                snprintf(buffer, sizeof(buffer), "%.1f deg", thegillArmStatePacket.baseDegrees);
+                snprintf(buffer, sizeof(buffer), "%.1f deg", TelemetryView<ArmStatePacket>(1).get().baseDegrees);
                 return buffer;
             });
 
@@ -614,7 +692,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[16];
-                snprintf(buffer, sizeof(buffer), "%.1fcm", thegillArmStatePacket.extensionCentimeters);
+                snprintf(buffer, sizeof(buffer), "%.1fcm", TelemetryView<ArmStatePacket>(1).get().extensionCentimeters);
                 return buffer;
             });
 
@@ -632,7 +710,7 @@ public:
                 nullptr,
                 [i]() -> const char* {
                     static char buffer[16];
-                    snprintf(buffer, sizeof(buffer), "%.1f deg", thegillArmStatePacket.servoDegrees[i]);
+                    snprintf(buffer, sizeof(buffer), "%.1f deg", TelemetryView<ArmStatePacket>(1).get().servoDegrees[i]);
                     return buffer;
                 });
         }
@@ -647,7 +725,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[12];
-                writeServoMask(thegillArmStatePacket.servoEnabledMask, buffer, sizeof(buffer));
+                writeServoMask(TelemetryView<ArmStatePacket>(1).get().servoEnabledMask, buffer, sizeof(buffer));
                 return buffer;
             });
 
@@ -661,7 +739,7 @@ public:
             nullptr,
             []() -> const char* {
                 static char buffer[12];
-                writeServoMask(thegillArmStatePacket.servoAttachedMask, buffer, sizeof(buffer));
+                writeServoMask(TelemetryView<ArmStatePacket>(1).get().servoAttachedMask, buffer, sizeof(buffer));
                 return buffer;
             });
 
@@ -674,7 +752,7 @@ public:
             12,
             nullptr,
             []() -> const char* {
-                return formatArmFlags(thegillArmStatePacket.flags);
+                return formatArmFlags(TelemetryView<ArmStatePacket>(1).get().flags);
             });
 
         ModuleMenuItem& configMenu = builder.addSubmenu("thegill.telemetry.config", "Configuration", ICON_SETTINGS, &telemetryMenu);
@@ -764,12 +842,6 @@ public:
     }
 
 private:
-    static constexpr float kDeadzone = 0.05f;
-
-    static float applyDeadzone(float value) {
-        return (fabsf(value) < kDeadzone) ? 0.0f : value;
-    }
-
     static int16_t toMotor(float value) {
         value = constrain(value, -1.0f, 1.0f);
         return static_cast<int16_t>(roundf(value * 32767.0f));
@@ -841,6 +913,7 @@ private:
         }
         thegillConfig.profile = profile;
         markThegillConfigDirty();
+        markConfigDirty();
         Serial.printf("[TheGillModule] Profile set to %d\n", static_cast<int>(profile));
     }
 
@@ -850,6 +923,7 @@ private:
         }
         thegillConfig.easing = easing;
         markThegillConfigDirty();
+        markConfigDirty();
         Serial.printf("[TheGillModule] Easing set to %d\n", static_cast<int>(easing));
     }
 
@@ -1050,8 +1124,7 @@ private:
         return static_cast<uint8_t>(((perCell - 3.0f) / 0.3f) * 10.0f);
     }
 
-    void drawBatteryWidget(DisplayCanvas& canvas, int16_t x, int16_t y) const {
-        const uint16_t millivolts = thegillRuntime.batteryMillivolts;
+    void drawBatteryWidget(DisplayCanvas& canvas, int16_t x, int16_t y, uint16_t millivolts) const {
         const uint8_t percent = batteryPercent4S(millivolts);
         const int width = 46;
         const int height = 9;
@@ -1114,8 +1187,47 @@ private:
         Serial.println("[TheGillModule] Deactivated");
     }
 
+private:
+    static constexpr uint32_t kViewVisibleMs = 500;     // Drawn this recently = on screen
+    uint32_t armViewDrawnMs_ = 0;                       // DisplayTask writes, CommTask reads
+
+    const CommandSpec commandSpecs_[7] = {
+        {"status", "", nullptr, [this](const CommandArgs&, Print&) {
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Mode=%s, Mech Mode=%d",
+                      profileLabel(thegillConfig.profile), static_cast<int>(mechIaneMode));
+        }},
+        {"mode drive", "", nullptr, [](const CommandArgs&, Print&) {
+            mechIaneMode = MechIaneMode::DriveMode;
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Switched to Drive mode");
+        }},
+        {"mode arm", "", nullptr, [](const CommandArgs&, Print&) {
+            mechIaneMode = MechIaneMode::ArmXYZ;
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Switched to Arm XYZ mode");
+        }},
+        {"mode xyz", "", nullptr, [](const CommandArgs&, Print&) {
+            mechIaneMode = MechIaneMode::ArmXYZ;
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Switched to Arm XYZ mode");
+        }},
+        {"mode ori", "", nullptr, [](const CommandArgs&, Print&) {
+            mechIaneMode = MechIaneMode::ArmOrientation;
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Switched to Orientation mode");
+        }},
+        {"precision on", "", nullptr, [](const CommandArgs&, Print&) {
+            setPrecisionMode(true);
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Precision mode ON");
+        }},
+        {"precision off", "", nullptr, [](const CommandArgs&, Print&) {
+            setPrecisionMode(false);
+            ILITE_LOG(MODULE, LOG_INFO, "[TheGill] Precision mode OFF");
+        }},
+    };
+    const CommandTable commands_{commandSpecs_, sizeof(commandSpecs_) / sizeof(commandSpecs_[0])};
 };
 
+#endif // ILITE_MODULE_THEGILL
+
+#if ILITE_MODULE_DRONGAZE
+
 // ============================================================================
 // DroneGaze Module
 // ============================================================================
@@ -1138,6 +1250,23 @@ static const uint8_t drongaze_logo_32x32[] = {
 // Forward declarations from drongaze.cpp
 extern void initDrongazeState();
 
+// Packet layouts, derived from drongaze.h at compile time (see PacketLayout.h)
+constexpr PacketDescriptor kDrongazeCommands[] = {
+    // Flight command: keep the link warm even when sticks are still, and
+    // carry two previous copies so an arm/disarm edge survives losses
+    // (with ILITEConfig::redundantCommands)
+    {ILITE_PACKET(DrongazeCommand, "Drongaze Command", DRONGAZE_PACKET_MAGIC), false, 50, 2},  // keepaliveMs, redundancy
+};
+
+constexpr PacketDescriptor kDrongazeTelemetry[] = {
+    {ILITE_PACKET(DrongazeTelemetry, "Drongaze Telemetry", DRONGAZE_PACKET_MAGIC)},
+    // Reply to a binary parameter frame (see DrongazeParamHeader): only
+    // arrives after a request, so silence is not staleness
+    {ILITE_PACKET_RANGE("Drongaze Param Ack", DRONGAZE_PARAM_ACK_MAGIC, sizeof(DrongazeParamHeader),
+                        sizeof(DrongazeParamHeader) + DRONGAZE_PARAM_MAX_ENTRIES * sizeof(DrongazeParamEntry)),
+     false, 0, 0, 0, 0, PacketDescriptor::kNeverStale},     // staleAfterMs
+};
+
 class DrongazeModule : public ILITEModule {
 public:
     const char* getModuleId() const override { return "com.ilite.drongaze"; }
@@ -1151,22 +1280,23 @@ public:
     size_t getDetectionKeywordCount() const override { return 4; }
     const uint8_t* getLogo32x32() const override { return drongaze_logo_32x32; }
 
-    size_t getCommandPacketTypeCount() const override { return 1; }
+    size_t getCommandPacketTypeCount() const override { return PacketLayout::countOf(kDrongazeCommands); }
     PacketDescriptor getCommandPacketDescriptor(size_t index) const override {
-        if (index == 0) {
-            return {"Drongaze Command", DRONGAZE_PACKET_MAGIC, sizeof(DrongazeCommand),
-                    sizeof(DrongazeCommand), true, nullptr, 0};
-        }
-        return {};
+        return PacketLayout::at(kDrongazeCommands, index);
     }
 
-    size_t getTelemetryPacketTypeCount() const override { return 1; }
+    size_t getTelemetryPacketTypeCount() const override { return PacketLayout::countOf(kDrongazeTelemetry); }
     PacketDescriptor getTelemetryPacketDescriptor(size_t index) const override {
-        if (index == 0) {
-            return {"Drongaze Telemetry", DRONGAZE_PACKET_MAGIC, sizeof(DrongazeTelemetry),
-                    sizeof(DrongazeTelemetry), true, nullptr, 0};
+        return PacketLayout::at(kDrongazeTelemetry, index);
+    }
+
+    float getTelemetryRequestHz(size_t typeIndex) const override {
+        // The PID trace and the auto-tuner want every sample; elsewhere the
+        // robot's rate will do
+        if (typeIndex == 0 && (millis() - traceDrawnMs_ < kTraceVisibleMs || autoTune_.isRunning())) {
+            return 100.0f;
         }
-        return {};
+        return 0.0f;
     }
 
     void onInit() override {
@@ -1177,6 +1307,8 @@ public:
         drongazeCommand.rollAngle = 0;
         drongazeCommand.yawAngle = 0;
         drongazeCommand.arm_motors = false;
+        rollAxis_.setCurve(&attitudeCurve_);
+        pitchAxis_.setCurve(&attitudeCurve_);
         Serial.println("[DrongazeModule] Initialized");
     }
 
@@ -1210,26 +1342,34 @@ public:
             memset(targetAddress, 0, sizeof(targetAddress));
         }
 
-        const float throttleNorm = clampValue((inputs.getJoystickA_Y() + 1.0f) * 0.5f, 0.0f, 1.0f);
+        // Stick gives 1000-2000 us, the pot adds up to 300 us of trim
+        const float throttleNorm = throttleAxis_.update((inputs.getJoystickA_Y() + 1.0f) * 0.5f, dt);
         float throttle = 1000.0f + throttleNorm * 1000.0f;
         const float trim = clampValue(inputs.getPotentiometer(), 0.0f, 1.0f) * 300.0f;
         throttle = clampValue(throttle + trim, 1000.0f, 2000.0f);
         drongazeCommand.throttle = static_cast<uint16_t>(throttle);
         drongazeState.currentSpeed = static_cast<int8_t>((throttle - 1000.0f) / 10.0f);
 
-        const float yawInput = applyDeadzone(inputs.getJoystickA_X());
-        drongazeState.yawCommand = clampValue<int16_t>(
-            drongazeState.yawCommand + static_cast<int16_t>(yawInput * 12.0f), -180, 180);
+        // Yaw stick is a rate; the heading is integrated here
+        if (drongazeState.yawCommand != static_cast<int16_t>(yawHeadingDeg_)) {
+            yawHeadingDeg_ = drongazeState.yawCommand;     // Reset elsewhere
+        }
+        yawHeadingDeg_ = clampValue(yawHeadingDeg_ + yawAxis_.update(inputs.getJoystickA_X(), dt) * dt,
+                                    -180.0f, 180.0f);
+        drongazeState.yawCommand = static_cast<int16_t>(yawHeadingDeg_);
         drongazeCommand.yawAngle = static_cast<int8_t>(drongazeState.yawCommand);
 
-        const float rollInput = applyDeadzone(inputs.getJoystickB_X());
-        const float pitchInput = applyDeadzone(inputs.getJoystickB_Y());
         const float axisScale = drongazeState.precisionMode ? 45.0f : 90.0f;
-
         drongazeCommand.rollAngle = static_cast<int8_t>(
-            clampValue(rollInput * axisScale, -90.0f, 90.0f));
+            clampValue(rollAxis_.updateScaled(inputs.getJoystickB_X(), axisScale, dt), -90.0f, 90.0f));
         drongazeCommand.pitchAngle = static_cast<int8_t>(
-            clampValue(pitchInput * axisScale, -90.0f, 90.0f));
+            clampValue(pitchAxis_.updateScaled(inputs.getJoystickB_Y(), axisScale, dt), -90.0f, 90.0f));
+
+        if (autoTune_.isRunning() || autoTuneAxis_ >= 0) {
+            serviceAutoTune(inputs);
+        }
+
+        serviceDrongazeParams(millis());
     }
 
     size_t prepareCommandPacket(size_t typeIndex, uint8_t* buffer, size_t bufferSize) override {
@@ -1240,79 +1380,90 @@ public:
         return 0;
     }
 
+    void onService(uint32_t nowMs) override {
+        if (spectrum_ == nullptr || pidTrace_[0] == nullptr) {
+            return;
+        }
+
+        // Telemetry rate over the last second gives the FFT its bin width
+        const uint32_t total = pidTrace_[0]->getTotalCount();
+        if (nowMs - spectrumRateMs_ >= kSpectrumRateWindowMs) {
+            if (spectrumRateMs_ != 0 && total >= spectrumRateTotal_) {
+                spectrumRateHz_ = (total - spectrumRateTotal_) * 1000.0f / (nowMs - spectrumRateMs_);
+            }
+            spectrumRateTotal_ = total;
+            spectrumRateMs_ = nowMs;
+        }
+
+        // Frames run as background jobs; one slice per call here only if
+        // the job table was full
+        if (JobQueue::isActive(spectrumJob_)) {
+            return;
+        }
+        if (spectrum_->isBusy()) {
+            if (spectrum_->step()) {
+                publishSpectrum(spectrumAxis_);
+            }
+            return;
+        }
+
+        // Next axis with half a frame of new samples (50 % overlap)
+        for (int i = 1; i <= 3; ++i) {
+            const int axis = (spectrumAxis_ + i) % 3;
+            const SeriesBuffer& trace = *pidTrace_[axis];
+            const uint32_t count = trace.getTotalCount();
+            if (spectrumRateHz_ <= 0.0f || trace.size() < kSpectrumPoints ||
+                count - spectrumTotal_[axis] < kSpectrumPoints / 2) {
+                continue;
+            }
+            trace.copyRecent(kSpectrumPoints, spectrumFrame_);
+            spectrumTotal_[axis] = count;
+            spectrumAxis_ = axis;
+            spectrum_->begin(spectrumFrame_, spectrumRateHz_);
+            spectrumJob_ = JobQueue::submit("fft", JobPriority::Normal,
+                                            [this]() { return spectrum_->step(); },
+                                            JobQueue::kDefaultSliceUs,
+                                            [this]() { publishSpectrum(spectrumAxis_); });
+            return;
+        }
+    }
+
     void handleTelemetry(size_t typeIndex, const uint8_t* data, size_t length) override {
+        // The full packet lives in the framework's TelemetryStore slot; only
+        // pull out the stabilization mask the control side needs.
         if (typeIndex == 0 && length >= sizeof(DrongazeTelemetry)) {
-            memcpy(&drongazeTelemetry, data, sizeof(DrongazeTelemetry));
-            drongazeState.stabilizationMask = drongazeTelemetry.stabilizationMask;
-            drongazeState.stabilizationGlobal =
-                (drongazeTelemetry.stabilizationMask & DRONGAZE_STABILIZATION_GLOBAL_BIT) != 0;
+            uint8_t mask;
+            memcpy(&mask, data + offsetof(DrongazeTelemetry, stabilizationMask), sizeof(mask));
+            drongazeState.stabilizationMask = mask;
+            drongazeState.stabilizationGlobal = (mask & DRONGAZE_STABILIZATION_GLOBAL_BIT) != 0;
+            recordPidTrace(data);
+        } else if (typeIndex == 1) {
+            handleDrongazeParamAck(data, length);
         }
     }
 
     void drawDashboard(DisplayCanvas& canvas) override {
         // 3D orientation cube visualization matching original ILITE
-        const float xSize = 20.0f;
-        const float ySize = 10.0f;
-        const float zSize = 5.0f;
+        static const WireVertex kCube[8] = {
+            {-20, -10, -5}, { 20, -10, -5}, { 20, 10, -5}, {-20, 10, -5},
+            {-20, -10,  5}, { 20, -10,  5}, { 20, 10,  5}, {-20, 10,  5}
+        };
         const int16_t top = 14;
         const int cx = 64;  // Screen width/2
         const int cy = top + (64 - top) / 2;  // Center Y in available space
 
-        // 3D cube vertices
-        struct Vec3 { float x, y, z; };
-        const Vec3 verts[8] = {
-            {-xSize,-ySize,-zSize}, { xSize,-ySize,-zSize}, { xSize, ySize,-zSize}, {-xSize, ySize,-zSize},
-            {-xSize,-ySize, zSize}, { xSize,-ySize, zSize}, { xSize, ySize, zSize}, {-xSize, ySize, zSize}
-        };
+        // One consistent snapshot of the latest telemetry for this frame
+        const DrongazeTelemetry telemetry = TelemetryView<DrongazeTelemetry>(0).get();
 
-        int px[8];
-        int py[8];
-
-        // Convert telemetry angles to radians
-        float roll  = drongazeTelemetry.roll * DEG_TO_RAD;
-        float pitch = -drongazeTelemetry.pitch * DEG_TO_RAD;
-        float yaw   = -drongazeTelemetry.yaw * DEG_TO_RAD + PI;
-
-        // Rotate each vertex
-        for (int i = 0; i < 8; i++) {
-            float x = verts[i].x;
-            float y = verts[i].y;
-            float z = verts[i].z;
-
-            // Rotate around X (roll)
-            float y1 = y * cos(roll) - z * sin(roll);
-            float z1 = y * sin(roll) + z * cos(roll);
-            y = y1; z = z1;
-
-            // Rotate around Y (pitch)
-            float x1 = x * cos(pitch) + z * sin(pitch);
-            float z2 = -x * sin(pitch) + z * cos(pitch);
-            x = x1; z = z2;
-
-            // Rotate around Z (yaw)
-            float x2 = x * cos(yaw) - y * sin(yaw);
-            float y2 = x * sin(yaw) + y * cos(yaw);
-            x = x2; y = y2;
-
-            // Project to 2D
-            px[i] = cx + static_cast<int>(x);
-            py[i] = cy - static_cast<int>(y);
-        }
-
-        // Draw cube edges
-        const uint8_t edges[12][2] = {
-            {0,1},{1,2},{2,3},{3,0},  // Back face
-            {4,5},{5,6},{6,7},{7,4},  // Front face
-            {0,4},{1,5},{2,6},{3,7}   // Connecting edges
-        };
-
-        for (int i = 0; i < 12; i++) {
-            canvas.drawLine(px[edges[i][0]], py[edges[i][0]],
-                          px[edges[i][1]], py[edges[i][1]]);
-        }
+        // One rotation per frame; the vertices are transformed in Q15
+        const WireRotation rotation = WireRotation::fromEuler(telemetry.roll * DEG_TO_RAD,
+                                                              -telemetry.pitch * DEG_TO_RAD,
+                                                              -telemetry.yaw * DEG_TO_RAD + PI);
+        const WireMesh cube{kCube, 8, Wireframe3D::kBoxEdges, Wireframe3D::kBoxEdgeCount};
+        Wireframe3D::drawMesh(canvas, cube, rotation, cx, cy);
 
         // Draw vertical acceleration arrow
-        int arrowLen = map(static_cast<int>(drongazeTelemetry.verticalAcc * 100), -1000, 1000, -20, 20);
+        int arrowLen = map(static_cast<int>(telemetry.verticalAcc * 100), -1000, 1000, -20, 20);
         arrowLen = constrain(arrowLen, -25, 25);
         canvas.drawLine(cx, cy, cx, cy - arrowLen);
 
@@ -1335,6 +1486,26 @@ public:
         canvas.drawTextF(0, textY, "R:%d", drongazeCommand.rollAngle);
         textY += 8;
         canvas.drawTextF(0, textY, "Y:%d", drongazeCommand.yawAngle);
+
+        // Strongest oscillation across the axes (right side)
+        SpectrumResult strongest;
+        int strongestAxis = -1;
+        for (int axis = 0; axis < 3; ++axis) {
+            const SpectrumResult result = getSpectrum(axis);
+            if (result.amplitudeDeg >= kSpectrumFloorDeg &&
+                (strongestAxis < 0 || result.amplitudeDeg > strongest.amplitudeDeg)) {
+                strongest = result;
+                strongestAxis = axis;
+            }
+        }
+        static const char kAxisLetters[3] = {'P', 'R', 'Y'};
+        canvas.drawText(98, top + 6, "Osc");
+        if (strongestAxis >= 0) {
+            canvas.drawTextF(98, top + 14, "%c%.1f", kAxisLetters[strongestAxis], strongest.dominantHz);
+            canvas.drawText(98, top + 22, "Hz");
+        } else {
+            canvas.drawText(98, top + 14, "--");
+        }
     }
 
     void buildModuleMenu(ModuleMenuBuilder& builder) override {
@@ -1375,6 +1546,38 @@ public:
                 return yawStr;
             });
 
+        // Auto-tune steps one axis and streams the proposed gains; any stick
+        // input, disarm or lost telemetry restores the gains it started from
+        ModuleMenuItem& tuneMenu = builder.addSubmenu("drongaze.autotune", "Auto-Tune", ICON_TUNING, &root);
+        static const char* kTuneIds[3] = {"drongaze.autotune.pitch", "drongaze.autotune.roll",
+                                          "drongaze.autotune.yaw"};
+        static const char* kTuneLabels[3] = {"Tune Pitch", "Tune Roll", "Tune Yaw"};
+        for (int axis = 0; axis < 3; ++axis) {
+            builder.addAction(
+                kTuneIds[axis],
+                kTuneLabels[axis],
+                [this, axis]() { startAutoTune(axis); },
+                ICON_PLAY,
+                &tuneMenu,
+                axis,
+                [this]() { return !autoTune_.isRunning(); });
+        }
+
+        builder.addAction(
+            "drongaze.autotune.abort",
+            "Abort Tune",
+            [this]() { autoTune_.abort(); },
+            ICON_STOP,
+            &tuneMenu,
+            3,
+            [this]() { return autoTune_.isRunning(); },
+            [this]() {
+                static char status[16];
+                snprintf(status, sizeof(status), "%s %u", PidAutoTune::stateName(autoTune_.getState()),
+                         static_cast<unsigned>(autoTune_.getStepCount()));
+                return status;
+            });
+
         builder.addAction(
             "drongaze.pid.refresh",
             "Request PID Gains",
@@ -1405,16 +1608,53 @@ public:
             []() { toggleDrongazeAxisStabilization(2); },
             ICON_TUNING,
             &stabMenu);
+
+        // Gains stream to the drone while the encoder turns; '*' marks a
+        // value the drone has not confirmed yet
+        ModuleMenuItem& pidMenu = builder.addSubmenu("drongaze.pid", "PID Gains", ICON_TUNING, &root);
+        static const char* kAxisLabels[3] = {"Pitch", "Roll", "Yaw"};
+        static const char* kTermLabels[3] = {"Kp", "Ki", "Kd"};
+        static const float kGainMax[3] = {20.0f, 5.0f, 5.0f};
+        for (int param = 0; param < 9; ++param) {
+            const int axis = param / 3;
+            const int term = param % 3;
+            char id[20];
+            char label[16];
+            snprintf(id, sizeof(id), "drongaze.pid.%d", param);
+            snprintf(label, sizeof(label), "%s %s", kAxisLabels[axis], kTermLabels[term]);
+
+            ModuleMenuItem& item = builder.addEditableFloat(
+                id,
+                label,
+                [axis, term]() {
+                    const DrongazePidGains& gains = drongazeState.pidGains[axis];
+                    return term == 0 ? gains.kp : term == 1 ? gains.ki : gains.kd;
+                },
+                [axis, term](float value) { setDrongazePidGain(axis, term, value); },
+                0.0f,
+                kGainMax[term],
+                0.01f,
+                0.1f,
+                nullptr,
+                &pidMenu,
+                param);
+            item.liveEdit = true;
+            item.isPending = [param]() {
+                return isDrongazeParamPending(static_cast<DrongazeParam>(param));
+            };
+        }
     }
 
     // ========================================================================
     // Custom Screens - PID Tuner
     // ========================================================================
 
-    size_t getCustomScreenCount() const override { return 1; }
+    size_t getCustomScreenCount() const override { return 3; }
 
     const char* getCustomScreenName(size_t index) const override {
         if (index == 0) return "PID Tuner";
+        if (index == 1) return "PID Trace";
+        if (index == 2) return "Spectrum";
         return "";
     }
 
@@ -1422,6 +1662,10 @@ public:
         if (index == 0) {
             // Cast away const since renderPidTuner modifies state
             const_cast<DrongazeModule*>(this)->renderPidTuner(canvas);
+        } else if (index == 1) {
+            renderPidTrace(canvas);
+        } else if (index == 2) {
+            renderSpectrum(canvas);
         }
     }
 
@@ -1435,10 +1679,15 @@ public:
 
 private:
     static constexpr float kDeadzone = 0.05f;
+    static constexpr float kYawRateDegPerSec = 600.0f;     // 12 deg per tick at 50 Hz
 
-    static float applyDeadzone(float value) {
-        return (fabsf(value) < kDeadzone) ? 0.0f : value;
-    }
+    // Throttle may cross its range in 0.25 s; attitude sticks get a soft center
+    ControlShaping::Axis throttleAxis_{ControlShaping::AxisShape(0.0f, 0.0f, 1.0f, 4.0f)};
+    ControlShaping::Axis yawAxis_{ControlShaping::AxisShape(kDeadzone, 0.4f, kYawRateDegPerSec)};
+    ControlShaping::CurveTable attitudeCurve_{ControlShaping::Curve::Expo, 0.3f};  // Roll and pitch
+    ControlShaping::Axis rollAxis_{ControlShaping::AxisShape(kDeadzone)};
+    ControlShaping::Axis pitchAxis_{ControlShaping::AxisShape(kDeadzone)};
+    float yawHeadingDeg_ = 0.0f;
 
     void toggleArm() {
         drongazeCommand.arm_motors = !drongazeCommand.arm_motors;
@@ -1464,6 +1713,282 @@ private:
 
     PidTunerState pidTuner;
 
+    // ========================================================================
+    // PID Trace Screen
+    // ========================================================================
+
+    // Per-axis tracking error (setpoint - actual) in centidegrees.
+    // 2^10 samples = ~10 s at 100 Hz telemetry.
+    static constexpr uint8_t kPidTraceLog2 = 10;
+    static constexpr uint32_t kTraceVisibleMs = 500;    // Drawn this recently = on screen
+    SeriesBuffer* pidTrace_[3] = {nullptr, nullptr, nullptr};
+    mutable uint32_t traceDrawnMs_ = 0;                 // DisplayTask writes, CommTask reads
+
+    // ========================================================================
+    // Error Spectrum (ServiceTask computes, DisplayTask draws)
+    // ========================================================================
+
+    static constexpr size_t kSpectrumPoints = 256;          // 2.56 s at 100 Hz
+    static constexpr size_t kSpectrumBins = kSpectrumPoints / 2;
+    static constexpr uint32_t kSpectrumRateWindowMs = 1000;
+    static constexpr float kSpectrumFloorDeg = 0.1f;        // Weaker peaks are noise
+
+    struct SpectrumResult {
+        float dominantHz = 0.0f;
+        float amplitudeDeg = 0.0f;
+        float sampleHz = 0.0f;
+        uint8_t level[kSpectrumBins] = {};                  // Scaled to the peak bin
+    };
+
+    Spectrum* spectrum_ = nullptr;
+    int16_t* spectrumFrame_ = nullptr;
+    JobId spectrumJob_ = 0;                                 // Frame in progress on the job worker
+    int spectrumAxis_ = 0;                                  // Axis of the frame in progress
+    uint32_t spectrumTotal_[3] = {0, 0, 0};                 // Trace count at each axis's last frame
+    uint32_t spectrumRateTotal_ = 0;
+    uint32_t spectrumRateMs_ = 0;
+    float spectrumRateHz_ = 0.0f;
+    SpectrumResult spectrumResult_[3];
+    mutable portMUX_TYPE spectrumLock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    void publishSpectrum(int axis) {
+        SpectrumResult result;
+        const float* magnitude = spectrum_->getMagnitudes();
+        const float peak = spectrum_->getDominantMagnitude();
+        for (size_t k = 1; k < kSpectrumBins && peak > 0.0f; ++k) {
+            result.level[k] = static_cast<uint8_t>(clampValue(magnitude[k] / peak * 255.0f, 0.0f, 255.0f));
+        }
+        result.dominantHz = spectrum_->getDominantHz();
+        result.amplitudeDeg = peak / 100.0f;                // Trace holds centidegrees
+        result.sampleHz = spectrumRateHz_;
+
+        portENTER_CRITICAL(&spectrumLock_);
+        spectrumResult_[axis] = result;
+        portEXIT_CRITICAL(&spectrumLock_);
+    }
+
+    SpectrumResult getSpectrum(int axis) const {
+        portENTER_CRITICAL(&spectrumLock_);
+        const SpectrumResult result = spectrumResult_[axis];
+        portEXIT_CRITICAL(&spectrumLock_);
+        return result;
+    }
+
+    void renderSpectrum(DisplayCanvas& canvas) const {
+        traceDrawnMs_ = millis();                           // Ask for the full telemetry rate too
+        const int16_t top = 14;
+        const int axis = pidTuner.selectedAxis;
+        const char* axisNames[3] = {"Pitch", "Roll", "Yaw"};
+        const SpectrumResult result = getSpectrum(axis);
+
+        canvas.setFont(DisplayCanvas::SMALL);
+        canvas.drawTextF(0, top + 6, "%s", axisNames[axis]);
+        if (result.sampleHz <= 0.0f) {
+            canvas.drawTextCentered(40, "No telemetry");
+            return;
+        }
+        if (result.amplitudeDeg >= kSpectrumFloorDeg) {
+            canvas.drawTextF(34, top + 6, "%.1fHz %.2f", result.dominantHz, result.amplitudeDeg);
+        } else {
+            canvas.drawText(34, top + 6, "quiet");
+        }
+
+        // One column per bin, DC to Nyquist left to right
+        const int16_t plotTop = top + 10;
+        const int16_t plotBottom = 63;
+        const int16_t plotHeight = plotBottom - plotTop;
+        canvas.drawHLine(0, plotBottom, 128);
+        for (size_t k = 1; k < kSpectrumBins; ++k) {
+            const int16_t height = static_cast<int16_t>(result.level[k] * plotHeight / 255);
+            if (height > 0) {
+                canvas.drawVLine(static_cast<int16_t>(k), plotBottom - height, height);
+            }
+        }
+        char nyquist[12];
+        snprintf(nyquist, sizeof(nyquist), "%.0fHz", result.sampleHz * 0.5f);
+        canvas.drawTextRight(127, top + 16, nyquist);
+    }
+
+    // ========================================================================
+    // PID Auto-Tune (CommTask)
+    // ========================================================================
+
+    static constexpr float kAutoTuneStickAbort = 0.2f;     // Stick deflection that hands back control
+    static constexpr uint32_t kAutoTuneStaleMs = 250;      // Telemetry gap that aborts
+    PidAutoTune autoTune_;
+    int autoTuneAxis_ = -1;                             // -1 = no tune to finish
+    float autoTuneBaseDeg_ = 0.0f;
+    uint32_t autoTuneSequence_ = 0;
+
+    void startAutoTune(int axis) {
+        if (autoTune_.isRunning() || axis < 0 || axis >= DRONGAZE_PID_AXIS_COUNT) {
+            return;
+        }
+        if (!drongazeCommand.arm_motors || !drongazeState.pidGainsValid[axis]) {
+            ILITE_LOG(MODULE, LOG_WARN, "[DroneGaze] Auto-tune needs armed motors and gains read back");
+            return;
+        }
+        const int8_t angles[3] = {drongazeCommand.pitchAngle, drongazeCommand.rollAngle,
+                                  drongazeCommand.yawAngle};
+        const DrongazePidGains& gains = drongazeState.pidGains[axis];
+        autoTuneAxis_ = axis;
+        autoTuneBaseDeg_ = angles[axis];
+        autoTuneSequence_ = TelemetryView<DrongazeTelemetry>(0).getSequence();
+        autoTune_.start({gains.kp, gains.ki, gains.kd}, autoTuneBaseDeg_, millis());
+        ILITE_LOG(MODULE, LOG_INFO, "[DroneGaze] Auto-tune axis %d from Kp=%.2f Ki=%.2f Kd=%.2f",
+                  axis, gains.kp, gains.ki, gains.kd);
+    }
+
+    void serviceAutoTune(const InputManager& inputs) {
+        const uint32_t now = millis();
+        const int axis = autoTuneAxis_;
+
+        if (autoTune_.isRunning()) {
+            const TelemetryView<DrongazeTelemetry> view(0);
+            const bool sticks = fabsf(inputs.getJoystickB_X()) > kAutoTuneStickAbort ||
+                                fabsf(inputs.getJoystickB_Y()) > kAutoTuneStickAbort ||
+                                fabsf(inputs.getJoystickA_X()) > kAutoTuneStickAbort;
+            if (!drongazeCommand.arm_motors || sticks || view.getAgeMs() > kAutoTuneStaleMs) {
+                autoTune_.abort();
+            } else {
+                const uint32_t sequence = view.getSequence();
+                if (sequence != autoTuneSequence_) {
+                    autoTuneSequence_ = sequence;
+                    const DrongazeTelemetry t = view.get();
+                    const float actual[3] = {t.pitch, t.roll, t.yaw};
+                    autoTune_.addSample(now, actual[axis]);
+                } else {
+                    autoTune_.update(now);
+                }
+            }
+        }
+
+        PidAutoTune::Gains gains;
+        if (autoTune_.takeProposal(gains)) {
+            setDrongazePidGain(axis, 0, gains.kp);
+            setDrongazePidGain(axis, 1, gains.ki);
+            setDrongazePidGain(axis, 2, gains.kd);
+        }
+
+        const DrongazeParam first = static_cast<DrongazeParam>(axis * 3);
+        const bool pending = isDrongazeParamPending(first) ||
+                             isDrongazeParamPending(static_cast<DrongazeParam>(axis * 3 + 1)) ||
+                             isDrongazeParamPending(static_cast<DrongazeParam>(axis * 3 + 2));
+        if (autoTune_.getState() == PidAutoTune::State::Apply && !pending) {
+            autoTune_.gainsApplied(now);
+        }
+
+        if (autoTune_.isRunning()) {
+            // The tuned axis follows the tuner instead of the (centered) stick
+            const int8_t setpoint = static_cast<int8_t>(clampValue(autoTune_.getSetpoint(), -90.0f, 90.0f));
+            if (axis == 0) {
+                drongazeCommand.pitchAngle = setpoint;
+            } else if (axis == 1) {
+                drongazeCommand.rollAngle = setpoint;
+            } else {
+                drongazeCommand.yawAngle = setpoint;
+            }
+            return;
+        }
+
+        const PidAutoTune::Outcome outcome = autoTune_.getOutcome();
+        if (outcome == PidAutoTune::Outcome::Converged) {
+            gains = autoTune_.getGains();
+            ILITE_LOG(MODULE, LOG_INFO, "[DroneGaze] Auto-tune axis %d done in %u steps: Kp=%.2f Ki=%.2f Kd=%.2f",
+                      axis, static_cast<unsigned>(autoTune_.getStepCount()), gains.kp, gains.ki, gains.kd);
+        } else {
+            ILITE_LOG(MODULE, LOG_WARN, "[DroneGaze] Auto-tune axis %d stopped (%s), gains restored",
+                      axis, PidAutoTune::outcomeName(outcome));
+        }
+        autoTuneAxis_ = -1;
+    }
+
+    // Traces and the spectrum live in the ModuleArena state block, which is
+    // reserved before every activation and freed on the next switch. All
+    // users check for null, so a failed reservation only empties the screens.
+    void createWorkingState() {
+        bool complete = true;
+        for (int axis = 0; axis < 3; ++axis) {
+            void* storage = ModuleArena::allocateState(
+                SeriesBuffer::storageValues(kPidTraceLog2) * sizeof(int16_t));
+            pidTrace_[axis] = storage != nullptr
+                ? ModuleArena::createState<SeriesBuffer>(kPidTraceLog2, static_cast<int16_t*>(storage))
+                : nullptr;
+            complete = complete && pidTrace_[axis] != nullptr;
+            spectrumTotal_[axis] = 0;
+        }
+        spectrumFrame_ = static_cast<int16_t*>(ModuleArena::allocateState(kSpectrumPoints * sizeof(int16_t)));
+        spectrum_ = ModuleArena::createState<Spectrum>(kSpectrumPoints);
+        spectrumRateTotal_ = 0;
+        spectrumRateMs_ = 0;
+        spectrumRateHz_ = 0.0f;
+
+        if (!complete || spectrumFrame_ == nullptr || spectrum_ == nullptr) {
+            releaseWorkingState();
+        }
+    }
+
+    void releaseWorkingState() {
+        // Returns once the worker is out of spectrum_
+        JobQueue::cancel(spectrumJob_);
+        spectrumJob_ = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            pidTrace_[axis] = nullptr;
+        }
+        spectrum_ = nullptr;
+        spectrumFrame_ = nullptr;
+    }
+
+    void recordPidTrace(const uint8_t* data) {
+        if (pidTrace_[0] == nullptr) {
+            return;
+        }
+        DrongazeTelemetry t;
+        memcpy(&t, data, sizeof(t));
+        const float error[3] = {
+            t.pitchAngle - t.pitch,
+            t.rollAngle - t.roll,
+            t.yawAngle - t.yaw
+        };
+        for (int axis = 0; axis < 3; ++axis) {
+            float centi = clampValue(error[axis] * 100.0f, -32768.0f, 32767.0f);
+            pidTrace_[axis]->push(static_cast<int16_t>(centi));
+        }
+    }
+
+    void renderPidTrace(DisplayCanvas& canvas) const {
+        traceDrawnMs_ = millis();
+        const int16_t top = 14;
+        const bool tuning = autoTune_.isRunning();
+        const int axis = tuning ? autoTuneAxis_ : pidTuner.selectedAxis;
+        const char* axisNames[3] = {"Pitch", "Roll", "Yaw"};
+
+        canvas.setFont(DisplayCanvas::SMALL);
+        canvas.drawTextF(0, top + 6, "%s err", axisNames[axis]);
+        if (tuning) {
+            canvas.drawTextF(96, top + 6, "AT%u", static_cast<unsigned>(autoTune_.getStepCount()));
+        }
+
+        const SeriesBuffer* trace = pidTrace_[axis];
+        int16_t lo = 0;
+        int16_t hi = 0;
+        if (trace == nullptr || !trace->getRange(lo, hi)) {
+            canvas.drawTextCentered(40, "No telemetry");
+            return;
+        }
+        canvas.drawTextF(64, top + 6, "%+.1f", trace->newest() / 100.0f);
+
+        // Symmetric auto-range so zero error sits on the centre line
+        int32_t bound = std::max(abs(static_cast<int32_t>(lo)), abs(static_cast<int32_t>(hi)));
+        bound = clampValue<int32_t>(bound, 100, 32767);  // At least +/-1 degree
+
+        const int16_t plotTop = top + 10;
+        const int16_t plotHeight = 64 - plotTop;
+        canvas.drawHLine(0, plotTop + plotHeight / 2, 128);
+        UIComponents::drawSeries(canvas, 0, plotTop, 128, plotHeight, *trace, 0,
+                                 static_cast<int16_t>(-bound), static_cast<int16_t>(bound));
+    }
+
     void renderPidTuner(DisplayCanvas& canvas) {
         const int16_t top = 14;
         canvas.setFont(DisplayCanvas::SMALL);
@@ -1500,6 +2025,10 @@ private:
         canvas.drawText(0, y, "Value:");
         if (pidTuner.cursorPos == 2) canvas.drawText(30, y, ">");
         canvas.drawTextF(36, y, "%.2f", *gainPtr);
+        const int param = pidTuner.selectedAxis * 3 + pidTuner.selectedParam;
+        if (isDrongazeParamPending(static_cast<DrongazeParam>(param))) {
+            canvas.drawText(72, y, "*");    // Not yet confirmed by the drone
+        }
         y += 10;
 
         // Step size toggle
@@ -1538,6 +2067,8 @@ private:
             }
 
             *gainPtr = constrain(*gainPtr + adjustment, 0.0f, 10.0f);
+            // Streams to the drone, coalesced with the following detents
+            setDrongazePidGain(pidTuner.selectedAxis, pidTuner.selectedParam, *gainPtr);
             AudioRegistry::play("menu_select");
         } else {
             // Navigate to/from send button
@@ -1566,7 +2097,16 @@ private:
     // Framework v2.0 Support - Button Events & Encoder Functions
     // ============================================================================
 
+    size_t getStateSize() const override {
+        return 3 * (ModuleArena::stateBytes(sizeof(SeriesBuffer)) +
+                    ModuleArena::stateBytes(SeriesBuffer::storageValues(kPidTraceLog2) * sizeof(int16_t))) +
+               ModuleArena::stateBytes(sizeof(Spectrum)) +
+               ModuleArena::stateBytes(kSpectrumPoints * sizeof(int16_t));
+    }
+
     void onActivate() override {
+        createWorkingState();
+
         // Register encoder functions when module activates
         FrameworkEngine& fw = FrameworkEngine::getInstance();
 
@@ -1601,6 +2141,8 @@ private:
         FrameworkEngine& fw = FrameworkEngine::getInstance();
         fw.clearEncoderFunction(0);
         fw.clearEncoderFunction(1);
+        releaseWorkingState();
+        releasePidHistories();
         Serial.println("[DrongazeModule] Deactivated");
     }
 
@@ -1635,6 +2177,11 @@ private:
         }
     }
 };
+
+#endif // ILITE_MODULE_DRONGAZE
+
+#if ILITE_MODULE_BULKY
+
 // ============================================================================
 // Bulky Module
 // ============================================================================
@@ -1658,6 +2205,35 @@ static const uint8_t bulky_logo_32x32[] = {
 extern void initBulkyState();
 extern void handleBulkyTelemetry(const uint8_t* data, size_t length);
 
+// Packet layouts, derived from bulky.h at compile time (see PacketLayout.h)
+constexpr PacketDescriptor::Field kBulkyV1Fields[] = {
+    ILITE_PACKET_FIELD(BulkyCommand, replyIndex),
+    ILITE_PACKET_FIELD(BulkyCommand, speed),
+    ILITE_PACKET_FIELD_NAMED(BulkyCommand, motionState, "motion"),
+    ILITE_PACKET_FIELD_NAMED(BulkyCommand, buttonStates, "buttons"),
+};
+
+constexpr PacketDescriptor::Field kBulkyV2Fields[] = {
+    ILITE_PACKET_FIELD(BulkyCommandV2, version),
+    ILITE_PACKET_FIELD(BulkyCommandV2, replyIndex),
+    ILITE_PACKET_FIELD(BulkyCommandV2, speed),
+    ILITE_PACKET_FIELD(BulkyCommandV2, state),
+};
+
+// Both layouts accept either size; only the field table differs
+constexpr PacketDescriptor kBulkyCommands[] = {
+    {"Bulky Command", BULKY_PACKET_MAGIC, sizeof(BulkyCommandV2),
+     PacketLayout::checkRange(sizeof(BulkyCommandV2), sizeof(BulkyCommand)), false,
+     PacketLayout::checkFields<BulkyCommand>(kBulkyV1Fields), PacketLayout::countOf(kBulkyV1Fields)},
+    {"Bulky Command", BULKY_PACKET_MAGIC, sizeof(BulkyCommandV2),
+     PacketLayout::checkRange(sizeof(BulkyCommandV2), sizeof(BulkyCommand)), false,
+     PacketLayout::checkFields<BulkyCommandV2>(kBulkyV2Fields), PacketLayout::countOf(kBulkyV2Fields)},
+};
+
+constexpr PacketDescriptor kBulkyTelemetry[] = {
+    {ILITE_PACKET(BulkyTelemetry, "Bulky Telemetry", BULKY_PACKET_MAGIC)},
+};
+
 class BulkyModule : public ILITEModule {
 public:
     const char* getModuleId() const override { return "com.ilite.bulky"; }
@@ -1674,19 +2250,15 @@ public:
     size_t getCommandPacketTypeCount() const override { return 1; }
     PacketDescriptor getCommandPacketDescriptor(size_t index) const override {
         if (index == 0) {
-            return {"Bulky Command", BULKY_PACKET_MAGIC, sizeof(BulkyCommand),
-                    sizeof(BulkyCommand), false, nullptr, 0};
+            // Either layout may go out; the fields follow the negotiated one
+            return kBulkyCommands[bulkyState.commandVersion >= BULKY_COMMAND_V2 ? 1 : 0];
         }
-        return {};
+        return PacketLayout::empty();
     }
 
-    size_t getTelemetryPacketTypeCount() const override { return 1; }
+    size_t getTelemetryPacketTypeCount() const override { return PacketLayout::countOf(kBulkyTelemetry); }
     PacketDescriptor getTelemetryPacketDescriptor(size_t index) const override {
-        if (index == 0) {
-            return {"Bulky Telemetry", BULKY_PACKET_MAGIC, sizeof(BulkyTelemetry),
-                    sizeof(BulkyTelemetry), true, nullptr, 0};
-        }
-        return {};
+        return PacketLayout::at(kBulkyTelemetry, index);
     }
 
     void onInit() override {
@@ -1707,40 +2279,16 @@ public:
     }
 
     void updateControl(const InputManager& inputs, float dt) override {
-        (void)dt;
-
-        // Read RAW joystick values (0-4095) using InputManager - no framework easing
-        int16_t joyX = inputs.getJoystickB_X_Raw();
-        int16_t joyY = inputs.getJoystickB_Y_Raw();
-
-        // Map joystick Y to speed (-100 to 100)
-        int16_t mappedY = map(joyY, 0, 4095, -100, 100);
+        const float forward = forwardAxis_.update(inputs.getJoystickB_Y(), dt);
+        const float turn = ControlShaping::deadzone(inputs.getJoystickB_X(), kDeadzone);
+        bulkyState.targetSpeed = static_cast<int8_t>(forward);
 
-        // Apply deadzone
-        if (abs(mappedY) < 10) {
-            mappedY = 0;
-        }
-
-        bulkyState.targetSpeed = static_cast<int8_t>(mappedY);
-
-        // Map joystick X to motion state (for turning/steering)
-        int16_t mappedX = map(joyX, 0, 4095, -100, 100);
-
-        // Simple motion state encoding:
         // 0 = stop, 1 = forward, 2 = backward, 3 = turn left, 4 = turn right
-        if (abs(mappedY) < 10 && abs(mappedX) < 10) {
-            bulkyState.motionState = 0; // Stop
-        } else if (abs(mappedX) > abs(mappedY)) {
-            // Turning dominates
-            bulkyState.motionState = (mappedX > 0) ? 4 : 3; // Turn right : Turn left
-        } else {
-            // Forward/backward dominates
-            bulkyState.motionState = (mappedY > 0) ? 1 : 2; // Forward : Backward
-        }
+        bulkyState.motionState = computeMotionState(forward / 100.0f, turn);
 
-        // Read speed potentiometer for speed scaling
-        uint16_t potValue = inputs.getPotentiometer_Raw();
-        uint8_t speedScale = map(potValue, 0, 4095, 0, 100);
+        // Speed potentiometer scales the command
+        uint8_t speedScale = static_cast<uint8_t>(
+            clampValue(inputs.getPotentiometer(), 0.0f, 1.0f) * 100.0f);
 
         // Apply slow mode limit
         if (bulkyState.slowModeActive) {
@@ -1751,19 +2299,18 @@ public:
         bulkyCommand.speed = (bulkyState.targetSpeed * speedScale) / 100;
         bulkyCommand.motionState = bulkyState.motionState;
 
-        // Read button states using InputManager
-        bulkyCommand.buttonStates[0] = inputs.getButton1() ? 1 : 0;
-        bulkyCommand.buttonStates[1] = inputs.getButton2() ? 1 : 0;
-        bulkyCommand.buttonStates[2] = inputs.getButton3() ? 1 : 0;
+        // Button states, expanded to bytes only for v1 robots
+        bulkyState.buttons = (inputs.getButton1() ? BulkyButton::Button1 : 0) |
+                             (inputs.getButton2() ? BulkyButton::Button2 : 0) |
+                             (inputs.getButton3() ? BulkyButton::Button3 : 0);
 
         // Increment reply index
         bulkyCommand.replyIndex++;
     }
 
     size_t prepareCommandPacket(size_t typeIndex, uint8_t* buffer, size_t bufferSize) override {
-        if (typeIndex == 0 && bufferSize >= sizeof(BulkyCommand)) {
-            memcpy(buffer, &bulkyCommand, sizeof(BulkyCommand));
-            return sizeof(BulkyCommand);
+        if (typeIndex == 0) {
+            return packBulkyCommand(buffer, bufferSize);
         }
         return 0;
     }
@@ -1777,12 +2324,13 @@ public:
     void drawDashboard(DisplayCanvas& canvas) override {
         // Graphical dashboard matching original ILITE Bulky layout
         const int16_t baseY = 14;  // Below top strip
+        const BulkyTelemetry telemetry = TelemetryView<BulkyTelemetry>(0).get();
 
         // Fire position bar (horizontal with icon showing servo position)
-        drawFirePosition(canvas, baseY + 7);
+        drawFirePosition(canvas, baseY + 7, telemetry.firePose);
 
         // Line follower (4-segment display)
-        drawLineFollower(canvas, baseY - 13);
+        drawLineFollower(canvas, baseY - 13, telemetry.linePosition);
 
         // Motion joystick (right side, lower)
         drawMotionJoystick(canvas, baseY + 18);
@@ -1791,14 +2339,14 @@ public:
         drawPeripheralJoystick(canvas, baseY - 1);
 
         // Proximity sensors (vertical bars)
-        drawProximitySensors(canvas, baseY + 8);
+        drawProximitySensors(canvas, baseY + 8, telemetry);
 
         // Speed bar (horizontal with value overlay)
         drawSpeedBar(canvas, baseY + 20);
     }
 
 private:
-    void drawFirePosition(DisplayCanvas& canvas, int16_t frameY) {
+    void drawFirePosition(DisplayCanvas& canvas, int16_t frameY, uint8_t firePose) {
         // 71x12px horizontal bar showing servo position (0-180 degrees)
         const int16_t x = 28;
         const int16_t w = 71;
@@ -1807,7 +2355,7 @@ private:
         canvas.drawRoundRect(x, frameY, w, h, 4, false);
 
         // Map fire position (0-180) to bar position
-        int iconX = map(bulkyTelemetry.firePose, 0, 180, x + w - 8, x + 8);
+        int iconX = map(firePose, 0, 180, x + w - 8, x + 8);
         iconX = constrain(iconX, x + 2, x + w - 10);
 
         // Draw icon/marker at position
@@ -1815,7 +2363,7 @@ private:
         canvas.drawText(iconX, frameY + h - 2, "^");
     }
 
-    void drawLineFollower(DisplayCanvas& canvas, int16_t frameY) {
+    void drawLineFollower(DisplayCanvas& canvas, int16_t frameY, uint8_t linePos) {
         // 4-segment line follower display (20x15px)
         const int16_t x = 1;
         const int16_t w = 20;
@@ -1824,7 +2372,6 @@ private:
         canvas.drawRoundRect(x, frameY, w, h, 3, false);
 
         // Draw 4 segments based on line position bits
-        uint8_t linePos = bulkyTelemetry.linePosition;
         int16_t fillY = frameY + 2;
         int16_t fillH = 11;
 
@@ -1871,7 +2418,7 @@ private:
         canvas.drawRoundRect(dotX, dotY, 3, 3, 1, true);
     }
 
-    void drawProximitySensors(DisplayCanvas& canvas, int16_t baseY) {
+    void drawProximitySensors(DisplayCanvas& canvas, int16_t baseY, const BulkyTelemetry& telemetry) {
         // Two vertical bars showing front/bottom distance (0-50cm)
         const int16_t w = 12;
         const int16_t h = 28;
@@ -1879,7 +2426,7 @@ private:
 
         // Bottom sensor (left bar)
         canvas.drawRoundRect(1, y, w, h, 3, false);
-        int bottomFill = map(bulkyTelemetry.bottomDistance, 0, 50, 27, 0);
+        int bottomFill = map(telemetry.bottomDistance, 0, 50, 27, 0);
         bottomFill = constrain(bottomFill, 0, 27);
         if (bottomFill > 0) {
             canvas.drawRect(3, y + 21, 8, bottomFill, true);
@@ -1887,7 +2434,7 @@ private:
 
         // Front sensor (right bar)
         canvas.drawRoundRect(14, y, w, h, 3, false);
-        int frontFill = map(bulkyTelemetry.frontDistance, 0, 50, 27, 0);
+        int frontFill = map(telemetry.frontDistance, 0, 50, 27, 0);
         frontFill = constrain(frontFill, 0, 27);
         if (frontFill > 0) {
             canvas.drawRect(16, y + 21, 8, frontFill, true);
@@ -1957,18 +2504,17 @@ public:
     }
 
 private:
-    static constexpr float kDeadzone = 0.05f;
+    static constexpr float kDeadzone = 0.1f;
 
-    static float applyDeadzone(float value) {
-        return (fabsf(value) < kDeadzone) ? 0.0f : value;
-    }
+    // Drive stick to -100..100 percent
+    ControlShaping::Axis forwardAxis_{ControlShaping::AxisShape(kDeadzone, 0.0f, 100.0f)};
 
     static uint8_t computeMotionState(float forward, float turn) {
         const float absForward = fabsf(forward);
         const float absTurn = fabsf(turn);
 
-        if (absForward < kDeadzone && absTurn < kDeadzone) {
-            return 0; // stop
+        if (absForward <= 0.0f && absTurn <= 0.0f) {
+            return 0; // stop (inputs are already deadzoned)
         }
         if (absTurn > absForward) {
             return turn > 0.0f ? 4 : 3; // turn right / left
@@ -2083,6 +2629,9 @@ private:
         }
     }
 };
+
+#endif // ILITE_MODULE_BULKY
+
 // ============================================================================
 // Explicit Registration (called before main)
 // ============================================================================
@@ -2144,28 +2693,54 @@ static void registerModuleMenuEntries() {
 // ============================================================================
 
 /**
- * @brief Register all built-in platform modules
+ * @brief Register the built-in platform modules selected for this build
  *
  * This function is called explicitly from ILITEFramework::begin() to ensure
  * the modules are properly linked and registered, avoiding linker issues
- * with static initialization in library archives.
+ * with static initialization in library archives. The table holds only the
+ * modules whose ILITE_MODULE_* flag is set (see ModuleSelection.h).
  */
 void registerBuiltInModules() {
     static bool registered = false;
+#if ILITE_MODULE_THEGILL
     static TheGillModule theGillModule;
+#endif
+#if ILITE_MODULE_DRONGAZE
     static DrongazeModule drongazeModule;
+#endif
+#if ILITE_MODULE_BULKY
     static BulkyModule bulkyModule;
+#endif
+
+    // Trailing nullptr keeps the table valid when every module is disabled
+    ILITEModule* const builtIns[] = {
+#if ILITE_MODULE_THEGILL
+        &theGillModule,
+#endif
+#if ILITE_MODULE_DRONGAZE
+        &drongazeModule,
+#endif
+#if ILITE_MODULE_BULKY
+        &bulkyModule,
+#endif
+        nullptr
+    };
 
     if (registered) {
         return;
     }
 
-    ModuleRegistry::registerModule(&theGillModule);
-    ModuleRegistry::registerModule(&drongazeModule);
-    ModuleRegistry::registerModule(&bulkyModule);
+    for (size_t i = 0; i < ILITE_BUILTIN_MODULE_COUNT; ++i) {
+        ModuleRegistry::registerModule(builtIns[i]);
+    }
 
     registerModuleMenuEntries();
     registered = true;
-    Serial.println("[ILITE] Built-in modules registered: TheGill, DroneGaze, Bulky");
+
+    Serial.printf("[ILITE] Built-in modules registered (%u):", static_cast<unsigned>(ILITE_BUILTIN_MODULE_COUNT));
+    for (size_t i = 0; i < ILITE_BUILTIN_MODULE_COUNT; ++i) {
+        Serial.printf(" %s", builtIns[i]->getModuleName());
+    }
+    Serial.println();
 }
 
@@ -4,13 +4,115 @@
  */
 
 #include "ModuleRegistry.h"
+#include <algorithm>
 #include <cstring>
 #include <cctype>
+#include <strings.h>
 
 // Static storage for registered modules
-static std::vector<ILITEModule*> g_modules;
+static ModuleList g_modules;
 static bool g_initialized = false;
 
+namespace {
+
+constexpr uint32_t kHashBase = 31;
+
+// One indexed keyword
+struct KeywordSlot {
+    uint32_t hash;          // Rolling hash of the lowercase keyword
+    const char* keyword;
+    uint8_t length;
+    uint8_t module;         // Index into g_modules
+    uint16_t order;         // Registration order (module, keyword) for tie-breaks
+};
+
+// Sorted by (length, hash)
+KeywordSlot g_keywordSlots[ModuleRegistry::kMaxKeywords];
+size_t g_keywordCount = 0;
+bool g_keywordsDirty = true;
+
+// Distinct keyword lengths, ascending
+uint8_t g_keywordLengths[ModuleRegistry::kMaxKeywords];
+size_t g_keywordLengthCount = 0;
+
+// One indexed telemetry magic, sorted by magic
+struct MagicSlot {
+    uint32_t magic;
+    uint8_t module;         // Index into g_modules, or kSharedMagic
+};
+
+constexpr uint8_t kSharedMagic = 0xFF;  // Declared by more than one module
+
+MagicSlot g_magicSlots[ModuleRegistry::kMaxMagics];
+size_t g_magicCount = 0;
+
+// Last successful lookup (re-pairing after a reboot reuses the same name)
+uint32_t g_lastNameHash = 0;
+size_t g_lastNameLength = 0;
+ILITEModule* g_lastMatch = nullptr;
+
+inline uint32_t lowerChar(char c) {
+    return static_cast<uint32_t>(tolower(static_cast<unsigned char>(c)));
+}
+
+uint32_t hashLower(const char* text, size_t length) {
+    uint32_t hash = 0;
+    for (size_t i = 0; i < length; ++i) {
+        hash = hash * kHashBase + lowerChar(text[i]);
+    }
+    return hash;
+}
+
+bool slotLess(const KeywordSlot& a, const KeywordSlot& b) {
+    if (a.length != b.length) {
+        return a.length < b.length;
+    }
+    return a.hash < b.hash;
+}
+
+bool magicLess(const MagicSlot& a, const MagicSlot& b) {
+    return a.magic < b.magic;
+}
+
+void buildMagicIndex() {
+    g_magicCount = 0;
+
+    for (size_t m = 0; m < g_modules.size(); ++m) {
+        ILITEModule* module = g_modules[m];
+        const size_t typeCount = module->getTelemetryPacketTypeCount();
+        for (size_t i = 0; i < typeCount; ++i) {
+            const uint32_t magic = module->getTelemetryPacketDescriptor(i).magicNumber;
+
+            MagicSlot* existing = nullptr;
+            for (size_t s = 0; s < g_magicCount; ++s) {
+                if (g_magicSlots[s].magic == magic) {
+                    existing = &g_magicSlots[s];
+                    break;
+                }
+            }
+            if (existing != nullptr) {
+                if (existing->module != m) {
+                    existing->module = kSharedMagic;
+                }
+                continue;
+            }
+            if (g_magicCount >= ModuleRegistry::kMaxMagics) {
+                Serial.printf("[ModuleRegistry] WARNING: Magic table full, ignoring 0x%08lX\n",
+                              static_cast<unsigned long>(magic));
+                continue;
+            }
+
+            MagicSlot& slot = g_magicSlots[g_magicCount++];
+            slot.magic = magic;
+            slot.module = static_cast<uint8_t>(m);
+        }
+    }
+
+    std::sort(g_magicSlots, g_magicSlots + g_magicCount, magicLess);
+}
+
+}  // namespace
+
 void ModuleRegistry::registerModule(ILITEModule* module) {
     if (module == nullptr) {
         return;
@@ -25,12 +127,18 @@ void ModuleRegistry::registerModule(ILITEModule* module) {
         }
     }
 
-    g_modules.push_back(module);
+    if (g_modules.count >= ModuleList::kCapacity) {
+        Serial.printf("[ModuleRegistry] ERROR: Module table full, dropping %s\n", newId);
+        return;
+    }
+
+    g_modules.items[g_modules.count++] = module;
+    g_keywordsDirty = true;
     Serial.printf("[ModuleRegistry] Registered module: %s (%s)\n",
                   module->getModuleName(), module->getModuleId());
 }
 
-std::vector<ILITEModule*>& ModuleRegistry::getModules() {
+const ModuleList& ModuleRegistry::getModules() {
     return g_modules;
 }
 
@@ -38,47 +146,123 @@ size_t ModuleRegistry::getModuleCount() {
     return g_modules.size();
 }
 
+// ============================================================================
+// Keyword Index
+// ============================================================================
+
+void ModuleRegistry::buildKeywordIndex() {
+    if (!g_keywordsDirty) {
+        return;
+    }
+    g_keywordsDirty = false;
+    g_keywordCount = 0;
+    g_keywordLengthCount = 0;
+    g_lastMatch = nullptr;
+
+    KeywordSlot* slots = g_keywordSlots;
+    uint16_t order = 0;
+    for (size_t m = 0; m < g_modules.size(); ++m) {
+        ILITEModule* module = g_modules[m];
+        const char** keywords = module->getDetectionKeywords();
+        const size_t keywordCount = module->getDetectionKeywordCount();
+        if (keywords == nullptr) {
+            continue;
+        }
+
+        for (size_t i = 0; i < keywordCount; ++i, ++order) {
+            const char* keyword = keywords[i];
+            if (keyword == nullptr || keyword[0] == '\0') {
+                continue;
+            }
+            const size_t length = strlen(keyword);
+            if (length > UINT8_MAX) {
+                continue;
+            }
+            if (g_keywordCount >= kMaxKeywords) {
+                Serial.printf("[ModuleRegistry] WARNING: Keyword table full, ignoring '%s'\n", keyword);
+                continue;
+            }
+
+            KeywordSlot& slot = slots[g_keywordCount++];
+            slot.hash = hashLower(keyword, length);
+            slot.keyword = keyword;
+            slot.length = static_cast<uint8_t>(length);
+            slot.module = static_cast<uint8_t>(m);
+            slot.order = order;
+        }
+    }
+
+    std::sort(slots, slots + g_keywordCount, slotLess);
+
+    for (size_t i = 0; i < g_keywordCount; ++i) {
+        if (g_keywordLengthCount == 0 ||
+            g_keywordLengths[g_keywordLengthCount - 1] != slots[i].length) {
+            g_keywordLengths[g_keywordLengthCount++] = slots[i].length;
+        }
+    }
+
+    buildMagicIndex();
+}
+
 ILITEModule* ModuleRegistry::findModuleByName(const char* deviceName) {
     if (deviceName == nullptr || deviceName[0] == '\0') {
         return nullptr;
     }
 
-    // Convert device name to lowercase for comparison
-    char lowerName[128];
-    size_t nameLen = strlen(deviceName);
-    if (nameLen >= sizeof(lowerName)) {
-        nameLen = sizeof(lowerName) - 1;
-    }
+    buildKeywordIndex();
 
-    for (size_t i = 0; i < nameLen; ++i) {
-        lowerName[i] = tolower(static_cast<unsigned char>(deviceName[i]));
+    const size_t nameLen = strlen(deviceName);
+    const uint32_t nameHash = hashLower(deviceName, nameLen);
+    if (g_lastMatch != nullptr && nameHash == g_lastNameHash && nameLen == g_lastNameLength) {
+        return g_lastMatch;
     }
-    lowerName[nameLen] = '\0';
 
-    // Search all modules for keyword match
-    for (ILITEModule* module : g_modules) {
-        const char** keywords = module->getDetectionKeywords();
-        size_t keywordCount = module->getDetectionKeywordCount();
+    // Rolling hash of every window of each indexed length; keep the match
+    // that comes first in registration order
+    const KeywordSlot* slots = g_keywordSlots;
+    const KeywordSlot* best = nullptr;
+    for (size_t l = 0; l < g_keywordLengthCount; ++l) {
+        const size_t length = g_keywordLengths[l];
+        if (length > nameLen) {
+            break;
+        }
 
-        if (keywords == nullptr || keywordCount == 0) {
-            continue;
+        uint32_t power = 1;  // kHashBase^(length - 1)
+        for (size_t i = 1; i < length; ++i) {
+            power *= kHashBase;
         }
 
-        for (size_t i = 0; i < keywordCount; ++i) {
-            const char* keyword = keywords[i];
-            if (keyword == nullptr) {
-                continue;
+        uint32_t hash = hashLower(deviceName, length);
+        for (size_t pos = 0; ; ++pos) {
+            KeywordSlot probe;
+            probe.hash = hash;
+            probe.length = static_cast<uint8_t>(length);
+            const KeywordSlot* it = std::lower_bound(slots, slots + g_keywordCount, probe, slotLess);
+            for (; it != slots + g_keywordCount && it->length == length && it->hash == hash; ++it) {
+                if ((best == nullptr || it->order < best->order) &&
+                    strncasecmp(deviceName + pos, it->keyword, length) == 0) {
+                    best = it;
+                }
             }
 
-            // Check if device name contains keyword (case-insensitive)
-            if (strstr(lowerName, keyword) != nullptr) {
-                Serial.printf("[ModuleRegistry] Device '%s' matched module '%s' (keyword: %s)\n",
-                              deviceName, module->getModuleName(), keyword);
-                return module;
+            if (pos + length >= nameLen) {
+                break;
             }
+            hash = (hash - lowerChar(deviceName[pos]) * power) * kHashBase +
+                   lowerChar(deviceName[pos + length]);
         }
     }
 
+    if (best != nullptr) {
+        ILITEModule* module = g_modules[best->module];
+        Serial.printf("[ModuleRegistry] Device '%s' matched module '%s' (keyword: %s)\n",
+                      deviceName, module->getModuleName(), best->keyword);
+        g_lastNameHash = nameHash;
+        g_lastNameLength = nameLen;
+        g_lastMatch = module;
+        return module;
+    }
+
     Serial.printf("[ModuleRegistry] No module matched device name: %s\n", deviceName);
     return nullptr;
 }
@@ -97,10 +281,19 @@ ILITEModule* ModuleRegistry::findModuleById(const char* moduleId) {
     return nullptr;
 }
 
-ILITEModule* ModuleRegistry::getModuleByIndex(size_t index) {
-    if (index >= g_modules.size()) {
+ILITEModule* ModuleRegistry::findModuleByMagic(uint32_t magic) {
+    buildKeywordIndex();
+
+    MagicSlot probe;
+    probe.magic = magic;
+    const MagicSlot* it = std::lower_bound(g_magicSlots, g_magicSlots + g_magicCount, probe, magicLess);
+    if (it == g_magicSlots + g_magicCount || it->magic != magic || it->module == kSharedMagic) {
         return nullptr;
     }
+    return g_modules[it->module];
+}
+
+ILITEModule* ModuleRegistry::getModuleByIndex(size_t index) {
     return g_modules[index];
 }
 
@@ -110,18 +303,33 @@ void ModuleRegistry::initializeAll() {
         return;
     }
 
-    Serial.printf("[ModuleRegistry] Initializing %zu modules...\n", g_modules.size());
+    Serial.printf("[ModuleRegistry] %zu modules registered (initialized on first use)\n",
+                  g_modules.size());
 
     for (ILITEModule* module : g_modules) {
         Serial.printf("[ModuleRegistry]   - %s (%s) by %s\n",
                       module->getModuleName(),
                       module->getVersion(),
                       module->getAuthor() ? module->getAuthor() : "Unknown");
-
-        module->onInit();
-        module->initialized_ = true;
     }
 
+    // Index keywords now so the first pairing doesn't pay for it
+    buildKeywordIndex();
+
     g_initialized = true;
-    Serial.println("[ModuleRegistry] All modules initialized successfully");
+    Serial.printf("[ModuleRegistry] Registry ready (%u keywords, %u magics)\n",
+                  static_cast<unsigned>(g_keywordCount), static_cast<unsigned>(g_magicCount));
+}
+
+void ModuleRegistry::ensureInitialized(ILITEModule* module) {
+    if (module == nullptr || module->initialized_) {
+        return;
+    }
+
+    const uint32_t startUs = micros();
+    module->onInit();
+    module->initialized_ = true;
+    Serial.printf("[ModuleRegistry] Initialized %s on first use (%lu us)\n",
+                  module->getModuleName(),
+                  static_cast<unsigned long>(micros() - startUs));
 }
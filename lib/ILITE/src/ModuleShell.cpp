@@ -1,12 +1,15 @@
 #include "ModuleShell.h"
 
 #include "DisplayCanvas.h"
+#include "EncoderSampler.h"
 #include "ILITE.h"
 #include "ILITEModule.h"
 #include "InputManager.h"
+#include "LinkMetrics.h"
 #include "ScreenRegistry.h"
 #include "display.h"
 #include "input.h"
+#include "espnow_discovery.h"
 
 #include <algorithm>
 
@@ -15,6 +18,10 @@ bool ModuleShell::menuOpen_ = false;
 ModuleMenuItem ModuleShell::menuRoot_{};
 ModuleMenuBuilder ModuleShell::menuBuilder_{menuRoot_};
 std::vector<ModuleShell::MenuLevel> ModuleShell::menuStack_{};
+std::vector<ModuleShell::MenuSpan> ModuleShell::spans_{};
+std::vector<uint16_t> ModuleShell::visibleIndex_{};
+std::vector<UIComponents::MenuItem> ModuleShell::menuItems_{};
+uint32_t ModuleShell::generation_ = 1;
 int ModuleShell::lastEncoderCount_ = 0;
 bool ModuleShell::lastEncoderButton_ = false;
 bool ModuleShell::lastButton3_ = false;
@@ -24,7 +31,7 @@ void ModuleShell::onModuleActivated(ILITEModule* module) {
     reset();
     if (activeModule_ != nullptr) {
         rebuildMenu();
-        lastEncoderCount_ = encoderCount;
+        lastEncoderCount_ = EncoderSampler::getInstance().getPosition();
         lastEncoderButton_ = (digitalRead(encoderBtn) == LOW);
         lastButton3_ = (digitalRead(button3) == LOW);
     }
@@ -42,9 +49,15 @@ bool ModuleShell::draw(DisplayCanvas& canvas, ILITEFramework& framework) {
         return false;
     }
 
-    activeModule_->drawDashboard(canvas);
+    {
+        ModuleCall call(activeModule_, ModuleCallback::Draw);
+        if (call.allowed()) {
+            activeModule_->drawDashboard(canvas);
+        }
+    }
 
     if (menuOpen_) {
+        invalidateVisibility();
         drawMenuOverlay(canvas);
     }
 
@@ -56,7 +69,7 @@ void ModuleShell::pollInput() {
         return;
     }
 
-    int currentEncoder = encoderCount;
+    int currentEncoder = EncoderSampler::getInstance().getPosition();
     if (currentEncoder != lastEncoderCount_) {
         int delta = currentEncoder - lastEncoderCount_;
         handleEncoderRotate((delta > 0) ? 1 : -1);
@@ -81,6 +94,15 @@ void ModuleShell::reset() {
     menuStack_.clear();
     menuBuilder_.clear();
     menuRoot_.children.clear();
+    spans_.clear();
+    visibleIndex_.clear();
+}
+
+void ModuleShell::invalidateVisibility() {
+    generation_++;
+    if (generation_ == 0) {
+        generation_ = 1;
+    }
 }
 
 void ModuleShell::rebuildMenu() {
@@ -88,8 +110,19 @@ void ModuleShell::rebuildMenu() {
     if (activeModule_ != nullptr) {
         activeModule_->buildModuleMenu(menuBuilder_);
     }
+
+    // The tree is fixed from here until the next rebuild, so child
+    // addresses and the spans below stay valid while the menu is open
+    spans_.clear();
+    visibleIndex_.clear();
+    size_t maxChildren = 0;
+    indexMenu(menuRoot_, maxChildren);
+    menuItems_.clear();
+    menuItems_.reserve(maxChildren);
+
     menuStack_.clear();
-    menuStack_.push_back(MenuLevel{&menuRoot_, 0, 0});
+    menuStack_.reserve(spans_.size());
+    menuStack_.push_back(MenuLevel{&menuRoot_, 0, 0, 0});
 }
 
 void ModuleShell::openMenu() {
@@ -103,7 +136,7 @@ void ModuleShell::openMenu() {
 void ModuleShell::closeMenu() {
     menuOpen_ = false;
     menuStack_.clear();
-    menuStack_.push_back(MenuLevel{&menuRoot_, 0, 0});
+    menuStack_.push_back(MenuLevel{&menuRoot_, 0, 0, 0});
 }
 
 void ModuleShell::handleEncoderRotate(int delta) {
@@ -115,7 +148,7 @@ void ModuleShell::handleEncoderRotate(int delta) {
     }
 
     MenuLevel& level = menuStack_.back();
-    auto visible = collectVisibleChildren(*level.node);
+    const VisibleChildren visible = visibleChildren(level);
     if (visible.empty()) {
         level.focus = 0;
         level.scroll = 0;
@@ -149,19 +182,14 @@ void ModuleShell::handleEncoderPress() {
     }
 
     MenuLevel& level = menuStack_.back();
-    auto visible = collectVisibleChildren(*level.node);
-    if (visible.empty()) {
-        return;
-    }
-
-    ModuleMenuItem* item = visibleChildAt(*level.node, level.focus);
+    ModuleMenuItem* item = visibleChildren(level).at(level.focus);
     if (item == nullptr) {
         return;
     }
 
     switch (item->type) {
         case ModuleMenuItem::Type::Submenu:
-            menuStack_.push_back(MenuLevel{item, 0, 0});
+            menuStack_.push_back(MenuLevel{item, spanFor(item), 0, 0});
             break;
         case ModuleMenuItem::Type::Toggle:
             if (item->onSelect) {
@@ -206,7 +234,7 @@ void ModuleShell::drawMenuOverlay(DisplayCanvas& canvas) {
     }
 
     MenuLevel& level = menuStack_.back();
-    auto visible = collectVisibleChildren(*level.node);
+    const VisibleChildren visible = visibleChildren(level);
 
     canvas.setDrawColor(1);
     canvas.drawRect(0, 0, canvas.getWidth(), canvas.getHeight(), true);
@@ -224,7 +252,7 @@ void ModuleShell::drawMenuOverlay(DisplayCanvas& canvas) {
                                    title,
                                    ICON_MENU,
                                    0,
-                                   0,
+                                   LinkMetrics::getSignalBars(discovery.getPairedMac()),
                                    true);
 
     if (breadcrumb) {
@@ -234,10 +262,14 @@ void ModuleShell::drawMenuOverlay(DisplayCanvas& canvas) {
                                      true);
     }
 
-    std::vector<UIComponents::MenuItem> items;
-    items.reserve(visible.size());
-    for (ModuleMenuItem* child : visible) {
-        UIComponents::MenuItem ui{};
+    // Capacity was reserved for the largest submenu in rebuildMenu(), and
+    // only the rows on screen run their value/toggle callbacks
+    constexpr int maxVisible = 4;
+    menuItems_.assign(visible.size(), UIComponents::MenuItem{});
+    const int rowEnd = std::min(level.scroll + maxVisible, static_cast<int>(visible.size()));
+    for (int row = level.scroll; row < rowEnd; ++row) {
+        const ModuleMenuItem* child = visible.at(row);
+        UIComponents::MenuItem& ui = menuItems_[row];
         ui.icon = child->icon;
         ui.label = child->label.c_str();
         ui.value = child->value ? child->value() : nullptr;
@@ -245,13 +277,12 @@ void ModuleShell::drawMenuOverlay(DisplayCanvas& canvas) {
         ui.isToggle = (child->type == ModuleMenuItem::Type::Toggle);
         ui.toggleState = ui.isToggle && child->toggleState ? child->toggleState() : false;
         ui.isReadOnly = false;
-        items.push_back(ui);
     }
 
     constexpr int contentY = UIComponents::HEADER_HEIGHT + UIComponents::BREADCRUMB_HEIGHT + 4;
     UIComponents::drawModernMenu(canvas,
-                                 items.data(),
-                                 items.size(),
+                                 menuItems_.data(),
+                                 menuItems_.size(),
                                  level.focus,
                                  level.scroll,
                                  contentY);
@@ -272,24 +303,46 @@ ModuleMenuItem* ModuleShell::currentMenuNode() {
     return menuStack_.back().node;
 }
 
-std::vector<ModuleMenuItem*> ModuleShell::collectVisibleChildren(ModuleMenuItem& node) {
-    std::vector<ModuleMenuItem*> result;
-    for (auto& child : node.children) {
-        if (child.condition && !child.condition()) {
-            continue;
+ModuleShell::VisibleChildren ModuleShell::visibleChildren(const MenuLevel& level) {
+    if (level.span >= spans_.size()) {
+        return VisibleChildren();
+    }
+    MenuSpan& span = spans_[level.span];
+    uint16_t* index = visibleIndex_.data() + span.first;
+    if (span.generation != generation_) {
+        const size_t childCount = level.node->children.size();
+        uint16_t count = 0;
+        for (size_t i = 0; i < childCount; ++i) {
+            const ModuleMenuItem& child = level.node->children[i];
+            if (child.condition && !child.condition()) {
+                continue;
+            }
+            index[count++] = static_cast<uint16_t>(i);
         }
-        result.push_back(&child);
+        span.count = count;
+        span.generation = generation_;
     }
-    return result;
+    return VisibleChildren(level.node, index, span.count);
 }
 
-ModuleMenuItem* ModuleShell::visibleChildAt(ModuleMenuItem& node, int index) {
-    auto visible = collectVisibleChildren(node);
-    if (index < 0 || static_cast<size_t>(index) >= visible.size()) {
-        return nullptr;
+void ModuleShell::indexMenu(const ModuleMenuItem& node, size_t& maxChildren) {
+    const size_t childCount = node.children.size();
+    spans_.push_back(MenuSpan{&node, static_cast<uint16_t>(visibleIndex_.size()), 0, 0});
+    visibleIndex_.resize(visibleIndex_.size() + childCount);
+    maxChildren = std::max(maxChildren, childCount);
+
+    for (const ModuleMenuItem& child : node.children) {
+        if (child.type == ModuleMenuItem::Type::Submenu) {
+            indexMenu(child, maxChildren);
+        }
     }
-    return visible[index];
 }
 
-
-
+uint16_t ModuleShell::spanFor(const ModuleMenuItem* node) {
+    for (size_t i = 0; i < spans_.size(); ++i) {
+        if (spans_[i].node == node) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    return static_cast<uint16_t>(spans_.size());
+}
@@ -0,0 +1,279 @@
+/**
+ * @file OtaReceiver.cpp
+ * @brief Compressed OTA listener: header, streaming inflate, Update writes
+ */
+
+#include "OtaReceiver.h"
+#include <Update.h>
+#include <WiFi.h>
+#include <esp32/rom/miniz.h>
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+OtaReceiverStats OtaReceiver::stats_;
+
+namespace {
+
+constexpr uint32_t kMagic = 0x5A4F4C49;         // "ILOZ" little-endian
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderBytes = 32;
+constexpr uint32_t kTimeoutMs = 5000;           // No byte for this long = host gone
+constexpr size_t kChunkBytes = 1460;            // One TCP segment
+
+struct Header {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t encoding;
+    uint16_t reserved;
+    uint32_t imageBytes;
+    uint32_t payloadBytes;
+    uint8_t md5[16];
+} __attribute__((packed));
+
+static_assert(sizeof(Header) == kHeaderBytes, "OTA header layout");
+
+// Allocated for one transfer: ROM decoder state, its wrap-around dictionary
+// and the receive buffer
+struct Inflater {
+    tinfl_decompressor decoder;
+    uint8_t dictionary[TINFL_LZ_DICT_SIZE];
+    uint8_t input[kChunkBytes];
+    size_t dictionaryOffset;
+};
+
+WiFiServer* g_server = nullptr;
+OtaReceiver::StartCallback g_onStart = nullptr;
+OtaReceiver::ProgressCallback g_onProgress = nullptr;
+
+bool readFully(WiFiClient& client, uint8_t* data, size_t length) {
+    size_t done = 0;
+    uint32_t lastByteMs = millis();
+    while (done < length) {
+        const int n = client.read(data + done, length - done);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+            lastByteMs = millis();
+        } else if (!client.connected() || millis() - lastByteMs > kTimeoutMs) {
+            return false;
+        } else {
+            delay(1);
+        }
+    }
+    return true;
+}
+
+// Up to capacity bytes, at least one unless the host went away
+size_t readSome(WiFiClient& client, uint8_t* data, size_t capacity) {
+    const uint32_t startMs = millis();
+    while (millis() - startMs <= kTimeoutMs) {
+        const int n = client.read(data, capacity);
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        if (!client.connected()) {
+            break;
+        }
+        delay(1);
+    }
+    return 0;
+}
+
+/// Inflate one chunk into the dictionary and write what comes out
+const char* inflateChunk(Inflater& inflater, const uint8_t* data, size_t length, bool last,
+                         uint32_t& written, bool& done) {
+    const mz_uint32 flags = TINFL_FLAG_PARSE_ZLIB_HEADER | (last ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+    size_t consumed = 0;
+    while (true) {
+        size_t inBytes = length - consumed;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - inflater.dictionaryOffset;
+        uint8_t* out = inflater.dictionary + inflater.dictionaryOffset;
+        const tinfl_status status = tinfl_decompress(&inflater.decoder, data + consumed, &inBytes,
+                                                     inflater.dictionary, out, &outBytes, flags);
+        consumed += inBytes;
+
+        if (outBytes > 0) {
+            if (Update.write(out, outBytes) != outBytes) {
+                return "flash write";
+            }
+            written += outBytes;
+            inflater.dictionaryOffset = (inflater.dictionaryOffset + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+
+        if (status < TINFL_STATUS_DONE) {
+            return "corrupt stream";
+        }
+        if (status == TINFL_STATUS_DONE) {
+            done = true;
+            return nullptr;
+        }
+        // Output space ran out: go round again on the same input
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && consumed == length) {
+            return last ? "truncated stream" : nullptr;
+        }
+    }
+}
+
+void reply(WiFiClient& client, const char* error) {
+    if (error == nullptr) {
+        client.print("OK\n");
+    } else {
+        client.printf("ERR %s\n", error);
+    }
+    client.flush();
+}
+
+/// Receive header and payload; nullptr on success, else the reason
+const char* receive(WiFiClient& client, OtaReceiverStats& stats) {
+    Header header;
+    if (!readFully(client, reinterpret_cast<uint8_t*>(&header), sizeof(header))) {
+        return "no header";
+    }
+    if (header.magic != kMagic || header.version != kVersion) {
+        return "bad header";
+    }
+    if (header.encoding != OtaReceiver::kEncodingRaw && header.encoding != OtaReceiver::kEncodingZlib) {
+        return "unknown encoding";
+    }
+    stats.encoding = header.encoding;
+
+    Inflater* inflater = new (std::nothrow) Inflater;
+    if (inflater == nullptr) {
+        return "no memory";
+    }
+    tinfl_init(&inflater->decoder);
+    inflater->dictionaryOffset = 0;
+
+    if (g_onStart != nullptr) {
+        g_onStart();
+    }
+
+    char md5[33];
+    for (size_t i = 0; i < sizeof(header.md5); ++i) {
+        snprintf(md5 + i * 2, 3, "%02x", header.md5[i]);
+    }
+    if (!Update.begin(header.imageBytes, U_FLASH)) {
+        delete inflater;
+        return "image too large";
+    }
+    Update.setMD5(md5);
+    client.print("GO\n");
+
+    const char* error = nullptr;
+    uint32_t received = 0;
+    uint32_t written = 0;
+    bool done = false;
+    int lastPercent = -1;
+    while (error == nullptr && received < header.payloadBytes) {
+        const size_t want = std::min(kChunkBytes, static_cast<size_t>(header.payloadBytes - received));
+        const size_t n = readSome(client, inflater->input, want);
+        if (n == 0) {
+            error = "connection lost";
+            break;
+        }
+        received += n;
+
+        if (header.encoding == OtaReceiver::kEncodingRaw) {
+            if (Update.write(inflater->input, n) != n) {
+                error = "flash write";
+            }
+            written += n;
+        } else if (done) {
+            error = "data after stream end";
+        } else {
+            error = inflateChunk(*inflater, inflater->input, n, received == header.payloadBytes,
+                                 written, done);
+        }
+        if (written > header.imageBytes) {
+            error = "image larger than header";
+        }
+
+        const int percent = static_cast<int>(static_cast<uint64_t>(received) * 100 / header.payloadBytes);
+        if (percent != lastPercent && g_onProgress != nullptr) {
+            lastPercent = percent;
+            g_onProgress(percent);
+        }
+    }
+    delete inflater;
+
+    stats.payloadBytes = received;
+    stats.imageBytes = written;
+    if (error == nullptr && written != header.imageBytes) {
+        error = "image size mismatch";
+    }
+    if (error == nullptr && !Update.end()) {
+        error = Update.getError() == UPDATE_ERROR_MD5 ? "md5 mismatch" : "update end";
+    }
+    if (error != nullptr) {
+        Update.abort();
+    }
+    return error;
+}
+
+}  // namespace
+
+// ============================================================================
+// Listener
+// ============================================================================
+
+bool OtaReceiver::begin(uint16_t port, StartCallback onStart, ProgressCallback onProgress) {
+    end();
+    g_server = new (std::nothrow) WiFiServer(port);
+    if (g_server == nullptr) {
+        return false;
+    }
+    g_onStart = onStart;
+    g_onProgress = onProgress;
+    g_server->begin();
+    g_server->setNoDelay(true);
+    Serial.printf("[OTA] Compressed images on port %u (tools/ota_push.py)\n", static_cast<unsigned>(port));
+    return true;
+}
+
+void OtaReceiver::end() {
+    if (g_server != nullptr) {
+        g_server->end();
+        delete g_server;
+        g_server = nullptr;
+    }
+}
+
+void OtaReceiver::handle() {
+    if (g_server == nullptr || !g_server->hasClient()) {
+        return;
+    }
+
+    WiFiClient client = g_server->available();
+    client.setNoDelay(true);
+
+    OtaReceiverStats stats;
+    const uint32_t startMs = millis();
+    stats.error = receive(client, stats);
+    stats.elapsedMs = millis() - startMs;
+    stats.ok = stats.error == nullptr;
+    stats_ = stats;
+
+    reply(client, stats.error);
+    dump(Serial);
+    client.stop();
+
+    if (stats.ok) {
+        delay(100);
+        ESP.restart();
+    }
+}
+
+void OtaReceiver::dump(Print& out) {
+    const OtaReceiverStats& s = stats_;
+    if (s.ok) {
+        out.printf("[OTA] %s image %lu B from %lu B in %lu ms\n",
+                   s.encoding == kEncodingZlib ? "zlib" : "raw",
+                   static_cast<unsigned long>(s.imageBytes),
+                   static_cast<unsigned long>(s.payloadBytes),
+                   static_cast<unsigned long>(s.elapsedMs));
+    } else {
+        out.printf("[OTA] Transfer failed: %s (%lu B received)\n",
+                   s.error != nullptr ? s.error : "none yet",
+                   static_cast<unsigned long>(s.payloadBytes));
+    }
+}
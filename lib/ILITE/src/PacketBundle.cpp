@@ -0,0 +1,84 @@
+/**
+ * @file PacketBundle.cpp
+ * @brief Bundle frame packing and unpacking
+ */
+
+#include "PacketBundle.h"
+#include <cstring>
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+PacketBundleWriter::PacketBundleWriter()
+    : length_(0),
+      count_(0),
+      headroom_(0)
+{
+    reset();
+}
+
+void PacketBundleWriter::reset() {
+    uint32_t magic = BUNDLE_PACKET_MAGIC;
+    memcpy(buffer_, &magic, sizeof(magic));
+    length_ = kHeaderSize;
+    count_ = 0;
+}
+
+bool PacketBundleWriter::fits(size_t length) const {
+    return length > 0 && length <= 0xFF && length_ + 1 + length <= kMaxFrameSize - headroom_;
+}
+
+bool PacketBundleWriter::append(const uint8_t* packet, size_t length) {
+    if (packet == nullptr || !fits(length)) {
+        return false;
+    }
+    buffer_[length_++] = static_cast<uint8_t>(length);
+    memcpy(buffer_ + length_, packet, length);
+    length_ += length;
+    count_++;
+    return true;
+}
+
+const uint8_t* PacketBundleWriter::firstPacket(size_t& length) const {
+    if (count_ == 0) {
+        length = 0;
+        return nullptr;
+    }
+    length = buffer_[kHeaderSize];
+    return buffer_ + kHeaderSize + 1;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+bool isPacketBundle(const uint8_t* data, size_t length) {
+    if (data == nullptr || length < PacketBundleWriter::kHeaderSize + 1) {
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == BUNDLE_PACKET_MAGIC;
+}
+
+int forEachBundledPacket(const uint8_t* data, size_t length,
+                         void (*handler)(const uint8_t* packet, size_t length, void* context),
+                         void* context) {
+    if (!isPacketBundle(data, length) || handler == nullptr) {
+        return -1;
+    }
+
+    int delivered = 0;
+    size_t offset = PacketBundleWriter::kHeaderSize;
+    while (offset < length) {
+        size_t subLength = data[offset++];
+        if (subLength == 0 || offset + subLength > length) {
+            return -1;
+        }
+        handler(data + offset, subLength, context);
+        offset += subLength;
+        delivered++;
+    }
+    return delivered;
+}
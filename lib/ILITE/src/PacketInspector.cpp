@@ -0,0 +1,337 @@
+/**
+ * @file PacketInspector.cpp
+ * @brief Packet statistics and the field-table driven inspector screen
+ */
+
+#include "PacketInspector.h"
+#include "PacketRouter.h"
+#include "ScreenRegistry.h"
+#include "TelemetryHealth.h"
+#include "TelemetryStore.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(PacketInspector::kMaxTypes == TelemetryStore::kMaxSlots,
+              "One statistics entry per telemetry slot");
+
+PacketTypeStats PacketInspector::stats_[PacketInspector::kMaxTypes] = {};
+
+const uint32_t PacketInspector::kJitterBucketUs[kPacketHistogramBuckets] = {
+    250, 500, 1000, 2000, 4000, 8000, 16000, UINT32_MAX
+};
+
+namespace {
+
+constexpr size_t kFieldRows = 6;
+constexpr size_t kRowChars = 22;
+constexpr int16_t kFirstRowY = 15;
+constexpr int16_t kRowHeight = 7;
+constexpr size_t kHexBytesPerRow = 8;
+
+// Screen state (DisplayTask)
+size_t selectedType = 0;
+size_t scrollRow = 0;
+bool showHistograms = false;
+
+template<typename T>
+T readAt(const uint8_t* data, size_t offset) {
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+size_t histogramBucket(uint32_t value, const uint32_t* bounds) {
+    size_t bucket = 0;
+    while (bucket < kPacketHistogramBuckets - 1 && value >= bounds[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+size_t typeCount(ILITEModule* module) {
+    if (module == nullptr) {
+        return 0;
+    }
+    const size_t count = module->getTelemetryPacketTypeCount();
+    return count < PacketInspector::kMaxTypes ? count : PacketInspector::kMaxTypes;
+}
+
+void drawHistogram(DisplayCanvas& canvas, int16_t x, const uint32_t* buckets, const char* label) {
+    uint32_t peak = 0;
+    for (size_t i = 0; i < kPacketHistogramBuckets; ++i) {
+        peak = buckets[i] > peak ? buckets[i] : peak;
+    }
+    const int16_t baseY = 50;
+    const int16_t maxHeight = 20;
+    for (size_t i = 0; i < kPacketHistogramBuckets; ++i) {
+        const int16_t height = peak ? static_cast<int16_t>((buckets[i] * maxHeight) / peak) : 0;
+        if (height > 0) {
+            canvas.drawRect(x + static_cast<int16_t>(i * 8), baseY - height, 7, height, true);
+        }
+    }
+    canvas.drawLine(x, baseY, x + 62, baseY);
+    canvas.drawText(x, baseY + 7, label);
+}
+
+void drawFields(DisplayCanvas& canvas, const PacketDescriptor& desc, const TelemetrySlot* slot) {
+    char rows[kFieldRows][kRowChars];
+    char values[kFieldRows][kRowChars];
+    size_t rowCount = 0;
+
+    const bool hex = desc.fields == nullptr || desc.fieldCount == 0;
+    size_t first = 0;
+    size_t total = 0;
+
+    // Format only the visible rows, straight from the slot
+    const bool ok = slot != nullptr && slot->inspect([&](const uint8_t* data, size_t length) {
+        rowCount = 0;
+        total = hex ? (length + kHexBytesPerRow - 1) / kHexBytesPerRow : desc.fieldCount;
+        first = total > kFieldRows ? std::min(scrollRow, total - kFieldRows) : 0;
+        for (size_t row = first; row < total && rowCount < kFieldRows; ++row, ++rowCount) {
+            if (hex) {
+                snprintf(rows[rowCount], kRowChars, "%02u", static_cast<unsigned>(row * kHexBytesPerRow));
+                size_t pos = 0;
+                for (size_t i = 0; i < kHexBytesPerRow && row * kHexBytesPerRow + i < length; ++i) {
+                    pos += snprintf(values[rowCount] + pos, kRowChars - pos, "%02X",
+                                    data[row * kHexBytesPerRow + i]);
+                }
+                values[rowCount][pos] = '\0';
+            } else {
+                const PacketDescriptor::Field& field = desc.fields[row];
+                snprintf(rows[rowCount], kRowChars, "%s", field.name);
+                PacketInspector::formatField(field, data, length, values[rowCount], kRowChars);
+            }
+        }
+    });
+
+    if (!ok) {
+        canvas.drawText(0, kFirstRowY + kRowHeight, "No packet yet");
+        return;
+    }
+    scrollRow = first;
+    for (size_t i = 0; i < rowCount; ++i) {
+        const int16_t y = kFirstRowY + static_cast<int16_t>(i * kRowHeight);
+        canvas.drawText(0, y, rows[i]);
+        canvas.drawText(hex ? 16 : 64, y, values[i]);
+    }
+
+    if (total > kFieldRows) {
+        canvas.drawTextF(110, 6, "%u/%u", static_cast<unsigned>(first + 1), static_cast<unsigned>(total));
+    }
+}
+
+void drawStats(DisplayCanvas& canvas, size_t typeIndex) {
+    const PacketTypeStats& stats = *PacketInspector::getStats(typeIndex);
+    const TelemetryRate& rate = *TelemetryHealth::get(typeIndex);
+    canvas.drawTextF(0, 15, "%.1f/s  %uB (%u-%u)  n=%lu",
+                     TelemetryHealth::getRateHz(typeIndex), stats.lastSize, stats.minSize, stats.maxSize,
+                     static_cast<unsigned long>(stats.packets));
+    canvas.drawTextF(0, 22, "Int %lu/%lums  jit %lu/%luus",
+                     static_cast<unsigned long>(rate.intervalAvgUs / 1000),
+                     static_cast<unsigned long>(rate.maxGapUs / 1000),
+                     static_cast<unsigned long>(stats.jitterAvgUs),
+                     static_cast<unsigned long>(stats.jitterMaxUs));
+    drawHistogram(canvas, 0, stats.sizeHistogram, "size/32B");
+    drawHistogram(canvas, 65, stats.jitterHistogram, "jitter .25-16ms");
+}
+
+void drawInspectorScreen(DisplayCanvas& canvas) {
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+
+    ILITEModule* module = PacketRouter::getInstance().getActiveModule();
+    const size_t count = typeCount(module);
+    if (count == 0) {
+        canvas.drawText(0, 6, "Packets");
+        canvas.drawLine(0, 8, 127, 8);
+        canvas.drawText(0, 22, "No telemetry types");
+        canvas.drawText(0, 63, "B1:Back");
+        return;
+    }
+    if (selectedType >= count) {
+        selectedType = 0;
+    }
+
+    const PacketDescriptor desc = module->getTelemetryPacketDescriptor(selectedType);
+    canvas.drawTextF(0, 6, "%u/%u %s", static_cast<unsigned>(selectedType + 1),
+                     static_cast<unsigned>(count), desc.name ? desc.name : "?");
+    canvas.drawLine(0, 8, 127, 8);
+
+    if (showHistograms) {
+        drawStats(canvas, selectedType);
+    } else {
+        drawFields(canvas, desc, TelemetryStore::getInstance().getSlot(selectedType));
+    }
+    canvas.drawText(0, 63, showHistograms ? "B1:Back B2:Fields B3:Reset" : "B1:Back B2:Stats Push:Type");
+}
+
+void scrollRows(int delta) {
+    if (delta < 0 && scrollRow < static_cast<size_t>(-delta)) {
+        scrollRow = 0;
+    } else {
+        scrollRow += delta;
+    }
+}
+
+void nextType() {
+    const size_t count = typeCount(PacketRouter::getInstance().getActiveModule());
+    selectedType = count ? (selectedType + 1) % count : 0;
+    scrollRow = 0;
+}
+
+void toggleHistograms() {
+    showHistograms = !showHistograms;
+}
+
+constexpr Screen kInspectorScreen[] = {{
+    "framework.packets", "Packets", ICON_SIGNAL_FULL,
+    &drawInspectorScreen, nullptr,
+    &scrollRows, &nextType,
+    &ScreenRegistry::goBack, &toggleHistograms, &PacketInspector::reset,
+    false
+}};
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void PacketInspector::begin() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+
+    ScreenRegistry::registerTable(kInspectorScreen, 1);
+    registered = true;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void PacketInspector::record(size_t typeIndex, size_t length, uint32_t intervalUs) {
+    if (typeIndex >= kMaxTypes) {
+        return;
+    }
+    PacketTypeStats& stats = stats_[typeIndex];
+    const uint16_t size = static_cast<uint16_t>(length);
+
+    if (stats.packets == 0) {
+        stats.minSize = size;
+        stats.maxSize = size;
+    } else {
+        // Deviation from TelemetryHealth's running average (which includes this interval)
+        const uint32_t average = TelemetryHealth::get(typeIndex)->intervalAvgUs;
+        const uint32_t jitter = intervalUs > average ? intervalUs - average : average - intervalUs;
+        stats.jitterAvgUs = stats.jitterAvgUs - stats.jitterAvgUs / 8 + jitter / 8;
+        stats.jitterMaxUs = jitter > stats.jitterMaxUs ? jitter : stats.jitterMaxUs;
+        stats.jitterHistogram[histogramBucket(jitter, kJitterBucketUs)]++;
+        stats.minSize = size < stats.minSize ? size : stats.minSize;
+        stats.maxSize = size > stats.maxSize ? size : stats.maxSize;
+    }
+
+    const size_t sizeBucket = length / kSizeBucketBytes;
+    stats.sizeHistogram[sizeBucket < kPacketHistogramBuckets ? sizeBucket : kPacketHistogramBuckets - 1]++;
+    stats.lastSize = size;
+    stats.packets++;
+}
+
+void PacketInspector::reset() {
+    memset(stats_, 0, sizeof(stats_));
+}
+
+const PacketTypeStats* PacketInspector::getStats(size_t typeIndex) {
+    return typeIndex < kMaxTypes ? &stats_[typeIndex] : nullptr;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+size_t PacketInspector::formatField(const PacketDescriptor::Field& field, const uint8_t* data, size_t length,
+                                    char* out, size_t outSize) {
+    if (out == nullptr || outSize == 0) {
+        return 0;
+    }
+    if (data == nullptr || field.size == 0 || field.offset + field.size > length) {
+        return snprintf(out, outSize, "--");
+    }
+
+    int written = 0;
+    switch (field.type) {
+        case PacketDescriptor::Field::INT8:
+            written = snprintf(out, outSize, "%d", readAt<int8_t>(data, field.offset));
+            break;
+        case PacketDescriptor::Field::UINT8:
+            written = snprintf(out, outSize, "%u", readAt<uint8_t>(data, field.offset));
+            break;
+        case PacketDescriptor::Field::INT16:
+            written = snprintf(out, outSize, "%d", readAt<int16_t>(data, field.offset));
+            break;
+        case PacketDescriptor::Field::UINT16:
+            written = snprintf(out, outSize, "%u", readAt<uint16_t>(data, field.offset));
+            break;
+        case PacketDescriptor::Field::INT32:
+            written = snprintf(out, outSize, "%ld", static_cast<long>(readAt<int32_t>(data, field.offset)));
+            break;
+        case PacketDescriptor::Field::UINT32:
+            written = snprintf(out, outSize, "%lu",
+                               static_cast<unsigned long>(readAt<uint32_t>(data, field.offset)));
+            break;
+        case PacketDescriptor::Field::FLOAT:
+            written = snprintf(out, outSize, "%.3f", readAt<float>(data, field.offset));
+            break;
+        case PacketDescriptor::Field::BOOL:
+            written = snprintf(out, outSize, "%s", data[field.offset] ? "true" : "false");
+            break;
+        case PacketDescriptor::Field::BYTE_ARRAY:
+        default: {
+            size_t pos = 0;
+            for (size_t i = 0; i < field.size && pos + 3 <= outSize; ++i) {
+                pos += snprintf(out + pos, outSize - pos, "%02X", data[field.offset + i]);
+            }
+            written = static_cast<int>(pos);
+            break;
+        }
+    }
+    if (written < 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    return static_cast<size_t>(written) < outSize ? static_cast<size_t>(written) : outSize - 1;
+}
+
+void PacketInspector::dump(Print& out) {
+    ILITEModule* module = PacketRouter::getInstance().getActiveModule();
+    const size_t count = typeCount(module);
+    if (count == 0) {
+        out.println("[Packets] No active module telemetry");
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
+        const PacketTypeStats& stats = stats_[i];
+        const TelemetryRate& rate = *TelemetryHealth::get(i);
+        out.printf("[Packets] %u %-12s 0x%08lX n=%lu %.1f/s size %u (%u-%u) int=%luus gap=%luus "
+                   "jitter avg=%lu max=%luus\n",
+                   static_cast<unsigned>(i), desc.name ? desc.name : "?",
+                   static_cast<unsigned long>(desc.magicNumber),
+                   static_cast<unsigned long>(stats.packets), TelemetryHealth::getRateHz(i),
+                   stats.lastSize, stats.minSize, stats.maxSize,
+                   static_cast<unsigned long>(rate.intervalAvgUs),
+                   static_cast<unsigned long>(rate.maxGapUs),
+                   static_cast<unsigned long>(stats.jitterAvgUs),
+                   static_cast<unsigned long>(stats.jitterMaxUs));
+        out.print("[Packets]   size:");
+        for (size_t b = 0; b < kPacketHistogramBuckets; ++b) {
+            out.printf(" %lu", static_cast<unsigned long>(stats.sizeHistogram[b]));
+        }
+        out.print("  jitter:");
+        for (size_t b = 0; b < kPacketHistogramBuckets; ++b) {
+            out.printf(" %lu", static_cast<unsigned long>(stats.jitterHistogram[b]));
+        }
+        out.println();
+    }
+}
@@ -6,7 +6,18 @@
 #include "PacketRouter.h"
 #include "ILITE.h"
 #include "ILITEHelpers.h"
+#include "LogChannels.h"
+#include "TelemetryTap.h"
+#include "BlackBox.h"
+#include "TelemetryStore.h"
+#include "PacketInspector.h"
+#include "TelemetryHealth.h"
+#include "ClockSync.h"
+#include "PacketBundle.h"
+#include "CommandStamp.h"
+#include "ModuleHandoff.h"
 #include <cstring>
+#include <utility>
 
 // Static instance pointer
 PacketRouter* PacketRouter::instance_ = nullptr;
@@ -16,19 +27,32 @@ PacketRouter* PacketRouter::instance_ = nullptr;
 // ============================================================================
 
 PacketRouter::PacketRouter()
-    : activeModule_(nullptr),
-      mutex_(nullptr),
+    : routeMutex_(nullptr),
+      configMutex_(nullptr),
+      active_(),
+      storeModule_(nullptr),
+      standbyModule_(nullptr),
+      moduleStandby_(false),
+      peerRoutes_(),
+      lastMissMagic_(0),
+      rxTimestampUs_(0),
+      sampleTimestampUs_(0),
       routedCount_(0),
       droppedCount_(0),
       errorCount_(0)
 {
     instance_ = this;
+    active_.primary = true;
 }
 
 PacketRouter::~PacketRouter() {
-    if (mutex_ != nullptr) {
-        vSemaphoreDelete(mutex_);
-        mutex_ = nullptr;
+    if (routeMutex_ != nullptr) {
+        vSemaphoreDelete(routeMutex_);
+        routeMutex_ = nullptr;
+    }
+    if (configMutex_ != nullptr) {
+        vSemaphoreDelete(configMutex_);
+        configMutex_ = nullptr;
     }
 }
 
@@ -42,14 +66,14 @@ PacketRouter& PacketRouter::getInstance() {
 // ============================================================================
 
 bool PacketRouter::begin() {
-    // Create mutex for thread safety
-    mutex_ = xSemaphoreCreateMutex();
-    if (mutex_ == nullptr) {
+    routeMutex_ = xSemaphoreCreateMutex();
+    configMutex_ = xSemaphoreCreateMutex();
+    if (routeMutex_ == nullptr || configMutex_ == nullptr) {
         Logger::getInstance().error("PacketRouter: Failed to create mutex");
         return false;
     }
 
-    Logger::getInstance().log("PacketRouter: Initialized");
+    ILITE_LOG(ROUTER, LOG_INFO, "PacketRouter: Initialized");
     return true;
 }
 
@@ -58,37 +82,118 @@ bool PacketRouter::begin() {
 // ============================================================================
 
 void PacketRouter::setActiveModule(ILITEModule* module) {
-    if (mutex_ == nullptr) {
+    if (configMutex_ == nullptr) {
         Logger::getInstance().error("PacketRouter: Not initialized (call begin() first)");
         return;
     }
 
-    // Lock for thread safety
-    if (xSemaphoreTake(mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
-        activeModule_ = module;
+    if (xSemaphoreTake(configMutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
+        // Packets for the previous module drop until the new table is live
+        retire(active_);
+        rebuildDispatchTable(active_, module);
+        active_.live.store(module != nullptr);
 
         if (module != nullptr) {
-            Logger::getInstance().logf("PacketRouter: Active module set to '%s'",
-                                      module->getModuleName());
+            ILITE_LOG(ROUTER, LOG_INFO, "PacketRouter: Active module set to '%s'",
+                      module->getModuleName());
         } else {
-            Logger::getInstance().log("PacketRouter: Active module cleared");
+            ILITE_LOG(ROUTER, LOG_INFO, "PacketRouter: Active module cleared");
         }
 
-        xSemaphoreGive(mutex_);
+        xSemaphoreGive(configMutex_);
     } else {
         Logger::getInstance().error("PacketRouter: Failed to acquire mutex in setActiveModule");
     }
 }
 
 ILITEModule* PacketRouter::getActiveModule() const {
-    return activeModule_;
+    return active_.live.load() ? active_.module : nullptr;
+}
+
+bool PacketRouter::setPeerModule(const uint8_t* mac, ILITEModule* module) {
+    if (mac == nullptr || configMutex_ == nullptr ||
+        xSemaphoreTake(configMutex_, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return false;
+    }
+
+    RouteTable* table = nullptr;
+    RouteTable* freeTable = nullptr;
+    for (RouteTable& route : peerRoutes_) {
+        if (route.used && memcmp(route.mac, mac, sizeof(route.mac)) == 0) {
+            table = &route;
+        } else if (!route.used && freeTable == nullptr) {
+            freeTable = &route;
+        }
+    }
+
+    bool ok = true;
+    if (table != nullptr) {
+        retire(*table);
+    }
+    if (module == nullptr) {
+        if (table != nullptr) {
+            rebuildDispatchTable(*table, nullptr);
+            table->used = false;
+        }
+    } else {
+        if (table == nullptr) {
+            table = freeTable;
+        }
+        if (table == nullptr) {
+            ok = false;
+        } else {
+            memcpy(table->mac, mac, sizeof(table->mac));
+            table->used = true;
+            rebuildDispatchTable(*table, module);
+            table->live.store(true);
+            ILITE_LOG(ROUTER, LOG_INFO, "PacketRouter: Peer route to '%s'",
+                      module->getModuleName());
+        }
+    }
+
+    xSemaphoreGive(configMutex_);
+    return ok;
+}
+
+void PacketRouter::retire(RouteTable& table) {
+    if (table.live.exchange(false)) {
+        ModuleHandoff::synchronize();
+    }
+}
+
+void PacketRouter::selectTelemetryBank(ILITEModule* module) {
+    // Unrouted in between (module switch): the slots stay as they are
+    if (module == nullptr || module == storeModule_) {
+        return;
+    }
+    TelemetryStore& store = TelemetryStore::getInstance();
+    if (moduleStandby_ && storeModule_ != nullptr) {
+        store.swapBanks();
+        std::swap(storeModule_, standbyModule_);
+    }
+    if (module != storeModule_) {
+        store.reset();
+        storeModule_ = module;
+    }
+}
+
+PacketRouter::RouteTable* PacketRouter::tableFor(const uint8_t* mac) {
+    if (mac != nullptr) {
+        for (RouteTable& route : peerRoutes_) {
+            if (route.live.load() && memcmp(route.mac, mac, sizeof(route.mac)) == 0) {
+                return &route;
+            }
+        }
+    }
+    return active_.live.load() ? &active_ : nullptr;
 }
 
 // ============================================================================
 // Packet Routing
 // ============================================================================
 
-bool PacketRouter::routePacket(const uint8_t* macAddr, const uint8_t* data, size_t length) {
+bool PacketRouter::routePacket(const uint8_t* macAddr, const uint8_t* data, size_t length,
+                               uint32_t timestampUs) {
     // Basic validation
     if (data == nullptr || length < 4) {
         // Packet too small to contain magic number
@@ -96,81 +201,253 @@ bool PacketRouter::routePacket(const uint8_t* macAddr, const uint8_t* data, size
         return false;
     }
 
-    // Lock for thread safety (ESP-NOW callbacks run in WiFi task)
-    if (mutex_ == nullptr || xSemaphoreTake(mutex_, pdMS_TO_TICKS(10)) != pdTRUE) {
-        // Couldn't acquire lock quickly - drop packet to avoid blocking ESP-NOW
-        droppedCount_++;
-        return false;
+    // Stamp echo from the robot: record latency, then route what it carries
+    CommandStampHeader echo;
+    size_t innerLength = 0;
+    const uint8_t* inner = unwrapStampedFrame(data, length, ECHO_PACKET_MAGIC, echo, innerLength);
+    if (inner != nullptr) {
+        CommandLatency::onEcho(echo);
+        data = inner;
+        length = innerLength;
+        if (length < 4) {
+            errorCount_++;
+            return false;
+        }
     }
 
-    bool routed = false;
-
-    // Check if we have an active module
-    if (activeModule_ != nullptr) {
-        routed = tryRouteToModule(activeModule_, data, length);
+    // Module switches never hold this; only a replay routing from CommTask
+    // can, and RxTask waiting just backs frames up in the receive ring
+    if (routeMutex_ == nullptr || xSemaphoreTake(routeMutex_, portMAX_DELAY) != pdTRUE) {
+        errorCount_++;
+        return false;
     }
 
-    // Update statistics
-    if (routed) {
-        routedCount_++;
+    bool routed = false;
+    rxTimestampUs_ = timestampUs != 0 ? timestampUs : micros();
+    RouteTable* table = tableFor(macAddr);
+
+    if (table != nullptr && isPacketBundle(data, length)) {
+        // Bundle frame: route each length-prefixed sub-packet on its own
+        struct BundleContext {
+            PacketRouter* router;
+            RouteTable* table;
+            bool anyRouted;
+        } context{this, table, false};
+
+        int count = forEachBundledPacket(data, length,
+            [](const uint8_t* packet, size_t packetLength, void* ctx) {
+                BundleContext* bundle = static_cast<BundleContext*>(ctx);
+                if (packetLength >= 4 &&
+                    bundle->router->tryRouteToModule(*bundle->table, packet, packetLength)) {
+                    bundle->router->routedCount_++;
+                    bundle->anyRouted = true;
+                } else {
+                    bundle->router->droppedCount_++;
+                }
+            },
+            &context);
+
+        if (count < 0) {
+            errorCount_++;
+        }
+        routed = context.anyRouted;
     } else {
-        droppedCount_++;
+        // Check if the source has a module
+        if (table != nullptr) {
+            routed = tryRouteToModule(*table, data, length);
+        }
+
+        // Update statistics
+        if (routed) {
+            routedCount_++;
+        } else {
+            droppedCount_++;
+        }
     }
 
-    xSemaphoreGive(mutex_);
+    xSemaphoreGive(routeMutex_);
     return routed;
 }
 
-bool PacketRouter::tryRouteToModule(ILITEModule* module, const uint8_t* data, size_t length) {
-    // Extract magic number from packet
-    uint32_t packetMagic = extractMagicNumber(data);
-
-    // Get telemetry packet count from module
-    size_t telemetryCount = module->getTelemetryPacketTypeCount();
-
-    // Try to match against each telemetry descriptor
-    for (size_t i = 0; i < telemetryCount; ++i) {
-        PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
-
-        // Check if magic number matches
-        if (desc.magicNumber != packetMagic) {
-            continue;  // Not this packet type
+bool PacketRouter::tryRouteToModule(RouteTable& table, const uint8_t* data, size_t length) {
+    ILITEModule* module = table.module;
+
+    // Extract magic number from packet (a delta frame names the one it carries)
+    const bool delta = isDeltaPacket(data, length);
+    uint32_t packetMagic = delta ? deltaPacketInnerMagic(data) : extractMagicNumber(data);
+
+    DispatchEntry* entry = lookup(table, packetMagic);
+    if (entry == nullptr) {
+        // Only log the first packet of each unknown magic in a row
+        if (packetMagic != lastMissMagic_) {
+            lastMissMagic_ = packetMagic;
+            ILITE_LOG_RATE(
+                ROUTER, LOG_WARN, 1, 3,
+                "PacketRouter: No match for magic 0x%08X in module '%s' (%u telemetry types)",
+                packetMagic, module->getModuleName(), static_cast<unsigned>(table.count)
+            );
         }
+        return false;
+    }
 
-        // Validate packet size
-        if (length < desc.minSize || length > desc.maxSize) {
-            Logger::getInstance().logf(
-                "PacketRouter: Size mismatch for '%s' packet type %zu (got %u, expected %u-%u)",
-                module->getModuleName(), i, length, desc.minSize, desc.maxSize
+    // Rebuild a delta frame into the full packet
+    uint8_t rebuilt[DeltaLayout::kMaxPacketSize];
+    if (delta) {
+        const size_t rebuiltLength = entry->deltaSlot == kNoDelta ? 0
+            : table.deltas[entry->deltaSlot].decode(data, length, rebuilt, sizeof(rebuilt));
+        if (rebuiltLength == 0) {
+            // Keyframe not seen yet (or not a delta-encoded type)
+            ILITE_LOG_RATE(
+                ROUTER, LOG_DEBUG, 1, 3,
+                "PacketRouter: Dropped delta frame for '%s' packet type %u",
+                module->getModuleName(), entry->typeIndex
             );
-            errorCount_++;
             return false;
         }
+        data = rebuilt;
+        length = rebuiltLength;
+    }
 
-        // Valid packet - route to module
-        module->handleTelemetry(i, data, length);
-        ILITEFramework::getInstance().onTelemetryReceived(module);
+    // Validate packet size
+    if (length < entry->minSize || length > entry->maxSize) {
+        ILITE_LOG_RATE(
+            ROUTER, LOG_WARN, 1, 3,
+            "PacketRouter: Size mismatch for '%s' packet type %u (got %u, expected %u-%u)",
+            module->getModuleName(), entry->typeIndex, static_cast<unsigned>(length),
+            entry->minSize, entry->maxSize
+        );
+        errorCount_++;
+        return false;
+    }
 
-        // Log first packet of each type (for debugging)
-        static uint32_t loggedTypes[8] = {0};  // Track first 8 types
-        if (i < 8 && loggedTypes[i] == 0) {
-            Logger::getInstance().logf(
-                "PacketRouter: First '%s' packet (type %zu, magic 0x%08X, %u bytes)",
-                desc.name, i, packetMagic, length
-            );
-            loggedTypes[i] = 1;
+    // Place the sample on our clock; a mapped time past the arrival is noise
+    sampleTimestampUs_ = rxTimestampUs_;
+    if (entry->timestampOffset >= 0 &&
+        static_cast<size_t>(entry->timestampOffset) + sizeof(uint32_t) <= length &&
+        ClockSync::isSynced()) {
+        uint32_t robotUs;
+        memcpy(&robotUs, data + entry->timestampOffset, sizeof(robotUs));
+        const uint32_t sampleUs = ClockSync::toLocalUs(robotUs);
+        if (static_cast<int32_t>(rxTimestampUs_ - sampleUs) > 0) {
+            sampleTimestampUs_ = sampleUs;
         }
+    }
+
+    // Valid packet - publish the framework copy, then notify the module
+    if (table.primary) {
+        TelemetryStore::getInstance().publish(entry->typeIndex, data, length);
+        const uint32_t intervalUs = TelemetryHealth::record(entry->typeIndex, packetMagic, rxTimestampUs_,
+                                                            sampleTimestampUs_);
+        PacketInspector::record(entry->typeIndex, length, intervalUs);
+    }
+    {
+        ModuleCall call(module, ModuleCallback::Telemetry);
+        module->handleTelemetry(entry->typeIndex, data, length);
+    }
+    if (table.primary) {
+        TelemetryTap::onTelemetry(entry->typeIndex, data, length, rxTimestampUs_);
+        BlackBox::onTelemetry(entry->typeIndex, data, length, rxTimestampUs_);
+    }
+    ILITEFramework::getInstance().onTelemetryReceived(module);
+    if (table.primary) {
+        ILITEFramework::getInstance().onControlTelemetry(module, entry->typeIndex);
+    }
+
+    // Log first packet of each type (for debugging)
+    if (!entry->logged) {
+        ILITE_LOG(
+            ROUTER, LOG_INFO,
+            "PacketRouter: First '%s' packet (type %u, magic 0x%08X, %u bytes)",
+            entry->name, entry->typeIndex, packetMagic, static_cast<unsigned>(length)
+        );
+        entry->logged = true;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Dispatch Table
+// ============================================================================
+
+size_t PacketRouter::hashMagic(uint32_t magic) {
+    // Fibonacci hashing spreads ASCII-tag magics ('TGST', 'TGAS', ...) well
+    return (magic * 2654435761u) >> 28;  // top 4 bits -> 16 slots
+}
+
+void PacketRouter::rebuildDispatchTable(RouteTable& table, ILITEModule* module) {
+    static_assert(kDispatchSlots == 16, "hashMagic() assumes 16 slots");
+
+    DispatchEntry* dispatch = table.dispatch;
+    for (size_t i = 0; i < kDispatchSlots; ++i) {
+        dispatch[i] = DispatchEntry{};
+    }
+    table.module = module;
+    table.count = 0;
+    table.deltaCount = 0;
+    lastMissMagic_ = 0;
+    if (table.primary) {
+        selectTelemetryBank(module);
+        TelemetryHealth::reset();
+        PacketInspector::reset();
+    }
 
-        return true;
+    if (module == nullptr) {
+        return;
     }
 
-    // No matching descriptor found
-    Logger::getInstance().logf(
-        "PacketRouter: No match for magic 0x%08X in module '%s' (%zu telemetry types)",
-        packetMagic, module->getModuleName(), telemetryCount
-    );
+    size_t telemetryCount = module->getTelemetryPacketTypeCount();
+    for (size_t i = 0; i < telemetryCount; ++i) {
+        if (table.count >= kDispatchSlots / 2) {
+            ILITE_LOG(ROUTER, LOG_WARN, "PacketRouter: Too many telemetry types, extra ignored");
+            break;
+        }
+
+        PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
+
+        // Linear probe from the home slot; skip duplicates (first descriptor wins)
+        size_t slot = hashMagic(desc.magicNumber);
+        while (dispatch[slot].used && dispatch[slot].magic != desc.magicNumber) {
+            slot = (slot + 1) & (kDispatchSlots - 1);
+        }
+        if (dispatch[slot].used) {
+            continue;
+        }
+
+        DispatchEntry& entry = dispatch[slot];
+        entry.magic = desc.magicNumber;
+        entry.minSize = static_cast<uint16_t>(desc.minSize);
+        entry.maxSize = static_cast<uint16_t>(desc.maxSize);
+        entry.typeIndex = static_cast<uint8_t>(i);
+        entry.deltaSlot = kNoDelta;
+        entry.timestampOffset = desc.timestampOffset;
+        if (desc.deltaEncoded) {
+            if (table.deltaCount < kMaxDeltaTypes && desc.maxSize <= DeltaLayout::kMaxPacketSize) {
+                entry.deltaSlot = static_cast<uint8_t>(table.deltaCount);
+                table.deltas[table.deltaCount++].configure(desc.fields, desc.fieldCount, desc.maxSize);
+            } else {
+                ILITE_LOG(ROUTER, LOG_WARN, "PacketRouter: '%s' cannot be delta-encoded, sent plain only",
+                          desc.name);
+            }
+        }
+        entry.used = true;
+        entry.logged = false;
+        entry.name = desc.name;
+        table.count++;
+    }
+}
 
-    return false;
+PacketRouter::DispatchEntry* PacketRouter::lookup(RouteTable& table, uint32_t magic) {
+    DispatchEntry* dispatch = table.dispatch;
+    size_t slot = hashMagic(magic);
+    // Table is at most half full, so a probe always reaches an empty slot
+    while (dispatch[slot].used) {
+        if (dispatch[slot].magic == magic) {
+            return &dispatch[slot];
+        }
+        slot = (slot + 1) & (kDispatchSlots - 1);
+    }
+    return nullptr;
 }
 
 uint32_t PacketRouter::extractMagicNumber(const uint8_t* data) {
@@ -184,6 +461,10 @@ uint32_t PacketRouter::extractMagicNumber(const uint8_t* data) {
 // Statistics
 // ============================================================================
 
+uint32_t PacketRouter::getSampleTimestampUs() const {
+    return sampleTimestampUs_;
+}
+
 uint32_t PacketRouter::getRoutedCount() const {
     return routedCount_;
 }
@@ -197,10 +478,10 @@ uint32_t PacketRouter::getErrorCount() const {
 }
 
 void PacketRouter::resetStats() {
-    if (mutex_ != nullptr && xSemaphoreTake(mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
+    if (routeMutex_ != nullptr && xSemaphoreTake(routeMutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
         routedCount_ = 0;
         droppedCount_ = 0;
         errorCount_ = 0;
-        xSemaphoreGive(mutex_);
+        xSemaphoreGive(routeMutex_);
     }
 }
@@ -0,0 +1,167 @@
+/**
+ * @file ParamSync.cpp
+ * @brief Coalescing, single-frame-in-flight parameter channel
+ */
+
+#include "ParamSync.h"
+
+ParamSync::ParamSync(SendFn send, uint32_t windowMs, uint32_t retryMs)
+    : send_(send),
+      windowMs_(windowMs),
+      retryMs_(retryMs),
+      lock_(portMUX_INITIALIZER_UNLOCKED),
+      values_{},
+      dirtyMask_(0),
+      inFlightMask_(0),
+      firstDirtyMs_(0),
+      refreshPending_(false),
+      awaiting_(false),
+      refreshInFlight_(false),
+      sequence_(0),
+      sentMs_(0),
+      backoffMs_(retryMs)
+{
+}
+
+// ============================================================================
+// Edits (any task)
+// ============================================================================
+
+void ParamSync::set(uint8_t id, float value) {
+    if (id >= kMaxParams) {
+        return;
+    }
+    const uint32_t bit = 1UL << id;
+    portENTER_CRITICAL(&lock_);
+    if (dirtyMask_ & bit) {
+        stats_.coalesced++;
+    } else if (dirtyMask_ == 0) {
+        firstDirtyMs_ = millis();
+    }
+    values_[id] = value;
+    dirtyMask_ |= bit;
+    stats_.edits++;
+    portEXIT_CRITICAL(&lock_);
+}
+
+void ParamSync::requestRefresh() {
+    portENTER_CRITICAL(&lock_);
+    refreshPending_ = true;
+    portEXIT_CRITICAL(&lock_);
+}
+
+// ============================================================================
+// Sending (one task)
+// ============================================================================
+
+void ParamSync::service(uint32_t nowMs) {
+    ParamValue values[kMaxParams];
+    size_t count = 0;
+    uint16_t sequence = 0;
+
+    portENTER_CRITICAL(&lock_);
+    uint32_t mask = 0;
+    bool resend = false;
+    if (awaiting_) {
+        if (nowMs - sentMs_ < backoffMs_) {
+            portEXIT_CRITICAL(&lock_);
+            return;
+        }
+        // Resend with the newest values; edits made meanwhile ride along
+        mask = inFlightMask_ | dirtyMask_;
+        resend = true;
+    } else if (dirtyMask_ != 0 && nowMs - firstDirtyMs_ >= windowMs_) {
+        mask = dirtyMask_;
+    } else if (refreshPending_) {
+        refreshPending_ = false;
+        refreshInFlight_ = true;
+    } else {
+        portEXIT_CRITICAL(&lock_);
+        return;
+    }
+
+    for (uint8_t id = 0; id < kMaxParams; ++id) {
+        if (mask & (1UL << id)) {
+            values[count++] = ParamValue{id, values_[id]};
+        }
+    }
+    if (count > 0) {
+        refreshInFlight_ = false;   // A set reply reports values too
+    }
+    sequence = ++sequence_;         // A reply to an older frame settles nothing
+    inFlightMask_ = mask;
+    dirtyMask_ = 0;
+    awaiting_ = true;
+    sentMs_ = nowMs;
+    backoffMs_ = resend ? (backoffMs_ * 2 > kMaxRetryMs ? kMaxRetryMs : backoffMs_ * 2) : retryMs_;
+    stats_.frames++;
+    if (resend) {
+        stats_.resends++;
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    // A failed send is left awaiting; the retry timer covers it
+    send_(sequence, values, count);
+}
+
+bool ParamSync::acknowledge(uint16_t sequence) {
+    portENTER_CRITICAL(&lock_);
+    const bool match = awaiting_ && sequence == sequence_;
+    if (match) {
+        awaiting_ = false;
+        inFlightMask_ = 0;
+        refreshInFlight_ = false;
+        stats_.acks++;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return match;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool ParamSync::isDirty(uint8_t id) const {
+    if (id >= kMaxParams) {
+        return false;
+    }
+    portENTER_CRITICAL(&lock_);
+    const bool dirty = (dirtyMask_ & (1UL << id)) != 0;
+    portEXIT_CRITICAL(&lock_);
+    return dirty;
+}
+
+bool ParamSync::isPending(uint8_t id) const {
+    if (id >= kMaxParams) {
+        return false;
+    }
+    portENTER_CRITICAL(&lock_);
+    const bool pending = ((dirtyMask_ | inFlightMask_) & (1UL << id)) != 0;
+    portEXIT_CRITICAL(&lock_);
+    return pending;
+}
+
+size_t ParamSync::getPendingCount() const {
+    portENTER_CRITICAL(&lock_);
+    const uint32_t mask = dirtyMask_ | inFlightMask_;
+    portEXIT_CRITICAL(&lock_);
+    return static_cast<size_t>(__builtin_popcount(mask));
+}
+
+ParamSyncStats ParamSync::getStats() const {
+    portENTER_CRITICAL(&lock_);
+    const ParamSyncStats stats = stats_;
+    portEXIT_CRITICAL(&lock_);
+    return stats;
+}
+
+void ParamSync::reset() {
+    portENTER_CRITICAL(&lock_);
+    dirtyMask_ = 0;
+    inFlightMask_ = 0;
+    refreshPending_ = false;
+    refreshInFlight_ = false;
+    awaiting_ = false;
+    backoffMs_ = retryMs_;
+    portEXIT_CRITICAL(&lock_);
+}
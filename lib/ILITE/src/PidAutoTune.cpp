@@ -0,0 +1,268 @@
+/**
+ * @file PidAutoTune.cpp
+ * @brief Step scheduling, incremental response analysis and gain rules
+ */
+
+#include "PidAutoTune.h"
+#include <math.h>
+
+namespace {
+
+// Crossings of the target need this much margin, so sensor noise around
+// the setpoint does not count as a lobe
+constexpr float kCrossBand = 0.03f;
+
+constexpr float kRiseLevel = 0.9f;
+constexpr float kKpRaise = 1.25f;
+constexpr float kKpRaiseNoResponse = 1.5f;
+constexpr float kKpLower = 0.8f;
+constexpr float kKdRaise = 1.3f;
+constexpr float kKdFromKp = 0.05f;          // First Kd when none is set
+constexpr float kKpStartFraction = 0.05f;   // First Kp when none is set
+
+}  // namespace
+
+// ============================================================================
+// Control
+// ============================================================================
+
+void PidAutoTune::start(const Gains& initial, float baseDeg, uint32_t nowMs) {
+    (void)nowMs;
+    initial_ = initial;
+    baseDeg_ = baseDeg;
+    setpointDeg_ = baseDeg;
+    steps_ = 0;
+    direction_ = 1.0f;
+    outcome_ = Outcome::None;
+    last_ = StepMetrics{};
+
+    Gains first = initial;
+    first.ki = 0.0f;
+    if (first.kp <= 0.0f) {
+        first.kp = config_.maxGains.kp * kKpStartFraction;
+    }
+    propose(first);
+    state_ = State::Apply;
+}
+
+void PidAutoTune::abort() {
+    if (isRunning()) {
+        fail(Outcome::Aborted);
+    }
+}
+
+void PidAutoTune::gainsApplied(uint32_t nowMs) {
+    if (state_ == State::Apply) {
+        beginSettle(nowMs);
+    }
+}
+
+bool PidAutoTune::takeProposal(Gains& out) {
+    if (!proposalReady_) {
+        return false;
+    }
+    out = proposal_;
+    proposalReady_ = false;
+    return true;
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void PidAutoTune::addSample(uint32_t nowMs, float actualDeg) {
+    if (!isRunning()) {
+        return;
+    }
+    if (fabsf(actualDeg - baseDeg_) > config_.limitDeg) {
+        fail(Outcome::Unstable);
+        return;
+    }
+
+    const uint32_t elapsedMs = nowMs - phaseStartMs_;
+    if (state_ == State::Settle) {
+        // Only the second half: the previous step is still decaying before
+        if (elapsedMs >= config_.settleMs / 2) {
+            zeroSum_ += actualDeg;
+            zeroCount_++;
+        }
+    } else if (state_ == State::Step) {
+        const float x = (actualDeg - zeroDeg_) / (direction_ * config_.stepDeg);
+        const float above = x - 1.0f;
+        StepMetrics& m = current_;
+        m.samples++;
+        m.reach = x > m.reach ? x : m.reach;
+        if (m.riseMs == 0.0f && x >= kRiseLevel) {
+            m.riseMs = static_cast<float>(elapsedMs > 0 ? elapsedMs : 1);
+        }
+
+        switch (lobe_) {
+            case Lobe::Rising:
+                if (above > kCrossBand) {
+                    lobe_ = Lobe::FirstPeak;
+                    firstCrossMs_ = nowMs;
+                    m.overshoot = above;
+                    m.peakMs = static_cast<float>(elapsedMs);
+                }
+                break;
+            case Lobe::FirstPeak:
+                if (above > m.overshoot) {
+                    m.overshoot = above;
+                    m.peakMs = static_cast<float>(elapsedMs);
+                } else if (above < -kCrossBand) {
+                    lobe_ = Lobe::Trough;
+                }
+                break;
+            case Lobe::Trough:
+                if (above > kCrossBand) {
+                    lobe_ = Lobe::SecondPeak;
+                    m.periodMs = static_cast<float>(nowMs - firstCrossMs_);
+                    m.secondPeak = above;
+                }
+                break;
+            case Lobe::SecondPeak:
+                if (above > m.secondPeak) {
+                    m.secondPeak = above;
+                } else if (above < -kCrossBand) {
+                    lobe_ = Lobe::Past;
+                }
+                break;
+            case Lobe::Past:
+                break;
+        }
+    }
+
+    update(nowMs);
+}
+
+void PidAutoTune::update(uint32_t nowMs) {
+    const uint32_t elapsedMs = nowMs - phaseStartMs_;
+    if (state_ == State::Settle && elapsedMs >= config_.settleMs) {
+        zeroDeg_ = zeroCount_ > 0 ? zeroSum_ / zeroCount_ : baseDeg_;
+        beginStep(nowMs);
+    } else if (state_ == State::Step && elapsedMs >= config_.stepMs) {
+        finishStep();
+    }
+}
+
+// ============================================================================
+// Phases
+// ============================================================================
+
+void PidAutoTune::beginSettle(uint32_t nowMs) {
+    state_ = State::Settle;
+    setpointDeg_ = baseDeg_;
+    phaseStartMs_ = nowMs;
+    zeroSum_ = 0.0f;
+    zeroCount_ = 0;
+}
+
+void PidAutoTune::beginStep(uint32_t nowMs) {
+    state_ = State::Step;
+    setpointDeg_ = baseDeg_ + direction_ * config_.stepDeg;
+    phaseStartMs_ = nowMs;
+    lobe_ = Lobe::Rising;
+    current_ = StepMetrics{};
+}
+
+void PidAutoTune::finishStep() {
+    last_ = current_;
+    steps_++;
+    direction_ = -direction_;
+    setpointDeg_ = baseDeg_;
+
+    const StepMetrics& m = last_;
+    const Gains& max = config_.maxGains;
+    Gains next = gains_;
+    bool converged = false;
+
+    if (m.reach < config_.minResponse) {
+        if (gains_.kp >= max.kp) {
+            fail(Outcome::NoResponse);
+            return;
+        }
+        next.kp *= kKpRaiseNoResponse;
+    } else if (m.overshoot > config_.overshootHigh) {
+        // Ringing is a phase margin problem more damping will not fix
+        const bool ringing = m.secondPeak > config_.ringDecay * m.overshoot;
+        if (ringing || gains_.kd >= max.kd) {
+            next.kp *= kKpLower;
+        } else {
+            next.kd = gains_.kd > 0.0f ? gains_.kd * kKdRaise : gains_.kp * kKdFromKp;
+        }
+    } else if (m.overshoot < config_.overshootLow && gains_.kp < max.kp) {
+        next.kp *= kKpRaise;
+    } else {
+        converged = true;
+    }
+
+    if (converged) {
+        // Ti = 2 x the oscillation period; half a period is about the peak time
+        const float periodMs = m.periodMs > 0.0f ? m.periodMs : 2.0f * m.peakMs;
+        if (periodMs > 0.0f) {
+            next.ki = next.kp / (2.0f * periodMs * 0.001f);
+        } else {
+            next.ki = initial_.ki;
+        }
+        propose(next);
+        outcome_ = Outcome::Converged;
+        state_ = State::Done;
+        return;
+    }
+
+    if (steps_ >= config_.maxSteps) {
+        fail(Outcome::StepLimit);
+        return;
+    }
+    propose(next);
+    state_ = State::Apply;
+}
+
+void PidAutoTune::propose(const Gains& gains) {
+    gains_.kp = clampGain(gains.kp, config_.maxGains.kp);
+    gains_.ki = clampGain(gains.ki, config_.maxGains.ki);
+    gains_.kd = clampGain(gains.kd, config_.maxGains.kd);
+    proposal_ = gains_;
+    proposalReady_ = true;
+}
+
+void PidAutoTune::fail(Outcome outcome) {
+    outcome_ = outcome;
+    state_ = State::Failed;
+    setpointDeg_ = baseDeg_;
+    gains_ = initial_;
+    proposal_ = initial_;
+    proposalReady_ = true;
+}
+
+float PidAutoTune::clampGain(float value, float max) const {
+    return value < 0.0f ? 0.0f : (value > max ? max : value);
+}
+
+// ============================================================================
+// Names
+// ============================================================================
+
+const char* PidAutoTune::stateName(State state) {
+    switch (state) {
+        case State::Idle: return "idle";
+        case State::Settle: return "settle";
+        case State::Step: return "step";
+        case State::Apply: return "apply";
+        case State::Done: return "done";
+        case State::Failed: return "failed";
+    }
+    return "?";
+}
+
+const char* PidAutoTune::outcomeName(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::None: return "none";
+        case Outcome::Converged: return "converged";
+        case Outcome::Unstable: return "unstable";
+        case Outcome::NoResponse: return "no response";
+        case Outcome::StepLimit: return "step limit";
+        case Outcome::Aborted: return "aborted";
+    }
+    return "?";
+}
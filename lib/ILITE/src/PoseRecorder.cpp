@@ -0,0 +1,521 @@
+/**
+ * @file PoseRecorder.cpp
+ * @brief Delta-encoded arm pose recording to a raw flash partition
+ */
+
+#include "PoseRecorder.h"
+#include "TaskMonitor.h"
+#include <cstring>
+
+static_assert(PoseRecorder::CHANNEL_COUNT <= 14, "Channel mask must fit a 2-byte varint");
+static_assert(sizeof(PoseRecorder::Frame) == PoseRecorder::CHANNEL_COUNT * sizeof(int16_t),
+              "Frame must be a plain channel array");
+
+namespace {
+
+constexpr uint32_t kWriterStackSize = 3072;
+constexpr UBaseType_t kWriterPriority = 1;
+constexpr BaseType_t kWriterCore = 0;
+constexpr uint32_t kMaxFrameDtMs = 60000;   // Longer pauses store an unchanged frame
+constexpr uint16_t kAllChannels = (1u << PoseRecorder::CHANNEL_COUNT) - 1;
+
+inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+inline uint8_t* writeVarint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+bool readVarint(const uint8_t*& in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 32 && in < end; shift += 7) {
+        const uint8_t byte = *in++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// ============================================================================
+// Singleton / Setup
+// ============================================================================
+
+PoseRecorder& PoseRecorder::getInstance() {
+    static PoseRecorder instance;
+    return instance;
+}
+
+PoseRecorder::PoseRecorder()
+    : partition_(nullptr),
+      blockCount_(0),
+      writerTask_(nullptr),
+      eraseAhead_(-1),
+      active_(0),
+      blockOpen_(false),
+      offset_(0),
+      lastFrameMs_(0),
+      lastSeenMs_(0),
+      sequence_(0),
+      droppedFrames_(0),
+      takeId_(0),
+      takeFirstSequence_(0),
+      takeBlocks_(0),
+      takeFrames_(0),
+      takeBytes_(0),
+      takeDurationMs_(0),
+      mapped_(nullptr),
+      mapHandle_(0),
+      playSequence_(0),
+      playCursor_(nullptr),
+      playEnd_(nullptr),
+      playClockMs_(0.0f),
+      playNextMs_(0),
+      playHavePending_(false),
+      playKeyFrame_(false),
+      speed_(1.0f),
+      state_(State::Idle)
+{
+    sealed_[0] = false;
+    sealed_[1] = false;
+    memset(&last_, 0, sizeof(last_));
+    memset(&playFrame_, 0, sizeof(playFrame_));
+}
+
+bool PoseRecorder::begin() {
+    if (isAvailable()) {
+        return true;
+    }
+
+    if (partition_ == nullptr) {
+        partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                              ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+        if (partition_ == nullptr || partition_->size < 2 * kBlockSize) {
+            partition_ = nullptr;
+            Serial.println("[PoseRecorder] No data partition for recordings");
+            return false;
+        }
+        blockCount_ = partition_->size / kBlockSize;
+        scanTake();
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        writerTask,
+        "PoseWriter",
+        kWriterStackSize,
+        this,
+        kWriterPriority,
+        &writerTask_,
+        kWriterCore
+    );
+    if (result != pdPASS) {
+        writerTask_ = nullptr;
+        Serial.println("[PoseRecorder] Failed to create writer task");
+        return false;
+    }
+    TaskMonitor::watch(writerTask_, kWriterStackSize, kWriterCore);
+
+    Serial.printf("[PoseRecorder] %lu blocks, take %lu: %lu frames, %.1f s\n",
+                  static_cast<unsigned long>(blockCount_),
+                  static_cast<unsigned long>(takeId_),
+                  static_cast<unsigned long>(takeFrames_),
+                  takeDurationMs_ * 0.001f);
+    return true;
+}
+
+void PoseRecorder::scanTake() {
+    takeBlocks_ = 0;
+    takeFrames_ = 0;
+    takeBytes_ = 0;
+    takeDurationMs_ = 0;
+    takeFirstSequence_ = 0;
+
+    // Newest take first, then its blocks
+    uint32_t newest = 0;
+    bool found = false;
+    BlockHeader header;
+    for (uint32_t sector = 0; sector < blockCount_; ++sector) {
+        if (esp_partition_read(partition_, sector * kBlockSize, &header, sizeof(header)) != ESP_OK) {
+            continue;
+        }
+        if (header.magic == kBlockMagic && (!found || header.takeId > newest)) {
+            newest = header.takeId;
+            found = true;
+        }
+    }
+    if (!found) {
+        return;
+    }
+    takeId_ = newest;
+
+    uint32_t first = UINT32_MAX;
+    for (uint32_t sector = 0; sector < blockCount_; ++sector) {
+        if (esp_partition_read(partition_, sector * kBlockSize, &header, sizeof(header)) != ESP_OK ||
+            header.magic != kBlockMagic || header.takeId != newest ||
+            sectorFor(header.sequence) != sector) {
+            continue;
+        }
+        if (header.sequence < first) first = header.sequence;
+        takeBlocks_++;
+        takeFrames_ += header.frameCount;
+        takeBytes_ += sizeof(BlockHeader) + header.payloadBytes;
+        takeDurationMs_ += header.durationMs;
+    }
+    takeFirstSequence_ = first;
+}
+
+// ============================================================================
+// Writer Task
+// ============================================================================
+
+void PoseRecorder::writerTask(void* param) {
+    static_cast<PoseRecorder*>(param)->writerLoop();
+}
+
+void PoseRecorder::writerLoop() {
+    int32_t erased = -1;    // Sector known to be blank
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        const int32_t requested = eraseAhead_.exchange(-1);
+        if (requested >= 0 && requested != erased &&
+            esp_partition_erase_range(partition_, requested * kBlockSize, kBlockSize) == ESP_OK) {
+            erased = requested;
+        }
+
+        // Older block first when both are waiting
+        uint8_t order[2] = {0, 1};
+        if (sealed_[0] && sealed_[1] && blocks_[1].header.sequence < blocks_[0].header.sequence) {
+            order[0] = 1;
+            order[1] = 0;
+        }
+        for (uint8_t index : order) {
+            if (!sealed_[index]) {
+                continue;
+            }
+            const Block& block = blocks_[index];
+            const int32_t sector = static_cast<int32_t>(sectorFor(block.header.sequence));
+            if (sector != erased) {
+                esp_partition_erase_range(partition_, sector * kBlockSize, kBlockSize);
+            }
+            const size_t length = (sizeof(BlockHeader) + block.header.payloadBytes + 3) & ~static_cast<size_t>(3);
+            esp_partition_write(partition_, sector * kBlockSize, &block, length);
+            erased = -1;
+            const uint32_t next = block.header.sequence + 1;
+            sealed_[index] = false;
+
+            // Blank the next sector now so the next write does not wait for it
+            if (state_ == State::Recording) {
+                const int32_t nextSector = static_cast<int32_t>(sectorFor(next));
+                if (esp_partition_erase_range(partition_, nextSector * kBlockSize, kBlockSize) == ESP_OK) {
+                    erased = nextSector;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Recording (control loop)
+// ============================================================================
+
+bool PoseRecorder::startRecording() {
+    if (state_ != State::Idle || (!isAvailable() && !begin())) {
+        return false;
+    }
+    if (sealed_[0] || sealed_[1]) {
+        return false;   // Previous take still being written
+    }
+
+    takeId_++;
+    takeBlocks_ = 0;
+    takeFrames_ = 0;
+    takeBytes_ = 0;
+    takeDurationMs_ = 0;
+    takeFirstSequence_ = 0;
+    sequence_ = 0;
+    droppedFrames_ = 0;
+    lastFrameMs_ = 0;
+    lastSeenMs_ = 0;
+    memset(&last_, 0, sizeof(last_));
+    beginBlock(0);
+
+    state_ = State::Recording;
+    eraseAhead_ = static_cast<int32_t>(sectorFor(0));
+    xTaskNotifyGive(writerTask_);
+    Serial.printf("[PoseRecorder] Recording take %lu\n", static_cast<unsigned long>(takeId_));
+    return true;
+}
+
+void PoseRecorder::stopRecording() {
+    if (state_ != State::Recording) {
+        return;
+    }
+    // Keep a trailing hold: store the last pose again with the time since
+    if (lastFrameMs_ != 0 && lastSeenMs_ != lastFrameMs_) {
+        store(last_, lastSeenMs_);
+    }
+    if (blockOpen_ && blocks_[active_].header.frameCount > 0) {
+        sealActive();
+    }
+    blockOpen_ = false;
+    state_ = State::Idle;
+
+    takeFirstSequence_ = sequence_ > blockCount_ ? sequence_ - blockCount_ : 0;
+    takeBlocks_ = sequence_ - takeFirstSequence_;
+    Serial.printf("[PoseRecorder] Take %lu: %lu frames, %lu bytes, %.1f s, %lu dropped\n",
+                  static_cast<unsigned long>(takeId_),
+                  static_cast<unsigned long>(takeFrames_),
+                  static_cast<unsigned long>(takeBytes_),
+                  takeDurationMs_ * 0.001f,
+                  static_cast<unsigned long>(droppedFrames_));
+}
+
+void PoseRecorder::beginBlock(uint32_t sequence) {
+    Block& block = blocks_[active_];
+    block.header.magic = kBlockMagic;
+    block.header.takeId = takeId_;
+    block.header.sequence = sequence;
+    block.header.payloadBytes = 0;
+    block.header.frameCount = 0;
+    block.header.durationMs = 0;
+    offset_ = 0;
+    blockOpen_ = true;
+}
+
+bool PoseRecorder::sealActive() {
+    const BlockHeader& header = blocks_[active_].header;
+    takeBytes_ += sizeof(BlockHeader) + header.payloadBytes;
+    sealed_[active_] = true;
+    xTaskNotifyGive(writerTask_);
+    active_ ^= 1;
+    blockOpen_ = false;
+    sequence_++;
+    return true;
+}
+
+void PoseRecorder::encodeFrame(const Frame& frame, uint32_t dtMs, bool keyFrame) {
+    Block& block = blocks_[active_];
+    uint8_t* out = block.payload + offset_;
+
+    uint16_t mask = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        if (keyFrame || frame.value[i] != last_.value[i]) {
+            mask |= static_cast<uint16_t>(1u << i);
+        }
+    }
+    out = writeVarint(out, dtMs);
+    out = writeVarint(out, mask);
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        if (mask & (1u << i)) {
+            const int32_t base = keyFrame ? 0 : last_.value[i];
+            out = writeVarint(out, zigzag(static_cast<int32_t>(frame.value[i]) - base));
+        }
+    }
+
+    offset_ = static_cast<size_t>(out - block.payload);
+    block.header.payloadBytes = static_cast<uint16_t>(offset_);
+    block.header.frameCount++;
+    block.header.durationMs += dtMs;
+    takeFrames_++;
+    takeDurationMs_ += dtMs;
+    last_ = frame;
+}
+
+void PoseRecorder::record(const Frame& frame, uint32_t nowMs) {
+    if (state_ != State::Recording) {
+        return;
+    }
+    lastSeenMs_ = nowMs;
+    if (blockOpen_ && lastFrameMs_ != 0 && nowMs - lastFrameMs_ < kMaxFrameDtMs &&
+        memcmp(&frame, &last_, sizeof(Frame)) == 0) {
+        return;     // Unchanged: time folds into the next stored frame
+    }
+    store(frame, nowMs);
+}
+
+void PoseRecorder::store(const Frame& frame, uint32_t nowMs) {
+    uint32_t dtMs = lastFrameMs_ != 0 ? nowMs - lastFrameMs_ : 0;
+    if (dtMs > kMaxFrameDtMs) {
+        dtMs = kMaxFrameDtMs;
+    }
+
+    if (blockOpen_ && offset_ + kMaxFrameBytes > kPayloadSize) {
+        sealActive();
+    }
+    bool keyFrame = false;
+    if (!blockOpen_) {
+        if (sealed_[active_]) {
+            droppedFrames_++;   // Writer is behind; the next frame's dt covers the gap
+            return;
+        }
+        beginBlock(sequence_);
+        keyFrame = true;
+    }
+    if (blocks_[active_].header.frameCount == 0) {
+        keyFrame = true;
+    }
+
+    encodeFrame(frame, dtMs, keyFrame);
+    lastFrameMs_ = nowMs != 0 ? nowMs : 1;
+}
+
+// ============================================================================
+// Playback (control loop)
+// ============================================================================
+
+bool PoseRecorder::startPlayback(float speed) {
+    if (state_ != State::Idle || (!isAvailable() && !begin())) {
+        return false;
+    }
+    if (sealed_[0] || sealed_[1]) {
+        Serial.println("[PoseRecorder] Take still being saved");
+        return false;
+    }
+    scanTake();
+    if (takeBlocks_ == 0) {
+        Serial.println("[PoseRecorder] No take recorded");
+        return false;
+    }
+
+    if (mapped_ == nullptr &&
+        esp_partition_mmap(partition_, 0, partition_->size, SPI_FLASH_MMAP_DATA,
+                           &mapped_, &mapHandle_) != ESP_OK) {
+        mapped_ = nullptr;
+        Serial.println("[PoseRecorder] Failed to map partition");
+        return false;
+    }
+
+    playSequence_ = takeFirstSequence_;
+    if (!openPlaybackBlock()) {
+        stopPlayback();
+        return false;
+    }
+    // The first frame plays at once whatever dt it was recorded with
+    uint32_t ignored = 0;
+    readVarint(playCursor_, playEnd_, ignored);
+    playHavePending_ = true;
+    playNextMs_ = 0;
+    playClockMs_ = 0.0f;
+    setPlaybackSpeed(speed);
+    state_ = State::Playing;
+    Serial.printf("[PoseRecorder] Playing take %lu at %.2fx\n",
+                  static_cast<unsigned long>(takeId_), speed_);
+    return true;
+}
+
+void PoseRecorder::stopPlayback() {
+    if (mapped_ != nullptr) {
+        spi_flash_munmap(mapHandle_);
+        mapped_ = nullptr;
+    }
+    playCursor_ = nullptr;
+    playEnd_ = nullptr;
+    if (state_ == State::Playing) {
+        state_ = State::Idle;
+    }
+}
+
+void PoseRecorder::setPlaybackSpeed(float speed) {
+    speed_ = constrain(speed, kMinSpeed, kMaxSpeed);
+}
+
+bool PoseRecorder::openPlaybackBlock() {
+    if (playSequence_ >= takeFirstSequence_ + takeBlocks_) {
+        return false;
+    }
+    const uint8_t* base = static_cast<const uint8_t*>(mapped_) + sectorFor(playSequence_) * kBlockSize;
+    BlockHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (header.magic != kBlockMagic || header.takeId != takeId_ ||
+        header.sequence != playSequence_ || header.payloadBytes > kPayloadSize) {
+        return false;
+    }
+    playCursor_ = base + sizeof(BlockHeader);
+    playEnd_ = playCursor_ + header.payloadBytes;
+    playKeyFrame_ = true;
+    return true;
+}
+
+bool PoseRecorder::advance(float dtSeconds, Frame& frame) {
+    if (state_ != State::Playing) {
+        frame = playFrame_;
+        return false;
+    }
+    playClockMs_ += dtSeconds * 1000.0f * speed_;
+
+    for (;;) {
+        if (!playHavePending_) {
+            if (playCursor_ >= playEnd_) {
+                playSequence_++;
+                if (!openPlaybackBlock()) {
+                    break;
+                }
+            }
+            uint32_t dtMs = 0;
+            if (!readVarint(playCursor_, playEnd_, dtMs)) {
+                break;
+            }
+            playNextMs_ += dtMs;
+            playHavePending_ = true;
+        }
+        if (static_cast<float>(playNextMs_) > playClockMs_) {
+            frame = playFrame_;
+            return true;
+        }
+
+        uint32_t mask = 0;
+        if (!readVarint(playCursor_, playEnd_, mask)) {
+            break;
+        }
+        if (playKeyFrame_) {
+            memset(&playFrame_, 0, sizeof(playFrame_));
+            playKeyFrame_ = false;
+        }
+        for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+            uint32_t delta = 0;
+            if ((mask & (1u << i)) && readVarint(playCursor_, playEnd_, delta)) {
+                playFrame_.value[i] = static_cast<int16_t>(playFrame_.value[i] + unzigzag(delta));
+            }
+        }
+        playHavePending_ = false;
+    }
+
+    // End of take (or a damaged block): hold the last pose
+    frame = playFrame_;
+    stopPlayback();
+    return false;
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+void PoseRecorder::dump(Print& out) const {
+    static const char* const kStateNames[] = {"idle", "recording", "playing"};
+    out.printf("[PoseRecorder] %s, take %lu: %lu frames, %lu bytes, %.1f s, %lu blocks of %lu\n",
+               kStateNames[static_cast<uint8_t>(state_)],
+               static_cast<unsigned long>(takeId_),
+               static_cast<unsigned long>(takeFrames_),
+               static_cast<unsigned long>(takeBytes_),
+               takeDurationMs_ * 0.001f,
+               static_cast<unsigned long>(takeBlocks_),
+               static_cast<unsigned long>(blockCount_));
+    if (droppedFrames_ != 0) {
+        out.printf("  %lu frames dropped while the writer was busy\n",
+                   static_cast<unsigned long>(droppedFrames_));
+    }
+}
@@ -0,0 +1,245 @@
+/**
+ * @file PowerManager.cpp
+ * @brief Power management locks, fallback clock switching and idle tracking
+ */
+
+#include "PowerManager.h"
+#include "input.h"
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include <soc/gpio_struct.h>
+#include <math.h>
+
+std::atomic<bool> PowerManager::idle_{false};
+std::atomic<bool> PowerManager::wakePending_{false};
+TaskHandle_t PowerManager::wakeTask_ = nullptr;
+bool PowerManager::scaling_ = false;
+
+namespace {
+
+esp_pm_lock_handle_t cpuLock = nullptr;
+esp_pm_lock_handle_t noSleepLock = nullptr;
+bool cpuLockHeld = false;
+bool noSleepLockHeld = false;
+bool lightSleepAllowed = false;
+std::atomic<bool> wakePinsArmed{false};   // Cleared by the first wake interrupt
+bool started = false;
+uint16_t maxMhz = 240;
+uint16_t minMhz = 80;
+uint32_t idleTimeout = 0;
+
+// Activity tracking (CommTask)
+uint32_t lastActivityMs = 0;
+int lastEncoderCount = 0;
+float lastPot = -1.0f;
+
+// Time per state, for dump()
+uint32_t stateSinceMs = 0;
+uint32_t activeMs = 0;
+uint32_t idleMs = 0;
+uint32_t idleEntries = 0;
+
+// GPIO wake sources and the interrupt type each pin has while awake.
+// gpio_wakeup_enable() turns a pin's interrupt into a level interrupt, so
+// the wake sources are armed only while light sleep is allowed, and the
+// first interrupt after waking puts the edges back (wakeFromPinIsr()).
+// Armed pins are written by the ISR too, so arming sets the flag first.
+struct WakePin {
+    uint8_t pin;
+    gpio_int_type_t awakeType;
+};
+
+constexpr WakePin kWakePins[] = {
+    {button1, GPIO_INTR_DISABLE},
+    {button2, GPIO_INTR_DISABLE},
+    {button3, GPIO_INTR_DISABLE},
+    {joystickBtnA, GPIO_INTR_DISABLE},
+    {joystickBtnB, GPIO_INTR_DISABLE},
+    {encoderBtn, GPIO_INTR_POSEDGE},    // InputManager's RISING handler
+    {encoderA, GPIO_INTR_ANYEDGE},      // EncoderSampler's CHANGE handlers
+    {encoderB, GPIO_INTR_ANYEDGE},
+};
+
+void armWakePins() {
+    wakePinsArmed.store(true, std::memory_order_release);
+    for (const WakePin& wake : kWakePins) {
+        const gpio_num_t gpio = static_cast<gpio_num_t>(wake.pin);
+        if (wake.pin == encoderA || wake.pin == encoderB) {
+            // PCNT stops counting in light sleep: wake when the encoder
+            // leaves the detent it is resting in
+            gpio_wakeup_enable(gpio, gpio_get_level(gpio) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+        } else {
+            gpio_wakeup_enable(gpio, GPIO_INTR_LOW_LEVEL);   // Buttons are active-low
+        }
+    }
+}
+
+void disarmWakePins() {
+    for (const WakePin& wake : kWakePins) {
+        const gpio_num_t gpio = static_cast<gpio_num_t>(wake.pin);
+        gpio_wakeup_disable(gpio);
+        gpio_set_intr_type(gpio, wake.awakeType);
+    }
+}
+
+bool hasActivity(const InputSnapshot& snapshot) {
+    bool active = snapshot.buttons != 0 || snapshot.encoderCount != lastEncoderCount;
+    active = active || fabsf(snapshot.joystickA_X) > PowerManager::kStickActivity
+                    || fabsf(snapshot.joystickA_Y) > PowerManager::kStickActivity
+                    || fabsf(snapshot.joystickB_X) > PowerManager::kStickActivity
+                    || fabsf(snapshot.joystickB_Y) > PowerManager::kStickActivity;
+    if (lastPot >= 0.0f && fabsf(snapshot.potentiometer - lastPot) > PowerManager::kPotActivity) {
+        active = true;
+    }
+    if (active || lastPot < 0.0f) {
+        lastPot = snapshot.potentiometer;   // Reference for slow drift
+    }
+    lastEncoderCount = snapshot.encoderCount;
+    return active;
+}
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool PowerManager::begin(uint16_t cpuMaxMhz, uint16_t cpuMinMhz, bool lightSleep, uint32_t idleTimeoutMs) {
+    maxMhz = cpuMaxMhz;
+    minMhz = cpuMinMhz < cpuMaxMhz ? cpuMinMhz : cpuMaxMhz;
+    idleTimeout = idleTimeoutMs;
+    lastActivityMs = millis();
+    stateSinceMs = lastActivityMs;
+
+    esp_pm_config_esp32_t pmConfig = {};
+    pmConfig.max_freq_mhz = maxMhz;
+    pmConfig.min_freq_mhz = minMhz;
+    pmConfig.light_sleep_enable = lightSleep;
+    scaling_ = esp_pm_configure(&pmConfig) == ESP_OK &&
+               esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ilite_cpu", &cpuLock) == ESP_OK &&
+               esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "ilite_awake", &noSleepLock) == ESP_OK;
+    lightSleepAllowed = scaling_ && lightSleep;
+
+    if (lightSleepAllowed) {
+        // The pins themselves are armed in applyLocks(), right before sleep
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    started = true;
+    applyLocks(false);
+    Serial.printf("[Power] %s, %u-%u MHz, light sleep %s\n",
+                  scaling_ ? "DFS" : "fallback clock switching", minMhz, maxMhz,
+                  lightSleepAllowed ? "on" : "off");
+    return scaling_;
+}
+
+void PowerManager::applyLocks(bool paired) {
+    const bool fullSpeed = paired || !isIdle();
+    const bool stayAwake = !lightSleepAllowed || fullSpeed;
+
+    if (!scaling_) {
+        if (fullSpeed != cpuLockHeld) {
+            setCpuFrequencyMhz(fullSpeed ? maxMhz : minMhz);
+            cpuLockHeld = fullSpeed;
+        }
+        return;
+    }
+    if (fullSpeed != cpuLockHeld) {
+        fullSpeed ? esp_pm_lock_acquire(cpuLock) : esp_pm_lock_release(cpuLock);
+        cpuLockHeld = fullSpeed;
+    }
+    if (stayAwake != noSleepLockHeld) {
+        if (stayAwake) {
+            esp_pm_lock_acquire(noSleepLock);
+            if (wakePinsArmed.exchange(false, std::memory_order_acq_rel)) {
+                disarmWakePins();
+            }
+        } else {
+            if (lightSleepAllowed) {
+                armWakePins();
+            }
+            esp_pm_lock_release(noSleepLock);
+        }
+        noSleepLockHeld = stayAwake;
+    }
+}
+
+// ============================================================================
+// State
+// ============================================================================
+
+bool PowerManager::update(const InputSnapshot& snapshot, bool paired, uint32_t nowMs) {
+    if (!started) {
+        return false;
+    }
+
+    const bool woken = wakePending_.exchange(false, std::memory_order_acq_rel);
+    if (hasActivity(snapshot) || woken) {
+        lastActivityMs = nowMs;
+    }
+
+    const bool wasIdle = isIdle();
+    const bool nowIdle = idleTimeout != 0 && nowMs - lastActivityMs >= idleTimeout;
+    if (nowIdle != wasIdle) {
+        (wasIdle ? idleMs : activeMs) += nowMs - stateSinceMs;
+        stateSinceMs = nowMs;
+        if (nowIdle) {
+            idleEntries++;
+        }
+        idle_.store(nowIdle, std::memory_order_relaxed);
+    }
+    applyLocks(paired);
+    return nowIdle != wasIdle;
+}
+
+void PowerManager::wake() {
+    if (!isIdle() || wakePending_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (wakeTask_ != nullptr) {
+        xTaskNotifyGive(wakeTask_);
+    }
+}
+
+void IRAM_ATTR PowerManager::wakeFromIsr() {
+    if (!idle_.load(std::memory_order_relaxed) || wakePending_.exchange(true)) {
+        return;
+    }
+    if (wakeTask_ != nullptr) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(wakeTask_, &woken);
+        if (woken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+bool IRAM_ATTR PowerManager::wakeFromPinIsr() {
+    if (!wakePinsArmed.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    // Level interrupt from an armed pin: it keeps firing until the pin
+    // returns to its edge type. gpio_set_intr_type() is not ISR-safe.
+    for (const WakePin& wake : kWakePins) {
+        const gpio_num_t gpio = static_cast<gpio_num_t>(wake.pin);
+        gpio_ll_wakeup_disable(&GPIO, gpio);
+        gpio_ll_set_intr_type(&GPIO, gpio, wake.awakeType);
+    }
+    wakeFromIsr();
+    return true;
+}
+
+void PowerManager::dump(Print& out) {
+    const uint32_t now = millis();
+    const uint32_t current = now - stateSinceMs;
+    out.printf("[Power] %s at %lu MHz (%s, light sleep %s)\n",
+               isIdle() ? "idle" : "active", static_cast<unsigned long>(getCpuFrequencyMhz()),
+               scaling_ ? "DFS" : "fallback", lightSleepAllowed ? "on" : "off");
+    out.printf("[Power] active %lus, idle %lus (%lu times), idle after %lus without input\n",
+               static_cast<unsigned long>((activeMs + (isIdle() ? 0 : current)) / 1000),
+               static_cast<unsigned long>((idleMs + (isIdle() ? current : 0)) / 1000),
+               static_cast<unsigned long>(idleEntries),
+               static_cast<unsigned long>(idleTimeout / 1000));
+}
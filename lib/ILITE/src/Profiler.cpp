@@ -0,0 +1,287 @@
+/**
+ * @file Profiler.cpp
+ * @brief Zone timing storage, statistics and the profiler screen
+ */
+
+#include "Profiler.h"
+#include "ScreenRegistry.h"
+#include "ILITE.h"
+#include "ModuleBudget.h"
+#include <algorithm>
+#include <cstring>
+
+Profiler::Zone Profiler::zones_[Profiler::kZoneCount];
+bool Profiler::enabled_ = true;
+
+namespace {
+
+const char* const kZoneNames[Profiler::kZoneCount] = {
+    "frame",
+    "render",
+    "modDraw",
+    "sendBuf",
+    "comm",
+    "control",
+    "prepCmd",
+    "c.read",
+    "c.intent",
+    "c.kin",
+    "c.pack",
+    "modSvc"
+};
+
+// "850u" below a millisecond, "12.3m" above
+void formatDuration(char* buffer, size_t size, uint32_t us) {
+    if (us < 1000) {
+        snprintf(buffer, size, "%luu", static_cast<unsigned long>(us));
+    } else {
+        snprintf(buffer, size, "%lu.%lum",
+                 static_cast<unsigned long>(us / 1000),
+                 static_cast<unsigned long>((us % 1000) / 100));
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void Profiler::record(ProfileZone zone, uint32_t elapsedCycles) {
+    if (!enabled_ || zone >= ProfileZone::Count) {
+        return;
+    }
+    const uint32_t mhz = getCpuFrequencyMhz();
+    Zone& z = zones_[static_cast<size_t>(zone)];
+    z.samples[z.head & (kWindow - 1)] = mhz ? elapsedCycles / mhz : elapsedCycles;
+    z.head++;
+}
+
+void Profiler::accumulate(ProfileZone zone, uint32_t elapsedCycles) {
+    if (!enabled_ || zone >= ProfileZone::Count) {
+        return;
+    }
+    Zone& z = zones_[static_cast<size_t>(zone)];
+    z.pending += elapsedCycles;
+    z.hasPending = true;
+}
+
+void Profiler::commit(ProfileZone zone) {
+    if (zone >= ProfileZone::Count) {
+        return;
+    }
+    Zone& z = zones_[static_cast<size_t>(zone)];
+    if (!z.hasPending) {
+        return;
+    }
+    const uint32_t pending = z.pending;
+    z.pending = 0;
+    z.hasPending = false;
+    record(zone, pending);
+}
+
+void Profiler::reset() {
+    memset(zones_, 0, sizeof(zones_));
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+ProfileStats Profiler::getStats(ProfileZone zone) {
+    ProfileStats stats;
+    if (zone >= ProfileZone::Count) {
+        return stats;
+    }
+
+    const Zone& z = zones_[static_cast<size_t>(zone)];
+    const uint32_t head = z.head;
+    const size_t count = head < kWindow ? head : kWindow;
+    if (count == 0) {
+        return stats;
+    }
+
+    uint32_t window[kWindow];
+    uint64_t sum = 0;
+    stats.minUs = UINT32_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t us = z.samples[(head - 1 - i) & (kWindow - 1)];
+        window[i] = us;
+        sum += us;
+        if (us < stats.minUs) stats.minUs = us;
+        if (us > stats.maxUs) stats.maxUs = us;
+    }
+
+    // Nearest-rank 99th percentile
+    const size_t rank = (count * 99 + 99) / 100 - 1;
+    std::nth_element(window, window + rank, window + count);
+
+    stats.p99Us = window[rank];
+    stats.avgUs = static_cast<uint32_t>(sum / count);
+    stats.lastUs = z.samples[(head - 1) & (kWindow - 1)];
+    stats.samples = static_cast<uint16_t>(count);
+    stats.total = head;
+    return stats;
+}
+
+const char* Profiler::getZoneName(ProfileZone zone) {
+    if (zone >= ProfileZone::Count) {
+        return "?";
+    }
+    return kZoneNames[static_cast<size_t>(zone)];
+}
+
+void Profiler::dump(Print& out) {
+    out.printf("[Profiler] window=%u samples, us\n", static_cast<unsigned>(kWindow));
+    out.println("zone        n      min      avg      p99      max");
+    for (size_t i = 0; i < kZoneCount; ++i) {
+        const ProfileZone zone = static_cast<ProfileZone>(i);
+        const ProfileStats stats = getStats(zone);
+        out.printf("%-8s %4u %8lu %8lu %8lu %8lu\n",
+                   getZoneName(zone),
+                   static_cast<unsigned>(stats.samples),
+                   static_cast<unsigned long>(stats.minUs),
+                   static_cast<unsigned long>(stats.avgUs),
+                   static_cast<unsigned long>(stats.p99Us),
+                   static_cast<unsigned long>(stats.maxUs));
+    }
+}
+
+// ============================================================================
+// Screen
+// ============================================================================
+
+namespace {
+
+constexpr size_t kScreenRows = 7;   // Zone rows between the header and the footer
+size_t screenFirstZone = 0;         // B2 pages through the zones, then the modules
+
+// Last page: each timed module's average draw, control and service call
+void drawModulePage(DisplayCanvas& canvas) {
+    canvas.drawTextF(0, 6, "Modules  budgets %s",
+                     ModuleBudget::getPolicy() == ModuleBudgetPolicy::Off ? "off" : "on");
+    canvas.drawLine(0, 8, 127, 8);
+    canvas.drawText(40, 14, "draw");
+    canvas.drawText(68, 14, "ctl");
+    canvas.drawText(96, 14, "svc");
+
+    static const ModuleCallback kColumns[] = {
+        ModuleCallback::Draw, ModuleCallback::Control, ModuleCallback::Service
+    };
+    char text[12];
+    int16_t y = 21;
+    size_t rows = 0;
+    for (size_t slot = 0; slot < ModuleBudget::kMaxModules && rows < kScreenRows; ++slot) {
+        const ILITEModule* module = ModuleBudget::getModule(slot);
+        if (module == nullptr) {
+            continue;
+        }
+        // Name cut to the first column; '*' while a callback is throttled
+        bool throttled = false;
+        for (size_t i = 0; i < ModuleBudget::kCallbackCount; ++i) {
+            throttled = throttled || ModuleBudget::getStats(slot, static_cast<ModuleCallback>(i)).throttled;
+        }
+        snprintf(text, 10, "%s", module->getModuleName());
+        if (throttled) {
+            strncat(text, "*", sizeof(text) - strlen(text) - 1);
+        }
+        canvas.drawText(0, y, text);
+        int16_t x = 40;
+        for (ModuleCallback callback : kColumns) {
+            const ModuleCallbackStats stats = ModuleBudget::getStats(slot, callback);
+            if (stats.calls == 0) {
+                canvas.drawText(x, y, "-");
+            } else {
+                formatDuration(text, sizeof(text), stats.avgUs);
+                canvas.drawText(x, y, text);
+            }
+            x += 28;
+        }
+        y += 6;
+        rows++;
+    }
+    if (rows == 0) {
+        canvas.drawText(0, y, "No module called yet");
+    }
+}
+
+void drawProfilerScreen(DisplayCanvas& canvas) {
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+    if (screenFirstZone >= Profiler::kZoneCount) {
+        drawModulePage(canvas);
+        canvas.drawText(0, 63, "B1:Back B2:More B3:Reset");
+        return;
+    }
+
+    const ILITEConfig& config = ILITE.getConfig();
+    const uint32_t budgetMs = config.displayRefreshHz ? 1000 / config.displayRefreshHz : 0;
+    canvas.drawTextF(0, 6, "Profiler  %lums budget", static_cast<unsigned long>(budgetMs));
+    canvas.drawLine(0, 8, 127, 8);
+
+    canvas.drawText(40, 14, "avg");
+    canvas.drawText(68, 14, "p99");
+    canvas.drawText(96, 14, "max");
+
+    char text[12];
+    int16_t y = 21;
+    const size_t last = screenFirstZone + kScreenRows < Profiler::kZoneCount
+                            ? screenFirstZone + kScreenRows
+                            : Profiler::kZoneCount;
+    for (size_t i = screenFirstZone; i < last; ++i, y += 6) {
+        const ProfileZone zone = static_cast<ProfileZone>(i);
+        const ProfileStats stats = Profiler::getStats(zone);
+        canvas.drawText(0, y, Profiler::getZoneName(zone));
+        if (stats.samples == 0) {
+            canvas.drawText(40, y, "-");
+            continue;
+        }
+        formatDuration(text, sizeof(text), stats.avgUs);
+        canvas.drawText(40, y, text);
+        formatDuration(text, sizeof(text), stats.p99Us);
+        canvas.drawText(68, y, text);
+        formatDuration(text, sizeof(text), stats.maxUs);
+        canvas.drawText(96, y, text);
+    }
+
+    canvas.drawText(0, 63, "B1:Back B2:More B3:Reset");
+}
+
+void nextZonePage() {
+    if (screenFirstZone >= Profiler::kZoneCount) {
+        screenFirstZone = 0;
+        return;
+    }
+    screenFirstZone += kScreenRows;
+    if (screenFirstZone > Profiler::kZoneCount) {
+        screenFirstZone = Profiler::kZoneCount;
+    }
+}
+
+void resetPage() {
+    if (screenFirstZone >= Profiler::kZoneCount) {
+        ModuleBudget::reset();
+    } else {
+        Profiler::reset();
+    }
+}
+
+constexpr Screen kProfilerScreen[] = {{
+    "framework.profiler", "Profiler", ICON_TUNING,
+    &drawProfilerScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, &nextZonePage, &resetPage,
+    false
+}};
+
+}  // namespace
+
+void Profiler::registerScreen() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+
+    ScreenRegistry::registerTable(kProfilerScreen, 1);
+    registered = true;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file RateRequest.cpp
+ * @brief Telemetry rate request framing, controller writer and robot follower
+ */
+
+#include "RateRequest.h"
+#include <cstring>
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+RateRequestWriter::RateRequestWriter()
+    : count_(0),
+      sentCount_(0),
+      sentMs_(0),
+      sentOnce_(false)
+{
+    memset(entries_, 0, sizeof(entries_));
+    memset(sent_, 0, sizeof(sent_));
+}
+
+void RateRequestWriter::reset() {
+    sentCount_ = 0;
+    sentOnce_ = false;
+}
+
+void RateRequestWriter::setCount(size_t count) {
+    count_ = count < kMaxEntries ? count : kMaxEntries;
+}
+
+void RateRequestWriter::set(size_t index, uint32_t magic, float hz) {
+    if (index >= kMaxEntries) {
+        return;
+    }
+    entries_[index].magic = magic;
+    entries_[index].intervalMs = intervalForHz(hz);
+}
+
+uint16_t RateRequestWriter::intervalForHz(float hz) {
+    if (!(hz > 0.0f)) {
+        return 0;
+    }
+    const float intervalMs = 1000.0f / hz + 0.5f;
+    if (intervalMs < 1.0f) {
+        return 1;
+    }
+    return intervalMs >= 65535.0f ? 65535 : static_cast<uint16_t>(intervalMs);
+}
+
+size_t RateRequestWriter::poll(uint32_t nowMs, uint8_t* out, size_t capacity) {
+    bool anyRate = false;
+    bool changed = count_ != sentCount_;
+    for (size_t i = 0; i < count_; ++i) {
+        anyRate = anyRate || entries_[i].intervalMs != 0;
+        changed = changed || entries_[i].magic != sent_[i].magic ||
+                  entries_[i].intervalMs != sent_[i].intervalMs;
+    }
+
+    if (!sentOnce_ && !anyRate) {
+        return 0;       // Never asked for anything: the robot keeps its defaults
+    }
+    if (!changed && (!anyRate || nowMs - sentMs_ < kRefreshMs)) {
+        return 0;
+    }
+
+    const size_t total = kHeaderSize + count_ * kEntrySize;
+    if (out == nullptr || total > capacity) {
+        return 0;
+    }
+    const uint32_t magic = RATE_REQUEST_MAGIC;
+    size_t offset = 0;
+    memcpy(out + offset, &magic, sizeof(magic));
+    offset += sizeof(magic);
+    out[offset++] = static_cast<uint8_t>(count_);
+    for (size_t i = 0; i < count_; ++i) {
+        memcpy(out + offset, &entries_[i].magic, sizeof(uint32_t));
+        offset += sizeof(uint32_t);
+        memcpy(out + offset, &entries_[i].intervalMs, sizeof(uint16_t));
+        offset += sizeof(uint16_t);
+    }
+
+    memcpy(sent_, entries_, count_ * sizeof(RateRequestEntry));
+    sentCount_ = count_;
+    sentMs_ = nowMs;
+    sentOnce_ = true;
+    return offset;
+}
+
+bool isRateRequest(const uint8_t* data, size_t length) {
+    if (data == nullptr || length < RateRequestWriter::kHeaderSize) {
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == RATE_REQUEST_MAGIC;
+}
+
+// ============================================================================
+// Follower
+// ============================================================================
+
+RateRequestFollower::RateRequestFollower()
+    : count_(0),
+      requestMs_(0),
+      haveRequest_(false)
+{
+    memset(types_, 0, sizeof(types_));
+}
+
+bool RateRequestFollower::addType(uint32_t magic, uint16_t defaultIntervalMs) {
+    Type* type = find(magic);
+    if (type == nullptr) {
+        if (count_ >= kMaxTypes) {
+            return false;
+        }
+        type = &types_[count_++];
+        *type = Type{};
+        type->magic = magic;
+    }
+    type->defaultMs = defaultIntervalMs;
+    return true;
+}
+
+bool RateRequestFollower::handle(const uint8_t* data, size_t length, uint32_t nowMs) {
+    if (!isRateRequest(data, length)) {
+        return false;
+    }
+    const size_t count = data[sizeof(uint32_t)];
+    if (length < RateRequestWriter::kHeaderSize + count * RateRequestWriter::kEntrySize) {
+        return true;    // Truncated: ours, but not applied
+    }
+
+    // Types missing from the request go back to their defaults
+    for (size_t i = 0; i < count_; ++i) {
+        types_[i].requestedMs = 0;
+    }
+    const uint8_t* entry = data + RateRequestWriter::kHeaderSize;
+    for (size_t i = 0; i < count; ++i, entry += RateRequestWriter::kEntrySize) {
+        uint32_t magic;
+        uint16_t intervalMs;
+        memcpy(&magic, entry, sizeof(magic));
+        memcpy(&intervalMs, entry + sizeof(magic), sizeof(intervalMs));
+        Type* type = find(magic);
+        if (type != nullptr) {
+            type->requestedMs = intervalMs;
+        }
+    }
+    requestMs_ = nowMs;
+    haveRequest_ = true;
+    return true;
+}
+
+bool RateRequestFollower::due(uint32_t magic, uint32_t nowMs) {
+    Type* type = find(magic);
+    if (type == nullptr) {
+        return true;
+    }
+    if (type->sent && nowMs - type->lastSentMs < intervalOf(*type, nowMs)) {
+        return false;
+    }
+    // From now rather than from the slot, so a late loop does not burst
+    type->lastSentMs = nowMs;
+    type->sent = true;
+    return true;
+}
+
+uint16_t RateRequestFollower::getIntervalMs(uint32_t magic, uint32_t nowMs) const {
+    const Type* type = find(magic);
+    return type != nullptr ? intervalOf(*type, nowMs) : 0;
+}
+
+void RateRequestFollower::reset() {
+    haveRequest_ = false;
+    for (size_t i = 0; i < count_; ++i) {
+        types_[i].requestedMs = 0;
+    }
+}
+
+uint16_t RateRequestFollower::intervalOf(const Type& type, uint32_t nowMs) const {
+    if (haveRequest_ && type.requestedMs != 0 && nowMs - requestMs_ < kTimeoutMs) {
+        return type.requestedMs;
+    }
+    return type.defaultMs;
+}
+
+RateRequestFollower::Type* RateRequestFollower::find(uint32_t magic) {
+    for (size_t i = 0; i < count_; ++i) {
+        if (types_[i].magic == magic) {
+            return &types_[i];
+        }
+    }
+    return nullptr;
+}
+
+const RateRequestFollower::Type* RateRequestFollower::find(uint32_t magic) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (types_[i].magic == magic) {
+            return &types_[i];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,298 @@
+#include "ReachabilityMap.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace IKEngine {
+
+namespace {
+
+constexpr uint8_t kNoRow = 0xFF;
+constexpr int kMaxMagnitude = 126;      // |field| tops out at kMaxMagnitude + 1
+constexpr int kOrthogonalStep = 2;      // Chamfer weights in half-cells
+constexpr int kDiagonalStep = 3;
+
+static_assert(ReachabilityMap::kMaxRows < kNoRow, "Row indices must fit below kNoRow");
+
+inline int minInt(int a, int b) {
+    return a < b ? a : b;
+}
+
+} // namespace
+
+ReachabilityMap::ReachabilityMap() {
+    memset(field_, 0, sizeof(field_));
+    memset(marks_, 0, sizeof(marks_));
+    memset(topRow_, kNoRow, sizeof(topRow_));
+    memset(bottomRow_, kNoRow, sizeof(bottomRow_));
+}
+
+// ============================================================================
+// Building
+// ============================================================================
+
+bool ReachabilityMap::update(const InverseKinematics& solver, float extensionMm) {
+    const float extension = solver.clampExtension(extensionMm);
+    if (building_) {
+        if (buildRevision_ != solver.getRevision()) {
+            beginBuild(solver, extension);
+        }
+    } else if (!ready_ ||
+               revision_ != solver.getRevision() ||
+               fabsf(extension - extensionMm_) > kRebuildExtensionMm) {
+        beginBuild(solver, extension);
+    }
+
+    if (building_) {
+        sampleRows(solver, kRowsPerUpdate);
+        if (buildRow_ >= buildRows_) {
+            finishBuild();
+        }
+    }
+    return ready_;
+}
+
+void ReachabilityMap::build(const InverseKinematics& solver, float extensionMm) {
+    beginBuild(solver, solver.clampExtension(extensionMm));
+    sampleRows(solver, buildRows_);
+    finishBuild();
+}
+
+void ReachabilityMap::beginBuild(const InverseKinematics& solver, float extensionMm) {
+    const ArmDimensions& dims = solver.getConfiguration().dimensions;
+    float reach = dims.shoulderLengthMm + dims.elbowLengthMm + extensionMm;
+    if (!(reach > 1.0f)) {
+        reach = 1.0f;
+    }
+
+    // Fit x in [0, reach] and y in [-reach, reach] with square cells
+    float cell = reach / static_cast<float>(kMaxCols - 1);
+    const float cellForRows = 2.0f * reach / static_cast<float>(kMaxRows - 1);
+    if (cellForRows > cell) cell = cellForRows;
+    if (cell < kMinCellMm) cell = kMinCellMm;
+
+    buildCols_ = static_cast<size_t>(ceilf(reach / cell)) + 1;
+    buildRows_ = static_cast<size_t>(ceilf(2.0f * reach / cell)) + 1;
+    if (buildCols_ > kMaxCols) buildCols_ = kMaxCols;
+    if (buildRows_ > kMaxRows) buildRows_ = kMaxRows;
+    buildCellMm_ = cell;
+    buildOriginY_ = -0.5f * static_cast<float>(buildRows_ - 1) * cell;
+    buildExtensionMm_ = extensionMm;
+    buildRevision_ = solver.getRevision();
+    buildRow_ = 0;
+    building_ = true;
+    memset(marks_, 0, sizeof(marks_));
+}
+
+void ReachabilityMap::sampleRows(const InverseKinematics& solver, size_t rowCount) {
+    IKSolution solution;
+    const size_t end = buildRow_ + rowCount < buildRows_ ? buildRow_ + rowCount : buildRows_;
+    for (; buildRow_ < end; ++buildRow_) {
+        const float y = buildOriginY_ + static_cast<float>(buildRow_) * buildCellMm_;
+        for (size_t col = 0; col < buildCols_; ++col) {
+            const float x = static_cast<float>(col) * buildCellMm_;
+            if (solver.solvePlanar(x, y, buildExtensionMm_, solution)) {
+                const size_t bit = buildRow_ * buildCols_ + col;
+                marks_[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+            }
+        }
+    }
+}
+
+bool ReachabilityMap::marked(size_t col, size_t row) const {
+    const size_t bit = row * buildCols_ + col;
+    return (marks_[bit >> 3] & (1u << (bit & 7))) != 0;
+}
+
+void ReachabilityMap::finishBuild() {
+    const int cols = static_cast<int>(buildCols_);
+    const int rows = static_cast<int>(buildRows_);
+
+    // Seed: 0 on cells with a 4-neighbour of the other class. Cells past the
+    // grid edge count as the same class, so x = 0 is not a boundary.
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const bool inside = marked(col, row);
+            const bool boundary =
+                (col > 0 && marked(col - 1, row) != inside) ||
+                (col + 1 < cols && marked(col + 1, row) != inside) ||
+                (row > 0 && marked(col, row - 1) != inside) ||
+                (row + 1 < rows && marked(col, row + 1) != inside);
+            field_[row * cols + col] = static_cast<int8_t>(boundary ? 0 : kMaxMagnitude);
+        }
+    }
+
+    // Two-pass chamfer transform of the distance to the nearest boundary cell
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int d = field_[row * cols + col];
+            if (col > 0) d = minInt(d, field_[row * cols + col - 1] + kOrthogonalStep);
+            if (row > 0) {
+                const int8_t* above = &field_[(row - 1) * cols];
+                d = minInt(d, above[col] + kOrthogonalStep);
+                if (col > 0) d = minInt(d, above[col - 1] + kDiagonalStep);
+                if (col + 1 < cols) d = minInt(d, above[col + 1] + kDiagonalStep);
+            }
+            field_[row * cols + col] = static_cast<int8_t>(minInt(d, kMaxMagnitude));
+        }
+    }
+    for (int row = rows - 1; row >= 0; --row) {
+        for (int col = cols - 1; col >= 0; --col) {
+            int d = field_[row * cols + col];
+            if (col + 1 < cols) d = minInt(d, field_[row * cols + col + 1] + kOrthogonalStep);
+            if (row + 1 < rows) {
+                const int8_t* below = &field_[(row + 1) * cols];
+                d = minInt(d, below[col] + kOrthogonalStep);
+                if (col > 0) d = minInt(d, below[col - 1] + kDiagonalStep);
+                if (col + 1 < cols) d = minInt(d, below[col + 1] + kDiagonalStep);
+            }
+            field_[row * cols + col] = static_cast<int8_t>(minInt(d, kMaxMagnitude));
+        }
+    }
+
+    // Boundary cells sit half a cell from the edge, so the zero crossing
+    // falls midway between an inside and an outside cell
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int8_t& value = field_[row * cols + col];
+            value = static_cast<int8_t>(marked(col, row) ? -(value + 1) : value + 1);
+        }
+    }
+
+    for (int col = 0; col < cols; ++col) {
+        topRow_[col] = kNoRow;
+        bottomRow_[col] = kNoRow;
+        for (int row = 0; row < rows; ++row) {
+            if (marked(col, row)) {
+                if (bottomRow_[col] == kNoRow) bottomRow_[col] = static_cast<uint8_t>(row);
+                topRow_[col] = static_cast<uint8_t>(row);
+            }
+        }
+    }
+
+    cols_ = buildCols_;
+    rows_ = buildRows_;
+    cellMm_ = buildCellMm_;
+    originY_ = buildOriginY_;
+    extensionMm_ = buildExtensionMm_;
+    revision_ = buildRevision_;
+    building_ = false;
+    ready_ = true;
+    generation_++;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+float ReachabilityMap::sample(float col, float row) const {
+    const float maxCol = static_cast<float>(cols_ - 1);
+    const float maxRow = static_cast<float>(rows_ - 1);
+    col = col < 0.0f ? 0.0f : (col > maxCol ? maxCol : col);
+    row = row < 0.0f ? 0.0f : (row > maxRow ? maxRow : row);
+
+    const size_t c0 = static_cast<size_t>(col);
+    const size_t r0 = static_cast<size_t>(row);
+    const size_t c1 = c0 + 1 < cols_ ? c0 + 1 : c0;
+    const size_t r1 = r0 + 1 < rows_ ? r0 + 1 : r0;
+    const float fc = col - static_cast<float>(c0);
+    const float fr = row - static_cast<float>(r0);
+
+    const float v00 = field_[r0 * cols_ + c0];
+    const float v01 = field_[r0 * cols_ + c1];
+    const float v10 = field_[r1 * cols_ + c0];
+    const float v11 = field_[r1 * cols_ + c1];
+    const float lower = v00 + (v01 - v00) * fc;
+    const float upper = v10 + (v11 - v10) * fc;
+    return lower + (upper - lower) * fr;
+}
+
+float ReachabilityMap::signedDistance(float horizontalMm, float verticalMm) const {
+    if (!ready_) {
+        return 0.0f;
+    }
+    const float col = horizontalMm / cellMm_;
+    const float row = (verticalMm - originY_) / cellMm_;
+    const float distance = sample(col, row) * 0.5f * cellMm_;
+
+    // Past the grid edge, add the distance back to it
+    const float maxCol = static_cast<float>(cols_ - 1);
+    const float maxRow = static_cast<float>(rows_ - 1);
+    const float outCol = col < 0.0f ? -col : (col > maxCol ? col - maxCol : 0.0f);
+    const float outRow = row < 0.0f ? -row : (row > maxRow ? row - maxRow : 0.0f);
+    if (outCol > 0.0f || outRow > 0.0f) {
+        return distance + sqrtf(outCol * outCol + outRow * outRow) * cellMm_;
+    }
+    return distance;
+}
+
+Vec3 ReachabilityMap::clamp(const Vec3& target) const {
+    if (!ready_ || signedDistance(target.x, target.y) < 0.0f) {
+        return target;
+    }
+
+    // Interpolation error is up to half a cell, so aim at least that deep
+    const float margin = fmaxf(kClampMarginMm, 0.5f * cellMm_);
+    const float reach = static_cast<float>(cols_ - 1) * cellMm_;
+
+    float x = target.x > 0.0f ? target.x : 0.0f;
+    float y = target.y;
+    const float radius = sqrtf(x * x + y * y);
+    if (radius > reach) {
+        // Saturated far field: pull onto the grid radially first
+        x *= reach / radius;
+        y *= reach / radius;
+    }
+
+    const float h = cellMm_;
+    for (int iteration = 0; iteration < 3; ++iteration) {
+        const float distance = signedDistance(x, y);
+        if (distance <= -0.5f * margin) {
+            break;
+        }
+        float gx = signedDistance(x + h, y) - signedDistance(x - h, y);
+        float gy = signedDistance(x, y + h) - signedDistance(x, y - h);
+        float length = sqrtf(gx * gx + gy * gy);
+        if (length < 1e-3f) {
+            // Flat field: assume the envelope is towards the shoulder
+            gx = x;
+            gy = y;
+            length = sqrtf(gx * gx + gy * gy);
+            if (length < 1e-3f) {
+                gx = -1.0f;
+                gy = 0.0f;
+                length = 1.0f;
+            }
+        }
+        const float step = (distance + margin) / length;
+        x -= gx * step;
+        y -= gy * step;
+        if (x < 0.0f) x = 0.0f;
+    }
+
+    return Vec3(x, y, target.z);
+}
+
+size_t ReachabilityMap::envelope(Vec3* out, size_t maxPoints) const {
+    if (!ready_ || out == nullptr) {
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t col = 0; col < cols_ && count < maxPoints; ++col) {
+        if (topRow_[col] != kNoRow) {
+            out[count++] = Vec3(static_cast<float>(col) * cellMm_,
+                                originY_ + static_cast<float>(topRow_[col]) * cellMm_,
+                                0.0f);
+        }
+    }
+    for (size_t col = cols_; col-- > 0 && count < maxPoints;) {
+        if (bottomRow_[col] != kNoRow) {
+            out[count++] = Vec3(static_cast<float>(col) * cellMm_,
+                                originY_ + static_cast<float>(bottomRow_[col]) * cellMm_,
+                                0.0f);
+        }
+    }
+    return count;
+}
+
+} // namespace IKEngine
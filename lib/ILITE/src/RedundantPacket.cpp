@@ -0,0 +1,152 @@
+/**
+ * @file RedundantPacket.cpp
+ * @brief Redundant packet framing, history and gap recovery
+ */
+
+#include "RedundantPacket.h"
+#include <cstring>
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+RedundantPacketWriter::RedundantPacketWriter()
+    : historyCount_(0),
+      historyHead_(0),
+      sequence_(0)
+{
+    memset(lengths_, 0, sizeof(lengths_));
+}
+
+void RedundantPacketWriter::reset() {
+    historyCount_ = 0;
+    historyHead_ = 0;
+}
+
+size_t RedundantPacketWriter::wrap(const uint8_t* packet, size_t length, uint8_t depth,
+                                   uint8_t* out, size_t capacity) {
+    if (packet == nullptr || out == nullptr || length == 0 || length > kMaxPacketSize) {
+        return 0;
+    }
+    if (depth > kMaxDepth) {
+        depth = kMaxDepth;
+    }
+    const size_t carried = historyCount_ < depth ? historyCount_ : depth;
+
+    size_t total = kHeaderSize + 1 + length;
+    for (size_t k = 0; k < carried; ++k) {
+        total += 1 + lengths_[(historyHead_ + kMaxDepth - k) % kMaxDepth];
+    }
+    if (total > capacity) {
+        return 0;
+    }
+
+    const uint16_t sequence = static_cast<uint16_t>(sequence_ + 1);
+    const uint32_t magic = REDUNDANT_PACKET_MAGIC;
+    size_t offset = 0;
+    memcpy(out + offset, &magic, sizeof(magic));
+    offset += sizeof(magic);
+    memcpy(out + offset, &sequence, sizeof(sequence));
+    offset += sizeof(sequence);
+    out[offset++] = static_cast<uint8_t>(1 + carried);
+
+    out[offset++] = static_cast<uint8_t>(length);
+    memcpy(out + offset, packet, length);
+    offset += length;
+    for (size_t k = 0; k < carried; ++k) {
+        const size_t slot = (historyHead_ + kMaxDepth - k) % kMaxDepth;
+        out[offset++] = lengths_[slot];
+        memcpy(out + offset, history_[slot], lengths_[slot]);
+        offset += lengths_[slot];
+    }
+
+    // The packet just sent becomes the newest history entry
+    historyHead_ = historyCount_ == 0 ? 0 : (historyHead_ + 1) % kMaxDepth;
+    memcpy(history_[historyHead_], packet, length);
+    lengths_[historyHead_] = static_cast<uint8_t>(length);
+    if (historyCount_ < kMaxDepth) {
+        historyCount_++;
+    }
+    sequence_ = sequence;
+    return offset;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+bool isRedundantPacket(const uint8_t* data, size_t length) {
+    if (data == nullptr || length < RedundantPacketWriter::kHeaderSize + 2) {
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    return magic == REDUNDANT_PACKET_MAGIC;
+}
+
+RedundantPacketReader::RedundantPacketReader()
+    : lastSequence_(0),
+      synced_(false),
+      recovered_(0),
+      lost_(0)
+{
+}
+
+void RedundantPacketReader::reset() {
+    synced_ = false;
+}
+
+int RedundantPacketReader::deliver(const uint8_t* data, size_t length,
+                                   void (*handler)(const uint8_t* packet, size_t length, void* context),
+                                   void* context) {
+    if (!isRedundantPacket(data, length) || handler == nullptr) {
+        return -1;
+    }
+
+    uint16_t sequence;
+    memcpy(&sequence, data + sizeof(uint32_t), sizeof(sequence));
+    const size_t count = data[RedundantPacketWriter::kHeaderSize - 1];
+    if (count == 0 || count > RedundantPacketWriter::kMaxDepth + 1) {
+        return -1;
+    }
+
+    // Locate every entry first; they are stored newest first
+    const uint8_t* entries[RedundantPacketWriter::kMaxDepth + 1];
+    size_t lengths[RedundantPacketWriter::kMaxDepth + 1];
+    size_t offset = RedundantPacketWriter::kHeaderSize;
+    for (size_t k = 0; k < count; ++k) {
+        if (offset >= length) {
+            return -1;
+        }
+        lengths[k] = data[offset++];
+        if (lengths[k] == 0 || offset + lengths[k] > length) {
+            return -1;
+        }
+        entries[k] = data + offset;
+        offset += lengths[k];
+    }
+
+    // How many sequences are new since the last delivery
+    size_t fresh = count;
+    if (synced_) {
+        const int16_t ahead = static_cast<int16_t>(sequence - lastSequence_);
+        if (ahead <= 0) {
+            return 0;   // Duplicate or reordered
+        }
+        if (static_cast<size_t>(ahead) < count) {
+            fresh = static_cast<size_t>(ahead);
+        } else {
+            lost_ += static_cast<size_t>(ahead) - count;
+        }
+    } else {
+        fresh = 1;      // No history to repair yet
+    }
+
+    for (size_t k = fresh; k-- > 0;) {
+        handler(entries[k], lengths[k], context);
+    }
+    recovered_ += fresh - 1;
+    lastSequence_ = sequence;
+    synced_ = true;
+    return static_cast<int>(fresh);
+}
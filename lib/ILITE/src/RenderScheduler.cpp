@@ -0,0 +1,148 @@
+/**
+ * @file RenderScheduler.cpp
+ * @brief Notification-driven frame pacing for DisplayTask
+ */
+
+#include "RenderScheduler.h"
+#include <esp_timer.h>
+#include <atomic>
+
+TaskHandle_t RenderScheduler::task_ = nullptr;
+RenderStats RenderScheduler::stats_ = {};
+
+namespace {
+
+constexpr uint32_t kInputBit = static_cast<uint32_t>(RenderReason::Input);
+constexpr uint32_t kDataBit = static_cast<uint32_t>(RenderReason::Data);
+constexpr uint32_t kAnimationBit = static_cast<uint32_t>(RenderReason::Animation);
+constexpr uint32_t kAllBits = kInputBit | kDataBit | kAnimationBit;
+
+TickType_t inputPeriod = pdMS_TO_TICKS(33);
+TickType_t dataPeriod = pdMS_TO_TICKS(100);
+
+// DisplayTask only
+TickType_t lastFrameTicks = 0;
+uint32_t pending = 0;
+
+// First Input request not yet drawn (esp_timer us, 0 = none)
+std::atomic<uint32_t> inputSinceUs{0};
+
+TickType_t periodFor(uint8_t hz, uint8_t fallbackHz) {
+    const uint8_t rate = hz > 0 ? hz : fallbackHz;
+    const TickType_t ticks = pdMS_TO_TICKS(1000 / rate);
+    return ticks > 0 ? ticks : 1;
+}
+
+inline void IRAM_ATTR markInput(uint32_t reasonBits) {
+    if ((reasonBits & kInputBit) == 0) {
+        return;
+    }
+    uint32_t expected = 0;
+    const uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+    inputSinceUs.compare_exchange_strong(expected, now ? now : 1);
+}
+
+}  // namespace
+
+void RenderScheduler::begin(TaskHandle_t displayTask, uint8_t maxFps, uint8_t dataHz) {
+    inputPeriod = periodFor(maxFps, 30);
+    dataPeriod = periodFor(dataHz, 10);
+    lastFrameTicks = xTaskGetTickCount();
+    task_ = displayTask;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+void RenderScheduler::invalidate(RenderReason reason) {
+    if (task_ == nullptr) {
+        return;
+    }
+    const uint32_t bits = static_cast<uint32_t>(reason);
+    markInput(bits);
+    xTaskNotify(task_, bits, eSetBits);
+}
+
+void IRAM_ATTR RenderScheduler::invalidateFromIsr(RenderReason reason) {
+    if (task_ == nullptr) {
+        return;
+    }
+    const uint32_t bits = static_cast<uint32_t>(reason);
+    markInput(bits);
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(task_, bits, eSetBits, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// ============================================================================
+// DisplayTask
+// ============================================================================
+
+uint32_t RenderScheduler::waitForFrame(uint8_t floorHz) {
+    const TickType_t floorPeriod = periodFor(floorHz, 2);
+
+    while (true) {
+        TickType_t due = floorPeriod;
+        if ((pending & (kInputBit | kAnimationBit)) != 0) {
+            due = inputPeriod < due ? inputPeriod : due;
+        } else if ((pending & kDataBit) != 0) {
+            due = dataPeriod < due ? dataPeriod : due;
+        }
+        const TickType_t since = xTaskGetTickCount() - lastFrameTicks;
+        if (since >= due) {
+            break;
+        }
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, due - since);
+        // xTaskNotifyGive() (maintenance exit) leaves a count: treat as Input
+        if ((bits & ~kAllBits) != 0) {
+            bits |= kInputBit;
+        }
+        pending |= bits & kAllBits;
+    }
+
+    lastFrameTicks = xTaskGetTickCount();
+    const uint32_t reasons = pending;
+    pending = 0;
+
+    stats_.frames++;
+    if ((reasons & kInputBit) != 0) {
+        stats_.inputFrames++;
+        const uint32_t since = inputSinceUs.exchange(0);
+        if (since != 0) {
+            const uint32_t latencyUs = static_cast<uint32_t>(esp_timer_get_time()) - since;
+            if (latencyUs > stats_.inputLatencyMaxUs) {
+                stats_.inputLatencyMaxUs = latencyUs;
+            }
+            stats_.inputLatencyAvgUs = stats_.inputLatencyAvgUs == 0
+                                           ? latencyUs
+                                           : stats_.inputLatencyAvgUs - stats_.inputLatencyAvgUs / 8 + latencyUs / 8;
+        }
+    } else if ((reasons & kAnimationBit) != 0) {
+        stats_.animationFrames++;
+    } else if (reasons != 0) {
+        stats_.dataFrames++;
+    } else {
+        stats_.floorFrames++;
+    }
+    return reasons;
+}
+
+void RenderScheduler::resetStats() {
+    stats_ = RenderStats{};
+}
+
+void RenderScheduler::dump(Print& out) {
+    const RenderStats& stats = stats_;
+    out.printf("[Render] frames=%lu input=%lu anim=%lu data=%lu floor=%lu input latency us: avg=%lu max=%lu\n",
+               static_cast<unsigned long>(stats.frames),
+               static_cast<unsigned long>(stats.inputFrames),
+               static_cast<unsigned long>(stats.animationFrames),
+               static_cast<unsigned long>(stats.dataFrames),
+               static_cast<unsigned long>(stats.floorFrames),
+               static_cast<unsigned long>(stats.inputLatencyAvgUs),
+               static_cast<unsigned long>(stats.inputLatencyMaxUs));
+}
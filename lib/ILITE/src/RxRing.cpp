@@ -0,0 +1,88 @@
+/**
+ * @file RxRing.cpp
+ * @brief Lock-free SPSC receive ring implementation
+ */
+
+#include "RxRing.h"
+#include <cstring>
+
+RxRing::RxRing()
+    : head_(0),
+      tail_(0),
+      overflowCount_(0),
+      highWaterMark_(0)
+{
+}
+
+bool RxRing::push(const uint8_t* mac, const uint8_t* data, int len) {
+    if (mac == nullptr || data == nullptr || len <= 0 ||
+        len > static_cast<int>(RxFrame::kMaxPayload)) {
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    size_t used = head - tail;
+    if (used >= kCapacity) {
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    RxFrame& slot = slots_[head & (kCapacity - 1)];
+    memcpy(slot.mac, mac, sizeof(slot.mac));
+    slot.length = static_cast<uint8_t>(len);
+    slot.timestampUs = micros();
+    memcpy(slot.data, data, len);
+
+    head_.store(head + 1, std::memory_order_release);
+
+    if (used + 1 > highWaterMark_.load(std::memory_order_relaxed)) {
+        highWaterMark_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+RxFrame* RxRing::reserve() {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail >= kCapacity) {
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &slots_[head & (kCapacity - 1)];
+}
+
+void RxRing::commit(uint8_t length) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    RxFrame& slot = slots_[head & (kCapacity - 1)];
+    slot.length = length;
+    slot.timestampUs = micros();
+
+    head_.store(head + 1, std::memory_order_release);
+
+    size_t used = head + 1 - tail_.load(std::memory_order_acquire);
+    if (used > highWaterMark_.load(std::memory_order_relaxed)) {
+        highWaterMark_.store(used, std::memory_order_relaxed);
+    }
+}
+
+const RxFrame* RxRing::front() const {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &slots_[tail & (kCapacity - 1)];
+}
+
+void RxRing::pop() {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+        return;
+    }
+    tail_.store(tail + 1, std::memory_order_release);
+}
+
+size_t RxRing::size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+}
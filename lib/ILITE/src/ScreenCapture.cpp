@@ -0,0 +1,295 @@
+/**
+ * @file ScreenCapture.cpp
+ * @brief Frame copies, XOR-delta PackBits encoding and the tap stream
+ */
+
+#include "ScreenCapture.h"
+#include "RenderScheduler.h"
+#include "TelemetryTap.h"
+#include <freertos/FreeRTOS.h>
+#include <esp_timer.h>
+#include <cstring>
+#include <new>
+
+std::atomic<bool> ScreenCapture::active_{false};
+
+namespace {
+
+constexpr size_t kMinRun = 3;                   // Shorter repeats stay literal
+constexpr size_t kMaxRun = 0x7F + kMinRun;
+constexpr size_t kMaxLiteral = 0x80;
+constexpr size_t kChunkHeader = 4;              // sequence:u16 tileWidth:u8 pageCount:u8
+constexpr uint8_t kFlagKeyframe = 0x01;
+constexpr uint8_t kFlagLast = 0x02;
+
+struct CaptureBuffers {
+    uint8_t latest[ScreenCapture::kFrameBytes];         ///< Newest frame for the web task
+    uint8_t tapReference[ScreenCapture::kFrameBytes];   ///< What the tap receiver shows
+};
+
+// Allocated on first use, so a controller that never streams costs no RAM
+std::atomic<CaptureBuffers*> g_buffers{nullptr};
+std::atomic<bool> g_tapStreaming{false};
+std::atomic<bool> g_webViewer{false};
+std::atomic<bool> g_tapKeyframe{true};
+std::atomic<bool> g_latestStale{true};
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+uint32_t g_latestSequence = 0;          // Guarded by g_lock
+uint8_t g_latestTileWidth = 0;          // Guarded by g_lock
+uint8_t g_latestPages = 0;              // Guarded by g_lock
+
+uint16_t g_tapSequence = 0;             // Display task only
+uint8_t g_tapTileWidth = 0;             // Display task only
+uint8_t g_tapPages = 0;                 // Display task only
+uint32_t g_lastKeyframeMs = 0;          // Display task only
+
+ScreenCaptureStats g_stats = {};
+
+bool ensureBuffers() {
+    if (g_buffers.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+    CaptureBuffers* buffers = new (std::nothrow) CaptureBuffers();
+    if (buffers == nullptr) {
+        return false;
+    }
+    CaptureBuffers* expected = nullptr;
+    if (!g_buffers.compare_exchange_strong(expected, buffers, std::memory_order_acq_rel)) {
+        delete buffers;     // Another task allocated first
+    }
+    return true;
+}
+
+size_t putChunkHeader(uint8_t* chunk, uint16_t sequence, uint8_t tileWidth, uint8_t pageCount) {
+    memcpy(chunk, &sequence, sizeof(sequence));
+    chunk[2] = tileWidth;
+    chunk[3] = pageCount;
+    return kChunkHeader;
+}
+
+/// Send the pages that differ from the receiver's reference (display task)
+void streamToTap(uint8_t* reference, const uint8_t* frame, uint8_t tileWidth, uint8_t pageCount,
+                 bool changed) {
+    const uint32_t now = millis();
+    const bool keyframe = g_tapKeyframe.load(std::memory_order_relaxed) ||
+                          tileWidth != g_tapTileWidth || pageCount != g_tapPages ||
+                          now - g_lastKeyframeMs >= ScreenCapture::kKeyframeMs;
+    if (!changed && !keyframe) {
+        return;
+    }
+    if (keyframe) {
+        // Against an empty screen; the receiver clears before applying it
+        memset(reference, 0, ScreenCapture::kFrameBytes);
+        g_tapTileWidth = tileWidth;
+        g_tapPages = pageCount;
+        g_lastKeyframeMs = now;
+        g_tapKeyframe.store(false, std::memory_order_relaxed);
+    }
+
+    const uint32_t timeUs = static_cast<uint32_t>(esp_timer_get_time());
+    const size_t pageBytes = static_cast<size_t>(tileWidth) * 8;
+    uint8_t chunk[TelemetryTap::kMaxPayload];
+    size_t length = putChunkHeader(chunk, g_tapSequence, tileWidth, pageCount);
+    uint8_t flags = keyframe ? kFlagKeyframe : 0;
+    size_t pages = 0;
+    bool delivered = true;
+
+    for (uint8_t page = 0; page < pageCount; ++page) {
+        const uint8_t* current = frame + page * pageBytes;
+        uint8_t* known = reference + page * pageBytes;
+        if (memcmp(current, known, pageBytes) == 0) {
+            continue;
+        }
+        if (length + 2 + ScreenCapture::kMaxEncodedPage > sizeof(chunk)) {
+            delivered = TelemetryTap::onDisplay(flags, chunk, length, timeUs) && delivered;
+            flags &= ~kFlagKeyframe;
+            length = kChunkHeader;
+        }
+        const size_t encoded = ScreenCapture::encodeDelta(current, known, pageBytes, chunk + length + 2);
+        chunk[length] = page;
+        chunk[length + 1] = static_cast<uint8_t>(encoded);
+        length += 2 + encoded;
+        memcpy(known, current, pageBytes);
+        g_stats.tapBytes += encoded;
+        pages++;
+    }
+    if (pages == 0 && !keyframe) {
+        return;     // The receiver already shows this frame
+    }
+
+    delivered = TelemetryTap::onDisplay(flags | kFlagLast, chunk, length, timeUs) && delivered;
+    g_tapSequence++;
+    g_stats.tapFrames++;
+    if (keyframe) {
+        g_stats.tapKeyframes++;
+    }
+    if (!delivered) {
+        // The receiver's copy is now wrong; start it over
+        g_stats.tapDrops++;
+        g_tapKeyframe.store(true, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+size_t ScreenCapture::encodeDelta(const uint8_t* current, const uint8_t* reference, size_t length,
+                                  uint8_t* out) {
+    size_t pos = 0;
+    size_t literalStart = 0;
+    size_t i = 0;
+
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            const size_t count = end - literalStart < kMaxLiteral ? end - literalStart : kMaxLiteral;
+            out[pos++] = static_cast<uint8_t>(count - 1);
+            for (size_t k = 0; k < count; ++k, ++literalStart) {
+                out[pos++] = current[literalStart] ^ reference[literalStart];
+            }
+        }
+    };
+
+    while (i < length) {
+        const uint8_t value = current[i] ^ reference[i];
+        size_t run = 1;
+        while (i + run < length && run < kMaxRun &&
+               static_cast<uint8_t>(current[i + run] ^ reference[i + run]) == value) {
+            run++;
+        }
+        if (run >= kMinRun) {
+            flushLiterals(i);
+            out[pos++] = static_cast<uint8_t>(0x80 + run - kMinRun);
+            out[pos++] = value;
+            literalStart = i + run;
+        }
+        i += run;
+    }
+    flushLiterals(length);
+    return pos;
+}
+
+// ============================================================================
+// Capture
+// ============================================================================
+
+void ScreenCapture::capture(const uint8_t* frame, uint8_t tileWidth, uint8_t pageCount, bool changed) {
+    CaptureBuffers* buffers = g_buffers.load(std::memory_order_acquire);
+    const size_t pageBytes = static_cast<size_t>(tileWidth) * 8;
+    const size_t frameBytes = pageBytes * pageCount;
+    if (buffers == nullptr || frame == nullptr) {
+        return;
+    }
+    if (pageBytes == 0 || pageBytes > kMaxPageBytes || frameBytes > kFrameBytes) {
+        g_stats.unsupported++;
+        return;
+    }
+    g_stats.frames++;
+
+    if (g_webViewer.load(std::memory_order_relaxed)) {
+        const bool stale = g_latestStale.exchange(false, std::memory_order_relaxed);
+        if (changed || stale) {
+            portENTER_CRITICAL(&g_lock);
+            memcpy(buffers->latest, frame, frameBytes);
+            g_latestTileWidth = tileWidth;
+            g_latestPages = pageCount;
+            g_latestSequence++;
+            portEXIT_CRITICAL(&g_lock);
+        }
+    }
+
+    if (g_tapStreaming.load(std::memory_order_relaxed)) {
+        if (TelemetryTap::isEnabled()) {
+            streamToTap(buffers->tapReference, frame, tileWidth, pageCount, changed);
+        } else {
+            g_tapKeyframe.store(true, std::memory_order_relaxed);   // For when the tap comes back
+        }
+    }
+}
+
+bool ScreenCapture::copyLatest(uint8_t* out, uint32_t& sequence, uint8_t& tileWidth, uint8_t& pageCount) {
+    CaptureBuffers* buffers = g_buffers.load(std::memory_order_acquire);
+    if (buffers == nullptr || out == nullptr) {
+        return false;
+    }
+    portENTER_CRITICAL(&g_lock);
+    const bool newer = g_latestSequence != 0 && g_latestSequence != sequence;
+    if (newer) {
+        memcpy(out, buffers->latest, static_cast<size_t>(g_latestTileWidth) * 8 * g_latestPages);
+        sequence = g_latestSequence;
+        tileWidth = g_latestTileWidth;
+        pageCount = g_latestPages;
+    }
+    portEXIT_CRITICAL(&g_lock);
+    return newer;
+}
+
+// ============================================================================
+// Control
+// ============================================================================
+
+bool ScreenCapture::updateActive() {
+    const bool active = g_buffers.load(std::memory_order_acquire) != nullptr &&
+                        (g_tapStreaming.load(std::memory_order_relaxed) ||
+                         g_webViewer.load(std::memory_order_relaxed));
+    active_.store(active, std::memory_order_relaxed);
+    if (active) {
+        // A static screen is only redrawn at the floor rate; get the first frame out now
+        RenderScheduler::invalidate(RenderReason::Data);
+    }
+    return active;
+}
+
+bool ScreenCapture::setTapStreaming(bool enabled) {
+    if (enabled && !ensureBuffers()) {
+        return false;
+    }
+    g_tapKeyframe.store(true, std::memory_order_relaxed);
+    g_tapStreaming.store(enabled, std::memory_order_relaxed);
+    updateActive();
+    return true;
+}
+
+bool ScreenCapture::isTapStreaming() {
+    return g_tapStreaming.load(std::memory_order_relaxed);
+}
+
+bool ScreenCapture::setWebViewer(bool viewing) {
+    if (viewing && !ensureBuffers()) {
+        return false;
+    }
+    g_latestStale.store(true, std::memory_order_relaxed);
+    g_webViewer.store(viewing, std::memory_order_relaxed);
+    updateActive();
+    return true;
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+ScreenCaptureStats ScreenCapture::getStats() {
+    return g_stats;
+}
+
+void ScreenCapture::dump(Print& out) {
+    const ScreenCaptureStats stats = g_stats;
+    out.printf("[Screen] tap %s%s, web viewer %s\n",
+               isTapStreaming() ? "on" : "off",
+               isTapStreaming() && !TelemetryTap::isEnabled() ? " (tap not running)" : "",
+               g_webViewer.load(std::memory_order_relaxed) ? "connected" : "none");
+    out.printf("[Screen] frames=%lu tapFrames=%lu keyframes=%lu bytes=%lu drops=%lu unsupported=%lu\n",
+               static_cast<unsigned long>(stats.frames),
+               static_cast<unsigned long>(stats.tapFrames),
+               static_cast<unsigned long>(stats.tapKeyframes),
+               static_cast<unsigned long>(stats.tapBytes),
+               static_cast<unsigned long>(stats.tapDrops),
+               static_cast<unsigned long>(stats.unsupported));
+    if (stats.tapFrames > 0) {
+        out.printf("[Screen] %lu bytes per tap frame\n",
+                   static_cast<unsigned long>(stats.tapBytes / stats.tapFrames));
+    }
+}
@@ -5,119 +5,266 @@
 
 #include "ScreenRegistry.h"
 #include <cstring>
+#include <new>
 
 // Static storage
-std::vector<Screen> ScreenRegistry::screens_;
-std::vector<const Screen*> ScreenRegistry::navigationStack_;
+constexpr ScreenHandle ScreenRegistry::kNoScreen;
+std::vector<const Screen*> ScreenRegistry::screens_;
+std::vector<Screen*> ScreenRegistry::copies_;
+int16_t* ScreenRegistry::index_ = nullptr;
+size_t ScreenRegistry::indexSlots_ = 0;
+uint16_t ScreenRegistry::generation_ = 0;
+ScreenHandle ScreenRegistry::stack_[ScreenRegistry::kMaxDepth];
+uint8_t ScreenRegistry::depth_ = 0;
+ScreenRegistry::Dispatch ScreenRegistry::dispatch_[2];
+std::atomic<uint8_t> ScreenRegistry::activeDispatch_{0};
+
+namespace {
+
+constexpr size_t kMinIndexSlots = 16;
+
+uint32_t hashId(ScreenID id) {
+    uint32_t hash = 2166136261u;                // FNV-1a
+    for (; *id != '\0'; ++id) {
+        hash = (hash ^ static_cast<uint8_t>(*id)) * 16777619u;
+    }
+    return hash;
+}
+
+}  // namespace
 
 // ============================================================================
 // Registration
 // ============================================================================
 
-void ScreenRegistry::registerScreen(const Screen& screen) {
-    // Check for duplicate IDs
-    for (const auto& existing : screens_) {
-        if (strcmp(existing.id, screen.id) == 0) {
-            Serial.printf("[ScreenRegistry] WARNING: Duplicate screen '%s' (ignoring)\n", screen.id);
-            return;
-        }
+bool ScreenRegistry::isDuplicate(const Screen& screen) {
+    if (find(screen.id) == kNoScreen) {
+        return false;
     }
+    Serial.printf("[ScreenRegistry] WARNING: Duplicate screen '%s' (ignoring)\n", screen.id);
+    return true;
+}
 
+void ScreenRegistry::add(const Screen* screen) {
+    if (screens_.size() >= kNoIndex) {
+        Serial.printf("[ScreenRegistry] ERROR: Too many screens, '%s' not registered\n", screen->id);
+        return;
+    }
     screens_.push_back(screen);
+
+    // Keep the index at most half full
+    const uint16_t index = static_cast<uint16_t>(screens_.size() - 1);
+    const bool indexed = screens_.size() * 2 > indexSlots_
+                             ? rebuildIndex(indexSlots_ ? indexSlots_ * 2 : kMinIndexSlots)
+                             : indexScreen(index);
+    if (!indexed) {
+        screens_.pop_back();
+        Serial.printf("[ScreenRegistry] ERROR: Out of memory for screen '%s'\n", screen->id);
+        return;
+    }
     Serial.printf("[ScreenRegistry] Registered screen: %s (%s)\n",
-                  screen.id, screen.title ? screen.title : "Untitled");
+                  screen->id, screen->title ? screen->title : "Untitled");
+}
+
+bool ScreenRegistry::indexScreen(uint16_t index) {
+    if (index_ == nullptr) {
+        return false;
+    }
+    size_t slot = hashId(screens_[index]->id) & (indexSlots_ - 1);
+    while (index_[slot] >= 0) {
+        slot = (slot + 1) & (indexSlots_ - 1);
+    }
+    index_[slot] = static_cast<int16_t>(index);
+    return true;
+}
+
+bool ScreenRegistry::rebuildIndex(size_t slots) {
+    int16_t* index = new (std::nothrow) int16_t[slots];
+    if (index == nullptr) {
+        return false;
+    }
+    delete[] index_;
+    index_ = index;
+    indexSlots_ = slots;
+    for (size_t i = 0; i < slots; ++i) {
+        index_[i] = -1;
+    }
+    for (size_t i = 0; i < screens_.size(); ++i) {
+        indexScreen(static_cast<uint16_t>(i));
+    }
+    return true;
+}
+
+void ScreenRegistry::registerScreen(const Screen& screen) {
+    if (isDuplicate(screen)) {
+        return;
+    }
+
+    Screen* copy = new (std::nothrow) Screen(screen);
+    if (copy == nullptr) {
+        Serial.printf("[ScreenRegistry] ERROR: Out of memory for screen '%s'\n", screen.id);
+        return;
+    }
+    copies_.push_back(copy);
+    add(copy);
+}
+
+void ScreenRegistry::registerTable(const Screen* screens, size_t count) {
+    if (screens == nullptr) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!isDuplicate(screens[i])) {
+            add(&screens[i]);
+        }
+    }
 }
 
 // ============================================================================
 // Queries
 // ============================================================================
 
-const Screen* ScreenRegistry::getScreen(ScreenID id) {
-    if (id == nullptr) {
-        return nullptr;
+ScreenHandle ScreenRegistry::find(ScreenID id) {
+    if (id == nullptr || index_ == nullptr) {
+        return kNoScreen;
     }
 
-    for (const auto& screen : screens_) {
-        if (strcmp(screen.id, id) == 0) {
-            return &screen;
+    size_t slot = hashId(id) & (indexSlots_ - 1);
+    for (; index_[slot] >= 0; slot = (slot + 1) & (indexSlots_ - 1)) {
+        const Screen* screen = screens_[index_[slot]];
+        if (screen->id == id || strcmp(screen->id, id) == 0) {
+            return {static_cast<uint16_t>(index_[slot]), generation_};
         }
     }
+    return kNoScreen;
+}
 
-    return nullptr;
+const Screen* ScreenRegistry::getScreen(ScreenHandle handle) {
+    if (handle.generation != generation_ || handle.index >= screens_.size()) {
+        return nullptr;
+    }
+    return screens_[handle.index];
+}
+
+const Screen* ScreenRegistry::getScreen(ScreenID id) {
+    return getScreen(find(id));
 }
 
 bool ScreenRegistry::hasScreen(ScreenID id) {
-    return getScreen(id) != nullptr;
+    return find(id) != kNoScreen;
 }
 
-std::vector<Screen>& ScreenRegistry::getAllScreens() {
+const std::vector<const Screen*>& ScreenRegistry::getAllScreens() {
     return screens_;
 }
 
 void ScreenRegistry::clear() {
+    depth_ = 0;
+    install(nullptr);
+    generation_++;          // Handles resolved so far now resolve to nothing
+
     screens_.clear();
-    navigationStack_.clear();
+    delete[] index_;
+    index_ = nullptr;
+    indexSlots_ = 0;
+    for (Screen* screen : copies_) {
+        delete screen;
+    }
+    copies_.clear();
 }
 
 // ============================================================================
 // Navigation
 // ============================================================================
 
-bool ScreenRegistry::show(ScreenID id) {
-    const Screen* screen = getScreen(id);
+void ScreenRegistry::install(const Screen* screen) {
+    const uint8_t next = activeDispatch_.load(std::memory_order_relaxed) ^ 1;
+    Dispatch& dispatch = dispatch_[next];
     if (screen == nullptr) {
+        dispatch = Dispatch();
+    } else {
+        dispatch.screen = screen;
+        dispatch.draw = screen->drawFunc;
+        dispatch.update = screen->updateFunc;
+        dispatch.rotate = screen->onEncoderRotate;
+        dispatch.press = screen->onEncoderPress;
+        dispatch.buttons[0] = screen->onButton1;
+        dispatch.buttons[1] = screen->onButton2;
+        dispatch.buttons[2] = screen->onButton3;
+        dispatch.modal = screen->isModal;
+    }
+    activeDispatch_.store(next, std::memory_order_release);
+}
+
+bool ScreenRegistry::show(ScreenID id) {
+    const ScreenHandle handle = find(id);
+    if (handle == kNoScreen) {
         Serial.printf("[ScreenRegistry] Screen not found: %s\n", id);
         return false;
     }
+    return show(handle);
+}
+
+bool ScreenRegistry::show(ScreenHandle handle) {
+    const Screen* screen = getScreen(handle);
+    if (screen == nullptr) {
+        return false;
+    }
 
     // Check condition if present
     if (screen->condition && !screen->condition()) {
-        Serial.printf("[ScreenRegistry] Screen condition not met: %s\n", id);
+        Serial.printf("[ScreenRegistry] Screen condition not met: %s\n", screen->id);
+        return false;
+    }
+    if (depth_ >= kMaxDepth) {
+        Serial.printf("[ScreenRegistry] Stack full, not showing: %s\n", screen->id);
         return false;
     }
 
     // Call onHide for previous screen
-    if (!navigationStack_.empty()) {
-        const Screen* prevScreen = navigationStack_.back();
-        if (prevScreen->onHide) {
-            prevScreen->onHide();
-        }
+    const Screen* prevScreen = getActiveScreen();
+    if (prevScreen != nullptr && prevScreen->onHide) {
+        prevScreen->onHide();
     }
 
     // Push onto stack
-    navigationStack_.push_back(screen);
+    stack_[depth_++] = handle;
+    install(screen);
 
     // Call onShow
     if (screen->onShow) {
         screen->onShow();
     }
 
-    Serial.printf("[ScreenRegistry] Showing screen: %s\n", id);
+    Serial.printf("[ScreenRegistry] Showing screen: %s\n", screen->id);
     return true;
 }
 
 bool ScreenRegistry::back() {
-    if (navigationStack_.empty()) {
+    if (depth_ == 0) {
         return false;
     }
 
     // Call onHide for current screen
-    const Screen* currentScreen = navigationStack_.back();
-    if (currentScreen->onHide) {
+    const Screen* currentScreen = getScreen(stack_[depth_ - 1]);
+    if (currentScreen != nullptr && currentScreen->onHide) {
         currentScreen->onHide();
     }
 
     // Pop from stack
-    navigationStack_.pop_back();
+    depth_--;
 
     // Call onShow for previous screen (if any)
-    if (!navigationStack_.empty()) {
-        const Screen* prevScreen = navigationStack_.back();
-        if (prevScreen->onShow) {
+    if (depth_ > 0) {
+        const Screen* prevScreen = getScreen(stack_[depth_ - 1]);
+        install(prevScreen);
+        if (prevScreen != nullptr && prevScreen->onShow) {
             prevScreen->onShow();
         }
-        Serial.printf("[ScreenRegistry] Back to screen: %s\n", prevScreen->id);
+        Serial.printf("[ScreenRegistry] Back to screen: %s\n", prevScreen ? prevScreen->id : "?");
     } else {
+        install(nullptr);
         Serial.println("[ScreenRegistry] Back to default display");
     }
 
@@ -126,60 +273,57 @@ bool ScreenRegistry::back() {
 
 void ScreenRegistry::clearStack() {
     // Call onHide for all screens
-    for (auto it = navigationStack_.rbegin(); it != navigationStack_.rend(); ++it) {
-        const Screen* screen = *it;
-        if (screen->onHide) {
+    while (depth_ > 0) {
+        const Screen* screen = getScreen(stack_[--depth_]);
+        if (screen != nullptr && screen->onHide) {
             screen->onHide();
         }
     }
 
-    navigationStack_.clear();
+    install(nullptr);
     Serial.println("[ScreenRegistry] Navigation stack cleared");
 }
 
 const Screen* ScreenRegistry::getActiveScreen() {
-    if (navigationStack_.empty()) {
-        return nullptr;
-    }
-    return navigationStack_.back();
+    return active().screen;
+}
+
+ScreenHandle ScreenRegistry::getActiveHandle() {
+    return depth_ > 0 ? stack_[depth_ - 1] : kNoScreen;
 }
 
 bool ScreenRegistry::hasActiveScreen() {
-    return !navigationStack_.empty();
+    return active().screen != nullptr;
 }
 
 // ============================================================================
 // Event Handling
 // ============================================================================
 
+// Handlers are copied out before the call: one that navigates twice
+// reinstalls the table it was called from
+
 void ScreenRegistry::handleEncoderRotate(int delta) {
-    const Screen* active = getActiveScreen();
-    if (active && active->onEncoderRotate) {
-        active->onEncoderRotate(delta);
+    const Delegate<void(int delta)> handler = active().rotate;
+    if (handler) {
+        handler(delta);
     }
 }
 
 void ScreenRegistry::handleEncoderPress() {
-    const Screen* active = getActiveScreen();
-    if (active && active->onEncoderPress) {
-        active->onEncoderPress();
+    const Delegate<void()> handler = active().press;
+    if (handler) {
+        handler();
     }
 }
 
 void ScreenRegistry::handleButton(int button) {
-    const Screen* active = getActiveScreen();
-    if (active) {
-        switch (button) {
-            case 1:
-                if (active->onButton1) active->onButton1();
-                break;
-            case 2:
-                if (active->onButton2) active->onButton2();
-                break;
-            case 3:
-                if (active->onButton3) active->onButton3();
-                break;
-        }
+    if (button < 1 || button > 3) {
+        return;
+    }
+    const Delegate<void()> handler = active().buttons[button - 1];
+    if (handler) {
+        handler();
     }
 }
 
@@ -188,22 +332,19 @@ void ScreenRegistry::handleButton(int button) {
 // ============================================================================
 
 void ScreenRegistry::updateActiveScreen() {
-    const Screen* active = getActiveScreen();
-    if (active && active->updateFunc) {
-        active->updateFunc();
+    const Dispatch& dispatch = active();
+    if (dispatch.update) {
+        dispatch.update();
     }
 }
 
 void ScreenRegistry::drawActiveScreen(DisplayCanvas& canvas) {
-    const Screen* active = getActiveScreen();
-    if (active && active->drawFunc) {
-        if (active->isModal) {
-            // For modal screens, don't clear canvas (draw over existing content)
-            active->drawFunc(canvas);
-        } else {
-            // For full-screen, clear first
+    const Dispatch& dispatch = active();
+    if (dispatch.draw) {
+        if (!dispatch.modal) {
+            // For full-screen, clear first (modal screens draw over existing content)
             canvas.clear();
-            active->drawFunc(canvas);
         }
+        dispatch.draw(canvas);
     }
 }
@@ -0,0 +1,523 @@
+/**
+ * @file SerialBridge.cpp
+ * @brief Bridge task: COBS decoding, forwarding, send matching and the host queue
+ */
+
+#include "SerialBridge.h"
+#include "DisplayCanvas.h"
+#include "Framing.h"
+#include "MpscQueue.h"
+#include "TaskMonitor.h"
+#include "TelemetryTap.h"
+#include "Transport.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+std::atomic<bool> SerialBridge::active_{false};
+
+const uint32_t SerialBridge::kBucketUs[kBridgeLatencyBuckets] = {
+    250, 500, 1000, 2000, 3000, 5000, 10000, UINT32_MAX
+};
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 4096;
+constexpr uint32_t kPollMs = 2;                                 // Safety net for a missed UART event
+constexpr size_t kMaxBody = 250;                                // ESP-NOW maximum
+constexpr size_t kMaxFrame = 1 + 4 + kMaxBody + 2;              // kind, time, body, crc
+constexpr size_t kMaxEncoded = Framing::cobsMaxEncoded(kMaxFrame);
+constexpr size_t kSentBody = 9;                                 // status, forwardUs, airUs
+
+struct BridgeRecord {
+    uint8_t kind;
+    uint8_t length;             ///< Bytes used in body
+    bool measured;              ///< Sent report from a send callback
+    uint32_t timeUs;
+    uint8_t body[kMaxBody];
+};
+
+// A command handed to the link, waiting for its send callback
+struct PendingCommand {
+    uint32_t hostTimeUs;
+    uint32_t readUs;
+    uint32_t sentUs;
+};
+
+using BridgeQueue = MpscQueue<BridgeRecord, SerialBridge::kQueueSize>;
+
+BridgeQueue* queue = nullptr;   // Allocated by the first start()
+TaskHandle_t bridgeHandle = nullptr;
+HardwareSerial* port = nullptr;
+uint32_t consoleBaud = 0;
+uint8_t peer[6] = {};
+std::atomic<bool> stopRequested{false};
+std::atomic<bool> finished{false};          // Port restored; service() ends the session
+std::atomic<uint32_t> droppedCount{0};
+
+// Pending commands, shared with the WiFi task
+portMUX_TYPE pendingLock = portMUX_INITIALIZER_UNLOCKED;
+PendingCommand pending[SerialBridge::kPending];
+size_t pendingHead = 0;
+size_t pendingCount = 0;
+uint32_t unmatchedCount = 0;
+
+// Bridge task only
+SerialBridgeStats stats;
+uint8_t frame[kMaxFrame];
+size_t frameLength = 0;
+bool frameOverflow = false;
+uint8_t cobsCode = 0;
+bool cobsBlockFull = false;
+bool cobsStarted = false;
+uint32_t startMs = 0;
+uint32_t lastByteMs = 0;
+uint32_t reportedDrops = 0;
+uint64_t forwardSumUs = 0;
+uint64_t airSumUs = 0;
+uint32_t airSamples = 0;
+
+inline uint32_t nowUs() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+using Framing::cobsEncode;
+using Framing::crc16;
+using Framing::getU16;
+using Framing::getU32;
+using Framing::putU16;
+using Framing::putU32;
+
+void writeFrame(uint8_t kind, uint32_t timeUs, const uint8_t* body, size_t length) {
+    static uint8_t out[kMaxFrame];
+    static uint8_t encoded[kMaxEncoded];
+
+    out[0] = kind;
+    putU32(out + 1, timeUs);
+    memcpy(out + 5, body, length);
+    const size_t outLength = 5 + length;
+    putU16(out + outLength, crc16(out, outLength));
+    const size_t encodedLength = cobsEncode(out, outLength + 2, encoded);
+    port->write(encoded, encodedLength);
+    stats.txBytes += encodedLength;
+}
+
+void pushSent(uint32_t hostTimeUs, uint8_t status, uint32_t forwardUs, uint32_t airUs, bool measured) {
+    BridgeRecord record;
+    record.kind = SerialBridge::FRAME_SENT;
+    record.length = kSentBody;
+    record.measured = measured;
+    record.timeUs = hostTimeUs;
+    record.body[0] = status;
+    putU32(record.body + 1, forwardUs);
+    putU32(record.body + 5, airUs);
+    queue->push(record);
+}
+
+void recordLatency(uint32_t forwardUs, uint32_t airUs) {
+    if (airSamples == 0 || forwardUs < stats.forwardMinUs) {
+        stats.forwardMinUs = forwardUs;
+    }
+    if (airSamples == 0 || airUs < stats.airMinUs) {
+        stats.airMinUs = airUs;
+    }
+    stats.forwardMaxUs = std::max(stats.forwardMaxUs, forwardUs);
+    stats.airMaxUs = std::max(stats.airMaxUs, airUs);
+    forwardSumUs += forwardUs;
+    airSumUs += airUs;
+    airSamples++;
+    stats.forwardAvgUs = static_cast<uint32_t>(forwardSumUs / airSamples);
+    stats.airAvgUs = static_cast<uint32_t>(airSumUs / airSamples);
+
+    size_t bucket = 0;
+    while (forwardUs + airUs > SerialBridge::kBucketUs[bucket]) {
+        bucket++;
+    }
+    stats.histogram[bucket]++;
+}
+
+void writeRecord(const BridgeRecord& record) {
+    if (record.kind == SerialBridge::FRAME_TELEMETRY) {
+        stats.telemetry++;
+    } else if (record.kind == SerialBridge::FRAME_SENT && record.measured) {
+        if (record.body[0] != SerialBridge::SENT_OK) {
+            stats.sendFailures++;
+        }
+        recordLatency(getU32(record.body + 1), getU32(record.body + 5));
+    }
+    writeFrame(record.kind, record.timeUs, record.body, record.length);
+}
+
+// ============================================================================
+// Forwarding
+// ============================================================================
+
+void forward(const uint8_t* body, size_t length, uint32_t hostTimeUs, uint32_t readUs) {
+    // Claimed before send(): a wired transport completes inside it
+    const uint32_t sentUs = nowUs();
+    portENTER_CRITICAL(&pendingLock);
+    if (pendingCount == SerialBridge::kPending) {
+        pendingHead = (pendingHead + 1) % SerialBridge::kPending;
+        pendingCount--;
+        unmatchedCount++;
+    }
+    pending[(pendingHead + pendingCount) % SerialBridge::kPending] = {hostTimeUs, readUs, sentUs};
+    pendingCount++;
+    portEXIT_CRITICAL(&pendingLock);
+
+    const esp_err_t err = Transport::getActive().send(peer, body, length);
+    if (err == ESP_OK) {
+        stats.commands++;
+        return;
+    }
+
+    // No callback follows: take the claim back if it is still the newest
+    portENTER_CRITICAL(&pendingLock);
+    if (pendingCount > 0 &&
+        pending[(pendingHead + pendingCount - 1) % SerialBridge::kPending].sentUs == sentUs) {
+        pendingCount--;
+    }
+    portEXIT_CRITICAL(&pendingLock);
+
+    if (err == ESP_ERR_ESPNOW_NO_MEM) {
+        stats.driverFull++;
+    } else {
+        stats.sendFailures++;
+    }
+    pushSent(hostTimeUs, err == ESP_ERR_ESPNOW_NO_MEM ? SerialBridge::SENT_BUSY : SerialBridge::SENT_FAILED,
+             sentUs - readUs, 0, false);
+}
+
+// A complete decoded frame: kind, time, body, crc
+void acceptFrame(uint32_t readUs) {
+    if (frameOverflow || frameLength < 7 ||
+        crc16(frame, frameLength - 2) != getU16(frame + frameLength - 2)) {
+        stats.badFrames++;     // Console text echoed by the host or a corrupted frame
+        return;
+    }
+    const size_t bodyLength = frameLength - 7;
+    switch (frame[0]) {
+        case SerialBridge::FRAME_COMMAND:
+            if (bodyLength == 0 || bodyLength > kMaxBody) {
+                stats.badFrames++;
+                return;
+            }
+            forward(frame + 5, bodyLength, getU32(frame + 1), readUs);
+            return;
+        case TelemetryTap::FRAME_END:
+            SerialBridge::stop();
+            return;
+        default:
+            stats.badFrames++;
+            return;
+    }
+}
+
+void feed(uint8_t byte, uint32_t readUs) {
+    if (byte == 0x00) {
+        // Delimiter: a frame is complete when its last block was
+        if (cobsStarted && cobsCode == 0) {
+            acceptFrame(readUs);
+        } else if (cobsStarted) {
+            stats.badFrames++;
+        }
+        frameLength = 0;
+        frameOverflow = false;
+        cobsCode = 0;
+        cobsStarted = false;
+        return;
+    }
+
+    if (cobsCode == 0) {
+        // Code byte: the previous block ends in an implied zero unless it was full
+        if (cobsStarted && !cobsBlockFull) {
+            if (frameLength < sizeof(frame)) {
+                frame[frameLength++] = 0x00;
+            } else {
+                frameOverflow = true;
+            }
+        }
+        cobsCode = static_cast<uint8_t>(byte - 1);
+        cobsBlockFull = byte == 0xFF;
+        cobsStarted = true;
+        return;
+    }
+
+    if (frameLength < sizeof(frame)) {
+        frame[frameLength++] = byte;
+    } else {
+        frameOverflow = true;
+    }
+    cobsCode--;
+}
+
+void wakeBridge() {
+    if (bridgeHandle != nullptr) {
+        xTaskNotifyGive(bridgeHandle);
+    }
+}
+
+// ============================================================================
+// Task
+// ============================================================================
+
+void finish() {
+    BridgeRecord record;
+    while (queue->pop(record)) {
+        writeRecord(record);
+    }
+    port->flush();
+    port->onReceive(nullptr);
+    port->updateBaudRate(consoleBaud);
+
+    portENTER_CRITICAL(&pendingLock);
+    stats.unmatched = unmatchedCount + pendingCount;
+    pendingCount = 0;
+    portEXIT_CRITICAL(&pendingLock);
+    stats.dropped = droppedCount.load();
+    stats.elapsedMs = millis() - startMs;
+
+    finished.store(true);
+}
+
+void bridgeTask(void*) {
+    uint8_t chunk[256];
+    while (true) {
+        if (!SerialBridge::isActive() || finished.load()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        // Woken by the UART receive event, a queued record or stop()
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kPollMs));
+
+        int available;
+        while ((available = port->available()) > 0) {
+            const size_t n = port->read(chunk, std::min(static_cast<size_t>(available), sizeof(chunk)));
+            const uint32_t readUs = nowUs();
+            lastByteMs = millis();
+            stats.rxBytes += n;
+            for (size_t i = 0; i < n; ++i) {
+                feed(chunk[i], readUs);
+            }
+        }
+
+        BridgeRecord record;
+        while (queue->pop(record)) {
+            writeRecord(record);
+        }
+        const uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            uint8_t body[4];
+            putU32(body, dropped - reportedDrops);
+            reportedDrops = dropped;
+            writeFrame(TelemetryTap::FRAME_DROPPED, nowUs(), body, sizeof(body));
+        }
+
+        if (stopRequested.load() || millis() - lastByteMs >= SerialBridge::kIdleTimeoutMs) {
+            finish();
+        }
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Session
+// ============================================================================
+
+bool SerialBridge::start(HardwareSerial& out, uint32_t baud, const uint8_t* peerMac,
+                         UBaseType_t priority, BaseType_t core) {
+    if (isActive() || peerMac == nullptr) {
+        return false;
+    }
+    if (queue == nullptr) {
+        queue = new (std::nothrow) BridgeQueue();
+        if (queue == nullptr) {
+            Serial.println("[Bridge] Out of memory for the record queue");
+            return false;
+        }
+    }
+    if (bridgeHandle == nullptr) {
+        BaseType_t result = xTaskCreatePinnedToCore(
+            bridgeTask,
+            "SerialBridge",
+            kTaskStackSize,
+            nullptr,
+            priority,
+            &bridgeHandle,
+            core
+        );
+        if (result != pdPASS) {
+            Serial.println("[Bridge] Failed to create the bridge task");
+            bridgeHandle = nullptr;
+            return false;
+        }
+        TaskMonitor::watch(bridgeHandle, kTaskStackSize, core);
+    }
+
+    BridgeRecord stale;
+    while (queue->pop(stale)) {
+    }
+    stats = SerialBridgeStats{};
+    frameLength = 0;
+    frameOverflow = false;
+    cobsCode = 0;
+    cobsStarted = false;
+    forwardSumUs = 0;
+    airSumUs = 0;
+    airSamples = 0;
+    droppedCount.store(0);
+    reportedDrops = 0;
+    portENTER_CRITICAL(&pendingLock);
+    pendingCount = 0;
+    unmatchedCount = 0;
+    portEXIT_CRITICAL(&pendingLock);
+    memcpy(peer, peerMac, sizeof(peer));
+    stopRequested.store(false);
+    finished.store(false);
+
+    // The tap writes to the same port
+    TelemetryTap::setEnabled(false);
+
+    port = &out;
+    consoleBaud = out.baudRate();
+    out.printf("[Bridge] On at %lu baud; send frames now\n", static_cast<unsigned long>(baud));
+    out.flush();
+    // The RX buffer size only applies to a fresh driver
+    out.end();
+    out.setRxBufferSize(kRxBufferBytes);
+    out.begin(baud);
+    out.onReceive(wakeBridge);
+
+    startMs = millis();
+    lastByteMs = startMs;
+    active_.store(true, std::memory_order_release);
+    xTaskNotifyGive(bridgeHandle);
+    return true;
+}
+
+void SerialBridge::stop() {
+    if (isActive() && !finished.load()) {
+        stopRequested.store(true);
+        wakeBridge();
+    }
+}
+
+void SerialBridge::service() {
+    if (finished.exchange(false)) {
+        active_.store(false, std::memory_order_release);
+        dump(Serial);
+    }
+}
+
+// ============================================================================
+// Hooks
+// ============================================================================
+
+void SerialBridge::onTelemetry(const uint8_t* mac, const uint8_t* data, size_t length,
+                               uint32_t timestampUs) {
+    if (!isActive() || mac == nullptr || memcmp(mac, peer, sizeof(peer)) != 0) {
+        return;
+    }
+    BridgeRecord record;
+    record.kind = FRAME_TELEMETRY;
+    record.length = static_cast<uint8_t>(std::min(length, kMaxBody));
+    record.measured = false;
+    record.timeUs = timestampUs;
+    memcpy(record.body, data, record.length);
+    if (!queue->push(record)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wakeBridge();
+}
+
+void SerialBridge::onSendComplete(const uint8_t* mac, bool success) {
+    if (!isActive() || mac == nullptr || memcmp(mac, peer, sizeof(peer)) != 0) {
+        return;
+    }
+    const uint32_t now = nowUs();
+    PendingCommand command;
+    bool found = false;
+    portENTER_CRITICAL(&pendingLock);
+    // Completions arrive in send order; older entries lost their callback
+    while (pendingCount > 0 && !found) {
+        command = pending[pendingHead];
+        pendingHead = (pendingHead + 1) % kPending;
+        pendingCount--;
+        if (now - command.sentUs > kCallbackTimeoutUs) {
+            unmatchedCount++;
+        } else {
+            found = true;
+        }
+    }
+    portEXIT_CRITICAL(&pendingLock);
+
+    if (found) {
+        pushSent(command.hostTimeUs, success ? SENT_OK : SENT_FAILED,
+                 command.sentUs - command.readUs, now - command.sentUs, true);
+        wakeBridge();
+    }
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+void SerialBridge::drawScreen(DisplayCanvas& canvas) {
+    const SerialBridgeStats s = getStats();
+    canvas.firstPage();
+    do {
+        canvas.clear();
+        canvas.setFont(DisplayCanvas::NORMAL);
+        canvas.drawTextCentered(14, "Serial Bridge");
+        canvas.setFont(DisplayCanvas::SMALL);
+        canvas.drawTextF(0, 30, "Cmd %lu  Tlm %lu", static_cast<unsigned long>(s.commands),
+                         static_cast<unsigned long>(s.telemetry));
+        canvas.drawTextF(0, 42, "Latency %lu us", static_cast<unsigned long>(s.forwardAvgUs + s.airAvgUs));
+        canvas.drawTextCentered(58, "Press encoder to exit");
+    } while (canvas.nextPage());
+}
+
+SerialBridgeStats SerialBridge::getStats() {
+    SerialBridgeStats copy = stats;
+    if (isActive()) {
+        copy.dropped = droppedCount.load();
+        copy.elapsedMs = millis() - startMs;
+    }
+    return copy;
+}
+
+void SerialBridge::dump(Print& out) {
+    const SerialBridgeStats s = getStats();
+    out.printf("[Bridge] %s %lu ms: commands=%lu telemetry=%lu dropped=%lu\n",
+               isActive() ? "running" : "done",
+               static_cast<unsigned long>(s.elapsedMs),
+               static_cast<unsigned long>(s.commands),
+               static_cast<unsigned long>(s.telemetry),
+               static_cast<unsigned long>(s.dropped));
+    out.printf("[Bridge] forward us: min=%lu avg=%lu max=%lu, air us: min=%lu avg=%lu max=%lu\n",
+               static_cast<unsigned long>(s.forwardMinUs),
+               static_cast<unsigned long>(s.forwardAvgUs),
+               static_cast<unsigned long>(s.forwardMaxUs),
+               static_cast<unsigned long>(s.airMinUs),
+               static_cast<unsigned long>(s.airAvgUs),
+               static_cast<unsigned long>(s.airMaxUs));
+    out.print("[Bridge] hist (<=0.25/0.5/1/2/3/5/10/+ ms):");
+    for (size_t i = 0; i < kBridgeLatencyBuckets; ++i) {
+        out.printf(" %lu", static_cast<unsigned long>(s.histogram[i]));
+    }
+    out.println();
+    if (s.badFrames != 0 || s.sendFailures != 0 || s.driverFull != 0 || s.unmatched != 0) {
+        out.printf("[Bridge] bad frames=%lu send failures=%lu driver full=%lu unmatched=%lu\n",
+                   static_cast<unsigned long>(s.badFrames),
+                   static_cast<unsigned long>(s.sendFailures),
+                   static_cast<unsigned long>(s.driverFull),
+                   static_cast<unsigned long>(s.unmatched));
+    }
+    out.printf("[Bridge] bytes in=%lu out=%lu\n", static_cast<unsigned long>(s.rxBytes),
+               static_cast<unsigned long>(s.txBytes));
+}
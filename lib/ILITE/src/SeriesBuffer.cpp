@@ -0,0 +1,235 @@
+/**
+ * @file SeriesBuffer.cpp
+ * @brief Decimation pyramid implementation
+ */
+
+#include "SeriesBuffer.h"
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+SeriesBuffer::SeriesBuffer(uint8_t capacityLog2)
+    : raw_(nullptr),
+      capacity_(0),
+      capacityLog2_(constrain(capacityLog2, kMinCapacityLog2, kMaxCapacityLog2)),
+      levels_(0),
+      total_(0),
+      rangeMin_(0),
+      rangeMax_(0),
+      ownsStorage_(true)
+{
+    layout(new int16_t[storageValues(capacityLog2_)]());
+}
+
+SeriesBuffer::SeriesBuffer(uint8_t capacityLog2, int16_t* storage)
+    : raw_(nullptr),
+      capacity_(0),
+      capacityLog2_(constrain(capacityLog2, kMinCapacityLog2, kMaxCapacityLog2)),
+      levels_(0),
+      total_(0),
+      rangeMin_(0),
+      rangeMax_(0),
+      ownsStorage_(false)
+{
+    layout(storage);
+}
+
+size_t SeriesBuffer::storageValues(uint8_t capacityLog2) {
+    const uint8_t log2 = constrain(capacityLog2, kMinCapacityLog2, kMaxCapacityLog2);
+    const size_t capacity = 1UL << log2;
+
+    // Raw ring followed by min/max arrays for every level: 3 * capacity total
+    size_t totalValues = capacity;
+    for (uint8_t l = 1; l <= log2 - 3; ++l) {
+        totalValues += 2 * (capacity >> l);
+    }
+    return totalValues;
+}
+
+void SeriesBuffer::layout(int16_t* storage) {
+    capacity_ = 1UL << capacityLog2_;
+    // Coarsest level keeps kTopBuckets (8) buckets
+    levels_ = capacityLog2_ - 3;
+    raw_ = storage;
+
+    int16_t* cursor = raw_ + capacity_;
+    for (uint8_t l = 0; l <= kMaxLevels; ++l) {
+        levelMin_[l] = nullptr;
+        levelMax_[l] = nullptr;
+        if (l >= 1 && l <= levels_) {
+            levelMin_[l] = cursor;
+            cursor += capacity_ >> l;
+            levelMax_[l] = cursor;
+            cursor += capacity_ >> l;
+        }
+    }
+}
+
+SeriesBuffer::~SeriesBuffer() {
+    if (ownsStorage_) {
+        delete[] raw_;
+    }
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+void SeriesBuffer::push(int16_t value) {
+    const uint32_t index = total_;
+    raw_[index & (capacity_ - 1)] = value;
+
+    // Update the open bucket at every level; the first sample of a bucket resets it
+    for (uint8_t l = 1; l <= levels_; ++l) {
+        const uint32_t slot = (index >> l) & ((capacity_ >> l) - 1);
+        if ((index & ((1UL << l) - 1)) == 0) {
+            levelMin_[l][slot] = value;
+            levelMax_[l][slot] = value;
+        } else {
+            if (value < levelMin_[l][slot]) levelMin_[l][slot] = value;
+            if (value > levelMax_[l][slot]) levelMax_[l][slot] = value;
+        }
+    }
+
+    total_++;
+
+    if (total_ == 1) {
+        rangeMin_ = value;
+        rangeMax_ = value;
+    } else {
+        if (value < rangeMin_) rangeMin_ = value;
+        if (value > rangeMax_) rangeMax_ = value;
+    }
+
+    // A coarsest bucket just closed: rebuild the range so old extremes age out
+    if ((total_ & ((1UL << levels_) - 1)) == 0) {
+        recomputeRange();
+    }
+}
+
+void SeriesBuffer::clear() {
+    total_ = 0;
+    rangeMin_ = 0;
+    rangeMax_ = 0;
+}
+
+void SeriesBuffer::recomputeRange() {
+    const uint32_t retained = size();
+    const uint32_t bucketSize = 1UL << levels_;
+    uint32_t buckets = (retained + bucketSize - 1) / bucketSize;
+    if (buckets > kTopBuckets) {
+        buckets = kTopBuckets;
+    }
+
+    const uint32_t newest = (total_ - 1) >> levels_;
+    const uint32_t mask = kTopBuckets - 1;
+    int16_t minValue = levelMin_[levels_][newest & mask];
+    int16_t maxValue = levelMax_[levels_][newest & mask];
+    for (uint32_t b = 1; b < buckets; ++b) {
+        const uint32_t slot = (newest - b) & mask;
+        if (levelMin_[levels_][slot] < minValue) minValue = levelMin_[levels_][slot];
+        if (levelMax_[levels_][slot] > maxValue) maxValue = levelMax_[levels_][slot];
+    }
+    rangeMin_ = minValue;
+    rangeMax_ = maxValue;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+size_t SeriesBuffer::size() const {
+    return total_ < capacity_ ? total_ : capacity_;
+}
+
+int16_t SeriesBuffer::newest() const {
+    return total_ > 0 ? raw_[(total_ - 1) & (capacity_ - 1)] : 0;
+}
+
+size_t SeriesBuffer::copyRecent(size_t count, int16_t* out) const {
+    const size_t retained = size();
+    if (count > retained) {
+        count = retained;
+    }
+    const uint32_t start = total_ - count;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = raw_[(start + i) & (capacity_ - 1)];
+    }
+    return count;
+}
+
+bool SeriesBuffer::getRange(int16_t& minValue, int16_t& maxValue) const {
+    if (total_ == 0) {
+        return false;
+    }
+    minValue = rangeMin_;
+    maxValue = rangeMax_;
+    return true;
+}
+
+void SeriesBuffer::mergeRange(uint32_t start, uint32_t end, uint8_t maxLevel,
+                              int16_t& minValue, int16_t& maxValue) const {
+    // Greedy aligned decomposition: take the largest bucket that starts at
+    // `pos` and fits before `end`, falling back to raw samples at the edges.
+    uint32_t pos = start;
+    while (pos < end) {
+        uint8_t level = maxLevel;
+        while (level > 0 &&
+               ((pos & ((1UL << level) - 1)) != 0 || pos + (1UL << level) > end)) {
+            level--;
+        }
+
+        int16_t lo;
+        int16_t hi;
+        if (level == 0) {
+            lo = hi = raw_[pos & (capacity_ - 1)];
+        } else {
+            const uint32_t slot = (pos >> level) & ((capacity_ >> level) - 1);
+            lo = levelMin_[level][slot];
+            hi = levelMax_[level][slot];
+        }
+        if (lo < minValue) minValue = lo;
+        if (hi > maxValue) maxValue = hi;
+        pos += 1UL << level;
+    }
+}
+
+size_t SeriesBuffer::decimate(size_t window, size_t columns,
+                              int16_t* minOut, int16_t* maxOut) const {
+    const size_t retained = size();
+    if (window == 0 || window > retained) {
+        window = retained;
+    }
+    if (window == 0 || columns == 0 || minOut == nullptr || maxOut == nullptr) {
+        return 0;
+    }
+
+    const uint32_t end = total_;
+    const uint32_t start = end - window;
+
+    if (window <= columns) {
+        for (size_t c = 0; c < window; ++c) {
+            minOut[c] = maxOut[c] = raw_[(start + c) & (capacity_ - 1)];
+        }
+        return window;
+    }
+
+    // Coarsest level whose buckets fit inside one column
+    const uint32_t perColumn = window / columns;
+    uint8_t maxLevel = 0;
+    while (maxLevel < levels_ && (2UL << maxLevel) <= perColumn) {
+        maxLevel++;
+    }
+
+    for (size_t c = 0; c < columns; ++c) {
+        const uint32_t colStart = start + static_cast<uint32_t>((uint64_t)window * c / columns);
+        const uint32_t colEnd = start + static_cast<uint32_t>((uint64_t)window * (c + 1) / columns);
+        int16_t lo = INT16_MAX;
+        int16_t hi = INT16_MIN;
+        mergeRange(colStart, colEnd, maxLevel, lo, hi);
+        minOut[c] = lo;
+        maxOut[c] = hi;
+    }
+    return columns;
+}
@@ -0,0 +1,389 @@
+/**
+ * @file SettingsStore.cpp
+ * @brief Settings cache, NVS load/compare/write and the commit task
+ */
+
+#include "SettingsStore.h"
+#include "TaskMonitor.h"
+#include <esp_timer.h>
+#include <nvs.h>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 3072;
+constexpr UBaseType_t kTaskPriority = 1;
+constexpr BaseType_t kTaskCore = 1;
+
+// Load a stored value in its Preferences-compatible NVS type
+bool loadValue(nvs_handle_t handle, const char* key, SettingType type, void* out, size_t size) {
+    switch (type) {
+        case SettingType::Int:
+            return nvs_get_i32(handle, key, static_cast<int32_t*>(out)) == ESP_OK;
+        case SettingType::UInt:
+            return nvs_get_u32(handle, key, static_cast<uint32_t*>(out)) == ESP_OK;
+        case SettingType::Bool: {
+            uint8_t value = 0;
+            if (nvs_get_u8(handle, key, &value) != ESP_OK) {
+                return false;
+            }
+            *static_cast<bool*>(out) = value != 0;
+            return true;
+        }
+        case SettingType::String: {
+            size_t length = size;
+            return nvs_get_str(handle, key, static_cast<char*>(out), &length) == ESP_OK;
+        }
+        case SettingType::Float:
+        case SettingType::Bytes: {
+            // A blob of another size is a different layout; keep the default
+            size_t length = 0;
+            if (nvs_get_blob(handle, key, nullptr, &length) != ESP_OK || length != size) {
+                return false;
+            }
+            return nvs_get_blob(handle, key, out, &length) == ESP_OK;
+        }
+    }
+    return false;
+}
+
+esp_err_t storeValue(nvs_handle_t handle, const char* key, SettingType type, const void* value,
+                     size_t size) {
+    switch (type) {
+        case SettingType::Int:
+            return nvs_set_i32(handle, key, *static_cast<const int32_t*>(value));
+        case SettingType::UInt:
+            return nvs_set_u32(handle, key, *static_cast<const uint32_t*>(value));
+        case SettingType::Bool:
+            return nvs_set_u8(handle, key, *static_cast<const bool*>(value) ? 1 : 0);
+        case SettingType::String:
+            return nvs_set_str(handle, key, static_cast<const char*>(value));
+        case SettingType::Float:
+        case SettingType::Bytes:
+            return nvs_set_blob(handle, key, value, size);
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+size_t valueLength(SettingType type, const uint8_t* value, size_t size) {
+    return type == SettingType::String ? strnlen(reinterpret_cast<const char*>(value), size) + 1 : size;
+}
+
+}  // namespace
+
+// ============================================================================
+// Singleton
+// ============================================================================
+
+SettingsStore& SettingsStore::getInstance() {
+    static SettingsStore instance;
+    return instance;
+}
+
+SettingsStore::SettingsStore()
+    : entryCount_(0),
+      dirtyCount_(0),
+      lock_(portMUX_INITIALIZER_UNLOCKED),
+      commitMutex_(xSemaphoreCreateMutex()),
+      taskHandle_(nullptr),
+      commitPeriodMs_(kDefaultCommitMs),
+      firstDirtyMs_(0),
+      stats_{}
+{
+    memset(entries_, 0, sizeof(entries_));
+}
+
+bool SettingsStore::begin(uint32_t commitPeriodMs) {
+    commitPeriodMs_ = commitPeriodMs;
+    if (taskHandle_ != nullptr) {
+        return true;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        commitTask,
+        "Settings",
+        kTaskStackSize,
+        this,
+        kTaskPriority,
+        &taskHandle_,
+        kTaskCore
+    );
+
+    if (result != pdPASS) {
+        Serial.println("[Settings] Failed to create commit task");
+        taskHandle_ = nullptr;
+        return false;
+    }
+
+    TaskMonitor::watch(taskHandle_, kTaskStackSize, kTaskCore);
+    return true;
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+int16_t SettingsStore::addEntry(const char* space, const char* key, SettingType type,
+                                const void* defaultValue, size_t size) {
+    if (space == nullptr || key == nullptr || size == 0 || size > kMaxValueBytes) {
+        return -1;
+    }
+
+    // Registration runs from setup code and module init; the lock only
+    // keeps a concurrent commit from seeing a half-filled entry
+    for (size_t i = 0; i < entryCount_; ++i) {
+        if (strcmp(entries_[i].space, space) == 0 && strcmp(entries_[i].key, key) == 0) {
+            return static_cast<int16_t>(i);
+        }
+    }
+    if (entryCount_ >= kMaxEntries) {
+        Serial.printf("[Settings] Table full, %s/%s not cached\n", space, key);
+        return -1;
+    }
+
+    Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.space = space;
+    entry.key = key;
+    entry.type = type;
+    entry.size = static_cast<uint8_t>(size);
+    memcpy(entry.value, defaultValue, size);
+
+    nvs_handle_t handle;
+    if (nvs_open(space, NVS_READONLY, &handle) == ESP_OK) {
+        uint8_t stored[kMaxValueBytes] = {};
+        if (loadValue(handle, key, type, stored, size)) {
+            memcpy(entry.value, stored, size);
+        }
+        nvs_close(handle);
+    }
+
+    portENTER_CRITICAL(&lock_);
+    const size_t slot = entryCount_;
+    entries_[slot] = entry;
+    entryCount_ = slot + 1;
+    portEXIT_CRITICAL(&lock_);
+    return static_cast<int16_t>(slot);
+}
+
+SettingString SettingsStore::addString(const char* space, const char* key, const char* defaultValue,
+                                       size_t maxLength) {
+    if (maxLength > kMaxValueBytes - 1) {
+        maxLength = kMaxValueBytes - 1;
+    }
+    char initial[kMaxValueBytes] = {};
+    if (defaultValue != nullptr) {
+        strncpy(initial, defaultValue, maxLength);
+    }
+    return SettingString(addEntry(space, key, SettingType::String, initial, maxLength + 1));
+}
+
+// ============================================================================
+// Cached Values (any task)
+// ============================================================================
+
+void SettingsStore::read(int16_t slot, void* out, size_t size) const {
+    if (slot < 0 || static_cast<size_t>(slot) >= entryCount_) {
+        return;
+    }
+    const Entry& entry = entries_[slot];
+    portENTER_CRITICAL(&lock_);
+    memcpy(out, entry.value, size < entry.size ? size : entry.size);
+    portEXIT_CRITICAL(&lock_);
+}
+
+void SettingsStore::write(int16_t slot, const void* value, size_t size) {
+    if (slot < 0 || static_cast<size_t>(slot) >= entryCount_) {
+        return;
+    }
+    Entry& entry = entries_[slot];
+    uint8_t next[kMaxValueBytes] = {};
+    if (entry.type == SettingType::String) {
+        // Zero tail and forced terminator, so equal text compares equal
+        strncpy(reinterpret_cast<char*>(next), static_cast<const char*>(value), entry.size - 1);
+    } else {
+        memcpy(next, value, size < entry.size ? size : entry.size);
+    }
+
+    portENTER_CRITICAL(&lock_);
+    if (memcmp(entry.value, next, entry.size) != 0) {
+        memcpy(entry.value, next, entry.size);
+        markDirtyLocked(entry);
+    }
+    portEXIT_CRITICAL(&lock_);
+}
+
+void SettingsStore::markDirtyLocked(Entry& entry) {
+    if (entry.dirty) {
+        return;
+    }
+    entry.dirty = true;
+    if (dirtyCount_++ == 0) {
+        firstDirtyMs_ = millis();
+    }
+}
+
+size_t SettingString::get(char* buffer, size_t bufferSize) const {
+    if (buffer == nullptr || bufferSize == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    SettingsStore::getInstance().read(slot_, buffer, bufferSize);
+    buffer[bufferSize - 1] = '\0';
+    return strlen(buffer);
+}
+
+void SettingString::set(const char* text) {
+    if (text == nullptr) {
+        text = "";
+    }
+    SettingsStore::getInstance().write(slot_, text, strlen(text) + 1);
+}
+
+size_t SettingsStore::getDirtyCount() const {
+    return dirtyCount_;
+}
+
+// ============================================================================
+// Commit
+// ============================================================================
+
+void SettingsStore::flush() {
+    if (taskHandle_ != nullptr) {
+        xTaskNotify(taskHandle_, 1, eSetBits);
+    }
+}
+
+bool SettingsStore::commitNow() {
+    if (commitMutex_ == nullptr || xSemaphoreTake(commitMutex_, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    const bool ok = commit();
+    xSemaphoreGive(commitMutex_);
+    return ok;
+}
+
+bool SettingsStore::commit() {
+    const int64_t startUs = esp_timer_get_time();
+    bool ok = true;
+    uint32_t written = 0;
+    bool done[kMaxEntries] = {};
+    auto retry = [this](Entry& entry) {
+        portENTER_CRITICAL(&lock_);
+        markDirtyLocked(entry);
+        portEXIT_CRITICAL(&lock_);
+    };
+
+    // One NVS handle and one nvs_commit per namespace
+    for (size_t first = 0; first < entryCount_; ++first) {
+        if (done[first] || !entries_[first].dirty) {
+            continue;
+        }
+        const char* space = entries_[first].space;
+        nvs_handle_t handle;
+        const bool opened = nvs_open(space, NVS_READWRITE, &handle) == ESP_OK;
+        bool spaceChanged = false;
+
+        for (size_t i = first; i < entryCount_; ++i) {
+            Entry& entry = entries_[i];
+            if (done[i] || !entry.dirty || strcmp(entry.space, space) != 0) {
+                continue;
+            }
+            done[i] = true;
+
+            uint8_t value[kMaxValueBytes];
+            portENTER_CRITICAL(&lock_);
+            memcpy(value, entry.value, entry.size);
+            entry.dirty = false;
+            dirtyCount_--;
+            portEXIT_CRITICAL(&lock_);
+
+            if (!opened) {
+                retry(entry);
+                ok = false;
+                continue;
+            }
+
+            uint8_t stored[kMaxValueBytes] = {};
+            const size_t length = valueLength(entry.type, value, entry.size);
+            if (loadValue(handle, entry.key, entry.type, stored, entry.size) &&
+                memcmp(stored, value, length) == 0) {
+                stats_.keysUnchanged++;
+                continue;
+            }
+            if (storeValue(handle, entry.key, entry.type, value, length) != ESP_OK) {
+                retry(entry);
+                ok = false;
+                continue;
+            }
+            spaceChanged = true;
+            written++;
+        }
+
+        if (opened) {
+            if (spaceChanged && nvs_commit(handle) != ESP_OK) {
+                ok = false;
+            }
+            nvs_close(handle);
+        }
+    }
+
+    if (!ok) {
+        stats_.failures++;
+    }
+    if (written > 0) {
+        const uint32_t elapsedUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+        stats_.commits++;
+        stats_.keysWritten += written;
+        stats_.lastCommitUs = elapsedUs;
+        stats_.totalCommitUs += elapsedUs;
+        if (elapsedUs > stats_.maxCommitUs) {
+            stats_.maxCommitUs = elapsedUs;
+        }
+    }
+
+    return ok;
+}
+
+void SettingsStore::commitTask(void* parameter) {
+    SettingsStore* store = static_cast<SettingsStore*>(parameter);
+    const TickType_t pollTicks = pdMS_TO_TICKS(250);
+
+    while (true) {
+        uint32_t flushRequested = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &flushRequested, pollTicks);
+
+        if (store->getDirtyCount() == 0) {
+            continue;
+        }
+        if (flushRequested == 0 && millis() - store->firstDirtyMs_ < store->commitPeriodMs_) {
+            continue;
+        }
+        store->commitNow();
+    }
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+void SettingsStore::dump(Print& out) {
+    const SettingsStats& stats = stats_;
+    const uint32_t avgUs = stats.commits != 0 ? stats.totalCommitUs / stats.commits : 0;
+    out.printf("[Settings] %u keys, %u dirty, period %lu ms\n",
+               static_cast<unsigned>(entryCount_), static_cast<unsigned>(getDirtyCount()),
+               static_cast<unsigned long>(commitPeriodMs_));
+    out.printf("[Settings] commits=%lu written=%lu unchanged=%lu fail=%lu us: last=%lu avg=%lu max=%lu\n",
+               static_cast<unsigned long>(stats.commits),
+               static_cast<unsigned long>(stats.keysWritten),
+               static_cast<unsigned long>(stats.keysUnchanged),
+               static_cast<unsigned long>(stats.failures),
+               static_cast<unsigned long>(stats.lastCommitUs),
+               static_cast<unsigned long>(avgUs),
+               static_cast<unsigned long>(stats.maxCommitUs));
+    for (size_t i = 0; i < entryCount_; ++i) {
+        if (entries_[i].dirty) {
+            out.printf("  pending %s/%s\n", entries_[i].space, entries_[i].key);
+        }
+    }
+}
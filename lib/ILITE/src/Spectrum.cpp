@@ -0,0 +1,204 @@
+/**
+ * @file Spectrum.cpp
+ * @brief Windowing, radix-2 butterflies and the real-spectrum split
+ */
+
+#include "Spectrum.h"
+#include <math.h>
+
+#ifdef ILITE_SPECTRUM_ESP_DSP
+#include <dsps_fft2r.h>
+#endif
+
+namespace {
+
+constexpr float kTwoPi = 6.28318530718f;
+
+uint32_t reverseBits(uint32_t value, uint8_t bits) {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < bits; ++i) {
+        result = (result << 1) | (value & 1u);
+        value >>= 1;
+    }
+    return result;
+}
+
+#ifdef ILITE_SPECTRUM_ESP_DSP
+// esp-dsp keeps one shared twiddle table, sized for the largest transform
+bool espDspReady() {
+    static bool ready = dsps_fft2r_init_fc32(nullptr, Spectrum::kMaxPoints / 2) == ESP_OK;
+    return ready;
+}
+#endif
+
+}  // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+Spectrum::Spectrum(size_t points)
+    : points_(kMinPoints),
+      half_(0),
+      stages_(0),
+      stage_(kIdle),
+      sampleHz_(0.0f),
+      binHz_(0.0f),
+      dominantHz_(0.0f),
+      dominantMagnitude_(0.0f),
+      dominantBin_(0),
+      frames_(0)
+{
+    while (points_ * 2 <= points && points_ * 2 <= kMaxPoints) {
+        points_ *= 2;
+    }
+    half_ = points_ / 2;
+    while ((1u << stages_) < half_) {
+        stages_++;
+    }
+
+    // Periodic Hann window; tables cover the half circle the split needs
+    for (size_t n = 0; n < points_; ++n) {
+        window_[n] = 0.5f - 0.5f * cosf(kTwoPi * n / points_);
+    }
+    for (size_t k = 0; k < half_; ++k) {
+        cos_[k] = cosf(kTwoPi * k / points_);
+        sin_[k] = sinf(kTwoPi * k / points_);
+    }
+    for (size_t k = 0; k < kHalf; ++k) {
+        magnitude_[k] = 0.0f;
+    }
+}
+
+size_t Spectrum::getSliceCount() const {
+#ifdef ILITE_SPECTRUM_ESP_DSP
+    return 2;
+#else
+    return static_cast<size_t>(stages_) + 1;
+#endif
+}
+
+// ============================================================================
+// Frame
+// ============================================================================
+
+bool Spectrum::begin(const int16_t* samples, float sampleHz) {
+    if (isBusy() || samples == nullptr) {
+        return false;
+    }
+    sampleHz_ = sampleHz;
+
+    int32_t sum = 0;
+    for (size_t n = 0; n < points_; ++n) {
+        sum += samples[n];
+    }
+    const float mean = static_cast<float>(sum) / points_;
+
+    // Even samples are the real parts, odd ones the imaginary parts; the
+    // portable butterflies want bit-reversed order, esp-dsp reorders after
+    for (size_t n = 0; n < points_; ++n) {
+        const float value = (samples[n] - mean) * window_[n];
+#ifdef ILITE_SPECTRUM_ESP_DSP
+        const size_t slot = n / 2;
+#else
+        const size_t slot = reverseBits(static_cast<uint32_t>(n / 2), stages_);
+#endif
+        work_[2 * slot + (n & 1)] = value;
+    }
+
+    stage_ = 0;
+    return true;
+}
+
+bool Spectrum::step() {
+    if (!isBusy()) {
+        return false;
+    }
+    if (stage_ < stages_) {
+#ifdef ILITE_SPECTRUM_ESP_DSP
+        if (espDspReady()) {
+            dsps_fft2r_fc32(work_, static_cast<int>(half_));
+            dsps_bit_rev_fc32(work_, static_cast<int>(half_));
+        }
+        stage_ = stages_;
+#else
+        butterflyStage(stage_++);
+#endif
+        return false;
+    }
+
+    split();
+    stage_ = kIdle;
+    frames_++;
+    return true;
+}
+
+// ============================================================================
+// Transform
+// ============================================================================
+
+void Spectrum::butterflyStage(uint8_t stage) {
+    // Butterflies of span 2^(stage + 1) over half_ complex points; their
+    // twiddles are every (points / span)-th entry of the table
+    const size_t span = static_cast<size_t>(2) << stage;
+    const size_t halfSpan = span / 2;
+    const size_t stride = points_ / span;
+
+    for (size_t start = 0; start < half_; start += span) {
+        for (size_t j = 0; j < halfSpan; ++j) {
+            const float wr = cos_[j * stride];
+            const float wi = -sin_[j * stride];
+            float* a = &work_[2 * (start + j)];
+            float* b = &work_[2 * (start + j + halfSpan)];
+            const float tr = wr * b[0] - wi * b[1];
+            const float ti = wr * b[1] + wi * b[0];
+            b[0] = a[0] - tr;
+            b[1] = a[1] - ti;
+            a[0] += tr;
+            a[1] += ti;
+        }
+    }
+}
+
+void Spectrum::split() {
+    // X[k] = E[k] + W^k O[k], with E and O the spectra of the even and odd
+    // samples recovered from Z[k] and conj(Z[half - k])
+    const float scale = 4.0f / points_;     // Hann coherent gain 1/2, one-sided
+    size_t peak = 1;
+    for (size_t k = 0; k < half_; ++k) {
+        const size_t m = k == 0 ? 0 : half_ - k;
+        const float ar = work_[2 * k];
+        const float ai = work_[2 * k + 1];
+        const float br = work_[2 * m];
+        const float bi = -work_[2 * m + 1];
+
+        const float er = 0.5f * (ar + br);
+        const float ei = 0.5f * (ai + bi);
+        const float orr = 0.5f * (ai - bi);
+        const float oi = -0.5f * (ar - br);
+
+        const float xr = er + cos_[k] * orr + sin_[k] * oi;
+        const float xi = ei + cos_[k] * oi - sin_[k] * orr;
+        magnitude_[k] = sqrtf(xr * xr + xi * xi) * scale;
+
+        if (k >= 1 && magnitude_[k] > magnitude_[peak]) {
+            peak = k;
+        }
+    }
+
+    binHz_ = sampleHz_ / points_;
+    dominantBin_ = peak;
+    dominantMagnitude_ = magnitude_[peak];
+
+    // Parabola through the peak and its neighbours
+    float offset = 0.0f;
+    if (peak + 1 < half_) {
+        const float left = magnitude_[peak - 1];
+        const float right = magnitude_[peak + 1];
+        const float denominator = left - 2.0f * magnitude_[peak] + right;
+        if (denominator < 0.0f) {
+            offset = 0.5f * (left - right) / denominator;
+        }
+    }
+    dominantHz_ = (static_cast<float>(peak) + offset) * binHz_;
+}
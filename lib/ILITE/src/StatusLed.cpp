@@ -0,0 +1,225 @@
+/**
+ * @file StatusLed.cpp
+ * @brief Pattern tables, LEDC setup and the step timer
+ */
+
+#include "StatusLed.h"
+#include <driver/ledc.h>
+#include <esp_timer.h>
+
+namespace {
+
+constexpr ledc_mode_t kMode = LEDC_LOW_SPEED_MODE;
+constexpr ledc_channel_t kLedcChannel = static_cast<ledc_channel_t>(StatusLed::kChannel);
+constexpr ledc_timer_t kLedcTimer = static_cast<ledc_timer_t>(StatusLed::kTimer);
+
+const LedStep kOffSteps[] = {{0, 0, 0}};
+const LedStep kScanningSteps[] = {{255, 30, 170}, {0, 30, 170}};
+const LedStep kPairingSteps[] = {{255, 15, 85}, {0, 15, 85}};
+const LedStep kPairedSteps[] = {{255, 0, 1850}, {0, 0, 50}, {255, 0, 50}, {0, 0, 50}};
+const LedStep kLowBatterySteps[] = {{160, 900, 100}, {0, 900, 600}};
+// ... --- ...: 100 ms dots, 300 ms dashes, 100 ms gaps, then a pause
+const LedStep kErrorSteps[] = {
+    {255, 0, 100}, {0, 0, 100}, {255, 0, 100}, {0, 0, 100}, {255, 0, 100}, {0, 0, 100},
+    {255, 0, 300}, {0, 0, 100}, {255, 0, 300}, {0, 0, 100}, {255, 0, 300}, {0, 0, 100},
+    {255, 0, 100}, {0, 0, 100}, {255, 0, 100}, {0, 0, 100}, {255, 0, 100}, {0, 0, 700}
+};
+
+struct PatternTable {
+    const LedStep* steps;
+    uint8_t count;
+    const char* name;
+};
+
+template <size_t N>
+constexpr PatternTable pattern(const LedStep (&steps)[N], const char* name) {
+    return {steps, static_cast<uint8_t>(N), name};
+}
+
+const PatternTable kPatterns[] = {
+    pattern(kOffSteps, "off"),
+    pattern(kScanningSteps, "scanning"),
+    pattern(kPairingSteps, "pairing"),
+    pattern(kPairedSteps, "paired"),
+    pattern(kLowBatterySteps, "low battery"),
+    pattern(kErrorSteps, "error"),
+};
+
+static_assert(sizeof(kPatterns) / sizeof(kPatterns[0]) == static_cast<size_t>(LedPattern::Count),
+              "One table per LedPattern");
+
+// Callers change the state under g_lock; only the timer callback drives the pin
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t g_timer = nullptr;
+uint8_t g_pin = 0;
+bool g_ledc = false;
+LedPattern g_pattern = LedPattern::Off;
+uint8_t g_step = 0;                 // Next step of g_pattern
+bool g_previewPending = false;
+bool g_previewShowing = false;      // The pattern resumes at the next callback
+uint8_t g_previewLevel = 0;
+uint32_t g_previewMs = 0;
+int64_t g_fadeEndUs = 0;            // A new duty must wait for the running fade
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool StatusLed::begin(uint8_t pin) {
+    if (g_timer != nullptr) {
+        return g_ledc;
+    }
+    g_pin = pin;
+
+    ledc_timer_config_t timerConfig = {};
+    timerConfig.speed_mode = kMode;
+    timerConfig.duty_resolution = LEDC_TIMER_8_BIT;
+    timerConfig.timer_num = kLedcTimer;
+    timerConfig.freq_hz = kPwmHz;
+    timerConfig.clk_cfg = LEDC_AUTO_CLK;
+
+    ledc_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = pin;
+    channelConfig.speed_mode = kMode;
+    channelConfig.channel = kLedcChannel;
+    channelConfig.timer_sel = kLedcTimer;
+    channelConfig.intr_type = LEDC_INTR_DISABLE;
+    channelConfig.duty = 0;
+    channelConfig.hpoint = 0;
+
+    // The fade service may already be installed by other LEDC users
+    const esp_err_t fadeResult = ledc_fade_func_install(0);
+    g_ledc = ledc_timer_config(&timerConfig) == ESP_OK &&
+             ledc_channel_config(&channelConfig) == ESP_OK &&
+             (fadeResult == ESP_OK || fadeResult == ESP_ERR_INVALID_STATE);
+    if (!g_ledc) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+    }
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &StatusLed::timerCallback;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "status_led";
+    if (esp_timer_create(&timerArgs, &g_timer) != ESP_OK) {
+        g_timer = nullptr;
+        return false;
+    }
+    kick();
+    return g_ledc;
+}
+
+// ============================================================================
+// Requests (any task)
+// ============================================================================
+
+void StatusLed::setPattern(LedPattern pattern) {
+    if (pattern >= LedPattern::Count) {
+        return;
+    }
+    portENTER_CRITICAL(&g_lock);
+    const bool changed = pattern != g_pattern;
+    if (changed) {
+        g_pattern = pattern;
+        g_step = 0;
+    }
+    // A preview on show picks the new pattern up when it ends
+    const bool restart = changed && !g_previewPending && !g_previewShowing;
+    portEXIT_CRITICAL(&g_lock);
+    if (restart) {
+        kick();
+    }
+}
+
+LedPattern StatusLed::getPattern() {
+    portENTER_CRITICAL(&g_lock);
+    const LedPattern pattern = g_pattern;
+    portEXIT_CRITICAL(&g_lock);
+    return pattern;
+}
+
+void StatusLed::preview(uint8_t level, uint32_t holdMs) {
+    portENTER_CRITICAL(&g_lock);
+    g_previewLevel = level;
+    g_previewMs = holdMs;
+    g_previewPending = true;
+    portEXIT_CRITICAL(&g_lock);
+    kick();
+}
+
+void StatusLed::kick() {
+    if (g_timer == nullptr) {
+        return;
+    }
+    // Run the callback now, or when the fade in progress has finished
+    const int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&g_lock);
+    const int64_t fadeEndUs = g_fadeEndUs;
+    portEXIT_CRITICAL(&g_lock);
+    const int64_t waitUs = fadeEndUs > now ? fadeEndUs - now : 1;
+    esp_timer_stop(g_timer);
+    esp_timer_start_once(g_timer, static_cast<uint64_t>(waitUs));
+}
+
+// ============================================================================
+// Steps (esp_timer task)
+// ============================================================================
+
+void StatusLed::timerCallback(void* arg) {
+    (void)arg;
+    LedStep step;
+    bool repeat = true;
+
+    portENTER_CRITICAL(&g_lock);
+    if (g_previewPending) {
+        const uint32_t holdMs = g_previewMs > kPreviewFadeMs ? g_previewMs - kPreviewFadeMs : 0;
+        step.level = g_previewLevel;
+        step.fadeMs = kPreviewFadeMs;
+        step.holdMs = static_cast<uint16_t>(holdMs < 0xFFFF ? holdMs : 0xFFFF);
+        g_previewPending = false;
+        g_previewShowing = true;
+        g_step = 0;
+    } else {
+        const PatternTable& table = kPatterns[static_cast<size_t>(g_pattern)];
+        step = table.steps[g_step];
+        g_step = static_cast<uint8_t>((g_step + 1) % table.count);
+        g_previewShowing = false;
+        repeat = table.count > 1;
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    applyStep(step);
+    if (repeat) {
+        esp_timer_start_once(g_timer, (static_cast<uint64_t>(step.fadeMs) + step.holdMs) * 1000ULL);
+    }
+}
+
+void StatusLed::applyStep(const LedStep& step) {
+    if (!g_ledc) {
+        digitalWrite(g_pin, step.level >= 128 ? HIGH : LOW);
+        return;
+    }
+    if (step.fadeMs > 0) {
+        ledc_set_fade_with_time(kMode, kLedcChannel, step.level, step.fadeMs);
+        ledc_fade_start(kMode, kLedcChannel, LEDC_FADE_NO_WAIT);
+        const int64_t fadeEndUs = esp_timer_get_time() + static_cast<int64_t>(step.fadeMs) * 1000;
+        portENTER_CRITICAL(&g_lock);
+        g_fadeEndUs = fadeEndUs;
+        portEXIT_CRITICAL(&g_lock);
+    } else {
+        ledc_set_duty(kMode, kLedcChannel, step.level);
+        ledc_update_duty(kMode, kLedcChannel);
+    }
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+void StatusLed::dump(Print& out) {
+    out.printf("[LED] GPIO%u %s, pattern %s\n", static_cast<unsigned>(g_pin),
+               g_timer == nullptr ? "not started" : (g_ledc ? "LEDC" : "digital"),
+               kPatterns[static_cast<size_t>(getPattern())].name);
+}
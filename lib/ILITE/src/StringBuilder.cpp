@@ -6,440 +6,463 @@
 #include "InputManager.h"
 #include "IconLibrary.h"
 
-#include <vector>
 #include <string>
 #include <cctype>
 #include <cstring>
+#include <strings.h>
 #include <algorithm>
 
 namespace {
 
-enum class KeyAction {
-    Character,
-    Space,
-    Backspace,
-    Enter,
-    Cancel,
-    Shift,
-    ToggleLayout
-};
+// ============================================================================
+// Character Wheel
+// ============================================================================
+
+/// Wheel entry that accepts the shown completion instead of typing a character
+constexpr char kAcceptCompletion = '\x01';
+
+/// Letters by frequency in English text, then everything else IDs and SSIDs use
+constexpr char kLetterOrder[] = "etaoinsrhldcumwfgypbvkjxqz";
+constexpr char kOtherOrder[] = "0123456789-_. /:@#!$%&*()=+;,?";
+
+constexpr size_t kWheelMax = 1 + sizeof(kLetterOrder) + sizeof(kOtherOrder);
+constexpr size_t kMaxPredicted = 8;
+constexpr size_t kHistorySize = 8;
+constexpr size_t kHistoryLength = 48;
 
-struct KeyDef {
-    std::string label;
-    KeyAction action = KeyAction::Character;
-    char value = '\0';
-    uint8_t width = 12;
+// Common completions, kept in flash. Console commands come from the
+// terminal prompt's suggestions (CommandTable names).
+constexpr const char* kDictionary[] = {
+    "com.ilite.thegill", "com.ilite.drongaze", "com.ilite.bulky",
+    "TheGill", "DroneGaze", "Bulky", "Mech'Iane", "ILITE-", "ILITE",
+    "ESP32-", "ESP_", "esp32", "robot", "controller", "192.168.4.1",
 };
 
-using KeyRow = std::vector<KeyDef>;
+struct WheelState {
+    char entries[kWheelMax];
+    size_t count = 0;
+    size_t position = 0;
+    uint16_t version = 0;           ///< Bumped on every rebuild (redraw trigger)
+    std::string completion;         ///< Characters an accept would append
+};
 
-KeyDef makeKey(const char* label, KeyAction action, char value = '\0', uint8_t width = 12) {
-    KeyDef key;
-    key.label = label ? label : "";
-    key.action = action;
-    key.value = value;
-    key.width = width;
-    return key;
-}
+// ============================================================================
+// Session State
+// ============================================================================
 
 struct BuilderState {
     bool active = false;
-    bool uppercase = true;
-    bool symbols = false;
+    bool uppercase = false;
     size_t maxLength = 32;
     std::string title;
     std::string subtitle;
     std::string text;
-    size_t cursorIndex = 0;
-    size_t selectedRow = 0;
-    size_t selectedCol = 0;
     uint32_t lastJoystickMoveMs = 0;
+    const char* const* suggestions = nullptr;
+    size_t suggestionCount = 0;
     std::function<void(const char*)> onSubmit;
     std::function<void()> onCancel;
 };
 
 BuilderState g_state;
+WheelState g_wheel;
 uint32_t g_cursorBlink = 0;
 
-KeyRow commandRow() {
-    KeyRow row;
-    row.push_back(makeKey("^", KeyAction::Shift, 0, 14));
-    row.push_back(makeKey("123", KeyAction::ToggleLayout, 0, 16));
-    row.push_back(makeKey("___", KeyAction::Space, 0, 44));
-    row.push_back(makeKey("<<", KeyAction::Backspace, 0, 16));
-    row.push_back(makeKey("OK", KeyAction::Enter, 0, 18));
-    row.push_back(makeKey("X", KeyAction::Cancel, 0, 14));
-    return row;
-}
+// Submitted strings, newest first; they rank above the dictionary
+char g_history[kHistorySize][kHistoryLength] = {};
 
-KeyRow makeCharRow(const char* chars, uint8_t keyWidth = 12) {
-    KeyRow row;
-    for (const char* p = chars; *p; ++p) {
-        KeyDef key;
-        key.label.assign(1, *p);
-        key.action = KeyAction::Character;
-        key.value = *p;
-        key.width = keyWidth;
-        row.push_back(key);
-    }
-    return row;
-}
+// ============================================================================
+// Prediction
+// ============================================================================
 
-const std::vector<KeyRow>& letterLayout() {
-    static std::vector<KeyRow> layout = [] {
-        std::vector<KeyRow> rows;
-        rows.push_back(makeCharRow("qwertyuiop", 12));
-        rows.push_back(makeCharRow("asdfghjkl", 13));
-        rows.push_back(makeCharRow("zxcvbnm", 17));
-        rows.push_back(commandRow());
-        return rows;
-    }();
-    return layout;
+bool matchesPrefix(const char* candidate, const std::string& prefix) {
+    return candidate != nullptr && strlen(candidate) > prefix.size() &&
+           strncasecmp(candidate, prefix.c_str(), prefix.size()) == 0;
 }
 
-const std::vector<KeyRow>& symbolLayout() {
-    static std::vector<KeyRow> layout = [] {
-        std::vector<KeyRow> rows;
-        rows.push_back(makeCharRow("1234567890", 12));
-        rows.push_back(makeCharRow("!@#$%^&*()", 12));
-        rows.push_back(makeCharRow("-_=+/:.;,", 13));
-        rows.push_back(commandRow());
-        return rows;
-    }();
-    return layout;
+/// Visit completion candidates in rank order: history, caller, dictionary
+template <typename Visit>
+void forEachCandidate(Visit visit) {
+    for (size_t i = 0; i < kHistorySize; ++i) {
+        if (g_history[i][0] != '\0' && !visit(g_history[i])) {
+            return;
+        }
+    }
+    for (size_t i = 0; i < g_state.suggestionCount; ++i) {
+        if (!visit(g_state.suggestions[i])) {
+            return;
+        }
+    }
+    for (const char* entry : kDictionary) {
+        if (!visit(entry)) {
+            return;
+        }
+    }
 }
 
-const std::vector<KeyRow>& activeLayout() {
-    return g_state.symbols ? symbolLayout() : letterLayout();
+bool wheelContains(char value) {
+    return memchr(g_wheel.entries, value, g_wheel.count) != nullptr;
 }
 
-void clampCursor() {
-    if (g_state.cursorIndex > g_state.text.size()) {
-        g_state.cursorIndex = g_state.text.size();
+void addToWheel(char value) {
+    if (g_wheel.count < kWheelMax && !wheelContains(value)) {
+        g_wheel.entries[g_wheel.count++] = value;
     }
 }
 
-void applyKey(KeyAction action, char value);
-
-void ensureSelectionInBounds() {
-    const auto& rows = activeLayout();
-    if (rows.empty()) {
-        g_state.selectedRow = 0;
-        g_state.selectedCol = 0;
-        return;
-    }
-    if (g_state.selectedRow >= rows.size()) {
-        g_state.selectedRow = rows.size() - 1;
-    }
-    const KeyRow& row = rows[g_state.selectedRow];
-    if (row.empty()) {
-        g_state.selectedCol = 0;
-        return;
-    }
-    if (g_state.selectedCol >= row.size()) {
-        g_state.selectedCol = row.size() - 1;
+/**
+ * Order: accept-completion (if any), the next characters of matching
+ * candidates in rank order, then letters by frequency and everything else.
+ * Selection returns to the front, so a known ID is one press per
+ * character at worst and one press in total once it is recognized.
+ */
+void rebuildWheel() {
+    const std::string& prefix = g_state.text;
+    g_wheel.count = 0;
+    g_wheel.completion.clear();
+
+    if (prefix.size() < g_state.maxLength) {
+        size_t predicted = 0;
+        forEachCandidate([&](const char* candidate) {
+            if (!matchesPrefix(candidate, prefix)) {
+                return true;
+            }
+            if (g_wheel.completion.empty()) {
+                g_wheel.completion.assign(candidate + prefix.size());
+                if (prefix.size() + g_wheel.completion.size() > g_state.maxLength) {
+                    g_wheel.completion.resize(g_state.maxLength - prefix.size());
+                }
+                g_wheel.entries[g_wheel.count++] = kAcceptCompletion;
+            }
+            const size_t before = g_wheel.count;
+            addToWheel(candidate[prefix.size()]);
+            predicted += g_wheel.count - before;
+            return predicted < kMaxPredicted;
+        });
+
+        for (const char* p = kLetterOrder; *p; ++p) {
+            addToWheel(g_state.uppercase ? static_cast<char>(toupper(*p)) : *p);
+        }
+        for (const char* p = kOtherOrder; *p; ++p) {
+            addToWheel(*p);
+        }
     }
+
+    g_wheel.position = 0;
+    g_wheel.version++;
 }
 
-void moveSelection(int dx, int dy) {
-    const auto& rows = activeLayout();
-    if (rows.empty()) {
+void rememberSubmission(const char* text) {
+    if (text == nullptr || text[0] == '\0' || strlen(text) >= kHistoryLength) {
         return;
     }
-
-    int row = static_cast<int>(g_state.selectedRow);
-    int col = static_cast<int>(g_state.selectedCol);
-
-    if (dy != 0) {
-        row += dy;
-        row = std::max(0, std::min(row, static_cast<int>(rows.size()) - 1));
-        col = std::min(col, static_cast<int>(rows[row].size()) - 1);
-    }
-
-    if (dx != 0) {
-        const int rowLen = static_cast<int>(rows[row].size());
-        if (rowLen > 0) {
-            col = (col + dx) % rowLen;
-            if (col < 0) col += rowLen;
-        } else {
-            col = 0;
+    // Move to the front, dropping an older copy or the oldest entry
+    size_t slot = kHistorySize - 1;
+    for (size_t i = 0; i < kHistorySize; ++i) {
+        if (strcmp(g_history[i], text) == 0) {
+            slot = i;
+            break;
         }
     }
-
-    g_state.selectedRow = static_cast<size_t>(row);
-    g_state.selectedCol = static_cast<size_t>(std::max(col, 0));
+    for (size_t i = slot; i > 0; --i) {
+        memcpy(g_history[i], g_history[i - 1], kHistoryLength);
+    }
+    strncpy(g_history[0], text, kHistoryLength - 1);
+    g_history[0][kHistoryLength - 1] = '\0';
 }
 
-void applyKey(KeyAction action, char value) {
-    switch (action) {
-    case KeyAction::Enter:
+// ============================================================================
+// Editing
+// ============================================================================
+
+void finish(bool submit) {
+    g_state.active = false;
+    if (submit) {
+        rememberSubmission(g_state.text.c_str());
         if (g_state.onSubmit) {
             g_state.onSubmit(g_state.text.c_str());
         }
-        g_state.active = false;
-        ScreenRegistry::back();
-        AudioRegistry::play("edit_save");
-        return;
-
-    case KeyAction::Cancel:
-        if (g_state.onCancel) {
-            g_state.onCancel();
-        }
-        g_state.active = false;
-        ScreenRegistry::back();
-        AudioRegistry::play("edit_cancel");
-        return;
+    } else if (g_state.onCancel) {
+        g_state.onCancel();
+    }
+    ScreenRegistry::back();
+    AudioRegistry::play(submit ? "edit_save" : "edit_cancel");
+}
 
-    case KeyAction::Backspace:
-        if (g_state.cursorIndex > 0 && !g_state.text.empty()) {
-            g_state.text.erase(g_state.cursorIndex - 1, 1);
-            g_state.cursorIndex--;
-            AudioRegistry::play("menu_back");
-        }
+void insertSelected() {
+    if (g_wheel.count == 0) {
         return;
-
-    case KeyAction::Space:
-        if (g_state.text.size() < g_state.maxLength) {
-            g_state.text.insert(g_state.cursorIndex, 1, ' ');
-            g_state.cursorIndex++;
-            AudioRegistry::play("menu_select");
-        }
+    }
+    const char value = g_wheel.entries[g_wheel.position];
+    if (value == kAcceptCompletion) {
+        g_state.text += g_wheel.completion;
+    } else if (g_state.text.size() < g_state.maxLength) {
+        g_state.text.push_back(value);
+    } else {
         return;
+    }
+    AudioRegistry::play("menu_select");
+    rebuildWheel();
+}
 
-    case KeyAction::Shift:
-        g_state.uppercase = !g_state.uppercase;
-        AudioRegistry::play("toggle");
-        return;
+void backspace() {
+    if (!g_state.text.empty()) {
+        g_state.text.pop_back();
+        AudioRegistry::play("menu_back");
+        rebuildWheel();
+    }
+}
 
-    case KeyAction::ToggleLayout:
-        g_state.symbols = !g_state.symbols;
-        g_state.selectedRow = 0;
-        g_state.selectedCol = 0;
-        AudioRegistry::play("toggle");
-        return;
+void toggleCase() {
+    g_state.uppercase = !g_state.uppercase;
+    AudioRegistry::play("toggle");
+    // Keep the selection on the same letter in its other case
+    const char selected = g_wheel.count > 0 ? g_wheel.entries[g_wheel.position] : '\0';
+    rebuildWheel();
+    const char flipped = g_state.uppercase ? static_cast<char>(toupper(selected))
+                                           : static_cast<char>(tolower(selected));
+    const char* found = static_cast<const char*>(memchr(g_wheel.entries, flipped, g_wheel.count));
+    if (found != nullptr) {
+        g_wheel.position = static_cast<size_t>(found - g_wheel.entries);
+    }
+}
 
-    case KeyAction::Character: {
-        if (g_state.text.size() >= g_state.maxLength) {
-            return;
-        }
-        char ch = value;
-        if (!g_state.symbols) {
-            ch = g_state.uppercase ? static_cast<char>(toupper(ch))
-                                   : static_cast<char>(tolower(ch));
-        }
-        g_state.text.insert(g_state.cursorIndex, 1, ch);
-        g_state.cursorIndex++;
-        AudioRegistry::play("menu_select");
+void moveWheel(int delta) {
+    if (g_wheel.count == 0) {
         return;
     }
+    const int count = static_cast<int>(g_wheel.count);
+    int position = (static_cast<int>(g_wheel.position) + delta) % count;
+    if (position < 0) {
+        position += count;
     }
+    g_wheel.position = static_cast<size_t>(position);
 }
 
-void drawKey(DisplayCanvas& canvas, const KeyDef& key, int16_t x, int16_t y, bool selected) {
-    const int16_t keyHeight = 11;  // Slightly smaller height
-    const int16_t width = key.width ? key.width : 12;
-
-    canvas.drawRect(x, y, width, keyHeight, false);
-    if (selected) {
-        // Filled selection for ultra compact look
-        canvas.drawRect(x + 1, y + 1, width - 2, keyHeight - 2, true);
-        canvas.setDrawColor(0);
-    }
+// ============================================================================
+// Drawing
+// ============================================================================
+
+// The screen is registered as modal so ScreenRegistry does not clear the
+// canvas: each frame redraws only the regions whose content changed and
+// the canvas' tile diff sends just those to the panel
+constexpr int16_t kTextY = 11;
+constexpr int16_t kTextH = 16;
+constexpr int16_t kWheelY = 30;
+constexpr int16_t kWheelH = 22;
+constexpr int16_t kFooterY = 54;
+constexpr int16_t kCellW = 11;
+constexpr uint32_t kFullRedrawMs = 1000;      // Repaint everything now and then regardless
+
+struct DrawnState {
+    bool valid = false;
+    uint32_t fullMs = 0;
+    bool uppercase = false;
+    std::string text;
+    bool cursorOn = false;
+    uint16_t wheelVersion = 0;
+    size_t wheelPosition = 0;
+};
 
-    canvas.setFont(DisplayCanvas::TINY);
-    // Center the text in the key
-    int16_t textX = x + (width - static_cast<int16_t>(key.label.length() * 4)) / 2;
-    if (textX < x + 1) textX = x + 1;
-    canvas.drawText(textX, y + 8, key.label.c_str());
+DrawnState g_drawn;
 
-    if (selected) {
-        canvas.setDrawColor(1);
-    }
+void clearRegion(DisplayCanvas& canvas, int16_t x, int16_t y, int16_t w, int16_t h) {
+    canvas.setDrawColor(0);
+    canvas.drawRect(x, y, w, h, true);
+    canvas.setDrawColor(1);
 }
 
-void drawTextArea(DisplayCanvas& canvas) {
+void drawHeader(DisplayCanvas& canvas) {
+    clearRegion(canvas, 0, 0, 128, kTextY);
     canvas.setFont(DisplayCanvas::SMALL);
-    int16_t boxX = 4;
-    int16_t boxY = 18;
-    int16_t boxW = 120;
-    int16_t boxH = 16;
-    canvas.drawRect(boxX, boxY, boxW, boxH, false);
-
-    std::string preview = g_state.text;
-    if (preview.size() > g_state.maxLength) {
-        preview.resize(g_state.maxLength);
-    }
-
-    size_t maxChars = static_cast<size_t>(boxW / 6);
-    size_t start = 0;
-    if (preview.size() > maxChars) {
-        if (g_state.cursorIndex > maxChars) {
-            start = g_state.cursorIndex - maxChars;
-        }
-        preview = preview.substr(start, maxChars);
-    }
+    const char* title = g_state.title.empty() ? "Text Input" : g_state.title.c_str();
+    canvas.drawText(0, 8, title);
+    canvas.setFont(DisplayCanvas::TINY);
+    canvas.drawTextRight(127, 7, g_state.uppercase ? "ABC" : "abc");
+}
 
-    canvas.drawText(boxX + 2, boxY + 12, preview.c_str());
+void drawTextArea(DisplayCanvas& canvas, bool cursorOn) {
+    clearRegion(canvas, 0, kTextY, 128, kTextH);
+    const int16_t boxX = 2;
+    const int16_t boxW = 124;
+    canvas.drawRect(boxX, kTextY, boxW, kTextH, false);
 
-    bool cursorVisible = ((millis() - g_cursorBlink) % 1000) < 500;
-    if (cursorVisible) {
-        size_t cursorPos = g_state.cursorIndex >= start ? g_state.cursorIndex - start : 0;
-        if (cursorPos > preview.size()) {
-            cursorPos = preview.size();
-        }
-        int16_t cursorX = boxX + 2 + static_cast<int16_t>(cursorPos * 6);
-        canvas.drawVLine(cursorX, boxY + 4, boxH - 8);
+    // Keep the end of the text in view, leaving room for a hint of the completion
+    canvas.setFont(DisplayCanvas::SMALL);
+    const size_t maxChars = static_cast<size_t>((boxW - 4) / 6);
+    const std::string& text = g_state.text;
+    const size_t start = text.size() + 4 > maxChars ? text.size() + 4 - maxChars : 0;
+    const char* visible = text.c_str() + std::min(start, text.size());
+    canvas.drawText(boxX + 2, kTextY + 12, visible);
+
+    const int16_t endX = boxX + 2 + static_cast<int16_t>(strlen(visible) * 6);
+    if (!g_wheel.completion.empty()) {
+        // Completion in the small font, underlined with dots
+        canvas.setFont(DisplayCanvas::TINY);
+        canvas.drawText(endX + 1, kTextY + 11, g_wheel.completion.c_str());
+        const int16_t width = static_cast<int16_t>(g_wheel.completion.size() * 4);
+        canvas.drawPatternLine(endX + 1, kTextY + 13, endX + width, kTextY + 13, 0x55);
+    }
+    if (cursorOn) {
+        canvas.drawVLine(endX, kTextY + 3, kTextH - 6);
     }
 }
 
-void drawKeyboardScreen(DisplayCanvas& canvas) {
-    canvas.clear();
+void drawWheel(DisplayCanvas& canvas) {
+    clearRegion(canvas, 0, kWheelY, 128, kWheelH);
+    if (g_wheel.count == 0) {
+        canvas.setFont(DisplayCanvas::SMALL);
+        canvas.drawTextCentered(kWheelY + 14, "Full - B3 to save");
+        return;
+    }
 
+    // Selected entry in the middle cell, neighbours fanning out to the edges
+    const int16_t centerX = 64 - kCellW / 2;
+    const int side = 5;
     canvas.setFont(DisplayCanvas::SMALL);
-    const char* title = g_state.title.empty() ? "Text Input" : g_state.title.c_str();
-    canvas.drawTextCentered(8, title);
+    for (int offset = -side; offset <= side; ++offset) {
+        if (g_wheel.count <= static_cast<size_t>(2 * side) &&
+            (offset < -static_cast<int>(g_wheel.position) ||
+             offset >= static_cast<int>(g_wheel.count - g_wheel.position))) {
+            continue;   // Short wheel: don't show entries twice
+        }
+        const int count = static_cast<int>(g_wheel.count);
+        const size_t index = static_cast<size_t>(((static_cast<int>(g_wheel.position) + offset) % count + count) % count);
+        const char value = g_wheel.entries[index];
+        const int16_t x = centerX + offset * kCellW;
+
+        char label[2] = {value, '\0'};
+        const char* text = label;
+        if (value == kAcceptCompletion) {
+            text = ">";
+        } else if (value == ' ') {
+            text = "_";
+        }
 
-    if (!g_state.subtitle.empty()) {
-        canvas.setFont(DisplayCanvas::TINY);
-        canvas.drawTextCentered(16, g_state.subtitle.c_str());
+        if (offset == 0) {
+            canvas.drawRect(x - 1, kWheelY + 2, kCellW + 2, kWheelH - 4, true);
+            canvas.setDrawColor(0);
+            canvas.drawText(x + 3, kWheelY + 15, text);
+            canvas.setDrawColor(1);
+        } else {
+            canvas.drawText(x + 3, kWheelY + 15, text);
+        }
     }
 
+    // What the selected entry does, under the wheel
     canvas.setFont(DisplayCanvas::TINY);
-    canvas.drawText(100, 10, g_state.symbols ? "SYM" : (g_state.uppercase ? "ABC" : "abc"));
-
-    drawTextArea(canvas);
-
-    const auto& layout = activeLayout();
-    const int16_t startX = 2;  // Tighter margins
-    int16_t y = 38;             // Start keyboard higher
-    const int16_t keyHeight = 11;  // Match drawKey height
-    const int16_t rowSpacing = 1;  // Tighter spacing
-
-    for (size_t rowIndex = 0; rowIndex < layout.size(); ++rowIndex) {
-        const KeyRow& row = layout[rowIndex];
-        int16_t x = startX;
-        for (size_t col = 0; col < row.size(); ++col) {
-            bool selected = (rowIndex == g_state.selectedRow && col == g_state.selectedCol);
-            drawKey(canvas, row[col], x, y, selected);
-            x += (row[col].width ? row[col].width : 12) + 1;  // Tighter key spacing
-        }
-        y += keyHeight + rowSpacing;
+    if (g_wheel.entries[g_wheel.position] == kAcceptCompletion) {
+        canvas.drawTextCentered(kWheelY + kWheelH - 1, "complete");
     }
 }
 
-void handleJoystickNavigation() {
-    InputManager& inputs = InputManager::getInstance();
-    const float threshold = 0.5f;
-    uint32_t now = millis();
-
-    if (now - g_state.lastJoystickMoveMs < 160) {
-        return;
-    }
-
-    float x = inputs.getJoystickA_X();
-    float y = inputs.getJoystickA_Y();
-    bool moved = false;
+void drawFooter(DisplayCanvas& canvas) {
+    clearRegion(canvas, 0, kFooterY, 128, 64 - kFooterY);
+    canvas.setFont(DisplayCanvas::TINY);
+    const char* hint = g_state.subtitle.empty() ? "B1:Del B2:Aa B3:OK" : g_state.subtitle.c_str();
+    canvas.drawTextCentered(62, hint);
+}
 
-    if (x > threshold) {
-        moveSelection(1, 0);
-        moved = true;
-    } else if (x < -threshold) {
-        moveSelection(-1, 0);
-        moved = true;
+void drawKeyboardScreen(DisplayCanvas& canvas) {
+    const uint32_t now = millis();
+    const bool full = !g_drawn.valid || now - g_drawn.fullMs >= kFullRedrawMs;
+    const bool cursorOn = ((now - g_cursorBlink) % 1000) < 500;
+
+    if (full) {
+        canvas.clear();
+        g_drawn.valid = true;
+        g_drawn.fullMs = now;
+        drawFooter(canvas);
+    }
+    if (full || g_drawn.uppercase != g_state.uppercase) {
+        drawHeader(canvas);
+        g_drawn.uppercase = g_state.uppercase;
+    }
+    if (full || g_drawn.cursorOn != cursorOn || g_drawn.text != g_state.text ||
+        g_drawn.wheelVersion != g_wheel.version) {
+        drawTextArea(canvas, cursorOn);
+        g_drawn.cursorOn = cursorOn;
+        g_drawn.text = g_state.text;
+    }
+    if (full || g_drawn.wheelVersion != g_wheel.version || g_drawn.wheelPosition != g_wheel.position) {
+        drawWheel(canvas);
+        g_drawn.wheelVersion = g_wheel.version;
+        g_drawn.wheelPosition = g_wheel.position;
     }
+}
 
-    // Inverted joystick: y > threshold = down, y < -threshold = up
-    if (y > threshold) {
-        moveSelection(0, 1);
-        moved = true;
-    } else if (y < -threshold) {
-        moveSelection(0, -1);
-        moved = true;
-    }
+// ============================================================================
+// Input
+// ============================================================================
 
-    if (moved) {
-        g_state.lastJoystickMoveMs = now;
+void handleJoystickNavigation() {
+    InputManager& inputs = InputManager::getInstance();
+    const float threshold = 0.5f;
+    const uint32_t now = millis();
+
+    // Joystick A X spins the wheel (faster when pushed fully), Y up accepts
+    // the completion and Y down deletes
+    if (now - g_state.lastJoystickMoveMs >= 160) {
+        const float x = inputs.getJoystickA_X();
+        const float y = inputs.getJoystickA_Y();
+        bool moved = true;
+        if (x > threshold) {
+            moveWheel(x > 0.9f ? 4 : 1);
+        } else if (x < -threshold) {
+            moveWheel(x < -0.9f ? -4 : -1);
+        } else if (y < -threshold && !g_wheel.completion.empty()) {
+            g_wheel.position = 0;
+            insertSelected();
+        } else if (y > threshold) {
+            backspace();
+        } else {
+            moved = false;
+        }
+        if (moved) {
+            g_state.lastJoystickMoveMs = now;
+        }
     }
 
     if (inputs.getJoystickButtonA_Pressed() || inputs.getJoystickButtonB_Pressed()) {
-        const auto& rows = activeLayout();
-        if (!rows.empty() && g_state.selectedRow < rows.size() &&
-            g_state.selectedCol < rows[g_state.selectedRow].size()) {
-            const KeyDef& key = rows[g_state.selectedRow][g_state.selectedCol];
-            applyKey(key.action, key.value);
-        }
+        insertSelected();
     }
 }
 
 void updateKeyboard() {
-    handleJoystickNavigation();
-}
-
-void onEncoderRotate(int delta) {
-    if (delta > 0) {
-        for (int i = 0; i < delta; ++i) moveSelection(1, 0);
-    } else {
-        for (int i = 0; i < -delta; ++i) moveSelection(-1, 0);
+    if (g_state.active) {
+        handleJoystickNavigation();
     }
 }
 
-void onEncoderPress() {
-    const auto& rows = activeLayout();
-    if (rows.empty()) return;
-    if (g_state.selectedRow >= rows.size()) return;
-    const KeyRow& row = rows[g_state.selectedRow];
-    if (row.empty() || g_state.selectedCol >= row.size()) return;
-    applyKey(row[g_state.selectedCol].action, row[g_state.selectedCol].value);
+void finishAccepted() {
+    finish(true);
 }
 
-void onButton(uint8_t index) {
-    switch (index) {
-        case 0: applyKey(KeyAction::Backspace, 0); break;
-        case 1: applyKey(KeyAction::Shift, 0); break;
-        case 2: applyKey(KeyAction::Enter, 0); break;
-    }
+void onShowKeyboard() {
+    g_cursorBlink = millis();
+    g_state.lastJoystickMoveMs = 0;
+    g_drawn.valid = false;
 }
 
+constexpr Screen kKeyboardScreen[] = {{
+    "framework.string_builder", "Keyboard", ICON_TUNING,
+    &drawKeyboardScreen, &updateKeyboard,
+    &moveWheel, &insertSelected,
+    &backspace, &toggleCase, &finishAccepted,
+    true,       // Draws its own background (partial redraw)
+    nullptr, &onShowKeyboard, nullptr
+}};
+
 void registerScreen() {
     static bool registered = false;
     if (registered) {
         return;
     }
 
-    Screen screen;
-    screen.id = "framework.string_builder";
-    screen.title = "Keyboard";
-    screen.icon = ICON_TUNING;
-    screen.drawFunc = [](DisplayCanvas& canvas) {
-        drawKeyboardScreen(canvas);
-    };
-    screen.updateFunc = []() { updateKeyboard(); };
-    screen.onEncoderRotate = [](int delta) { onEncoderRotate(delta); };
-    screen.onEncoderPress = []() { onEncoderPress(); };
-    screen.onButton1 = []() { onButton(0); };
-    screen.onButton2 = []() { onButton(1); };
-    screen.onButton3 = []() { onButton(2); };
-    screen.isModal = false;
-    screen.onShow = []() {
-        g_cursorBlink = millis();
-        g_state.lastJoystickMoveMs = 0;
-    };
-    ScreenRegistry::registerScreen(screen);
+    ScreenRegistry::registerTable(kKeyboardScreen, 1);
     registered = true;
 }
 
-const KeyDef* currentKey() {
-    const auto& rows = activeLayout();
-    if (rows.empty() || g_state.selectedRow >= rows.size()) {
-        return nullptr;
-    }
-    const KeyRow& row = rows[g_state.selectedRow];
-    if (row.empty() || g_state.selectedCol >= row.size()) {
-        return nullptr;
-    }
-    return &row[g_state.selectedCol];
-}
-
 } // namespace
 
 bool StringBuilder::begin(const StringBuilderConfig& config) {
@@ -449,22 +472,22 @@ bool StringBuilder::begin(const StringBuilderConfig& config) {
     registerScreen();
 
     g_state.active = true;
-    g_state.uppercase = true;
-    g_state.symbols = false;
+    g_state.uppercase = false;
     g_state.maxLength = config.maxLength > 0 ? config.maxLength : 1;
     g_state.title = config.title ? config.title : "Text Input";
     g_state.subtitle = config.subtitle ? config.subtitle : "";
+    g_state.suggestions = config.suggestions;
+    g_state.suggestionCount = config.suggestions != nullptr ? config.suggestionCount : 0;
     g_state.onSubmit = config.onSubmit;
     g_state.onCancel = config.onCancel;
     g_state.text = config.initialValue ? config.initialValue : "";
     if (g_state.text.size() > g_state.maxLength) {
         g_state.text.resize(g_state.maxLength);
     }
-    g_state.cursorIndex = g_state.text.size();
-    g_state.selectedRow = 0;
-    g_state.selectedCol = 0;
-    g_cursorBlink = millis();
     g_state.lastJoystickMoveMs = 0;
+    g_cursorBlink = millis();
+    g_drawn.valid = false;
+    rebuildWheel();
 
     ScreenRegistry::show("framework.string_builder");
     return true;
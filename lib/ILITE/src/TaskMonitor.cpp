@@ -0,0 +1,230 @@
+/**
+ * @file TaskMonitor.cpp
+ * @brief Stack watermark / CPU load sampling and the task monitor screen
+ */
+
+#include "TaskMonitor.h"
+#include "ScreenRegistry.h"
+#include "connection_log.h"
+#include "LogChannels.h"
+#include "PowerManager.h"
+#include <esp_freertos_hooks.h>
+#include <cstring>
+
+TaskSample TaskMonitor::tasks_[TaskMonitor::kMaxTasks];
+size_t TaskMonitor::taskCount_ = 0;
+volatile uint32_t TaskMonitor::idleCount_[TaskMonitor::kCoreCount] = {};
+volatile bool TaskMonitor::idleSlept_[TaskMonitor::kCoreCount] = {};
+uint32_t TaskMonitor::idleMax_[TaskMonitor::kCoreCount] = {};
+uint8_t TaskMonitor::coreLoad_[TaskMonitor::kCoreCount] = {};
+bool TaskMonitor::highLoadReported_[TaskMonitor::kCoreCount] = {};
+uint32_t TaskMonitor::lastSampleMs_ = 0;
+
+#define TASK_MONITOR_RUNTIME_STATS \
+    (configUSE_TRACE_FACILITY == 1 && configGENERATE_RUN_TIME_STATS == 1)
+
+namespace {
+
+#if TASK_MONITOR_RUNTIME_STATS
+constexpr size_t kMaxSystemTasks = 24;
+TaskStatus_t systemTasks[kMaxSystemTasks];
+uint32_t lastRunTime[TaskMonitor::kMaxTasks] = {};
+uint32_t lastTotalRunTime = 0;
+#endif
+
+void drawTaskScreen(DisplayCanvas& canvas) {
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+
+    canvas.drawTextF(0, 6, "Tasks  c0 %u%%  c1 %u%%",
+                     TaskMonitor::getCoreLoad(0), TaskMonitor::getCoreLoad(1));
+    canvas.drawLine(0, 8, 127, 8);
+
+    canvas.drawText(48, 14, "free/stack");
+    canvas.drawText(106, 14, "cpu");
+
+    int16_t y = 21;
+    for (size_t i = 0; i < TaskMonitor::getTaskCount() && y <= 57; ++i, y += 6) {
+        const TaskSample* task = TaskMonitor::getTask(i);
+        char name[10];
+        strncpy(name, task->name, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+        canvas.drawText(0, y, name);
+        canvas.drawTextF(48, y, "%lu/%lu",
+                         static_cast<unsigned long>(task->stackFree),
+                         static_cast<unsigned long>(task->stackSize));
+        if (task->cpuPercent >= 0) {
+            canvas.drawTextF(106, y, "%d%%", task->cpuPercent);
+        } else {
+            canvas.drawText(106, y, "-");
+        }
+    }
+
+    canvas.drawText(0, 63, "B1:Back");
+}
+
+constexpr Screen kTaskScreen[] = {{
+    "framework.tasks", "Tasks", ICON_INFO,
+    &drawTaskScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, nullptr, nullptr,
+    false
+}};
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool TaskMonitor::idleHook(size_t core) {
+    idleCount_[core]++;
+    // Spinning keeps the count proportional to idle time. While the
+    // controller is idle, let the core wait for interrupts (and light
+    // sleep) instead; the count is then meaningless for this period.
+    const bool sleep = PowerManager::isIdle();
+    if (sleep) {
+        idleSlept_[core] = true;
+    }
+    return sleep;
+}
+
+bool TaskMonitor::idleHook0() {
+    return idleHook(0);
+}
+
+bool TaskMonitor::idleHook1() {
+    return idleHook(1);
+}
+
+void TaskMonitor::begin() {
+    static bool started = false;
+    if (started) {
+        return;
+    }
+    started = true;
+
+    esp_register_freertos_idle_hook_for_cpu(&TaskMonitor::idleHook0, 0);
+    esp_register_freertos_idle_hook_for_cpu(&TaskMonitor::idleHook1, 1);
+    lastSampleMs_ = millis();
+
+    ScreenRegistry::registerTable(kTaskScreen, 1);
+}
+
+bool TaskMonitor::watch(TaskHandle_t handle, uint32_t stackSize, int8_t core) {
+    if (handle == nullptr || taskCount_ >= kMaxTasks) {
+        return false;
+    }
+
+    TaskSample& task = tasks_[taskCount_];
+    task = TaskSample{};
+    task.handle = handle;
+    task.name = pcTaskGetName(handle);
+    task.stackSize = stackSize;
+    task.stackFree = stackSize;
+    task.core = core;
+    taskCount_++;
+    return true;
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void TaskMonitor::update() {
+    const uint32_t now = millis();
+    if (now - lastSampleMs_ >= kSampleIntervalMs) {
+        sample();
+    }
+}
+
+void TaskMonitor::sample() {
+    lastSampleMs_ = millis();
+
+    // Core load from idle hook counts
+    for (size_t core = 0; core < kCoreCount; ++core) {
+        const uint32_t count = idleCount_[core];
+        idleCount_[core] = 0;
+        if (idleSlept_[core]) {
+            idleSlept_[core] = false;   // Keep the previous load
+            continue;
+        }
+        if (count > idleMax_[core]) {
+            idleMax_[core] = count;
+        }
+        const uint32_t idlePercent = idleMax_[core] ? (count * 100ULL) / idleMax_[core] : 100;
+        coreLoad_[core] = static_cast<uint8_t>(100 - (idlePercent > 100 ? 100 : idlePercent));
+
+        const bool high = coreLoad_[core] >= kHighLoadPercent;
+        if (high && !highLoadReported_[core]) {
+            ILITE_LOG(SYSTEM, LOG_WARN, "Core %u load %u%%", static_cast<unsigned>(core), coreLoad_[core]);
+        }
+        highLoadReported_[core] = high;
+    }
+
+#if TASK_MONITOR_RUNTIME_STATS
+    uint32_t totalRunTime = 0;
+    const UBaseType_t systemCount = uxTaskGetSystemState(systemTasks, kMaxSystemTasks, &totalRunTime);
+    const uint32_t totalDelta = totalRunTime - lastTotalRunTime;
+    lastTotalRunTime = totalRunTime;
+#endif
+
+    for (size_t i = 0; i < taskCount_; ++i) {
+        TaskSample& task = tasks_[i];
+
+        // ESP-IDF reports the watermark in bytes
+        task.stackFree = uxTaskGetStackHighWaterMark(task.handle);
+        task.priority = static_cast<uint8_t>(uxTaskPriorityGet(task.handle));
+
+        const bool low = task.stackFree * 100 < task.stackSize * kLowStackPercent;
+        if (low && !task.lowStackReported) {
+            ILITE_LOG(SYSTEM, LOG_WARN, "Stack low: %s %lu/%lu", task.name,
+                              static_cast<unsigned long>(task.stackFree),
+                              static_cast<unsigned long>(task.stackSize));
+            task.lowStackReported = true;
+        }
+
+#if TASK_MONITOR_RUNTIME_STATS
+        task.cpuPercent = -1;
+        for (UBaseType_t s = 0; s < systemCount; ++s) {
+            if (systemTasks[s].xHandle != task.handle) {
+                continue;
+            }
+            const uint32_t runTime = systemTasks[s].ulRunTimeCounter;
+            if (lastRunTime[i] != 0 && totalDelta != 0) {
+                uint32_t percent = static_cast<uint32_t>(((runTime - lastRunTime[i]) * 100ULL) / totalDelta);
+                task.cpuPercent = static_cast<int8_t>(percent > 100 ? 100 : percent);
+            }
+            lastRunTime[i] = runTime;
+            break;
+        }
+#endif
+    }
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+const TaskSample* TaskMonitor::getTask(size_t index) {
+    return index < taskCount_ ? &tasks_[index] : nullptr;
+}
+
+uint8_t TaskMonitor::getCoreLoad(size_t core) {
+    return core < kCoreCount ? coreLoad_[core] : 0;
+}
+
+void TaskMonitor::dump(Print& out) {
+    out.printf("[TaskMonitor] core0 %u%%  core1 %u%%\n", coreLoad_[0], coreLoad_[1]);
+    out.println("task          core prio  free/stack  cpu");
+    for (size_t i = 0; i < taskCount_; ++i) {
+        const TaskSample& task = tasks_[i];
+        out.printf("%-14s %3d %4u %5lu/%-5lu %3d%%\n",
+                   task.name,
+                   task.core,
+                   static_cast<unsigned>(task.priority),
+                   static_cast<unsigned long>(task.stackFree),
+                   static_cast<unsigned long>(task.stackSize),
+                   task.cpuPercent);
+    }
+}
@@ -0,0 +1,313 @@
+/**
+ * @file TdmaSlots.cpp
+ * @brief Slot beacons, master election, slot claims and phase error
+ */
+
+#include "TdmaSlots.h"
+#include "espnow_discovery.h"
+#include "ScreenRegistry.h"
+#include "DisplayCanvas.h"
+#include "IconLibrary.h"
+#include "LogChannels.h"
+#include <esp_timer.h>
+#include <cstring>
+
+namespace {
+
+struct Node {
+    bool inUse;
+    uint8_t mac[6];
+    uint8_t slot;
+    uint32_t periodUs;
+    uint32_t lastHeardMs;
+    int64_t anchorUs;               ///< Its superframe start, on our esp_timer
+};
+
+// Node table and stats: written by RxTask (beacons) and CommTask (ticks)
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+Node g_nodes[TdmaSlots::kMaxNodes] = {};
+TdmaSlotStats g_stats;
+
+bool g_enabled = false;
+uint8_t g_selfMac[6] = {};
+
+// CommTask only
+uint32_t g_listenUntilMs = 0;
+uint32_t g_lastBeaconMs = 0;
+int64_t g_anchorUs = 0;
+
+int64_t positiveMod(int64_t value, uint32_t modulus) {
+    const int64_t rest = value % modulus;
+    return rest < 0 ? rest + modulus : rest;
+}
+
+void drawSlotScreen(DisplayCanvas& canvas) {
+    const TdmaSlotStats stats = TdmaSlots::getStats();
+    canvas.clear();
+    canvas.setFont(DisplayCanvas::TINY);
+    canvas.drawTextF(0, 6, "Slots  %u controllers", static_cast<unsigned>(stats.nodes + 1));
+    canvas.drawLine(0, 8, 127, 8);
+
+    if (!TdmaSlots::isEnabled()) {
+        canvas.drawText(0, 22, "TDMA slots off");
+        canvas.drawText(0, 63, "B1:Back");
+        return;
+    }
+
+    // One box per slot: ours filled, another controller's crossed
+    for (uint8_t i = 0; i < TdmaSlots::kSlots; ++i) {
+        const int16_t x = static_cast<int16_t>(i * 16);
+        const bool mine = stats.slot == i;
+        const bool taken = (stats.occupied & (1u << i)) != 0;
+        canvas.drawRect(x + 1, 12, 14, 12, mine);
+        if (taken && !mine) {
+            canvas.drawLine(x + 1, 12, x + 14, 23);
+            canvas.drawLine(x + 14, 12, x + 1, 23);
+        }
+        canvas.drawTextF(x + 6, 31, "%u", static_cast<unsigned>(i));
+    }
+
+    if (stats.slot == TdmaSlots::kNoSlot) {
+        canvas.drawText(0, 40, "Listening...");
+    } else {
+        char master[18];
+        EspNowDiscovery::macToString(stats.masterMac, master, sizeof(master));
+        canvas.drawTextF(0, 40, "Master %s", stats.master ? "this one" : master + 9);
+        canvas.drawTextF(0, 47, "Error %ldus  realigned %lu", static_cast<long>(stats.lastErrorUs),
+                         static_cast<unsigned long>(stats.realigns));
+    }
+    canvas.drawTextF(0, 54, "Beacons %lu/%lu", static_cast<unsigned long>(stats.beaconsSent),
+                     static_cast<unsigned long>(stats.beaconsHeard));
+    canvas.drawText(0, 63, "B1:Back");
+}
+
+constexpr Screen kSlotScreen[] = {{
+    "framework.slots", "Slots", ICON_SIGNAL_FULL,
+    &drawSlotScreen, nullptr,
+    nullptr, nullptr,
+    &ScreenRegistry::goBack, nullptr, nullptr,
+    false
+}};
+
+}  // namespace
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void TdmaSlots::setEnabled(bool enabled) {
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        ScreenRegistry::registerTable(kSlotScreen, 1);
+    }
+    WiFi.macAddress(g_selfMac);
+    portENTER_CRITICAL(&g_lock);
+    for (Node& node : g_nodes) {
+        node.inUse = false;
+    }
+    g_stats = TdmaSlotStats{};
+    portEXIT_CRITICAL(&g_lock);
+    g_listenUntilMs = millis() + kListenMs;
+    g_lastBeaconMs = 0;
+    g_enabled = enabled;
+}
+
+bool TdmaSlots::isEnabled() {
+    return g_enabled;
+}
+
+uint32_t TdmaSlots::packInfo(uint8_t slot, uint32_t periodUs) {
+    return static_cast<uint32_t>(slot) | ((periodUs / 10) << 16);
+}
+
+// ============================================================================
+// Beacons
+// ============================================================================
+
+void TdmaSlots::onBeacon(const uint8_t* mac, uint32_t offsetUs, uint32_t info, uint32_t rxUs) {
+    if (!g_enabled || mac == nullptr) {
+        return;
+    }
+    // Back to 64 bits, then back to when the sender stamped it
+    const int64_t nowUs = esp_timer_get_time();
+    const int64_t rxTimeUs = nowUs - static_cast<uint32_t>(static_cast<uint32_t>(nowUs) - rxUs);
+    const int64_t anchorUs = rxTimeUs - offsetUs - EspNowDiscovery::estimateAirtimeUs(sizeof(Packet));
+    const uint32_t now = millis();
+
+    portENTER_CRITICAL(&g_lock);
+    g_stats.beaconsHeard++;
+    Node* target = nullptr;
+    Node* oldest = nullptr;
+    for (Node& node : g_nodes) {
+        if (node.inUse && memcmp(node.mac, mac, sizeof(node.mac)) == 0) {
+            target = &node;
+            break;
+        }
+        if (!node.inUse || now - node.lastHeardMs >= kNodeTimeoutMs) {
+            oldest = &node;
+        }
+    }
+    if (target == nullptr) {
+        target = oldest;
+    }
+    if (target != nullptr) {
+        target->inUse = true;
+        memcpy(target->mac, mac, sizeof(target->mac));
+        target->slot = static_cast<uint8_t>(info & 0xFF);
+        target->periodUs = (info >> 16) * 10;
+        target->lastHeardMs = now;
+        target->anchorUs = anchorUs;
+    }
+    portEXIT_CRITICAL(&g_lock);
+}
+
+// ============================================================================
+// Ticks
+// ============================================================================
+
+int32_t TdmaSlots::onTick(EspNowDiscovery& discovery, int64_t tickStartUs, uint32_t periodUs) {
+    if (!g_enabled || periodUs < kSlots) {
+        return 0;
+    }
+    const uint32_t now = millis();
+
+    // Controllers at our period: their slots, and the lowest MAC among them
+    Node nodes[kMaxNodes];
+    portENTER_CRITICAL(&g_lock);
+    memcpy(nodes, g_nodes, sizeof(nodes));
+    const bool periodChanged = g_stats.periodUs != periodUs;
+    portEXIT_CRITICAL(&g_lock);
+    if (periodChanged) {
+        // Another superframe: listen again before claiming
+        g_listenUntilMs = now + kListenMs;
+    }
+
+    uint8_t occupied = 0;
+    uint8_t nodeCount = 0;
+    uint32_t otherPeriod = 0;
+    const Node* master = nullptr;
+    for (const Node& node : nodes) {
+        if (!node.inUse || now - node.lastHeardMs >= kNodeTimeoutMs) {
+            continue;
+        }
+        if (node.periodUs != periodUs) {
+            otherPeriod++;
+            continue;
+        }
+        nodeCount++;
+        if (node.slot < kSlots) {
+            occupied |= 1u << node.slot;
+        }
+        if (memcmp(node.mac, g_selfMac, sizeof(g_selfMac)) < 0 &&
+            (master == nullptr || memcmp(node.mac, master->mac, sizeof(node.mac)) < 0)) {
+            master = &node;
+        }
+    }
+
+    uint8_t slot = periodChanged ? kNoSlot : g_stats.slot;
+    uint32_t claims = 0;
+    if (static_cast<int32_t>(now - g_listenUntilMs) >= 0) {
+        // A slot shared with a lower MAC is theirs
+        bool conflict = false;
+        for (const Node& node : nodes) {
+            if (node.inUse && now - node.lastHeardMs < kNodeTimeoutMs && node.periodUs == periodUs &&
+                node.slot == slot && memcmp(node.mac, g_selfMac, sizeof(g_selfMac)) < 0) {
+                conflict = true;
+            }
+        }
+        if (slot == kNoSlot || conflict) {
+            for (uint8_t i = 0; i < kSlots; ++i) {
+                if ((occupied & (1u << i)) == 0) {
+                    slot = i;
+                    claims++;
+                    break;
+                }
+            }
+        }
+    }
+
+    int32_t errorUs = 0;
+    if (slot != kNoSlot) {
+        const uint32_t slotUs = periodUs / kSlots;
+        if (master == nullptr) {
+            g_anchorUs = tickStartUs - static_cast<int64_t>(slot) * slotUs;
+        } else {
+            g_anchorUs = master->anchorUs;
+            const int64_t phase = positiveMod(tickStartUs - g_anchorUs - static_cast<int64_t>(slot) * slotUs,
+                                              periodUs);
+            errorUs = static_cast<int32_t>(phase < periodUs / 2 ? phase : phase - periodUs);
+        }
+
+        if (g_lastBeaconMs == 0 || now - g_lastBeaconMs >= kBeaconIntervalMs) {
+            const uint32_t offsetUs = static_cast<uint32_t>(positiveMod(esp_timer_get_time() - g_anchorUs,
+                                                                        periodUs));
+            if (discovery.sendSlotBeacon(offsetUs, packInfo(slot, periodUs))) {
+                portENTER_CRITICAL(&g_lock);
+                g_stats.beaconsSent++;
+                portEXIT_CRITICAL(&g_lock);
+            }
+            g_lastBeaconMs = now;
+        }
+    }
+
+    portENTER_CRITICAL(&g_lock);
+    g_stats.synced = slot != kNoSlot;
+    g_stats.master = slot != kNoSlot && master == nullptr;
+    g_stats.slot = slot;
+    g_stats.occupied = occupied;
+    g_stats.nodes = nodeCount;
+    memcpy(g_stats.masterMac, master != nullptr ? master->mac : g_selfMac, sizeof(g_stats.masterMac));
+    g_stats.periodUs = periodUs;
+    g_stats.lastErrorUs = errorUs;
+    g_stats.claims += claims;
+    g_stats.otherPeriod = otherPeriod;
+    portEXIT_CRITICAL(&g_lock);
+
+    if (claims > 0) {
+        ILITE_LOG(DISCOVERY, LOG_INFO, "TDMA slot %u of %u (%u other controllers)",
+                  static_cast<unsigned>(slot), static_cast<unsigned>(kSlots),
+                  static_cast<unsigned>(nodeCount));
+    }
+    return errorUs;
+}
+
+void TdmaSlots::onRealigned() {
+    portENTER_CRITICAL(&g_lock);
+    g_stats.realigns++;
+    portEXIT_CRITICAL(&g_lock);
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+TdmaSlotStats TdmaSlots::getStats() {
+    portENTER_CRITICAL(&g_lock);
+    const TdmaSlotStats stats = g_stats;
+    portEXIT_CRITICAL(&g_lock);
+    return stats;
+}
+
+void TdmaSlots::dump(Print& out) {
+    const TdmaSlotStats stats = getStats();
+    if (!g_enabled) {
+        out.println("[TDMA] Off");
+        return;
+    }
+    char master[18];
+    EspNowDiscovery::macToString(stats.masterMac, master, sizeof(master));
+    char map[kSlots + 1];
+    for (uint8_t i = 0; i < kSlots; ++i) {
+        map[i] = stats.slot == i ? '#' : ((stats.occupied & (1u << i)) ? 'x' : '.');
+    }
+    map[kSlots] = '\0';
+    out.printf("[TDMA] slots [%s] period %lu us, %u other controllers (%lu at another rate)\n", map,
+               static_cast<unsigned long>(stats.periodUs), static_cast<unsigned>(stats.nodes),
+               static_cast<unsigned long>(stats.otherPeriod));
+    out.printf("[TDMA] master %s%s, error %ld us, %lu realigns, %lu claims\n", master,
+               stats.master ? " (this one)" : "", static_cast<long>(stats.lastErrorUs),
+               static_cast<unsigned long>(stats.realigns), static_cast<unsigned long>(stats.claims));
+    out.printf("[TDMA] beacons sent %lu, heard %lu\n", static_cast<unsigned long>(stats.beaconsSent),
+               static_cast<unsigned long>(stats.beaconsHeard));
+}
@@ -0,0 +1,194 @@
+/**
+ * @file TelemetryHealth.cpp
+ * @brief Per-descriptor telemetry rate, gap and staleness records
+ */
+
+#include "TelemetryHealth.h"
+#include "ILITEModule.h"
+#include "LogChannels.h"
+#include "TelemetryStore.h"
+#include <cstring>
+
+static_assert(TelemetryHealth::kMaxTypes == TelemetryStore::kMaxSlots,
+              "One rate record per telemetry slot");
+
+TelemetryRate TelemetryHealth::rates_[TelemetryHealth::kMaxTypes] = {};
+std::atomic<uint16_t> TelemetryHealth::requestedMs_[TelemetryHealth::kMaxTypes];
+std::atomic<bool> TelemetryHealth::rebase_[TelemetryHealth::kMaxTypes];
+
+// ============================================================================
+// Recording (RxTask)
+// ============================================================================
+
+uint32_t TelemetryHealth::record(size_t typeIndex, uint32_t magic, uint32_t timestampUs,
+                                 uint32_t sampleUs) {
+    if (typeIndex >= kMaxTypes) {
+        return 0;
+    }
+    TelemetryRate& rate = rates_[typeIndex];
+
+    uint32_t interval = 0;
+    if (rate.packets == 0) {
+        rate.magic = magic;
+    } else if (rebase_[typeIndex].exchange(false)) {
+        // The gap straddles a rate change: start measuring the new rate
+        interval = timestampUs - rate.lastUs;
+        rate.intervalAvgUs = 0;
+    } else {
+        interval = timestampUs - rate.lastUs;
+        rate.intervalAvgUs = rate.intervalAvgUs == 0
+                                 ? interval
+                                 : rate.intervalAvgUs - rate.intervalAvgUs / 8 + interval / 8;
+        rate.maxGapUs = interval > rate.maxGapUs ? interval : rate.maxGapUs;
+    }
+    if (sampleUs != timestampUs) {
+        const uint32_t latency = timestampUs - sampleUs;
+        rate.latencyAvgUs = rate.latencyAvgUs == 0
+                                ? latency
+                                : rate.latencyAvgUs - rate.latencyAvgUs / 8 + latency / 8;
+    }
+    rate.lastUs = timestampUs;
+    rate.packets++;
+    return interval;
+}
+
+void TelemetryHealth::reset() {
+    memset(rates_, 0, sizeof(rates_));
+    for (size_t i = 0; i < kMaxTypes; ++i) {
+        requestedMs_[i].store(0);
+        rebase_[i].store(false);
+    }
+}
+
+void TelemetryHealth::onRateRequested(size_t typeIndex, uint16_t intervalMs) {
+    if (typeIndex >= kMaxTypes || requestedMs_[typeIndex].exchange(intervalMs) == intervalMs) {
+        return;
+    }
+    rebase_[typeIndex].store(true);
+}
+
+// ============================================================================
+// Staleness
+// ============================================================================
+
+size_t TelemetryHealth::service(ILITEModule* module, uint32_t nowUs) {
+    if (module == nullptr) {
+        return 0;
+    }
+    size_t count = module->getTelemetryPacketTypeCount();
+    count = count < kMaxTypes ? count : kMaxTypes;
+
+    size_t wentStale = 0;
+    for (size_t i = 0; i < count; ++i) {
+        TelemetryRate& rate = rates_[i];
+        if (rate.packets == 0) {
+            continue;   // Never received: nothing to fall back from
+        }
+        const PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
+        if (desc.staleAfterMs == PacketDescriptor::kNeverStale) {
+            continue;   // Reply packet: silence between requests is normal
+        }
+        const uint32_t limitUs = getStaleAfterMs(i, desc.staleAfterMs) * 1000;
+        // A packet recorded after nowUs was read gives a negative age
+        const int32_t ageUs = static_cast<int32_t>(nowUs - rate.lastUs);
+        const bool stale = ageUs > 0 && static_cast<uint32_t>(ageUs) > limitUs;
+        if (stale == rate.stale) {
+            continue;
+        }
+        rate.stale = stale;
+        if (stale) {
+            rate.staleCount++;
+            wentStale++;
+            ILITE_LOG(ROUTER, LOG_WARN, "Telemetry '%s' stale (%lu ms silent)",
+                      desc.name ? desc.name : "?",
+                      static_cast<unsigned long>(ageUs / 1000));
+        } else {
+            ILITE_LOG(ROUTER, LOG_INFO, "Telemetry '%s' fresh again", desc.name ? desc.name : "?");
+        }
+        module->onTelemetryStale(i, stale);
+    }
+    return wentStale;
+}
+
+uint32_t TelemetryHealth::getStaleAfterMs(size_t typeIndex, uint16_t staleAfterMs) {
+    if (staleAfterMs == PacketDescriptor::kNeverStale) {
+        return UINT32_MAX;
+    }
+    if (staleAfterMs != 0) {
+        return staleAfterMs;
+    }
+    if (typeIndex >= kMaxTypes) {
+        return kUnknownRateStaleMs;
+    }
+
+    // Until the new rate is measured, go by what was asked for
+    uint32_t intervalUs = rates_[typeIndex].intervalAvgUs;
+    if (intervalUs == 0 || rebase_[typeIndex].load()) {
+        const uint32_t requestedMs = requestedMs_[typeIndex].load();
+        if (requestedMs == 0) {
+            const uint32_t measuredMs = kStaleIntervals * intervalUs / 1000;
+            return measuredMs > kUnknownRateStaleMs ? measuredMs : kUnknownRateStaleMs;
+        }
+        intervalUs = requestedMs * 1000;
+    }
+    const uint32_t limitMs = kStaleIntervals * intervalUs / 1000;
+    return limitMs > kMinStaleMs ? limitMs : kMinStaleMs;
+}
+
+bool TelemetryHealth::isStale(size_t typeIndex, uint16_t staleAfterMs) {
+    const uint32_t ageMs = getAgeMs(typeIndex);
+    if (ageMs == UINT32_MAX) {
+        return true;
+    }
+    return staleAfterMs != PacketDescriptor::kNeverStale && ageMs > getStaleAfterMs(typeIndex, staleAfterMs);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+const TelemetryRate* TelemetryHealth::get(size_t typeIndex) {
+    return typeIndex < kMaxTypes ? &rates_[typeIndex] : nullptr;
+}
+
+uint32_t TelemetryHealth::getAgeMs(size_t typeIndex) {
+    if (typeIndex >= kMaxTypes || rates_[typeIndex].packets == 0) {
+        return UINT32_MAX;
+    }
+    const int32_t ageUs = static_cast<int32_t>(micros() - rates_[typeIndex].lastUs);
+    return ageUs > 0 ? static_cast<uint32_t>(ageUs) / 1000 : 0;
+}
+
+float TelemetryHealth::getRateHz(size_t typeIndex) {
+    if (typeIndex >= kMaxTypes) {
+        return 0.0f;
+    }
+    const uint32_t intervalUs = rates_[typeIndex].intervalAvgUs;
+    if (intervalUs == 0 || rates_[typeIndex].stale) {
+        return 0.0f;
+    }
+    return 1000000.0f / intervalUs;
+}
+
+void TelemetryHealth::dump(Print& out) {
+    bool any = false;
+    for (size_t i = 0; i < kMaxTypes; ++i) {
+        const TelemetryRate& rate = rates_[i];
+        if (rate.packets == 0) {
+            continue;
+        }
+        any = true;
+        const uint32_t ageMs = getAgeMs(i);
+        out.printf("[Telemetry] %u 0x%08lX n=%lu %.1f Hz age=%lums max gap=%lums latency=%luus stale=%s (%lux)\n",
+                   static_cast<unsigned>(i), static_cast<unsigned long>(rate.magic),
+                   static_cast<unsigned long>(rate.packets), getRateHz(i),
+                   static_cast<unsigned long>(ageMs),
+                   static_cast<unsigned long>(rate.maxGapUs / 1000),
+                   static_cast<unsigned long>(rate.latencyAvgUs),
+                   rate.stale ? "yes" : "no",
+                   static_cast<unsigned long>(rate.staleCount));
+    }
+    if (!any) {
+        out.println("[Telemetry] No telemetry received");
+    }
+}
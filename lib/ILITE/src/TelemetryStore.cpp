@@ -0,0 +1,95 @@
+/**
+ * @file TelemetryStore.cpp
+ * @brief Seqlock telemetry slot implementation
+ */
+
+#include "TelemetryStore.h"
+
+// ============================================================================
+// TelemetrySlot
+// ============================================================================
+
+void TelemetrySlot::publish(const uint8_t* data, size_t length) {
+    if (data == nullptr) {
+        return;
+    }
+    if (length > kMaxSize) {
+        length = kMaxSize;
+    }
+
+    uint32_t seq = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(seq + 1, std::memory_order_relaxed);   // odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(data_, data, length);
+    length_ = static_cast<uint16_t>(length);
+    updatedMs_.store(millis(), std::memory_order_relaxed);
+
+    sequence_.store(seq + 2, std::memory_order_release);   // even: stable
+}
+
+size_t TelemetrySlot::read(void* out, size_t maxLength, uint32_t* sequenceOut) const {
+    if (out == nullptr) {
+        return 0;
+    }
+
+    // The writer only holds the slot for one memcpy; if it was preempted
+    // mid-write, yield so it can finish instead of spinning against it.
+    for (int attempt = 0; attempt < 32; ++attempt) {
+        uint32_t before = sequence_.load(std::memory_order_acquire);
+        if (before == 0) {
+            return 0;
+        }
+        if (before & 1u) {
+            taskYIELD();
+            continue;
+        }
+
+        size_t length = length_ < maxLength ? length_ : maxLength;
+        memcpy(out, data_, length);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+            if (sequenceOut != nullptr) {
+                *sequenceOut = before;
+            }
+            return length;
+        }
+    }
+    return 0;
+}
+
+void TelemetrySlot::reset() {
+    sequence_.store(0, std::memory_order_release);
+    updatedMs_.store(0, std::memory_order_relaxed);
+    length_ = 0;
+}
+
+// ============================================================================
+// TelemetryStore
+// ============================================================================
+
+TelemetryStore& TelemetryStore::getInstance() {
+    static TelemetryStore instance;
+    return instance;
+}
+
+void TelemetryStore::publish(size_t typeIndex, const uint8_t* data, size_t length) {
+    if (typeIndex < kMaxSlots) {
+        slots_[bank_][typeIndex].publish(data, length);
+    }
+}
+
+const TelemetrySlot* TelemetryStore::getSlot(size_t typeIndex) const {
+    return typeIndex < kMaxSlots ? &slots_[bank_][typeIndex] : nullptr;
+}
+
+void TelemetryStore::reset() {
+    for (size_t i = 0; i < kMaxSlots; ++i) {
+        slots_[bank_][i].reset();
+    }
+}
+
+void TelemetryStore::swapBanks() {
+    bank_ ^= 1;
+}
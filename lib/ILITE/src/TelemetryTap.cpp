@@ -0,0 +1,266 @@
+/**
+ * @file TelemetryTap.cpp
+ * @brief Packet record queue, COBS framing and the serial drainer task
+ */
+
+#include "TelemetryTap.h"
+#include "Framing.h"
+#include "ILITEModule.h"
+#include "MpscQueue.h"
+#include "TaskMonitor.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <cstring>
+#include <new>
+
+std::atomic<bool> TelemetryTap::enabled_{false};
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 3072;
+constexpr UBaseType_t kTaskPriority = 1;    // Below every framework task
+constexpr BaseType_t kTaskCore = 1;
+constexpr size_t kMaxBody = TelemetryTap::kMaxPayload + 1;     // typeIndex + packet
+constexpr size_t kMaxFrame = 1 + 4 + kMaxBody + 2;             // kind, time, body, crc
+constexpr size_t kMaxEncoded = Framing::cobsMaxEncoded(kMaxFrame);
+constexpr uint8_t kDirTelemetry = 0x01;
+constexpr uint8_t kDirCommand = 0x02;
+
+struct TapRecord {
+    uint8_t kind;
+    uint8_t length;             ///< Bytes used in body
+    uint32_t timeUs;
+    uint8_t body[kMaxBody];
+};
+
+using TapQueue = MpscQueue<TapRecord, TelemetryTap::kQueueSize>;
+
+TapQueue* queue = nullptr;      // Allocated by begin(), so a disabled tap costs no RAM
+HardwareSerial* port = nullptr;
+TaskHandle_t drainerHandle = nullptr;
+ILITEModule* describedModule = nullptr;
+
+std::atomic<uint32_t> recordCount{0};
+std::atomic<uint32_t> droppedCount{0};
+uint32_t reportedDrops = 0;     // Drainer only
+uint32_t frameCount = 0;        // Drainer only
+uint32_t byteCount = 0;         // Drainer only
+
+using Framing::cobsEncode;
+using Framing::crc16;
+using Framing::putU16;
+using Framing::putU32;
+
+void writeFrame(uint8_t kind, uint32_t timeUs, const uint8_t* body, size_t length) {
+    static uint8_t frame[kMaxFrame];
+    static uint8_t encoded[kMaxEncoded];
+
+    frame[0] = kind;
+    putU32(frame + 1, timeUs);
+    memcpy(frame + 5, body, length);
+    const size_t frameLength = 5 + length;
+    putU16(frame + frameLength, crc16(frame, frameLength));
+
+    const size_t encodedLength = cobsEncode(frame, frameLength + 2, encoded);
+    // One write per frame: console text never lands inside a frame
+    port->write(encoded, encodedLength);
+    frameCount++;
+    byteCount += encodedLength;
+}
+
+bool push(TapRecord& record) {
+    if (queue == nullptr || !queue->push(record)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+    if (drainerHandle != nullptr) {
+        xTaskNotifyGive(drainerHandle);
+    }
+    return true;
+}
+
+bool pushDescriptor(uint8_t direction, uint8_t typeIndex, const PacketDescriptor& desc) {
+    TapRecord record;
+    record.kind = TelemetryTap::FRAME_DESCRIPTOR;
+    record.timeUs = static_cast<uint32_t>(esp_timer_get_time());
+    uint8_t* out = record.body;
+    size_t pos = 0;
+
+    out[pos++] = direction;
+    out[pos++] = typeIndex;
+    putU32(out + pos, desc.magicNumber);
+    putU16(out + pos + 4, static_cast<uint16_t>(desc.minSize));
+    putU16(out + pos + 6, static_cast<uint16_t>(desc.maxSize));
+    pos += 8;
+
+    const char* name = desc.name != nullptr ? desc.name : "";
+    const size_t nameLength = strnlen(name, 32);
+    out[pos++] = static_cast<uint8_t>(nameLength);
+    memcpy(out + pos, name, nameLength);
+    pos += nameLength;
+
+    // Fields that do not fit the record are left out; the count says how many follow
+    const size_t countIndex = pos++;
+    uint8_t fieldCount = 0;
+    for (size_t i = 0; desc.fields != nullptr && i < desc.fieldCount && i < 255; ++i) {
+        const PacketDescriptor::Field& field = desc.fields[i];
+        const char* fieldName = field.name != nullptr ? field.name : "";
+        const size_t fieldNameLength = strnlen(fieldName, 24);
+        if (pos + 4 + fieldNameLength > sizeof(record.body)) {
+            break;
+        }
+        out[pos++] = static_cast<uint8_t>(field.offset);
+        out[pos++] = static_cast<uint8_t>(field.size);
+        out[pos++] = static_cast<uint8_t>(field.type);
+        out[pos++] = static_cast<uint8_t>(fieldNameLength);
+        memcpy(out + pos, fieldName, fieldNameLength);
+        pos += fieldNameLength;
+        fieldCount++;
+    }
+    out[countIndex] = fieldCount;
+    record.length = static_cast<uint8_t>(pos);
+    return push(record);
+}
+
+void drainerTask(void*) {
+    TapRecord record;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+
+        while (queue->pop(record)) {
+            writeFrame(record.kind, record.timeUs, record.body, record.length);
+        }
+
+        const uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops && TelemetryTap::isEnabled()) {
+            uint8_t body[4];
+            putU32(body, dropped - reportedDrops);
+            reportedDrops = dropped;
+            writeFrame(TelemetryTap::FRAME_DROPPED,
+                       static_cast<uint32_t>(esp_timer_get_time()), body, sizeof(body));
+        }
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool TelemetryTap::begin(HardwareSerial& out, uint32_t baud) {
+    if (drainerHandle != nullptr) {
+        return true;
+    }
+
+    queue = new (std::nothrow) TapQueue();
+    if (queue == nullptr) {
+        Serial.println("[TelemetryTap] Out of memory for the record queue");
+        return false;
+    }
+    port = &out;
+    if (baud != 0) {
+        out.flush();
+        out.updateBaudRate(baud);
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        drainerTask,
+        "TelemetryTap",
+        kTaskStackSize,
+        nullptr,
+        kTaskPriority,
+        &drainerHandle,
+        kTaskCore
+    );
+
+    if (result != pdPASS) {
+        Serial.println("[TelemetryTap] Failed to create drainer task");
+        drainerHandle = nullptr;
+        delete queue;
+        queue = nullptr;
+        return false;
+    }
+
+    TaskMonitor::watch(drainerHandle, kTaskStackSize, kTaskCore);
+    return true;
+}
+
+void TelemetryTap::setEnabled(bool enabled) {
+    if (enabled && queue == nullptr) {
+        Serial.println("[TelemetryTap] Not started (call begin() first)");
+        return;
+    }
+    const bool wasEnabled = enabled_.exchange(enabled, std::memory_order_relaxed);
+    if (enabled && !wasEnabled) {
+        // A decoder attaching now needs the tables before the packets
+        describeModule(describedModule);
+    }
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+bool TelemetryTap::record(uint8_t kind, uint8_t typeIndex, const uint8_t* data, size_t length,
+                          uint32_t timestampUs) {
+    if (data == nullptr) {
+        return false;
+    }
+    if (length > kMaxPayload) {
+        length = kMaxPayload;
+    }
+    TapRecord record;
+    record.kind = kind;
+    record.length = static_cast<uint8_t>(length + 1);
+    record.timeUs = timestampUs;
+    record.body[0] = typeIndex;
+    memcpy(record.body + 1, data, length);
+    return push(record);
+}
+
+void TelemetryTap::describeModule(ILITEModule* module) {
+    describedModule = module;
+    if (!isEnabled() || module == nullptr) {
+        return;
+    }
+
+    TapRecord record;
+    record.kind = FRAME_MODULE;
+    record.timeUs = static_cast<uint32_t>(esp_timer_get_time());
+    const char* name = module->getModuleName();
+    const size_t nameLength = name != nullptr ? strnlen(name, sizeof(record.body)) : 0;
+    memcpy(record.body, name, nameLength);
+    record.length = static_cast<uint8_t>(nameLength);
+    push(record);
+
+    // Descriptors go through the same queue and may be dropped when it is
+    // full; yield to the drainer between them
+    const size_t telemetryCount = module->getTelemetryPacketTypeCount();
+    for (size_t i = 0; i < telemetryCount && i < 255; ++i) {
+        pushDescriptor(kDirTelemetry, static_cast<uint8_t>(i),
+                       module->getTelemetryPacketDescriptor(i));
+        vTaskDelay(1);
+    }
+    const size_t commandCount = module->getCommandPacketTypeCount();
+    for (size_t i = 0; i < commandCount && i < 255; ++i) {
+        pushDescriptor(kDirCommand, static_cast<uint8_t>(i),
+                       module->getCommandPacketDescriptor(i));
+        vTaskDelay(1);
+    }
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+
+void TelemetryTap::dump(Print& out) {
+    out.printf("[TelemetryTap] %s records=%lu dropped=%lu frames=%lu bytes=%lu\n",
+               isEnabled() ? "on" : "off",
+               static_cast<unsigned long>(recordCount.load()),
+               static_cast<unsigned long>(droppedCount.load()),
+               static_cast<unsigned long>(frameCount),
+               static_cast<unsigned long>(byteCount));
+}
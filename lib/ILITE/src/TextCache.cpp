@@ -0,0 +1,251 @@
+/**
+ * @file TextCache.cpp
+ * @brief Label and width cache implementation
+ */
+
+#include "TextCache.h"
+#include <cstring>
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+TextCache::TextCache(U8G2& u8g2)
+    : u8g2_(u8g2),
+      enabled_(false),
+      frame_(1),
+      hits_(0),
+      misses_(0),
+      seenNext_(0)
+{
+    clear();
+}
+
+void TextCache::setEnabled(bool enabled) {
+    if (!enabled) {
+        clear();
+    }
+    enabled_ = enabled;
+}
+
+void TextCache::clear() {
+    memset(labels_, 0, sizeof(labels_));
+    memset(widths_, 0, sizeof(widths_));
+    memset(seen_, 0, sizeof(seen_));
+    seenNext_ = 0;
+}
+
+uint32_t TextCache::hashText(uint8_t font, const char* text) {
+    // FNV-1a over the font id and the string
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ font) * 16777619u;
+    for (const char* p = text; *p != '\0'; ++p) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    return hash != 0 ? hash : 1;  // 0 marks empty slots
+}
+
+// ============================================================================
+// Widths
+// ============================================================================
+
+int16_t TextCache::getWidth(uint8_t font, const char* text) {
+    if (!enabled_) {
+        return u8g2_.getUTF8Width(text);
+    }
+
+    const uint32_t hash = hashText(font, text);
+    Width& slot = widths_[hash % kWidthSlots];
+    if (slot.valid && slot.hash == hash) {
+        return slot.width;
+    }
+
+    slot.hash = hash;
+    slot.width = u8g2_.getUTF8Width(text);
+    slot.valid = true;
+    return slot.width;
+}
+
+// ============================================================================
+// Labels
+// ============================================================================
+
+TextCache::Label* TextCache::findLabel(uint32_t hash, uint8_t font) {
+    for (Label& label : labels_) {
+        if (label.lastUsed != 0 && label.hash == hash && label.font == font) {
+            return &label;
+        }
+    }
+    return nullptr;
+}
+
+bool TextCache::admit(uint32_t hash) {
+    for (uint32_t seen : seen_) {
+        if (seen == hash) {
+            return true;
+        }
+    }
+    seen_[seenNext_] = hash;
+    seenNext_ = (seenNext_ + 1) % kSeenSlots;
+    return false;
+}
+
+bool TextCache::drawText(uint8_t font, int16_t x, int16_t y, const char* text) {
+    const uint8_t color = u8g2_.getDrawColor();
+    if (!enabled_ || color > 1 || text == nullptr || *text == '\0') {
+        return false;
+    }
+
+    const uint32_t hash = hashText(font, text);
+    Label* label = findLabel(hash, font);
+    if (label != nullptr) {
+        const int16_t top = y - label->ascent;
+        if (x < 0 || top < bandTop() ||
+            x + label->width > u8g2_.getDisplayWidth() ||
+            top + label->height > bandBottom()) {
+            misses_++;
+            return false;
+        }
+        blit(*label, x, top, color);
+        label->lastUsed = frame_;
+        hits_++;
+        return true;
+    }
+
+    misses_++;
+    if (!admit(hash)) {
+        return false;
+    }
+
+    // Replace the least recently used slot
+    Label* victim = &labels_[0];
+    for (Label& candidate : labels_) {
+        if (candidate.lastUsed < victim->lastUsed) {
+            victim = &candidate;
+        }
+    }
+    if (!rasterize(*victim, hash, font, x, y, text)) {
+        return false;
+    }
+    blit(*victim, x, y - victim->ascent, color);
+    return true;
+}
+
+bool TextCache::rasterize(Label& label, uint32_t hash, uint8_t font,
+                          int16_t x, int16_t y, const char* text) {
+    // Reference ascent/descent plus one row each way: brackets and
+    // accents reach past the reference height. +1 column because the last
+    // glyph may extend past its advance.
+    const int8_t ascent = u8g2_.getAscent() + 1;
+    const int8_t descent = u8g2_.getDescent() - 1;
+    const int16_t height = ascent - descent;
+    const int16_t width = getWidth(font, text) + 1;
+    const int16_t top = y - ascent;
+
+    if (height <= 0 || height > kMaxHeight || width > kMaxColumns ||
+        x < 0 || top < bandTop() ||
+        x + width > u8g2_.getDisplayWidth() ||
+        top + height > bandBottom()) {
+        return false;
+    }
+
+    uint16_t saved[kMaxColumns];
+    uint16_t onSet[kMaxColumns];
+    const uint16_t fill = static_cast<uint16_t>((1UL << height) - 1);
+    const uint8_t color = u8g2_.getDrawColor();
+
+    for (int16_t c = 0; c < width; ++c) {
+        saved[c] = readColumn(x + c, top, height);
+    }
+
+    u8g2_.setDrawColor(1);
+
+    // Pass 1 on a set region: background pixels become 0
+    for (int16_t c = 0; c < width; ++c) {
+        writeColumn(x + c, top, height, fill);
+    }
+    u8g2_.setCursor(x, y);
+    u8g2_.print(text);
+    for (int16_t c = 0; c < width; ++c) {
+        onSet[c] = readColumn(x + c, top, height);
+    }
+
+    // Pass 2 on a cleared region: foreground pixels become 1
+    for (int16_t c = 0; c < width; ++c) {
+        writeColumn(x + c, top, height, 0);
+    }
+    u8g2_.setCursor(x, y);
+    u8g2_.print(text);
+    for (int16_t c = 0; c < width; ++c) {
+        label.fg[c] = readColumn(x + c, top, height);
+        label.bg[c] = static_cast<uint16_t>(~onSet[c]) & fill;
+        writeColumn(x + c, top, height, saved[c]);
+    }
+
+    u8g2_.setDrawColor(color);
+
+    label.hash = hash;
+    label.font = font;
+    label.width = static_cast<uint8_t>(width);
+    label.height = static_cast<uint8_t>(height);
+    label.ascent = ascent;
+    label.lastUsed = frame_;
+    return true;
+}
+
+void TextCache::blit(const Label& label, int16_t x, int16_t top, uint8_t color) {
+    for (uint8_t c = 0; c < label.width; ++c) {
+        const uint16_t on = color ? label.fg[c] : label.bg[c];
+        const uint16_t off = color ? label.bg[c] : label.fg[c];
+        if ((on | off) == 0) {
+            continue;
+        }
+        uint16_t bits = readColumn(x + c, top, label.height);
+        bits = (bits & ~off) | on;
+        writeColumn(x + c, top, label.height, bits);
+    }
+}
+
+// ============================================================================
+// Framebuffer Access
+// ============================================================================
+
+// Rows the buffer holds: the whole screen, or one band in page mode
+// (DisplayCanvas::firstPage()). Labels outside the band are not cached.
+int16_t TextCache::bandTop() const {
+    return static_cast<int16_t>(u8g2_.getBufferCurrTileRow()) * 8;
+}
+
+int16_t TextCache::bandBottom() const {
+    const int16_t bottom = bandTop() + static_cast<int16_t>(u8g2_.getBufferTileHeight()) * 8;
+    return bottom < u8g2_.getDisplayHeight() ? bottom : u8g2_.getDisplayHeight();
+}
+
+uint16_t TextCache::readColumn(int16_t x, int16_t top, uint8_t height) const {
+    const uint8_t* buffer = u8g2_.getBufferPtr();
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    const uint8_t pages = u8g2_.getBufferTileHeight();
+    const uint8_t firstPage = (top - bandTop()) >> 3;
+
+    uint32_t column = 0;
+    for (uint8_t k = 0; k < 3 && firstPage + k < pages; ++k) {
+        column |= static_cast<uint32_t>(buffer[(firstPage + k) * stride + x]) << (8 * k);
+    }
+    return static_cast<uint16_t>((column >> (top & 7)) & ((1UL << height) - 1));
+}
+
+void TextCache::writeColumn(int16_t x, int16_t top, uint8_t height, uint16_t bits) {
+    uint8_t* buffer = u8g2_.getBufferPtr();
+    const uint16_t stride = u8g2_.getBufferTileWidth() * 8;
+    const uint8_t pages = u8g2_.getBufferTileHeight();
+    const uint8_t firstPage = (top - bandTop()) >> 3;
+    const uint8_t shift = top & 7;
+
+    const uint32_t mask = ((1UL << height) - 1) << shift;
+    const uint32_t value = static_cast<uint32_t>(bits) << shift;
+    for (uint8_t k = 0; k < 3 && firstPage + k < pages; ++k) {
+        uint8_t& byte = buffer[(firstPage + k) * stride + x];
+        const uint8_t m = static_cast<uint8_t>(mask >> (8 * k));
+        byte = static_cast<uint8_t>((byte & ~m) | (static_cast<uint8_t>(value >> (8 * k)) & m));
+    }
+}
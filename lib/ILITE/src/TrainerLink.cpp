@@ -0,0 +1,405 @@
+/**
+ * @file TrainerLink.cpp
+ * @brief Trainee frame sending, the instructor's jitter buffer and input merging
+ */
+
+#include "TrainerLink.h"
+#include "InputReplay.h"
+#include "LogChannels.h"
+#include "Transport.h"
+#include "espnow_discovery.h"
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+
+extern EspNowDiscovery discovery;
+
+std::atomic<TrainerRole> TrainerLink::role_{TrainerRole::Off};
+std::atomic<TrainerMix> TrainerLink::mix_{TrainerMix::Override};
+std::atomic<uint8_t> TrainerLink::delayTicks_{1};
+std::atomic<uint8_t> TrainerLink::takeoverMask_{InputSnapshot::BUTTON_3};
+std::atomic<bool> TrainerLink::traineeDriving_{false};
+
+const uint32_t TrainerLink::kBucketUs[kTrainerLatencyBuckets] = {
+    1000, 2000, 5000, 10000, 20000, 30000, 50000, UINT32_MAX
+};
+
+namespace {
+
+constexpr size_t kFrameSize = sizeof(TrainerFrameHeader) + InputReplay::kSnapshotSize;
+constexpr uint32_t kOffsetCreepUs = 1;      // Per frame; follows a slower trainee clock
+constexpr uint8_t kStickChannels = AdcSampler::POT + 1;
+
+struct BufferedFrame {
+    bool valid;
+    uint32_t sequence;
+    uint32_t captureUs;
+    InputSnapshot snapshot;
+};
+
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Shared by RxTask and CommTask, under g_lock
+TrainerStats g_stats;
+BufferedFrame g_frames[TrainerLink::kBufferFrames];
+uint32_t g_newestSequence = 0;      // Newest frame received
+uint32_t g_lastFrameUs = 0;         // Arrival of that frame
+bool g_haveFrame = false;
+uint32_t g_offsetUs = 0;            // Lowest (arrival - capture) seen
+
+// Written by start() before the role is published
+uint8_t g_peerMac[6] = {};
+
+// CommTask only
+uint32_t g_txSequence = 0;
+InputSnapshot g_trainee;            // Trainee input in use
+bool g_haveTrainee = false;
+uint8_t g_repeatTicks = 0;
+bool g_linkUp = false;
+
+inline bool newer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+void recordAge(TrainerStats& stats, uint32_t ageUs) {
+    if (stats.used == 0 || ageUs < stats.minUs) {
+        stats.minUs = ageUs;
+    }
+    if (ageUs > stats.maxUs) {
+        stats.maxUs = ageUs;
+    }
+    stats.avgUs = stats.used == 0
+        ? ageUs
+        : static_cast<uint32_t>((static_cast<int64_t>(stats.avgUs) * 15 + ageUs) / 16);
+    size_t bucket = 0;
+    while (ageUs > TrainerLink::kBucketUs[bucket] && bucket < kTrainerLatencyBuckets - 1) {
+        ++bucket;
+    }
+    stats.histogram[bucket]++;
+    stats.used++;
+}
+
+void clearBuffer() {
+    for (BufferedFrame& frame : g_frames) {
+        frame.valid = false;
+    }
+    g_newestSequence = 0;
+    g_haveFrame = false;
+    g_offsetUs = 0;
+}
+
+/// The trainee's input on top of (Mix) or instead of (Override) `live`
+void applyTrainee(InputSnapshot& live, const InputSnapshot& trainee, bool fresh, TrainerMix mix) {
+    // Edges only count once; a repeated frame is held, not pressed again
+    const uint8_t pressed = fresh ? trainee.pressed : 0;
+    if (mix == TrainerMix::Override) {
+        memcpy(live.raw, trainee.raw, kStickChannels * sizeof(live.raw[0]));
+        live.joystickA_X = trainee.joystickA_X;
+        live.joystickA_Y = trainee.joystickA_Y;
+        live.joystickB_X = trainee.joystickB_X;
+        live.joystickB_Y = trainee.joystickB_Y;
+        live.buttons = trainee.buttons;
+        live.debounced = trainee.debounced;
+        live.pressed = pressed;
+    } else {
+        live.joystickA_X = constrain(live.joystickA_X + trainee.joystickA_X, -1.0f, 1.0f);
+        live.joystickA_Y = constrain(live.joystickA_Y + trainee.joystickA_Y, -1.0f, 1.0f);
+        live.joystickB_X = constrain(live.joystickB_X + trainee.joystickB_X, -1.0f, 1.0f);
+        live.joystickB_Y = constrain(live.joystickB_Y + trainee.joystickB_Y, -1.0f, 1.0f);
+        live.buttons |= trainee.buttons;
+        live.debounced |= trainee.debounced;
+        live.pressed |= pressed;
+    }
+    live.potentiometer = trainee.potentiometer;
+}
+
+}  // namespace
+
+// ============================================================================
+// Control (ServiceTask)
+// ============================================================================
+
+bool TrainerLink::start(TrainerRole role, const uint8_t* mac) {
+    stop();
+    if (role == TrainerRole::Off || mac == nullptr) {
+        return role == TrainerRole::Off;
+    }
+    if (!discovery.setTrainerPeer(mac)) {
+        return false;
+    }
+    memcpy(g_peerMac, mac, sizeof(g_peerMac));
+    reset();
+    role_.store(role, std::memory_order_release);
+
+    char label[18];
+    EspNowDiscovery::macToString(mac, label, sizeof(label));
+    ILITE_LOG(INPUTS, LOG_INFO, "Trainer: %s, peer %s",
+              role == TrainerRole::Trainee ? "trainee" : "instructor", label);
+    return true;
+}
+
+void TrainerLink::stop() {
+    if (role_.exchange(TrainerRole::Off, std::memory_order_acq_rel) == TrainerRole::Off) {
+        return;
+    }
+    discovery.setTrainerPeer(nullptr);
+    traineeDriving_.store(false, std::memory_order_relaxed);
+    ILITE_LOG(INPUTS, LOG_INFO, "Trainer: off");
+}
+
+void TrainerLink::setDelayTicks(uint8_t ticks) {
+    delayTicks_.store(ticks > kMaxDelayTicks ? kMaxDelayTicks : ticks, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Instructor: receiving (RxTask)
+// ============================================================================
+
+bool TrainerLink::onFrame(const uint8_t* mac, const uint8_t* data, size_t length, uint32_t rxUs) {
+    if (data == nullptr || length < sizeof(TrainerFrameHeader)) {
+        return false;
+    }
+    TrainerFrameHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != TRAINER_PACKET_MAGIC) {
+        return false;
+    }
+    // Ours either way; only the configured trainee is used
+    if (getRole() != TrainerRole::Instructor || !EspNowDiscovery::macEqual(mac, g_peerMac)) {
+        return true;
+    }
+
+    InputSnapshot snapshot;
+    const bool valid = length == kFrameSize && header.format == InputReplay::kFormatVersion &&
+                       InputReplay::decodeSnapshot(data + sizeof(header), length - sizeof(header), snapshot);
+
+    portENTER_CRITICAL(&g_lock);
+    if (!valid) {
+        g_stats.badFrames++;
+        portEXIT_CRITICAL(&g_lock);
+        return true;
+    }
+    g_stats.framesReceived++;
+
+    // A trainee that went quiet may have rebooted: new sequence and clock
+    if (g_haveFrame && rxUs - g_lastFrameUs > kLostMs * 1000UL) {
+        clearBuffer();
+    }
+    if (g_haveFrame && !newer(header.sequence, g_newestSequence)) {
+        g_stats.outOfOrder++;
+        portEXIT_CRITICAL(&g_lock);
+        return true;
+    }
+
+    // The fastest frame defines the clock offset; queueing only adds to it
+    const uint32_t transitUs = rxUs - header.captureUs;
+    if (!g_haveFrame || static_cast<int32_t>(transitUs - g_offsetUs) < 0) {
+        g_offsetUs = transitUs;
+    } else {
+        g_offsetUs += kOffsetCreepUs;
+    }
+    g_newestSequence = header.sequence;
+    g_lastFrameUs = rxUs;
+    g_haveFrame = true;
+
+    // Free slot, else the oldest frame
+    BufferedFrame* slot = &g_frames[0];
+    for (BufferedFrame& frame : g_frames) {
+        if (!frame.valid) {
+            slot = &frame;
+            break;
+        }
+        if (newer(slot->sequence, frame.sequence)) {
+            slot = &frame;
+        }
+    }
+    if (slot->valid) {
+        g_stats.overflows++;
+    }
+    slot->valid = true;
+    slot->sequence = header.sequence;
+    slot->captureUs = header.captureUs;
+    slot->snapshot = snapshot;
+    portEXIT_CRITICAL(&g_lock);
+    return true;
+}
+
+// ============================================================================
+// CommTask
+// ============================================================================
+
+void TrainerLink::onInput(const InputSnapshot& snapshot, uint32_t captureUs) {
+    if (getRole() != TrainerRole::Trainee) {
+        return;
+    }
+    uint8_t frame[kFrameSize];
+    TrainerFrameHeader header;
+    header.magic = TRAINER_PACKET_MAGIC;
+    header.sequence = ++g_txSequence;
+    header.captureUs = captureUs;
+    header.format = InputReplay::kFormatVersion;
+    memcpy(frame, &header, sizeof(header));
+    InputReplay::encodeSnapshot(snapshot, frame + sizeof(header));
+
+    const bool sent = Transport::getActive().send(g_peerMac, frame, sizeof(frame)) == ESP_OK;
+    portENTER_CRITICAL(&g_lock);
+    if (sent) {
+        g_stats.framesSent++;
+    } else {
+        g_stats.sendFailures++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+}
+
+bool TrainerLink::merge(InputSnapshot& live, uint32_t nowUs, uint32_t tickUs) {
+    if (getRole() != TrainerRole::Instructor) {
+        return false;
+    }
+    const uint8_t takeoverMask = takeoverMask_.load(std::memory_order_relaxed);
+    const bool takeover = (live.debounced & takeoverMask) != 0;
+    const uint32_t delayUs = getDelayTicks() * tickUs;
+    const uint32_t boundUs = delayUs + tickUs;
+
+    enum class Source : uint8_t { Fresh, Repeat, Neutral } source = Source::Neutral;
+    bool fresh = false;
+    portENTER_CRITICAL(&g_lock);
+    // A frame may have arrived after this tick's capture
+    const bool linkUp = g_haveFrame &&
+                        static_cast<int32_t>(nowUs - g_lastFrameUs) <= static_cast<int32_t>(kLostMs * 1000UL);
+
+    // Newest frame that has waited out the jitter delay; older ones are superseded
+    BufferedFrame* best = nullptr;
+    uint32_t bestAgeUs = 0;
+    for (BufferedFrame& frame : g_frames) {
+        if (!frame.valid) {
+            continue;
+        }
+        const int32_t ageUs = static_cast<int32_t>(nowUs - frame.captureUs - g_offsetUs);
+        if (ageUs >= static_cast<int32_t>(delayUs) && (best == nullptr || newer(frame.sequence, best->sequence))) {
+            best = &frame;
+            bestAgeUs = static_cast<uint32_t>(ageUs);
+        }
+    }
+    if (best != nullptr) {
+        const uint32_t sequence = best->sequence;
+        if (bestAgeUs <= boundUs) {
+            g_trainee = best->snapshot;
+            g_haveTrainee = true;
+            fresh = true;
+            recordAge(g_stats, bestAgeUs);
+        } else {
+            g_stats.late++;
+        }
+        for (BufferedFrame& frame : g_frames) {
+            if (frame.valid && !newer(frame.sequence, sequence)) {
+                frame.valid = false;
+            }
+        }
+    }
+
+    if (linkUp) {
+        g_stats.ticks++;
+        if (fresh) {
+            source = Source::Fresh;
+            g_repeatTicks = 0;
+        } else if (g_haveTrainee && g_repeatTicks < kMaxRepeatTicks) {
+            source = Source::Repeat;
+            g_repeatTicks++;
+        }
+        if (takeover) {
+            g_stats.takeover++;
+        } else if (source == Source::Repeat) {
+            g_stats.repeats++;
+        } else if (source == Source::Neutral) {
+            g_stats.neutral++;
+        }
+    } else if (g_linkUp) {
+        g_stats.lost++;
+    }
+    portEXIT_CRITICAL(&g_lock);
+
+    if (linkUp != g_linkUp) {
+        g_linkUp = linkUp;
+        ILITE_LOG(INPUTS, LOG_INFO, linkUp ? "Trainer: trainee link up" : "Trainer: trainee link lost");
+        if (!linkUp) {
+            g_haveTrainee = false;
+        }
+    }
+    const bool driving = linkUp && !takeover;
+    traineeDriving_.store(driving, std::memory_order_relaxed);
+
+    const bool changed = driving || ((live.buttons | live.debounced | live.pressed) & takeoverMask) != 0;
+    if (driving && source != Source::Neutral) {
+        applyTrainee(live, g_trainee, source == Source::Fresh, getMix());
+    } else if (driving) {
+        // A gap past the repeats: the trainee's sticks centered, no buttons
+        InputSnapshot neutral = live;
+        neutral.joystickA_X = neutral.joystickA_Y = 0.0f;
+        neutral.joystickB_X = neutral.joystickB_Y = 0.0f;
+        neutral.potentiometer = g_haveTrainee ? g_trainee.potentiometer : live.potentiometer;
+        neutral.buttons = neutral.debounced = neutral.pressed = 0;
+        applyTrainee(live, neutral, false, getMix());
+    }
+    live.buttons &= ~takeoverMask;
+    live.debounced &= ~takeoverMask;
+    live.pressed &= ~takeoverMask;
+    return changed;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+TrainerStats TrainerLink::getStats() {
+    portENTER_CRITICAL(&g_lock);
+    const TrainerStats stats = g_stats;
+    portEXIT_CRITICAL(&g_lock);
+    return stats;
+}
+
+void TrainerLink::reset() {
+    portENTER_CRITICAL(&g_lock);
+    g_stats = TrainerStats{};
+    portEXIT_CRITICAL(&g_lock);
+}
+
+void TrainerLink::dump(Print& out) {
+    const TrainerStats stats = getStats();
+    const TrainerRole role = getRole();
+    char label[18] = "-";
+    if (role != TrainerRole::Off) {
+        EspNowDiscovery::macToString(g_peerMac, label, sizeof(label));
+    }
+    out.printf("[Trainer] %s peer=%s mode=%s delay=%u ticks\n",
+               role == TrainerRole::Off ? "off" : (role == TrainerRole::Trainee ? "trainee" : "instructor"),
+               label, getMix() == TrainerMix::Mix ? "mix" : "override",
+               static_cast<unsigned>(getDelayTicks()));
+    if (role == TrainerRole::Trainee) {
+        out.printf("[Trainer] sent=%lu failed=%lu\n",
+                   static_cast<unsigned long>(stats.framesSent),
+                   static_cast<unsigned long>(stats.sendFailures));
+        return;
+    }
+    out.printf("[Trainer] received=%lu bad=%lu out of order=%lu overflows=%lu late=%lu\n",
+               static_cast<unsigned long>(stats.framesReceived),
+               static_cast<unsigned long>(stats.badFrames),
+               static_cast<unsigned long>(stats.outOfOrder),
+               static_cast<unsigned long>(stats.overflows),
+               static_cast<unsigned long>(stats.late));
+    out.printf("[Trainer] ticks=%lu fresh=%lu repeated=%lu neutral=%lu takeover=%lu lost=%lu %s\n",
+               static_cast<unsigned long>(stats.ticks),
+               static_cast<unsigned long>(stats.used),
+               static_cast<unsigned long>(stats.repeats),
+               static_cast<unsigned long>(stats.neutral),
+               static_cast<unsigned long>(stats.takeover),
+               static_cast<unsigned long>(stats.lost),
+               isTraineeDriving() ? "(trainee driving)" : "");
+    out.printf("[Trainer] age us: min=%lu avg=%lu max=%lu\n",
+               static_cast<unsigned long>(stats.minUs),
+               static_cast<unsigned long>(stats.avgUs),
+               static_cast<unsigned long>(stats.maxUs));
+    out.print("[Trainer] hist (<=1/2/5/10/20/30/50/+ ms):");
+    for (size_t i = 0; i < kTrainerLatencyBuckets; ++i) {
+        out.printf(" %lu", static_cast<unsigned long>(stats.histogram[i]));
+    }
+    out.println();
+}
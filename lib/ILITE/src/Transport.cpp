@@ -0,0 +1,60 @@
+/**
+ * @file Transport.cpp
+ * @brief Active transport selection and the ESP-NOW transport
+ */
+
+#include "Transport.h"
+#include "LatencyPins.h"
+
+Transport* Transport::active_ = &EspNowTransport::instance();
+Transport::SentCallback Transport::sentCallback_ = nullptr;
+RxRing* Transport::receiveRing_ = nullptr;
+Transport::NotifyCallback Transport::receiveNotify_ = nullptr;
+
+// ============================================================================
+// Active Transport
+// ============================================================================
+
+bool Transport::setActive(Transport& transport) {
+    if (&transport == active_) {
+        return true;
+    }
+    if (!transport.begin()) {
+        return false;
+    }
+    active_ = &transport;
+    return true;
+}
+
+void Transport::setReceiver(RxRing* ring, NotifyCallback notify) {
+    receiveRing_ = ring;
+    receiveNotify_ = notify;
+}
+
+void Transport::reportSent(const uint8_t* mac, bool success) {
+    if (sentCallback_ != nullptr) {
+        sentCallback_(mac, success ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+    }
+}
+
+void Transport::dump(Print& out) const {
+    out.printf("[Transport] %s\n", getName());
+}
+
+// ============================================================================
+// ESP-NOW
+// ============================================================================
+
+EspNowTransport& EspNowTransport::instance() {
+    static EspNowTransport transport;
+    return transport;
+}
+
+esp_err_t EspNowTransport::send(const uint8_t* mac, const uint8_t* data, size_t length) {
+    ILITE_LATENCY_SEND();
+    const esp_err_t result = esp_now_send(mac, data, length);
+    if (result != ESP_OK) {
+        ILITE_LATENCY_SEND_DONE();      // No send callback follows
+    }
+    return result;
+}
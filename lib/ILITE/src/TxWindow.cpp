@@ -0,0 +1,248 @@
+/**
+ * @file TxWindow.cpp
+ * @brief Bounded in-flight window for command frames
+ */
+
+#include "TxWindow.h"
+#include "Transport.h"
+#include <esp_timer.h>
+#include <cstring>
+
+portMUX_TYPE TxWindow::lock_ = portMUX_INITIALIZER_UNLOCKED;
+TxWindow::InFlight TxWindow::inFlight_[kMaxWindow];
+TxWindow::Held TxWindow::held_[kHeldSlots];
+TxWindowStats TxWindow::stats_;
+
+namespace {
+
+uint32_t nowUs() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+}  // namespace
+
+void TxWindow::begin(uint8_t maxInFlight) {
+    reset();
+    stats_.maxInFlight = maxInFlight > kMaxWindow ? kMaxWindow : maxInFlight;
+}
+
+// ============================================================================
+// CommTask Side
+// ============================================================================
+
+bool TxWindow::submit(const uint8_t* mac, uint8_t key, const uint8_t* data, size_t length) {
+    if (mac == nullptr || data == nullptr || length == 0 || length > sizeof(Held::data)) {
+        return false;
+    }
+    const uint32_t now = nowUs();
+
+    // The newer frame supersedes a held one of the same type
+    if (key != kTxNoCoalesce) {
+        uint32_t coalesced = 0;
+        for (Held& entry : held_) {
+            if (entry.used && entry.key == key && memcmp(entry.mac, mac, 6) == 0) {
+                entry.used = false;
+                coalesced++;
+            }
+        }
+        if (coalesced != 0) {
+            portENTER_CRITICAL(&lock_);
+            stats_.coalesced += coalesced;
+            portEXIT_CRITICAL(&lock_);
+        }
+    }
+
+    if (stats_.maxInFlight == 0 || hasRoom(now)) {
+        bool retry = false;
+        if (transmit(mac, data, length, retry)) {
+            return true;
+        }
+        if (!retry) {
+            return false;
+        }
+    }
+
+    hold(mac, key, data, length, now);
+    return true;
+}
+
+void TxWindow::pump(uint32_t maxAgeUs) {
+    const uint32_t now = nowUs();
+    while (true) {
+        // Oldest held frame first; stale ones are dropped on the way
+        Held* oldest = nullptr;
+        for (Held& entry : held_) {
+            if (!entry.used) {
+                continue;
+            }
+            if (now - entry.heldUs > maxAgeUs) {
+                entry.used = false;
+                portENTER_CRITICAL(&lock_);
+                stats_.dropped++;
+                portEXIT_CRITICAL(&lock_);
+                continue;
+            }
+            if (oldest == nullptr || static_cast<int32_t>(entry.heldUs - oldest->heldUs) < 0) {
+                oldest = &entry;
+            }
+        }
+        if (oldest == nullptr || (stats_.maxInFlight != 0 && !hasRoom(now))) {
+            return;
+        }
+
+        bool retry = false;
+        if (!transmit(oldest->mac, oldest->data, oldest->length, retry) && retry) {
+            return;     // Driver still full; keep it for the next pump
+        }
+        oldest->used = false;
+    }
+}
+
+bool TxWindow::hasRoom(uint32_t now) {
+    portENTER_CRITICAL(&lock_);
+    expireLocked(now);
+    const bool room = stats_.inFlight < stats_.maxInFlight;
+    portEXIT_CRITICAL(&lock_);
+    return room;
+}
+
+bool TxWindow::transmit(const uint8_t* mac, const uint8_t* data, size_t length, bool& retry) {
+    // Claim the window slot first: a wired transport completes inside send()
+    InFlight* claimed = nullptr;
+    if (stats_.maxInFlight != 0) {
+        portENTER_CRITICAL(&lock_);
+        for (InFlight& slot : inFlight_) {
+            if (!slot.used) {
+                memcpy(slot.mac, mac, sizeof(slot.mac));
+                slot.sentUs = nowUs();
+                slot.used = true;
+                stats_.inFlight++;
+                claimed = &slot;
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&lock_);
+    }
+
+    const esp_err_t err = Transport::getActive().send(mac, data, length);
+    retry = err == ESP_ERR_ESPNOW_NO_MEM;
+    portENTER_CRITICAL(&lock_);
+    if (err == ESP_OK) {
+        stats_.sent++;
+    } else {
+        if (claimed != nullptr && claimed->used) {
+            claimed->used = false;
+            stats_.inFlight--;
+        }
+        if (retry) {
+            stats_.driverFull++;
+        } else {
+            stats_.failures++;
+        }
+    }
+    portEXIT_CRITICAL(&lock_);
+    return err == ESP_OK;
+}
+
+void TxWindow::hold(const uint8_t* mac, uint8_t key, const uint8_t* data, size_t length,
+                    uint32_t now) {
+    Held* slot = nullptr;
+    Held* oldest = nullptr;
+    for (Held& entry : held_) {
+        if (!entry.used) {
+            slot = &entry;
+            break;
+        }
+        if (oldest == nullptr || static_cast<int32_t>(entry.heldUs - oldest->heldUs) < 0) {
+            oldest = &entry;
+        }
+    }
+    const bool evicted = slot == nullptr;
+    if (evicted) {
+        // Full: the oldest held frame is the least useful one
+        slot = oldest;
+    }
+
+    memcpy(slot->mac, mac, sizeof(slot->mac));
+    slot->key = key;
+    slot->length = static_cast<uint8_t>(length);
+    slot->heldUs = now;
+    slot->used = true;
+    memcpy(slot->data, data, length);
+
+    portENTER_CRITICAL(&lock_);
+    if (evicted) {
+        stats_.dropped++;
+    }
+    stats_.held++;
+    portEXIT_CRITICAL(&lock_);
+}
+
+// ============================================================================
+// WiFi Task Side
+// ============================================================================
+
+void TxWindow::onSendComplete(const uint8_t* mac) {
+    if (mac == nullptr) {
+        return;
+    }
+    portENTER_CRITICAL(&lock_);
+    // Completions arrive in send order, so release the oldest slot for this peer
+    InFlight* match = nullptr;
+    for (InFlight& slot : inFlight_) {
+        if (slot.used && memcmp(slot.mac, mac, sizeof(slot.mac)) == 0 &&
+            (match == nullptr || static_cast<int32_t>(slot.sentUs - match->sentUs) < 0)) {
+            match = &slot;
+        }
+    }
+    if (match != nullptr) {
+        match->used = false;
+        stats_.inFlight--;
+    }
+    portEXIT_CRITICAL(&lock_);
+}
+
+void TxWindow::expireLocked(uint32_t now) {
+    for (InFlight& slot : inFlight_) {
+        if (slot.used && now - slot.sentUs > kCallbackTimeoutUs) {
+            slot.used = false;
+            stats_.inFlight--;
+            stats_.timeouts++;
+        }
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+TxWindowStats TxWindow::getStats() {
+    portENTER_CRITICAL(&lock_);
+    const TxWindowStats stats = stats_;
+    portEXIT_CRITICAL(&lock_);
+    return stats;
+}
+
+void TxWindow::reset() {
+    portENTER_CRITICAL(&lock_);
+    const uint8_t window = stats_.maxInFlight;
+    const uint8_t inFlight = stats_.inFlight;
+    stats_ = TxWindowStats{};
+    stats_.maxInFlight = window;
+    stats_.inFlight = inFlight;
+    portEXIT_CRITICAL(&lock_);
+}
+
+void TxWindow::dump(Print& out) {
+    const TxWindowStats stats = getStats();
+    out.printf("[TxWindow] window=%u in flight=%u sent=%lu held=%lu coalesced=%lu dropped=%lu\n",
+               stats.maxInFlight, stats.inFlight,
+               static_cast<unsigned long>(stats.sent),
+               static_cast<unsigned long>(stats.held),
+               static_cast<unsigned long>(stats.coalesced),
+               static_cast<unsigned long>(stats.dropped));
+    out.printf("[TxWindow] driver full=%lu failures=%lu callback timeouts=%lu\n",
+               static_cast<unsigned long>(stats.driverFull),
+               static_cast<unsigned long>(stats.failures),
+               static_cast<unsigned long>(stats.timeouts));
+}
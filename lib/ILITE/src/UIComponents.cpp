@@ -351,6 +351,62 @@ void UIComponents::drawMiniGauge(DisplayCanvas& canvas,
     }
 }
 
+void UIComponents::drawSeries(DisplayCanvas& canvas,
+                              int16_t x, int16_t y,
+                              int16_t w, int16_t h,
+                              const SeriesBuffer& series,
+                              size_t window,
+                              int16_t minValue,
+                              int16_t maxValue) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    if (w > SERIES_MAX_COLUMNS) {
+        w = SERIES_MAX_COLUMNS;
+    }
+
+    int16_t colMin[SERIES_MAX_COLUMNS];
+    int16_t colMax[SERIES_MAX_COLUMNS];
+    size_t columns = series.decimate(window, w, colMin, colMax);
+    if (columns == 0) {
+        return;
+    }
+
+    if (minValue >= maxValue && !series.getRange(minValue, maxValue)) {
+        return;
+    }
+    if (minValue >= maxValue) {
+        // Flat signal: centre it
+        minValue -= 1;
+        maxValue += 1;
+    }
+
+    const int32_t span = static_cast<int32_t>(maxValue) - minValue;
+    auto mapY = [&](int16_t value) -> int16_t {
+        int32_t v = constrain(static_cast<int32_t>(value), static_cast<int32_t>(minValue),
+                              static_cast<int32_t>(maxValue));
+        return y + (h - 1) - static_cast<int16_t>((v - minValue) * (h - 1) / span);
+    };
+
+    int16_t px = x + w - static_cast<int16_t>(columns);
+    int16_t prevTop = 0;
+    int16_t prevBottom = 0;
+    for (size_t c = 0; c < columns; ++c, ++px) {
+        int16_t top = mapY(colMax[c]);
+        int16_t bottom = mapY(colMin[c]);
+
+        // Stretch to touch the previous column so the trace stays connected
+        if (c > 0) {
+            if (top > prevBottom) top = prevBottom;
+            if (bottom < prevTop) bottom = prevTop;
+        }
+
+        canvas.drawVLine(px, top, bottom - top + 1);
+        prevTop = mapY(colMax[c]);
+        prevBottom = mapY(colMin[c]);
+    }
+}
+
 void UIComponents::drawConnectionStatus(DisplayCanvas& canvas,
                                         int16_t x, int16_t y,
                                         bool isPaired,
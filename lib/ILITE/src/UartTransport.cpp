@@ -0,0 +1,287 @@
+/**
+ * @file UartTransport.cpp
+ * @brief COBS framing over the IDF UART driver, decoded in place into the RxRing
+ */
+
+#include "UartTransport.h"
+#include "TaskMonitor.h"
+#include <WiFi.h>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 3072;
+constexpr int kRxBufferSize = 4096;
+constexpr int kTxBufferSize = 4096;
+constexpr int kEventQueueSize = 16;
+constexpr uint8_t kRxTimeoutSymbols = 2;    // Flush partial FIFOs quickly
+
+const uint8_t kBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+using Framing::cobsEncode;
+using Framing::crc16;
+using Framing::crc16Update;
+using Framing::putU16;
+
+}  // namespace
+
+UartTransport& UartTransport::instance() {
+    static UartTransport transport;
+    return transport;
+}
+
+bool UartTransport::begin() {
+    if (rxTask_ != nullptr) {
+        return true;
+    }
+
+    uart_config_t uartConfig{};
+    uartConfig.baud_rate = static_cast<int>(config_.baud);
+    uartConfig.data_bits = UART_DATA_8_BITS;
+    uartConfig.parity = UART_PARITY_DISABLE;
+    uartConfig.stop_bits = UART_STOP_BITS_1;
+    uartConfig.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    uartConfig.source_clk = UART_SCLK_APB;
+
+    if (uart_driver_install(config_.port, kRxBufferSize, kTxBufferSize,
+                            kEventQueueSize, &events_, 0) != ESP_OK) {
+        Serial.println("[UART] Driver install failed");
+        return false;
+    }
+    const int dePin = config_.dePin >= 0 ? config_.dePin : UART_PIN_NO_CHANGE;
+    if (uart_param_config(config_.port, &uartConfig) != ESP_OK ||
+        uart_set_pin(config_.port, config_.txPin, config_.rxPin, dePin, UART_PIN_NO_CHANGE) != ESP_OK ||
+        (config_.dePin >= 0 &&
+         uart_set_mode(config_.port, UART_MODE_RS485_HALF_DUPLEX) != ESP_OK)) {
+        Serial.println("[UART] Configuration failed");
+        uart_driver_delete(config_.port);
+        events_ = nullptr;
+        return false;
+    }
+    uart_set_rx_timeout(config_.port, kRxTimeoutSymbols);
+    WiFi.macAddress(selfMac_);
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        rxTaskEntry,
+        "UartRx",
+        kTaskStackSize,
+        this,
+        taskPriority_,
+        &rxTask_,
+        taskCore_
+    );
+    if (result != pdPASS) {
+        Serial.println("[UART] Failed to create receive task");
+        rxTask_ = nullptr;
+        uart_driver_delete(config_.port);
+        events_ = nullptr;
+        return false;
+    }
+    TaskMonitor::watch(rxTask_, kTaskStackSize, taskCore_);
+
+    Serial.printf("[UART] Transport on UART%d at %lu baud (tx=%d rx=%d de=%d)\n",
+                  static_cast<int>(config_.port), static_cast<unsigned long>(config_.baud),
+                  config_.txPin, config_.rxPin, config_.dePin);
+    return true;
+}
+
+// ============================================================================
+// Sending (any task)
+// ============================================================================
+
+esp_err_t UartTransport::send(const uint8_t* mac, const uint8_t* data, size_t length) {
+    if (mac == nullptr || data == nullptr || length == 0 || length > RxFrame::kMaxPayload) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rxTask_ == nullptr) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t frame[kMaxDecoded];
+    memcpy(frame, selfMac_, 6);
+    memcpy(frame + 6, mac, 6);
+    memcpy(frame + kAddressBytes, data, length);
+    size_t frameLength = kAddressBytes + length;
+    putU16(frame + frameLength, crc16(frame, frameLength));
+    frameLength += 2;
+
+    uint8_t encoded[kMaxEncoded];
+    const size_t encodedLength = cobsEncode(frame, frameLength, encoded);
+    // One write per frame (the driver serialises writers), so frames never interleave
+    if (uart_write_bytes(config_.port, encoded, encodedLength) != static_cast<int>(encodedLength)) {
+        return ESP_FAIL;
+    }
+    stats_.txFrames++;
+    stats_.txBytes += encodedLength;
+    reportSent(mac, true);
+    return ESP_OK;
+}
+
+// ============================================================================
+// Receiving (receive task)
+// ============================================================================
+
+void UartTransport::rxTaskEntry(void* param) {
+    UartTransport* self = static_cast<UartTransport*>(param);
+    uint8_t chunk[128];
+    uart_event_t event;
+
+    while (true) {
+        if (xQueueReceive(self->events_, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        switch (event.type) {
+            case UART_DATA: {
+                size_t pending = event.size;
+                while (pending > 0) {
+                    const size_t want = pending < sizeof(chunk) ? pending : sizeof(chunk);
+                    const int got = uart_read_bytes(self->config_.port, chunk, want, 0);
+                    if (got <= 0) {
+                        break;
+                    }
+                    self->stats_.rxBytes += got;
+                    self->receive(chunk, static_cast<size_t>(got));
+                    pending -= static_cast<size_t>(got);
+                }
+                break;
+            }
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // Bytes were lost; resynchronise on the next delimiter
+                self->stats_.driverOverflows++;
+                uart_flush_input(self->config_.port);
+                xQueueReset(self->events_);
+                self->dropping_ = self->inFrame_;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void UartTransport::receive(const uint8_t* bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        const uint8_t byte = bytes[i];
+        if (byte == 0x00) {
+            endFrame();
+            continue;
+        }
+        if (!inFrame_) {
+            restartFrame();
+            inFrame_ = true;
+        }
+        if (blockRemaining_ == 0) {
+            // A block shorter than 254 bytes stood for a zero (not before the first)
+            if (blockCode_ != 0 && blockCode_ != 0xFF) {
+                emit(0x00);
+            }
+            blockCode_ = byte;
+            blockRemaining_ = byte - 1;
+        } else {
+            emit(byte);
+            blockRemaining_--;
+        }
+    }
+}
+
+void UartTransport::emit(uint8_t byte) {
+    if (dropping_) {
+        return;
+    }
+    if (lagCount_ < 2) {
+        lag_[lagCount_++] = byte;
+        return;
+    }
+    const uint8_t out = lag_[0];
+    lag_[0] = lag_[1];
+    lag_[1] = byte;
+    store(out);
+}
+
+void UartTransport::store(uint8_t byte) {
+    if (decoded_ == 0) {
+        slot_ = receiveRing_ != nullptr ? receiveRing_->reserve() : nullptr;
+        if (slot_ == nullptr) {
+            stats_.ringFull++;
+            dropping_ = true;
+            return;
+        }
+    }
+
+    if (decoded_ < 6) {
+        slot_->mac[decoded_] = byte;
+    } else if (decoded_ < kAddressBytes) {
+        dst_[decoded_ - 6] = byte;
+    } else if (decoded_ - kAddressBytes < RxFrame::kMaxPayload) {
+        slot_->data[decoded_ - kAddressBytes] = byte;
+    } else {
+        stats_.framingErrors++;
+        dropping_ = true;
+        return;
+    }
+    crc_ = crc16Update(crc_, byte);
+    decoded_++;
+}
+
+void UartTransport::endFrame() {
+    if (!inFrame_) {
+        return;     // Idle delimiters
+    }
+    inFrame_ = false;
+    if (dropping_) {
+        return;
+    }
+    if (blockRemaining_ != 0 || lagCount_ < 2 || decoded_ <= kAddressBytes) {
+        stats_.framingErrors++;
+        return;
+    }
+    const uint16_t received = static_cast<uint16_t>(lag_[0] | (lag_[1] << 8));
+    if (received != crc_) {
+        stats_.crcErrors++;
+        return;
+    }
+    if (memcmp(dst_, selfMac_, sizeof(dst_)) != 0 &&
+        memcmp(dst_, kBroadcastMac, sizeof(dst_)) != 0) {
+        stats_.notForUs++;
+        return;
+    }
+
+    // The slot was filled in place; publishing it is all that is left
+    receiveRing_->commit(static_cast<uint8_t>(decoded_ - kAddressBytes));
+    slot_ = nullptr;
+    stats_.rxFrames++;
+    if (receiveNotify_ != nullptr) {
+        receiveNotify_();
+    }
+}
+
+void UartTransport::restartFrame() {
+    slot_ = nullptr;
+    decoded_ = 0;
+    crc_ = Framing::kCrcInit;
+    lagCount_ = 0;
+    blockCode_ = 0;
+    blockRemaining_ = 0;
+    dropping_ = false;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void UartTransport::dump(Print& out) const {
+    out.printf("[Transport] UART%d %lu baud%s\n", static_cast<int>(config_.port),
+               static_cast<unsigned long>(config_.baud),
+               config_.dePin >= 0 ? " (RS485)" : "");
+    out.printf("[Transport] tx frames=%lu bytes=%lu  rx frames=%lu bytes=%lu\n",
+               static_cast<unsigned long>(stats_.txFrames),
+               static_cast<unsigned long>(stats_.txBytes),
+               static_cast<unsigned long>(stats_.rxFrames),
+               static_cast<unsigned long>(stats_.rxBytes));
+    out.printf("[Transport] crc errors=%lu framing=%lu not for us=%lu ring full=%lu overflows=%lu\n",
+               static_cast<unsigned long>(stats_.crcErrors),
+               static_cast<unsigned long>(stats_.framingErrors),
+               static_cast<unsigned long>(stats_.notForUs),
+               static_cast<unsigned long>(stats_.ringFull),
+               static_cast<unsigned long>(stats_.driverOverflows));
+}
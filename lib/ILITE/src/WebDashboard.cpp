@@ -0,0 +1,759 @@
+/**
+ * @file WebDashboard.cpp
+ * @brief Polled HTTP server, minimal WebSocket and the telemetry push loop
+ */
+
+#include "WebDashboard.h"
+#include "ILITEModule.h"
+#include "ModuleHandoff.h"
+#include "ScreenCapture.h"
+#include "TaskMonitor.h"
+#include "TelemetryStore.h"
+#include <WiFi.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mbedtls/base64.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/version.h>
+
+namespace {
+
+constexpr uint32_t kTaskStackSize = 4096;
+constexpr uint32_t kPollMs = 5;                 ///< Accept and read interval
+constexpr uint32_t kRequestTimeoutMs = 500;     ///< Whole request head
+constexpr size_t kLineBytes = 128;
+constexpr size_t kRxBytes = 64;                 ///< Acks, pings and close frames only
+constexpr size_t kHeaderRoom = 4;               ///< 0x82, 126, length:u16
+
+constexpr uint8_t kFrameSchema = 0x01;
+constexpr uint8_t kFrameBatch = 0x02;
+constexpr uint8_t kFrameScreen = 0x03;
+
+constexpr uint8_t kOpText = 0x1;
+constexpr uint8_t kOpBinary = 0x2;
+constexpr uint8_t kOpClose = 0x8;
+constexpr uint8_t kOpPing = 0x9;
+constexpr uint8_t kOpPong = 0xA;
+
+const char kSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+const char kIndexHtml[] PROGMEM = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8">
+<meta name="viewport" content="width=device-width,initial-scale=1">
+<title>ILITE</title>
+<style>
+body{font:14px monospace;margin:8px;background:#111;color:#ddd}
+h1{font-size:16px;margin:4px 0}h2{font-size:14px;margin:12px 0 2px;color:#8cf}
+table{border-collapse:collapse;width:100%}td{padding:1px 6px}
+td.v{text-align:right;color:#fff}#s{color:#888}
+#d{width:256px;image-rendering:pixelated;border:1px solid #333;margin:4px 0}
+</style></head><body>
+<h1 id="m">ILITE</h1><div id="s">connecting</div><canvas id="d" width="128" height="64"></canvas><div id="t"></div>
+<script>
+var types=[],cells=[],ws,frames=0,last=Date.now(),px=null,pw=0,pp=0;
+function schema(d){
+ var o=1,n=d.getUint8(o++),l=d.getUint8(o++),td=new TextDecoder();
+ function str(len){var s=td.decode(new Uint8Array(d.buffer,o,len));o+=len;return s;}
+ document.getElementById('m').textContent=str(l);
+ types=[];cells=[];var root=document.getElementById('t');root.innerHTML='';
+ for(var i=0;i<n;i++){
+  var name=str(d.getUint8(o++)),fc=d.getUint8(o++),fields=[],row=[];
+  var h=document.createElement('h2');h.textContent=name;root.appendChild(h);
+  var tb=document.createElement('table');root.appendChild(tb);
+  for(var f=0;f<fc;f++){
+   var type=d.getUint8(o++),fn=str(d.getUint8(o++)),tr=tb.insertRow();
+   tr.insertCell().textContent=fn;var c=tr.insertCell();c.className='v';c.textContent='-';
+   fields.push(type);row.push(c);
+  }
+  var foot=tb.insertRow().insertCell();foot.colSpan=2;foot.id='c'+i;
+  types.push(fields);cells.push(row);
+ }
+}
+function batch(d){
+ var o=1,n=d.getUint8(o++);o+=4;
+ for(var i=0;i<n;i++){
+  var t=d.getUint8(o++),co=d.getUint16(o,true);o+=2;var fc=d.getUint8(o++);
+  for(var f=0;f<fc;f++,o+=4){
+   if(!cells[t]||!cells[t][f])continue;
+   var v=d.getFloat32(o,true),type=types[t][f];
+   cells[t][f].textContent=isNaN(v)?'[bytes]':type==6?v.toFixed(3):type==7?(v?'true':'false'):v;
+  }
+  var foot=document.getElementById('c'+t);if(foot)foot.textContent=co?'+'+co+' coalesced':'';
+ }
+ frames++;
+}
+function disp(d){
+ var o=1,key=d.getUint8(o++)&1,w=d.getUint8(o++)*8,pc=d.getUint8(o++),cv=document.getElementById('d');
+ if(key||!px||pw!=w||pp!=pc){px=new Uint8Array(w*pc);pw=w;pp=pc;cv.width=w;cv.height=pc*8;}
+ while(o<d.byteLength){
+  var at=d.getUint8(o++)*w,end=o+2+d.getUint16(o,true);o+=2;
+  while(o<end){var c=d.getUint8(o++);
+   if(c<128){for(var k=0;k<=c;k++)px[at++]^=d.getUint8(o++);}
+   else{var v=d.getUint8(o++);for(var k=c-125;k>0;k--)px[at++]^=v;}}
+ }
+ var cx=cv.getContext('2d'),im=cx.createImageData(w,pc*8);
+ for(var y=0;y<pc*8;y++)for(var x=0;x<w;x++){
+  var q=(y*w+x)*4,on=(px[(y>>3)*w+x]>>(y&7))&1;
+  im.data[q]=im.data[q+1]=im.data[q+2]=on?255:0;im.data[q+3]=255;
+ }
+ cx.putImageData(im,0,0);
+}
+function connect(){
+ ws=new WebSocket('ws://'+location.host+'/ws');ws.binaryType='arraybuffer';
+ ws.onmessage=function(e){
+  var d=new DataView(e.data),k=d.getUint8(0);
+  if(k==1)schema(d);else if(k==2)batch(d);else if(k==3)disp(d);
+  requestAnimationFrame(function(){if(ws.readyState==1)ws.send(new Uint8Array([k]));});
+ };
+ ws.onclose=function(){document.getElementById('s').textContent='reconnecting';setTimeout(connect,1000);};
+}
+setInterval(function(){var now=Date.now();
+ if(ws&&ws.readyState==1)document.getElementById('s').textContent=Math.round(frames*1000/(now-last))+' frames/s';
+ frames=0;last=now;},1000);
+connect();
+</script></body></html>
+)HTML";
+
+// Control (ServiceTask) -> web task
+std::atomic<bool> g_wantRunning{false};
+std::atomic<uint16_t> g_port{80};
+std::atomic<bool> g_running{false};
+TaskHandle_t g_taskHandle = nullptr;
+
+// Web task state
+WiFiServer* g_server = nullptr;
+uint16_t g_serverPort = 0;
+WiFiClient g_socket;
+bool g_socketOpen = false;
+size_t g_credits = 0;
+uint8_t g_rx[kRxBytes];
+size_t g_rxLength = 0;
+ILITEModule* g_schemaModule = nullptr;
+bool g_schemaSent = false;
+uint32_t g_lastSequence[TelemetryStore::kMaxSlots] = {};
+uint32_t g_lastPushMs = 0;
+uint32_t g_rateWindowMs = 0;
+uint32_t g_rateFrames = 0;
+bool g_stalled = false;
+uint8_t g_frame[kHeaderRoom + WebDashboard::kMaxFrameBytes];
+uint8_t g_screen[ScreenCapture::kFrameBytes];           ///< Newest captured frame
+uint8_t g_screenReference[ScreenCapture::kFrameBytes];  ///< What the page shows
+uint32_t g_screenSequence = 0;
+uint8_t g_screenTileWidth = 0;
+uint8_t g_screenPages = 0;
+bool g_screenShown = false;             ///< The page holds a frame to diff against
+uint32_t g_lastScreenMs = 0;
+
+WebDashboardStats g_stats;
+
+// ============================================================================
+// WebSocket framing
+// ============================================================================
+
+/// Send g_frame[kHeaderRoom..kHeaderRoom+length) as one unmasked frame
+bool sendFrame(uint8_t opcode, size_t length) {
+    size_t start;
+    if (length < 126) {
+        start = kHeaderRoom - 2;
+        g_frame[start + 1] = static_cast<uint8_t>(length);
+    } else {
+        start = 0;
+        g_frame[1] = 126;
+        g_frame[2] = static_cast<uint8_t>(length >> 8);
+        g_frame[3] = static_cast<uint8_t>(length);
+    }
+    g_frame[start] = 0x80 | opcode;
+    const size_t total = kHeaderRoom - start + length;
+    if (g_socket.write(g_frame + start, total) != total) {
+        return false;
+    }
+    g_stats.bytes += length;
+    return true;
+}
+
+void closeSocket() {
+    if (g_socketOpen) {
+        g_socket.stop();
+        ScreenCapture::setWebViewer(false);
+    }
+    g_socketOpen = false;
+    g_rxLength = 0;
+    g_stats.connected = false;
+}
+
+/// Consume complete client frames in g_rx; false drops the client
+bool parseClientFrames() {
+    while (g_rxLength >= 2) {
+        const uint8_t opcode = g_rx[0] & 0x0F;
+        const bool masked = (g_rx[1] & 0x80) != 0;
+        size_t length = g_rx[1] & 0x7F;
+        size_t header = 2;
+        if (length == 127) {
+            return false;  // Nothing the page sends is that large
+        }
+        if (length == 126) {
+            if (g_rxLength < 4) {
+                return true;
+            }
+            length = (static_cast<size_t>(g_rx[2]) << 8) | g_rx[3];
+            header = 4;
+        }
+        const size_t maskAt = header;
+        if (masked) {
+            header += 4;
+        }
+        const size_t total = header + length;
+        if (total > sizeof(g_rx)) {
+            return false;
+        }
+        if (g_rxLength < total) {
+            return true;
+        }
+
+        uint8_t* payload = g_rx + header;
+        if (masked) {
+            for (size_t i = 0; i < length; ++i) {
+                payload[i] ^= g_rx[maskAt + (i & 3)];
+            }
+        }
+
+        if (opcode == kOpClose) {
+            return false;
+        }
+        if (opcode == kOpPing) {
+            memcpy(g_frame + kHeaderRoom, payload, length);
+            sendFrame(kOpPong, length);
+        } else if (opcode != kOpPong) {
+            // Text, binary or continuation: the page drew a frame
+            g_credits = std::min(g_credits + 1, WebDashboard::kCredits);
+        }
+
+        memmove(g_rx, g_rx + total, g_rxLength - total);
+        g_rxLength -= total;
+    }
+    return true;
+}
+
+void readSocket() {
+    if (!g_socket.connected()) {
+        closeSocket();
+        return;
+    }
+    int available = g_socket.available();
+    while (available > 0 && g_rxLength < sizeof(g_rx)) {
+        const int got = g_socket.read(g_rx + g_rxLength, sizeof(g_rx) - g_rxLength);
+        if (got <= 0) {
+            break;
+        }
+        g_rxLength += got;
+        if (!parseClientFrames()) {
+            closeSocket();
+            return;
+        }
+        available = g_socket.available();
+    }
+}
+
+// ============================================================================
+// HTTP
+// ============================================================================
+
+/// Read one header line (CR LF stripped); false on timeout or overflow
+bool readLine(WiFiClient& client, char* line, size_t size, uint32_t deadlineMs) {
+    size_t length = 0;
+    while (static_cast<int32_t>(deadlineMs - millis()) > 0) {
+        if (!client.connected()) {
+            return false;
+        }
+        const int c = client.read();
+        if (c < 0) {
+            vTaskDelay(pdMS_TO_TICKS(1));
+            continue;
+        }
+        if (c == '\n') {
+            if (length > 0 && line[length - 1] == '\r') {
+                length--;
+            }
+            line[length] = '\0';
+            return true;
+        }
+        if (length + 1 >= size) {
+            return false;
+        }
+        line[length++] = static_cast<char>(c);
+    }
+    return false;
+}
+
+bool acceptKey(const char* key, char* out, size_t outSize) {
+    char joined[64];
+    const int joinedLength = snprintf(joined, sizeof(joined), "%s%s", key, kSocketGuid);
+    if (joinedLength <= 0 || static_cast<size_t>(joinedLength) >= sizeof(joined)) {
+        return false;
+    }
+    unsigned char digest[20];
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+    if (mbedtls_sha1_ret(reinterpret_cast<const unsigned char*>(joined), joinedLength, digest) != 0) {
+        return false;
+    }
+#else
+    if (mbedtls_sha1(reinterpret_cast<const unsigned char*>(joined), joinedLength, digest) != 0) {
+        return false;
+    }
+#endif
+    size_t written = 0;
+    if (mbedtls_base64_encode(reinterpret_cast<unsigned char*>(out), outSize - 1, &written,
+                              digest, sizeof(digest)) != 0) {
+        return false;
+    }
+    out[written] = '\0';
+    return true;
+}
+
+void handleRequest(WiFiClient& client) {
+    const uint32_t deadline = millis() + kRequestTimeoutMs;
+    char line[kLineBytes];
+    if (!readLine(client, line, sizeof(line), deadline)) {
+        client.stop();
+        return;
+    }
+    char path[32] = "";
+    if (sscanf(line, "GET %31s HTTP/1.%*c", path) != 1) {
+        client.print("HTTP/1.1 405 Method Not Allowed\r\nConnection: close\r\n\r\n");
+        client.stop();
+        return;
+    }
+
+    char key[32] = "";
+    while (readLine(client, line, sizeof(line), deadline)) {
+        if (line[0] == '\0') {
+            break;
+        }
+        if (strncasecmp(line, "Sec-WebSocket-Key:", 18) == 0) {
+            const char* value = line + 18;
+            while (*value == ' ') {
+                value++;
+            }
+            strncpy(key, value, sizeof(key) - 1);
+        }
+    }
+
+    if (strcmp(path, "/") == 0) {
+        const size_t length = strlen_P(kIndexHtml);
+        client.printf("HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %u\r\n"
+                      "Cache-Control: max-age=3600\r\nConnection: close\r\n\r\n",
+                      static_cast<unsigned>(length));
+        client.write(reinterpret_cast<const uint8_t*>(kIndexHtml), length);
+        client.stop();
+        g_stats.pages++;
+        return;
+    }
+
+    char accept[32];
+    if (strcmp(path, "/ws") != 0 || key[0] == '\0' || !acceptKey(key, accept, sizeof(accept))) {
+        client.print("HTTP/1.1 404 Not Found\r\nConnection: close\r\n\r\n");
+        client.stop();
+        return;
+    }
+
+    client.printf("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                  "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+    closeSocket();
+    client.setNoDelay(true);
+    g_socket = client;
+    g_socketOpen = true;
+    g_credits = WebDashboard::kCredits;
+    g_schemaSent = false;
+    g_stalled = false;
+    g_screenSequence = 0;
+    g_screenShown = false;
+    ScreenCapture::setWebViewer(true);
+    g_stats.clients++;
+    g_stats.connected = true;
+}
+
+// ============================================================================
+// Telemetry push
+// ============================================================================
+
+size_t typeCount(ILITEModule* module) {
+    if (module == nullptr) {
+        return 0;
+    }
+    return std::min(module->getTelemetryPacketTypeCount(), TelemetryStore::kMaxSlots);
+}
+
+/// Append a length-prefixed string; false if it does not fit
+bool putString(size_t& at, const char* text) {
+    const size_t length = std::min<size_t>(text ? strlen(text) : 0, 255);
+    if (at + 1 + length > WebDashboard::kMaxFrameBytes) {
+        return false;
+    }
+    g_frame[kHeaderRoom + at++] = static_cast<uint8_t>(length);
+    memcpy(g_frame + kHeaderRoom + at, text, length);
+    at += length;
+    return true;
+}
+
+bool sendSchema(ILITEModule* module) {
+    uint8_t* body = g_frame + kHeaderRoom;
+    const size_t count = typeCount(module);
+    size_t at = 0;
+    body[at++] = kFrameSchema;
+    body[at++] = 0;
+    putString(at, module ? module->getModuleName() : "No module");
+
+    uint8_t sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
+        const size_t typeStart = at;
+        const size_t fields = desc.fields ? std::min<size_t>(desc.fieldCount, 255) : 0;
+        bool fits = putString(at, desc.name) && at + 1 <= WebDashboard::kMaxFrameBytes;
+        if (fits) {
+            body[at++] = static_cast<uint8_t>(fields);
+        }
+        for (size_t f = 0; fits && f < fields; ++f) {
+            fits = at + 1 <= WebDashboard::kMaxFrameBytes;
+            if (fits) {
+                body[at++] = static_cast<uint8_t>(desc.fields[f].type);
+                fits = putString(at, desc.fields[f].name);
+            }
+        }
+        if (!fits) {
+            at = typeStart;  // Later types are not shown
+            break;
+        }
+        sent++;
+    }
+    body[1] = sent;
+    if (!sendFrame(kOpBinary, at)) {
+        return false;
+    }
+    g_stats.schemas++;
+    return true;
+}
+
+float decodeField(const PacketDescriptor::Field& field, const uint8_t* data, size_t length) {
+    if (field.offset + field.size > length) {
+        return NAN;
+    }
+    const uint8_t* at = data + field.offset;
+    switch (field.type) {
+        case PacketDescriptor::Field::INT8:   { int8_t v;   memcpy(&v, at, 1); return v; }
+        case PacketDescriptor::Field::UINT8:  { uint8_t v;  memcpy(&v, at, 1); return v; }
+        case PacketDescriptor::Field::BOOL:   { uint8_t v;  memcpy(&v, at, 1); return v ? 1.0f : 0.0f; }
+        case PacketDescriptor::Field::INT16:  { int16_t v;  memcpy(&v, at, 2); return v; }
+        case PacketDescriptor::Field::UINT16: { uint16_t v; memcpy(&v, at, 2); return v; }
+        case PacketDescriptor::Field::INT32:  { int32_t v;  memcpy(&v, at, 4); return static_cast<float>(v); }
+        case PacketDescriptor::Field::UINT32: { uint32_t v; memcpy(&v, at, 4); return static_cast<float>(v); }
+        case PacketDescriptor::Field::FLOAT:  { float v;    memcpy(&v, at, 4); return v; }
+        default:
+            return NAN;
+    }
+}
+
+/// Push every changed type that fits one frame; types left out go next time
+void pushBatch(ILITEModule* module) {
+    const size_t count = typeCount(module);
+    TelemetryStore& store = TelemetryStore::getInstance();
+    uint8_t* body = g_frame + kHeaderRoom;
+    const uint32_t now = millis();
+    size_t at = 0;
+    body[at++] = kFrameBatch;
+    body[at++] = 0;
+    memcpy(body + at, &now, sizeof(now));
+    at += sizeof(now);
+
+    uint8_t packets = 0;
+    uint32_t coalesced = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetrySlot* slot = store.getSlot(i);
+        if (slot == nullptr || slot->getSequence() == g_lastSequence[i]) {
+            continue;
+        }
+        const PacketDescriptor desc = module->getTelemetryPacketDescriptor(i);
+        const size_t fields = desc.fields ? std::min<size_t>(desc.fieldCount, 255) : 0;
+        const size_t entry = 4 + fields * sizeof(float);
+        if (at + entry > WebDashboard::kMaxFrameBytes) {
+            continue;
+        }
+
+        uint32_t sequence = 0;
+        const bool ok = slot->inspect([&](const uint8_t* data, size_t length) {
+            for (size_t f = 0; f < fields; ++f) {
+                const float value = decodeField(desc.fields[f], data, length);
+                memcpy(body + at + 4 + f * sizeof(float), &value, sizeof(value));
+            }
+        }, &sequence);
+        if (!ok) {
+            continue;
+        }
+
+        const uint32_t skipped = g_lastSequence[i] != 0 ? (sequence - g_lastSequence[i]) / 2 - 1 : 0;
+        const uint16_t skippedField = static_cast<uint16_t>(std::min<uint32_t>(skipped, UINT16_MAX));
+        body[at] = static_cast<uint8_t>(i);
+        memcpy(body + at + 1, &skippedField, sizeof(skippedField));
+        body[at + 3] = static_cast<uint8_t>(fields);
+        at += entry;
+        g_lastSequence[i] = sequence;
+        coalesced += skipped;
+        packets++;
+    }
+    if (packets == 0) {
+        return;
+    }
+    body[1] = packets;
+    if (!sendFrame(kOpBinary, at)) {
+        closeSocket();
+        return;
+    }
+    g_credits--;
+    g_lastPushMs = now;
+    g_rateFrames++;
+    g_stats.batches++;
+    g_stats.packets += packets;
+    g_stats.coalesced += coalesced;
+}
+
+/// Push the pages of the newest display frame that differ from what the page shows
+void pushScreen() {
+    uint8_t tileWidth = 0;
+    uint8_t pageCount = 0;
+    if (!ScreenCapture::copyLatest(g_screen, g_screenSequence, tileWidth, pageCount)) {
+        return;
+    }
+    const bool keyframe = !g_screenShown || tileWidth != g_screenTileWidth ||
+                          pageCount != g_screenPages;
+    if (keyframe) {
+        memset(g_screenReference, 0, sizeof(g_screenReference));
+        g_screenTileWidth = tileWidth;
+        g_screenPages = pageCount;
+    }
+
+    uint8_t* body = g_frame + kHeaderRoom;
+    const size_t pageBytes = static_cast<size_t>(tileWidth) * 8;
+    size_t at = 0;
+    body[at++] = kFrameScreen;
+    body[at++] = keyframe ? 0x01 : 0x00;
+    body[at++] = tileWidth;
+    body[at++] = pageCount;
+    const size_t headerBytes = at;
+
+    for (uint8_t page = 0; page < pageCount; ++page) {
+        const uint8_t* current = g_screen + page * pageBytes;
+        uint8_t* known = g_screenReference + page * pageBytes;
+        if (memcmp(current, known, pageBytes) == 0) {
+            continue;
+        }
+        if (at + 3 + ScreenCapture::kMaxEncodedPage > WebDashboard::kMaxFrameBytes) {
+            g_screenSequence = 0;   // Copy the frame again for the pages left out
+            break;
+        }
+        const uint16_t encoded = static_cast<uint16_t>(
+            ScreenCapture::encodeDelta(current, known, pageBytes, body + at + 3));
+        body[at] = page;
+        memcpy(body + at + 1, &encoded, sizeof(encoded));
+        at += 3 + encoded;
+        memcpy(known, current, pageBytes);
+    }
+    if (at == headerBytes && !keyframe) {
+        return;
+    }
+    if (!sendFrame(kOpBinary, at)) {
+        closeSocket();
+        return;
+    }
+    g_credits--;
+    g_screenShown = true;
+    g_lastScreenMs = millis();
+    g_rateFrames++;
+    g_stats.screens++;
+}
+
+bool anyChanged(ILITEModule* module) {
+    const size_t count = typeCount(module);
+    TelemetryStore& store = TelemetryStore::getInstance();
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetrySlot* slot = store.getSlot(i);
+        if (slot != nullptr && slot->getSequence() != g_lastSequence[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void servicePush() {
+    ModulePin pin(ModuleHandoff::Reader::Web);
+    ILITEModule* module = pin.get();
+
+    if (!g_schemaSent || module != g_schemaModule) {
+        if (!sendSchema(module)) {
+            closeSocket();
+            return;
+        }
+        g_schemaModule = module;
+        g_schemaSent = true;
+        memset(g_lastSequence, 0, sizeof(g_lastSequence));
+    }
+
+    // The screen shares the credits; a phone drawing slowly gets fewer screens too
+    if (g_credits > 0 && millis() - g_lastScreenMs >= WebDashboard::kMinScreenIntervalMs) {
+        pushScreen();
+        if (!g_socketOpen) {
+            return;
+        }
+    }
+
+    if (millis() - g_lastPushMs < WebDashboard::kMinPushIntervalMs || !anyChanged(module)) {
+        return;
+    }
+    if (g_credits == 0) {
+        if (!g_stalled) {
+            g_stats.creditStalls++;
+            g_stalled = true;
+        }
+        return;
+    }
+    g_stalled = false;
+    pushBatch(module);
+}
+
+// ============================================================================
+// Task
+// ============================================================================
+
+void stopServer() {
+    closeSocket();
+    if (g_server != nullptr) {
+        g_server->end();
+        delete g_server;
+        g_server = nullptr;
+    }
+    g_serverPort = 0;
+    g_running.store(false, std::memory_order_release);
+}
+
+bool startServer(uint16_t port) {
+    stopServer();
+    g_server = new (std::nothrow) WiFiServer(port);
+    if (g_server == nullptr) {
+        return false;
+    }
+    g_server->begin();
+    g_server->setNoDelay(true);
+    g_serverPort = port;
+    g_running.store(true, std::memory_order_release);
+    Serial.printf("[Web] Dashboard on http://%s:%u/\n",
+                  WiFi.softAPIP().toString().c_str(), static_cast<unsigned>(port));
+    return true;
+}
+
+void webTask(void*) {
+    while (true) {
+        if (!g_wantRunning.load(std::memory_order_acquire)) {
+            if (g_server != nullptr) {
+                stopServer();
+                Serial.println("[Web] Dashboard stopped");
+            }
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        const uint16_t port = g_port.load(std::memory_order_relaxed);
+        if (g_server == nullptr || g_serverPort != port) {
+            if (!startServer(port)) {
+                Serial.println("[Web] Out of memory, dashboard not started");
+                g_wantRunning.store(false, std::memory_order_release);
+                continue;
+            }
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kPollMs));
+
+        WiFiClient client = g_server->available();
+        if (client) {
+            handleRequest(client);
+        }
+        if (g_socketOpen) {
+            readSocket();
+        }
+        if (g_socketOpen) {
+            servicePush();
+        }
+
+        const uint32_t now = millis();
+        if (now - g_rateWindowMs >= 1000) {
+            g_stats.pushHz = g_rateFrames;
+            g_rateFrames = 0;
+            g_rateWindowMs = now;
+        }
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Control
+// ============================================================================
+
+bool WebDashboard::begin(uint16_t port, UBaseType_t priority, BaseType_t core) {
+    g_port.store(port, std::memory_order_relaxed);
+    g_wantRunning.store(true, std::memory_order_release);
+    if (g_taskHandle == nullptr) {
+        BaseType_t result = xTaskCreatePinnedToCore(
+            webTask,
+            "WebDashboard",
+            kTaskStackSize,
+            nullptr,
+            priority,
+            &g_taskHandle,
+            core
+        );
+        if (result != pdPASS) {
+            Serial.println("[Web] Failed to create the dashboard task");
+            g_taskHandle = nullptr;
+            g_wantRunning.store(false, std::memory_order_release);
+            return false;
+        }
+        TaskMonitor::watch(g_taskHandle, kTaskStackSize, core);
+    } else {
+        xTaskNotifyGive(g_taskHandle);
+    }
+    return true;
+}
+
+void WebDashboard::end() {
+    g_wantRunning.store(false, std::memory_order_release);
+    if (g_taskHandle != nullptr) {
+        xTaskNotifyGive(g_taskHandle);
+    }
+}
+
+bool WebDashboard::isRunning() {
+    return g_wantRunning.load(std::memory_order_acquire);
+}
+
+WebDashboardStats WebDashboard::getStats() {
+    return g_stats;
+}
+
+void WebDashboard::dump(Print& out) {
+    const WebDashboardStats stats = g_stats;
+    out.printf("[Web] %s, port %u, client %s\n",
+               isRunning() ? "running" : "stopped",
+               static_cast<unsigned>(g_port.load(std::memory_order_relaxed)),
+               stats.connected ? "connected" : "none");
+    out.printf("[Web] pages=%lu clients=%lu schemas=%lu\n",
+               static_cast<unsigned long>(stats.pages),
+               static_cast<unsigned long>(stats.clients),
+               static_cast<unsigned long>(stats.schemas));
+    out.printf("[Web] frames=%lu (%lu/s) screens=%lu packets=%lu coalesced=%lu stalls=%lu bytes=%lu\n",
+               static_cast<unsigned long>(stats.batches),
+               static_cast<unsigned long>(stats.pushHz),
+               static_cast<unsigned long>(stats.screens),
+               static_cast<unsigned long>(stats.packets),
+               static_cast<unsigned long>(stats.coalesced),
+               static_cast<unsigned long>(stats.creditStalls),
+               static_cast<unsigned long>(stats.bytes));
+}
@@ -0,0 +1,229 @@
+/**
+ * @file WidgetTree.cpp
+ * @brief Retained-mode widget implementation
+ */
+
+#include "WidgetTree.h"
+#include <cmath>
+#include <cstring>
+
+// ============================================================================
+// WidgetScreen
+// ============================================================================
+
+bool WidgetScreen::add(Widget& widget) {
+    if (count_ >= kMaxWidgets) {
+        return false;
+    }
+    widgets_[count_++] = &widget;
+    widget.invalidate();
+    return true;
+}
+
+void WidgetScreen::invalidateAll() {
+    for (size_t i = 0; i < count_; ++i) {
+        widgets_[i]->invalidate();
+    }
+}
+
+size_t WidgetScreen::render(DisplayCanvas& canvas, bool full) {
+    size_t drawn = 0;
+
+    for (size_t i = 0; i < count_; ++i) {
+        Widget& widget = *widgets_[i];
+        // Always poll so the cached value tracks the source
+        bool changed = widget.refresh();
+        if (!full && !changed && !widget.dirty_) {
+            continue;
+        }
+
+        if (!full) {
+            canvas.setDrawColor(0);
+            canvas.drawRect(widget.x_, widget.y_, widget.w_, widget.h_, true);
+        }
+        canvas.setDrawColor(1);
+        widget.draw(canvas);
+        widget.dirty_ = false;
+        drawn++;
+    }
+
+    return drawn;
+}
+
+// ============================================================================
+// TextWidget
+// ============================================================================
+
+TextWidget::TextWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+                       DisplayCanvas::Font font, Source source, bool centered)
+    : Widget(x, y, w, h),
+      font_(font),
+      source_(source),
+      centered_(centered)
+{
+    text_[0] = '\0';
+}
+
+bool TextWidget::refresh() {
+    const char* text = source_ ? source_() : nullptr;
+    if (text == nullptr) {
+        text = "";
+    }
+    if (strncmp(text, text_, kMaxText - 1) == 0) {
+        return false;
+    }
+    strncpy(text_, text, kMaxText - 1);
+    text_[kMaxText - 1] = '\0';
+    return true;
+}
+
+void TextWidget::draw(DisplayCanvas& canvas) {
+    canvas.setFont(font_);
+    int16_t x = x_;
+    if (centered_) {
+        x = x_ + (w_ - canvas.getTextWidth(text_)) / 2;
+    }
+    // Baseline two rows above the bottom leaves room for descenders
+    canvas.drawText(x, y_ + h_ - 2, text_);
+}
+
+// ============================================================================
+// BatteryWidget / SignalWidget
+// ============================================================================
+
+BatteryWidget::BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h, Source source)
+    : Widget(x - w, y, w, h),
+      source_(source),
+      percent_(0)
+{
+}
+
+bool BatteryWidget::refresh() {
+    uint8_t percent = source_ ? source_() : 0;
+    if (percent == percent_) {
+        return false;
+    }
+    percent_ = percent;
+    return true;
+}
+
+void BatteryWidget::draw(DisplayCanvas& canvas) {
+    UIComponents::drawBatteryIndicator(canvas, x_ + w_, y_, percent_);
+}
+
+SignalWidget::SignalWidget(int16_t x, int16_t y, int16_t w, int16_t h, Source source)
+    : Widget(x - w, y, w, h),
+      source_(source),
+      strength_(0)
+{
+}
+
+bool SignalWidget::refresh() {
+    uint8_t strength = source_ ? source_() : 0;
+    if (strength == strength_) {
+        return false;
+    }
+    strength_ = strength;
+    return true;
+}
+
+void SignalWidget::draw(DisplayCanvas& canvas) {
+    UIComponents::drawSignalIndicator(canvas, x_ + w_, y_, strength_);
+}
+
+// ============================================================================
+// LabeledValueWidget
+// ============================================================================
+
+LabeledValueWidget::LabeledValueWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+                                       IconID icon, const char* label, Formatter formatter)
+    : Widget(x, y, w, h),
+      icon_(icon),
+      label_(label),
+      formatter_(formatter)
+{
+    value_[0] = '\0';
+}
+
+bool LabeledValueWidget::refresh() {
+    char value[kMaxValue] = "";
+    if (formatter_) {
+        formatter_(value, sizeof(value));
+        value[kMaxValue - 1] = '\0';
+    }
+    if (strcmp(value, value_) == 0) {
+        return false;
+    }
+    memcpy(value_, value, sizeof(value_));
+    return true;
+}
+
+void LabeledValueWidget::draw(DisplayCanvas& canvas) {
+    UIComponents::drawLabeledValue(canvas, x_, y_, icon_, label_, value_);
+}
+
+// ============================================================================
+// GaugeWidget
+// ============================================================================
+
+GaugeWidget::GaugeWidget(int16_t cx, int16_t cy, int16_t radius,
+                         float min, float max, IconID icon, const char* label,
+                         Source source, float resolution)
+    : Widget(cx - radius, cy - radius - 10, radius * 2 + 1, radius * 2 + 19),
+      cx_(cx),
+      cy_(cy),
+      radius_(radius),
+      min_(min),
+      max_(max),
+      icon_(icon),
+      label_(label),
+      source_(source),
+      resolution_(resolution > 0.0f ? resolution : (max - min) / 100.0f),
+      step_(INT32_MIN),
+      value_(min)
+{
+    if (resolution_ <= 0.0f) {
+        resolution_ = 1.0f;
+    }
+}
+
+bool GaugeWidget::refresh() {
+    float value = source_ ? source_() : min_;
+    int32_t step = static_cast<int32_t>(lroundf(value / resolution_));
+    if (step == step_) {
+        return false;
+    }
+    step_ = step;
+    value_ = value;
+    return true;
+}
+
+void GaugeWidget::draw(DisplayCanvas& canvas) {
+    UIComponents::drawMiniGauge(canvas, cx_, cy_, radius_, value_, min_, max_, icon_, label_);
+}
+
+// ============================================================================
+// CardWidget
+// ============================================================================
+
+CardWidget::CardWidget(int16_t x, int16_t y, int16_t w, int16_t h,
+                       const UIComponents::ModuleCard& card, FocusSource focused)
+    : Widget(x, y, w, h),
+      card_(card),
+      focusedSource_(focused),
+      focused_(false)
+{
+}
+
+bool CardWidget::refresh() {
+    bool focused = focusedSource_ ? focusedSource_() : false;
+    if (focused == focused_) {
+        return false;
+    }
+    focused_ = focused;
+    return true;
+}
+
+void CardWidget::draw(DisplayCanvas& canvas) {
+    UIComponents::drawModuleCard(canvas, card_, x_, y_, w_, h_, focused_);
+}
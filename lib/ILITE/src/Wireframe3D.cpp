@@ -0,0 +1,230 @@
+/**
+ * @file Wireframe3D.cpp
+ * @brief Q15 rotations, projection and Cohen-Sutherland clipping
+ */
+
+#include "Wireframe3D.h"
+#include "DisplayCanvas.h"
+#include <math.h>
+
+namespace {
+
+enum Outcode : uint8_t {
+    kInside = 0,
+    kLeft = 1,
+    kRight = 2,
+    kTop = 4,
+    kBottom = 8
+};
+
+int32_t toQ15(float value) {
+    return static_cast<int32_t>(lroundf(value * 32768.0f));
+}
+
+uint8_t outcode(int32_t x, int32_t y, const WireViewport& view) {
+    uint8_t code = kInside;
+    if (x < view.x0) {
+        code |= kLeft;
+    } else if (x > view.x1) {
+        code |= kRight;
+    }
+    if (y < view.y0) {
+        code |= kTop;
+    } else if (y > view.y1) {
+        code |= kBottom;
+    }
+    return code;
+}
+
+}  // namespace
+
+// ============================================================================
+// Rotation
+// ============================================================================
+
+WireRotation WireRotation::identity() {
+    WireRotation r{};
+    r.m[0][0] = r.m[1][1] = r.m[2][2] = 1L << kShift;
+    return r;
+}
+
+WireRotation WireRotation::fromEuler(float roll, float pitch, float yaw) {
+    const float cr = cosf(roll);
+    const float sr = sinf(roll);
+    const float cp = cosf(pitch);
+    const float sp = sinf(pitch);
+    const float cy = cosf(yaw);
+    const float sy = sinf(yaw);
+
+    // Rz(yaw) * Ry(pitch) * Rx(roll)
+    const float rows[3][3] = {
+        {cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+        {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+        {-sp,     cp * sr,                cp * cr}
+    };
+    WireRotation r;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r.m[i][j] = toQ15(rows[i][j]);
+        }
+    }
+    return r;
+}
+
+WireRotation WireRotation::fromQuaternion(float w, float x, float y, float z) {
+    const float rows[3][3] = {
+        {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z),        2.0f * (x * z + w * y)},
+        {2.0f * (x * y + w * z),        1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - w * x)},
+        {2.0f * (x * z - w * y),        2.0f * (y * z + w * x),        1.0f - 2.0f * (x * x + y * y)}
+    };
+    WireRotation r;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r.m[i][j] = toQ15(rows[i][j]);
+        }
+    }
+    return r;
+}
+
+void WireRotation::apply(const WireVertex& in, int32_t out[3]) const {
+    // Rows are unit vectors, so each sum stays within |v| * 2^15
+    const int32_t round = 1L << (kShift - 1);
+    for (int i = 0; i < 3; ++i) {
+        const int32_t sum = m[i][0] * in.x + m[i][1] * in.y + m[i][2] * in.z;
+        out[i] = (sum + round) >> kShift;
+    }
+}
+
+// ============================================================================
+// Meshes
+// ============================================================================
+
+const WireEdge Wireframe3D::kBoxEdges[12] = {
+    {0, 1}, {1, 2}, {2, 3}, {3, 0},     // Back face
+    {4, 5}, {5, 6}, {6, 7}, {7, 4},     // Front face
+    {0, 4}, {1, 5}, {2, 6}, {3, 7}      // Connecting edges
+};
+
+// ============================================================================
+// Projection
+// ============================================================================
+
+WireViewport Wireframe3D::viewport(const DisplayCanvas& canvas) {
+    return {0, 0, static_cast<int16_t>(canvas.getWidth() - 1), static_cast<int16_t>(canvas.getHeight() - 1)};
+}
+
+void Wireframe3D::project(const WireVertex* vertices, size_t count, const WireRotation& rotation,
+                          int16_t centerX, int16_t centerY, WirePoint* out, int32_t scaleQ8) {
+    for (size_t i = 0; i < count; ++i) {
+        int32_t v[3];
+        rotation.apply(vertices[i], v);
+        out[i].x = static_cast<int16_t>(centerX + ((v[0] * scaleQ8 + 128) >> 8));
+        out[i].y = static_cast<int16_t>(centerY - ((v[1] * scaleQ8 + 128) >> 8));
+    }
+}
+
+// ============================================================================
+// Clipping
+// ============================================================================
+
+bool Wireframe3D::clipLine(int16_t& x0, int16_t& y0, int16_t& x1, int16_t& y1, const WireViewport& view) {
+    int32_t ax = x0;
+    int32_t ay = y0;
+    int32_t bx = x1;
+    int32_t by = y1;
+    uint8_t codeA = outcode(ax, ay, view);
+    uint8_t codeB = outcode(bx, by, view);
+
+    while (true) {
+        if ((codeA | codeB) == 0) {
+            break;
+        }
+        if ((codeA & codeB) != 0) {
+            return false;
+        }
+
+        // Move the outside endpoint onto the edge it crosses
+        const uint8_t code = codeA != 0 ? codeA : codeB;
+        const int64_t dx = bx - ax;
+        const int64_t dy = by - ay;
+        int32_t x;
+        int32_t y;
+        if (code & kTop) {
+            y = view.y0;
+            x = ax + static_cast<int32_t>(dx * (y - ay) / dy);
+        } else if (code & kBottom) {
+            y = view.y1;
+            x = ax + static_cast<int32_t>(dx * (y - ay) / dy);
+        } else if (code & kLeft) {
+            x = view.x0;
+            y = ay + static_cast<int32_t>(dy * (x - ax) / dx);
+        } else {
+            x = view.x1;
+            y = ay + static_cast<int32_t>(dy * (x - ax) / dx);
+        }
+
+        if (code == codeA) {
+            ax = x;
+            ay = y;
+            codeA = outcode(ax, ay, view);
+        } else {
+            bx = x;
+            by = y;
+            codeB = outcode(bx, by, view);
+        }
+    }
+
+    x0 = static_cast<int16_t>(ax);
+    y0 = static_cast<int16_t>(ay);
+    x1 = static_cast<int16_t>(bx);
+    y1 = static_cast<int16_t>(by);
+    return true;
+}
+
+// ============================================================================
+// Drawing
+// ============================================================================
+
+void Wireframe3D::drawLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (clipLine(x0, y0, x1, y1, viewport(canvas))) {
+        canvas.drawLine(x0, y0, x1, y1);
+    }
+}
+
+void Wireframe3D::drawPatternLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                  uint8_t pattern, uint8_t length) {
+    if (clipLine(x0, y0, x1, y1, viewport(canvas))) {
+        canvas.drawPatternLine(x0, y0, x1, y1, pattern, length);
+    }
+}
+
+void Wireframe3D::drawEdges(DisplayCanvas& canvas, const WirePoint* points,
+                            const WireEdge* edges, size_t edgeCount) {
+    const WireViewport view = viewport(canvas);
+    for (size_t i = 0; i < edgeCount; ++i) {
+        WirePoint a = points[edges[i].a];
+        WirePoint b = points[edges[i].b];
+        if (clipLine(a.x, a.y, b.x, b.y, view)) {
+            canvas.drawLine(a.x, a.y, b.x, b.y);
+        }
+    }
+}
+
+void Wireframe3D::drawMesh(DisplayCanvas& canvas, const WireMesh& mesh, const WireRotation& rotation,
+                           int16_t centerX, int16_t centerY, int32_t scaleQ8) {
+    WirePoint points[kMaxVertices];
+    const size_t count = mesh.vertexCount < kMaxVertices ? mesh.vertexCount : kMaxVertices;
+    project(mesh.vertices, count, rotation, centerX, centerY, points, scaleQ8);
+    const WireViewport view = viewport(canvas);
+    for (size_t i = 0; i < mesh.edgeCount; ++i) {
+        const WireEdge& edge = mesh.edges[i];
+        if (edge.a >= count || edge.b >= count) {
+            continue;
+        }
+        WirePoint a = points[edge.a];
+        WirePoint b = points[edge.b];
+        if (clipLine(a.x, a.y, b.x, b.y, view)) {
+            canvas.drawLine(a.x, a.y, b.x, b.y);
+        }
+    }
+}
@@ -1,23 +1,38 @@
 #include "audio_feedback.h"
+#include "AudioSynth.h"
+#include "MpscQueue.h"
 #include <DacESP32.h>
+#include <esp_timer.h>
+#include <atomic>
 
 namespace {
 constexpr gpio_num_t kBuzzerPin = GPIO_NUM_26;
-struct Tone {
-  uint16_t frequency;
-  uint16_t durationMs;
+constexpr uint32_t kTickPeriodUs = 1000;
+constexpr uint32_t kQueueSize = 8;
+
+// A request either points at a static note table or carries one inline tone
+struct Request {
+  const AudioNote* notes;
+  uint16_t count;
+  AudioNote tone;
 };
 
-struct QueuedTone {
-  Tone tone;
-  uint32_t endMs;
+struct Player {
+  Request request;
+  uint16_t index;
+  int64_t noteEndUs;
   bool active;
 };
 
 DacESP32 buzzer(kBuzzerPin);
-QueuedTone currentTone{{0,0},0,false};
+MpscQueue<Request, kQueueSize> queue;
+Player player{{nullptr, 0, {0, 0}}, 0, 0, false};
+std::atomic<bool> playing{false};
+esp_timer_handle_t tickTimer = nullptr;
+
+constexpr AudioNote kStartupMelody[] = {{320, 120}, {480, 120}, {640, 160}, {0, 60}};
 
-Tone cueToTone(AudioCue cue){
+AudioNote cueToTone(AudioCue cue){
   switch(cue){
     case AudioCue::Scroll:        return {520, 80};
     case AudioCue::Select:        return {720, 140};
@@ -32,50 +47,146 @@ Tone cueToTone(AudioCue cue){
   }
 }
 
-void startTone(const Tone& tone){
-  buzzer.enable();
-  buzzer.outputCW(tone.frequency);
-  currentTone = {tone, millis() + tone.durationMs, true};
+const AudioNote& noteAt(const Player& p, uint16_t index){
+  return p.request.notes ? p.request.notes[index] : p.request.tone;
+}
+
+void outputNote(const AudioNote& note){
+  if(note.frequencyHz == 0){
+    buzzer.outputCW(0);
+    buzzer.disable();
+  }else{
+    buzzer.enable();
+    buzzer.outputCW(note.frequencyHz);
+  }
 }
 
-void stopTone(){
+void stopPlayer(){
   buzzer.outputCW(0);
   buzzer.disable();
-  currentTone = {{0,0},0,false};
+  player.active = false;
+  playing.store(false, std::memory_order_relaxed);
+}
+
+// Starts the next note with a non-zero duration at startUs, or stops
+void startNote(int64_t startUs){
+  while(player.index < player.request.count){
+    const AudioNote& note = noteAt(player, player.index);
+    if(note.durationMs != 0){
+      outputNote(note);
+      player.noteEndUs = startUs + static_cast<int64_t>(note.durationMs) * 1000;
+      return;
+    }
+    player.index++;
+  }
+  stopPlayer();
+}
+
+// Sequencer step; runs on the esp_timer task (or audioUpdate() as fallback)
+void tick(){
+  const int64_t now = esp_timer_get_time();
+
+  // Newest request wins, like the old startTone()
+  Request request;
+  bool received = false;
+  while(queue.pop(request)){
+    received = true;
+  }
+  if(received){
+    player.request = request;
+    player.index = 0;
+    player.active = true;
+    playing.store(true, std::memory_order_relaxed);
+    startNote(now);
+    return;
+  }
+
+  if(!player.active || now < player.noteEndUs){
+    return;
+  }
+  player.index++;
+  // Chain from the scheduled end so notes don't drift; resync if we fell behind
+  startNote(now - player.noteEndUs < kTickPeriodUs ? player.noteEndUs : now);
+}
+
+void tickCallback(void*){
+  tick();
+}
+
+void play(const Request& request){
+  if(request.count == 0){
+    return;
+  }
+  AudioSynth& synth = AudioSynth::getInstance();
+  if(synth.isRunning()){
+    if(request.notes){
+      synth.play(request.notes, request.count);
+    }else{
+      synth.playTone(request.tone.frequencyHz, request.tone.durationMs);
+    }
+    return;
+  }
+  queue.push(request);
 }
 
 } // namespace
 
 void audioSetup(){
+  // Mixed, enveloped voices; the cosine generator below is the fallback
+  if(AudioSynth::getInstance().begin()){
+    return;
+  }
+
   buzzer.enable();
   buzzer.outputCW(0);
   buzzer.disable();
+
+  if(tickTimer != nullptr){
+    return;
+  }
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = &tickCallback;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "audio_seq";
+  if(esp_timer_create(&timerArgs, &tickTimer) != ESP_OK){
+    tickTimer = nullptr;
+    return;
+  }
+  if(esp_timer_start_periodic(tickTimer, kTickPeriodUs) != ESP_OK){
+    esp_timer_delete(tickTimer);
+    tickTimer = nullptr;
+  }
 }
 
 void audioPlayStartup(){
-  const Tone startup[] = {{320,120}, {480,120}, {640,160}, {0,60}};
-  for(const Tone& tone : startup){
-    if(tone.frequency == 0){
-      stopTone();
-      delay(tone.durationMs);
-    }else{
-      startTone(tone);
-      delay(tone.durationMs);
-    }
-  }
-  stopTone();
+  audioPlaySequence(kStartupMelody, sizeof(kStartupMelody) / sizeof(kStartupMelody[0]));
 }
 
 void audioFeedback(AudioCue cue){
-  startTone(cueToTone(cue));
+  play({nullptr, 1, cueToTone(cue)});
 }
 
 void audioUpdate(){
-  if(currentTone.active && millis() >= currentTone.endMs){
-    stopTone();
+  // The timer owns the sequencer; without it the main loop drives it instead
+  if(tickTimer == nullptr && !AudioSynth::getInstance().isRunning()){
+    tick();
   }
 }
 
 void audioPlayTone(uint16_t frequencyHz, uint16_t durationMs){
-  startTone({frequencyHz, durationMs});
+  play({nullptr, 1, {frequencyHz, durationMs}});
+}
+
+void audioPlaySequence(const AudioNote* notes, size_t count){
+  if(notes == nullptr){
+    return;
+  }
+  play({notes, static_cast<uint16_t>(count > UINT16_MAX ? UINT16_MAX : count), {0, 0}});
+}
+
+bool audioIsPlaying(){
+  if(AudioSynth::getInstance().isRunning()){
+    return AudioSynth::getInstance().isPlaying();
+  }
+  return playing.load(std::memory_order_relaxed) || !queue.empty();
 }
@@ -7,11 +7,13 @@
 #include "ILITEModule.h"
 #include "ModuleRegistry.h"
 #include "InputManager.h"
+#include "ControlShaping.h"
 #include "DisplayCanvas.h"
 #include "input.h"
 #include "display.h"
 #include "audio_feedback.h"
 #include "telemetry.h"
+#include "LogChannels.h"
 #include <cstring>
 
 // ============================================================================
@@ -21,7 +23,6 @@
 // Note: bulkyCommand is already declared in telemetry.cpp
 // BulkyCommand bulkyCommand{0, 0, 0, {0, 0, 0}};
 
-BulkyTelemetry bulkyTelemetry{};
 BulkyControlState bulkyState{};
 
 // ============================================================================
@@ -29,7 +30,7 @@ BulkyControlState bulkyState{};
 // ============================================================================
 
 extern byte displayMode;
-extern U8G2_SH1106_128X64_NONAME_F_HW_I2C oled;
+extern OledDisplay oled;
 
 // These variables are used by Bulky display functions
 extern byte Front_Distance;
@@ -44,13 +45,14 @@ extern byte firePose;
 
 void initBulkyState() {
     memset(&bulkyCommand, 0, sizeof(bulkyCommand));
-    memset(&bulkyTelemetry, 0, sizeof(bulkyTelemetry));
 
     bulkyState.targetSpeed = 0;
     bulkyState.motionState = 0;
     bulkyState.honkActive = false;
     bulkyState.lightActive = false;
     bulkyState.slowModeActive = false;
+    bulkyState.buttons = 0;
+    bulkyState.commandVersion = BULKY_COMMAND_V1;
     bulkyState.lastTelemetryTime = 0;
     bulkyState.connectionActive = false;
 }
@@ -60,47 +62,36 @@ void initBulkyState() {
 // ============================================================================
 
 void updateBulkyControl() {
-    // Read joystick for motion control
-    int16_t joyX = analogRead(joystickB_X);
-    int16_t joyY = analogRead(joystickB_Y);
+    const InputManager& inputs = InputManager::getInstance();
 
-    // Map joystick Y to speed (-100 to 100)
-    int16_t mappedY = map(joyY, 0, 4095, -100, 100);
-
-    // Apply deadzone
-    if (abs(mappedY) < 10) {
-        mappedY = 0;
-    }
-
-    bulkyState.targetSpeed = static_cast<int8_t>(mappedY);
-
-    // Map joystick X to motion state (for turning/steering)
-    int16_t mappedX = map(joyX, 0, 4095, -100, 100);
+    // Joystick B: Y drives speed (-100 to 100), X steers
+    const float forward = ControlShaping::deadzone(inputs.getJoystickB_Y(), 0.1f);
+    const float turn = ControlShaping::deadzone(inputs.getJoystickB_X(), 0.1f);
+    bulkyState.targetSpeed = static_cast<int8_t>(forward * 100.0f);
 
     // Simple motion state encoding:
     // 0 = stop, 1 = forward, 2 = backward, 3 = turn left, 4 = turn right
-    if (abs(mappedY) < 10 && abs(mappedX) < 10) {
+    if (forward == 0.0f && turn == 0.0f) {
         bulkyState.motionState = 0; // Stop
-    } else if (abs(mappedX) > abs(mappedY)) {
+    } else if (fabsf(turn) > fabsf(forward)) {
         // Turning dominates
-        bulkyState.motionState = (mappedX > 0) ? 4 : 3; // Turn right : Turn left
+        bulkyState.motionState = (turn > 0.0f) ? 4 : 3; // Turn right : Turn left
     } else {
         // Forward/backward dominates
-        bulkyState.motionState = (mappedY > 0) ? 1 : 2; // Forward : Backward
+        bulkyState.motionState = (forward > 0.0f) ? 1 : 2; // Forward : Backward
     }
 
-    // Read speed potentiometer for speed scaling
-    uint16_t potValue = analogRead(potA);
-    uint8_t speedScale = map(potValue, 0, 4095, 0, 100);
+    // Speed potentiometer scales the command
+    const uint8_t speedScale = static_cast<uint8_t>(inputs.getPotentiometer() * 100.0f);
 
     // Apply speed scaling
     bulkyCommand.speed = (bulkyState.targetSpeed * speedScale) / 100;
     bulkyCommand.motionState = bulkyState.motionState;
 
-    // Read button states
-    bulkyCommand.buttonStates[0] = digitalRead(button1) ? 1 : 0;
-    bulkyCommand.buttonStates[1] = digitalRead(button2) ? 1 : 0;
-    bulkyCommand.buttonStates[2] = digitalRead(button3) ? 1 : 0;
+    // Button states, expanded to bytes only for v1 robots
+    bulkyState.buttons = (inputs.getButton1() ? BulkyButton::Button1 : 0) |
+                         (inputs.getButton2() ? BulkyButton::Button2 : 0) |
+                         (inputs.getButton3() ? BulkyButton::Button3 : 0);
 
     // Increment reply index
     bulkyCommand.replyIndex++;
@@ -112,25 +103,37 @@ void updateBulkyControl() {
 
 void handleBulkyTelemetry(const uint8_t* data, size_t length) {
     if (length < sizeof(BulkyTelemetry)) {
-        Serial.printf("[Bulky] Telemetry too short: %d bytes\n", length);
+        ILITE_LOG_RATE(MODULE, LOG_WARN, 1, 3, "Bulky: telemetry too short: %u bytes",
+                       static_cast<unsigned>(length));
         return;
     }
 
-    memcpy(&bulkyTelemetry, data, sizeof(BulkyTelemetry));
+    // The dashboard reads the packet from the TelemetryStore slot; this copy
+    // only negotiates the command layout
+    BulkyTelemetry telemetry;
+    memcpy(&telemetry, data, sizeof(BulkyTelemetry));
 
     // Verify magic number
-    if (bulkyTelemetry.magic != BULKY_PACKET_MAGIC) {
-        Serial.printf("[Bulky] Invalid magic: 0x%08X (expected 0x%08X)\n",
-                      bulkyTelemetry.magic, BULKY_PACKET_MAGIC);
+    if (telemetry.magic != BULKY_PACKET_MAGIC) {
+        ILITE_LOG_RATE(MODULE, LOG_WARN, 1, 3, "Bulky: invalid magic 0x%08lX",
+                       static_cast<unsigned long>(telemetry.magic));
         return;
     }
 
-    // Update display variables (used by drawBulkyDashboard)
-    Front_Distance = bulkyTelemetry.frontDistance;
-    Bottom_Distance = bulkyTelemetry.bottomDistance;
-    linePosition = bulkyTelemetry.linePosition;
-    firePose = bulkyTelemetry.firePose;
-    speed = bulkyTelemetry.currentSpeed;
+    // Older robots send 0 here and keep the v1 layout
+    const uint8_t version = telemetry.commandVersion >= BULKY_COMMAND_V2
+                                ? BULKY_COMMAND_V2 : BULKY_COMMAND_V1;
+    if (version != bulkyState.commandVersion) {
+        bulkyState.commandVersion = version;
+        ILITE_LOG(MODULE, LOG_INFO, "Bulky: command layout v%u", static_cast<unsigned>(version));
+    }
+
+    // One-byte mirrors for the legacy drawBulkyDashboard() in display.cpp
+    Front_Distance = telemetry.frontDistance;
+    Bottom_Distance = telemetry.bottomDistance;
+    linePosition = telemetry.linePosition;
+    firePose = telemetry.firePose;
+    speed = telemetry.currentSpeed;
 
     bulkyState.lastTelemetryTime = millis();
     bulkyState.connectionActive = true;
@@ -140,9 +143,35 @@ void handleBulkyTelemetry(const uint8_t* data, size_t length) {
 // Payload Preparation
 // ============================================================================
 
+size_t packBulkyCommand(uint8_t* buffer, size_t bufferSize) {
+    if (bulkyState.commandVersion >= BULKY_COMMAND_V2) {
+        if (bufferSize < sizeof(BulkyCommandV2)) {
+            return 0;
+        }
+        BulkyCommandV2 packet;
+        packet.version = BULKY_COMMAND_V2;
+        packet.replyIndex = bulkyCommand.replyIndex;
+        packet.speed = bulkyCommand.speed;
+        packet.state = (bulkyCommand.motionState & BULKY_MOTION_MASK) |
+                       static_cast<uint8_t>((bulkyState.buttons & BulkyButton::All) << BULKY_BUTTON_SHIFT);
+        memcpy(buffer, &packet, sizeof(packet));
+        return sizeof(packet);
+    }
+
+    if (bufferSize < sizeof(BulkyCommand)) {
+        return 0;
+    }
+    bulkyCommand.buttonStates[0] = (bulkyState.buttons & BulkyButton::Button1) ? 1 : 0;
+    bulkyCommand.buttonStates[1] = (bulkyState.buttons & BulkyButton::Button2) ? 1 : 0;
+    bulkyCommand.buttonStates[2] = (bulkyState.buttons & BulkyButton::Button3) ? 1 : 0;
+    memcpy(buffer, &bulkyCommand, sizeof(BulkyCommand));
+    return sizeof(BulkyCommand);
+}
+
 const uint8_t* getBulkyPayload(size_t& size) {
-    size = sizeof(BulkyCommand);
-    return reinterpret_cast<const uint8_t*>(&bulkyCommand);
+    static uint8_t payload[sizeof(BulkyCommand)];
+    size = packBulkyCommand(payload, sizeof(payload));
+    return payload;
 }
 
 // ============================================================================
@@ -1,96 +1,529 @@
 #include "connection_log.h"
 
-#include <stdarg.h>
+#include <soc/soc.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 
+using connection_log_detail::Arg;
+using connection_log_detail::ArgType;
+using connection_log_detail::Record;
+using connection_log_detail::RecordWriter;
+
 namespace {
-constexpr size_t kMaxEntries = 32;
-constexpr size_t kEntryLength = 48;
+constexpr size_t kMaxEntries = 64;   // Power of 2
+constexpr size_t kEntryLength = 96;  // Formatted text, wrapped below
+constexpr size_t kMaxLinesPerEntry = 12;
 
-char logEntries[kMaxEntries][kEntryLength] = {};
-size_t logCount = 0;
-size_t nextIndex = 0;
-bool loggingEnabled = false;
+static_assert((kMaxEntries & (kMaxEntries - 1)) == 0, "kMaxEntries must be a power of 2");
 
-size_t oldestIndex() {
-  if (logCount == 0) {
-    return 0;
+// Record n (counting from boot) lives in records[n % kMaxEntries]. Writers
+// claim n with fetch_add and mark the record odd while filling it; readers
+// copy a record and discard the copy if its sequence changed meanwhile.
+Record records[kMaxEntries];
+std::atomic<uint32_t> nextRecord{0};
+std::atomic<uint32_t> firstRecord{0};  // Advanced by connectionLogClear()
+std::atomic<bool> loggingEnabled{false};
+
+// Reader-side cache of formatted text, keyed by record sequence
+char entryText[kMaxEntries][kEntryLength] = {};
+uint32_t entryTextSequence[kMaxEntries] = {};
+
+// Reader-side wrap index. Each record is wrapped once, the first time the
+// index reaches it, and numbered with the count of lines of all records
+// before it since boot. Line numbers are therefore sorted across the ring
+// and a line is found by binary search over the stored records.
+struct WrapInfo {
+  uint32_t firstLine;
+  uint8_t lineCount;
+  uint8_t start[kMaxLinesPerEntry];
+  uint8_t length[kMaxLinesPerEntry];
+};
+WrapInfo wrapInfo[kMaxEntries];
+uint32_t wrappedRecords = 0;   // Next record to wrap
+uint32_t wrappedLines = 0;     // Its firstLine
+
+inline uint32_t completeSequence(uint32_t n) {
+  return 2 * n + 2;
+}
+
+bool isFlashString(const char* text) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(text);
+  return address >= SOC_DROM_LOW && address < SOC_DROM_HIGH;
+}
+
+bool copyRecord(uint32_t n, Record& out) {
+  Record& record = records[n & (kMaxEntries - 1)];
+  const uint32_t expected = completeSequence(n);
+  if (record.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
   }
-  if (logCount < kMaxEntries) {
-    return 0;
+  out.timeMs = record.timeMs;
+  out.fmt = record.fmt;
+  out.argCount = record.argCount;
+  out.stringBytes = record.stringBytes;
+  memcpy(out.types, record.types, sizeof(out.types));
+  memcpy(out.args, record.args, sizeof(out.args));
+  memcpy(out.strings, record.strings, sizeof(out.strings));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return record.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+// printf-style formatting of a captured record. Each conversion is handed to
+// snprintf on its own with the argument's recorded type, so a mismatched
+// format prints "?" instead of reading the wrong type.
+size_t formatRecord(const Record& record, char* out, size_t size) {
+  size_t pos = 0;
+  uint8_t argIndex = 0;
+  const char* f = record.fmt ? record.fmt : record.strings;
+
+  auto append = [&](int written) {
+    if (written > 0) {
+      pos += static_cast<size_t>(written);
+      if (pos >= size) {
+        pos = size - 1;
+      }
+    }
+  };
+
+  while (*f != '\0' && pos + 1 < size) {
+    if (*f != '%') {
+      out[pos++] = *f++;
+      continue;
+    }
+    if (f[1] == '%') {
+      out[pos++] = '%';
+      f += 2;
+      continue;
+    }
+
+    char spec[24];
+    size_t n = 0;
+    spec[n++] = *f++;
+    while (*f != '\0' && strchr("-+ #0", *f) != nullptr) {
+      if (n < 8) {
+        spec[n++] = *f;
+      }
+      f++;
+    }
+    // Width and precision; '*' takes the value from the next argument
+    for (int part = 0; part < 2; ++part) {
+      if (part == 1) {
+        if (*f != '.') {
+          break;
+        }
+        spec[n++] = *f++;
+      }
+      if (*f == '*') {
+        f++;
+        long long value = 0;
+        if (argIndex < record.argCount) {
+          value = record.args[argIndex].i;
+          argIndex++;
+        }
+        n += snprintf(spec + n, sizeof(spec) - n - 4, "%d", static_cast<int>(value));
+      } else {
+        while (*f >= '0' && *f <= '9') {
+          if (n < sizeof(spec) - 6) {
+            spec[n++] = *f;
+          }
+          f++;
+        }
+      }
+    }
+    while (*f != '\0' && strchr("hlLqjzt", *f) != nullptr) {
+      f++;
+    }
+    const char conversion = *f;
+    if (conversion == '\0') {
+      break;
+    }
+    f++;
+
+    const bool haveArg = argIndex < record.argCount;
+    const ArgType type = haveArg ? static_cast<ArgType>(record.types[argIndex]) : connection_log_detail::ARG_SIGNED;
+    const Arg arg = haveArg ? record.args[argIndex] : Arg{};
+    argIndex++;
+    if (!haveArg) {
+      append(snprintf(out + pos, size - pos, "?"));
+      continue;
+    }
+
+    const bool isInteger = type == connection_log_detail::ARG_SIGNED || type == connection_log_detail::ARG_UNSIGNED;
+    switch (conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X': {
+        if (!isInteger) {
+          append(snprintf(out + pos, size - pos, "?"));
+          break;
+        }
+        spec[n++] = 'l';
+        spec[n++] = 'l';
+        spec[n++] = conversion;
+        spec[n] = '\0';
+        append(snprintf(out + pos, size - pos, spec, arg.u));
+        break;
+      }
+      case 'c':
+        spec[n++] = 'c';
+        spec[n] = '\0';
+        append(snprintf(out + pos, size - pos, spec, isInteger ? static_cast<int>(arg.i) : '?'));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A': {
+        double value = arg.d;
+        if (type == connection_log_detail::ARG_SIGNED) {
+          value = static_cast<double>(arg.i);
+        } else if (type == connection_log_detail::ARG_UNSIGNED) {
+          value = static_cast<double>(arg.u);
+        } else if (type != connection_log_detail::ARG_DOUBLE) {
+          append(snprintf(out + pos, size - pos, "?"));
+          break;
+        }
+        spec[n++] = conversion;
+        spec[n] = '\0';
+        append(snprintf(out + pos, size - pos, spec, value));
+        break;
+      }
+      case 's': {
+        const char* text = "?";
+        if (type == connection_log_detail::ARG_STATIC_TEXT) {
+          text = arg.s;
+        } else if (type == connection_log_detail::ARG_TEXT && arg.u < sizeof(record.strings)) {
+          text = record.strings + arg.u;
+        }
+        spec[n++] = 's';
+        spec[n] = '\0';
+        append(snprintf(out + pos, size - pos, spec, text));
+        break;
+      }
+      case 'p':
+        spec[n++] = 'p';
+        spec[n] = '\0';
+        append(snprintf(out + pos, size - pos, spec, arg.p));
+        break;
+      default:
+        append(snprintf(out + pos, size - pos, "?"));
+        break;
+    }
   }
-  return nextIndex;
+
+  out[pos] = '\0';
+  return pos;
 }
 
-void writeEntry(const char* text) {
-  if (!text) {
-    return;
+// Formatted text of record n, cached per slot; nullptr while the record is
+// being written or after it was overwritten
+const char* formattedText(uint32_t n) {
+  const size_t slot = n & (kMaxEntries - 1);
+  const uint32_t sequence = completeSequence(n);
+  if (entryTextSequence[slot] == sequence) {
+    return entryText[slot];
+  }
+  Record copy;
+  if (!copyRecord(n, copy)) {
+    return nullptr;
+  }
+  formatRecord(copy, entryText[slot], kEntryLength);
+  entryTextSequence[slot] = sequence;
+  return entryText[slot];
+}
+
+inline bool isBlank(char c) {
+  return isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// Word wrap at kConnectionLogColumns: break at the last blank that fits,
+// hard-break longer words, drop blanks around breaks
+void wrapText(const char* text, WrapInfo& info) {
+  const size_t total = strlen(text);
+  size_t pos = 0;
+  while (pos < total && isBlank(text[pos])) {
+    ++pos;
+  }
+
+  info.lineCount = 0;
+  while (pos < total && info.lineCount < kMaxLinesPerEntry) {
+    const size_t remaining = total - pos;
+    size_t lineLen = remaining;
+    if (remaining > kConnectionLogColumns) {
+      lineLen = kConnectionLogColumns;
+      if (info.lineCount + 1 < kMaxLinesPerEntry) {
+        // A blank right after the last column still lets the word fit
+        for (size_t i = kConnectionLogColumns; i > 0; --i) {
+          if (isBlank(text[pos + i])) {
+            lineLen = i;
+            break;
+          }
+        }
+      }
+    }
+    size_t copyLen = lineLen;
+    while (copyLen > 0 && isBlank(text[pos + copyLen - 1])) {
+      --copyLen;
+    }
+    info.start[info.lineCount] = static_cast<uint8_t>(pos);
+    info.length[info.lineCount] = static_cast<uint8_t>(copyLen);
+    info.lineCount++;
+
+    pos += lineLen;
+    while (pos < total && isBlank(text[pos])) {
+      ++pos;
+    }
+  }
+  if (info.lineCount == 0) {
+    info.start[0] = 0;
+    info.length[0] = 0;
+    info.lineCount = 1;
   }
-  strncpy(logEntries[nextIndex], text, kEntryLength - 1);
-  logEntries[nextIndex][kEntryLength - 1] = '\0';
-  nextIndex = (nextIndex + 1) % kMaxEntries;
-  if (logCount < kMaxEntries) {
-    ++logCount;
+}
+
+// Wraps records not seen yet and returns the indexed part of the stored
+// window as [first, end). Stops at a record still being written.
+void indexWindow(uint32_t& first, uint32_t& end) {
+  const size_t count = connectionLogGetCount();
+  const uint32_t next = nextRecord.load(std::memory_order_acquire);
+  first = next - count;
+  if (static_cast<int32_t>(wrappedRecords - first) < 0) {
+    wrappedRecords = first;   // Cleared, or the ring lapped the index
+  }
+  while (wrappedRecords != next) {
+    const char* text = formattedText(wrappedRecords);
+    if (text == nullptr) {
+      break;
+    }
+    WrapInfo& info = wrapInfo[wrappedRecords & (kMaxEntries - 1)];
+    info.firstLine = wrappedLines;
+    wrapText(text, info);
+    wrappedLines += info.lineCount;
+    wrappedRecords++;
   }
+  end = wrappedRecords;
 }
 
 }  // namespace
 
-void connectionLogInit() {
-  connectionLogClear();
-}
+// ============================================================================
+// Writing (any task)
+// ============================================================================
 
-void connectionLogAdd(const char* message) {
-  if (!loggingEnabled) {
+RecordWriter::RecordWriter(const char* fmt)
+    : record_(nullptr),
+      sequence_(0) {
+  if (!loggingEnabled.load(std::memory_order_relaxed) || fmt == nullptr) {
     return;
   }
-  if (!message || message[0] == '\0') {
-    return;
+  const uint32_t n = nextRecord.fetch_add(1, std::memory_order_relaxed);
+  record_ = &records[n & (kMaxEntries - 1)];
+  sequence_ = completeSequence(n);
+  record_->sequence.store(sequence_ - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record_->timeMs = millis();
+  record_->fmt = fmt;
+  record_->argCount = 0;
+  record_->stringBytes = 0;
+  if (!isFlashString(fmt)) {
+    // A RAM format may be gone by the time the record is read
+    record_->fmt = nullptr;
+    size_t length = 0;
+    while (length + 1 < connection_log_detail::kStringBytes && fmt[length] != '\0') {
+      record_->strings[length] = fmt[length];
+      length++;
+    }
+    record_->strings[length] = '\0';
+    record_->stringBytes = static_cast<uint8_t>(length + 1);
   }
-  writeEntry(message);
 }
 
-void connectionLogAddf(const char* fmt, ...) {
-  if (!loggingEnabled) {
+RecordWriter::~RecordWriter() {
+  if (record_ != nullptr) {
+    record_->sequence.store(sequence_, std::memory_order_release);
+  }
+}
+
+void RecordWriter::add(const char* value) {
+  if (value == nullptr) {
+    value = "(null)";
+  }
+  if (isFlashString(value)) {
+    if (Arg* arg = next(connection_log_detail::ARG_STATIC_TEXT)) {
+      arg->s = value;
+    }
+    return;
+  }
+  if (record_ == nullptr) {
     return;
   }
-  if (!fmt) {
+  // Copy RAM strings; an exhausted pool leaves an empty string
+  const size_t offset = record_->stringBytes < connection_log_detail::kStringBytes
+                            ? record_->stringBytes
+                            : connection_log_detail::kStringBytes - 1;
+  Arg* arg = next(connection_log_detail::ARG_TEXT);
+  if (arg == nullptr) {
+    return;
+  }
+  arg->u = offset;
+  char* dest = record_->strings + offset;
+  const size_t room = connection_log_detail::kStringBytes - offset;
+  size_t length = 0;
+  while (length + 1 < room && value[length] != '\0') {
+    dest[length] = value[length];
+    length++;
+  }
+  dest[length] = '\0';
+  record_->stringBytes = static_cast<uint8_t>(offset + length + 1);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void connectionLogInit() {
+  connectionLogClear();
+}
+
+void connectionLogAdd(const char* message) {
+  if (!message || message[0] == '\0') {
     return;
   }
-  char buffer[kEntryLength];
-  va_list args;
-  va_start(args, fmt);
-  vsnprintf(buffer, sizeof(buffer), fmt, args);
-  va_end(args);
-  writeEntry(buffer);
+  RecordWriter writer("%s");
+  writer.add(message);
 }
 
 size_t connectionLogGetCount() {
-  return logCount;
+  const uint32_t next = nextRecord.load(std::memory_order_acquire);
+  const uint32_t first = firstRecord.load(std::memory_order_relaxed);
+  const uint32_t stored = next - first;
+  return stored < kMaxEntries ? stored : kMaxEntries;
 }
 
 const char* connectionLogGetEntry(size_t index) {
-  if (index >= logCount) {
+  const size_t count = connectionLogGetCount();
+  if (index >= count) {
     return nullptr;
   }
-  size_t start = oldestIndex();
-  size_t actual = (start + index) % kMaxEntries;
-  return logEntries[actual];
+  const uint32_t n = nextRecord.load(std::memory_order_acquire) - count + index;
+  const char* text = formattedText(n);
+  return text != nullptr ? text : "";  // Still being written, or already overwritten
 }
 
-void connectionLogClear() {
-  for (size_t i = 0; i < kMaxEntries; ++i) {
-    logEntries[i][0] = '\0';
+size_t connectionLogGetLineCount() {
+  uint32_t first = 0;
+  uint32_t end = 0;
+  indexWindow(first, end);
+  if (end == first) {
+    return 0;
   }
-  logCount = 0;
-  nextIndex = 0;
+  const WrapInfo& last = wrapInfo[(end - 1) & (kMaxEntries - 1)];
+  return last.firstLine + last.lineCount - wrapInfo[first & (kMaxEntries - 1)].firstLine;
+}
+
+bool connectionLogGetLine(size_t line, char* buffer, size_t size, bool newestFirst) {
+  if (buffer == nullptr || size == 0) {
+    return false;
+  }
+  buffer[0] = '\0';
+
+  uint32_t first = 0;
+  uint32_t end = 0;
+  indexWindow(first, end);
+  if (end == first) {
+    return false;
+  }
+  const uint32_t base = wrapInfo[first & (kMaxEntries - 1)].firstLine;
+  const WrapInfo& last = wrapInfo[(end - 1) & (kMaxEntries - 1)];
+  const uint32_t limit = last.firstLine + last.lineCount;
+  if (line >= limit - base) {
+    return false;
+  }
+  const uint32_t target = newestFirst ? limit - 1 - line : base + line;
+
+  // Last record starting at or before the target line
+  uint32_t lo = first;
+  uint32_t hi = end - 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo + 1) / 2;
+    if (wrapInfo[mid & (kMaxEntries - 1)].firstLine <= target) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  // Newest first keeps each entry's own lines top to bottom
+  const size_t slot = lo & (kMaxEntries - 1);
+  const WrapInfo& info = wrapInfo[slot];
+  const size_t index = newestFirst ? line - (limit - info.firstLine - info.lineCount)
+                                   : target - info.firstLine;
+  size_t length = info.length[index];
+  if (length >= size) {
+    length = size - 1;
+  }
+  memcpy(buffer, entryText[slot] + info.start[index], length);
+  buffer[length] = '\0';
+  return true;
+}
+
+bool connectionLogReadNext(uint32_t& cursor, uint32_t& timeMs, char* text, size_t size,
+                           uint32_t& lost) {
+  const uint32_t next = nextRecord.load(std::memory_order_acquire);
+  if (next - cursor > kMaxEntries) {
+    lost += next - kMaxEntries - cursor;
+    cursor = next - kMaxEntries;
+  }
+  while (cursor != next) {
+    Record copy;
+    if (copyRecord(cursor, copy)) {
+      formatRecord(copy, text, size);
+      timeMs = copy.timeMs;
+      cursor++;
+      return true;
+    }
+    // A newer sequence means the slot was reused; anything else is a
+    // writer that has claimed the record but not published it yet
+    const uint32_t sequence = records[cursor & (kMaxEntries - 1)].sequence.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(sequence - completeSequence(cursor)) <= 0) {
+      return false;
+    }
+    lost++;
+    cursor++;
+  }
+  return false;
+}
+
+void connectionLogDump(Print& out) {
+  const size_t count = connectionLogGetCount();
+  out.printf("[ConnectionLog] %u entries\n", static_cast<unsigned>(count));
+  const uint32_t first = nextRecord.load(std::memory_order_acquire) - count;
+  char text[kEntryLength];
+  for (size_t i = 0; i < count; ++i) {
+    Record copy;
+    if (!copyRecord(first + i, copy)) {
+      continue;
+    }
+    formatRecord(copy, text, sizeof(text));
+    out.printf("%8lu %s\n", static_cast<unsigned long>(copy.timeMs), text);
+  }
+}
+
+void connectionLogClear() {
+  firstRecord.store(nextRecord.load(std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
 void connectionLogSetRecordingEnabled(bool enabled) {
-  loggingEnabled = enabled;
+  loggingEnabled.store(enabled, std::memory_order_relaxed);
 }
 
 bool connectionLogIsRecordingEnabled() {
-  return loggingEnabled;
+  return loggingEnabled.load(std::memory_order_relaxed);
 }
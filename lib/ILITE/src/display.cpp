@@ -1,13 +1,16 @@
 #include "display.h"
 #include "thegill.h"
+#include "InputManager.h"
 #include "connection_log.h"
 #include "menu_entries.h"
+#include "DisplayCanvas.h"
+#include "Wireframe3D.h"
 #include <ctype.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
 
-U8G2_SH1106_128X64_NONAME_F_HW_I2C oled(U8G2_R0);
+OledDisplay oled(U8G2_R0);
 
 #define iconFont u8g2_font_open_iconic_all_2x_t
 #define networkBatteryIconFont u8g2_font_siji_t_6x10
@@ -55,8 +58,7 @@ namespace {
 constexpr int kLogVisibleLines = 8;
 constexpr int16_t kLogStartY = kStatusBarHeight + 2;
 constexpr int16_t kLogLineHeight = 6;
-constexpr size_t kLogMaxCharsPerLine = 32;
-constexpr size_t kLogLineBufferSize = 80;
+constexpr size_t kLogLineBufferSize = kConnectionLogColumns + 1;
 
 int mapHistoryValue(int16_t value, int16_t minValue, int16_t maxValue, int top, int bottom) {
   if (maxValue == minValue) {
@@ -72,126 +74,10 @@ int mapHistoryValue(int16_t value, int16_t minValue, int16_t maxValue, int top,
   return bottom - static_cast<int>((static_cast<long>(value - minValue) * span) / range);
 }
 
-size_t nextWrappedSegment(const char* text, size_t start, size_t totalLength,
-                          size_t* nextStart) {
-  if (!text || start >= totalLength) {
-    if (nextStart) {
-      *nextStart = totalLength;
-    }
-    return 0;
-  }
-  size_t remaining = totalLength - start;
-  size_t limit = remaining < kLogMaxCharsPerLine ? remaining : kLogMaxCharsPerLine;
-  size_t lineLen = limit;
-  if (remaining > kLogMaxCharsPerLine) {
-    size_t breakPos = start + limit;
-    bool foundSpace = false;
-    for (size_t i = 0; i < kLogMaxCharsPerLine; ++i) {
-      size_t pos = breakPos - 1 - i;
-      if (isspace(static_cast<unsigned char>(text[pos]))) {
-        lineLen = pos - start + 1;
-        foundSpace = true;
-        break;
-      }
-    }
-    if (!foundSpace) {
-      lineLen = limit;
-    }
-  }
-  size_t copyLen = lineLen;
-  while (copyLen > 0 && isspace(static_cast<unsigned char>(text[start + copyLen - 1]))) {
-    --copyLen;
-  }
-  size_t advance = lineLen > 0 ? lineLen : 1;
-  size_t newStart = start + advance;
-  while (newStart < totalLength && isspace(static_cast<unsigned char>(text[newStart]))) {
-    ++newStart;
-  }
-  if (nextStart) {
-    *nextStart = newStart;
-  }
-  return copyLen;
-}
-
-size_t countWrappedLines(const char* text) {
-  if (!text) {
-    return 0;
-  }
-  if (text[0] == '\0') {
-    return 1;
-  }
-  size_t totalLength = strlen(text);
-  size_t start = 0;
-  while (start < totalLength && isspace(static_cast<unsigned char>(text[start]))) {
-    ++start;
-  }
-  size_t count = 0;
-  while (start < totalLength) {
-    size_t nextStart = start;
-    size_t copyLen = nextWrappedSegment(text, start, totalLength, &nextStart);
-    ++count;
-    if (nextStart <= start) {
-      break;
-    }
-    start = nextStart;
-  }
-  return count > 0 ? count : 1;
-}
-
-bool extractWrappedLine(const char* text, size_t lineIndex, char* buffer, size_t bufferSize) {
-  if (!buffer || bufferSize == 0) {
-    return false;
-  }
-  buffer[0] = '\0';
-  if (!text) {
-    return false;
-  }
-  if (text[0] == '\0') {
-    return lineIndex == 0;
-  }
-  size_t totalLength = strlen(text);
-  size_t start = 0;
-  while (start < totalLength && isspace(static_cast<unsigned char>(text[start]))) {
-    ++start;
-  }
-  if (start >= totalLength) {
-    return lineIndex == 0;
-  }
-  size_t currentLine = 0;
-  while (start < totalLength) {
-    size_t nextStart = start;
-    size_t copyLen = nextWrappedSegment(text, start, totalLength, &nextStart);
-    if (currentLine == lineIndex) {
-      if (copyLen >= bufferSize) {
-        copyLen = bufferSize - 1;
-      }
-      memcpy(buffer, text + start, copyLen);
-      buffer[copyLen] = '\0';
-      return true;
-    }
-    ++currentLine;
-    if (nextStart <= start) {
-      break;
-    }
-    start = nextStart;
-  }
-  return false;
-}
-
-size_t getTotalWrappedLineCount() {
-  size_t total = 0;
-  size_t count = connectionLogGetCount();
-  for (size_t i = 0; i < count; ++i) {
-    const char* entry = connectionLogGetEntry(i);
-    total += countWrappedLines(entry);
-  }
-  return total;
-}
-
 }  // namespace
 
 int getLogMaxScrollOffset() {
-  size_t totalLines = getTotalWrappedLineCount();
+  size_t totalLines = connectionLogGetLineCount();
   if (totalLines > static_cast<size_t>(kLogVisibleLines)) {
     return static_cast<int>(totalLines) - kLogVisibleLines;
   }
@@ -420,7 +306,7 @@ void drawSpeed(){
   oled.drawRFrame(28, frameY, 71, 12, 4);
   oled.drawBox(30, frameY + 2, map(speed, 0, 100, 0, 67), 8);
   int16_t lineY = kStatusBarHeight + 47;
-  oled.drawLine(32, lineY, map(analogRead(potA), 0, 4096, 32, 80), lineY);
+  oled.drawLine(32, lineY, map(InputManager::getInstance().getPotentiometer_Raw(), 0, 4096, 32, 80), lineY);
 }
 
 void drawLine(){
@@ -450,8 +336,8 @@ void tirminal () {
 void drawMotionJoystickPose(){
   oled.setDrawColor(1);
   int16_t frameY = kStatusBarHeight + 32;
-  oled.drawRBox(100 + map(analogRead(joystickB_X), 0, 4096, 0, 23),
-                frameY + map(analogRead(joystickB_Y), 0, 4096, 0, 16),
+  oled.drawRBox(100 + map(InputManager::getInstance().getJoystickB_X_Raw(), 0, 4096, 0, 23),
+                frameY + map(InputManager::getInstance().getJoystickB_Y_Raw(), 0, 4096, 0, 16),
                 3, 3, 1);
   oled.drawRFrame(100, frameY, 25, 18, 3);
 }
@@ -459,8 +345,8 @@ void drawMotionJoystickPose(){
 void drawPeripheralJoystickPose(){
   oled.setDrawColor(1);
   int16_t frameY = kStatusBarHeight + 13;
-  oled.drawRBox(100 + map(analogRead(joystickA_X), 0, 4096, 0, 23),
-                frameY + map(analogRead(joystickA_Y), 0, 4096, 0, 16),
+  oled.drawRBox(100 + map(InputManager::getInstance().getJoystickA_X_Raw(), 0, 4096, 0, 23),
+                frameY + map(InputManager::getInstance().getJoystickA_Y_Raw(), 0, 4096, 0, 16),
                 3, 3, 1);
   oled.drawRFrame(100, frameY, 25, 18, 3);
 }
@@ -675,11 +561,22 @@ void drawPidGraph(){
   int zeroY = mapHistoryValue(0, correctionMin, correctionMax, graphTop, graphBottom);
   oled.drawHLine(0, zeroY, screen_Width);
 
-  int prevY = mapHistoryValue(pidCorrectionHistory[axis][0], correctionMin, correctionMax, graphTop, graphBottom);
-  for (int x = 1; x < screen_Width; ++x) {
-    int currY = mapHistoryValue(pidCorrectionHistory[axis][x], correctionMin, correctionMax, graphTop, graphBottom);
-    oled.drawLine(x - 1, prevY, x, currY);
-    prevY = currY;
+  // Oldest to newest, right-aligned so a partial history scrolls in from the right
+  // No history until the first sample is recorded
+  const PidHistories* histories = pidHistories.load(std::memory_order_acquire);
+  if (histories != nullptr) {
+    const PidHistory& history = histories->correction[axis];
+    const int startX = screen_Width - static_cast<int>(history.size());
+    int x = startX;
+    int prevY = 0;
+    for (int16_t sample : history) {
+      int currY = mapHistoryValue(sample, correctionMin, correctionMax, graphTop, graphBottom);
+      if (x > startX) {
+        oled.drawLine(x - 1, prevY, x, currY);
+      }
+      prevY = currY;
+      ++x;
+    }
   }
 
   float setpoint = (axis == 0) ? static_cast<float>(telemetry.pitchAngle)
@@ -765,58 +662,29 @@ void drawPidGraph(){
   oled.sendBuffer();
 }
 
-void drawOrientationCube(){
-  oled.clearBuffer();
-  drawHeader("Orientation");
-  const float xSize = 20.0f;
-  const float ySize = 10.0f;
-  const float zSize = 5.0f;
+void drawOrientationCube(DisplayCanvas& canvas){
+  canvas.clear();
+  canvas.drawHeader("Orientation");
+  static const WireVertex verts[8] = {
+    {-20,-10,-5}, { 20,-10,-5}, { 20, 10,-5}, {-20, 10,-5},
+    {-20,-10, 5}, { 20,-10, 5}, { 20, 10, 5}, {-20, 10, 5}
+  };
+  const WireMesh cube{verts, 8, Wireframe3D::kBoxEdges, Wireframe3D::kBoxEdgeCount};
   const int cx = screen_Width/2;
   const int cy = screen_Height/2 + 6;
-  struct Vec3 { float x,y,z; };
-  const Vec3 verts[8] = {
-    {-xSize,-ySize,-zSize}, { xSize,-ySize,-zSize}, { xSize, ySize,-zSize}, {-xSize, ySize,-zSize},
-    {-xSize,-ySize, zSize}, { xSize,-ySize, zSize}, { xSize, ySize, zSize}, {-xSize, ySize, zSize}
-  };
-  int px[8];
-  int py[8];
-  float roll  = telemetry.roll  * DEG_TO_RAD;
-  float pitch = -telemetry.pitch * DEG_TO_RAD;
-  float yaw   = -telemetry.yaw   * DEG_TO_RAD + PI;
-  for(int i=0;i<8;i++){
-    float x=verts[i].x;
-    float y=verts[i].y;
-    float z=verts[i].z;
-    float y1 = y*cos(roll) - z*sin(roll);
-    float z1 = y*sin(roll) + z*cos(roll);
-    y = y1; z = z1;
-    float x1 = x*cos(pitch) + z*sin(pitch);
-    float z2 = -x*sin(pitch) + z*cos(pitch);
-    x = x1; z = z2;
-    float x2 = x*cos(yaw) - y*sin(yaw);
-    float y2 = x*sin(yaw) + y*cos(yaw);
-    x = x2; y = y2;
-    px[i] = cx + (int)x;
-    py[i] = cy - (int)y;
-  }
-  const uint8_t edges[12][2] = {
-    {0,1},{1,2},{2,3},{3,0},
-    {4,5},{5,6},{6,7},{7,4},
-    {0,4},{1,5},{2,6},{3,7}
-  };
-  for(int i=0;i<12;i++){
-    oled.drawLine(px[edges[i][0]], py[edges[i][0]],
-                  px[edges[i][1]], py[edges[i][1]]);
-  }
+  const WireRotation rotation = WireRotation::fromEuler(telemetry.roll * DEG_TO_RAD,
+                                                        -telemetry.pitch * DEG_TO_RAD,
+                                                        -telemetry.yaw * DEG_TO_RAD + PI);
+  Wireframe3D::drawMesh(canvas, cube, rotation, cx, cy);
   int arrowLen = map(static_cast<int>(telemetry.verticalAcc * 100), -1000, 1000, -20, 20);
-  oled.drawLine(cx, cy, cx, cy - arrowLen);
+  Wireframe3D::drawLine(canvas, cx, cy, cx, cy - arrowLen);
   if(arrowLen != 0){
     int head = cy - arrowLen;
-    oled.drawTriangle(cx, head, cx-3, head + (arrowLen>0?-5:5),
-                      cx+3, head + (arrowLen>0?-5:5));
+    canvas.drawTriangle(cx, head, cx-3, head + (arrowLen>0?-5:5),
+                        cx+3, head + (arrowLen>0?-5:5), true);
   }
-  drawHomeFooter();
-  oled.sendBuffer();
+  canvas.setFont(DisplayCanvas::SMALL);
+  canvas.drawText(0, 60, homeSelected ? ">Home" : " Home");
 }
 
 void drawPairingMenu(){
@@ -1168,8 +1036,7 @@ void drawConnectionLog(){
   drawHeader("Link Log");
   oled.setFont(tinyFont);
 
-  const size_t count = connectionLogGetCount();
-  const size_t totalLines = getTotalWrappedLineCount();
+  const size_t totalLines = connectionLogGetLineCount();
   int maxOffset = 0;
   if(totalLines > static_cast<size_t>(kLogVisibleLines)){
     maxOffset = static_cast<int>(totalLines) - kLogVisibleLines;
@@ -1181,41 +1048,22 @@ void drawConnectionLog(){
     logScrollOffset = maxOffset;
   }
 
-  if(count == 0){
+  if(totalLines == 0){
     oled.setCursor(0, kLogStartY);
     oled.print("Waiting for events...");
   } else {
+    // Bottom-anchored: offset 0 shows the newest lines
     size_t startLine = 0;
     if(totalLines > static_cast<size_t>(kLogVisibleLines)){
       startLine = totalLines - kLogVisibleLines - static_cast<size_t>(logScrollOffset);
     }
-    size_t currentLine = 0;
-    int drawnLines = 0;
-    for(size_t entryIndex = 0; entryIndex < count && drawnLines < kLogVisibleLines; ++entryIndex){
-      const char* entry = connectionLogGetEntry(entryIndex);
-      if(!entry){
-        continue;
-      }
-      size_t entryLineCount = countWrappedLines(entry);
-      if(currentLine + entryLineCount <= startLine){
-        currentLine += entryLineCount;
-        continue;
-      }
-      size_t skipLines = 0;
-      if(startLine > currentLine){
-        skipLines = startLine - currentLine;
-      }
-      for(size_t line = skipLines; line < entryLineCount && drawnLines < kLogVisibleLines; ++line){
-        char buffer[kLogLineBufferSize];
-        if(!extractWrappedLine(entry, line, buffer, sizeof(buffer))){
-          continue;
-        }
-        int16_t y = kLogStartY + drawnLines * kLogLineHeight;
-        oled.setCursor(0, y);
-        oled.print(buffer);
-        ++drawnLines;
+    char buffer[kLogLineBufferSize];
+    for(int drawnLines = 0; drawnLines < kLogVisibleLines; ++drawnLines){
+      if(!connectionLogGetLine(startLine + drawnLines, buffer, sizeof(buffer))){
+        break;
       }
-      currentLine += entryLineCount;
+      oled.setCursor(0, kLogStartY + drawnLines * kLogLineHeight);
+      oled.print(buffer);
     }
   }
 
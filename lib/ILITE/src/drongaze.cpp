@@ -8,11 +8,15 @@
 
 #include "drongaze.h"
 #include "input.h"
+#include "InputManager.h"
+#include "ControlShaping.h"
 #include "display.h"
 #include "audio_feedback.h"
 #include "espnow_discovery.h"
 #include "connection_log.h"
-#include <cstdio>
+#include "LogChannels.h"
+#include "Transport.h"
+#include "ParamSync.h"
 #include <cstring>
 
 // ============================================================================
@@ -36,9 +40,6 @@ constexpr float PID_COARSE_STEPS[3] = {0.50f, 0.10f, 0.10f};
 /// Maximum allowed PID gains (Kp, Ki, Kd)
 constexpr float PID_GAIN_MAX[3] = {20.0f, 5.0f, 5.0f};
 
-/// Axis name strings for command generation
-static const char* kAxisCommandNames[DRONGAZE_PID_AXIS_COUNT] = {"pitch", "roll", "yaw"};
-
 /// Stabilization mask bits for each axis
 static const uint8_t kAxisMaskBits[DRONGAZE_PID_AXIS_COUNT] = {0x02, 0x01, 0x04};
 
@@ -55,8 +56,8 @@ extern int pidTunerAxisIndex;
 extern uint8_t pidFocusIndex;
 extern bool pidCoarseMode;
 
-// Forward declare sendDroneCommand for internal use
-static bool sendDroneCommand(const char* fmt, ...);
+// Forward declare resetParamLink for initDrongazeState
+static void resetParamLink();
 
 // ============================================================================
 // Initialization
@@ -83,6 +84,8 @@ void initDrongazeState() {
 
     memset(&drongazeTelemetry, 0, sizeof(drongazeTelemetry));
     drongazeTelemetry.magic = DRONGAZE_PACKET_MAGIC;
+
+    resetParamLink();
 }
 
 // ============================================================================
@@ -90,44 +93,24 @@ void initDrongazeState() {
 // ============================================================================
 
 void updateDrongazeControl() {
-    // Throttle: Potentiometer provides base, joystick A Y-axis provides offset
-    static uint16_t potFiltered = analogRead(potA);
-    potFiltered = (potFiltered * 3 + analogRead(potA)) / 4; // IIR low-pass filter
-    uint16_t potOffset = map(potFiltered, 0, 4095, 0, 500);
-    potOffset = constrain(potOffset, 0, 500);
-
-    drongazeCommand.throttle = constrain(
-        map(analogRead(joystickA_Y), 0, 4095, 2000, -1000) + potOffset,
-        1000,
-        2000);
-
-    // Yaw: Incremental rate control (not absolute position)
-    int16_t yawDelta = map(analogRead(joystickA_X), 0, 4096, -10, 10);
-    if (abs(yawDelta) < 2) {
-        yawDelta = 0; // Deadband to prevent drift
-    }
+    const InputManager& inputs = InputManager::getInstance();
+
+    // Throttle: joystick A Y-axis (stick up = more), potentiometer adds up to 500 us
+    const float throttle = 500.0f - 1500.0f * inputs.getJoystickA_Y() + inputs.getPotentiometer() * 500.0f;
+    drongazeCommand.throttle = static_cast<uint16_t>(ControlShaping::clamp(throttle, 1000.0f, 2000.0f));
+
+    // Yaw: Incremental rate control (not absolute position), wide deadband against drift
+    const int16_t yawDelta = static_cast<int16_t>(
+        ControlShaping::deadzone(inputs.getJoystickA_X(), 0.2f) * 10.0f);
     drongazeState.yawCommand = constrain(drongazeState.yawCommand + yawDelta, -180, 180);
     drongazeCommand.yawAngle = drongazeState.yawCommand;
 
-    // Roll: Joystick B X-axis
-    int16_t roll = map(analogRead(joystickB_X), 0, 4095, -90, 90);
-    if (abs(roll) < 10) {
-        roll = 0; // Deadzone around center
-    }
-    if (drongazeState.precisionMode) {
-        roll /= 2; // Half sensitivity in precision mode
-    }
-    drongazeCommand.rollAngle = roll;
-
-    // Pitch: Joystick B Y-axis
-    int16_t pitch = map(analogRead(joystickB_Y), 0, 4095, -90, 90);
-    if (abs(pitch) < 10) {
-        pitch = 0;
-    }
-    if (drongazeState.precisionMode) {
-        pitch /= 2;
-    }
-    drongazeCommand.pitchAngle = pitch;
+    // Roll / pitch: joystick B, half sensitivity in precision mode
+    const float axisScale = drongazeState.precisionMode ? 45.0f : 90.0f;
+    drongazeCommand.rollAngle = static_cast<int8_t>(
+        ControlShaping::deadzone(inputs.getJoystickB_X(), 0.11f) * axisScale);
+    drongazeCommand.pitchAngle = static_cast<int8_t>(
+        ControlShaping::deadzone(inputs.getJoystickB_Y(), 0.11f) * axisScale);
 
     // Arm state from global button mode
     drongazeCommand.arm_motors = btnmode;
@@ -168,69 +151,137 @@ const uint8_t* prepareDrongazePayload(size_t& size) {
 }
 
 // ============================================================================
-// PID Tuning
+// Parameter Channel
 // ============================================================================
 
-static int axisNameToIndex(const char* name) {
-    if (!name) return -1;
-    if (strcasecmp(name, "pitch") == 0) return 0;
-    if (strcasecmp(name, "roll") == 0) return 1;
-    if (strcasecmp(name, "yaw") == 0) return 2;
-    return -1;
+namespace {
+
+constexpr size_t kParamFrameMax = sizeof(DrongazeParamHeader) +
+                                  DRONGAZE_PARAM_MAX_ENTRIES * sizeof(DrongazeParamEntry);
+constexpr size_t kParamCount = static_cast<size_t>(DrongazeParam::Count);
+static_assert(kParamCount <= DRONGAZE_PARAM_MAX_ENTRIES, "All parameters must fit one frame");
+static_assert(kParamCount <= ParamSync::kMaxParams, "Parameter IDs must fit ParamSync");
+
+float* pidGainFor(size_t param) {
+    DrongazePidGains& gains = drongazeState.pidGains[param / 3];
+    return (param % 3 == 0) ? &gains.kp : (param % 3 == 1) ? &gains.ki : &gains.kd;
 }
 
-static bool sendDroneCommand(const char* fmt, ...) {
-    if (!controlSessionActive) {
-        connectionLogAdd("Command not sent: no active session");
-        return false;
+bool hasParamTarget() {
+    static const uint8_t kBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    return controlSessionActive &&
+           memcmp(targetAddress, kBroadcastMac, sizeof(targetAddress)) != 0;
+}
+
+// ParamSync send function: a Set of the given values, or a Get of everything
+bool sendParamFrame(uint16_t sequence, const ParamValue* values, size_t count) {
+    DrongazeParamHeader header{};
+    header.magic = DRONGAZE_PARAM_MAGIC;
+    header.sequence = sequence;
+    header.op = static_cast<uint8_t>(count > 0 ? DrongazeParamOp::Set : DrongazeParamOp::Get);
+    header.count = static_cast<uint8_t>(count);
+
+    uint8_t frame[kParamFrameMax];
+    memcpy(frame, &header, sizeof(header));
+    size_t length = sizeof(header);
+    for (size_t i = 0; i < count; ++i) {
+        const DrongazeParamEntry entry{values[i].id, values[i].value};
+        memcpy(frame + length, &entry, sizeof(entry));
+        length += sizeof(entry);
     }
 
-    // Validate target address
-    uint8_t broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-    if (memcmp(targetAddress, broadcastAddress, sizeof(targetAddress)) == 0) {
-        connectionLogAdd("Command not sent: unknown target");
+    if (Transport::getActive().send(targetAddress, frame, length) != ESP_OK) {
+        ILITE_LOG_RATE(MODULE, LOG_WARN, 1, 5, "Parameter frame send failed");
         return false;
     }
+    return true;
+}
 
-    // Format command string
-    char buffer[48];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
-    va_end(args);
-    buffer[sizeof(buffer) - 1] = '\0';
+ParamSync paramSync(sendParamFrame);
 
-    if (buffer[0] == '\0') {
-        return false;
+}  // namespace
+
+static void resetParamLink() {
+    paramSync.reset();
+}
+
+void setDrongazeParam(DrongazeParam param, float value) {
+    paramSync.set(static_cast<uint8_t>(param), value);
+}
+
+bool isDrongazeParamPending(DrongazeParam param) {
+    return paramSync.isPending(static_cast<uint8_t>(param));
+}
+
+size_t getDrongazePendingParamCount() {
+    return paramSync.getPendingCount();
+}
+
+void serviceDrongazeParams(uint32_t nowMs) {
+    if (hasParamTarget()) {
+        paramSync.service(nowMs);
     }
+}
 
-    // Send via ESP-NOW command channel
-    if (!discovery.sendCommand(targetAddress, buffer)) {
-        connectionLogAddf("Command send failed: %s", buffer);
-        audioFeedback(AudioCue::Error);
-        return false;
+void handleDrongazeParamAck(const uint8_t* data, size_t length) {
+    DrongazeParamHeader header;
+    if (data == nullptr || length < sizeof(header)) return;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != DRONGAZE_PARAM_ACK_MAGIC ||
+        length < sizeof(header) + header.count * sizeof(DrongazeParamEntry)) {
+        return;
+    }
+    // A duplicate or late reply to a frame already settled (or resent) may
+    // carry values older than what the robot has now; only the current
+    // frame's reply is applied
+    if (!paramSync.acknowledge(header.sequence)) {
+        return;
     }
 
-    connectionLogAddf("Command sent: %s", buffer);
-    return true;
+    const uint8_t* cursor = data + sizeof(header);
+    for (uint8_t i = 0; i < header.count; ++i, cursor += sizeof(DrongazeParamEntry)) {
+        DrongazeParamEntry entry;
+        memcpy(&entry, cursor, sizeof(entry));
+        // An edit made since this frame left wins over the reported value
+        if (entry.id >= kParamCount || paramSync.isDirty(entry.id)) {
+            continue;
+        }
+        if (entry.id < static_cast<uint8_t>(DrongazeParam::StabilizePitch)) {
+            *pidGainFor(entry.id) = entry.value;
+            drongazeState.pidGainsValid[entry.id / 3] = true;
+        }
+    }
 }
 
+// ============================================================================
+// PID Tuning
+// ============================================================================
+
 void sendDrongazePidGains(int axisIndex) {
     if (axisIndex < 0 || axisIndex >= DRONGAZE_PID_AXIS_COUNT) return;
 
     const DrongazePidGains& gains = drongazeState.pidGains[axisIndex];
-    sendDroneCommand("pid set %s %.3f %.3f %.3f",
-                     kAxisCommandNames[axisIndex],
-                     gains.kp, gains.ki, gains.kd);
+    const uint8_t first = static_cast<uint8_t>(axisIndex * 3);
+    setDrongazeParam(static_cast<DrongazeParam>(first), gains.kp);
+    setDrongazeParam(static_cast<DrongazeParam>(first + 1), gains.ki);
+    setDrongazeParam(static_cast<DrongazeParam>(first + 2), gains.kd);
+}
+
+void setDrongazePidGain(int axisIndex, int paramIndex, float value) {
+    if (axisIndex < 0 || axisIndex >= DRONGAZE_PID_AXIS_COUNT) return;
+    if (paramIndex < 0 || paramIndex > 2) return;
+
+    const size_t param = static_cast<size_t>(axisIndex * 3 + paramIndex);
+    *pidGainFor(param) = constrain(value, 0.0f, PID_GAIN_MAX[paramIndex]);
+    setDrongazeParam(static_cast<DrongazeParam>(param), *pidGainFor(param));
 }
 
 void adjustDrongazePidGain(int axisIndex, int paramIndex, int delta) {
     if (axisIndex < 0 || axisIndex >= DRONGAZE_PID_AXIS_COUNT) return;
     if (paramIndex < 0 || paramIndex > 2) return;
 
-    DrongazePidGains& gains = drongazeState.pidGains[axisIndex];
-    float* value = (paramIndex == 0) ? &gains.kp :
-                   (paramIndex == 1) ? &gains.ki : &gains.kd;
+    const size_t param = static_cast<size_t>(axisIndex * 3 + paramIndex);
+    float* value = pidGainFor(param);
 
     // Initialize to 0 if not yet valid
     if (!drongazeState.pidGainsValid[axisIndex]) {
@@ -245,32 +296,12 @@ void adjustDrongazePidGain(int axisIndex, int paramIndex, int delta) {
     *value = constrain(*value, 0.0f, PID_GAIN_MAX[paramIndex]);
 
     drongazeState.pidGainsValid[axisIndex] = true;
-    sendDrongazePidGains(axisIndex);
-}
-
-void handleDrongazeCommandMessage(const char* message) {
-    if (!message) return;
-
-    // Parse "PID axis: Kp=X Ki=Y Kd=Z" format
-    if (strncmp(message, "PID ", 4) == 0) {
-        char axisName[16] = {0};
-        float kp = 0.0f, ki = 0.0f, kd = 0.0f;
-
-        if (sscanf(message, "PID %15[^:]: Kp=%f Ki=%f Kd=%f", axisName, &kp, &ki, &kd) == 4) {
-            int axisIndex = axisNameToIndex(axisName);
-            if (axisIndex >= 0 && axisIndex < DRONGAZE_PID_AXIS_COUNT) {
-                drongazeState.pidGains[axisIndex].kp = kp;
-                drongazeState.pidGains[axisIndex].ki = ki;
-                drongazeState.pidGains[axisIndex].kd = kd;
-                drongazeState.pidGainsValid[axisIndex] = true;
-            }
-        }
-    }
+    // Only the edited gain goes out, batched with the next detents
+    setDrongazeParam(static_cast<DrongazeParam>(param), *value);
 }
 
 void requestDrongazePidGains() {
-    sendDroneCommand("pid show");
-    sendDroneCommand("stabilization status");
+    paramSync.requestRefresh();
 }
 
 void toggleDrongazeAxisStabilization(int axisIndex) {
@@ -279,9 +310,9 @@ void toggleDrongazeAxisStabilization(int axisIndex) {
     bool enabled = (drongazeState.stabilizationMask & kAxisMaskBits[axisIndex]) != 0;
     bool enable = !enabled;
 
-    if (sendDroneCommand("stabilization axis %s %s", kAxisCommandNames[axisIndex], enable ? "on" : "off")) {
-        audioFeedback(enable ? AudioCue::ToggleOn : AudioCue::ToggleOff);
-    }
+    const uint8_t param = static_cast<uint8_t>(DrongazeParam::StabilizePitch) + axisIndex;
+    setDrongazeParam(static_cast<DrongazeParam>(param), enable ? 1.0f : 0.0f);
+    audioFeedback(enable ? AudioCue::ToggleOn : AudioCue::ToggleOff);
 }
 
 // ============================================================================
@@ -331,7 +362,7 @@ void drawDrongazeLayoutCard(const ModuleState& state, int16_t x, int16_t y, bool
     extern void drawLayoutCardFrame(int16_t x, int16_t y, const char* title, const char* subtitle, bool focused);
     extern void drawWifiStatusBadge(const ModuleState& state, int16_t right, int16_t y);
     extern ModuleState* getActiveModule();
-    extern U8G2_SH1106_128X64_NONAME_F_HW_I2C oled;
+    extern OledDisplay oled;
     extern const int screen_Width;
 
     const ModuleState* active = getActiveModule();
@@ -1,10 +1,20 @@
 #include "espnow_discovery.h"
 #include "audio_feedback.h"
 #include "connection_log.h"
+#include "LogChannels.h"
+#include "LinkMetrics.h"
+#include "LatencyPins.h"
+#include "ClockSync.h"
+#include "FrameworkEvents.h"
+#include "TdmaSlots.h"
+#include "Transport.h"
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
 #include "display.h"
 #endif
 
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 
@@ -13,6 +23,19 @@ namespace {
 
 constexpr uint8_t kBroadcastMac[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
 
+// 802.11 vendor action frame around the ESP-NOW payload: MAC header (24),
+// category + OUI + random (8), vendor IE header (7), FCS (4)
+constexpr uint32_t kEspNowFrameOverhead = 43;
+constexpr uint32_t kLongPreambleUs = 192;
+
+// Keepalive spacing after a channel switch, until the peer is heard
+constexpr uint32_t kChannelKeepaliveMs = 100;
+
+const char* const kAirtimeLabels[EspNowDiscovery::kAirtimeSlots] = {
+    "other", "pair_req", "identity", "confirm", "ack", "keepalive", "command", "ping", "pong",
+    "channel", "slot", "resume", "resume_ack"
+};
+
 const char* messageTypeToString(MessageType type) {
     switch (type) {
         case MessageType::MSG_PAIR_REQ:
@@ -27,6 +50,18 @@ const char* messageTypeToString(MessageType type) {
             return "MSG_KEEPALIVE";
         case MessageType::MSG_COMMAND:
             return "MSG_COMMAND";
+        case MessageType::MSG_PING:
+            return "MSG_PING";
+        case MessageType::MSG_PONG:
+            return "MSG_PONG";
+        case MessageType::MSG_CHANNEL:
+            return "MSG_CHANNEL";
+        case MessageType::MSG_SLOT_BEACON:
+            return "MSG_SLOT_BEACON";
+        case MessageType::MSG_RESUME:
+            return "MSG_RESUME";
+        case MessageType::MSG_RESUME_ACK:
+            return "MSG_RESUME_ACK";
         default:
             return "MSG_UNKNOWN";
     }
@@ -48,21 +83,19 @@ const char* macLabel(const uint8_t* mac, char* buffer, size_t bufferLen) {
     return buffer;
 }
 
+bool isRoutineTraffic(MessageType type) {
+    return type == MessageType::MSG_PING || type == MessageType::MSG_PONG ||
+           type == MessageType::MSG_SLOT_BEACON;
+}
+
 void logTx(MessageType type, const uint8_t* mac) {
     char label[24] = {};
-    connectionLogAddf("TX %s to %s", messageTypeToString(type), macLabel(mac, label, sizeof(label)));
+    ILITE_LOG_RATE(DISCOVERY, LOG_INFO, 5, 10, "TX %s to %s", messageTypeToString(type), macLabel(mac, label, sizeof(label)));
 }
 
 void logRx(MessageType type, const uint8_t* mac) {
     char label[24] = {};
-    connectionLogAddf("RX %s from %s", messageTypeToString(type), macLabel(mac, label, sizeof(label)));
-}
-
-void logMac(const char* prefix, const uint8_t* mac) {
-    char buffer[24] = {};
-    EspNowDiscovery::macToString(mac, buffer, sizeof(buffer));
-    Serial.print(prefix);
-    Serial.println(buffer);
+    ILITE_LOG_RATE(DISCOVERY, LOG_INFO, 5, 10, "RX %s from %s", messageTypeToString(type), macLabel(mac, label, sizeof(label)));
 }
 
 }  // namespace
@@ -70,31 +103,46 @@ void logMac(const char* prefix, const uint8_t* mac) {
 // Global pointer for static callback access
 static EspNowDiscovery* g_discoveryInstance = nullptr;
 
-// Static ESP-NOW receive callback (forwards to instance method)
-static void onEspNowDataRecv(const uint8_t* mac, const uint8_t* incomingData, int len) {
-    if (g_discoveryInstance != nullptr) {
-        g_discoveryInstance->handleIncoming(mac, incomingData, len);
+// ESP-NOW receive callback. Runs in the WiFi task, so it only copies the frame
+// into the ring and wakes the consumer; all parsing happens in drainReceived().
+// While a wired transport is active it owns the ring (single producer), and
+// anything heard over the air is dropped.
+void onEspNowDataRecv(const uint8_t* mac, const uint8_t* incomingData, int len) {
+    ILITE_LATENCY_PULSE(Rx);
+    EspNowDiscovery* self = g_discoveryInstance;
+    if (self == nullptr || !Transport::getActive().isEspNow()) {
+        return;
+    }
+    if (self->foreignFilter && !self->acceptsFrame(mac, incomingData, len)) {
+        ForeignTrafficStats& foreign = self->foreign;
+        foreign.frames++;
+        foreign.bytes += len;
+        foreign.airUs += EspNowDiscovery::estimateAirtimeUs(len);
+        memcpy(foreign.lastMac, mac, sizeof(foreign.lastMac));
+        return;
+    }
+    if (self->rxRing.push(mac, incomingData, len) && self->rxTask != nullptr) {
+        xTaskNotifyGive(self->rxTask);
     }
 }
 
 void EspNowDiscovery::begin() {
-    WiFi.mode(WIFI_AP_STA);
+    // ESP-NOW needs STA; the AP only runs in the OTA maintenance mode
+    if ((WiFi.getMode() & WIFI_STA) == 0) {
+        WiFi.mode(WIFI_STA);
+    }
     WiFi.setTxPower(WIFI_POWER_19_5dBm);
-    // esp_err_t chanResult = esp_wifi_set_channel(WIFI_CHANNEL, WIFI_SECOND_CHAN_NONE); //we're not setting channels for now, let them play loose.
-    // if (chanResult != ESP_OK) {
-    //     Serial.print("[ESP-NOW] Failed to set WiFi channel: ");
-    //     Serial.println(chanResult);
-    //     connectionLogAddf("WiFi channel error: %d", chanResult);
-    // }
+    // The channel is left alone: the caller picks it before begin() (see
+    // ChannelSurvey) and requestChannelSwitch() moves it later
 
     fillSelfIdentity();
-    connectionLogAdd("ESP-NOW begin");
+    ILITE_LOG(DISCOVERY, LOG_INFO, "ESP-NOW begin");
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
-    connectionLogAdd("Role: controller");
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Role: controller");
 #else
-    connectionLogAdd("Role: controlled");
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Role: controlled");
 #endif
-    connectionLogAddf("Identity: %s/%s", selfIdentity.customId, selfIdentity.deviceType);
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Identity: %s/%s", selfIdentity.customId, selfIdentity.deviceType);
 
     // Register ESP-NOW receive callback
     g_discoveryInstance = this;
@@ -111,12 +159,10 @@ void EspNowDiscovery::begin() {
         }
     }
 
-    for (int i = 0; i < kMaxPeers; ++i) {
-        peers[i] = PeerEntry{};
-    }
-    peerCount = 0;
+    clearPeers();
     link = LinkState{};
     lastBroadcastMs = 0;
+    resetBroadcastBackoff();
     discoveryEnabled = true;
 
     Serial.print("[ESP-NOW] Role: ");
@@ -136,33 +182,58 @@ void EspNowDiscovery::begin() {
 void EspNowDiscovery::discover() {
     uint32_t now = millis();
     pruneExpiredPeers(now);
+    refreshPeerRanks(now);
 
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
     // Note: Old display mode system removed - now using discoveryEnabled flag
-    bool allowBroadcast = discoveryEnabled;
+    bool allowBroadcast = discoveryEnabled && !passiveListening;
     // Only broadcast if not paired, OR if continuous scanning is enabled
     bool shouldBroadcast = allowBroadcast && (!link.paired || continuousScanning);
 
-    if (shouldBroadcast && now - lastBroadcastMs >= BROADCAST_INTERVAL_MS) {
+    if (shouldBroadcast && (lastBroadcastMs == 0 || now - lastBroadcastMs >= broadcastIntervalMs)) {
         char mac[24];
         macLabel(kBroadcastMac, mac, sizeof(mac));
-        Serial.printf("[ESP-NOW] Broadcasting PAIR_REQ to %s\n", mac);
+        ILITE_LOG(DISCOVERY, LOG_DEBUG, "Broadcasting PAIR_REQ to %s (next in %lu ms)", mac,
+                  static_cast<unsigned long>(broadcastIntervalMs));
         sendPacket(MessageType::MSG_PAIR_REQ, kBroadcastMac);
         lastBroadcastMs = now;
+
+        // Back off while the last interval found nothing new; a robot
+        // searching channels must hear one request per dwell
+        const uint32_t maxIntervalMs = autoChannel && !link.paired ? kChannelSearchBroadcastMs
+                                                                   : BROADCAST_MAX_INTERVAL_MS;
+        if (link.paired) {
+            broadcastIntervalMs = BROADCAST_MAX_INTERVAL_MS;
+        } else if (discoveredSinceBroadcast) {
+            broadcastIntervalMs = BROADCAST_MIN_INTERVAL_MS;
+        } else if (broadcastIntervalMs < maxIntervalMs) {
+            broadcastIntervalMs = std::min(broadcastIntervalMs * 2, maxIntervalMs);
+        } else {
+            broadcastIntervalMs = maxIntervalMs;
+        }
+        discoveredSinceBroadcast = false;
     }
 
     // Auto-pair with first discovered device (when allowed)
     bool autoPairAllowed = discoveryEnabled && autoPairingEnabled;
     if (autoPairAllowed && !link.paired) {
         int targetIndex = selectTarget();
-        if (targetIndex >= 0) {
+        if (link.resuming) {
+            // The last session's robot answered the broadcast; resume it instead
+            if (now - link.lastConfirmSentMs >= link.resumeRetryMs) {
+                retryResume(now);
+            }
+        } else if (targetIndex >= 0) {
             PeerEntry& target = peers[targetIndex];
             const bool awaitingSamePeer = link.awaitingAck && macEqual(target.mac, link.peerMac);
             const bool shouldRetryCurrent = awaitingSamePeer && !target.acked &&
                                             (now - link.lastConfirmSentMs) >= BROADCAST_INTERVAL_MS;
             bool shouldConfirm = !target.confirmed || shouldRetryCurrent;
-            if (shouldConfirm) {
-                Serial.printf("[ESP-NOW] Auto-pairing with device index %d\n", targetIndex);
+            if (session.token != 0 && !target.confirmed && macEqual(target.mac, session.mac)) {
+                target.confirmed = true;
+                startResume(now);
+            } else if (shouldConfirm) {
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Auto-pairing with device index %d", targetIndex);
                 beginPairingWith(target.mac);
             }
         }
@@ -173,7 +244,27 @@ void EspNowDiscovery::discover() {
             link.lastKeepaliveMs = now;
         }
 
+        // A peer silent for several of its usual gaps may have rebooted
+        const uint32_t silenceMs = link.gapAvgMs * 4 > kResumeSilenceMs ? link.gapAvgMs * 4 : kResumeSilenceMs;
+        if (!link.awaitingAck && session.token != 0 && now - link.lastActivityMs >= silenceMs) {
+            startResume(now);
+        }
+
+        // Restored or resuming link: repeat until the peer acks it
+        if (link.resuming) {
+            if (now - link.lastConfirmSentMs >= link.resumeRetryMs) {
+                retryResume(now);
+            }
+        } else if (link.awaitingAck && now - link.lastConfirmSentMs >= BROADCAST_INTERVAL_MS) {
+            sendPacket(MessageType::MSG_PAIR_CONFIRM, link.peerMac, now, session.token);
+            link.lastConfirmSentMs = now;
+        }
+
+        if (pingIntervalMs > 0 && now - lastPingMs >= pingIntervalMs) {
+            sendPing(now);
+        }
     }
+    serviceTeamLinks(now);
 #else
     if (link.paired) {
         // Send keepalive to maintain connection
@@ -181,20 +272,51 @@ void EspNowDiscovery::discover() {
             sendPacket(MessageType::MSG_KEEPALIVE, link.peerMac);
             link.lastKeepaliveMs = now;
         }
+    } else if (link.resuming) {
+        if (now - link.lastConfirmSentMs >= link.resumeRetryMs) {
+            retryResume(now);
+        }
+    } else if (autoChannel && !isChannelSwitchPending() &&
+               now - lastChannelSearchMs >= kChannelSearchDwellMs) {
+        // Walk the candidates until a controller's pair request arrives
+        const uint8_t current = getChannel();
+        const size_t count = sizeof(kChannelCandidates) / sizeof(kChannelCandidates[0]);
+        uint8_t next = kChannelCandidates[0];
+        for (size_t i = 0; i < count; ++i) {
+            if (kChannelCandidates[i] == current) {
+                next = kChannelCandidates[(i + 1) % count];
+                break;
+            }
+        }
+        setRadioChannel(next);
+        lastChannelSearchMs = now;
     }
 #endif
+    serviceChannel(now);
 }
 
-bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incomingData, int len) {
+bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incomingData, int len, uint32_t rxUs) {
 
     uint32_t now = millis();
+    if (rxUs == 0) {
+        rxUs = static_cast<uint32_t>(esp_timer_get_time());
+    }
 
     // CRITICAL: Update link activity FIRST for ANY packet from paired peer
     // This ensures telemetry packets (which have different structure) still reset timeout
     if (link.paired && macEqual(mac, link.peerMac)) {
+        // Usual gap between the peer's frames; a silence gap counts as the threshold
+        uint32_t gap = now - link.lastActivityMs;
+        if (gap > kResumeSilenceMs) {
+            gap = kResumeSilenceMs;
+        }
+        link.gapAvgMs = link.gapAvgMs == 0 ? gap
+                                           : link.gapAvgMs + static_cast<int32_t>(gap - link.gapAvgMs) / 8;
         link.lastActivityMs = now;
     }
 
+    LinkMetrics::onReceive(mac);
+
     // Update lastSeen for ANY message from ANY known peer to prevent premature stale detection
     int peerIndex = findPeerIndex(mac);
     if (peerIndex >= 0) {
@@ -204,34 +326,47 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
     // Now validate protocol packet structure (may fail for telemetry packets)
     const Packet* packet = reinterpret_cast<const Packet*>(incomingData);
     MessageType type = packet->type;
-    logRx(type, mac);
-
-    // Serial logging for RX (similar to TX logging)
-    Serial.printf("[RX] Received %s (%d bytes) from %02X:%02X:%02X:%02X:%02X:%02X\n",
-        messageTypeToString(type), len,
-        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    // Link pings and slot beacons run continuously and are not worth a log line each
+    if (!isRoutineTraffic(type)) {
+        logRx(type, mac);
+    }
 
     if (len < static_cast<int>(sizeof(Packet))) {
-        Serial.printf("[ESP-NOW] Packet too small: %d < %d bytes\n", len, sizeof(Packet));
+        ILITE_LOG_RATE(DISCOVERY, LOG_WARN, 1, 3, "Packet too small: %d < %u bytes", len,
+                       static_cast<unsigned>(sizeof(Packet)));
+        recordRx(0, len);
         return false;
     }
 
     if (packet->version != kProtocolVersion) {
-        Serial.printf("[ESP-NOW] Protocol version mismatch: %d != %d\n", packet->version, kProtocolVersion);
+        ILITE_LOG_RATE(DISCOVERY, LOG_WARN, 1, 3, "Protocol version mismatch: %d != %d", packet->version,
+                       kProtocolVersion);
+        recordRx(0, len);
         return false;
     }
 
+    const size_t typeSlot = static_cast<size_t>(type);
+    recordRx(typeSlot < kAirtimeSlots ? typeSlot : 0, len);
+
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+    // Passive listening learns robots from whatever they send on their own
+    if (passiveListening && peerIndex < 0 &&
+        strncmp(packet->id.deviceType, "controlled", sizeof(packet->id.deviceType)) == 0) {
+        upsertPeer(packet->id, mac, now);
+    }
+#endif
+
     switch (type) {
         case MessageType::MSG_PAIR_REQ:
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLED
             if (link.paired) {
-                connectionLogAdd("Ignoring pair request while paired");
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Ignoring pair request while paired");
                 return true;
             }
-            Serial.println("[ESP-NOW] Pair request received");
             char pairLabel[24] = {};
             macToString(mac, pairLabel, sizeof(pairLabel));
-            connectionLogAddf("Pair request from %s", pairLabel);
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Pair request from %s", pairLabel);
+            lastChannelSearchMs = now;  // Found the controller's channel; stay for the handshake
             upsertPeer(packet->id, mac, now);
             ensurePeer(mac);
             sendPacket(MessageType::MSG_IDENTITY_REPLY, mac);
@@ -243,12 +378,11 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
 
         case MessageType::MSG_IDENTITY_REPLY:
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
-            Serial.println("[ESP-NOW] Identity reply received");
-            connectionLogAddf("Recieved an identity");
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Recieved an identity");
             upsertPeer(packet->id, mac, now);
             ensurePeer(mac);
-            audioFeedback(AudioCue::PeerDiscovered);
-            connectionLogAddf("Identity reply: %s", packet->id.customId);
+            FrameworkEvents::postCue(AudioCue::PeerDiscovered);
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Identity reply: %s", packet->id.customId);
             return true;
 #else
             return false;
@@ -256,22 +390,24 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
 
         case MessageType::MSG_PAIR_CONFIRM:
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLED
-            Serial.println("[ESP-NOW] Pair confirm received");
             char confirmLabel[24] = {};
             macToString(mac, confirmLabel, sizeof(confirmLabel));
-            connectionLogAddf("Pair confirm from %s", confirmLabel);
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Pair confirm from %s", confirmLabel);
             ensurePeer(mac);
             int index = upsertPeer(packet->id, mac, now);
             if (index >= 0) {
+                // Team confirms carry no session
+                if (packet->reserved != 0) {
+                    setSession(mac, packet->reserved);
+                }
                 link.paired = true;
                 link.peerIndex = index;
                 memcpy(link.peerMac, mac, sizeof(link.peerMac));
                 link.lastActivityMs = now;
                 sendPacket(MessageType::MSG_PAIR_ACK, mac);
                 peers[index].acked = true;
-                Serial.println("[ESP-NOW] Paired with controller");
                 audioFeedback(AudioCue::PeerAcknowledge);
-                connectionLogAddf("Paired with %s", packet->id.customId);
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Paired with %s", packet->id.customId);
             }
             return true;
 #else
@@ -280,9 +416,18 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
 
         case MessageType::MSG_PAIR_ACK:
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+            if (TeamLink* team = findTeamLink(mac)) {
+                if (team->awaitingAck) {
+                    team->awaitingAck = false;
+                    if (peerIndex >= 0) {
+                        peers[peerIndex].acked = true;
+                    }
+                    ILITE_LOG(DISCOVERY, LOG_INFO, "Team pair ack from %s", packet->id.customId);
+                }
+                return true;
+            }
             if (link.awaitingAck && macEqual(mac, link.peerMac)) {
-                Serial.println("[ESP-NOW] Pair ack received");
-                connectionLogAddf("Acked PAIR");
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Acked PAIR");
                 char ackLabel[24] = {};
                 macToString(mac, ackLabel, sizeof(ackLabel));
                 link.paired = true;
@@ -292,14 +437,14 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
                 if (index >= 0) {
                     peers[index].acked = true;
                     peers[index].lastSeen = now;
-                    peerCount = computePeerCount();
                 }
                 // Only disable discovery if continuous scanning is not enabled
                 if (!continuousScanning) {
                     discoveryEnabled = false;
                 }
-                audioFeedback(AudioCue::PeerAcknowledge);
-                connectionLogAddf("Pair ack from %s", ackLabel);
+                // handlePairing() plays the cue and selects the module
+                FrameworkEvents::postPairState(mac, true);
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Pair ack from %s", ackLabel);
                 return true;
             }
             return false;
@@ -311,12 +456,48 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
             // Keepalive message - just acknowledge receipt (lastSeen already updated above)
             return true;
 
+        case MessageType::MSG_PING:
+            // Echo right away so the round trip excludes module work
+            sendPong(mac, *packet, rxUs);
+            return true;
+
+        case MessageType::MSG_PONG:
+            LinkMetrics::onPong(mac, packet->reserved, packet->monotonicMs);
+            if (len >= static_cast<int>(sizeof(PongPacket)) && link.paired && macEqual(mac, link.peerMac)) {
+                const PongPacket* pong = reinterpret_cast<const PongPacket*>(incomingData);
+                ClockSync::onPong(mac, packet->monotonicMs, pong->pingRxUs, pong->pongTxUs, rxUs);
+            }
+            return true;
+
+        case MessageType::MSG_CHANNEL:
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLED
+            // Repeats only refresh the switch time; a move being verified is left alone
+            if (link.paired && macEqual(mac, link.peerMac) && channelMove.switchedMs == 0) {
+                scheduleChannelMove(static_cast<uint8_t>(packet->reserved), now + packet->monotonicMs);
+            }
+#endif
+            return true;
+
+        case MessageType::MSG_SLOT_BEACON:
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+            TdmaSlots::onBeacon(mac, packet->monotonicMs, packet->reserved, rxUs);
+#endif
+            return true;
+
+        case MessageType::MSG_RESUME:
+            handleResume(mac, *packet, now);
+            return true;
+
+        case MessageType::MSG_RESUME_ACK:
+            handleResumeAck(mac, *packet, now);
+            return true;
+
         case MessageType::MSG_COMMAND:
             if (len >= static_cast<int>(sizeof(CommandPacket))) {
                 const CommandPacket* cmd = reinterpret_cast<const CommandPacket*>(incomingData);
                 char commandLabel[24] = {};
                 macToString(mac, commandLabel, sizeof(commandLabel));
-                connectionLogAddf("Command from %s: %s", commandLabel, cmd->command);
+                ILITE_LOG(DISCOVERY, LOG_INFO, "Command from %s: %s", commandLabel, cmd->command);
                 if (commandCallback) {
                     char message[sizeof(cmd->command) + 1];
                     memcpy(message, cmd->command, sizeof(cmd->command));
@@ -324,7 +505,7 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
                     commandCallback(message);
                 }
             } else {
-                connectionLogAdd("Command packet truncated");
+                ILITE_LOG(DISCOVERY, LOG_WARN, "Command packet truncated");
             }
             return true;
     }
@@ -332,6 +513,37 @@ bool EspNowDiscovery::handleIncoming(const uint8_t* mac, const uint8_t* incoming
     return false;
 }
 
+void EspNowDiscovery::setReceiveTask(TaskHandle_t task) {
+    rxTask = task;
+    if (task != nullptr && rxRing.size() > 0) {
+        xTaskNotifyGive(task);
+    }
+}
+
+void EspNowDiscovery::notifyReceiveTask() {
+    TaskHandle_t task = rxTask;
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+size_t EspNowDiscovery::drainReceived(size_t maxFrames, void (*unhandled)(const RxFrame& frame)) {
+    size_t processed = 0;
+    while (processed < maxFrames) {
+        const RxFrame* frame = rxRing.front();
+        if (frame == nullptr) {
+            break;
+        }
+        if (!handleIncoming(frame->mac, frame->data, frame->length, frame->timestampUs) &&
+            unhandled != nullptr) {
+            unhandled(*frame);
+        }
+        rxRing.pop();
+        ++processed;
+    }
+    return processed;
+}
+
 bool EspNowDiscovery::hasPeers() const {
     return peerCount > 0;
 }
@@ -365,14 +577,290 @@ int EspNowDiscovery::findPeerIndex(const uint8_t* mac) const {
     if (!mac) {
         return -1;
     }
-    for (int i = 0; i < kMaxPeers; ++i) {
-        if (peers[i].inUse && macEqual(peers[i].mac, mac)) {
-            return i;
+    portENTER_CRITICAL(&peerLock);
+    const int index = lookupPeer(mac);
+    portEXIT_CRITICAL(&peerLock);
+    return index;
+}
+
+int EspNowDiscovery::lookupPeer(const uint8_t* mac) const {
+    // Caller holds peerLock
+    uint32_t slot = macHash(mac) & (kPeerMapSize - 1);
+    for (int probe = 0; probe < kPeerMapSize; ++probe) {
+        const int8_t index = peerMap[slot];
+        if (index == kSlotEmpty) {
+            return -1;
+        }
+        if (index >= 0 && macEqual(peers[index].mac, mac)) {
+            return index;
         }
+        slot = (slot + 1) & (kPeerMapSize - 1);
     }
     return -1;
 }
 
+int EspNowDiscovery::getRankedPeers(int firstRank, int8_t* indices, int maxCount) const {
+    if (!indices || firstRank < 0 || maxCount <= 0) {
+        return 0;
+    }
+    int copied = 0;
+    // Retry while the owner rewrites the order; a reader that keeps losing
+    // takes the last copy (every index in it still names a peer slot)
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint32_t before = rankVersion.load(std::memory_order_acquire);
+        copied = std::max(0, std::min(rankedCount - firstRank, maxCount));
+        memcpy(indices, rankedPeers + firstRank, copied);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((before & 1) == 0 && rankVersion.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    return copied;
+}
+
+int EspNowDiscovery::getPeerRank(int index) const {
+    if (index < 0 || index >= kMaxPeers) {
+        return -1;
+    }
+    return peerRanks[index];
+}
+
+int8_t EspNowDiscovery::getPeerRssi(int index) const {
+    if (index < 0 || index >= kMaxPeers || !peers[index].inUse) {
+        return kNoRssi;
+    }
+    return peers[index].rssiDbm;
+}
+
+// -----------------------------------------------------------------------------
+// Peer ranking
+// -----------------------------------------------------------------------------
+
+bool EspNowDiscovery::outranks(int a, int b) const {
+    const PeerEntry& pa = peers[a];
+    const PeerEntry& pb = peers[b];
+    if (pa.fading != pb.fading) {
+        return !pa.fading;
+    }
+    if (pa.rssiDbm != pb.rssiDbm) {
+        return pa.rssiDbm > pb.rssiDbm;
+    }
+    return static_cast<int16_t>(pa.discoveryOrder - pb.discoveryOrder) < 0;
+}
+
+void EspNowDiscovery::beginRankUpdate() {
+    rankVersion.store(rankVersion.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void EspNowDiscovery::endRankUpdate() {
+    rankVersion.store(rankVersion.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void EspNowDiscovery::siftRank(int index) {
+    // Insertion step: the rest of the order is sorted, so only `index` moves
+    int rank = peerRanks[index];
+    while (rank > 0 && outranks(index, rankedPeers[rank - 1])) {
+        rankedPeers[rank] = rankedPeers[rank - 1];
+        peerRanks[rankedPeers[rank]] = static_cast<int8_t>(rank);
+        --rank;
+    }
+    while (rank + 1 < rankedCount && outranks(rankedPeers[rank + 1], index)) {
+        rankedPeers[rank] = rankedPeers[rank + 1];
+        peerRanks[rankedPeers[rank]] = static_cast<int8_t>(rank);
+        ++rank;
+    }
+    rankedPeers[rank] = static_cast<int8_t>(index);
+    peerRanks[index] = static_cast<int8_t>(rank);
+}
+
+void EspNowDiscovery::rankInsert(int index) {
+    beginRankUpdate();
+    rankedPeers[rankedCount] = static_cast<int8_t>(index);
+    peerRanks[index] = static_cast<int8_t>(rankedCount);
+    ++rankedCount;
+    siftRank(index);
+    endRankUpdate();
+}
+
+void EspNowDiscovery::rankErase(int index) {
+    beginRankUpdate();
+    for (int rank = peerRanks[index]; rank + 1 < rankedCount; ++rank) {
+        rankedPeers[rank] = rankedPeers[rank + 1];
+        peerRanks[rankedPeers[rank]] = static_cast<int8_t>(rank);
+    }
+    --rankedCount;
+    peerRanks[index] = -1;
+    endRankUpdate();
+}
+
+void EspNowDiscovery::rankUpdate(int index) {
+    const int rank = peerRanks[index];
+    if ((rank > 0 && outranks(index, rankedPeers[rank - 1])) ||
+        (rank + 1 < rankedCount && outranks(rankedPeers[rank + 1], index))) {
+        beginRankUpdate();
+        siftRank(index);
+        endRankUpdate();
+    }
+}
+
+void EspNowDiscovery::refreshPeerRanks(uint32_t now) {
+    if (peerCount == 0 || now - lastRankRefreshMs < kRankRefreshMs) {
+        return;
+    }
+    lastRankRefreshMs = now;
+
+    for (int i = 0; i < kMaxPeers; ++i) {
+        PeerEntry& entry = peers[i];
+        if (!entry.inUse) {
+            continue;
+        }
+        int8_t rssi = entry.rssiDbm;
+        const LinkPeerStats* stats = LinkMetrics::find(entry.mac);
+        if (stats && stats->rssiSamples > 0) {
+            const int16_t measured = std::max<int16_t>(stats->rssiDbm, kNoRssi + 1);
+            if (rssi == kNoRssi || abs(measured - rssi) >= kRankRssiStepDb) {
+                rssi = static_cast<int8_t>(std::min<int16_t>(measured, 0));
+            }
+        }
+        portENTER_CRITICAL(&peerLock);
+        const bool fading = entry.inUse && now - entry.lastSeen > kRankFadingMs;
+        if (entry.inUse && (rssi != entry.rssiDbm || fading != entry.fading)) {
+            entry.rssiDbm = rssi;
+            entry.fading = fading;
+            rankUpdate(i);
+        }
+        portEXIT_CRITICAL(&peerLock);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Peer map
+// -----------------------------------------------------------------------------
+
+uint32_t EspNowDiscovery::macHash(const uint8_t* mac) {
+    // FNV-1a; the vendor prefix is often shared, so all six bytes are mixed
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 6; ++i) {
+        hash = (hash ^ mac[i]) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+uint32_t EspNowDiscovery::peerFilterBits(const uint8_t* mac, int word) {
+    // Two of 64 bits per MAC, from independent parts of the hash
+    const uint32_t hash = macHash(mac);
+    uint32_t bits = 0;
+    for (uint32_t bit : {hash & 63u, (hash >> 8) & 63u}) {
+        if (static_cast<int>(bit >> 5) == word) {
+            bits |= 1u << (bit & 31);
+        }
+    }
+    return bits;
+}
+
+bool EspNowDiscovery::acceptsFrame(const uint8_t* mac, const uint8_t* data, int len) const {
+    // Discovery packets from anyone: pairing and passive listening need them
+    if (len >= static_cast<int>(sizeof(Packet)) && data[0] == kProtocolVersion &&
+        data[1] >= static_cast<uint8_t>(MessageType::MSG_PAIR_REQ) &&
+        data[1] <= static_cast<uint8_t>(MessageType::MSG_RESUME_ACK)) {
+        return true;
+    }
+    if (hasTrainerPeer.load(std::memory_order_acquire) && macEqual(mac, trainerMac)) {
+        return true;
+    }
+    for (int word = 0; word < 2; ++word) {
+        const uint32_t bits = peerFilterBits(mac, word);
+        if ((peerFilter[word].load(std::memory_order_relaxed) & bits) != bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EspNowDiscovery::mapInsert(int index) {
+    for (int word = 0; word < 2; ++word) {
+        peerFilter[word].fetch_or(peerFilterBits(peers[index].mac, word), std::memory_order_relaxed);
+    }
+    mapPlace(index);
+}
+
+void EspNowDiscovery::mapPlace(int index) {
+    uint32_t slot = macHash(peers[index].mac) & (kPeerMapSize - 1);
+    while (peerMap[slot] >= 0) {
+        slot = (slot + 1) & (kPeerMapSize - 1);
+    }
+    if (peerMap[slot] == kSlotDeleted) {
+        --peerMapDeleted;
+    }
+    peerMap[slot] = static_cast<int8_t>(index);
+}
+
+void EspNowDiscovery::mapErase(int index) {
+    uint32_t slot = macHash(peers[index].mac) & (kPeerMapSize - 1);
+    for (int probe = 0; probe < kPeerMapSize; ++probe) {
+        if (peerMap[slot] == kSlotEmpty) {
+            return;
+        }
+        if (peerMap[slot] == index) {
+            peerMap[slot] = kSlotDeleted;
+            ++peerMapDeleted;
+            break;
+        }
+        slot = (slot + 1) & (kPeerMapSize - 1);
+    }
+
+    // Too many tombstones make misses probe the whole map; the filter is
+    // rebuilt either way, since a Bloom set cannot drop one MAC
+    if (peerMapDeleted > kPeerMapSize / 4) {
+        rebuildPeerMap(index);
+        return;
+    }
+    uint32_t filter[2] = {0, 0};
+    for (int i = 0; i < kMaxPeers; ++i) {
+        if (peers[i].inUse && i != index) {
+            filter[0] |= peerFilterBits(peers[i].mac, 0);
+            filter[1] |= peerFilterBits(peers[i].mac, 1);
+        }
+    }
+    peerFilter[0].store(filter[0], std::memory_order_relaxed);
+    peerFilter[1].store(filter[1], std::memory_order_relaxed);
+}
+
+void EspNowDiscovery::rebuildPeerMap(int except) {
+    // The receive callback reads the filter concurrently: build both words
+    // aside and store each once, so a present peer is never filtered out.
+    // `except` is the peer being erased, still marked in use.
+    memset(peerMap, kSlotEmpty, sizeof(peerMap));
+    peerMapDeleted = 0;
+    uint32_t filter[2] = {0, 0};
+    for (int i = 0; i < kMaxPeers; ++i) {
+        if (peers[i].inUse && i != except) {
+            filter[0] |= peerFilterBits(peers[i].mac, 0);
+            filter[1] |= peerFilterBits(peers[i].mac, 1);
+            mapPlace(i);
+        }
+    }
+    peerFilter[0].store(filter[0], std::memory_order_relaxed);
+    peerFilter[1].store(filter[1], std::memory_order_relaxed);
+}
+
+void EspNowDiscovery::clearPeers() {
+    portENTER_CRITICAL(&peerLock);
+    for (int i = 0; i < kMaxPeers; ++i) {
+        peers[i] = PeerEntry{};
+    }
+    peerCount = 0;
+    nextExpiryMs = 0;
+    rebuildPeerMap();
+
+    beginRankUpdate();
+    rankedCount = 0;
+    memset(peerRanks, -1, sizeof(peerRanks));
+    endRankUpdate();
+    portEXIT_CRITICAL(&peerLock);
+}
+
 void EspNowDiscovery::macToString(const uint8_t* mac, char* buffer, size_t bufferLen) {
     if (!buffer || bufferLen < 18) {
         return;
@@ -389,6 +877,25 @@ bool EspNowDiscovery::macEqual(const uint8_t* a, const uint8_t* b) {
     return a && b && memcmp(a, b, 6) == 0;
 }
 
+bool EspNowDiscovery::macFromString(const char* text, uint8_t* mac) {
+    if (!text || !mac) {
+        return false;
+    }
+    unsigned bytes[6];
+    char tail = '\0';
+    if (sscanf(text, "%x:%x:%x:%x:%x:%x%c", &bytes[0], &bytes[1], &bytes[2],
+               &bytes[3], &bytes[4], &bytes[5], &tail) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        if (bytes[i] > 0xFF) {
+            return false;
+        }
+        mac[i] = static_cast<uint8_t>(bytes[i]);
+    }
+    return true;
+}
+
 void EspNowDiscovery::fillSelfIdentity() {
     memset(&selfIdentity, 0, sizeof(selfIdentity));
 #if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
@@ -413,15 +920,17 @@ bool EspNowDiscovery::ensurePeer(const uint8_t* mac) const {
     peerInfo.encrypt = false;
     esp_err_t err = esp_now_add_peer(&peerInfo);
     if (err != ESP_OK) {
-        Serial.print("[ESP-NOW] Failed to add peer: ");
-        connectionLogAddf("[ESPN]Failed to add peer");
-        Serial.println(err);
+        ILITE_LOG(DISCOVERY, LOG_WARN, "Failed to add peer: %d", err);
         return false;
     }
     return true;
 }
 
 bool EspNowDiscovery::sendPacket(MessageType type, const uint8_t* mac) {
+    return sendPacket(type, mac, millis(), 0);
+}
+
+bool EspNowDiscovery::sendPacket(MessageType type, const uint8_t* mac, uint32_t stamp, uint32_t reserved) {
     if (!mac) {
         return false;
     }
@@ -432,23 +941,46 @@ bool EspNowDiscovery::sendPacket(MessageType type, const uint8_t* mac) {
     packet.id = selfIdentity;
     WiFi.macAddress(packet.id.mac);
     memcpy(selfIdentity.mac, packet.id.mac, sizeof(selfIdentity.mac));
-    packet.monotonicMs = millis();
-    memset(&packet.reserved, 0, sizeof(packet.reserved));
+    packet.monotonicMs = stamp;
+    packet.reserved = reserved;
+
+    return transmit(type, mac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
+}
+
+bool EspNowDiscovery::sendPong(const uint8_t* mac, const Packet& ping, uint32_t pingRxUs) {
+    if (!mac) {
+        return false;
+    }
 
+    PongPacket pong{};
+    pong.header.version = kProtocolVersion;
+    pong.header.type = MessageType::MSG_PONG;
+    pong.header.id = selfIdentity;
+    pong.header.monotonicMs = ping.monotonicMs;
+    pong.header.reserved = ping.reserved;
+    pong.pingRxUs = pingRxUs;
+    // Stamped last so the controller's delay excludes the time held here
+    pong.pongTxUs = static_cast<uint32_t>(esp_timer_get_time());
+
+    return transmit(MessageType::MSG_PONG, mac, reinterpret_cast<const uint8_t*>(&pong), sizeof(pong));
+}
+
+bool EspNowDiscovery::transmit(MessageType type, const uint8_t* mac, const uint8_t* frame, size_t size) {
     if (!macEqual(mac, kBroadcastMac)) {
         if (!ensurePeer(mac)) {
             return false;
         }
     }
 
-    esp_err_t err = esp_now_send(mac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
+    esp_err_t err = Transport::getActive().send(mac, frame, size);
     if (err != ESP_OK) {
-        Serial.print("[ESP-NOW] Send failed: ");
-        Serial.println(err);
-        connectionLogAddf("Send failed (%u): %d", static_cast<unsigned>(type), err);
+        ILITE_LOG_RATE(DISCOVERY, LOG_WARN, 1, 5, "Send failed (%u): %d", static_cast<unsigned>(type), err);
         return false;
     }
-    logTx(type, mac);
+    recordTx(type, size);
+    if (!isRoutineTraffic(type)) {
+        logTx(type, mac);
+    }
     return true;
 }
 
@@ -457,67 +989,116 @@ int EspNowDiscovery::upsertPeer(const Identity& id, const uint8_t* mac, uint32_t
         return -1;
     }
 
-    for (int i = 0; i < kMaxPeers; ++i) {
-        if (peers[i].inUse && macEqual(peers[i].mac, mac)) {
-            peers[i].identity = id;
-            memcpy(peers[i].mac, mac, 6);
-            peers[i].lastSeen = now;
-            peerCount = computePeerCount();
-            connectionLogAddf("Peer updated: %s", id.customId);
-            return i;
+    portENTER_CRITICAL(&peerLock);
+    const int existing = lookupPeer(mac);
+    if (existing >= 0) {
+        peers[existing].identity = id;
+        peers[existing].lastSeen = now;
+        if (peers[existing].fading) {
+            peers[existing].fading = false;
+            rankUpdate(existing);
         }
+        portEXIT_CRITICAL(&peerLock);
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Peer updated: %s", id.customId);
+        return existing;
     }
 
-    for (int i = 0; i < kMaxPeers; ++i) {
+    int claimed = -1;
+    for (int i = 0; peerCount < kMaxPeers && i < kMaxPeers; ++i) {
         if (!peers[i].inUse) {
+            if (peerCount == 0) {
+                nextExpiryMs = now + DEVICE_TTL_MS;
+            }
             peers[i].inUse = true;
             peers[i].identity = id;
             memcpy(peers[i].mac, mac, 6);
             peers[i].lastSeen = now;
             peers[i].confirmed = false;
             peers[i].acked = false;
-            peerCount = computePeerCount();
-            char label[24] = {};
-            macToString(mac, label, sizeof(label));
-            Serial.print("[ESP-NOW] Discovered peer: ");
-            Serial.print(id.customId);
-            Serial.print(" @ ");
-            Serial.println(label);
-            connectionLogAddf("Peer discovered: %s", id.customId);
-            return i;
+            peers[i].rssiDbm = kNoRssi;
+            peers[i].fading = false;
+            peers[i].discoveryOrder = nextDiscoveryOrder++;
+            mapInsert(i);
+            rankInsert(i);
+            ++peerCount;
+            claimed = i;
+            break;
         }
     }
+    portEXIT_CRITICAL(&peerLock);
 
-    Serial.println("[ESP-NOW] Peer table full");
-    connectionLogAdd("Peer table full");
-    return -1;
+    if (claimed < 0) {
+        ILITE_LOG(DISCOVERY, LOG_WARN, "Peer table full");
+        return -1;
+    }
+    discoveredSinceBroadcast = true;
+    char label[24] = {};
+    macToString(mac, label, sizeof(label));
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Peer discovered: %s @ %s", id.customId, label);
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+    FrameworkEvents::postPeerSeen(mac);
+#endif
+    return claimed;
 }
 
 void EspNowDiscovery::pruneExpiredPeers(uint32_t now) {
-    bool changed = false;
+    // Stale entries leave the table under the lock; the link and team
+    // bookkeeping and the log lines follow from a copy of their MACs
+    uint8_t staleMacs[kMaxPeers][6];
+    bool staleLink[kMaxPeers];
+    int staleCount = 0;
+
+    portENTER_CRITICAL(&peerLock);
+    if (peerCount == 0 || static_cast<int32_t>(now - nextExpiryMs) <= 0) {
+        portEXIT_CRITICAL(&peerLock);
+        return;
+    }
+
+    // Oldest lastSeen among the peers that remain
+    uint32_t oldestAge = 0;
     for (int i = 0; i < kMaxPeers; ++i) {
-        if (peers[i].inUse && now - peers[i].lastSeen > DEVICE_TTL_MS) {
-            char label[24] = {};
-            macToString(peers[i].mac, label, sizeof(label));
-            Serial.print("[ESP-NOW] Removing stale peer: ");
-            Serial.println(label);
-            if (link.peerIndex == i) {
-                resetLink();
+        if (!peers[i].inUse) {
+            continue;
+        }
+        const uint32_t age = now - peers[i].lastSeen;
+        if (age <= DEVICE_TTL_MS) {
+            if (age > oldestAge) {
+                oldestAge = age;
             }
-            peers[i] = PeerEntry{};
-            changed = true;
-            connectionLogAddf("Peer stale: %s", label);
+            continue;
         }
+
+        memcpy(staleMacs[staleCount], peers[i].mac, 6);
+        staleLink[staleCount] = link.peerIndex == i;
+        ++staleCount;
+        mapErase(i);
+        rankErase(i);
+        peers[i] = PeerEntry{};
+        --peerCount;
     }
-    if (changed) {
-        peerCount = computePeerCount();
+    nextExpiryMs = now + (DEVICE_TTL_MS - oldestAge);
+    portEXIT_CRITICAL(&peerLock);
+
+    for (int n = 0; n < staleCount; ++n) {
+        char label[24] = {};
+        macToString(staleMacs[n], label, sizeof(label));
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Removing stale peer: %s", label);
+        if (staleLink[n]) {
+            resetLink();
+        }
+        if (TeamLink* team = findTeamLink(staleMacs[n])) {
+            *team = TeamLink{};
+            ILITE_LOG(DISCOVERY, LOG_INFO, "Team link lost: %s", label);
+        }
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Peer stale: %s", label);
     }
 }
 
 int EspNowDiscovery::selectTarget() const {
     int fallback = -1;
     for (int i = 0; i < kMaxPeers; ++i) {
-        if (!peers[i].inUse) {
+        // Team peers are already driven; never make one the main link
+        if (!peers[i].inUse || isTeamLink(peers[i].mac)) {
             continue;
         }
         if (!peers[i].acked) {
@@ -531,24 +1112,356 @@ int EspNowDiscovery::selectTarget() const {
 }
 
 void EspNowDiscovery::resetLink() {
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+    if (link.paired) {
+        FrameworkEvents::postPairState(link.peerMac, false);
+    }
+#endif
     if (link.peerIndex >= 0 && link.peerIndex < kMaxPeers) {
         peers[link.peerIndex].acked = false;
         peers[link.peerIndex].confirmed = false;
     }
     link = LinkState{};
+    ClockSync::reset();
     discoveryEnabled = true;
     lastBroadcastMs = 0;
-    connectionLogAdd("Link reset");
+    resetBroadcastBackoff();
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Link reset");
 }
 
-int EspNowDiscovery::computePeerCount() const {
-    int count = 0;
-    for (int i = 0; i < kMaxPeers; ++i) {
-        if (peers[i].inUse) {
-            ++count;
+// -----------------------------------------------------------------------------
+// Session resume
+// -----------------------------------------------------------------------------
+
+uint32_t EspNowDiscovery::newSessionToken() {
+    uint32_t token = 0;
+    while (token == 0) {
+        token = esp_random();
+    }
+    return token;
+}
+
+void EspNowDiscovery::setSession(const uint8_t* mac, uint32_t token) {
+    if (mac == nullptr || token == 0) {
+        session = Session{};
+        return;
+    }
+    memcpy(session.mac, mac, sizeof(session.mac));
+    session.token = token;
+}
+
+bool EspNowDiscovery::resumeSession() {
+    if (session.token == 0 || link.paired || !ensurePeer(session.mac)) {
+        return false;
+    }
+    startResume(millis());
+    return true;
+}
+
+void EspNowDiscovery::startResume(uint32_t now) {
+    memcpy(link.peerMac, session.mac, sizeof(link.peerMac));
+    link.awaitingAck = true;
+    link.resuming = true;
+    link.resumeStartMs = now;
+    link.resumeRetryMs = kResumeRetryMs;
+    resume.attempts++;
+    char label[24] = {};
+    macToString(session.mac, label, sizeof(label));
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Resuming session with %s", label);
+    retryResume(now);
+}
+
+void EspNowDiscovery::retryResume(uint32_t now) {
+    sendPacket(MessageType::MSG_RESUME, session.mac, now, session.token);
+    link.lastConfirmSentMs = now;
+    link.resumeRetryMs = link.resumeRetryMs * 2 < kResumeMaxRetryMs ? link.resumeRetryMs * 2 : kResumeMaxRetryMs;
+}
+
+void EspNowDiscovery::handleResume(const uint8_t* mac, const Packet& packet, uint32_t now) {
+    // Paired elsewhere: not ours to answer
+    if (link.paired && !macEqual(mac, link.peerMac)) {
+        return;
+    }
+    if (!ensurePeer(mac)) {
+        return;
+    }
+    if (session.token == 0 || packet.reserved != session.token || !macEqual(mac, session.mac)) {
+        resume.refused++;
+        sendPacket(MessageType::MSG_RESUME_ACK, mac, now, 0);
+        return;
+    }
+    completeResume(mac, packet, now);
+    sendPacket(MessageType::MSG_RESUME_ACK, mac, now, session.token);
+}
+
+void EspNowDiscovery::handleResumeAck(const uint8_t* mac, const Packet& packet, uint32_t now) {
+    if (!link.resuming || !macEqual(mac, session.mac)) {
+        return;
+    }
+    if (packet.reserved != 0 && packet.reserved == session.token) {
+        resume.lastResumeMs = now - link.resumeStartMs;
+        completeResume(mac, packet, now);
+        return;
+    }
+
+    // The peer lost the session
+    resume.refused++;
+    link.resuming = false;
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+    // Confirm a new session at once instead of waiting for a broadcast
+    const int index = upsertPeer(packet.id, mac, now);
+    if (index >= 0) {
+        session.token = newSessionToken();
+        peers[index].confirmed = true;
+        peers[index].acked = false;
+        link.peerIndex = index;
+        link.lastConfirmSentMs = now;
+        sendPacket(MessageType::MSG_PAIR_CONFIRM, mac, now, session.token);
+    }
+#else
+    link.awaitingAck = false;
+    session = Session{};
+#endif
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Session refused, pairing again");
+}
+
+void EspNowDiscovery::completeResume(const uint8_t* mac, const Packet& packet, uint32_t now) {
+    const bool wasPaired = link.paired;
+    const int index = upsertPeer(packet.id, mac, now);
+    if (index >= 0) {
+        peers[index].confirmed = true;
+        peers[index].acked = true;
+        link.peerIndex = index;
+    }
+    link.paired = true;
+    memcpy(link.peerMac, mac, sizeof(link.peerMac));
+    link.lastActivityMs = now;
+    link.awaitingAck = false;
+    link.resuming = false;
+    resume.resumed++;
+    if (!wasPaired) {
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+        if (!continuousScanning) {
+            discoveryEnabled = false;
+        }
+        // handlePairing() plays the cue and selects the module
+        FrameworkEvents::postPairState(mac, true);
+#else
+        audioFeedback(AudioCue::PeerAcknowledge);
+#endif
+    }
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Session resumed with %s", packet.id.customId);
+}
+
+void EspNowDiscovery::dumpSession(Print& out) const {
+    char label[24] = {};
+    macToString(session.mac, label, sizeof(label));
+    if (session.token == 0) {
+        out.println("[Session] none");
+    } else {
+        out.printf("[Session] %s token %08lx%s\n", label, static_cast<unsigned long>(session.token),
+                   link.resuming ? " (resuming)" : "");
+    }
+    out.printf("[Session] %lu resumes started, %lu resumed, %lu refused, last %lu ms\n",
+               static_cast<unsigned long>(resume.attempts), static_cast<unsigned long>(resume.resumed),
+               static_cast<unsigned long>(resume.refused), static_cast<unsigned long>(resume.lastResumeMs));
+}
+
+bool EspNowDiscovery::sendSlotBeacon(uint32_t offsetUs, uint32_t info) {
+    return sendPacket(MessageType::MSG_SLOT_BEACON, kBroadcastMac, offsetUs, info);
+}
+
+void EspNowDiscovery::sendPing(uint32_t now) {
+    lastPingMs = now;
+    const uint32_t sequence = ++pingSequence;
+    const uint32_t stampUs = static_cast<uint32_t>(esp_timer_get_time());
+    if (sendPacket(MessageType::MSG_PING, link.peerMac, stampUs, sequence)) {
+        LinkMetrics::onPingSent(link.peerMac, sequence);
+    }
+}
+
+void EspNowDiscovery::resetBroadcastBackoff() {
+    broadcastIntervalMs = BROADCAST_MIN_INTERVAL_MS;
+    discoveredSinceBroadcast = false;
+}
+
+// -----------------------------------------------------------------------------
+// Channel moves
+// -----------------------------------------------------------------------------
+
+uint8_t EspNowDiscovery::getChannel() {
+    uint8_t primary = 0;
+    wifi_second_chan_t secondary = WIFI_SECOND_CHAN_NONE;
+    if (esp_wifi_get_channel(&primary, &secondary) != ESP_OK) {
+        return 0;
+    }
+    return primary;
+}
+
+bool EspNowDiscovery::setRadioChannel(uint8_t channel) {
+    if (channel < 1 || channel > kMaxWifiChannel || (WiFi.getMode() & WIFI_AP) != 0) {
+        return false;
+    }
+    const esp_err_t err = esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+    if (err != ESP_OK) {
+        ILITE_LOG(DISCOVERY, LOG_WARN, "Channel %u failed: %d", static_cast<unsigned>(channel), err);
+        return false;
+    }
+    return true;
+}
+
+bool EspNowDiscovery::requestChannelSwitch(uint8_t channel) {
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+    const uint8_t current = getChannel();
+    if (channel < 1 || channel > kMaxWifiChannel || channel == current || isChannelSwitchPending() ||
+        (WiFi.getMode() & WIFI_AP) != 0) {
+        return false;
+    }
+    if (!link.paired) {
+        // Nobody to take along
+        if (!setRadioChannel(channel)) {
+            return false;
+        }
+        channelSwitches++;
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Channel %u -> %u", static_cast<unsigned>(current),
+                  static_cast<unsigned>(channel));
+        return true;
+    }
+    const uint32_t now = millis();
+    scheduleChannelMove(channel, now + kChannelSwitchDelayMs);
+    announceChannel(now);
+    return true;
+#else
+    (void)channel;
+    return false;
+#endif
+}
+
+void EspNowDiscovery::scheduleChannelMove(uint8_t channel, uint32_t switchAtMs) {
+    if (channel < 1 || channel > kMaxWifiChannel) {
+        return;
+    }
+    if (channelMove.target == 0) {
+        channelMove.previous = getChannel();
+    }
+    channelMove.target = channel;
+    channelMove.switchAtMs = switchAtMs;
+}
+
+void EspNowDiscovery::announceChannel(uint32_t now) {
+    const int32_t remaining = static_cast<int32_t>(channelMove.switchAtMs - now);
+    const uint32_t delayMs = remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+    sendPacket(MessageType::MSG_CHANNEL, link.peerMac, delayMs, channelMove.target);
+    for (const TeamLink& team : teamLinks) {
+        if (team.inUse) {
+            sendPacket(MessageType::MSG_CHANNEL, team.mac, delayMs, channelMove.target);
         }
     }
-    return count;
+}
+
+void EspNowDiscovery::serviceChannel(uint32_t now) {
+    if (channelMove.target != 0) {
+        if (static_cast<int32_t>(now - channelMove.switchAtMs) < 0) {
+#if DEVICE_ROLE == DEVICE_ROLE_CONTROLLER
+            announceChannel(now);
+#endif
+            return;
+        }
+        const uint8_t target = channelMove.target;
+        channelMove.target = 0;
+        if (!link.paired || !setRadioChannel(target)) {
+            return;
+        }
+        channelMove.switchedMs = now;
+        channelMove.lastKeepaliveMs = 0;
+        channelSwitches++;
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Channel %u -> %u", static_cast<unsigned>(channelMove.previous),
+                  static_cast<unsigned>(target));
+    }
+
+    if (channelMove.switchedMs == 0) {
+        return;
+    }
+    if (!link.paired || static_cast<int32_t>(link.lastActivityMs - channelMove.switchedMs) > 0) {
+        channelMove.switchedMs = 0;     // Heard the peer (or lost it anyway)
+        return;
+    }
+    if (now - channelMove.switchedMs >= kChannelRecoverMs) {
+        channelMove.switchedMs = 0;
+        if (setRadioChannel(channelMove.previous)) {
+            channelReverts++;
+            ILITE_LOG(DISCOVERY, LOG_WARN, "Peer silent on the new channel, back to %u",
+                      static_cast<unsigned>(channelMove.previous));
+        }
+        return;
+    }
+    // Give the peer something to hear, whichever side switched last
+    if (channelMove.lastKeepaliveMs == 0 || now - channelMove.lastKeepaliveMs >= kChannelKeepaliveMs) {
+        sendPacket(MessageType::MSG_KEEPALIVE, link.peerMac);
+        channelMove.lastKeepaliveMs = now;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Airtime
+// -----------------------------------------------------------------------------
+
+uint32_t EspNowDiscovery::estimateAirtimeUs(size_t payloadBytes) {
+    // 1 bit per microsecond at 1 Mbit/s
+    return kLongPreambleUs + (static_cast<uint32_t>(payloadBytes) + kEspNowFrameOverhead) * 8;
+}
+
+void EspNowDiscovery::recordTx(MessageType type, size_t bytes) {
+    const size_t slot = static_cast<size_t>(type);
+    AirtimeStats& stats = airtime[slot < kAirtimeSlots ? slot : 0];
+    stats.txFrames++;
+    stats.txBytes += bytes;
+    stats.txAirUs += estimateAirtimeUs(bytes);
+}
+
+void EspNowDiscovery::recordRx(size_t slot, size_t bytes) {
+    AirtimeStats& stats = airtime[slot];
+    stats.rxFrames++;
+    stats.rxBytes += bytes;
+    stats.rxAirUs += estimateAirtimeUs(bytes);
+}
+
+const AirtimeStats& EspNowDiscovery::getAirtimeStats(size_t slot) const {
+    return airtime[slot < kAirtimeSlots ? slot : 0];
+}
+
+void EspNowDiscovery::resetAirtimeStats() {
+    for (AirtimeStats& stats : airtime) {
+        stats = AirtimeStats{};
+    }
+}
+
+void EspNowDiscovery::dumpAirtime(Print& out) const {
+    out.printf("[ESP-NOW] broadcast every %lu ms%s\n",
+               static_cast<unsigned long>(broadcastIntervalMs),
+               passiveListening ? " (passive, not broadcasting)" : "");
+    out.println("type        tx n   tx ms    rx n   rx ms");
+    for (size_t i = 0; i < kAirtimeSlots; ++i) {
+        const AirtimeStats& stats = airtime[i];
+        out.printf("%-10s %6lu %7lu %7lu %7lu\n",
+                   kAirtimeLabels[i],
+                   static_cast<unsigned long>(stats.txFrames),
+                   static_cast<unsigned long>(stats.txAirUs / 1000),
+                   static_cast<unsigned long>(stats.rxFrames),
+                   static_cast<unsigned long>(stats.rxAirUs / 1000));
+    }
+    char label[24] = {};
+    macToString(foreign.lastMac, label, sizeof(label));
+    out.printf("channel    %u (%lu switches, %lu reverts%s)\n",
+               static_cast<unsigned>(getChannel()),
+               static_cast<unsigned long>(channelSwitches),
+               static_cast<unsigned long>(channelReverts),
+               isChannelSwitchPending() ? ", switching" : "");
+    out.printf("foreign    %s %7lu %7lu (last %s)\n",
+               foreignFilter ? "dropped" : "    off",
+               static_cast<unsigned long>(foreign.frames),
+               static_cast<unsigned long>(foreign.airUs / 1000),
+               foreign.frames > 0 ? label : "-");
 }
 
 bool EspNowDiscovery::sendCommand(const uint8_t* mac, const char* command) {
@@ -569,23 +1482,23 @@ bool EspNowDiscovery::sendCommand(const uint8_t* mac, const char* command) {
 
     if (!macEqual(mac, kBroadcastMac)) {
         if (!ensurePeer(mac)) {
-            connectionLogAdd("Command target unavailable");
+            ILITE_LOG(DISCOVERY, LOG_WARN, "Command target unavailable");
             return false;
         }
     }
 
-    esp_err_t err = esp_now_send(mac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
+    esp_err_t err = Transport::getActive().send(mac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
     if (err != ESP_OK) {
-        Serial.print("[ESP-NOW] Command send failed: ");
-        Serial.println(err);
-        connectionLogAddf("Command send failed: %d", err);
+        ILITE_LOG(DISCOVERY, LOG_WARN, "Command send failed: %d", err);
         return false;
     }
 
+    recordTx(MessageType::MSG_COMMAND, sizeof(packet));
+
     char label[24] = {};
     macToString(mac, label, sizeof(label));
     logTx(MessageType::MSG_COMMAND, mac);
-    connectionLogAddf("Command sent to %s: %s", label, packet.command);
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Command sent to %s: %s", label, packet.command);
     return true;
 }
 
@@ -621,6 +1534,9 @@ uint32_t EspNowDiscovery::getLastActivityMs() const {
 }
 
 void EspNowDiscovery::setDiscoveryEnabled(bool enabled) {
+    if (enabled && !discoveryEnabled) {
+        resetBroadcastBackoff();
+    }
     discoveryEnabled = enabled;
     if (enabled && !link.paired) {
         lastBroadcastMs = 0;
@@ -632,14 +1548,27 @@ bool EspNowDiscovery::isDiscoveryEnabled() const {
 }
 
 void EspNowDiscovery::setContinuousScanning(bool enabled) {
+    if (enabled && !continuousScanning) {
+        resetBroadcastBackoff();
+        lastBroadcastMs = 0;
+    }
     continuousScanning = enabled;
-    Serial.printf("[ESP-NOW] Continuous scanning %s\n", enabled ? "enabled" : "disabled");
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Continuous scanning %s", enabled ? "enabled" : "disabled");
 }
 
 bool EspNowDiscovery::isContinuousScanning() const {
     return continuousScanning;
 }
 
+void EspNowDiscovery::setPassiveListening(bool enabled) {
+    if (!enabled && passiveListening) {
+        resetBroadcastBackoff();
+        lastBroadcastMs = 0;
+    }
+    passiveListening = enabled;
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Passive listening %s", enabled ? "enabled" : "disabled");
+}
+
 void EspNowDiscovery::setAutoPairEnabled(bool enabled) {
     autoPairingEnabled = enabled;
 }
@@ -670,17 +1599,163 @@ bool EspNowDiscovery::beginPairingWith(const uint8_t* mac) {
         return false;
     }
     uint32_t now = millis();
-    if (sendPacket(MessageType::MSG_PAIR_CONFIRM, mac)) {
+    // Retries keep the token the peer may already hold
+    if (!(link.awaitingAck && macEqual(mac, link.peerMac) && macEqual(mac, session.mac))) {
+        setSession(mac, newSessionToken());
+    }
+    if (sendPacket(MessageType::MSG_PAIR_CONFIRM, mac, now, session.token)) {
         peers[index].confirmed = true;
         peers[index].acked = false;
         link.peerIndex = index;
         link.awaitingAck = true;
         link.lastConfirmSentMs = now;
         memcpy(link.peerMac, mac, sizeof(link.peerMac));
-        Serial.print("[ESP-NOW] Sent confirm to ");
-        logMac("", mac);
-        connectionLogAddf("Pair confirm -> %s", peers[index].identity.customId);
+        ILITE_LOG(DISCOVERY, LOG_INFO, "Pair confirm -> %s", peers[index].identity.customId);
         return true;
     }
     return false;
 }
+
+bool EspNowDiscovery::restorePairing(const uint8_t* mac, const char* customId, uint32_t sessionToken) {
+    if (!mac || !ensurePeer(mac)) {
+        return false;
+    }
+    if (link.paired) {
+        resetLink();
+    }
+
+    Identity id{};
+    strncpy(id.customId, customId ? customId : "", sizeof(id.customId) - 1);
+    memcpy(id.mac, mac, sizeof(id.mac));
+    uint32_t now = millis();
+    int index = upsertPeer(id, mac, now);
+    if (index < 0) {
+        return false;
+    }
+
+    peers[index].confirmed = true;
+    peers[index].acked = true;
+    link.paired = true;
+    link.peerIndex = index;
+    memcpy(link.peerMac, mac, sizeof(link.peerMac));
+    link.lastActivityMs = now;
+
+    // With the cached session one resume exchange suffices; without, a new confirm
+    if (sessionToken != 0) {
+        setSession(mac, sessionToken);
+        startResume(now);
+    } else {
+        setSession(mac, newSessionToken());
+        link.lastConfirmSentMs = now;
+        link.awaitingAck = true;
+        sendPacket(MessageType::MSG_PAIR_CONFIRM, mac, now, session.token);
+    }
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Pairing restored: %s", id.customId);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Team links
+// -----------------------------------------------------------------------------
+
+bool EspNowDiscovery::addTeamLink(const uint8_t* mac) {
+    const int index = findPeerIndex(mac);
+    if (index < 0 || (link.paired && macEqual(mac, link.peerMac)) || !ensurePeer(mac)) {
+        return false;
+    }
+    TeamLink* team = findTeamLink(mac);
+    for (int i = 0; team == nullptr && i < kMaxTeamLinks; ++i) {
+        if (!teamLinks[i].inUse) {
+            team = &teamLinks[i];
+        }
+    }
+    if (team == nullptr) {
+        return false;
+    }
+
+    const uint32_t now = millis();
+    team->inUse = true;
+    memcpy(team->mac, mac, sizeof(team->mac));
+    team->awaitingAck = true;
+    team->lastConfirmSentMs = now;
+    team->lastKeepaliveMs = now;
+    peers[index].confirmed = true;
+    peers[index].acked = false;
+    sendPacket(MessageType::MSG_PAIR_CONFIRM, mac);
+    ILITE_LOG(DISCOVERY, LOG_INFO, "Team link -> %s", peers[index].identity.customId);
+    return true;
+}
+
+bool EspNowDiscovery::removeTeamLink(const uint8_t* mac) {
+    TeamLink* team = findTeamLink(mac);
+    if (team == nullptr) {
+        return false;
+    }
+    const int index = findPeerIndex(mac);
+    if (index >= 0) {
+        peers[index].confirmed = false;
+        peers[index].acked = false;
+    }
+    *team = TeamLink{};
+    return true;
+}
+
+bool EspNowDiscovery::isTeamLink(const uint8_t* mac) const {
+    return findTeamLink(mac) != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Trainer link
+// -----------------------------------------------------------------------------
+
+bool EspNowDiscovery::setTrainerPeer(const uint8_t* mac) {
+    // The receive callback only compares the MAC while the flag is set
+    hasTrainerPeer.store(false, std::memory_order_release);
+    if (mac == nullptr) {
+        return true;
+    }
+    if (!ensurePeer(mac)) {
+        return false;
+    }
+    memcpy(trainerMac, mac, sizeof(trainerMac));
+    hasTrainerPeer.store(true, std::memory_order_release);
+    return true;
+}
+
+const uint8_t* EspNowDiscovery::getTrainerPeer() const {
+    return hasTrainerPeer.load(std::memory_order_acquire) ? trainerMac : nullptr;
+}
+
+bool EspNowDiscovery::isTeamLinkAcked(const uint8_t* mac) const {
+    const TeamLink* team = findTeamLink(mac);
+    return team != nullptr && !team->awaitingAck;
+}
+
+EspNowDiscovery::TeamLink* EspNowDiscovery::findTeamLink(const uint8_t* mac) {
+    return const_cast<TeamLink*>(static_cast<const EspNowDiscovery*>(this)->findTeamLink(mac));
+}
+
+const EspNowDiscovery::TeamLink* EspNowDiscovery::findTeamLink(const uint8_t* mac) const {
+    for (const TeamLink& team : teamLinks) {
+        if (team.inUse && macEqual(team.mac, mac)) {
+            return &team;
+        }
+    }
+    return nullptr;
+}
+
+void EspNowDiscovery::serviceTeamLinks(uint32_t now) {
+    for (TeamLink& team : teamLinks) {
+        if (!team.inUse) {
+            continue;
+        }
+        if (team.awaitingAck && now - team.lastConfirmSentMs >= BROADCAST_INTERVAL_MS) {
+            sendPacket(MessageType::MSG_PAIR_CONFIRM, team.mac);
+            team.lastConfirmSentMs = now;
+        }
+        if (now - team.lastKeepaliveMs >= KEEPALIVE_INTERVAL_MS) {
+            sendPacket(MessageType::MSG_KEEPALIVE, team.mac);
+            team.lastKeepaliveMs = now;
+        }
+    }
+}
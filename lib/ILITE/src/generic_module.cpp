@@ -5,6 +5,7 @@
 
 #include "generic_module.h"
 #include "input.h"
+#include "InputManager.h"
 #include "display.h"
 #include "audio_feedback.h"
 #include <cstring>
@@ -22,7 +23,7 @@ GenericControlState genericState{};
 // ============================================================================
 
 extern byte displayMode;
-extern U8G2_SH1106_128X64_NONAME_F_HW_I2C oled;
+extern OledDisplay oled;
 
 // ============================================================================
 // Initialization
@@ -42,20 +43,21 @@ void initGenericState() {
 
 void updateGenericControl() {
     // Read all analog inputs (no processing, raw values)
-    genericCommand.joystickA_X = analogRead(joystickA_X);
-    genericCommand.joystickA_Y = analogRead(joystickA_Y);
-    genericCommand.joystickB_X = analogRead(joystickB_X);
-    genericCommand.joystickB_Y = analogRead(joystickB_Y);
-    genericCommand.potA = analogRead(potA);
-
-    // Pack button states into bitfield
+    genericCommand.joystickA_X = InputManager::getInstance().getJoystickA_X_Raw();
+    genericCommand.joystickA_Y = InputManager::getInstance().getJoystickA_Y_Raw();
+    genericCommand.joystickB_X = InputManager::getInstance().getJoystickB_X_Raw();
+    genericCommand.joystickB_Y = InputManager::getInstance().getJoystickB_Y_Raw();
+    genericCommand.potA = InputManager::getInstance().getPotentiometer_Raw();
+
+    // Pack button states into bitfield (same snapshot as the axes)
+    const InputManager& inputs = InputManager::getInstance();
     uint8_t buttons = 0;
-    if (digitalRead(button1) == LOW) buttons |= 0x08;
-    if (digitalRead(button2) == LOW) buttons |= 0x10;
-    if (digitalRead(button3) == LOW) buttons |= 0x20;
-    if (digitalRead(joystickBtnA) == LOW) buttons |= 0x02;
-    if (digitalRead(joystickBtnB) == LOW) buttons |= 0x04;
-    if (digitalRead(encoderBtn) == LOW) buttons |= 0x01;
+    if (inputs.getButton1()) buttons |= 0x08;
+    if (inputs.getButton2()) buttons |= 0x10;
+    if (inputs.getButton3()) buttons |= 0x20;
+    if (inputs.getJoystickButtonA()) buttons |= 0x02;
+    if (inputs.getJoystickButtonB()) buttons |= 0x04;
+    if (inputs.getEncoderButton()) buttons |= 0x01;
 
     genericCommand.buttons = buttons;
     genericCommand.reserved = 0;
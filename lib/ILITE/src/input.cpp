@@ -1,4 +1,5 @@
 #include "input.h"
+#include "EncoderSampler.h"
 
 volatile bool button1State = false;
 volatile bool button2State = false;
@@ -47,14 +48,6 @@ void IRAM_ATTR encoderBtnISR(){
   }
 }
 
-void IRAM_ATTR encoderClockISR(){
-  if(digitalRead(encoderB) == 1){
-    encoderCount++;
-  } else {
-    encoderCount--;
-  }
-}
-
 void initInput(){
   pinMode(encoderA, INPUT_PULLUP);
   pinMode(encoderB, INPUT_PULLUP);
@@ -74,7 +67,7 @@ void initInput(){
   // attachInterrupt(button1, button1ISR, FALLING);
   // attachInterrupt(button2, button2ISR, FALLING);
   // attachInterrupt(button3, button3ISR, FALLING);
-  attachInterrupt(encoderA, encoderClockISR, RISING);
+  EncoderSampler::getInstance().begin();
 }
 
 void checkPress(){
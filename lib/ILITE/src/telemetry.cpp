@@ -2,6 +2,7 @@
 #include "bulky.h"
 #include <string.h>
 #include <math.h>
+#include <new>
 
 ThrustCommand emission{PACKET_MAGIC, 1000, 0, 0, 0, false};
 receptionDataPacket reception{};
@@ -9,10 +10,7 @@ TelemetryPacket telemetry{};
 BulkyCommand bulkyCommand{0, 0, 0, {0, 0, 0}};
 uint8_t droneStabilizationMask = 0;
 bool droneStabilizationGlobal = false;
-int16_t pidCorrectionHistory[PID_AXIS_COUNT][screen_Width];
-int16_t pidActualHistory[PID_AXIS_COUNT][screen_Width];
-int16_t pidTargetHistory[PID_AXIS_COUNT][screen_Width];
-int16_t pidErrorHistory[PID_AXIS_COUNT][screen_Width];
+std::atomic<PidHistories*> pidHistories{nullptr};
 
 static inline int16_t clampToInt16(float value) {
   if (value > 32767.0f) return 32767;
@@ -23,11 +21,13 @@ static inline int16_t clampToInt16(float value) {
 void appendPidSample() {
   constexpr float kAngleScale = 100.0f;
 
-  for (int axis = 0; axis < PID_AXIS_COUNT; ++axis) {
-    memmove(pidCorrectionHistory[axis], pidCorrectionHistory[axis] + 1, (screen_Width - 1) * sizeof(int16_t));
-    memmove(pidActualHistory[axis],     pidActualHistory[axis]     + 1, (screen_Width - 1) * sizeof(int16_t));
-    memmove(pidTargetHistory[axis],     pidTargetHistory[axis]     + 1, (screen_Width - 1) * sizeof(int16_t));
-    memmove(pidErrorHistory[axis],      pidErrorHistory[axis]      + 1, (screen_Width - 1) * sizeof(int16_t));
+  PidHistories* histories = pidHistories.load(std::memory_order_relaxed);
+  if (histories == nullptr) {
+    histories = new (std::nothrow) PidHistories();
+    if (histories == nullptr) {
+      return;
+    }
+    pidHistories.store(histories, std::memory_order_release);
   }
 
   const float actual[PID_AXIS_COUNT] = { telemetry.pitch, telemetry.roll, telemetry.yaw };
@@ -42,9 +42,13 @@ void appendPidSample() {
     int16_t errorSample = clampToInt16(static_cast<float>(targetSample - actualSample));
     int16_t correctionSample = clampToInt16(roundf(correction[axis]));
 
-    pidActualHistory[axis][screen_Width - 1] = actualSample;
-    pidTargetHistory[axis][screen_Width - 1] = targetSample;
-    pidErrorHistory[axis][screen_Width - 1] = errorSample;
-    pidCorrectionHistory[axis][screen_Width - 1] = correctionSample;
+    histories->actual[axis].push(actualSample);
+    histories->target[axis].push(targetSample);
+    histories->error[axis].push(errorSample);
+    histories->correction[axis].push(correctionSample);
   }
 }
+
+void releasePidHistories() {
+  delete pidHistories.exchange(nullptr, std::memory_order_acq_rel);
+}
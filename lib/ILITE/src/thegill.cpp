@@ -3,9 +3,18 @@
 #include "ModuleRegistry.h"
 #include "AudioRegistry.h"
 #include "InputManager.h"
+#include "ControlShaping.h"
+#include "DriveMixer.h"
 #include "DisplayCanvas.h"
+#include "Wireframe3D.h"
 #include "InverseKinematics.h"
+#include "ReachabilityMap.h"
+#include "ArmTrajectory.h"
+#include "PoseRecorder.h"
+#include "StatusLed.h"
 #include "input.h"
+#include "LogChannels.h"
+#include "Profiler.h"
 #include <math.h>
 #include <cstring>
 
@@ -21,6 +30,15 @@ constexpr uint32_t kPeripheralIntervalMs = 120;
 constexpr uint32_t kConfigMinIntervalMs = 1000;
 constexpr uint32_t kArmStateRequestIntervalMs = 250;
 constexpr uint32_t kArmCommandMinIntervalMs = 40;
+constexpr uint32_t kArmStreamCommandIntervalMs = 250;  // Gripper/flag refresh while streaming
+// Arm command resolution and hysteresis; a band above half a step keeps a
+// resting stick from toggling between two steps
+constexpr float kArmAngleStepDeg = 0.5f;
+constexpr float kArmAngleBandDeg = 0.6f;
+constexpr float kArmExtensionStepMm = 1.0f;
+constexpr float kArmExtensionBandMm = 1.2f;
+constexpr float kArmGripperStep = 0.02f;
+constexpr float kArmGripperBand = 0.025f;
 constexpr float kDriveDeadzone = 0.05f;
 constexpr float kMaxWheelSpeedMmPerSec = 1200.0f;
 
@@ -63,27 +81,6 @@ SettingsPacket thegillSettingsPacket{
   ""
 };
 
-StatusPacket thegillStatusPacket{
-  THEGILL_STATUS_MAGIC,
-  {0, 0, 0, 0},
-  0,
-  {0, 0, 0},
-  0,
-  0,
-  0,
-  0
-};
-
-ArmStatePacket thegillArmStatePacket{
-  THEGILL_ARM_STATE_MAGIC,
-  0.0f,
-  0.0f,
-  {0.f, 0.f, 0.f, 0.f, 0.f},
-  0,
-  0,
-  0
-};
-
 ThegillConfig thegillConfig{
   GillDriveProfile::Tank,
   GillDriveEasing::None,
@@ -146,7 +143,14 @@ static uint32_t lastStatusPacketMs = 0;
 static uint32_t lastArmStatePacketMs = 0;
 static float lastLeftCommand = 0.0f;
 static float lastRightCommand = 0.0f;
+static ControlShaping::CurveTable driveCurve;
+// Skid steer; saturated turns scale both sides instead of clipping one
+static DriveMixer driveMixer(DriveMixer::Layout::Skid);
+constexpr size_t kWheelFrontLeft = 0;
+constexpr size_t kWheelFrontRight = 2;
 static bool armCommandDirty = false;
+static bool armTrajectoryEnabled = false;
+static ArmControlCommand lastStreamedArmCommand{};
 static uint8_t systemCommandLatch = 0;
 static MechIaneMode previousMode = MechIaneMode::DriveMode;
 static uint8_t frontLightDuty = 200;
@@ -261,6 +265,14 @@ ArmCameraView armCameraView = ArmCameraView::TopLeftCorner;
 IKEngine::Vec3 targetPosition{200.0f, 0.0f, 0.0f};    // Planar XY target in mm
 IKEngine::Vec3 targetOrientation{0.0f, 0.0f, 1.0f};   // Tool direction vector
 IKEngine::InverseKinematics ikSolver;
+// Jog front-end: cached while the sticks rest, incremental while they move
+static IKEngine::IncrementalSolver ikJogSolver(ikSolver);
+// Pose of the last arm-state packet, recomputed when a joint moves
+static IKEngine::ForwardCache armStateForward(ikSolver);
+// Workspace for the commanded extension; keeps jog targets on the envelope
+static IKEngine::ReachabilityMap armWorkspace;
+// Jerk-limited follower of armCommand's joints when streaming trajectories
+static ArmTrajectoryPlanner armPlanner;
 static bool gripperOpen = false;
 static bool orientationAnglesValid = false;
 static float orientationPitchRad = 0.0f;
@@ -273,7 +285,6 @@ static float manualBaseYawDeg = 0.0f;
 static float manualExtensionMm = 0.0f;
 static GripperControlTarget gripperTarget = GripperControlTarget::Both;
 static bool honkCommandActive = false;
-static uint32_t lastControlLoopMs = 0;
 
 static constexpr ArmCameraView kCameraSequence[] = {
     ArmCameraView::TopLeftCorner,
@@ -289,6 +300,59 @@ static constexpr ArmCameraView kCameraSequence[] = {
     ArmCameraView::RearQuarter
 };
 
+static int16_t quantizePose(float value, float scale) {
+    return static_cast<int16_t>(constrain(lroundf(value * scale), -32767L, 32767L));
+}
+
+static PoseRecorder::Frame captureArmPose() {
+    const float a = PoseRecorder::kAngleScale;
+    PoseRecorder::Frame frame;
+    frame.value[PoseRecorder::EXTENSION] = quantizePose(armCommand.extensionMillimeters, a);
+    frame.value[PoseRecorder::BASE] = quantizePose(armCommand.baseDegrees, a);
+    frame.value[PoseRecorder::SHOULDER] = quantizePose(armCommand.shoulderDegrees, a);
+    frame.value[PoseRecorder::ELBOW] = quantizePose(armCommand.elbowDegrees, a);
+    frame.value[PoseRecorder::PITCH] = quantizePose(armCommand.pitchDegrees, a);
+    frame.value[PoseRecorder::ROLL] = quantizePose(armCommand.rollDegrees, a);
+    frame.value[PoseRecorder::YAW] = quantizePose(armCommand.yawDegrees, a);
+    frame.value[PoseRecorder::GRIPPER1] = quantizePose(armCommand.gripper1Degrees, a);
+    frame.value[PoseRecorder::GRIPPER2] = quantizePose(armCommand.gripper2Degrees, a);
+    frame.value[PoseRecorder::TARGET_X] = quantizePose(targetPosition.x, PoseRecorder::kTargetScale);
+    frame.value[PoseRecorder::TARGET_Y] = quantizePose(targetPosition.y, PoseRecorder::kTargetScale);
+    return frame;
+}
+
+// Replayed poses replace the jog state so control resumes from them
+static void applyArmPose(const PoseRecorder::Frame& frame) {
+    const float a = 1.0f / PoseRecorder::kAngleScale;
+    armCommand.extensionMillimeters = frame.value[PoseRecorder::EXTENSION] * a;
+    armCommand.baseDegrees = frame.value[PoseRecorder::BASE] * a;
+    armCommand.shoulderDegrees = frame.value[PoseRecorder::SHOULDER] * a;
+    armCommand.elbowDegrees = frame.value[PoseRecorder::ELBOW] * a;
+    armCommand.pitchDegrees = frame.value[PoseRecorder::PITCH] * a;
+    armCommand.rollDegrees = frame.value[PoseRecorder::ROLL] * a;
+    armCommand.yawDegrees = frame.value[PoseRecorder::YAW] * a;
+    armCommand.gripper1Degrees = frame.value[PoseRecorder::GRIPPER1] * a;
+    armCommand.gripper2Degrees = frame.value[PoseRecorder::GRIPPER2] * a;
+    armCommand.validMask = ArmCommandMask::AllServos |
+                           ArmCommandMask::Extension |
+                           ArmCommandMask::Base |
+                           ArmCommandMask::AllGrippers;
+    armCommand.flags = ArmCommandFlag::EnableOutputs;
+    armCommandDirty = true;
+
+    targetPosition.x = frame.value[PoseRecorder::TARGET_X] / PoseRecorder::kTargetScale;
+    targetPosition.y = frame.value[PoseRecorder::TARGET_Y] / PoseRecorder::kTargetScale;
+    targetPosition.z = 0.0f;
+    manualBaseYawDeg = armCommand.baseDegrees;
+    manualExtensionMm = armCommand.extensionMillimeters;
+    manualPitchDeg = armCommand.pitchDegrees;
+    manualYawDeg = armCommand.yawDegrees;
+    manualRollDeg = armCommand.rollDegrees;
+    targetToolRollDeg = armCommand.rollDegrees;
+    orientationAnglesValid = false;
+    gripperOpen = armCommand.gripper1Degrees <= (kGripperNeutralDeg - 1.0f);
+}
+
 static void setDriveSpeedScalar(float value) {
     driveSpeedScalar = constrain(value, kMinDriveScale, kMaxDriveScale);
     thegillRuntime.driveSpeedScalar = driveSpeedScalar;
@@ -298,27 +362,6 @@ static void setArmSpeedScalar(float scalar) {
     armSpeedScalar = constrain(scalar, kMinArmSpeedScalar, kMaxArmSpeedScalar);
 }
 
-static IKEngine::Vec3 planarToWorld(float planarX, float planarY, float yawDeg) {
-    const float yawRad = yawDeg * DEG_TO_RAD;
-    const float cosYaw = cosf(yawRad);
-    const float sinYaw = sinf(yawRad);
-    return {
-        planarX * cosYaw,
-        planarY,
-        planarX * sinYaw
-    };
-}
-
-static void setPlanarTargetFromWorld(const IKEngine::Vec3& world, float yawDeg) {
-    const float yawRad = yawDeg * DEG_TO_RAD;
-    const float cosYaw = cosf(yawRad);
-    const float sinYaw = sinf(yawRad);
-    const float horizontal = world.x * cosYaw + world.z * sinYaw;
-    targetPosition.x = constrain(horizontal, 0.0f, 780.0f);
-    targetPosition.y = constrain(world.y, -780.0f, 780.0f);
-    targetPosition.z = 0.0f;
-}
-
 static void setPumpDuty(uint8_t duty) {
     duty = duty > kMaxPumpDuty ? kMaxPumpDuty : duty;
     if (updateByte(thegillPeripheralCommand.pumpDuty, duty)) {
@@ -394,6 +437,9 @@ static void applyPotValue(float potValue) {
         }
         case PotTarget::Led1: {
             uint8_t pwm = static_cast<uint8_t>(roundf(clamped * 255.0f));
+            if (pwm != thegillPeripheralCommand.ledPwm[0]) {
+                StatusLed::preview(pwm);    // Show the level being dialled
+            }
             setLedLevel(0, pwm);
             break;
         }
@@ -505,369 +551,593 @@ void cycleArmCameraView(int delta) {
 // TheGill Control Update (called at 50Hz)
 // ============================================================================
 
-void updateThegillControl() {
-    const InputManager& inputs = InputManager::getInstance();
-    const float potValue = inputs.getPotentiometer();
-    const uint32_t now = millis();
+// GillDriveEasing as a shared ControlShaping curve (SlewRate shapes nothing)
+static void syncDriveCurve() {
+    const float rate = constrain(thegillConfig.easingRate, 0.0f, 1.0f);
+    ControlShaping::Curve curve = ControlShaping::Curve::Linear;
+    float strength = 0.0f;
+    switch (thegillConfig.easing) {
+        case GillDriveEasing::Exponential: curve = ControlShaping::Curve::Power; strength = rate * 0.5f; break;
+        case GillDriveEasing::Sine: curve = ControlShaping::Curve::Sine; strength = rate; break;
+        case GillDriveEasing::EaseIn: curve = ControlShaping::Curve::Power; strength = rate; break;
+        case GillDriveEasing::EaseOut: curve = ControlShaping::Curve::EaseOut; strength = rate; break;
+        case GillDriveEasing::EaseInOut: curve = ControlShaping::Curve::Smoothstep; strength = rate; break;
+        case GillDriveEasing::None:
+        case GillDriveEasing::SlewRate:
+        default:
+            break;
+    }
+    driveCurve.rebuildIfChanged(curve, strength);
+}
+
+// ============================================================================
+// Control Pipeline
+// ============================================================================
+//
+// One control tick runs four stages, each a profiler zone:
+//   read       - sample buttons and shape the stick axes once
+//   intent     - mode switches, pot targets, drive commands, arm jog targets
+//   kinematics - workspace clamp and IK (skipped while its inputs hold),
+//                pose recorder and trajectory follower
+//   pack       - command flags and latches, runtime mirror, dirty marking
+
+namespace {
 
-    if (lastControlLoopMs == 0) {
-        lastControlLoopMs = now;
+struct ControlInputs {
+    float pot;
+    float joyAX;            // Shaped: deadzone and drive curve applied
+    float joyAY;
+    float joyBX;
+    float joyBY;
+    bool leftDown;
+    bool shiftDown;
+    bool rightDown;
+    bool leftPressed;
+    bool shiftPressed;
+    bool rightPressed;
+    bool joyBtnADown;
+    bool joyBtnBDown;
+    bool joyBtnAPressed;
+    bool joyBtnBPressed;
+};
+
+// Everything the workspace clamp and IK solve read
+struct KinematicsKey {
+    IKEngine::Vec3 target;
+    float extensionMm;
+    float baseYawDeg;
+    float toolRollDeg;
+    float pitchDeg;
+    float yawDeg;
+    float rollDeg;
+    uint32_t solverRevision;
+    uint32_t workspaceGeneration;
+    MechIaneMode mode;
+    bool extensionEnabled;
+
+    bool operator==(const KinematicsKey& other) const {
+        return target.x == other.target.x && target.y == other.target.y &&
+               target.z == other.target.z && extensionMm == other.extensionMm &&
+               baseYawDeg == other.baseYawDeg && toolRollDeg == other.toolRollDeg &&
+               pitchDeg == other.pitchDeg && yawDeg == other.yawDeg && rollDeg == other.rollDeg &&
+               solverRevision == other.solverRevision &&
+               workspaceGeneration == other.workspaceGeneration && mode == other.mode &&
+               extensionEnabled == other.extensionEnabled;
     }
-    float dt = (now - lastControlLoopMs) * 0.001f;
-    lastControlLoopMs = now;
-    if (dt < 0.0f) {
-        dt = 0.0f;
+};
+
+// What the solve wrote, replayed while the key holds
+struct KinematicsResult {
+    bool solved;
+    IKEngine::Vec3 target;  // After the workspace clamp
+    float shoulderDeg;
+    float elbowDeg;
+    float pitchDeg;
+    float rollDeg;
+    float yawDeg;
+};
+
+KinematicsKey kinematicsKey{};
+KinematicsResult kinematicsResult{};
+bool kinematicsCached = false;
+
+// Last solved pose that cleared the collision scene, with the base and
+// extension it was solved for
+struct ArmSafePose {
+    KinematicsResult result;
+    float baseYawDeg;
+    float extensionMm;
+};
+ArmSafePose armSafePose{};
+bool armSafePoseValid = false;
+bool armCollisionBlocked = false;
+float driveMagnitude = 0.0f;
+ArmControlCommand lastPackedArmCommand{};
+
+// Conditioners between armCommand and the packet, in ArmControlCommand order
+ControlShaping::Setpoint armSetpoints[] = {
+    {kArmExtensionStepMm, kArmExtensionBandMm},
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Base
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Shoulder
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Elbow
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Pitch
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Roll
+    {kArmAngleStepDeg, kArmAngleBandDeg},   // Yaw
+    {kArmGripperStep, kArmGripperBand},
+    {kArmGripperStep, kArmGripperBand}
+};
+
+}  // namespace
+
+static float shapeAxis(float value) {
+    const float v = (fabsf(value) < kDriveDeadzone) ? 0.0f : value;
+    return driveCurve.apply(constrain(v, -1.0f, 1.0f));
+}
+
+static float applySlew(float target, float previous) {
+    if (thegillConfig.easing != GillDriveEasing::SlewRate) {
+        return target;
     }
+    const float rate = constrain(thegillConfig.easingRate, 0.02f, 1.0f);
+    // Per tick: at most rate * 0.25 of full scale
+    return constrain(ControlShaping::slew(previous, target, rate * 0.25f, 1.0f), -1.0f, 1.0f);
+}
 
-    const bool shiftDown = inputs.getButton2();
-    const bool leftDown = inputs.getButton1();
-    const bool rightDown = inputs.getButton3();
-    const bool leftPressed = inputs.getButton1Pressed();
-    const bool rightPressed = inputs.getButton3Pressed();
-    const bool shiftPressed = inputs.getButton2Pressed();
-    const bool inDriveMode = (mechIaneMode == MechIaneMode::DriveMode);
+static void readControlInputs(const InputManager& inputs, ControlInputs& in) {
+    ILITE_PROFILE(ProfileZone::ControlRead);
+
+    in.pot = inputs.getPotentiometer();
+    in.leftDown = inputs.getButton1();
+    in.shiftDown = inputs.getButton2();
+    in.rightDown = inputs.getButton3();
+    in.leftPressed = inputs.getButton1Pressed();
+    in.shiftPressed = inputs.getButton2Pressed();
+    in.rightPressed = inputs.getButton3Pressed();
+    in.joyBtnADown = inputs.getJoystickButtonA();
+    in.joyBtnBDown = inputs.getJoystickButtonB();
+    in.joyBtnAPressed = inputs.getJoystickButtonA_Pressed();
+    in.joyBtnBPressed = inputs.getJoystickButtonB_Pressed();
+
+    // The table is rebuilt only when the easing setting changes
+    syncDriveCurve();
+    in.joyAX = shapeAxis(inputs.getJoystickA_X());
+    in.joyAY = shapeAxis(inputs.getJoystickA_Y());
+    in.joyBX = shapeAxis(inputs.getJoystickB_X());
+    in.joyBY = shapeAxis(inputs.getJoystickB_Y());
+}
+
+// Drive mode: hold a joystick button to set pump/light duty from the pot
+static bool updateHoldButtons(const ControlInputs& in, uint32_t now) {
+    const bool joyAState = in.joyBtnADown;
+    const bool joyBState = in.joyBtnBDown;
+    if (joyAState && !prevJoyAState) {
+        joyAPressMs = now;
+        joyALong = false;
+    }
+    if (joyBState && !prevJoyBState) {
+        joyBPressMs = now;
+        joyBLong = false;
+    }
+    if (joyAState && !joyALong && (now - joyAPressMs) >= kHoldThresholdMs) {
+        joyALong = true;
+        AudioRegistry::play("menu_select");
+    }
+    if (joyBState && !joyBLong && (now - joyBPressMs) >= kHoldThresholdMs) {
+        joyBLong = true;
+        AudioRegistry::play("menu_select");
+    }
+
+    if (!joyAState && prevJoyAState) {
+        if (joyALong) {
+            pumpDutySetting = static_cast<uint8_t>(roundf(constrain(in.pot, 0.0f, 1.0f) * 255.0f));
+            pumpEnabled = true;
+        } else {
+            pumpEnabled = !pumpEnabled;
+        }
+        setPumpDuty(pumpEnabled ? pumpDutySetting : 0);
+    }
+
+    if (!joyBState && prevJoyBState) {
+        if (joyBLong) {
+            frontLightDuty = static_cast<uint8_t>(roundf(constrain(in.pot, 0.0f, 1.0f) * 255.0f));
+            frontLightEnabled = true;
+        } else {
+            frontLightEnabled = !frontLightEnabled;
+        }
+        frontLightManual = true;
+        peripheralDirty = true;
+        StatusLed::preview(frontLightEnabled ? frontLightDuty : 0);
+    }
+
+    return (joyALong && joyAState) || (joyBLong && joyBState);
+}
+
+static void updateDriveIntent(const ControlInputs& in, float scalar) {
+    // Tank sticks are a body motion too: the mean drives, half the difference turns
+    DriveMixer::Motion motion{(in.joyAY + in.joyBY) * 0.5f, 0.0f, (in.joyAY - in.joyBY) * 0.5f};
+    if (thegillConfig.profile == GillDriveProfile::Differential) {
+        motion = {in.joyAY, 0.0f, in.joyAX};
+    }
+    motion.forward *= scalar;
+    motion.turn *= scalar;
+
+    float wheels[DriveMixer::kMaxWheels];
+    driveMixer.mix(motion, wheels);
+    float left = wheels[kWheelFrontLeft];
+    float right = wheels[kWheelFrontRight];
+
+    left = applySlew(left, lastLeftCommand);
+    right = applySlew(right, lastRightCommand);
+    lastLeftCommand = left;
+    lastRightCommand = right;
+
+    thegillCommand.leftFront = toWheelCommand(left);
+    thegillCommand.leftRear = toWheelCommand(left);
+    thegillCommand.rightFront = toWheelCommand(right);
+    thegillCommand.rightRear = toWheelCommand(right);
+
+    thegillRuntime.targetLeftFront = left;
+    thegillRuntime.targetLeftRear = left;
+    thegillRuntime.targetRightFront = right;
+    thegillRuntime.targetRightRear = right;
+
+    armCommand.validMask = 0;
+    armCommandDirty = false;
+    PoseRecorder::getInstance().stopPlayback();
+
+    driveMagnitude = fmaxf(fabsf(left), fabsf(right));
+    commandGrippers(0.0f);
+}
 
-    // Joystick button detection with beep feedback
-    const bool joyBtnAPressed = inputs.getJoystickButtonA_Pressed();
-    const bool joyBtnBPressed = inputs.getJoystickButtonB_Pressed();
-    const bool joyBtnAState = inputs.getJoystickButtonA();
-    const bool joyBtnBState = inputs.getJoystickButtonB();
+static void updateArmIntent(const ControlInputs& in, float scalar) {
+    thegillCommand.leftFront = 0;
+    thegillCommand.leftRear = 0;
+    thegillCommand.rightFront = 0;
+    thegillCommand.rightRear = 0;
+    driveMagnitude = 0.0f;
+
+    const auto& ikConfig = ikSolver.getConfiguration();
+    const float baseMin = fminf(ikConfig.baseYaw.minDeg, ikConfig.baseYaw.maxDeg);
+    const float baseMax = fmaxf(ikConfig.baseYaw.minDeg, ikConfig.baseYaw.maxDeg);
+    const float baseYawSpeed = 6.0f * scalar;
+    manualBaseYawDeg = constrain(manualBaseYawDeg + in.joyBX * baseYawSpeed, baseMin, baseMax);
+
+    if (mechIaneMode == MechIaneMode::ArmXYZ) {
+        const float positionSpeed = 9.0f * scalar;
+        targetPosition.x = constrain(targetPosition.x + in.joyAX * positionSpeed, 0.0f, 780.0f);
+        targetPosition.y = constrain(targetPosition.y + in.joyAY * positionSpeed, -780.0f, 780.0f);
+        targetPosition.z = 0.0f;
+
+        const float extensionSpeed = 8.0f * scalar;
+        const float extMin = fminf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
+        const float extMax = fmaxf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
+        manualExtensionMm = constrain(manualExtensionMm + in.joyBY * extensionSpeed, extMin, extMax);
+    } else {
+        if (!orientationAnglesValid) {
+            manualPitchDeg = constrain(armCommand.pitchDegrees, 0.0f, 180.0f);
+            manualYawDeg = constrain(armCommand.yawDegrees, 0.0f, 180.0f);
+            manualRollDeg = constrain(armCommand.rollDegrees, 0.0f, 180.0f);
+            targetToolRollDeg = manualRollDeg;
+            orientationPitchRad = (manualPitchDeg - 90.0f) * DEG_TO_RAD;
+            orientationYawRad = (manualYawDeg - 90.0f) * DEG_TO_RAD;
+            orientationAnglesValid = true;
+        }
+
+        const float orientSpeedDeg = 0.08f * RAD_TO_DEG * scalar;
+        const float rollSpeedDeg = 12.0f * scalar;
+
+        const float prevPitch = manualPitchDeg;
+        const float prevYaw = manualYawDeg;
+
+        manualPitchDeg = constrain(manualPitchDeg + in.joyAY * orientSpeedDeg, 5.0f, 175.0f);
+        manualYawDeg = constrain(manualYawDeg + in.joyAX * orientSpeedDeg, 0.0f, 180.0f);
+        manualRollDeg = constrain(manualRollDeg + in.joyBY * rollSpeedDeg, 0.0f, 180.0f);
+        targetToolRollDeg = manualRollDeg;
+
+        if (fabsf(manualPitchDeg - prevPitch) > 0.05f || fabsf(manualYawDeg - prevYaw) > 0.05f) {
+            ILITE_LOG(CONTROL, LOG_DEBUG, "Thegill orientation: pitch %.2f yaw %.2f roll %.2f deg (joyA %.2f, %.2f)",
+                      manualPitchDeg, manualYawDeg, manualRollDeg, in.joyAX, in.joyAY);
+        }
+
+        orientationPitchRad = (manualPitchDeg - 90.0f) * DEG_TO_RAD;
+        orientationYawRad = (manualYawDeg - 90.0f) * DEG_TO_RAD;
+        targetOrientation.x = cosf(orientationPitchRad) * cosf(orientationYawRad);
+        targetOrientation.y = cosf(orientationPitchRad) * sinf(orientationYawRad);
+        targetOrientation.z = sinf(orientationPitchRad);
+    }
+
+    float gripperCommandValue = 0.0f;
+    bool gripperOverride = false;
+    if (in.joyBtnADown && !in.joyBtnBDown) {
+        gripperCommandValue = 1.0f;
+        gripperOverride = true;
+    } else if (in.joyBtnBDown && !in.joyBtnADown) {
+        gripperCommandValue = -1.0f;
+        gripperOverride = true;
+    }
+    if (!gripperOverride && !in.shiftDown && (in.leftDown ^ in.rightDown)) {
+        gripperCommandValue = in.leftDown ? -1.0f : 1.0f;
+        gripperOverride = true;
+    }
+    if (!gripperOverride && gripperHoldEnabled && gripperHoldLatched) {
+        gripperCommandValue = 1.0f;
+        gripperOverride = true;
+    }
+    if (!gripperOverride) {
+        gripperCommandValue = 0.0f;
+    }
+    if (gripperHoldEnabled && gripperCommandValue > 0.5f) {
+        gripperHoldLatched = true;
+    } else if (gripperCommandValue < -0.1f) {
+        gripperHoldLatched = false;
+    }
+    commandGrippers(gripperCommandValue);
+}
+
+static void updateControlIntent(const ControlInputs& in, uint32_t now) {
+    ILITE_PROFILE(ProfileZone::ControlIntent);
+
+    const bool inDriveMode = (mechIaneMode == MechIaneMode::DriveMode);
 
     // Debug: Print raw button states periodically
     static uint32_t lastButtonDebugMs = 0;
     if ((now - lastButtonDebugMs) > 2000) {
-        Serial.printf("[Thegill Debug] JoyBtn A: %s (GPIO19), JoyBtn B: %s (GPIO13)\n",
-                      joyBtnAState ? "PRESSED" : "released",
-                      joyBtnBState ? "PRESSED" : "released");
+        ILITE_LOG(INPUTS, LOG_DEBUG, "Thegill: JoyBtn A %s (GPIO19), JoyBtn B %s (GPIO13)",
+                  in.joyBtnADown ? "pressed" : "released",
+                  in.joyBtnBDown ? "pressed" : "released");
         lastButtonDebugMs = now;
     }
 
-    if (joyBtnAPressed) {
+    if (in.joyBtnAPressed) {
         AudioRegistry::play("menu_select");
-        Serial.println("[Thegill] *** Joystick A button PRESSED EVENT ***");
+        ILITE_LOG(INPUTS, LOG_DEBUG, "Thegill: joystick A button pressed");
     }
 
-    if (joyBtnBPressed) {
+    if (in.joyBtnBPressed) {
         AudioRegistry::play("menu_select");
-        Serial.println("[Thegill] *** Joystick B button PRESSED EVENT ***");
+        ILITE_LOG(INPUTS, LOG_DEBUG, "Thegill: joystick B button pressed");
     }
 
-    if (!inDriveMode) {
-        potTarget = PotTarget::ArmSpeed;
-    } else {
-        potTarget = PotTarget::DriveSpeed;
-    }
+    potTarget = inDriveMode ? PotTarget::DriveSpeed : PotTarget::ArmSpeed;
 
     // Mode toggles
-    if (rightPressed) {
+    if (in.rightPressed) {
         mechIaneMode = inDriveMode ? MechIaneMode::ArmXYZ : MechIaneMode::DriveMode;
         potTarget = (mechIaneMode == MechIaneMode::DriveMode) ? PotTarget::DriveSpeed : PotTarget::ArmSpeed;
         AudioRegistry::play("menu_select");
-    } else if (!inDriveMode && shiftPressed && !leftDown && !rightDown) {
+    } else if (!inDriveMode && in.shiftPressed && !in.leftDown && !in.rightDown) {
         mechIaneMode = (mechIaneMode == MechIaneMode::ArmXYZ) ? MechIaneMode::ArmOrientation : MechIaneMode::ArmXYZ;
         potTarget = PotTarget::ArmSpeed;
         requestOrientationRetarget();
         AudioRegistry::play("menu_select");
     }
 
-    if (!inDriveMode && leftPressed) {
+    if (!inDriveMode && in.leftPressed) {
         gripperHoldEnabled = !gripperHoldEnabled;
         gripperHoldLatched = false;
         AudioRegistry::play(gripperHoldEnabled ? "startup" : "menu_back");
     }
 
-    // Drive-mode button handling for pump/lights with hold-to-set-pot
     bool potLocked = false;
     if (inDriveMode) {
-        if (joyAState && !prevJoyAState) {
-            joyAPressMs = now;
-            joyALong = false;
-        }
-        if (joyBState && !prevJoyBState) {
-            joyBPressMs = now;
-            joyBLong = false;
-        }
-        if (joyAState && !joyALong && (now - joyAPressMs) >= kHoldThresholdMs) {
-            joyALong = true;
-            AudioRegistry::play("menu_select");
-        }
-        if (joyBState && !joyBLong && (now - joyBPressMs) >= kHoldThresholdMs) {
-            joyBLong = true;
-            AudioRegistry::play("menu_select");
-        }
-
-        if (!joyAState && prevJoyAState) {
-            if (joyALong) {
-                pumpDutySetting = static_cast<uint8_t>(roundf(constrain(potValue, 0.0f, 1.0f) * 255.0f));
-                pumpEnabled = true;
-            } else {
-                pumpEnabled = !pumpEnabled;
-            }
-            setPumpDuty(pumpEnabled ? pumpDutySetting : 0);
-        }
-
-        if (!joyBState && prevJoyBState) {
-            if (joyBLong) {
-                frontLightDuty = static_cast<uint8_t>(roundf(constrain(potValue, 0.0f, 1.0f) * 255.0f));
-                frontLightEnabled = true;
-            } else {
-                frontLightEnabled = !frontLightEnabled;
-            }
-            frontLightManual = true;
-            peripheralDirty = true;
-        }
-
-        potLocked = (joyALong && joyAState) || (joyBLong && joyBState);
+        potLocked = updateHoldButtons(in, now);
     } else {
         joyALong = joyBLong = false;
     }
-    prevJoyAState = joyAState;
-    prevJoyBState = joyBState;
+    prevJoyAState = in.joyBtnADown;
+    prevJoyBState = in.joyBtnBDown;
 
     if (!potLocked) {
-        applyPotValue(potValue);
+        applyPotValue(in.pot);
     }
 
-    const float precisionScalar = precisionMode ? 0.45f : 1.0f;
-    const float adaptiveScalar = driveSpeedScalar * precisionScalar;
-    const float armControlScalar = armSpeedScalar * precisionScalar;
-
     if (previousMode == MechIaneMode::DriveMode && mechIaneMode != MechIaneMode::DriveMode) {
         forceArmStateResync();
     }
     previousMode = mechIaneMode;
 
-    auto shapeAxis = [](float value) {
-        float v = (fabsf(value) < kDriveDeadzone) ? 0.0f : value;
-        float rate = constrain(thegillConfig.easingRate, 0.0f, 1.0f);
-        float sign = copysignf(1.0f, v);
-        float mag = fabsf(v);
-
-        switch (thegillConfig.easing) {
-            case GillDriveEasing::Exponential: {
-                const float power = 1.0f + rate * 1.5f;
-                mag = powf(mag, power);
-                break;
-            }
-            case GillDriveEasing::Sine: {
-                float shaped = sinf(mag * HALF_PI);
-                mag = (1.0f - rate) * mag + rate * shaped;
-                break;
-            }
-            case GillDriveEasing::EaseIn: {
-                float power = 1.0f + rate * 3.0f;
-                mag = powf(mag, power);
-                break;
-            }
-            case GillDriveEasing::EaseOut: {
-                float power = 1.0f + rate * 3.0f;
-                mag = 1.0f - powf(1.0f - mag, power);
-                break;
-            }
-            case GillDriveEasing::EaseInOut: {
-                float shaped = mag * mag * (3.0f - 2.0f * mag); // smoothstep
-                mag = (1.0f - rate) * mag + rate * shaped;
-                break;
-            }
-            case GillDriveEasing::None:
-            case GillDriveEasing::SlewRate:
-            default:
-                break;
-        }
-
-        v = constrain(sign * mag, -1.0f, 1.0f);
-        return v;
-    };
-
-    auto applySlew = [](float target, float previous) {
-        if (thegillConfig.easing != GillDriveEasing::SlewRate) {
-            return target;
-        }
-        const float rate = constrain(thegillConfig.easingRate, 0.02f, 1.0f);
-        const float maxDelta = rate * 0.25f;
-        float delta = target - previous;
-        if (delta > maxDelta) delta = maxDelta;
-        if (delta < -maxDelta) delta = -maxDelta;
-        return constrain(previous + delta, -1.0f, 1.0f);
-    };
-
+    const float precisionScalar = precisionMode ? 0.45f : 1.0f;
     if (inDriveMode) {
-        float left = shapeAxis(inputs.getJoystickA_Y());
-        float right = shapeAxis(inputs.getJoystickB_Y());
-
-        if (thegillConfig.profile == GillDriveProfile::Differential) {
-            const float throttle = shapeAxis(inputs.getJoystickA_Y());
-            const float turn = shapeAxis(inputs.getJoystickA_X());
-            left = throttle + turn;
-            right = throttle - turn;
-        }
+        updateDriveIntent(in, driveSpeedScalar * precisionScalar);
+    } else {
+        updateArmIntent(in, armSpeedScalar * precisionScalar);
+    }
 
-        left = constrain(left * adaptiveScalar, -1.0f, 1.0f);
-        right = constrain(right * adaptiveScalar, -1.0f, 1.0f);
+    honkCommandActive = inDriveMode && in.shiftDown && !in.leftDown && !in.rightDown;
+}
 
-        left = applySlew(left, lastLeftCommand);
-        right = applySlew(right, lastRightCommand);
-        lastLeftCommand = left;
-        lastRightCommand = right;
+static void applyKinematicsResult(const KinematicsResult& result) {
+    targetPosition = result.target;
+    armCommand.flags = ArmCommandFlag::EnableOutputs;
+    if (!result.solved) {
+        armCommand.validMask = ArmCommandMask::Extension |
+                               ArmCommandMask::Base |
+                               ArmCommandMask::AllGrippers;
+        return;
+    }
+    armCommand.shoulderDegrees = result.shoulderDeg;
+    armCommand.elbowDegrees = result.elbowDeg;
+    armCommand.pitchDegrees = result.pitchDeg;
+    armCommand.rollDegrees = result.rollDeg;
+    armCommand.yawDegrees = result.yawDeg;
+    armCommand.validMask = ArmCommandMask::AllServos |
+                           ArmCommandMask::Extension |
+                           ArmCommandMask::Base |
+                           ArmCommandMask::AllGrippers;
 
-        thegillCommand.leftFront = toWheelCommand(left);
-        thegillCommand.leftRear = toWheelCommand(left);
-        thegillCommand.rightFront = toWheelCommand(right);
-        thegillCommand.rightRear = toWheelCommand(right);
+    manualPitchDeg = armCommand.pitchDegrees;
+    manualYawDeg = armCommand.yawDegrees;
+    manualRollDeg = armCommand.rollDegrees;
+}
 
-        thegillRuntime.targetLeftFront = left;
-        thegillRuntime.targetLeftRear = left;
-        thegillRuntime.targetRightFront = right;
-        thegillRuntime.targetRightRear = right;
+// Solver frame: +X forward, +Y left, +Z up, origin at the shoulder pivot.
+// Rough envelope of the rover around the arm; link radii include the servo
+// horns and the gripper jaws.
+static const char* const kArmLinkNames[IKEngine::InverseKinematics::kCollisionJoints - 1] = {
+    "upper arm", "forearm", "gripper"
+};
 
-        armCommand.validMask = 0;
-        armCommandDirty = false;
+static const Kinematics::CollisionScene& armCollisionScene() {
+    static Kinematics::CollisionScene scene;
+    static bool built = false;
+    if (!built) {
+        scene.setLinkRadius(0, 20.0f);     // Upper arm
+        scene.setLinkRadius(1, 16.0f);     // Forearm and extension
+        scene.setLinkRadius(2, 25.0f);     // Gripper
+        scene.addBox({{-50.0f, -50.0f, -90.0f}, {50.0f, 50.0f, 0.0f}, "turret", 0x01});
+        scene.addBox({{-220.0f, -160.0f, -260.0f}, {220.0f, 160.0f, -90.0f}, "chassis", 0});
+        scene.addBox({{-170.0f, -25.0f, -90.0f}, {-130.0f, 25.0f, 200.0f}, "camera mast", 0});
+        built = true;
+    }
+    return scene;
+}
 
-        refreshPeripheralState(fmaxf(fabsf(left), fabsf(right)));
-        commandGrippers(0.0f);
-    } else {
-        thegillCommand.leftFront = 0;
-        thegillCommand.leftRear = 0;
-        thegillCommand.rightFront = 0;
-        thegillCommand.rightRear = 0;
-
-        const float joyAX = shapeAxis(inputs.getJoystickA_X());
-        const float joyAY = shapeAxis(inputs.getJoystickA_Y());
-        const float joyBX = shapeAxis(inputs.getJoystickB_X());
-        const float joyBY = shapeAxis(inputs.getJoystickB_Y());
-
-        const auto& ikConfig = ikSolver.getConfiguration();
-        const float baseMin = fminf(ikConfig.baseYaw.minDeg, ikConfig.baseYaw.maxDeg);
-        const float baseMax = fmaxf(ikConfig.baseYaw.minDeg, ikConfig.baseYaw.maxDeg);
-        const float baseYawSpeed = 6.0f * armControlScalar;
-        manualBaseYawDeg = constrain(manualBaseYawDeg + joyBX * baseYawSpeed, baseMin, baseMax);
-
-        if (mechIaneMode == MechIaneMode::ArmXYZ) {
-            const float positionSpeed = 9.0f * armControlScalar;
-            targetPosition.x = constrain(targetPosition.x + joyAX * positionSpeed, 0.0f, 780.0f);
-            targetPosition.y = constrain(targetPosition.y + joyAY * positionSpeed, -780.0f, 780.0f);
-            targetPosition.z = 0.0f;
-
-            const float extensionSpeed = 8.0f * armControlScalar;
-            const float extMin = fminf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
-            const float extMax = fmaxf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
-            manualExtensionMm = constrain(manualExtensionMm + joyBY * extensionSpeed, extMin, extMax);
-        } else {
-            if (!orientationAnglesValid) {
-                manualPitchDeg = constrain(armCommand.pitchDegrees, 0.0f, 180.0f);
-                manualYawDeg = constrain(armCommand.yawDegrees, 0.0f, 180.0f);
-                manualRollDeg = constrain(armCommand.rollDegrees, 0.0f, 180.0f);
-                targetToolRollDeg = manualRollDeg;
-                orientationPitchRad = (manualPitchDeg - 90.0f) * DEG_TO_RAD;
-                orientationYawRad = (manualYawDeg - 90.0f) * DEG_TO_RAD;
-                orientationAnglesValid = true;
-            }
+static Kinematics::CollisionHit checkArmCollision(const IKEngine::IKSolution& solution, float baseYawDeg) {
+    const IKEngine::ArmPose pose = ikSolver.forwardPlanar(solution.joints.shoulderDeg,
+                                                          solution.joints.elbowDeg,
+                                                          solution.joints.elbowExtensionMm);
+    IKEngine::Vec3 chain[IKEngine::InverseKinematics::kCollisionJoints];
+    ikSolver.collisionChain(pose, baseYawDeg, chain);
+    return armCollisionScene().check(chain, IKEngine::InverseKinematics::kCollisionJoints);
+}
 
-            const float orientSpeedDeg = 0.08f * RAD_TO_DEG * armControlScalar;
-            const float rollSpeedDeg = 12.0f * armControlScalar;
+static void solveArmKinematics(uint32_t now) {
+    const auto& ikConfig = ikSolver.getConfiguration();
+    const float extMin = fminf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
+    const float extMax = fmaxf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
+    manualExtensionMm = constrain(manualExtensionMm, extMin, extMax);
+    const float commandedExtension = extensionEnabled ? manualExtensionMm : 0.0f;
 
-            const float prevPitch = manualPitchDeg;
-            const float prevYaw = manualYawDeg;
+    armCommand.baseDegrees = manualBaseYawDeg;
+    armCommand.extensionMillimeters = commandedExtension;
+    ikSolver.setExtensionEnabled(extensionEnabled);
+    // Always stepped: a rebuild in progress samples a few rows per tick
+    const bool workspaceReady = armWorkspace.update(ikSolver, commandedExtension);
+
+    const KinematicsKey key{targetPosition, commandedExtension, manualBaseYawDeg, targetToolRollDeg,
+                            manualPitchDeg, manualYawDeg, manualRollDeg, ikSolver.getRevision(),
+                            armWorkspace.getGeneration(), mechIaneMode, extensionEnabled};
+    if (kinematicsCached && key == kinematicsKey) {
+        applyKinematicsResult(kinematicsResult);
+        return;
+    }
 
-            manualPitchDeg = constrain(manualPitchDeg + joyAY * orientSpeedDeg, 5.0f, 175.0f);
-            manualYawDeg = constrain(manualYawDeg + joyAX * orientSpeedDeg, 0.0f, 180.0f);
-            manualRollDeg = constrain(manualRollDeg + joyBY * rollSpeedDeg, 0.0f, 180.0f);
-            targetToolRollDeg = manualRollDeg;
+    KinematicsResult result{};
+    result.target = workspaceReady ? armWorkspace.clamp(targetPosition) : targetPosition;
+    IKEngine::IKSolution solution;
+    result.solved = ikJogSolver.solvePlanar(result.target, commandedExtension, solution);
+    if (result.solved) {
+        result.shoulderDeg = solution.joints.shoulderDeg;
+        result.elbowDeg = solution.joints.elbowDeg;
+        if (mechIaneMode == MechIaneMode::ArmOrientation) {
+            result.pitchDeg = manualPitchDeg;
+            result.rollDeg = manualRollDeg;
+            result.yawDeg = manualYawDeg;
+        } else {
+            result.pitchDeg = solution.joints.gripperPitchDeg;
+            result.rollDeg = targetToolRollDeg;
+            result.yawDeg = solution.joints.gripperYawDeg;
+        }
+    }
 
-            if (fabsf(manualPitchDeg - prevPitch) > 0.05f || fabsf(manualYawDeg - prevYaw) > 0.05f) {
-                Serial.printf("[Thegill Orientation] Pitch: %.2f deg, Yaw: %.2f deg, Roll: %.2f deg (joyAX: %.2f, joyAY: %.2f)\n",
-                              manualPitchDeg, manualYawDeg, manualRollDeg, joyAX, joyAY);
+    // Only the solved pose is checked; a pose that hits the robot or itself
+    // falls back to the last clear one, so the jog stops at the obstacle
+    bool blocked = false;
+    if (result.solved) {
+        const Kinematics::CollisionHit hit = checkArmCollision(solution, manualBaseYawDeg);
+        if (!hit) {
+            armSafePose = ArmSafePose{result, manualBaseYawDeg, commandedExtension};
+            armSafePoseValid = true;
+        } else {
+            blocked = true;
+            ILITE_LOG_RATE(CONTROL, LOG_WARN, 1, 2, "Thegill arm: %s would hit the %s",
+                           kArmLinkNames[hit.link],
+                           hit.kind == Kinematics::CollisionKind::Self
+                               ? kArmLinkNames[hit.other]
+                               : armCollisionScene().getBox(hit.other).name);
+            if (armSafePoseValid) {
+                result = armSafePose.result;
+                manualBaseYawDeg = armSafePose.baseYawDeg;
+                manualExtensionMm = armSafePose.extensionMm;
+                armCommand.baseDegrees = manualBaseYawDeg;
+                armCommand.extensionMillimeters = extensionEnabled ? manualExtensionMm : 0.0f;
+            } else {
+                result.solved = false;  // Hold the servos where they are
             }
-
-            orientationPitchRad = (manualPitchDeg - 90.0f) * DEG_TO_RAD;
-            orientationYawRad = (manualYawDeg - 90.0f) * DEG_TO_RAD;
-            targetOrientation.x = cosf(orientationPitchRad) * cosf(orientationYawRad);
-            targetOrientation.y = cosf(orientationPitchRad) * sinf(orientationYawRad);
-            targetOrientation.z = sinf(orientationPitchRad);
         }
+    }
+    armCollisionBlocked = blocked;
+
+    applyKinematicsResult(result);
+    kinematicsKey = key;
+    kinematicsResult = result;
+    kinematicsCached = !blocked;
+
+    // Debug: Log arm command when in orientation mode
+    static uint32_t lastDebugPrintMs = 0;
+    if (result.solved && mechIaneMode == MechIaneMode::ArmOrientation && (now - lastDebugPrintMs) > 500) {
+        ILITE_LOG(CONTROL, LOG_DEBUG, "Thegill arm: pitch %.1f yaw %.1f roll %.1f | shoulder %.1f elbow %.1f deg",
+                  armCommand.pitchDegrees, armCommand.yawDegrees, armCommand.rollDegrees,
+                  armCommand.shoulderDegrees, armCommand.elbowDegrees);
+        lastDebugPrintMs = now;
+    }
+}
 
-        float gripperCommandValue = 0.0f;
-        bool gripperOverride = false;
-        if (joyBtnAState && !joyBtnBState) {
-            gripperCommandValue = 1.0f;
-            gripperOverride = true;
-        } else if (joyBtnBState && !joyBtnAState) {
-            gripperCommandValue = -1.0f;
-            gripperOverride = true;
-        }
-        if (!gripperOverride && !shiftDown && (leftDown ^ rightDown)) {
-            gripperCommandValue = leftDown ? -1.0f : 1.0f;
-            gripperOverride = true;
-        }
-        if (!gripperOverride && gripperHoldEnabled && gripperHoldLatched) {
-            gripperCommandValue = 1.0f;
-            gripperOverride = true;
-        }
-        if (!gripperOverride) {
-            gripperCommandValue = 0.0f;
-        }
-        if (gripperHoldEnabled && gripperCommandValue > 0.5f) {
-            gripperHoldLatched = true;
-        } else if (gripperCommandValue < -0.1f) {
-            gripperHoldLatched = false;
-        }
-        commandGrippers(gripperCommandValue);
+static void updateArmKinematics(uint32_t now, float dt) {
+    ILITE_PROFILE(ProfileZone::ControlKinematics);
 
-        const float extMin = fminf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
-        const float extMax = fmaxf(ikConfig.elbowExtension.minMm, ikConfig.elbowExtension.maxMm);
-        manualExtensionMm = constrain(manualExtensionMm, extMin, extMax);
-        float commandedExtension = extensionEnabled ? manualExtensionMm : 0.0f;
-
-        armCommand.baseDegrees = manualBaseYawDeg;
-        armCommand.extensionMillimeters = commandedExtension;
-        IKEngine::IKSolution solution;
-        ikSolver.setExtensionEnabled(extensionEnabled);
-        if (ikSolver.solvePlanar(targetPosition, commandedExtension, solution)) {
-            solution.joints.baseYawDeg = manualBaseYawDeg;
-            solution.joints.elbowExtensionMm = commandedExtension;
-            armCommand.shoulderDegrees = solution.joints.shoulderDeg;
-            armCommand.elbowDegrees = solution.joints.elbowDeg;
-            armCommand.pitchDegrees = solution.joints.gripperPitchDeg;
-            armCommand.rollDegrees = targetToolRollDeg;
-            armCommand.yawDegrees = solution.joints.gripperYawDeg;
-            armCommand.validMask = ArmCommandMask::AllServos |
-                                   ArmCommandMask::Extension |
-                                   ArmCommandMask::Base |
-                                   ArmCommandMask::AllGrippers;
-            armCommand.flags = ArmCommandFlag::EnableOutputs;
-            armCommandDirty = true;
+    if (mechIaneMode == MechIaneMode::DriveMode) {
+        return;
+    }
+    solveArmKinematics(now);
+
+    PoseRecorder& poses = PoseRecorder::getInstance();
+    if (poses.getState() == PoseRecorder::State::Playing) {
+        PoseRecorder::Frame frame;
+        poses.advance(dt, frame);
+        applyArmPose(frame);
+    } else if (poses.getState() == PoseRecorder::State::Recording) {
+        poses.record(captureArmPose(), now);
+    }
 
-            if (mechIaneMode == MechIaneMode::ArmOrientation) {
-                armCommand.pitchDegrees = manualPitchDeg;
-                armCommand.rollDegrees = manualRollDeg;
-                armCommand.yawDegrees = manualYawDeg;
-            }
+    if (armTrajectoryEnabled) {
+        float goal[ArmTrajectoryPlanner::AXIS_COUNT];
+        ArmTrajectoryPlanner::fromCommand(armCommand, goal);
+        armPlanner.setGoal(goal);
+        armPlanner.update(dt);
+    }
+}
 
-            // Debug: Log arm command when in orientation mode
-            static uint32_t lastDebugPrintMs = 0;
-            if (mechIaneMode == MechIaneMode::ArmOrientation && (now - lastDebugPrintMs) > 500) {
-                Serial.printf("[Thegill ArmCmd] Pitch: %.1f°, Yaw: %.1f°, Roll: %.1f° | Shoulder: %.1f°, Elbow: %.1f°\n",
-                              armCommand.pitchDegrees, armCommand.yawDegrees, armCommand.rollDegrees,
-                              armCommand.shoulderDegrees, armCommand.elbowDegrees);
-                lastDebugPrintMs = now;
-            }
+// armCommand as sent: stick jitter inside the bands leaves it unchanged.
+// Calling it again with the same armCommand returns the same packet.
+static ArmControlCommand conditionedArmCommand() {
+    ArmControlCommand out = armCommand;
+    out.extensionMillimeters = armSetpoints[0].update(armCommand.extensionMillimeters);
+    out.baseDegrees = armSetpoints[1].update(armCommand.baseDegrees);
+    out.shoulderDegrees = armSetpoints[2].update(armCommand.shoulderDegrees);
+    out.elbowDegrees = armSetpoints[3].update(armCommand.elbowDegrees);
+    out.pitchDegrees = armSetpoints[4].update(armCommand.pitchDegrees);
+    out.rollDegrees = armSetpoints[5].update(armCommand.rollDegrees);
+    out.yawDegrees = armSetpoints[6].update(armCommand.yawDegrees);
+    out.gripper1Degrees = armSetpoints[7].update(armCommand.gripper1Degrees);
+    out.gripper2Degrees = armSetpoints[8].update(armCommand.gripper2Degrees);
+    return out;
+}
 
-            manualPitchDeg = armCommand.pitchDegrees;
-            manualYawDeg = armCommand.yawDegrees;
-            manualRollDeg = armCommand.rollDegrees;
-        } else {
-            armCommand.validMask = ArmCommandMask::Extension |
-                                   ArmCommandMask::Base |
-                                   ArmCommandMask::AllGrippers;
-            armCommand.flags = ArmCommandFlag::EnableOutputs;
+static void packControlCommand(uint32_t now) {
+    ILITE_PROFILE(ProfileZone::ControlPack);
+
+    refreshPeripheralState(driveMagnitude);
+
+    // Only a changed arm command is sent ahead of kArmCommandMinIntervalMs
+    if (mechIaneMode != MechIaneMode::DriveMode) {
+        const ArmControlCommand conditioned = conditionedArmCommand();
+        if (memcmp(&conditioned, &lastPackedArmCommand, sizeof(conditioned)) != 0) {
+            lastPackedArmCommand = conditioned;
             armCommandDirty = true;
         }
-
-        refreshPeripheralState(0.0f);
     }
 
-    honkCommandActive = inDriveMode && shiftDown && !leftDown && !rightDown;
-
     if (requestStatusPulse) {
         latchSystemCommand(GillSystemCommand_RequestStatus);
         requestStatusPulse = false;
@@ -899,6 +1169,14 @@ void updateThegillControl() {
     thegillRuntime.cameraView = armCameraView;
 }
 
+void updateThegillControl(const InputManager& inputs, float dt) {
+    const uint32_t now = millis();
+    ControlInputs in;
+    readControlInputs(inputs, in);
+    updateControlIntent(in, now);
+    updateArmKinematics(now, dt);
+    packControlCommand(now);
+}
 
 // ============================================================================
 // TheGill Module Class (ILITE Framework Integration)
@@ -923,278 +1201,193 @@ static const uint8_t thegill_logo_32x32[] = {
 // 3D Arm Visualization Helper Functions
 // ============================================================================
 
-// Simple 3D to 2D isometric projection
-struct Point2D {
-    int16_t x;
-    int16_t y;
+// Screen-space point produced by the camera projection
+using Point2D = WirePoint;
+
+// Fixed-point camera model. Every ArmCameraView is either an orthographic
+// view or a perspective view with a yaw/pitch camera, so each one reduces to
+// three rotated axes plus offsets. The tables are built once; projecting a
+// vertex is then nine integer multiply-adds and, for perspective views, one
+// integer divide.
+struct CameraProjection {
+    int32_t axis[3][3];   ///< Screen X, screen up, depth rows (X/up carry zoom or focal length)
+    int32_t offset[3];    ///< Camera translation folded into each row, same units
+    uint8_t shift;        ///< Fractional bits of the X/up rows
+    bool perspective;
+    int16_t centerX;
+    int16_t centerY;
 };
 
-Point2D projectIsometric(float x, float y, float z, float scale = 0.12f) {
-    Point2D p;
-
-    switch (armCameraView) {
-        case ArmCameraView::TopLeftCorner: {
-            // Original view - top-left isometric
-            const float angleX = 0.615f;  // ~35 degrees
-            const float angleZ = 0.785f;  // 45 degrees
-
-            float cosX = cosf(angleX);
-            float sinX = sinf(angleX);
-            float cosZ = cosf(angleZ);
-            float sinZ = sinf(angleZ);
-
-            // Rotate around Z then X
-            float x1 = x * cosZ - y * sinZ;
-            float y1 = x * sinZ + y * cosZ;
-            float z1 = z;
-
-            float x2 = x1;
-            float y2 = y1 * cosX - z1 * sinX;
-
-            p.x = static_cast<int16_t>(x2 * scale + 84);
-            p.y = static_cast<int16_t>(-y2 * scale + 45);
-            break;
-        }
-
-        case ArmCameraView::ThirdPerson: {
-            // Low-height 3rd person view (behind and below)
-            // Camera positioned at (-300, -400, 50) looking at origin
-            const float camX = -300.0f;
-            const float camY = -400.0f;
-            const float camZ = 50.0f;
-
-            // Translate to camera space
-            float dx = x - camX;
-            float dy = y - camY;
-            float dz = z - camZ;
-
-            // Rotate to face camera forward (+Y in camera space)
-            const float angleY = 0.3f;  // Slight upward tilt
-            float cosY = cosf(angleY);
-            float sinY = sinf(angleY);
-
-            float y2 = dy * cosY - dz * sinY;
-            float z2 = dy * sinY + dz * cosY;
-
-            // Perspective projection
-            float depth = y2 + 600.0f;  // Prevent division by zero
-            if (depth < 10.0f) depth = 10.0f;
-
-            float perspective = 200.0f / depth;
-            p.x = static_cast<int16_t>(dx * perspective + 64);
-            p.y = static_cast<int16_t>(-z2 * perspective + 48);
-            break;
-        }
+static constexpr uint8_t kOrthoShift = 14;        // Q14: zoom <= 0.2 keeps sums in range
+static constexpr uint8_t kPerspectiveShift = 10;  // Q10: focal length is folded into the rows
+static constexpr uint8_t kDepthShift = 14;
+static constexpr uint8_t kDepthFraction = 4;      // Depth keeps 1/16 mm for the divide
+static constexpr int32_t kMinDepthMm = 10;
+static constexpr size_t kCameraViewCount = static_cast<size_t>(ArmCameraView::RearQuarter) + 1;
 
-        case ArmCameraView::Overhead: {
-            // Top-down view
-            p.x = static_cast<int16_t>(x * 0.15f + 64);
-            p.y = static_cast<int16_t>(y * 0.15f + 32);
-            break;
-        }
+static CameraProjection cameraProjections[kCameraViewCount];
+static bool cameraProjectionsReady = false;
 
-        case ArmCameraView::Side: {
-            // Side view (looking from X axis)
-            p.x = static_cast<int16_t>(y * 0.12f + 64);
-            p.y = static_cast<int16_t>(-z * 0.12f + 48);
-            break;
-        }
+static int32_t toFixed(float value, uint8_t shift) {
+    return static_cast<int32_t>(lroundf(value * static_cast<float>(1L << shift)));
+}
 
-        case ArmCameraView::Front: {
-            // Front view (looking from Y axis)
-            p.x = static_cast<int16_t>(x * 0.12f + 64);
-            p.y = static_cast<int16_t>(-z * 0.12f + 48);
-            break;
+// px = cx + zoom * (ex . v + ox), py = cy - zoom * (ey . v + oy)
+static CameraProjection orthoView(const IKEngine::Vec3& ex, const IKEngine::Vec3& ey,
+                                  float zoom, int16_t cx, int16_t cy,
+                                  float ox = 0.0f, float oy = 0.0f) {
+    CameraProjection cam{};
+    const float rows[2][3] = {{ex.x, ex.y, ex.z}, {ey.x, ey.y, ey.z}};
+    for (int r = 0; r < 2; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            cam.axis[r][c] = toFixed(rows[r][c] * zoom, kOrthoShift);
         }
+    }
+    cam.offset[0] = toFixed(ox * zoom, kOrthoShift);
+    cam.offset[1] = toFixed(oy * zoom, kOrthoShift);
+    cam.shift = kOrthoShift;
+    cam.perspective = false;
+    cam.centerX = cx;
+    cam.centerY = cy;
+    return cam;
+}
 
-        case ArmCameraView::OperatorLeft: {
-            const float camX = -150.0f;
-            const float camY = -250.0f;
-            const float camZ = 120.0f;
-            float dx = x - camX;
-            float dy = y - camY;
-            float dz = z - camZ;
-
-            const float yaw = 0.4f;
-            const float pitch = 0.35f;
-            float cosYaw = cosf(yaw);
-            float sinYaw = sinf(yaw);
-            float cosPitch = cosf(pitch);
-            float sinPitch = sinf(pitch);
-
-            float x1 = dx * cosYaw - dy * sinYaw;
-            float y1 = dx * sinYaw + dy * cosYaw;
-            float y2 = y1 * cosPitch - dz * sinPitch;
-            float z2 = y1 * sinPitch + dz * cosPitch;
-
-            float depth = y2 + 500.0f;
-            if (depth < 10.0f) depth = 10.0f;
-            float perspective = 220.0f / depth;
-            p.x = static_cast<int16_t>(x1 * perspective + 64);
-            p.y = static_cast<int16_t>(-z2 * perspective + 44);
-            break;
-        }
+// Isometric-style view: rotate about Z by angleZ, then tilt about X by angleX
+static CameraProjection tiltedView(float angleX, float angleZ, float zoom, int16_t cx, int16_t cy) {
+    const float cosX = cosf(angleX);
+    const float sinX = sinf(angleX);
+    const float cosZ = cosf(angleZ);
+    const float sinZ = sinf(angleZ);
+    return orthoView({cosZ, -sinZ, 0.0f},
+                     {sinZ * cosX, cosZ * cosX, -sinX},
+                     zoom, cx, cy);
+}
 
-        case ArmCameraView::OperatorRight: {
-            const float camX = 150.0f;
-            const float camY = -250.0f;
-            const float camZ = 140.0f;
-            float dx = x - camX;
-            float dy = y - camY;
-            float dz = z - camZ;
-
-            const float yaw = -0.4f;
-            const float pitch = 0.4f;
-            float cosYaw = cosf(yaw);
-            float sinYaw = sinf(yaw);
-            float cosPitch = cosf(pitch);
-            float sinPitch = sinf(pitch);
-
-            float x1 = dx * cosYaw - dy * sinYaw;
-            float y1 = dx * sinYaw + dy * cosYaw;
-            float y2 = y1 * cosPitch - dz * sinPitch;
-            float z2 = y1 * sinPitch + dz * cosPitch;
-
-            float depth = y2 + 500.0f;
-            if (depth < 10.0f) depth = 10.0f;
-            float perspective = 220.0f / depth;
-            p.x = static_cast<int16_t>(x1 * perspective + 64);
-            p.y = static_cast<int16_t>(-z2 * perspective + 44);
-            break;
-        }
+// Camera at `eye`, rotated by yaw about Z then pitch about X, with
+// depth = forward + depthOffset and scale = focal / depth
+static CameraProjection perspectiveView(const IKEngine::Vec3& eye, float yaw, float pitch,
+                                        float depthOffset, float focal, int16_t cx, int16_t cy) {
+    const float cosYaw = cosf(yaw);
+    const float sinYaw = sinf(yaw);
+    const float cosPitch = cosf(pitch);
+    const float sinPitch = sinf(pitch);
+    const float rows[3][3] = {
+        {cosYaw, -sinYaw, 0.0f},                                // screen X
+        {sinYaw * sinPitch, cosYaw * sinPitch, cosPitch},       // screen up
+        {sinYaw * cosPitch, cosYaw * cosPitch, -sinPitch}       // depth
+    };
 
-        case ArmCameraView::ToolTip: {
-            // Camera positioned ahead of the tool looking back toward base
-            const float camX = 420.0f;
-            const float camY = 0.0f;
-            const float camZ = 180.0f;
-            float dx = x - camX;
-            float dy = y - camY;
-            float dz = z - camZ;
-
-            const float yaw = PI;          // Look back toward base
-            const float pitch = -0.2f;     // Slight downward tilt
-            float cosYaw = cosf(yaw);
-            float sinYaw = sinf(yaw);
-            float cosPitch = cosf(pitch);
-            float sinPitch = sinf(pitch);
-
-            float x1 = dx * cosYaw - dy * sinYaw;
-            float y1 = dx * sinYaw + dy * cosYaw;
-            float y2 = y1 * cosPitch - dz * sinPitch;
-            float z2 = y1 * sinPitch + dz * cosPitch;
-
-            float depth = y2 + 400.0f;
-            if (depth < 10.0f) depth = 10.0f;
-            float perspective = 240.0f / depth;
-            p.x = static_cast<int16_t>(x1 * perspective + 64);
-            p.y = static_cast<int16_t>(-z2 * perspective + 38);
-            break;
+    CameraProjection cam{};
+    for (int r = 0; r < 3; ++r) {
+        const float along = rows[r][0] * eye.x + rows[r][1] * eye.y + rows[r][2] * eye.z;
+        const float scale = (r < 2) ? focal : 1.0f;
+        const uint8_t shift = (r < 2) ? kPerspectiveShift : kDepthShift;
+        for (int c = 0; c < 3; ++c) {
+            cam.axis[r][c] = toFixed(rows[r][c] * scale, shift);
         }
+        cam.offset[r] = toFixed(((r < 2) ? -along : depthOffset - along) * scale, shift);
+    }
+    cam.shift = kPerspectiveShift;
+    cam.perspective = true;
+    cam.centerX = cx;
+    cam.centerY = cy;
+    return cam;
+}
 
-        case ArmCameraView::OrbitHigh: {
-            const float angleX = 0.9f;
-            const float angleZ = 0.45f;
-            float cosX = cosf(angleX);
-            float sinX = sinf(angleX);
-            float cosZ = cosf(angleZ);
-            float sinZ = sinf(angleZ);
-
-            float x1 = x * cosZ - y * sinZ;
-            float y1 = x * sinZ + y * cosZ;
-            float y2 = y1 * cosX - z * sinX;
+static void buildCameraProjections() {
+    using V = ArmCameraView;
+    auto& t = cameraProjections;
+    t[static_cast<size_t>(V::TopLeftCorner)] = tiltedView(0.615f, 0.785f, 0.12f, 84, 45);
+    t[static_cast<size_t>(V::ThirdPerson)]   = perspectiveView({-300.0f, -400.0f, 50.0f}, 0.0f, 0.3f, 600.0f, 200.0f, 64, 48);
+    t[static_cast<size_t>(V::Overhead)]      = orthoView({1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, 0.15f, 64, 32);
+    t[static_cast<size_t>(V::Side)]          = orthoView({0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, 0.12f, 64, 48);
+    t[static_cast<size_t>(V::Front)]         = orthoView({1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, 0.12f, 64, 48);
+    t[static_cast<size_t>(V::OperatorLeft)]  = perspectiveView({-150.0f, -250.0f, 120.0f}, 0.4f, 0.35f, 500.0f, 220.0f, 64, 44);
+    t[static_cast<size_t>(V::OperatorRight)] = perspectiveView({150.0f, -250.0f, 140.0f}, -0.4f, 0.4f, 500.0f, 220.0f, 64, 44);
+    t[static_cast<size_t>(V::ToolTip)]       = perspectiveView({420.0f, 0.0f, 180.0f}, PI, -0.2f, 400.0f, 240.0f, 64, 38);
+    t[static_cast<size_t>(V::OrbitHigh)]     = tiltedView(0.9f, 0.45f, 0.10f, 70, 30);
+    // Close-up centred on the shoulder (x = 120, z = 140)
+    t[static_cast<size_t>(V::ShoulderClose)] = orthoView({1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, 0.20f, 64, 42, -120.0f, -140.0f);
+    t[static_cast<size_t>(V::RearQuarter)]   = perspectiveView({200.0f, -360.0f, 150.0f}, 0.55f, 0.4f, 520.0f, 210.0f, 64, 46);
+    cameraProjectionsReady = true;
+}
 
-            p.x = static_cast<int16_t>(x1 * 0.10f + 70);
-            p.y = static_cast<int16_t>(-y2 * 0.10f + 30);
-            break;
-        }
+static const CameraProjection& activeCameraProjection() {
+    if (!cameraProjectionsReady) {
+        buildCameraProjections();
+    }
+    size_t index = static_cast<size_t>(armCameraView);
+    if (index >= kCameraViewCount) {
+        index = 0;
+    }
+    return cameraProjections[index];
+}
 
-        case ArmCameraView::ShoulderClose: {
-            const float focusX = 120.0f;
-            const float focusY = 0.0f;
-            const float focusZ = 140.0f;
-            const float localScale = 0.20f;
-            p.x = static_cast<int16_t>((x - focusX) * localScale + 64);
-            p.y = static_cast<int16_t>((focusZ - z) * localScale + 42);
-            break;
-        }
+static Point2D projectFixed(const CameraProjection& cam, int32_t x, int32_t y, int32_t z) {
+    const int32_t sx = cam.axis[0][0] * x + cam.axis[0][1] * y + cam.axis[0][2] * z + cam.offset[0];
+    const int32_t sy = cam.axis[1][0] * x + cam.axis[1][1] * y + cam.axis[1][2] * z + cam.offset[1];
 
-        case ArmCameraView::RearQuarter: {
-            const float camX = 200.0f;
-            const float camY = -360.0f;
-            const float camZ = 150.0f;
-            float dx = x - camX;
-            float dy = y - camY;
-            float dz = z - camZ;
-
-            const float yaw = 0.55f;
-            const float pitch = 0.4f;
-            float cosYaw = cosf(yaw);
-            float sinYaw = sinf(yaw);
-            float cosPitch = cosf(pitch);
-            float sinPitch = sinf(pitch);
-
-            float x1 = dx * cosYaw - dy * sinYaw;
-            float y1 = dx * sinYaw + dy * cosYaw;
-            float y2 = y1 * cosPitch - dz * sinPitch;
-            float z2 = y1 * sinPitch + dz * cosPitch;
-
-            float depth = y2 + 520.0f;
-            if (depth < 10.0f) depth = 10.0f;
-            float perspective = 210.0f / depth;
-            p.x = static_cast<int16_t>(x1 * perspective + 64);
-            p.y = static_cast<int16_t>(-z2 * perspective + 46);
-            break;
-        }
+    Point2D p;
+    if (!cam.perspective) {
+        const int32_t round = 1L << (cam.shift - 1);
+        p.x = static_cast<int16_t>(cam.centerX + ((sx + round) >> cam.shift));
+        p.y = static_cast<int16_t>(cam.centerY - ((sy + round) >> cam.shift));
+        return p;
     }
 
+    int32_t depth = (cam.axis[2][0] * x + cam.axis[2][1] * y + cam.axis[2][2] * z + cam.offset[2]) >>
+                    (kDepthShift - kDepthFraction);
+    if (depth < (kMinDepthMm << kDepthFraction)) depth = kMinDepthMm << kDepthFraction;
+    const int32_t divisor = depth << (cam.shift - kDepthFraction);
+    p.x = static_cast<int16_t>(cam.centerX + sx / divisor);
+    p.y = static_cast<int16_t>(cam.centerY - sy / divisor);
     return p;
 }
 
-void drawDottedLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t dotSpacing = 3) {
-    // Draw a dotted line by plotting dots at intervals
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-    float len = sqrtf(dx * dx + dy * dy);
-
-    if (len < 1.0f) return;
+// World coordinates in millimetres
+Point2D projectIsometric(float x, float y, float z) {
+    return projectFixed(activeCameraProjection(), lroundf(x), lroundf(y), lroundf(z));
+}
 
-    float stepX = dx / len;
-    float stepY = dy / len;
+void drawDottedLine(DisplayCanvas& canvas, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t dotSpacing = 3) {
+    // One dot every `dotSpacing` pixels along the major axis; grid lines
+    // reach well past the panel in the close-up views, so clip first
+    if (dotSpacing == 0) return;
+    Wireframe3D::drawPatternLine(canvas, x0, y0, x1, y1, 0x01, dotSpacing < 8 ? dotSpacing : 8);
+}
 
-    for (float t = 0; t < len; t += dotSpacing) {
-        int16_t px = x0 + static_cast<int16_t>(stepX * t);
-        int16_t py = y0 + static_cast<int16_t>(stepY * t);
-        canvas.drawPixel(px, py);
+// Perpendicular offset of a cylinder wall with the given radius
+static Point2D cylinderOffset(Point2D p1, Point2D p2, int16_t radius) {
+    const float dx = p2.x - p1.x;
+    const float dy = p2.y - p1.y;
+    const float len = sqrtf(dx * dx + dy * dy);
+    if (len < 0.1f) {
+        return {0, 0};
     }
+    return {static_cast<int16_t>(-dy / len * radius), static_cast<int16_t>(dx / len * radius)};
 }
 
-void drawCylinder(DisplayCanvas& canvas, Point2D p1, Point2D p2, int16_t radius = 2) {
-    // Draw a 3D cylinder outline between two points
-    // Calculate perpendicular offset for cylinder walls
-    float dx = p2.x - p1.x;
-    float dy = p2.y - p1.y;
-    float len = sqrtf(dx * dx + dy * dy);
-
-    if (len < 0.1f) {
+static void drawCylinderWalls(DisplayCanvas& canvas, Point2D p1, Point2D p2, Point2D perp, int16_t radius) {
+    if (p1.x == p2.x && p1.y == p2.y) {
         // Too short, just draw a circle
         canvas.drawCircle(p1.x, p1.y, radius, false);
         return;
     }
 
-    // Perpendicular vector
-    float perpX = -dy / len * radius;
-    float perpY = dx / len * radius;
-
     // Draw four edges of the cylinder
-    canvas.drawLine(p1.x + perpX, p1.y + perpY, p2.x + perpX, p2.y + perpY);
-    canvas.drawLine(p1.x - perpX, p1.y - perpY, p2.x - perpX, p2.y - perpY);
+    Wireframe3D::drawLine(canvas, p1.x + perp.x, p1.y + perp.y, p2.x + perp.x, p2.y + perp.y);
+    Wireframe3D::drawLine(canvas, p1.x - perp.x, p1.y - perp.y, p2.x - perp.x, p2.y - perp.y);
 
     // Draw end caps
     canvas.drawCircle(p1.x, p1.y, radius, false);
     canvas.drawCircle(p2.x, p2.y, radius, false);
 }
 
+void drawCylinder(DisplayCanvas& canvas, Point2D p1, Point2D p2, int16_t radius = 2) {
+    // Draw a 3D cylinder outline between two points
+    drawCylinderWalls(canvas, p1, p2, cylinderOffset(p1, p2, radius), radius);
+}
+
 static IKEngine::Vec3 crossVec(const IKEngine::Vec3& a, const IKEngine::Vec3& b) {
     return {
         a.y * b.z - a.z * b.y,
@@ -1204,109 +1397,120 @@ static IKEngine::Vec3 crossVec(const IKEngine::Vec3& a, const IKEngine::Vec3& b)
 }
 
 static void drawExtensionSegment(DisplayCanvas& canvas, Point2D start, Point2D end) {
-    canvas.drawLine(start.x, start.y, end.x, end.y);
-    canvas.drawLine(start.x + 1, start.y, end.x + 1, end.y);
-    canvas.drawLine(start.x - 1, start.y, end.x - 1, end.y);
+    Wireframe3D::drawLine(canvas, start.x, start.y, end.x, end.y);
+    Wireframe3D::drawLine(canvas, start.x + 1, start.y, end.x + 1, end.y);
+    Wireframe3D::drawLine(canvas, start.x - 1, start.y, end.x - 1, end.y);
 }
 
-void draw3DArmVisualization(DisplayCanvas& canvas, const IKEngine::IKSolution& solution) {
-    // Draw 3D isometric view of the arm based on IK solution
-    canvas.setDrawColor(1);
+// ============================================================================
+// Projected Skeleton Cache
+// ============================================================================
 
-    // Draw dotted grid on XY plane for depth perception
-    const int gridSize = 500;  // Grid extends +/- 500mm
-    const int gridStep = 100;  // 100mm grid spacing
-
-    for (int x = -gridSize; x <= gridSize; x += gridStep) {
-        Point2D p1 = projectIsometric(x, -gridSize, 0);
-        Point2D p2 = projectIsometric(x, gridSize, 0);
-        drawDottedLine(canvas, p1.x, p1.y, p2.x, p2.y, 4);
-    }
-
-    for (int y = -gridSize; y <= gridSize; y += gridStep) {
-        Point2D p1 = projectIsometric(-gridSize, y, 0);
-        Point2D p2 = projectIsometric(gridSize, y, 0);
-        drawDottedLine(canvas, p1.x, p1.y, p2.x, p2.y, 4);
-    }
-
-    // Base position
-    float baseX = 0.0f;
-    float baseY = 0.0f;
-    float baseZ = 0.0f;
-
-    // Calculate arm link positions using FK from IK solution
-    float baseYawRad = solution.joints.baseYawDeg * DEG_TO_RAD;
-    float shoulderRad = solution.joints.shoulderDeg * DEG_TO_RAD;
-    float elbowRad = solution.joints.elbowDeg * DEG_TO_RAD;
-
-    // Shoulder joint position (rotates around base)
-    float shoulderLen = 155.0f;  // From IK config
-    float shoulderX = shoulderLen * cosf(shoulderRad) * cosf(baseYawRad);
-    float shoulderZ = shoulderLen * cosf(shoulderRad) * sinf(baseYawRad);
-    float shoulderY = shoulderLen * sinf(shoulderRad);
-
-    // Elbow joint position
-    float forearmLen = 170.0f + solution.joints.elbowExtensionMm;
-    float elbowAngleAbs = shoulderRad - elbowRad;  // Absolute elbow angle
-    float forearmDirX = cosf(elbowAngleAbs) * cosf(baseYawRad);
-    float forearmDirZ = cosf(elbowAngleAbs) * sinf(baseYawRad);
-    float forearmDirY = sinf(elbowAngleAbs);
-    float extensionLen = fmaxf(solution.joints.elbowExtensionMm, 0.0f);
-    float rigidLen = forearmLen - extensionLen;
-    if (rigidLen < 0.0f) {
-        extensionLen += rigidLen;
-        rigidLen = 0.0f;
-    }
-    float extensionBaseX = shoulderX + rigidLen * forearmDirX;
-    float extensionBaseZ = shoulderZ + rigidLen * forearmDirZ;
-    float extensionBaseY = shoulderY + rigidLen * forearmDirY;
-    float elbowX = extensionBaseX + extensionLen * forearmDirX;
-    float elbowZ = extensionBaseZ + extensionLen * forearmDirZ;
-    float elbowY = extensionBaseY + extensionLen * forearmDirY;
-
-    // End effector (wrist center)
-    float wristLen = 0.0f;  // Reference at extension tip
-    float wristX = elbowX + solution.toolDirection.x * wristLen;
-    float wristY = elbowY + solution.toolDirection.y * wristLen;
-    float wristZ = elbowZ + solution.toolDirection.z * wristLen;
+// Everything the projected skeleton depends on
+struct ArmViewKey {
+    ArmCameraView camera;
+    float baseYawDeg;
+    float shoulderDeg;
+    float elbowDeg;
+    float extensionMm;
+    float rollDeg;
+    IKEngine::Vec3 toolDirection;
+    float targetX;
+    float targetY;
+    uint32_t workspaceGeneration;
+    uint32_t ikRevision;            ///< Link lengths come from the solver configuration
+
+    bool operator==(const ArmViewKey& other) const {
+        return camera == other.camera &&
+               baseYawDeg == other.baseYawDeg &&
+               shoulderDeg == other.shoulderDeg &&
+               elbowDeg == other.elbowDeg &&
+               extensionMm == other.extensionMm &&
+               rollDeg == other.rollDeg &&
+               toolDirection.x == other.toolDirection.x &&
+               toolDirection.y == other.toolDirection.y &&
+               toolDirection.z == other.toolDirection.z &&
+               targetX == other.targetX &&
+               targetY == other.targetY &&
+               workspaceGeneration == other.workspaceGeneration &&
+               ikRevision == other.ikRevision;
+    }
+};
 
-    // Project to 2D
-    Point2D pBase = projectIsometric(baseX, baseY, baseZ);
-    Point2D pShoulder = projectIsometric(shoulderX, shoulderY, shoulderZ);
-    Point2D pElbow = projectIsometric(elbowX, elbowY, elbowZ);
-    Point2D pWrist = projectIsometric(wristX, wristY, wristZ);
-    IKEngine::Vec3 targetWorld = planarToWorld(targetPosition.x, targetPosition.y, solution.joints.baseYawDeg);
-    Point2D pTarget = projectIsometric(targetWorld.x, targetWorld.y, targetWorld.z);
+static constexpr int kGridSize = 500;  // Grid extends +/- 500mm
+static constexpr int kGridStep = 100;  // 100mm grid spacing
+static constexpr size_t kGridLines = (2 * kGridSize) / kGridStep + 1;
+
+struct ArmSkeleton2D {
+    Point2D gridX[kGridLines][2];  ///< Lines of constant X
+    Point2D gridY[kGridLines][2];  ///< Lines of constant Y
+    Point2D base;
+    Point2D shoulder;
+    Point2D extensionBase;
+    Point2D elbow;
+    Point2D wrist;
+    Point2D target;
+    Point2D axisTip[3];            ///< Tool forward, up, right
+    Point2D upperArmPerp;
+    Point2D forearmPerp;
+    Point2D wristPerp;
+    Point2D envelope[IKEngine::ReachabilityMap::kMaxEnvelopePoints];  ///< Reachable outline in the arm plane
+    size_t envelopeCount;
+};
 
-    // Draw arm links as cylinders for 3D effect
-    Point2D pExtensionBase = projectIsometric(extensionBaseX, extensionBaseY, extensionBaseZ);
-    drawCylinder(canvas, pBase, pShoulder, 2);      // Upper arm
-    drawCylinder(canvas, pShoulder, pExtensionBase, 2);
-    drawExtensionSegment(canvas, pExtensionBase, pElbow);                   // Telescoping section
-    drawCylinder(canvas, pElbow, pWrist, 1);        // Wrist (thinner)
+static ArmSkeleton2D armSkeleton;
+static ArmViewKey armSkeletonKey;
+static bool armSkeletonValid = false;
+static ArmCameraView armGridCamera = ArmCameraView::TopLeftCorner;
+static bool armGridValid = false;
+
+static void projectGrid(ArmSkeleton2D& skeleton) {
+    const CameraProjection& cam = activeCameraProjection();
+    for (size_t i = 0; i < kGridLines; ++i) {
+        const int32_t v = -kGridSize + static_cast<int32_t>(i) * kGridStep;
+        skeleton.gridX[i][0] = projectFixed(cam, v, -kGridSize, 0);
+        skeleton.gridX[i][1] = projectFixed(cam, v, kGridSize, 0);
+        skeleton.gridY[i][0] = projectFixed(cam, -kGridSize, v, 0);
+        skeleton.gridY[i][1] = projectFixed(cam, kGridSize, v, 0);
+    }
+}
 
-    // Draw joints as filled circles
-    canvas.drawCircle(pBase.x, pBase.y, 3, true);
-    canvas.drawCircle(pShoulder.x, pShoulder.y, 3, true);
-    canvas.drawCircle(pElbow.x, pElbow.y, 3, true);
+static void projectSkeleton(ArmSkeleton2D& skeleton, const IKEngine::IKSolution& solution) {
+    // Same forward kinematics and link lengths as the arm-state telemetry
+    const IKEngine::ArmPose pose = ikSolver.forwardPlanar(solution.joints.shoulderDeg,
+                                                          solution.joints.elbowDeg,
+                                                          solution.joints.elbowExtensionMm);
+    const float baseYawRad = solution.joints.baseYawDeg * DEG_TO_RAD;
+    const float cosYaw = cosf(baseYawRad);
+    const float sinYaw = sinf(baseYawRad);
+    auto toWorld = [cosYaw, sinYaw](const IKEngine::Vec3& planar) {
+        return IKEngine::Vec3(planar.x * cosYaw, planar.y, planar.x * sinYaw);
+    };
+    const IKEngine::Vec3 shoulder = toWorld(pose.elbow);
+    const IKEngine::Vec3 extensionBase = toWorld(pose.extensionBase);
+    const IKEngine::Vec3 wrist = toWorld(pose.wrist);
 
-    // Draw end effector (gripper)
-    canvas.drawCircle(pWrist.x, pWrist.y, 4, false);
-    if (gripperOpen) {
-        // Draw open gripper jaws
-        canvas.drawLine(pWrist.x - 3, pWrist.y - 3, pWrist.x - 5, pWrist.y - 5);
-        canvas.drawLine(pWrist.x + 3, pWrist.y - 3, pWrist.x + 5, pWrist.y - 5);
-    } else {
-        // Draw closed gripper
-        canvas.drawLine(pWrist.x, pWrist.y - 3, pWrist.x, pWrist.y - 5);
+    // Project to 2D
+    skeleton.base = projectIsometric(0.0f, 0.0f, 0.0f);
+    skeleton.shoulder = projectIsometric(shoulder.x, shoulder.y, shoulder.z);
+    skeleton.extensionBase = projectIsometric(extensionBase.x, extensionBase.y, extensionBase.z);
+    skeleton.elbow = projectIsometric(wrist.x, wrist.y, wrist.z);
+    skeleton.wrist = skeleton.elbow;  // Wrist centre sits at the extension tip
+    const IKEngine::Vec3 targetWorld = toWorld(IKEngine::Vec3(targetPosition.x, targetPosition.y, 0.0f));
+    skeleton.target = projectIsometric(targetWorld.x, targetWorld.y, targetWorld.z);
+
+    IKEngine::Vec3 outline[IKEngine::ReachabilityMap::kMaxEnvelopePoints];
+    skeleton.envelopeCount = armWorkspace.envelope(outline, IKEngine::ReachabilityMap::kMaxEnvelopePoints);
+    for (size_t i = 0; i < skeleton.envelopeCount; ++i) {
+        const IKEngine::Vec3 world = toWorld(outline[i]);
+        skeleton.envelope[i] = projectIsometric(world.x, world.y, world.z);
     }
 
-    // Draw target position as crosshair with circle
-    canvas.drawLine(pTarget.x - 4, pTarget.y, pTarget.x + 4, pTarget.y);
-    canvas.drawLine(pTarget.x, pTarget.y - 4, pTarget.x, pTarget.y + 4);
-    canvas.drawCircle(pTarget.x, pTarget.y, 5, false);
+    skeleton.upperArmPerp = cylinderOffset(skeleton.base, skeleton.shoulder, 2);
+    skeleton.forearmPerp = cylinderOffset(skeleton.shoulder, skeleton.extensionBase, 2);
+    skeleton.wristPerp = cylinderOffset(skeleton.elbow, skeleton.wrist, 1);
 
-    IKEngine::Vec3 wristVec{wristX, wristY, wristZ};
+    // Tool frame axes
     IKEngine::Vec3 forward = IKEngine::InverseKinematics::normalise(solution.toolDirection);
     IKEngine::Vec3 worldUp{0.0f, 0.0f, 1.0f};
     IKEngine::Vec3 right = crossVec(forward, worldUp);
@@ -1334,15 +1538,96 @@ void draw3DArmVisualization(DisplayCanvas& canvas, const IKEngine::IKSolution& s
         up = rotatedUp;
     }
     const float axisLen = 60.0f;
-    auto drawAxis = [&](const IKEngine::Vec3& dir) {
-        Point2D tip = projectIsometric(wristVec.x + dir.x * axisLen,
-                                       wristVec.y + dir.y * axisLen,
-                                       wristVec.z + dir.z * axisLen);
-        canvas.drawLine(pWrist.x, pWrist.y, tip.x, tip.y);
+    const IKEngine::Vec3 axes[3] = {forward, up, right};
+    for (int i = 0; i < 3; ++i) {
+        skeleton.axisTip[i] = projectIsometric(wrist.x + axes[i].x * axisLen,
+                                               wrist.y + axes[i].y * axisLen,
+                                               wrist.z + axes[i].z * axisLen);
+    }
+}
+
+// Reproject only when the camera or the IK solution changed
+static const ArmSkeleton2D& projectedArm(const IKEngine::IKSolution& solution) {
+    if (!armGridValid || armGridCamera != armCameraView) {
+        projectGrid(armSkeleton);
+        armGridCamera = armCameraView;
+        armGridValid = true;
+    }
+
+    const ArmViewKey key{
+        armCameraView,
+        solution.joints.baseYawDeg,
+        solution.joints.shoulderDeg,
+        solution.joints.elbowDeg,
+        solution.joints.elbowExtensionMm,
+        solution.joints.gripperRollDeg,
+        solution.toolDirection,
+        targetPosition.x,
+        targetPosition.y,
+        armWorkspace.getGeneration(),
+        ikSolver.getRevision()
     };
-    drawAxis(forward);
-    drawAxis(up);
-    drawAxis(right);
+    if (!armSkeletonValid || !(key == armSkeletonKey)) {
+        projectSkeleton(armSkeleton, solution);
+        armSkeletonKey = key;
+        armSkeletonValid = true;
+    }
+    return armSkeleton;
+}
+
+void draw3DArmVisualization(DisplayCanvas& canvas, const IKEngine::IKSolution& solution) {
+    // Draw 3D isometric view of the arm based on IK solution
+    canvas.setDrawColor(1);
+    const ArmSkeleton2D& arm = projectedArm(solution);
+
+    // Draw dotted grid on XY plane for depth perception
+    for (size_t i = 0; i < kGridLines; ++i) {
+        drawDottedLine(canvas, arm.gridX[i][0].x, arm.gridX[i][0].y, arm.gridX[i][1].x, arm.gridX[i][1].y, 4);
+        drawDottedLine(canvas, arm.gridY[i][0].x, arm.gridY[i][0].y, arm.gridY[i][1].x, arm.gridY[i][1].y, 4);
+    }
+
+    // Reach envelope in the arm plane
+    for (size_t i = 0; i < arm.envelopeCount; ++i) {
+        canvas.drawPixel(arm.envelope[i].x, arm.envelope[i].y);
+    }
+
+    const Point2D pBase = arm.base;
+    const Point2D pShoulder = arm.shoulder;
+    const Point2D pElbow = arm.elbow;
+    const Point2D pWrist = arm.wrist;
+    const Point2D pTarget = arm.target;
+
+    // Draw arm links as cylinders for 3D effect
+    drawCylinderWalls(canvas, pBase, pShoulder, arm.upperArmPerp, 2);        // Upper arm
+    drawCylinderWalls(canvas, pShoulder, arm.extensionBase, arm.forearmPerp, 2);
+    drawExtensionSegment(canvas, arm.extensionBase, pElbow);                 // Telescoping section
+    drawCylinderWalls(canvas, pElbow, pWrist, arm.wristPerp, 1);             // Wrist (thinner)
+
+    // Draw joints as filled circles
+    canvas.drawCircle(pBase.x, pBase.y, 3, true);
+    canvas.drawCircle(pShoulder.x, pShoulder.y, 3, true);
+    canvas.drawCircle(pElbow.x, pElbow.y, 3, true);
+
+    // Draw end effector (gripper)
+    canvas.drawCircle(pWrist.x, pWrist.y, 4, false);
+    if (gripperOpen) {
+        // Draw open gripper jaws
+        canvas.drawLine(pWrist.x - 3, pWrist.y - 3, pWrist.x - 5, pWrist.y - 5);
+        canvas.drawLine(pWrist.x + 3, pWrist.y - 3, pWrist.x + 5, pWrist.y - 5);
+    } else {
+        // Draw closed gripper
+        canvas.drawLine(pWrist.x, pWrist.y - 3, pWrist.x, pWrist.y - 5);
+    }
+
+    // Draw target position as crosshair with circle
+    Wireframe3D::drawLine(canvas, pTarget.x - 4, pTarget.y, pTarget.x + 4, pTarget.y);
+    Wireframe3D::drawLine(canvas, pTarget.x, pTarget.y - 4, pTarget.x, pTarget.y + 4);
+    canvas.drawCircle(pTarget.x, pTarget.y, 5, false);
+
+    // Tool frame axes
+    for (const Point2D& tip : arm.axisTip) {
+        Wireframe3D::drawLine(canvas, pWrist.x, pWrist.y, tip.x, tip.y);
+    }
 
     // Draw mode and gripper state indicators
     canvas.setFont(DisplayCanvas::TINY);
@@ -1352,6 +1637,10 @@ void draw3DArmVisualization(DisplayCanvas& canvas, const IKEngine::IKSolution& s
         canvas.drawText(0, 63, "ORI");
     }
 
+    if (armCollisionBlocked) {
+        canvas.drawText(46, 63, "BLOCKED");
+    }
+
     // Draw gripper state
     if (gripperOpen) {
         canvas.drawText(110, 63, "OPEN");
@@ -1404,42 +1693,6 @@ void setGripperFingerPosition(uint8_t fingerIndex, float degrees) {
     }
 }
 
-static IKEngine::Vec3 estimateToolPosition(const ArmStatePacket& packet) {
-    constexpr float shoulderLen = 155.0f;
-    constexpr float elbowBaseLen = 170.0f;
-    constexpr float wristLen = 0.0f;
-
-    const float baseYawRad = packet.baseDegrees * DEG_TO_RAD;
-    const float shoulderRad = packet.servoDegrees[0] * DEG_TO_RAD;
-    const float elbowRad = packet.servoDegrees[1] * DEG_TO_RAD;
-    const float extensionMm = packet.extensionCentimeters * 10.0f;
-    const float forearmLen = elbowBaseLen + extensionMm;
-    const float elbowAngleAbs = shoulderRad - elbowRad;
-
-    const float shoulderX = shoulderLen * cosf(shoulderRad) * cosf(baseYawRad);
-    const float shoulderZ = shoulderLen * cosf(shoulderRad) * sinf(baseYawRad);
-    const float shoulderY = shoulderLen * sinf(shoulderRad);
-
-    const float elbowX = shoulderX + forearmLen * cosf(elbowAngleAbs) * cosf(baseYawRad);
-    const float elbowZ = shoulderZ + forearmLen * cosf(elbowAngleAbs) * sinf(baseYawRad);
-    const float elbowY = shoulderY + forearmLen * sinf(elbowAngleAbs);
-
-    const float pitchRad = packet.servoDegrees[2] * DEG_TO_RAD;
-    const float yawRad = packet.servoDegrees[4] * DEG_TO_RAD;
-    IKEngine::Vec3 dir{
-        cosf(pitchRad) * cosf(yawRad),
-        cosf(pitchRad) * sinf(yawRad),
-        sinf(pitchRad)
-    };
-
-    IKEngine::Vec3 wrist{
-        elbowX + dir.x * wristLen,
-        elbowY + dir.y * wristLen,
-        elbowZ + dir.z * wristLen
-    };
-    return wrist;
-}
-
 bool acquirePeripheralCommand(PeripheralCommand& out) {
     const uint32_t now = millis();
     if (!peripheralDirty && (now - lastPeripheralSendMs) < kPeripheralIntervalMs) {
@@ -1488,31 +1741,78 @@ bool acquireArmCommand(ArmControlCommand& out) {
         return false;
     }
     const uint32_t now = millis();
+    armCommand.magic = ARM_COMMAND_MAGIC;
+    const ArmControlCommand conditioned = conditionedArmCommand();
+    if (armTrajectoryEnabled && armStateSynced) {
+        // Joints travel in ArmTrajectoryPacket; only grippers and flags go here
+        const bool changed = conditioned.gripper1Degrees != lastStreamedArmCommand.gripper1Degrees ||
+                             conditioned.gripper2Degrees != lastStreamedArmCommand.gripper2Degrees ||
+                             conditioned.flags != lastStreamedArmCommand.flags;
+        if (!changed && (now - lastArmCommandSendMs) < kArmStreamCommandIntervalMs) {
+            return false;
+        }
+        lastArmCommandSendMs = now;
+        out = conditioned;
+        out.validMask &= ~ArmTrajectoryPlanner::kValidMask;
+        lastStreamedArmCommand = conditioned;
+        armCommandDirty = false;
+        return true;
+    }
     if (!armCommandDirty && (now - lastArmCommandSendMs) < kArmCommandMinIntervalMs) {
         return false;
     }
     lastArmCommandSendMs = now;
-    armCommand.magic = ARM_COMMAND_MAGIC;
-    out = armCommand;
+    out = conditioned;
     armCommandDirty = false;
     return true;
 }
 
+bool acquireArmTrajectory(ArmTrajectoryPacket& out) {
+    // Wait for the robot's pose so the first segment starts where the arm is
+    if (!armTrajectoryEnabled || !armStateSynced || mechIaneMode == MechIaneMode::DriveMode) {
+        return false;
+    }
+    return armPlanner.buildPacket(millis(), armCommand.flags, out);
+}
+
+void setArmTrajectoryStreaming(bool enabled) {
+    if (armTrajectoryEnabled == enabled) {
+        return;
+    }
+    armTrajectoryEnabled = enabled;
+    if (enabled) {
+        float pose[ArmTrajectoryPlanner::AXIS_COUNT];
+        ArmTrajectoryPlanner::fromCommand(armCommand, pose);
+        armPlanner.configure(ikSolver.getConfiguration());
+        armPlanner.reset(pose);
+        lastStreamedArmCommand = ArmControlCommand{};
+    } else {
+        // Hand the joints back to ArmControlCommand at the current setpoint
+        armCommandDirty = true;
+    }
+    ILITE_LOG(MODULE, LOG_INFO, "TheGill: arm trajectory streaming %s", enabled ? "on" : "off");
+}
+
+bool isArmTrajectoryStreaming() {
+    return armTrajectoryEnabled;
+}
+
+float thegillWheelFraction(int16_t wheelSpeedMmPerSec) {
+    return constrain(static_cast<float>(wheelSpeedMmPerSec) / kMaxWheelSpeedMmPerSec, -1.2f, 1.2f);
+}
+
 void processStatusPacket(const StatusPacket& packet) {
     if (packet.magic != THEGILL_STATUS_MAGIC) {
         return;
     }
-    thegillStatusPacket = packet;
     lastStatusPacketMs = millis();
 
-    auto normalize = [](int16_t value) {
-        return constrain(static_cast<float>(value) / kMaxWheelSpeedMmPerSec, -1.2f, 1.2f);
-    };
-
-    thegillRuntime.actualLeftFront = normalize(packet.wheelSpeedMmPerSec[0]);
-    thegillRuntime.actualLeftRear = normalize(packet.wheelSpeedMmPerSec[1]);
-    thegillRuntime.actualRightFront = normalize(packet.wheelSpeedMmPerSec[2]);
-    thegillRuntime.actualRightRear = normalize(packet.wheelSpeedMmPerSec[3]);
+    // Mirrors for the legacy display.cpp screens; the module dashboard and
+    // menus read the packet from the TelemetryStore slot
+    thegillRuntime.actualLeftFront = thegillWheelFraction(packet.wheelSpeedMmPerSec[0]);
+    thegillRuntime.actualLeftRear = thegillWheelFraction(packet.wheelSpeedMmPerSec[1]);
+    thegillRuntime.actualRightFront = thegillWheelFraction(packet.wheelSpeedMmPerSec[2]);
+    thegillRuntime.actualRightRear = thegillWheelFraction(packet.wheelSpeedMmPerSec[3]);
 
     thegillRuntime.batteryMillivolts = packet.batteryMillivolts;
     thegillRuntime.commandAgeMs = packet.commandAgeMs;
@@ -1535,15 +1835,17 @@ void processArmStatePacket(const ArmStatePacket& packet) {
     if (packet.magic != THEGILL_ARM_STATE_MAGIC) {
         return;
     }
-    thegillArmStatePacket = packet;
     lastArmStatePacketMs = millis();
     armStateSynced = true;
     requestArmStatePending = false;
 
-    IKEngine::Vec3 wristTarget = estimateToolPosition(packet);
     manualBaseYawDeg = packet.baseDegrees;
     manualExtensionMm = packet.extensionCentimeters * 10.0f;
-    setPlanarTargetFromWorld(wristTarget, manualBaseYawDeg);
+    armStateForward.update(packet.servoDegrees[0], packet.servoDegrees[1], manualExtensionMm);
+    const IKEngine::Vec3& wrist = armStateForward.pose().wrist;
+    targetPosition.x = constrain(wrist.x, 0.0f, 780.0f);
+    targetPosition.y = constrain(wrist.y, -780.0f, 780.0f);
+    targetPosition.z = 0.0f;
 
     const float pitchRad = packet.servoDegrees[2] * DEG_TO_RAD;
     const float yawRad = packet.servoDegrees[4] * DEG_TO_RAD;
@@ -1576,6 +1878,14 @@ void processArmStatePacket(const ArmStatePacket& packet) {
     armCommand.flags = (packet.flags & 0x01) ? ArmCommandFlag::EnableOutputs : 0;
     armCommandDirty = false;
     peripheralDirty = true;
+    // Start from the robot's pose, not from what was held before the sync
+    for (ControlShaping::Setpoint& setpoint : armSetpoints) {
+        setpoint.reset();
+    }
+
+    float pose[ArmTrajectoryPlanner::AXIS_COUNT];
+    ArmTrajectoryPlanner::fromCommand(armCommand, pose);
+    armPlanner.reset(pose);
 }
 
 void queueStatusRequest() {
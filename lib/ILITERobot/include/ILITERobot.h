@@ -0,0 +1,90 @@
+/**
+ * @file ILITERobot.h
+ * @brief Robot-side companion of the ILITE controller (header-only, no heap)
+ *
+ * The controller's link features each need a matching robot: bundled and
+ * redundant command frames have to be unwrapped, stamps echoed, rate
+ * requests followed, telemetry delta-encoded, pings answered with clock
+ * stamps and sessions resumed. This library is that half, for any robot
+ * firmware that talks ESP-NOW (or another frame transport) to an ILITE
+ * controller:
+ *
+ * | Header            | Class              | Controller counterpart              |
+ * |-------------------|--------------------|-------------------------------------|
+ * | RobotRxRing.h     | RxRing<N>          | RxRing                              |
+ * | RobotDispatch.h   | Dispatcher         | PacketRouter, command descriptors   |
+ * | RobotTelemetry.h  | TelemetryScheduler | RateRequestWriter, TelemetryStore   |
+ * | RobotDelta.h      | DeltaWriter        | DeltaPacketReader                   |
+ * | RobotLink.h       | LinkResponder      | EspNowDiscovery, ClockSync          |
+ * | RobotWire.h       | Wire structs       | The headers named in it             |
+ *
+ * - **Header-only, C++11**: only <cstdint>, <cstring>, <atomic> and
+ *   <type_traits>; no Arduino, WiFi or FreeRTOS headers. The robot passes
+ *   in time and a send function, so the same code runs on the PC.
+ * - **No allocation**: every table is a fixed array sized for the
+ *   controller's own limits (8 telemetry types, 16 command routes).
+ * - **Same wire format**: the controller's native build (examples/NativeCore)
+ *   feeds these classes with the controller's writers and reads their
+ *   output with its readers, and benchmarks them next to the controller's
+ *   hot paths.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * #include <ILITERobot.h>
+ *
+ * ILITERobot::RxRing<8> rxRing;
+ * ILITERobot::Dispatcher dispatcher;
+ * ILITERobot::TelemetryScheduler telemetry(sendFrame, nullptr);
+ * ILITERobot::LinkResponder link("TheGill", "gill-01", ownMac, sendFrame, nullptr, clockUs);
+ *
+ * bool sendFrame(const uint8_t* mac, const uint8_t* data, size_t len, void*) {
+ *     return esp_now_send(mac, data, len) == ESP_OK;
+ * }
+ *
+ * void onReceive(const uint8_t* mac, const uint8_t* data, int len) {
+ *     rxRing.push(mac, data, len, clockUs());
+ * }
+ *
+ * void setup() {
+ *     // esp_now_init(), broadcast peer, esp_now_register_recv_cb(onReceive)
+ *     dispatcher.addPacket<DriveCommand>(DRIVE_MAGIC, onDrive);
+ *     dispatcher.addRoute(ILITERobot::kRateRequestMagic, ILITERobot::kRateHeaderSize,
+ *                         ILITERobot::kMaxFrameSize, ILITERobot::TelemetryScheduler::rateRoute,
+ *                         &telemetry);
+ *     telemetry.addType(STATE_MAGIC, 100, buildState);
+ *     telemetry.setEcho(true);
+ * }
+ *
+ * void loop() {
+ *     const uint32_t now = millis();
+ *     while (const ILITERobot::RxFrame* frame = rxRing.front()) {
+ *         if (!link.handle(frame->mac, frame->data, frame->length, frame->timestampUs, now)) {
+ *             dispatcher.handle(frame->data, frame->length);
+ *         }
+ *         rxRing.pop();
+ *     }
+ *     link.poll(now);
+ *     if (link.isPaired()) {
+ *         telemetry.poll(link.getPeer(), now, dispatcher.getStamp());
+ *     }
+ * }
+ * ```
+ *
+ * ## Thread Safety:
+ * RxRing::push() on the receive callback; everything else on one task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_H
+#define ILITE_ROBOT_H
+
+#include "RobotWire.h"
+#include "RobotRxRing.h"
+#include "RobotDispatch.h"
+#include "RobotDelta.h"
+#include "RobotTelemetry.h"
+#include "RobotLink.h"
+
+#endif // ILITE_ROBOT_H
@@ -0,0 +1,306 @@
+/**
+ * @file RobotDelta.h
+ * @brief Delta-encode telemetry against keyframes, as the controller decodes it
+ *
+ * For telemetry types whose controller descriptor sets `deltaEncoded`, the
+ * robot may send most packets as the fields that changed since the last
+ * keyframe (see DeltaPacket.h on the controller):
+ *
+ *     [DLTA:4][packet magic:4][keySeq:1][kind:1][packet | mask + values]
+ *
+ * Both ends cut the packet into the same segments, one per field of the
+ * descriptor, so the robot lists its fields in the same order as the
+ * descriptor's Field table:
+ *
+ * | DeltaField::Kind | Descriptor Field::Type           | Sent when changed              |
+ * |------------------|----------------------------------|--------------------------------|
+ * | Integer          | INT/UINT 8-32, BOOL              | Zigzag varint of the difference|
+ * | Float            | FLOAT                            | Varint of the XOR of the bits  |
+ * | Bytes            | BYTE_ARRAY, other sizes          | The bytes themselves           |
+ *
+ * Without fields, the packet is cut into 4-byte words sent as XORs, like a
+ * descriptor without a Field table.
+ *
+ * A keyframe goes out every `keyframeInterval` packets, when the length
+ * changes, when a byte outside every field changed, or when the delta would
+ * not be smaller. A lost keyframe costs the controller the deltas until the
+ * next one, so keep the interval short on lossy links.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * const ILITERobot::DeltaField kStateFields[] = {
+ *     {0, 4, ILITERobot::DeltaField::Integer},     // magic
+ *     {4, 2, ILITERobot::DeltaField::Integer},     // batteryMv
+ *     {6, 4, ILITERobot::DeltaField::Float},       // heading
+ * };
+ * ILITERobot::DeltaWriter delta(kStateFields, 3, sizeof(RobotState));
+ *
+ * uint8_t frame[ILITERobot::DeltaWriter::kMaxFrameSize];
+ * const size_t length = delta.encode(reinterpret_cast<const uint8_t*>(&state), sizeof(state),
+ *                                    frame, sizeof(frame));
+ * ```
+ *
+ * ## Thread Safety:
+ * None; one writer per telemetry type, used by the task that sends it.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_DELTA_H
+#define ILITE_ROBOT_DELTA_H
+
+#include "RobotWire.h"
+
+namespace ILITERobot {
+
+/**
+ * @brief One field of a delta-encoded packet (mirrors PacketDescriptor::Field)
+ */
+struct DeltaField {
+    enum Kind : uint8_t {
+        Integer,
+        Float,
+        Bytes
+    };
+
+    uint8_t offset;
+    uint8_t size;
+    Kind kind;
+};
+
+/**
+ * @class DeltaWriter
+ * @brief Keyframe and delta encoder for one telemetry type
+ */
+class DeltaWriter {
+public:
+    static constexpr size_t kHeaderSize = kDeltaHeaderSize;
+    static constexpr size_t kMaxFrameSize = kHeaderSize + kDeltaMaxPacketSize;
+    static constexpr uint8_t kDefaultKeyframeInterval = 25;
+
+    DeltaWriter() : DeltaWriter(nullptr, 0, 0) {}
+
+    /**
+     * @param fields Fields in descriptor order, or nullptr for 4-byte words
+     * @param packetSize Size of the packet (only used without fields)
+     */
+    DeltaWriter(const DeltaField* fields, size_t fieldCount, size_t packetSize,
+                uint8_t keyframeInterval = kDefaultKeyframeInterval)
+        : count_(0),
+          keyLength_(0),
+          keySeq_(0),
+          sinceKey_(0),
+          interval_(keyframeInterval > 0 ? keyframeInterval : 1),
+          haveKey_(false),
+          keyframes_(0),
+          deltas_(0)
+    {
+        configure(fields, fieldCount, packetSize);
+        memset(key_, 0, sizeof(key_));
+    }
+
+    /// Lay out the segments again; the next packet is a keyframe
+    void configure(const DeltaField* fields, size_t fieldCount, size_t packetSize) {
+        count_ = 0;
+        memset(covered_, 0, sizeof(covered_));
+        haveKey_ = false;
+
+        if (fields == nullptr || fieldCount == 0) {
+            packetSize = packetSize < kDeltaMaxPacketSize ? packetSize : kDeltaMaxPacketSize;
+            for (size_t offset = 0; offset < packetSize; offset += 4) {
+                add(offset, packetSize - offset < 4 ? packetSize - offset : 4, Xor);
+            }
+            return;
+        }
+        for (size_t i = 0; i < fieldCount; ++i) {
+            const DeltaField& field = fields[i];
+            const bool word = field.size == 1 || field.size == 2 || field.size == 4;
+            Segment kind = Raw;
+            if (field.kind == DeltaField::Float && field.size == 4) {
+                kind = Xor;
+            } else if (field.kind == DeltaField::Integer && word) {
+                kind = Zigzag;
+            }
+            add(field.offset, field.size, kind);
+        }
+    }
+
+    /// Send a keyframe next (new link)
+    void reset() { haveKey_ = false; }
+
+    /**
+     * @brief Encode one packet (starting with its magic) as a keyframe or delta frame
+     * @return Bytes written to `out`, or 0 if the packet is invalid or does not fit
+     */
+    size_t encode(const uint8_t* packet, size_t length, uint8_t* out, size_t capacity) {
+        if (packet == nullptr || out == nullptr || length < sizeof(uint32_t) ||
+            length > kDeltaMaxPacketSize) {
+            return 0;
+        }
+
+        if (haveKey_ && length == keyLength_ && sinceKey_ < interval_) {
+            const size_t size = encodeDelta(packet, length, out, capacity);
+            if (size > 0) {
+                sinceKey_++;
+                deltas_++;
+                return size;
+            }
+        }
+
+        if (kHeaderSize + length > capacity) {
+            return 0;
+        }
+        keySeq_++;
+        writeHeader(out, packet, kDeltaKeyframe);
+        memcpy(out + kHeaderSize, packet, length);
+
+        memcpy(key_, packet, length);
+        keyLength_ = static_cast<uint8_t>(length);
+        sinceKey_ = 0;
+        haveKey_ = true;
+        keyframes_++;
+        return kHeaderSize + length;
+    }
+
+    uint32_t getKeyframes() const { return keyframes_; }
+    uint32_t getDeltas() const { return deltas_; }
+
+private:
+    enum Segment : uint8_t {
+        Zigzag,     ///< Integer: zigzag varint of the wrapped difference
+        Xor,        ///< Float or word: varint of the XOR of the bits
+        Raw         ///< Anything else: the bytes themselves
+    };
+
+    void add(size_t offset, size_t size, Segment kind) {
+        if (count_ >= kDeltaMaxSegments || size == 0 || offset + size > kDeltaMaxPacketSize) {
+            return;     // Left uncovered: a change there forces a keyframe
+        }
+        offsets_[count_] = static_cast<uint8_t>(offset);
+        sizes_[count_] = static_cast<uint8_t>(size);
+        kinds_[count_] = kind;
+        count_++;
+        for (size_t i = offset; i < offset + size; ++i) {
+            covered_[i / 8] |= static_cast<uint8_t>(1U << (i % 8));
+        }
+    }
+
+    bool isCovered(size_t offset) const { return (covered_[offset / 8] >> (offset % 8)) & 1U; }
+
+    void writeHeader(uint8_t* out, const uint8_t* packet, uint8_t kind) const {
+        const uint32_t magic = kDeltaMagic;
+        memcpy(out, &magic, sizeof(magic));
+        memcpy(out + sizeof(magic), packet, sizeof(uint32_t));
+        out[8] = keySeq_;
+        out[9] = kind;
+    }
+
+    size_t encodeDelta(const uint8_t* packet, size_t length, uint8_t* out, size_t capacity) const {
+        // Bytes no segment covers travel only in keyframes
+        for (size_t i = 0; i < length; ++i) {
+            if (!isCovered(i) && packet[i] != key_[i]) {
+                return 0;
+            }
+        }
+
+        // Never larger than the keyframe it replaces
+        const size_t maskBytes = (count_ + 7) / 8;
+        const size_t limit = capacity < kHeaderSize + length ? capacity : kHeaderSize + length - 1;
+        if (kHeaderSize + maskBytes > limit) {
+            return 0;
+        }
+
+        uint8_t* mask = out + kHeaderSize;
+        memset(mask, 0, maskBytes);
+        size_t offset = kHeaderSize + maskBytes;
+        for (size_t s = 0; s < count_; ++s) {
+            const size_t at = offsets_[s];
+            const size_t size = sizes_[s];
+            if (at + size > length) {
+                // Cut short by this packet: its bytes cannot travel as a delta
+                if (at < length && memcmp(packet + at, key_ + at, length - at) != 0) {
+                    return 0;
+                }
+                continue;
+            }
+            if (memcmp(packet + at, key_ + at, size) == 0) {
+                continue;
+            }
+            mask[s / 8] |= static_cast<uint8_t>(1U << (s % 8));
+
+            size_t written;
+            if (kinds_[s] == Raw) {
+                if (offset + size > limit) {
+                    return 0;
+                }
+                memcpy(out + offset, packet + at, size);
+                written = size;
+            } else {
+                const uint32_t current = load(packet + at, size);
+                const uint32_t base = load(key_ + at, size);
+                const uint32_t value = kinds_[s] == Xor ? current ^ base : zigzag(current, base, size);
+                written = putVarint(out + offset, limit - offset, value);
+                if (written == 0) {
+                    return 0;
+                }
+            }
+            offset += written;
+        }
+
+        writeHeader(out, packet, kDeltaDelta);
+        return offset;
+    }
+
+    static uint32_t load(const uint8_t* data, size_t size) {
+        uint32_t value = 0;
+        memcpy(&value, data, size);
+        return value;
+    }
+
+    static uint32_t sizeMask(size_t size) {
+        return size >= 4 ? 0xFFFFFFFFu : (1u << (size * 8)) - 1u;
+    }
+
+    // Zigzag of the difference, wrapped to the segment size and sign-extended
+    static uint32_t zigzag(uint32_t current, uint32_t base, size_t size) {
+        const uint32_t bits = static_cast<uint32_t>(size * 8);
+        uint32_t wrapped = (current - base) & sizeMask(size);
+        if (bits < 32 && (wrapped >> (bits - 1))) {
+            wrapped |= ~sizeMask(size);
+        }
+        const int32_t difference = static_cast<int32_t>(wrapped);
+        return (static_cast<uint32_t>(difference) << 1) ^ static_cast<uint32_t>(difference >> 31);
+    }
+
+    static size_t putVarint(uint8_t* out, size_t capacity, uint32_t value) {
+        size_t n = 0;
+        do {
+            if (n >= capacity) {
+                return 0;
+            }
+            const uint8_t byte = value & 0x7F;
+            value >>= 7;
+            out[n++] = value ? (byte | 0x80) : byte;
+        } while (value);
+        return n;
+    }
+
+    uint8_t offsets_[kDeltaMaxSegments];
+    uint8_t sizes_[kDeltaMaxSegments];
+    Segment kinds_[kDeltaMaxSegments];
+    uint8_t count_;
+    uint8_t covered_[kDeltaMaxPacketSize / 8];
+    uint8_t key_[kDeltaMaxPacketSize];
+    uint8_t keyLength_;
+    uint8_t keySeq_;
+    uint8_t sinceKey_;
+    uint8_t interval_;
+    bool haveKey_;
+    uint32_t keyframes_;
+    uint32_t deltas_;
+};
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_DELTA_H
@@ -0,0 +1,406 @@
+/**
+ * @file RobotDispatch.h
+ * @brief Route the controller's command frames to per-packet handlers
+ *
+ * The controller can send a command packet in several wrappings, depending
+ * on the module's descriptors and ILITEConfig:
+ *
+ * | Wrapping                    | Controller side       | Here                               |
+ * |-----------------------------|-----------------------|------------------------------------|
+ * | Plain packet                | -                     | Routed by magic                    |
+ * | Bundle (BNDL)               | `bundleable`          | Each sub-packet routed             |
+ * | Redundant (REDN)            | `redundancy` + config | Lost copies rebuilt, dupes dropped |
+ * | Stamp (STMP) around any     | `commandStamps`       | Stripped, kept for the echo        |
+ *
+ * A route is the robot's half of a command PacketDescriptor: magic, size
+ * range and a handler. Sizes are checked before the handler runs, so a
+ * handler can memcpy the packet into its struct without checks of its own.
+ * addPacket<T>() does that copy and hands the handler a `const T&`.
+ *
+ * Each route keeps its own RedundantReader, so redundant types recover
+ * independently. Frames no route claims go to the fallback handler (e.g.
+ * the robot's own parser for legacy packets), or are counted as unknown.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * ILITERobot::Dispatcher dispatcher;
+ *
+ * void onDrive(const DriveCommand& drive, void*) { motors.set(drive.left, drive.right); }
+ *
+ * void setup() {
+ *     dispatcher.addPacket<DriveCommand>(DRIVE_MAGIC, onDrive);
+ *     dispatcher.addRoute(ARM_MAGIC, 8, 24, onArm);        // variable length
+ *     dispatcher.addRoute(ILITERobot::kRateRequestMagic, ILITERobot::kRateHeaderSize,
+ *                         ILITERobot::kMaxFrameSize, ILITERobot::TelemetryScheduler::rateRoute,
+ *                         &telemetry);
+ * }
+ *
+ * // In the loop, for each frame drained from the RxRing:
+ * dispatcher.handle(frame->data, frame->length);
+ * ```
+ *
+ * ## Thread Safety:
+ * One task (the loop draining the RxRing). Handlers run on it.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_DISPATCH_H
+#define ILITE_ROBOT_DISPATCH_H
+
+#include <type_traits>
+#include "RobotWire.h"
+
+namespace ILITERobot {
+
+/// Receives one packet; `length` is within the route's size range
+using PacketHandler = void (*)(const uint8_t* packet, size_t length, void* context);
+
+/**
+ * @class RedundantReader
+ * @brief Deliver the copies of a redundant frame that are new, oldest first
+ *
+ * Same rules as RedundantPacketReader on the controller: before the first
+ * frame only the newest copy is delivered; after that every carried copy
+ * newer than the last delivered one, and frames not newer are dropped.
+ */
+class RedundantReader {
+public:
+    RedundantReader() : lastSequence_(0), synced_(false), recovered_(0), lost_(0) {}
+
+    /// Forget the last sequence (new link)
+    void reset() { synced_ = false; }
+
+    /**
+     * @brief Deliver the new copies of a redundant frame
+     * @return Copies delivered (0 for a duplicate), or -1 if the frame is malformed
+     */
+    int deliver(const uint8_t* data, size_t length, PacketHandler handler, void* context) {
+        if (data == nullptr || length < kRedundantHeaderSize + 2 || handler == nullptr ||
+            frameMagic(data, length) != kRedundantMagic) {
+            return -1;
+        }
+
+        uint16_t sequence;
+        memcpy(&sequence, data + sizeof(uint32_t), sizeof(sequence));
+        const size_t count = data[kRedundantHeaderSize - 1];
+        if (count == 0 || count > kRedundantMaxDepth + 1) {
+            return -1;
+        }
+
+        // Locate every entry first; they are stored newest first
+        const uint8_t* entries[kRedundantMaxDepth + 1];
+        size_t lengths[kRedundantMaxDepth + 1];
+        size_t offset = kRedundantHeaderSize;
+        for (size_t k = 0; k < count; ++k) {
+            if (offset >= length) {
+                return -1;
+            }
+            lengths[k] = data[offset++];
+            if (lengths[k] == 0 || offset + lengths[k] > length) {
+                return -1;
+            }
+            entries[k] = data + offset;
+            offset += lengths[k];
+        }
+
+        size_t fresh = 1;       // No history to repair before the first frame
+        if (synced_) {
+            const int16_t ahead = static_cast<int16_t>(sequence - lastSequence_);
+            if (ahead <= 0) {
+                return 0;       // Duplicate or reordered
+            }
+            fresh = count;
+            if (static_cast<size_t>(ahead) < count) {
+                fresh = static_cast<size_t>(ahead);
+            } else {
+                lost_ += static_cast<size_t>(ahead) - count;
+            }
+        }
+
+        for (size_t k = fresh; k-- > 0;) {
+            handler(entries[k], lengths[k], context);
+        }
+        recovered_ += static_cast<uint32_t>(fresh - 1);
+        lastSequence_ = sequence;
+        synced_ = true;
+        return static_cast<int>(fresh);
+    }
+
+    /// Lost frames rebuilt from later frames
+    uint32_t getRecovered() const { return recovered_; }
+
+    /// Frames lost beyond what the carried copies could rebuild
+    uint32_t getLost() const { return lost_; }
+
+private:
+    uint16_t lastSequence_;
+    bool synced_;
+    uint32_t recovered_;
+    uint32_t lost_;
+};
+
+/**
+ * @brief Dispatcher counters
+ */
+struct DispatchStats {
+    uint32_t frames = 0;            ///< Frames passed to handle()
+    uint32_t packets = 0;           ///< Packets delivered to a route
+    uint32_t stamped = 0;           ///< Frames that carried a command stamp
+    uint32_t bundles = 0;
+    uint32_t duplicates = 0;        ///< Redundant frames with nothing new
+    uint32_t recovered = 0;         ///< Lost packets rebuilt from redundant copies
+    uint32_t unknown = 0;           ///< No route and no fallback
+    uint32_t sizeRejected = 0;      ///< Outside the route's size range
+    uint32_t malformed = 0;         ///< Framing that does not parse
+};
+
+/**
+ * @class Dispatcher
+ * @brief Unwrap command frames and route their packets by magic
+ */
+class Dispatcher {
+public:
+    static constexpr size_t kMaxRoutes = 16;
+
+    Dispatcher() : routeCount_(0), fallback_(nullptr), fallbackContext_(nullptr), haveStamp_(false) {
+        memset(&stamp_, 0, sizeof(stamp_));
+    }
+
+    /**
+     * @brief Route packets with `magic` and a length in [minSize, maxSize] to `handler`
+     *
+     * Adding a magic again replaces its route.
+     *
+     * @return false if kMaxRoutes routes exist already
+     */
+    bool addRoute(uint32_t magic, size_t minSize, size_t maxSize, PacketHandler handler,
+                  void* context = nullptr) {
+        if (handler == nullptr || minSize < sizeof(uint32_t) || minSize > maxSize) {
+            return false;
+        }
+        Route* route = find(magic);
+        if (route == nullptr) {
+            if (routeCount_ >= kMaxRoutes) {
+                return false;
+            }
+            route = &routes_[routeCount_++];
+        }
+        *route = Route();
+        route->magic = magic;
+        route->minSize = static_cast<uint8_t>(minSize < kMaxFrameSize ? minSize : kMaxFrameSize);
+        route->maxSize = static_cast<uint8_t>(maxSize < kMaxFrameSize ? maxSize : kMaxFrameSize);
+        route->handler = handler;
+        route->context = context;
+        return true;
+    }
+
+    /**
+     * @brief Route a fixed-size packet struct; the handler gets an aligned copy
+     */
+    template<typename T>
+    bool addPacket(uint32_t magic, void (*handler)(const T& packet, void* context), void* context = nullptr) {
+        static_assert(std::is_trivially_copyable<T>::value, "Packet structs must be trivially copyable");
+        static_assert(sizeof(T) >= sizeof(uint32_t) && sizeof(T) <= kMaxFrameSize,
+                      "Packet struct must hold a magic and fit an ESP-NOW frame");
+        if (handler == nullptr || !addRoute(magic, sizeof(T), sizeof(T), deliverTyped<T>, context)) {
+            return false;
+        }
+        find(magic)->typed = reinterpret_cast<void (*)()>(handler);
+        return true;
+    }
+
+    /// Frames without a route (discovery packets are not passed in here)
+    void setFallback(PacketHandler handler, void* context = nullptr) {
+        fallback_ = handler;
+        fallbackContext_ = context;
+    }
+
+    /**
+     * @brief Unwrap one received frame and deliver its packets
+     * @return Packets delivered to routes
+     */
+    size_t handle(const uint8_t* data, size_t length) {
+        stats_.frames++;
+        const uint32_t delivered = stats_.packets;
+        if (data == nullptr || length < sizeof(uint32_t)) {
+            stats_.malformed++;
+            return 0;
+        }
+
+        // Stamp around the whole frame: applied once its packets are handled
+        StampHeader stamp;
+        const bool stamped = frameMagic(data, length) == kStampMagic;
+        if (stamped) {
+            if (length < kStampSize + sizeof(uint32_t)) {
+                stats_.malformed++;
+                return 0;
+            }
+            memcpy(&stamp, data, sizeof(stamp));
+            data += kStampSize;
+            length -= kStampSize;
+            stats_.stamped++;
+        }
+
+        if (frameMagic(data, length) == kBundleMagic) {
+            stats_.bundles++;
+            if (length < kBundleHeaderSize + 1) {
+                stats_.malformed++;
+            }
+            size_t offset = kBundleHeaderSize;
+            while (offset < length) {
+                const size_t subLength = data[offset++];
+                if (subLength == 0 || offset + subLength > length) {
+                    stats_.malformed++;
+                    break;
+                }
+                dispatch(data + offset, subLength);
+                offset += subLength;
+            }
+        } else {
+            dispatch(data, length);
+        }
+
+        if (stamped) {
+            stamp_ = stamp;
+            haveStamp_ = true;
+        }
+        return stats_.packets - delivered;
+    }
+
+    /**
+     * @brief Last command stamp applied, to echo on telemetry (nullptr if none yet)
+     */
+    const StampHeader* getStamp() const { return haveStamp_ ? &stamp_ : nullptr; }
+
+    /// Packets delivered to the route of `magic`
+    uint32_t getPacketCount(uint32_t magic) const {
+        const Route* route = find(magic);
+        return route != nullptr ? route->packets : 0;
+    }
+
+    const DispatchStats& getStats() const { return stats_; }
+
+    /// Forget redundant sequences and the stamp (new link); counters stay
+    void reset() {
+        for (size_t i = 0; i < routeCount_; ++i) {
+            routes_[i].reader.reset();
+        }
+        haveStamp_ = false;
+    }
+
+private:
+    struct Route {
+        uint32_t magic = 0;
+        uint8_t minSize = 0;
+        uint8_t maxSize = 0;
+        PacketHandler handler = nullptr;
+        void* context = nullptr;
+        void (*typed)() = nullptr;      ///< addPacket() handler, called by deliverTyped()
+        RedundantReader reader;
+        uint32_t packets = 0;
+    };
+
+    template<typename T>
+    static void deliverTyped(const uint8_t* packet, size_t length, void* context) {
+        (void)length;
+        const Route* route = static_cast<const Route*>(context);
+        T value;
+        memcpy(&value, packet, sizeof(value));
+        reinterpret_cast<void (*)(const T&, void*)>(route->typed)(value, route->context);
+    }
+
+    // One packet: plain, or a redundant frame of its route's type
+    void dispatch(const uint8_t* packet, size_t length) {
+        if (length < sizeof(uint32_t)) {
+            stats_.malformed++;
+            return;
+        }
+        const bool redundant = frameMagic(packet, length) == kRedundantMagic;
+        uint32_t magic = frameMagic(packet, length);
+        if (redundant) {
+            // The newest copy names the type
+            if (length < kRedundantHeaderSize + 1 + sizeof(uint32_t)) {
+                stats_.malformed++;
+                return;
+            }
+            magic = frameMagic(packet + kRedundantHeaderSize + 1, sizeof(uint32_t));
+        }
+
+        Route* route = find(magic);
+        if (route == nullptr) {
+            if (fallback_ != nullptr) {
+                fallback_(packet, length, fallbackContext_);
+            } else {
+                stats_.unknown++;
+            }
+            return;
+        }
+
+        if (!redundant) {
+            deliver(*route, packet, length);
+            return;
+        }
+        CopyContext copy{this, route};
+        const uint32_t recovered = route->reader.getRecovered();
+        const int copies = route->reader.deliver(packet, length, deliverCopy, &copy);
+        if (copies < 0) {
+            stats_.malformed++;
+        } else if (copies == 0) {
+            stats_.duplicates++;
+        }
+        stats_.recovered += route->reader.getRecovered() - recovered;
+    }
+
+    struct CopyContext {
+        Dispatcher* dispatcher;
+        Route* route;
+    };
+
+    static void deliverCopy(const uint8_t* packet, size_t length, void* context) {
+        CopyContext* copy = static_cast<CopyContext*>(context);
+        copy->dispatcher->deliver(*copy->route, packet, length);
+    }
+
+    void deliver(Route& route, const uint8_t* packet, size_t length) {
+        if (length < route.minSize || length > route.maxSize) {
+            stats_.sizeRejected++;
+            return;
+        }
+        // Typed routes get the route itself, to find their handler
+        route.handler(packet, length, route.typed != nullptr ? &route : route.context);
+        route.packets++;
+        stats_.packets++;
+    }
+
+    Route* find(uint32_t magic) {
+        for (size_t i = 0; i < routeCount_; ++i) {
+            if (routes_[i].magic == magic) {
+                return &routes_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const Route* find(uint32_t magic) const {
+        for (size_t i = 0; i < routeCount_; ++i) {
+            if (routes_[i].magic == magic) {
+                return &routes_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Route routes_[kMaxRoutes];
+    size_t routeCount_;
+    PacketHandler fallback_;
+    void* fallbackContext_;
+    StampHeader stamp_;
+    bool haveStamp_;
+    DispatchStats stats_;
+};
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_DISPATCH_H
@@ -0,0 +1,305 @@
+/**
+ * @file RobotLink.h
+ * @brief The robot's half of ILITE discovery: pairing, keepalive, time sync, resume
+ *
+ * LinkResponder answers the controller's discovery packets the way the
+ * framework's own "controlled" role does (espnow_discovery.cpp), without
+ * WiFi or Arduino dependencies. The robot passes frames in and supplies a
+ * send function and its clock:
+ *
+ * | Controller sends     | LinkResponder                                          |
+ * |----------------------|--------------------------------------------------------|
+ * | PAIR_REQ (broadcast) | IDENTITY_REPLY, unless paired                          |
+ * | PAIR_CONFIRM         | Paired; keeps the session token; PAIR_ACK              |
+ * | PING                 | PONG at once, with arrival and send stamps (ClockSync) |
+ * | RESUME               | RESUME_ACK with the token, or 0 if it does not match   |
+ * | RESUME_ACK           | Resumed, or the session cleared if refused (token 0)   |
+ * | KEEPALIVE            | Nothing to do                                          |
+ *
+ * - **Time sync**: the pong carries the ping's arrival time (the RxRing
+ *   stamp) and a send time taken last, just before the send function, so
+ *   the controller's ClockSync sees only the radio in the round trip.
+ * - **Fast resume**: a robot that stored its session (getSession(),
+ *   getSessionPeer()) before a reboot calls resume() with it. RESUME goes
+ *   out at once and then with backoff (kResumeRetryMs doubling to
+ *   kResumeMaxRetryMs) until the controller acknowledges, which skips the
+ *   broadcast pairing round.
+ * - **Keepalive**: every kKeepaliveMs while paired, from poll().
+ *
+ * Channel moves and slot beacons are not handled: handle() returns false
+ * so the robot can act on them itself.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * uint32_t clockUs() { return static_cast<uint32_t>(esp_timer_get_time()); }
+ *
+ * ILITERobot::LinkResponder link("TheGill", "gill-01", ownMac, sendFrame, nullptr, clockUs);
+ *
+ * // In the loop
+ * if (!link.handle(frame->mac, frame->data, frame->length, frame->timestampUs, millis())) {
+ *     dispatcher.handle(frame->data, frame->length);
+ * }
+ * link.poll(millis());
+ * ```
+ *
+ * ## Thread Safety:
+ * One task (the loop draining the RxRing).
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_LINK_H
+#define ILITE_ROBOT_LINK_H
+
+#include "RobotWire.h"
+
+namespace ILITERobot {
+
+/// Robot clock in microseconds (low 32 bits of esp_timer_get_time())
+using ClockFunction = uint32_t (*)();
+
+/**
+ * @brief Link responder counters
+ */
+struct LinkStats {
+    uint32_t pairRequests = 0;
+    uint32_t pairings = 0;
+    uint32_t pings = 0;
+    uint32_t resumes = 0;           ///< Resumes completed, either side starting
+    uint32_t resumesRefused = 0;
+    uint32_t keepalives = 0;
+    uint32_t sendFailures = 0;
+};
+
+/**
+ * @class LinkResponder
+ * @brief Discovery state of one robot paired with one controller
+ */
+class LinkResponder {
+public:
+    static constexpr uint32_t kKeepaliveMs = 5000;          ///< KEEPALIVE_INTERVAL_MS
+    static constexpr uint32_t kResumeRetryMs = 100;         ///< EspNowDiscovery::kResumeRetryMs
+    static constexpr uint32_t kResumeMaxRetryMs = 1000;
+
+    /**
+     * @param platform Identity platform ("TheGill"), at most 15 characters
+     * @param customId Identity id the controller matches modules against
+     * @param ownMac This robot's station MAC
+     * @param clock Time source for pong stamps
+     */
+    LinkResponder(const char* platform, const char* customId, const uint8_t* ownMac,
+                  SendFunction send, void* context, ClockFunction clock)
+        : send_(send),
+          sendContext_(context),
+          clock_(clock),
+          paired_(false),
+          resuming_(false),
+          token_(0),
+          lastKeepaliveMs_(0),
+          lastResumeMs_(0),
+          resumeRetryMs_(kResumeRetryMs)
+    {
+        memset(&self_, 0, sizeof(self_));
+        strncpy(self_.deviceType, "controlled", sizeof(self_.deviceType) - 1);
+        if (platform != nullptr) {
+            strncpy(self_.platform, platform, sizeof(self_.platform) - 1);
+        }
+        if (customId != nullptr) {
+            strncpy(self_.customId, customId, sizeof(self_.customId) - 1);
+        }
+        if (ownMac != nullptr) {
+            memcpy(self_.mac, ownMac, sizeof(self_.mac));
+        }
+        memset(peer_, 0, sizeof(peer_));
+        memset(sessionMac_, 0, sizeof(sessionMac_));
+    }
+
+    /**
+     * @brief Consume a discovery packet
+     * @param rxUs Arrival time on the robot clock (RxFrame::timestampUs)
+     * @return true if it was a discovery packet this class handled
+     */
+    bool handle(const uint8_t* mac, const uint8_t* data, size_t length, uint32_t rxUs, uint32_t nowMs) {
+        if (mac == nullptr || !isDiscoveryPacket(data, length)) {
+            return false;
+        }
+        DiscoveryPacket packet;
+        memcpy(&packet, data, sizeof(packet));
+
+        switch (packet.type) {
+            case MessageType::PairRequest:
+                if (!paired_) {
+                    stats_.pairRequests++;
+                    sendPacket(MessageType::IdentityReply, mac, nowMs, 0);
+                }
+                return true;
+
+            case MessageType::PairConfirm:
+                // Team confirms carry no session
+                if (packet.reserved != 0) {
+                    token_ = packet.reserved;
+                    memcpy(sessionMac_, mac, sizeof(sessionMac_));
+                }
+                pair(mac, nowMs);
+                stats_.pairings++;
+                sendPacket(MessageType::PairAck, mac, nowMs, 0);
+                return true;
+
+            case MessageType::Ping:
+                stats_.pings++;
+                sendPong(mac, packet, rxUs);
+                return true;
+
+            case MessageType::Resume:
+                if (paired_ && memcmp(mac, peer_, sizeof(peer_)) != 0) {
+                    return true;    // Paired elsewhere: not ours to answer
+                }
+                if (token_ == 0 || packet.reserved != token_ ||
+                    memcmp(mac, sessionMac_, sizeof(sessionMac_)) != 0) {
+                    stats_.resumesRefused++;
+                    sendPacket(MessageType::ResumeAck, mac, nowMs, 0);
+                    return true;
+                }
+                pair(mac, nowMs);
+                stats_.resumes++;
+                sendPacket(MessageType::ResumeAck, mac, nowMs, token_);
+                return true;
+
+            case MessageType::ResumeAck:
+                if (!resuming_ || memcmp(mac, sessionMac_, sizeof(sessionMac_)) != 0) {
+                    return true;
+                }
+                if (packet.reserved != 0 && packet.reserved == token_) {
+                    pair(mac, nowMs);
+                    stats_.resumes++;
+                } else {
+                    // The controller lost the session: wait for a pair request
+                    stats_.resumesRefused++;
+                    resuming_ = false;
+                    token_ = 0;
+                }
+                return true;
+
+            case MessageType::Keepalive:
+            case MessageType::IdentityReply:
+            case MessageType::PairAck:
+            case MessageType::Pong:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    /// Keepalives while paired, RESUME retries while resuming
+    void poll(uint32_t nowMs) {
+        if (paired_) {
+            if (nowMs - lastKeepaliveMs_ >= kKeepaliveMs) {
+                sendPacket(MessageType::Keepalive, peer_, nowMs, 0);
+                stats_.keepalives++;
+                lastKeepaliveMs_ = nowMs;
+            }
+        } else if (resuming_ && nowMs - lastResumeMs_ >= resumeRetryMs_) {
+            retryResume(nowMs);
+        }
+    }
+
+    /**
+     * @brief Resume a stored session with its controller (e.g. after a reboot)
+     * @return false if there is no token or the link is up already
+     */
+    bool resume(const uint8_t* mac, uint32_t token, uint32_t nowMs) {
+        if (mac == nullptr || token == 0 || paired_) {
+            return false;
+        }
+        memcpy(peer_, mac, sizeof(peer_));
+        memcpy(sessionMac_, mac, sizeof(sessionMac_));
+        token_ = token;
+        resuming_ = true;
+        resumeRetryMs_ = kResumeRetryMs;
+        retryResume(nowMs);
+        return true;
+    }
+
+    /// Link lost (e.g. no commands for the failsafe time); the session is kept
+    void unpair() {
+        paired_ = false;
+        resuming_ = false;
+    }
+
+    bool isPaired() const { return paired_; }
+    bool isResuming() const { return resuming_; }
+
+    /// Controller MAC (valid while paired or resuming)
+    const uint8_t* getPeer() const { return peer_; }
+
+    /// Session token to store for resume() (0 = none)
+    uint32_t getSession() const { return token_; }
+
+    /// Controller the session is with
+    const uint8_t* getSessionPeer() const { return sessionMac_; }
+
+    const LinkStats& getStats() const { return stats_; }
+
+private:
+    void pair(const uint8_t* mac, uint32_t nowMs) {
+        memcpy(peer_, mac, sizeof(peer_));
+        paired_ = true;
+        resuming_ = false;
+        lastKeepaliveMs_ = nowMs;
+    }
+
+    void retryResume(uint32_t nowMs) {
+        sendPacket(MessageType::Resume, peer_, nowMs, token_);
+        lastResumeMs_ = nowMs;
+        resumeRetryMs_ = resumeRetryMs_ * 2 < kResumeMaxRetryMs ? resumeRetryMs_ * 2 : kResumeMaxRetryMs;
+    }
+
+    void sendPacket(MessageType type, const uint8_t* mac, uint32_t stamp, uint32_t reserved) {
+        DiscoveryPacket packet;
+        packet.version = kProtocolVersion;
+        packet.type = type;
+        packet.id = self_;
+        packet.monotonicMs = stamp;
+        packet.reserved = reserved;
+        transmit(mac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
+    }
+
+    void sendPong(const uint8_t* mac, const DiscoveryPacket& ping, uint32_t pingRxUs) {
+        PongPacket pong;
+        pong.header.version = kProtocolVersion;
+        pong.header.type = MessageType::Pong;
+        pong.header.id = self_;
+        pong.header.monotonicMs = ping.monotonicMs;
+        pong.header.reserved = ping.reserved;
+        pong.pingRxUs = pingRxUs;
+        // Stamped last so the controller's delay excludes the time held here
+        pong.pongTxUs = clock_ != nullptr ? clock_() : pingRxUs;
+        transmit(mac, reinterpret_cast<const uint8_t*>(&pong), sizeof(pong));
+    }
+
+    void transmit(const uint8_t* mac, const uint8_t* frame, size_t length) {
+        if (send_ == nullptr || !send_(mac, frame, length, sendContext_)) {
+            stats_.sendFailures++;
+        }
+    }
+
+    SendFunction send_;
+    void* sendContext_;
+    ClockFunction clock_;
+    Identity self_;
+    uint8_t peer_[6];
+    uint8_t sessionMac_[6];
+    bool paired_;
+    bool resuming_;
+    uint32_t token_;
+    uint32_t lastKeepaliveMs_;
+    uint32_t lastResumeMs_;
+    uint32_t resumeRetryMs_;
+    LinkStats stats_;
+};
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_LINK_H
@@ -0,0 +1,146 @@
+/**
+ * @file RobotRxRing.h
+ * @brief Receive ring between the robot's ESP-NOW callback and its control loop
+ *
+ * The ESP-NOW receive callback runs on the WiFi task. Parsing commands
+ * there races the control loop, and doing the work there delays the radio.
+ * The callback only copies the frame into this ring. The loop drains it
+ * through a Dispatcher, as RxTask does with RxRing on the controller:
+ *
+ * - **SPSC**: one producer (callback), one consumer (loop). No locks;
+ *   head and tail are atomics, and a slot is published with a release store.
+ * - **Stamped**: each frame keeps the time it arrived, so the loop can
+ *   answer pings and judge command age from the arrival, not the drain.
+ * - **Bounded**: a full ring drops the new frame and counts it. Size the
+ *   capacity for the longest loop stall; 8 frames cover 40 ms at 200 Hz.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * ILITERobot::RxRing<8> rxRing;
+ *
+ * void onReceive(const uint8_t* mac, const uint8_t* data, int len) {
+ *     rxRing.push(mac, data, len, micros());
+ * }
+ *
+ * void loop() {
+ *     while (const ILITERobot::RxFrame* frame = rxRing.front()) {
+ *         if (!link.handle(frame->mac, frame->data, frame->length, frame->timestampUs, millis())) {
+ *             dispatcher.handle(frame->data, frame->length);
+ *         }
+ *         rxRing.pop();
+ *     }
+ * }
+ * ```
+ *
+ * ## Thread Safety:
+ * push() from one task (the receive callback), front()/pop() from one other.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_RX_RING_H
+#define ILITE_ROBOT_RX_RING_H
+
+#include <atomic>
+#include "RobotWire.h"
+
+namespace ILITERobot {
+
+/**
+ * @brief One received frame, stamped on arrival
+ */
+struct RxFrame {
+    uint8_t mac[6];                 ///< Sender MAC address
+    uint8_t length;                 ///< Payload length in bytes
+    uint32_t timestampUs;           ///< Robot clock when the callback fired
+    uint8_t data[kMaxFrameSize];
+};
+
+/**
+ * @class RxRing
+ * @brief Fixed-capacity SPSC ring of RxFrame slots
+ */
+template<size_t Capacity = 8>
+class RxRing {
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "RxRing capacity must be a power of two");
+
+    static constexpr size_t kCapacity = Capacity;
+
+    RxRing() : head_(0), tail_(0), overflowCount_(0), highWaterMark_(0) {}
+
+    /**
+     * @brief Copy a frame into the next free slot (producer side)
+     * @return false if the ring was full or the frame oversized (frame dropped)
+     */
+    bool push(const uint8_t* mac, const uint8_t* data, int length, uint32_t nowUs) {
+        if (mac == nullptr || data == nullptr || length <= 0 ||
+            length > static_cast<int>(kMaxFrameSize)) {
+            overflowCount_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t used = head - tail_.load(std::memory_order_acquire);
+        if (used >= Capacity) {
+            overflowCount_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        RxFrame& slot = slots_[head & (Capacity - 1)];
+        memcpy(slot.mac, mac, sizeof(slot.mac));
+        slot.length = static_cast<uint8_t>(length);
+        slot.timestampUs = nowUs;
+        memcpy(slot.data, data, static_cast<size_t>(length));
+        head_.store(head + 1, std::memory_order_release);
+
+        if (used + 1 > highWaterMark_.load(std::memory_order_relaxed)) {
+            highWaterMark_.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Oldest unread frame, or nullptr if empty (consumer side)
+     *
+     * The pointer stays valid until pop() is called.
+     */
+    const RxFrame* front() const {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[tail & (Capacity - 1)];
+    }
+
+    /// Release the frame returned by front() (consumer side)
+    void pop() {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail != head_.load(std::memory_order_acquire)) {
+            tail_.store(tail + 1, std::memory_order_release);
+        }
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /// Frames dropped because the ring was full or they were oversized
+    uint32_t getOverflowCount() const { return overflowCount_.load(std::memory_order_relaxed); }
+
+    /// Most frames queued at once
+    uint32_t getHighWaterMark() const { return highWaterMark_.load(std::memory_order_relaxed); }
+
+private:
+    RxFrame slots_[Capacity];
+    std::atomic<uint32_t> head_;    ///< Next slot to write (producer owned)
+    std::atomic<uint32_t> tail_;    ///< Next slot to read (consumer owned)
+    std::atomic<uint32_t> overflowCount_;
+    std::atomic<uint32_t> highWaterMark_;
+};
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_RX_RING_H
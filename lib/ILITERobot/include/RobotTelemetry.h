@@ -0,0 +1,393 @@
+/**
+ * @file RobotTelemetry.h
+ * @brief Pace, pack and send the robot's telemetry the way the controller asks
+ *
+ * A robot declares each telemetry type once, with the interval it uses on
+ * its own and a function that builds the packet. poll() in the loop then
+ * sends whatever is due:
+ *
+ * - **Rate requests**: the controller's RATE frames (RateRequest.h) set the
+ *   interval per type. Types missing from a request, and every type once a
+ *   request is kRateTimeoutMs old, return to their defaults.
+ * - **Bundling**: the types due in one poll() share a frame (BNDL) up to
+ *   the ESP-NOW payload, so three 20-byte packets cost one transmission. A
+ *   lone packet goes out plain.
+ * - **Delta encoding**: types enabled with enableDelta() are sent as
+ *   DeltaWriter frames; the controller descriptor must set `deltaEncoded`
+ *   with the same fields.
+ * - **Stamp echo**: with setEcho(true), every frame is wrapped in an ECHO
+ *   of the last command stamp the Dispatcher applied. The controller then
+ *   measures input -> command applied -> telemetry back. Send right after
+ *   handling commands to keep that number honest.
+ *
+ * Interval timing follows RateRequestFollower: a type is due when its
+ * interval passed since it was last sent, counted from the send, so a late
+ * loop does not burst.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * size_t buildState(uint8_t* out, size_t capacity, void*) {
+ *     const RobotState state = readState();
+ *     memcpy(out, &state, sizeof(state));
+ *     return sizeof(state);
+ * }
+ *
+ * ILITERobot::TelemetryScheduler telemetry(sendFrame, nullptr);
+ * telemetry.addType(STATE_MAGIC, 100, buildState);         // 10 Hz unless asked
+ * telemetry.enableDelta(STATE_MAGIC, kStateFields, 3, sizeof(RobotState));
+ * telemetry.setEcho(true);
+ *
+ * // In the loop, after draining the RxRing:
+ * telemetry.poll(controllerMac, millis(), dispatcher.getStamp());
+ * ```
+ *
+ * ## Thread Safety:
+ * One task. rateRoute() runs from Dispatcher::handle() on that task.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_TELEMETRY_H
+#define ILITE_ROBOT_TELEMETRY_H
+
+#include "RobotDelta.h"
+
+namespace ILITERobot {
+
+/**
+ * @brief Builds one telemetry packet (starting with its magic) into `out`
+ * @return Packet length, or 0 to skip this interval
+ */
+using BuildFunction = size_t (*)(uint8_t* out, size_t capacity, void* context);
+
+/**
+ * @brief Telemetry scheduler counters
+ */
+struct TelemetryStats {
+    uint32_t frames = 0;            ///< Frames handed to the send function
+    uint32_t packets = 0;           ///< Packets in those frames
+    uint32_t bundles = 0;           ///< Frames carrying more than one packet
+    uint32_t keyframes = 0;
+    uint32_t deltas = 0;
+    uint32_t echoes = 0;            ///< Frames wrapped in a stamp echo
+    uint32_t sendFailures = 0;
+    uint32_t dropped = 0;           ///< Packets that could not be built or framed
+    uint32_t rateRequests = 0;
+};
+
+/**
+ * @class TelemetryScheduler
+ * @brief Robot's telemetry types, their rates and the frames they go out in
+ */
+class TelemetryScheduler {
+public:
+    static constexpr size_t kMaxTypes = kRateMaxEntries;
+    static constexpr size_t kMaxDeltaTypes = 4;
+
+    TelemetryScheduler(SendFunction send, void* context)
+        : send_(send),
+          sendContext_(context),
+          count_(0),
+          deltaCount_(0),
+          echo_(false),
+          bundle_(true),
+          haveRequest_(false),
+          requestMs_(0),
+          nowMs_(0),
+          frameLength_(0),
+          framePackets_(0),
+          plain_(false)
+    {
+    }
+
+    /**
+     * @brief Declare a telemetry type, its default interval and its builder
+     *
+     * Declaring a magic again updates it. Types are built in declaration
+     * order when several are due.
+     *
+     * @return false if kMaxTypes types are declared already
+     */
+    bool addType(uint32_t magic, uint16_t defaultIntervalMs, BuildFunction build, void* context = nullptr) {
+        if (build == nullptr) {
+            return false;
+        }
+        Type* type = find(magic);
+        if (type == nullptr) {
+            if (count_ >= kMaxTypes) {
+                return false;
+            }
+            type = &types_[count_++];
+            *type = Type();
+            type->magic = magic;
+        }
+        type->defaultMs = defaultIntervalMs;
+        type->build = build;
+        type->context = context;
+        return true;
+    }
+
+    /**
+     * @brief Send a declared type delta-encoded (its descriptor sets `deltaEncoded`)
+     * @return false if the type is undeclared or kMaxDeltaTypes are enabled already
+     */
+    bool enableDelta(uint32_t magic, const DeltaField* fields, size_t fieldCount, size_t packetSize,
+                     uint8_t keyframeInterval = DeltaWriter::kDefaultKeyframeInterval) {
+        Type* type = find(magic);
+        if (type == nullptr || packetSize > kDeltaMaxPacketSize) {
+            return false;
+        }
+        if (type->delta == nullptr) {
+            if (deltaCount_ >= kMaxDeltaTypes) {
+                return false;
+            }
+            type->delta = &deltas_[deltaCount_++];
+        }
+        *type->delta = DeltaWriter(fields, fieldCount, packetSize, keyframeInterval);
+        return true;
+    }
+
+    /// Wrap frames in an echo of the stamp passed to poll()
+    void setEcho(bool enabled) { echo_ = enabled; }
+
+    /// Pack the packets due together into bundles (default on)
+    void setBundling(bool enabled) { bundle_ = enabled; }
+
+    /**
+     * @brief Apply a rate request frame
+     * @return true if it was one (consumed)
+     */
+    bool handleRateRequest(const uint8_t* data, size_t length, uint32_t nowMs) {
+        if (data == nullptr || length < kRateHeaderSize || frameMagic(data, length) != kRateRequestMagic) {
+            return false;
+        }
+        const size_t count = data[sizeof(uint32_t)];
+        if (length < kRateHeaderSize + count * kRateEntrySize) {
+            return true;    // Truncated: ours, but not applied
+        }
+
+        // Types missing from the request go back to their defaults
+        for (size_t i = 0; i < count_; ++i) {
+            types_[i].requestedMs = 0;
+        }
+        const uint8_t* entry = data + kRateHeaderSize;
+        for (size_t i = 0; i < count; ++i, entry += kRateEntrySize) {
+            uint32_t magic;
+            uint16_t intervalMs;
+            memcpy(&magic, entry, sizeof(magic));
+            memcpy(&intervalMs, entry + sizeof(magic), sizeof(intervalMs));
+            Type* type = find(magic);
+            if (type != nullptr) {
+                type->requestedMs = intervalMs;
+            }
+        }
+        requestMs_ = nowMs;
+        haveRequest_ = true;
+        stats_.rateRequests++;
+        return true;
+    }
+
+    /**
+     * @brief Dispatcher route for rate requests (`context` = the scheduler)
+     *
+     * The request counts from the last poll(), which is close enough for
+     * timeouts of seconds.
+     */
+    static void rateRoute(const uint8_t* packet, size_t length, void* context) {
+        TelemetryScheduler* scheduler = static_cast<TelemetryScheduler*>(context);
+        scheduler->handleRateRequest(packet, length, scheduler->nowMs_);
+    }
+
+    /**
+     * @brief Build and send every type that is due
+     * @param echo Stamp to echo (Dispatcher::getStamp()), nullptr for none
+     * @return Packets sent
+     */
+    size_t poll(const uint8_t* mac, uint32_t nowMs, const StampHeader* echo = nullptr) {
+        nowMs_ = nowMs;
+        const uint32_t before = stats_.packets;
+        const StampHeader* wrap = echo_ ? echo : nullptr;
+        frameLength_ = 0;
+        framePackets_ = 0;
+
+        for (size_t i = 0; i < count_; ++i) {
+            Type& type = types_[i];
+            if (type.sent && nowMs - type.lastSentMs < intervalOf(type, nowMs)) {
+                continue;
+            }
+            // From now rather than from the slot, so a late loop does not burst
+            type.lastSentMs = nowMs;
+            type.sent = true;
+
+            uint8_t packet[kMaxFrameSize];
+            size_t length = type.build(packet, sizeof(packet), type.context);
+            if (length < sizeof(uint32_t) || length > sizeof(packet)) {
+                if (length != 0) {
+                    stats_.dropped++;
+                }
+                continue;
+            }
+            uint8_t encoded[DeltaWriter::kMaxFrameSize];
+            const uint8_t* out = packet;
+            if (type.delta != nullptr && length <= kDeltaMaxPacketSize) {
+                const uint32_t keyframes = type.delta->getKeyframes();
+                const size_t size = type.delta->encode(packet, length, encoded, sizeof(encoded));
+                if (size > 0) {
+                    out = encoded;
+                    length = size;
+                    if (type.delta->getKeyframes() != keyframes) {
+                        stats_.keyframes++;
+                    } else {
+                        stats_.deltas++;
+                    }
+                }
+            }
+            append(mac, out, length, wrap);
+        }
+        flush(mac, wrap);
+        return stats_.packets - before;
+    }
+
+    /// Interval in effect for the type (0 if undeclared)
+    uint16_t getIntervalMs(uint32_t magic, uint32_t nowMs) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (types_[i].magic == magic) {
+                return intervalOf(types_[i], nowMs);
+            }
+        }
+        return 0;
+    }
+
+    /// Link lost or new: drop the rate request and start deltas on a keyframe
+    void reset() {
+        haveRequest_ = false;
+        for (size_t i = 0; i < count_; ++i) {
+            types_[i].requestedMs = 0;
+        }
+        for (size_t i = 0; i < deltaCount_; ++i) {
+            deltas_[i].reset();
+        }
+    }
+
+    const TelemetryStats& getStats() const { return stats_; }
+
+private:
+    struct Type {
+        uint32_t magic = 0;
+        uint16_t defaultMs = 0;
+        uint16_t requestedMs = 0;   ///< 0 = not requested
+        uint32_t lastSentMs = 0;
+        bool sent = false;
+        BuildFunction build = nullptr;
+        void* context = nullptr;
+        DeltaWriter* delta = nullptr;
+    };
+
+    Type* find(uint32_t magic) {
+        for (size_t i = 0; i < count_; ++i) {
+            if (types_[i].magic == magic) {
+                return &types_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    uint16_t intervalOf(const Type& type, uint32_t nowMs) const {
+        if (haveRequest_ && type.requestedMs != 0 && nowMs - requestMs_ < kRateTimeoutMs) {
+            return type.requestedMs;
+        }
+        return type.defaultMs;
+    }
+
+    // Bytes the frame can still carry for one more bundled packet
+    size_t room(const StampHeader* echo) const {
+        const size_t limit = kMaxFrameSize - (echo != nullptr ? kStampSize : 0);
+        const size_t used = framePackets_ == 0 ? kBundleHeaderSize : frameLength_;
+        return limit > used + 1 ? limit - used - 1 : 0;
+    }
+
+    void append(const uint8_t* mac, const uint8_t* packet, size_t length, const StampHeader* echo) {
+        if (!bundle_ || length > room(echo)) {
+            flush(mac, echo);
+        }
+        if (!bundle_ || length > room(echo)) {
+            // Too large to bundle: alone, plain
+            if (length + (echo != nullptr ? kStampSize : 0) > kMaxFrameSize) {
+                stats_.dropped++;
+                return;
+            }
+            memcpy(frame_ + kStampSize, packet, length);
+            frameLength_ = length;
+            framePackets_ = 1;
+            plain_ = true;
+            flush(mac, echo);
+            return;
+        }
+        if (framePackets_ == 0) {
+            const uint32_t magic = kBundleMagic;
+            memcpy(frame_ + kStampSize, &magic, sizeof(magic));
+            frameLength_ = kBundleHeaderSize;
+            plain_ = false;
+        }
+        frame_[kStampSize + frameLength_++] = static_cast<uint8_t>(length);
+        memcpy(frame_ + kStampSize + frameLength_, packet, length);
+        frameLength_ += length;
+        framePackets_++;
+    }
+
+    void flush(const uint8_t* mac, const StampHeader* echo) {
+        if (framePackets_ == 0) {
+            return;
+        }
+        uint8_t* body = frame_ + kStampSize;
+        size_t length = frameLength_;
+        if (!plain_ && framePackets_ == 1) {
+            // A one-packet bundle goes out as the packet itself
+            body += kBundleHeaderSize + 1;
+            length -= kBundleHeaderSize + 1;
+        }
+        if (echo != nullptr) {
+            StampHeader header = *echo;
+            header.magic = kEchoMagic;
+            body -= kStampSize;
+            memcpy(body, &header, sizeof(header));
+            length += kStampSize;
+            stats_.echoes++;
+        }
+
+        if (send_ != nullptr && send_(mac, body, length, sendContext_)) {
+            stats_.frames++;
+            stats_.packets += framePackets_;
+            if (!plain_ && framePackets_ > 1) {
+                stats_.bundles++;
+            }
+        } else {
+            stats_.sendFailures++;
+        }
+        frameLength_ = 0;
+        framePackets_ = 0;
+    }
+
+    SendFunction send_;
+    void* sendContext_;
+    Type types_[kMaxTypes];
+    DeltaWriter deltas_[kMaxDeltaTypes];
+    size_t count_;
+    size_t deltaCount_;
+    bool echo_;
+    bool bundle_;
+    bool haveRequest_;
+    uint32_t requestMs_;
+    uint32_t nowMs_;
+    // Frame being filled; kStampSize bytes of headroom in front for the echo
+    uint8_t frame_[kStampSize + kMaxFrameSize];
+    size_t frameLength_;
+    size_t framePackets_;
+    bool plain_;                    ///< frame_ holds one packet without bundle framing
+    TelemetryStats stats_;
+};
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_TELEMETRY_H
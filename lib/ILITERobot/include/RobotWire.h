@@ -0,0 +1,132 @@
+/**
+ * @file RobotWire.h
+ * @brief Wire formats the robot shares with the ILITE controller
+ *
+ * Every constant and struct here mirrors a controller header, named in the
+ * comment next to it. The controller's native build (examples/NativeCore)
+ * static_asserts that both sides agree, so a format change on one side
+ * fails that build until the other follows.
+ *
+ * All multi-byte values are little-endian, as both ends are ESP32s. Frames
+ * are read with memcpy, never through casts of unaligned buffers.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_ROBOT_WIRE_H
+#define ILITE_ROBOT_WIRE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ILITERobot {
+
+constexpr size_t kMaxFrameSize = 250;               ///< ESP-NOW payload
+
+// Frame magics (ASCII, little-endian on the air)
+constexpr uint32_t kBundleMagic = 0x424E444C;       ///< 'BNDL', PacketBundle.h
+constexpr uint32_t kStampMagic = 0x53544D50;        ///< 'STMP', CommandStamp.h
+constexpr uint32_t kEchoMagic = 0x4543484F;         ///< 'ECHO', CommandStamp.h
+constexpr uint32_t kRateRequestMagic = 0x52415445;  ///< 'RATE', RateRequest.h
+constexpr uint32_t kDeltaMagic = 0x444C5441;        ///< 'DLTA', DeltaPacket.h
+constexpr uint32_t kRedundantMagic = 0x5245444E;    ///< 'REDN', RedundantPacket.h
+
+// Bundle: [magic:4]([len:1][packet])...
+constexpr size_t kBundleHeaderSize = sizeof(uint32_t);
+
+// Redundant: [magic:4][seq:2][count:1]([len:1][packet]) x count, newest first
+constexpr size_t kRedundantHeaderSize = sizeof(uint32_t) + sizeof(uint16_t) + 1;
+constexpr size_t kRedundantMaxDepth = 3;            ///< Previous copies carried at most
+
+// Rate request: [magic:4][count:1]([magic:4][intervalMs:2]) x count
+constexpr size_t kRateHeaderSize = sizeof(uint32_t) + 1;
+constexpr size_t kRateEntrySize = sizeof(uint32_t) + sizeof(uint16_t);
+constexpr size_t kRateMaxEntries = 8;
+constexpr uint32_t kRateTimeoutMs = 6000;           ///< 3 x RateRequestWriter::kRefreshMs
+
+// Delta: [magic:4][inner magic:4][keySeq:1][kind:1][body]
+constexpr size_t kDeltaHeaderSize = 2 * sizeof(uint32_t) + 2;
+constexpr size_t kDeltaMaxPacketSize = 128;
+constexpr size_t kDeltaMaxSegments = 32;
+constexpr uint8_t kDeltaKeyframe = 0;
+constexpr uint8_t kDeltaDelta = 1;
+
+// Discovery (espnow_discovery.h)
+constexpr uint8_t kProtocolVersion = 1;
+
+#pragma pack(push, 1)
+/// Stamp on a command frame, and its echo on telemetry (CommandStampHeader)
+struct StampHeader {
+    uint32_t magic;         ///< kStampMagic or kEchoMagic
+    uint32_t sequence;
+    uint32_t inputUs;       ///< Controller's input snapshot time (its clock)
+};
+
+enum class MessageType : uint8_t {
+    PairRequest = 0x01,
+    IdentityReply = 0x02,
+    PairConfirm = 0x03,     ///< reserved = session token (0 = team link)
+    PairAck = 0x04,
+    Keepalive = 0x05,
+    Command = 0x06,
+    Ping = 0x07,            ///< monotonicMs = controller stamp, reserved = sequence
+    Pong = 0x08,
+    Channel = 0x09,         ///< reserved = channel, monotonicMs = ms until the switch
+    SlotBeacon = 0x0A,
+    Resume = 0x0B,          ///< reserved = session token
+    ResumeAck = 0x0C        ///< reserved = the token, 0 = not held
+};
+
+struct Identity {
+    char deviceType[12];    ///< "controlled" for robots
+    char platform[16];
+    char customId[32];      ///< Matched against module names on the controller
+    uint8_t mac[6];
+};
+
+/// Discovery packet (Packet)
+struct DiscoveryPacket {
+    uint8_t version;
+    MessageType type;
+    Identity id;
+    uint32_t monotonicMs;
+    uint32_t reserved;
+};
+
+/// Pong with the robot's stamps for the controller's ClockSync (PongPacket)
+struct PongPacket {
+    DiscoveryPacket header;
+    uint32_t pingRxUs;
+    uint32_t pongTxUs;
+};
+#pragma pack(pop)
+
+constexpr size_t kStampSize = sizeof(StampHeader);
+
+/// First four bytes of a frame (0 if shorter)
+inline uint32_t frameMagic(const uint8_t* data, size_t length) {
+    uint32_t magic = 0;
+    if (data != nullptr && length >= sizeof(magic)) {
+        memcpy(&magic, data, sizeof(magic));
+    }
+    return magic;
+}
+
+/// A discovery packet of this protocol version
+inline bool isDiscoveryPacket(const uint8_t* data, size_t length) {
+    return data != nullptr && length >= sizeof(DiscoveryPacket) && data[0] == kProtocolVersion &&
+           data[1] >= static_cast<uint8_t>(MessageType::PairRequest) &&
+           data[1] <= static_cast<uint8_t>(MessageType::ResumeAck);
+}
+
+/**
+ * @brief Sends one frame to `mac` (esp_now_send() or a transport of the robot's own)
+ * @return true if the frame was queued
+ */
+using SendFunction = bool (*)(const uint8_t* mac, const uint8_t* data, size_t length, void* context);
+
+}  // namespace ILITERobot
+
+#endif // ILITE_ROBOT_WIRE_H
@@ -0,0 +1,106 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the parts of the Arduino core the framework core uses
+ *
+ * Only what the hardware-independent sources need: fixed-width types,
+ * millis()/micros() on the shim clock (see NativeClock.h), the numeric
+ * helpers and a Print that writes to stdout. Anything touching pins, WiFi or
+ * the display is deliberately missing, so a source that needs hardware
+ * fails to compile in the native environment instead of silently faking it.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_NATIVE_ARDUINO_H
+#define ILITE_NATIVE_ARDUINO_H
+
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "NativeClock.h"
+#include "freertos/FreeRTOS.h"
+
+using std::abs;
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+inline uint32_t millis() { return static_cast<uint32_t>(NativeClock::nowUs() / 1000); }
+inline uint32_t micros() { return static_cast<uint32_t>(NativeClock::nowUs()); }
+inline void delay(uint32_t ms) { NativeClock::sleepUs(static_cast<uint64_t>(ms) * 1000); }
+inline void delayMicroseconds(uint32_t us) { NativeClock::sleepUs(us); }
+inline void yield() {}
+
+/**
+ * @brief Output sink with the Arduino Print interface, writing to a stdio stream
+ */
+class Print {
+public:
+    explicit Print(FILE* stream = stdout) : stream_(stream) {}
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t byte) { return fputc(byte, stream_) == EOF ? 0 : 1; }
+    virtual size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, stream_); }
+
+    size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+    size_t println() { return print('\n'); }
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        const int written = vfprintf(stream_, format, args);
+        va_end(args);
+        return written < 0 ? 0 : static_cast<size_t>(written);
+    }
+
+    void flush() { fflush(stream_); }
+
+private:
+    FILE* stream_;
+};
+
+/// Console output; there is no input side on the host
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    void updateBaudRate(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    explicit operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // ILITE_NATIVE_ARDUINO_H
@@ -0,0 +1,66 @@
+/**
+ * @file NativeClock.h
+ * @brief Time source of the native shim: the host clock, or a virtual one
+ *
+ * Benchmarks want the real monotonic clock. Simulations want a clock that
+ * only moves when told to, so a run with a simulated radio is reproducible
+ * to the microsecond regardless of host load. millis(), micros() and
+ * esp_timer_get_time() all read this clock.
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_NATIVE_CLOCK_H
+#define ILITE_NATIVE_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace NativeClock {
+
+inline bool& virtualMode() {
+    static bool enabled = false;
+    return enabled;
+}
+
+inline uint64_t& virtualUs() {
+    static uint64_t now = 0;
+    return now;
+}
+
+inline uint64_t hostUs() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+/// Microseconds since start (virtual or host)
+inline uint64_t nowUs() {
+    return virtualMode() ? virtualUs() : hostUs();
+}
+
+/// Switch to the virtual clock, starting at `startUs`
+inline void useVirtualTime(uint64_t startUs = 0) {
+    virtualMode() = true;
+    virtualUs() = startUs;
+}
+
+/// Move the virtual clock forward (no effect on the host clock)
+inline void advanceUs(uint64_t us) {
+    virtualUs() += us;
+}
+
+/// delay(): advances the virtual clock, or sleeps on the host clock
+inline void sleepUs(uint64_t us) {
+    if (virtualMode()) {
+        advanceUs(us);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+}  // namespace NativeClock
+
+#endif // ILITE_NATIVE_CLOCK_H
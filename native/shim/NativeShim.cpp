@@ -0,0 +1,8 @@
+/**
+ * @file NativeShim.cpp
+ * @brief Definitions behind the native shim headers
+ */
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
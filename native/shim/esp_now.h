@@ -0,0 +1,46 @@
+/**
+ * @file esp_now.h
+ * @brief Host stand-in for ESP-NOW, backed by the simulated radio (SimRadio.h)
+ *
+ * The functions keep the ESP-IDF signatures; frames go into SimRadio, which
+ * delivers them to simulated robots and reports completions through the
+ * registered send callback when the virtual clock reaches them.
+ */
+
+#ifndef ILITE_NATIVE_ESP_NOW_H
+#define ILITE_NATIVE_ESP_NOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include "esp_err.h"
+
+#define ESP_NOW_ETH_ALEN 6
+#define ESP_NOW_MAX_DATA_LEN 250
+
+typedef enum {
+    ESP_NOW_SEND_SUCCESS = 0,
+    ESP_NOW_SEND_FAIL,
+} esp_now_send_status_t;
+
+typedef void (*esp_now_send_cb_t)(const uint8_t* mac, esp_now_send_status_t status);
+typedef void (*esp_now_recv_cb_t)(const uint8_t* mac, const uint8_t* data, int len);
+
+typedef struct {
+    uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+    uint8_t lmk[16];
+    uint8_t channel;
+    int ifidx;
+    bool encrypt;
+    void* priv;
+} esp_now_peer_info_t;
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_deinit();
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t len);
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb);
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_del_peer(const uint8_t* peer_addr);
+bool esp_now_is_peer_exist(const uint8_t* peer_addr);
+
+#endif // ILITE_NATIVE_ESP_NOW_H
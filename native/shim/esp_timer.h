@@ -0,0 +1,16 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for esp_timer_get_time() (see NativeClock.h)
+ */
+
+#ifndef ILITE_NATIVE_ESP_TIMER_H
+#define ILITE_NATIVE_ESP_TIMER_H
+
+#include <cstdint>
+#include "NativeClock.h"
+
+inline int64_t esp_timer_get_time() {
+    return static_cast<int64_t>(NativeClock::nowUs());
+}
+
+#endif // ILITE_NATIVE_ESP_TIMER_H
@@ -0,0 +1,53 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS types and critical sections the core uses
+ *
+ * Critical sections are real spinlocks, so the SPSC and lock-based
+ * structures behave the same when a simulation drives them from host
+ * threads. There is no scheduler: task notifications are no-ops.
+ */
+
+#ifndef ILITE_NATIVE_FREERTOS_H
+#define ILITE_NATIVE_FREERTOS_H
+
+#include <cstdint>
+#include <thread>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+
+struct portMUX_TYPE {
+    volatile int locked;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED portMUX_TYPE{0}
+
+inline void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE) != 0) {
+    }
+}
+
+inline void vPortExitCritical(portMUX_TYPE* mux) {
+    __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+}
+
+#define portENTER_CRITICAL(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vPortExitCritical(mux)
+
+#define taskYIELD() std::this_thread::yield()
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+
+#endif // ILITE_NATIVE_FREERTOS_H
@@ -0,0 +1,6 @@
+/**
+ * @file task.h
+ * @brief Host stand-in (see FreeRTOS.h)
+ */
+
+#include "FreeRTOS.h"
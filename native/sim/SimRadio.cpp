@@ -0,0 +1,243 @@
+/**
+ * @file SimRadio.cpp
+ * @brief Event queue behind the native esp_now_*() functions
+ */
+
+#include "SimRadio.h"
+#include "NativeClock.h"
+#include <esp_now.h>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint8_t kBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+enum class EventKind : uint8_t {
+    ToPeer,         // Controller frame reaching robots
+    SendDone,       // Send callback of a controller frame
+    ToController    // Robot frame reaching the controller
+};
+
+struct Event {
+    EventKind kind;
+    uint8_t mac[6];             // Destination (ToPeer/SendDone) or sender (ToController)
+    bool success;
+    std::vector<uint8_t> data;
+};
+
+struct Peer {
+    uint8_t mac[6];
+    SimRadio::PeerHandler handler;
+};
+
+SimLinkConfig config;
+SimRadioStats stats;
+std::vector<Peer> peers;
+std::multimap<uint64_t, Event> events;      // Due time -> event, FIFO within a time
+std::mt19937 rng(1);
+esp_now_send_cb_t sendCallback = nullptr;
+esp_now_recv_cb_t recvCallback = nullptr;
+size_t awaitingCallback = 0;
+bool initialised = false;
+
+uint64_t airtimeUs(size_t length) {
+    const uint32_t kbps = config.bitRateKbps > 0 ? config.bitRateKbps : 1000;
+    return config.overheadUs + (static_cast<uint64_t>(length) * 8 * 1000) / kbps;
+}
+
+bool lose() {
+    if (config.lossRate <= 0.0f) {
+        return false;
+    }
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    return uniform(rng) < config.lossRate;
+}
+
+Peer* findPeer(const uint8_t* mac) {
+    for (Peer& peer : peers) {
+        if (memcmp(peer.mac, mac, 6) == 0) {
+            return &peer;
+        }
+    }
+    return nullptr;
+}
+
+void dispatch(const Event& event) {
+    switch (event.kind) {
+        case EventKind::ToPeer: {
+            const bool broadcast = memcmp(event.mac, kBroadcastMac, 6) == 0;
+            for (Peer& peer : peers) {
+                if (broadcast || memcmp(peer.mac, event.mac, 6) == 0) {
+                    stats.delivered++;
+                    if (peer.handler) {
+                        // The sender seen by a robot is the controller; the shim has no MAC of its own
+                        static const uint8_t kControllerMac[6] = {0x02, 0, 0, 0, 0, 0x01};
+                        peer.handler(kControllerMac, event.data.data(), event.data.size());
+                    }
+                }
+            }
+            break;
+        }
+        case EventKind::SendDone:
+            if (awaitingCallback > 0) {
+                awaitingCallback--;
+            }
+            if (sendCallback != nullptr) {
+                sendCallback(event.mac, event.success ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+            }
+            break;
+        case EventKind::ToController:
+            stats.received++;
+            if (recvCallback != nullptr) {
+                recvCallback(event.mac, event.data.data(), static_cast<int>(event.data.size()));
+            }
+            break;
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Simulation Control
+// ============================================================================
+
+void SimRadio::configure(const SimLinkConfig& linkConfig) {
+    config = linkConfig;
+    rng.seed(config.seed);
+}
+
+void SimRadio::addPeer(const uint8_t* mac, PeerHandler handler) {
+    Peer peer;
+    memcpy(peer.mac, mac, 6);
+    peer.handler = std::move(handler);
+    peers.push_back(std::move(peer));
+}
+
+void SimRadio::reply(const uint8_t* fromMac, const uint8_t* data, size_t length) {
+    stats.replies++;
+    if (lose()) {
+        stats.lost++;
+        return;
+    }
+    Event event;
+    event.kind = EventKind::ToController;
+    memcpy(event.mac, fromMac, 6);
+    event.success = true;
+    event.data.assign(data, data + length);
+    events.emplace(NativeClock::nowUs() + airtimeUs(length), std::move(event));
+}
+
+void SimRadio::poll() {
+    // Handlers may queue new events, so take one at a time
+    while (!events.empty() && events.begin()->first <= NativeClock::nowUs()) {
+        Event event = std::move(events.begin()->second);
+        events.erase(events.begin());
+        dispatch(event);
+    }
+}
+
+void SimRadio::advanceUs(uint64_t us) {
+    const uint64_t end = NativeClock::nowUs() + us;
+    while (!events.empty() && events.begin()->first <= end) {
+        const uint64_t due = events.begin()->first;
+        if (due > NativeClock::nowUs()) {
+            NativeClock::advanceUs(due - NativeClock::nowUs());
+        }
+        poll();
+    }
+    if (end > NativeClock::nowUs()) {
+        NativeClock::advanceUs(end - NativeClock::nowUs());
+    }
+}
+
+const SimRadioStats& SimRadio::getStats() {
+    return stats;
+}
+
+void SimRadio::reset() {
+    peers.clear();
+    events.clear();
+    stats = SimRadioStats{};
+    sendCallback = nullptr;
+    recvCallback = nullptr;
+    awaitingCallback = 0;
+    rng.seed(config.seed);
+}
+
+// ============================================================================
+// esp_now_*() (native shim)
+// ============================================================================
+
+esp_err_t esp_now_init() {
+    initialised = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_deinit() {
+    initialised = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+    sendCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+    recvCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+    return peer != nullptr ? ESP_OK : ESP_ERR_ESPNOW_ARG;
+}
+
+esp_err_t esp_now_del_peer(const uint8_t* peer_addr) {
+    return peer_addr != nullptr ? ESP_OK : ESP_ERR_ESPNOW_ARG;
+}
+
+bool esp_now_is_peer_exist(const uint8_t* peer_addr) {
+    return peer_addr != nullptr && (memcmp(peer_addr, kBroadcastMac, 6) == 0 || findPeer(peer_addr) != nullptr);
+}
+
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t len) {
+    if (!initialised) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    if (peer_addr == nullptr || data == nullptr || len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return ESP_ERR_ESPNOW_ARG;
+    }
+    if (awaitingCallback >= config.queueDepth) {
+        stats.queueFull++;
+        return ESP_ERR_ESPNOW_NO_MEM;
+    }
+
+    const bool broadcast = memcmp(peer_addr, kBroadcastMac, 6) == 0;
+    const bool known = broadcast || findPeer(peer_addr) != nullptr;
+    const bool lost = !known || lose();
+    const uint64_t due = NativeClock::nowUs() + airtimeUs(len);
+    stats.sent++;
+    awaitingCallback++;
+
+    if (lost) {
+        stats.lost++;
+    } else {
+        Event frame;
+        frame.kind = EventKind::ToPeer;
+        memcpy(frame.mac, peer_addr, 6);
+        frame.success = true;
+        frame.data.assign(data, data + len);
+        events.emplace(due, std::move(frame));
+    }
+
+    // Broadcasts are never acknowledged, so they always "succeed"
+    Event done;
+    done.kind = EventKind::SendDone;
+    memcpy(done.mac, peer_addr, 6);
+    done.success = broadcast || !lost;
+    events.emplace(due, std::move(done));
+    return ESP_OK;
+}
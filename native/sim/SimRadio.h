@@ -0,0 +1,89 @@
+/**
+ * @file SimRadio.h
+ * @brief Simulated ESP-NOW link between the controller and scripted robots
+ *
+ * The native shim's esp_now_*() functions land here. A frame sent by the
+ * controller is scheduled on the virtual clock (NativeClock) after its
+ * airtime; when the clock gets there the frame is either lost or handed to
+ * the robot's handler, and the send callback reports the outcome, as the
+ * real driver does. Robots answer with reply(), which reaches the
+ * controller's receive callback the same way.
+ *
+ * Loss comes from a seeded generator, so a run is reproducible bit for bit.
+ * At most `queueDepth` sends may await their callback; further sends get
+ * ESP_ERR_ESPNOW_NO_MEM, like a full driver queue.
+ *
+ * ## Usage Example:
+ * ```cpp
+ * NativeClock::useVirtualTime();
+ * SimRadio::configure(config);
+ * SimRadio::addPeer(robotMac, [](const uint8_t* from, const uint8_t* data, size_t len) {
+ *     SimRadio::reply(robotMac, telemetry, sizeof(telemetry));
+ * });
+ * // ... controller code calls esp_now_send() ...
+ * SimRadio::advanceUs(20000);     // deliveries and callbacks run here
+ * ```
+ *
+ * @author ILITE Team
+ * @date 2025
+ */
+
+#ifndef ILITE_SIM_RADIO_H
+#define ILITE_SIM_RADIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Behaviour of the simulated link
+ */
+struct SimLinkConfig {
+    float lossRate = 0.0f;          ///< Probability a frame is lost (each direction)
+    uint32_t bitRateKbps = 1000;    ///< PHY rate used for airtime
+    uint32_t overheadUs = 100;      ///< Per-frame preamble, ACK and backoff
+    uint8_t queueDepth = 8;         ///< Sends awaiting their callback before NO_MEM
+    uint32_t seed = 1;              ///< Loss generator seed
+};
+
+/**
+ * @brief Counters of the simulated link
+ */
+struct SimRadioStats {
+    uint32_t sent = 0;              ///< Controller frames accepted
+    uint32_t delivered = 0;         ///< Controller frames handed to a robot
+    uint32_t lost = 0;              ///< Frames lost (both directions)
+    uint32_t queueFull = 0;         ///< Sends refused with NO_MEM
+    uint32_t replies = 0;           ///< Robot frames sent
+    uint32_t received = 0;          ///< Robot frames handed to the controller
+};
+
+/**
+ * @class SimRadio
+ * @brief Static simulated radio (one controller, any number of robots)
+ */
+class SimRadio {
+public:
+    using PeerHandler = std::function<void(const uint8_t* from, const uint8_t* data, size_t length)>;
+
+    static void configure(const SimLinkConfig& config);
+
+    /// Add a robot; `handler` receives the frames sent to its MAC (or broadcast)
+    static void addPeer(const uint8_t* mac, PeerHandler handler);
+
+    /// Robot side: send a frame to the controller
+    static void reply(const uint8_t* fromMac, const uint8_t* data, size_t length);
+
+    /// Move the virtual clock forward, delivering everything due on the way
+    static void advanceUs(uint64_t us);
+
+    /// Deliver everything due at the current time
+    static void poll();
+
+    static const SimRadioStats& getStats();
+
+    /// Drop peers, queued frames, callbacks and counters
+    static void reset();
+};
+
+#endif // ILITE_SIM_RADIO_H
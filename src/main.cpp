@@ -20,7 +20,6 @@
 #include <ControlBindingSystem.h>
 #include <MenuRegistry.h>
 #include <UIComponents.h>
-#include <audio_feedback.h>   // For audioUpdate() to stop tones
 
 
 // ============================================================================
@@ -128,7 +127,7 @@ void setup() {
     config.controlLoopHz = 50;           // 50Hz control loop
     config.displayRefreshHz = 20;        // 10Hz display refresh
     config.enableAudio = true;           // Enable audio feedback
-    config.enableOTA = true;             // Enable OTA updates
+    config.enableOTA = true;             // Allow the OTA maintenance mode
     config.wifiSSID = WIFI_SSID;         // WiFi SSID for OTA
     config.wifiPassword = WIFI_PASSWORD; // WiFi password for OTA
 
@@ -191,12 +190,9 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    // Update framework (handles all tasks, communication, display, input)
+    // Housekeeping runs in the framework's ServiceTask; this just yields
     ILITE.update();
 
-    // Update audio system to stop tones properly
-    audioUpdate();
-
     // Optional: Add custom logic here if needed
     // All module-specific logic should be in the module classes
 }
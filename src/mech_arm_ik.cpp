@@ -1,4 +1,5 @@
 ﻿#include "mech_arm_ik.h"
+#include "Kinematics.h"
 
 #include <math.h>
 
@@ -7,28 +8,16 @@ namespace mech {
 namespace {
 constexpr float kEpsilon = 1e-6f;
 
-inline float sqr(float v) {
-  return v * v;
+Kinematics::Vec3T<float> toKin(const Vec3& v) {
+  return Kinematics::Vec3T<float>(v.x, v.y, v.z);
 }
 
 Vec3 rotateAroundAxis(const Vec3& v, const Vec3& axis, float angle) {
-  if (fabsf(angle) < kEpsilon) {
+  if (fabsf(angle) < kEpsilon || axis.magSq() < kEpsilon) {
     return v;
   }
-  Vec3 k = axis;
-  float magSq = k.magSq();
-  if (magSq < kEpsilon) {
-    return v;
-  }
-  float invMag = 1.0f / sqrtf(magSq);
-  k *= invMag;
-  float cosA = cosf(angle);
-  float sinA = sinf(angle);
-  Vec3 term1 = v * cosA;
-  Vec3 term2 = k.cross(v) * sinA;
-  float dotKV = v.dot(k);
-  Vec3 term3 = k * (dotKV * (1.0f - cosA));
-  return term1 + term2 + term3;
+  Kinematics::Vec3T<float> rotated = Kinematics::rotateAroundAxis(toKin(v), toKin(axis), angle);
+  return Vec3(rotated.x, rotated.y, rotated.z);
 }
 
 } // namespace
@@ -188,6 +177,7 @@ void IKStatus::reset() {
   reachable = true;
   lateralError = 0.0f;
   distanceError = 0.0f;
+  collision = Kinematics::CollisionHit();
 }
 
 float ArmSolution::baseAngleDeg() const {
@@ -288,6 +278,10 @@ void MechArmIK::setDimensions(const ArmDimensions& dims) {
   updateBasePosition();
 }
 
+void MechArmIK::setCollisionScene(const Kinematics::CollisionScene* scene) {
+  collisionScene_ = scene;
+}
+
 void MechArmIK::setLimits(const ArmLimits& limits) {
   limits_ = limits;
   if (limits_.baseYawLimit < 0.f) {
@@ -342,15 +336,17 @@ bool MechArmIK::solve(const Vec3& desiredTarget, bool elbowUp) {
     desiredTarget.z - basePos_.z
   );
 
-  float rawBaseAngle = atan2f(relative.x, relative.z);
+  float rawBaseAngle = Kinematics::atan2Fast(relative.x, relative.z);
   float baseAngle = clampf(rawBaseAngle, -limits_.baseYawLimit, limits_.baseYawLimit);
   if (fabsf(baseAngle - rawBaseAngle) > 0.001f) {
     status_.baseLimited = true;
   }
 
-  Vec3 radialDir(sinf(baseAngle), 0.f, cosf(baseAngle));
+  const float baseSin = Kinematics::sinFast(baseAngle);
+  const float baseCos = Kinematics::cosFast(baseAngle);
+  Vec3 radialDir(baseSin, 0.f, baseCos);
   float radial = relative.x * radialDir.x + relative.z * radialDir.z;
-  float lateral = relative.x * cosf(baseAngle) - relative.z * sinf(baseAngle);
+  float lateral = relative.x * baseCos - relative.z * baseSin;
   status_.lateralError = lateral;
 
   if (radial < limits_.minRadial) {
@@ -390,15 +386,11 @@ bool MechArmIK::solve(const Vec3& desiredTarget, bool elbowUp) {
   effectiveL2 = clampf(effectiveL2, dims_.elbowLength, dims_.elbowLength + dims_.extensionMax);
   extension_ = effectiveL2 - dims_.elbowLength;
 
-  float cosElbow = (sqr(dims_.shoulderLength) + sqr(effectiveL2) - sqr(planar)) / (2.f * dims_.shoulderLength * effectiveL2);
-  cosElbow = clampf(cosElbow, -1.0f, 1.0f);
-  float elbowInternal = acosf(cosElbow);
-  float elbowAngle = PI - elbowInternal;
-
-  float cosShoulder = (sqr(dims_.shoulderLength) + sqr(planar) - sqr(effectiveL2)) / (2.f * dims_.shoulderLength * planar);
-  cosShoulder = clampf(cosShoulder, -1.0f, 1.0f);
-  float shoulderOffset = acosf(cosShoulder);
-  float angleToTarget = atan2f(vertical, radial);
+  Kinematics::TwoLinkResult<float> triangle =
+    Kinematics::solveTwoLink(dims_.shoulderLength, effectiveL2, radial, vertical, 1e-3f);
+  float elbowAngle = PI - triangle.elbowInterior;
+  float shoulderOffset = triangle.shoulderOffset;
+  float angleToTarget = triangle.angleToTarget;
   float shoulderAngle = elbowUp ? angleToTarget + shoulderOffset : angleToTarget - shoulderOffset;
 
   float clampedShoulder = clampf(shoulderAngle, limits_.shoulderMin, limits_.shoulderMax);
@@ -418,24 +410,24 @@ bool MechArmIK::solve(const Vec3& desiredTarget, bool elbowUp) {
   joints_[0] = Vec3(basePos_.x, 0.f, basePos_.z);
   joints_[1] = basePos_;
 
-  float l1Radial = dims_.shoulderLength * cosf(shoulderAngle);
-  float l1Vertical = dims_.shoulderLength * sinf(shoulderAngle);
+  float l1Radial = dims_.shoulderLength * Kinematics::cosFast(shoulderAngle);
+  float l1Vertical = dims_.shoulderLength * Kinematics::sinFast(shoulderAngle);
   joints_[2] = Vec3(
     basePos_.x + radialDir.x * l1Radial,
     basePos_.y + l1Vertical,
     basePos_.z + radialDir.z * l1Radial
   );
 
-  float baseL2Radial = dims_.elbowLength * cosf(link2Angle);
-  float baseL2Vertical = dims_.elbowLength * sinf(link2Angle);
+  float baseL2Radial = dims_.elbowLength * Kinematics::cosFast(link2Angle);
+  float baseL2Vertical = dims_.elbowLength * Kinematics::sinFast(link2Angle);
   joints_[3] = Vec3(
     joints_[2].x + radialDir.x * baseL2Radial,
     joints_[2].y + baseL2Vertical,
     joints_[2].z + radialDir.z * baseL2Radial
   );
 
-  float totalL2Radial = (dims_.elbowLength + extension_) * cosf(link2Angle);
-  float totalL2Vertical = (dims_.elbowLength + extension_) * sinf(link2Angle);
+  float totalL2Radial = (dims_.elbowLength + extension_) * Kinematics::cosFast(link2Angle);
+  float totalL2Vertical = (dims_.elbowLength + extension_) * Kinematics::sinFast(link2Angle);
   joints_[4] = Vec3(
     joints_[2].x + radialDir.x * totalL2Radial,
     joints_[2].y + totalL2Vertical,
@@ -453,6 +445,17 @@ bool MechArmIK::solve(const Vec3& desiredTarget, bool elbowUp) {
   status_.distanceError = Vec3::distance(desiredTarget, reached_);
   status_.reachable = status_.distanceError <= 1.5f;
 
+  if (collisionScene_ != nullptr) {
+    Kinematics::Vec3T<float> chain[5];
+    for (int i = 0; i < 5; ++i) {
+      chain[i] = toKin(joints_[i]);
+    }
+    status_.collision = collisionScene_->check(chain, 5);
+    if (status_.collision) {
+      status_.reachable = false;
+    }
+  }
+
   currentSolution_.basePosition = basePos_;
   currentSolution_.desiredTarget = target_;
   currentSolution_.reachedTarget = reached_;
@@ -570,8 +573,8 @@ void MechArmIK::updateGripperFrame(const Vec3& radialDir, float link2Angle) {
     forward = joints_[4] - joints_[2];
   }
   if (forward.magSq() < 1e-5f) {
-    float forwardRadial = cosf(link2Angle);
-    float forwardVertical = sinf(link2Angle);
+    float forwardRadial = Kinematics::cosFast(link2Angle);
+    float forwardVertical = Kinematics::sinFast(link2Angle);
     forward = Vec3(radialDir.x * forwardRadial, forwardVertical, radialDir.z * forwardRadial);
   }
   forward.normalize();
@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+"""Cut page-aligned subsets of the DisplayCanvas fonts out of U8g2.
+
+As a PlatformIO extra script (platformio.ini), it runs before every build,
+writes ILITEPageFonts.h to the build directory and defines
+ILITE_PAGE_FONTS=1 (see lib/ILITE/include/PageFont.h). If U8g2 is not in
+the environment's libdeps yet it installs lib_deps first, and it stops the
+build if the header still cannot be generated:
+
+    extra_scripts = pre:tools/font_subset.py
+
+By hand, against any U8g2 checkout, to look at the subsets:
+
+    tools/font_subset.py .pio/libdeps/ILITE/U8g2 -o /tmp/ILITEPageFonts.h
+
+The character set is every printable ASCII character in a string literal
+under lib/ILITE and src, plus digits, hex letters and the characters printf
+produces for numbers. A character outside it still draws, through U8G2.
+Glyphs are decoded from U8G2's run-length format and stored as
+ceil(height / 8) pages of column bytes, bit 0 on top, the layout of the
+framebuffer.
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+# DisplayCanvas::Font -> U8G2 font, in enum order (DisplayCanvas::getFontPointer)
+FONTS = (
+    ("TINY", "u8g2_font_4x6_tf"),
+    ("SMALL", "u8g2_font_5x8_tf"),
+    ("NORMAL", "u8g2_font_torussansbold8_8r"),
+)
+FIRST = 0x20
+LAST = 0x7E
+MAX_HEIGHT = 16             # PageFontData::kMaxHeight
+ALWAYS = "0123456789abcdefABCDEF -+.:%/"
+SOURCE_DIRS = ("lib/ILITE/src", "lib/ILITE/include", "src")
+HEADER_NAME = "ILITEPageFonts.h"
+
+STRING_LITERAL = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+ESCAPE = re.compile(r"\\([0-7]{1,3}|x[0-9a-fA-F]+|.)")
+SIMPLE_ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", '"': '"', "'": "'"}
+
+
+def unescape(text):
+    def replace(match):
+        code = match.group(1)
+        if code[0] in "01234567":
+            return chr(int(code, 8))
+        if code[0] == "x":
+            return chr(int(code[1:], 16) & 0xFF)
+        return SIMPLE_ESCAPES.get(code, code)
+    return ESCAPE.sub(replace, text)
+
+
+# ============================================================================
+# Character set
+# ============================================================================
+
+def used_characters(project_dir):
+    chars = set(ALWAYS)
+    for directory in SOURCE_DIRS:
+        for root, _, files in os.walk(os.path.join(project_dir, directory)):
+            for name in files:
+                if not name.endswith((".cpp", ".h", ".c", ".hpp", ".ino")):
+                    continue
+                with open(os.path.join(root, name), encoding="utf-8", errors="replace") as source:
+                    for literal in STRING_LITERAL.findall(source.read()):
+                        chars.update(unescape(literal))
+    return sorted(c for c in chars if FIRST <= ord(c) <= LAST)
+
+
+# ============================================================================
+# U8G2 font decoding
+# ============================================================================
+
+def find_font_source(u8g2_dir):
+    for pattern in ("src/clib/u8g2_fonts.c", "csrc/u8g2_fonts.c", "u8g2_fonts.c"):
+        path = os.path.join(u8g2_dir, pattern)
+        if os.path.exists(path):
+            return path
+    return None
+
+
+def read_font(source_text, name):
+    """Bytes of one `const uint8_t name[] = "..." "...";` array."""
+    match = re.search(re.escape(name) + r'\[[^\]]*\][^=]*=\s*((?:"(?:[^"\\]|\\.)*"\s*)+);',
+                      source_text)
+    if match is None:
+        return None
+    data = "".join(unescape(s) for s in re.findall(r'"((?:[^"\\]|\\.)*)"', match.group(1)))
+    return bytes(ord(c) & 0xFF for c in data)
+
+
+class BitReader:
+    """U8G2 glyph bit stream: fields packed LSB first across bytes."""
+
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+        self.bit = 0
+
+    def unsigned(self, count):
+        value = 0
+        for i in range(count):
+            byte = self.data[self.pos] if self.pos < len(self.data) else 0
+            value |= ((byte >> self.bit) & 1) << i
+            self.bit += 1
+            if self.bit == 8:
+                self.bit = 0
+                self.pos += 1
+        return value
+
+    def signed(self, count):
+        return self.unsigned(count) - (1 << (count - 1))
+
+
+def decode_glyphs(font):
+    """{encoding: (width, height, x, y, advance, rows)} of the 8-bit glyphs."""
+    bits_0, bits_1 = font[2], font[3]
+    bits_w, bits_h, bits_x, bits_y, bits_d = font[4:9]
+    glyphs = {}
+    pos = 23
+    while pos + 1 < len(font) and font[pos + 1] != 0:
+        encoding, jump = font[pos], font[pos + 1]
+        reader = BitReader(font, pos + 2)
+        width = reader.unsigned(bits_w)
+        height = reader.unsigned(bits_h)
+        x = reader.signed(bits_x)
+        y = reader.signed(bits_y)
+        advance = reader.signed(bits_d)
+
+        pixels = []
+        if width > 0:
+            total = width * height
+            while True:
+                zeros = reader.unsigned(bits_0)
+                ones = reader.unsigned(bits_1)
+                while True:
+                    pixels.extend([0] * zeros + [1] * ones)
+                    if reader.unsigned(1) == 0:
+                        break
+                if len(pixels) >= total:
+                    break
+            pixels = pixels[:total]
+        rows = [pixels[r * width:(r + 1) * width] for r in range(height)] if width else []
+        glyphs[encoding] = (width, height, x, y, advance, rows)
+        pos += jump
+    return glyphs
+
+
+def page_bitmap(width, height, rows):
+    """Column bytes page by page, bit 0 on top (framebuffer layout)."""
+    out = []
+    for page in range(0, height, 8):
+        for column in range(width):
+            byte = 0
+            for bit in range(8):
+                row = page + bit
+                if row < height and rows[row][column]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+# ============================================================================
+# Header generation
+# ============================================================================
+
+def build_font(label, name, font, chars):
+    decoded = decode_glyphs(font)
+    glyphs = []
+    bitmaps = []
+    kept = 0
+    for code in range(FIRST, LAST + 1):
+        glyph = decoded.get(code)
+        if glyph is None or chr(code) not in chars or glyph[1] > MAX_HEIGHT:
+            glyphs.append((0, 0, 0, 0, 0, 0, 0))
+            continue
+        width, height, x, y, advance, rows = glyph
+        glyphs.append((len(bitmaps), width, height, x, height + y, advance, 1))
+        bitmaps.extend(page_bitmap(width, height, rows))
+        kept += 1
+    return {"label": label, "name": name, "glyphs": glyphs, "bitmaps": bitmaps,
+            "kept": kept, "source_bytes": len(font)}
+
+
+def identifier(label):
+    return "k" + label.capitalize()
+
+
+def render_header(fonts, char_count):
+    lines = [
+        "// Generated by tools/font_subset.py - do not edit",
+        "// %d characters in use; see PageFont.h" % char_count,
+        "//",
+    ]
+    for font in fonts:
+        size = len(font["bitmaps"]) + 8 * len(font["glyphs"])
+        lines.append("// %-6s %-28s %2d glyphs, %5d bytes (U8G2 font: %5d bytes)"
+                     % (font["label"], font["name"], font["kept"], size, font["source_bytes"]))
+    lines += ["", "#ifndef ILITE_PAGE_FONTS_GENERATED_H", "#define ILITE_PAGE_FONTS_GENERATED_H",
+              "", '#include "PageFont.h"', "", "namespace {", ""]
+
+    for font in fonts:
+        base = identifier(font["label"])
+        lines.append("const uint8_t %sBitmaps[] = {" % base)
+        data = font["bitmaps"] or [0]
+        for i in range(0, len(data), 16):
+            lines.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        lines.append("const PageGlyph %sGlyphs[] = {" % base)
+        for code, glyph in zip(range(FIRST, LAST + 1), font["glyphs"]):
+            shown = chr(code) if chr(code) not in "\\" else "backslash"
+            lines.append("    {%d, %d, %d, %d, %d, %d, %d},    // %s" % (glyph + (shown,)))
+        lines.append("};")
+        lines.append("")
+        lines.append('const PageFontData %sFont = {"%s", %sGlyphs, %sBitmaps};'
+                     % (base, font["name"], base, base))
+        lines.append("")
+
+    lines.append("// Indexed by DisplayCanvas::Font")
+    lines.append("const PageFontData* const kPageFonts[] = {")
+    for font in fonts:
+        lines.append("    &%sFont," % identifier(font["label"]))
+    lines += ["};", "constexpr size_t kPageFontCount = sizeof(kPageFonts) / sizeof(kPageFonts[0]);",
+              "", "}  // namespace", "", "#endif // ILITE_PAGE_FONTS_GENERATED_H", ""]
+    return "\n".join(lines)
+
+
+def generate(u8g2_dir, project_dir, output):
+    """Write the header; returns a reason string if it could not."""
+    source = find_font_source(u8g2_dir) if u8g2_dir else None
+    if source is None:
+        return "u8g2_fonts.c not found in %s" % u8g2_dir
+    with open(source, encoding="latin-1") as handle:
+        text = handle.read()
+
+    chars = used_characters(project_dir)
+    fonts = []
+    for label, name in FONTS:
+        font = read_font(text, name)
+        if font is None or len(font) < 23:
+            return "%s not found in %s" % (name, source)
+        fonts.append(build_font(label, name, font, chars))
+
+    header = render_header(fonts, len(chars))
+    # Rewrite only on change so the canvas is not rebuilt every time
+    if os.path.exists(output):
+        with open(output) as handle:
+            if handle.read() == header:
+                return None
+    os.makedirs(os.path.dirname(output) or ".", exist_ok=True)
+    with open(output, "w") as handle:
+        handle.write(header)
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("u8g2", help="U8g2 library directory")
+    parser.add_argument("-o", "--output", default=HEADER_NAME, help="header to write")
+    parser.add_argument("--project", default=os.path.join(os.path.dirname(__file__), ".."),
+                        help="project root (for the character set)")
+    args = parser.parse_args()
+    error = generate(args.u8g2, args.project, args.output)
+    if error:
+        parser.error(error)
+    with open(args.output) as handle:
+        for line in handle:
+            if not line.startswith("//"):
+                break
+            sys.stdout.write(line)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    # PlatformIO extra script: SCons provides Import()
+    Import("env")  # noqa: F821
+
+    def _find_u8g2():
+        pattern = env.subst(os.path.join("$PROJECT_LIBDEPS_DIR", "$PIOENV", "U8g2*"))  # noqa: F821
+        candidates = glob.glob(pattern)
+        return candidates[0] if candidates else None
+
+    # Pre-scripts run before PlatformIO installs lib_deps, so on a clean
+    # checkout U8g2 is not there yet: install this environment's deps first
+    _u8g2 = _find_u8g2()
+    if _u8g2 is None:
+        env.Execute(env.VerboseAction(  # noqa: F821
+            '"$PYTHONEXE" -m platformio pkg install -d "$PROJECT_DIR" -e $PIOENV',
+            "font_subset: installing lib_deps for $PIOENV"))
+        _u8g2 = _find_u8g2()
+
+    _out_dir = env.subst(os.path.join("$BUILD_DIR", "ilite_fonts"))  # noqa: F821
+    _error = generate(_u8g2, env.subst("$PROJECT_DIR"),  # noqa: F821
+                      os.path.join(_out_dir, HEADER_NAME))
+    if _error:
+        # Never fall back silently: a build without page fonts is not the one configured
+        sys.stderr.write("font_subset: %s; cannot generate %s\n" % (_error, HEADER_NAME))
+        env.Exit(1)  # noqa: F821
+    env.Append(CPPDEFINES=[("ILITE_PAGE_FONTS", 1)], CPPPATH=[_out_dir])  # noqa: F821
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Latency histograms from a logic-analyzer capture of the ILITE marker pins.
+
+Build with ILITE_LATENCY_PINS=1 (env ILITE_latency), probe the marker GPIOs
+listed in lib/ILITE/include/LatencyPins.h, capture a few seconds of driving
+and export the capture as CSV. Both layouts work: one row per sample
+(sigrok-cli -O csv) and one row per transition (Saleae Logic export). The
+first column is the time in seconds, or the sample index with --rate.
+
+    tools/latency_histogram.py capture.csv
+    tools/latency_histogram.py capture.csv --channels control=D1,air=D3 --rate 24e6
+
+--channels names the CSV column of each marker; by default the first six
+data columns are adc_latch, control, prepare, air, rx and send_buffer in
+that order. Markers that are not in the capture are left out of the report.
+
+Reported intervals (microseconds):
+
+    adc_to_control   ADC latch pulse to the next updateControl() start
+    control          updateControl() duration
+    prepare          prepareCommandPacket() duration, each call
+    control_to_air   updateControl() end to the next esp_now_send()
+    air              first esp_now_send() to the callback that clears the queue
+    input_to_air     ADC latch to the end of the next air span (the whole path)
+    rx_to_control    Receive callback to the next updateControl() start
+    send_buffer      DisplayCanvas::sendBuffer() duration
+"""
+
+import argparse
+import bisect
+import csv
+import math
+import sys
+
+MARKERS = ("adc_latch", "control", "prepare", "air", "rx", "send_buffer")
+# An interval longer than this pairs unrelated events (a stalled loop)
+MAX_PAIR_US = 100000.0
+BUCKETS = 16
+BAR_WIDTH = 40
+
+
+def read_capture(path, channels, rate):
+    """{marker: ([rising times], [falling times])} in microseconds."""
+    with open(path, newline="") as handle:
+        rows = [row for row in csv.reader(handle) if row and not row[0].startswith(";")]
+    if not rows:
+        raise ValueError("empty capture")
+    header = [name.strip() for name in rows[0]]
+
+    columns = {}
+    if channels:
+        for item in channels.split(","):
+            marker, _, column = item.partition("=")
+            if marker not in MARKERS:
+                raise ValueError("unknown marker %s (one of %s)" % (marker, ", ".join(MARKERS)))
+            if column not in header:
+                raise ValueError("no column %s in %s" % (column, ", ".join(header)))
+            columns[marker] = header.index(column)
+    else:
+        for marker, index in zip(MARKERS, range(1, len(header))):
+            columns[marker] = index
+
+    edges = {marker: ([], []) for marker in columns}
+    previous = {}
+    for row in rows[1:]:
+        try:
+            stamp = float(row[0])
+        except ValueError:
+            continue
+        time_us = stamp / rate * 1e6 if rate else stamp * 1e6
+        for marker, index in columns.items():
+            if index >= len(row):
+                continue
+            level = row[index].strip() not in ("0", "", "low", "LOW")
+            if marker in previous and level != previous[marker]:
+                edges[marker][0 if level else 1].append(time_us)
+            previous[marker] = level
+    return edges
+
+
+def widths(rising, falling):
+    """High times: each rising edge to the next falling edge."""
+    out = []
+    for start in rising:
+        at = bisect.bisect_right(falling, start)
+        if at < len(falling) and falling[at] - start <= MAX_PAIR_US:
+            out.append(falling[at] - start)
+    return out
+
+
+def follow(sources, targets):
+    """Each source event to the next target event after it."""
+    out = []
+    for start in sources:
+        at = bisect.bisect_right(targets, start)
+        if at < len(targets) and targets[at] - start <= MAX_PAIR_US:
+            out.append(targets[at] - start)
+    return out
+
+
+def intervals(edges):
+    def rise(marker):
+        return edges[marker][0] if marker in edges else None
+
+    def fall(marker):
+        return edges[marker][1] if marker in edges else None
+
+    measures = (
+        ("adc_to_control", follow, rise("adc_latch"), rise("control")),
+        ("control", widths, rise("control"), fall("control")),
+        ("prepare", widths, rise("prepare"), fall("prepare")),
+        ("control_to_air", follow, fall("control"), rise("air")),
+        ("air", widths, rise("air"), fall("air")),
+        ("input_to_air", follow, rise("adc_latch"), fall("air")),
+        ("rx_to_control", follow, rise("rx"), rise("control")),
+        ("send_buffer", widths, rise("send_buffer"), fall("send_buffer")),
+    )
+    return [(name, measure(first, second)) for name, measure, first, second in measures
+            if first is not None and second is not None]
+
+
+def percentile(values, share):
+    return values[min(len(values) - 1, int(math.ceil(share * len(values))) - 1)]
+
+
+def print_histogram(name, values, out):
+    if not values:
+        out.write("%s: no samples\n\n" % name)
+        return
+    values = sorted(values)
+    out.write("%s: %d samples, min %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f us\n"
+              % (name, len(values), values[0], percentile(values, 0.5), percentile(values, 0.9),
+                 percentile(values, 0.99), values[-1]))
+
+    # Equal-width buckets from min to max
+    low, high = values[0], values[-1]
+    step = (high - low) / BUCKETS or 1.0
+    counts = [0] * BUCKETS
+    for value in values:
+        counts[min(BUCKETS - 1, int((value - low) / step))] += 1
+    peak = max(counts)
+    for index, count in enumerate(counts):
+        bar = "#" * int(round(BAR_WIDTH * count / peak))
+        out.write("  %9.1f %6d %s\n" % (low + index * step, count, bar))
+    out.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="CSV export of the capture")
+    parser.add_argument("--channels", help="marker=column pairs, e.g. control=D1,air=D3")
+    parser.add_argument("--rate", type=float, help="sample rate when the time column counts samples")
+    args = parser.parse_args()
+    try:
+        edges = read_capture(args.capture, args.channels, args.rate)
+    except (OSError, ValueError) as error:
+        parser.error(str(error))
+    for name, values in intervals(edges):
+        print_histogram(name, values, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
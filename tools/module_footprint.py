@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""Report the flash and RAM each built-in module costs, from the linker map.
+
+As a PlatformIO extra script (platformio.ini), it adds -Wl,-Map to the link
+and prints the report after every firmware build:
+
+    extra_scripts = post:tools/module_footprint.py
+
+By hand, on the map of any build:
+
+    tools/module_footprint.py .pio/build/ILITE/firmware.map
+
+Input sections are charged to a module by object file (the module's own
+protocol and helper sources) or, inside ModuleRegistration.cpp.o, by the
+module's name in the section's symbol (the Arduino core builds with
+-ffunction-sections -fdata-sections, so every function and table has its
+own section). Everything else is the framework. A module built out with its
+ILITE_MODULE_* flag (see lib/ILITE/include/ModuleSelection.h) shows 0.
+
+flash counts what is in the image (code, constants, initialized data),
+dram the static data and bss, iram the code placed in instruction RAM.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Module -> (object files it owns, symbol keywords in ModuleRegistration.cpp.o)
+MODULES = (
+    ("TheGill", ("thegill.cpp.o", "PoseRecorder.cpp.o", "ArmTrajectory.cpp.o",
+                 "InverseKinematics.cpp.o", "ReachabilityMap.cpp.o", "mech_arm_ik.cpp.o"),
+     ("thegill",)),
+    ("DroneGaze", ("drongaze.cpp.o", "PidAutoTune.cpp.o", "Spectrum.cpp.o"),
+     ("drongaze",)),
+    ("Bulky", ("bulky.cpp.o",),
+     ("bulky",)),
+)
+REGISTRATION_OBJECT = "ModuleRegistration.cpp.o"
+FRAMEWORK = "(framework)"
+
+FLASH_SECTIONS = (".flash.text", ".flash.rodata", ".flash.appdesc", ".iram0.text",
+                  ".iram0.vectors", ".dram0.data", ".rtc.text", ".rtc.data")
+DRAM_SECTIONS = (".dram0.data", ".dram0.bss", ".noinit")
+IRAM_SECTIONS = (".iram0.text", ".iram0.vectors")
+
+OUTPUT_SECTION = re.compile(r"^(\.[\w.]+)(\s|$)")
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+INPUT_NAME = re.compile(r"^ (\.\S+)$")
+INPUT_CONTINUED = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+
+
+def object_name(path):
+    archive_member = re.search(r"\(([^)]+)\)$", path)
+    return os.path.basename(archive_member.group(1) if archive_member else path)
+
+
+def owner(section, obj):
+    for name, objects, keywords in MODULES:
+        if obj in objects:
+            return name
+        if obj == REGISTRATION_OBJECT:
+            lowered = section.lower()
+            if any(keyword in lowered for keyword in keywords):
+                return name
+    return FRAMEWORK
+
+
+def input_sections(lines):
+    """Yield (output section, input section, size, object) from the memory map."""
+    output = None
+    pending = None
+    in_map = False
+    for line in lines:
+        line = line.rstrip("\n")
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+
+        match = OUTPUT_SECTION.match(line)
+        if match:
+            output = match.group(1)
+            pending = None
+            continue
+
+        match = INPUT_SECTION.match(line)
+        if match:
+            yield output, match.group(1), int(match.group(3), 16), object_name(match.group(4))
+            pending = None
+            continue
+
+        # Long section names put the address, size and object on the next line
+        match = INPUT_NAME.match(line)
+        if match:
+            pending = match.group(1)
+            continue
+        match = INPUT_CONTINUED.match(line)
+        if match and pending is not None:
+            yield output, pending, int(match.group(2), 16), object_name(match.group(3))
+        pending = None
+
+
+def footprint(map_path):
+    totals = {}
+    with open(map_path, encoding="utf-8", errors="replace") as handle:
+        for output, section, size, obj in input_sections(handle):
+            if output is None or size == 0:
+                continue
+            row = totals.setdefault(owner(section, obj), [0, 0, 0])
+            if output in FLASH_SECTIONS:
+                row[0] += size
+            if output in DRAM_SECTIONS:
+                row[1] += size
+            if output in IRAM_SECTIONS:
+                row[2] += size
+    return totals
+
+
+def report(map_path, out=sys.stdout):
+    totals = footprint(map_path)
+    names = [name for name, _, _ in MODULES] + [FRAMEWORK]
+    out.write("Module footprint (%s)\n" % map_path)
+    out.write("%-12s %10s %10s %10s\n" % ("module", "flash", "dram", "iram"))
+    grand = [0, 0, 0]
+    for name in names:
+        row = totals.get(name, [0, 0, 0])
+        grand = [a + b for a, b in zip(grand, row)]
+        out.write("%-12s %10d %10d %10d\n" % (name, row[0], row[1], row[2]))
+    out.write("%-12s %10d %10d %10d\n" % ("total", grand[0], grand[1], grand[2]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="linker map (firmware.map)")
+    args = parser.parse_args()
+    if not os.path.exists(args.map):
+        parser.error("no such map: %s" % args.map)
+    report(args.map)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    # PlatformIO extra script: SCons provides Import()
+    Import("env")  # noqa: F821
+
+    MAP_PATH = os.path.join("$BUILD_DIR", "${PROGNAME}.map")
+    env.Append(LINKFLAGS=["-Wl,-Map," + MAP_PATH])  # noqa: F821
+
+    def _report_after_link(target, source, env):
+        report(env.subst(MAP_PATH))
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _report_after_link)  # noqa: F821
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Push a firmware image to the controller over the maintenance-mode AP, compressed.
+
+Put the controller in maintenance mode ("ota" on the console), join its
+access point, then:
+
+    tools/ota_push.py .pio/build/ILITE/firmware.bin
+
+The image is zlib-compressed (level 9) and streamed to OtaReceiver on port
+3233; the controller inflates it straight into the OTA partition, checks
+the MD5 and reboots. --raw sends it uncompressed over the same path, which
+is the baseline for the comparison in docs/ota.md. Both print the bytes
+sent and the time taken. The ILITE_OTA_zlib env in platformio.ini uploads
+with this script. Needs only the standard library.
+"""
+
+import argparse
+import hashlib
+import socket
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = 0x5A4F4C49  # "ILOZ"
+VERSION = 1
+ENCODING_RAW = 0
+ENCODING_ZLIB = 1
+CHUNK = 1460
+TIMEOUT_S = 30.0  # Covers the flash erase before "GO"
+
+
+def read_line(sock):
+    line = bytearray()
+    while not line.endswith(b"\n"):
+        byte = sock.recv(1)
+        if not byte:
+            break
+        line += byte
+    return line.decode("ascii", "replace").strip()
+
+
+def push(host, port, image, raw, level):
+    payload = image if raw else zlib.compress(image, level)
+    encoding = ENCODING_RAW if raw else ENCODING_ZLIB
+    header = struct.pack("<IBBHII16s", MAGIC, VERSION, encoding, 0, len(image), len(payload),
+                         hashlib.md5(image).digest())
+
+    print("image %d B, sending %d B %s (%.1f %% of the image)"
+          % (len(image), len(payload), "raw" if raw else "zlib", 100.0 * len(payload) / len(image)))
+
+    start = time.monotonic()
+    with socket.create_connection((host, port), timeout=TIMEOUT_S) as sock:
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        sock.sendall(header)
+        answer = read_line(sock)
+        if answer != "GO":
+            print("controller refused: %s" % (answer or "connection closed"))
+            return False
+
+        sent = 0
+        last_percent = -1
+        while sent < len(payload):
+            chunk = payload[sent:sent + CHUNK]
+            sock.sendall(chunk)
+            sent += len(chunk)
+            percent = sent * 100 // len(payload)
+            if percent != last_percent:
+                last_percent = percent
+                sys.stdout.write("\r%3d %%" % percent)
+                sys.stdout.flush()
+        sys.stdout.write("\n")
+
+        answer = read_line(sock)
+    elapsed = time.monotonic() - start
+
+    print("%s in %.1f s (%.1f KB/s on the air, %.1f KB/s of image)"
+          % (answer or "connection closed", elapsed,
+             len(payload) / 1024.0 / elapsed, len(image) / 1024.0 / elapsed))
+    return answer == "OK"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="firmware.bin")
+    parser.add_argument("--host", default="192.168.4.1", help="controller AP address")
+    parser.add_argument("--port", type=int, default=3233)
+    parser.add_argument("--raw", action="store_true", help="send uncompressed (baseline)")
+    parser.add_argument("--level", type=int, default=9, help="zlib level (1-9)")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as handle:
+        image = handle.read()
+    if not image:
+        parser.error("empty image: %s" % args.image)
+
+    try:
+        ok = push(args.host, args.port, image, args.raw, args.level)
+    except OSError as error:
+        print("%s:%d: %s" % (args.host, args.port, error))
+        ok = False
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
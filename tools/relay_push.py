@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Stage a robot firmware image on the controller over the console, then relay it.
+
+The controller keeps the image in its spare OTA slot and sends it to the
+paired robot over the link (see lib/ILITE/include/FirmwareRelay.h):
+
+    tools/relay_push.py /dev/ttyUSB0 robot/.pio/build/thegill/firmware.bin --start
+
+The image goes as "relay stage <bytes> <crc32>" followed by the raw bytes,
+256 at a time; each block waits for the controller's "[Relay] staged"
+line, so the console never overruns while the controller writes flash.
+Without --start the image stays staged for "relay start" or the "Robot
+Firmware" screen. With it, the controller's progress lines are printed
+until the transfer ends. Needs pyserial.
+"""
+
+import argparse
+import sys
+import time
+import zlib
+
+import serial
+
+BLOCK = 256             # FirmwareRelay::kStageBlockBytes
+LINE_TIMEOUT_S = 5.0    # A sector erase plus a block write
+RELAY_TIMEOUT_S = 600.0
+
+
+def wait_for(port, prefixes, timeout):
+    """First console line starting with one of prefixes, or None."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        line = port.readline().decode("ascii", "replace").strip()
+        if line.startswith(prefixes):
+            return line
+    return None
+
+
+def stage(port, image):
+    crc = zlib.crc32(image) & 0xFFFFFFFF
+    port.reset_input_buffer()
+    port.write(b"relay stage %d %08x\n" % (len(image), crc))
+    answer = wait_for(port, ("[Relay] ready", "[Relay] Cannot", "[Relay] No room"), LINE_TIMEOUT_S)
+    if answer is None or not answer.startswith("[Relay] ready"):
+        print(answer or "no answer from the controller")
+        return False
+
+    start = time.monotonic()
+    for offset in range(0, len(image), BLOCK):
+        port.write(image[offset:offset + BLOCK])
+        answer = wait_for(port, ("[Relay] staged", "[Relay] Staging failed"), LINE_TIMEOUT_S)
+        if answer is None or not answer.startswith("[Relay] staged"):
+            print("\n%s" % (answer or "controller stopped answering"))
+            return False
+        sys.stdout.write("\rstaged %3d %%" % (min(offset + BLOCK, len(image)) * 100 // len(image)))
+        sys.stdout.flush()
+    sys.stdout.write("\n")
+
+    answer = wait_for(port, ("[Relay] Image staged", "[Relay] Staging failed"), LINE_TIMEOUT_S)
+    print("%s (%.1f s)" % (answer or "no answer from the controller", time.monotonic() - start))
+    return answer is not None and answer.startswith("[Relay] Image staged")
+
+
+def relay(port):
+    port.write(b"relay start\n")
+    deadline = time.monotonic() + RELAY_TIMEOUT_S
+    while time.monotonic() < deadline:
+        line = port.readline().decode("ascii", "replace").strip()
+        if not line.startswith("[Relay]"):
+            continue
+        print(line)
+        if line.startswith("[Relay] Needs"):
+            return False
+        if line.startswith(("[Relay] done", "[Relay] failed")):
+            return line.startswith("[Relay] done")
+    print("no result from the controller")
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("image", help="robot firmware.bin")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--start", action="store_true", help="relay to the paired robot once staged")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as handle:
+        image = handle.read()
+    if not image:
+        parser.error("empty image: %s" % args.image)
+
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        ok = stage(port, image)
+        if ok and args.start:
+            ok = relay(port)
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
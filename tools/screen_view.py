@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Rebuild the controller's screen from a TelemetryTap recording.
+
+Turn the display stream on ("screen on", or ILITEConfig::screenTap) and
+record the tap as usual:
+
+    tools/tap_replay.py record /dev/ttyUSB0 session.tap --baud 2000000
+
+Write every frame as a PGM image (name = milliseconds since the first):
+
+    tools/screen_view.py session.tap --frames shots/
+
+Or render a video at a constant rate through ffmpeg, scaled up 4x:
+
+    tools/screen_view.py session.tap --video demo.mp4 --fps 30
+
+Display frames are the kind 0x04 records described in
+lib/ILITE/include/TelemetryTap.h, delta coded as in ScreenCapture.h.
+Decoding restarts at the next keyframe after a dropped record.
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+
+FRAME_DISPLAY = 0x04
+FRAME_DROPPED = 0x12
+FLAG_KEYFRAME = 0x01
+FLAG_LAST = 0x02
+SCALE = 4
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(raw):
+    """Yield (kind, time_us, body) for every valid frame."""
+    for chunk in raw.split(b"\x00"):
+        frame = cobs_decode(chunk) if chunk else None
+        if frame is None or len(frame) < 7:
+            continue
+        if crc16(frame[:-2]) != struct.unpack_from("<H", frame, len(frame) - 2)[0]:
+            continue
+        kind, time_us = struct.unpack_from("<BI", frame)
+        yield kind, time_us, frame[5:-2]
+
+
+def apply_delta(page, at, delta):
+    """XOR a PackBits-coded delta into page[at:]."""
+    i = 0
+    while i < len(delta):
+        ctrl = delta[i]
+        i += 1
+        if ctrl < 0x80:
+            for value in delta[i:i + ctrl + 1]:
+                page[at] ^= value
+                at += 1
+            i += ctrl + 1
+        else:
+            value = delta[i]
+            i += 1
+            for _ in range(ctrl - 0x80 + 3):
+                page[at] ^= value
+                at += 1
+
+
+class Screen:
+    def __init__(self):
+        self.width = 0
+        self.pages = 0
+        self.buffer = bytearray()
+        self.valid = False
+
+    def apply(self, body):
+        """Apply one display record; True when it completed a frame."""
+        flags = body[0]
+        _, tile_width, page_count = struct.unpack_from("<HBB", body, 1)
+        width = tile_width * 8
+        if flags & FLAG_KEYFRAME or width != self.width or page_count != self.pages:
+            self.width = width
+            self.pages = page_count
+            self.buffer = bytearray(width * page_count)
+            self.valid = bool(flags & FLAG_KEYFRAME)
+        at = 5
+        while at + 2 <= len(body):
+            page, length = body[at], body[at + 1]
+            apply_delta(self.buffer, page * width, body[at + 2:at + 2 + length])
+            at += 2 + length
+        return self.valid and bool(flags & FLAG_LAST)
+
+    def gray(self):
+        """One byte per pixel, row by row (the buffer is 8 rows per byte)."""
+        out = bytearray(self.width * self.pages * 8)
+        for y in range(self.pages * 8):
+            row = (y >> 3) * self.width
+            bit = y & 7
+            for x in range(self.width):
+                if (self.buffer[row + x] >> bit) & 1:
+                    out[y * self.width + x] = 0xFF
+        return bytes(out)
+
+
+def decode(path):
+    """Return [(ms since first frame, width, height, gray pixels)]."""
+    with open(path, "rb") as source:
+        raw = source.read()
+    screen = Screen()
+    shots = []
+    first_us = last_us = None
+    elapsed_us = 0
+    for kind, time_us, body in frames(raw):
+        if kind == FRAME_DROPPED:
+            screen.valid = False    # Wait for the keyframe the controller sends next
+            continue
+        if kind != FRAME_DISPLAY or len(body) < 5:
+            continue
+        if first_us is None:
+            first_us = last_us = time_us
+        elapsed_us += (time_us - last_us) & 0xFFFFFFFF
+        last_us = time_us
+        if screen.apply(body):
+            shots.append((elapsed_us // 1000, screen.width, screen.pages * 8, screen.gray()))
+    return shots
+
+
+def write_frames(shots, directory):
+    os.makedirs(directory, exist_ok=True)
+    for ms, width, height, pixels in shots:
+        with open(os.path.join(directory, "%08d.pgm" % ms), "wb") as out:
+            out.write(b"P5\n%d %d\n255\n" % (width, height))
+            out.write(pixels)
+    print("Wrote %d frames to %s" % (len(shots), directory))
+
+
+def write_video(shots, path, fps):
+    _, width, height, _ = shots[0]
+    command = ["ffmpeg", "-y", "-loglevel", "error",
+               "-f", "rawvideo", "-pix_fmt", "gray", "-s", "%dx%d" % (width, height),
+               "-r", str(fps), "-i", "-",
+               "-vf", "scale=iw*%d:ih*%d:flags=neighbor" % (SCALE, SCALE),
+               "-pix_fmt", "yuv420p", path]
+    encoder = subprocess.Popen(command, stdin=subprocess.PIPE)
+    # Hold each frame until the next one is due; frames of another size are left out
+    index = 0
+    end_ms = shots[-1][0]
+    ticks = int(end_ms * fps / 1000) + 1
+    for tick in range(ticks):
+        now_ms = tick * 1000 / fps
+        while index + 1 < len(shots) and shots[index + 1][0] <= now_ms:
+            index += 1
+        _, w, h, pixels = shots[index]
+        if (w, h) == (width, height):
+            encoder.stdin.write(pixels)
+    encoder.stdin.close()
+    if encoder.wait() != 0:
+        sys.exit("ffmpeg failed")
+    print("Wrote %d frames (%.1f s) to %s" % (ticks, end_ms / 1000.0, path))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file")
+    parser.add_argument("--frames", metavar="DIR", help="write one PGM per frame")
+    parser.add_argument("--video", metavar="FILE", help="render a video with ffmpeg")
+    parser.add_argument("--fps", type=int, default=30)
+    args = parser.parse_args()
+
+    shots = decode(args.file)
+    if not shots:
+        sys.exit("No display frames in %s (was \"screen on\"?)" % args.file)
+    print("%d frames over %.1f s" % (len(shots), shots[-1][0] / 1000.0))
+    if args.frames:
+        write_frames(shots, args.frames)
+    if args.video:
+        write_video(shots, args.video, args.fps)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Drive the paired robot from the PC through the controller's serial bridge.
+
+Import Bridge from a test script, or run the built-in rate test, which sends
+one command frame (hex) at a fixed rate and prints the latency the
+controller reports:
+
+    tools/serial_bridge.py /dev/ttyUSB0 --frame 54474344... --hz 200 --seconds 10
+
+Bridge(port) sends "bridge" at the console baud, waits for the controller
+to switch, then follows it to --bridge-baud (ILITEConfig::bridgeBaud). send()
+writes one command frame; poll() returns the robot's telemetry frames and
+collects the "sent" reports (driver status, forward and air time). close()
+sends the end frame and returns the controller's summary lines. The wire
+format is described in lib/ILITE/include/SerialBridge.h. Needs pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+FRAME_DROPPED = 0x12
+FRAME_END = 0x13
+FRAME_COMMAND = 0x20
+FRAME_TELEMETRY = 0x21
+FRAME_SENT = 0x22
+SENT_STATUS = ("ok", "failed", "busy")
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+    out[code_index] = code
+    out.append(0)
+    return bytes(out)
+
+
+def encode(kind, time_us, body=b""):
+    frame = struct.pack("<BI", kind, time_us & 0xFFFFFFFF) + body
+    return cobs_encode(frame + struct.pack("<H", crc16(frame)))
+
+
+class Bridge:
+    def __init__(self, device, console_baud=115200, bridge_baud=2000000):
+        # One open port throughout: reopening toggles DTR/RTS, which resets many boards
+        self.port = serial.Serial(device, console_baud, timeout=0.1)
+        self.console_baud = console_baud
+        self.port.reset_input_buffer()
+        self.port.write(b"bridge\n")
+        deadline = time.monotonic() + 2.0
+        while True:
+            line = self.port.readline().decode("ascii", "replace").strip()
+            if line.startswith("[Bridge] On"):
+                break
+            if line.startswith("[Bridge]") or time.monotonic() > deadline:
+                self.port.close()
+                raise RuntimeError(line or "no answer from the controller")
+        time.sleep(0.05)    # The controller restarts its UART driver
+        self.port.baudrate = bridge_baud
+        self.port.timeout = 0
+        self.port.reset_input_buffer()
+        self.buffer = bytearray()
+        self.start = time.monotonic()
+        self.sent = []          # (host_us, status, forward_us, air_us, round_trip_us)
+        self.dropped = 0
+
+    def now_us(self):
+        return int((time.monotonic() - self.start) * 1e6) & 0xFFFFFFFF
+
+    def send(self, frame):
+        """Send one ESP-NOW frame (bytes, 1-250) to the robot."""
+        self.port.write(encode(FRAME_COMMAND, self.now_us(), frame))
+
+    def poll(self):
+        """Telemetry frames [(controller_us, bytes)] received since the last poll."""
+        self.buffer += self.port.read(self.port.in_waiting or 1)
+        telemetry = []
+        while b"\x00" in self.buffer:
+            chunk, _, self.buffer = self.buffer.partition(b"\x00")
+            frame = cobs_decode(bytes(chunk)) if chunk else None
+            if frame is None or len(frame) < 7:
+                continue    # Console text from other tasks
+            if crc16(frame[:-2]) != struct.unpack_from("<H", frame, len(frame) - 2)[0]:
+                continue
+            kind, time_us = struct.unpack_from("<BI", frame)
+            body = frame[5:-2]
+            if kind == FRAME_TELEMETRY:
+                telemetry.append((time_us, body))
+            elif kind == FRAME_SENT and len(body) == 9:
+                status, forward_us, air_us = struct.unpack("<BII", body)
+                round_trip = (self.now_us() - time_us) & 0xFFFFFFFF
+                self.sent.append((time_us, status, forward_us, air_us, round_trip))
+            elif kind == FRAME_DROPPED and len(body) == 4:
+                self.dropped += struct.unpack("<I", body)[0]
+        return telemetry
+
+    def close(self):
+        """Leave the bridge; returns the controller's summary lines."""
+        self.port.write(encode(FRAME_END, self.now_us()))
+        self.port.flush()
+        time.sleep(0.05)    # The summary comes at the console baud
+        self.port.baudrate = self.console_baud
+        self.port.reset_input_buffer()
+        self.port.timeout = 0.1
+        lines = []
+        deadline = time.monotonic() + 3.0
+        while time.monotonic() < deadline:
+            line = self.port.readline().decode("ascii", "replace").strip()
+            if line.startswith("[Bridge]") and not line.startswith("[Bridge] On"):
+                lines.append(line)
+                deadline = time.monotonic() + 0.3
+        self.port.close()
+        return lines
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * fraction))]
+
+
+def rate_test(bridge, frame, hz, seconds):
+    period = 1.0 / hz
+    telemetry = 0
+    next_send = time.monotonic()
+    end = next_send + seconds
+    while time.monotonic() < end:
+        if time.monotonic() >= next_send:
+            bridge.send(frame)
+            next_send += period
+        telemetry += len(bridge.poll())
+        time.sleep(min(0.0005, max(0.0, next_send - time.monotonic())))
+    time.sleep(0.05)
+    telemetry += len(bridge.poll())
+
+    sent = bridge.sent
+    print("%d commands at %d Hz, %d reports, %d telemetry frames (%d dropped)"
+          % (int(seconds * hz), hz, len(sent), telemetry, bridge.dropped))
+    if sent:
+        for status in range(len(SENT_STATUS)):
+            count = sum(1 for s in sent if s[1] == status)
+            if count:
+                print("  %-6s %d" % (SENT_STATUS[status], count))
+        measured = [s for s in sent if s[3] > 0]
+        for name, index in (("forward", 2), ("air", 3), ("host round trip", 4)):
+            values = [s[index] for s in (measured if index == 3 else sent)]
+            if values:
+                print("  %-15s us: p50=%d p99=%d max=%d"
+                      % (name, percentile(values, 0.5), percentile(values, 0.99), max(values)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--frame", required=True, help="command frame as hex")
+    parser.add_argument("--hz", type=int, default=200)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--baud", type=int, default=115200, help="console baud")
+    parser.add_argument("--bridge-baud", type=int, default=2000000)
+    args = parser.parse_args()
+
+    frame = bytes.fromhex(args.frame)
+    if not 0 < len(frame) <= 250:
+        parser.error("frame must be 1-250 bytes")
+
+    try:
+        bridge = Bridge(args.port, args.baud, args.bridge_baud)
+    except RuntimeError as error:
+        sys.exit("bridge refused: %s" % error)
+    try:
+        rate_test(bridge, frame, args.hz, args.seconds)
+    finally:
+        for line in bridge.close():
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Record a TelemetryTap session, or replay one into the controller.
+
+Record (inputs + RX + TX frames written raw to a file). --baud is the tap
+baud: turn the tap on first ("tap on" at the console baud) unless
+ILITEConfig::telemetryTap starts it at boot:
+
+    tools/tap_replay.py record /dev/ttyUSB0 session.tap --baud 2000000
+
+Replay (sends "replay", then the input/RX/TX frames paced at the recorded
+rate, then the end frame; prints the controller's summary):
+
+    tools/tap_replay.py replay /dev/ttyUSB0 session.tap --baud 2000000
+
+The file is the raw byte stream of the port: COBS frames ending in 0x00,
+as described in lib/ILITE/include/TelemetryTap.h. Console text in it is
+skipped by the CRC check on both sides. Needs pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+FRAME_RX = 0x01
+FRAME_TX = 0x02
+FRAME_INPUT = 0x03
+FRAME_END = 0x13
+REPLAYED = (FRAME_INPUT, FRAME_RX, FRAME_TX)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+    out[code_index] = code
+    out.append(0)
+    return bytes(out)
+
+
+def frames(raw):
+    """Yield (kind, time_us, encoded_frame) for every valid frame."""
+    for chunk in raw.split(b"\x00"):
+        frame = cobs_decode(chunk) if chunk else None
+        if frame is None or len(frame) < 7:
+            continue
+        if crc16(frame[:-2]) != struct.unpack_from("<H", frame, len(frame) - 2)[0]:
+            continue
+        kind, time_us = struct.unpack_from("<BI", frame)
+        yield kind, time_us, chunk + b"\x00"
+
+
+def record(port, path):
+    print("Recording to %s; Ctrl-C to stop" % path)
+    with open(path, "wb") as out:
+        try:
+            while True:
+                out.write(port.read(4096))
+        except KeyboardInterrupt:
+            pass
+
+
+def replay(port, path):
+    with open(path, "rb") as source:
+        recorded = [f for f in frames(source.read()) if f[0] in REPLAYED]
+    if not recorded:
+        sys.exit("No input/RX/TX frames in %s (was the tap on?)" % path)
+    inputs = sum(1 for f in recorded if f[0] == FRAME_INPUT)
+    print("Replaying %d frames (%d ticks)" % (len(recorded), inputs))
+
+    port.write(b"tap off\nreplay\n")
+    time.sleep(0.2)
+    port.reset_input_buffer()
+    port.write(b"\x00")            # Delimit anything left on the line
+
+    start_us = recorded[0][1]
+    start = time.monotonic()
+    for _, time_us, encoded in recorded:
+        due = start + ((time_us - start_us) & 0xFFFFFFFF) / 1e6
+        delay = due - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        port.write(encoded)
+
+    end = struct.pack("<BI", FRAME_END, 0)
+    port.write(cobs_encode(end + struct.pack("<H", crc16(end))))
+
+    # The summary follows once the controller has replayed the queue
+    deadline = time.monotonic() + 5.0
+    while time.monotonic() < deadline:
+        line = port.readline().decode("ascii", "replace").strip()
+        if line.startswith("[Replay]"):
+            print(line)
+            deadline = time.monotonic() + 0.5
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mode", choices=("record", "replay"))
+    parser.add_argument("port")
+    parser.add_argument("file")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        if args.mode == "record":
+            record(port, args.file)
+        else:
+            replay(port, args.file)
+
+
+if __name__ == "__main__":
+    main()